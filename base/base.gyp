@@ -35,6 +35,20 @@
         ],
       },
       'conditions': [
+        ['(target_arch == "ia32" or target_arch == "x64") and OS != "win"', {
+          'dependencies': [
+            'base_sha1_x86',
+          ],
+          'defines': [
+            'BASE_SHA1_X86',
+          ],
+          # For the tests of the SHA-1 implementations.
+          'direct_dependent_settings': {
+            'defines': [
+              'BASE_SHA1_X86',
+            ],
+          },
+        }],
         ['desktop_linux == 1 or chromeos == 1', {
           'conditions': [
             ['chromeos==1', {
@@ -407,6 +421,38 @@
         '..',
       ],
     },
+    {
+      # The SHA-1 compression function that uses the x86 SHA extensions. It
+      # is built with them enabled, which the rest of base must not be, and
+      # is only called when base::CPU reports them.
+      'target_name': 'base_sha1_x86',
+      'type': 'static_library',
+      'variables': {
+        'optimize': 'max',
+      },
+      'toolsets': ['host', 'target'],
+      'sources': [
+        'sha1_internal.h',
+        'sha1_x86.cc',
+      ],
+      'include_dirs': [
+        '..',
+      ],
+      'defines': [
+        'BASE_IMPLEMENTATION',
+        'BASE_SHA1_X86',
+      ],
+      'cflags': [
+        '-msse4.1',
+        '-msha',
+      ],
+      'xcode_settings': {
+        'OTHER_CFLAGS': [
+          '-msse4.1',
+          '-msha',
+        ],
+      },
+    },
     # Include this target for a main() function that simply instantiates
     # and runs a base::TestSuite.
     {
@@ -447,6 +493,8 @@
         'callback_unittest.nc',
         'cancelable_callback_unittest.cc',
         'command_line_unittest.cc',
+        'containers/flat_map_unittest.cc',
+        'containers/flat_set_unittest.cc',
         'containers/hash_tables_unittest.cc',
         'containers/linked_list_unittest.cc',
         'containers/mru_cache_unittest.cc',
@@ -456,6 +504,7 @@
         'debug/crash_logging_unittest.cc',
         'debug/leak_tracker_unittest.cc',
         'debug/proc_maps_linux_unittest.cc',
+        'debug/sampling_heap_profiler_unittest.cc',
         'debug/stack_trace_unittest.cc',
         'debug/trace_event_memory_unittest.cc',
         'debug/trace_event_synthetic_delay_unittest.cc',
@@ -508,6 +557,7 @@
         'mac/scoped_sending_event_unittest.mm',
         'md5_unittest.cc',
         'memory/aligned_memory_unittest.cc',
+        'memory/arena_unittest.cc',
         'memory/discardable_memory_allocator_android_unittest.cc',
         'memory/discardable_memory_manager_unittest.cc',
         'memory/discardable_memory_unittest.cc',
@@ -535,6 +585,7 @@
         'metrics/histogram_delta_serialization_unittest.cc',
         'metrics/histogram_snapshot_manager_unittest.cc',
         'metrics/histogram_unittest.cc',
+        'metrics/shared_histogram_allocator_unittest.cc',
         'metrics/sparse_histogram_unittest.cc',
         'metrics/stats_table_unittest.cc',
         'metrics/statistics_recorder_unittest.cc',
@@ -814,6 +865,12 @@
         '../testing/gtest.gyp:gtest',
       ],
       'sources': [
+        'containers/flat_map_perftest.cc',
+        'debug/sampling_heap_profiler_perftest.cc',
+        'json/json_perftest.cc',
+        'memory/arena_perftest.cc',
+        'pickle_perftest.cc',
+        'sha1_perftest.cc',
         'threading/thread_perftest.cc',
         'test/run_all_unittests.cc',
         '../testing/perf/perf_test.cc'
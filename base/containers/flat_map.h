@@ -0,0 +1,103 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_CONTAINERS_FLAT_MAP_H_
+#define BASE_CONTAINERS_FLAT_MAP_H_
+
+#include <functional>
+#include <utility>
+
+#include "base/containers/flat_tree.h"
+
+namespace base {
+
+namespace internal {
+
+template <typename Key, typename Mapped>
+struct GetKeyFromMapValue {
+  const Key& operator()(const std::pair<Key, Mapped>& value) const {
+    return value.first;
+  }
+};
+
+}  // namespace internal
+
+// An std::map-like container backed by a sorted std::vector of key/value
+// pairs.
+//
+// WHEN TO USE IT
+// --------------
+//
+// The elements live in a single allocation rather than one per element.
+// Iterating over them is about ten times faster than over a std::map, and
+// building the container all at once from a range is several times faster
+// for cheap keys. Looking up a key is a binary search, which costs about as
+// much as a std::map lookup whose nodes are in the cache, and less when they
+// aren't. See base/containers/flat_map_perftest.cc. However, inserting or
+// erasing a single element moves all the elements after it, so building it
+// one element at a time is O(n^2).
+//
+// So use flat_map (and flat_set) for maps which are built once or rarely
+// changed, and then read or iterated over. Keep using std::map when elements
+// are added and removed all the time, when iterators or pointers to elements
+// must stay valid across changes, or when the values are expensive to copy.
+//
+// DIFFERENCES FROM std::map
+// -------------------------
+//
+//  - Any insertion or erasure invalidates all iterators.
+//  - value_type is std::pair<Key, Mapped> rather than
+//    std::pair<const Key, Mapped>; don't change keys through iterators.
+//  - The range constructor and range insert() sort the new elements in one
+//    go. Of elements with equal keys, the first one wins, as with std::map.
+//
+// example:
+//   base::flat_map<std::string, int> days;
+//   days.reserve(7);
+//   days["sunday"] = 0;
+//   ...
+//   base::flat_map<std::string, int>::const_iterator it = days.find(day);
+template <typename Key, typename Mapped, typename Compare = std::less<Key> >
+class flat_map : public internal::flat_tree<
+                     Key,
+                     std::pair<Key, Mapped>,
+                     internal::GetKeyFromMapValue<Key, Mapped>,
+                     Compare> {
+ private:
+  typedef internal::flat_tree<Key,
+                              std::pair<Key, Mapped>,
+                              internal::GetKeyFromMapValue<Key, Mapped>,
+                              Compare> tree;
+
+ public:
+  typedef Mapped mapped_type;
+  typedef typename tree::key_type key_type;
+  typedef typename tree::value_type value_type;
+  typedef typename tree::iterator iterator;
+  typedef typename tree::value_compare value_compare;
+
+  flat_map() {}
+  explicit flat_map(const Compare& comp) : tree(comp) {}
+
+  // Sorts [first, last) all at once. Of elements with equal keys, the first
+  // is kept.
+  template <typename InputIterator>
+  flat_map(InputIterator first,
+           InputIterator last,
+           const Compare& comp = Compare())
+      : tree(first, last, comp) {}
+
+  // Returns the value for |key|, inserting a default constructed one first if
+  // there is none.
+  mapped_type& operator[](const key_type& key) {
+    iterator position = this->lower_bound(key);
+    if (position == this->end() || this->key_comp()(key, position->first))
+      position = this->insert(position, value_type(key, mapped_type()));
+    return position->second;
+  }
+};
+
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_FLAT_MAP_H_
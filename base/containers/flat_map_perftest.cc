@@ -0,0 +1,131 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/containers/flat_map.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace base {
+
+namespace {
+
+const int kNumLookups = 4000000;
+
+// Keys like those of header or property maps.
+std::string MakeKey(int i) {
+  return StringPrintf("x-key-%d", i * 7919);
+}
+
+template <typename Key>
+Key KeyForIndex(int i);
+
+template <>
+int KeyForIndex<int>(int i) {
+  return i * 7919;
+}
+
+template <>
+std::string KeyForIndex<std::string>(int i) {
+  return MakeKey(i);
+}
+
+// A fixed pseudo-random order, so that runs are comparable.
+int NextRandom(int max) {
+  static uint32 state = 12345;
+  state = state * 1103515245 + 12345;
+  return (state >> 8) % max;
+}
+
+// Times building a map of |size| elements, looking keys up in it, half of
+// which are present, and iterating over it. Elements are inserted and looked
+// up in random order rather than in key order.
+template <typename Map>
+void RunMapTest(const std::string& map_name,
+                const std::string& key_name,
+                int size) {
+  typedef typename Map::key_type Key;
+  std::vector<std::pair<Key, int> > elements;
+  std::vector<Key> lookups;
+  for (int i = 0; i < size; ++i) {
+    elements.push_back(std::make_pair(KeyForIndex<Key>(i), i));
+    lookups.push_back(KeyForIndex<Key>(i));
+    lookups.push_back(KeyForIndex<Key>(size + i));
+  }
+  std::random_shuffle(elements.begin(), elements.end(), NextRandom);
+  std::random_shuffle(lookups.begin(), lookups.end(), NextRandom);
+
+  const int kNumBuilds = std::max(1, kNumLookups / 10 / size);
+  TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kNumBuilds; ++i) {
+    Map map(elements.begin(), elements.end());
+    EXPECT_EQ(static_cast<size_t>(size), map.size());
+  }
+  TimeDelta build_time = TimeTicks::Now() - start;
+
+  Map map(elements.begin(), elements.end());
+  const int kNumRounds = kNumLookups / lookups.size();
+  int found = 0;
+  start = TimeTicks::Now();
+  for (int round = 0; round < kNumRounds; ++round) {
+    for (size_t i = 0; i < lookups.size(); ++i) {
+      if (map.find(lookups[i]) != map.end())
+        ++found;
+    }
+  }
+  TimeDelta lookup_time = TimeTicks::Now() - start;
+  EXPECT_EQ(kNumRounds * size, found);
+
+  int64 sum = 0;
+  start = TimeTicks::Now();
+  for (int round = 0; round < kNumRounds; ++round) {
+    for (typename Map::const_iterator it = map.begin(); it != map.end(); ++it)
+      sum += it->second;
+  }
+  TimeDelta iteration_time = TimeTicks::Now() - start;
+  EXPECT_EQ(static_cast<int64>(kNumRounds) * size * (size - 1) / 2, sum);
+
+  std::string trace = StringPrintf("%s_%d", key_name.c_str(), size);
+  perf_test::PrintResult(
+      map_name + "_build", "", trace,
+      build_time.InMicroseconds() * 1000.0 / kNumBuilds / size,
+      "ns/element", true);
+  perf_test::PrintResult(
+      map_name + "_find", "", trace,
+      lookup_time.InMicroseconds() * 1000.0 / kNumRounds / lookups.size(),
+      "ns/lookup", true);
+  perf_test::PrintResult(
+      map_name + "_iterate", "", trace,
+      iteration_time.InMicroseconds() * 1000.0 / kNumRounds / size,
+      "ns/element", true);
+}
+
+template <typename Key>
+void RunTests(const std::string& key_name) {
+  const int kSizes[] = { 8, 64, 1024 };
+  for (size_t i = 0; i < arraysize(kSizes); ++i) {
+    RunMapTest<std::map<Key, int> >("std_map", key_name, kSizes[i]);
+    RunMapTest<flat_map<Key, int> >("flat_map", key_name, kSizes[i]);
+  }
+}
+
+}  // namespace
+
+TEST(FlatMapPerfTest, IntKeys) {
+  RunTests<int>("int");
+}
+
+TEST(FlatMapPerfTest, StringKeys) {
+  RunTests<std::string>("string");
+}
+
+}  // namespace base
@@ -0,0 +1,112 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/flat_map.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+TEST(FlatMap, Subscript) {
+  flat_map<std::string, int> days;
+  days["tuesday"] = 2;
+  days["sunday"] = 0;
+  days["monday"] = 1;
+  days["sunday"] = 7;
+
+  ASSERT_EQ(3u, days.size());
+  flat_map<std::string, int>::const_iterator it = days.begin();
+  EXPECT_EQ("monday", it->first);
+  EXPECT_EQ(1, it->second);
+  ++it;
+  EXPECT_EQ("sunday", it->first);
+  EXPECT_EQ(7, it->second);
+  ++it;
+  EXPECT_EQ("tuesday", it->first);
+  EXPECT_EQ(2, it->second);
+  ++it;
+  EXPECT_TRUE(it == days.end());
+
+  EXPECT_EQ(0, days["wednesday"]);
+  EXPECT_EQ(4u, days.size());
+}
+
+TEST(FlatMap, InsertDoesNotOverwrite) {
+  flat_map<int, std::string> map;
+  EXPECT_TRUE(map.insert(std::make_pair(1, std::string("one"))).second);
+  std::pair<flat_map<int, std::string>::iterator, bool> result =
+      map.insert(std::make_pair(1, std::string("uno")));
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ("one", result.first->second);
+  EXPECT_EQ("one", map.find(1)->second);
+}
+
+// Of elements with equal keys, bulk construction keeps the first, like
+// inserting them one by one into a std::map would.
+TEST(FlatMap, RangeConstructorKeepsFirst) {
+  std::vector<std::pair<int, int> > input;
+  for (int i = 0; i < 100; ++i)
+    input.push_back(std::make_pair((i * 37) % 50, i));
+
+  flat_map<int, int> map(input.begin(), input.end());
+  ASSERT_EQ(50u, map.size());
+  for (int key = 0; key < 50; ++key) {
+    flat_map<int, int>::const_iterator it = map.find(key);
+    ASSERT_TRUE(it != map.end());
+    // The first occurrence of |key| is at the i < 50 with i * 37 = key mod 50.
+    EXPECT_EQ(key, (it->second * 37) % 50);
+    EXPECT_LT(it->second, 50);
+  }
+}
+
+TEST(FlatMap, RangeInsertKeepsExisting) {
+  flat_map<int, int> map;
+  map[1] = 10;
+  map[3] = 30;
+
+  std::vector<std::pair<int, int> > more;
+  more.push_back(std::make_pair(3, 300));
+  more.push_back(std::make_pair(2, 200));
+  more.push_back(std::make_pair(2, 201));
+  map.insert(more.begin(), more.end());
+
+  ASSERT_EQ(3u, map.size());
+  EXPECT_EQ(10, map[1]);
+  EXPECT_EQ(200, map[2]);
+  EXPECT_EQ(30, map[3]);
+}
+
+TEST(FlatMap, EraseAndFind) {
+  flat_map<int, int> map;
+  for (int i = 0; i < 10; ++i)
+    map[i] = i * i;
+
+  EXPECT_EQ(1u, map.erase(5));
+  EXPECT_EQ(0u, map.erase(5));
+  EXPECT_TRUE(map.find(5) == map.end());
+  EXPECT_EQ(9u, map.size());
+  EXPECT_EQ(36, map.find(6)->second);
+  EXPECT_EQ(6, map.lower_bound(5)->first);
+
+  map.erase(map.begin(), map.find(6));
+  EXPECT_EQ(4u, map.size());
+  EXPECT_EQ(6, map.begin()->first);
+}
+
+TEST(FlatMap, ReserveAndShrink) {
+  flat_map<int, int> map;
+  map.reserve(100);
+  EXPECT_GE(map.capacity(), 100u);
+  map[1] = 1;
+  map.shrink_to_fit();
+  EXPECT_EQ(1u, map.size());
+  EXPECT_EQ(1, map[1]);
+}
+
+}  // namespace base
@@ -0,0 +1,58 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_CONTAINERS_FLAT_SET_H_
+#define BASE_CONTAINERS_FLAT_SET_H_
+
+#include <functional>
+
+#include "base/containers/flat_tree.h"
+
+namespace base {
+
+namespace internal {
+
+template <typename Key>
+struct GetKeyFromSetValue {
+  const Key& operator()(const Key& key) const { return key; }
+};
+
+}  // namespace internal
+
+// An std::set-like container backed by a sorted std::vector. See flat_map.h
+// for when to use it.
+//
+// Iterators are invalidated by any insertion or erasure. Unlike with
+// std::set, values can be changed through iterators, which must not change
+// their order.
+//
+// example:
+//   base::flat_set<std::string> schemes(kSchemes,
+//                                       kSchemes + arraysize(kSchemes));
+//   if (schemes.count(url.scheme()))
+//     ...
+template <typename Key, typename Compare = std::less<Key> >
+class flat_set : public internal::flat_tree<
+                     Key, Key, internal::GetKeyFromSetValue<Key>, Compare> {
+ private:
+  typedef internal::flat_tree<
+      Key, Key, internal::GetKeyFromSetValue<Key>, Compare> tree;
+
+ public:
+  typedef typename tree::value_compare value_compare;
+
+  flat_set() {}
+  explicit flat_set(const Compare& comp) : tree(comp) {}
+
+  // Sorts [first, last) all at once. Of equal values, the first is kept.
+  template <typename InputIterator>
+  flat_set(InputIterator first,
+           InputIterator last,
+           const Compare& comp = Compare())
+      : tree(first, last, comp) {}
+};
+
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_FLAT_SET_H_
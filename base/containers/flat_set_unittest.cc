@@ -0,0 +1,137 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/flat_set.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+std::vector<int> ToVector(const flat_set<int>& set) {
+  return std::vector<int>(set.begin(), set.end());
+}
+
+}  // namespace
+
+TEST(FlatSet, InsertAndFind) {
+  flat_set<int> set;
+  EXPECT_TRUE(set.empty());
+
+  EXPECT_TRUE(set.insert(3).second);
+  EXPECT_TRUE(set.insert(1).second);
+  EXPECT_TRUE(set.insert(2).second);
+  std::pair<flat_set<int>::iterator, bool> result = set.insert(2);
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(2, *result.first);
+
+  EXPECT_EQ(3u, set.size());
+  const int kExpected[] = { 1, 2, 3 };
+  EXPECT_EQ(std::vector<int>(kExpected, kExpected + arraysize(kExpected)),
+            ToVector(set));
+
+  EXPECT_EQ(1u, set.count(1));
+  EXPECT_EQ(0u, set.count(4));
+  EXPECT_TRUE(set.find(0) == set.end());
+  ASSERT_TRUE(set.find(3) != set.end());
+  EXPECT_EQ(3, *set.find(3));
+}
+
+TEST(FlatSet, InsertWithHint) {
+  flat_set<int> set;
+  // A correct hint.
+  for (int i = 0; i < 10; i += 2)
+    set.insert(set.end(), i);
+  // Wrong hints.
+  EXPECT_EQ(5, *set.insert(set.begin(), 5));
+  EXPECT_EQ(4, *set.insert(set.end(), 4));
+
+  const int kExpected[] = { 0, 2, 4, 5, 6, 8 };
+  EXPECT_EQ(std::vector<int>(kExpected, kExpected + arraysize(kExpected)),
+            ToVector(set));
+}
+
+TEST(FlatSet, RangeConstructorAndInsert) {
+  const int kInput[] = { 5, 1, 4, 1, 3, 5 };
+  flat_set<int> set(kInput, kInput + arraysize(kInput));
+  const int kExpected1[] = { 1, 3, 4, 5 };
+  EXPECT_EQ(std::vector<int>(kExpected1, kExpected1 + arraysize(kExpected1)),
+            ToVector(set));
+
+  const int kMore[] = { 6, 2, 4, 0, 6 };
+  set.insert(kMore, kMore + arraysize(kMore));
+  const int kExpected2[] = { 0, 1, 2, 3, 4, 5, 6 };
+  EXPECT_EQ(std::vector<int>(kExpected2, kExpected2 + arraysize(kExpected2)),
+            ToVector(set));
+}
+
+TEST(FlatSet, Erase) {
+  const int kInput[] = { 1, 2, 3, 4, 5 };
+  flat_set<int> set(kInput, kInput + arraysize(kInput));
+
+  EXPECT_EQ(1u, set.erase(3));
+  EXPECT_EQ(0u, set.erase(3));
+  flat_set<int>::iterator it = set.erase(set.begin());
+  EXPECT_EQ(2, *it);
+  set.erase(set.find(4), set.end());
+
+  const int kExpected[] = { 2 };
+  EXPECT_EQ(std::vector<int>(kExpected, kExpected + arraysize(kExpected)),
+            ToVector(set));
+
+  set.clear();
+  EXPECT_TRUE(set.empty());
+}
+
+TEST(FlatSet, Bounds) {
+  const int kInput[] = { 10, 20, 30 };
+  flat_set<int> set(kInput, kInput + arraysize(kInput));
+  const flat_set<int>& const_set = set;
+
+  EXPECT_EQ(10, *const_set.lower_bound(5));
+  EXPECT_EQ(20, *const_set.lower_bound(20));
+  EXPECT_EQ(30, *const_set.upper_bound(20));
+  EXPECT_TRUE(const_set.upper_bound(30) == const_set.end());
+
+  std::pair<flat_set<int>::const_iterator, flat_set<int>::const_iterator>
+      range = const_set.equal_range(20);
+  EXPECT_EQ(1, range.second - range.first);
+  EXPECT_EQ(20, *range.first);
+  range = const_set.equal_range(25);
+  EXPECT_TRUE(range.first == range.second);
+}
+
+TEST(FlatSet, CustomCompare) {
+  const char* kInput[] = { "b", "c", "a" };
+  flat_set<std::string, std::greater<std::string> > set(
+      kInput, kInput + arraysize(kInput));
+  ASSERT_EQ(3u, set.size());
+  EXPECT_EQ("c", *set.begin());
+  EXPECT_EQ("a", *set.rbegin());
+  EXPECT_EQ(1u, set.count("b"));
+}
+
+TEST(FlatSet, SwapAndCompare) {
+  const int kInput[] = { 1, 2 };
+  flat_set<int> set1(kInput, kInput + arraysize(kInput));
+  flat_set<int> set2;
+  EXPECT_TRUE(set1 != set2);
+  EXPECT_TRUE(set2 < set1);
+
+  set1.swap(set2);
+  EXPECT_TRUE(set1.empty());
+  EXPECT_EQ(2u, set2.size());
+
+  set1.insert(2);
+  set1.insert(1);
+  EXPECT_TRUE(set1 == set2);
+}
+
+}  // namespace base
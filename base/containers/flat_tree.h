@@ -0,0 +1,233 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_CONTAINERS_FLAT_TREE_H_
+#define BASE_CONTAINERS_FLAT_TREE_H_
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace base {
+namespace internal {
+
+// The implementation of base::flat_map and base::flat_set: a sorted vector of
+// |Value| with unique keys, where GetKeyFromValue()(value) returns the key of
+// a value and |KeyCompare| orders the keys.
+//
+// See flat_map.h for when to use these containers instead of std::map.
+template <typename Key,
+          typename Value,
+          typename GetKeyFromValue,
+          typename KeyCompare>
+class flat_tree {
+ public:
+  typedef Key key_type;
+  typedef KeyCompare key_compare;
+  typedef Value value_type;
+  typedef std::vector<Value> underlying_type;
+  typedef typename underlying_type::size_type size_type;
+  typedef typename underlying_type::difference_type difference_type;
+  typedef typename underlying_type::reference reference;
+  typedef typename underlying_type::const_reference const_reference;
+  typedef typename underlying_type::pointer pointer;
+  typedef typename underlying_type::const_pointer const_pointer;
+  typedef typename underlying_type::iterator iterator;
+  typedef typename underlying_type::const_iterator const_iterator;
+  typedef typename underlying_type::reverse_iterator reverse_iterator;
+  typedef typename underlying_type::const_reverse_iterator
+      const_reverse_iterator;
+
+  // Orders values by their keys.
+  class value_compare {
+   public:
+    explicit value_compare(const KeyCompare& comp) : comp_(comp) {}
+    bool operator()(const Value& left, const Value& right) const {
+      GetKeyFromValue extractor;
+      return comp_(extractor(left), extractor(right));
+    }
+
+   private:
+    KeyCompare comp_;
+  };
+
+  flat_tree() : comp_(KeyCompare()) {}
+  explicit flat_tree(const KeyCompare& comp) : comp_(comp) {}
+
+  // Sorts the values of [first, last) all at once, which is much cheaper than
+  // inserting them one by one. Of values with the same key, the first one is
+  // kept.
+  template <typename InputIterator>
+  flat_tree(InputIterator first,
+            InputIterator last,
+            const KeyCompare& comp = KeyCompare())
+      : comp_(comp),
+        values_(first, last) {
+    SortAndRemoveDuplicates(values_.begin());
+  }
+
+  // Size management. Like std::vector, the storage is only released by
+  // clear() followed by shrink_to_fit(), or by destruction.
+  void reserve(size_type new_capacity) { values_.reserve(new_capacity); }
+  size_type capacity() const { return values_.capacity(); }
+  void shrink_to_fit() { underlying_type(values_).swap(values_); }
+  size_type size() const { return values_.size(); }
+  size_type max_size() const { return values_.max_size(); }
+  bool empty() const { return values_.empty(); }
+  void clear() { values_.clear(); }
+
+  // Iterators visit the values in key order.
+  iterator begin() { return values_.begin(); }
+  const_iterator begin() const { return values_.begin(); }
+  iterator end() { return values_.end(); }
+  const_iterator end() const { return values_.end(); }
+  reverse_iterator rbegin() { return values_.rbegin(); }
+  const_reverse_iterator rbegin() const { return values_.rbegin(); }
+  reverse_iterator rend() { return values_.rend(); }
+  const_reverse_iterator rend() const { return values_.rend(); }
+
+  // Inserts |value| unless a value with the same key is present. Returns an
+  // iterator to the value with that key, and whether |value| was inserted.
+  // This is O(size()) because of the values moved up; to insert many values,
+  // use the range insert() below.
+  std::pair<iterator, bool> insert(const value_type& value) {
+    const key_type& key = GetKeyFromValue()(value);
+    iterator position = lower_bound(key);
+    if (position != end() && !comp_(key, GetKeyFromValue()(*position)))
+      return std::make_pair(position, false);
+    return std::make_pair(values_.insert(position, value), true);
+  }
+
+  // As above, but checks |hint| first, which makes inserting values in order
+  // cheap.
+  iterator insert(iterator hint, const value_type& value) {
+    const key_type& key = GetKeyFromValue()(value);
+    if ((hint == begin() || comp_(GetKeyFromValue()(*(hint - 1)), key)) &&
+        (hint == end() || comp_(key, GetKeyFromValue()(*hint)))) {
+      return values_.insert(hint, value);
+    }
+    return insert(value).first;
+  }
+
+  // Inserts the values of [first, last) whose keys are not present yet, all
+  // at once. Of new values with the same key, the first one is inserted.
+  template <typename InputIterator>
+  void insert(InputIterator first, InputIterator last) {
+    size_type old_size = size();
+    values_.insert(values_.end(), first, last);
+    SortAndRemoveDuplicates(values_.begin() + old_size);
+  }
+
+  // Erasing is O(size()) because of the values moved down.
+  iterator erase(iterator position) { return values_.erase(position); }
+  iterator erase(iterator first, iterator last) {
+    return values_.erase(first, last);
+  }
+  size_type erase(const key_type& key) {
+    std::pair<iterator, iterator> range = equal_range(key);
+    size_type count = range.second - range.first;
+    erase(range.first, range.second);
+    return count;
+  }
+
+  // Lookups are binary searches over contiguous memory.
+  size_type count(const key_type& key) const {
+    return find(key) == end() ? 0 : 1;
+  }
+  iterator find(const key_type& key) {
+    iterator position = lower_bound(key);
+    if (position != end() && !comp_(key, GetKeyFromValue()(*position)))
+      return position;
+    return end();
+  }
+  const_iterator find(const key_type& key) const {
+    return const_cast<flat_tree*>(this)->find(key);
+  }
+  iterator lower_bound(const key_type& key) {
+    // std::lower_bound() would need a comparator taking a value and a key,
+    // which some debug STL implementations check both ways around.
+    iterator first = begin();
+    difference_type length = end() - first;
+    while (length > 0) {
+      difference_type half = length / 2;
+      iterator middle = first + half;
+      if (comp_(GetKeyFromValue()(*middle), key)) {
+        first = middle + 1;
+        length -= half + 1;
+      } else {
+        length = half;
+      }
+    }
+    return first;
+  }
+  const_iterator lower_bound(const key_type& key) const {
+    return const_cast<flat_tree*>(this)->lower_bound(key);
+  }
+  iterator upper_bound(const key_type& key) {
+    iterator position = lower_bound(key);
+    if (position != end() && !comp_(key, GetKeyFromValue()(*position)))
+      ++position;
+    return position;
+  }
+  const_iterator upper_bound(const key_type& key) const {
+    return const_cast<flat_tree*>(this)->upper_bound(key);
+  }
+  std::pair<iterator, iterator> equal_range(const key_type& key) {
+    iterator position = lower_bound(key);
+    return std::make_pair(position, upper_bound(key));
+  }
+  std::pair<const_iterator, const_iterator> equal_range(
+      const key_type& key) const {
+    const_iterator position = lower_bound(key);
+    return std::make_pair(position, upper_bound(key));
+  }
+
+  key_compare key_comp() const { return comp_; }
+  value_compare value_comp() const { return value_compare(comp_); }
+
+  void swap(flat_tree& other) {
+    std::swap(comp_, other.comp_);
+    values_.swap(other.values_);
+  }
+
+  bool operator==(const flat_tree& other) const {
+    return values_ == other.values_;
+  }
+  bool operator!=(const flat_tree& other) const { return !(*this == other); }
+  bool operator<(const flat_tree& other) const {
+    return values_ < other.values_;
+  }
+
+ private:
+  // Given that [begin(), middle) is sorted with unique keys, sorts the rest
+  // and merges it in, dropping values whose keys are already present.
+  void SortAndRemoveDuplicates(iterator middle) {
+    value_compare comp(comp_);
+    // The sorts are stable so that of equal keys, the earliest one wins, as
+    // with std::map::insert().
+    std::stable_sort(middle, end(), comp);
+    std::inplace_merge(begin(), middle, end(), comp);
+    values_.erase(std::unique(begin(), end(), EqualKeys(comp_)), end());
+  }
+
+  class EqualKeys {
+   public:
+    explicit EqualKeys(const KeyCompare& comp) : comp_(comp) {}
+    bool operator()(const Value& left, const Value& right) const {
+      GetKeyFromValue extractor;
+      return !comp_(extractor(left), extractor(right));
+    }
+
+   private:
+    KeyCompare comp_;
+  };
+
+  KeyCompare comp_;
+  underlying_type values_;
+};
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_FLAT_TREE_H_
@@ -38,6 +38,7 @@ CPU::CPU()
     has_avx_(false),
     has_avx_hardware_(false),
     has_aesni_(false),
+    has_sha_(false),
     has_non_stop_time_stamp_counter_(false),
     cpu_vendor_("unknown") {
   Initialize();
@@ -60,6 +61,16 @@ void __cpuid(int cpu_info[4], int info_type) {
   );
 }
 
+void __cpuidex(int cpu_info[4], int info_type, int info_index) {
+  __asm__ volatile (
+    "mov %%ebx, %%edi\n"
+    "cpuid\n"
+    "xchg %%edi, %%ebx\n"
+    : "=a"(cpu_info[0]), "=D"(cpu_info[1]), "=c"(cpu_info[2]), "=d"(cpu_info[3])
+    : "a"(info_type), "c"(info_index)
+  );
+}
+
 #else
 
 void __cpuid(int cpu_info[4], int info_type) {
@@ -70,6 +81,14 @@ void __cpuid(int cpu_info[4], int info_type) {
   );
 }
 
+void __cpuidex(int cpu_info[4], int info_type, int info_index) {
+  __asm__ volatile (
+    "cpuid \n\t"
+    : "=a"(cpu_info[0]), "=b"(cpu_info[1]), "=c"(cpu_info[2]), "=d"(cpu_info[3])
+    : "a"(info_type), "c"(info_index)
+  );
+}
+
 #endif
 
 // _xgetbv returns the value of an Intel Extended Control Register (XCR).
@@ -135,6 +154,12 @@ void CPU::Initialize() {
     has_aesni_ = (cpu_info[2] & 0x02000000) != 0;
   }
 
+  // The structured extended feature flags are in leaf 7, sub-leaf 0.
+  if (num_ids >= 7) {
+    __cpuidex(cpu_info, 7, 0);
+    has_sha_ = (cpu_info[1] & 0x20000000) != 0;
+  }
+
   // Get the brand string of the cpu.
   __cpuid(cpu_info, 0x80000000);
   const int parameter_end = 0x80000004;
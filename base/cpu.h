@@ -53,6 +53,8 @@ class BASE_EXPORT CPU {
   // to workaround a bug in NSS but |has_avx()| is what you want.
   bool has_avx_hardware() const { return has_avx_hardware_; }
   bool has_aesni() const { return has_aesni_; }
+  // The SHA extensions: SHA1RNDS4, SHA256RNDS2 and friends.
+  bool has_sha() const { return has_sha_; }
   bool has_non_stop_time_stamp_counter() const {
     return has_non_stop_time_stamp_counter_;
   }
@@ -80,6 +82,7 @@ class BASE_EXPORT CPU {
   bool has_avx_;
   bool has_avx_hardware_;
   bool has_aesni_;
+  bool has_sha_;
   bool has_non_stop_time_stamp_counter_;
   std::string cpu_vendor_;
   std::string cpu_brand_;
@@ -0,0 +1,403 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/debug/sampling_heap_profiler.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+
+#include "base/atomicops.h"
+#include "base/bind.h"
+#include "base/debug/stack_trace.h"
+#include "base/debug/trace_event.h"
+#include "base/format_macros.h"
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/message_loop/message_loop_proxy.h"
+#include "base/rand_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/thread_local.h"
+
+namespace base {
+namespace debug {
+
+namespace {
+
+const int kDumpIntervalSeconds = 5;
+
+// Stack frames recorded per sample, and the frames of this file skipped at
+// the top of the stack.
+const size_t kMaxFrames = 32;
+const size_t kSkippedFrames = 2;
+
+// The free hook looks sampled addresses up in a table of counts indexed by a
+// hash of the address, and only takes the lock when the count is not zero.
+const int kFilterBits = 12;
+const size_t kFilterSize = 1 << kFilterBits;
+
+struct Sample {
+  uint64 estimated_bytes;
+  size_t frame_count;
+  const void* frames[kMaxFrames];
+};
+
+typedef std::map<const void*, Sample> SampleMap;
+
+// State shared with the allocator hooks, which run on any thread.
+
+// The bytes left to allocate before the next sample. The allocation which
+// takes it to zero or below is sampled, and sets it anew.
+subtle::AtomicWord g_bytes_until_sample = 0;
+
+subtle::Atomic32 g_sampled_address_counts[kFilterSize];
+
+// Guards the globals below.
+LazyInstance<Lock>::Leaky g_lock = LAZY_INSTANCE_INITIALIZER;
+
+size_t g_sampling_interval = SamplingHeapProfiler::kDefaultSamplingInterval;
+uint64 g_random_state = 0;
+
+// The live samples by address, or NULL when not profiling.
+SampleMap* g_samples = NULL;
+
+// Set while a thread runs profiler code, which allocates: its allocations are
+// not sampled, and the profiler doesn't reenter itself.
+LazyInstance<ThreadLocalBoolean>::Leaky g_in_profiler =
+    LAZY_INSTANCE_INITIALIZER;
+
+size_t FilterIndex(const void* address) {
+  uintptr_t value = reinterpret_cast<uintptr_t>(address);
+  return (static_cast<uint32>(value >> 4) * 2654435761u) >> (32 - kFilterBits);
+}
+
+// Returns an exponentially distributed number of bytes with a mean of
+// |g_sampling_interval|, so that samples form a Poisson process. Must be
+// called with |g_lock| held.
+subtle::AtomicWord NextSampleInterval() {
+  // xorshift64*, which is plenty for picking samples and never allocates.
+  g_random_state ^= g_random_state >> 12;
+  g_random_state ^= g_random_state << 25;
+  g_random_state ^= g_random_state >> 27;
+  uint64 bits = g_random_state * GG_UINT64_C(2685821657736338717);
+  // A uniform number in (0, 1].
+  double uniform = ((bits >> 11) + 1) * (1.0 / (GG_UINT64_C(1) << 53));
+  return static_cast<subtle::AtomicWord>(-log(uniform) * g_sampling_interval) +
+         1;
+}
+
+void RecordSample(const void* address, size_t size) {
+  ThreadLocalBoolean& in_profiler = g_in_profiler.Get();
+  if (in_profiler.Get()) {
+    // Skip the sample, but keep sampling. This path can't take the lock.
+    subtle::NoBarrier_Store(
+        &g_bytes_until_sample,
+        static_cast<subtle::AtomicWord>(g_sampling_interval));
+    return;
+  }
+  in_profiler.Set(true);
+
+  Sample sample;
+  StackTrace stack_trace;
+  size_t frame_count = 0;
+  const void* const* frames = stack_trace.Addresses(&frame_count);
+  size_t skipped = std::min(frame_count, kSkippedFrames);
+  sample.frame_count = std::min(frame_count - skipped, kMaxFrames);
+  memcpy(sample.frames, frames + skipped,
+         sample.frame_count * sizeof(sample.frames[0]));
+
+  {
+    AutoLock lock(g_lock.Get());
+    if (g_samples) {
+      double probability =
+          1.0 - exp(-static_cast<double>(size) / g_sampling_interval);
+      sample.estimated_bytes = static_cast<uint64>(size / probability);
+      std::pair<SampleMap::iterator, bool> result =
+          g_samples->insert(std::make_pair(address, sample));
+      if (result.second) {
+        subtle::NoBarrier_AtomicIncrement(
+            &g_sampled_address_counts[FilterIndex(address)], 1);
+      } else {
+        // The free of the previous allocation at |address| was missed.
+        result.first->second = sample;
+      }
+      // Allocations racing with this one are not counted towards the next
+      // sample, which is noise at this rate.
+      subtle::NoBarrier_Store(&g_bytes_until_sample, NextSampleInterval());
+    }
+  }
+
+  in_profiler.Set(false);
+}
+
+void RemoveSample(const void* address) {
+  ThreadLocalBoolean& in_profiler = g_in_profiler.Get();
+  if (in_profiler.Get())
+    return;
+  in_profiler.Set(true);
+  {
+    AutoLock lock(g_lock.Get());
+    if (g_samples && g_samples->erase(address)) {
+      subtle::NoBarrier_AtomicIncrement(
+          &g_sampled_address_counts[FilterIndex(address)], -1);
+    }
+  }
+  in_profiler.Set(false);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Holds the sites of a dump until the tracing system needs to serialize it.
+class SampledHeapHolder : public base::debug::ConvertableToTraceFormat {
+ public:
+  SampledHeapHolder(size_t sampling_interval,
+                    const std::vector<SamplingHeapProfiler::Site>& sites)
+      : sampling_interval_(sampling_interval),
+        sites_(sites) {}
+
+  // base::debug::ConvertableToTraceFormat overrides:
+  virtual void AppendAsTraceFormat(std::string* out) const OVERRIDE {
+    AppendSampledHeapAsTraceFormat(sampling_interval_, sites_, out);
+  }
+
+ private:
+  virtual ~SampledHeapHolder() {}
+
+  size_t sampling_interval_;
+  std::vector<SamplingHeapProfiler::Site> sites_;
+
+  DISALLOW_COPY_AND_ASSIGN(SampledHeapHolder);
+};
+
+bool CompareSitesByBytes(const SamplingHeapProfiler::Site& a,
+                         const SamplingHeapProfiler::Site& b) {
+  return a.estimated_bytes > b.estimated_bytes;
+}
+
+}  // namespace
+
+SamplingHeapProfiler::Site::Site()
+    : sampled_allocations(0),
+      estimated_bytes(0) {
+}
+
+SamplingHeapProfiler::Site::~Site() {
+}
+
+// static
+const size_t SamplingHeapProfiler::kDefaultSamplingInterval;
+
+SamplingHeapProfiler::SamplingHeapProfiler(
+    scoped_refptr<MessageLoopProxy> message_loop_proxy,
+    NewHookFunction add_new_hook_function,
+    NewHookFunction remove_new_hook_function,
+    DeleteHookFunction add_delete_hook_function,
+    DeleteHookFunction remove_delete_hook_function)
+    : message_loop_proxy_(message_loop_proxy),
+      add_new_hook_function_(add_new_hook_function),
+      remove_new_hook_function_(remove_new_hook_function),
+      add_delete_hook_function_(add_delete_hook_function),
+      remove_delete_hook_function_(remove_delete_hook_function),
+      sampling_interval_(kDefaultSamplingInterval),
+      profiling_(false),
+      weak_factory_(this) {
+  // Force the category to show up in the trace viewer.
+  TRACE_EVENT0(TRACE_DISABLED_BY_DEFAULT("memory.sampling"), "init");
+  TraceLog::GetInstance()->AddEnabledStateObserver(this);
+}
+
+SamplingHeapProfiler::~SamplingHeapProfiler() {
+  StopProfiling();
+  TraceLog::GetInstance()->RemoveEnabledStateObserver(this);
+}
+
+void SamplingHeapProfiler::OnTraceLogEnabled() {
+  bool enabled;
+  TRACE_EVENT_CATEGORY_GROUP_ENABLED(
+      TRACE_DISABLED_BY_DEFAULT("memory.sampling"), &enabled);
+  if (!enabled)
+    return;
+  message_loop_proxy_->PostTask(
+      FROM_HERE,
+      base::Bind(&SamplingHeapProfiler::StartProfiling,
+                 weak_factory_.GetWeakPtr()));
+}
+
+void SamplingHeapProfiler::OnTraceLogDisabled() {
+  // As with TraceMemoryController, the category is already disabled, so
+  // always try to stop.
+  message_loop_proxy_->PostTask(
+      FROM_HERE,
+      base::Bind(&SamplingHeapProfiler::StopProfiling,
+                 weak_factory_.GetWeakPtr()));
+}
+
+void SamplingHeapProfiler::StartProfiling() {
+  if (profiling_)
+    return;
+  DCHECK_GT(sampling_interval_, 0u);
+  DVLOG(1) << "Starting sampling heap profiler";
+
+  // Create the thread-local flag before any hook can need it.
+  g_in_profiler.Get();
+  {
+    AutoLock lock(g_lock.Get());
+    DCHECK(!g_samples) << "Only one SamplingHeapProfiler may run at a time";
+    g_samples = new SampleMap;
+    g_sampling_interval = sampling_interval_;
+    g_random_state = RandUint64() | 1;
+    subtle::NoBarrier_Store(&g_bytes_until_sample, NextSampleInterval());
+  }
+  add_new_hook_function_(&RecordAlloc);
+  add_delete_hook_function_(&RecordFree);
+  profiling_ = true;
+
+  dump_timer_.Start(FROM_HERE,
+                    TimeDelta::FromSeconds(kDumpIntervalSeconds),
+                    base::Bind(&SamplingHeapProfiler::DumpSamples,
+                               weak_factory_.GetWeakPtr()));
+}
+
+void SamplingHeapProfiler::DumpSamples() {
+  if (!profiling_)
+    return;
+  const int kSnapshotId = 1;
+  TRACE_EVENT_OBJECT_SNAPSHOT_WITH_ID(
+      TRACE_DISABLED_BY_DEFAULT("memory.sampling"),
+      "memory::SampledHeap",
+      kSnapshotId,
+      scoped_refptr<ConvertableToTraceFormat>(
+          new SampledHeapHolder(sampling_interval_, GetSites())));
+}
+
+void SamplingHeapProfiler::StopProfiling() {
+  if (!profiling_)
+    return;
+  DVLOG(1) << "Stopping sampling heap profiler";
+  dump_timer_.Stop();
+  remove_new_hook_function_(&RecordAlloc);
+  remove_delete_hook_function_(&RecordFree);
+  profiling_ = false;
+
+  SampleMap* samples;
+  {
+    AutoLock lock(g_lock.Get());
+    samples = g_samples;
+    g_samples = NULL;
+    for (size_t i = 0; i < kFilterSize; ++i)
+      subtle::NoBarrier_Store(&g_sampled_address_counts[i], 0);
+  }
+  delete samples;
+}
+
+std::vector<SamplingHeapProfiler::Site> SamplingHeapProfiler::GetSites()
+    const {
+  ThreadLocalBoolean& in_profiler = g_in_profiler.Get();
+  bool was_in_profiler = in_profiler.Get();
+  // Allocating while holding the lock is only safe with the flag set.
+  in_profiler.Set(true);
+
+  std::vector<Sample> samples;
+  {
+    AutoLock lock(g_lock.Get());
+    if (g_samples) {
+      samples.reserve(g_samples->size());
+      for (SampleMap::const_iterator it = g_samples->begin();
+           it != g_samples->end(); ++it) {
+        samples.push_back(it->second);
+      }
+    }
+  }
+
+  std::vector<Site> sites;
+  std::map<std::vector<const void*>, size_t> site_indices;
+  for (size_t i = 0; i < samples.size(); ++i) {
+    const Sample& sample = samples[i];
+    std::vector<const void*> frames(sample.frames,
+                                    sample.frames + sample.frame_count);
+    std::pair<std::map<std::vector<const void*>, size_t>::iterator, bool>
+        result = site_indices.insert(std::make_pair(frames, sites.size()));
+    if (result.second) {
+      sites.push_back(Site());
+      sites.back().frames.swap(frames);
+    }
+    Site& site = sites[result.first->second];
+    site.sampled_allocations++;
+    site.estimated_bytes += sample.estimated_bytes;
+  }
+  std::sort(sites.begin(), sites.end(), &CompareSitesByBytes);
+
+  in_profiler.Set(was_in_profiler);
+  return sites;
+}
+
+// static
+void SamplingHeapProfiler::RecordAlloc(const void* address, size_t size) {
+  if (!address)
+    return;
+  // A plain load and store rather than an atomic increment, which costs as
+  // much as the rest of the hook. Concurrent allocations may lose each
+  // other's updates, which only stretches the interval a little.
+  subtle::AtomicWord before = subtle::NoBarrier_Load(&g_bytes_until_sample);
+  subtle::AtomicWord left = before - static_cast<subtle::AtomicWord>(size);
+  subtle::NoBarrier_Store(&g_bytes_until_sample, left);
+  // Only the allocation which crosses zero takes a sample.
+  if (left > 0 || before <= 0)
+    return;
+  RecordSample(address, size);
+}
+
+// static
+void SamplingHeapProfiler::RecordFree(const void* address) {
+  if (!address)
+    return;
+  // Most frees are of addresses which were never sampled.
+  if (!subtle::NoBarrier_Load(&g_sampled_address_counts[FilterIndex(address)]))
+    return;
+  RemoveSample(address);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void AppendSampledHeapAsTraceFormat(
+    size_t sampling_interval,
+    const std::vector<SamplingHeapProfiler::Site>& sites,
+    std::string* output) {
+  // The output looks like this, with sites by decreasing size:
+  //
+  // {"sampling_interval": 131072, "estimated_bytes": 2621440, "sites": [
+  // {"samples": 12, "estimated_bytes": 1572864,
+  //  "stack": ["0x7fa7fa9b9ba0", "0x7fa7f4b3be13"]}, ...]}
+  uint64 total_bytes = 0;
+  for (size_t i = 0; i < sites.size(); ++i)
+    total_bytes += sites[i].estimated_bytes;
+
+  output->append(StringPrintf(
+      "{\"sampling_interval\": %" PRIuS ", \"estimated_bytes\": %" PRIu64
+      ", \"sites\": [",
+      sampling_interval, total_bytes));
+  for (size_t i = 0; i < sites.size(); ++i) {
+    const SamplingHeapProfiler::Site& site = sites[i];
+    if (i)
+      output->append(",");
+    output->append(StringPrintf(
+        "\n{\"samples\": %" PRIuS ", \"estimated_bytes\": %" PRIu64
+        ", \"stack\": [",
+        site.sampled_allocations, site.estimated_bytes));
+    for (size_t j = 0; j < site.frames.size(); ++j) {
+      if (j)
+        output->append(", ");
+      output->append(StringPrintf(
+          "\"0x%" PRIx64 "\"",
+          static_cast<uint64>(reinterpret_cast<uintptr_t>(site.frames[j]))));
+    }
+    output->append("]}");
+  }
+  output->append("]}\n");
+}
+
+}  // namespace debug
+}  // namespace base
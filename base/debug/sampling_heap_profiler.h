@@ -0,0 +1,131 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_DEBUG_SAMPLING_HEAP_PROFILER_H_
+#define BASE_DEBUG_SAMPLING_HEAP_PROFILER_H_
+
+#include <string>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/debug/trace_event_impl.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/timer/timer.h"
+
+namespace base {
+
+class MessageLoopProxy;
+
+namespace debug {
+
+// A heap profiler cheap enough to leave on in production. Rather than
+// recording every allocation, like the tcmalloc heap profiler behind
+// TraceMemoryController, it samples allocations as a Poisson process over
+// the allocated bytes, on average once every sampling_interval() bytes, and
+// records the native stack of the sampled ones. Between samples, the
+// allocation hook is a subtraction from a counter and the free hook a load
+// from a small table.
+//
+// While the "disabled-by-default-memory.sampling" trace category is enabled,
+// it emits a "memory::SampledHeap" snapshot to the TraceLog every few
+// seconds, with the estimated live bytes of each allocation stack.
+//
+// Only one profiler may run at a time.
+class BASE_EXPORT SamplingHeapProfiler
+    : public TraceLog::EnabledStateObserver {
+ public:
+  typedef void (*NewHook)(const void* address, size_t size);
+  typedef void (*DeleteHook)(const void* address);
+  typedef int (*NewHookFunction)(NewHook hook);
+  typedef int (*DeleteHookFunction)(DeleteHook hook);
+
+  // Live sampled allocations with the same stack.
+  struct Site {
+    Site();
+    ~Site();
+
+    std::vector<const void*> frames;
+    size_t sampled_allocations;
+    // The bytes the samples stand for: a sampled allocation of |size| bytes
+    // counts for size / (1 - exp(-size / sampling_interval)).
+    uint64 estimated_bytes;
+  };
+
+  static const size_t kDefaultSamplingInterval = 128 * 1024;
+
+  // |message_loop_proxy| must be a proxy to the primary thread of the
+  // process. The function pointers add and remove allocator hooks, such as
+  // tcmalloc's MallocHook_AddNewHook(); like TraceMemoryController, this
+  // avoids a dependency from base on the allocator.
+  SamplingHeapProfiler(
+      scoped_refptr<MessageLoopProxy> message_loop_proxy,
+      NewHookFunction add_new_hook_function,
+      NewHookFunction remove_new_hook_function,
+      DeleteHookFunction add_delete_hook_function,
+      DeleteHookFunction remove_delete_hook_function);
+  virtual ~SamplingHeapProfiler();
+
+  // base::debug::TraceLog::EnabledStateObserver overrides:
+  virtual void OnTraceLogEnabled() OVERRIDE;
+  virtual void OnTraceLogDisabled() OVERRIDE;
+
+  // The mean number of allocated bytes between samples. Changes take effect
+  // at the next StartProfiling().
+  size_t sampling_interval() const { return sampling_interval_; }
+  void set_sampling_interval(size_t sampling_interval) {
+    sampling_interval_ = sampling_interval;
+  }
+
+  // Installs the allocator hooks and starts dumping samples periodically.
+  void StartProfiling();
+
+  // Emits the live samples to the TraceLog.
+  void DumpSamples();
+
+  // Removes the allocator hooks and drops the samples.
+  void StopProfiling();
+
+  bool is_profiling() const { return profiling_; }
+
+  // Returns the live samples grouped by stack, most estimated bytes first.
+  std::vector<Site> GetSites() const;
+
+  // The allocator hooks. Public for testing.
+  static void RecordAlloc(const void* address, size_t size);
+  static void RecordFree(const void* address);
+
+ private:
+  // Ensures the observer starts and stops profiling on the primary thread.
+  scoped_refptr<MessageLoopProxy> message_loop_proxy_;
+
+  NewHookFunction add_new_hook_function_;
+  NewHookFunction remove_new_hook_function_;
+  DeleteHookFunction add_delete_hook_function_;
+  DeleteHookFunction remove_delete_hook_function_;
+
+  size_t sampling_interval_;
+  bool profiling_;
+
+  // Timer to schedule dumps.
+  RepeatingTimer<SamplingHeapProfiler> dump_timer_;
+
+  WeakPtrFactory<SamplingHeapProfiler> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(SamplingHeapProfiler);
+};
+
+// Converts |sites| to trace event compatible JSON and appends it to
+// |output|. Stacks are lists of hexadecimal addresses, to be symbolized
+// offline. Visible for testing.
+BASE_EXPORT void AppendSampledHeapAsTraceFormat(
+    size_t sampling_interval,
+    const std::vector<SamplingHeapProfiler::Site>& sites,
+    std::string* output);
+
+}  // namespace debug
+}  // namespace base
+
+#endif  // BASE_DEBUG_SAMPLING_HEAP_PROFILER_H_
@@ -0,0 +1,90 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdlib.h>
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/debug/sampling_heap_profiler.h"
+#include "base/message_loop/message_loop.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace base {
+namespace debug {
+
+namespace {
+
+const int kNumRounds = 200;
+const int kNumLiveAllocations = 10000;
+
+SamplingHeapProfiler::NewHook g_new_hook = NULL;
+SamplingHeapProfiler::DeleteHook g_delete_hook = NULL;
+
+int SetNewHook(SamplingHeapProfiler::NewHook hook) {
+  g_new_hook = hook;
+  return 1;
+}
+
+int ClearNewHook(SamplingHeapProfiler::NewHook hook) {
+  g_new_hook = NULL;
+  return 1;
+}
+
+int SetDeleteHook(SamplingHeapProfiler::DeleteHook hook) {
+  g_delete_hook = hook;
+  return 1;
+}
+
+int ClearDeleteHook(SamplingHeapProfiler::DeleteHook hook) {
+  g_delete_hook = NULL;
+  return 1;
+}
+
+// Allocates and frees |kNumLiveAllocations| blocks of varied small sizes
+// |kNumRounds| times, calling the hooks the way the allocator would.
+void AllocateAndFree(const std::string& name) {
+  std::vector<void*> blocks(kNumLiveAllocations);
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int round = 0; round < kNumRounds; ++round) {
+    for (int i = 0; i < kNumLiveAllocations; ++i) {
+      size_t size = 16 + (i & 255);
+      blocks[i] = malloc(size);
+      if (g_new_hook)
+        g_new_hook(blocks[i], size);
+    }
+    for (int i = 0; i < kNumLiveAllocations; ++i) {
+      if (g_delete_hook)
+        g_delete_hook(blocks[i]);
+      free(blocks[i]);
+    }
+  }
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+  perf_test::PrintResult(
+      "sampling_heap_profiler", "", name,
+      elapsed.InMicroseconds() * 1000.0 / (kNumRounds * kNumLiveAllocations),
+      "ns/malloc+free", true);
+}
+
+}  // namespace
+
+// Compares malloc() and free() without and with the sampling hooks.
+TEST(SamplingHeapProfilerPerfTest, HookOverhead) {
+  MessageLoop message_loop;
+  SamplingHeapProfiler profiler(message_loop.message_loop_proxy(),
+                                &SetNewHook, &ClearNewHook,
+                                &SetDeleteHook, &ClearDeleteHook);
+  AllocateAndFree("no_hooks");
+
+  profiler.StartProfiling();
+  AllocateAndFree("sampling");
+  profiler.StopProfiling();
+}
+
+}  // namespace debug
+}  // namespace base
@@ -0,0 +1,188 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/debug/sampling_heap_profiler.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "base/debug/trace_event_impl.h"
+#include "base/json/json_reader.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/message_loop/message_loop.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace debug {
+
+namespace {
+
+// Fake allocator hook registry, so that the tests drive the hooks by hand.
+SamplingHeapProfiler::NewHook g_new_hook = NULL;
+SamplingHeapProfiler::DeleteHook g_delete_hook = NULL;
+
+int AddNewHook(SamplingHeapProfiler::NewHook hook) {
+  g_new_hook = hook;
+  return 1;
+}
+
+int RemoveNewHook(SamplingHeapProfiler::NewHook hook) {
+  EXPECT_EQ(g_new_hook, hook);
+  g_new_hook = NULL;
+  return 1;
+}
+
+int AddDeleteHook(SamplingHeapProfiler::DeleteHook hook) {
+  g_delete_hook = hook;
+  return 1;
+}
+
+int RemoveDeleteHook(SamplingHeapProfiler::DeleteHook hook) {
+  EXPECT_EQ(g_delete_hook, hook);
+  g_delete_hook = NULL;
+  return 1;
+}
+
+const void* FakeAddress(size_t index) {
+  return reinterpret_cast<const void*>((index + 1) * 64);
+}
+
+uint64 TotalEstimatedBytes(const std::vector<SamplingHeapProfiler::Site>& s) {
+  uint64 total = 0;
+  for (size_t i = 0; i < s.size(); ++i)
+    total += s[i].estimated_bytes;
+  return total;
+}
+
+}  // namespace
+
+class SamplingHeapProfilerTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    profiler_.reset(new SamplingHeapProfiler(
+        message_loop_.message_loop_proxy(), &AddNewHook, &RemoveNewHook,
+        &AddDeleteHook, &RemoveDeleteHook));
+  }
+
+  virtual void TearDown() OVERRIDE {
+    profiler_.reset();
+    EXPECT_FALSE(g_new_hook);
+    EXPECT_FALSE(g_delete_hook);
+  }
+
+  MessageLoop message_loop_;
+  scoped_ptr<SamplingHeapProfiler> profiler_;
+};
+
+TEST_F(SamplingHeapProfilerTest, StartAndStop) {
+  EXPECT_TRUE(TraceLog::GetInstance()->HasEnabledStateObserver(
+      profiler_.get()));
+  EXPECT_FALSE(profiler_->is_profiling());
+  EXPECT_FALSE(g_new_hook);
+
+  profiler_->StartProfiling();
+  EXPECT_TRUE(profiler_->is_profiling());
+  EXPECT_EQ(&SamplingHeapProfiler::RecordAlloc, g_new_hook);
+  EXPECT_EQ(&SamplingHeapProfiler::RecordFree, g_delete_hook);
+
+  profiler_->StopProfiling();
+  EXPECT_FALSE(profiler_->is_profiling());
+  EXPECT_FALSE(g_new_hook);
+  EXPECT_FALSE(g_delete_hook);
+  EXPECT_TRUE(profiler_->GetSites().empty());
+}
+
+// Small allocations are sampled in proportion to their bytes, and the
+// estimate of the live bytes is close to the truth.
+TEST_F(SamplingHeapProfilerTest, EstimatesLiveBytes) {
+  const size_t kSamplingInterval = 1024;
+  const size_t kAllocationSize = 48;
+  const size_t kNumAllocations = 100000;
+  profiler_->set_sampling_interval(kSamplingInterval);
+  profiler_->StartProfiling();
+
+  for (size_t i = 0; i < kNumAllocations; ++i)
+    g_new_hook(FakeAddress(i), kAllocationSize);
+
+  std::vector<SamplingHeapProfiler::Site> sites = profiler_->GetSites();
+  // All the allocations come from the same loop, but the stacks of the
+  // samples may differ in the frames above it.
+  ASSERT_FALSE(sites.empty());
+  size_t sampled = 0;
+  for (size_t i = 0; i < sites.size(); ++i)
+    sampled += sites[i].sampled_allocations;
+  const double kExpectedSamples =
+      kNumAllocations * kAllocationSize / kSamplingInterval;
+  EXPECT_GT(sampled, kExpectedSamples * 0.9);
+  EXPECT_LT(sampled, kExpectedSamples * 1.1);
+
+  const double kLiveBytes = kNumAllocations * kAllocationSize;
+  EXPECT_GT(TotalEstimatedBytes(sites), kLiveBytes * 0.9);
+  EXPECT_LT(TotalEstimatedBytes(sites), kLiveBytes * 1.1);
+
+  // Freeing half of the allocations halves the estimate.
+  for (size_t i = 0; i < kNumAllocations; i += 2)
+    g_delete_hook(FakeAddress(i));
+  sites = profiler_->GetSites();
+  EXPECT_GT(TotalEstimatedBytes(sites), kLiveBytes * 0.4);
+  EXPECT_LT(TotalEstimatedBytes(sites), kLiveBytes * 0.6);
+
+  for (size_t i = 1; i < kNumAllocations; i += 2)
+    g_delete_hook(FakeAddress(i));
+  EXPECT_TRUE(profiler_->GetSites().empty());
+}
+
+// An allocation much larger than the sampling interval is always sampled,
+// and counts for its own size.
+TEST_F(SamplingHeapProfilerTest, LargeAllocationsAreAlwaysSampled) {
+  const size_t kLargeSize = 16 * 1024 * 1024;
+  profiler_->StartProfiling();
+  for (size_t i = 0; i < 3; ++i)
+    g_new_hook(FakeAddress(i), kLargeSize);
+
+  std::vector<SamplingHeapProfiler::Site> sites = profiler_->GetSites();
+  ASSERT_EQ(1u, sites.size());
+  EXPECT_EQ(3u, sites[0].sampled_allocations);
+  EXPECT_EQ(3 * kLargeSize, sites[0].estimated_bytes);
+  EXPECT_FALSE(sites[0].frames.empty());
+
+  // Frees of unknown addresses are ignored.
+  g_delete_hook(FakeAddress(100));
+  g_delete_hook(NULL);
+  EXPECT_EQ(1u, profiler_->GetSites().size());
+
+  g_delete_hook(FakeAddress(1));
+  sites = profiler_->GetSites();
+  ASSERT_EQ(1u, sites.size());
+  EXPECT_EQ(2u, sites[0].sampled_allocations);
+}
+
+TEST_F(SamplingHeapProfilerTest, AppendSampledHeapAsTraceFormat) {
+  std::vector<SamplingHeapProfiler::Site> sites(2);
+  sites[0].frames.push_back(reinterpret_cast<const void*>(0x1234));
+  sites[0].frames.push_back(reinterpret_cast<const void*>(0xabcd));
+  sites[0].sampled_allocations = 3;
+  sites[0].estimated_bytes = 4000;
+  sites[1].sampled_allocations = 1;
+  sites[1].estimated_bytes = 1000;
+
+  std::string output;
+  AppendSampledHeapAsTraceFormat(1024, sites, &output);
+  EXPECT_EQ("{\"sampling_interval\": 1024, \"estimated_bytes\": 5000, "
+            "\"sites\": [\n"
+            "{\"samples\": 3, \"estimated_bytes\": 4000, "
+            "\"stack\": [\"0x1234\", \"0xabcd\"]},\n"
+            "{\"samples\": 1, \"estimated_bytes\": 1000, \"stack\": []}]}\n",
+            output);
+
+  scoped_ptr<Value> value(JSONReader::Read(output));
+  ASSERT_TRUE(value.get());
+  EXPECT_TRUE(value->IsType(Value::TYPE_DICTIONARY));
+}
+
+}  // namespace debug
+}  // namespace base
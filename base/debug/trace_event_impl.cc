@@ -12,12 +12,14 @@
 #include "base/debug/leak_annotations.h"
 #include "base/debug/trace_event.h"
 #include "base/debug/trace_event_synthetic_delay.h"
+#include "base/file_util.h"
 #include "base/float_util.h"
 #include "base/format_macros.h"
 #include "base/json/string_escape.h"
 #include "base/lazy_instance.h"
 #include "base/memory/singleton.h"
 #include "base/message_loop/message_loop.h"
+#include "base/pickle.h"
 #include "base/process/process_metrics.h"
 #include "base/stl_util.h"
 #include "base/strings/string_number_conversions.h"
@@ -68,6 +70,9 @@ const size_t kTraceEventBatchChunks = 1000 / kTraceBufferChunkSize;
 const size_t kMonitorTraceEventBufferChunks = 30000 / kTraceBufferChunkSize;
 // ECHO_TO_CONSOLE needs a small buffer to hold the unfinished COMPLETE events.
 const size_t kEchoToConsoleTraceEventBufferChunks = 256;
+// When streaming to a file, only the most recent chunks are kept in memory so
+// that COMPLETE events can still be updated.
+const size_t kStreamingTraceEventBufferChunks = 256;
 
 const int kThreadFlushTimeoutMs = 3000;
 
@@ -115,6 +120,96 @@ TimeTicks ThreadNow() {
       TimeTicks::ThreadNow() : TimeTicks();
 }
 
+// Writes the chunks it is given to a file in the format of
+// TraceEvent::AppendAsBinary(), on a thread of its own. The thread doesn't run
+// a message loop: posting a task may add trace events, which would deadlock
+// when chunks are handed over with TraceLog::lock_ held.
+class TraceFileWriter : public PlatformThread::Delegate {
+ public:
+  explicit TraceFileWriter(const FilePath& file_path)
+      : file_path_(file_path),
+        file_(NULL),
+        cond_var_(&lock_),
+        stopping_(false) {
+    if (!PlatformThread::Create(0, this, &thread_handle_))
+      DCHECK(false) << "failed to create thread";
+  }
+
+  // Writes the chunks that are still pending before returning.
+  virtual ~TraceFileWriter() {
+    {
+      AutoLock lock(lock_);
+      stopping_ = true;
+    }
+    cond_var_.Signal();
+    PlatformThread::Join(thread_handle_);
+  }
+
+  // Can be called from any thread, including with TraceLog::lock_ held.
+  void AddChunk(scoped_ptr<TraceBufferChunk> chunk) {
+    {
+      AutoLock lock(lock_);
+      pending_chunks_.push_back(chunk.release());
+    }
+    cond_var_.Signal();
+  }
+
+  // Implementation of PlatformThread::Delegate:
+  virtual void ThreadMain() OVERRIDE {
+    PlatformThread::SetName("TraceFileWriter");
+    while (true) {
+      ScopedVector<TraceBufferChunk> chunks;
+      bool stopping;
+      {
+        AutoLock lock(lock_);
+        while (pending_chunks_.empty() && !stopping_)
+          cond_var_.Wait();
+        chunks.swap(pending_chunks_);
+        stopping = stopping_;
+      }
+      WriteChunks(chunks.get());
+      if (stopping)
+        break;
+    }
+    if (file_)
+      CloseFile(file_);
+  }
+
+ private:
+  void WriteChunks(const std::vector<TraceBufferChunk*>& chunks) {
+    if (chunks.empty())
+      return;
+    // The file is opened lazily so that a writer that never gets any chunk
+    // doesn't truncate the file of the writer that replaced it.
+    if (!file_) {
+      file_ = OpenFile(file_path_, "wb");
+      if (!file_) {
+        LOG(ERROR) << "Failed to open trace file " << file_path_.value();
+        return;
+      }
+    }
+    std::string data;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+      for (size_t j = 0; j < chunks[i]->size(); ++j)
+        chunks[i]->GetEventAt(j)->AppendAsBinary(&data);
+    }
+    if (fwrite(data.data(), 1, data.size(), file_) != data.size())
+      LOG(ERROR) << "Failed to write trace file " << file_path_.value();
+  }
+
+  const FilePath file_path_;
+  // Only accessed on the writer thread.
+  FILE* file_;
+  PlatformThreadHandle thread_handle_;
+
+  Lock lock_;
+  ConditionVariable cond_var_;
+  ScopedVector<TraceBufferChunk> pending_chunks_;
+  bool stopping_;
+
+  DISALLOW_COPY_AND_ASSIGN(TraceFileWriter);
+};
+
 class TraceBufferRingBuffer : public TraceBuffer {
  public:
   TraceBufferRingBuffer(size_t max_chunks)
@@ -129,6 +224,35 @@ class TraceBufferRingBuffer : public TraceBuffer {
       recyclable_chunks_queue_[i] = i;
   }
 
+  // Instead of being overwritten, the oldest chunks are handed to
+  // |file_writer|, and so are the remaining ones when the buffer is deleted.
+  TraceBufferRingBuffer(size_t max_chunks,
+                        scoped_ptr<TraceFileWriter> file_writer)
+      : max_chunks_(max_chunks),
+        recyclable_chunks_queue_(new size_t[queue_capacity()]),
+        queue_head_(0),
+        queue_tail_(max_chunks),
+        current_iteration_index_(0),
+        current_chunk_seq_(1),
+        file_writer_(file_writer.Pass()) {
+    chunks_.reserve(max_chunks);
+    for (size_t i = 0; i < max_chunks; ++i)
+      recyclable_chunks_queue_[i] = i;
+  }
+
+  virtual ~TraceBufferRingBuffer() {
+    if (!file_writer_)
+      return;
+    for (size_t queue_index = queue_head_; queue_index != queue_tail_;
+        queue_index = NextQueueIndex(queue_index)) {
+      size_t chunk_index = recyclable_chunks_queue_[queue_index];
+      if (chunk_index >= chunks_.size() || !chunks_[chunk_index])
+        continue;
+      file_writer_->AddChunk(make_scoped_ptr(chunks_[chunk_index]));
+      chunks_[chunk_index] = NULL;
+    }
+  }
+
   virtual scoped_ptr<TraceBufferChunk> GetChunk(size_t* index) OVERRIDE {
     // Because the number of threads is much less than the number of chunks,
     // the queue should never be empty.
@@ -143,6 +267,10 @@ class TraceBufferRingBuffer : public TraceBuffer {
 
     TraceBufferChunk* chunk = chunks_[*index];
     chunks_[*index] = NULL;  // Put NULL in the slot of a in-flight chunk.
+    if (chunk && file_writer_) {
+      file_writer_->AddChunk(make_scoped_ptr(chunk));
+      chunk = NULL;
+    }
     if (chunk)
       chunk->Reset(current_chunk_seq_++);
     else
@@ -187,7 +315,8 @@ class TraceBufferRingBuffer : public TraceBuffer {
   }
 
   virtual const TraceBufferChunk* NextChunk() OVERRIDE {
-    if (chunks_.empty())
+    // All the events go to the file when streaming.
+    if (chunks_.empty() || file_writer_)
       return NULL;
 
     while (current_iteration_index_ != queue_tail_) {
@@ -283,6 +412,8 @@ class TraceBufferRingBuffer : public TraceBuffer {
   size_t current_iteration_index_;
   uint32 current_chunk_seq_;
 
+  scoped_ptr<TraceFileWriter> file_writer_;
+
   DISALLOW_COPY_AND_ASSIGN(TraceBufferRingBuffer);
 };
 
@@ -763,6 +894,210 @@ void TraceEvent::AppendAsJSON(std::string* out) const {
   *out += "}";
 }
 
+void TraceEvent::AppendAsBinary(std::string* out) const {
+  Pickle pickle;
+  pickle.WriteString(TraceLog::GetCategoryGroupName(category_group_enabled_));
+  pickle.WriteInt(TraceLog::GetInstance()->process_id());
+  pickle.WriteInt(thread_id_);
+  pickle.WriteInt64(timestamp_.ToInternalValue());
+  pickle.WriteInt64(thread_timestamp_.ToInternalValue());
+  pickle.WriteInt64(duration_.ToInternalValue());
+  pickle.WriteInt64(thread_duration_.ToInternalValue());
+  pickle.WriteUInt64(static_cast<uint64>(id_));
+  pickle.WriteInt(phase_);
+  pickle.WriteInt(flags_);
+  pickle.WriteString(name_);
+
+  int num_args = 0;
+  while (num_args < kTraceMaxNumArgs && arg_names_[num_args])
+    ++num_args;
+  pickle.WriteInt(num_args);
+  for (int i = 0; i < num_args; ++i) {
+    pickle.WriteString(arg_names_[i]);
+    pickle.WriteInt(arg_types_[i]);
+    switch (arg_types_[i]) {
+      case TRACE_VALUE_TYPE_CONVERTABLE: {
+        std::string value;
+        convertable_values_[i]->AppendAsTraceFormat(&value);
+        pickle.WriteString(value);
+        break;
+      }
+      case TRACE_VALUE_TYPE_STRING:
+      case TRACE_VALUE_TYPE_COPY_STRING:
+        pickle.WriteString(arg_values_[i].as_string ?
+                           arg_values_[i].as_string : "NULL");
+        break;
+      case TRACE_VALUE_TYPE_POINTER:
+        // Same as AppendValueAsJSON(), so that the JSON output matches.
+        pickle.WriteUInt64(static_cast<uint64>(
+            reinterpret_cast<intptr_t>(arg_values_[i].as_pointer)));
+        break;
+      default:
+        pickle.WriteUInt64(arg_values_[i].as_uint);
+        break;
+    }
+  }
+
+  uint32 record_size = static_cast<uint32>(pickle.size());
+  out->append(reinterpret_cast<const char*>(&record_size),
+              sizeof(record_size));
+  out->append(static_cast<const char*>(pickle.data()), pickle.size());
+}
+
+// static
+bool TraceEvent::AppendBinaryEventsAsJSON(const std::string& binary,
+                                          std::string* out) {
+  size_t offset = 0;
+  bool first = true;
+  while (offset < binary.size()) {
+    uint32 record_size;
+    if (binary.size() - offset < sizeof(record_size))
+      return false;
+    memcpy(&record_size, binary.data() + offset, sizeof(record_size));
+    offset += sizeof(record_size);
+    if (binary.size() - offset < record_size)
+      return false;
+
+    // Pickle reads its header in place, so copy records that are not aligned
+    // the way Pickle writes them.
+    std::string aligned_record;
+    const char* record = binary.data() + offset;
+    if (reinterpret_cast<uintptr_t>(record) % sizeof(uint32)) {
+      aligned_record.assign(record, record_size);
+      record = aligned_record.data();
+    }
+    offset += record_size;
+
+    Pickle pickle(record, static_cast<int>(record_size));
+    PickleIterator iter(pickle);
+    std::string category;
+    std::string name;
+    int process_id;
+    int thread_id;
+    int64 timestamp;
+    int64 thread_timestamp;
+    int64 duration;
+    int64 thread_duration;
+    uint64 id;
+    int phase;
+    int flags;
+    int num_args;
+    if (!pickle.ReadString(&iter, &category) ||
+        !pickle.ReadInt(&iter, &process_id) ||
+        !pickle.ReadInt(&iter, &thread_id) ||
+        !pickle.ReadInt64(&iter, &timestamp) ||
+        !pickle.ReadInt64(&iter, &thread_timestamp) ||
+        !pickle.ReadInt64(&iter, &duration) ||
+        !pickle.ReadInt64(&iter, &thread_duration) ||
+        !pickle.ReadUInt64(&iter, &id) ||
+        !pickle.ReadInt(&iter, &phase) ||
+        !pickle.ReadInt(&iter, &flags) ||
+        !pickle.ReadString(&iter, &name) ||
+        !pickle.ReadInt(&iter, &num_args) ||
+        num_args < 0 || num_args > kTraceMaxNumArgs) {
+      return false;
+    }
+
+    if (!first)
+      *out += ",";
+    first = false;
+
+    // Keep in sync with AppendAsJSON().
+    StringAppendF(out,
+        "{\"cat\":\"%s\",\"pid\":%i,\"tid\":%i,\"ts\":%" PRId64 ","
+        "\"ph\":\"%c\",\"name\":\"%s\",\"args\":{",
+        category.c_str(),
+        process_id,
+        thread_id,
+        timestamp,
+        static_cast<char>(phase),
+        name.c_str());
+
+    for (int i = 0; i < num_args; ++i) {
+      std::string arg_name;
+      int arg_type;
+      if (!pickle.ReadString(&iter, &arg_name) ||
+          !pickle.ReadInt(&iter, &arg_type)) {
+        return false;
+      }
+      if (i > 0)
+        *out += ",";
+      *out += "\"";
+      *out += arg_name;
+      *out += "\":";
+
+      switch (arg_type) {
+        case TRACE_VALUE_TYPE_CONVERTABLE: {
+          std::string value;
+          if (!pickle.ReadString(&iter, &value))
+            return false;
+          *out += value;
+          break;
+        }
+        case TRACE_VALUE_TYPE_STRING:
+        case TRACE_VALUE_TYPE_COPY_STRING: {
+          std::string value;
+          if (!pickle.ReadString(&iter, &value))
+            return false;
+          EscapeJSONString(value, true, out);
+          break;
+        }
+        case TRACE_VALUE_TYPE_POINTER: {
+          uint64 value;
+          if (!pickle.ReadUInt64(&iter, &value))
+            return false;
+          StringAppendF(out, "\"0x%" PRIx64 "\"", value);
+          break;
+        }
+        default: {
+          uint64 bits;
+          if (!pickle.ReadUInt64(&iter, &bits))
+            return false;
+          TraceValue value;
+          value.as_uint = bits;
+          AppendValueAsJSON(static_cast<unsigned char>(arg_type), value, out);
+          break;
+        }
+      }
+    }
+    *out += "}";
+
+    if (phase == TRACE_EVENT_PHASE_COMPLETE) {
+      if (duration != -1)
+        StringAppendF(out, ",\"dur\":%" PRId64, duration);
+      if (thread_timestamp && thread_duration != -1)
+        StringAppendF(out, ",\"tdur\":%" PRId64, thread_duration);
+    }
+
+    if (thread_timestamp)
+      StringAppendF(out, ",\"tts\":%" PRId64, thread_timestamp);
+
+    if (flags & TRACE_EVENT_FLAG_HAS_ID)
+      StringAppendF(out, ",\"id\":\"0x%" PRIx64 "\"", id);
+
+    if (phase == TRACE_EVENT_PHASE_INSTANT) {
+      char scope = '?';
+      switch (flags & TRACE_EVENT_FLAG_SCOPE_MASK) {
+        case TRACE_EVENT_SCOPE_GLOBAL:
+          scope = TRACE_EVENT_SCOPE_NAME_GLOBAL;
+          break;
+
+        case TRACE_EVENT_SCOPE_PROCESS:
+          scope = TRACE_EVENT_SCOPE_NAME_PROCESS;
+          break;
+
+        case TRACE_EVENT_SCOPE_THREAD:
+          scope = TRACE_EVENT_SCOPE_NAME_THREAD;
+          break;
+      }
+      StringAppendF(out, ",\"s\":\"%c\"", scope);
+    }
+
+    *out += "}";
+  }
+  return true;
+}
+
 void TraceEvent::AppendPrettyPrinted(std::ostringstream* out) const {
   *out << name_ << "[";
   *out << TraceLog::GetCategoryGroupName(category_group_enabled_);
@@ -1055,13 +1390,11 @@ TraceEvent* TraceLog::ThreadLocalEventBuffer::AddTraceEvent(
     TraceEventHandle* handle) {
   CheckThisIsCurrentBuffer();
 
-  if (chunk_ && chunk_->IsFull()) {
+  if (!chunk_ || chunk_->IsFull()) {
+    // Hand the full chunk back and get the next one with a single acquisition
+    // of the lock, which is shared with every other tracing thread.
     AutoLock lock(trace_log_->lock_);
     FlushWhileLocked();
-    chunk_.reset();
-  }
-  if (!chunk_) {
-    AutoLock lock(trace_log_->lock_);
     chunk_ = trace_log_->logged_events_->GetChunk(&chunk_index_);
     trace_log_->CheckIfBufferIsFullWhileLocked();
   }
@@ -1140,6 +1473,7 @@ TraceLog::TraceLog()
       event_callback_category_filter_(
           CategoryFilter::kDefaultCategoryFilterString),
       thread_shared_chunk_index_(0),
+      flush_format_(FLUSH_FORMAT_JSON),
       generation_(0) {
   // Trace is enabled or disabled on one thread while other threads are
   // accessing the enabled flag. We don't care whether edge-case events are
@@ -1386,6 +1720,14 @@ void TraceLog::SetEnabled(const CategoryFilter& category_filter,
   }
 }
 
+void TraceLog::SetStreamingFile(const FilePath& file_path) {
+  AutoLock lock(lock_);
+  DCHECK(!IsEnabled());
+  DCHECK(!flush_message_loop_proxy_.get());
+  streaming_file_path_ = file_path;
+  UseNextTraceBuffer();
+}
+
 CategoryFilter TraceLog::GetCurrentCategoryFilter() {
   AutoLock lock(lock_);
   return category_filter_;
@@ -1481,6 +1823,11 @@ bool TraceLog::BufferIsFull() const {
 
 TraceBuffer* TraceLog::CreateTraceBuffer() {
   Options options = trace_options();
+  if (!streaming_file_path_.empty()) {
+    return new TraceBufferRingBuffer(
+        kStreamingTraceEventBufferChunks,
+        make_scoped_ptr(new TraceFileWriter(streaming_file_path_)));
+  }
   if (options & RECORD_CONTINUOUSLY)
     return new TraceBufferRingBuffer(kTraceEventRingBufferChunks);
   else if ((options & ENABLE_SAMPLING) && mode_ == MONITORING_MODE)
@@ -1549,6 +1896,11 @@ void TraceLog::SetEventCallbackDisabled() {
 //    If this is the last message loop, finish the flush;
 // 4. If any thread hasn't finish its flush in time, finish the flush.
 void TraceLog::Flush(const TraceLog::OutputCallback& cb) {
+  Flush(cb, FLUSH_FORMAT_JSON);
+}
+
+void TraceLog::Flush(const TraceLog::OutputCallback& cb,
+                     FlushFormat format) {
   if (IsEnabled()) {
     // Can't flush when tracing is enabled because otherwise PostTask would
     // - generate more trace events;
@@ -1568,6 +1920,7 @@ void TraceLog::Flush(const TraceLog::OutputCallback& cb) {
     flush_message_loop_proxy_ = MessageLoopProxy::current();
     DCHECK(!thread_message_loops_.size() || flush_message_loop_proxy_.get());
     flush_output_callback_ = cb;
+    flush_format_ = format;
 
     if (thread_shared_chunk_) {
       logged_events_->ReturnChunk(thread_shared_chunk_index_,
@@ -1595,7 +1948,8 @@ void TraceLog::Flush(const TraceLog::OutputCallback& cb) {
 
 void TraceLog::ConvertTraceEventsToTraceFormat(
     scoped_ptr<TraceBuffer> logged_events,
-    const TraceLog::OutputCallback& flush_output_callback) {
+    const TraceLog::OutputCallback& flush_output_callback,
+    FlushFormat flush_format) {
 
   if (flush_output_callback.is_null())
     return;
@@ -1614,6 +1968,10 @@ void TraceLog::ConvertTraceEventsToTraceFormat(
         break;
       }
       for (size_t j = 0; j < chunk->size(); ++j) {
+        if (flush_format == FLUSH_FORMAT_BINARY) {
+          chunk->GetEventAt(j)->AppendAsBinary(&(json_events_str_ptr->data()));
+          continue;
+        }
         if (i > 0 || j > 0)
           json_events_str_ptr->data().append(",");
         chunk->GetEventAt(j)->AppendAsJSON(&(json_events_str_ptr->data()));
@@ -1627,6 +1985,7 @@ void TraceLog::ConvertTraceEventsToTraceFormat(
 void TraceLog::FinishFlush(int generation) {
   scoped_ptr<TraceBuffer> previous_logged_events;
   OutputCallback flush_output_callback;
+  FlushFormat flush_format;
 
   if (!CheckGeneration(generation))
     return;
@@ -1635,16 +1994,18 @@ void TraceLog::FinishFlush(int generation) {
     AutoLock lock(lock_);
 
     previous_logged_events.swap(logged_events_);
+    streaming_file_path_.clear();
     UseNextTraceBuffer();
     thread_message_loops_.clear();
 
     flush_message_loop_proxy_ = NULL;
     flush_output_callback = flush_output_callback_;
     flush_output_callback_.Reset();
+    flush_format = flush_format_;
   }
 
   ConvertTraceEventsToTraceFormat(previous_logged_events.Pass(),
-                                  flush_output_callback);
+                                  flush_output_callback, flush_format);
 }
 
 // Run in each thread holding a local event buffer.
@@ -1707,7 +2068,7 @@ void TraceLog::FlushButLeaveBufferIntact(
   }  // release lock
 
   ConvertTraceEventsToTraceFormat(previous_logged_events.Pass(),
-                                  flush_output_callback);
+                                  flush_output_callback, FLUSH_FORMAT_JSON);
 }
 
 void TraceLog::UseNextTraceBuffer() {
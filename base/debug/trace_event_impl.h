@@ -13,6 +13,7 @@
 #include "base/atomicops.h"
 #include "base/callback.h"
 #include "base/containers/hash_tables.h"
+#include "base/files/file_path.h"
 #include "base/gtest_prod_util.h"
 #include "base/memory/ref_counted_memory.h"
 #include "base/memory/scoped_vector.h"
@@ -128,6 +129,17 @@ class BASE_EXPORT TraceEvent {
   void AppendAsJSON(std::string* out) const;
   void AppendPrettyPrinted(std::ostringstream* out) const;
 
+  // Serialize event data to a length-prefixed binary record. The record is
+  // self-contained: strings are copied and convertable arguments are stored in
+  // trace format, so it can be converted to JSON in another process.
+  void AppendAsBinary(std::string* out) const;
+
+  // Converts the records written by one or more calls to AppendAsBinary() to
+  // the comma-separated JSON that AppendAsJSON() would have written for the
+  // same events. Returns false if |binary| is malformed.
+  static bool AppendBinaryEventsAsJSON(const std::string& binary,
+                                       std::string* out);
+
   static void AppendValueAsJSON(unsigned char type,
                                 TraceValue value,
                                 std::string* out);
@@ -483,6 +495,16 @@ class BASE_EXPORT TraceLog {
                                EventCallback cb);
   void SetEventCallbackDisabled();
 
+  // Output format of Flush().
+  enum FlushFormat {
+    // Comma-separated JSON events, see TraceResultBuffer.
+    FLUSH_FORMAT_JSON,
+    // Records written by TraceEvent::AppendAsBinary(). This skips the JSON
+    // conversion, which dominates the flush of large captures. Use
+    // TraceEvent::AppendBinaryEventsAsJSON() to convert them later.
+    FLUSH_FORMAT_BINARY,
+  };
+
   // Flush all collected events to the given output callback. The callback will
   // be called one or more times either synchronously or asynchronously from
   // the current thread with IPC-bite-size chunks. The string format is
@@ -495,6 +517,16 @@ class BASE_EXPORT TraceLog {
   typedef base::Callback<void(const scoped_refptr<base::RefCountedString>&,
                               bool has_more_events)> OutputCallback;
   void Flush(const OutputCallback& cb);
+  // Like Flush(), but the events are passed to |cb| in |format|.
+  void Flush(const OutputCallback& cb, FlushFormat format);
+
+  // Streams the events of the next trace to |file_path| as the trace buffer
+  // fills up, instead of keeping them in memory until Flush(). The file holds
+  // the records of TraceEvent::AppendAsBinary(), written on a background
+  // thread; only the most recent chunks stay in memory. The next Flush()
+  // writes the remaining events to the file, passes no events to its callback,
+  // and ends the streaming. Must be called while tracing is disabled.
+  void SetStreamingFile(const FilePath& file_path);
   void FlushButLeaveBufferIntact(const OutputCallback& flush_output_callback);
 
   // Called by TRACE_EVENT* macros, don't call this directly.
@@ -648,7 +680,8 @@ class BASE_EXPORT TraceLog {
   // is called for the flush of the current |logged_events_|.
   void FlushCurrentThread(int generation);
   void ConvertTraceEventsToTraceFormat(scoped_ptr<TraceBuffer> logged_events,
-      const TraceLog::OutputCallback& flush_output_callback);
+      const TraceLog::OutputCallback& flush_output_callback,
+      FlushFormat flush_format);
   void FinishFlush(int generation);
   void OnFlushTimeout(int generation);
 
@@ -726,8 +759,12 @@ class BASE_EXPORT TraceLog {
   scoped_ptr<TraceBufferChunk> thread_shared_chunk_;
   size_t thread_shared_chunk_index_;
 
+  // Set by SetStreamingFile() until the next Flush().
+  FilePath streaming_file_path_;
+
   // Set when asynchronous Flush is in progress.
   OutputCallback flush_output_callback_;
+  FlushFormat flush_format_;
   scoped_refptr<MessageLoopProxy> flush_message_loop_proxy_;
   subtle::AtomicWord generation_;
 
@@ -11,6 +11,8 @@
 #include "base/command_line.h"
 #include "base/debug/trace_event.h"
 #include "base/debug/trace_event_synthetic_delay.h"
+#include "base/file_util.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
 #include "base/memory/ref_counted_memory.h"
@@ -56,6 +58,10 @@ class TraceEventTestFixture : public testing::Test {
       WaitableEvent* flush_complete_event,
       const scoped_refptr<base::RefCountedString>& events_str,
       bool has_more_events);
+  void OnBinaryTraceDataCollected(
+      WaitableEvent* flush_complete_event,
+      const scoped_refptr<base::RefCountedString>& events_str,
+      bool has_more_events);
   void OnWatchEventMatched() {
     ++event_watch_notification_;
   }
@@ -112,6 +118,19 @@ class TraceEventTestFixture : public testing::Test {
                    base::Unretained(flush_complete_event)));
   }
 
+  // Same as EndTraceAndFlush(), but the events go through the binary flush
+  // format and are converted back to JSON.
+  void EndTraceAndFlushBinary() {
+    WaitableEvent flush_complete_event(false, false);
+    TraceLog::GetInstance()->SetDisabled();
+    TraceLog::GetInstance()->Flush(
+        base::Bind(&TraceEventTestFixture::OnBinaryTraceDataCollected,
+                   base::Unretained(static_cast<TraceEventTestFixture*>(this)),
+                   base::Unretained(&flush_complete_event)),
+        TraceLog::FLUSH_FORMAT_BINARY);
+    flush_complete_event.Wait();
+  }
+
   void FlushMonitoring() {
     WaitableEvent flush_complete_event(false, false);
     FlushMonitoring(&flush_complete_event);
@@ -191,6 +210,17 @@ void TraceEventTestFixture::OnTraceDataCollected(
     flush_complete_event->Signal();
 }
 
+void TraceEventTestFixture::OnBinaryTraceDataCollected(
+    WaitableEvent* flush_complete_event,
+    const scoped_refptr<base::RefCountedString>& events_str,
+    bool has_more_events) {
+  scoped_refptr<base::RefCountedString> json_events_str =
+      new base::RefCountedString;
+  ASSERT_TRUE(TraceEvent::AppendBinaryEventsAsJSON(events_str->data(),
+                                                   &json_events_str->data()));
+  OnTraceDataCollected(flush_complete_event, json_events_str, has_more_events);
+}
+
 static bool CompareJsonValues(const std::string& lhs,
                               const std::string& rhs,
                               CompareOp op) {
@@ -867,6 +897,105 @@ TEST_F(TraceEventTestFixture, DataCaptured) {
   ValidateAllTraceMacrosCreatedData(trace_parsed_);
 }
 
+// Test that the binary flush format carries the same data as the JSON one.
+TEST_F(TraceEventTestFixture, DataCapturedWithBinaryFlush) {
+  TraceLog::GetInstance()->SetEnabled(CategoryFilter("*"),
+                                      base::debug::TraceLog::RECORDING_MODE,
+                                      TraceLog::RECORD_UNTIL_FULL);
+
+  TraceWithAllMacroVariants(NULL);
+
+  EndTraceAndFlushBinary();
+
+  ValidateAllTraceMacrosCreatedData(trace_parsed_);
+}
+
+// Test that converting a binary record gives the exact JSON of the event.
+TEST_F(TraceEventTestFixture, BinaryEventMatchesJSON) {
+  const unsigned char* category_group_enabled =
+      TraceLog::GetCategoryGroupEnabled("binary");
+  const char* arg_names[2] = { "ptr", "str" };
+  const unsigned char arg_types[2] = { TRACE_VALUE_TYPE_POINTER,
+                                       TRACE_VALUE_TYPE_STRING };
+  unsigned long long arg_values[2];
+  arg_values[0] = static_cast<unsigned long long>(
+      reinterpret_cast<intptr_t>(&arg_values));
+  arg_values[1] = static_cast<unsigned long long>(
+      reinterpret_cast<intptr_t>("a \"quoted\" string"));
+
+  TraceEvent event;
+  event.Initialize(kThreadId,
+                   TimeTicks::FromInternalValue(12345),
+                   TimeTicks::FromInternalValue(678),
+                   TRACE_EVENT_PHASE_COMPLETE,
+                   category_group_enabled, "name", kAsyncId,
+                   2, arg_names, arg_types, arg_values, NULL,
+                   TRACE_EVENT_FLAG_HAS_ID);
+  event.UpdateDuration(TimeTicks::FromInternalValue(12400),
+                       TimeTicks::FromInternalValue(700));
+
+  std::string json;
+  event.AppendAsJSON(&json);
+
+  std::string binary;
+  event.AppendAsBinary(&binary);
+  event.AppendAsBinary(&binary);
+  std::string converted;
+  ASSERT_TRUE(TraceEvent::AppendBinaryEventsAsJSON(binary, &converted));
+  EXPECT_EQ(json + "," + json, converted);
+
+  // Truncated input is rejected.
+  converted.clear();
+  EXPECT_FALSE(TraceEvent::AppendBinaryEventsAsJSON(
+      binary.substr(0, binary.size() - 1), &converted));
+}
+
+// Test that a streamed trace holds all the events, even when there are many
+// more of them than the streaming buffer keeps in memory.
+TEST_F(TraceEventTestFixture, StreamingFile) {
+  ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  FilePath trace_file = temp_dir.path().AppendASCII("trace.bin");
+  TraceLog::GetInstance()->SetStreamingFile(trace_file);
+
+  BeginTrace();
+  TraceWithAllMacroVariants(NULL);
+  const int kNumEvents = 50000;
+  for (int i = 0; i < kNumEvents; ++i)
+    TRACE_EVENT_INSTANT1("all", "streamed", TRACE_EVENT_SCOPE_THREAD, "i", i);
+  EndTraceAndFlush();
+
+  // Nothing is kept for Flush().
+  EXPECT_EQ(0u, trace_parsed_.GetSize());
+
+  std::string binary;
+  ASSERT_TRUE(ReadFileToString(trace_file, &binary));
+  WaitableEvent flush_complete_event(false, false);
+  OnBinaryTraceDataCollected(
+      &flush_complete_event,
+      make_scoped_refptr(RefCountedString::TakeString(&binary)),
+      false);
+  ValidateAllTraceMacrosCreatedData(trace_parsed_);
+
+  size_t streamed_count = 0;
+  for (size_t i = 0; i < trace_parsed_.GetSize(); ++i) {
+    const DictionaryValue* dict = NULL;
+    std::string name;
+    if (trace_parsed_.GetDictionary(i, &dict) &&
+        dict->GetString("name", &name) && name == "streamed") {
+      ++streamed_count;
+    }
+  }
+  EXPECT_EQ(static_cast<size_t>(kNumEvents), streamed_count);
+
+  // The trace after the flush is kept in memory again.
+  Clear();
+  BeginTrace();
+  TRACE_EVENT_INSTANT0("all", "not streamed", TRACE_EVENT_SCOPE_THREAD);
+  EndTraceAndFlush();
+  EXPECT_TRUE(FindNamePhase("not streamed", "i"));
+}
+
 class MockEnabledStateChangedObserver :
       public base::debug::TraceLog::EnabledStateObserver {
  public:
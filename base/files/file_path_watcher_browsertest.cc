@@ -483,7 +483,7 @@ TEST_F(FilePathWatcherTest, MoveParent) {
   DeleteDelegateOnFileThread(subdir_delegate.release());
 }
 
-#if defined(OS_WIN)
+#if defined(OS_WIN) || defined(OS_LINUX) || defined(OS_ANDROID)
 TEST_F(FilePathWatcherTest, RecursiveWatch) {
   FilePathWatcher watcher;
   FilePath dir(temp_dir_.path().AppendASCII("dir"));
@@ -541,12 +541,64 @@ TEST_F(FilePathWatcherTest, RecursiveWatch) {
   FilePathWatcher watcher;
   FilePath dir(temp_dir_.path().AppendASCII("dir"));
   scoped_ptr<TestDelegate> delegate(new TestDelegate(collector()));
-  // Non-Windows implementaion does not support recursive watching.
+  // Mac implementation does not support recursive watching.
   ASSERT_FALSE(SetupWatch(dir, &watcher, delegate.get(), true));
   DeleteDelegateOnFileThread(delegate.release());
 }
 #endif
 
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+// Verify that directories moved into and out of a recursively watched
+// directory are watched and forgotten.
+TEST_F(FilePathWatcherTest, RecursiveWatchMovedDirectory) {
+  FilePathWatcher watcher;
+  FilePath dir(temp_dir_.path().AppendASCII("dir"));
+  FilePath outside(temp_dir_.path().AppendASCII("outside"));
+  FilePath outside_subdir(outside.AppendASCII("subdir"));
+  ASSERT_TRUE(base::CreateDirectory(dir));
+  ASSERT_TRUE(base::CreateDirectory(outside_subdir));
+  scoped_ptr<TestDelegate> delegate(new TestDelegate(collector()));
+  ASSERT_TRUE(SetupWatch(dir, &watcher, delegate.get(), true));
+
+  // Move "$outside" into "$dir".
+  FilePath moved(dir.AppendASCII("moved"));
+  ASSERT_TRUE(base::Move(outside, moved));
+  ASSERT_TRUE(WaitForEvents());
+
+  // Changes below the moved directory are seen.
+  ASSERT_TRUE(WriteFile(moved.AppendASCII("subdir").AppendASCII("file"),
+                        "content"));
+  ASSERT_TRUE(WaitForEvents());
+
+  // Move it back out, and make sure the watch still works.
+  ASSERT_TRUE(base::Move(moved, outside));
+  ASSERT_TRUE(WaitForEvents());
+  ASSERT_TRUE(WriteFile(dir.AppendASCII("file"), "content"));
+  ASSERT_TRUE(WaitForEvents());
+  DeleteDelegateOnFileThread(delegate.release());
+}
+#endif
+
+// Verify that a burst of changes is reported, and that the watcher keeps
+// reporting changes after it.
+TEST_F(FilePathWatcherTest, ManyChanges) {
+  FilePathWatcher watcher;
+  FilePath dir(temp_dir_.path().AppendASCII("dir"));
+  ASSERT_TRUE(base::CreateDirectory(dir));
+  scoped_ptr<TestDelegate> delegate(new TestDelegate(collector()));
+  ASSERT_TRUE(SetupWatch(dir, &watcher, delegate.get(), false));
+
+  for (int i = 0; i < 100; i++) {
+    ASSERT_TRUE(WriteFile(dir.AppendASCII(base::StringPrintf("file%d", i)),
+                          "content"));
+  }
+  ASSERT_TRUE(WaitForEvents());
+
+  ASSERT_TRUE(WriteFile(dir.AppendASCII("file0"), "content v2"));
+  ASSERT_TRUE(WaitForEvents());
+  DeleteDelegateOnFileThread(delegate.release());
+}
+
 TEST_F(FilePathWatcherTest, MoveChild) {
   FilePathWatcher file_watcher;
   FilePathWatcher subdir_watcher;
@@ -12,6 +12,7 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <map>
 #include <set>
 #include <utility>
 #include <vector>
@@ -20,6 +21,7 @@
 #include "base/containers/hash_tables.h"
 #include "base/debug/trace_event.h"
 #include "base/file_util.h"
+#include "base/files/file_enumerator.h"
 #include "base/files/file_path.h"
 #include "base/lazy_instance.h"
 #include "base/location.h"
@@ -27,9 +29,12 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/message_loop/message_loop.h"
 #include "base/message_loop/message_loop_proxy.h"
+#include "base/metrics/histogram.h"
 #include "base/posix/eintr_wrapper.h"
+#include "base/stl_util.h"
 #include "base/synchronization/lock.h"
 #include "base/threading/thread.h"
+#include "base/time/time.h"
 
 namespace base {
 
@@ -37,6 +42,14 @@ namespace {
 
 class FilePathWatcherImpl;
 
+// A watcher is notified at most once per this interval. The events that come
+// in meanwhile are handled together, so that a directory that changes many
+// times in a row, like a download folder, doesn't flood the watcher's thread.
+const int kMinDispatchIntervalMs = 100;
+
+// The interval over which InotifyReader reports the rate of events.
+const int kEventRateIntervalSeconds = 60;
+
 // Singleton to manage all inotify watches.
 // TODO(tony): It would be nice if this wasn't a singleton.
 // http://crbug.com/38174
@@ -45,6 +58,24 @@ class InotifyReader {
   typedef int Watch;  // Watch descriptor used by AddWatch and RemoveWatch.
   static const Watch kInvalidWatch = -1;
 
+  // An inotify event, as passed to the watchers of its watch.
+  struct Event {
+    Event(Watch watch,
+          const FilePath::StringType& child,
+          bool created,
+          bool is_dir);
+
+    Watch watch;
+    // What changed, relative to the watched directory. Empty if the change
+    // is to the directory itself.
+    FilePath::StringType child;
+    // True if |child| appeared.
+    bool created;
+    // True if |child| is a directory.
+    bool is_dir;
+  };
+  typedef std::vector<Event> EventVector;
+
   // Watch directory |path| for changes. |watcher| will be notified on each
   // change. Returns kInvalidWatch on failure.
   Watch AddWatch(const FilePath& path, FilePathWatcherImpl* watcher);
@@ -52,8 +83,9 @@ class InotifyReader {
   // Remove |watch|. Returns true on success.
   bool RemoveWatch(Watch watch, FilePathWatcherImpl* watcher);
 
-  // Callback for InotifyReaderTask.
-  void OnInotifyEvent(const inotify_event* event);
+  // Callback for InotifyReaderTask with the events of one read. Each watcher
+  // gets the events for its watches in a single batch.
+  void OnInotifyEvents(const EventVector& events);
 
  private:
   friend struct DefaultLazyInstanceTraits<InotifyReader>;
@@ -63,7 +95,14 @@ class InotifyReader {
   InotifyReader();
   ~InotifyReader();
 
+  // Counts |num_events| more events, and reports the rate of events once per
+  // interval.
+  void RecordEventRate(size_t num_events);
+
   // We keep track of which delegates want to be notified on which watches.
+  // This is the only table of watch descriptors: the watches of all the
+  // watchers, including the ones for the subdirectories of recursive
+  // watches, are in it.
   hash_map<Watch, WatcherSet> watchers_;
 
   // Lock to protect watchers_.
@@ -81,6 +120,11 @@ class InotifyReader {
   // Flag set to true when startup was successful.
   bool valid_;
 
+  // The start of the current event rate interval, and the number of events
+  // read since. Only accessed on |thread_|.
+  TimeTicks event_rate_interval_start_;
+  size_t event_rate_num_events_;
+
   DISALLOW_COPY_AND_ASSIGN(InotifyReader);
 };
 
@@ -89,13 +133,9 @@ class FilePathWatcherImpl : public FilePathWatcher::PlatformDelegate,
  public:
   FilePathWatcherImpl();
 
-  // Called for each event coming from the watch. |fired_watch| identifies the
-  // watch that fired, |child| indicates what has changed, and is relative to
-  // the currently watched path for |fired_watch|. The flag |created| is true if
-  // the object appears.
-  void OnFilePathChanged(InotifyReader::Watch fired_watch,
-                         const FilePath::StringType& child,
-                         bool created);
+  // Called on the InotifyReader thread with the events for this watcher from
+  // one read. Queues them, and makes sure DispatchEvents() runs.
+  void QueueEvents(const InotifyReader::EventVector& events);
 
   // Start watching |path| for changes and notify |delegate| on each change.
   // Returns true if watch for |path| has been added successfully.
@@ -132,22 +172,64 @@ class FilePathWatcherImpl : public FilePathWatcher::PlatformDelegate,
     FilePath::StringType linkname_;
   };
   typedef std::vector<WatchEntry> WatchVector;
+  typedef std::map<InotifyReader::Watch, FilePath> WatchToPathMap;
+  typedef std::map<FilePath, InotifyReader::Watch> PathToWatchMap;
+
+  // Handles the queued events on |message_loop()|, running |callback_| at
+  // most once for all of them.
+  void DispatchEvents();
+
+  // Handles one event. Sets |notify| if the event is to be reported. Returns
+  // false on error.
+  bool HandleEvent(const InotifyReader::Event& event,
+                   bool* notify) WARN_UNUSED_RESULT;
 
   // Reconfigure to watch for the most specific parent directory of |target_|
   // that exists. Updates |watched_path_|. Returns true on success.
   bool UpdateWatches() WARN_UNUSED_RESULT;
 
+  // For recursive watches: watches all the directories below |target_| if it
+  // changed since the last call, or none if it is gone.
+  void UpdateRecursiveWatches();
+
+  // For recursive watches: updates the watches for the directory |path| below
+  // |target_|, which was |created| or otherwise changed.
+  void UpdateRecursiveWatchesForPath(const FilePath& path, bool created);
+
+  // Watches |dir| and all the directories below it that aren't watched yet.
+  void AddRecursiveWatches(const FilePath& dir);
+  void AddRecursiveWatch(const FilePath& path);
+
+  // Stops watching |dir| and all the directories below it.
+  void RemoveRecursiveWatches(const FilePath& dir);
+  void RemoveAllRecursiveWatches();
+
   // Callback to notify upon changes.
   FilePathWatcher::Callback callback_;
 
   // The file or directory we're supposed to watch.
   FilePath target_;
 
+  // Whether the directories below |target_| are watched too.
+  bool recursive_;
+
   // The vector of watches and next component names for all path components,
   // starting at the root directory. The last entry corresponds to the watch for
   // |target_| and always stores an empty next component name in |subdir_|.
   WatchVector watches_;
 
+  // For recursive watches, the watches for the directories below |target_|,
+  // both ways, and the watch for |target_| they were set up for.
+  WatchToPathMap recursive_paths_by_watch_;
+  PathToWatchMap recursive_watches_by_path_;
+  InotifyReader::Watch recursive_target_watch_;
+
+  // The events queued by QueueEvents() for DispatchEvents(), and when
+  // DispatchEvents() last ran. Guarded by |pending_events_lock_|.
+  Lock pending_events_lock_;
+  InotifyReader::EventVector pending_events_;
+  TimeTicks last_dispatch_time_;
+
   DISALLOW_COPY_AND_ASSIGN(FilePathWatcherImpl);
 };
 
@@ -199,24 +281,41 @@ void InotifyReaderCallback(InotifyReader* reader, int inotify_fd,
       return;
     }
 
+    InotifyReader::EventVector events;
     ssize_t i = 0;
     while (i < bytes_read) {
       inotify_event* event = reinterpret_cast<inotify_event*>(&buffer[i]);
       size_t event_size = sizeof(inotify_event) + event->len;
       DCHECK(i + event_size <= static_cast<size_t>(bytes_read));
-      reader->OnInotifyEvent(event);
+      if (!(event->mask & IN_IGNORED)) {
+        events.push_back(InotifyReader::Event(
+            event->wd,
+            event->len ? event->name : FILE_PATH_LITERAL(""),
+            (event->mask & (IN_CREATE | IN_MOVED_TO)) != 0,
+            (event->mask & IN_ISDIR) != 0));
+      }
       i += event_size;
     }
+    reader->OnInotifyEvents(events);
   }
 }
 
 static LazyInstance<InotifyReader>::Leaky g_inotify_reader =
     LAZY_INSTANCE_INITIALIZER;
 
+InotifyReader::Event::Event(Watch watch,
+                            const FilePath::StringType& child,
+                            bool created,
+                            bool is_dir)
+    : watch(watch), child(child), created(created), is_dir(is_dir) {
+}
+
 InotifyReader::InotifyReader()
     : thread_("inotify_reader"),
       inotify_fd_(inotify_init()),
-      valid_(false) {
+      valid_(false),
+      event_rate_interval_start_(TimeTicks::Now()),
+      event_rate_num_events_(0) {
   if (inotify_fd_ < 0)
     PLOG(ERROR) << "inotify_init() failed";
 
@@ -255,7 +354,7 @@ InotifyReader::Watch InotifyReader::AddWatch(
   AutoLock auto_lock(lock_);
 
   Watch watch = inotify_add_watch(inotify_fd_, path.value().c_str(),
-                                  IN_CREATE | IN_DELETE |
+                                  IN_ATTRIB | IN_CREATE | IN_DELETE |
                                   IN_CLOSE_WRITE | IN_MOVE |
                                   IN_ONLYDIR);
 
@@ -284,41 +383,132 @@ bool InotifyReader::RemoveWatch(Watch watch,
   return true;
 }
 
-void InotifyReader::OnInotifyEvent(const inotify_event* event) {
-  if (event->mask & IN_IGNORED)
-    return;
+void InotifyReader::OnInotifyEvents(const EventVector& events) {
+  RecordEventRate(events.size());
+
+  typedef std::map<FilePathWatcherImpl*, EventVector> EventsByWatcher;
+  EventsByWatcher events_by_watcher;
 
-  FilePath::StringType child(event->len ? event->name : FILE_PATH_LITERAL(""));
   AutoLock auto_lock(lock_);
 
-  for (WatcherSet::iterator watcher = watchers_[event->wd].begin();
-       watcher != watchers_[event->wd].end();
-       ++watcher) {
-    (*watcher)->OnFilePathChanged(event->wd,
-                                  child,
-                                  event->mask & (IN_CREATE | IN_MOVED_TO));
+  for (EventVector::const_iterator event = events.begin();
+       event != events.end(); ++event) {
+    hash_map<Watch, WatcherSet>::const_iterator watchers =
+        watchers_.find(event->watch);
+    if (watchers == watchers_.end())
+      continue;
+    for (WatcherSet::const_iterator watcher = watchers->second.begin();
+         watcher != watchers->second.end();
+         ++watcher) {
+      events_by_watcher[*watcher].push_back(*event);
+    }
+  }
+
+  // The watchers are only guaranteed to be alive while |lock_| is held.
+  for (EventsByWatcher::const_iterator it = events_by_watcher.begin();
+       it != events_by_watcher.end(); ++it) {
+    it->first->QueueEvents(it->second);
   }
 }
 
-FilePathWatcherImpl::FilePathWatcherImpl() {
-}
+void InotifyReader::RecordEventRate(size_t num_events) {
+  event_rate_num_events_ += num_events;
 
-void FilePathWatcherImpl::OnFilePathChanged(InotifyReader::Watch fired_watch,
-                                            const FilePath::StringType& child,
-                                            bool created) {
-  if (!message_loop()->BelongsToCurrentThread()) {
-    // Switch to message_loop_ to access watches_ safely.
-    message_loop()->PostTask(FROM_HERE,
-        Bind(&FilePathWatcherImpl::OnFilePathChanged,
-                   this,
-                   fired_watch,
-                   child,
-                   created));
+  const TimeTicks now = TimeTicks::Now();
+  const TimeDelta elapsed = now - event_rate_interval_start_;
+  const TimeDelta interval = TimeDelta::FromSeconds(kEventRateIntervalSeconds);
+  if (elapsed < interval)
     return;
+
+  // The events may have come in over more than one interval, if it has been
+  // quiet for a while.
+  UMA_HISTOGRAM_COUNTS(
+      "FilePathWatcher.InotifyEventsPerMinute",
+      static_cast<int>(event_rate_num_events_ * interval.InMilliseconds() /
+                       elapsed.InMilliseconds()));
+  event_rate_interval_start_ = now;
+  event_rate_num_events_ = 0;
+}
+
+FilePathWatcherImpl::FilePathWatcherImpl()
+    : recursive_(false),
+      recursive_target_watch_(InotifyReader::kInvalidWatch) {
+}
+
+void FilePathWatcherImpl::QueueEvents(
+    const InotifyReader::EventVector& events) {
+  TimeDelta delay;
+  {
+    AutoLock auto_lock(pending_events_lock_);
+    bool dispatch_pending = !pending_events_.empty();
+    pending_events_.insert(pending_events_.end(), events.begin(), events.end());
+    if (dispatch_pending)
+      return;
+
+    // Wait for the rest of the interval if the watcher was notified less
+    // than an interval ago, collecting the events that come in meanwhile.
+    delay = last_dispatch_time_ +
+        TimeDelta::FromMilliseconds(kMinDispatchIntervalMs) - TimeTicks::Now();
   }
 
+  // Switch to message_loop_ to access watches_ safely.
+  message_loop()->PostDelayedTask(
+      FROM_HERE,
+      Bind(&FilePathWatcherImpl::DispatchEvents, this),
+      std::max(delay, TimeDelta()));
+}
+
+void FilePathWatcherImpl::DispatchEvents() {
+  DCHECK(message_loop()->BelongsToCurrentThread());
   DCHECK(MessageLoopForIO::current());
 
+  InotifyReader::EventVector events;
+  {
+    AutoLock auto_lock(pending_events_lock_);
+    events.swap(pending_events_);
+    last_dispatch_time_ = TimeTicks::Now();
+  }
+
+  // The watch may have been cancelled since the events were queued.
+  if (callback_.is_null())
+    return;
+
+  UMA_HISTOGRAM_COUNTS_10000("FilePathWatcher.EventsPerDispatch",
+                             static_cast<int>(events.size()));
+
+  bool notify = false;
+  for (InotifyReader::EventVector::const_iterator event = events.begin();
+       event != events.end(); ++event) {
+    if (!HandleEvent(*event, &notify)) {
+      callback_.Run(target_, true /* error */);
+      return;
+    }
+  }
+
+  if (notify)
+    callback_.Run(target_, false);
+}
+
+bool FilePathWatcherImpl::HandleEvent(const InotifyReader::Event& event,
+                                      bool* notify) {
+  const InotifyReader::Watch fired_watch = event.watch;
+  const FilePath::StringType& child = event.child;
+
+  // Any change below |target_| is reported. A directory appearing or going
+  // away adds or removes the watches below it.
+  if (recursive_) {
+    WatchToPathMap::const_iterator recursive_path =
+        recursive_paths_by_watch_.find(fired_watch);
+    if (recursive_path != recursive_paths_by_watch_.end()) {
+      if (event.is_dir && !child.empty()) {
+        UpdateRecursiveWatchesForPath(recursive_path->second.Append(child),
+                                      event.created);
+      }
+      *notify = true;
+      return true;
+    }
+  }
+
   // Find the entry in |watches_| that corresponds to |fired_watch|.
   WatchVector::const_iterator watch_entry(watches_.begin());
   for ( ; watch_entry != watches_.end(); ++watch_entry) {
@@ -342,9 +532,17 @@ void FilePathWatcherImpl::OnFilePathChanged(InotifyReader::Watch fired_watch,
       // as changes to symlinks on the target path will not have
       // IN_ISDIR set in the event masks. As a result we may sometimes
       // call UpdateWatches() unnecessarily.
-      if (change_on_target_path && !UpdateWatches()) {
-        callback_.Run(target_, true /* error */);
-        return;
+      if (change_on_target_path) {
+        if (!UpdateWatches())
+          return false;
+        if (recursive_)
+          UpdateRecursiveWatches();
+      }
+
+      // A directory appearing in or going away from |target_|.
+      if (recursive_ && event.is_dir && !child.empty() &&
+          watch_entry->subdir_.empty() && watch_entry->linkname_.empty()) {
+        UpdateRecursiveWatchesForPath(target_.Append(child), event.created);
       }
 
       // Report the following events:
@@ -356,13 +554,14 @@ void FilePathWatcherImpl::OnFilePathChanged(InotifyReader::Watch fired_watch,
       //    the target appearing might have been missed in this case, so
       //    recheck.
       if (target_changed ||
-          (change_on_target_path && !created) ||
+          (change_on_target_path && !event.created) ||
           (change_on_target_path && PathExists(target_))) {
-        callback_.Run(target_, false);
-        return;
+        *notify = true;
+        return true;
       }
     }
   }
+  return true;
 }
 
 bool FilePathWatcherImpl::Watch(const FilePath& path,
@@ -370,15 +569,11 @@ bool FilePathWatcherImpl::Watch(const FilePath& path,
                                 const FilePathWatcher::Callback& callback) {
   DCHECK(target_.empty());
   DCHECK(MessageLoopForIO::current());
-  if (recursive) {
-    // Recursive watch is not supported on this platform.
-    NOTIMPLEMENTED();
-    return false;
-  }
 
   set_message_loop(MessageLoopProxy::current().get());
   callback_ = callback;
   target_ = path;
+  recursive_ = recursive;
   MessageLoop::current()->AddDestructionObserver(this);
 
   std::vector<FilePath::StringType> comps;
@@ -390,7 +585,11 @@ bool FilePathWatcherImpl::Watch(const FilePath& path,
 
   watches_.push_back(WatchEntry(InotifyReader::kInvalidWatch,
                                 FilePath::StringType()));
-  return UpdateWatches();
+  if (!UpdateWatches())
+    return false;
+  if (recursive_)
+    UpdateRecursiveWatches();
+  return true;
 }
 
 void FilePathWatcherImpl::Cancel() {
@@ -425,6 +624,7 @@ void FilePathWatcherImpl::CancelOnMessageLoopThread() {
       g_inotify_reader.Get().RemoveWatch(watch_entry->watch_, this);
   }
   watches_.clear();
+  RemoveAllRecursiveWatches();
   target_.clear();
 }
 
@@ -484,6 +684,94 @@ bool FilePathWatcherImpl::UpdateWatches() {
   return true;
 }
 
+void FilePathWatcherImpl::UpdateRecursiveWatches() {
+  DCHECK(recursive_);
+
+  // The watch for |target_| changes when |target_| appears, goes away or is
+  // replaced, and all the directories below it have to be watched anew.
+  const InotifyReader::Watch target_watch = watches_.back().watch_;
+  if (target_watch == recursive_target_watch_)
+    return;
+
+  RemoveAllRecursiveWatches();
+  recursive_target_watch_ = target_watch;
+  if (target_watch != InotifyReader::kInvalidWatch)
+    AddRecursiveWatches(target_);
+}
+
+void FilePathWatcherImpl::UpdateRecursiveWatchesForPath(const FilePath& path,
+                                                        bool created) {
+  // A directory that was created may replace one that was watched under the
+  // same name.
+  if (created || !DirectoryExists(path))
+    RemoveRecursiveWatches(path);
+  if (created)
+    AddRecursiveWatches(path);
+}
+
+void FilePathWatcherImpl::AddRecursiveWatches(const FilePath& dir) {
+  // |target_| itself is watched by the last entry of |watches_|.
+  if (dir != target_)
+    AddRecursiveWatch(dir);
+
+  // Symbolic links aren't followed, so that a link to a parent directory
+  // doesn't make this endless.
+  FileEnumerator enumerator(
+      dir, true,
+      FileEnumerator::DIRECTORIES | FileEnumerator::SHOW_SYM_LINKS);
+  for (FilePath subdir = enumerator.Next(); !subdir.empty();
+       subdir = enumerator.Next()) {
+    AddRecursiveWatch(subdir);
+  }
+}
+
+void FilePathWatcherImpl::AddRecursiveWatch(const FilePath& path) {
+  if (ContainsKey(recursive_watches_by_path_, path))
+    return;
+
+  InotifyReader::Watch watch = g_inotify_reader.Get().AddWatch(path, this);
+  if (watch == InotifyReader::kInvalidWatch) {
+    // The directory may be gone already, in which case an event tells.
+    DPLOG(WARNING) << "Watch failed for " << path.value();
+    return;
+  }
+
+  // The directory may have been watched under another name already, if it
+  // was moved.
+  WatchToPathMap::iterator old_path = recursive_paths_by_watch_.find(watch);
+  if (old_path != recursive_paths_by_watch_.end())
+    recursive_watches_by_path_.erase(old_path->second);
+
+  recursive_paths_by_watch_[watch] = path;
+  recursive_watches_by_path_[path] = watch;
+}
+
+void FilePathWatcherImpl::RemoveRecursiveWatches(const FilePath& dir) {
+  // All the paths starting with |dir| are next to each other in the map,
+  // including the ones below it, but also the likes of |dir|-foo.
+  PathToWatchMap::iterator it = recursive_watches_by_path_.lower_bound(dir);
+  while (it != recursive_watches_by_path_.end() &&
+         it->first.value().compare(0, dir.value().size(), dir.value()) == 0) {
+    if (it->first != dir && !dir.IsParent(it->first)) {
+      ++it;
+      continue;
+    }
+    g_inotify_reader.Get().RemoveWatch(it->second, this);
+    recursive_paths_by_watch_.erase(it->second);
+    recursive_watches_by_path_.erase(it++);
+  }
+}
+
+void FilePathWatcherImpl::RemoveAllRecursiveWatches() {
+  for (WatchToPathMap::const_iterator it = recursive_paths_by_watch_.begin();
+       it != recursive_paths_by_watch_.end(); ++it) {
+    g_inotify_reader.Get().RemoveWatch(it->first, this);
+  }
+  recursive_paths_by_watch_.clear();
+  recursive_watches_by_path_.clear();
+  recursive_target_watch_ = InotifyReader::kInvalidWatch;
+}
+
 }  // namespace
 
 FilePathWatcher::FilePathWatcher() {
@@ -5,6 +5,7 @@
 #include "base/json/json_file_value_serializer.h"
 
 #include "base/file_util.h"
+#include "base/json/json_reader.h"
 #include "base/json/json_string_value_serializer.h"
 #include "base/logging.h"
 
@@ -92,7 +93,10 @@ base::Value* JSONFileValueSerializer::Deserialize(int* error_code,
     return NULL;
   }
 
-  JSONStringValueSerializer serializer(json_string);
-  serializer.set_allow_trailing_comma(allow_trailing_comma_);
-  return serializer.Deserialize(error_code, error_str);
+  // The file contents are not needed once parsed, so let the parser take them
+  // instead of copying them.
+  return base::JSONReader::ReadAndReturnErrorTakingInput(&json_string,
+      allow_trailing_comma_ ? base::JSON_ALLOW_TRAILING_COMMAS :
+          base::JSON_PARSE_RFC,
+      error_code, error_str);
 }
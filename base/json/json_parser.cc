@@ -202,16 +202,29 @@ JSONParser::~JSONParser() {
 }
 
 Value* JSONParser::Parse(const StringPiece& input) {
-  scoped_ptr<std::string> input_copy;
   // If the children of a JSON root can be detached, then hidden roots cannot
   // be used, so do not bother copying the input because StringPiece will not
   // be used anywhere.
-  if (!(options_ & JSON_DETACHABLE_CHILDREN)) {
-    input_copy.reset(new std::string(input.as_string()));
-    start_pos_ = input_copy->data();
-  } else {
-    start_pos_ = input.data();
-  }
+  if (options_ & JSON_DETACHABLE_CHILDREN)
+    return ParseInternal(input, scoped_ptr<std::string>());
+
+  scoped_ptr<std::string> input_copy(new std::string(input.as_string()));
+  StringPiece copy_piece(*input_copy);
+  return ParseInternal(copy_piece, input_copy.Pass());
+}
+
+Value* JSONParser::ParseAndTakeInput(std::string* input) {
+  scoped_ptr<std::string> owned_input(new std::string);
+  owned_input->swap(*input);
+  StringPiece owned_piece(*owned_input);
+  return ParseInternal(owned_piece, owned_input.Pass());
+}
+
+Value* JSONParser::ParseInternal(const StringPiece& input,
+                                 scoped_ptr<std::string> owned_input) {
+  DCHECK((options_ & JSON_DETACHABLE_CHILDREN) ||
+         (owned_input && owned_input->data() == input.data()));
+  start_pos_ = input.data();
   pos_ = start_pos_;
   end_pos_ = start_pos_ + input.length();
   index_ = 0;
@@ -249,9 +262,9 @@ Value* JSONParser::Parse(const StringPiece& input) {
   // hidden root.
   if (!(options_ & JSON_DETACHABLE_CHILDREN)) {
     if (root->IsType(Value::TYPE_DICTIONARY)) {
-      return new DictionaryHiddenRootValue(input_copy.release(), root.get());
+      return new DictionaryHiddenRootValue(owned_input.release(), root.get());
     } else if (root->IsType(Value::TYPE_LIST)) {
-      return new ListHiddenRootValue(input_copy.release(), root.get());
+      return new ListHiddenRootValue(owned_input.release(), root.get());
     } else if (root->IsType(Value::TYPE_STRING)) {
       // A string type could be a JSONStringValue, but because there's no
       // corresponding HiddenRootValue, the memory will be lost. Deep copy to
@@ -11,6 +11,7 @@
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
 #include "base/json/json_reader.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/strings/string_piece.h"
 
 #if !defined(OS_CHROMEOS)
@@ -66,6 +67,11 @@ class BASE_EXPORT_PRIVATE JSONParser {
   // result as a Value owned by the caller.
   Value* Parse(const StringPiece& input);
 
+  // Like Parse(), but takes the contents of |input|, leaving it empty, rather
+  // than copying them to back the string values of the result. This saves a
+  // copy of the whole input for callers that have no further use for it.
+  Value* ParseAndTakeInput(std::string* input);
+
   // Returns the error code.
   JSONReader::JsonParseError error_code() const;
 
@@ -143,6 +149,12 @@ class BASE_EXPORT_PRIVATE JSONParser {
     std::string* string_;
   };
 
+  // Parses |input|. Unless children are detachable, the string values of the
+  // result reference |owned_input|, which must hold the data of |input|, and
+  // the result takes ownership of it.
+  Value* ParseInternal(const StringPiece& input,
+                       scoped_ptr<std::string> owned_input);
+
   // Quick check that the stream has capacity to consume |length| more bytes.
   bool CanConsume(int length);
 
@@ -315,5 +315,37 @@ TEST_F(JSONParserTest, Decode4ByteUtf8Char) {
   EXPECT_TRUE(root.get()) << error_message;
 }
 
+TEST_F(JSONParserTest, ParseAndTakeInput) {
+  std::string input("{\"a\": [\"b\", 1], \"c\": \"d\"}");
+  const std::string expected_input(input);
+  scoped_ptr<Value> root;
+  {
+    JSONParser parser(JSON_PARSE_RFC);
+    root.reset(parser.ParseAndTakeInput(&input));
+  }
+  ASSERT_TRUE(root.get());
+  EXPECT_TRUE(input.empty());
+
+  // The string values must outlive the caller's copy of the input.
+  input.assign(expected_input.size(), 'x');
+  scoped_ptr<Value> expected(JSONReader::Read(expected_input));
+  EXPECT_TRUE(root->Equals(expected.get()));
+  DictionaryValue* dict = NULL;
+  ASSERT_TRUE(root->GetAsDictionary(&dict));
+  std::string str;
+  EXPECT_TRUE(dict->GetString("c", &str));
+  EXPECT_EQ("d", str);
+
+  // Errors are reported as with Parse().
+  std::string bad_input("[1,]");
+  int error_code = 0;
+  std::string error_message;
+  root.reset(JSONReader::ReadAndReturnErrorTakingInput(
+      &bad_input, JSON_PARSE_RFC, &error_code, &error_message));
+  EXPECT_FALSE(root.get());
+  EXPECT_EQ(JSONReader::JSON_TRAILING_COMMA, error_code);
+  EXPECT_FALSE(error_message.empty());
+}
+
 }  // namespace internal
 }  // namespace base
@@ -0,0 +1,81 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace base {
+
+namespace {
+
+const int kNumRuns = 20;
+
+// Builds a document shaped like a large Preferences file: many nested
+// dictionaries holding short strings, numbers and lists.
+std::string BuildPrefsLikeJSON(int num_entries) {
+  DictionaryValue root;
+  for (int i = 0; i < num_entries; ++i) {
+    scoped_ptr<DictionaryValue> entry(new DictionaryValue);
+    entry->SetString("name", "entry name " + IntToString(i));
+    entry->SetString("path", "/some/path/to/extension/" + IntToString(i));
+    entry->SetInteger("state", i % 3);
+    entry->SetDouble("install_time", i * 1000.5);
+    entry->SetBoolean("enabled", (i % 2) == 0);
+    scoped_ptr<ListValue> permissions(new ListValue);
+    permissions->AppendString("tabs");
+    permissions->AppendString("storage");
+    permissions->AppendString("http://*.example.com/*");
+    entry->Set("permissions", permissions.release());
+    root.SetWithoutPathExpansion("entry" + IntToString(i), entry.release());
+  }
+  std::string json;
+  JSONWriter::Write(&root, &json);
+  return json;
+}
+
+// Parses |json| |kNumRuns| times, either copying the input or handing it
+// over to the parser.
+void ParseJSON(const std::string& name, const std::string& json,
+               bool take_input) {
+  TimeDelta elapsed;
+  for (int i = 0; i < kNumRuns; ++i) {
+    std::string input(json);
+    TimeTicks start = TimeTicks::Now();
+    scoped_ptr<Value> root(take_input ?
+        JSONReader::ReadAndReturnErrorTakingInput(&input, JSON_PARSE_RFC,
+                                                  NULL, NULL) :
+        JSONReader::Read(input));
+    elapsed += TimeTicks::Now() - start;
+    ASSERT_TRUE(root.get());
+  }
+
+  perf_test::PrintResult("json", "", name + "_time",
+                         elapsed.InMillisecondsF() / kNumRuns, "ms", true);
+  // The copy of the input is held alongside the input itself until the
+  // result is destroyed.
+  perf_test::PrintResult("json", "", name + "_input_copy",
+                         static_cast<size_t>(take_input ? 0 : json.size()),
+                         "bytes", true);
+}
+
+}  // namespace
+
+TEST(JSONPerfTest, ParseLarge) {
+  const std::string json(BuildPrefsLikeJSON(20000));
+  perf_test::PrintResult("json", "", "parse_large_input",
+                         json.size(), "bytes", true);
+  ParseJSON("parse_large_copy", json, false);
+  ParseJSON("parse_large_take", json, true);
+}
+
+}  // namespace base
@@ -112,6 +112,15 @@ class BASE_EXPORT JSONReader {
                                    int* error_code_out,
                                    std::string* error_msg_out);
 
+  // Same as ReadAndReturnError(), but takes the contents of |json|, leaving it
+  // empty. The parser would otherwise keep a copy of the whole input, so this
+  // halves the memory held by parsing large documents the caller no longer
+  // needs, such as the contents of a file.
+  static Value* ReadAndReturnErrorTakingInput(std::string* json,
+                                              int options,  // JSONParserOptions
+                                              int* error_code_out,
+                                              std::string* error_msg_out);
+
   // Converts a JSON parse error code into a human readable message.
   // Returns an empty string if error_code is JSON_NO_ERROR.
   static std::string ErrorCodeToString(JsonParseError error_code);
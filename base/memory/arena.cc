@@ -0,0 +1,135 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/arena.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "base/logging.h"
+
+namespace base {
+
+struct Arena::Block {
+  Block* next;
+  size_t size;
+
+  char* data() { return reinterpret_cast<char*>(this + 1); }
+  char* end() { return data() + size; }
+};
+
+namespace {
+
+char* AlignUp(char* pointer, size_t alignment) {
+  uintptr_t value = reinterpret_cast<uintptr_t>(pointer);
+  return reinterpret_cast<char*>((value + alignment - 1) & ~(alignment - 1));
+}
+
+}  // namespace
+
+const size_t Arena::kDefaultBlockSize;
+const size_t Arena::kDefaultAlignment;
+
+Arena::Arena()
+    : block_size_(kDefaultBlockSize),
+      blocks_(NULL),
+      position_(NULL),
+      limit_(NULL),
+      bytes_allocated_(0),
+      num_blocks_(0) {
+}
+
+Arena::Arena(size_t block_size)
+    : block_size_(block_size),
+      blocks_(NULL),
+      position_(NULL),
+      limit_(NULL),
+      bytes_allocated_(0),
+      num_blocks_(0) {
+  DCHECK_GT(block_size, 0u);
+}
+
+Arena::~Arena() {
+  while (blocks_) {
+    Block* next = blocks_->next;
+    free(blocks_);
+    blocks_ = next;
+  }
+}
+
+void* Arena::Allocate(size_t size, size_t alignment) {
+  DCHECK(alignment && !(alignment & (alignment - 1))) << alignment;
+  char* result = AlignUp(position_, alignment);
+  if (!position_ || result < position_ || result > limit_ ||
+      size > static_cast<size_t>(limit_ - result)) {
+    return AllocateSlow(size, alignment);
+  }
+  position_ = result + size;
+  bytes_allocated_ += size;
+  return result;
+}
+
+void Arena::Reset() {
+  // Keep the current block if it is a regular one; free the rest.
+  Block* kept = NULL;
+  if (blocks_ && blocks_->size == block_size_) {
+    kept = blocks_;
+    blocks_ = blocks_->next;
+  }
+  while (blocks_) {
+    Block* next = blocks_->next;
+    free(blocks_);
+    blocks_ = next;
+  }
+
+  blocks_ = kept;
+  num_blocks_ = kept ? 1 : 0;
+  if (kept) {
+    kept->next = NULL;
+    position_ = kept->data();
+    limit_ = kept->end();
+  } else {
+    position_ = limit_ = NULL;
+  }
+  bytes_allocated_ = 0;
+}
+
+void* Arena::AllocateSlow(size_t size, size_t alignment) {
+  // Worst case padding to reach the alignment.
+  size_t padded_size = size + alignment - 1;
+  CHECK_GE(padded_size, size);
+
+  if (padded_size > block_size_ / 4) {
+    // Give large allocations a block of their own, behind the current one,
+    // so that the rest of the current block isn't wasted.
+    Block* block = NewBlock(padded_size);
+    if (blocks_) {
+      block->next = blocks_->next;
+      blocks_->next = block;
+    } else {
+      block->next = NULL;
+      blocks_ = block;
+    }
+    bytes_allocated_ += size;
+    return AlignUp(block->data(), alignment);
+  }
+
+  Block* block = NewBlock(block_size_);
+  block->next = blocks_;
+  blocks_ = block;
+  position_ = block->data();
+  limit_ = block->end();
+  return Allocate(size, alignment);
+}
+
+Arena::Block* Arena::NewBlock(size_t data_size) {
+  CHECK_LE(data_size, std::numeric_limits<size_t>::max() - sizeof(Block));
+  Block* block = static_cast<Block*>(malloc(sizeof(Block) + data_size));
+  CHECK(block);
+  block->size = data_size;
+  ++num_blocks_;
+  return block;
+}
+
+}  // namespace base
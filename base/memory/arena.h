@@ -0,0 +1,150 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Arena is a bump allocator for short-lived object graphs which are freed all
+// at once. Memory is carved out of large blocks, so allocating is a pointer
+// increment, and nothing is freed until the arena is reset or destroyed:
+//
+//   base::Arena arena;
+//   Node* node = new (arena.Allocate(sizeof(Node), ALIGNOF(Node))) Node;
+//
+// Destructors of objects placed in the arena are not run, so it suits plain
+// structs, or objects that are destroyed by hand.
+//
+// ArenaAllocator adapts an Arena to STL containers, whose nodes or elements
+// then come from the arena:
+//
+//   typedef base::ArenaAllocator<std::pair<const int, int> > Allocator;
+//   base::Arena arena;
+//   Allocator allocator(&arena);
+//   std::map<int, int, std::less<int>, Allocator> map(std::less<int>(),
+//                                                      allocator);
+//
+// The containers must be destroyed before the arena. Memory they release
+// along the way is only reclaimed when the arena is, so an arena is a poor
+// fit for containers that grow and shrink for a long time.
+//
+// Arena is not thread safe.
+
+#ifndef BASE_MEMORY_ARENA_H_
+#define BASE_MEMORY_ARENA_H_
+
+#include <stddef.h>
+
+#include <limits>
+#include <new>
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/compiler_specific.h"
+
+namespace base {
+
+class BASE_EXPORT Arena {
+ public:
+  // The size of the blocks allocations are carved from. Allocations larger
+  // than a quarter of the block size get a block of their own.
+  static const size_t kDefaultBlockSize = 4096;
+
+  // The alignment of Allocate(size), which is what malloc() guarantees on
+  // common platforms.
+  static const size_t kDefaultAlignment = 2 * sizeof(void*);
+
+  Arena();
+  explicit Arena(size_t block_size);
+  ~Arena();
+
+  // Returns |size| bytes aligned to |alignment|, which must be a power of two.
+  // The memory stays valid until Reset() or destruction.
+  void* Allocate(size_t size, size_t alignment);
+  void* Allocate(size_t size) { return Allocate(size, kDefaultAlignment); }
+
+  // Frees all allocations at once. One block is kept, so that an arena reused
+  // for a similar graph, such as once per frame, mostly avoids malloc().
+  void Reset();
+
+  // The number of bytes handed out since construction or the last Reset().
+  size_t bytes_allocated() const { return bytes_allocated_; }
+
+  // The number of blocks currently held, each obtained with one malloc().
+  size_t num_blocks() const { return num_blocks_; }
+
+ private:
+  struct Block;
+
+  void* AllocateSlow(size_t size, size_t alignment);
+  Block* NewBlock(size_t data_size);
+
+  const size_t block_size_;
+
+  // The block allocations are carved from, followed by earlier and
+  // dedicated blocks.
+  Block* blocks_;
+
+  // The free range of |blocks_|.
+  char* position_;
+  char* limit_;
+
+  size_t bytes_allocated_;
+  size_t num_blocks_;
+
+  DISALLOW_COPY_AND_ASSIGN(Arena);
+};
+
+// An STL allocator taking its memory from an Arena. deallocate() is a no-op.
+template <typename T>
+class ArenaAllocator {
+ public:
+  typedef T value_type;
+  typedef T* pointer;
+  typedef const T* const_pointer;
+  typedef T& reference;
+  typedef const T& const_reference;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+
+  template <typename U>
+  struct rebind {
+    typedef ArenaAllocator<U> other;
+  };
+
+  explicit ArenaAllocator(Arena* arena) : arena_(arena) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.arena()) {}
+
+  pointer address(reference value) const { return &value; }
+  const_pointer address(const_reference value) const { return &value; }
+
+  pointer allocate(size_type count, const void* hint = 0) {
+    return static_cast<pointer>(
+        arena_->Allocate(count * sizeof(T), ALIGNOF(T)));
+  }
+  void deallocate(pointer p, size_type count) {}
+
+  size_type max_size() const {
+    return std::numeric_limits<size_type>::max() / sizeof(T);
+  }
+
+  void construct(pointer p, const T& value) { new (p) T(value); }
+  void destroy(pointer p) { p->~T(); }
+
+  Arena* arena() const { return arena_; }
+
+ private:
+  Arena* arena_;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+  return a.arena() == b.arena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+  return a.arena() != b.arena();
+}
+
+}  // namespace base
+
+#endif  // BASE_MEMORY_ARENA_H_
@@ -0,0 +1,115 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/memory/arena.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace {
+
+const int kNumRuns = 2000;
+const int kNumElements = 500;
+
+// Builds and destroys |kNumRuns| maps of |kNumElements| elements, whose
+// nodes come from |allocator|. With an arena, the arena is reset after each
+// map, the way a graph built per frame or per message would be dropped.
+template <typename Allocator>
+void BuildMaps(const std::string& name,
+               const Allocator& allocator,
+               base::Arena* arena) {
+  typedef std::map<int, int, std::less<int>, Allocator> Map;
+  base::TimeTicks start = base::TimeTicks::Now();
+  int64 sum = 0;
+  for (int run = 0; run < kNumRuns; ++run) {
+    {
+      Map map(std::less<int>(), allocator);
+      for (int i = 0; i < kNumElements; ++i)
+        map[(i * 7919) % kNumElements] = i;
+      for (typename Map::const_iterator it = map.begin(); it != map.end();
+           ++it) {
+        sum += it->second;
+      }
+    }
+    if (arena)
+      arena->Reset();
+  }
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+  EXPECT_GT(sum, 0);
+
+  perf_test::PrintResult(
+      "arena", "", name + "_map_time",
+      elapsed.InMicroseconds() * 1000.0 / (kNumRuns * kNumElements),
+      "ns/element", true);
+}
+
+template <typename Allocator>
+void BuildLists(const std::string& name,
+                const Allocator& allocator,
+                base::Arena* arena) {
+  typedef std::list<int, Allocator> List;
+  base::TimeTicks start = base::TimeTicks::Now();
+  int64 sum = 0;
+  for (int run = 0; run < kNumRuns; ++run) {
+    {
+      List list(allocator);
+      for (int i = 0; i < kNumElements; ++i)
+        list.push_back(i);
+      for (typename List::const_iterator it = list.begin(); it != list.end();
+           ++it) {
+        sum += *it;
+      }
+    }
+    if (arena)
+      arena->Reset();
+  }
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+  EXPECT_GT(sum, 0);
+
+  perf_test::PrintResult(
+      "arena", "", name + "_list_time",
+      elapsed.InMicroseconds() * 1000.0 / (kNumRuns * kNumElements),
+      "ns/element", true);
+}
+
+TEST(ArenaPerfTest, Map) {
+  BuildMaps("malloc", std::allocator<std::pair<const int, int> >(), NULL);
+
+  base::Arena arena;
+  BuildMaps("arena",
+            base::ArenaAllocator<std::pair<const int, int> >(&arena), &arena);
+}
+
+TEST(ArenaPerfTest, List) {
+  BuildLists("malloc", std::allocator<int>(), NULL);
+
+  base::Arena arena;
+  BuildLists("arena", base::ArenaAllocator<int>(&arena), &arena);
+}
+
+// The number of calls to malloc() an arena makes for one map, compared to
+// one per node without it.
+TEST(ArenaPerfTest, MallocCalls) {
+  typedef base::ArenaAllocator<std::pair<const int, int> > Allocator;
+  base::Arena arena;
+  {
+    Allocator allocator(&arena);
+    std::map<int, int, std::less<int>, Allocator> map(std::less<int>(),
+                                                       allocator);
+    for (int i = 0; i < kNumElements; ++i)
+      map[i] = i;
+  }
+  perf_test::PrintResult("arena", "", "map_malloc_calls",
+                         static_cast<size_t>(kNumElements), "calls", true);
+  perf_test::PrintResult("arena", "", "arena_map_malloc_calls",
+                         arena.num_blocks(), "calls", true);
+}
+
+}  // namespace
@@ -0,0 +1,147 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/arena.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <list>
+#include <map>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+bool IsAligned(void* pointer, size_t alignment) {
+  return !(reinterpret_cast<uintptr_t>(pointer) & (alignment - 1));
+}
+
+}  // namespace
+
+TEST(ArenaTest, Empty) {
+  Arena arena;
+  EXPECT_EQ(0u, arena.num_blocks());
+  EXPECT_EQ(0u, arena.bytes_allocated());
+  arena.Reset();
+  EXPECT_EQ(0u, arena.num_blocks());
+}
+
+TEST(ArenaTest, SmallAllocationsShareBlocks) {
+  Arena arena(1024);
+  std::vector<char*> allocations;
+  for (int i = 0; i < 100; ++i) {
+    char* allocation = static_cast<char*>(arena.Allocate(8, 8));
+    ASSERT_TRUE(allocation);
+    memset(allocation, i, 8);
+    allocations.push_back(allocation);
+  }
+  EXPECT_EQ(800u, arena.bytes_allocated());
+  EXPECT_EQ(1u, arena.num_blocks());
+
+  // Consecutive allocations are adjacent.
+  EXPECT_EQ(allocations[0] + 8, allocations[1]);
+  for (int i = 0; i < 100; ++i)
+    EXPECT_EQ(static_cast<char>(i), allocations[i][7]);
+
+  // Filling the block starts a new one.
+  for (int i = 0; i < 100; ++i)
+    arena.Allocate(8, 8);
+  EXPECT_EQ(2u, arena.num_blocks());
+}
+
+TEST(ArenaTest, Alignment) {
+  Arena arena(256);
+  const size_t kAlignments[] = { 1, 2, 4, 8, 16, 32, 64 };
+  for (int round = 0; round < 20; ++round) {
+    for (size_t i = 0; i < arraysize(kAlignments); ++i) {
+      arena.Allocate(1, 1);
+      void* allocation = arena.Allocate(3, kAlignments[i]);
+      EXPECT_TRUE(IsAligned(allocation, kAlignments[i])) << kAlignments[i];
+    }
+  }
+  EXPECT_TRUE(IsAligned(arena.Allocate(1), Arena::kDefaultAlignment));
+}
+
+TEST(ArenaTest, LargeAllocationsGetTheirOwnBlock) {
+  Arena arena(1024);
+  char* small = static_cast<char*>(arena.Allocate(16, 8));
+  EXPECT_EQ(1u, arena.num_blocks());
+
+  void* large = arena.Allocate(4000, 64);
+  EXPECT_TRUE(IsAligned(large, 64));
+  memset(large, 0, 4000);
+  EXPECT_EQ(2u, arena.num_blocks());
+
+  // The current block is still used for small allocations.
+  EXPECT_EQ(small + 16, arena.Allocate(16, 8));
+  EXPECT_EQ(2u, arena.num_blocks());
+}
+
+TEST(ArenaTest, ResetKeepsOneBlock) {
+  Arena arena(1024);
+  for (int i = 0; i < 300; ++i)
+    arena.Allocate(16, 8);
+  arena.Allocate(2048);
+  EXPECT_LT(2u, arena.num_blocks());
+
+  arena.Reset();
+  EXPECT_EQ(1u, arena.num_blocks());
+  EXPECT_EQ(0u, arena.bytes_allocated());
+
+  // The kept block is reused.
+  for (int i = 0; i < 50; ++i)
+    arena.Allocate(16, 8);
+  EXPECT_EQ(1u, arena.num_blocks());
+}
+
+TEST(ArenaTest, ZeroSizedAllocations) {
+  Arena arena;
+  EXPECT_TRUE(arena.Allocate(0));
+  EXPECT_TRUE(arena.Allocate(0, 1));
+  EXPECT_EQ(1u, arena.num_blocks());
+}
+
+TEST(ArenaAllocatorTest, Map) {
+  Arena arena;
+  typedef ArenaAllocator<std::pair<const int, int> > Allocator;
+  typedef std::map<int, int, std::less<int>, Allocator> ArenaMap;
+  {
+    Allocator allocator(&arena);
+    ArenaMap map(std::less<int>(), allocator);
+    for (int i = 0; i < 1000; ++i)
+      map[i] = i * 2;
+    EXPECT_EQ(1000u, map.size());
+    EXPECT_EQ(20, map[10]);
+    map.erase(10);
+    EXPECT_EQ(0u, map.count(10));
+  }
+  EXPECT_LT(0u, arena.bytes_allocated());
+  EXPECT_LT(1u, arena.num_blocks());
+}
+
+TEST(ArenaAllocatorTest, ListAndVector) {
+  Arena arena;
+  ArenaAllocator<int> allocator(&arena);
+
+  std::list<int, ArenaAllocator<int> > list(allocator);
+  std::vector<int, ArenaAllocator<int> > vector(allocator);
+  for (int i = 0; i < 100; ++i) {
+    list.push_back(i);
+    vector.push_back(i);
+  }
+  EXPECT_EQ(100u, list.size());
+  EXPECT_EQ(99, list.back());
+  EXPECT_EQ(100u, vector.size());
+  EXPECT_EQ(42, vector[42]);
+
+  EXPECT_TRUE(allocator == list.get_allocator());
+  Arena other_arena;
+  EXPECT_TRUE(allocator != ArenaAllocator<int>(&other_arena));
+}
+
+}  // namespace base
@@ -16,6 +16,7 @@ const struct TypeNamePair {
 } kTypeNamePairs[] = {
   { DISCARDABLE_MEMORY_TYPE_ANDROID, "android" },
   { DISCARDABLE_MEMORY_TYPE_MAC, "mac" },
+  { DISCARDABLE_MEMORY_TYPE_LINUX, "linux" },
   { DISCARDABLE_MEMORY_TYPE_EMULATED, "emulated" },
   { DISCARDABLE_MEMORY_TYPE_MALLOC, "malloc" }
 };
@@ -67,6 +67,7 @@ scoped_ptr<DiscardableMemory> DiscardableMemory::CreateLockedMemoryWithType(
   switch (type) {
     case DISCARDABLE_MEMORY_TYPE_NONE:
     case DISCARDABLE_MEMORY_TYPE_MAC:
+    case DISCARDABLE_MEMORY_TYPE_LINUX:
       return scoped_ptr<DiscardableMemory>();
     case DISCARDABLE_MEMORY_TYPE_ANDROID: {
       return g_context.Pointer()->allocator.Allocate(size);
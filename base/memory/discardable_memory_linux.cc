@@ -4,11 +4,169 @@
 
 #include "base/memory/discardable_memory.h"
 
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <set>
+
+#include "base/atomicops.h"
+#include "base/basictypes.h"
+#include "base/compiler_specific.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/memory/discardable_memory_emulated.h"
 #include "base/memory/discardable_memory_malloc.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/synchronization/lock.h"
+
+// Older headers don't define MADV_FREE. Kernels that don't support it fail
+// madvise() with EINVAL, which IsMadvFreeSupported() detects.
+#if !defined(MADV_FREE)
+#define MADV_FREE 8
+#endif
 
 namespace base {
+namespace {
+
+// Written to the first word of every page when the memory is unlocked. The
+// kernel replaces pages it reclaims with zero pages, so a page that no longer
+// starts with the marker has been purged.
+const subtle::Atomic32 kPageMarker = 0x5ca1ab1e;
+
+class DiscardableMemoryLinux;
+
+// All instances, so that PurgeForTesting() can find them.
+struct Instances {
+  Lock lock;
+  std::set<DiscardableMemoryLinux*> set;
+};
+LazyInstance<Instances>::Leaky g_instances = LAZY_INSTANCE_INITIALIZER;
+
+struct MadvFreeSupport {
+  MadvFreeSupport() : value(false) {
+    size_t page_size = getpagesize();
+    void* page = mmap(NULL, page_size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (page == MAP_FAILED)
+      return;
+    value = !madvise(page, page_size, MADV_FREE);
+    munmap(page, page_size);
+  }
+  bool value;
+};
+LazyInstance<MadvFreeSupport>::Leaky g_madv_free_support =
+    LAZY_INSTANCE_INITIALIZER;
+
+bool IsMadvFreeSupported() {
+  return g_madv_free_support.Get().value;
+}
+
+// Discardable memory backed by a private anonymous mapping. Unlocking it
+// marks its pages with MADV_FREE, which lets the kernel reclaim them lazily
+// when it runs short of memory, without any help from our threads and without
+// the cost of a page fault if it doesn't. Writing to a page again takes it
+// back, so Lock() re-dirties every page with an atomic compare-and-swap of
+// its marker, which fails only for the pages the kernel has already zeroed.
+class DiscardableMemoryLinux : public DiscardableMemory {
+ public:
+  explicit DiscardableMemoryLinux(size_t size)
+      : buffer_(NULL),
+        page_size_(getpagesize()),
+        page_count_((size + page_size_ - 1) / page_size_),
+        is_locked_(true) {
+    DCHECK(size);
+  }
+
+  bool Initialize() {
+    void* buffer = mmap(NULL, page_count_ * page_size_,
+                        PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                        -1, 0);
+    if (buffer == MAP_FAILED) {
+      DPLOG(ERROR) << "mmap() failed";
+      return false;
+    }
+
+    buffer_ = static_cast<char*>(buffer);
+    saved_words_.reset(new subtle::Atomic32[page_count_]);
+
+    AutoLock lock(g_instances.Get().lock);
+    g_instances.Get().set.insert(this);
+    return true;
+  }
+
+  virtual ~DiscardableMemoryLinux() {
+    if (!buffer_)
+      return;
+
+    {
+      AutoLock lock(g_instances.Get().lock);
+      g_instances.Get().set.erase(this);
+    }
+    munmap(buffer_, page_count_ * page_size_);
+  }
+
+  virtual DiscardableMemoryLockStatus Lock() OVERRIDE {
+    DCHECK(!is_locked_);
+    DCHECK_EQ(0, mprotect(buffer_, page_count_ * page_size_,
+                          PROT_READ | PROT_WRITE));
+    is_locked_ = true;
+
+    bool purged = false;
+    for (size_t i = 0; i < page_count_; ++i) {
+      if (subtle::NoBarrier_CompareAndSwap(
+              PageMarker(i), kPageMarker, kPageMarker) != kPageMarker) {
+        purged = true;
+      }
+    }
+    if (purged)
+      return DISCARDABLE_MEMORY_LOCK_STATUS_PURGED;
+
+    for (size_t i = 0; i < page_count_; ++i)
+      *PageMarker(i) = saved_words_[i];
+    return DISCARDABLE_MEMORY_LOCK_STATUS_SUCCESS;
+  }
+
+  virtual void Unlock() OVERRIDE {
+    DCHECK(is_locked_);
+    for (size_t i = 0; i < page_count_; ++i) {
+      saved_words_[i] = *PageMarker(i);
+      *PageMarker(i) = kPageMarker;
+    }
+    if (madvise(buffer_, page_count_ * page_size_, MADV_FREE))
+      DPLOG(ERROR) << "Failed to unlock memory.";
+    DCHECK_EQ(0, mprotect(buffer_, page_count_ * page_size_, PROT_NONE));
+    is_locked_ = false;
+  }
+
+  virtual void* Memory() const OVERRIDE {
+    DCHECK(is_locked_);
+    return buffer_;
+  }
+
+  // Discards the pages right away if the memory is unlocked.
+  void Purge() {
+    if (!is_locked_)
+      madvise(buffer_, page_count_ * page_size_, MADV_DONTNEED);
+  }
+
+ private:
+  subtle::Atomic32* PageMarker(size_t page) {
+    return reinterpret_cast<subtle::Atomic32*>(buffer_ + page * page_size_);
+  }
+
+  char* buffer_;
+  const size_t page_size_;
+  const size_t page_count_;
+
+  // The first word of each page, saved while the marker replaces it.
+  scoped_ptr<subtle::Atomic32[]> saved_words_;
+
+  bool is_locked_;
+
+  DISALLOW_COPY_AND_ASSIGN(DiscardableMemoryLinux);
+};
+
+}  // namespace
 
 // static
 void DiscardableMemory::RegisterMemoryPressureListeners() {
@@ -24,10 +182,14 @@ void DiscardableMemory::UnregisterMemoryPressureListeners() {
 void DiscardableMemory::GetSupportedTypes(
     std::vector<DiscardableMemoryType>* types) {
   const DiscardableMemoryType supported_types[] = {
+    DISCARDABLE_MEMORY_TYPE_LINUX,
     DISCARDABLE_MEMORY_TYPE_EMULATED,
     DISCARDABLE_MEMORY_TYPE_MALLOC
   };
-  types->assign(supported_types, supported_types + arraysize(supported_types));
+  // Kernels older than 4.5 don't support MADV_FREE.
+  const DiscardableMemoryType* first_type =
+      IsMadvFreeSupported() ? supported_types : supported_types + 1;
+  types->assign(first_type, supported_types + arraysize(supported_types));
 }
 
 // static
@@ -38,6 +200,17 @@ scoped_ptr<DiscardableMemory> DiscardableMemory::CreateLockedMemoryWithType(
     case DISCARDABLE_MEMORY_TYPE_ANDROID:
     case DISCARDABLE_MEMORY_TYPE_MAC:
       return scoped_ptr<DiscardableMemory>();
+    case DISCARDABLE_MEMORY_TYPE_LINUX: {
+      if (!IsMadvFreeSupported())
+        return scoped_ptr<DiscardableMemory>();
+
+      scoped_ptr<DiscardableMemoryLinux> memory(
+          new DiscardableMemoryLinux(size));
+      if (!memory->Initialize())
+        return scoped_ptr<DiscardableMemory>();
+
+      return memory.PassAs<DiscardableMemory>();
+    }
     case DISCARDABLE_MEMORY_TYPE_EMULATED: {
       scoped_ptr<internal::DiscardableMemoryEmulated> memory(
           new internal::DiscardableMemoryEmulated(size));
@@ -67,6 +240,15 @@ bool DiscardableMemory::PurgeForTestingSupported() {
 
 // static
 void DiscardableMemory::PurgeForTesting() {
+  {
+    AutoLock lock(g_instances.Get().lock);
+    for (std::set<DiscardableMemoryLinux*>::iterator it =
+             g_instances.Get().set.begin();
+         it != g_instances.Get().set.end();
+         ++it) {
+      (*it)->Purge();
+    }
+  }
   internal::DiscardableMemoryEmulated::PurgeForTesting();
 }
 
@@ -116,6 +116,7 @@ scoped_ptr<DiscardableMemory> DiscardableMemory::CreateLockedMemoryWithType(
   switch (type) {
     case DISCARDABLE_MEMORY_TYPE_NONE:
     case DISCARDABLE_MEMORY_TYPE_ANDROID:
+    case DISCARDABLE_MEMORY_TYPE_LINUX:
       return scoped_ptr<DiscardableMemory>();
     case DISCARDABLE_MEMORY_TYPE_MAC: {
       scoped_ptr<DiscardableMemoryMac> memory(new DiscardableMemoryMac(size));
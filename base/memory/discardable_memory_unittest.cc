@@ -85,6 +85,28 @@ TEST_P(DiscardableMemoryTest, LockAndUnLock) {
   memory->Unlock();
 }
 
+// Test that memory that is not purged keeps its contents across Unlock() and
+// Lock().
+TEST_P(DiscardableMemoryTest, LockPreservesContents) {
+  const scoped_ptr<DiscardableMemory> memory(CreateLockedMemory(kSize));
+  ASSERT_TRUE(memory);
+  uint8* data = static_cast<uint8*>(memory->Memory());
+  for (size_t i = 0; i < kSize; ++i)
+    data[i] = static_cast<uint8>(i);
+
+  memory->Unlock();
+
+  DiscardableMemoryLockStatus status = memory->Lock();
+  ASSERT_NE(DISCARDABLE_MEMORY_LOCK_STATUS_FAILED, status);
+  if (status == DISCARDABLE_MEMORY_LOCK_STATUS_SUCCESS) {
+    data = static_cast<uint8*>(memory->Memory());
+    for (size_t i = 0; i < kSize; ++i)
+      EXPECT_EQ(static_cast<uint8>(i), data[i]);
+  }
+
+  memory->Unlock();
+}
+
 // Test delete a discardable memory while it is locked.
 TEST_P(DiscardableMemoryTest, DeleteWhileLocked) {
   const scoped_ptr<DiscardableMemory> memory(CreateLockedMemory(kSize));
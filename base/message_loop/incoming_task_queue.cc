@@ -12,9 +12,19 @@
 namespace base {
 namespace internal {
 
-IncomingTaskQueue::IncomingTaskQueue(MessageLoop* message_loop)
+IncomingTaskQueue::IncomingTaskQueue(MessageLoop* message_loop,
+                                     bool lock_free)
     : message_loop_(message_loop),
-      next_sequence_num_(0) {
+      next_sequence_num_(0),
+      lock_free_(lock_free),
+      lock_free_head_(0),
+      lock_free_sequence_num_(0),
+      lock_free_shutdown_(0) {
+#if defined(OS_WIN)
+  // CalculateDelayedRuntime() manages the high resolution timer lease, which
+  // needs |incoming_queue_lock_|.
+  DCHECK(!lock_free_);
+#endif
 }
 
 bool IncomingTaskQueue::AddToIncomingQueue(
@@ -22,6 +32,12 @@ bool IncomingTaskQueue::AddToIncomingQueue(
     const Closure& task,
     TimeDelta delay,
     bool nestable) {
+  if (lock_free_) {
+    PendingTask pending_task(
+        from_here, task, CalculateDelayedRuntime(delay), nestable);
+    return PostPendingTaskLockFree(&pending_task);
+  }
+
   AutoLock locked(incoming_queue_lock_);
   PendingTask pending_task(
       from_here, task, CalculateDelayedRuntime(delay), nestable);
@@ -37,6 +53,9 @@ bool IncomingTaskQueue::IsHighResolutionTimerEnabledForTesting() {
 }
 
 bool IncomingTaskQueue::IsIdleForTesting() {
+  if (lock_free_)
+    return !subtle::Acquire_Load(&lock_free_head_);
+
   AutoLock lock(incoming_queue_lock_);
   return incoming_queue_.empty();
 }
@@ -45,6 +64,11 @@ void IncomingTaskQueue::ReloadWorkQueue(TaskQueue* work_queue) {
   // Make sure no tasks are lost.
   DCHECK(work_queue->empty());
 
+  if (lock_free_) {
+    ReloadWorkQueueLockFree(work_queue);
+    return;
+  }
+
   // Acquire all we can from the inter-thread queue with one lock acquisition.
   AutoLock lock(incoming_queue_lock_);
   if (!incoming_queue_.empty())
@@ -64,13 +88,32 @@ void IncomingTaskQueue::WillDestroyCurrentMessageLoop() {
   }
 #endif
 
+  // Posting threads check |lock_free_shutdown_| without taking the lock; the
+  // ones that already passed the check only dereference |message_loop_| under
+  // the lock below.
+  subtle::Release_Store(&lock_free_shutdown_, 1);
+
   AutoLock lock(incoming_queue_lock_);
   message_loop_ = NULL;
 }
 
+uint64 IncomingTaskQueue::GetTaskTraceID(const PendingTask& task) const {
+  return (static_cast<uint64>(task.sequence_num) << 32) |
+         ((static_cast<uint64>(reinterpret_cast<intptr_t>(this)) << 32) >> 32);
+}
+
 IncomingTaskQueue::~IncomingTaskQueue() {
   // Verify that WillDestroyCurrentMessageLoop() has been called.
   DCHECK(!message_loop_);
+
+  // Delete the tasks that were posted after the message loop went away.
+  LockFreeNode* node =
+      reinterpret_cast<LockFreeNode*>(subtle::Acquire_Load(&lock_free_head_));
+  while (node) {
+    LockFreeNode* next = node->next;
+    delete node;
+    node = next;
+  }
 }
 
 TimeTicks IncomingTaskQueue::CalculateDelayedRuntime(TimeDelta delay) {
@@ -132,7 +175,7 @@ bool IncomingTaskQueue::PostPendingTask(PendingTask* pending_task) {
 
   TRACE_EVENT_FLOW_BEGIN0(TRACE_DISABLED_BY_DEFAULT("toplevel.flow"),
       "MessageLoop::PostTask",
-      TRACE_ID_MANGLE(message_loop_->GetTaskTraceID(*pending_task)));
+      TRACE_ID_MANGLE(GetTaskTraceID(*pending_task)));
 
   bool was_empty = incoming_queue_.empty();
   incoming_queue_.push(*pending_task);
@@ -144,5 +187,71 @@ bool IncomingTaskQueue::PostPendingTask(PendingTask* pending_task) {
   return true;
 }
 
+bool IncomingTaskQueue::PostPendingTaskLockFree(PendingTask* pending_task) {
+  if (subtle::Acquire_Load(&lock_free_shutdown_)) {
+    pending_task->task.Reset();
+    return false;
+  }
+
+  // Tasks posted from the same thread get increasing sequence numbers, which
+  // is all the FIFO ordering of equal |delayed_run_time| values relies on.
+  pending_task->sequence_num =
+      subtle::NoBarrier_AtomicIncrement(&lock_free_sequence_num_, 1) - 1;
+
+  TRACE_EVENT_FLOW_BEGIN0(TRACE_DISABLED_BY_DEFAULT("toplevel.flow"),
+      "MessageLoop::PostTask",
+      TRACE_ID_MANGLE(GetTaskTraceID(*pending_task)));
+
+  LockFreeNode* node = new LockFreeNode(*pending_task);
+  pending_task->task.Reset();
+
+  // The release barrier publishes |node| to ReloadWorkQueueLockFree().
+  subtle::AtomicWord head = subtle::NoBarrier_Load(&lock_free_head_);
+  for (;;) {
+    node->next = reinterpret_cast<LockFreeNode*>(head);
+    subtle::AtomicWord previous_head = subtle::Release_CompareAndSwap(
+        &lock_free_head_, head, reinterpret_cast<subtle::AtomicWord>(node));
+    if (previous_head == head)
+      break;
+    head = previous_head;
+  }
+
+  // Only the thread that made the stack non-empty needs to wake up the pump:
+  // the message loop drains the whole stack once it runs.
+  if (!head) {
+    AutoLock lock(incoming_queue_lock_);
+    if (message_loop_)
+      message_loop_->ScheduleWork(true);
+  }
+
+  return true;
+}
+
+void IncomingTaskQueue::ReloadWorkQueueLockFree(TaskQueue* work_queue) {
+  LockFreeNode* node = reinterpret_cast<LockFreeNode*>(
+      subtle::NoBarrier_AtomicExchange(&lock_free_head_, 0));
+  if (!node)
+    return;
+
+  // Pairs with the release barrier in PostPendingTaskLockFree().
+  subtle::MemoryBarrier();
+
+  // The stack is in LIFO order, reverse it to get the posting order back.
+  LockFreeNode* reversed = NULL;
+  while (node) {
+    LockFreeNode* next = node->next;
+    node->next = reversed;
+    reversed = node;
+    node = next;
+  }
+
+  while (reversed) {
+    LockFreeNode* next = reversed->next;
+    work_queue->push(reversed->task);
+    delete reversed;
+    reversed = next;
+  }
+}
+
 }  // namespace internal
 }  // namespace base
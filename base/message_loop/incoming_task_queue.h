@@ -5,6 +5,7 @@
 #ifndef BASE_MESSAGE_LOOP_INCOMING_TASK_QUEUE_H_
 #define BASE_MESSAGE_LOOP_INCOMING_TASK_QUEUE_H_
 
+#include "base/atomicops.h"
 #include "base/base_export.h"
 #include "base/memory/ref_counted.h"
 #include "base/pending_task.h"
@@ -21,10 +22,17 @@ namespace internal {
 // Implements a queue of tasks posted to the message loop running on the current
 // thread. This class takes care of synchronizing posting tasks from different
 // threads and together with MessageLoop ensures clean shutdown.
+//
+// By default posting is serialized by |incoming_queue_lock_|. When
+// |lock_free| is true, posting threads instead push onto an intrusive
+// multi-producer single-consumer stack with a single compare-and-swap, and
+// the lock is only taken on the empty -> non-empty transition to wake up the
+// message pump. ReloadWorkQueue() detaches the whole stack at once and
+// restores FIFO order before handing the tasks to the message loop.
 class BASE_EXPORT IncomingTaskQueue
     : public RefCountedThreadSafe<IncomingTaskQueue> {
  public:
-  explicit IncomingTaskQueue(MessageLoop* message_loop);
+  IncomingTaskQueue(MessageLoop* message_loop, bool lock_free);
 
   // Appends a task to the incoming queue. Posting of all tasks is routed though
   // AddToIncomingQueue() or TryAddToIncomingQueue() to make sure that posting
@@ -52,8 +60,25 @@ class BASE_EXPORT IncomingTaskQueue
   // Disconnects |this| from the parent message loop.
   void WillDestroyCurrentMessageLoop();
 
+  // Creates a process-wide unique ID to represent |task| in trace events. The
+  // ID does not depend on the parent message loop, so it can be computed by
+  // posting threads racing with the loop's destruction.
+  uint64 GetTaskTraceID(const PendingTask& task) const;
+
+  bool is_lock_free() const { return lock_free_; }
+
  private:
   friend class RefCountedThreadSafe<IncomingTaskQueue>;
+
+  // A node of the lock-free incoming stack.
+  struct LockFreeNode {
+    explicit LockFreeNode(const PendingTask& pending_task)
+        : task(pending_task), next(NULL) {}
+
+    PendingTask task;
+    LockFreeNode* next;
+  };
+
   virtual ~IncomingTaskQueue();
 
   // Calculates the time at which a PendingTask should run.
@@ -65,6 +90,14 @@ class BASE_EXPORT IncomingTaskQueue
   // does not retain |pending_task->task| beyond this function call.
   bool PostPendingTask(PendingTask* pending_task);
 
+  // Lock-free counterpart of PostPendingTask(). Must be called without
+  // holding |incoming_queue_lock_|.
+  bool PostPendingTaskLockFree(PendingTask* pending_task);
+
+  // Moves the tasks of the lock-free stack into |work_queue| in the order in
+  // which they were posted.
+  void ReloadWorkQueueLockFree(TaskQueue* work_queue);
+
 #if defined(OS_WIN)
   TimeTicks high_resolution_timer_expiration_;
 #endif
@@ -84,6 +117,17 @@ class BASE_EXPORT IncomingTaskQueue
   // The next sequence number to use for delayed tasks.
   int next_sequence_num_;
 
+  // Whether the lock-free backend is used. Does not change after construction.
+  const bool lock_free_;
+
+  // The lock-free backend state. |lock_free_head_| holds the most recently
+  // posted LockFreeNode (the stack is in LIFO order), |lock_free_sequence_num_|
+  // replaces |next_sequence_num_| and |lock_free_shutdown_| is set once
+  // WillDestroyCurrentMessageLoop() has been called.
+  subtle::AtomicWord lock_free_head_;
+  subtle::Atomic32 lock_free_sequence_num_;
+  subtle::Atomic32 lock_free_shutdown_;
+
   DISALLOW_COPY_AND_ASSIGN(IncomingTaskQueue);
 };
 
@@ -88,6 +88,8 @@ const LinearHistogram::DescriptionPair event_descriptions_[] = {
 
 bool enable_histogrammer_ = false;
 
+bool enable_lock_free_incoming_queue_ = false;
+
 MessageLoop::MessagePumpFactory* message_pump_for_ui_factory_ = NULL;
 
 // Returns true if MessagePump::ScheduleWork() must be called one
@@ -100,6 +102,18 @@ bool AlwaysNotifyPump(MessageLoop::Type type) {
 #endif
 }
 
+// Returns true if the lock-free IncomingTaskQueue backend can be used for a
+// MessageLoop of the given |type|. It only notifies the pump on the
+// empty -> non-empty transition of the queue, and on Windows the delayed run
+// time calculation needs the queue lock for the high resolution timer lease.
+bool CanUseLockFreeIncomingQueue(MessageLoop::Type type) {
+#if defined(OS_WIN)
+  return false;
+#else
+  return !AlwaysNotifyPump(type);
+#endif
+}
+
 }  // namespace
 
 //------------------------------------------------------------------------------
@@ -191,6 +205,11 @@ void MessageLoop::EnableHistogrammer(bool enable) {
   enable_histogrammer_ = enable;
 }
 
+// static
+void MessageLoop::EnableLockFreeIncomingQueue(bool enable) {
+  enable_lock_free_incoming_queue_ = enable;
+}
+
 // static
 bool MessageLoop::InitMessagePumpForUIFactory(MessagePumpFactory* factory) {
   if (message_pump_for_ui_factory_)
@@ -376,7 +395,9 @@ void MessageLoop::Init() {
   DCHECK(!current()) << "should only have one message loop per thread";
   lazy_tls_ptr.Pointer()->Set(this);
 
-  incoming_task_queue_ = new internal::IncomingTaskQueue(this);
+  incoming_task_queue_ = new internal::IncomingTaskQueue(
+      this,
+      enable_lock_free_incoming_queue_ && CanUseLockFreeIncomingQueue(type_));
   message_loop_proxy_ =
       new internal::MessageLoopProxyImpl(incoming_task_queue_);
   thread_task_runner_handle_.reset(
@@ -505,8 +526,9 @@ bool MessageLoop::DeletePendingTasks() {
 }
 
 uint64 MessageLoop::GetTaskTraceID(const PendingTask& task) {
-  return (static_cast<uint64>(task.sequence_num) << 32) |
-         ((static_cast<uint64>(reinterpret_cast<intptr_t>(this)) << 32) >> 32);
+  // The ID has to match the one used by the incoming queue when the task was
+  // posted.
+  return incoming_task_queue_->GetTaskTraceID(task);
 }
 
 void MessageLoop::ReloadWorkQueue() {
@@ -156,6 +156,12 @@ class BASE_EXPORT MessageLoop : public MessagePump::Delegate {
 
   static void EnableHistogrammer(bool enable_histogrammer);
 
+  // Makes MessageLoops created afterwards post tasks through a lock-free
+  // incoming queue, which scales better when many threads post to the same
+  // loop. Ignored on platforms and loop types whose pump must be notified of
+  // every posted task.
+  static void EnableLockFreeIncomingQueue(bool enable);
+
   typedef scoped_ptr<MessagePump> (MessagePumpFactory)();
   // Uses the given base::MessagePumpForUIFactory to override the default
   // MessagePump implementation for 'TYPE_UI'. Returns true if the factory
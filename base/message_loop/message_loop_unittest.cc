@@ -9,6 +9,7 @@
 #include "base/compiler_specific.h"
 #include "base/logging.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/scoped_vector.h"
 #include "base/message_loop/message_loop.h"
 #include "base/message_loop/message_loop_proxy_impl.h"
 #include "base/message_loop/message_loop_test.h"
@@ -958,6 +959,84 @@ TEST(MessageLoopTest, IsType) {
   EXPECT_FALSE(loop.IsType(MessageLoop::TYPE_DEFAULT));
 }
 
+#if !defined(OS_WIN)
+
+namespace {
+
+const int kLockFreeTasksPerThread = 1000;
+
+void RecordOrder(std::vector<int>* order, int value, int* remaining) {
+  order->push_back(value);
+  if (!--*remaining)
+    MessageLoop::current()->QuitWhenIdle();
+}
+
+void PostOrderedTasks(scoped_refptr<MessageLoopProxy> target,
+                      std::vector<int>* order,
+                      int* remaining) {
+  for (int i = 0; i < kLockFreeTasksPerThread; ++i)
+    target->PostTask(FROM_HERE, Bind(&RecordOrder, order, i, remaining));
+}
+
+}  // namespace
+
+// Verify that the lock-free incoming queue runs every task and keeps tasks
+// posted from the same thread in FIFO order.
+TEST(MessageLoopTest, LockFreeIncomingQueueOrdering) {
+  const int kNumProducers = 4;
+
+  MessageLoop::EnableLockFreeIncomingQueue(true);
+  MessageLoop loop;
+  MessageLoop::EnableLockFreeIncomingQueue(false);
+
+  std::vector<int> orders[kNumProducers];
+  int remaining[kNumProducers];
+  int producers_left = kNumProducers;
+  ScopedVector<Thread> producers;
+  for (int i = 0; i < kNumProducers; ++i) {
+    remaining[i] = kLockFreeTasksPerThread;
+    producers.push_back(new Thread("Producer"));
+    ASSERT_TRUE(producers.back()->Start());
+  }
+  for (int i = 0; i < kNumProducers; ++i) {
+    producers[i]->message_loop()->PostTask(
+        FROM_HERE,
+        Bind(&PostOrderedTasks, loop.message_loop_proxy(), &orders[i],
+             &remaining[i]));
+  }
+
+  // Each producer quits the loop once all of its tasks ran; keep running
+  // until every producer is done.
+  while (producers_left) {
+    loop.Run();
+    producers_left = 0;
+    for (int i = 0; i < kNumProducers; ++i) {
+      if (remaining[i])
+        ++producers_left;
+    }
+  }
+
+  for (int i = 0; i < kNumProducers; ++i) {
+    ASSERT_EQ(static_cast<size_t>(kLockFreeTasksPerThread), orders[i].size());
+    for (int j = 0; j < kLockFreeTasksPerThread; ++j)
+      EXPECT_EQ(j, orders[i][j]);
+  }
+}
+
+// Verify that posting to a lock-free queue whose loop is gone fails cleanly.
+TEST(MessageLoopTest, LockFreeIncomingQueuePostAfterDestruction) {
+  scoped_refptr<MessageLoopProxy> proxy;
+  {
+    MessageLoop::EnableLockFreeIncomingQueue(true);
+    MessageLoop loop;
+    MessageLoop::EnableLockFreeIncomingQueue(false);
+    proxy = loop.message_loop_proxy();
+  }
+  EXPECT_FALSE(proxy->PostTask(FROM_HERE, Bind(&DoNothing)));
+}
+
+#endif  // !defined(OS_WIN)
+
 #if defined(OS_WIN)
 void EmptyFunction() {}
 
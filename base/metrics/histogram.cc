@@ -18,6 +18,7 @@
 #include "base/debug/alias.h"
 #include "base/logging.h"
 #include "base/metrics/sample_vector.h"
+#include "base/metrics/shared_histogram_allocator.h"
 #include "base/metrics/statistics_recorder.h"
 #include "base/pickle.h"
 #include "base/strings/string_util.h"
@@ -105,6 +106,7 @@ HistogramBase* Histogram::FactoryGet(const string& name,
         new Histogram(name, minimum, maximum, registered_ranges);
 
     tentative_histogram->SetFlags(flags);
+    tentative_histogram->MaybeUseSharedMemorySamples();
     histogram =
         StatisticsRecorder::RegisterOrDeleteDuplicate(tentative_histogram);
   }
@@ -320,9 +322,33 @@ Histogram::Histogram(const string& name,
     samples_.reset(new SampleVector(ranges));
 }
 
+Histogram::Histogram(const string& name,
+                     Sample minimum,
+                     Sample maximum,
+                     const BucketRanges* ranges,
+                     scoped_ptr<SampleVector> samples)
+  : HistogramBase(name),
+    bucket_ranges_(ranges),
+    declared_min_(minimum),
+    declared_max_(maximum),
+    samples_(samples.Pass()) {
+}
+
 Histogram::~Histogram() {
 }
 
+void Histogram::MaybeUseSharedMemorySamples() {
+  SharedHistogramAllocator* allocator = SharedHistogramAllocator::GetGlobal();
+  if (!allocator)
+    return;
+  scoped_ptr<SampleVector> samples(allocator->AllocateSamples(*this));
+  if (!samples)
+    return;
+  DCHECK_EQ(0, samples_->TotalCount());
+  samples_ = samples.Pass();
+  SetFlags(kSharedMemoryFlag);
+}
+
 bool Histogram::PrintEmptyBucket(size_t index) const {
   return true;
 }
@@ -571,6 +597,7 @@ HistogramBase* LinearHistogram::FactoryGetWithRangeDescription(
     }
 
     tentative_histogram->SetFlags(flags);
+    tentative_histogram->MaybeUseSharedMemorySamples();
     histogram =
         StatisticsRecorder::RegisterOrDeleteDuplicate(tentative_histogram);
   }
@@ -676,6 +703,7 @@ HistogramBase* BooleanHistogram::FactoryGet(const string& name, int32 flags) {
         new BooleanHistogram(name, registered_ranges);
 
     tentative_histogram->SetFlags(flags);
+    tentative_histogram->MaybeUseSharedMemorySamples();
     histogram =
         StatisticsRecorder::RegisterOrDeleteDuplicate(tentative_histogram);
   }
@@ -734,6 +762,7 @@ HistogramBase* CustomHistogram::FactoryGet(const string& name,
         new CustomHistogram(name, registered_ranges);
 
     tentative_histogram->SetFlags(flags);
+    tentative_histogram->MaybeUseSharedMemorySamples();
 
     histogram =
         StatisticsRecorder::RegisterOrDeleteDuplicate(tentative_histogram);
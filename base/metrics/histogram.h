@@ -473,8 +473,21 @@ class BASE_EXPORT Histogram : public HistogramBase {
             Sample maximum,
             const BucketRanges* ranges);
 
+  // Like above, but the histogram records into |samples|, e.g. samples in
+  // memory shared with another process.
+  Histogram(const std::string& name,
+            Sample minimum,
+            Sample maximum,
+            const BucketRanges* ranges,
+            scoped_ptr<SampleVector> samples);
+
   virtual ~Histogram();
 
+  // Called by the factory methods on a histogram not registered yet: moves
+  // its samples into the segment of the global SharedHistogramAllocator, if
+  // there is one and it has room left.
+  void MaybeUseSharedMemorySamples();
+
   // HistogramBase implementation:
   virtual bool SerializeInfoImpl(Pickle* pickle) const OVERRIDE;
 
@@ -73,6 +73,12 @@ class BASE_EXPORT HistogramBase {
     // the source histogram!).
     kIPCSerializationSourceFlag = 0x10,
 
+    // Indicates that the samples of the histogram live in memory shared with
+    // another process, which reads them directly. Such histograms don't need
+    // to be pickled to be sent across an IPC Channel. See
+    // SharedHistogramAllocator.
+    kSharedMemoryFlag = 0x20,
+
     // Only for Histogram and its sub classes: fancy bucket-naming support.
     kHexRangePrintingFlag = 0x8000,
   };
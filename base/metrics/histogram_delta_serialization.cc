@@ -7,6 +7,7 @@
 #include "base/logging.h"
 #include "base/metrics/histogram_base.h"
 #include "base/metrics/histogram_snapshot_manager.h"
+#include "base/metrics/statistics_recorder.h"
 #include "base/numerics/safe_conversions.h"
 #include "base/pickle.h"
 #include "base/values.h"
@@ -62,11 +63,22 @@ HistogramDeltaSerialization::~HistogramDeltaSerialization() {
 void HistogramDeltaSerialization::PrepareAndSerializeDeltas(
     std::vector<std::string>* serialized_deltas) {
   serialized_deltas_ = serialized_deltas;
+
+  // Histograms in shared memory are read directly by the receiving process.
+  StatisticsRecorder::Histograms histograms;
+  StatisticsRecorder::GetHistograms(&histograms);
+  StatisticsRecorder::Histograms unshared_histograms;
+  for (size_t i = 0; i < histograms.size(); ++i) {
+    if (!(histograms[i]->flags() & HistogramBase::kSharedMemoryFlag))
+      unshared_histograms.push_back(histograms[i]);
+  }
+
   // Note: Before serializing, we set the kIPCSerializationSourceFlag for all
   // the histograms, so that the receiving process can distinguish them from the
   // local histograms.
   histogram_snapshot_manager_.PrepareDeltas(
-      Histogram::kIPCSerializationSourceFlag, Histogram::kNoFlags);
+      unshared_histograms, Histogram::kIPCSerializationSourceFlag,
+      Histogram::kNoFlags);
   serialized_deltas_ = NULL;
 }
 
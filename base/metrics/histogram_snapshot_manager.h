@@ -7,6 +7,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "base/metrics/histogram_base.h"
@@ -37,6 +38,12 @@ class BASE_EXPORT HistogramSnapshotManager {
   void PrepareDeltas(HistogramBase::Flags flags_to_set,
                      HistogramBase::Flags required_flags);
 
+  // Like above, but for |histograms| instead of all the histograms registered
+  // with StatisticsRecorder.
+  void PrepareDeltas(const std::vector<HistogramBase*>& histograms,
+                     HistogramBase::Flags flags_to_set,
+                     HistogramBase::Flags required_flags);
+
  private:
   // Snapshot this histogram, and record the delta.
   void PrepareDelta(const HistogramBase& histogram);
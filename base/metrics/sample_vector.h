@@ -23,6 +23,11 @@ class BucketRanges;
 class BASE_EXPORT_PRIVATE SampleVector : public HistogramSamples {
  public:
   explicit SampleVector(const BucketRanges* bucket_ranges);
+  // Records into |counts|, which has an entry per bucket of |bucket_ranges|,
+  // and |meta| instead of memory of its own. Neither is owned.
+  SampleVector(HistogramBase::AtomicCount* counts,
+               HistogramSamples::Metadata* meta,
+               const BucketRanges* bucket_ranges);
   virtual ~SampleVector();
 
   // HistogramSamples implementation:
@@ -46,7 +51,12 @@ class BASE_EXPORT_PRIVATE SampleVector : public HistogramSamples {
  private:
   FRIEND_TEST_ALL_PREFIXES(HistogramTest, CorruptSampleCounts);
 
-  std::vector<HistogramBase::AtomicCount> counts_;
+  // Used when the counts are not stored elsewhere.
+  std::vector<HistogramBase::AtomicCount> local_counts_;
+
+  // Points to |local_counts_| or to the counts passed to the constructor.
+  HistogramBase::AtomicCount* counts_;
+  const size_t counts_size_;
 
   // Shares the same BucketRanges with Histogram object.
   const BucketRanges* const bucket_ranges_;
@@ -56,7 +66,8 @@ class BASE_EXPORT_PRIVATE SampleVector : public HistogramSamples {
 
 class BASE_EXPORT_PRIVATE SampleVectorIterator : public SampleCountIterator {
  public:
-  SampleVectorIterator(const std::vector<HistogramBase::AtomicCount>* counts,
+  SampleVectorIterator(const HistogramBase::AtomicCount* counts,
+                       size_t counts_size,
                        const BucketRanges* bucket_ranges);
   virtual ~SampleVectorIterator();
 
@@ -73,7 +84,8 @@ class BASE_EXPORT_PRIVATE SampleVectorIterator : public SampleCountIterator {
  private:
   void SkipEmptyBuckets();
 
-  const std::vector<HistogramBase::AtomicCount>* counts_;
+  const HistogramBase::AtomicCount* counts_;
+  size_t counts_size_;
   const BucketRanges* bucket_ranges_;
 
   size_t index_;
@@ -42,6 +42,33 @@ TEST(SampleVectorTest, AccumulateTest) {
   EXPECT_EQ(samples.TotalCount(), samples.redundant_count());
 }
 
+TEST(SampleVectorTest, ExternalStorageTest) {
+  // Custom buckets: [1, 5) [5, 10)
+  BucketRanges ranges(3);
+  ranges.set_range(0, 1);
+  ranges.set_range(1, 5);
+  ranges.set_range(2, 10);
+
+  HistogramBase::AtomicCount counts[2] = { 0, 0 };
+  HistogramSamples::Metadata meta;
+  SampleVector samples(counts, &meta, &ranges);
+
+  samples.Accumulate(1, 200);
+  samples.Accumulate(5, 100);
+  EXPECT_EQ(200, counts[0]);
+  EXPECT_EQ(100, counts[1]);
+  EXPECT_EQ(700, meta.sum);
+  EXPECT_EQ(300, meta.redundant_count);
+
+  // Samples written to the storage by someone else are visible.
+  counts[1] += 1;
+  meta.sum += 5;
+  meta.redundant_count += 1;
+  EXPECT_EQ(101, samples.GetCountAtIndex(1));
+  EXPECT_EQ(705, samples.sum());
+  EXPECT_EQ(samples.TotalCount(), samples.redundant_count());
+}
+
 TEST(SampleVectorTest, AddSubtractTest) {
   // Custom buckets: [0, 1) [1, 2) [2, 3) [3, INT_MAX)
   BucketRanges ranges(5);
@@ -185,7 +212,7 @@ TEST(SampleVectorIteratorTest, IterateTest) {
   counts[2] = 2;
 
   // BucketRanges can have larger size than counts.
-  SampleVectorIterator it(&counts, &ranges);
+  SampleVectorIterator it(&counts[0], counts.size(), &ranges);
   size_t index;
 
   HistogramBase::Sample min;
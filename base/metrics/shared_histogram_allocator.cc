@@ -0,0 +1,273 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/metrics/shared_histogram_allocator.h"
+
+#include <string.h>
+
+#include "base/atomicops.h"
+#include "base/logging.h"
+#include "base/memory/shared_memory.h"
+#include "base/metrics/bucket_ranges.h"
+#include "base/metrics/histogram.h"
+#include "base/metrics/sample_vector.h"
+#include "base/metrics/statistics_recorder.h"
+
+namespace base {
+
+namespace {
+
+const uint32 kSegmentMagic = 0x48495354;  // 'HIST'
+const uint32 kSegmentVersion = 1;
+
+// Histogram names are not expected to get anywhere close to this.
+const uint32 kMaxNameLength = 1024;
+
+// The allocator passed to SetGlobal().
+subtle::AtomicWord g_allocator = 0;
+
+uint32 AlignRecordSize(size_t size) {
+  return static_cast<uint32>((size + 7) & ~static_cast<size_t>(7));
+}
+
+// A histogram of another process, recording into a record of the segment.
+class SharedHistogram : public Histogram {
+ public:
+  SharedHistogram(const std::string& name,
+                  HistogramType type,
+                  Sample minimum,
+                  Sample maximum,
+                  const BucketRanges* ranges,
+                  scoped_ptr<SampleVector> samples)
+      : Histogram(name, minimum, maximum, ranges, samples.Pass()),
+        type_(type) {}
+  virtual ~SharedHistogram() {}
+
+  virtual HistogramType GetHistogramType() const OVERRIDE { return type_; }
+
+ private:
+  const HistogramType type_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedHistogram);
+};
+
+struct SegmentHeader {
+  uint32 magic;
+  uint32 version;
+  uint32 size;
+
+  // Bytes of the segment in use, including this header. A record is published
+  // by advancing it past the record once the record is written.
+  subtle::Atomic32 used;
+};
+
+// Followed by the bucket_count + 1 ranges of the histogram, its bucket_count
+// counts, and the characters of its name.
+struct RecordHeader {
+  uint32 size;
+  int32 type;
+  int32 flags;
+  HistogramBase::Sample declared_min;
+  HistogramBase::Sample declared_max;
+  uint32 bucket_count;
+  uint32 name_length;
+  uint32 ranges_checksum;
+  HistogramSamples::Metadata meta;
+};
+
+size_t RangesOffset() {
+  return sizeof(RecordHeader);
+}
+
+size_t CountsOffset(uint32 bucket_count) {
+  return RangesOffset() + (bucket_count + 1) * sizeof(HistogramBase::Sample);
+}
+
+size_t NameOffset(uint32 bucket_count) {
+  return CountsOffset(bucket_count) +
+      bucket_count * sizeof(HistogramBase::AtomicCount);
+}
+
+SegmentHeader* GetSegmentHeader(SharedMemory* memory) {
+  return static_cast<SegmentHeader*>(memory->memory());
+}
+
+}  // namespace
+
+SharedHistogramAllocator::SharedHistogramAllocator(
+    scoped_ptr<SharedMemory> memory)
+    : memory_(memory.Pass()),
+      next_record_offset_(sizeof(SegmentHeader)),
+      corrupt_(false) {
+  DCHECK(memory_->memory());
+  SegmentHeader* segment = GetSegmentHeader(memory_.get());
+  if (memory_->mapped_size() >= sizeof(SegmentHeader) &&
+      segment->magic == 0 && subtle::NoBarrier_Load(&segment->used) == 0) {
+    segment->version = kSegmentVersion;
+    segment->size = static_cast<uint32>(memory_->mapped_size());
+    segment->magic = kSegmentMagic;
+    subtle::Release_Store(&segment->used, sizeof(SegmentHeader));
+  }
+}
+
+SharedHistogramAllocator::~SharedHistogramAllocator() {}
+
+// static
+void SharedHistogramAllocator::SetGlobal(
+    scoped_ptr<SharedHistogramAllocator> allocator) {
+  CHECK(!subtle::NoBarrier_Load(&g_allocator));
+  subtle::Release_Store(&g_allocator,
+                        reinterpret_cast<subtle::AtomicWord>(
+                            allocator.release()));
+}
+
+// static
+SharedHistogramAllocator* SharedHistogramAllocator::GetGlobal() {
+  return reinterpret_cast<SharedHistogramAllocator*>(
+      subtle::Acquire_Load(&g_allocator));
+}
+
+// static
+scoped_ptr<SharedHistogramAllocator>
+SharedHistogramAllocator::ReleaseGlobalForTesting() {
+  SharedHistogramAllocator* allocator = GetGlobal();
+  subtle::Release_Store(&g_allocator, 0);
+  return scoped_ptr<SharedHistogramAllocator>(allocator);
+}
+
+bool SharedHistogramAllocator::IsValid() const {
+  const SegmentHeader* segment = GetSegmentHeader(memory_.get());
+  return memory_->mapped_size() >= sizeof(SegmentHeader) &&
+      segment->magic == kSegmentMagic &&
+      segment->version == kSegmentVersion &&
+      segment->size <= memory_->mapped_size();
+}
+
+scoped_ptr<SampleVector> SharedHistogramAllocator::AllocateSamples(
+    const Histogram& histogram) {
+  if (!IsValid())
+    return scoped_ptr<SampleVector>();
+
+  const BucketRanges* ranges = histogram.bucket_ranges();
+  const std::string& name = histogram.histogram_name();
+  uint32 bucket_count = static_cast<uint32>(ranges->bucket_count());
+  if (name.size() > kMaxNameLength)
+    return scoped_ptr<SampleVector>();
+  uint32 name_length = static_cast<uint32>(name.size());
+  uint32 size = AlignRecordSize(NameOffset(bucket_count) + name_length);
+
+  AutoLock auto_lock(lock_);
+  SegmentHeader* segment = GetSegmentHeader(memory_.get());
+  uint32 used = subtle::NoBarrier_Load(&segment->used);
+  if (size > segment->size - used)
+    return scoped_ptr<SampleVector>();
+
+  char* record_start = static_cast<char*>(memory_->memory()) + used;
+  RecordHeader* record = reinterpret_cast<RecordHeader*>(record_start);
+  record->size = size;
+  record->type = histogram.GetHistogramType();
+  record->flags = histogram.flags();
+  record->declared_min = histogram.declared_min();
+  record->declared_max = histogram.declared_max();
+  record->bucket_count = bucket_count;
+  record->name_length = name_length;
+  record->ranges_checksum = ranges->checksum();
+
+  HistogramBase::Sample* record_ranges =
+      reinterpret_cast<HistogramBase::Sample*>(record_start + RangesOffset());
+  for (size_t i = 0; i < ranges->size(); ++i)
+    record_ranges[i] = ranges->range(i);
+  memcpy(record_start + NameOffset(bucket_count), name.data(), name_length);
+
+  subtle::Release_Store(&segment->used, used + size);
+
+  HistogramBase::AtomicCount* counts =
+      reinterpret_cast<HistogramBase::AtomicCount*>(
+          record_start + CountsOffset(bucket_count));
+  return scoped_ptr<SampleVector>(
+      new SampleVector(counts, &record->meta, ranges));
+}
+
+void SharedHistogramAllocator::GetNewHistograms(
+    ScopedVector<HistogramBase>* histograms) {
+  if (corrupt_ || !IsValid())
+    return;
+
+  uint32 used = subtle::Acquire_Load(&GetSegmentHeader(memory_.get())->used);
+  if (used > GetSegmentHeader(memory_.get())->size) {
+    corrupt_ = true;
+    return;
+  }
+  while (next_record_offset_ < used) {
+    uint32 record_size;
+    HistogramBase* histogram =
+        ReadRecord(next_record_offset_, used, &record_size);
+    if (!histogram) {
+      DLOG(ERROR) << "Invalid histogram record in shared memory";
+      corrupt_ = true;
+      return;
+    }
+    histograms->push_back(histogram);
+    next_record_offset_ += record_size;
+  }
+}
+
+HistogramBase* SharedHistogramAllocator::ReadRecord(uint32 offset,
+                                                    uint32 used,
+                                                    uint32* record_size) {
+  if (used - offset < sizeof(RecordHeader))
+    return NULL;
+
+  // The other process can still write to the record, so work on a copy.
+  char* record_start = static_cast<char*>(memory_->memory()) + offset;
+  RecordHeader* record = reinterpret_cast<RecordHeader*>(record_start);
+  RecordHeader copy = *record;
+
+  if (copy.bucket_count < 1 || copy.bucket_count > Histogram::kBucketCount_MAX ||
+      copy.name_length > kMaxNameLength) {
+    return NULL;
+  }
+  if (copy.size != AlignRecordSize(NameOffset(copy.bucket_count) +
+                                   copy.name_length) ||
+      copy.size > used - offset) {
+    return NULL;
+  }
+  HistogramType type = static_cast<HistogramType>(copy.type);
+  if (type != HISTOGRAM && type != LINEAR_HISTOGRAM &&
+      type != BOOLEAN_HISTOGRAM && type != CUSTOM_HISTOGRAM) {
+    return NULL;
+  }
+
+  const HistogramBase::Sample* record_ranges =
+      reinterpret_cast<const HistogramBase::Sample*>(record_start +
+                                                     RangesOffset());
+  scoped_ptr<BucketRanges> ranges(new BucketRanges(copy.bucket_count + 1));
+  for (size_t i = 0; i < ranges->size(); ++i) {
+    ranges->set_range(i, record_ranges[i]);
+    if (i > 0 && ranges->range(i) <= ranges->range(i - 1))
+      return NULL;
+  }
+  ranges->ResetChecksum();
+  if (ranges->checksum() != copy.ranges_checksum)
+    return NULL;
+  const BucketRanges* registered_ranges =
+      StatisticsRecorder::RegisterOrDeleteDuplicateRanges(ranges.release());
+
+  std::string name(record_start + NameOffset(copy.bucket_count),
+                   copy.name_length);
+  HistogramBase::AtomicCount* counts =
+      reinterpret_cast<HistogramBase::AtomicCount*>(
+          record_start + CountsOffset(copy.bucket_count));
+  scoped_ptr<SampleVector> samples(
+      new SampleVector(counts, &record->meta, registered_ranges));
+
+  SharedHistogram* histogram =
+      new SharedHistogram(name, type, copy.declared_min, copy.declared_max,
+                          registered_ranges, samples.Pass());
+  histogram->SetFlags(copy.flags);
+  *record_size = copy.size;
+  return histogram;
+}
+
+}  // namespace base
@@ -0,0 +1,88 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// SharedHistogramAllocator places the samples of histograms in a shared memory
+// segment, so that another process can read them directly instead of having
+// them pickled and sent over IPC. The process owning the histograms installs
+// an allocator with SetGlobal(), after which the histograms created by the
+// factory methods of Histogram and its sub classes record into the segment.
+// The process reading them wraps the same segment in an allocator, and
+// gets the histograms with GetNewHistograms() (see SharedHistogramReader).
+//
+// The segment is a header followed by records, each describing a histogram
+// and holding its samples. Records are only ever appended, so a reader can
+// scan the records added since its previous scan. The reader validates every
+// record, as the writing process may be compromised.
+
+#ifndef BASE_METRICS_SHARED_HISTOGRAM_ALLOCATOR_H_
+#define BASE_METRICS_SHARED_HISTOGRAM_ALLOCATOR_H_
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/synchronization/lock.h"
+
+namespace base {
+
+class Histogram;
+class HistogramBase;
+class SampleVector;
+class SharedMemory;
+
+class BASE_EXPORT SharedHistogramAllocator {
+ public:
+  // Takes ownership of |memory|, which must be mapped. If nothing has been
+  // written to the segment yet (it is all zeros), its header is initialized.
+  explicit SharedHistogramAllocator(scoped_ptr<SharedMemory> memory);
+  ~SharedHistogramAllocator();
+
+  // Makes the histograms created from now on in this process record into the
+  // segment of |allocator|, while there is room left. Can only be called once,
+  // and |allocator| is leaked, as histograms are.
+  static void SetGlobal(scoped_ptr<SharedHistogramAllocator> allocator);
+
+  // Returns the allocator passed to SetGlobal(), or NULL.
+  static SharedHistogramAllocator* GetGlobal();
+
+  // Undoes SetGlobal(). The histograms created with the allocator must be
+  // gone before it is destroyed.
+  static scoped_ptr<SharedHistogramAllocator> ReleaseGlobalForTesting();
+
+  // Returns false if the segment was not initialized by an allocator.
+  bool IsValid() const;
+
+  // Describes |histogram| in a new record and returns samples stored in that
+  // record, for |histogram| to record into. Returns an empty scoped_ptr if the
+  // segment is full.
+  scoped_ptr<SampleVector> AllocateSamples(const Histogram& histogram);
+
+  // Appends to |histograms| a histogram for each record added since the
+  // previous call. Their samples are those of the records, and they are not
+  // registered with StatisticsRecorder. Stops at the first invalid record, and
+  // ignores the rest of the segment from then on.
+  void GetNewHistograms(ScopedVector<HistogramBase>* histograms);
+
+ private:
+  // Returns the histogram of the record at |offset|, or NULL if the record is
+  // invalid. |record_size| is set to the size of the record.
+  HistogramBase* ReadRecord(uint32 offset, uint32 used, uint32* record_size);
+
+  scoped_ptr<SharedMemory> memory_;
+
+  // Serializes AllocateSamples() calls.
+  Lock lock_;
+
+  // Offset of the first record GetNewHistograms() has not read yet.
+  uint32 next_record_offset_;
+
+  // Set when GetNewHistograms() finds an invalid record.
+  bool corrupt_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedHistogramAllocator);
+};
+
+}  // namespace base
+
+#endif  // BASE_METRICS_SHARED_HISTOGRAM_ALLOCATOR_H_
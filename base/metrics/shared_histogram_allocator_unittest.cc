@@ -0,0 +1,211 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/metrics/shared_histogram_allocator.h"
+
+#include <vector>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/memory/shared_memory.h"
+#include "base/metrics/histogram.h"
+#include "base/metrics/histogram_samples.h"
+#include "base/metrics/shared_histogram_reader.h"
+#include "base/metrics/statistics_recorder.h"
+#include "base/process/process_handle.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+const size_t kSegmentSize = 64 * 1024;
+
+}  // namespace
+
+class SharedHistogramAllocatorTest : public testing::Test {
+ protected:
+  virtual void SetUp() {
+    InitializeStatisticsRecorder();
+
+    scoped_ptr<SharedMemory> memory(new SharedMemory);
+    ASSERT_TRUE(memory->CreateAndMapAnonymous(kSegmentSize));
+    SharedMemoryHandle handle;
+    ASSERT_TRUE(memory->ShareToProcess(GetCurrentProcessHandle(), &handle));
+    writer_memory_ = memory.get();
+    writer_.reset(new SharedHistogramAllocator(memory.Pass()));
+
+    // A second mapping of the segment, as another process would have.
+    scoped_ptr<SharedMemory> reader_memory(new SharedMemory(handle, false));
+    ASSERT_TRUE(reader_memory->Map(kSegmentSize));
+    reader_.reset(new SharedHistogramAllocator(reader_memory.Pass()));
+  }
+
+  virtual void TearDown() {
+    if (SharedHistogramAllocator::GetGlobal())
+      writer_ = SharedHistogramAllocator::ReleaseGlobalForTesting();
+    UninitializeStatisticsRecorder();
+  }
+
+  void InitializeStatisticsRecorder() {
+    statistics_recorder_ = new StatisticsRecorder();
+  }
+
+  void UninitializeStatisticsRecorder() {
+    delete statistics_recorder_;
+    statistics_recorder_ = NULL;
+  }
+
+  // Histograms created while writing to the segment, as another process
+  // would. They are gone from StatisticsRecorder after StopWriting().
+  void StartWriting() {
+    SharedHistogramAllocator::SetGlobal(writer_.Pass());
+  }
+
+  void StopWriting() {
+    writer_ = SharedHistogramAllocator::ReleaseGlobalForTesting();
+    UninitializeStatisticsRecorder();
+    InitializeStatisticsRecorder();
+  }
+
+  StatisticsRecorder* statistics_recorder_;
+  SharedMemory* writer_memory_;
+  scoped_ptr<SharedHistogramAllocator> writer_;
+  scoped_ptr<SharedHistogramAllocator> reader_;
+};
+
+TEST_F(SharedHistogramAllocatorTest, HistogramsRecordIntoSegment) {
+  EXPECT_TRUE(writer_->IsValid());
+  EXPECT_TRUE(reader_->IsValid());
+
+  StartWriting();
+  HistogramBase* histogram = Histogram::FactoryGet(
+      "Shared", 1, 1000, 10, HistogramBase::kUmaTargetedHistogramFlag);
+  ASSERT_TRUE(histogram);
+  EXPECT_TRUE(histogram->flags() & HistogramBase::kSharedMemoryFlag);
+  histogram->Add(5);
+  histogram->Add(500);
+  StopWriting();
+
+  ScopedVector<HistogramBase> histograms;
+  reader_->GetNewHistograms(&histograms);
+  ASSERT_EQ(1u, histograms.size());
+  EXPECT_EQ("Shared", histograms[0]->histogram_name());
+  EXPECT_EQ(HISTOGRAM, histograms[0]->GetHistogramType());
+  EXPECT_EQ(HistogramBase::kUmaTargetedHistogramFlag,
+            histograms[0]->flags());
+  EXPECT_TRUE(histograms[0]->HasConstructionArguments(1, 1000, 10));
+
+  scoped_ptr<HistogramSamples> samples(histograms[0]->SnapshotSamples());
+  EXPECT_EQ(2, samples->TotalCount());
+  EXPECT_EQ(1, samples->GetCount(5));
+  EXPECT_EQ(505, samples->sum());
+
+  // Samples recorded later are visible to the reader right away.
+  histogram->Add(5);
+  samples = histograms[0]->SnapshotSamples();
+  EXPECT_EQ(2, samples->GetCount(5));
+
+  // Only new records are returned by later calls.
+  reader_->GetNewHistograms(&histograms);
+  EXPECT_EQ(1u, histograms.size());
+}
+
+TEST_F(SharedHistogramAllocatorTest, FullSegment) {
+  StartWriting();
+  HistogramBase* histogram = Histogram::FactoryGet(
+      "Large", 1, 1000000, 10000, HistogramBase::kNoFlags);
+  ASSERT_TRUE(histogram);
+  EXPECT_FALSE(histogram->flags() & HistogramBase::kSharedMemoryFlag);
+  histogram->Add(10);
+  EXPECT_EQ(1, histogram->SnapshotSamples()->TotalCount());
+  StopWriting();
+
+  ScopedVector<HistogramBase> histograms;
+  reader_->GetNewHistograms(&histograms);
+  EXPECT_EQ(0u, histograms.size());
+}
+
+TEST_F(SharedHistogramAllocatorTest, InvalidRecord) {
+  StartWriting();
+  Histogram::FactoryGet("Shared1", 1, 1000, 10, HistogramBase::kNoFlags);
+  Histogram::FactoryGet("Shared2", 1, 1000, 10, HistogramBase::kNoFlags);
+  StopWriting();
+
+  // Corrupt the bucket count, the sixth field, of the second record. Records
+  // start with their size, and follow the four fields of the segment header.
+  char* segment = static_cast<char*>(writer_memory_->memory());
+  const size_t kSegmentHeaderSize = 4 * sizeof(uint32);
+  uint32 first_record_size =
+      *reinterpret_cast<uint32*>(segment + kSegmentHeaderSize);
+  uint32* second_bucket_count = reinterpret_cast<uint32*>(
+      segment + kSegmentHeaderSize + first_record_size) + 5;
+  EXPECT_EQ(10u, *second_bucket_count);
+  *second_bucket_count = 0x7fffffff;
+
+  ScopedVector<HistogramBase> histograms;
+  reader_->GetNewHistograms(&histograms);
+  ASSERT_EQ(1u, histograms.size());
+  EXPECT_EQ("Shared1", histograms[0]->histogram_name());
+
+  // The rest of the segment is ignored from now on.
+  *second_bucket_count = 10;
+  reader_->GetNewHistograms(&histograms);
+  EXPECT_EQ(1u, histograms.size());
+}
+
+TEST_F(SharedHistogramAllocatorTest, ReaderMergesDeltas) {
+  StartWriting();
+  HistogramBase* histogram = Histogram::FactoryGet(
+      "Shared", 1, 1000, 10, HistogramBase::kNoFlags);
+  HistogramBase* linear_histogram = LinearHistogram::FactoryGet(
+      "SharedLinear", 1, 10, 11, HistogramBase::kNoFlags);
+  HistogramBase* boolean_histogram = BooleanHistogram::FactoryGet(
+      "SharedBoolean", HistogramBase::kNoFlags);
+  std::vector<HistogramBase::Sample> custom_ranges;
+  custom_ranges.push_back(5);
+  custom_ranges.push_back(50);
+  HistogramBase* custom_histogram = CustomHistogram::FactoryGet(
+      "SharedCustom", custom_ranges, HistogramBase::kNoFlags);
+  histogram->Add(5);
+  linear_histogram->Add(3);
+  boolean_histogram->AddBoolean(true);
+  custom_histogram->Add(10);
+  StopWriting();
+
+  SharedHistogramReader reader(reader_.Pass());
+  reader.MergeDeltas();
+
+  StatisticsRecorder::Histograms histograms;
+  StatisticsRecorder::GetHistograms(&histograms);
+  ASSERT_EQ(4u, histograms.size());
+
+  HistogramBase* local_histogram = StatisticsRecorder::FindHistogram("Shared");
+  ASSERT_TRUE(local_histogram);
+  EXPECT_NE(histogram, local_histogram);
+  EXPECT_FALSE(local_histogram->flags() & HistogramBase::kSharedMemoryFlag);
+  EXPECT_EQ(1, local_histogram->SnapshotSamples()->GetCount(5));
+  EXPECT_EQ(1, StatisticsRecorder::FindHistogram("SharedLinear")->
+                   SnapshotSamples()->GetCount(3));
+  EXPECT_EQ(1, StatisticsRecorder::FindHistogram("SharedBoolean")->
+                   SnapshotSamples()->GetCount(1));
+  EXPECT_EQ(1, StatisticsRecorder::FindHistogram("SharedCustom")->
+                   SnapshotSamples()->GetCount(10));
+  EXPECT_EQ(CUSTOM_HISTOGRAM,
+            StatisticsRecorder::FindHistogram("SharedCustom")->
+                GetHistogramType());
+
+  // Only the new samples are added.
+  histogram->Add(5);
+  histogram->Add(500);
+  reader.MergeDeltas();
+  scoped_ptr<HistogramSamples> samples(local_histogram->SnapshotSamples());
+  EXPECT_EQ(3, samples->TotalCount());
+  EXPECT_EQ(2, samples->GetCount(5));
+
+  reader.MergeDeltas();
+  EXPECT_EQ(3, local_histogram->SnapshotSamples()->TotalCount());
+}
+
+}  // namespace base
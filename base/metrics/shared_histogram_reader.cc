@@ -0,0 +1,93 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/metrics/shared_histogram_reader.h"
+
+#include <vector>
+
+#include "base/logging.h"
+#include "base/metrics/bucket_ranges.h"
+#include "base/metrics/histogram.h"
+#include "base/metrics/shared_histogram_allocator.h"
+
+namespace base {
+
+namespace {
+
+// Returns the histogram of this process matching |remote|, creating it if
+// necessary, or NULL if one exists with different construction arguments.
+HistogramBase* GetOrCreateLocalHistogram(const Histogram& remote) {
+  const std::string& name = remote.histogram_name();
+  int32 flags = remote.flags() & ~HistogramBase::kSharedMemoryFlag;
+  switch (remote.GetHistogramType()) {
+    case HISTOGRAM:
+      return Histogram::FactoryGet(name, remote.declared_min(),
+                                   remote.declared_max(),
+                                   remote.bucket_count(), flags);
+    case LINEAR_HISTOGRAM:
+      return LinearHistogram::FactoryGet(name, remote.declared_min(),
+                                         remote.declared_max(),
+                                         remote.bucket_count(), flags);
+    case BOOLEAN_HISTOGRAM:
+      return BooleanHistogram::FactoryGet(name, flags);
+    case CUSTOM_HISTOGRAM: {
+      // The first and last ranges are added back by CustomHistogram.
+      std::vector<HistogramBase::Sample> custom_ranges;
+      for (size_t i = 1; i < remote.bucket_count(); ++i)
+        custom_ranges.push_back(remote.ranges(i));
+      return CustomHistogram::FactoryGet(name, custom_ranges, flags);
+    }
+    default:
+      NOTREACHED();
+      return NULL;
+  }
+}
+
+}  // namespace
+
+SharedHistogramReader::SharedHistogramReader(
+    scoped_ptr<SharedHistogramAllocator> allocator)
+    : allocator_(allocator.Pass()),
+      histogram_snapshot_manager_(this) {
+}
+
+SharedHistogramReader::~SharedHistogramReader() {
+}
+
+void SharedHistogramReader::MergeDeltas() {
+  allocator_->GetNewHistograms(&histograms_);
+  histogram_snapshot_manager_.PrepareDeltas(
+      histograms_.get(), HistogramBase::kNoFlags, HistogramBase::kNoFlags);
+}
+
+void SharedHistogramReader::RecordDelta(const HistogramBase& histogram,
+                                        const HistogramSamples& snapshot) {
+  // All the histograms of |allocator_| are Histograms.
+  HistogramBase* local_histogram =
+      GetOrCreateLocalHistogram(static_cast<const Histogram&>(histogram));
+  if (!local_histogram)
+    return;
+
+  if (local_histogram->flags() & HistogramBase::kSharedMemoryFlag) {
+    DVLOG(1) << "Single process mode, histogram observed and not copied: "
+             << histogram.histogram_name();
+    return;
+  }
+  local_histogram->AddSamples(snapshot);
+}
+
+void SharedHistogramReader::InconsistencyDetected(
+    HistogramBase::Inconsistency problem) {
+  // HistogramSnapshotManager drops corrupt deltas, which is all that is
+  // needed here.
+}
+
+void SharedHistogramReader::UniqueInconsistencyDetected(
+    HistogramBase::Inconsistency problem) {
+}
+
+void SharedHistogramReader::InconsistencyDetectedInLoggedCount(int amount) {
+}
+
+}  // namespace base
@@ -0,0 +1,56 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_METRICS_SHARED_HISTOGRAM_READER_H_
+#define BASE_METRICS_SHARED_HISTOGRAM_READER_H_
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/metrics/histogram_flattener.h"
+#include "base/metrics/histogram_snapshot_manager.h"
+
+namespace base {
+
+class HistogramBase;
+class SharedHistogramAllocator;
+
+// Adds the samples another process records in the segment of a
+// SharedHistogramAllocator to the histograms of this process with the same
+// names, creating them if necessary. This replaces pickling the deltas with
+// HistogramDeltaSerialization: the deltas are computed from the segment.
+class BASE_EXPORT SharedHistogramReader : public HistogramFlattener {
+ public:
+  explicit SharedHistogramReader(
+      scoped_ptr<SharedHistogramAllocator> allocator);
+  virtual ~SharedHistogramReader();
+
+  // Adds the samples recorded since the previous call.
+  void MergeDeltas();
+
+ private:
+  // HistogramFlattener implementation.
+  virtual void RecordDelta(const HistogramBase& histogram,
+                           const HistogramSamples& snapshot) OVERRIDE;
+  virtual void InconsistencyDetected(
+      HistogramBase::Inconsistency problem) OVERRIDE;
+  virtual void UniqueInconsistencyDetected(
+      HistogramBase::Inconsistency problem) OVERRIDE;
+  virtual void InconsistencyDetectedInLoggedCount(int amount) OVERRIDE;
+
+  scoped_ptr<SharedHistogramAllocator> allocator_;
+
+  // The histograms of the other process found so far in the segment.
+  ScopedVector<HistogramBase> histograms_;
+
+  // Calculates deltas in histogram counters.
+  HistogramSnapshotManager histogram_snapshot_manager_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedHistogramReader);
+};
+
+}  // namespace base
+
+#endif  // BASE_METRICS_SHARED_HISTOGRAM_READER_H_
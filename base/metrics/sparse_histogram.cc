@@ -4,11 +4,14 @@
 
 #include "base/metrics/sparse_histogram.h"
 
+#include "base/atomic_sequence_num.h"
+#include "base/lazy_instance.h"
 #include "base/metrics/sample_map.h"
 #include "base/metrics/statistics_recorder.h"
 #include "base/pickle.h"
 #include "base/strings/stringprintf.h"
 #include "base/synchronization/lock.h"
+#include "base/threading/thread_local_storage.h"
 
 using std::map;
 using std::string;
@@ -18,6 +21,51 @@ namespace base {
 typedef HistogramBase::Count Count;
 typedef HistogramBase::Sample Sample;
 
+class SparseHistogram::ThreadBuffer
+    : public RefCountedThreadSafe<ThreadBuffer> {
+ public:
+  ThreadBuffer() : samples(new SampleMap), thread_exited(false) {}
+
+  // Only contended when a snapshot merges the buffer.
+  Lock lock;
+  scoped_ptr<SampleMap> samples;
+  bool thread_exited;
+
+ private:
+  friend class RefCountedThreadSafe<ThreadBuffer>;
+  ~ThreadBuffer() {}
+
+  DISALLOW_COPY_AND_ASSIGN(ThreadBuffer);
+};
+
+namespace {
+
+// The buffers of the current thread, by SparseHistogram::thread_buffer_id_.
+typedef map<int, scoped_refptr<SparseHistogram::ThreadBuffer> >
+    ThreadBufferMap;
+
+void OnThreadExit(void* value) {
+  ThreadBufferMap* buffers = static_cast<ThreadBufferMap*>(value);
+  for (ThreadBufferMap::iterator it = buffers->begin(); it != buffers->end();
+       ++it) {
+    AutoLock auto_lock(it->second->lock);
+    it->second->thread_exited = true;
+  }
+  delete buffers;
+}
+
+struct ThreadBufferSlot {
+  ThreadBufferSlot() : slot(&OnThreadExit) {}
+  ThreadLocalStorage::Slot slot;
+};
+
+LazyInstance<ThreadBufferSlot>::Leaky g_thread_buffer_slot =
+    LAZY_INSTANCE_INITIALIZER;
+
+StaticAtomicSequenceNumber g_next_thread_buffer_id;
+
+}  // namespace
+
 // static
 HistogramBase* SparseHistogram::FactoryGet(const string& name, int32 flags) {
   HistogramBase* histogram = StatisticsRecorder::FindHistogram(name);
@@ -33,6 +81,22 @@ HistogramBase* SparseHistogram::FactoryGet(const string& name, int32 flags) {
   return histogram;
 }
 
+// static
+HistogramBase* SparseHistogram::FactoryGetWithThreadLocalBuffers(
+    const string& name, int32 flags) {
+  HistogramBase* histogram = StatisticsRecorder::FindHistogram(name);
+
+  if (!histogram) {
+    // To avoid racy destruction at shutdown, the following will be leaked.
+    HistogramBase* tentative_histogram = new SparseHistogram(name, true);
+    tentative_histogram->SetFlags(flags);
+    histogram =
+        StatisticsRecorder::RegisterOrDeleteDuplicate(tentative_histogram);
+  }
+  DCHECK_EQ(SPARSE_HISTOGRAM, histogram->GetHistogramType());
+  return histogram;
+}
+
 SparseHistogram::~SparseHistogram() {}
 
 HistogramType SparseHistogram::GetHistogramType() const {
@@ -48,6 +112,15 @@ bool SparseHistogram::HasConstructionArguments(
 }
 
 void SparseHistogram::Add(Sample value) {
+  if (use_thread_local_buffers_) {
+    ThreadBuffer* buffer = GetThreadBuffer();
+    if (buffer->lock.Try()) {
+      buffer->samples->Accumulate(value, 1);
+      buffer->lock.Release();
+      return;
+    }
+    // A snapshot is merging the buffer, so record into the histogram instead.
+  }
   base::AutoLock auto_lock(lock_);
   samples_.Accumulate(value, 1);
 }
@@ -56,6 +129,7 @@ scoped_ptr<HistogramSamples> SparseHistogram::SnapshotSamples() const {
   scoped_ptr<SampleMap> snapshot(new SampleMap());
 
   base::AutoLock auto_lock(lock_);
+  MergeThreadBuffersWhileLocked();
   snapshot->Add(samples_);
   return snapshot.PassAs<HistogramSamples>();
 }
@@ -85,7 +159,54 @@ bool SparseHistogram::SerializeInfoImpl(Pickle* pickle) const {
 }
 
 SparseHistogram::SparseHistogram(const string& name)
-    : HistogramBase(name) {}
+    : HistogramBase(name),
+      use_thread_local_buffers_(false),
+      thread_buffer_id_(0) {}
+
+SparseHistogram::SparseHistogram(const string& name,
+                                 bool use_thread_local_buffers)
+    : HistogramBase(name),
+      use_thread_local_buffers_(use_thread_local_buffers),
+      thread_buffer_id_(use_thread_local_buffers ?
+                        g_next_thread_buffer_id.GetNext() : 0) {}
+
+SparseHistogram::ThreadBuffer* SparseHistogram::GetThreadBuffer() {
+  ThreadLocalStorage::Slot& slot = g_thread_buffer_slot.Get().slot;
+  ThreadBufferMap* buffers = static_cast<ThreadBufferMap*>(slot.Get());
+  if (!buffers) {
+    buffers = new ThreadBufferMap;
+    slot.Set(buffers);
+  }
+
+  scoped_refptr<ThreadBuffer>& buffer = (*buffers)[thread_buffer_id_];
+  if (!buffer.get()) {
+    buffer = new ThreadBuffer;
+    base::AutoLock auto_lock(lock_);
+    thread_buffers_.push_back(buffer);
+  }
+  return buffer.get();
+}
+
+void SparseHistogram::MergeThreadBuffersWhileLocked() const {
+  lock_.AssertAcquired();
+  size_t i = 0;
+  while (i < thread_buffers_.size()) {
+    ThreadBuffer* buffer = thread_buffers_[i].get();
+    bool thread_exited;
+    {
+      base::AutoLock auto_lock(buffer->lock);
+      samples_.Add(*buffer->samples);
+      buffer->samples.reset(new SampleMap);
+      thread_exited = buffer->thread_exited;
+    }
+    if (thread_exited) {
+      thread_buffers_[i] = thread_buffers_.back();
+      thread_buffers_.pop_back();
+    } else {
+      ++i;
+    }
+  }
+}
 
 HistogramBase* SparseHistogram::DeserializeInfoImpl(PickleIterator* iter) {
   string histogram_name;
@@ -7,11 +7,13 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "base/base_export.h"
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
 #include "base/logging.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/metrics/histogram_base.h"
 #include "base/metrics/sample_map.h"
@@ -60,6 +62,19 @@ class BASE_EXPORT_PRIVATE SparseHistogram : public HistogramBase {
   // new one.
   static HistogramBase* FactoryGet(const std::string& name, int32 flags);
 
+  // Like FactoryGet(), but the new histogram records the samples of each
+  // thread in a buffer of its own instead of taking |lock_|, which is shared
+  // by all the threads recording into the histogram. The buffers are merged
+  // into the histogram when it is snapshotted, e.g. by
+  // HistogramSnapshotManager. If a histogram named |name| already exists, it
+  // is returned as is.
+  static HistogramBase* FactoryGetWithThreadLocalBuffers(
+      const std::string& name, int32 flags);
+
+  // Per-thread samples of a histogram created by
+  // FactoryGetWithThreadLocalBuffers().
+  class ThreadBuffer;
+
   virtual ~SparseHistogram();
 
   // HistogramBase implementation:
@@ -82,6 +97,14 @@ class BASE_EXPORT_PRIVATE SparseHistogram : public HistogramBase {
  private:
   // Clients should always use FactoryGet to create SparseHistogram.
   explicit SparseHistogram(const std::string& name);
+  SparseHistogram(const std::string& name, bool use_thread_local_buffers);
+
+  // Returns the buffer of the current thread, creating it on first use.
+  ThreadBuffer* GetThreadBuffer();
+
+  // Moves the samples of all the thread buffers into |samples_|, and drops the
+  // buffers of the threads that have exited. |lock_| must be held.
+  void MergeThreadBuffersWhileLocked() const;
 
   friend BASE_EXPORT_PRIVATE HistogramBase* DeserializeHistogramInfo(
       PickleIterator* iter);
@@ -104,10 +127,20 @@ class BASE_EXPORT_PRIVATE SparseHistogram : public HistogramBase {
   // For constuctor calling.
   friend class SparseHistogramTest;
 
-  // Protects access to |samples_|.
+  // Protects access to |samples_| and |thread_buffers_|.
   mutable base::Lock lock_;
 
-  SampleMap samples_;
+  // Mutable because the thread buffers are merged lazily, when a snapshot is
+  // taken.
+  mutable SampleMap samples_;
+
+  const bool use_thread_local_buffers_;
+
+  // Identifies the histogram in the per-thread buffer maps. Unlike |this|, it
+  // is never reused.
+  const int thread_buffer_id_;
+
+  mutable std::vector<scoped_refptr<ThreadBuffer> > thread_buffers_;
 
   DISALLOW_COPY_AND_ASSIGN(SparseHistogram);
 };
@@ -11,11 +11,38 @@
 #include "base/metrics/sparse_histogram.h"
 #include "base/metrics/statistics_recorder.h"
 #include "base/pickle.h"
+#include "base/memory/scoped_vector.h"
 #include "base/strings/stringprintf.h"
+#include "base/threading/simple_thread.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace base {
 
+namespace {
+
+// Adds |count| samples of |value| to |histogram|.
+class AddSamplesDelegate : public DelegateSimpleThread::Delegate {
+ public:
+  AddSamplesDelegate(HistogramBase* histogram,
+                     HistogramBase::Sample value,
+                     int count)
+      : histogram_(histogram), value_(value), count_(count) {}
+
+  virtual void Run() OVERRIDE {
+    for (int i = 0; i < count_; ++i)
+      histogram_->Add(value_);
+  }
+
+ private:
+  HistogramBase* histogram_;
+  HistogramBase::Sample value_;
+  int count_;
+
+  DISALLOW_COPY_AND_ASSIGN(AddSamplesDelegate);
+};
+
+}  // namespace
+
 class SparseHistogramTest : public testing::Test {
  protected:
   virtual void SetUp() {
@@ -141,4 +168,43 @@ TEST_F(SparseHistogramTest, Serialize) {
   EXPECT_FALSE(iter.SkipBytes(1));
 }
 
+TEST_F(SparseHistogramTest, ThreadLocalBuffers) {
+  HistogramBase* histogram = SparseHistogram::FactoryGetWithThreadLocalBuffers(
+      "Sparse", HistogramBase::kNoFlags);
+  EXPECT_EQ(histogram, SparseHistogram::FactoryGet("Sparse",
+                                                   HistogramBase::kNoFlags));
+
+  histogram->Add(1);
+  histogram->Add(1);
+  scoped_ptr<HistogramSamples> snapshot(histogram->SnapshotSamples());
+  EXPECT_EQ(2, snapshot->GetCount(1));
+
+  const int kNumThreads = 4;
+  const int kSamplesPerThread = 10000;
+  ScopedVector<AddSamplesDelegate> delegates;
+  ScopedVector<DelegateSimpleThread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    delegates.push_back(
+        new AddSamplesDelegate(histogram, i % 2 + 1, kSamplesPerThread));
+    threads.push_back(new DelegateSimpleThread(delegates.back(), "Sparse"));
+    threads.back()->Start();
+  }
+
+  // Snapshots taken while the threads record must not lose samples.
+  histogram->SnapshotSamples();
+  for (int i = 0; i < kNumThreads; ++i)
+    threads[i]->Join();
+
+  histogram->Add(1);
+  snapshot = histogram->SnapshotSamples();
+  EXPECT_EQ(kNumThreads * kSamplesPerThread + 3, snapshot->TotalCount());
+  EXPECT_EQ(kNumThreads / 2 * kSamplesPerThread + 3, snapshot->GetCount(1));
+  EXPECT_EQ(kNumThreads / 2 * kSamplesPerThread, snapshot->GetCount(2));
+  EXPECT_EQ(kNumThreads / 2 * kSamplesPerThread * 3 + 3, snapshot->sum());
+
+  // The buffers of the exited threads are gone, but their samples are kept.
+  snapshot = histogram->SnapshotSamples();
+  EXPECT_EQ(kNumThreads * kSamplesPerThread + 3, snapshot->TotalCount());
+}
+
 }  // namespace base
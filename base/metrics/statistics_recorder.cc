@@ -4,8 +4,11 @@
 
 #include "base/metrics/statistics_recorder.h"
 
+#include <algorithm>
+
 #include "base/at_exit.h"
 #include "base/debug/leak_annotations.h"
+#include "base/hash.h"
 #include "base/json/string_escape.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
@@ -21,6 +24,11 @@ namespace {
 // Initialize histogram statistics gathering system.
 base::LazyInstance<base::StatisticsRecorder>::Leaky g_statistics_recorder_ =
     LAZY_INSTANCE_INITIALIZER;
+
+bool HistogramNameLessThan(const base::HistogramBase* lhs,
+                           const base::HistogramBase* rhs) {
+  return lhs->histogram_name() < rhs->histogram_name();
+}
 }  // namespace
 
 namespace base {
@@ -37,7 +45,7 @@ bool StatisticsRecorder::IsActive() {
   if (lock_ == NULL)
     return false;
   base::AutoLock auto_lock(*lock_);
-  return NULL != histograms_;
+  return NULL != ranges_;
 }
 
 // static
@@ -47,8 +55,8 @@ HistogramBase* StatisticsRecorder::RegisterOrDeleteDuplicate(
   // to annotate them. Because ANNOTATE_LEAKING_OBJECT_PTR may be used only once
   // for an object, the duplicates should not be annotated.
   // Callers are responsible for not calling RegisterOrDeleteDuplicate(ptr)
-  // twice if (lock_ == NULL) || (!histograms_).
-  if (lock_ == NULL) {
+  // twice if (histogram_locks_ == NULL) || (!histograms_).
+  if (histogram_locks_ == NULL) {
     ANNOTATE_LEAKING_OBJECT_PTR(histogram);  // see crbug.com/79322
     return histogram;
   }
@@ -56,14 +64,16 @@ HistogramBase* StatisticsRecorder::RegisterOrDeleteDuplicate(
   HistogramBase* histogram_to_delete = NULL;
   HistogramBase* histogram_to_return = NULL;
   {
-    base::AutoLock auto_lock(*lock_);
-    if (histograms_ == NULL) {
+    const string& name = histogram->histogram_name();
+    size_t shard = GetShardIndex(name);
+    base::AutoLock auto_lock(histogram_locks_[shard]);
+    HistogramMap* histograms = histograms_[shard];
+    if (histograms == NULL) {
       histogram_to_return = histogram;
     } else {
-      const string& name = histogram->histogram_name();
-      HistogramMap::iterator it = histograms_->find(name);
-      if (histograms_->end() == it) {
-        (*histograms_)[name] = histogram;
+      HistogramMap::iterator it = histograms->find(name);
+      if (histograms->end() == it) {
+        (*histograms)[name] = histogram;
         ANNOTATE_LEAKING_OBJECT_PTR(histogram);  // see crbug.com/79322
         histogram_to_return = histogram;
       } else if (histogram == it->second) {
@@ -196,18 +206,7 @@ std::string StatisticsRecorder::ToJSON(const std::string& query) {
 
 // static
 void StatisticsRecorder::GetHistograms(Histograms* output) {
-  if (lock_ == NULL)
-    return;
-  base::AutoLock auto_lock(*lock_);
-  if (histograms_ == NULL)
-    return;
-
-  for (HistogramMap::iterator it = histograms_->begin();
-       histograms_->end() != it;
-       ++it) {
-    DCHECK_EQ(it->first, it->second->histogram_name());
-    output->push_back(it->second);
-  }
+  GetMatchingHistograms(std::string(), output);
 }
 
 // static
@@ -234,14 +233,16 @@ void StatisticsRecorder::GetBucketRanges(
 
 // static
 HistogramBase* StatisticsRecorder::FindHistogram(const std::string& name) {
-  if (lock_ == NULL)
+  if (histogram_locks_ == NULL)
     return NULL;
-  base::AutoLock auto_lock(*lock_);
-  if (histograms_ == NULL)
+  size_t shard = GetShardIndex(name);
+  base::AutoLock auto_lock(histogram_locks_[shard]);
+  HistogramMap* histograms = histograms_[shard];
+  if (histograms == NULL)
     return NULL;
 
-  HistogramMap::iterator it = histograms_->find(name);
-  if (histograms_->end() == it)
+  HistogramMap::iterator it = histograms->find(name);
+  if (histograms->end() == it)
     return NULL;
   return it->second;
 }
@@ -249,25 +250,44 @@ HistogramBase* StatisticsRecorder::FindHistogram(const std::string& name) {
 // private static
 void StatisticsRecorder::GetSnapshot(const std::string& query,
                                      Histograms* snapshot) {
-  if (lock_ == NULL)
-    return;
-  base::AutoLock auto_lock(*lock_);
-  if (histograms_ == NULL)
+  GetMatchingHistograms(query, snapshot);
+}
+
+// private static
+size_t StatisticsRecorder::GetShardIndex(const std::string& name) {
+  return Hash(name) % kNumHistogramShards;
+}
+
+// private static
+void StatisticsRecorder::GetMatchingHistograms(const std::string& query,
+                                               Histograms* output) {
+  if (histogram_locks_ == NULL)
     return;
 
-  for (HistogramMap::iterator it = histograms_->begin();
-       histograms_->end() != it;
-       ++it) {
-    if (it->first.find(query) != std::string::npos)
-      snapshot->push_back(it->second);
+  size_t first_new = output->size();
+  for (size_t shard = 0; shard < kNumHistogramShards; ++shard) {
+    base::AutoLock auto_lock(histogram_locks_[shard]);
+    HistogramMap* histograms = histograms_[shard];
+    if (histograms == NULL)
+      return;
+
+    for (HistogramMap::iterator it = histograms->begin();
+         histograms->end() != it;
+         ++it) {
+      DCHECK_EQ(it->first, it->second->histogram_name());
+      if (it->first.find(query) != std::string::npos)
+        output->push_back(it->second);
+    }
   }
+  // Callers expect the single sorted map the registry used to be.
+  std::sort(output->begin() + first_new, output->end(), &HistogramNameLessThan);
 }
 
 // This singleton instance should be started during the single threaded portion
 // of main(), and hence it is not thread safe.  It initializes globals to
 // provide support for all future calls.
 StatisticsRecorder::StatisticsRecorder() {
-  DCHECK(!histograms_);
+  DCHECK(!ranges_);
   if (lock_ == NULL) {
     // This will leak on purpose. It's the only way to make sure we won't race
     // against the static uninitialization of the module while one of our
@@ -276,9 +296,14 @@ StatisticsRecorder::StatisticsRecorder() {
     // leak one per process, which would be similar to the instance allocated
     // during static initialization and released only on  process termination.
     lock_ = new base::Lock;
+    histogram_locks_ = new base::Lock[kNumHistogramShards];
+  }
+  for (size_t shard = 0; shard < kNumHistogramShards; ++shard) {
+    base::AutoLock auto_lock(histogram_locks_[shard]);
+    DCHECK(!histograms_[shard]);
+    histograms_[shard] = new HistogramMap;
   }
   base::AutoLock auto_lock(*lock_);
-  histograms_ = new HistogramMap;
   ranges_ = new RangesMap;
 
   if (VLOG_IS_ON(1))
@@ -296,18 +321,22 @@ void StatisticsRecorder::DumpHistogramsToVlog(void* instance) {
 }
 
 StatisticsRecorder::~StatisticsRecorder() {
-  DCHECK(histograms_ && ranges_ && lock_);
+  DCHECK(ranges_ && lock_ && histogram_locks_);
 
   // Clean up.
-  scoped_ptr<HistogramMap> histograms_deleter;
   scoped_ptr<RangesMap> ranges_deleter;
-  // We don't delete lock_ on purpose to avoid having to properly protect
-  // against it going away after we checked for NULL in the static methods.
+  // We don't delete lock_ and histogram_locks_ on purpose to avoid having to
+  // properly protect against them going away after we checked for NULL in the
+  // static methods.
+  for (size_t shard = 0; shard < kNumHistogramShards; ++shard) {
+    scoped_ptr<HistogramMap> histograms_deleter;
+    base::AutoLock auto_lock(histogram_locks_[shard]);
+    histograms_deleter.reset(histograms_[shard]);
+    histograms_[shard] = NULL;
+  }
   {
     base::AutoLock auto_lock(*lock_);
-    histograms_deleter.reset(histograms_);
     ranges_deleter.reset(ranges_);
-    histograms_ = NULL;
     ranges_ = NULL;
   }
   // We are going to leak the histograms and the ranges.
@@ -315,10 +344,15 @@ StatisticsRecorder::~StatisticsRecorder() {
 
 
 // static
-StatisticsRecorder::HistogramMap* StatisticsRecorder::histograms_ = NULL;
+const size_t StatisticsRecorder::kNumHistogramShards;
+// static
+StatisticsRecorder::HistogramMap*
+    StatisticsRecorder::histograms_[kNumHistogramShards] = { NULL };
 // static
 StatisticsRecorder::RangesMap* StatisticsRecorder::ranges_ = NULL;
 // static
 base::Lock* StatisticsRecorder::lock_ = NULL;
+// static
+base::Lock* StatisticsRecorder::histogram_locks_ = NULL;
 
 }  // namespace base
@@ -66,18 +66,23 @@ class BASE_EXPORT StatisticsRecorder {
   static void GetBucketRanges(std::vector<const BucketRanges*>* output);
 
   // Find a histogram by name. It matches the exact name. This method is thread
-  // safe.  It returns NULL if a matching histogram is not found.
+  // safe, and only contends with lookups and registrations of histograms in
+  // the same shard.  It returns NULL if a matching histogram is not found.
   static HistogramBase* FindHistogram(const std::string& name);
 
   // GetSnapshot copies some of the pointers to registered histograms into the
   // caller supplied vector (Histograms). Only histograms which have |query| as
   // a substring are copied (an empty string will process all registered
-  // histograms).
+  // histograms). Like GetHistograms(), the result is sorted by name.
   static void GetSnapshot(const std::string& query, Histograms* snapshot);
 
  private:
-  // We keep all registered histograms in a map, from name to histogram.
+  // We keep all registered histograms in maps, from name to histogram. The
+  // names are spread over kNumHistogramShards maps by hash, each protected by
+  // its own lock, so that the FactoryGet() lookups of unrelated histograms on
+  // different threads don't contend.
   typedef std::map<std::string, HistogramBase*> HistogramMap;
+  static const size_t kNumHistogramShards = 16;
 
   // We keep all |bucket_ranges_| in a map, from checksum to a list of
   // |bucket_ranges_|.  Checksum is calculated from the |ranges_| in
@@ -88,6 +93,7 @@ class BASE_EXPORT StatisticsRecorder {
   friend class HistogramBaseTest;
   friend class HistogramSnapshotManagerTest;
   friend class HistogramTest;
+  friend class SharedHistogramAllocatorTest;
   friend class SparseHistogramTest;
   friend class StatisticsRecorderTest;
   FRIEND_TEST_ALL_PREFIXES(HistogramDeltaSerializationTest,
@@ -101,12 +107,23 @@ class BASE_EXPORT StatisticsRecorder {
 
   static void DumpHistogramsToVlog(void* instance);
 
-  static HistogramMap* histograms_;
+  // Returns the shard of |histograms_| that holds |name|.
+  static size_t GetShardIndex(const std::string& name);
+
+  // Appends the histograms with |query| as a substring to |output|, sorted by
+  // name.
+  static void GetMatchingHistograms(const std::string& query,
+                                    Histograms* output);
+
+  static HistogramMap* histograms_[kNumHistogramShards];
   static RangesMap* ranges_;
 
-  // Lock protects access to above maps.
+  // Lock protects access to |ranges_|.
   static base::Lock* lock_;
 
+  // |histogram_locks_[i]| protects access to |histograms_[i]|.
+  static base::Lock* histogram_locks_;
+
   DISALLOW_COPY_AND_ASSIGN(StatisticsRecorder);
 };
 
@@ -8,6 +8,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/metrics/histogram.h"
 #include "base/metrics/statistics_recorder.h"
+#include "base/strings/stringprintf.h"
 #include "base/values.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -151,6 +152,26 @@ TEST_F(StatisticsRecorderTest, FindHistogram) {
   EXPECT_TRUE(StatisticsRecorder::FindHistogram("TestHistogram") == NULL);
 }
 
+TEST_F(StatisticsRecorderTest, GetHistogramsIsSorted) {
+  // Enough histograms to be spread over all the registry shards.
+  const int kNumHistograms = 100;
+  for (int i = kNumHistograms - 1; i >= 0; --i) {
+    Histogram::FactoryGet(StringPrintf("TestHistogram%03d", i), 1, 1000, 10,
+                          HistogramBase::kNoFlags);
+  }
+
+  StatisticsRecorder::Histograms histograms;
+  StatisticsRecorder::GetHistograms(&histograms);
+  ASSERT_EQ(static_cast<size_t>(kNumHistograms), histograms.size());
+  for (int i = 0; i < kNumHistograms; ++i) {
+    EXPECT_EQ(StringPrintf("TestHistogram%03d", i),
+              histograms[i]->histogram_name());
+    EXPECT_EQ(histograms[i],
+              StatisticsRecorder::FindHistogram(
+                  histograms[i]->histogram_name()));
+  }
+}
+
 TEST_F(StatisticsRecorderTest, GetSnapshot) {
   Histogram::FactoryGet("TestHistogram1", 1, 1000, 10, Histogram::kNoFlags);
   Histogram::FactoryGet("TestHistogram2", 1, 1000, 10, Histogram::kNoFlags);
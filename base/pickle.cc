@@ -181,6 +181,17 @@ Pickle::Pickle(int header_size)
   header_->payload_size = 0;
 }
 
+Pickle::Pickle(int header_size, size_t payload_capacity)
+    : header_(NULL),
+      header_size_(AlignInt(header_size, sizeof(uint32))),
+      capacity_after_header_(0),
+      write_offset_(0) {
+  DCHECK_GE(static_cast<size_t>(header_size), sizeof(Header));
+  DCHECK_LE(header_size, kPayloadUnit);
+  Resize(std::max(payload_capacity, static_cast<size_t>(kPayloadUnit)));
+  header_->payload_size = 0;
+}
+
 Pickle::Pickle(const char* data, int data_len)
     : header_(reinterpret_cast<Header*>(const_cast<char*>(data))),
       header_size_(0),
@@ -307,6 +318,23 @@ const char* Pickle::FindNext(size_t header_size,
   return start + header_size + hdr->payload_size;
 }
 
+// static
+bool Pickle::PeekNext(size_t header_size,
+                      const char* start,
+                      const char* end,
+                      size_t* pickle_size) {
+  DCHECK_EQ(header_size, AlignInt(header_size, sizeof(uint32)));
+  DCHECK_LE(header_size, static_cast<size_t>(kPayloadUnit));
+
+  size_t length = static_cast<size_t>(end - start);
+  if (length < sizeof(Header) || length < header_size)
+    return false;
+
+  const Header* hdr = reinterpret_cast<const Header*>(start);
+  *pickle_size = header_size + hdr->payload_size;
+  return true;
+}
+
 template <size_t length> void Pickle::WriteBytesStatic(const void* data) {
   WriteBytesCommon(data, length);
 }
@@ -110,6 +110,11 @@ class BASE_EXPORT Pickle {
   // will be rounded up to ensure that the header size is 32bit-aligned.
   explicit Pickle(int header_size);
 
+  // Like Pickle(int header_size), but allocates room for |payload_capacity|
+  // bytes of payload up front, so that writing up to that much data does not
+  // reallocate the buffer. Use it when the size of the data is known.
+  Pickle(int header_size, size_t payload_capacity);
+
   // Initializes a Pickle from a const block of data.  The data is not copied;
   // instead the data is merely referenced by this Pickle.  Only const methods
   // should be used on the Pickle when initialized this way.  The header
@@ -314,6 +319,14 @@ class BASE_EXPORT Pickle {
                               const char* range_start,
                               const char* range_end);
 
+  // Sets |pickle_size| to the size of the pickled data that starts at
+  // range_start, which may extend past range_end. Returns false if the header
+  // is not entirely in the given data range.
+  static bool PeekNext(size_t header_size,
+                       const char* range_start,
+                       const char* range_end,
+                       size_t* pickle_size);
+
   // The allocation granularity of the payload.
   static const int kPayloadUnit;
 
@@ -339,10 +352,12 @@ class BASE_EXPORT Pickle {
   }
   inline void WriteBytesCommon(const void* data, size_t length);
 
+  FRIEND_TEST_ALL_PREFIXES(PickleTest, PayloadCapacity);
   FRIEND_TEST_ALL_PREFIXES(PickleTest, Resize);
   FRIEND_TEST_ALL_PREFIXES(PickleTest, FindNext);
   FRIEND_TEST_ALL_PREFIXES(PickleTest, FindNextWithIncompleteHeader);
   FRIEND_TEST_ALL_PREFIXES(PickleTest, FindNextOverflow);
+  FRIEND_TEST_ALL_PREFIXES(PickleTest, PeekNext);
 };
 
 #endif  // BASE_PICKLE_H__
@@ -0,0 +1,69 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/pickle.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace {
+
+const int kNumRuns = 1000000;
+
+// A header a bit larger than the one of Pickle, as IPC::Message has.
+struct TestHeader : Pickle::Header {
+  int32 routing;
+  uint32 type;
+  uint32 flags;
+};
+
+class TestPickle : public Pickle {
+ public:
+  TestPickle() : Pickle(sizeof(TestHeader)) {}
+  explicit TestPickle(size_t payload_capacity)
+      : Pickle(sizeof(TestHeader), payload_capacity) {}
+};
+
+// Builds and destroys |kNumRuns| pickles of |num_fields| integers, written
+// one at a time like the fields of a message. The pickles allocate room for
+// |payload_capacity| bytes of payload up front, if it is not 0.
+void BuildPickles(const std::string& name,
+                  int num_fields,
+                  size_t payload_capacity) {
+  base::TimeTicks start = base::TimeTicks::Now();
+  int64 total_size = 0;
+  for (int i = 0; i < kNumRuns; ++i) {
+    scoped_ptr<TestPickle> pickle(payload_capacity ?
+        new TestPickle(payload_capacity) : new TestPickle);
+    for (int j = 0; j < num_fields; ++j)
+      pickle->WriteInt(j);
+    total_size += pickle->size();
+  }
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+  EXPECT_GT(total_size, 0);
+
+  perf_test::PrintResult(
+      "pickle", "", name + "_time ",
+      elapsed.InMicroseconds() * 1000.0 / kNumRuns, "ns/pickle", true);
+}
+
+// Small pickles fit in their first payload unit.
+TEST(PicklePerfTest, BuildSmall) {
+  BuildPickles("build_small", 8, 0);
+}
+
+// Larger pickles grow their buffer several times as they are written, unless
+// they are given the capacity they need.
+TEST(PicklePerfTest, BuildLarge) {
+  const int kNumFields = 200;
+  BuildPickles("build_large", kNumFields, 0);
+  BuildPickles("build_large_with_capacity", kNumFields,
+               kNumFields * sizeof(int));
+}
+
+}  // namespace
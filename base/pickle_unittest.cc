@@ -189,6 +189,27 @@ TEST(PickleTest, FindNextWithIncompleteHeader) {
 #pragma warning(push)
 #pragma warning(disable: 4146)
 #endif
+TEST(PickleTest, PeekNext) {
+  Pickle pickle;
+  pickle.WriteString("Goooooooooooogle");
+  const char* start = reinterpret_cast<const char*>(pickle.data());
+
+  size_t pickle_size = 0;
+  EXPECT_TRUE(Pickle::PeekNext(sizeof(Pickle::Header), start,
+                               start + pickle.size(), &pickle_size));
+  EXPECT_EQ(pickle.size(), pickle_size);
+
+  // Only the header needs to be in the range.
+  pickle_size = 0;
+  EXPECT_TRUE(Pickle::PeekNext(sizeof(Pickle::Header), start,
+                               start + sizeof(Pickle::Header), &pickle_size));
+  EXPECT_EQ(pickle.size(), pickle_size);
+
+  EXPECT_FALSE(Pickle::PeekNext(sizeof(Pickle::Header), start,
+                                start + sizeof(Pickle::Header) - 1,
+                                &pickle_size));
+}
+
 TEST(PickleTest, FindNextOverflow) {
   size_t header_size = sizeof(Pickle::Header);
   size_t header_size2 = 2 * header_size;
@@ -235,6 +256,29 @@ TEST(PickleTest, GetReadPointerAndAdvance) {
   EXPECT_FALSE(PickleIterator(pickle).GetReadPointerAndAdvance(INT_MIN));
 }
 
+TEST(PickleTest, PayloadCapacity) {
+  const size_t kCapacity = 1000;
+  Pickle pickle(sizeof(Pickle::Header), kCapacity);
+  EXPECT_GE(pickle.capacity_after_header(), kCapacity);
+  EXPECT_EQ(0u, pickle.payload_size());
+
+  // Filling the payload up to the capacity does not grow it.
+  size_t capacity = pickle.capacity_after_header();
+  std::string data(kCapacity - sizeof(int), 'a');
+  EXPECT_TRUE(pickle.WriteString(data));
+  EXPECT_EQ(capacity, pickle.capacity_after_header());
+
+  PickleIterator iter(pickle);
+  std::string outdata;
+  EXPECT_TRUE(pickle.ReadString(&iter, &outdata));
+  EXPECT_EQ(data, outdata);
+
+  // A small capacity still gets a full payload unit.
+  Pickle small_pickle(sizeof(Pickle::Header), 1);
+  EXPECT_EQ(static_cast<size_t>(Pickle::kPayloadUnit),
+            small_pickle.capacity_after_header());
+}
+
 TEST(PickleTest, Resize) {
   size_t unit = Pickle::kPayloadUnit;
   scoped_ptr<char[]> data(new char[unit]);
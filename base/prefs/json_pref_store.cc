@@ -13,9 +13,11 @@
 #include "base/json/json_string_value_serializer.h"
 #include "base/memory/ref_counted.h"
 #include "base/message_loop/message_loop_proxy.h"
+#include "base/metrics/histogram.h"
 #include "base/prefs/pref_filter.h"
 #include "base/sequenced_task_runner.h"
 #include "base/threading/sequenced_worker_pool.h"
+#include "base/time/time.h"
 #include "base/values.h"
 
 namespace {
@@ -65,12 +67,19 @@ class FileThreadDeserializer
   static base::Value* DoReading(const base::FilePath& path,
                                 PersistentPrefStore::PrefReadError* error,
                                 bool* no_dir) {
+    const base::TimeTicks start_time = base::TimeTicks::Now();
     int error_code;
     std::string error_msg;
     JSONFileValueSerializer serializer(path);
     base::Value* value = serializer.Deserialize(&error_code, &error_msg);
+    if (value) {
+      UMA_HISTOGRAM_TIMES("Settings.JsonDataReadTime",
+                          base::TimeTicks::Now() - start_time);
+    }
     HandleErrors(value, path, error_code, error_msg, error);
-    *no_dir = !base::PathExists(path.DirName());
+    // The directory must exist if the file could be read, so only go back to
+    // the disk when it couldn't.
+    *no_dir = !value && !base::PathExists(path.DirName());
     return value;
   }
 
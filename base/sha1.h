@@ -24,6 +24,16 @@ BASE_EXPORT std::string SHA1HashString(const std::string& str);
 BASE_EXPORT void SHA1HashBytes(const unsigned char* data, size_t len,
                                unsigned char* hash);
 
+// Computes the SHA-1 hashes of |count| inputs, the i-th being the |lens|[i]
+// bytes in |data|[i], and puts the i-th hash at |hashes| + i * kSHA1Length.
+// |hashes| must be |count| * kSHA1Length bytes long. When the CPU has no SHA
+// instructions, several inputs are hashed at once in SIMD lanes, which makes
+// this faster than one SHA1HashBytes() per input for many short inputs.
+BASE_EXPORT void SHA1HashBytesMultiple(const unsigned char* const* data,
+                                       const size_t* lens,
+                                       size_t count,
+                                       unsigned char* hashes);
+
 }  // namespace base
 
 #endif  // BASE_SHA1_H_
@@ -0,0 +1,58 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// The SHA-1 implementations behind base/sha1.h. Only sha1_portable.cc and
+// the tests should include this; everybody else should use base/sha1.h,
+// which picks the fastest implementation the CPU supports.
+
+#ifndef BASE_SHA1_INTERNAL_H_
+#define BASE_SHA1_INTERNAL_H_
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+
+namespace base {
+namespace internal {
+
+// Adds the |num_blocks| 64-byte blocks at |data| to the hash whose state is
+// |state|, in host byte order.
+typedef void (*SHA1CompressFunction)(uint32 state[5],
+                                     const uint8* data,
+                                     size_t num_blocks);
+
+// The plain C++ implementation.
+BASE_EXPORT void SHA1CompressPortable(uint32 state[5],
+                                      const uint8* data,
+                                      size_t num_blocks);
+
+// Returns the compression function SHA1HashBytes() uses.
+BASE_EXPORT SHA1CompressFunction GetSHA1CompressFunction();
+
+// Hashes the |len| bytes at |data| into |hash| as SHA1HashBytes() does, but
+// with |compress_function|.
+BASE_EXPORT void SHA1HashBytesWith(SHA1CompressFunction compress_function,
+                                   const unsigned char* data,
+                                   size_t len,
+                                   unsigned char* hash);
+
+// BASE_SHA1_X86 is defined by base.gyp on x86, where sha1_x86.cc is built.
+#if defined(BASE_SHA1_X86)
+// Uses the SHA extensions. In sha1_x86.cc, which is built with them enabled.
+// Only call it if base::CPU::has_sha().
+BASE_EXPORT void SHA1CompressSHAExtensions(uint32 state[5],
+                                           const uint8* data,
+                                           size_t num_blocks);
+
+// SHA1HashBytesMultiple() for CPUs without the SHA extensions: hashes four
+// inputs at a time in the lanes of SSE2 registers.
+BASE_EXPORT void SHA1HashBytesMultipleSSE2(const unsigned char* const* data,
+                                           const size_t* lens,
+                                           size_t count,
+                                           unsigned char* hashes);
+#endif  // defined(BASE_SHA1_X86)
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // BASE_SHA1_INTERNAL_H_
@@ -0,0 +1,107 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/sha1.h"
+#include "base/sha1_internal.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+#if defined(BASE_SHA1_X86)
+#include "base/cpu.h"
+#endif
+
+namespace {
+
+// Short inputs are about the size of the keys SimpleCache hashes.
+const size_t kShortSize = 64;
+const int kShortRuns = 1000000;
+const size_t kLongSize = 1024 * 1024;
+const int kLongRuns = 64;
+
+// Hashes |runs| inputs of |size| bytes with |compress_function| and prints
+// the throughput.
+void HashBytes(const std::string& name,
+               base::internal::SHA1CompressFunction compress_function,
+               size_t size,
+               int runs) {
+  std::vector<unsigned char> input(size, 'a');
+  unsigned char hash[base::kSHA1Length];
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < runs; ++i) {
+    // Changes the input so that no two runs are alike.
+    input[0] = static_cast<unsigned char>(i);
+    base::internal::SHA1HashBytesWith(compress_function, &input[0], size,
+                                      hash);
+  }
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+  EXPECT_NE(0, hash[0] | hash[1] | hash[2] | hash[3]);
+
+  perf_test::PrintResult(
+      "sha1", "", name + base::StringPrintf("_%u", static_cast<unsigned>(size)),
+      size * static_cast<double>(runs) / elapsed.InMicroseconds(), "MB/s",
+      true);
+}
+
+void HashBytesWithEveryImplementation(size_t size, int runs) {
+  HashBytes("portable", base::internal::SHA1CompressPortable, size, runs);
+#if defined(BASE_SHA1_X86)
+  base::CPU cpu;
+  if (cpu.has_sha() && cpu.has_sse41()) {
+    HashBytes("sha_extensions", base::internal::SHA1CompressSHAExtensions,
+              size, runs);
+  }
+#endif
+}
+
+}  // namespace
+
+TEST(SHA1PerfTest, Short) {
+  HashBytesWithEveryImplementation(kShortSize, kShortRuns);
+}
+
+TEST(SHA1PerfTest, Long) {
+  HashBytesWithEveryImplementation(kLongSize, kLongRuns);
+}
+
+// Compares hashing many short inputs one at a time and all at once.
+TEST(SHA1PerfTest, Multiple) {
+  const size_t kCount = 1024;
+  const int kRuns = kShortRuns / kCount;
+  std::vector<std::string> inputs(kCount);
+  std::vector<const unsigned char*> data(kCount);
+  std::vector<size_t> lens(kCount);
+  for (size_t i = 0; i < kCount; ++i) {
+    inputs[i] = base::StringPrintf("http://www.example.com/%u",
+                                   static_cast<unsigned>(i));
+    data[i] = reinterpret_cast<const unsigned char*>(inputs[i].data());
+    lens[i] = inputs[i].size();
+  }
+  std::vector<unsigned char> hashes(kCount * base::kSHA1Length);
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int run = 0; run < kRuns; ++run) {
+    for (size_t i = 0; i < kCount; ++i)
+      base::SHA1HashBytes(data[i], lens[i], &hashes[i * base::kSHA1Length]);
+  }
+  base::TimeDelta single = base::TimeTicks::Now() - start;
+
+  start = base::TimeTicks::Now();
+  for (int run = 0; run < kRuns; ++run)
+    base::SHA1HashBytesMultiple(&data[0], &lens[0], kCount, &hashes[0]);
+  base::TimeDelta multiple = base::TimeTicks::Now() - start;
+
+  const double kHashes = static_cast<double>(kRuns) * kCount;
+  perf_test::PrintResult("sha1", "", "single_time",
+                         single.InMicroseconds() * 1000.0 / kHashes,
+                         "ns/hash", true);
+  perf_test::PrintResult("sha1", "", "multiple_time",
+                         multiple.InMicroseconds() * 1000.0 / kHashes,
+                         "ns/hash", true);
+}
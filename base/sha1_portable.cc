@@ -6,7 +6,17 @@
 
 #include <string.h>
 
+#include <algorithm>
+
 #include "base/basictypes.h"
+#include "base/lazy_instance.h"
+#include "base/sha1_internal.h"
+
+#if defined(BASE_SHA1_X86)
+#include <emmintrin.h>
+
+#include "base/cpu.h"
+#endif
 
 namespace base {
 
@@ -19,7 +29,7 @@ namespace base {
 
 // Usage example:
 //
-// SecureHashAlgorithm sha;
+// SecureHashAlgorithm sha(compress_function);
 // while(there is data to hash)
 //   sha.Update(moredata, size of data);
 // sha.Final();
@@ -33,7 +43,10 @@ namespace base {
 
 class SecureHashAlgorithm {
  public:
-  SecureHashAlgorithm() { Init(); }
+  explicit SecureHashAlgorithm(internal::SHA1CompressFunction compress)
+      : compress_(compress) {
+    Init();
+  }
 
   static const int kDigestSizeBytes;
 
@@ -48,49 +61,22 @@ class SecureHashAlgorithm {
 
  private:
   void Pad();
-  void Process();
 
-  uint32 A, B, C, D, E;
+  internal::SHA1CompressFunction compress_;
 
   uint32 H[5];
 
-  union {
-    uint32 W[80];
-    uint8 M[64];
-  };
+  // The bytes of the current block.
+  uint8 M[64];
 
   uint32 cursor;
-  uint32 l;
+  uint64 l;
 };
 
-static inline uint32 f(uint32 t, uint32 B, uint32 C, uint32 D) {
-  if (t < 20) {
-    return (B & C) | ((~B) & D);
-  } else if (t < 40) {
-    return B ^ C ^ D;
-  } else if (t < 60) {
-    return (B & C) | (B & D) | (C & D);
-  } else {
-    return B ^ C ^ D;
-  }
-}
-
 static inline uint32 S(uint32 n, uint32 X) {
   return (X << n) | (X >> (32-n));
 }
 
-static inline uint32 K(uint32 t) {
-  if (t < 20) {
-    return 0x5a827999;
-  } else if (t < 40) {
-    return 0x6ed9eba1;
-  } else if (t < 60) {
-    return 0x8f1bbcdc;
-  } else {
-    return 0xca62c1d6;
-  }
-}
-
 static inline void swapends(uint32* t) {
   *t = ((*t & 0xff000000) >> 24) |
        ((*t & 0xff0000) >> 8) |
@@ -98,14 +84,45 @@ static inline void swapends(uint32* t) {
        ((*t & 0xff) << 24);
 }
 
+static inline uint32 LoadBigEndian(const uint8* p) {
+  return (static_cast<uint32>(p[0]) << 24) |
+         (static_cast<uint32>(p[1]) << 16) |
+         (static_cast<uint32>(p[2]) << 8) |
+         static_cast<uint32>(p[3]);
+}
+
+// The padded message: the input bytes, a 0x80 byte, zeroes, then the length
+// in bits as a big-endian 64-bit number, so that the total is a multiple of
+// 64 bytes.
+static inline size_t PaddedBlocks(size_t len) {
+  return (len + 8) / 64 + 1;
+}
+
+// Returns block |block| of the padded message of the |len| bytes at |data|.
+// Blocks that are entirely input are returned in place; the others are built
+// in |buffer|.
+static const uint8* GetPaddedBlock(const uint8* data, size_t len,
+                                   size_t block, uint8* buffer) {
+  const size_t start = block * 64;
+  if (start + 64 <= len)
+    return data + start;
+
+  memset(buffer, 0, 64);
+  if (start <= len) {
+    memcpy(buffer, data + start, len - start);
+    buffer[len - start] = 0x80;
+  }
+  if (block == PaddedBlocks(len) - 1) {
+    const uint64 bits = static_cast<uint64>(len) * 8;
+    for (int i = 0; i < 8; ++i)
+      buffer[63 - i] = static_cast<uint8>(bits >> (8 * i));
+  }
+  return buffer;
+}
+
 const int SecureHashAlgorithm::kDigestSizeBytes = 20;
 
 void SecureHashAlgorithm::Init() {
-  A = 0;
-  B = 0;
-  C = 0;
-  D = 0;
-  E = 0;
   cursor = 0;
   l = 0;
   H[0] = 0x67452301;
@@ -117,7 +134,6 @@ void SecureHashAlgorithm::Init() {
 
 void SecureHashAlgorithm::Final() {
   Pad();
-  Process();
 
   for (int t = 0; t < 5; ++t)
     swapends(&H[t]);
@@ -125,12 +141,31 @@ void SecureHashAlgorithm::Final() {
 
 void SecureHashAlgorithm::Update(const void* data, size_t nbytes) {
   const uint8* d = reinterpret_cast<const uint8*>(data);
-  while (nbytes--) {
-    M[cursor++] = *d++;
-    if (cursor >= 64)
-      Process();
-    l += 8;
+  l += nbytes;
+
+  // Complete the buffered block, if any.
+  if (cursor > 0) {
+    size_t n = std::min(nbytes, static_cast<size_t>(64 - cursor));
+    memcpy(M + cursor, d, n);
+    cursor += n;
+    d += n;
+    nbytes -= n;
+    if (cursor < 64)
+      return;
+    compress_(H, M, 1);
+    cursor = 0;
+  }
+
+  // Hash the whole blocks in place.
+  size_t blocks = nbytes / 64;
+  if (blocks > 0) {
+    compress_(H, d, blocks);
+    d += blocks * 64;
+    nbytes -= blocks * 64;
   }
+
+  memcpy(M, d, nbytes);
+  cursor = nbytes;
 }
 
 void SecureHashAlgorithm::Pad() {
@@ -138,64 +173,263 @@ void SecureHashAlgorithm::Pad() {
 
   if (cursor > 64-8) {
     // pad out to next block
-    while (cursor < 64)
-      M[cursor++] = 0;
+    memset(M + cursor, 0, 64 - cursor);
+    compress_(H, M, 1);
+    cursor = 0;
+  }
+
+  memset(M + cursor, 0, 64 - 8 - cursor);
+  const uint64 bits = l * 8;
+  for (int i = 0; i < 8; ++i)
+    M[63 - i] = static_cast<uint8>(bits >> (8 * i));
+  compress_(H, M, 1);
+  cursor = 0;
+}
 
-    Process();
+namespace internal {
+
+void SHA1CompressPortable(uint32 state[5], const uint8* data,
+                          size_t num_blocks) {
+  uint32 W[80];
+  for (; num_blocks > 0; --num_blocks, data += 64) {
+    uint32 t;
+
+    // Each a...e corresponds to a section in the FIPS 180-3 algorithm.
+
+    // a.
+    for (t = 0; t < 16; ++t)
+      W[t] = LoadBigEndian(data + 4 * t);
+
+    // b.
+    for (t = 16; t < 80; ++t)
+      W[t] = S(1, W[t - 3] ^ W[t - 8] ^ W[t - 14] ^ W[t - 16]);
+
+    // c.
+    uint32 A = state[0];
+    uint32 B = state[1];
+    uint32 C = state[2];
+    uint32 D = state[3];
+    uint32 E = state[4];
+
+    // d. One loop per function f and constant K, so that the rounds do not
+    // branch on t.
+#define SHA1_ROUND(f, k)                           \
+    do {                                           \
+      uint32 TEMP = S(5, A) + (f) + E + W[t] + k;  \
+      E = D;                                       \
+      D = C;                                       \
+      C = S(30, B);                                \
+      B = A;                                       \
+      A = TEMP;                                    \
+    } while (0)
+
+    for (t = 0; t < 20; ++t)
+      SHA1_ROUND((B & C) | ((~B) & D), 0x5a827999);
+    for (; t < 40; ++t)
+      SHA1_ROUND(B ^ C ^ D, 0x6ed9eba1);
+    for (; t < 60; ++t)
+      SHA1_ROUND((B & C) | (B & D) | (C & D), 0x8f1bbcdc);
+    for (; t < 80; ++t)
+      SHA1_ROUND(B ^ C ^ D, 0xca62c1d6);
+
+#undef SHA1_ROUND
+
+    // e.
+    state[0] += A;
+    state[1] += B;
+    state[2] += C;
+    state[3] += D;
+    state[4] += E;
   }
+}
 
-  while (cursor < 64-4)
-    M[cursor++] = 0;
-
-  M[64-4] = (l & 0xff000000) >> 24;
-  M[64-3] = (l & 0xff0000) >> 16;
-  M[64-2] = (l & 0xff00) >> 8;
-  M[64-1] = (l & 0xff);
-}
-
-void SecureHashAlgorithm::Process() {
-  uint32 t;
-
-  // Each a...e corresponds to a section in the FIPS 180-3 algorithm.
-
-  // a.
-  //
-  // W and M are in a union, so no need to memcpy.
-  // memcpy(W, M, sizeof(M));
-  for (t = 0; t < 16; ++t)
-    swapends(&W[t]);
-
-  // b.
-  for (t = 16; t < 80; ++t)
-    W[t] = S(1, W[t - 3] ^ W[t - 8] ^ W[t - 14] ^ W[t - 16]);
-
-  // c.
-  A = H[0];
-  B = H[1];
-  C = H[2];
-  D = H[3];
-  E = H[4];
-
-  // d.
-  for (t = 0; t < 80; ++t) {
-    uint32 TEMP = S(5, A) + f(t, B, C, D) + E + W[t] + K(t);
-    E = D;
-    D = C;
-    C = S(30, B);
-    B = A;
-    A = TEMP;
+}  // namespace internal
+
+namespace {
+
+// Picks the fastest compression function the CPU supports.
+struct SHA1Implementation {
+  SHA1Implementation()
+      : compress(&internal::SHA1CompressPortable),
+        has_sha_extensions(false) {
+#if defined(BASE_SHA1_X86)
+    CPU cpu;
+    if (cpu.has_sha() && cpu.has_sse41()) {
+      compress = &internal::SHA1CompressSHAExtensions;
+      has_sha_extensions = true;
+    }
+#endif
   }
 
-  // e.
-  H[0] += A;
-  H[1] += B;
-  H[2] += C;
-  H[3] += D;
-  H[4] += E;
+  internal::SHA1CompressFunction compress;
+  bool has_sha_extensions;
+};
 
-  cursor = 0;
+LazyInstance<SHA1Implementation>::Leaky g_sha1_implementation =
+    LAZY_INSTANCE_INITIALIZER;
+
+#if defined(BASE_SHA1_X86)
+
+const size_t kLanes = 4;
+
+template <int n>
+inline __m128i Rotate(__m128i x) {
+  return _mm_or_si128(_mm_slli_epi32(x, n), _mm_srli_epi32(x, 32 - n));
+}
+
+inline __m128i Add(__m128i a, __m128i b) {
+  return _mm_add_epi32(a, b);
 }
 
+// SHA1CompressPortable() on four hashes at once, one per lane: |state|[i]
+// holds word i of the four states, and |W|[0 .. 15] the message words of the
+// four blocks.
+void Compress4(__m128i state[5], __m128i W[80]) {
+  int t;
+  for (t = 16; t < 80; ++t) {
+    W[t] = Rotate<1>(_mm_xor_si128(_mm_xor_si128(W[t - 3], W[t - 8]),
+                                   _mm_xor_si128(W[t - 14], W[t - 16])));
+  }
+
+  __m128i A = state[0];
+  __m128i B = state[1];
+  __m128i C = state[2];
+  __m128i D = state[3];
+  __m128i E = state[4];
+
+#define SHA1_ROUND4(f, k)                                           \
+  do {                                                              \
+    __m128i TEMP = Add(Add(Rotate<5>(A), (f)), Add(Add(E, W[t]), k)); \
+    E = D;                                                          \
+    D = C;                                                          \
+    C = Rotate<30>(B);                                              \
+    B = A;                                                          \
+    A = TEMP;                                                       \
+  } while (0)
+
+  const __m128i k0 = _mm_set1_epi32(0x5a827999);
+  const __m128i k1 = _mm_set1_epi32(0x6ed9eba1);
+  const __m128i k2 = _mm_set1_epi32(static_cast<int>(0x8f1bbcdcu));
+  const __m128i k3 = _mm_set1_epi32(static_cast<int>(0xca62c1d6u));
+  for (t = 0; t < 20; ++t)
+    SHA1_ROUND4(_mm_or_si128(_mm_and_si128(B, C), _mm_andnot_si128(B, D)), k0);
+  for (; t < 40; ++t)
+    SHA1_ROUND4(_mm_xor_si128(_mm_xor_si128(B, C), D), k1);
+  for (; t < 60; ++t) {
+    SHA1_ROUND4(_mm_or_si128(_mm_and_si128(B, C),
+                             _mm_and_si128(D, _mm_or_si128(B, C))), k2);
+  }
+  for (; t < 80; ++t)
+    SHA1_ROUND4(_mm_xor_si128(_mm_xor_si128(B, C), D), k3);
+
+#undef SHA1_ROUND4
+
+  state[0] = Add(state[0], A);
+  state[1] = Add(state[1], B);
+  state[2] = Add(state[2], C);
+  state[3] = Add(state[3], D);
+  state[4] = Add(state[4], E);
+}
+
+#endif  // defined(BASE_SHA1_X86)
+
+}  // namespace
+
+namespace internal {
+
+SHA1CompressFunction GetSHA1CompressFunction() {
+  return g_sha1_implementation.Get().compress;
+}
+
+void SHA1HashBytesWith(SHA1CompressFunction compress_function,
+                       const unsigned char* data,
+                       size_t len,
+                       unsigned char* hash) {
+  SecureHashAlgorithm sha(compress_function);
+  sha.Update(data, len);
+  sha.Final();
+
+  memcpy(hash, sha.Digest(), SecureHashAlgorithm::kDigestSizeBytes);
+}
+
+#if defined(BASE_SHA1_X86)
+
+void SHA1HashBytesMultipleSSE2(const unsigned char* const* data,
+                               const size_t* lens,
+                               size_t count,
+                               unsigned char* hashes) {
+  static const uint32 kInitialState[5] = {
+    0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0
+  };
+  static const uint8 kIdleBlock[64] = { 0 };
+  const size_t kIdle = static_cast<size_t>(-1);
+
+  // The input each lane is hashing, or kIdle once there are no more inputs,
+  // and the next block of its padded message.
+  size_t input[kLanes];
+  size_t block[kLanes];
+  uint32 state[5][kLanes];
+  size_t next_input = 0;
+  for (size_t lane = 0; lane < kLanes; ++lane) {
+    input[lane] = next_input < count ? next_input++ : kIdle;
+    block[lane] = 0;
+    for (int i = 0; i < 5; ++i)
+      state[i][lane] = kInitialState[i];
+  }
+
+  uint8 buffers[kLanes][64];
+  __m128i W[80];
+  __m128i S[5];
+  for (;;) {
+    const uint8* blocks[kLanes];
+    bool busy = false;
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+      if (input[lane] == kIdle) {
+        blocks[lane] = kIdleBlock;
+        continue;
+      }
+      busy = true;
+      blocks[lane] = GetPaddedBlock(data[input[lane]], lens[input[lane]],
+                                    block[lane], buffers[lane]);
+    }
+    if (!busy)
+      break;
+
+    for (int t = 0; t < 16; ++t) {
+      W[t] = _mm_set_epi32(static_cast<int>(LoadBigEndian(blocks[3] + 4 * t)),
+                           static_cast<int>(LoadBigEndian(blocks[2] + 4 * t)),
+                           static_cast<int>(LoadBigEndian(blocks[1] + 4 * t)),
+                           static_cast<int>(LoadBigEndian(blocks[0] + 4 * t)));
+    }
+    for (int i = 0; i < 5; ++i)
+      S[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state[i]));
+    Compress4(S, W);
+    for (int i = 0; i < 5; ++i)
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(state[i]), S[i]);
+
+    // Output the finished hashes and start the next inputs in their lanes.
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+      if (input[lane] == kIdle ||
+          ++block[lane] < PaddedBlocks(lens[input[lane]])) {
+        continue;
+      }
+      unsigned char* hash = hashes + input[lane] * kSHA1Length;
+      for (int i = 0; i < 5; ++i) {
+        uint32 word = state[i][lane];
+        swapends(&word);
+        memcpy(hash + 4 * i, &word, sizeof(word));
+        state[i][lane] = kInitialState[i];
+      }
+      input[lane] = next_input < count ? next_input++ : kIdle;
+      block[lane] = 0;
+    }
+  }
+}
+
+#endif  // defined(BASE_SHA1_X86)
+
+}  // namespace internal
+
 std::string SHA1HashString(const std::string& str) {
   char hash[SecureHashAlgorithm::kDigestSizeBytes];
   SHA1HashBytes(reinterpret_cast<const unsigned char*>(str.c_str()),
@@ -205,11 +439,23 @@ std::string SHA1HashString(const std::string& str) {
 
 void SHA1HashBytes(const unsigned char* data, size_t len,
                    unsigned char* hash) {
-  SecureHashAlgorithm sha;
-  sha.Update(data, len);
-  sha.Final();
+  internal::SHA1HashBytesWith(internal::GetSHA1CompressFunction(), data, len,
+                              hash);
+}
 
-  memcpy(hash, sha.Digest(), SecureHashAlgorithm::kDigestSizeBytes);
+void SHA1HashBytesMultiple(const unsigned char* const* data,
+                           const size_t* lens,
+                           size_t count,
+                           unsigned char* hashes) {
+#if defined(BASE_SHA1_X86)
+  // A single stream through the SHA extensions beats four through SSE2.
+  if (!g_sha1_implementation.Get().has_sha_extensions) {
+    internal::SHA1HashBytesMultipleSSE2(data, lens, count, hashes);
+    return;
+  }
+#endif
+  for (size_t i = 0; i < count; ++i)
+    SHA1HashBytes(data[i], lens[i], hashes + i * kSHA1Length);
 }
 
 }  // namespace base
@@ -5,10 +5,84 @@
 #include "base/sha1.h"
 
 #include <string>
+#include <vector>
 
 #include "base/basictypes.h"
+#include "base/sha1_internal.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+#if defined(BASE_SHA1_X86)
+#include "base/cpu.h"
+#endif
+
+namespace {
+
+// Returns |len| bytes that are not all alike.
+std::string MakeInput(size_t len, unsigned int seed) {
+  std::string input(len, '\0');
+  for (size_t i = 0; i < len; ++i) {
+    seed = seed * 1103515245 + 12345;
+    input[i] = static_cast<char>(seed >> 16);
+  }
+  return input;
+}
+
+std::string HashWith(base::internal::SHA1CompressFunction compress_function,
+                     const std::string& input) {
+  unsigned char hash[base::kSHA1Length];
+  base::internal::SHA1HashBytesWith(
+      compress_function, reinterpret_cast<const unsigned char*>(input.data()),
+      input.size(), hash);
+  return std::string(reinterpret_cast<char*>(hash), base::kSHA1Length);
+}
+
+// Inputs of all lengths around the block and padding boundaries.
+std::vector<std::string> MakeInputs() {
+  std::vector<std::string> inputs;
+  for (size_t len = 0; len < 300; ++len)
+    inputs.push_back(MakeInput(len, static_cast<unsigned int>(len)));
+  inputs.push_back(MakeInput(10000, 1));
+  return inputs;
+}
+
+typedef void (*HashBytesMultipleFunction)(const unsigned char* const* data,
+                                          const size_t* lens,
+                                          size_t count,
+                                          unsigned char* hashes);
+
+// Checks that |function| hashes every prefix of |inputs| like SHA1HashString.
+void ExpectHashesMultiple(HashBytesMultipleFunction function,
+                          const std::vector<std::string>& inputs) {
+  std::vector<const unsigned char*> data;
+  std::vector<size_t> lens;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    data.push_back(reinterpret_cast<const unsigned char*>(inputs[i].data()));
+    lens.push_back(inputs[i].size());
+  }
+  for (size_t count = 0; count <= 9; ++count) {
+    std::vector<unsigned char> hashes(count * base::kSHA1Length + 1, 0xcc);
+    function(&data[0], &lens[0], count, &hashes[0]);
+    for (size_t i = 0; i < count; ++i) {
+      EXPECT_EQ(base::SHA1HashString(inputs[i]),
+                std::string(reinterpret_cast<char*>(
+                                &hashes[i * base::kSHA1Length]),
+                            base::kSHA1Length)) << count << " " << i;
+    }
+    EXPECT_EQ(0xcc, hashes[count * base::kSHA1Length]);
+  }
+
+  std::vector<unsigned char> hashes(inputs.size() * base::kSHA1Length);
+  function(&data[0], &lens[0], inputs.size(), &hashes[0]);
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    EXPECT_EQ(base::SHA1HashString(inputs[i]),
+              std::string(reinterpret_cast<char*>(
+                              &hashes[i * base::kSHA1Length]),
+                          base::kSHA1Length)) << i;
+  }
+}
+
+}  // namespace
+
 TEST(SHA1Test, Test1) {
   // Example A.1 from FIPS 180-2: one-block message.
   std::string input = "abc";
@@ -106,3 +180,38 @@ TEST(SHA1Test, Test3Bytes) {
   for (size_t i = 0; i < base::kSHA1Length; i++)
     EXPECT_EQ(expected[i], output[i]);
 }
+
+TEST(SHA1Test, CompressFunctionsAgree) {
+  const std::vector<std::string> inputs = MakeInputs();
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    const std::string expected =
+        HashWith(&base::internal::SHA1CompressPortable, inputs[i]);
+    EXPECT_EQ(expected, base::SHA1HashString(inputs[i])) << i;
+#if defined(BASE_SHA1_X86)
+    base::CPU cpu;
+    if (cpu.has_sha() && cpu.has_sse41()) {
+      EXPECT_EQ(expected,
+                HashWith(&base::internal::SHA1CompressSHAExtensions,
+                         inputs[i])) << i;
+    }
+#endif
+  }
+}
+
+TEST(SHA1Test, Multiple) {
+  ExpectHashesMultiple(&base::SHA1HashBytesMultiple, MakeInputs());
+}
+
+#if defined(BASE_SHA1_X86)
+TEST(SHA1Test, MultipleSSE2) {
+  ExpectHashesMultiple(&base::internal::SHA1HashBytesMultipleSSE2,
+                       MakeInputs());
+
+  // Lanes that finish at very different times.
+  std::vector<std::string> inputs;
+  inputs.push_back(MakeInput(5000, 2));
+  for (size_t i = 0; i < 20; ++i)
+    inputs.push_back(MakeInput(i * 13, static_cast<unsigned int>(i)));
+  ExpectHashesMultiple(&base::internal::SHA1HashBytesMultipleSSE2, inputs);
+}
+#endif  // defined(BASE_SHA1_X86)
@@ -0,0 +1,118 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// SHA-1 compression with the Intel SHA extensions. This file is built with
+// them enabled (-msha -msse4.1), so nothing here may run unless base::CPU
+// reports them; sha1_portable.cc checks.
+
+#include "base/sha1_internal.h"
+
+#include <immintrin.h>
+
+namespace base {
+namespace internal {
+
+namespace {
+
+// Returns the four message words after |w4| .. |w1|, the last sixteen.
+inline __m128i NextMessageWords(__m128i w4, __m128i w3, __m128i w2,
+                                __m128i w1) {
+  return _mm_sha1msg2_epu32(
+      _mm_xor_si128(_mm_sha1msg1_epu32(w4, w3), w2), w1);
+}
+
+// Runs the four rounds that use the message words |w|. |previous_abcd| holds
+// A, B, C and D from before the previous four rounds, from which E is
+// derived.
+template <int kFunction>
+inline void FourRounds(__m128i w, __m128i* abcd, __m128i* previous_abcd) {
+  const __m128i e = _mm_sha1nexte_epu32(*previous_abcd, w);
+  *previous_abcd = *abcd;
+  *abcd = _mm_sha1rnds4_epu32(*abcd, e, kFunction);
+}
+
+}  // namespace
+
+void SHA1CompressSHAExtensions(uint32 state[5],
+                               const uint8* data,
+                               size_t num_blocks) {
+  // Reverses the bytes of a 128-bit value, so that the first big-endian word
+  // of the block ends up in the highest lane, where SHA1RNDS4 expects it.
+  const __m128i kByteSwap =
+      _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+  // A is in the highest lane of |abcd|, E in the highest lane of |e|.
+  __m128i abcd = _mm_shuffle_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0x1b);
+  __m128i e = _mm_set_epi32(static_cast<int>(state[4]), 0, 0, 0);
+
+  for (; num_blocks > 0; --num_blocks, data += 64) {
+    const __m128i abcd_save = abcd;
+    const __m128i e_save = e;
+    const __m128i* block = reinterpret_cast<const __m128i*>(data);
+
+    __m128i w0 = _mm_shuffle_epi8(_mm_loadu_si128(block), kByteSwap);
+    __m128i w1 = _mm_shuffle_epi8(_mm_loadu_si128(block + 1), kByteSwap);
+    __m128i w2 = _mm_shuffle_epi8(_mm_loadu_si128(block + 2), kByteSwap);
+    __m128i w3 = _mm_shuffle_epi8(_mm_loadu_si128(block + 3), kByteSwap);
+
+    // Rounds 0 to 3 take E as it is.
+    __m128i previous_abcd = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, _mm_add_epi32(e, w0), 0);
+
+    // Rounds 4 to 19.
+    FourRounds<0>(w1, &abcd, &previous_abcd);
+    FourRounds<0>(w2, &abcd, &previous_abcd);
+    FourRounds<0>(w3, &abcd, &previous_abcd);
+    w0 = NextMessageWords(w0, w1, w2, w3);
+    FourRounds<0>(w0, &abcd, &previous_abcd);
+
+    // Rounds 20 to 39.
+    w1 = NextMessageWords(w1, w2, w3, w0);
+    FourRounds<1>(w1, &abcd, &previous_abcd);
+    w2 = NextMessageWords(w2, w3, w0, w1);
+    FourRounds<1>(w2, &abcd, &previous_abcd);
+    w3 = NextMessageWords(w3, w0, w1, w2);
+    FourRounds<1>(w3, &abcd, &previous_abcd);
+    w0 = NextMessageWords(w0, w1, w2, w3);
+    FourRounds<1>(w0, &abcd, &previous_abcd);
+    w1 = NextMessageWords(w1, w2, w3, w0);
+    FourRounds<1>(w1, &abcd, &previous_abcd);
+
+    // Rounds 40 to 59.
+    w2 = NextMessageWords(w2, w3, w0, w1);
+    FourRounds<2>(w2, &abcd, &previous_abcd);
+    w3 = NextMessageWords(w3, w0, w1, w2);
+    FourRounds<2>(w3, &abcd, &previous_abcd);
+    w0 = NextMessageWords(w0, w1, w2, w3);
+    FourRounds<2>(w0, &abcd, &previous_abcd);
+    w1 = NextMessageWords(w1, w2, w3, w0);
+    FourRounds<2>(w1, &abcd, &previous_abcd);
+    w2 = NextMessageWords(w2, w3, w0, w1);
+    FourRounds<2>(w2, &abcd, &previous_abcd);
+
+    // Rounds 60 to 79.
+    w3 = NextMessageWords(w3, w0, w1, w2);
+    FourRounds<3>(w3, &abcd, &previous_abcd);
+    w0 = NextMessageWords(w0, w1, w2, w3);
+    FourRounds<3>(w0, &abcd, &previous_abcd);
+    w1 = NextMessageWords(w1, w2, w3, w0);
+    FourRounds<3>(w1, &abcd, &previous_abcd);
+    w2 = NextMessageWords(w2, w3, w0, w1);
+    FourRounds<3>(w2, &abcd, &previous_abcd);
+    w3 = NextMessageWords(w3, w0, w1, w2);
+    FourRounds<3>(w3, &abcd, &previous_abcd);
+
+    // E after round 79 is A from before round 76 rotated, plus the saved E.
+    e = _mm_sha1nexte_epu32(previous_abcd, e_save);
+    abcd = _mm_add_epi32(abcd, abcd_save);
+  }
+
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(state),
+                   _mm_shuffle_epi32(abcd, 0x1b));
+  state[4] = static_cast<uint32>(_mm_extract_epi32(e, 3));
+}
+
+}  // namespace internal
+}  // namespace base
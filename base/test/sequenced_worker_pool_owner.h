@@ -29,6 +29,9 @@ class SequencedWorkerPoolOwner : public SequencedWorkerPool::TestingObserver {
  public:
   SequencedWorkerPoolOwner(size_t max_threads,
                            const std::string& thread_name_prefix);
+  SequencedWorkerPoolOwner(size_t max_threads,
+                           const std::string& thread_name_prefix,
+                           SequencedWorkerPool::SchedulerMode scheduler_mode);
 
   virtual ~SequencedWorkerPoolOwner();
 
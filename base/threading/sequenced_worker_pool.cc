@@ -4,6 +4,7 @@
 
 #include "base/threading/sequenced_worker_pool.h"
 
+#include <deque>
 #include <list>
 #include <map>
 #include <set>
@@ -11,6 +12,7 @@
 #include <vector>
 
 #include "base/atomic_sequence_num.h"
+#include "base/atomicops.h"
 #include "base/callback.h"
 #include "base/compiler_specific.h"
 #include "base/critical_closure.h"
@@ -19,6 +21,7 @@
 #include "base/logging.h"
 #include "base/memory/linked_ptr.h"
 #include "base/message_loop/message_loop_proxy.h"
+#include "base/profiler/scoped_profile.h"
 #include "base/stl_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/synchronization/condition_variable.h"
@@ -84,6 +87,11 @@ struct SequencedTaskLessThan {
   }
 };
 
+// The maximum number of tasks a worker of a WORK_STEALING pool runs from the
+// local deques before it checks the global queue again, so that sequenced
+// and delayed tasks are not starved by a steady stream of unsequenced ones.
+const int kMaxLocalTasksPerGlobalCheck = 32;
+
 // SequencedWorkerPoolTaskRunner ---------------------------------------------
 // A TaskRunner which posts tasks to a SequencedWorkerPool with a
 // fixed ShutdownBehavior.
@@ -222,6 +230,11 @@ base::LazyInstance<base::ThreadLocalPointer<
     SequencedWorkerPool::SequenceToken> >::Leaky g_lazy_tls_ptr =
         LAZY_INSTANCE_INITIALIZER;
 
+// The SequencedWorkerPool::Worker running on the current thread, if any. Used
+// by WORK_STEALING pools to find the local deque of the posting worker.
+base::LazyInstance<base::ThreadLocalPointer<void> >::Leaky
+    g_lazy_tls_worker_ptr = LAZY_INSTANCE_INITIALIZER;
+
 }  // namespace
 
 // Worker ---------------------------------------------------------------------
@@ -252,11 +265,25 @@ class SequencedWorkerPool::Worker : public SimpleThread {
     return running_shutdown_behavior_;
   }
 
+  SequencedWorkerPool* worker_pool() const { return worker_pool_.get(); }
+
+  // The deque of unsequenced tasks of a WORK_STEALING pool. The owning worker
+  // takes tasks from the front, other workers steal from the back.
+  Lock* local_queue_lock() { return &local_queue_lock_; }
+  std::deque<SequencedTask>* local_queue() { return &local_queue_; }
+
+  size_t local_queue_index() const { return local_queue_index_; }
+  void set_local_queue_index(size_t index) { local_queue_index_ = index; }
+
  private:
   scoped_refptr<SequencedWorkerPool> worker_pool_;
   SequenceToken running_sequence_;
   WorkerShutdown running_shutdown_behavior_;
 
+  Lock local_queue_lock_;
+  std::deque<SequencedTask> local_queue_;
+  size_t local_queue_index_;
+
   DISALLOW_COPY_AND_ASSIGN(Worker);
 };
 
@@ -268,6 +295,7 @@ class SequencedWorkerPool::Inner {
   // by it).
   Inner(SequencedWorkerPool* worker_pool, size_t max_threads,
         const std::string& thread_name_prefix,
+        SchedulerMode scheduler_mode,
         TestingObserver* observer);
 
   ~Inner();
@@ -345,7 +373,11 @@ class SequencedWorkerPool::Inner {
   // In any case, the calling code should clear the given
   // delete_these_outside_lock vector the next time the lock is released.
   // See the implementation for a more detailed description.
-  GetWorkStatus GetWork(SequencedTask* task,
+  //
+  // In WORK_STEALING mode, the local deques are only looked at when the global
+  // queue has no task that can run right away.
+  GetWorkStatus GetWork(Worker* this_worker,
+                        SequencedTask* task,
                         TimeDelta* wait_time,
                         std::vector<Closure>* delete_these_outside_lock);
 
@@ -389,6 +421,27 @@ class SequencedWorkerPool::Inner {
   // called inside the lock.
   bool CanShutdown() const;
 
+  // WORK_STEALING mode helpers. None of them requires the lock.
+
+  // Queues |task| on a worker's local deque if the pool allows it. Returns
+  // false if the task has to go through the global queue instead.
+  bool TryPostToLocalQueue(const SequencedTask& task);
+
+  // Takes a task from the deque of |this_worker|, or steals one from another
+  // worker. Returns false if all the deques are empty. The caller is
+  // responsible for the |local_blocking_shutdown_pending_task_count_|
+  // accounting of the returned task.
+  bool TakeLocalTask(Worker* this_worker, SequencedTask* task);
+
+  // Takes a task with TakeLocalTask() and runs it (or deletes it if shutdown
+  // has started and it doesn't block shutdown) without taking the lock.
+  // Returns false if there was no task to take.
+  bool RunLocalTask(Worker* this_worker);
+
+  // Decrements |local_blocking_shutdown_running_task_count_| and, if shutdown
+  // is in progress, wakes up Shutdown() so that it checks CanShutdown() again.
+  void DidRunLocalBlockingTask();
+
   SequencedWorkerPool* const worker_pool_;
 
   // The last sequence number used. Managed by GetSequenceToken, since this
@@ -454,7 +507,8 @@ class SequencedWorkerPool::Inner {
   std::set<int> current_sequences_;
 
   // An ID for each posted task to distinguish the task from others in traces.
-  int trace_id_;
+  // Incremented atomically since local deque posts don't take the lock.
+  subtle::Atomic32 trace_id_;
 
   // Set when Shutdown is called and no further tasks should be
   // allowed, though we may still be running existing tasks.
@@ -471,6 +525,37 @@ class SequencedWorkerPool::Inner {
 
   TestingObserver* const testing_observer_;
 
+  const bool work_stealing_;
+
+  // WORK_STEALING mode state, shared with posting threads and workers that
+  // don't hold |lock_|.
+  //
+  // |local_queue_workers_| holds the Worker* of each started worker (they are
+  // only deleted with |this|); |local_queue_worker_count_| is the number of
+  // published entries. Local deques are only used once all |max_threads_|
+  // workers have been published.
+  scoped_ptr<subtle::AtomicWord[]> local_queue_workers_;
+  subtle::AtomicWord local_queue_worker_count_;
+
+  // Picks the deque of tasks posted from non-worker threads.
+  subtle::AtomicWord next_local_queue_;
+
+  // Number of tasks in all the local deques.
+  subtle::AtomicWord local_task_count_;
+
+  // Like |blocking_shutdown_pending_task_count_| and
+  // |blocking_shutdown_thread_count_|, but for BLOCK_SHUTDOWN tasks in local
+  // deques, and for local tasks that block shutdown and are run without the
+  // lock.
+  subtle::AtomicWord local_blocking_shutdown_pending_task_count_;
+  subtle::AtomicWord local_blocking_shutdown_running_task_count_;
+
+  // Number of workers that are about to wait or waiting for work.
+  subtle::AtomicWord idle_worker_count_;
+
+  // Mirrors |shutdown_called_| for code that doesn't hold |lock_|.
+  subtle::Atomic32 shutdown_called_flag_;
+
   DISALLOW_COPY_AND_ASSIGN(Inner);
 };
 
@@ -483,7 +568,8 @@ SequencedWorkerPool::Worker::Worker(
     : SimpleThread(
           prefix + StringPrintf("Worker%d", thread_number).c_str()),
       worker_pool_(worker_pool),
-      running_shutdown_behavior_(CONTINUE_ON_SHUTDOWN) {
+      running_shutdown_behavior_(CONTINUE_ON_SHUTDOWN),
+      local_queue_index_(0) {
   Start();
 }
 
@@ -494,6 +580,7 @@ void SequencedWorkerPool::Worker::Run() {
   // Store a pointer to the running sequence in thread local storage for
   // static function access.
   g_lazy_tls_ptr.Get().Set(&running_sequence_);
+  g_lazy_tls_worker_ptr.Get().Set(this);
 
   // Just jump back to the Inner object to run the thread, since it has all the
   // tracking information and queues. It might be more natural to implement
@@ -511,6 +598,7 @@ SequencedWorkerPool::Inner::Inner(
     SequencedWorkerPool* worker_pool,
     size_t max_threads,
     const std::string& thread_name_prefix,
+    SchedulerMode scheduler_mode,
     TestingObserver* observer)
     : worker_pool_(worker_pool),
       lock_(),
@@ -529,7 +617,18 @@ SequencedWorkerPool::Inner::Inner(
       cleanup_state_(CLEANUP_DONE),
       cleanup_idlers_(0),
       cleanup_cv_(&lock_),
-      testing_observer_(observer) {}
+      testing_observer_(observer),
+      work_stealing_(scheduler_mode == WORK_STEALING),
+      local_queue_worker_count_(0),
+      next_local_queue_(0),
+      local_task_count_(0),
+      local_blocking_shutdown_pending_task_count_(0),
+      local_blocking_shutdown_running_task_count_(0),
+      idle_worker_count_(0),
+      shutdown_called_flag_(0) {
+  if (work_stealing_)
+    local_queue_workers_.reset(new subtle::AtomicWord[max_threads_]);
+}
 
 SequencedWorkerPool::Inner::~Inner() {
   // You must call Shutdown() before destroying the pool.
@@ -575,6 +674,11 @@ bool SequencedWorkerPool::Inner::PostTask(
       base::MakeCriticalClosure(task) : task;
   sequenced.time_to_run = TimeTicks::Now() + delay;
 
+  if (work_stealing_ && !optional_token_name && !sequenced.sequence_token_id &&
+      delay == TimeDelta() && TryPostToLocalQueue(sequenced)) {
+    return true;
+  }
+
   int create_thread_id = 0;
   {
     AutoLock lock(lock_);
@@ -591,7 +695,8 @@ bool SequencedWorkerPool::Inner::PostTask(
     }
 
     // The trace_id is used for identifying the task in about:tracing.
-    sequenced.trace_id = trace_id_++;
+    sequenced.trace_id =
+        static_cast<int>(subtle::NoBarrier_AtomicIncrement(&trace_id_, 1));
 
     TRACE_EVENT_FLOW_BEGIN0(TRACE_DISABLED_BY_DEFAULT("toplevel.flow"),
         "SequencedWorkerPool::PostTask",
@@ -642,8 +747,10 @@ void SequencedWorkerPool::Inner::CleanupForTesting() {
   CHECK_EQ(CLEANUP_DONE, cleanup_state_);
   if (shutdown_called_)
     return;
-  if (pending_tasks_.empty() && waiting_thread_count_ == threads_.size())
+  if (pending_tasks_.empty() && waiting_thread_count_ == threads_.size() &&
+      !subtle::Acquire_Load(&local_task_count_)) {
     return;
+  }
   cleanup_state_ = CLEANUP_REQUESTED;
   cleanup_idlers_ = 0;
   has_work_cv_.Signal();
@@ -665,6 +772,7 @@ void SequencedWorkerPool::Inner::Shutdown(
     if (shutdown_called_)
       return;
     shutdown_called_ = true;
+    subtle::Barrier_AtomicIncrement(&shutdown_called_flag_, 1);
     max_blocking_tasks_after_shutdown_ = max_new_blocking_tasks_after_shutdown;
 
     // Tickle the threads. This will wake up a waiting one so it will know that
@@ -713,6 +821,15 @@ void SequencedWorkerPool::Inner::ThreadLoop(Worker* this_worker) {
             std::make_pair(this_worker->tid(), make_linked_ptr(this_worker)));
     DCHECK(result.second);
 
+    if (work_stealing_) {
+      // Workers are created one at a time, so the index is unique.
+      size_t index = threads_.size() - 1;
+      this_worker->set_local_queue_index(index);
+      subtle::Release_Store(&local_queue_workers_[index],
+                            reinterpret_cast<subtle::AtomicWord>(this_worker));
+      subtle::Release_Store(&local_queue_worker_count_, index + 1);
+    }
+
     while (true) {
 #if defined(OS_MACOSX)
       base::mac::ScopedNSAutoreleasePool autorelease_pool;
@@ -720,12 +837,23 @@ void SequencedWorkerPool::Inner::ThreadLoop(Worker* this_worker) {
 
       HandleCleanup();
 
+      if (work_stealing_ && cleanup_state_ == CLEANUP_DONE) {
+        // Run a batch of local tasks without the lock. CleanupForTesting()
+        // only has the worker that does the cleanup run tasks, through
+        // GetWork().
+        AutoUnlock unlock(lock_);
+        for (int i = 0; i < kMaxLocalTasksPerGlobalCheck; ++i) {
+          if (!RunLocalTask(this_worker))
+            break;
+        }
+      }
+
       // See GetWork for what delete_these_outside_lock is doing.
       SequencedTask task;
       TimeDelta wait_time;
       std::vector<Closure> delete_these_outside_lock;
       GetWorkStatus status =
-          GetWork(&task, &wait_time, &delete_these_outside_lock);
+          GetWork(this_worker, &task, &wait_time, &delete_these_outside_lock);
       if (status == GET_WORK_FOUND) {
         TRACE_EVENT_FLOW_END0(TRACE_DISABLED_BY_DEFAULT("toplevel.flow"),
             "SequencedWorkerPool::PostTask",
@@ -794,20 +922,44 @@ void SequencedWorkerPool::Inner::ThreadLoop(Worker* this_worker) {
         // ones with the same sequence token, but additional threads won't
         // help this case.
         if (shutdown_called_ &&
-            blocking_shutdown_pending_task_count_ == 0)
+            blocking_shutdown_pending_task_count_ == 0 &&
+            !subtle::Acquire_Load(
+                &local_blocking_shutdown_pending_task_count_)) {
           break;
+        }
         waiting_thread_count_++;
 
-        switch (status) {
-          case GET_WORK_NOT_FOUND:
-            has_work_cv_.Wait();
-            break;
-          case GET_WORK_WAIT:
-            has_work_cv_.TimedWait(wait_time);
-            break;
-          default:
-            NOTREACHED();
+        // A task posted to a local deque only wakes up a worker if it sees a
+        // nonzero |idle_worker_count_|, so check the deques again after
+        // announcing that this worker is about to wait. Both sides use full
+        // barriers, so at least one of them sees the other's update.
+        bool local_work_available = false;
+        if (work_stealing_) {
+          subtle::Barrier_AtomicIncrement(&idle_worker_count_, 1);
+          local_work_available = subtle::NoBarrier_Load(&local_task_count_) > 0;
+        }
+
+        if (!local_work_available) {
+          scoped_ptr<tracked_objects::ScopedProfile> idle_profile;
+          if (work_stealing_) {
+            idle_profile.reset(new tracked_objects::ScopedProfile(
+                FROM_HERE_WITH_EXPLICIT_FUNCTION(
+                    "SequencedWorkerPool::WorkerIdle")));
+          }
+          switch (status) {
+            case GET_WORK_NOT_FOUND:
+              has_work_cv_.Wait();
+              break;
+            case GET_WORK_WAIT:
+              has_work_cv_.TimedWait(wait_time);
+              break;
+            default:
+              NOTREACHED();
+          }
         }
+
+        if (work_stealing_)
+          subtle::Barrier_AtomicIncrement(&idle_worker_count_, -1);
         waiting_thread_count_--;
       }
     }
@@ -893,6 +1045,7 @@ SequencedWorkerPool::Inner::LockedCurrentThreadShutdownBehavior() const {
 }
 
 SequencedWorkerPool::Inner::GetWorkStatus SequencedWorkerPool::Inner::GetWork(
+    Worker* this_worker,
     SequencedTask* task,
     TimeDelta* wait_time,
     std::vector<Closure>* delete_these_outside_lock) {
@@ -990,6 +1143,27 @@ SequencedWorkerPool::Inner::GetWorkStatus SequencedWorkerPool::Inner::GetWork(
   UMA_HISTOGRAM_COUNTS_100("SequencedWorkerPool.UnrunnableTaskCount",
                            unrunnable_tasks);
 #endif
+
+  if (work_stealing_ && status != GET_WORK_FOUND) {
+    SequencedTask local_task;
+    while (TakeLocalTask(this_worker, &local_task)) {
+      if (local_task.shutdown_behavior == BLOCK_SHUTDOWN) {
+        // Done under the lock, together with the increment of
+        // |blocking_shutdown_thread_count_| in WillRunWorkerTask(), so that
+        // CanShutdown() never sees the task in neither count.
+        subtle::Barrier_AtomicIncrement(
+            &local_blocking_shutdown_pending_task_count_, -1);
+      } else if (shutdown_called_) {
+        // Same as for the global queue, tasks that don't block shutdown are
+        // deleted once it has started.
+        delete_these_outside_lock->push_back(local_task.task);
+        continue;
+      }
+      *task = local_task;
+      status = GET_WORK_FOUND;
+      break;
+    }
+  }
   return status;
 }
 
@@ -1115,7 +1289,171 @@ bool SequencedWorkerPool::Inner::CanShutdown() const {
   // See PrepareToStartAdditionalThreadIfHelpful for how thread creation works.
   return !thread_being_created_ &&
          blocking_shutdown_thread_count_ == 0 &&
-         blocking_shutdown_pending_task_count_ == 0;
+         blocking_shutdown_pending_task_count_ == 0 &&
+         !subtle::Acquire_Load(&local_blocking_shutdown_pending_task_count_) &&
+         !subtle::Acquire_Load(&local_blocking_shutdown_running_task_count_);
+}
+
+bool SequencedWorkerPool::Inner::TryPostToLocalQueue(
+    const SequencedTask& task) {
+  DCHECK(work_stealing_);
+  size_t worker_count = static_cast<size_t>(
+      subtle::Acquire_Load(&local_queue_worker_count_));
+  if (worker_count < max_threads_)
+    return false;
+
+  // Shutdown() sets |shutdown_called_flag_| before it checks CanShutdown(),
+  // and the pending count is incremented before the flag is checked here, so
+  // either the task is seen by Shutdown() or it goes through the global queue
+  // and its BLOCK_SHUTDOWN rules.
+  bool blocks_shutdown = task.shutdown_behavior == BLOCK_SHUTDOWN;
+  if (blocks_shutdown) {
+    subtle::Barrier_AtomicIncrement(
+        &local_blocking_shutdown_pending_task_count_, 1);
+  }
+  if (subtle::Acquire_Load(&shutdown_called_flag_)) {
+    if (blocks_shutdown) {
+      subtle::Barrier_AtomicIncrement(
+          &local_blocking_shutdown_pending_task_count_, -1);
+    }
+    return false;
+  }
+
+  // Tasks posted from one of our workers stay on that worker's deque, others
+  // are spread across all the deques.
+  Worker* target = NULL;
+  Worker* current_worker =
+      static_cast<Worker*>(g_lazy_tls_worker_ptr.Get().Get());
+  if (current_worker && current_worker->worker_pool() == worker_pool_) {
+    target = current_worker;
+  } else {
+    size_t index = static_cast<size_t>(
+        subtle::NoBarrier_AtomicIncrement(&next_local_queue_, 1));
+    target = reinterpret_cast<Worker*>(
+        subtle::Acquire_Load(&local_queue_workers_[index % worker_count]));
+  }
+
+  SequencedTask local_task(task);
+  local_task.trace_id =
+      static_cast<int>(subtle::NoBarrier_AtomicIncrement(&trace_id_, 1));
+  TRACE_EVENT_FLOW_BEGIN0(TRACE_DISABLED_BY_DEFAULT("toplevel.flow"),
+      "SequencedWorkerPool::PostTask",
+      TRACE_ID_MANGLE(GetTaskTraceID(local_task, static_cast<void*>(this))));
+
+  // The count is incremented before the task is queued so that it never goes
+  // below zero; a worker that sees it may spin briefly until the task lands.
+  subtle::Barrier_AtomicIncrement(&local_task_count_, 1);
+  {
+    AutoLock lock(*target->local_queue_lock());
+    target->local_queue()->push_back(local_task);
+  }
+
+  // Pairs with the idle check in ThreadLoop().
+  if (subtle::NoBarrier_Load(&idle_worker_count_) > 0) {
+    AutoLock lock(lock_);
+    SignalHasWork();
+  }
+  return true;
+}
+
+bool SequencedWorkerPool::Inner::TakeLocalTask(Worker* this_worker,
+                                               SequencedTask* task) {
+  DCHECK(work_stealing_);
+  if (subtle::Acquire_Load(&local_task_count_) <= 0)
+    return false;
+
+  {
+    AutoLock lock(*this_worker->local_queue_lock());
+    std::deque<SequencedTask>* queue = this_worker->local_queue();
+    if (!queue->empty()) {
+      *task = queue->front();
+      queue->pop_front();
+      subtle::Barrier_AtomicIncrement(&local_task_count_, -1);
+      return true;
+    }
+  }
+
+  size_t worker_count = static_cast<size_t>(
+      subtle::Acquire_Load(&local_queue_worker_count_));
+  size_t own_index = this_worker->local_queue_index();
+  for (size_t i = 1; i < worker_count; ++i) {
+    Worker* victim = reinterpret_cast<Worker*>(subtle::Acquire_Load(
+        &local_queue_workers_[(own_index + i) % worker_count]));
+    AutoLock lock(*victim->local_queue_lock());
+    std::deque<SequencedTask>* queue = victim->local_queue();
+    if (queue->empty())
+      continue;
+    // Attributes the steal to this worker thread in about:profiler.
+    tracked_objects::ScopedProfile steal_profile(
+        FROM_HERE_WITH_EXPLICIT_FUNCTION("SequencedWorkerPool::StealTask"));
+    *task = queue->back();
+    queue->pop_back();
+    subtle::Barrier_AtomicIncrement(&local_task_count_, -1);
+    return true;
+  }
+  return false;
+}
+
+bool SequencedWorkerPool::Inner::RunLocalTask(Worker* this_worker) {
+  SequencedTask task;
+  if (!TakeLocalTask(this_worker, &task))
+    return false;
+
+  // Count the task as running before it stops being pending, and before
+  // checking for shutdown, for the same reason as in TryPostToLocalQueue().
+  bool blocks_shutdown = task.shutdown_behavior != CONTINUE_ON_SHUTDOWN;
+  if (blocks_shutdown) {
+    subtle::Barrier_AtomicIncrement(
+        &local_blocking_shutdown_running_task_count_, 1);
+  }
+  if (task.shutdown_behavior == BLOCK_SHUTDOWN) {
+    subtle::Barrier_AtomicIncrement(
+        &local_blocking_shutdown_pending_task_count_, -1);
+  }
+
+  if (task.shutdown_behavior != BLOCK_SHUTDOWN &&
+      subtle::Acquire_Load(&shutdown_called_flag_)) {
+    // Deleted without the lock held, see GetWork().
+    task.task.Reset();
+    if (blocks_shutdown)
+      DidRunLocalBlockingTask();
+    return true;
+  }
+
+  TRACE_EVENT_FLOW_END0(TRACE_DISABLED_BY_DEFAULT("toplevel.flow"),
+      "SequencedWorkerPool::PostTask",
+      TRACE_ID_MANGLE(GetTaskTraceID(task, static_cast<void*>(this))));
+  TRACE_EVENT2("toplevel", "SequencedWorkerPool::ThreadLoop",
+               "src_file", task.posted_from.file_name(),
+               "src_func", task.posted_from.function_name());
+
+  this_worker->set_running_task_info(SequenceToken(), task.shutdown_behavior);
+
+  tracked_objects::TrackedTime start_time =
+      tracked_objects::ThreadData::NowForStartOfRun(task.birth_tally);
+
+  task.task.Run();
+
+  tracked_objects::ThreadData::TallyRunOnNamedThreadIfTracking(task,
+      start_time, tracked_objects::ThreadData::NowForEndOfRun());
+
+  // See ThreadLoop() for why this happens before set_running_task_info().
+  task.task = Closure();
+
+  this_worker->set_running_task_info(SequenceToken(), CONTINUE_ON_SHUTDOWN);
+
+  if (blocks_shutdown)
+    DidRunLocalBlockingTask();
+  return true;
+}
+
+void SequencedWorkerPool::Inner::DidRunLocalBlockingTask() {
+  subtle::Barrier_AtomicIncrement(
+      &local_blocking_shutdown_running_task_count_, -1);
+  if (subtle::Acquire_Load(&shutdown_called_flag_)) {
+    AutoLock lock(lock_);
+    can_shutdown_cv_.Signal();
+  }
 }
 
 base::StaticAtomicSequenceNumber
@@ -1140,15 +1478,27 @@ SequencedWorkerPool::SequencedWorkerPool(
     size_t max_threads,
     const std::string& thread_name_prefix)
     : constructor_message_loop_(MessageLoopProxy::current()),
-      inner_(new Inner(this, max_threads, thread_name_prefix, NULL)) {
+      inner_(new Inner(this, max_threads, thread_name_prefix, GLOBAL_QUEUE,
+                       NULL)) {
+}
+
+SequencedWorkerPool::SequencedWorkerPool(
+    size_t max_threads,
+    const std::string& thread_name_prefix,
+    TestingObserver* observer)
+    : constructor_message_loop_(MessageLoopProxy::current()),
+      inner_(new Inner(this, max_threads, thread_name_prefix, GLOBAL_QUEUE,
+                       observer)) {
 }
 
 SequencedWorkerPool::SequencedWorkerPool(
     size_t max_threads,
     const std::string& thread_name_prefix,
+    SchedulerMode scheduler_mode,
     TestingObserver* observer)
     : constructor_message_loop_(MessageLoopProxy::current()),
-      inner_(new Inner(this, max_threads, thread_name_prefix, observer)) {
+      inner_(new Inner(this, max_threads, thread_name_prefix, scheduler_mode,
+                       observer)) {
 }
 
 SequencedWorkerPool::~SequencedWorkerPool() {}
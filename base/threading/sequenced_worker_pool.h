@@ -118,6 +118,25 @@ class BASE_EXPORT SequencedWorkerPool : public TaskRunner {
     BLOCK_SHUTDOWN,
   };
 
+  // Defines how worker threads pick up the tasks posted to the pool.
+  enum SchedulerMode {
+    // Every task goes through one queue protected by the pool lock.
+    GLOBAL_QUEUE,
+
+    // Once all the worker threads have been created, unsequenced tasks that
+    // are not delayed are queued on a deque owned by one of the workers
+    // (the posting worker itself, or one picked round-robin for other
+    // threads). The pool lock is only taken to wake up an idle worker.
+    // Workers steal tasks from the other workers' deques when they run out.
+    // Sequenced, named and delayed tasks still go through the global queue,
+    // so a sequence keeps running on one worker at a time, and shutdown
+    // semantics are the same as in GLOBAL_QUEUE mode.
+    //
+    // Each worker reports the tasks it steals and the time it spends idle to
+    // about:profiler through tracked_objects.
+    WORK_STEALING,
+  };
+
   // Opaque identifier that defines sequencing of tasks posted to the worker
   // pool.
   class SequenceToken {
@@ -171,6 +190,13 @@ class BASE_EXPORT SequencedWorkerPool : public TaskRunner {
                       const std::string& thread_name_prefix,
                       TestingObserver* observer);
 
+  // Like the above, but with the given |scheduler_mode|. |observer| may be
+  // NULL.
+  SequencedWorkerPool(size_t max_threads,
+                      const std::string& thread_name_prefix,
+                      SchedulerMode scheduler_mode,
+                      TestingObserver* observer);
+
   // Returns a unique token that can be used to sequence tasks posted to
   // PostSequencedWorkerTask(). Valid tokens are always nonzero.
   SequenceToken GetSequenceToken();
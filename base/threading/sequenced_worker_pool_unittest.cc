@@ -179,7 +179,8 @@ class TestTracker : public base::RefCountedThreadSafe<TestTracker> {
 class SequencedWorkerPoolTest : public testing::Test {
  public:
   SequencedWorkerPoolTest()
-      : tracker_(new TestTracker) {
+      : scheduler_mode_(SequencedWorkerPool::GLOBAL_QUEUE),
+        tracker_(new TestTracker) {
     ResetPool();
   }
 
@@ -199,7 +200,9 @@ class SequencedWorkerPoolTest : public testing::Test {
   // Destroys the SequencedWorkerPool instance, blocking until it is fully shut
   // down, and creates a new instance.
   void ResetPool() {
-    pool_owner_.reset(new SequencedWorkerPoolOwner(kNumWorkerThreads, "test"));
+    pool_owner_.reset(
+        new SequencedWorkerPoolOwner(kNumWorkerThreads, "test",
+                                     scheduler_mode_));
   }
 
   void SetWillWaitForShutdownCallback(const Closure& callback) {
@@ -243,7 +246,16 @@ class SequencedWorkerPoolTest : public testing::Test {
     return pool_owner_->has_work_call_count();
   }
 
+ protected:
+  explicit SequencedWorkerPoolTest(
+      SequencedWorkerPool::SchedulerMode scheduler_mode)
+      : scheduler_mode_(scheduler_mode),
+        tracker_(new TestTracker) {
+    ResetPool();
+  }
+
  private:
+  const SequencedWorkerPool::SchedulerMode scheduler_mode_;
   MessageLoop message_loop_;
   scoped_ptr<SequencedWorkerPoolOwner> pool_owner_;
   const scoped_refptr<TestTracker> tracker_;
@@ -796,6 +808,129 @@ TEST_F(SequencedWorkerPoolTest, FlushForTesting) {
   pool()->FlushForTesting();
 }
 
+// Runs the tests below on a pool in WORK_STEALING mode. Unsequenced tasks only
+// go to the local deques once all the workers exist, so most tests start with
+// EnsureAllWorkersCreated().
+class SequencedWorkerPoolWorkStealingTest : public SequencedWorkerPoolTest {
+ public:
+  SequencedWorkerPoolWorkStealingTest()
+      : SequencedWorkerPoolTest(SequencedWorkerPool::WORK_STEALING) {}
+};
+
+// Posts |count| fast tasks from a worker, which queues them on its own deque,
+// and then blocks that worker.
+void PostFastTasksAndBlock(scoped_refptr<TestTracker> tracker,
+                           SequencedWorkerPool* pool,
+                           size_t count,
+                           ThreadBlocker* blocker) {
+  for (size_t i = 0; i < count; ++i) {
+    pool->PostWorkerTask(FROM_HERE,
+                         base::Bind(&TestTracker::FastTask, tracker,
+                                    static_cast<int>(i)));
+  }
+  tracker->BlockTask(-2, blocker);
+}
+
+TEST_F(SequencedWorkerPoolWorkStealingTest, LotsOfTasks) {
+  EnsureAllWorkersCreated();
+  pool()->PostWorkerTask(FROM_HERE,
+                         base::Bind(&TestTracker::SlowTask, tracker(), 0));
+
+  const size_t kNumTasks = 100;
+  for (size_t i = 1; i < kNumTasks; i++) {
+    pool()->PostWorkerTask(FROM_HERE,
+                           base::Bind(&TestTracker::FastTask, tracker(), i));
+  }
+
+  std::vector<int> result = tracker()->WaitUntilTasksComplete(kNumTasks);
+  EXPECT_EQ(kNumTasks, result.size());
+}
+
+// Tests that the tasks a blocked worker queued on its own deque are stolen and
+// run by the other workers.
+TEST_F(SequencedWorkerPoolWorkStealingTest, StealsFromBlockedWorker) {
+  EnsureAllWorkersCreated();
+  ThreadBlocker blocker;
+  const size_t kNumTasks = 20;
+  pool()->PostWorkerTask(FROM_HERE,
+                         base::Bind(&PostFastTasksAndBlock,
+                                    scoped_refptr<TestTracker>(tracker()),
+                                    pool(), kNumTasks, &blocker));
+  tracker()->WaitUntilTasksBlocked(1);
+
+  std::vector<int> result = tracker()->WaitUntilTasksComplete(kNumTasks);
+  EXPECT_EQ(kNumTasks, result.size());
+
+  blocker.Unblock(1);
+  tracker()->WaitUntilTasksComplete(kNumTasks + 1);
+}
+
+// Same as SequencedWorkerPoolTest.DiscardOnShutdown, with the queued tasks on
+// the local deques.
+TEST_F(SequencedWorkerPoolWorkStealingTest, DiscardOnShutdown) {
+  EnsureAllWorkersCreated();
+  ThreadBlocker blocker;
+  for (size_t i = 0; i < kNumWorkerThreads; i++) {
+    pool()->PostWorkerTask(FROM_HERE,
+                           base::Bind(&TestTracker::BlockTask,
+                                      tracker(), i, &blocker));
+  }
+  tracker()->WaitUntilTasksBlocked(kNumWorkerThreads);
+
+  pool()->PostWorkerTaskWithShutdownBehavior(
+      FROM_HERE,
+      base::Bind(&TestTracker::FastTask, tracker(), 100),
+      SequencedWorkerPool::CONTINUE_ON_SHUTDOWN);
+  pool()->PostWorkerTaskWithShutdownBehavior(
+      FROM_HERE,
+      base::Bind(&TestTracker::FastTask, tracker(), 101),
+      SequencedWorkerPool::SKIP_ON_SHUTDOWN);
+  pool()->PostWorkerTaskWithShutdownBehavior(
+      FROM_HERE,
+      base::Bind(&TestTracker::FastTask, tracker(), 102),
+      SequencedWorkerPool::BLOCK_SHUTDOWN);
+
+  SetWillWaitForShutdownCallback(
+      base::Bind(&EnsureTasksToCompleteCountAndUnblock,
+                 scoped_refptr<TestTracker>(tracker()), 0,
+                 &blocker, kNumWorkerThreads));
+  pool()->Shutdown();
+
+  std::vector<int> result =
+      tracker()->WaitUntilTasksComplete(kNumWorkerThreads + 1);
+  ASSERT_EQ(kNumWorkerThreads + 1, result.size());
+  for (size_t i = 0; i < kNumWorkerThreads; i++) {
+    EXPECT_TRUE(std::find(result.begin(), result.end(), static_cast<int>(i)) !=
+                result.end());
+  }
+  EXPECT_TRUE(std::find(result.begin(), result.end(), 102) != result.end());
+}
+
+TEST_F(SequencedWorkerPoolWorkStealingTest, FlushForTesting) {
+  EnsureAllWorkersCreated();
+  pool()->PostDelayedWorkerTask(
+      FROM_HERE,
+      base::Bind(&TestTracker::FastTask, tracker(), 0),
+      TimeDelta::FromMinutes(5));
+  const size_t kNumFastTasks = 20;
+  for (size_t i = 0; i < kNumFastTasks; i++) {
+    pool()->PostWorkerTask(FROM_HERE,
+                           base::Bind(&TestTracker::FastTask, tracker(), 0));
+  }
+  pool()->PostWorkerTask(
+      FROM_HERE,
+      base::Bind(&TestTracker::PostAdditionalTasks, tracker(), 0, pool(),
+                 true));
+
+  EXPECT_FALSE(tracker()->HasOneRef());
+  pool()->FlushForTesting();
+  EXPECT_TRUE(tracker()->HasOneRef());
+  EXPECT_EQ(kNumFastTasks + 1 + 3, tracker()->GetTasksCompletedCount());
+
+  pool()->Shutdown();
+  pool()->FlushForTesting();
+}
+
 TEST(SequencedWorkerPoolRefPtrTest, ShutsDownCleanWithContinueOnShutdown) {
   MessageLoop loop;
   scoped_refptr<SequencedWorkerPool> pool(new SequencedWorkerPool(3, "Pool"));
@@ -841,6 +976,37 @@ INSTANTIATE_TYPED_TEST_CASE_P(
     SequencedWorkerPool, TaskRunnerTest,
     SequencedWorkerPoolTaskRunnerTestDelegate);
 
+class SequencedWorkerPoolWorkStealingTaskRunnerTestDelegate {
+ public:
+  SequencedWorkerPoolWorkStealingTaskRunnerTestDelegate() {}
+
+  ~SequencedWorkerPoolWorkStealingTaskRunnerTestDelegate() {}
+
+  void StartTaskRunner() {
+    pool_owner_.reset(
+        new SequencedWorkerPoolOwner(
+            10, "SequencedWorkerPoolWorkStealingTaskRunnerTest",
+            SequencedWorkerPool::WORK_STEALING));
+  }
+
+  scoped_refptr<SequencedWorkerPool> GetTaskRunner() {
+    return pool_owner_->pool();
+  }
+
+  void StopTaskRunner() {
+    pool_owner_->pool()->FlushForTesting();
+    pool_owner_->pool()->Shutdown();
+  }
+
+ private:
+  MessageLoop message_loop_;
+  scoped_ptr<SequencedWorkerPoolOwner> pool_owner_;
+};
+
+INSTANTIATE_TYPED_TEST_CASE_P(
+    SequencedWorkerPoolWorkStealing, TaskRunnerTest,
+    SequencedWorkerPoolWorkStealingTaskRunnerTestDelegate);
+
 class SequencedWorkerPoolTaskRunnerWithShutdownBehaviorTestDelegate {
  public:
   SequencedWorkerPoolTaskRunnerWithShutdownBehaviorTestDelegate() {}
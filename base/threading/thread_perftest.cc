@@ -5,7 +5,10 @@
 #include "base/base_switches.h"
 #include "base/bind.h"
 #include "base/command_line.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/memory/scoped_vector.h"
+#include "base/message_loop/message_loop.h"
+#include "base/strings/stringprintf.h"
 #include "base/synchronization/condition_variable.h"
 #include "base/synchronization/lock.h"
 #include "base/synchronization/waitable_event.h"
@@ -144,6 +147,93 @@ TEST_F(TaskPerfTest, TaskPingPong) {
   RunPingPongTest("4_Task_Threads", 4);
 }
 
+// Class to test the post-to-run latency of tasks posted to one consumer thread
+// by several producer threads at once. The producers are the threads created
+// by RunPingPongTest(), the consumer is owned by the test so that it can be
+// created with either incoming queue backend.
+class MultiProducerTaskPerfTest : public ThreadPerfTest {
+ public:
+  MultiProducerTaskPerfTest() : lock_free_(false), num_consumed_(0) {}
+
+  void RunMultiProducerTest(bool lock_free, unsigned num_producers) {
+    lock_free_ = lock_free;
+    name_ = base::StringPrintf("%u_Producers_%s",
+                               num_producers,
+                               lock_free ? "LockFree" : "Locked");
+    RunPingPongTest(name_, num_producers);
+  }
+
+  virtual void Init() OVERRIDE {
+    MessageLoop::EnableLockFreeIncomingQueue(lock_free_);
+    consumer_.reset(new base::Thread("Consumer"));
+    consumer_->Start();
+    MessageLoop::EnableLockFreeIncomingQueue(false);
+    num_consumed_ = 0;
+    total_latency_ = base::TimeDelta();
+  }
+
+  virtual void Reset() OVERRIDE {
+    consumer_.reset();
+    perf_test::PrintResult(
+        "task", "", name_ + "_latency ",
+        total_latency_.InMicroseconds() / static_cast<double>(num_consumed_),
+        "us/task", true);
+  }
+
+  virtual void PingPong(int hops) OVERRIDE {
+    num_tasks_ = hops;
+    int per_producer = hops / threads_.size();
+    for (size_t i = 0; i < threads_.size(); i++) {
+      int count = per_producer;
+      if (i == 0)
+        count += hops % threads_.size();
+      threads_[i]->message_loop_proxy()->PostTask(
+          FROM_HERE,
+          base::Bind(&MultiProducerTaskPerfTest::ProduceOnThread,
+                     base::Unretained(this),
+                     count));
+    }
+  }
+
+ private:
+  void ProduceOnThread(int count) {
+    scoped_refptr<base::MessageLoopProxy> consumer =
+        consumer_->message_loop_proxy();
+    for (int i = 0; i < count; i++) {
+      consumer->PostTask(
+          FROM_HERE,
+          base::Bind(&MultiProducerTaskPerfTest::ConsumeOnThread,
+                     base::Unretained(this),
+                     base::TimeTicks::HighResNow()));
+    }
+  }
+
+  void ConsumeOnThread(base::TimeTicks posted) {
+    total_latency_ += base::TimeTicks::HighResNow() - posted;
+    if (++num_consumed_ == num_tasks_)
+      FinishMeasurement();
+  }
+
+  bool lock_free_;
+  std::string name_;
+  scoped_ptr<base::Thread> consumer_;
+
+  // Only accessed on the consumer thread while the test is running.
+  int num_tasks_;
+  int num_consumed_;
+  base::TimeDelta total_latency_;
+};
+
+// Measures how the incoming queue of a single MessageLoop behaves under
+// contention, with the default locked backend and with the lock-free one.
+TEST_F(MultiProducerTaskPerfTest, MultiProducerPostTask) {
+  const unsigned kNumProducers[] = { 1, 4, 16 };
+  for (size_t i = 0; i < arraysize(kNumProducers); i++) {
+    RunMultiProducerTest(false, kNumProducers[i]);
+    RunMultiProducerTest(true, kNumProducers[i]);
+  }
+}
+
 // Class to test our WaitableEvent performance by signaling back and fort.
 // WaitableEvent is templated so we can also compare with other versions.
 template <typename WaitableEventType>
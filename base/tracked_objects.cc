@@ -6,6 +6,7 @@
 
 #include <limits.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "base/atomicops.h"
 #include "base/base_switches.h"
@@ -272,6 +273,7 @@ ThreadData::ThreadData(const std::string& suggested_name)
       incarnation_count_for_pool_(-1) {
   DCHECK_GE(suggested_name.size(), 0u);
   thread_name_ = suggested_name;
+  ClearLookupCaches();
   PushToHeadOfList();  // Which sets real incarnation_count_for_pool_.
 }
 
@@ -282,6 +284,7 @@ ThreadData::ThreadData(int thread_number)
       incarnation_count_for_pool_(-1)  {
   CHECK_GT(thread_number, 0);
   base::StringAppendF(&thread_name_, "WorkerThread-%d", thread_number);
+  ClearLookupCaches();
   PushToHeadOfList();  // Which sets real incarnation_count_for_pool_.
 }
 
@@ -403,18 +406,36 @@ void ThreadData::Snapshot(bool reset_max, ProcessDataSnapshot* process_data) {
   }
 }
 
+void ThreadData::ClearLookupCaches() {
+  memset(birth_cache_, 0, sizeof(birth_cache_));
+  memset(death_cache_, 0, sizeof(death_cache_));
+}
+
 Births* ThreadData::TallyABirth(const Location& location) {
-  BirthMap::iterator it = birth_map_.find(location);
+  Births*& cached_child = birth_cache_[
+      (location.line_number() ^
+       (reinterpret_cast<uintptr_t>(location.file_name()) >> 4)) &
+      (kLookupCacheSize - 1)];
   Births* child;
-  if (it != birth_map_.end()) {
-    child =  it->second;
+  if (cached_child &&
+      cached_child->location().line_number() == location.line_number() &&
+      cached_child->location().file_name() == location.file_name() &&
+      cached_child->location().function_name() == location.function_name()) {
+    child = cached_child;
     child->RecordBirth();
   } else {
-    child = new Births(location, *this);  // Leak this.
-    // Lock since the map may get relocated now, and other threads sometimes
-    // snapshot it (but they lock before copying it).
-    base::AutoLock lock(map_lock_);
-    birth_map_[location] = child;
+    BirthMap::iterator it = birth_map_.find(location);
+    if (it != birth_map_.end()) {
+      child =  it->second;
+      child->RecordBirth();
+    } else {
+      child = new Births(location, *this);  // Leak this.
+      // Lock since the map may get relocated now, and other threads sometimes
+      // snapshot it (but they lock before copying it).
+      base::AutoLock lock(map_lock_);
+      birth_map_[location] = child;
+    }
+    cached_child = child;
   }
 
   if (kTrackParentChildLinks && status_ > PROFILING_ACTIVE &&
@@ -447,15 +468,19 @@ void ThreadData::TallyADeath(const Births& birth,
   if (kAllowAlternateTimeSourceHandling && now_function_)
     queue_duration = 0;
 
-  DeathMap::iterator it = death_map_.find(&birth);
-  DeathData* death_data;
-  if (it != death_map_.end()) {
-    death_data = &it->second;
-  } else {
-    base::AutoLock lock(map_lock_);  // Lock as the map may get relocated now.
-    death_data = &death_map_[&birth];
-  }  // Release lock ASAP.
-  death_data->RecordDeath(queue_duration, run_duration, random_number_);
+  DeathCacheEntry& cached = death_cache_[
+      (reinterpret_cast<uintptr_t>(&birth) >> 4) & (kLookupCacheSize - 1)];
+  if (cached.birth != &birth) {
+    DeathMap::iterator it = death_map_.find(&birth);
+    if (it != death_map_.end()) {
+      cached.death_data = &it->second;
+    } else {
+      base::AutoLock lock(map_lock_);  // Lock as the map may get relocated now.
+      cached.death_data = &death_map_[&birth];
+    }  // Release lock ASAP.
+    cached.birth = &birth;
+  }
+  cached.death_data->RecordDeath(queue_duration, run_duration, random_number_);
 
   if (!kTrackParentChildLinks)
     return;
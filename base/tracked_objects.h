@@ -493,6 +493,7 @@ class BASE_EXPORT ThreadData {
   // better change of optimizing (inlining? etc.) private methods (knowing that
   // there will be no need for an external entry point).
   friend class TrackedObjectsTest;
+  FRIEND_TEST_ALL_PREFIXES(TrackedObjectsTest, ManyLocations);
   FRIEND_TEST_ALL_PREFIXES(TrackedObjectsTest, MinimalStartupShutdown);
   FRIEND_TEST_ALL_PREFIXES(TrackedObjectsTest, TinyStartupShutdown);
   FRIEND_TEST_ALL_PREFIXES(TrackedObjectsTest, ParentChildTest);
@@ -512,6 +513,9 @@ class BASE_EXPORT ThreadData {
   // the instance permanently on that list.
   void PushToHeadOfList();
 
+  // Empties birth_cache_ and death_cache_.
+  void ClearLookupCaches();
+
   // (Thread safe) Get start of list of all ThreadData instances using the lock.
   static ThreadData* first();
 
@@ -656,6 +660,18 @@ class BASE_EXPORT ThreadData {
   // local Births (that took place on this thread).
   ParentChildSet parent_child_set_;
 
+  // Direct mapped caches of the birth_map_ and death_map_ entries used last,
+  // so that most tallies skip the map lookups. Map entries are never erased,
+  // so the cached pointers stay valid. Only accessed on this thread, and so
+  // never locked.
+  static const size_t kLookupCacheSize = 64;
+  struct DeathCacheEntry {
+    const Births* birth;
+    DeathData* death_data;
+  };
+  Births* birth_cache_[kLookupCacheSize];
+  DeathCacheEntry death_cache_[kLookupCacheSize];
+
   // Lock to protect *some* access to BirthMap and DeathMap.  The maps are
   // regularly read and written on this thread, but may only be read from other
   // threads.  To support this, we acquire this lock if we are writing from this
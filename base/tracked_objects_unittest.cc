@@ -581,4 +581,48 @@ TEST_F(TrackedObjectsTest, DifferentLives) {
   EXPECT_EQ(base::GetCurrentProcId(), process_data.process_id);
 }
 
+// Tallies lives at more locations than the per-thread lookup caches hold, so
+// that cache entries get replaced, and checks that no tally is lost.
+TEST_F(TrackedObjectsTest, ManyLocations) {
+  if (!ThreadData::InitializeAndSetTrackingStatus(
+          ThreadData::PROFILING_ACTIVE))
+    return;
+
+  ThreadData::InitializeThreadContext(kMainThreadName);
+  const char kFunction[] = "ManyLocations";
+  const int kLocationCount = 200;
+  const int kLivesPerLocation = 3;
+  const base::TimeTicks kDelayedStartTime = base::TimeTicks();
+  const TrackedTime kStartOfRun = TrackedTime() +
+      Duration::FromMilliseconds(5);
+  const TrackedTime kEndOfRun = TrackedTime() + Duration::FromMilliseconds(7);
+  for (int life = 0; life < kLivesPerLocation; ++life) {
+    for (int line = 1; line <= kLocationCount; ++line) {
+      Location location(kFunction, kFile, line, NULL);
+      // TrackingInfo will call TallyABirth() during construction.
+      base::TrackingInfo pending_task(location, kDelayedStartTime);
+      ThreadData::TallyRunOnNamedThreadIfTracking(pending_task,
+          kStartOfRun, kEndOfRun);
+    }
+  }
+
+  ThreadData* data = ThreadData::Get();
+  ASSERT_TRUE(data);
+  ThreadData::BirthMap birth_map;
+  ThreadData::DeathMap death_map;
+  ThreadData::ParentChildSet parent_child_set;
+  data->SnapshotMaps(false, &birth_map, &death_map, &parent_child_set);
+  ASSERT_EQ(static_cast<size_t>(kLocationCount), birth_map.size());
+  ASSERT_EQ(static_cast<size_t>(kLocationCount), death_map.size());
+  for (ThreadData::BirthMap::const_iterator it = birth_map.begin();
+       it != birth_map.end(); ++it) {
+    EXPECT_EQ(kLivesPerLocation, it->second->birth_count());
+  }
+  for (ThreadData::DeathMap::const_iterator it = death_map.begin();
+       it != death_map.end(); ++it) {
+    EXPECT_EQ(kLivesPerLocation, it->second.count());
+    EXPECT_EQ(kLivesPerLocation * 2, it->second.run_duration_sum());
+  }
+}
+
 }  // namespace tracked_objects
@@ -33,7 +33,9 @@ void MainThreadRenderingStats::Add(const MainThreadRenderingStats& other) {
 
 ImplThreadRenderingStats::ImplThreadRenderingStats()
     : frame_count(0),
-      rasterized_pixel_count(0) {}
+      rasterized_pixel_count(0),
+      image_decode_task_count(0),
+      reused_image_decode_task_count(0) {}
 
 scoped_refptr<base::debug::ConvertableToTraceFormat>
 ImplThreadRenderingStats::AsTraceableData() const {
@@ -41,6 +43,9 @@ ImplThreadRenderingStats::AsTraceableData() const {
   record_data->SetInteger("frame_count", frame_count);
   record_data->SetDouble("rasterize_time", rasterize_time.InSecondsF());
   record_data->SetInteger("rasterized_pixel_count", rasterized_pixel_count);
+  record_data->SetInteger("image_decode_task_count", image_decode_task_count);
+  record_data->SetInteger("reused_image_decode_task_count",
+                          reused_image_decode_task_count);
   return TracedValue::FromValue(record_data.release());
 }
 
@@ -49,6 +54,8 @@ void ImplThreadRenderingStats::Add(const ImplThreadRenderingStats& other) {
   rasterize_time += other.rasterize_time;
   analysis_time += other.analysis_time;
   rasterized_pixel_count += other.rasterized_pixel_count;
+  image_decode_task_count += other.image_decode_task_count;
+  reused_image_decode_task_count += other.reused_image_decode_task_count;
 }
 
 void RenderingStats::Add(const RenderingStats& other) {
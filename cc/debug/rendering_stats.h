@@ -35,6 +35,10 @@ struct CC_EXPORT ImplThreadRenderingStats {
   base::TimeDelta rasterize_time;
   base::TimeDelta analysis_time;
   int64 rasterized_pixel_count;
+  // Image decode tasks that tiles depended on, and how many of those reused
+  // a task created for an earlier tile.
+  int64 image_decode_task_count;
+  int64 reused_image_decode_task_count;
 
   ImplThreadRenderingStats();
   scoped_refptr<base::debug::ConvertableToTraceFormat> AsTraceableData() const;
@@ -108,4 +108,14 @@ void RenderingStatsInstrumentation::AddAnalysis(base::TimeDelta duration,
   impl_stats_.analysis_time += duration;
 }
 
+void RenderingStatsInstrumentation::AddImageDecodeTask(bool reused) {
+  if (!record_rendering_stats_)
+    return;
+
+  base::AutoLock scoped_lock(lock_);
+  impl_stats_.image_decode_task_count++;
+  if (reused)
+    impl_stats_.reused_image_decode_task_count++;
+}
+
 }  // namespace cc
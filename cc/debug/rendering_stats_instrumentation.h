@@ -53,6 +53,7 @@ class CC_EXPORT RenderingStatsInstrumentation {
   void AddRecord(base::TimeDelta duration, int64 pixels);
   void AddRaster(base::TimeDelta duration, int64 pixels);
   void AddAnalysis(base::TimeDelta duration, int64 pixels);
+  void AddImageDecodeTask(bool reused);
 
  protected:
   RenderingStatsInstrumentation();
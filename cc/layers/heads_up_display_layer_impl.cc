@@ -71,6 +71,7 @@ HeadsUpDisplayLayerImpl::HeadsUpDisplayLayerImpl(LayerTreeImpl* tree_impl,
           SkTypeface::CreateFromName("monospace", SkTypeface::kBold))),
       fps_graph_(60.0, 80.0),
       paint_time_graph_(16.0, 48.0),
+      draw_call_count_(0),
       fade_step_(0) {}
 
 HeadsUpDisplayLayerImpl::~HeadsUpDisplayLayerImpl() {}
@@ -197,6 +198,7 @@ void HeadsUpDisplayLayerImpl::UpdateHudContents() {
       FrameRateCounter* fps_counter = layer_tree_impl()->frame_rate_counter();
       fps_graph_.value = fps_counter->GetAverageFPS();
       fps_counter->GetMinAndMaxFPS(&fps_graph_.min, &fps_graph_.max);
+      draw_call_count_ = layer_tree_impl()->LastFrameDrawCallCount();
     }
 
     if (debug_state.continuous_painting) {
@@ -330,7 +332,7 @@ SkRect HeadsUpDisplayLayerImpl::DrawFPSDisplay(
   const int kHistogramWidth = 37;
 
   int width = kGraphWidth + kHistogramWidth + 4 * kPadding;
-  int height = kFontHeight + kGraphHeight + 4 * kPadding + 2;
+  int height = 2 * kFontHeight + kGraphHeight + 5 * kPadding + 2;
   int left = bounds().width() - width - right;
   SkRect area = SkRect::MakeXYWH(left, top, width, height);
 
@@ -350,6 +352,11 @@ SkRect HeadsUpDisplayLayerImpl::DrawFPSDisplay(
                                              graph_bounds.top(),
                                              kHistogramWidth,
                                              kGraphHeight);
+  SkRect draw_calls_text_bounds =
+      SkRect::MakeXYWH(left + kPadding,
+                       graph_bounds.bottom() + kPadding + 2,
+                       text_bounds.width(),
+                       kFontHeight);
 
   const std::string value_text =
       base::StringPrintf("FPS:%5.1f", fps_graph_.value);
@@ -371,6 +378,13 @@ SkRect HeadsUpDisplayLayerImpl::DrawFPSDisplay(
            kFontHeight,
            text_bounds.right(),
            text_bounds.bottom());
+  DrawText(canvas,
+           &paint,
+           base::StringPrintf("Draw calls: %d", draw_call_count_),
+           SkPaint::kLeft_Align,
+           kFontHeight,
+           draw_calls_text_bounds.left(),
+           draw_calls_text_bounds.bottom());
 
   DrawGraphLines(canvas, &paint, graph_bounds, fps_graph_);
 
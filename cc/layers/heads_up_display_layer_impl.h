@@ -125,6 +125,7 @@ class CC_EXPORT HeadsUpDisplayLayerImpl : public LayerImpl {
 
   Graph fps_graph_;
   Graph paint_time_graph_;
+  int draw_call_count_;
   MemoryHistory::Entry memory_entry_;
   int fade_step_;
   std::vector<DebugRect> paint_rects_;
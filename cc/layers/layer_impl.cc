@@ -70,7 +70,10 @@ LayerImpl::LayerImpl(LayerTreeImpl* tree_impl, int id)
       draw_depth_(0.f),
       needs_push_properties_(false),
       num_dependents_need_push_properties_(0),
-      current_draw_mode_(DRAW_MODE_NONE) {
+      current_draw_mode_(DRAW_MODE_NONE),
+      transform_tree_index_(-1),
+      clip_tree_index_(-1),
+      effect_tree_index_(-1) {
   DCHECK_GT(layer_id_, 0);
   DCHECK(layer_tree_impl_);
   layer_tree_impl_->RegisterLayer(this);
@@ -102,6 +105,7 @@ void LayerImpl::AddChild(scoped_ptr<LayerImpl> child) {
   DCHECK_EQ(layer_tree_impl(), child->layer_tree_impl());
   children_.push_back(child.Pass());
   layer_tree_impl()->set_needs_update_draw_properties();
+  layer_tree_impl()->set_needs_update_meta_information();
 }
 
 scoped_ptr<LayerImpl> LayerImpl::RemoveChild(LayerImpl* child) {
@@ -112,6 +116,7 @@ scoped_ptr<LayerImpl> LayerImpl::RemoveChild(LayerImpl* child) {
       scoped_ptr<LayerImpl> ret = children_.take(it);
       children_.erase(it);
       layer_tree_impl()->set_needs_update_draw_properties();
+      layer_tree_impl()->set_needs_update_meta_information();
       return ret.Pass();
     }
   }
@@ -134,6 +139,7 @@ void LayerImpl::ClearChildList() {
 
   children_.clear();
   layer_tree_impl()->set_needs_update_draw_properties();
+  layer_tree_impl()->set_needs_update_meta_information();
 }
 
 bool LayerImpl::HasAncestor(const LayerImpl* ancestor) const {
@@ -159,6 +165,7 @@ void LayerImpl::SetScrollParent(LayerImpl* parent) {
     DCHECK_EQ(layer_tree_impl()->LayerById(parent->id()), parent);
 
   scroll_parent_ = parent;
+  layer_tree_impl()->set_needs_update_meta_information();
   SetNeedsPushProperties();
 }
 
@@ -172,6 +179,7 @@ void LayerImpl::SetScrollChildren(std::set<LayerImpl*>* children) {
   if (scroll_children_.get() == children)
     return;
   scroll_children_.reset(children);
+  layer_tree_impl()->set_needs_update_meta_information();
   SetNeedsPushProperties();
 }
 
@@ -180,6 +188,7 @@ void LayerImpl::SetClipParent(LayerImpl* ancestor) {
     return;
 
   clip_parent_ = ancestor;
+  layer_tree_impl()->set_needs_update_meta_information();
   SetNeedsPushProperties();
 }
 
@@ -187,6 +196,7 @@ void LayerImpl::SetClipChildren(std::set<LayerImpl*>* children) {
   if (clip_children_.get() == children)
     return;
   clip_children_.reset(children);
+  layer_tree_impl()->set_needs_update_meta_information();
   SetNeedsPushProperties();
 }
 
@@ -200,6 +210,7 @@ void LayerImpl::PassCopyRequests(ScopedPtrVector<CopyOutputRequest>* requests) {
 
   if (was_empty && layer_tree_impl()->IsActiveTree())
     layer_tree_impl()->AddLayerWithCopyOutputRequest(this);
+  layer_tree_impl()->set_needs_update_meta_information();
   NoteLayerPropertyChangedForSubtree();
 }
 
@@ -225,6 +236,7 @@ void LayerImpl::TakeCopyRequestsAndTransformToTarget(
   }
 
   layer_tree_impl()->RemoveLayerWithCopyOutputRequest(this);
+  layer_tree_impl()->set_needs_update_meta_information();
 }
 
 void LayerImpl::CreateRenderSurface() {
@@ -835,6 +847,7 @@ void LayerImpl::SetDrawsContent(bool draws_content) {
     return;
 
   draws_content_ = draws_content;
+  layer_tree_impl()->set_needs_update_meta_information();
   NoteLayerPropertyChanged();
 }
 
@@ -283,6 +283,15 @@ class CC_EXPORT LayerImpl : public LayerAnimationValueObserver,
     return draw_properties_;
   }
 
+  // The indices of this layer's nodes in the property trees built by
+  // PropertyTreeBuilder, or -1 if they haven't been built.
+  int transform_tree_index() const { return transform_tree_index_; }
+  void set_transform_tree_index(int index) { transform_tree_index_ = index; }
+  int clip_tree_index() const { return clip_tree_index_; }
+  void set_clip_tree_index(int index) { clip_tree_index_ = index; }
+  int effect_tree_index() const { return effect_tree_index_; }
+  void set_effect_tree_index(int index) { effect_tree_index_ = index; }
+
   // The following are shortcut accessors to get various information from
   // draw_properties_
   const gfx::Transform& draw_transform() const {
@@ -657,6 +666,10 @@ class CC_EXPORT LayerImpl : public LayerAnimationValueObserver,
   // hierarchy before layers can be drawn.
   DrawProperties<LayerImpl> draw_properties_;
 
+  int transform_tree_index_;
+  int clip_tree_index_;
+  int effect_tree_index_;
+
   scoped_refptr<base::debug::ConvertableToTraceFormat> debug_info_;
 
   DISALLOW_COPY_AND_ASSIGN(LayerImpl);
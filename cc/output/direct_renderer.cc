@@ -313,6 +313,16 @@ void DirectRenderer::SetScissorStateForQuadWithRenderPassScissor(
     return;
   }
 
+  // Skip quads entirely outside the damage, rather than drawing them only to
+  // have every pixel clipped away. Render pass quads are always drawn, since
+  // their filters may reach outside the quad.
+  if (quad.material != DrawQuad::RENDER_PASS &&
+      !quad_scissor_rect.Intersects(MathUtil::MapClippedRect(
+          quad.quadTransform(), gfx::RectF(quad.visible_rect)))) {
+    *should_skip_quad = true;
+    return;
+  }
+
   *should_skip_quad = false;
   SetScissorTestRectInDrawSpace(frame, quad_scissor_rect);
 }
@@ -212,6 +212,8 @@ GLRenderer::GLRenderer(RendererClient* client,
       scissor_rect_needs_reset_(true),
       stencil_shadow_(false),
       blend_shadow_(false),
+      draw_call_count_(0),
+      last_frame_draw_call_count_(0),
       highp_threshold_min_(highp_threshold_min),
       highp_threshold_cache_(0),
       on_demand_tile_raster_resource_id_(0) {
@@ -342,6 +344,7 @@ void GLRenderer::ClearFramebuffer(DrawingFrame* frame,
 }
 
 void GLRenderer::BeginDrawingFrame(DrawingFrame* frame) {
+  draw_call_count_ = 0;
   if (frame->device_viewport_rect.IsEmpty())
     return;
 
@@ -361,6 +364,9 @@ void GLRenderer::DoDrawQuad(DrawingFrame* frame, const DrawQuad* quad) {
   if (quad->material != DrawQuad::TEXTURE_CONTENT) {
     FlushTextureQuadCache();
   }
+  if (quad->material != DrawQuad::SOLID_COLOR) {
+    FlushSolidColorQuadCache();
+  }
 
   switch (quad->material) {
     case DrawQuad::INVALID:
@@ -484,6 +490,7 @@ void GLRenderer::DrawDebugBorderQuad(const DrawingFrame* frame,
   // The indices for the line are stored in the same array as the triangle
   // indices.
   GLC(gl_, gl_->DrawElements(GL_LINE_LOOP, 4, GL_UNSIGNED_SHORT, 0));
+  ++draw_call_count_;
 }
 
 static SkBitmap ApplyImageFilter(GLRenderer* renderer,
@@ -1355,6 +1362,14 @@ void GLRenderer::DrawSolidColorQuad(const DrawingFrame* frame,
       settings_->allow_antialiasing && !quad->force_anti_aliasing_off &&
       SetupQuadForAntialiasing(device_transform, quad, &local_quad, edge);
 
+  // Quads that need no antialiasing differ only by transform and color, so
+  // they are coalesced to draw a run of them in one call.
+  if (!use_aa) {
+    EnqueueSolidColorQuad(frame, quad, alpha);
+    return;
+  }
+  FlushSolidColorQuadCache();
+
   SolidColorProgramUniforms uniforms;
   if (use_aa)
     SolidColorUniformLocation(GetSolidColorProgramAA(), &uniforms);
@@ -1873,6 +1888,7 @@ void GLRenderer::FlushTextureQuadCache() {
                         6 * draw_cache_.matrix_data.size(),
                         GL_UNSIGNED_SHORT,
                         0));
+  ++draw_call_count_;
 
   // Clear the cache.
   draw_cache_.program_id = 0;
@@ -1946,6 +1962,86 @@ void GLRenderer::EnqueueTextureQuad(const DrawingFrame* frame,
   draw_cache_.matrix_data.push_back(m);
 }
 
+void GLRenderer::FlushSolidColorQuadCache() {
+  // Check to see if we have anything to draw.
+  if (solid_color_draw_cache_.program_id == 0)
+    return;
+
+  SetBlendEnabled(solid_color_draw_cache_.needs_blending);
+  SetUseProgram(solid_color_draw_cache_.program_id);
+
+  GLC(gl_,
+      gl_->UniformMatrix4fv(
+          solid_color_draw_cache_.matrix_location,
+          static_cast<int>(solid_color_draw_cache_.matrix_data.size()),
+          false,
+          reinterpret_cast<float*>(
+              &solid_color_draw_cache_.matrix_data.front())));
+  GLC(gl_,
+      gl_->Uniform4fv(
+          solid_color_draw_cache_.color_location,
+          static_cast<int>(solid_color_draw_cache_.color_data.size()),
+          reinterpret_cast<float*>(
+              &solid_color_draw_cache_.color_data.front())));
+
+  GLC(gl_,
+      gl_->DrawElements(GL_TRIANGLES,
+                        6 * solid_color_draw_cache_.matrix_data.size(),
+                        GL_UNSIGNED_SHORT,
+                        0));
+  ++draw_call_count_;
+
+  // Clear the cache.
+  solid_color_draw_cache_.program_id = 0;
+  solid_color_draw_cache_.color_data.resize(0);
+  solid_color_draw_cache_.matrix_data.resize(0);
+}
+
+void GLRenderer::EnqueueSolidColorQuad(const DrawingFrame* frame,
+                                       const SolidColorDrawQuad* quad,
+                                       float alpha) {
+  const SolidColorBatchProgram* program = GetSolidColorBatchProgram();
+  DCHECK(program && (program->initialized() || IsContextLost()));
+
+  if (solid_color_draw_cache_.program_id !=
+          static_cast<int>(program->program()) ||
+      solid_color_draw_cache_.needs_blending !=
+          quad->ShouldDrawWithBlending() ||
+      solid_color_draw_cache_.matrix_data.size() >= 8) {
+    FlushSolidColorQuadCache();
+    solid_color_draw_cache_.program_id = program->program();
+    solid_color_draw_cache_.needs_blending = quad->ShouldDrawWithBlending();
+    solid_color_draw_cache_.color_location =
+        program->vertex_shader().color_location();
+    solid_color_draw_cache_.matrix_location =
+        program->vertex_shader().matrix_location();
+  }
+
+  SkColor color = quad->color;
+  Float4 premultiplied_color = {
+      {(SkColorGetR(color) * (1.0f / 255.0f)) * alpha,
+       (SkColorGetG(color) * (1.0f / 255.0f)) * alpha,
+       (SkColorGetB(color) * (1.0f / 255.0f)) * alpha,
+       alpha}};
+  solid_color_draw_cache_.color_data.push_back(premultiplied_color);
+
+  gfx::Transform quad_rect_matrix;
+  QuadRectTransform(
+      &quad_rect_matrix, quad->quadTransform(), quad->visible_rect);
+  quad_rect_matrix = frame->projection_matrix * quad_rect_matrix;
+
+  Float16 m;
+  quad_rect_matrix.matrix().asColMajorf(m.data);
+  solid_color_draw_cache_.matrix_data.push_back(m);
+}
+
+void GLRenderer::FlushQuadCaches() {
+  // At most one of the caches holds quads, as enqueueing a quad of one kind
+  // flushes the other.
+  FlushTextureQuadCache();
+  FlushSolidColorQuadCache();
+}
+
 void GLRenderer::DrawIOSurfaceQuad(const DrawingFrame* frame,
                                    const IOSurfaceDrawQuad* quad) {
   SetBlendEnabled(quad->ShouldDrawWithBlending());
@@ -1998,9 +2094,12 @@ void GLRenderer::FinishDrawingFrame(DrawingFrame* frame) {
 
   GLC(gl_, gl_->Disable(GL_BLEND));
   blend_shadow_ = false;
+
+  last_frame_draw_call_count_ = draw_call_count_;
+  TRACE_COUNTER_ID1("cc", "DrawCallCount", this, draw_call_count_);
 }
 
-void GLRenderer::FinishDrawingQuadList() { FlushTextureQuadCache(); }
+void GLRenderer::FinishDrawingQuadList() { FlushQuadCaches(); }
 
 bool GLRenderer::FlippedFramebuffer() const { return true; }
 
@@ -2008,7 +2107,7 @@ void GLRenderer::EnsureScissorTestEnabled() {
   if (is_scissor_enabled_)
     return;
 
-  FlushTextureQuadCache();
+  FlushQuadCaches();
   GLC(gl_, gl_->Enable(GL_SCISSOR_TEST));
   is_scissor_enabled_ = true;
 }
@@ -2017,7 +2116,7 @@ void GLRenderer::EnsureScissorTestDisabled() {
   if (!is_scissor_enabled_)
     return;
 
-  FlushTextureQuadCache();
+  FlushQuadCaches();
   GLC(gl_, gl_->Disable(GL_SCISSOR_TEST));
   is_scissor_enabled_ = false;
 }
@@ -2096,6 +2195,7 @@ void GLRenderer::DrawQuadGeometry(const DrawingFrame* frame,
   GLC(gl_, gl_->UniformMatrix4fv(matrix_location, 1, false, &gl_matrix[0]));
 
   GLC(gl_, gl_->DrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, 0));
+  ++draw_call_count_;
 }
 
 void GLRenderer::CopyTextureToFramebuffer(const DrawingFrame* frame,
@@ -2580,7 +2680,7 @@ void GLRenderer::SetScissorTestRect(const gfx::Rect& scissor_rect) {
     return;
 
   scissor_rect_ = scissor_rect;
-  FlushTextureQuadCache();
+  FlushQuadCaches();
   GLC(gl_,
       gl_->Scissor(scissor_rect.x(),
                    scissor_rect.y(),
@@ -2650,6 +2750,17 @@ const GLRenderer::SolidColorProgramAA* GLRenderer::GetSolidColorProgramAA() {
   return &solid_color_program_aa_;
 }
 
+const GLRenderer::SolidColorBatchProgram*
+GLRenderer::GetSolidColorBatchProgram() {
+  if (!solid_color_batch_program_.initialized()) {
+    TRACE_EVENT0("cc", "GLRenderer::solidColorBatchProgram::initialize");
+    solid_color_batch_program_.Initialize(output_surface_->context_provider(),
+                                          TexCoordPrecisionNA,
+                                          SamplerTypeNA);
+  }
+  return &solid_color_batch_program_;
+}
+
 const GLRenderer::RenderPassProgram* GLRenderer::GetRenderPassProgram(
     TexCoordPrecision precision) {
   DCHECK_GE(precision, 0);
@@ -3008,6 +3119,7 @@ void GLRenderer::CleanupSharedObjects() {
   debug_border_program_.Cleanup(gl_);
   solid_color_program_.Cleanup(gl_);
   solid_color_program_aa_.Cleanup(gl_);
+  solid_color_batch_program_.Cleanup(gl_);
 
   if (offscreen_framebuffer_id_)
     GLC(gl_, gl_->DeleteFramebuffers(1, &offscreen_framebuffer_id_));
@@ -3043,4 +3155,8 @@ bool GLRenderer::IsContextLost() {
   return output_surface_->context_provider()->IsContextLost();
 }
 
+int GLRenderer::LastFrameDrawCallCount() const {
+  return last_frame_draw_call_count_;
+}
+
 }  // namespace cc
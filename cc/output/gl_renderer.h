@@ -67,6 +67,8 @@ class CC_EXPORT GLRenderer : public DirectRenderer {
 
   virtual bool IsContextLost() OVERRIDE;
 
+  virtual int LastFrameDrawCallCount() const OVERRIDE;
+
   virtual void SetVisible(bool visible) OVERRIDE;
 
   virtual void SendManagedMemoryStats(size_t bytes_visible,
@@ -162,6 +164,11 @@ class CC_EXPORT GLRenderer : public DirectRenderer {
   void EnqueueTextureQuad(const DrawingFrame* frame,
                           const TextureDrawQuad* quad);
   void FlushTextureQuadCache();
+  void EnqueueSolidColorQuad(const DrawingFrame* frame,
+                             const SolidColorDrawQuad* quad,
+                             float alpha);
+  void FlushSolidColorQuadCache();
+  void FlushQuadCaches();
   void DrawIOSurfaceQuad(const DrawingFrame* frame,
                          const IOSurfaceDrawQuad* quad);
   void DrawTileQuad(const DrawingFrame* frame, const TileDrawQuad* quad);
@@ -298,6 +305,8 @@ class CC_EXPORT GLRenderer : public DirectRenderer {
       SolidColorProgram;
   typedef ProgramBinding<VertexShaderQuadAA, FragmentShaderColorAA>
       SolidColorProgramAA;
+  typedef ProgramBinding<VertexShaderPosColorArray, FragmentShaderVaryingColor>
+      SolidColorBatchProgram;
 
   const TileProgram* GetTileProgram(
       TexCoordPrecision precision, SamplerType sampler);
@@ -352,6 +361,7 @@ class CC_EXPORT GLRenderer : public DirectRenderer {
   const DebugBorderProgram* GetDebugBorderProgram();
   const SolidColorProgram* GetSolidColorProgram();
   const SolidColorProgramAA* GetSolidColorProgramAA();
+  const SolidColorBatchProgram* GetSolidColorBatchProgram();
 
   TileProgram tile_program_[NumTexCoordPrecisions][NumSamplerTypes];
   TileProgramOpaque
@@ -395,6 +405,7 @@ class CC_EXPORT GLRenderer : public DirectRenderer {
   DebugBorderProgram debug_border_program_;
   SolidColorProgram solid_color_program_;
   SolidColorProgramAA solid_color_program_aa_;
+  SolidColorBatchProgram solid_color_batch_program_;
 
   gpu::gles2::GLES2Interface* gl_;
   gpu::ContextSupport* context_support_;
@@ -416,6 +427,9 @@ class CC_EXPORT GLRenderer : public DirectRenderer {
   bool blend_shadow_;
   unsigned program_shadow_;
   TexturedQuadDrawCache draw_cache_;
+  SolidColorQuadDrawCache solid_color_draw_cache_;
+  int draw_call_count_;
+  int last_frame_draw_call_count_;
   int highp_threshold_min_;
   int highp_threshold_cache_;
 
@@ -66,6 +66,7 @@ class GLRendererShaderPixelTest : public GLRendererPixelTest {
     EXPECT_PROGRAM_VALID(renderer()->GetDebugBorderProgram());
     EXPECT_PROGRAM_VALID(renderer()->GetSolidColorProgram());
     EXPECT_PROGRAM_VALID(renderer()->GetSolidColorProgramAA());
+    EXPECT_PROGRAM_VALID(renderer()->GetSolidColorBatchProgram());
     TestShadersWithTexCoordPrecision(TexCoordPrecisionMedium);
     TestShadersWithTexCoordPrecision(TexCoordPrecisionHigh);
     ASSERT_FALSE(renderer()->IsContextLost());
@@ -968,6 +969,111 @@ TEST_F(GLRendererTest, ShouldClearRootRenderPass) {
   Mock::VerifyAndClearExpectations(&mock_context);
 }
 
+class DrawCountingMockContext : public TestWebGraphicsContext3D {
+ public:
+  MOCK_METHOD4(drawElements,
+               void(GLenum mode, GLsizei count, GLenum type, GLintptr offset));
+};
+
+TEST_F(GLRendererTest, SolidColorQuadsAreBatched) {
+  scoped_ptr<DrawCountingMockContext> mock_context_owned(
+      new DrawCountingMockContext);
+  DrawCountingMockContext* mock_context = mock_context_owned.get();
+
+  FakeOutputSurfaceClient output_surface_client;
+  scoped_ptr<OutputSurface> output_surface(FakeOutputSurface::Create3d(
+      mock_context_owned.PassAs<TestWebGraphicsContext3D>()));
+  CHECK(output_surface->BindToClient(&output_surface_client));
+
+  scoped_ptr<SharedBitmapManager> shared_bitmap_manager(
+      new TestSharedBitmapManager());
+  scoped_ptr<ResourceProvider> resource_provider(ResourceProvider::Create(
+      output_surface.get(), shared_bitmap_manager.get(), 0, false, 1));
+
+  LayerTreeSettings settings;
+  FakeRendererClient renderer_client;
+  FakeRendererGL renderer(&renderer_client,
+                          &settings,
+                          output_surface.get(),
+                          resource_provider.get());
+
+  gfx::Rect viewport_rect(30, 10);
+
+  RenderPass::Id root_pass_id(1, 0);
+  TestRenderPass* root_pass = AddRenderPass(&render_passes_in_draw_order_,
+                                            root_pass_id,
+                                            viewport_rect,
+                                            gfx::Transform());
+  AddQuad(root_pass, gfx::Rect(0, 0, 10, 10), SK_ColorRED);
+  AddQuad(root_pass, gfx::Rect(10, 0, 10, 10), SK_ColorGREEN);
+  AddQuad(root_pass, gfx::Rect(20, 0, 10, 10), SK_ColorBLUE);
+
+  // The three opaque quads differ only by color and position, so they are
+  // drawn with one call of 18 indices.
+  EXPECT_CALL(*mock_context, drawElements(GL_TRIANGLES, 18, _, _)).Times(1);
+
+  renderer.DecideRenderPassAllocationsForFrame(render_passes_in_draw_order_);
+  renderer.DrawFrame(&render_passes_in_draw_order_,
+                     NULL,
+                     1.f,
+                     viewport_rect,
+                     viewport_rect,
+                     false);
+  EXPECT_EQ(1, renderer.LastFrameDrawCallCount());
+
+  Mock::VerifyAndClearExpectations(&mock_context);
+}
+
+TEST_F(GLRendererTest, QuadsOutsideDamageAreSkipped) {
+  scoped_ptr<DrawCountingMockContext> mock_context_owned(
+      new DrawCountingMockContext);
+  DrawCountingMockContext* mock_context = mock_context_owned.get();
+  mock_context->set_have_post_sub_buffer(true);
+
+  FakeOutputSurfaceClient output_surface_client;
+  scoped_ptr<OutputSurface> output_surface(FakeOutputSurface::Create3d(
+      mock_context_owned.PassAs<TestWebGraphicsContext3D>()));
+  CHECK(output_surface->BindToClient(&output_surface_client));
+
+  scoped_ptr<SharedBitmapManager> shared_bitmap_manager(
+      new TestSharedBitmapManager());
+  scoped_ptr<ResourceProvider> resource_provider(ResourceProvider::Create(
+      output_surface.get(), shared_bitmap_manager.get(), 0, false, 1));
+
+  LayerTreeSettings settings;
+  settings.partial_swap_enabled = true;
+  FakeRendererClient renderer_client;
+  FakeRendererGL renderer(&renderer_client,
+                          &settings,
+                          output_surface.get(),
+                          resource_provider.get());
+  EXPECT_TRUE(renderer.Capabilities().using_partial_swap);
+
+  gfx::Rect viewport_rect(100, 100);
+
+  RenderPass::Id root_pass_id(1, 0);
+  TestRenderPass* root_pass = AddRenderPass(&render_passes_in_draw_order_,
+                                            root_pass_id,
+                                            viewport_rect,
+                                            gfx::Transform());
+  AddQuad(root_pass, gfx::Rect(50, 50, 50, 50), SK_ColorGREEN);
+  root_pass->damage_rect = gfx::RectF(0.f, 0.f, 10.f, 10.f);
+
+  // The quad does not touch the damage, so nothing is drawn.
+  EXPECT_CALL(*mock_context, drawElements(_, _, _, _)).Times(0);
+
+  renderer.DecideRenderPassAllocationsForFrame(render_passes_in_draw_order_);
+  renderer.DrawFrame(&render_passes_in_draw_order_,
+                     NULL,
+                     1.f,
+                     viewport_rect,
+                     viewport_rect,
+                     false);
+  EXPECT_EQ(0, renderer.LastFrameDrawCallCount());
+
+  Mock::VerifyAndClearExpectations(&mock_context);
+}
+
 class ScissorTestOnClearCheckingContext : public TestWebGraphicsContext3D {
  public:
   ScissorTestOnClearCheckingContext() : scissor_enabled_(false) {}
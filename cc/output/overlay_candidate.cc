@@ -4,14 +4,49 @@
 
 #include "cc/output/overlay_candidate_validator.h"
 
+#include "cc/quads/draw_quad.h"
+#include "cc/quads/texture_draw_quad.h"
+#include "cc/resources/resource_provider.h"
+#include "ui/gfx/rect_conversions.h"
+#include "ui/gfx/transform.h"
+
 namespace cc {
 
 OverlayCandidate::OverlayCandidate()
     : transform(NONE),
       format(RGBA_8888),
       uv_rect(0.f, 0.f, 1.f, 1.f),
+      plane_z_order(0),
       overlay_handled(false) {}
 
 OverlayCandidate::~OverlayCandidate() {}
 
+// static
+bool OverlayCandidate::FromDrawQuad(ResourceProvider* resource_provider,
+                                    const DrawQuad& draw_quad,
+                                    OverlayCandidate* candidate) {
+  if (draw_quad.material != DrawQuad::TEXTURE_CONTENT)
+    return false;
+
+  const TextureDrawQuad& quad = *TextureDrawQuad::MaterialCast(&draw_quad);
+  if (!resource_provider->AllowOverlay(quad.resource_id))
+    return false;
+
+  // Simple quads only.
+  if (!quad.quadTransform().IsIdentityOrTranslation() || quad.needs_blending ||
+      quad.shared_quad_state->opacity != 1.f ||
+      quad.shared_quad_state->blend_mode != SkXfermode::kSrcOver_Mode ||
+      quad.premultiplied_alpha || quad.background_color != SK_ColorTRANSPARENT)
+    return false;
+
+  gfx::RectF float_rect(quad.rect);
+  quad.quadTransform().TransformRect(&float_rect);
+  candidate->transform =
+      quad.flipped ? OverlayCandidate::FLIP_VERTICAL : OverlayCandidate::NONE;
+  candidate->display_rect = gfx::ToNearestRect(float_rect);
+  candidate->uv_rect = BoundingRect(quad.uv_top_left, quad.uv_bottom_right);
+  candidate->format = RGBA_8888;
+  return true;
+}
+
 }  // namespace cc
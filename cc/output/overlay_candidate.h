@@ -13,6 +13,8 @@
 #include "ui/gfx/geometry/rect.h"
 
 namespace cc {
+class DrawQuad;
+class ResourceProvider;
 
 struct CC_EXPORT OverlayCandidate {
   enum OverlayTransform {
@@ -27,6 +29,13 @@ struct CC_EXPORT OverlayCandidate {
   OverlayCandidate();
   ~OverlayCandidate();
 
+  // Returns true and fills in |candidate| if |quad| is simple enough to be
+  // put in an overlay plane: an opaque, untransformed texture quad whose
+  // resource allows overlays.
+  static bool FromDrawQuad(ResourceProvider* resource_provider,
+                           const DrawQuad& quad,
+                           OverlayCandidate* candidate);
+
   // Transformation to apply to layer during composition.
   OverlayTransform transform;
   // Format of the buffer to composite.
@@ -35,6 +44,9 @@ struct CC_EXPORT OverlayCandidate {
   gfx::Rect display_rect;
   // Crop within the buffer to be placed inside |display_rect|.
   gfx::RectF uv_rect;
+  // Stacking order of the plane. The main surface is 0, and planes with
+  // higher values are shown on top of those with lower ones.
+  int plane_z_order;
 
   // To be modified by the implementer if this candidate can go into
   // an overlay.
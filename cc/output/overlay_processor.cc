@@ -5,6 +5,7 @@
 #include "cc/output/overlay_processor.h"
 
 #include "cc/output/output_surface.h"
+#include "cc/output/overlay_strategy_multi_plane.h"
 #include "cc/output/overlay_strategy_single_on_top.h"
 #include "cc/quads/draw_quad.h"
 #include "cc/quads/texture_draw_quad.h"
@@ -25,6 +26,8 @@ void OverlayProcessor::Initialize() {
   if (candidates) {
     strategies_.push_back(scoped_ptr<Strategy>(
         new OverlayStrategySingleOnTop(candidates, resource_provider_)));
+    strategies_.push_back(scoped_ptr<Strategy>(
+        new OverlayStrategyMultiPlane(candidates, resource_provider_)));
   }
 }
 
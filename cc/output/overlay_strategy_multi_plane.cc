@@ -0,0 +1,128 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/output/overlay_strategy_multi_plane.h"
+
+#include <vector>
+
+#include "cc/base/math_util.h"
+#include "cc/output/overlay_candidate_validator.h"
+#include "cc/quads/draw_quad.h"
+#include "cc/quads/solid_color_draw_quad.h"
+
+namespace cc {
+
+namespace {
+
+bool IntersectsAny(const std::vector<gfx::RectF>& rects,
+                   const gfx::RectF& rect) {
+  for (size_t i = 0; i < rects.size(); ++i) {
+    if (rects[i].Intersects(rect))
+      return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+OverlayStrategyMultiPlane::OverlayStrategyMultiPlane(
+    OverlayCandidateValidator* capability_checker,
+    ResourceProvider* resource_provider)
+    : capability_checker_(capability_checker),
+      resource_provider_(resource_provider) {}
+
+bool OverlayStrategyMultiPlane::Attempt(
+    RenderPassList* render_passes_in_draw_order) {
+  if (!capability_checker_)
+    return false;
+
+  RenderPass* root_render_pass = render_passes_in_draw_order->back();
+  DCHECK(root_render_pass);
+
+  // Add our primary surface.
+  OverlayCandidateValidator::OverlayCandidateList candidates;
+  OverlayCandidate main_image;
+  main_image.display_rect = root_render_pass->output_rect;
+  main_image.format = RGBA_8888;
+  candidates.push_back(main_image);
+
+  // Walk the quads from front to back, so that all quads above a candidate
+  // have been seen when it is reached.
+  QuadList& quad_list = root_render_pass->quad_list;
+  std::vector<size_t> candidate_quad_indices;
+  std::vector<gfx::RectF> rects_above;
+  std::vector<gfx::RectF> plane_rects;
+  int next_on_top_z_order = 1;
+  int next_underlay_z_order = -1;
+  for (size_t i = 0; i < quad_list.size(); ++i) {
+    const DrawQuad* quad = quad_list[i];
+    gfx::RectF rect = MathUtil::MapClippedRect(quad->quadTransform(),
+                                               gfx::RectF(quad->visible_rect));
+    OverlayCandidate candidate;
+    if (OverlayCandidate::FromDrawQuad(resource_provider_, *quad, &candidate) &&
+        !IntersectsAny(plane_rects, rect)) {
+      // Planes on top are numbered again below, once their count is known.
+      if (IntersectsAny(rects_above, rect))
+        candidate.plane_z_order = next_underlay_z_order--;
+      else
+        candidate.plane_z_order = next_on_top_z_order++;
+      candidates.push_back(candidate);
+      candidate_quad_indices.push_back(i);
+      plane_rects.push_back(rect);
+    }
+    rects_above.push_back(rect);
+  }
+
+  if (candidate_quad_indices.empty())
+    return false;
+
+  // Planes for quads higher in the quad list go above those for lower ones.
+  for (size_t i = 1; i < candidates.size(); ++i) {
+    if (candidates[i].plane_z_order > 0) {
+      candidates[i].plane_z_order =
+          next_on_top_z_order - candidates[i].plane_z_order;
+    }
+  }
+
+  // Check for support.
+  capability_checker_->CheckOverlaySupport(&candidates);
+
+  // Create a pass for each candidate that can be handled by an overlay. Going
+  // from back to front keeps the remaining indices valid and leaves the
+  // topmost plane's pass first.
+  bool handled_any = false;
+  for (size_t i = candidate_quad_indices.size(); i > 0; --i) {
+    if (!candidates[i].overlay_handled)
+      continue;
+
+    scoped_ptr<RenderPass> overlay_pass = RenderPass::Create();
+    overlay_pass->overlay_state = RenderPass::SIMPLE_OVERLAY;
+
+    size_t quad_index = candidate_quad_indices[i - 1];
+    scoped_ptr<DrawQuad> overlay_quad =
+        quad_list.take(quad_list.begin() + quad_index);
+    quad_list.erase(quad_list.begin() + quad_index);
+    if (candidates[i].plane_z_order < 0) {
+      // Clear the quad's area of the main surface, without blending, so that
+      // the plane beneath shows through it.
+      scoped_ptr<SolidColorDrawQuad> hole_quad = SolidColorDrawQuad::Create();
+      hole_quad->SetAll(overlay_quad->shared_quad_state,
+                        overlay_quad->rect,
+                        overlay_quad->rect,
+                        overlay_quad->visible_rect,
+                        false,
+                        SK_ColorTRANSPARENT,
+                        true);
+      quad_list.insert(quad_list.begin() + quad_index,
+                       hole_quad.PassAs<DrawQuad>());
+    }
+    overlay_pass->quad_list.push_back(overlay_quad.Pass());
+    render_passes_in_draw_order->insert(render_passes_in_draw_order->begin(),
+                                        overlay_pass.Pass());
+    handled_any = true;
+  }
+  return handled_any;
+}
+
+}  // namespace cc
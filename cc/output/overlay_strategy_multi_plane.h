@@ -0,0 +1,39 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CC_OUTPUT_OVERLAY_STRATEGY_MULTI_PLANE_H_
+#define CC_OUTPUT_OVERLAY_STRATEGY_MULTI_PLANE_H_
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "cc/base/cc_export.h"
+#include "cc/output/overlay_processor.h"
+#include "cc/quads/render_pass.h"
+
+namespace cc {
+class OverlayCandidateValidator;
+
+// Promotes several quads of the root render pass to overlay planes, unlike
+// OverlayStrategySingleOnTop which only handles the topmost quad. A candidate
+// that nothing drawn above it overlaps goes in a plane on top of the main
+// surface, like a canvas beside other content. A candidate with content above
+// it, like a video under its controls, goes in a plane under the main surface,
+// and a transparent hole is drawn in its place so the plane shows through.
+// Planes never overlap each other. The validator decides which of the
+// candidates the display can show.
+class CC_EXPORT OverlayStrategyMultiPlane : public OverlayProcessor::Strategy {
+ public:
+  OverlayStrategyMultiPlane(OverlayCandidateValidator* capability_checker,
+                            ResourceProvider* resource_provider);
+  virtual bool Attempt(RenderPassList* render_passes_in_draw_order) OVERRIDE;
+
+ private:
+  OverlayCandidateValidator* capability_checker_;
+  ResourceProvider* resource_provider_;
+  DISALLOW_COPY_AND_ASSIGN(OverlayStrategyMultiPlane);
+};
+
+}  // namespace cc
+
+#endif  // CC_OUTPUT_OVERLAY_STRATEGY_MULTI_PLANE_H_
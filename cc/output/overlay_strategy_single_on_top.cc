@@ -5,10 +5,8 @@
 #include "cc/output/overlay_strategy_single_on_top.h"
 
 #include "cc/output/output_surface.h"
+#include "cc/output/overlay_candidate_validator.h"
 #include "cc/quads/draw_quad.h"
-#include "cc/quads/texture_draw_quad.h"
-#include "ui/gfx/rect_conversions.h"
-#include "ui/gfx/transform.h"
 
 namespace cc {
 
@@ -28,19 +26,9 @@ bool OverlayStrategySingleOnTop::Attempt(
   DCHECK(root_render_pass);
 
   QuadList& quad_list = root_render_pass->quad_list;
-  const DrawQuad* candidate_quad = quad_list.front();
-  if (candidate_quad->material != DrawQuad::TEXTURE_CONTENT)
-    return false;
-
-  const TextureDrawQuad& quad = *TextureDrawQuad::MaterialCast(candidate_quad);
-  if (!resource_provider_->AllowOverlay(quad.resource_id))
-    return false;
-
-  // Simple quads only.
-  if (!quad.quadTransform().IsIdentityOrTranslation() || quad.needs_blending ||
-      quad.shared_quad_state->opacity != 1.f ||
-      quad.shared_quad_state->blend_mode != SkXfermode::kSrcOver_Mode ||
-      quad.premultiplied_alpha || quad.background_color != SK_ColorTRANSPARENT)
+  OverlayCandidate candidate;
+  if (!OverlayCandidate::FromDrawQuad(
+          resource_provider_, *quad_list.front(), &candidate))
     return false;
 
   // Add our primary surface.
@@ -51,14 +39,7 @@ bool OverlayStrategySingleOnTop::Attempt(
   candidates.push_back(main_image);
 
   // Add the overlay.
-  OverlayCandidate candidate;
-  gfx::RectF float_rect(quad.rect);
-  quad.quadTransform().TransformRect(&float_rect);
-  candidate.transform =
-      quad.flipped ? OverlayCandidate::FLIP_VERTICAL : OverlayCandidate::NONE;
-  candidate.display_rect = gfx::ToNearestRect(float_rect);
-  candidate.uv_rect = BoundingRect(quad.uv_top_left, quad.uv_bottom_right);
-  candidate.format = RGBA_8888;
+  candidate.plane_z_order = 1;
   candidates.push_back(candidate);
 
   // Check for support.
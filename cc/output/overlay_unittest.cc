@@ -7,9 +7,11 @@
 #include "cc/output/output_surface_client.h"
 #include "cc/output/overlay_candidate_validator.h"
 #include "cc/output/overlay_processor.h"
+#include "cc/output/overlay_strategy_multi_plane.h"
 #include "cc/output/overlay_strategy_single_on_top.h"
 #include "cc/quads/checkerboard_draw_quad.h"
 #include "cc/quads/render_pass.h"
+#include "cc/quads/solid_color_draw_quad.h"
 #include "cc/quads/texture_draw_quad.h"
 #include "cc/resources/resource_provider.h"
 #include "cc/resources/texture_mailbox.h"
@@ -43,6 +45,23 @@ void SingleOverlayValidator::CheckOverlaySupport(
   candidate.overlay_handled = true;
 }
 
+// Handles every candidate, and remembers what it was asked.
+class MultiOverlayValidator : public OverlayCandidateValidator {
+ public:
+  virtual void CheckOverlaySupport(OverlayCandidateList* surfaces) OVERRIDE {
+    for (size_t i = 1; i < surfaces->size(); ++i)
+      (*surfaces)[i].overlay_handled = true;
+    last_candidates_ = *surfaces;
+  }
+
+  const OverlayCandidateList& last_candidates() const {
+    return last_candidates_;
+  }
+
+ private:
+  OverlayCandidateList last_candidates_;
+};
+
 class SingleOverlayProcessor : public OverlayProcessor {
  public:
   SingleOverlayProcessor(OutputSurface* surface,
@@ -67,6 +86,21 @@ void SingleOverlayProcessor::Initialize() {
       new OverlayStrategySingleOnTop(candidates, resource_provider_)));
 }
 
+class MultiOverlayProcessor : public OverlayProcessor {
+ public:
+  MultiOverlayProcessor(OutputSurface* surface,
+                        ResourceProvider* resource_provider)
+      : OverlayProcessor(surface, resource_provider) {}
+
+  virtual void Initialize() OVERRIDE {
+    OverlayCandidateValidator* candidates =
+        surface_->overlay_candidate_validator();
+    ASSERT_TRUE(candidates != NULL);
+    strategies_.push_back(scoped_ptr<Strategy>(
+        new OverlayStrategyMultiPlane(candidates, resource_provider_)));
+  }
+};
+
 class DefaultOverlayProcessor : public OverlayProcessor {
  public:
   DefaultOverlayProcessor(OutputSurface* surface,
@@ -91,6 +125,10 @@ class OverlayOutputSurface : public OutputSurface {
   void InitWithSingleOverlayValidator() {
     overlay_candidate_validator_.reset(new SingleOverlayValidator);
   }
+
+  void InitWithMultiOverlayValidator() {
+    overlay_candidate_validator_.reset(new MultiOverlayValidator);
+  }
 };
 
 scoped_ptr<RenderPass> CreateRenderPass() {
@@ -112,9 +150,10 @@ scoped_ptr<RenderPass> CreateRenderPass() {
   return pass.Pass();
 }
 
-scoped_ptr<TextureDrawQuad> CreateCandidateQuad(
+scoped_ptr<TextureDrawQuad> CreateCandidateQuadAt(
     ResourceProvider* resource_provider,
-    const SharedQuadState* shared_quad_state) {
+    const SharedQuadState* shared_quad_state,
+    const gfx::Rect& rect) {
   unsigned sync_point = 0;
   TextureMailbox mailbox =
       TextureMailbox(gpu::Mailbox::Generate(), GL_TEXTURE_2D, sync_point);
@@ -131,9 +170,9 @@ scoped_ptr<TextureDrawQuad> CreateCandidateQuad(
 
   scoped_ptr<TextureDrawQuad> overlay_quad = TextureDrawQuad::Create();
   overlay_quad->SetNew(shared_quad_state,
-                       kOverlayRect,
-                       kOverlayRect,
-                       kOverlayRect,
+                       rect,
+                       rect,
+                       rect,
                        resource_id,
                        premultiplied_alpha,
                        kUVTopLeft,
@@ -145,6 +184,13 @@ scoped_ptr<TextureDrawQuad> CreateCandidateQuad(
   return overlay_quad.Pass();
 }
 
+scoped_ptr<TextureDrawQuad> CreateCandidateQuad(
+    ResourceProvider* resource_provider,
+    const SharedQuadState* shared_quad_state) {
+  return CreateCandidateQuadAt(
+      resource_provider, shared_quad_state, kOverlayRect);
+}
+
 scoped_ptr<DrawQuad> CreateCheckeredQuad(
     ResourceProvider* resource_provider,
     const SharedQuadState* shared_quad_state) {
@@ -208,7 +254,7 @@ TEST(OverlayTest, OverlaysProcessorHasStrategy) {
   scoped_ptr<DefaultOverlayProcessor> overlay_processor(
       new DefaultOverlayProcessor(&output_surface, resource_provider.get()));
   overlay_processor->Initialize();
-  EXPECT_GE(1U, overlay_processor->GetStrategyCount());
+  EXPECT_EQ(2U, overlay_processor->GetStrategyCount());
 }
 
 class SingleOverlayOnTopTest : public testing::Test {
@@ -422,5 +468,136 @@ TEST_F(SingleOverlayOnTopTest, RejectTransform) {
   EXPECT_EQ(RenderPass::NO_OVERLAY, pass_list.back()->overlay_state);
 }
 
+class MultiPlaneOverlayTest : public testing::Test {
+ protected:
+  virtual void SetUp() {
+    provider_ = TestContextProvider::Create();
+    output_surface_.reset(new OverlayOutputSurface(provider_));
+    EXPECT_TRUE(output_surface_->BindToClient(&client_));
+    output_surface_->InitWithMultiOverlayValidator();
+
+    resource_provider_ =
+        ResourceProvider::Create(output_surface_.get(), NULL, 0, false, 1);
+
+    overlay_processor_.reset(new MultiOverlayProcessor(
+        output_surface_.get(), resource_provider_.get()));
+    overlay_processor_->Initialize();
+  }
+
+  const OverlayCandidateValidator::OverlayCandidateList& last_candidates() {
+    return static_cast<MultiOverlayValidator*>(
+        output_surface_->overlay_candidate_validator())->last_candidates();
+  }
+
+  scoped_refptr<TestContextProvider> provider_;
+  scoped_ptr<OverlayOutputSurface> output_surface_;
+  FakeOutputSurfaceClient client_;
+  scoped_ptr<ResourceProvider> resource_provider_;
+  scoped_ptr<MultiOverlayProcessor> overlay_processor_;
+};
+
+TEST_F(MultiPlaneOverlayTest, SeveralPlanesOnTop) {
+  scoped_ptr<RenderPass> pass = CreateRenderPass();
+  pass->quad_list.push_back(
+      CreateCandidateQuadAt(resource_provider_.get(),
+                            pass->shared_quad_state_list.back(),
+                            gfx::Rect(0, 0, 128, 128)).PassAs<DrawQuad>());
+  pass->quad_list.push_back(
+      CreateCandidateQuadAt(resource_provider_.get(),
+                            pass->shared_quad_state_list.back(),
+                            gfx::Rect(128, 0, 128, 128)).PassAs<DrawQuad>());
+  // Add something behind them.
+  pass->quad_list.push_back(CreateCheckeredQuad(
+      resource_provider_.get(), pass->shared_quad_state_list.back()));
+
+  RenderPassList pass_list;
+  pass_list.push_back(pass.Pass());
+
+  overlay_processor_->ProcessForOverlays(&pass_list);
+
+  // Both candidates are put in planes above the main surface, the topmost
+  // one highest.
+  ASSERT_EQ(3U, last_candidates().size());
+  EXPECT_EQ(2, last_candidates()[1].plane_z_order);
+  EXPECT_EQ(1, last_candidates()[2].plane_z_order);
+
+  ASSERT_EQ(3U, pass_list.size());
+  EXPECT_EQ(RenderPass::SIMPLE_OVERLAY, pass_list[0]->overlay_state);
+  EXPECT_EQ(RenderPass::SIMPLE_OVERLAY, pass_list[1]->overlay_state);
+  EXPECT_RECT_EQ(gfx::Rect(0, 0, 128, 128),
+                 pass_list[0]->quad_list.front()->rect);
+  EXPECT_RECT_EQ(gfx::Rect(128, 0, 128, 128),
+                 pass_list[1]->quad_list.front()->rect);
+
+  RenderPass* main_pass = pass_list.back();
+  EXPECT_EQ(RenderPass::NO_OVERLAY, main_pass->overlay_state);
+  ASSERT_EQ(1U, main_pass->quad_list.size());
+  EXPECT_EQ(DrawQuad::CHECKERBOARD, main_pass->quad_list.front()->material);
+}
+
+TEST_F(MultiPlaneOverlayTest, UnderlayBeneathOccludingQuad) {
+  scoped_ptr<RenderPass> pass = CreateRenderPass();
+  // Something drawn over the candidate, like video controls.
+  pass->quad_list.push_back(CreateCheckeredQuad(
+      resource_provider_.get(), pass->shared_quad_state_list.back()));
+  scoped_ptr<TextureDrawQuad> original_quad = CreateCandidateQuad(
+      resource_provider_.get(), pass->shared_quad_state_list.back());
+  pass->quad_list.push_back(
+      original_quad->Copy(pass->shared_quad_state_list.back()));
+
+  RenderPassList pass_list;
+  pass_list.push_back(pass.Pass());
+
+  overlay_processor_->ProcessForOverlays(&pass_list);
+
+  ASSERT_EQ(2U, last_candidates().size());
+  EXPECT_EQ(-1, last_candidates()[1].plane_z_order);
+
+  ASSERT_EQ(2U, pass_list.size());
+  RenderPass* overlay_pass = pass_list.front();
+  EXPECT_EQ(RenderPass::SIMPLE_OVERLAY, overlay_pass->overlay_state);
+  EXPECT_EQ(original_quad->resource_id,
+            TextureDrawQuad::MaterialCast(overlay_pass->quad_list.front())
+                ->resource_id);
+
+  // The candidate's place in the main surface is cleared to transparent,
+  // without blending, so that the underlay shows through.
+  RenderPass* main_pass = pass_list.back();
+  ASSERT_EQ(2U, main_pass->quad_list.size());
+  EXPECT_EQ(DrawQuad::CHECKERBOARD, main_pass->quad_list[0]->material);
+  ASSERT_EQ(DrawQuad::SOLID_COLOR, main_pass->quad_list[1]->material);
+  const SolidColorDrawQuad* hole_quad =
+      SolidColorDrawQuad::MaterialCast(main_pass->quad_list[1]);
+  EXPECT_EQ(SK_ColorTRANSPARENT, hole_quad->color);
+  EXPECT_RECT_EQ(kOverlayRect, hole_quad->rect);
+  EXPECT_FALSE(hole_quad->ShouldDrawWithBlending());
+}
+
+TEST_F(MultiPlaneOverlayTest, OverlappingCandidatesPromoteTopmost) {
+  scoped_ptr<RenderPass> pass = CreateRenderPass();
+  pass->quad_list.push_back(
+      CreateCandidateQuadAt(resource_provider_.get(),
+                            pass->shared_quad_state_list.back(),
+                            gfx::Rect(0, 0, 128, 128)).PassAs<DrawQuad>());
+  pass->quad_list.push_back(
+      CreateCandidateQuadAt(resource_provider_.get(),
+                            pass->shared_quad_state_list.back(),
+                            gfx::Rect(64, 64, 128, 128)).PassAs<DrawQuad>());
+
+  RenderPassList pass_list;
+  pass_list.push_back(pass.Pass());
+
+  overlay_processor_->ProcessForOverlays(&pass_list);
+
+  // Planes may not overlap, so only the topmost candidate is offered.
+  ASSERT_EQ(2U, last_candidates().size());
+  ASSERT_EQ(2U, pass_list.size());
+  EXPECT_RECT_EQ(gfx::Rect(0, 0, 128, 128),
+                 pass_list.front()->quad_list.front()->rect);
+  ASSERT_EQ(1U, pass_list.back()->quad_list.size());
+  EXPECT_RECT_EQ(gfx::Rect(64, 64, 128, 128),
+                 pass_list.back()->quad_list.front()->rect);
+}
+
 }  // namespace
 }  // namespace cc
@@ -14,6 +14,10 @@ bool Renderer::IsContextLost() {
   return false;
 }
 
+int Renderer::LastFrameDrawCallCount() const {
+  return 0;
+}
+
 RendererCapabilitiesImpl::RendererCapabilitiesImpl()
     : best_texture_format(RGBA_8888),
       allow_partial_texture_updates(false),
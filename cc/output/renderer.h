@@ -80,6 +80,9 @@ class CC_EXPORT Renderer {
 
   virtual bool IsContextLost();
 
+  // The number of draw calls issued for the last frame drawn, for the HUD.
+  virtual int LastFrameDrawCallCount() const;
+
   virtual void SetVisible(bool visible) = 0;
 
   virtual void SendManagedMemoryStats(size_t bytes_visible,
@@ -137,6 +137,27 @@ class VertexShaderPosTexTransform {
   DISALLOW_COPY_AND_ASSIGN(VertexShaderPosTexTransform);
 };
 
+// Draws up to 8 quads of flat color in one call, indexed like
+// VertexShaderPosTexTransform.
+class VertexShaderPosColorArray {
+ public:
+  VertexShaderPosColorArray();
+
+  void Init(gpu::gles2::GLES2Interface* context,
+            unsigned program,
+            int* base_uniform_index);
+  std::string GetShaderString() const;
+
+  int matrix_location() const { return matrix_location_; }
+  int color_location() const { return color_location_; }
+
+ private:
+  int matrix_location_;
+  int color_location_;
+
+  DISALLOW_COPY_AND_ASSIGN(VertexShaderPosColorArray);
+};
+
 class VertexShaderQuad {
  public:
   VertexShaderQuad();
@@ -688,6 +709,15 @@ class FragmentShaderColor {
   DISALLOW_COPY_AND_ASSIGN(FragmentShaderColor);
 };
 
+class FragmentShaderVaryingColor {
+ public:
+  void Init(gpu::gles2::GLES2Interface* context,
+            unsigned program,
+            int* base_uniform_index) {}
+  std::string GetShaderString(
+      TexCoordPrecision precision, SamplerType sampler) const;
+};
+
 class FragmentShaderColorAA {
  public:
   FragmentShaderColorAA();
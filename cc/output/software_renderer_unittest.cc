@@ -377,6 +377,76 @@ TEST_F(SoftwareRendererTest, ShouldClearRootRenderPass) {
       output.getColor(smaller_rect.right() - 1, smaller_rect.bottom() - 1));
 }
 
+class DamageRecordingSoftwareOutputDevice : public SoftwareOutputDevice {
+ public:
+  const gfx::Rect& damage_rect() const { return damage_rect_; }
+};
+
+TEST_F(SoftwareRendererTest, PartialSwapDrawsOnlyDamage) {
+  float device_scale_factor = 1.f;
+  gfx::Rect viewport_rect(0, 0, 100, 100);
+
+  DamageRecordingSoftwareOutputDevice* device =
+      new DamageRecordingSoftwareOutputDevice;
+  InitializeRenderer(make_scoped_ptr<SoftwareOutputDevice>(device));
+  EXPECT_TRUE(renderer()->Capabilities().using_partial_swap);
+
+  RenderPassList list;
+
+  SkBitmap output;
+  output.setConfig(SkBitmap::kARGB_8888_Config,
+                   viewport_rect.width(),
+                   viewport_rect.height());
+  output.allocPixels();
+
+  // Draw a fullscreen green quad in a first frame.
+  RenderPass::Id root_pass_id(1, 0);
+  TestRenderPass* root_pass =
+      AddRenderPass(&list, root_pass_id, viewport_rect, gfx::Transform());
+  AddQuad(root_pass, viewport_rect, SK_ColorGREEN);
+
+  renderer()->DecideRenderPassAllocationsForFrame(list);
+  renderer()->DrawFrame(&list,
+                        NULL,
+                        device_scale_factor,
+                        viewport_rect,
+                        viewport_rect,
+                        false);
+  EXPECT_RECT_EQ(viewport_rect, device->damage_rect());
+
+  list.clear();
+
+  // Draw a fullscreen magenta quad in a frame that only damages a small rect.
+  gfx::Rect damage_rect(20, 20, 10, 10);
+  root_pass =
+      AddRenderPass(&list, root_pass_id, viewport_rect, gfx::Transform());
+  AddQuad(root_pass, viewport_rect, SK_ColorMAGENTA);
+  root_pass->damage_rect = gfx::RectF(damage_rect);
+
+  renderer()->DecideRenderPassAllocationsForFrame(list);
+  renderer()->DrawFrame(&list,
+                        NULL,
+                        device_scale_factor,
+                        viewport_rect,
+                        viewport_rect,
+                        false);
+  renderer()->GetFramebufferPixels(output.getPixels(), viewport_rect);
+
+  // Only the damage is painted and presented; the rest of the previous frame
+  // is kept.
+  EXPECT_RECT_EQ(damage_rect, device->damage_rect());
+  EXPECT_EQ(SK_ColorMAGENTA,
+            output.getColor(damage_rect.x(), damage_rect.y()));
+  EXPECT_EQ(SK_ColorMAGENTA,
+            output.getColor(damage_rect.right() - 1, damage_rect.bottom() - 1));
+  EXPECT_EQ(SK_ColorGREEN, output.getColor(0, 0));
+  EXPECT_EQ(SK_ColorGREEN,
+            output.getColor(damage_rect.right(), damage_rect.bottom()));
+  EXPECT_EQ(
+      SK_ColorGREEN,
+      output.getColor(viewport_rect.width() - 1, viewport_rect.height() - 1));
+}
+
 TEST_F(SoftwareRendererTest, RenderPassVisibleRect) {
   float device_scale_factor = 1.f;
   gfx::Rect viewport_rect(0, 0, 100, 100);
@@ -10,12 +10,14 @@
 
 #include "base/base64.h"
 #include "base/debug/trace_event.h"
+#include "base/synchronization/lock.h"
 #include "base/values.h"
 #include "cc/base/math_util.h"
 #include "cc/base/util.h"
 #include "cc/debug/traced_picture.h"
 #include "cc/debug/traced_value.h"
 #include "cc/layers/content_layer_client.h"
+#include "skia/ext/analysis_canvas.h"
 #include "skia/ext/pixel_ref_utils.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkData.h"
@@ -89,7 +91,7 @@ scoped_refptr<Picture> Picture::Create(
     int num_raster_threads) {
   scoped_refptr<Picture> picture = make_scoped_refptr(new Picture(layer_rect));
 
-  picture->Record(client, tile_grid_info);
+  picture->Record(client, tile_grid_info, NULL, gfx::Rect());
   if (gather_pixel_refs)
     picture->GatherPixelRefs(tile_grid_info);
   picture->CloneForDrawing(num_raster_threads);
@@ -97,9 +99,82 @@ scoped_refptr<Picture> Picture::Create(
   return picture;
 }
 
+scoped_refptr<Picture> Picture::CreateReusingPicture(
+    const Picture* reused_picture,
+    const gfx::Rect& layer_rect,
+    const gfx::Rect& invalid_rect,
+    ContentLayerClient* client,
+    const SkTileGridPicture::TileGridInfo& tile_grid_info,
+    bool gather_pixel_refs,
+    int num_raster_threads) {
+  DCHECK(reused_picture);
+  DCHECK(reused_picture->LayerRect().Contains(layer_rect));
+  scoped_refptr<Picture> picture = make_scoped_refptr(new Picture(layer_rect));
+
+  picture->Record(client, tile_grid_info, reused_picture, invalid_rect);
+  if (gather_pixel_refs)
+    picture->GatherPixelRefs(tile_grid_info);
+  picture->CloneForDrawing(num_raster_threads);
+
+  return picture;
+}
+
+// The analyses of rects of a picture. Shared by the picture and its clones,
+// which analyze on different raster threads.
+class Picture::AnalysisCache
+    : public base::RefCountedThreadSafe<Picture::AnalysisCache> {
+ public:
+  AnalysisCache() {}
+
+  bool Get(const gfx::Rect& layer_rect, Analysis* analysis) const {
+    base::AutoLock lock(lock_);
+    for (EntryVector::const_iterator it = entries_.begin();
+         it != entries_.end();
+         ++it) {
+      if (it->first == layer_rect) {
+        *analysis = it->second;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void Set(const gfx::Rect& layer_rect, const Analysis& analysis) {
+    base::AutoLock lock(lock_);
+    for (EntryVector::const_iterator it = entries_.begin();
+         it != entries_.end();
+         ++it) {
+      if (it->first == layer_rect)
+        return;
+    }
+    entries_.push_back(std::make_pair(layer_rect, analysis));
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<AnalysisCache>;
+  ~AnalysisCache() {}
+
+  // A picture covers few pile cells, so a vector is searched quickly.
+  typedef std::vector<std::pair<gfx::Rect, Analysis> > EntryVector;
+
+  mutable base::Lock lock_;
+  EntryVector entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(AnalysisCache);
+};
+
+Picture::Analysis::Analysis()
+    : is_solid_color(false),
+      has_text(false),
+      solid_color(SK_ColorTRANSPARENT) {}
+
+Picture::Analysis::~Analysis() {}
+
 Picture::Picture(const gfx::Rect& layer_rect)
   : layer_rect_(layer_rect),
-    cell_size_(layer_rect.size()) {
+    analysis_cache_(new AnalysisCache),
+    cell_size_(layer_rect.size()),
+    reuse_depth_(0) {
   // Instead of recording a trace event for object creation here, we wait for
   // the picture to be recorded in Picture::Record.
 }
@@ -169,7 +244,9 @@ Picture::Picture(SkPicture* picture,
     layer_rect_(layer_rect),
     opaque_rect_(opaque_rect),
     picture_(skia::AdoptRef(picture)),
-    cell_size_(layer_rect.size()) {
+    analysis_cache_(new AnalysisCache),
+    cell_size_(layer_rect.size()),
+    reuse_depth_(0) {
 }
 
 Picture::Picture(const skia::RefPtr<SkPicture>& picture,
@@ -179,8 +256,10 @@ Picture::Picture(const skia::RefPtr<SkPicture>& picture,
     layer_rect_(layer_rect),
     opaque_rect_(opaque_rect),
     picture_(picture),
+    analysis_cache_(new AnalysisCache),
     pixel_refs_(pixel_refs),
-    cell_size_(layer_rect.size()) {
+    cell_size_(layer_rect.size()),
+    reuse_depth_(0) {
 }
 
 Picture::~Picture() {
@@ -214,6 +293,7 @@ void Picture::CloneForDrawing(int num_threads) {
                       layer_rect_,
                       opaque_rect_,
                       pixel_refs_));
+      clone->analysis_cache_ = analysis_cache_;
       clones_.push_back(clone);
 
       clone->EmitTraceSnapshotAlias(this);
@@ -223,7 +303,9 @@ void Picture::CloneForDrawing(int num_threads) {
 }
 
 void Picture::Record(ContentLayerClient* painter,
-                     const SkTileGridPicture::TileGridInfo& tile_grid_info) {
+                     const SkTileGridPicture::TileGridInfo& tile_grid_info,
+                     const Picture* reused_picture,
+                     const gfx::Rect& invalid_rect) {
   TRACE_EVENT1("cc", "Picture::Record",
                "data", AsTraceableRecordData());
 
@@ -250,13 +332,42 @@ void Picture::Record(ContentLayerClient* painter,
 
   gfx::RectF opaque_layer_rect;
 
-  painter->PaintContents(canvas, layer_rect_, &opaque_layer_rect);
+  if (reused_picture) {
+    // Replay the old recording outside of |invalid_rect|, in its own layer
+    // space. Playback of an SkPicture isn't thread-safe, so replay a clone
+    // that raster threads won't also be playing back through
+    // |reused_picture|.
+    skia::RefPtr<SkPicture> reused_skpicture = skia::AdoptRef(new SkPicture);
+    reused_picture->picture_->clone(reused_skpicture.get(), 1);
+
+    canvas->save();
+    canvas->clipRect(gfx::RectToSkRect(invalid_rect), SkRegion::kDifference_Op);
+    canvas->translate(SkIntToScalar(reused_picture->layer_rect_.x()),
+                      SkIntToScalar(reused_picture->layer_rect_.y()));
+    canvas->drawPicture(*reused_skpicture);
+    canvas->restore();
+
+    gfx::Rect paint_rect = gfx::IntersectRects(layer_rect_, invalid_rect);
+    canvas->clipRect(gfx::RectToSkRect(paint_rect));
+    painter->PaintContents(canvas, paint_rect, &opaque_layer_rect);
+
+    // The old opaque rect still holds if the new contents don't make part
+    // of it transparent.
+    gfx::Rect painted_opaque_rect = gfx::ToEnclosedRect(opaque_layer_rect);
+    gfx::Rect reused_opaque_rect =
+        gfx::IntersectRects(reused_picture->opaque_rect_, layer_rect_);
+    if (painted_opaque_rect.Contains(paint_rect) ||
+        !reused_opaque_rect.Intersects(paint_rect))
+      opaque_rect_ = reused_opaque_rect;
+    reuse_depth_ = reused_picture->reuse_depth_ + 1;
+  } else {
+    painter->PaintContents(canvas, layer_rect_, &opaque_layer_rect);
+    opaque_rect_ = gfx::ToEnclosedRect(opaque_layer_rect);
+  }
 
   canvas->restore();
   picture_->endRecording();
 
-  opaque_rect_ = gfx::ToEnclosedRect(opaque_layer_rect);
-
   EmitTraceSnapshot();
 }
 
@@ -359,6 +470,29 @@ void Picture::Replay(SkCanvas* canvas) {
                    "num_pixels_replayed", bounds.width() * bounds.height());
 }
 
+void Picture::AnalyzeInRect(const gfx::Rect& layer_rect, Analysis* analysis) {
+  DCHECK(raster_thread_checker_.CalledOnValidThread());
+  DCHECK(layer_rect_.Contains(layer_rect));
+  DCHECK(picture_);
+  if (analysis_cache_->Get(layer_rect, analysis))
+    return;
+
+  TRACE_EVENT0("cc", "Picture::AnalyzeInRect");
+  skia::AnalysisCanvas canvas(layer_rect.width(), layer_rect.height());
+  canvas.translate(layer_rect_.x() - layer_rect.x(),
+                   layer_rect_.y() - layer_rect.y());
+  picture_->draw(&canvas, &canvas);
+
+  analysis->is_solid_color = canvas.GetColorIfSolid(&analysis->solid_color);
+  analysis->has_text = canvas.HasText();
+  analysis_cache_->Set(layer_rect, *analysis);
+}
+
+bool Picture::GetCachedAnalysisInRect(const gfx::Rect& layer_rect,
+                                      Analysis* analysis) const {
+  return analysis_cache_->Get(layer_rect, analysis);
+}
+
 scoped_ptr<base::Value> Picture::AsValue() const {
   SkDynamicMemoryWStream stream;
 
@@ -20,6 +20,7 @@
 #include "cc/base/cc_export.h"
 #include "cc/base/region.h"
 #include "skia/ext/refptr.h"
+#include "third_party/skia/include/core/SkColor.h"
 #include "third_party/skia/include/core/SkTileGridPicture.h"
 #include "ui/gfx/rect.h"
 
@@ -44,18 +45,42 @@ class CC_EXPORT Picture
   typedef std::vector<SkPixelRef*> PixelRefs;
   typedef base::hash_map<PixelRefMapKey, PixelRefs> PixelRefMap;
 
+  struct CC_EXPORT Analysis {
+    Analysis();
+    ~Analysis();
+
+    bool is_solid_color;
+    bool has_text;
+    SkColor solid_color;
+  };
+
   static scoped_refptr<Picture> Create(
       const gfx::Rect& layer_rect,
       ContentLayerClient* client,
       const SkTileGridPicture::TileGridInfo& tile_grid_info,
       bool gather_pixels_refs,
       int num_raster_threads);
+  // Like Create(), but only has |client| paint |invalid_rect| and replays
+  // |reused_picture|, which must cover |layer_rect|, everywhere else. This
+  // is much cheaper than repainting all of |layer_rect| when |invalid_rect|
+  // is small.
+  static scoped_refptr<Picture> CreateReusingPicture(
+      const Picture* reused_picture,
+      const gfx::Rect& layer_rect,
+      const gfx::Rect& invalid_rect,
+      ContentLayerClient* client,
+      const SkTileGridPicture::TileGridInfo& tile_grid_info,
+      bool gather_pixels_refs,
+      int num_raster_threads);
   static scoped_refptr<Picture> CreateFromValue(const base::Value* value);
   static scoped_refptr<Picture> CreateFromSkpValue(const base::Value* value);
 
   gfx::Rect LayerRect() const { return layer_rect_; }
   gfx::Rect OpaqueRect() const { return opaque_rect_; }
 
+  // The number of earlier recordings that this one replays parts of.
+  int reuse_depth() const { return reuse_depth_; }
+
   // Get thread-safe clone for rasterizing with on a specific thread.
   Picture* GetCloneForDrawingOnThread(unsigned thread_index);
 
@@ -73,6 +98,18 @@ class CC_EXPORT Picture
   // clip/scale/layer transformations.
   void Replay(SkCanvas* canvas);
 
+  // Analyzes |layer_rect|, which must be inside LayerRect(), for a solid
+  // color and text. Results are cached per rect and shared with this
+  // picture's clones, so a pile cell is only analyzed once however many
+  // tiles, at however many scales, cover it.
+  void AnalyzeInRect(const gfx::Rect& layer_rect, Analysis* analysis);
+
+  // Returns false without analyzing if no clone of this picture has analyzed
+  // |layer_rect| yet. Unlike AnalyzeInRect(), this is safe to call on any
+  // thread.
+  bool GetCachedAnalysisInRect(const gfx::Rect& layer_rect,
+                               Analysis* analysis) const;
+
   scoped_ptr<base::Value> AsValue() const;
 
   // This iterator imprecisely returns the set of pixel refs that are needed to
@@ -134,16 +171,23 @@ class CC_EXPORT Picture
   void CloneForDrawing(int num_threads);
 
   // Record a paint operation. To be able to safely use this SkPicture for
-  // playback on a different thread this can only be called once.
+  // playback on a different thread this can only be called once. If
+  // |reused_picture| is not NULL, only |invalid_rect| is painted and
+  // |reused_picture| is replayed for the rest of the layer rect.
   void Record(ContentLayerClient* client,
-              const SkTileGridPicture::TileGridInfo& tile_grid_info);
+              const SkTileGridPicture::TileGridInfo& tile_grid_info,
+              const Picture* reused_picture,
+              const gfx::Rect& invalid_rect);
 
   // Gather pixel refs from recording.
   void GatherPixelRefs(const SkTileGridPicture::TileGridInfo& tile_grid_info);
 
+  class AnalysisCache;
+
   gfx::Rect layer_rect_;
   gfx::Rect opaque_rect_;
   skia::RefPtr<SkPicture> picture_;
+  scoped_refptr<AnalysisCache> analysis_cache_;
 
   typedef std::vector<scoped_refptr<Picture> > PictureVector;
   PictureVector clones_;
@@ -153,6 +197,8 @@ class CC_EXPORT Picture
   gfx::Point max_pixel_cell_;
   gfx::Size cell_size_;
 
+  int reuse_depth_;
+
   scoped_refptr<base::debug::ConvertableToTraceFormat>
     AsTraceableRasterData(float scale) const;
   scoped_refptr<base::debug::ConvertableToTraceFormat>
@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <map>
 #include <vector>
 
 #include "cc/base/region.h"
@@ -25,6 +26,14 @@ const int kPixelDistanceToRecord = 8000;
 // script and find a sweet spot.
 const float kDensityThreshold = 0.5f;
 
+// A picture dropped by an invalidation is replayed rather than repainted
+// outside the invalid part of the new recording, as long as that part is at
+// most this fraction of the new recording's area. Each such recording nests
+// the one it replays, so this is done at most kMaxPictureReuseDepth times in
+// a row before repainting everything.
+const float kMaxInvalidFractionToReusePicture = 0.25f;
+const int kMaxPictureReuseDepth = 4;
+
 bool rect_sort_y(const gfx::Rect &r1, const gfx::Rect &r2) {
   return r1.y() < r2.y() || (r1.y() == r2.y() && r1.x() < r2.x());
 }
@@ -168,6 +177,12 @@ bool PicturePile::Update(ContentLayerClient* painter,
   recorded_viewport_ = interest_rect;
   recorded_viewport_.Intersect(gfx::Rect(size()));
 
+  // Pictures dropped by |invalidation| that can be partly replayed into the
+  // new recordings of their cells.
+  typedef std::map<PictureMapKey, scoped_refptr<Picture> >
+      InvalidatedPictureMap;
+  InvalidatedPictureMap invalidated_pictures;
+
   bool invalidated = false;
   for (Region::Iterator i(invalidation); i.has_rect(); i.next()) {
     gfx::Rect invalidation = i.rect();
@@ -183,6 +198,10 @@ bool PicturePile::Update(ContentLayerClient* painter,
       if (picture_it == picture_map_.end())
         continue;
 
+      Picture* picture = picture_it->second.GetPicture();
+      if (picture && picture->reuse_depth() < kMaxPictureReuseDepth)
+        invalidated_pictures[key] = picture;
+
       // Inform the grid cell that it has been invalidated in this frame.
       invalidated = picture_it->second.Invalidate(frame_number) || invalidated;
     }
@@ -225,6 +244,40 @@ bool PicturePile::Update(ContentLayerClient* painter,
     gfx::Rect record_rect = *it;
     record_rect = PadRect(record_rect);
 
+    // If every cell of |record_rect| lost the same picture to |invalidation|
+    // and only a small part of |record_rect| is invalid, replay that picture
+    // for the rest instead of repainting it.
+    scoped_refptr<Picture> reused_picture;
+    gfx::Rect invalid_rect;
+    bool include_borders = true;
+    for (TilingData::Iterator it(&tiling_, record_rect, include_borders); it;
+         ++it) {
+      const PictureMapKey& key = it.index();
+      if (!record_rect.Contains(PaddedRect(key)))
+        continue;
+      InvalidatedPictureMap::iterator picture_it =
+          invalidated_pictures.find(key);
+      if (picture_it == invalidated_pictures.end() ||
+          (reused_picture.get() &&
+           reused_picture.get() != picture_it->second.get())) {
+        reused_picture = NULL;
+        break;
+      }
+      reused_picture = picture_it->second;
+    }
+    if (reused_picture.get()) {
+      Region invalid_region = invalidation;
+      invalid_region.Intersect(record_rect);
+      invalid_rect = PadRect(invalid_region.bounds());
+      invalid_rect.Intersect(record_rect);
+      float invalid_fraction =
+          static_cast<float>(invalid_rect.width() * invalid_rect.height()) /
+          (record_rect.width() * record_rect.height());
+      if (!reused_picture->LayerRect().Contains(record_rect) ||
+          invalid_fraction > kMaxInvalidFractionToReusePicture)
+        reused_picture = NULL;
+    }
+
     int repeat_count = std::max(1, slow_down_raster_scale_factor_for_debug_);
     scoped_refptr<Picture> picture;
     int num_raster_threads = RasterWorkerPool::GetNumRasterThreads();
@@ -239,11 +292,21 @@ bool PicturePile::Update(ContentLayerClient* painter,
       base::TimeDelta best_duration = base::TimeDelta::Max();
       for (int i = 0; i < repeat_count; i++) {
         base::TimeTicks start_time = stats_instrumentation->StartRecording();
-        picture = Picture::Create(record_rect,
-                                  painter,
-                                  tile_grid_info_,
-                                  gather_pixel_refs,
-                                  num_raster_threads);
+        if (reused_picture.get()) {
+          picture = Picture::CreateReusingPicture(reused_picture.get(),
+                                                  record_rect,
+                                                  invalid_rect,
+                                                  painter,
+                                                  tile_grid_info_,
+                                                  gather_pixel_refs,
+                                                  num_raster_threads);
+        } else {
+          picture = Picture::Create(record_rect,
+                                    painter,
+                                    tile_grid_info_,
+                                    gather_pixel_refs,
+                                    num_raster_threads);
+        }
         base::TimeDelta duration =
             stats_instrumentation->EndRecording(start_time);
         best_duration = std::min(duration, best_duration);
@@ -255,7 +318,6 @@ bool PicturePile::Update(ContentLayerClient* painter,
 
     bool found_tile_for_recorded_picture = false;
 
-    bool include_borders = true;
     for (TilingData::Iterator it(&tiling_, record_rect, include_borders); it;
          ++it) {
       const PictureMapKey& key = it.index();
@@ -368,6 +368,14 @@ void PicturePileImpl::AnalyzeInRect(
 
   layer_rect.Intersect(gfx::Rect(tiling_.total_size()));
 
+  // Solid cells are analyzed once, and then reused by every tile that they
+  // cover, at every scale.
+  if (GetSolidColorOfCells(layer_rect, true, &analysis->solid_color)) {
+    analysis->is_solid_color = true;
+    analysis->has_text = false;
+    return;
+  }
+
   skia::AnalysisCanvas canvas(layer_rect.width(), layer_rect.height());
 
   RasterForAnalysis(&canvas, layer_rect, 1.0f, stats_instrumentation);
@@ -376,12 +384,49 @@ void PicturePileImpl::AnalyzeInRect(
   analysis->has_text = canvas.HasText();
 }
 
-PicturePileImpl::Analysis::Analysis()
-    : is_solid_color(false),
-      has_text(false) {
+bool PicturePileImpl::GetCachedSolidColorInRect(
+    const gfx::Rect& content_rect,
+    float contents_scale,
+    SkColor* solid_color) {
+  gfx::Rect layer_rect =
+      gfx::ScaleToEnclosingRect(content_rect, 1.f / contents_scale);
+  layer_rect.Intersect(gfx::Rect(tiling_.total_size()));
+  return GetSolidColorOfCells(layer_rect, false, solid_color);
 }
 
-PicturePileImpl::Analysis::~Analysis() {
+bool PicturePileImpl::GetSolidColorOfCells(const gfx::Rect& layer_rect,
+                                           bool analyze,
+                                           SkColor* solid_color) {
+  bool found_cell = false;
+  bool include_borders = true;
+  for (TilingData::Iterator tile_iter(&tiling_, layer_rect, include_borders);
+       tile_iter;
+       ++tile_iter) {
+    PictureMap::const_iterator map_iter = picture_map_.find(tile_iter.index());
+    if (map_iter == picture_map_.end())
+      return false;
+    Picture* picture = map_iter->second.GetPicture();
+
+    // Only the part of the cell inside the layer is ever rastered.
+    gfx::Rect cell_rect = PaddedRect(tile_iter.index());
+    cell_rect.Intersect(gfx::Rect(tiling_.total_size()));
+    if (!picture || !picture->LayerRect().Contains(cell_rect))
+      return false;
+
+    Analysis analysis;
+    if (analyze)
+      picture->AnalyzeInRect(cell_rect, &analysis);
+    else if (!picture->GetCachedAnalysisInRect(cell_rect, &analysis))
+      return false;
+
+    if (!analysis.is_solid_color || analysis.has_text)
+      return false;
+    if (found_cell && analysis.solid_color != *solid_color)
+      return false;
+    *solid_color = analysis.solid_color;
+    found_cell = true;
+  }
+  return found_cell;
 }
 
 PicturePileImpl::PixelRefIterator::PixelRefIterator(
@@ -62,14 +62,7 @@ class CC_EXPORT PicturePileImpl : public PicturePileBase {
 
   skia::RefPtr<SkPicture> GetFlattenedPicture();
 
-  struct CC_EXPORT Analysis {
-    Analysis();
-    ~Analysis();
-
-    bool is_solid_color;
-    bool has_text;
-    SkColor solid_color;
-  };
+  typedef Picture::Analysis Analysis;
 
   void AnalyzeInRect(const gfx::Rect& content_rect,
                      float contents_scale,
@@ -80,6 +73,13 @@ class CC_EXPORT PicturePileImpl : public PicturePileBase {
                      Analysis* analysis,
                      RenderingStatsInstrumentation* stats_instrumentation);
 
+  // Returns true if earlier analyses of the pile cells that |content_rect|
+  // covers show that it is all |solid_color|. Unlike AnalyzeInRect(), this
+  // never analyzes, so it is cheap and safe to call when scheduling tasks.
+  bool GetCachedSolidColorInRect(const gfx::Rect& content_rect,
+                                 float contents_scale,
+                                 SkColor* solid_color);
+
   class CC_EXPORT PixelRefIterator {
    public:
     PixelRefIterator(const gfx::Rect& content_rect,
@@ -129,6 +129,14 @@ class CC_EXPORT PicturePileImpl : public PicturePileBase {
 
  private:
   typedef std::map<Picture*, Region> PictureRegionMap;
+
+  // Returns true if every pile cell that |layer_rect| covers has a recording
+  // that paints the cell with the same color, without text. Cells that
+  // haven't been analyzed yet are analyzed if |analyze| is true, and make
+  // this return false otherwise.
+  bool GetSolidColorOfCells(const gfx::Rect& layer_rect,
+                            bool analyze,
+                            SkColor* solid_color);
   void CoalesceRasters(const gfx::Rect& canvas_rect,
                        const gfx::Rect& content_rect,
                        float contents_scale,
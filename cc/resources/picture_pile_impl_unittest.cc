@@ -147,6 +147,48 @@ TEST(PicturePileImplTest, AnalyzeIsSolidEmpty) {
   EXPECT_EQ(analysis.solid_color, SkColorSetARGB(0, 0, 0, 0));
 }
 
+TEST(PicturePileImplTest, AnalysisIsCachedAcrossScales) {
+  gfx::Size tile_size(100, 100);
+  gfx::Size layer_bounds(400, 400);
+
+  scoped_refptr<FakePicturePileImpl> pile =
+      FakePicturePileImpl::CreateFilledPile(tile_size, layer_bounds);
+
+  SkColor solid_color = SkColorSetARGB(255, 12, 23, 34);
+  SkPaint solid_paint;
+  solid_paint.setColor(solid_color);
+  SkPaint non_solid_paint;
+  non_solid_paint.setColor(SkColorSetARGB(128, 45, 56, 67));
+
+  pile->add_draw_rect_with_paint(gfx::Rect(0, 0, 400, 400), solid_paint);
+  pile->add_draw_rect_with_paint(gfx::Rect(350, 350, 1, 1), non_solid_paint);
+  pile->RerecordPile();
+
+  // Nothing is known before the cells have been analyzed.
+  SkColor color = SK_ColorTRANSPARENT;
+  EXPECT_FALSE(
+      pile->GetCachedSolidColorInRect(gfx::Rect(0, 0, 50, 50), 0.5f, &color));
+
+  PicturePileImpl::Analysis analysis;
+  pile->AnalyzeInRect(gfx::Rect(0, 0, 100, 100), 1.f, &analysis);
+  EXPECT_TRUE(analysis.is_solid_color);
+  EXPECT_EQ(solid_color, analysis.solid_color);
+
+  // Tiles at another scale covering the analyzed cells reuse their analyses.
+  EXPECT_TRUE(
+      pile->GetCachedSolidColorInRect(gfx::Rect(0, 0, 40, 40), 0.5f, &color));
+  EXPECT_EQ(solid_color, color);
+
+  // Tiles covering cells that haven't been analyzed, or that aren't solid,
+  // aren't known to be solid.
+  EXPECT_FALSE(pile->GetCachedSolidColorInRect(
+      gfx::Rect(100, 100, 50, 50), 0.5f, &color));
+  pile->AnalyzeInRect(gfx::Rect(300, 300, 100, 100), 1.f, &analysis);
+  EXPECT_FALSE(analysis.is_solid_color);
+  EXPECT_FALSE(pile->GetCachedSolidColorInRect(
+      gfx::Rect(300, 300, 100, 100), 1.f, &color));
+}
+
 TEST(PicturePileImplTest, PixelRefIteratorEmpty) {
   gfx::Size tile_size(128, 128);
   gfx::Size layer_bounds(256, 256);
@@ -737,6 +779,54 @@ TEST(PicturePileImpl, RasterContentsTransparent) {
   }
 }
 
+// TileManager splits expensive tiles into bands rasterized separately, which
+// must produce the same pixels as rasterizing the whole tile.
+TEST(PicturePileImpl, RasterBandsMatchWholeRaster) {
+  gfx::Size tile_size(100, 100);
+  gfx::Size layer_bounds(300, 300);
+  float contents_scale = 0.873f;
+
+  scoped_refptr<FakePicturePileImpl> pile =
+      FakePicturePileImpl::CreateFilledPile(tile_size, layer_bounds);
+  pile->set_background_color(SK_ColorTRANSPARENT);
+  pile->set_contents_opaque(false);
+  pile->set_clear_canvas_with_debug_color(false);
+  SkPaint paint;
+  paint.setAntiAlias(true);
+  paint.setColor(SkColorSetARGB(255, 45, 56, 67));
+  pile->add_draw_rect_with_paint(gfx::RectF(10.5f, 20.25f, 250.f, 33.3f),
+                                 paint);
+  paint.setColor(SkColorSetARGB(128, 200, 10, 10));
+  pile->add_draw_rect_with_paint(gfx::RectF(40.f, 5.75f, 30.3f, 280.f), paint);
+  pile->RerecordPile();
+
+  gfx::Rect content_rect(10, 10, 200, 200);
+  SkBitmap whole;
+  whole.allocN32Pixels(content_rect.width(), content_rect.height());
+  SkCanvas whole_canvas(whole);
+  pile->RasterToBitmap(&whole_canvas, content_rect, contents_scale, NULL);
+
+  const int kNumBands = 3;
+  for (int i = 0; i < kNumBands; ++i) {
+    int top = content_rect.y() + content_rect.height() * i / kNumBands;
+    int bottom = content_rect.y() + content_rect.height() * (i + 1) / kNumBands;
+    gfx::Rect band_rect(
+        content_rect.x(), top, content_rect.width(), bottom - top);
+    SkBitmap band;
+    band.allocN32Pixels(band_rect.width(), band_rect.height());
+    SkCanvas band_canvas(band);
+    pile->RasterToBitmap(&band_canvas, band_rect, contents_scale, NULL);
+
+    for (int y = 0; y < band.height(); ++y) {
+      for (int x = 0; x < band.width(); ++x) {
+        ASSERT_EQ(whole.getColor(x, band_rect.y() - content_rect.y() + y),
+                  band.getColor(x, y)) << "x: " << x << ", y: " << y
+                                       << ", band: " << i;
+      }
+    }
+  }
+}
+
 class OverlapTest : public ::testing::TestWithParam<float> {
  public:
   static float MinContentsScale() { return 1.f / 4.f; }
@@ -0,0 +1,102 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/resources/picture_pile.h"
+
+#include "base/time/time.h"
+#include "cc/base/region.h"
+#include "cc/test/fake_content_layer_client.h"
+#include "cc/test/fake_rendering_stats_instrumentation.h"
+#include "cc/test/lap_timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace cc {
+namespace {
+
+static const int kTimeLimitMillis = 2000;
+static const int kWarmupRuns = 5;
+static const int kTimeCheckInterval = 10;
+
+static const int kLayerSize = 2048;
+static const int kRectSize = 32;
+
+class PicturePilePerfTest : public testing::Test {
+ public:
+  PicturePilePerfTest()
+      : pile_(new PicturePile()),
+        frame_number_(0),
+        timer_(kWarmupRuns,
+               base::TimeDelta::FromMilliseconds(kTimeLimitMillis),
+               kTimeCheckInterval) {}
+
+  virtual void SetUp() OVERRIDE {
+    pile_->Resize(gfx::Size(kLayerSize, kLayerSize));
+    pile_->SetTileGridSize(gfx::Size(256, 256));
+    pile_->SetMinContentsScale(1.f);
+
+    // Fill the layer with many small rects, so that painting a cell costs
+    // noticeably more than replaying its recording.
+    SkPaint paint;
+    for (int y = 0; y < kLayerSize; y += kRectSize) {
+      for (int x = 0; x < kLayerSize; x += kRectSize) {
+        paint.setColor(SkColorSetARGB(255, x % 256, y % 256, 0));
+        client_.add_draw_rect(
+            gfx::RectF(x + 1, y + 1, kRectSize - 2, kRectSize - 2), paint);
+      }
+    }
+
+    Update(gfx::Rect(pile_->size()));
+  }
+
+  // Measures the time to re-record the pile for |invalidation| each frame,
+  // as for a blinking caret or a small animation when it is small.
+  void RunUpdateTest(const std::string& test_name, const Region& invalidation) {
+    timer_.Reset();
+    do {
+      Update(invalidation);
+      timer_.NextLap();
+    } while (!timer_.HasTimeLimitExpired());
+
+    perf_test::PrintResult(
+        "picture_pile_update", "", test_name, timer_.MsPerLap(), "ms", true);
+  }
+
+ private:
+  void Update(const Region& invalidation) {
+    pile_->Update(&client_,
+                  SK_ColorWHITE,
+                  false,
+                  false,
+                  invalidation,
+                  gfx::Rect(pile_->size()),
+                  ++frame_number_,
+                  &stats_instrumentation_);
+  }
+
+  FakeContentLayerClient client_;
+  FakeRenderingStatsInstrumentation stats_instrumentation_;
+  scoped_refptr<PicturePile> pile_;
+  int frame_number_;
+  LapTimer timer_;
+};
+
+TEST_F(PicturePilePerfTest, UpdateCaret) {
+  RunUpdateTest("caret", gfx::Rect(300, 300, 2, 20));
+}
+
+TEST_F(PicturePilePerfTest, UpdateSmallRect) {
+  RunUpdateTest("small_rect", gfx::Rect(300, 300, 64, 64));
+}
+
+TEST_F(PicturePilePerfTest, UpdateCell) {
+  RunUpdateTest("cell", gfx::Rect(512, 512, 512, 512));
+}
+
+TEST_F(PicturePilePerfTest, UpdateWholeLayer) {
+  RunUpdateTest("whole_layer", gfx::Rect(kLayerSize, kLayerSize));
+}
+
+}  // namespace
+}  // namespace cc
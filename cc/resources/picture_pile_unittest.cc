@@ -301,6 +301,34 @@ TEST_F(PicturePileTest, FrequentInvalidationCanRaster) {
   EXPECT_FALSE(pile_->CanRasterSlowTileCheck(tile02_noborders));
 }
 
+TEST_F(PicturePileTest, SmallInvalidateReusesPicture) {
+  UpdateWholeLayer();
+
+  TestPicturePile::PictureInfo& picture_info =
+      pile_->picture_map().find(TestPicturePile::PictureMapKey(0, 0))->second;
+  EXPECT_EQ(0, picture_info.GetPicture()->reuse_depth());
+
+  // Small invalidations replay the previous picture, up to a limited depth.
+  gfx::Rect invalidate_rect(50, 50, 1, 1);
+  int max_reuse_depth = 0;
+  for (int i = 0; i < 10; ++i) {
+    Update(invalidate_rect, layer_rect());
+    int reuse_depth = picture_info.GetPicture()->reuse_depth();
+    if (reuse_depth == 0)
+      break;
+    EXPECT_EQ(max_reuse_depth + 1, reuse_depth);
+    max_reuse_depth = reuse_depth;
+  }
+  EXPECT_LT(0, max_reuse_depth);
+  EXPECT_EQ(0, picture_info.GetPicture()->reuse_depth());
+
+  // Large invalidations are repainted.
+  Update(invalidate_rect, layer_rect());
+  EXPECT_EQ(1, picture_info.GetPicture()->reuse_depth());
+  UpdateWholeLayer();
+  EXPECT_EQ(0, picture_info.GetPicture()->reuse_depth());
+}
+
 TEST_F(PicturePileTest, NoInvalidationValidViewport) {
   // This test validates that the recorded_viewport cache of full tiles
   // is still valid for some use cases.  If it's not, it's a performance
@@ -415,5 +415,52 @@ TEST(PictureTest, CreateFromSkpValue) {
   EXPECT_EQ(100, one_rect_picture_check->OpaqueRect().width());
   EXPECT_EQ(200, one_rect_picture_check->OpaqueRect().height());
 }
+
+TEST(PictureTest, CreateReusingPicture) {
+  SkGraphics::Init();
+
+  gfx::Rect layer_rect(100, 100);
+
+  SkTileGridPicture::TileGridInfo tile_grid_info;
+  tile_grid_info.fTileInterval = SkISize::Make(100, 100);
+  tile_grid_info.fMargin.setEmpty();
+  tile_grid_info.fOffset.setZero();
+
+  FakeContentLayerClient content_layer_client;
+
+  SkPaint red_paint;
+  red_paint.setColor(SkColorSetARGB(255, 255, 0, 0));
+  SkPaint green_paint;
+  green_paint.setColor(SkColorSetARGB(255, 0, 255, 0));
+
+  content_layer_client.add_draw_rect(layer_rect, red_paint);
+  scoped_refptr<Picture> one_rect_picture = Picture::Create(
+      layer_rect, &content_layer_client, tile_grid_info, false, 0);
+  EXPECT_EQ(0, one_rect_picture->reuse_depth());
+
+  // Only the invalid rect is painted again; the rest comes from the reused
+  // picture, so the result matches a full recording.
+  gfx::Rect invalid_rect(25, 25, 50, 50);
+  content_layer_client.add_draw_rect(invalid_rect, green_paint);
+  scoped_refptr<Picture> reusing_picture =
+      Picture::CreateReusingPicture(one_rect_picture.get(),
+                                    layer_rect,
+                                    invalid_rect,
+                                    &content_layer_client,
+                                    tile_grid_info,
+                                    false,
+                                    0);
+  scoped_refptr<Picture> two_rect_picture = Picture::Create(
+      layer_rect, &content_layer_client, tile_grid_info, false, 0);
+  EXPECT_EQ(1, reusing_picture->reuse_depth());
+  EXPECT_EQ(layer_rect, reusing_picture->LayerRect());
+  EXPECT_EQ(two_rect_picture->OpaqueRect(), reusing_picture->OpaqueRect());
+
+  unsigned char reusing_buffer[4 * 100 * 100] = {0};
+  DrawPicture(reusing_buffer, layer_rect, reusing_picture);
+  unsigned char two_rect_buffer[4 * 100 * 100] = {0};
+  DrawPicture(two_rect_buffer, layer_rect, two_rect_picture);
+  EXPECT_TRUE(memcmp(reusing_buffer, two_rect_buffer, 4 * 100 * 100) == 0);
+}
 }  // namespace
 }  // namespace cc
@@ -34,29 +34,41 @@ class BinComparator {
     gfx::Rect b_rect = b->content_rect();
     if (a_rect.y() != b_rect.y())
       return a_rect.y() < b_rect.y();
-    return a_rect.x() < b_rect.x();
+    if (a_rect.x() != b_rect.x())
+      return a_rect.x() < b_rect.x();
+
+    // Break ties by id so that the order doesn't depend on how the tiles
+    // were inserted or taken off the heap.
+    return a->id() < b->id();
   }
 };
 
 namespace {
 
-typedef std::vector<Tile*> TileVector;
+// Orders the heap of a bin so that the tile that BinComparator puts first is
+// on top.
+class HeapComparator {
+ public:
+  bool operator()(const Tile* a, const Tile* b) const {
+    return BinComparator()(b, a);
+  }
+};
 
-void SortBinTiles(ManagedTileBin bin, TileVector* tiles) {
+bool IsBinOrdered(ManagedTileBin bin) {
   switch (bin) {
     case NOW_AND_READY_TO_DRAW_BIN:
     case NEVER_BIN:
-      break;
+      return false;
     case NOW_BIN:
     case SOON_BIN:
     case EVENTUALLY_AND_ACTIVE_BIN:
     case EVENTUALLY_BIN:
     case AT_LAST_AND_ACTIVE_BIN:
     case AT_LAST_BIN:
-      std::sort(tiles->begin(), tiles->end(), BinComparator());
-      break;
+      return true;
     default:
       NOTREACHED();
+      return false;
   }
 }
 
@@ -64,39 +76,66 @@ void SortBinTiles(ManagedTileBin bin, TileVector* tiles) {
 
 PrioritizedTileSet::PrioritizedTileSet() {
   for (int bin = 0; bin < NUM_BINS; ++bin)
-    bin_sorted_[bin] = true;
+    bin_is_heap_[bin] = false;
 }
 
 PrioritizedTileSet::~PrioritizedTileSet() {}
 
 void PrioritizedTileSet::InsertTile(Tile* tile, ManagedTileBin bin) {
-  tiles_[bin].push_back(tile);
-  bin_sorted_[bin] = false;
+  // A new tile may go before the tiles already taken off the heap, so they
+  // have to go back on it.
+  std::vector<Tile*>& ordered = ordered_tiles_[bin];
+  std::vector<Tile*>& heap = tiles_[bin];
+  if (!ordered.empty()) {
+    heap.insert(heap.end(), ordered.begin(), ordered.end());
+    ordered.clear();
+    bin_is_heap_[bin] = false;
+  }
+
+  heap.push_back(tile);
+  if (bin_is_heap_[bin])
+    std::push_heap(heap.begin(), heap.end(), HeapComparator());
 }
 
 void PrioritizedTileSet::Clear() {
   for (int bin = 0; bin < NUM_BINS; ++bin) {
+    ordered_tiles_[bin].clear();
     tiles_[bin].clear();
-    bin_sorted_[bin] = true;
+    bin_is_heap_[bin] = false;
   }
 }
 
-void PrioritizedTileSet::SortBinIfNeeded(ManagedTileBin bin) {
-  if (!bin_sorted_[bin]) {
-    SortBinTiles(bin, &tiles_[bin]);
-    bin_sorted_[bin] = true;
+Tile* PrioritizedTileSet::TileAt(ManagedTileBin bin,
+                                 size_t index,
+                                 bool use_priority_ordering) {
+  std::vector<Tile*>& ordered = ordered_tiles_[bin];
+  std::vector<Tile*>& heap = tiles_[bin];
+  DCHECK_LT(index, ordered.size() + heap.size());
+
+  if (use_priority_ordering && index >= ordered.size() && IsBinOrdered(bin)) {
+    if (!bin_is_heap_[bin]) {
+      std::make_heap(heap.begin(), heap.end(), HeapComparator());
+      bin_is_heap_[bin] = true;
+    }
+    while (ordered.size() <= index) {
+      std::pop_heap(heap.begin(), heap.end(), HeapComparator());
+      ordered.push_back(heap.back());
+      heap.pop_back();
+    }
   }
+
+  if (index < ordered.size())
+    return ordered[index];
+  return heap[index - ordered.size()];
 }
 
 PrioritizedTileSet::Iterator::Iterator(
     PrioritizedTileSet* tile_set, bool use_priority_ordering)
     : tile_set_(tile_set),
       current_bin_(NOW_AND_READY_TO_DRAW_BIN),
+      index_(0),
       use_priority_ordering_(use_priority_ordering) {
-  if (use_priority_ordering_)
-    tile_set_->SortBinIfNeeded(current_bin_);
-  iterator_ = tile_set->tiles_[current_bin_].begin();
-  if (iterator_ == tile_set_->tiles_[current_bin_].end())
+  if (!*this)
     AdvanceList();
 }
 
@@ -109,30 +148,26 @@ void PrioritizedTileSet::Iterator::DisablePriorityOrdering() {
 PrioritizedTileSet::Iterator&
 PrioritizedTileSet::Iterator::operator++() {
   // We can't increment past the end of the tiles.
-  DCHECK(iterator_ != tile_set_->tiles_[current_bin_].end());
+  DCHECK(*this);
 
-  ++iterator_;
-  if (iterator_ == tile_set_->tiles_[current_bin_].end())
+  ++index_;
+  if (!*this)
     AdvanceList();
   return *this;
 }
 
 Tile* PrioritizedTileSet::Iterator::operator*() {
-  DCHECK(iterator_ != tile_set_->tiles_[current_bin_].end());
-  return *iterator_;
+  DCHECK(*this);
+  return tile_set_->TileAt(current_bin_, index_, use_priority_ordering_);
 }
 
 void PrioritizedTileSet::Iterator::AdvanceList() {
-  DCHECK(iterator_ == tile_set_->tiles_[current_bin_].end());
+  DCHECK(!*this);
 
   while (current_bin_ != NEVER_BIN) {
     current_bin_ = static_cast<ManagedTileBin>(current_bin_ + 1);
-
-    if (use_priority_ordering_)
-      tile_set_->SortBinIfNeeded(current_bin_);
-
-    iterator_ = tile_set_->tiles_[current_bin_].begin();
-    if (iterator_ != tile_set_->tiles_[current_bin_].end())
+    index_ = 0;
+    if (*this)
       break;
   }
 }
@@ -33,7 +33,7 @@ class CC_EXPORT PrioritizedTileSet {
     Tile* operator->() { return *(*this); }
     Tile* operator*();
     operator bool() const {
-      return iterator_ != tile_set_->tiles_[current_bin_].end();
+      return index_ < tile_set_->TileCount(current_bin_);
     }
 
    private:
@@ -41,17 +41,29 @@ class CC_EXPORT PrioritizedTileSet {
 
     PrioritizedTileSet* tile_set_;
     ManagedTileBin current_bin_;
-    std::vector<Tile*>::iterator iterator_;
+    size_t index_;
     bool use_priority_ordering_;
   };
 
  private:
   friend class Iterator;
 
-  void SortBinIfNeeded(ManagedTileBin bin);
+  size_t TileCount(ManagedTileBin bin) const {
+    return ordered_tiles_[bin].size() + tiles_[bin].size();
+  }
 
+  // Returns the tile at |index| in |bin|. With |use_priority_ordering|, tiles
+  // are taken off the bin's heap until the tiles up to |index| are in priority
+  // order, so only the part of a bin that is actually visited gets ordered.
+  Tile* TileAt(ManagedTileBin bin, size_t index, bool use_priority_ordering);
+
+  // The tiles of each bin that have already been taken off the heap, in
+  // priority order.
+  std::vector<Tile*> ordered_tiles_[NUM_BINS];
+  // The rest of the tiles of each bin, in insertion order until the bin is
+  // first visited in priority order and a heap after that.
   std::vector<Tile*> tiles_[NUM_BINS];
-  bool bin_sorted_[NUM_BINS];
+  bool bin_is_heap_[NUM_BINS];
 };
 
 }  // namespace cc
@@ -42,7 +42,9 @@ class BinComparator {
     gfx::Rect b_rect = b->content_rect();
     if (a_rect.y() != b_rect.y())
       return a_rect.y() < b_rect.y();
-    return a_rect.x() < b_rect.x();
+    if (a_rect.x() != b_rect.x())
+      return a_rect.x() < b_rect.x();
+    return a->id() < b->id();
   }
 };
 
@@ -529,7 +531,8 @@ TEST_F(PrioritizedTileSetTest, ManyTilesForEachBin) {
 TEST_F(PrioritizedTileSetTest, ManyTilesForEachBinDisablePriority) {
   // Aggregate test with many tiles for each of the bins. Tiles should
   // appear in order, until DisablePriorityOrdering is called. After that
-  // tiles should appear in the order they were inserted.
+  // tiles of bins that haven't been visited yet should appear in the order
+  // they were inserted.
 
   std::vector<scoped_refptr<Tile> > now_and_ready_to_draw_bins;
   std::vector<scoped_refptr<Tile> > now_bins;
@@ -596,13 +599,11 @@ TEST_F(PrioritizedTileSetTest, ManyTilesForEachBinDisablePriority) {
     ++it;
   }
 
-  // After we disable priority ordering, we already have sorted the next vector.
+  // Tiles are only ordered as they are visited, so none of the next bin has
+  // been ordered yet when we disable priority ordering.
   it.DisablePriorityOrdering();
 
-  // Eventually and active bins are sorted.
-  std::sort(eventually_and_active_bins.begin(),
-            eventually_and_active_bins.end(),
-            BinComparator());
+  // Eventually and active bins are not sorted.
   for (vector_it = eventually_and_active_bins.begin();
        vector_it != eventually_and_active_bins.end();
        ++vector_it) {
@@ -635,6 +636,58 @@ TEST_F(PrioritizedTileSetTest, ManyTilesForEachBinDisablePriority) {
   EXPECT_FALSE(it);
 }
 
+TEST_F(PrioritizedTileSetTest, DisablePriorityInsideBin) {
+  // Disabling priority ordering in the middle of a bin leaves the tiles
+  // visited so far in order, and the rest of the bin comes unordered.
+
+  std::vector<scoped_refptr<Tile> > now_bins;
+  TilePriority priorities[4] = {
+      TilePriorityForEventualBin(),
+      TilePriorityForNowBin(),
+      TilePriority(),
+      TilePriorityForSoonBin()};
+
+  PrioritizedTileSet set;
+  for (int i = 0; i < 5; ++i) {
+    for (int priority = 0; priority < 4; ++priority) {
+      scoped_refptr<Tile> tile = CreateTile();
+      tile->SetPriority(ACTIVE_TREE, priorities[priority]);
+      tile->SetPriority(PENDING_TREE, priorities[priority]);
+      now_bins.push_back(tile);
+      set.InsertTile(tile, NOW_BIN);
+    }
+  }
+  std::sort(now_bins.begin(), now_bins.end(), BinComparator());
+
+  const size_t kOrderedCount = 7;
+  PrioritizedTileSet::Iterator it(&set, true);
+  for (size_t i = 0; i < kOrderedCount; ++i) {
+    EXPECT_TRUE(now_bins[i] == *it);
+    ++it;
+  }
+
+  it.DisablePriorityOrdering();
+
+  std::vector<Tile*> remaining_tiles;
+  for (; it; ++it)
+    remaining_tiles.push_back(*it);
+  std::vector<Tile*> expected_tiles;
+  for (size_t i = kOrderedCount; i < now_bins.size(); ++i)
+    expected_tiles.push_back(now_bins[i].get());
+  std::sort(remaining_tiles.begin(), remaining_tiles.end());
+  std::sort(expected_tiles.begin(), expected_tiles.end());
+  EXPECT_TRUE(remaining_tiles == expected_tiles);
+
+  // A later ordered iteration orders the rest of the bin.
+  std::vector<scoped_refptr<Tile> >::iterator vector_it;
+  PrioritizedTileSet::Iterator second_it(&set, true);
+  for (vector_it = now_bins.begin(); vector_it != now_bins.end(); ++vector_it) {
+    EXPECT_TRUE(*vector_it == *second_it);
+    ++second_it;
+  }
+  EXPECT_FALSE(second_it);
+}
+
 TEST_F(PrioritizedTileSetTest, TilesForFirstAndLastBins) {
   // Make sure that if we have empty lists between two non-empty lists,
   // we just get two tiles from the iterator.
@@ -4,6 +4,10 @@
 
 #include "cc/resources/raster_worker_pool.h"
 
+#include <algorithm>
+#include <map>
+#include <vector>
+
 #include "base/time/time.h"
 #include "cc/output/context_provider.h"
 #include "cc/resources/direct_raster_worker_pool.h"
@@ -19,21 +23,73 @@
 #include "cc/test/test_web_graphics_context_3d.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/perf/perf_test.h"
+#include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/khronos/GLES2/gl2.h"
 
 namespace cc {
 namespace {
 
+// Backs mapped pixel buffers and images with memory, so that raster tasks can
+// write to them, and copies pixel buffers on upload as the GPU process would.
 class PerfGLES2Interface : public gpu::gles2::GLES2InterfaceStub {
+ public:
+  PerfGLES2Interface() : next_id_(1u), bound_buffer_(0u) {}
+
   // Overridden from gpu::gles2::GLES2Interface:
   virtual GLuint CreateImageCHROMIUM(GLsizei width,
                                      GLsizei height,
                                      GLenum internalformat) OVERRIDE {
-    return 1u;
+    GLuint image_id = next_id_++;
+    images_[image_id].resize(4 * width * height);
+    return image_id;
+  }
+  virtual void DestroyImageCHROMIUM(GLuint image_id) OVERRIDE {
+    images_.erase(image_id);
+  }
+  virtual void* MapImageCHROMIUM(GLuint image_id, GLenum access) OVERRIDE {
+    return Data(&images_[image_id]);
   }
   virtual void GenBuffers(GLsizei n, GLuint* buffers) OVERRIDE {
     for (GLsizei i = 0; i < n; ++i)
-      buffers[i] = 1u;
+      buffers[i] = next_id_++;
+  }
+  virtual void DeleteBuffers(GLsizei n, const GLuint* buffers) OVERRIDE {
+    for (GLsizei i = 0; i < n; ++i)
+      buffers_.erase(buffers[i]);
+  }
+  virtual void BindBuffer(GLenum target, GLuint buffer) OVERRIDE {
+    bound_buffer_ = buffer;
+  }
+  virtual void BufferData(GLenum target,
+                          GLsizeiptr size,
+                          const void* data,
+                          GLenum usage) OVERRIDE {
+    buffers_[bound_buffer_].resize(size);
+  }
+  virtual void* MapBufferCHROMIUM(GLuint target, GLenum access) OVERRIDE {
+    return Data(&buffers_[bound_buffer_]);
+  }
+  virtual void AsyncTexImage2DCHROMIUM(GLenum target,
+                                       GLint level,
+                                       GLint internalformat,
+                                       GLsizei width,
+                                       GLsizei height,
+                                       GLint border,
+                                       GLenum format,
+                                       GLenum type,
+                                       const void* pixels) OVERRIDE {
+    Upload();
+  }
+  virtual void AsyncTexSubImage2DCHROMIUM(GLenum target,
+                                          GLint level,
+                                          GLint xoffset,
+                                          GLint yoffset,
+                                          GLsizei width,
+                                          GLsizei height,
+                                          GLenum format,
+                                          GLenum type,
+                                          const void* data) OVERRIDE {
+    Upload();
   }
   virtual void GenTextures(GLsizei n, GLuint* textures) OVERRIDE {
     for (GLsizei i = 0; i < n; ++i)
@@ -43,6 +99,26 @@ class PerfGLES2Interface : public gpu::gles2::GLES2InterfaceStub {
     if (pname == GL_MAX_TEXTURE_SIZE)
       *params = INT_MAX;
   }
+
+ private:
+  typedef std::vector<uint8_t> Memory;
+
+  static uint8_t* Data(Memory* memory) {
+    return memory->empty() ? NULL : &(*memory)[0];
+  }
+
+  // Copies the bound pixel buffer into texture memory.
+  void Upload() {
+    const Memory& buffer = buffers_[bound_buffer_];
+    texture_.resize(buffer.size());
+    std::copy(buffer.begin(), buffer.end(), texture_.begin());
+  }
+
+  GLuint next_id_;
+  GLuint bound_buffer_;
+  std::map<GLuint, Memory> buffers_;
+  std::map<GLuint, Memory> images_;
+  Memory texture_;
 };
 
 class PerfContextProvider : public ContextProvider {
@@ -80,6 +156,10 @@ static const int kTimeLimitMillis = 2000;
 static const int kWarmupRuns = 5;
 static const int kTimeCheckInterval = 10;
 
+// Size of the resources rastered by the RasterTiles test. Other tests use 1x1
+// resources, so that they measure the worker pool's own overhead.
+static const int kTileSize = 256;
+
 class PerfWorkerPoolTaskImpl : public internal::WorkerPoolTask {
  public:
   PerfWorkerPoolTaskImpl() {}
@@ -112,19 +192,21 @@ class PerfRasterWorkerPoolTaskImpl : public internal::RasterWorkerPoolTask {
   PerfRasterWorkerPoolTaskImpl(scoped_ptr<ScopedResource> resource,
                                internal::WorkerPoolTask::Vector* dependencies)
       : internal::RasterWorkerPoolTask(resource.get(), dependencies),
-        resource_(resource.Pass()) {}
+        resource_(resource.Pass()),
+        canvas_(NULL) {}
 
   // Overridden from internal::Task:
-  virtual void RunOnWorkerThread() OVERRIDE {}
+  virtual void RunOnWorkerThread() OVERRIDE { Raster(); }
 
   // Overridden from internal::WorkerPoolTask:
   virtual void ScheduleOnOriginThread(internal::WorkerPoolTaskClient* client)
       OVERRIDE {
-    client->AcquireCanvasForRaster(this, resource());
+    canvas_ = client->AcquireCanvasForRaster(this, resource());
   }
-  virtual void RunOnOriginThread() OVERRIDE {}
+  virtual void RunOnOriginThread() OVERRIDE { Raster(); }
   virtual void CompleteOnOriginThread(internal::WorkerPoolTaskClient* client)
       OVERRIDE {
+    canvas_ = NULL;
     client->ReleaseCanvasForRaster(this, resource());
   }
   virtual void RunReplyOnOriginThread() OVERRIDE { Reset(); }
@@ -138,7 +220,14 @@ class PerfRasterWorkerPoolTaskImpl : public internal::RasterWorkerPoolTask {
   virtual ~PerfRasterWorkerPoolTaskImpl() {}
 
  private:
+  // Writes every pixel of the resource, as rastering an opaque tile would.
+  void Raster() {
+    if (canvas_)
+      canvas_->drawColor(SK_ColorWHITE);
+  }
+
   scoped_ptr<ScopedResource> resource_;
+  SkCanvas* canvas_;
 
   DISALLOW_COPY_AND_ASSIGN(PerfRasterWorkerPoolTaskImpl);
 };
@@ -204,9 +293,8 @@ class RasterWorkerPoolPerfTestBase {
   void CreateRasterTasks(
       unsigned num_raster_tasks,
       const internal::WorkerPoolTask::Vector& image_decode_tasks,
+      const gfx::Size& size,
       RasterTaskVector* raster_tasks) {
-    const gfx::Size size(1, 1);
-
     for (unsigned i = 0; i < num_raster_tasks; ++i) {
       scoped_ptr<ScopedResource> resource(
           ScopedResource::Create(resource_provider_.get()));
@@ -291,7 +379,8 @@ class RasterWorkerPoolPerfTest
     internal::WorkerPoolTask::Vector image_decode_tasks;
     RasterTaskVector raster_tasks;
     CreateImageDecodeTasks(num_image_decode_tasks, &image_decode_tasks);
-    CreateRasterTasks(num_raster_tasks, image_decode_tasks, &raster_tasks);
+    CreateRasterTasks(
+        num_raster_tasks, image_decode_tasks, gfx::Size(1, 1), &raster_tasks);
 
     // Avoid unnecessary heap allocations by reusing the same queue.
     RasterTaskQueue queue;
@@ -325,8 +414,10 @@ class RasterWorkerPoolPerfTest
     RasterTaskVector raster_tasks[kNumVersions];
     for (size_t i = 0; i < kNumVersions; ++i) {
       CreateImageDecodeTasks(num_image_decode_tasks, &image_decode_tasks[i]);
-      CreateRasterTasks(
-          num_raster_tasks, image_decode_tasks[i], &raster_tasks[i]);
+      CreateRasterTasks(num_raster_tasks,
+                        image_decode_tasks[i],
+                        gfx::Size(1, 1),
+                        &raster_tasks[i]);
     }
 
     // Avoid unnecessary heap allocations by reusing the same queue.
@@ -358,10 +449,36 @@ class RasterWorkerPoolPerfTest
   void RunScheduleAndExecuteTasksTest(const std::string& test_name,
                                       unsigned num_raster_tasks,
                                       unsigned num_image_decode_tasks) {
+    RunScheduleAndExecuteTasksTest("schedule_and_execute_tasks",
+                                   test_name,
+                                   num_raster_tasks,
+                                   num_image_decode_tasks,
+                                   gfx::Size(1, 1));
+  }
+
+  // Like RunScheduleAndExecuteTasksTest(), but each task writes a whole tile,
+  // which then has to be uploaded unless the worker pool rasters directly
+  // into memory that the compositor can use as a texture.
+  void RunRasterTilesTest(const std::string& test_name,
+                          unsigned num_raster_tasks) {
+    RunScheduleAndExecuteTasksTest(
+        "raster_tiles",
+        test_name,
+        num_raster_tasks,
+        0,
+        gfx::Size(kTileSize, kTileSize));
+  }
+
+  void RunScheduleAndExecuteTasksTest(const std::string& measurement,
+                                      const std::string& test_name,
+                                      unsigned num_raster_tasks,
+                                      unsigned num_image_decode_tasks,
+                                      const gfx::Size& size) {
     internal::WorkerPoolTask::Vector image_decode_tasks;
     RasterTaskVector raster_tasks;
     CreateImageDecodeTasks(num_image_decode_tasks, &image_decode_tasks);
-    CreateRasterTasks(num_raster_tasks, image_decode_tasks, &raster_tasks);
+    CreateRasterTasks(
+        num_raster_tasks, image_decode_tasks, size, &raster_tasks);
 
     // Avoid unnecessary heap allocations by reusing the same queue.
     RasterTaskQueue queue;
@@ -379,7 +496,7 @@ class RasterWorkerPoolPerfTest
     raster_worker_pool_->ScheduleTasks(&empty);
     RunMessageLoopUntilAllTasksHaveCompleted();
 
-    perf_test::PrintResult("schedule_and_execute_tasks",
+    perf_test::PrintResult(measurement,
                            TestModifierString(),
                            test_name,
                            timer_.LapsPerSecond(),
@@ -432,6 +549,11 @@ TEST_P(RasterWorkerPoolPerfTest, ScheduleAndExecuteTasks) {
   RunScheduleAndExecuteTasksTest("32_4", 32, 4);
 }
 
+TEST_P(RasterWorkerPoolPerfTest, RasterTiles) {
+  RunRasterTilesTest("1", 1);
+  RunRasterTilesTest("32", 32);
+}
+
 INSTANTIATE_TEST_CASE_P(RasterWorkerPoolPerfTests,
                         RasterWorkerPoolPerfTest,
                         ::testing::Values(RASTER_WORKER_POOL_TYPE_PIXEL_BUFFER,
@@ -447,7 +569,8 @@ class RasterWorkerPoolCommonPerfTest : public RasterWorkerPoolPerfTestBase,
     internal::WorkerPoolTask::Vector image_decode_tasks;
     RasterTaskVector raster_tasks;
     CreateImageDecodeTasks(num_image_decode_tasks, &image_decode_tasks);
-    CreateRasterTasks(num_raster_tasks, image_decode_tasks, &raster_tasks);
+    CreateRasterTasks(
+        num_raster_tasks, image_decode_tasks, gfx::Size(1, 1), &raster_tasks);
 
     // Avoid unnecessary heap allocations by reusing the same queue.
     RasterTaskQueue queue;
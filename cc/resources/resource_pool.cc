@@ -4,6 +4,7 @@
 
 #include "cc/resources/resource_pool.h"
 
+#include "base/values.h"
 #include "cc/resources/resource_provider.h"
 #include "cc/resources/scoped_resource.h"
 
@@ -20,7 +21,10 @@ ResourcePool::ResourcePool(ResourceProvider* resource_provider,
       max_resource_count_(0),
       memory_usage_bytes_(0),
       unused_memory_usage_bytes_(0),
-      resource_count_(0) {}
+      resource_count_(0),
+      reused_resource_count_(0),
+      allocated_resource_count_(0),
+      evicted_resource_count_(0) {}
 
 ResourcePool::~ResourcePool() {
   while (!busy_resources_.empty()) {
@@ -48,9 +52,16 @@ scoped_ptr<ScopedResource> ResourcePool::AcquireResource(
 
     unused_resources_.erase(it);
     unused_memory_usage_bytes_ -= resource->bytes();
+    ++reused_resource_count_;
     return make_scoped_ptr(resource);
   }
 
+  // Free the unused resources that the new one pushes over the limits before
+  // allocating it, rather than at the next ReduceResourceUsage(). This keeps
+  // the peak usage within the limits, and lets the driver recycle their
+  // memory for the new texture.
+  EvictUnusedResources(Resource::MemorySizeBytes(size, format_));
+
   // Create new resource.
   scoped_ptr<ScopedResource> resource =
       ScopedResource::Create(resource_provider_);
@@ -63,6 +74,7 @@ scoped_ptr<ScopedResource> ResourcePool::AcquireResource(
 
   memory_usage_bytes_ += resource->bytes();
   ++resource_count_;
+  ++allocated_resource_count_;
   return resource.Pass();
 }
 
@@ -81,8 +93,15 @@ void ResourcePool::SetResourceUsageLimits(size_t max_memory_usage_bytes,
 }
 
 void ResourcePool::ReduceResourceUsage() {
+  EvictUnusedResources(0);
+}
+
+void ResourcePool::EvictUnusedResources(size_t additional_bytes) {
   while (!unused_resources_.empty()) {
-    if (!ResourceUsageTooHigh())
+    if (!ResourceUsageTooHigh() &&
+        (!additional_bytes ||
+         (resource_count_ < max_resource_count_ &&
+          memory_usage_bytes_ + additional_bytes <= max_memory_usage_bytes_)))
       break;
 
     // LRU eviction pattern. Most recently used might be blocked by
@@ -97,6 +116,7 @@ void ResourcePool::ReduceResourceUsage() {
     memory_usage_bytes_ -= resource->bytes();
     unused_memory_usage_bytes_ -= resource->bytes();
     --resource_count_;
+    ++evicted_resource_count_;
     delete resource;
   }
 }
@@ -126,6 +146,18 @@ void ResourcePool::CheckBusyResources() {
   }
 }
 
+scoped_ptr<base::Value> ResourcePool::AsValue() const {
+  scoped_ptr<base::DictionaryValue> state(new base::DictionaryValue());
+  state->SetInteger("resource_count", resource_count_);
+  state->SetInteger("unused_resource_count", unused_resources_.size());
+  state->SetInteger("memory_usage_bytes", memory_usage_bytes_);
+  state->SetInteger("unused_memory_usage_bytes", unused_memory_usage_bytes_);
+  state->SetInteger("reused_resource_count", reused_resource_count_);
+  state->SetInteger("allocated_resource_count", allocated_resource_count_);
+  state->SetInteger("evicted_resource_count", evicted_resource_count_);
+  return state.PassAs<base::Value>();
+}
+
 void ResourcePool::DidFinishUsingResource(ScopedResource* resource) {
   unused_memory_usage_bytes_ += resource->bytes();
   unused_resources_.push_back(resource);
@@ -13,6 +13,10 @@
 #include "cc/resources/resource.h"
 #include "cc/resources/resource_format.h"
 
+namespace base {
+class Value;
+}
+
 namespace cc {
 class ScopedResource;
 
@@ -44,6 +48,15 @@ class CC_EXPORT ResourcePool {
     return resource_count_ - unused_resources_.size();
   }
 
+  // How often AcquireResource() recycled an unused resource or had to
+  // allocate a new one, and how many unused resources were freed to stay
+  // within the usage limits.
+  size_t reused_resource_count() const { return reused_resource_count_; }
+  size_t allocated_resource_count() const { return allocated_resource_count_; }
+  size_t evicted_resource_count() const { return evicted_resource_count_; }
+
+  scoped_ptr<base::Value> AsValue() const;
+
  protected:
   ResourcePool(ResourceProvider* resource_provider,
                GLenum target,
@@ -52,6 +65,9 @@ class CC_EXPORT ResourcePool {
   bool ResourceUsageTooHigh();
 
  private:
+  // Frees least recently used unused resources until the usage, plus
+  // |additional_bytes| in one more resource, is within the limits.
+  void EvictUnusedResources(size_t additional_bytes);
   void DidFinishUsingResource(ScopedResource* resource);
 
   ResourceProvider* resource_provider_;
@@ -63,6 +79,9 @@ class CC_EXPORT ResourcePool {
   size_t memory_usage_bytes_;
   size_t unused_memory_usage_bytes_;
   size_t resource_count_;
+  size_t reused_resource_count_;
+  size_t allocated_resource_count_;
+  size_t evicted_resource_count_;
 
   typedef std::list<ScopedResource*> ResourceList;
   ResourceList unused_resources_;
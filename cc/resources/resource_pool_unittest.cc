@@ -0,0 +1,101 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/resources/resource_pool.h"
+
+#include "cc/resources/resource_provider.h"
+#include "cc/resources/scoped_resource.h"
+#include "cc/test/fake_output_surface.h"
+#include "cc/test/fake_output_surface_client.h"
+#include "cc/test/test_shared_bitmap_manager.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace cc {
+namespace {
+
+class ResourcePoolTest : public testing::Test {
+ public:
+  virtual void SetUp() OVERRIDE {
+    output_surface_ = FakeOutputSurface::Create3d();
+    CHECK(output_surface_->BindToClient(&output_surface_client_));
+
+    shared_bitmap_manager_.reset(new TestSharedBitmapManager());
+    resource_provider_ = ResourceProvider::Create(
+        output_surface_.get(), shared_bitmap_manager_.get(), 0, false, 1);
+    resource_pool_ = ResourcePool::Create(
+        resource_provider_.get(), GL_TEXTURE_2D, RGBA_8888);
+  }
+
+  // Releases |resource| and makes it available for reuse.
+  void ReleaseAndRecycle(scoped_ptr<ScopedResource> resource) {
+    resource_pool_->ReleaseResource(resource.Pass());
+    resource_pool_->CheckBusyResources();
+  }
+
+ protected:
+  FakeOutputSurfaceClient output_surface_client_;
+  scoped_ptr<FakeOutputSurface> output_surface_;
+  scoped_ptr<SharedBitmapManager> shared_bitmap_manager_;
+  scoped_ptr<ResourceProvider> resource_provider_;
+  scoped_ptr<ResourcePool> resource_pool_;
+};
+
+TEST_F(ResourcePoolTest, ReusesResourceOfSameSize) {
+  gfx::Size size(100, 100);
+  size_t bytes = Resource::MemorySizeBytes(size, RGBA_8888);
+  resource_pool_->SetResourceUsageLimits(2 * bytes, 2 * bytes, 2);
+
+  scoped_ptr<ScopedResource> resource = resource_pool_->AcquireResource(size);
+  ResourceProvider::ResourceId id = resource->id();
+  ReleaseAndRecycle(resource.Pass());
+
+  resource = resource_pool_->AcquireResource(size);
+  EXPECT_EQ(id, resource->id());
+  EXPECT_EQ(1u, resource_pool_->allocated_resource_count());
+  EXPECT_EQ(1u, resource_pool_->reused_resource_count());
+  EXPECT_EQ(0u, resource_pool_->evicted_resource_count());
+  ReleaseAndRecycle(resource.Pass());
+}
+
+TEST_F(ResourcePoolTest, EvictsBeforeAllocatingOverLimit) {
+  gfx::Size size(100, 100);
+  gfx::Size other_size(100, 50);
+  size_t bytes = Resource::MemorySizeBytes(size, RGBA_8888);
+  resource_pool_->SetResourceUsageLimits(bytes, bytes, 1);
+
+  ReleaseAndRecycle(resource_pool_->AcquireResource(size));
+  EXPECT_EQ(bytes, resource_pool_->total_memory_usage_bytes());
+
+  // The unused resource can't be reused for another size, and keeping it
+  // would put the pool over its limits, so it is freed before the new one is
+  // allocated.
+  scoped_ptr<ScopedResource> resource =
+      resource_pool_->AcquireResource(other_size);
+  EXPECT_EQ(2u, resource_pool_->allocated_resource_count());
+  EXPECT_EQ(1u, resource_pool_->evicted_resource_count());
+  EXPECT_EQ(Resource::MemorySizeBytes(other_size, RGBA_8888),
+            resource_pool_->total_memory_usage_bytes());
+  EXPECT_EQ(1u, resource_pool_->acquired_resource_count());
+  ReleaseAndRecycle(resource.Pass());
+}
+
+TEST_F(ResourcePoolTest, KeepsUnusedResourcesWithinLimits) {
+  gfx::Size size(100, 100);
+  gfx::Size other_size(100, 50);
+  size_t bytes = Resource::MemorySizeBytes(size, RGBA_8888);
+  resource_pool_->SetResourceUsageLimits(4 * bytes, 4 * bytes, 4);
+
+  ReleaseAndRecycle(resource_pool_->AcquireResource(size));
+
+  // There is room for both, so nothing is evicted.
+  scoped_ptr<ScopedResource> resource =
+      resource_pool_->AcquireResource(other_size);
+  EXPECT_EQ(0u, resource_pool_->evicted_resource_count());
+  EXPECT_EQ(bytes + Resource::MemorySizeBytes(other_size, RGBA_8888),
+            resource_pool_->total_memory_usage_bytes());
+  ReleaseAndRecycle(resource.Pass());
+}
+
+}  // namespace
+}  // namespace cc
@@ -5,6 +5,7 @@
 #include "cc/resources/task_graph_runner.h"
 
 #include <algorithm>
+#include <functional>
 
 #include "base/debug/trace_event.h"
 #include "base/strings/stringprintf.h"
@@ -14,55 +15,80 @@ namespace cc {
 namespace internal {
 namespace {
 
-// Helper class for iterating over all dependents of a task.
+bool CompareNodeTask(const TaskGraph::Node& a, const TaskGraph::Node& b) {
+  return std::less<const Task*>()(a.task, b.task);
+}
+
+bool CompareEdgeTask(const TaskGraph::Edge& a, const TaskGraph::Edge& b) {
+  return std::less<const Task*>()(a.task, b.task);
+}
+
+// Sorts the nodes and edges of |graph| by task so that nodes and the edges of
+// a task can be found with a binary search instead of a linear scan, which
+// otherwise makes each task completion cost O(nodes * edges) under |lock_|.
+void SortTaskGraph(TaskGraph* graph) {
+  std::sort(graph->nodes.begin(), graph->nodes.end(), CompareNodeTask);
+  std::sort(graph->edges.begin(), graph->edges.end(), CompareEdgeTask);
+}
+
+// Helper class for iterating over all dependents of a task. The graph must
+// have been sorted with SortTaskGraph().
 class DependentIterator {
  public:
   DependentIterator(TaskGraph* graph, const Task* task)
-      : graph_(graph), task_(task), current_index_(-1), current_node_(NULL) {
-    ++(*this);
+      : graph_(graph),
+        task_(task),
+        current_edge_(std::lower_bound(graph->edges.begin(),
+                                       graph->edges.end(),
+                                       TaskGraph::Edge(task, NULL),
+                                       CompareEdgeTask)),
+        current_node_(NULL) {
+    FindCurrentNode();
   }
 
   TaskGraph::Node& operator->() const {
-    DCHECK_LT(current_index_, graph_->edges.size());
-    DCHECK_EQ(graph_->edges[current_index_].task, task_);
+    DCHECK(*this);
     DCHECK(current_node_);
     return *current_node_;
   }
 
   TaskGraph::Node& operator*() const {
-    DCHECK_LT(current_index_, graph_->edges.size());
-    DCHECK_EQ(graph_->edges[current_index_].task, task_);
+    DCHECK(*this);
     DCHECK(current_node_);
     return *current_node_;
   }
 
-  // Note: Performance can be improved by keeping edges sorted.
   DependentIterator& operator++() {
-    // Find next dependency edge for |task_|.
-    do {
-      ++current_index_;
-      if (current_index_ == graph_->edges.size())
-        return *this;
-    } while (graph_->edges[current_index_].task != task_);
-
-    // Now find the node for the dependent of this edge.
-    TaskGraph::Node::Vector::iterator it =
-        std::find_if(graph_->nodes.begin(),
-                     graph_->nodes.end(),
-                     TaskGraph::Node::TaskComparator(
-                         graph_->edges[current_index_].dependent));
-    DCHECK(it != graph_->nodes.end());
-    current_node_ = &(*it);
-
+    DCHECK(*this);
+    ++current_edge_;
+    FindCurrentNode();
     return *this;
   }
 
-  operator bool() const { return current_index_ < graph_->edges.size(); }
+  operator bool() const {
+    return current_edge_ != graph_->edges.end() &&
+           current_edge_->task == task_;
+  }
 
  private:
+  // Finds the node for the dependent of the current edge.
+  void FindCurrentNode() {
+    if (!*this)
+      return;
+
+    TaskGraph::Node::Vector::iterator it =
+        std::lower_bound(graph_->nodes.begin(),
+                         graph_->nodes.end(),
+                         TaskGraph::Node(current_edge_->dependent, 0u, 0u),
+                         CompareNodeTask);
+    DCHECK(it != graph_->nodes.end());
+    DCHECK_EQ(current_edge_->dependent, it->task);
+    current_node_ = &(*it);
+  }
+
   TaskGraph* graph_;
   const Task* task_;
-  size_t current_index_;
+  TaskGraph::Edge::Vector::iterator current_edge_;
   TaskGraph::Node* current_node_;
 };
 
@@ -165,6 +191,9 @@ void TaskGraphRunner::ScheduleTasks(NamespaceToken token, TaskGraph* graph) {
                       DependencyMismatchComparator(graph)) ==
          graph->nodes.end());
 
+  // Sorting doesn't need |lock_|, so do it before taking it.
+  SortTaskGraph(graph);
+
   {
     base::AutoLock lock(lock_);
 
@@ -183,25 +212,31 @@ void TaskGraphRunner::ScheduleTasks(NamespaceToken token, TaskGraph* graph) {
       }
     }
 
-    // Build new "ready to run" queue and remove nodes from old graph.
+    // Remove any old nodes that are associated with tasks in the new graph.
+    // The result is that the old graph is left with all nodes not present in
+    // this graph, which we use below to determine what tasks need to be
+    // canceled. Both graphs are sorted by task, so this takes a single pass.
+    TaskGraph::Node::Vector& old_nodes = task_namespace.graph.nodes;
+    TaskGraph::Node::Vector::iterator new_it = graph->nodes.begin();
+    TaskGraph::Node::Vector::iterator old_end = old_nodes.begin();
+    for (TaskGraph::Node::Vector::iterator old_it = old_nodes.begin();
+         old_it != old_nodes.end();
+         ++old_it) {
+      while (new_it != graph->nodes.end() && CompareNodeTask(*new_it, *old_it))
+        ++new_it;
+      if (new_it != graph->nodes.end() && new_it->task == old_it->task)
+        continue;
+      *old_end++ = *old_it;
+    }
+    old_nodes.erase(old_end, old_nodes.end());
+
+    // Build new "ready to run" queue.
     task_namespace.ready_to_run_tasks.clear();
     for (TaskGraph::Node::Vector::iterator it = graph->nodes.begin();
          it != graph->nodes.end();
          ++it) {
       TaskGraph::Node& node = *it;
 
-      // Remove any old nodes that are associated with this task. The result is
-      // that the old graph is left with all nodes not present in this graph,
-      // which we use below to determine what tasks need to be canceled.
-      TaskGraph::Node::Vector::iterator old_it =
-          std::find_if(task_namespace.graph.nodes.begin(),
-                       task_namespace.graph.nodes.end(),
-                       TaskGraph::Node::TaskComparator(node.task));
-      if (old_it != task_namespace.graph.nodes.end()) {
-        std::swap(*old_it, task_namespace.graph.nodes.back());
-        task_namespace.graph.nodes.pop_back();
-      }
-
       // Task is not ready to run if dependencies are not yet satisfied.
       if (node.dependencies)
         continue;
@@ -399,8 +434,11 @@ void TaskGraphRunner::RunTaskWithLockAcquired() {
   // Add task to |running_tasks|.
   task_namespace->running_tasks.push_back(task.get());
 
-  // There may be more work available, so wake up another worker thread.
-  has_ready_to_run_tasks_cv_.Signal();
+  // Wake up another worker thread if there is more work available. Waking
+  // one up when there is nothing for it to do only makes it contend for
+  // |lock_| before it goes back to sleep.
+  if (!ready_to_run_namespaces_.empty())
+    has_ready_to_run_tasks_cv_.Signal();
 
   // Call WillRun() before releasing |lock_| and running task.
   task->WillRun();
@@ -7,8 +7,11 @@
 #include <vector>
 
 #include "base/memory/scoped_ptr.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/simple_thread.h"
 #include "base/time/time.h"
 #include "cc/base/completion_event.h"
+#include "cc/base/scoped_ptr_deque.h"
 #include "cc/test/lap_timer.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/perf/perf_test.h"
@@ -209,7 +212,82 @@ class TaskGraphRunnerPerfTest : public testing::Test {
                            true);
   }
 
+  // Same as RunScheduleAndExecuteTasksTest() but with |num_workers| threads
+  // running the tasks, which makes them contend for the runner's lock.
+  void RunScheduleAndExecuteTasksOnWorkersTest(const std::string& test_name,
+                                               int num_workers,
+                                               int num_top_level_tasks,
+                                               int num_tasks,
+                                               int num_leaf_tasks) {
+    PerfTaskImpl::Vector top_level_tasks;
+    PerfTaskImpl::Vector tasks;
+    PerfTaskImpl::Vector leaf_tasks;
+    CreateTasks(num_top_level_tasks, &top_level_tasks);
+    CreateTasks(num_tasks, &tasks);
+    CreateTasks(num_leaf_tasks, &leaf_tasks);
+
+    // Use a runner of our own as Shutdown() can only be called once.
+    internal::TaskGraphRunner task_graph_runner;
+    internal::NamespaceToken namespace_token =
+        task_graph_runner.GetNamespaceToken();
+    WorkerDelegate worker_delegate(&task_graph_runner);
+    ScopedPtrDeque<base::DelegateSimpleThread> workers;
+    for (int i = 0; i < num_workers; ++i) {
+      scoped_ptr<base::DelegateSimpleThread> worker =
+          make_scoped_ptr(new base::DelegateSimpleThread(
+              &worker_delegate,
+              base::StringPrintf("TaskGraphRunnerPerfWorker%d", i + 1)));
+      worker->Start();
+      workers.push_back(worker.Pass());
+    }
+
+    // Avoid unnecessary heap allocations by reusing the same graph and
+    // completed tasks vector.
+    internal::TaskGraph graph;
+    internal::Task::Vector completed_tasks;
+
+    timer_.Reset();
+    do {
+      graph.Reset();
+      BuildTaskGraph(top_level_tasks, tasks, leaf_tasks, &graph);
+      task_graph_runner.ScheduleTasks(namespace_token, &graph);
+      task_graph_runner.WaitForTasksToFinishRunning(namespace_token);
+      task_graph_runner.CollectCompletedTasks(namespace_token,
+                                              &completed_tasks);
+      completed_tasks.clear();
+      ResetTasks(&top_level_tasks);
+      ResetTasks(&tasks);
+      ResetTasks(&leaf_tasks);
+      timer_.NextLap();
+    } while (!timer_.HasTimeLimitExpired());
+
+    task_graph_runner.Shutdown();
+    while (!workers.empty()) {
+      scoped_ptr<base::DelegateSimpleThread> worker = workers.take_front();
+      worker->Join();
+    }
+
+    perf_test::PrintResult("execute_tasks_on_workers",
+                           TestModifierString(),
+                           test_name,
+                           timer_.LapsPerSecond(),
+                           "runs/s",
+                           true);
+  }
+
  private:
+  class WorkerDelegate : public base::DelegateSimpleThread::Delegate {
+   public:
+    explicit WorkerDelegate(internal::TaskGraphRunner* task_graph_runner)
+        : task_graph_runner_(task_graph_runner) {}
+
+    // Overridden from base::DelegateSimpleThread::Delegate:
+    virtual void Run() OVERRIDE { task_graph_runner_->Run(); }
+
+   private:
+    internal::TaskGraphRunner* task_graph_runner_;
+  };
+
   static std::string TestModifierString() {
     return std::string("_task_graph_runner");
   }
@@ -298,6 +376,7 @@ TEST_F(TaskGraphRunnerPerfTest, ScheduleTasks) {
   RunScheduleTasksTest("2_32_0", 2, 32, 0);
   RunScheduleTasksTest("2_1_1", 2, 1, 1);
   RunScheduleTasksTest("2_32_1", 2, 32, 1);
+  RunScheduleTasksTest("2_1024_1", 2, 1024, 1);
 }
 
 TEST_F(TaskGraphRunnerPerfTest, ScheduleAlternateTasks) {
@@ -316,6 +395,15 @@ TEST_F(TaskGraphRunnerPerfTest, ScheduleAndExecuteTasks) {
   RunScheduleAndExecuteTasksTest("2_32_0", 2, 32, 0);
   RunScheduleAndExecuteTasksTest("2_1_1", 2, 1, 1);
   RunScheduleAndExecuteTasksTest("2_32_1", 2, 32, 1);
+  RunScheduleAndExecuteTasksTest("2_1024_1", 2, 1024, 1);
+}
+
+TEST_F(TaskGraphRunnerPerfTest, ScheduleAndExecuteTasksOnWorkers) {
+  RunScheduleAndExecuteTasksOnWorkersTest("1_0_32_0", 1, 0, 32, 0);
+  RunScheduleAndExecuteTasksOnWorkersTest("4_0_32_0", 4, 0, 32, 0);
+  RunScheduleAndExecuteTasksOnWorkersTest("4_2_32_1", 4, 2, 32, 1);
+  RunScheduleAndExecuteTasksOnWorkersTest("4_0_1024_0", 4, 0, 1024, 0);
+  RunScheduleAndExecuteTasksOnWorkersTest("4_2_1024_1", 4, 2, 1024, 1);
 }
 
 }  // namespace
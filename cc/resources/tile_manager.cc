@@ -24,6 +24,7 @@
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkPixelRef.h"
 #include "ui/gfx/rect_conversions.h"
+#include "ui/gfx/skia_util.h"
 
 namespace cc {
 namespace {
@@ -44,6 +45,104 @@ class DisableLCDTextFilter : public SkDrawFilter {
   }
 };
 
+skia::RefPtr<SkDrawFilter> CreateDrawFilter(RasterMode raster_mode) {
+  switch (raster_mode) {
+    case LOW_QUALITY_RASTER_MODE:
+      return skia::AdoptRef<SkDrawFilter>(new skia::PaintSimplifier);
+    case HIGH_QUALITY_NO_LCD_RASTER_MODE:
+      return skia::AdoptRef<SkDrawFilter>(new DisableLCDTextFilter);
+    case HIGH_QUALITY_RASTER_MODE:
+      return skia::RefPtr<SkDrawFilter>();
+    case NUM_RASTER_MODES:
+    default:
+      NOTREACHED();
+  }
+  return skia::RefPtr<SkDrawFilter>();
+}
+
+// Rasterizes part of a tile into a bitmap of its own, for the tile's
+// RasterWorkerPoolTaskImpl to copy into the tile's resource once all parts are
+// done. This lets the parts of an expensive tile run on different worker
+// threads, without them having to share the resource's canvas, which is only
+// valid while the tile's task runs.
+class SubRasterWorkerPoolTaskImpl : public internal::WorkerPoolTask {
+ public:
+  SubRasterWorkerPoolTaskImpl(PicturePileImpl* picture_pile,
+                              const gfx::Rect& content_rect,
+                              float contents_scale,
+                              RasterMode raster_mode,
+                              bool analyze_picture)
+      : picture_pile_(picture_pile),
+        content_rect_(content_rect),
+        contents_scale_(contents_scale),
+        raster_mode_(raster_mode),
+        analyze_picture_(analyze_picture) {}
+
+  // Overridden from internal::Task:
+  virtual void RunOnWorkerThread() OVERRIDE {
+    TRACE_EVENT0("cc", "SubRasterWorkerPoolTaskImpl::RunOnWorkerThread");
+    AnalyzeAndRaster(picture_pile_->GetCloneForDrawingOnThread(
+        RasterWorkerPool::GetPictureCloneIndexForCurrentThread()));
+  }
+
+  // Overridden from internal::WorkerPoolTask:
+  virtual void ScheduleOnOriginThread(internal::WorkerPoolTaskClient* client)
+      OVERRIDE {}
+  virtual void RunOnOriginThread() OVERRIDE {
+    TRACE_EVENT0("cc", "SubRasterWorkerPoolTaskImpl::RunOnOriginThread");
+    AnalyzeAndRaster(picture_pile_);
+  }
+  virtual void CompleteOnOriginThread(internal::WorkerPoolTaskClient* client)
+      OVERRIDE {}
+  virtual void RunReplyOnOriginThread() OVERRIDE {}
+
+  const gfx::Rect& content_rect() const { return content_rect_; }
+  const PicturePileImpl::Analysis& analysis() const { return analysis_; }
+  const SkBitmap& bitmap() const { return bitmap_; }
+  base::TimeDelta raster_time() const { return raster_time_; }
+
+  // Frees the bitmap once it has been copied.
+  void ReleaseBitmap() { bitmap_.reset(); }
+
+ protected:
+  virtual ~SubRasterWorkerPoolTaskImpl() {}
+
+ private:
+  void AnalyzeAndRaster(PicturePileImpl* picture_pile) {
+    DCHECK(picture_pile);
+
+    if (analyze_picture_) {
+      picture_pile->AnalyzeInRect(content_rect_, contents_scale_, &analysis_);
+      analysis_.is_solid_color &= kUseColorEstimator;
+      if (analysis_.is_solid_color)
+        return;
+    }
+
+    base::TimeTicks start_time = base::TimeTicks::Now();
+    bitmap_.allocN32Pixels(content_rect_.width(), content_rect_.height());
+    SkCanvas canvas(bitmap_);
+    skia::RefPtr<SkDrawFilter> draw_filter = CreateDrawFilter(raster_mode_);
+    canvas.setDrawFilter(draw_filter.get());
+    picture_pile->RasterToBitmap(
+        &canvas, content_rect_, contents_scale_, NULL);
+    raster_time_ = base::TimeTicks::Now() - start_time;
+  }
+
+  scoped_refptr<PicturePileImpl> picture_pile_;
+  gfx::Rect content_rect_;
+  float contents_scale_;
+  RasterMode raster_mode_;
+  bool analyze_picture_;
+  PicturePileImpl::Analysis analysis_;
+  SkBitmap bitmap_;
+  base::TimeDelta raster_time_;
+
+  DISALLOW_COPY_AND_ASSIGN(SubRasterWorkerPoolTaskImpl);
+};
+
+typedef std::vector<scoped_refptr<SubRasterWorkerPoolTaskImpl> >
+    SubRasterTaskVector;
+
 class RasterWorkerPoolTaskImpl : public internal::RasterWorkerPoolTask {
  public:
   RasterWorkerPoolTaskImpl(
@@ -58,7 +157,10 @@ class RasterWorkerPoolTaskImpl : public internal::RasterWorkerPoolTask {
       int source_frame_number,
       bool analyze_picture,
       RenderingStatsInstrumentation* rendering_stats,
-      const base::Callback<void(const PicturePileImpl::Analysis&, bool)>& reply,
+      const base::Callback<void(const PicturePileImpl::Analysis&,
+                                base::TimeDelta,
+                                bool)>& reply,
+      SubRasterTaskVector* sub_raster_tasks,
       internal::WorkerPoolTask::Vector* dependencies)
       : internal::RasterWorkerPoolTask(resource, dependencies),
         picture_pile_(picture_pile),
@@ -72,7 +174,9 @@ class RasterWorkerPoolTaskImpl : public internal::RasterWorkerPoolTask {
         analyze_picture_(analyze_picture),
         rendering_stats_(rendering_stats),
         reply_(reply),
-        canvas_(NULL) {}
+        canvas_(NULL) {
+    sub_raster_tasks_.swap(*sub_raster_tasks);
+  }
 
   // Overridden from internal::Task:
   virtual void RunOnWorkerThread() OVERRIDE {
@@ -103,7 +207,7 @@ class RasterWorkerPoolTaskImpl : public internal::RasterWorkerPoolTask {
   }
   virtual void RunReplyOnOriginThread() OVERRIDE {
     DCHECK(!canvas_);
-    reply_.Run(analysis_, !HasFinishedRunning());
+    reply_.Run(analysis_, raster_time_, !HasFinishedRunning());
   }
 
  protected:
@@ -123,6 +227,11 @@ class RasterWorkerPoolTaskImpl : public internal::RasterWorkerPoolTask {
     DCHECK(picture_pile);
     DCHECK(canvas_);
 
+    if (!sub_raster_tasks_.empty()) {
+      CopySubRasters(picture_pile);
+      return;
+    }
+
     if (analyze_picture_) {
       Analyze(picture_pile);
       if (analysis_.is_solid_color)
@@ -163,24 +272,12 @@ class RasterWorkerPoolTaskImpl : public internal::RasterWorkerPoolTask {
     devtools_instrumentation::ScopedLayerTask raster_task(
         devtools_instrumentation::kRasterTask, layer_id_);
 
-    skia::RefPtr<SkDrawFilter> draw_filter;
-    switch (raster_mode_) {
-      case LOW_QUALITY_RASTER_MODE:
-        draw_filter = skia::AdoptRef(new skia::PaintSimplifier);
-        break;
-      case HIGH_QUALITY_NO_LCD_RASTER_MODE:
-        draw_filter = skia::AdoptRef(new DisableLCDTextFilter);
-        break;
-      case HIGH_QUALITY_RASTER_MODE:
-        break;
-      case NUM_RASTER_MODES:
-      default:
-        NOTREACHED();
-    }
+    skia::RefPtr<SkDrawFilter> draw_filter = CreateDrawFilter(raster_mode_);
     canvas_->setDrawFilter(draw_filter.get());
 
     base::TimeDelta prev_rasterize_time =
         rendering_stats_->impl_thread_rendering_stats().rasterize_time;
+    base::TimeTicks start_time = base::TimeTicks::Now();
 
     // Only record rasterization time for highres tiles, because
     // lowres tiles are not required for activation and therefore
@@ -191,6 +288,7 @@ class RasterWorkerPoolTaskImpl : public internal::RasterWorkerPoolTask {
     DCHECK(picture_pile);
     picture_pile->RasterToBitmap(
         canvas_, content_rect_, contents_scale_, stats);
+    raster_time_ = base::TimeTicks::Now() - start_time;
 
     if (rendering_stats_->record_rendering_stats()) {
       base::TimeDelta current_rasterize_time =
@@ -204,6 +302,66 @@ class RasterWorkerPoolTaskImpl : public internal::RasterWorkerPoolTask {
     }
   }
 
+  // Combines the analyses of the sub-raster tasks, and copies their bitmaps
+  // into |canvas_| unless the whole tile is a solid color.
+  void CopySubRasters(PicturePileImpl* picture_pile) {
+    TRACE_EVENT1("cc",
+                 "RasterWorkerPoolTaskImpl::CopySubRasters",
+                 "data",
+                 TracedValue::FromValue(DataAsValue().release()));
+
+    analysis_.is_solid_color = analyze_picture_;
+    for (SubRasterTaskVector::const_iterator it = sub_raster_tasks_.begin();
+         it != sub_raster_tasks_.end();
+         ++it) {
+      const PicturePileImpl::Analysis& analysis = (*it)->analysis();
+      analysis_.has_text |= analysis.has_text;
+      if (!analysis.is_solid_color ||
+          (it != sub_raster_tasks_.begin() &&
+           analysis.solid_color != analysis_.solid_color)) {
+        analysis_.is_solid_color = false;
+      }
+      analysis_.solid_color = analysis.solid_color;
+      raster_time_ += (*it)->raster_time();
+    }
+    if (analysis_.is_solid_color)
+      return;
+
+    devtools_instrumentation::ScopedLayerTask raster_task(
+        devtools_instrumentation::kRasterTask, layer_id_);
+
+    // The sub-rasters replace the contents of their part of the tile.
+    SkPaint paint;
+    paint.setXfermodeMode(SkXfermode::kSrc_Mode);
+    for (SubRasterTaskVector::const_iterator it = sub_raster_tasks_.begin();
+         it != sub_raster_tasks_.end();
+         ++it) {
+      SubRasterWorkerPoolTaskImpl* task = it->get();
+      gfx::Rect rect = task->content_rect() - content_rect_.OffsetFromOrigin();
+      if (!task->HasFinishedRunning()) {
+        // The sub-raster task was canceled without running, which only
+        // happens when this task is rescheduled after being canceled too.
+        // Rasterize its part here.
+        canvas_->save();
+        canvas_->clipRect(gfx::RectToSkRect(rect));
+        canvas_->translate(rect.x(), rect.y());
+        skia::RefPtr<SkDrawFilter> draw_filter =
+            CreateDrawFilter(raster_mode_);
+        canvas_->setDrawFilter(draw_filter.get());
+        picture_pile->RasterToBitmap(
+            canvas_, task->content_rect(), contents_scale_, NULL);
+        canvas_->setDrawFilter(NULL);
+        canvas_->restore();
+      } else if (task->analysis().is_solid_color) {
+        paint.setColor(task->analysis().solid_color);
+        canvas_->drawRect(gfx::RectToSkRect(rect), paint);
+      } else {
+        canvas_->drawBitmap(task->bitmap(), rect.x(), rect.y(), &paint);
+        task->ReleaseBitmap();
+      }
+    }
+  }
+
   PicturePileImpl::Analysis analysis_;
   scoped_refptr<PicturePileImpl> picture_pile_;
   gfx::Rect content_rect_;
@@ -215,7 +373,11 @@ class RasterWorkerPoolTaskImpl : public internal::RasterWorkerPoolTask {
   int source_frame_number_;
   bool analyze_picture_;
   RenderingStatsInstrumentation* rendering_stats_;
-  const base::Callback<void(const PicturePileImpl::Analysis&, bool)> reply_;
+  const base::Callback<void(const PicturePileImpl::Analysis&,
+                            base::TimeDelta,
+                            bool)> reply_;
+  SubRasterTaskVector sub_raster_tasks_;
+  base::TimeDelta raster_time_;
   SkCanvas* canvas_;
 
   DISALLOW_COPY_AND_ASSIGN(RasterWorkerPoolTaskImpl);
@@ -274,6 +436,20 @@ class ImageDecodeWorkerPoolTaskImpl : public internal::WorkerPoolTask {
 
 const size_t kScheduledRasterTasksLimit = 32u;
 
+// Tiles with fewer content pixels than this are never split into sub-raster
+// tasks.
+const int kMinSubRasterTileArea = 512 * 512;
+
+// Tiles are split when their layer's raster cost predicts they would take a
+// single worker thread at least this long to rasterize.
+const int kMinSubRasterTileTimeUs = 8000;
+
+// The maximum number of sub-raster tasks per tile.
+const size_t kMaxSubRasterTasks = 4u;
+
+// The weight of a new tile's raster cost in the layer's moving average.
+const double kRasterCostSampleWeight = 0.25;
+
 // Memory limit policy works by mapping some bin states to the NEVER bin.
 const ManagedTileBin kBinPolicyMap[NUM_TILE_MEMORY_LIMIT_POLICIES][NUM_BINS] = {
     // [ALLOW_NOTHING]
@@ -384,13 +560,14 @@ inline ManagedTileBin BinFromTilePriority(const TilePriority& prio) {
 }  // namespace
 
 RasterTaskCompletionStats::RasterTaskCompletionStats()
-    : completed_count(0u), canceled_count(0u) {}
+    : completed_count(0u), canceled_count(0u), known_solid_color_count(0u) {}
 
 scoped_ptr<base::Value> RasterTaskCompletionStatsAsValue(
     const RasterTaskCompletionStats& stats) {
   scoped_ptr<base::DictionaryValue> state(new base::DictionaryValue());
   state->SetInteger("completed_count", stats.completed_count);
   state->SetInteger("canceled_count", stats.canceled_count);
+  state->SetInteger("known_solid_color_count", stats.known_solid_color_count);
   return state.PassAs<base::Value>();
 }
 
@@ -525,7 +702,8 @@ void TileManager::CleanUpReleasedTiles() {
     DCHECK_GT(layer_it->second, 0);
     if (--layer_it->second == 0) {
       used_layer_counts_.erase(layer_it);
-      image_decode_tasks_.erase(tile->layer_id());
+      ReleaseLayerPixelRefs(tile->layer_id());
+      layer_raster_costs_.erase(tile->layer_id());
     }
 
     delete tile;
@@ -813,6 +991,7 @@ scoped_ptr<base::Value> TileManager::BasicStateAsValue() const {
   state->SetInteger("tile_count", tiles_.size());
   state->Set("global_state", global_state_.AsValue().release());
   state->Set("memory_requirements", GetMemoryRequirementsAsValue().release());
+  state->Set("resource_pool", resource_pool_->AsValue().release());
   return state.PassAs<base::Value>();
 }
 
@@ -1083,6 +1262,12 @@ void TileManager::ScheduleTasks(
     DCHECK(tile_version.requires_resource());
     DCHECK(!tile_version.resource_);
 
+    // Earlier tiles, possibly at other scales, may have already found the
+    // tile's part of the recording to be a solid color, in which case there
+    // is nothing to raster.
+    if (!tile_version.raster_task_ && UseKnownSolidColor(tile))
+      continue;
+
     if (!tile_version.raster_task_)
       tile_version.raster_task_ = CreateRasterTask(tile);
 
@@ -1113,6 +1298,29 @@ void TileManager::ScheduleTasks(
   did_check_for_completed_tasks_since_last_schedule_tasks_ = false;
 }
 
+bool TileManager::UseKnownSolidColor(Tile* tile) {
+  // Analysis is skipped for gpu rasterization, see CreateRasterTask().
+  if (!kUseColorEstimator || tile->use_gpu_rasterization())
+    return false;
+
+  SkColor solid_color;
+  if (!tile->picture_pile()->GetCachedSolidColorInRect(
+          tile->content_rect(), tile->contents_scale(), &solid_color))
+    return false;
+
+  ManagedTileState& mts = tile->managed_state();
+  ManagedTileState::TileVersion& tile_version =
+      mts.tile_versions[mts.raster_mode];
+  tile_version.set_has_text(false);
+  tile_version.set_solid_color(solid_color);
+  ++update_visible_tiles_stats_.known_solid_color_count;
+
+  FreeUnusedResourcesForTile(tile);
+  if (tile->priority(ACTIVE_TREE).distance_to_visible == 0.f)
+    did_initialize_visible_tile_ = true;
+  return true;
+}
+
 scoped_refptr<internal::WorkerPoolTask> TileManager::CreateImageDecodeTask(
     Tile* tile,
     SkPixelRef* pixel_ref) {
@@ -1122,7 +1330,6 @@ scoped_refptr<internal::WorkerPoolTask> TileManager::CreateImageDecodeTask(
       rendering_stats_instrumentation_,
       base::Bind(&TileManager::OnImageDecodeTaskCompleted,
                  base::Unretained(this),
-                 tile->layer_id(),
                  base::Unretained(pixel_ref))));
 }
 
@@ -1136,7 +1343,7 @@ scoped_refptr<internal::RasterWorkerPoolTask> TileManager::CreateRasterTask(
 
   // Create and queue all image decode tasks that this tile depends on.
   internal::WorkerPoolTask::Vector decode_tasks;
-  PixelRefTaskMap& existing_pixel_refs = image_decode_tasks_[tile->layer_id()];
+  PixelRefIdSet& layer_pixel_refs = layer_pixel_refs_[tile->layer_id()];
   for (PicturePileImpl::PixelRefIterator iter(
            tile->content_rect(), tile->contents_scale(), tile->picture_pile());
        iter;
@@ -1144,10 +1351,15 @@ scoped_refptr<internal::RasterWorkerPoolTask> TileManager::CreateRasterTask(
     SkPixelRef* pixel_ref = *iter;
     uint32_t id = pixel_ref->getGenerationID();
 
-    // Append existing image decode task if available.
-    PixelRefTaskMap::iterator decode_task_it = existing_pixel_refs.find(id);
-    if (decode_task_it != existing_pixel_refs.end()) {
+    if (layer_pixel_refs.insert(id).second)
+      ++pixel_ref_layer_counts_[id];
+
+    // Append existing image decode task if available, even if it was created
+    // for another layer.
+    PixelRefTaskMap::iterator decode_task_it = image_decode_tasks_.find(id);
+    if (decode_task_it != image_decode_tasks_.end()) {
       decode_tasks.push_back(decode_task_it->second);
+      rendering_stats_instrumentation_->AddImageDecodeTask(true);
       continue;
     }
 
@@ -1155,7 +1367,8 @@ scoped_refptr<internal::RasterWorkerPoolTask> TileManager::CreateRasterTask(
     scoped_refptr<internal::WorkerPoolTask> decode_task =
         CreateImageDecodeTask(tile, pixel_ref);
     decode_tasks.push_back(decode_task);
-    existing_pixel_refs[id] = decode_task;
+    image_decode_tasks_[id] = decode_task;
+    rendering_stats_instrumentation_->AddImageDecodeTask(false);
   }
 
   // We analyze picture before rasterization to detect solid-color tiles.
@@ -1165,6 +1378,30 @@ scoped_refptr<internal::RasterWorkerPoolTask> TileManager::CreateRasterTask(
   // gpu rasterization where there is no upload.
   bool analyze_picture = !tile->use_gpu_rasterization();
 
+  // Split expensive tiles into horizontal bands rasterized by sub-raster tasks
+  // that run before the tile's task, so that they can use several worker
+  // threads.
+  SubRasterTaskVector sub_raster_tasks;
+  size_t sub_raster_task_count = GetSubRasterTaskCount(tile);
+  const gfx::Rect& content_rect = tile->content_rect();
+  for (size_t i = 0; i < sub_raster_task_count; ++i) {
+    int top = content_rect.y() +
+              content_rect.height() * i / sub_raster_task_count;
+    int bottom = content_rect.y() +
+                 content_rect.height() * (i + 1) / sub_raster_task_count;
+    gfx::Rect sub_rect(content_rect.x(), top, content_rect.width(),
+                       bottom - top);
+    scoped_refptr<SubRasterWorkerPoolTaskImpl> sub_raster_task(
+        new SubRasterWorkerPoolTaskImpl(
+            tile->picture_pile(),
+            sub_rect,
+            tile->contents_scale(),
+            mts.raster_mode,
+            analyze_picture));
+    sub_raster_tasks.push_back(sub_raster_task);
+    decode_tasks.push_back(sub_raster_task);
+  }
+
   return make_scoped_refptr(new RasterWorkerPoolTaskImpl(
       const_resource,
       tile->picture_pile(),
@@ -1182,28 +1419,62 @@ scoped_refptr<internal::RasterWorkerPoolTask> TileManager::CreateRasterTask(
                  tile->id(),
                  base::Passed(&resource),
                  mts.raster_mode),
+      &sub_raster_tasks,
       &decode_tasks));
 }
 
-void TileManager::OnImageDecodeTaskCompleted(int layer_id,
-                                             SkPixelRef* pixel_ref,
+size_t TileManager::GetSubRasterTaskCount(const Tile* tile) const {
+  // Gpu rasterization runs all tasks on the origin thread.
+  if (tile->use_gpu_rasterization())
+    return 0;
+
+  int num_threads = RasterWorkerPool::GetNumRasterThreads();
+  if (num_threads < 2)
+    return 0;
+
+  int area = tile->content_rect().width() * tile->content_rect().height();
+  if (area < kMinSubRasterTileArea)
+    return 0;
+
+  LayerRasterCostMap::const_iterator it =
+      layer_raster_costs_.find(tile->layer_id());
+  if (it == layer_raster_costs_.end() ||
+      it->second * area < kMinSubRasterTileTimeUs) {
+    return 0;
+  }
+
+  return std::min(kMaxSubRasterTasks, static_cast<size_t>(num_threads));
+}
+
+void TileManager::OnImageDecodeTaskCompleted(SkPixelRef* pixel_ref,
                                              bool was_canceled) {
   // If the task was canceled, we need to clean it up
   // from |image_decode_tasks_|.
   if (!was_canceled)
     return;
 
-  LayerPixelRefTaskMap::iterator layer_it = image_decode_tasks_.find(layer_id);
+  image_decode_tasks_.erase(pixel_ref->getGenerationID());
+}
 
-  if (layer_it == image_decode_tasks_.end())
+void TileManager::ReleaseLayerPixelRefs(int layer_id) {
+  LayerPixelRefIdMap::iterator layer_it = layer_pixel_refs_.find(layer_id);
+  if (layer_it == layer_pixel_refs_.end())
     return;
 
-  PixelRefTaskMap& pixel_ref_tasks = layer_it->second;
-  PixelRefTaskMap::iterator task_it =
-      pixel_ref_tasks.find(pixel_ref->getGenerationID());
-
-  if (task_it != pixel_ref_tasks.end())
-    pixel_ref_tasks.erase(task_it);
+  // Drop the decode tasks of the pixel refs no other layer uses.
+  const PixelRefIdSet& pixel_refs = layer_it->second;
+  for (PixelRefIdSet::const_iterator it = pixel_refs.begin();
+       it != pixel_refs.end();
+       ++it) {
+    PixelRefLayerCountMap::iterator count_it =
+        pixel_ref_layer_counts_.find(*it);
+    DCHECK(count_it != pixel_ref_layer_counts_.end());
+    if (--count_it->second == 0) {
+      pixel_ref_layer_counts_.erase(count_it);
+      image_decode_tasks_.erase(*it);
+    }
+  }
+  layer_pixel_refs_.erase(layer_it);
 }
 
 void TileManager::OnRasterTaskCompleted(
@@ -1211,6 +1482,7 @@ void TileManager::OnRasterTaskCompleted(
     scoped_ptr<ScopedResource> resource,
     RasterMode raster_mode,
     const PicturePileImpl::Analysis& analysis,
+    base::TimeDelta raster_time,
     bool was_canceled) {
   TileMap::iterator it = tiles_.find(tile_id);
   if (it == tiles_.end()) {
@@ -1234,6 +1506,17 @@ void TileManager::OnRasterTaskCompleted(
 
   ++update_visible_tiles_stats_.completed_count;
 
+  int area = tile->content_rect().width() * tile->content_rect().height();
+  if (raster_time > base::TimeDelta() && area > 0) {
+    double cost = raster_time.InMicroseconds() / static_cast<double>(area);
+    LayerRasterCostMap::iterator cost_it =
+        layer_raster_costs_.find(tile->layer_id());
+    if (cost_it == layer_raster_costs_.end())
+      layer_raster_costs_[tile->layer_id()] = cost;
+    else
+      cost_it->second += kRasterCostSampleWeight * (cost - cost_it->second);
+  }
+
   tile_version.set_has_text(analysis.has_text);
   if (analysis.is_solid_color) {
     tile_version.set_solid_color(analysis.solid_color);
@@ -40,6 +40,9 @@ struct RasterTaskCompletionStats {
 
   size_t completed_count;
   size_t canceled_count;
+  // Tiles that didn't need a raster task, because earlier analyses had found
+  // them to be a solid color.
+  size_t known_solid_color_count;
 };
 scoped_ptr<base::Value> RasterTaskCompletionStatsAsValue(
     const RasterTaskCompletionStats& stats);
@@ -174,13 +177,14 @@ class CC_EXPORT TileManager : public RasterWorkerPoolClient,
     NUM_RASTER_WORKER_POOL_TYPES
   };
 
-  void OnImageDecodeTaskCompleted(int layer_id,
-                                  SkPixelRef* pixel_ref,
-                                  bool was_canceled);
+  void OnImageDecodeTaskCompleted(SkPixelRef* pixel_ref, bool was_canceled);
+  // Forgets the pixel refs used by |layer_id|, which has no tiles left.
+  void ReleaseLayerPixelRefs(int layer_id);
   void OnRasterTaskCompleted(Tile::Id tile,
                              scoped_ptr<ScopedResource> resource,
                              RasterMode raster_mode,
                              const PicturePileImpl::Analysis& analysis,
+                             base::TimeDelta raster_time,
                              bool was_canceled);
 
   inline size_t BytesConsumedIfAllocated(const Tile* tile) const {
@@ -191,10 +195,18 @@ class CC_EXPORT TileManager : public RasterWorkerPoolClient,
   void FreeResourceForTile(Tile* tile, RasterMode mode);
   void FreeResourcesForTile(Tile* tile);
   void FreeUnusedResourcesForTile(Tile* tile);
+  // Gives |tile| a solid color and returns true if cached analyses of its
+  // picture pile show that it is one, so that it needs no raster task.
+  bool UseKnownSolidColor(Tile* tile);
   scoped_refptr<internal::WorkerPoolTask> CreateImageDecodeTask(
       Tile* tile,
       SkPixelRef* pixel_ref);
   scoped_refptr<internal::RasterWorkerPoolTask> CreateRasterTask(Tile* tile);
+  // Returns the number of sub-raster tasks |tile| should be rasterized with,
+  // or 0 if it should be rasterized by a single task. Tiles are split when
+  // they are large and the raster times measured for their layer predict that
+  // a single worker thread would take long to rasterize them.
+  size_t GetSubRasterTaskCount(const Tile* tile) const;
   scoped_ptr<base::Value> GetMemoryRequirementsAsValue() const;
   void UpdatePrioritizedTileSetIfNeeded();
 
@@ -230,14 +242,29 @@ class CC_EXPORT TileManager : public RasterWorkerPoolClient,
   bool did_initialize_visible_tile_;
   bool did_check_for_completed_tasks_since_last_schedule_tasks_;
 
+  // Image decode tasks are shared by all layers, so that an image that
+  // appears in several layers is decoded once. A task is kept, even after it
+  // has run, for as long as any layer that uses its pixel ref has tiles.
   typedef base::hash_map<uint32_t, scoped_refptr<internal::WorkerPoolTask> >
       PixelRefTaskMap;
-  typedef base::hash_map<int, PixelRefTaskMap> LayerPixelRefTaskMap;
-  LayerPixelRefTaskMap image_decode_tasks_;
+  PixelRefTaskMap image_decode_tasks_;
+
+  typedef base::hash_set<uint32_t> PixelRefIdSet;
+  typedef base::hash_map<int, PixelRefIdSet> LayerPixelRefIdMap;
+  LayerPixelRefIdMap layer_pixel_refs_;
+
+  // The number of layers in |layer_pixel_refs_| that use each pixel ref.
+  typedef base::hash_map<uint32_t, int> PixelRefLayerCountMap;
+  PixelRefLayerCountMap pixel_ref_layer_counts_;
 
   typedef base::hash_map<int, int> LayerCountMap;
   LayerCountMap used_layer_counts_;
 
+  // Moving average of the raster time per content pixel, in microseconds, of
+  // the tiles of each layer.
+  typedef base::hash_map<int, double> LayerRasterCostMap;
+  LayerRasterCostMap layer_raster_costs_;
+
   RasterTaskCompletionStats update_visible_tiles_stats_;
 
   std::vector<Tile*> released_tiles_;
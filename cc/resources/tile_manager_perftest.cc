@@ -51,14 +51,15 @@ class TileManagerPerfTest : public testing::Test {
     picture_pile_ = FakePicturePileImpl::CreateInfiniteFilledPile();
   }
 
-  GlobalStateThatImpactsTilePriority GlobalStateForTest() {
+  GlobalStateThatImpactsTilePriority GlobalStateForTest(
+      unsigned memory_limit_tiles) {
     GlobalStateThatImpactsTilePriority state;
     gfx::Size tile_size = settings_.default_tile_size;
     state.soft_memory_limit_in_bytes =
-        10000u * 4u *
+        memory_limit_tiles * 4u *
         static_cast<size_t>(tile_size.width() * tile_size.height());
     state.hard_memory_limit_in_bytes = state.soft_memory_limit_in_bytes;
-    state.num_resources_limit = 10000;
+    state.num_resources_limit = memory_limit_tiles;
     state.memory_limit_policy = ALLOW_ANYTHING;
     state.tree_priority = SMOOTHNESS_TAKES_PRIORITY;
     return state;
@@ -135,9 +136,12 @@ class TileManagerPerfTest : public testing::Test {
     CreateBinTiles(count - 3 * count_per_bin, NEVER_BIN, tiles);
   }
 
+  // Runs ManageTiles() with memory for |memory_limit_tiles| tiles. Only the
+  // tiles that fit in that budget need to be visited in priority order.
   void RunManageTilesTest(const std::string& test_name,
                           unsigned tile_count,
-                          int priority_change_percent) {
+                          int priority_change_percent,
+                          unsigned memory_limit_tiles) {
     DCHECK_GE(tile_count, 100u);
     DCHECK_GE(priority_change_percent, 0);
     DCHECK_LE(priority_change_percent, 100);
@@ -156,7 +160,7 @@ class TileManagerPerfTest : public testing::Test {
         }
       }
 
-      tile_manager_->ManageTiles(GlobalStateForTest());
+      tile_manager_->ManageTiles(GlobalStateForTest(memory_limit_tiles));
       tile_manager_->UpdateVisibleTiles();
       timer_.NextLap();
     } while (!timer_.HasTimeLimitExpired());
@@ -178,15 +182,23 @@ class TileManagerPerfTest : public testing::Test {
 };
 
 TEST_F(TileManagerPerfTest, ManageTiles) {
-  RunManageTilesTest("100_0", 100, 0);
-  RunManageTilesTest("1000_0", 1000, 0);
-  RunManageTilesTest("10000_0", 10000, 0);
-  RunManageTilesTest("100_10", 100, 10);
-  RunManageTilesTest("1000_10", 1000, 10);
-  RunManageTilesTest("10000_10", 10000, 10);
-  RunManageTilesTest("100_100", 100, 100);
-  RunManageTilesTest("1000_100", 1000, 100);
-  RunManageTilesTest("10000_100", 10000, 100);
+  RunManageTilesTest("100_0", 100, 0, 10000);
+  RunManageTilesTest("1000_0", 1000, 0, 10000);
+  RunManageTilesTest("10000_0", 10000, 0, 10000);
+  RunManageTilesTest("100_10", 100, 10, 10000);
+  RunManageTilesTest("1000_10", 1000, 10, 10000);
+  RunManageTilesTest("10000_10", 10000, 10, 10000);
+  RunManageTilesTest("100_100", 100, 100, 10000);
+  RunManageTilesTest("1000_100", 1000, 100, 10000);
+  RunManageTilesTest("10000_100", 10000, 100, 10000);
+}
+
+TEST_F(TileManagerPerfTest, ManageTilesWithMemoryLimit) {
+  RunManageTilesTest("5000_10_limit_100", 5000, 10, 100);
+  RunManageTilesTest("5000_10_limit_1000", 5000, 10, 1000);
+  RunManageTilesTest("10000_10_limit_100", 10000, 10, 100);
+  RunManageTilesTest("10000_10_limit_1000", 10000, 10, 1000);
+  RunManageTilesTest("10000_100_limit_1000", 10000, 100, 1000);
 }
 
 }  // namespace
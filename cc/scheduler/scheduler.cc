@@ -24,6 +24,8 @@ Scheduler::Scheduler(
       layer_tree_host_id_(layer_tree_host_id),
       impl_task_runner_(impl_task_runner),
       last_set_needs_begin_impl_frame_(false),
+      missed_draw_deadline_count_(0),
+      missed_main_frame_deadline_count_(0),
       state_machine_(scheduler_settings),
       inside_process_scheduled_actions_(false),
       inside_action_(SchedulerStateMachine::ACTION_NONE),
@@ -295,6 +297,7 @@ void Scheduler::ScheduleBeginImplFrameDeadline(base::TimeTicks deadline) {
 void Scheduler::OnBeginImplFrameDeadline() {
   TRACE_EVENT0("cc", "Scheduler::OnBeginImplFrameDeadline");
   begin_impl_frame_deadline_closure_.Cancel();
+  UpdateMissedDeadlineCounts();
 
   // We split the deadline actions up into two phases so the state machine
   // has a chance to trigger actions that should occur durring and after
@@ -362,9 +365,11 @@ void Scheduler::ProcessScheduledActions() {
       case SchedulerStateMachine::ACTION_NONE:
         break;
       case SchedulerStateMachine::ACTION_SEND_BEGIN_MAIN_FRAME:
+        last_begin_main_frame_sent_time_ = gfx::FrameTime::Now();
         client_->ScheduledActionSendBeginMainFrame();
         break;
       case SchedulerStateMachine::ACTION_COMMIT:
+        last_commit_time_ = gfx::FrameTime::Now();
         client_->ScheduledActionCommit();
         break;
       case SchedulerStateMachine::ACTION_UPDATE_VISIBLE_TILES:
@@ -398,6 +403,7 @@ void Scheduler::ProcessScheduledActions() {
     }
   } while (action != SchedulerStateMachine::ACTION_NONE);
 
+  state_machine_.SetMainFrameWillMissDeadline(MainFrameWillMissDeadline());
   SetupNextBeginImplFrameIfNeeded();
   client_->DidAnticipatedDrawTimeChange(AnticipatedDrawTime());
 
@@ -428,6 +434,10 @@ scoped_ptr<base::Value> Scheduler::StateAsValue() const {
       "commit_to_activate_duration_estimate_ms",
       client_->CommitToActivateDurationEstimate().InMillisecondsF());
   state->Set("client_state", client_state.release());
+
+  state->SetInteger("missed_draw_deadline_count", missed_draw_deadline_count_);
+  state->SetInteger("missed_main_frame_deadline_count",
+                    missed_main_frame_deadline_count_);
   return state.PassAs<base::Value>();
 }
 
@@ -450,6 +460,66 @@ bool Scheduler::CanCommitAndActivateBeforeDeadline() const {
   return estimated_draw_time < last_begin_impl_frame_args_.deadline;
 }
 
+base::TimeTicks Scheduler::EstimatedActivationTime() const {
+  base::TimeTicks now = gfx::FrameTime::Now();
+  switch (state_machine_.commit_state()) {
+    case SchedulerStateMachine::COMMIT_STATE_BEGIN_MAIN_FRAME_SENT:
+    case SchedulerStateMachine::COMMIT_STATE_BEGIN_MAIN_FRAME_STARTED:
+      // The main thread may already have spent some of its estimate.
+      return std::max(last_begin_main_frame_sent_time_ +
+                          client_->BeginMainFrameToCommitDurationEstimate(),
+                      now) +
+             client_->CommitToActivateDurationEstimate();
+    case SchedulerStateMachine::COMMIT_STATE_READY_TO_COMMIT:
+      return now + client_->CommitToActivateDurationEstimate();
+    default:
+      break;
+  }
+  if (state_machine_.has_pending_tree()) {
+    return std::max(last_commit_time_ +
+                        client_->CommitToActivateDurationEstimate(),
+                    now);
+  }
+  return base::TimeTicks();
+}
+
+bool Scheduler::MainFrameWillMissDeadline() const {
+  if (state_machine_.begin_impl_frame_state() !=
+      SchedulerStateMachine::BEGIN_IMPL_FRAME_STATE_INSIDE_BEGIN_FRAME)
+    return false;
+
+  base::TimeTicks estimated_activation_time = EstimatedActivationTime();
+  return !estimated_activation_time.is_null() &&
+         estimated_activation_time > last_begin_impl_frame_args_.deadline;
+}
+
+void Scheduler::UpdateMissedDeadlineCounts() {
+  if (!state_machine_.needs_redraw())
+    return;
+
+  base::TimeTicks next_begin_impl_frame_time =
+      last_begin_impl_frame_args_.frame_time +
+      last_begin_impl_frame_args_.interval;
+  bool missed_draw_deadline =
+      gfx::FrameTime::Now() + client_->DrawDurationEstimate() >
+      next_begin_impl_frame_time;
+  bool missed_main_frame_deadline = !EstimatedActivationTime().is_null();
+  if (!missed_draw_deadline && !missed_main_frame_deadline)
+    return;
+
+  if (missed_draw_deadline)
+    missed_draw_deadline_count_++;
+  if (missed_main_frame_deadline)
+    missed_main_frame_deadline_count_++;
+  TRACE_COUNTER_ID2(TRACE_DISABLED_BY_DEFAULT("cc.debug.scheduler"),
+                    "MissedDeadlines",
+                    this,
+                    "draw",
+                    missed_draw_deadline_count_,
+                    "main_frame",
+                    missed_main_frame_deadline_count_);
+}
+
 bool Scheduler::IsBeginMainFrameSentOrStarted() const {
   return (state_machine_.commit_state() ==
               SchedulerStateMachine::COMMIT_STATE_BEGIN_MAIN_FRAME_SENT ||
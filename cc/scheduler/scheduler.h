@@ -140,6 +140,13 @@ class CC_EXPORT Scheduler {
   bool CanCommitAndActivateBeforeDeadline() const;
   void AdvanceCommitStateIfPossible();
 
+  // Returns when the main thread's update in progress is expected to be
+  // activated, from the client's duration estimates, or a null time if there
+  // is no such update.
+  base::TimeTicks EstimatedActivationTime() const;
+  bool MainFrameWillMissDeadline() const;
+  void UpdateMissedDeadlineCounts();
+
   bool IsBeginMainFrameSentOrStarted() const;
 
   const SchedulerSettings settings_;
@@ -153,6 +160,15 @@ class CC_EXPORT Scheduler {
   base::CancelableClosure poll_for_draw_triggers_closure_;
   base::RepeatingTimer<Scheduler> advance_commit_state_timer_;
 
+  base::TimeTicks last_begin_main_frame_sent_time_;
+  base::TimeTicks last_commit_time_;
+
+  // Deadlines at which a redraw couldn't finish before the next
+  // BeginImplFrame, and at which a redraw went ahead without the main
+  // thread's update in progress.
+  int missed_draw_deadline_count_;
+  int missed_main_frame_deadline_count_;
+
   SchedulerStateMachine state_machine_;
   bool inside_process_scheduled_actions_;
   SchedulerStateMachine::Action inside_action_;
@@ -44,7 +44,8 @@ SchedulerStateMachine::SchedulerStateMachine(const SchedulerSettings& settings)
       did_create_and_initialize_first_output_surface_(false),
       smoothness_takes_priority_(false),
       skip_next_begin_main_frame_to_reduce_latency_(false),
-      skip_begin_main_frame_to_reduce_latency_(false) {}
+      skip_begin_main_frame_to_reduce_latency_(false),
+      main_frame_will_miss_deadline_(false) {}
 
 const char* SchedulerStateMachine::OutputSurfaceStateToString(
     OutputSurfaceState state) {
@@ -273,6 +274,8 @@ scoped_ptr<base::Value> SchedulerStateMachine::AsValue() const  {
                           skip_begin_main_frame_to_reduce_latency_);
   minor_state->SetBoolean("skip_next_begin_main_frame_to_reduce_latency",
                           skip_next_begin_main_frame_to_reduce_latency_);
+  minor_state->SetBoolean("main_frame_will_miss_deadline",
+                          main_frame_will_miss_deadline_);
   state->Set("minor_state", minor_state.release());
 
   return state.PassAs<base::Value>();
@@ -808,6 +811,11 @@ void SchedulerStateMachine::SetSkipNextBeginMainFrameToReduceLatency() {
   skip_next_begin_main_frame_to_reduce_latency_ = true;
 }
 
+void SchedulerStateMachine::SetMainFrameWillMissDeadline(
+    bool main_frame_will_miss_deadline) {
+  main_frame_will_miss_deadline_ = main_frame_will_miss_deadline;
+}
+
 bool SchedulerStateMachine::BeginImplFrameNeeded() const {
   // Proactive BeginImplFrames are bad for the synchronous compositor because we
   // have to draw when we get the BeginImplFrame and could end up drawing many
@@ -969,6 +977,11 @@ bool SchedulerStateMachine::ShouldTriggerBeginImplFrameDeadlineEarly() const {
   if (commit_state_ == COMMIT_STATE_IDLE && !has_pending_tree_)
     return true;
 
+  // Likewise, don't wait for a new tree from the main thread that isn't
+  // expected to be activated before the deadline anyway.
+  if (main_frame_will_miss_deadline_)
+    return true;
+
   // Prioritize impl-thread draws in smoothness mode.
   if (smoothness_takes_priority_)
     return true;
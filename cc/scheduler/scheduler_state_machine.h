@@ -221,6 +221,11 @@ class CC_EXPORT SchedulerStateMachine {
 
   void SetSkipNextBeginMainFrameToReduceLatency();
 
+  // Indicates whether the main thread's update in progress, if any, is
+  // expected to be activated after this BeginImplFrame's deadline, in which
+  // case pending impl-thread changes are drawn without waiting for it.
+  void SetMainFrameWillMissDeadline(bool main_frame_will_miss_deadline);
+
   // Indicates whether drawing would, at this time, make sense.
   // CanDraw can be used to suppress flashes or checkerboarding
   // when such behavior would be undesirable.
@@ -315,6 +320,7 @@ class CC_EXPORT SchedulerStateMachine {
   bool smoothness_takes_priority_;
   bool skip_next_begin_main_frame_to_reduce_latency_;
   bool skip_begin_main_frame_to_reduce_latency_;
+  bool main_frame_will_miss_deadline_;
 
  private:
   DISALLOW_COPY_AND_ASSIGN(SchedulerStateMachine);
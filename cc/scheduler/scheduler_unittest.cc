@@ -1249,6 +1249,52 @@ TEST(SchedulerTest, NotSkipMainFrameInPreferSmoothnessMode) {
   MainFrameInHighLatencyMode(1, 1, true, true);
 }
 
+void ImplFrameWithMainFrameInProgress(
+    int64 begin_main_frame_to_commit_estimate_in_ms,
+    bool should_draw_without_waiting) {
+  // Set up client with the specified commit estimate (draw duration and
+  // activation are set to 1).
+  SchedulerClientWithFixedEstimates client(
+      base::TimeDelta::FromMilliseconds(1),
+      base::TimeDelta::FromMilliseconds(
+          begin_main_frame_to_commit_estimate_in_ms),
+      base::TimeDelta::FromMilliseconds(1));
+  SchedulerSettings default_scheduler_settings;
+  Scheduler* scheduler = client.CreateScheduler(default_scheduler_settings);
+  scheduler->SetCanStart();
+  scheduler->SetVisible(true);
+  scheduler->SetCanDraw(true);
+  InitializeOutputSurfaceAndFirstCommit(scheduler);
+
+  // The impl thread has something to draw while the main thread works on a
+  // new frame.
+  client.Reset();
+  scheduler->SetNeedsCommit();
+  scheduler->SetNeedsRedraw();
+  scheduler->BeginImplFrame(BeginFrameArgs::CreateForTesting());
+  EXPECT_TRUE(client.HasAction("ScheduledActionSendBeginMainFrame"));
+  EXPECT_TRUE(scheduler->BeginImplFrameDeadlinePending());
+
+  // Only a deadline that was triggered early runs right away.
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(should_draw_without_waiting,
+            client.HasAction("ScheduledActionDrawAndSwapIfPossible"));
+  EXPECT_NE(should_draw_without_waiting,
+            scheduler->BeginImplFrameDeadlinePending());
+}
+
+TEST(SchedulerTest, WaitForMainFrameThatCanCommitBeforeDeadline) {
+  // Set up client so that estimates indicate that the commit can finish
+  // before the deadline (~8ms by default).
+  ImplFrameWithMainFrameInProgress(1, false);
+}
+
+TEST(SchedulerTest, DrawWithoutWaitingForMainFrameThatWillMissDeadline) {
+  // Set up client so that estimates indicate that the commit cannot finish
+  // before the deadline (~8ms by default).
+  ImplFrameWithMainFrameInProgress(32, true);
+}
+
 void SpinForMillis(int millis) {
   base::RunLoop run_loop;
   base::MessageLoop::current()->PostDelayedTask(
@@ -24,6 +24,9 @@ class CC_SURFACES_EXPORT Surface {
 
   const gfx::Size& size() const { return size_; }
   int surface_id() const { return surface_id_; }
+  // Increases every time a frame is queued, so that consumers can tell
+  // whether the surface has changed since they last looked at it.
+  int frame_index() const { return frame_index_; }
 
   void QueueFrame(scoped_ptr<CompositorFrame> frame);
   // Returns the most recent frame that is eligible to be rendered.
@@ -34,6 +37,7 @@ class CC_SURFACES_EXPORT Surface {
   SurfaceClient* client_;
   gfx::Size size_;
   int surface_id_;
+  int frame_index_;
   // TODO(jamesr): Support multiple frames in flight.
   scoped_ptr<CompositorFrame> current_frame_;
 
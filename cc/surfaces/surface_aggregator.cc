@@ -6,6 +6,7 @@
 
 #include "base/containers/hash_tables.h"
 #include "base/logging.h"
+#include "cc/base/math_util.h"
 #include "cc/output/compositor_frame.h"
 #include "cc/output/delegated_frame_data.h"
 #include "cc/quads/draw_quad.h"
@@ -24,6 +25,10 @@ SurfaceAggregator::SurfaceAggregator(SurfaceManager* manager)
 
 SurfaceAggregator::~SurfaceAggregator() {}
 
+SurfaceAggregator::AggregatedSurface::AggregatedSurface() : reusable(true) {}
+
+SurfaceAggregator::AggregatedSurface::~AggregatedSurface() {}
+
 DelegatedFrameData* SurfaceAggregator::GetReferencedDataForSurfaceID(
     int surface_id) {
   Surface* referenced_surface = manager_->GetSurfaceForID(surface_id);
@@ -35,6 +40,13 @@ DelegatedFrameData* SurfaceAggregator::GetReferencedDataForSurfaceID(
   return referenced_frame->delegated_frame_data.get();
 }
 
+int SurfaceAggregator::GetFrameIndexForSurfaceID(int surface_id) {
+  Surface* surface = manager_->GetSurfaceForID(surface_id);
+  if (!surface || !surface->GetEligibleFrame())
+    return -1;
+  return surface->frame_index();
+}
+
 class SurfaceAggregator::RenderPassIdAllocator {
  public:
   explicit RenderPassIdAllocator(int surface_id)
@@ -72,63 +84,168 @@ RenderPass::Id SurfaceAggregator::RemapPassId(
   return allocator->Remap(surface_local_pass_id);
 }
 
-void SurfaceAggregator::HandleSurfaceQuad(const SurfaceDrawQuad* surface_quad,
-                                          RenderPass* dest_pass) {
-  int surface_id = surface_quad->surface_id;
-  // If this surface's id is already in our referenced set then it creates
-  // a cycle in the graph and should be dropped.
-  if (referenced_surfaces_.count(surface_id))
-    return;
+SurfaceAggregator::AggregatedSurface* SurfaceAggregator::GetAggregatedSurface(
+    int surface_id,
+    bool* changed) {
+  AggregatedSurface* aggregated = aggregated_surfaces_.get(surface_id);
+  if (aggregated && aggregated->reusable) {
+    // The passes are up to date if no surface in them has queued a frame
+    // since they were built. They can't be reused where one of those
+    // surfaces is already being aggregated, since that would be a cycle.
+    bool up_to_date = true;
+    for (std::map<int, int>::const_iterator it =
+             aggregated->frame_indices.begin();
+         it != aggregated->frame_indices.end();
+         ++it) {
+      if (referenced_surfaces_.count(it->first) ||
+          GetFrameIndexForSurfaceID(it->first) != it->second) {
+        up_to_date = false;
+        break;
+      }
+    }
+    if (up_to_date) {
+      for (std::map<int, int>::const_iterator it =
+               aggregated->frame_indices.begin();
+           it != aggregated->frame_indices.end();
+           ++it)
+        used_surfaces_.insert(it->first);
+      *changed = built_surfaces_.count(surface_id) > 0;
+      return aggregated;
+    }
+  }
+
   DelegatedFrameData* referenced_data =
       GetReferencedDataForSurfaceID(surface_id);
-  if (!referenced_data)
-    return;
+  if (!referenced_data || referenced_data->render_pass_list.empty()) {
+    aggregated_surfaces_.erase(surface_id);
+    return NULL;
+  }
+  // The damage of the surface's own frame has already been drawn if the
+  // passes are only rebuilt because an embedded surface changed.
+  int frame_index = GetFrameIndexForSurfaceID(surface_id);
+  bool frame_changed =
+      !aggregated || aggregated->frame_indices[surface_id] != frame_index;
+  bool was_aggregated = !!aggregated;
+
+  scoped_ptr<AggregatedSurface> new_aggregated(new AggregatedSurface);
+  new_aggregated->frame_indices[surface_id] = frame_index;
+
   std::set<int>::iterator it = referenced_surfaces_.insert(surface_id).first;
+  building_surfaces_.push_back(new_aggregated.get());
+  RenderPassList* parent_pass_list = dest_pass_list_;
+  dest_pass_list_ = &new_aggregated->passes;
 
-  const RenderPassList& referenced_passes = referenced_data->render_pass_list;
-  for (size_t j = 0; j + 1 < referenced_passes.size(); ++j) {
-    const RenderPass& source = *referenced_passes[j];
+  CopyPasses(referenced_data->render_pass_list, surface_id, frame_changed);
 
-    scoped_ptr<RenderPass> copy_pass(RenderPass::Create());
+  dest_pass_list_ = parent_pass_list;
+  building_surfaces_.pop_back();
+  referenced_surfaces_.erase(it);
 
-    RenderPass::Id remapped_pass_id = RemapPassId(source.id, surface_id);
+  // Nothing of a surface that wasn't aggregated before has been drawn yet.
+  if (!was_aggregated) {
+    RenderPass* root_pass = new_aggregated->passes.back();
+    root_pass->damage_rect = root_pass->output_rect;
+  }
 
-    copy_pass->SetAll(remapped_pass_id,
-                      source.output_rect,
-                      source.damage_rect,
-                      source.transform_to_root_target,
-                      source.has_transparent_background,
-                      source.overlay_state);
+  used_surfaces_.insert(surface_id);
+  built_surfaces_.insert(surface_id);
+  aggregated = new_aggregated.get();
+  aggregated_surfaces_.set(surface_id, new_aggregated.Pass());
+  *changed = true;
+  return aggregated;
+}
+
+void SurfaceAggregator::EmitAggregatedSurface(
+    const AggregatedSurface& aggregated,
+    bool changed,
+    const gfx::Transform& transform,
+    RenderPass* dest_pass) {
+  const RenderPassList& passes = aggregated.passes;
+  for (size_t i = 0; i < passes.size(); ++i) {
+    const RenderPass& source = *passes[i];
+
+    if (dest_pass && i + 1 == passes.size()) {
+      CopyAggregatedQuadsToPass(source, transform, dest_pass);
+      if (changed) {
+        dest_pass->damage_rect.Union(
+            MathUtil::MapClippedRect(transform, source.damage_rect));
+      }
+      continue;
+    }
+
+    scoped_ptr<RenderPass> copy_pass = source.Copy(source.id);
 
     // Contributing passes aggregated in to the pass list need to take the
     // transform of the surface quad into account to update their transform to
     // the root surface.
-    // TODO(jamesr): Make sure this is sufficient for surfaces nested several
-    // levels deep and add tests.
-    copy_pass->transform_to_root_target.ConcatTransform(
-        surface_quad->quadTransform());
+    copy_pass->transform_to_root_target.ConcatTransform(transform);
 
-    CopyQuadsToPass(source.quad_list,
-                    source.shared_quad_state_list,
-                    gfx::Transform(),
-                    copy_pass.get(),
-                    surface_id);
+    // Passes that were already aggregated last time haven't changed since.
+    if (!changed)
+      copy_pass->damage_rect = gfx::RectF();
+
+    CopyAggregatedQuadsToPass(source, gfx::Transform(), copy_pass.get());
 
     dest_pass_list_->push_back(copy_pass.Pass());
   }
+}
 
-  // TODO(jamesr): Clean up last pass special casing.
-  const RenderPass& last_pass = *referenced_data->render_pass_list.back();
-  const QuadList& quads = last_pass.quad_list;
+void SurfaceAggregator::CopyAggregatedQuadsToPass(
+    const RenderPass& source_pass,
+    const gfx::Transform& transform,
+    RenderPass* dest_pass) {
+  const SharedQuadState* last_copied_source_shared_quad_state = NULL;
 
-  // TODO(jamesr): Make sure clipping is enforced.
-  CopyQuadsToPass(quads,
-                  last_pass.shared_quad_state_list,
-                  surface_quad->quadTransform(),
-                  dest_pass,
-                  surface_id);
+  for (size_t i = 0; i < source_pass.quad_list.size(); ++i) {
+    const DrawQuad* quad = source_pass.quad_list[i];
+    if (quad->shared_quad_state != last_copied_source_shared_quad_state) {
+      CopySharedQuadState(*quad->shared_quad_state,
+                          transform,
+                          &dest_pass->shared_quad_state_list);
+      last_copied_source_shared_quad_state = quad->shared_quad_state;
+    }
 
-  referenced_surfaces_.erase(it);
+    // Render pass ids were already remapped when |source_pass| was built.
+    if (quad->material == DrawQuad::RENDER_PASS) {
+      const RenderPassDrawQuad* pass_quad =
+          RenderPassDrawQuad::MaterialCast(quad);
+      dest_pass->quad_list.push_back(
+          pass_quad->Copy(dest_pass->shared_quad_state_list.back(),
+                          pass_quad->render_pass_id).PassAs<DrawQuad>());
+    } else {
+      dest_pass->quad_list.push_back(
+          quad->Copy(dest_pass->shared_quad_state_list.back()));
+    }
+  }
+}
+
+void SurfaceAggregator::HandleSurfaceQuad(const SurfaceDrawQuad* surface_quad,
+                                          RenderPass* dest_pass) {
+  DCHECK(!building_surfaces_.empty());
+  AggregatedSurface* parent = building_surfaces_.back();
+
+  int surface_id = surface_quad->surface_id;
+  // If this surface's id is already in our referenced set then it creates
+  // a cycle in the graph and should be dropped.
+  if (referenced_surfaces_.count(surface_id)) {
+    parent->reusable = false;
+    return;
+  }
+
+  bool changed = false;
+  AggregatedSurface* aggregated = GetAggregatedSurface(surface_id, &changed);
+  if (!aggregated) {
+    // The parent needs rebuilding once this surface gets a frame.
+    parent->frame_indices[surface_id] = GetFrameIndexForSurfaceID(surface_id);
+    return;
+  }
+  parent->frame_indices.insert(aggregated->frame_indices.begin(),
+                               aggregated->frame_indices.end());
+  parent->reusable &= aggregated->reusable;
+
+  // TODO(jamesr): Make sure clipping is enforced.
+  EmitAggregatedSurface(
+      *aggregated, changed, surface_quad->quadTransform(), dest_pass);
 }
 
 void SurfaceAggregator::CopySharedQuadState(
@@ -192,7 +309,8 @@ void SurfaceAggregator::CopyQuadsToPass(
 }
 
 void SurfaceAggregator::CopyPasses(const RenderPassList& source_pass_list,
-                                   int surface_id) {
+                                   int surface_id,
+                                   bool frame_changed) {
   for (size_t i = 0; i < source_pass_list.size(); ++i) {
     const RenderPass& source = *source_pass_list[i];
 
@@ -206,6 +324,8 @@ void SurfaceAggregator::CopyPasses(const RenderPassList& source_pass_list,
                       source.transform_to_root_target,
                       source.has_transparent_background,
                       source.overlay_state);
+    if (!frame_changed)
+      copy_pass->damage_rect = gfx::RectF();
 
     CopyQuadsToPass(source.quad_list,
                     source.shared_quad_state_list,
@@ -218,30 +338,31 @@ void SurfaceAggregator::CopyPasses(const RenderPassList& source_pass_list,
 }
 
 scoped_ptr<CompositorFrame> SurfaceAggregator::Aggregate(int surface_id) {
-  Surface* surface = manager_->GetSurfaceForID(surface_id);
-  if (!surface)
-    return scoped_ptr<CompositorFrame>();
-  CompositorFrame* root_surface_frame = surface->GetEligibleFrame();
-  if (!root_surface_frame)
-    return scoped_ptr<CompositorFrame>();
-
-  scoped_ptr<CompositorFrame> frame(new CompositorFrame);
-  frame->delegated_frame_data = make_scoped_ptr(new DelegatedFrameData);
-
-  DCHECK(root_surface_frame->delegated_frame_data);
-
-  const RenderPassList& source_pass_list =
-      root_surface_frame->delegated_frame_data->render_pass_list;
+  DCHECK(referenced_surfaces_.empty());
 
-  std::set<int>::iterator it = referenced_surfaces_.insert(surface_id).first;
+  bool changed = false;
+  AggregatedSurface* aggregated = GetAggregatedSurface(surface_id, &changed);
 
-  dest_pass_list_ = &frame->delegated_frame_data->render_pass_list;
-  CopyPasses(source_pass_list, surface_id);
+  scoped_ptr<CompositorFrame> frame;
+  if (aggregated) {
+    frame.reset(new CompositorFrame);
+    frame->delegated_frame_data = make_scoped_ptr(new DelegatedFrameData);
 
-  referenced_surfaces_.erase(it);
-  DCHECK(referenced_surfaces_.empty());
+    dest_pass_list_ = &frame->delegated_frame_data->render_pass_list;
+    EmitAggregatedSurface(*aggregated, changed, gfx::Transform(), NULL);
+    dest_pass_list_ = NULL;
+  }
 
-  dest_pass_list_ = NULL;
+  // Drop the passes of surfaces that are no longer embedded.
+  for (AggregatedSurfaceMap::iterator it = aggregated_surfaces_.begin();
+       it != aggregated_surfaces_.end();) {
+    if (used_surfaces_.count(it->first))
+      ++it;
+    else
+      aggregated_surfaces_.erase(it++);
+  }
+  built_surfaces_.clear();
+  used_surfaces_.clear();
 
   // TODO(jamesr): Aggregate all resource references into the returned frame's
   // resource list.
@@ -5,7 +5,9 @@
 #ifndef CC_SURFACES_SURFACE_AGGREGATOR_H_
 #define CC_SURFACES_SURFACE_AGGREGATOR_H_
 
+#include <map>
 #include <set>
+#include <vector>
 
 #include "base/containers/scoped_ptr_hash_map.h"
 #include "base/memory/scoped_ptr.h"
@@ -19,6 +21,11 @@ class DelegatedFrameData;
 class SurfaceDrawQuad;
 class SurfaceManager;
 
+// Flattens a surface and the surfaces it embeds into a single frame. The
+// flattened passes of each surface are kept between calls to Aggregate(), and
+// reused as long as neither the surface nor any surface it embeds has queued
+// a new frame. Only the damage of surfaces that did is added to the passes
+// they are drawn into.
 class CC_SURFACES_EXPORT SurfaceAggregator {
  public:
   explicit SurfaceAggregator(SurfaceManager* manager);
@@ -27,7 +34,40 @@ class CC_SURFACES_EXPORT SurfaceAggregator {
   scoped_ptr<CompositorFrame> Aggregate(int surface_id);
 
  private:
+  // The passes of a surface's frame with all embedded surfaces flattened into
+  // them. The last one is the surface's root pass.
+  struct AggregatedSurface {
+    AggregatedSurface();
+    ~AggregatedSurface();
+
+    RenderPassList passes;
+    // The frame index of this surface and of every surface it embeds, or -1
+    // for embedded surfaces that had no frame, when |passes| were built.
+    std::map<int, int> frame_indices;
+    // False if a reference was dropped to break a cycle. Which reference
+    // that is depends on where the surface is embedded, so the passes can't
+    // be reused.
+    bool reusable;
+  };
+
   DelegatedFrameData* GetReferencedDataForSurfaceID(int surface_id);
+  int GetFrameIndexForSurfaceID(int surface_id);
+
+  // Returns the up to date flattened passes of |surface_id|, building them if
+  // needed, or NULL if the surface has no frame. |changed| is set to whether
+  // they were built during this call to Aggregate().
+  AggregatedSurface* GetAggregatedSurface(int surface_id, bool* changed);
+  // Copies |aggregated|'s passes into the aggregated frame. The root pass's
+  // quads are drawn into |dest_pass| with |transform|, unless |dest_pass| is
+  // NULL, in which case the root pass is copied too.
+  void EmitAggregatedSurface(const AggregatedSurface& aggregated,
+                             bool changed,
+                             const gfx::Transform& transform,
+                             RenderPass* dest_pass);
+  void CopyAggregatedQuadsToPass(const RenderPass& source_pass,
+                                 const gfx::Transform& transform,
+                                 RenderPass* dest_pass);
+
   RenderPass::Id RemapPassId(RenderPass::Id surface_local_pass_id,
                              int surface_id);
 
@@ -41,7 +81,9 @@ class CC_SURFACES_EXPORT SurfaceAggregator {
                        const gfx::Transform& content_to_target_transform,
                        RenderPass* dest_pass,
                        int surface_id);
-  void CopyPasses(const RenderPassList& source_pass_list, int surface_id);
+  void CopyPasses(const RenderPassList& source_pass_list,
+                  int surface_id,
+                  bool frame_changed);
 
   SurfaceManager* manager_;
 
@@ -50,6 +92,9 @@ class CC_SURFACES_EXPORT SurfaceAggregator {
       RenderPassIdAllocatorMap;
   RenderPassIdAllocatorMap render_pass_allocator_map_;
 
+  typedef base::ScopedPtrHashMap<int, AggregatedSurface> AggregatedSurfaceMap;
+  AggregatedSurfaceMap aggregated_surfaces_;
+
   // The following state is only valid for the duration of one Aggregate call
   // and is only stored on the class to avoid having to pass through every
   // function call.
@@ -58,9 +103,17 @@ class CC_SURFACES_EXPORT SurfaceAggregator {
   // detect cycles.
   std::set<int> referenced_surfaces_;
 
-  // This is the pass list for the aggregated frame.
+  // This is the pass list that passes are being aggregated into.
   RenderPassList* dest_pass_list_;
 
+  // The surfaces whose passes are being built, innermost last.
+  std::vector<AggregatedSurface*> building_surfaces_;
+
+  // The surfaces whose passes were built, and the ones that were used, by
+  // this aggregation.
+  std::set<int> built_surfaces_;
+  std::set<int> used_surfaces_;
+
   DISALLOW_COPY_AND_ASSIGN(SurfaceAggregator);
 };
 
@@ -698,6 +698,66 @@ TEST_F(SurfaceAggregatorValidSurfaceTest, AggregateMultiplePassWithTransform) {
   }
 }
 
+// This tests that the passes of surfaces that haven't queued a new frame are
+// reused, and that only the damage of the surfaces that have is reported.
+TEST_F(SurfaceAggregatorValidSurfaceTest, DamageOfUnchangedSurfacesIsDropped) {
+  gfx::Size surface_size(5, 5);
+  RenderPass::Id pass_id(1, 1);
+
+  Surface embedded_surface(&manager_, NULL, surface_size);
+  test::Quad embedded_quads[] = {test::Quad::SolidColorQuad(SK_ColorGREEN)};
+  test::Pass embedded_passes[] = {
+      test::Pass(embedded_quads, arraysize(embedded_quads))};
+  SubmitFrame(embedded_passes, arraysize(embedded_passes), &embedded_surface);
+
+  test::Quad root_quads[] = {
+      test::Quad::SolidColorQuad(SK_ColorWHITE),
+      test::Quad::SurfaceQuad(embedded_surface.surface_id())};
+  test::Pass root_passes[] = {test::Pass(root_quads, arraysize(root_quads))};
+  SubmitFrame(root_passes, arraysize(root_passes), &root_surface_);
+
+  test::Quad expected_quads[] = {test::Quad::SolidColorQuad(SK_ColorWHITE),
+                                 test::Quad::SolidColorQuad(SK_ColorGREEN)};
+  test::Pass expected_passes[] = {
+      test::Pass(expected_quads, arraysize(expected_quads))};
+
+  // Everything is new the first time around.
+  scoped_ptr<CompositorFrame> aggregated_frame =
+      aggregator_.Aggregate(root_surface_.surface_id());
+  ASSERT_TRUE(aggregated_frame);
+  RenderPassList* pass_list =
+      &aggregated_frame->delegated_frame_data->render_pass_list;
+  TestPassesMatchExpectations(
+      expected_passes, arraysize(expected_passes), pass_list);
+  EXPECT_EQ(gfx::RectF(surface_size).ToString(),
+            pass_list->back()->damage_rect.ToString());
+
+  // Nothing changed, so nothing is damaged.
+  aggregated_frame = aggregator_.Aggregate(root_surface_.surface_id());
+  ASSERT_TRUE(aggregated_frame);
+  pass_list = &aggregated_frame->delegated_frame_data->render_pass_list;
+  TestPassesMatchExpectations(
+      expected_passes, arraysize(expected_passes), pass_list);
+  EXPECT_TRUE(pass_list->back()->damage_rect.IsEmpty());
+
+  // Only the damage of the embedded surface's new frame is reported.
+  gfx::RectF embedded_damage(1, 2, 2, 1);
+  scoped_ptr<RenderPass> embedded_pass = RenderPass::Create();
+  embedded_pass->SetNew(
+      pass_id, gfx::Rect(surface_size), embedded_damage, gfx::Transform());
+  AddSolidColorQuadWithBlendMode(
+      surface_size, embedded_pass.get(), SkXfermode::kSrcOver_Mode);
+  test::QueuePassAsFrame(embedded_pass.Pass(), &embedded_surface);
+
+  aggregated_frame = aggregator_.Aggregate(root_surface_.surface_id());
+  ASSERT_TRUE(aggregated_frame);
+  pass_list = &aggregated_frame->delegated_frame_data->render_pass_list;
+  TestPassesMatchExpectations(
+      expected_passes, arraysize(expected_passes), pass_list);
+  EXPECT_EQ(embedded_damage.ToString(),
+            pass_list->back()->damage_rect.ToString());
+}
+
 }  // namespace
 }  // namespace cc
 
@@ -1078,7 +1078,6 @@ static void PreCalculateMetaInformation(
     num_descendants_that_draw_content = 1000;
   }
 
-  layer->draw_properties().sorted_for_recursion = false;
   layer->draw_properties().has_child_with_a_scroll_parent = false;
 
   if (layer->clip_parent())
@@ -1230,6 +1229,11 @@ template <typename LayerType>
 static bool SortChildrenForRecursion(std::vector<LayerType*>* out,
                                      const LayerType& parent) {
   out->reserve(parent.children().size());
+  for (size_t i = 0; i < parent.children().size(); ++i) {
+    LayerTreeHostCommon::get_child_as_raw_ptr(parent.children(), i)
+        ->draw_properties().sorted_for_recursion = false;
+  }
+
   bool order_changed = false;
   for (size_t i = 0; i < parent.children().size(); ++i) {
     LayerType* current =
@@ -2210,8 +2214,12 @@ void LayerTreeHostCommon::CalculateDrawProperties(
   data_for_recursion.subtree_can_use_lcd_text = inputs->can_use_lcd_text;
   data_for_recursion.subtree_is_visible_from_ancestor = true;
 
-  PreCalculateMetaInformationRecursiveData recursive_data;
-  PreCalculateMetaInformation(inputs->root_layer, &recursive_data);
+  // Scrolling and animations don't change the meta information, so it only
+  // needs to be gathered again when the tree's structure has changed.
+  if (!inputs->can_reuse_meta_information) {
+    PreCalculateMetaInformationRecursiveData recursive_data;
+    PreCalculateMetaInformation(inputs->root_layer, &recursive_data);
+  }
   std::vector<AccumulatedSurfaceState<LayerImpl> >
       accumulated_surface_state;
   CalculateDrawPropertiesInternal<LayerImpl>(inputs->root_layer,
@@ -52,7 +52,8 @@ class CC_EXPORT LayerTreeHostCommon {
           can_use_lcd_text(can_use_lcd_text),
           can_render_to_separate_surface(can_render_to_separate_surface),
           can_adjust_raster_scales(can_adjust_raster_scales),
-          render_surface_layer_list(render_surface_layer_list) {}
+          render_surface_layer_list(render_surface_layer_list),
+          can_reuse_meta_information(false) {}
 
     LayerType* root_layer;
     gfx::Size device_viewport_size;
@@ -65,6 +66,11 @@ class CC_EXPORT LayerTreeHostCommon {
     bool can_render_to_separate_surface;
     bool can_adjust_raster_scales;
     RenderSurfaceLayerListType* render_surface_layer_list;
+    // Set when nothing that the per-subtree meta information depends on
+    // (children, DrawsContent(), clip and scroll parents, copy requests) has
+    // changed since the last calculation for this tree, so that pass can be
+    // skipped. Only honored for LayerImpl trees.
+    bool can_reuse_meta_information;
   };
 
   template <typename LayerType, typename RenderSurfaceLayerListType>
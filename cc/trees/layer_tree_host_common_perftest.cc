@@ -13,6 +13,7 @@
 #include "base/threading/thread.h"
 #include "base/time/time.h"
 #include "cc/layers/layer.h"
+#include "cc/layers/layer_impl.h"
 #include "cc/test/fake_content_layer_client.h"
 #include "cc/test/fake_layer_tree_host_client.h"
 #include "cc/test/lap_timer.h"
@@ -20,6 +21,8 @@
 #include "cc/test/layer_tree_test.h"
 #include "cc/test/paths.h"
 #include "cc/trees/layer_tree_impl.h"
+#include "cc/trees/property_tree.h"
+#include "cc/trees/property_tree_builder.h"
 #include "testing/perf/perf_test.h"
 
 namespace cc {
@@ -146,6 +149,111 @@ class CalcDrawPropsImplTest : public LayerTreeHostCommonPerfTest {
   }
 };
 
+// Measures building property trees for the same layer trees and computing
+// screen space transforms, clips and opacities from them, for comparison
+// with CalcDrawPropsImplTest.
+class PropertyTreesImplTest : public LayerTreeHostCommonPerfTest {
+ public:
+  void RunPropertyTrees() {
+    RunTestWithImplSidePainting();
+  }
+
+  virtual void BeginTest() OVERRIDE {
+    PostSetNeedsCommitToMainThread();
+  }
+
+  virtual void DrawLayersOnThread(LayerTreeHostImpl* host_impl) OVERRIDE {
+    timer_.Reset();
+    LayerTreeImpl* active_tree = host_impl->active_tree();
+
+    do {
+      TransformTree transform_tree;
+      ClipTree clip_tree;
+      EffectTree effect_tree;
+      PropertyTreeBuilder::BuildPropertyTrees(
+          active_tree->root_layer(),
+          host_impl->DrawTransform(),
+          gfx::Rect(active_tree->DrawViewportSize()),
+          &transform_tree,
+          &clip_tree,
+          &effect_tree);
+      transform_tree.UpdateScreenSpaceTransforms();
+      clip_tree.UpdateScreenSpaceClips(transform_tree);
+      effect_tree.UpdateScreenSpaceOpacities();
+
+      timer_.NextLap();
+    } while (!timer_.HasTimeLimitExpired());
+
+    EndTest();
+  }
+};
+
+// Measures LayerTreeImpl::UpdateDrawProperties() when only one layer's
+// scroll offset or transform changes between updates, as happens while
+// scrolling or running an animation on the impl thread.
+class UpdateDrawPropsImplTest : public LayerTreeHostCommonPerfTest {
+ public:
+  enum UpdateType {
+    SCROLL_ONLY,
+    ANIMATION_ONLY,
+  };
+
+  void RunUpdateDrawProps(UpdateType update_type) {
+    update_type_ = update_type;
+    RunTestWithImplSidePainting();
+  }
+
+  virtual void BeginTest() OVERRIDE {
+    PostSetNeedsCommitToMainThread();
+  }
+
+  virtual void DrawLayersOnThread(LayerTreeHostImpl* host_impl) OVERRIDE {
+    timer_.Reset();
+    LayerTreeImpl* active_tree = host_impl->active_tree();
+    LayerImpl* root = active_tree->root_layer();
+    LayerImpl* changing_layer = update_type_ == SCROLL_ONLY
+                                    ? FindScrollableLayer(root)
+                                    : FindAnimatedLayer(root);
+    ASSERT_TRUE(changing_layer);
+
+    int lap = 0;
+    do {
+      float delta = static_cast<float>(lap++ % 2);
+      if (update_type_ == SCROLL_ONLY) {
+        changing_layer->SetScrollDelta(gfx::Vector2dF(0.f, delta));
+      } else {
+        gfx::Transform transform;
+        transform.Translate(delta, 0.f);
+        changing_layer->SetTransform(transform);
+      }
+      active_tree->UpdateDrawProperties();
+
+      timer_.NextLap();
+    } while (!timer_.HasTimeLimitExpired());
+
+    EndTest();
+  }
+
+ private:
+  static LayerImpl* FindScrollableLayer(LayerImpl* layer) {
+    if (layer->scrollable())
+      return layer;
+    for (size_t i = 0; i < layer->children().size(); ++i) {
+      if (LayerImpl* found = FindScrollableLayer(layer->children()[i]))
+        return found;
+    }
+    return NULL;
+  }
+
+  // Animates the first child of the root, so that a subtree rather than the
+  // whole tree moves.
+  static LayerImpl* FindAnimatedLayer(LayerImpl* root) {
+    return root->children().empty() ? root : root->children()[0];
+  }
+
+  UpdateType update_type_;
+};
+
 TEST_F(CalcDrawPropsMainTest, TenTen) {
   SetTestName("10_10_main_thread");
   ReadTestFile("10_10_layer_tree");
@@ -194,5 +302,41 @@ TEST_F(CalcDrawPropsImplTest, TouchRegionHeavy) {
   RunCalcDrawProps();
 }
 
+TEST_F(PropertyTreesImplTest, HeavyPage) {
+  SetTestName("heavy_page_property_trees");
+  ReadTestFile("heavy_layer_tree");
+  RunPropertyTrees();
+}
+
+TEST_F(PropertyTreesImplTest, TouchRegionHeavy) {
+  SetTestName("touch_region_heavy_property_trees");
+  ReadTestFile("touch_region_heavy");
+  RunPropertyTrees();
+}
+
+TEST_F(UpdateDrawPropsImplTest, HeavyPageScrollOnly) {
+  SetTestName("heavy_page_scroll_only");
+  ReadTestFile("heavy_layer_tree");
+  RunUpdateDrawProps(SCROLL_ONLY);
+}
+
+TEST_F(UpdateDrawPropsImplTest, HeavyPageAnimationOnly) {
+  SetTestName("heavy_page_animation_only");
+  ReadTestFile("heavy_layer_tree");
+  RunUpdateDrawProps(ANIMATION_ONLY);
+}
+
+TEST_F(UpdateDrawPropsImplTest, TouchRegionHeavyScrollOnly) {
+  SetTestName("touch_region_heavy_scroll_only");
+  ReadTestFile("touch_region_heavy");
+  RunUpdateDrawProps(SCROLL_ONLY);
+}
+
+TEST_F(UpdateDrawPropsImplTest, TouchRegionHeavyAnimationOnly) {
+  SetTestName("touch_region_heavy_animation_only");
+  ReadTestFile("touch_region_heavy");
+  RunUpdateDrawProps(ANIMATION_ONLY);
+}
+
 }  // namespace
 }  // namespace cc
@@ -5281,6 +5281,49 @@ TEST_F(LayerTreeHostImplTest, FarAwayQuadsDontNeedAA) {
   host_impl_->DidDrawAllLayers(frame);
 }
 
+TEST_F(LayerTreeHostImplTest, UpdateDrawPropertiesAfterDrawsContentChange) {
+  // The information gathered about each subtree before calculating draw
+  // properties is reused while only scroll offsets change, but must be
+  // recomputed when a layer stops drawing content.
+  scoped_ptr<LayerImpl> root = LayerImpl::Create(host_impl_->active_tree(), 1);
+  root->SetBounds(gfx::Size(100, 100));
+  root->SetContentBounds(gfx::Size(100, 100));
+
+  scoped_ptr<LayerImpl> scoped_surface_layer =
+      LayerImpl::Create(host_impl_->active_tree(), 2);
+  LayerImpl* surface_layer = scoped_surface_layer.get();
+  surface_layer->SetBounds(gfx::Size(50, 50));
+  surface_layer->SetContentBounds(gfx::Size(50, 50));
+  surface_layer->SetOpacity(0.5f);
+  surface_layer->SetScrollClipLayer(root->id());
+  root->AddChild(scoped_surface_layer.Pass());
+
+  LayerImpl* children[2];
+  for (int i = 0; i < 2; ++i) {
+    scoped_ptr<LayerImpl> child =
+        LayerImpl::Create(host_impl_->active_tree(), 3 + i);
+    child->SetBounds(gfx::Size(10, 10));
+    child->SetContentBounds(gfx::Size(10, 10));
+    child->SetDrawsContent(true);
+    children[i] = child.get();
+    surface_layer->AddChild(child.Pass());
+  }
+  host_impl_->active_tree()->SetRootLayer(root.Pass());
+
+  // Two descendants draw content under a translucent layer, so it needs a
+  // render surface.
+  host_impl_->active_tree()->UpdateDrawProperties();
+  EXPECT_EQ(2u, host_impl_->active_tree()->RenderSurfaceLayerList().size());
+
+  surface_layer->SetScrollDelta(gfx::Vector2dF(0.f, 5.f));
+  host_impl_->active_tree()->UpdateDrawProperties();
+  EXPECT_EQ(2u, host_impl_->active_tree()->RenderSurfaceLayerList().size());
+
+  // With only one of them left, the layer draws without a surface.
+  children[1]->SetDrawsContent(false);
+  host_impl_->active_tree()->UpdateDrawProperties();
+  EXPECT_EQ(1u, host_impl_->active_tree()->RenderSurfaceLayerList().size());
+}
 
 class CompositorFrameMetadataTest : public LayerTreeHostImplTest {
  public:
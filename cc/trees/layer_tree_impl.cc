@@ -94,6 +94,7 @@ LayerTreeImpl::LayerTreeImpl(LayerTreeHostImpl* layer_tree_host_impl)
       requires_high_res_to_draw_(false),
       viewport_size_invalid_(false),
       needs_update_draw_properties_(true),
+      needs_update_meta_information_(true),
       needs_full_tree_sync_(true),
       next_activation_forces_redraw_(false) {}
 
@@ -119,6 +120,7 @@ void LayerTreeImpl::SetRootLayer(scoped_ptr<LayerImpl> layer) {
   inner_viewport_scroll_layer_ = NULL;
   outer_viewport_scroll_layer_ = NULL;
   page_scale_layer_ = NULL;
+  set_needs_update_meta_information();
 
   layer_tree_host_impl_->OnCanDrawStateChangedForTree();
 }
@@ -467,7 +469,9 @@ void LayerTreeImpl::UpdateDrawProperties() {
         can_render_to_separate_surface,
         settings().layer_transforms_should_scale_layer_contents,
         &render_surface_layer_list_);
+    inputs.can_reuse_meta_information = !needs_update_meta_information_;
     LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+    needs_update_meta_information_ = false;
   }
 
   {
@@ -525,11 +529,13 @@ LayerImpl* LayerTreeImpl::LayerById(int id) {
 void LayerTreeImpl::RegisterLayer(LayerImpl* layer) {
   DCHECK(!LayerById(layer->id()));
   layer_id_map_[layer->id()] = layer;
+  set_needs_update_meta_information();
 }
 
 void LayerTreeImpl::UnregisterLayer(LayerImpl* layer) {
   DCHECK(LayerById(layer->id()));
   layer_id_map_.erase(layer->id());
+  set_needs_update_meta_information();
 }
 
 void LayerTreeImpl::PushPersistedState(LayerTreeImpl* pending_tree) {
@@ -640,6 +646,11 @@ MemoryHistory* LayerTreeImpl::memory_history() const {
   return layer_tree_host_impl_->memory_history();
 }
 
+int LayerTreeImpl::LastFrameDrawCallCount() const {
+  Renderer* renderer = layer_tree_host_impl_->renderer();
+  return renderer ? renderer->LastFrameDrawCallCount() : 0;
+}
+
 bool LayerTreeImpl::device_viewport_valid_for_tile_management() const {
   return layer_tree_host_impl_->device_viewport_valid_for_tile_management();
 }
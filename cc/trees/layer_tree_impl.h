@@ -71,6 +71,7 @@ class CC_EXPORT LayerTreeImpl {
   FrameRateCounter* frame_rate_counter() const;
   PaintTimeCounter* paint_time_counter() const;
   MemoryHistory* memory_history() const;
+  int LastFrameDrawCallCount() const;
   bool device_viewport_valid_for_tile_management() const;
   bool IsActiveTree() const;
   bool IsPendingTree() const;
@@ -172,6 +173,14 @@ class CC_EXPORT LayerTreeImpl {
     return needs_update_draw_properties_;
   }
 
+  // Called when the layer hierarchy, the layers that draw content, clip or
+  // scroll parents, or copy requests change. Those determine the per-subtree
+  // information that CalculateDrawProperties() gathers before its main
+  // recursion; updates that only scroll or animate layers keep reusing it.
+  void set_needs_update_meta_information() {
+    needs_update_meta_information_ = true;
+  }
+
   void set_needs_full_tree_sync(bool needs) { needs_full_tree_sync_ = needs; }
   bool needs_full_tree_sync() const { return needs_full_tree_sync_; }
 
@@ -284,6 +293,7 @@ class CC_EXPORT LayerTreeImpl {
   bool requires_high_res_to_draw_;
   bool viewport_size_invalid_;
   bool needs_update_draw_properties_;
+  bool needs_update_meta_information_;
 
   // In impl-side painting mode, this is true when the tree may contain
   // structural differences relative to the active tree.
@@ -0,0 +1,81 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/trees/property_tree.h"
+
+#include "cc/base/math_util.h"
+
+namespace cc {
+
+TransformNodeData::TransformNodeData() : flattens_inherited_transform(false) {}
+
+TransformNodeData::~TransformNodeData() {}
+
+ClipNodeData::ClipNodeData() : transform_id(-1) {}
+
+EffectNodeData::EffectNodeData() : opacity(1.f), screen_space_opacity(1.f) {}
+
+template <typename T>
+PropertyTree<T>::PropertyTree() {}
+
+template <typename T>
+PropertyTree<T>::~PropertyTree() {}
+
+template <typename T>
+int PropertyTree<T>::Insert(const T& node, int parent_id) {
+  DCHECK_LT(parent_id, static_cast<int>(nodes_.size()));
+  DCHECK(parent_id > -1 || nodes_.empty());
+  nodes_.push_back(node);
+  T& inserted = nodes_.back();
+  inserted.id = static_cast<int>(nodes_.size()) - 1;
+  inserted.parent_id = parent_id;
+  return inserted.id;
+}
+
+template class PropertyTree<TransformNode>;
+template class PropertyTree<ClipNode>;
+template class PropertyTree<EffectNode>;
+
+void TransformTree::UpdateScreenSpaceTransforms() {
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    TransformNode& node = nodes_[i];
+    const TransformNode* parent_node = parent(&node);
+    if (!parent_node) {
+      node.data.to_screen = node.data.to_parent;
+      continue;
+    }
+
+    node.data.to_screen = parent_node->data.to_screen;
+    if (parent_node->data.flattens_inherited_transform)
+      node.data.to_screen.FlattenTo2d();
+    node.data.to_screen.PreconcatTransform(node.data.to_parent);
+  }
+}
+
+void ClipTree::UpdateScreenSpaceClips(const TransformTree& transform_tree) {
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    ClipNode& node = nodes_[i];
+    const TransformNode* transform_node =
+        transform_tree.Node(node.data.transform_id);
+    DCHECK(transform_node);
+    node.data.combined_clip_in_screen_space = MathUtil::MapClippedRect(
+        transform_node->data.to_screen, node.data.clip);
+
+    if (const ClipNode* parent_node = parent(&node)) {
+      node.data.combined_clip_in_screen_space.Intersect(
+          parent_node->data.combined_clip_in_screen_space);
+    }
+  }
+}
+
+void EffectTree::UpdateScreenSpaceOpacities() {
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    EffectNode& node = nodes_[i];
+    node.data.screen_space_opacity = node.data.opacity;
+    if (const EffectNode* parent_node = parent(&node))
+      node.data.screen_space_opacity *= parent_node->data.screen_space_opacity;
+  }
+}
+
+}  // namespace cc
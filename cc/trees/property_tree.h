@@ -0,0 +1,130 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CC_TREES_PROPERTY_TREE_H_
+#define CC_TREES_PROPERTY_TREE_H_
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/logging.h"
+#include "cc/base/cc_export.h"
+#include "ui/gfx/rect_f.h"
+#include "ui/gfx/transform.h"
+
+namespace cc {
+
+// A node of a property tree. |id| is the node's index in the tree and
+// |parent_id| its parent's, or -1 for the root.
+template <typename T>
+struct CC_EXPORT TreeNode {
+  TreeNode() : id(-1), parent_id(-1) {}
+
+  int id;
+  int parent_id;
+  T data;
+};
+
+struct CC_EXPORT TransformNodeData {
+  TransformNodeData();
+  ~TransformNodeData();
+
+  // Maps this node's space to its parent's.
+  gfx::Transform to_parent;
+
+  // Maps this node's space to the screen. Computed by
+  // TransformTree::UpdateScreenSpaceTransforms().
+  gfx::Transform to_screen;
+
+  // Whether children of this node are flattened to 2D before their own
+  // transforms apply.
+  bool flattens_inherited_transform;
+};
+
+typedef TreeNode<TransformNodeData> TransformNode;
+
+struct CC_EXPORT ClipNodeData {
+  ClipNodeData();
+
+  // The clip, in the space of |transform_id|.
+  gfx::RectF clip;
+
+  // The transform node that |clip| is in.
+  int transform_id;
+
+  // The intersection of this clip and its ancestors', in screen space.
+  // Computed by ClipTree::UpdateScreenSpaceClips().
+  gfx::RectF combined_clip_in_screen_space;
+};
+
+typedef TreeNode<ClipNodeData> ClipNode;
+
+struct CC_EXPORT EffectNodeData {
+  EffectNodeData();
+
+  float opacity;
+
+  // The product of this node's and its ancestors' opacities. Computed by
+  // EffectTree::UpdateScreenSpaceOpacities().
+  float screen_space_opacity;
+};
+
+typedef TreeNode<EffectNodeData> EffectNode;
+
+// A flat tree of layer properties. Nodes live in one vector and are inserted
+// after their parents, so a single forward pass over contiguous memory visits
+// every parent before its children, instead of chasing pointers through the
+// layer hierarchy. Layers refer to nodes by index, and layers that don't
+// change a property share their ancestor's node.
+template <typename T>
+class CC_EXPORT PropertyTree {
+ public:
+  PropertyTree();
+  virtual ~PropertyTree();
+
+  // Appends |node| as a child of |parent_id| and returns its id. The parent
+  // must already be in the tree.
+  int Insert(const T& node, int parent_id);
+
+  T* Node(int i) {
+    DCHECK_LT(i, static_cast<int>(nodes_.size()));
+    return i > -1 ? &nodes_[i] : NULL;
+  }
+  const T* Node(int i) const {
+    DCHECK_LT(i, static_cast<int>(nodes_.size()));
+    return i > -1 ? &nodes_[i] : NULL;
+  }
+
+  T* parent(const T* node) { return Node(node->parent_id); }
+  const T* parent(const T* node) const { return Node(node->parent_id); }
+
+  void clear() { nodes_.clear(); }
+  size_t size() const { return nodes_.size(); }
+
+ protected:
+  std::vector<T> nodes_;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(PropertyTree);
+};
+
+class CC_EXPORT TransformTree : public PropertyTree<TransformNode> {
+ public:
+  void UpdateScreenSpaceTransforms();
+};
+
+class CC_EXPORT ClipTree : public PropertyTree<ClipNode> {
+ public:
+  // |transform_tree| must have had its screen space transforms updated.
+  void UpdateScreenSpaceClips(const TransformTree& transform_tree);
+};
+
+class CC_EXPORT EffectTree : public PropertyTree<EffectNode> {
+ public:
+  void UpdateScreenSpaceOpacities();
+};
+
+}  // namespace cc
+
+#endif  // CC_TREES_PROPERTY_TREE_H_
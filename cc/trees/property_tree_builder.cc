@@ -0,0 +1,108 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/trees/property_tree_builder.h"
+
+#include "cc/layers/layer_impl.h"
+#include "ui/gfx/rect.h"
+#include "ui/gfx/transform.h"
+
+namespace cc {
+
+namespace {
+
+struct DataForRecursion {
+  TransformTree* transform_tree;
+  ClipTree* clip_tree;
+  EffectTree* effect_tree;
+  int transform_tree_parent;
+  int clip_tree_parent;
+  int effect_tree_parent;
+};
+
+void BuildPropertyTreesInternal(LayerImpl* layer,
+                                const DataForRecursion& data_from_parent) {
+  DataForRecursion data_for_children(data_from_parent);
+
+  // Tr[origin] * Tr[origin2anchor] * M[layer] * Tr[anchor2origin], as in
+  // CalculateDrawProperties().
+  gfx::Size bounds = layer->bounds();
+  gfx::PointF anchor_point = layer->anchor_point();
+  gfx::PointF position = layer->position() - layer->TotalScrollOffset();
+  TransformNode transform_node;
+  gfx::Transform& to_parent = transform_node.data.to_parent;
+  to_parent.Translate3d(position.x() + anchor_point.x() * bounds.width(),
+                        position.y() + anchor_point.y() * bounds.height(),
+                        layer->anchor_point_z());
+  to_parent.PreconcatTransform(layer->transform());
+  to_parent.Translate3d(-anchor_point.x() * bounds.width(),
+                        -anchor_point.y() * bounds.height(),
+                        -layer->anchor_point_z());
+  transform_node.data.flattens_inherited_transform =
+      layer->should_flatten_transform();
+  data_for_children.transform_tree_parent =
+      data_from_parent.transform_tree->Insert(
+          transform_node, data_from_parent.transform_tree_parent);
+  layer->set_transform_tree_index(data_for_children.transform_tree_parent);
+
+  if (layer->masks_to_bounds()) {
+    ClipNode clip_node;
+    clip_node.data.clip = gfx::RectF(bounds);
+    clip_node.data.transform_id = layer->transform_tree_index();
+    data_for_children.clip_tree_parent = data_from_parent.clip_tree->Insert(
+        clip_node, data_from_parent.clip_tree_parent);
+  }
+  layer->set_clip_tree_index(data_for_children.clip_tree_parent);
+
+  if (layer->opacity() != 1.f) {
+    EffectNode effect_node;
+    effect_node.data.opacity = layer->opacity();
+    data_for_children.effect_tree_parent = data_from_parent.effect_tree->Insert(
+        effect_node, data_from_parent.effect_tree_parent);
+  }
+  layer->set_effect_tree_index(data_for_children.effect_tree_parent);
+
+  for (size_t i = 0; i < layer->children().size(); ++i)
+    BuildPropertyTreesInternal(layer->children()[i], data_for_children);
+}
+
+}  // namespace
+
+void PropertyTreeBuilder::BuildPropertyTrees(
+    LayerImpl* root_layer,
+    const gfx::Transform& device_transform,
+    const gfx::Rect& viewport,
+    TransformTree* transform_tree,
+    ClipTree* clip_tree,
+    EffectTree* effect_tree) {
+  DCHECK(root_layer);
+  transform_tree->clear();
+  clip_tree->clear();
+  effect_tree->clear();
+
+  // The viewport clip is in screen space, while layers hang off a node that
+  // maps the root layer's space to the screen.
+  int screen_transform_id = transform_tree->Insert(TransformNode(), -1);
+  TransformNode device_transform_node;
+  device_transform_node.data.to_parent = device_transform;
+  int device_transform_id =
+      transform_tree->Insert(device_transform_node, screen_transform_id);
+
+  ClipNode viewport_clip_node;
+  viewport_clip_node.data.clip = gfx::RectF(viewport);
+  viewport_clip_node.data.transform_id = screen_transform_id;
+
+  DataForRecursion data_for_recursion;
+  data_for_recursion.transform_tree = transform_tree;
+  data_for_recursion.clip_tree = clip_tree;
+  data_for_recursion.effect_tree = effect_tree;
+  data_for_recursion.transform_tree_parent = device_transform_id;
+  data_for_recursion.clip_tree_parent =
+      clip_tree->Insert(viewport_clip_node, -1);
+  data_for_recursion.effect_tree_parent = effect_tree->Insert(EffectNode(), -1);
+
+  BuildPropertyTreesInternal(root_layer, data_for_recursion);
+}
+
+}  // namespace cc
@@ -0,0 +1,46 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CC_TREES_PROPERTY_TREE_BUILDER_H_
+#define CC_TREES_PROPERTY_TREE_BUILDER_H_
+
+#include "cc/base/cc_export.h"
+#include "cc/trees/property_tree.h"
+
+namespace gfx {
+class Rect;
+class Transform;
+}
+
+namespace cc {
+
+class LayerImpl;
+
+class CC_EXPORT PropertyTreeBuilder {
+ public:
+  // Builds the property trees for the subtree of |root_layer| and records
+  // each layer's nodes in its transform_tree_index(), clip_tree_index() and
+  // effect_tree_index(). Every layer gets a transform node; only layers that
+  // mask to bounds or change opacity get clip or effect nodes, and other
+  // layers share their nearest such ancestor's. The trees' first nodes stand
+  // for the screen, with |device_transform| mapping the root layer's space to
+  // it and |viewport| clipping everything.
+  //
+  // The trees don't model page scale, fixed-position compensation or render
+  // surfaces yet, so they only agree with CalculateDrawProperties() for trees
+  // without those.
+  static void BuildPropertyTrees(LayerImpl* root_layer,
+                                 const gfx::Transform& device_transform,
+                                 const gfx::Rect& viewport,
+                                 TransformTree* transform_tree,
+                                 ClipTree* clip_tree,
+                                 EffectTree* effect_tree);
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(PropertyTreeBuilder);
+};
+
+}  // namespace cc
+
+#endif  // CC_TREES_PROPERTY_TREE_BUILDER_H_
@@ -0,0 +1,147 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/trees/property_tree.h"
+
+#include "cc/layers/layer_impl.h"
+#include "cc/test/fake_impl_proxy.h"
+#include "cc/test/fake_layer_tree_host_impl.h"
+#include "cc/test/geometry_test_utils.h"
+#include "cc/test/test_shared_bitmap_manager.h"
+#include "cc/trees/layer_tree_host_common.h"
+#include "cc/trees/layer_tree_impl.h"
+#include "cc/trees/property_tree_builder.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace cc {
+namespace {
+
+void SetLayerProperties(LayerImpl* layer,
+                        const gfx::Transform& transform,
+                        const gfx::PointF& position,
+                        const gfx::Size& bounds) {
+  layer->SetTransform(transform);
+  layer->SetAnchorPoint(gfx::PointF());
+  layer->SetPosition(position);
+  layer->SetBounds(bounds);
+  layer->SetContentBounds(bounds);
+}
+
+TEST(PropertyTreeTest, ScreenSpaceTransformsMatchDrawProperties) {
+  FakeImplProxy proxy;
+  TestSharedBitmapManager shared_bitmap_manager;
+  FakeLayerTreeHostImpl host_impl(&proxy, &shared_bitmap_manager);
+  scoped_ptr<LayerImpl> root = LayerImpl::Create(host_impl.active_tree(), 1);
+  scoped_ptr<LayerImpl> child = LayerImpl::Create(host_impl.active_tree(), 2);
+  scoped_ptr<LayerImpl> grand_child =
+      LayerImpl::Create(host_impl.active_tree(), 3);
+
+  gfx::Transform scale;
+  scale.Scale(2.0, 3.0);
+  gfx::Transform translate;
+  translate.Translate(5.0, 7.0);
+  SetLayerProperties(
+      root.get(), gfx::Transform(), gfx::PointF(), gfx::Size(100, 100));
+  SetLayerProperties(
+      child.get(), scale, gfx::PointF(10.f, 20.f), gfx::Size(30, 30));
+  SetLayerProperties(
+      grand_child.get(), translate, gfx::PointF(1.f, 2.f), gfx::Size(10, 10));
+  child->SetScrollClipLayer(root->id());
+  child->SetScrollDelta(gfx::Vector2dF(3.f, 4.f));
+
+  LayerImpl* child_ptr = child.get();
+  LayerImpl* grand_child_ptr = grand_child.get();
+  child->AddChild(grand_child.Pass());
+  root->AddChild(child.Pass());
+
+  LayerImplList render_surface_layer_list;
+  LayerTreeHostCommon::CalcDrawPropsImplInputsForTesting inputs(
+      root.get(), root->bounds(), &render_surface_layer_list);
+  LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+
+  TransformTree transform_tree;
+  ClipTree clip_tree;
+  EffectTree effect_tree;
+  PropertyTreeBuilder::BuildPropertyTrees(root.get(),
+                                          gfx::Transform(),
+                                          gfx::Rect(root->bounds()),
+                                          &transform_tree,
+                                          &clip_tree,
+                                          &effect_tree);
+  transform_tree.UpdateScreenSpaceTransforms();
+
+  // The screen and device nodes, then one node per layer.
+  EXPECT_EQ(5u, transform_tree.size());
+  EXPECT_TRANSFORMATION_MATRIX_EQ(
+      root->screen_space_transform(),
+      transform_tree.Node(root->transform_tree_index())->data.to_screen);
+  EXPECT_TRANSFORMATION_MATRIX_EQ(
+      child_ptr->screen_space_transform(),
+      transform_tree.Node(child_ptr->transform_tree_index())->data.to_screen);
+  EXPECT_TRANSFORMATION_MATRIX_EQ(
+      grand_child_ptr->screen_space_transform(),
+      transform_tree.Node(grand_child_ptr->transform_tree_index())
+          ->data.to_screen);
+}
+
+TEST(PropertyTreeTest, ClipsAndEffectsAreSharedByDescendants) {
+  FakeImplProxy proxy;
+  TestSharedBitmapManager shared_bitmap_manager;
+  FakeLayerTreeHostImpl host_impl(&proxy, &shared_bitmap_manager);
+  scoped_ptr<LayerImpl> root = LayerImpl::Create(host_impl.active_tree(), 1);
+  scoped_ptr<LayerImpl> child = LayerImpl::Create(host_impl.active_tree(), 2);
+  scoped_ptr<LayerImpl> grand_child =
+      LayerImpl::Create(host_impl.active_tree(), 3);
+
+  gfx::Transform identity;
+  SetLayerProperties(root.get(), identity, gfx::PointF(), gfx::Size(100, 100));
+  SetLayerProperties(
+      child.get(), identity, gfx::PointF(50.f, 50.f), gfx::Size(100, 100));
+  SetLayerProperties(
+      grand_child.get(), identity, gfx::PointF(10.f, 10.f), gfx::Size(5, 5));
+  child->SetMasksToBounds(true);
+  child->SetOpacity(0.5f);
+  grand_child->SetOpacity(0.5f);
+
+  LayerImpl* child_ptr = child.get();
+  LayerImpl* grand_child_ptr = grand_child.get();
+  child->AddChild(grand_child.Pass());
+  root->AddChild(child.Pass());
+
+  TransformTree transform_tree;
+  ClipTree clip_tree;
+  EffectTree effect_tree;
+  PropertyTreeBuilder::BuildPropertyTrees(root.get(),
+                                          gfx::Transform(),
+                                          gfx::Rect(root->bounds()),
+                                          &transform_tree,
+                                          &clip_tree,
+                                          &effect_tree);
+  transform_tree.UpdateScreenSpaceTransforms();
+  clip_tree.UpdateScreenSpaceClips(transform_tree);
+  effect_tree.UpdateScreenSpaceOpacities();
+
+  // Only |child| masks to bounds, so |root| keeps the viewport clip and
+  // |grand_child| shares |child|'s.
+  EXPECT_EQ(2u, clip_tree.size());
+  EXPECT_EQ(0, root->clip_tree_index());
+  EXPECT_EQ(1, child_ptr->clip_tree_index());
+  EXPECT_EQ(1, grand_child_ptr->clip_tree_index());
+  EXPECT_FLOAT_RECT_EQ(gfx::RectF(50.f, 50.f, 50.f, 50.f),
+                       clip_tree.Node(1)->data.combined_clip_in_screen_space);
+
+  EXPECT_EQ(3u, effect_tree.size());
+  EXPECT_EQ(0, root->effect_tree_index());
+  EXPECT_FLOAT_EQ(
+      0.5f,
+      effect_tree.Node(child_ptr->effect_tree_index())
+          ->data.screen_space_opacity);
+  EXPECT_FLOAT_EQ(
+      0.25f,
+      effect_tree.Node(grand_child_ptr->effect_tree_index())
+          ->data.screen_space_opacity);
+}
+
+}  // namespace
+}  // namespace cc
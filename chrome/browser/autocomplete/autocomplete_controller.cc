@@ -233,6 +233,8 @@ void AutocompleteController::Start(const AutocompleteInput& input) {
   // Start the new query.
   in_start_ = true;
   base::TimeTicks start_time = base::TimeTicks::Now();
+  query_start_time_ = start_time;
+  provider_timings_.clear();
   for (ACProviders::iterator i(providers_.begin()); i != providers_.end();
        ++i) {
     // TODO(mpearson): Remove timing code once bugs 178705 / 237703 / 168933
@@ -249,6 +251,7 @@ void AutocompleteController::Start(const AutocompleteInput& input) {
     if (input.matches_requested() != AutocompleteInput::ALL_MATCHES)
       DCHECK((*i)->done());
     base::TimeTicks provider_end_time = base::TimeTicks::Now();
+    provider_timings_[*i].start_time = provider_end_time - provider_start_time;
     std::string name = std::string("Omnibox.ProviderTime.") + (*i)->GetName();
     base::HistogramBase* counter = base::Histogram::FactoryGet(
         name, 1, 5000, 20, base::Histogram::kUmaTargetedHistogramFlag);
@@ -601,14 +604,21 @@ void AutocompleteController::NotifyChanged(bool notify_default_match) {
 }
 
 void AutocompleteController::CheckIfDone() {
+  done_ = true;
   for (ACProviders::const_iterator i(providers_.begin()); i != providers_.end();
        ++i) {
     if (!(*i)->done()) {
       done_ = false;
-      return;
+      continue;
+    }
+    if (query_start_time_.is_null())
+      continue;
+    ProviderTiming& timing = provider_timings_[*i];
+    if (!timing.done) {
+      timing.done = true;
+      timing.done_time = base::TimeTicks::Now() - query_start_time_;
     }
   }
-  done_ = true;
 }
 
 void AutocompleteController::StartExpireTimer() {
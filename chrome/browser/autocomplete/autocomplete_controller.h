@@ -5,6 +5,8 @@
 #ifndef CHROME_BROWSER_AUTOCOMPLETE_AUTOCOMPLETE_CONTROLLER_H_
 #define CHROME_BROWSER_AUTOCOMPLETE_AUTOCOMPLETE_CONTROLLER_H_
 
+#include <map>
+
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
 #include "base/gtest_prod_util.h"
@@ -45,6 +47,19 @@ class ZeroSuggestProvider;
 // matches from a series of providers into one AutocompleteResult.
 class AutocompleteController : public AutocompleteProviderListener {
  public:
+  // How long a provider took to answer the current query: the time spent in
+  // its Start(), and the time from the start of the query until the provider
+  // was done. |done_time| is only meaningful once |done| is set.
+  struct ProviderTiming {
+    ProviderTiming() : done(false) {}
+
+    base::TimeDelta start_time;
+    base::TimeDelta done_time;
+    bool done;
+  };
+  typedef std::map<const AutocompleteProvider*, ProviderTiming>
+      ProviderTimings;
+
   // |provider_types| is a bitmap containing AutocompleteProvider::Type values
   // that will (potentially, depending on platform, flags, etc.) be
   // instantiated.
@@ -121,6 +136,7 @@ class AutocompleteController : public AutocompleteProviderListener {
   const AutocompleteResult& result() const { return result_; }
   bool done() const { return done_; }
   const ACProviders* providers() const { return &providers_; }
+  const ProviderTimings& provider_timings() const { return provider_timings_; }
 
   const base::TimeTicks& last_time_default_match_changed() const {
     return last_time_default_match_changed_;
@@ -169,6 +185,7 @@ class AutocompleteController : public AutocompleteProviderListener {
   void NotifyChanged(bool notify_default_match);
 
   // Updates |done_| to be accurate with respect to current providers' statuses.
+  // Also records in |provider_timings_| when each provider became done.
   void CheckIfDone();
 
   // Starts |expire_timer_|.
@@ -196,6 +213,11 @@ class AutocompleteController : public AutocompleteProviderListener {
   // Data from the autocomplete query.
   AutocompleteResult result_;
 
+  // When the current query was started, and how long each provider took to
+  // answer it.
+  base::TimeTicks query_start_time_;
+  ProviderTimings provider_timings_;
+
   // The most recent time the default match (inline match) changed.  This may
   // be earlier than the most recent keystroke if the recent keystrokes didn't
   // change the suggested match in the omnibox.  (For instance, if
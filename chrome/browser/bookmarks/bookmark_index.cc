@@ -6,7 +6,6 @@
 
 #include <algorithm>
 #include <iterator>
-#include <list>
 
 #include "base/i18n/case_conversion.h"
 #include "base/strings/string16.h"
@@ -17,40 +16,6 @@
 #include "chrome/browser/history/query_parser.h"
 #include "chrome/browser/history/url_database.h"
 
-// Used when finding the set of bookmarks that match a query. Each match
-// represents a set of terms (as an interator into the Index) matching the
-// query as well as the set of nodes that contain those terms in their titles.
-struct BookmarkIndex::Match {
-  // List of terms matching the query.
-  std::list<Index::const_iterator> terms;
-
-  // The set of nodes matching the terms. As an optimization this is empty
-  // when we match only one term, and is filled in when we get more than one
-  // term. We can do this as when we have only one matching term we know
-  // the set of matching nodes is terms.front()->second.
-  //
-  // Use nodes_begin() and nodes_end() to get an iterator over the set as
-  // it handles the necessary switching between nodes and terms.front().
-  NodeSet nodes;
-
-  // Returns an iterator to the beginning of the matching nodes. See
-  // description of nodes for why this should be used over nodes.begin().
-  NodeSet::const_iterator nodes_begin() const;
-
-  // Returns an iterator to the beginning of the matching nodes. See
-  // description of nodes for why this should be used over nodes.end().
-  NodeSet::const_iterator nodes_end() const;
-};
-
-BookmarkIndex::NodeSet::const_iterator
-    BookmarkIndex::Match::nodes_begin() const {
-  return nodes.empty() ? terms.front()->second.begin() : nodes.begin();
-}
-
-BookmarkIndex::NodeSet::const_iterator BookmarkIndex::Match::nodes_end() const {
-  return nodes.empty() ? terms.front()->second.end() : nodes.end();
-}
-
 BookmarkIndex::BookmarkIndex(content::BrowserContext* browser_context)
     : browser_context_(browser_context) {
 }
@@ -119,30 +84,16 @@ void BookmarkIndex::SortMatches(const Matches& matches,
   history::URLDatabase* url_db = history_service ?
       history_service->InMemoryDatabase() : NULL;
 
-  for (Matches::const_iterator i = matches.begin(); i != matches.end(); ++i)
-    ExtractBookmarkNodePairs(url_db, *i, node_typed_counts);
-
-  std::sort(node_typed_counts->begin(), node_typed_counts->end(),
-            &NodeTypedCountPairSortFunc);
-  // Eliminate duplicates.
-  node_typed_counts->erase(std::unique(node_typed_counts->begin(),
-                                       node_typed_counts->end()),
-                           node_typed_counts->end());
-}
-
-void BookmarkIndex::ExtractBookmarkNodePairs(
-    history::URLDatabase* url_db,
-    const Match& match,
-    NodeTypedCountPairs* node_typed_counts) const {
-
-  for (NodeSet::const_iterator i = match.nodes_begin();
-       i != match.nodes_end(); ++i) {
+  node_typed_counts->reserve(matches.size());
+  for (Matches::const_iterator i = matches.begin(); i != matches.end(); ++i) {
     history::URLRow url;
     if (url_db)
       url_db->GetRowForURL((*i)->url(), &url);
-    NodeTypedCountPair pair(*i, url.typed_count());
-    node_typed_counts->push_back(pair);
+    node_typed_counts->push_back(NodeTypedCountPair(*i, url.typed_count()));
   }
+
+  std::sort(node_typed_counts->begin(), node_typed_counts->end(),
+            &NodeTypedCountPairSortFunc);
 }
 
 void BookmarkIndex::AddMatchToResults(
@@ -170,79 +121,50 @@ bool BookmarkIndex::GetBookmarksWithTitleMatchingTerm(const base::string16& term
   if (i == index_.end())
     return false;
 
+  Matches term_matches;
   if (!QueryParser::IsWordLongEnoughForPrefixSearch(term)) {
     // Term is too short for prefix match, compare using exact match.
     if (i->first != term)
       return false;  // No bookmarks with this term.
-
-    if (first_term) {
-      Match match;
-      match.terms.push_back(i);
-      matches->push_back(match);
-      return true;
-    }
-    CombineMatchesInPlace(i, matches);
-  } else if (first_term) {
-    // This is the first term and we're doing a prefix match. Loop through
-    // index adding all entries that start with term to matches.
-    while (i != index_.end() &&
-           i->first.size() >= term.size() &&
-           term.compare(0, term.size(), i->first, 0, term.size()) == 0) {
-      Match match;
-      match.terms.push_back(i);
-      matches->push_back(match);
-      ++i;
-    }
+    term_matches.assign(i->second.begin(), i->second.end());
   } else {
-    // Prefix match and not the first term. Loop through index combining
-    // current matches in matches with term, placing result in result.
-    Matches result;
-    while (i != index_.end() &&
-           i->first.size() >= term.size() &&
-           term.compare(0, term.size(), i->first, 0, term.size()) == 0) {
-      CombineMatches(i, *matches, &result);
-      ++i;
+    // Gather the nodes of every word starting with |term|. The words are
+    // adjacent in |index_|, and each word's nodes are already sorted.
+    Index::const_iterator prefix_end = i;
+    size_t word_count = 0;
+    size_t node_count = 0;
+    while (prefix_end != index_.end() &&
+           prefix_end->first.size() >= term.size() &&
+           term.compare(0, term.size(), prefix_end->first, 0,
+                        term.size()) == 0) {
+      ++word_count;
+      node_count += prefix_end->second.size();
+      ++prefix_end;
     }
-    matches->swap(result);
-  }
-  return !matches->empty();
-}
-
-void BookmarkIndex::CombineMatchesInPlace(const Index::const_iterator& index_i,
-                                          Matches* matches) {
-  for (size_t i = 0; i < matches->size(); ) {
-    Match* match = &((*matches)[i]);
-    NodeSet intersection;
-    std::set_intersection(match->nodes_begin(), match->nodes_end(),
-                          index_i->second.begin(), index_i->second.end(),
-                          std::inserter(intersection, intersection.begin()));
-    if (intersection.empty()) {
-      matches->erase(matches->begin() + i);
-    } else {
-      match->terms.push_back(index_i);
-      match->nodes.swap(intersection);
-      ++i;
+    term_matches.reserve(node_count);
+    for (; i != prefix_end; ++i) {
+      term_matches.insert(term_matches.end(), i->second.begin(),
+                          i->second.end());
+    }
+    // A title can contain more than one of the words.
+    if (word_count > 1) {
+      std::sort(term_matches.begin(), term_matches.end());
+      term_matches.erase(
+          std::unique(term_matches.begin(), term_matches.end()),
+          term_matches.end());
     }
   }
-}
 
-void BookmarkIndex::CombineMatches(const Index::const_iterator& index_i,
-                                   const Matches& current_matches,
-                                   Matches* result) {
-  for (size_t i = 0; i < current_matches.size(); ++i) {
-    const Match& match = current_matches[i];
-    NodeSet intersection;
-    std::set_intersection(match.nodes_begin(), match.nodes_end(),
-                          index_i->second.begin(), index_i->second.end(),
-                          std::inserter(intersection, intersection.begin()));
-    if (!intersection.empty()) {
-      result->push_back(Match());
-      Match& combined_match = result->back();
-      combined_match.terms = match.terms;
-      combined_match.terms.push_back(index_i);
-      combined_match.nodes.swap(intersection);
-    }
+  if (first_term) {
+    matches->swap(term_matches);
+  } else {
+    Matches intersection;
+    std::set_intersection(matches->begin(), matches->end(),
+                          term_matches.begin(), term_matches.end(),
+                          std::back_inserter(intersection));
+    matches->swap(intersection);
   }
+  return !matches->empty();
 }
 
 std::vector<base::string16> BookmarkIndex::ExtractQueryWords(
@@ -31,7 +31,8 @@ class URLDatabase;
 //
 // BookmarkIndex maintains the index (index_) as a map of sets. The map (type
 // Index) maps from a lower case string to the set (type NodeSet) of
-// BookmarkNodes that contain that string in their title.
+// BookmarkNodes that contain that string in their title. Since the map is
+// sorted, all the words starting with a prefix are adjacent in it.
 class BookmarkIndex {
  public:
   explicit BookmarkIndex(content::BrowserContext* browser_context);
@@ -53,27 +54,20 @@ class BookmarkIndex {
   typedef std::set<const BookmarkNode*> NodeSet;
   typedef std::map<base::string16, NodeSet> Index;
 
-  struct Match;
-  typedef std::vector<Match> Matches;
+  // Nodes matching a query, sorted and without duplicates so that the nodes
+  // for successive terms can be intersected in linear time.
+  typedef std::vector<const BookmarkNode*> Matches;
 
   // Pairs BookmarkNodes and the number of times the nodes' URLs were typed.
   // Used to sort Matches in decreasing order of typed count.
   typedef std::pair<const BookmarkNode*, int> NodeTypedCountPair;
   typedef std::vector<NodeTypedCountPair> NodeTypedCountPairs;
 
-  // Extracts |matches.nodes| into NodeTypedCountPairs, sorts the pairs in
-  // decreasing order of typed count, and then de-dupes the matches.
+  // Retrieves the typed count of each node in |matches| and returns the pairs
+  // in |node_typed_counts| sorted in decreasing order of typed count.
   void SortMatches(const Matches& matches,
                    NodeTypedCountPairs* node_typed_counts) const;
 
-  // Extracts BookmarkNodes from |match| and retrieves typed counts for each
-  // node from the in-memory database. Inserts pairs containing the node and
-  // typed count into the vector |node_typed_counts|. |node_typed_counts| is
-  // sorted in decreasing order of typed count.
-  void ExtractBookmarkNodePairs(history::URLDatabase* url_db,
-                                const Match& match,
-                                NodeTypedCountPairs* node_typed_counts) const;
-
   // Sort function for NodeTypedCountPairs. We sort in decreasing order of typed
   // count so that the best matches will always be added to the results.
   static bool NodeTypedCountPairSortFunc(const NodeTypedCountPair& a,
@@ -87,34 +81,13 @@ class BookmarkIndex {
                          const std::vector<QueryNode*>& query_nodes,
                          std::vector<BookmarkTitleMatch>* results);
 
-  // Populates |matches| for the specified term. If |first_term| is true, this
-  // is the first term in the query. Returns true if there is at least one node
-  // matching the term.
+  // Narrows |matches| down to the nodes with a title word matching |term|. If
+  // |first_term| is true, this is the first term in the query and |matches| is
+  // filled in instead. Returns true if there is at least one node left.
   bool GetBookmarksWithTitleMatchingTerm(const base::string16& term,
                                          bool first_term,
                                          Matches* matches);
 
-  // Iterates over |matches| updating each Match's nodes to contain the
-  // intersection of the Match's current nodes and the nodes at |index_i|.
-  // If the intersection is empty, the Match is removed.
-  //
-  // This is invoked from GetBookmarksWithTitleMatchingTerm.
-  void CombineMatchesInPlace(const Index::const_iterator& index_i,
-                             Matches* matches);
-
-  // Iterates over |current_matches| calculating the intersection between the
-  // Match's nodes and the nodes at |index_i|. If the intersection between the
-  // two is non-empty, a new match is added to |result|.
-  //
-  // This differs from CombineMatchesInPlace in that if the intersection is
-  // non-empty the result is added to result, not combined in place. This
-  // variant is used for prefix matching.
-  //
-  // This is invoked from GetBookmarksWithTitleMatchingTerm.
-  void CombineMatches(const Index::const_iterator& index_i,
-                      const Matches& current_matches,
-                      Matches* result);
-
   // Returns the set of query words from |query|.
   std::vector<base::string16> ExtractQueryWords(const base::string16& query);
 
@@ -0,0 +1,81 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_vector.h"
+#include "base/strings/stringprintf.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/test/perf_log.h"
+#include "base/test/perf_time_logger.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "chrome/browser/bookmarks/bookmark_index.h"
+#include "chrome/browser/bookmarks/bookmark_model.h"
+#include "chrome/browser/bookmarks/bookmark_title_match.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace {
+
+const int kBookmarkCount = 50000;
+
+// What the user types, one keystroke at a time.
+const char* const kTypedInputs[] = {
+  "bookmark 4242",
+  "project notes 17",
+  "recipe soup",
+};
+
+const char* const kTitleWords[] = {
+  "project", "notes", "recipe", "soup", "travel", "photos", "news", "bank",
+};
+
+}  // namespace
+
+// Measures how long the bookmark index takes to answer each keystroke while
+// typing into the omnibox, with a large number of bookmarks.
+TEST(BookmarkIndexPerfTest, Keystrokes) {
+  ScopedVector<BookmarkNode> nodes;
+  BookmarkIndex index(NULL);
+  {
+    base::PerfTimeLogger timer("BookmarkIndex_Add_50k");
+    for (int i = 0; i < kBookmarkCount; ++i) {
+      BookmarkNode* node = new BookmarkNode(
+          i + 1, GURL(base::StringPrintf("http://www.site%d.com/", i)));
+      node->SetTitle(base::ASCIIToUTF16(base::StringPrintf(
+          "Bookmark %d %s %s %d", i,
+          kTitleWords[i % arraysize(kTitleWords)],
+          kTitleWords[(i / 7) % arraysize(kTitleWords)], i % 100)));
+      nodes.push_back(node);
+      index.Add(node);
+    }
+    timer.Done();
+  }
+
+  base::TimeDelta total_time;
+  base::TimeDelta max_time;
+  int keystrokes = 0;
+  for (size_t i = 0; i < arraysize(kTypedInputs); ++i) {
+    const std::string input(kTypedInputs[i]);
+    for (size_t length = 1; length <= input.length(); ++length) {
+      std::vector<BookmarkTitleMatch> matches;
+      base::ElapsedTimer timer;
+      index.GetBookmarksWithTitlesMatching(
+          base::ASCIIToUTF16(input.substr(0, length)), 10, &matches);
+      base::TimeDelta elapsed = timer.Elapsed();
+      total_time += elapsed;
+      max_time = std::max(max_time, elapsed);
+      ++keystrokes;
+    }
+  }
+
+  base::LogPerfResult("BookmarkIndex_Keystroke_Mean_50k",
+                      total_time.InMillisecondsF() / keystrokes, "ms");
+  base::LogPerfResult("BookmarkIndex_Keystroke_Max_50k",
+                      max_time.InMillisecondsF(), "ms");
+}
@@ -141,6 +141,11 @@ TEST_F(BookmarkIndexTest, Tests) {
 
     // Prefix matches against multiple candidates.
     { "abc1 abc2 abc3 abc4", "abc", "abc1 abc2 abc3 abc4"},
+
+    // Several terms each prefix matching several words of the same title.
+    { "abc1 abc2 def1 def2;abc3 def3;abc4;def4",
+      "abc def",
+      "abc1 abc2 def1 def2;abc3 def3"},
   };
   for (size_t i = 0; i < ARRAYSIZE_UNSAFE(data); ++i) {
     std::vector<std::string> titles;
@@ -464,7 +464,7 @@ void BookmarkModel::SetURL(const BookmarkNode* node, const GURL& url) {
     base::AutoLock url_lock(url_lock_);
     RemoveNodeFromURLSet(mutable_node);
     mutable_node->set_url(url);
-    nodes_ordered_by_url_set_.insert(mutable_node);
+    AddNodeToURLSet(mutable_node);
   }
 
   if (store_.get())
@@ -673,7 +673,7 @@ const BookmarkNode* BookmarkModel::AddURLWithCreationTime(
   {
     // Only hold the lock for the duration of the insert.
     base::AutoLock url_lock(url_lock_);
-    nodes_ordered_by_url_set_.insert(new_node);
+    AddNodeToURLSet(new_node);
   }
 
   return AddNode(AsMutable(parent), index, new_node);
@@ -871,6 +871,20 @@ void BookmarkModel::RemoveAndDeleteNode(BookmarkNode* delete_me) {
                     BookmarkNodeRemoved(this, parent, index, node.get()));
 }
 
+void BookmarkModel::AddNodeToURLSet(BookmarkNode* node) {
+  // NOTE: this is called in such a way that url_lock_ is already held. As
+  // such, this doesn't explicitly grab the lock.
+  NodesOrderedByURLSet::iterator i = nodes_ordered_by_url_set_.insert(node);
+  // Equal nodes are inserted after the existing ones, so if another node has
+  // the same URL, it is just before |node|. Copying its URL makes both nodes
+  // use the same string, instead of one copy per bookmark.
+  if (i != nodes_ordered_by_url_set_.begin()) {
+    --i;
+    if ((*i)->url() == node->url())
+      node->set_url((*i)->url());
+  }
+}
+
 void BookmarkModel::RemoveNodeFromURLSet(BookmarkNode* node) {
   // NOTE: this is called in such a way that url_lock_ is already held. As
   // such, this doesn't explicitly grab the lock.
@@ -1070,7 +1084,7 @@ void BookmarkModel::PopulateNodesByURL(BookmarkNode* node) {
   // NOTE: this is called with url_lock_ already held. As such, this doesn't
   // explicitly grab the lock.
   if (node->is_url())
-    nodes_ordered_by_url_set_.insert(node);
+    AddNodeToURLSet(node);
   for (int i = 0; i < node->child_count(); ++i)
     PopulateNodesByURL(node->GetChild(i));
 }
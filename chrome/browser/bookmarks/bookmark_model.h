@@ -478,6 +478,10 @@ class BookmarkModel : public content::NotificationObserver,
   // type specifies how the node should be removed.
   void RemoveAndDeleteNode(BookmarkNode* delete_me);
 
+  // Adds |node| to |nodes_ordered_by_url_set_|. If other nodes have the same
+  // URL, |node| is made to share its storage with theirs.
+  void AddNodeToURLSet(BookmarkNode* node);
+
   // Remove |node| from |nodes_ordered_by_url_set_|.
   void RemoveNodeFromURLSet(BookmarkNode* node);
 
@@ -6,6 +6,7 @@
 
 #include "base/bind.h"
 #include "base/compiler_specific.h"
+#include "base/critical_closure.h"
 #include "base/file_util.h"
 #include "base/files/file_path.h"
 #include "base/json/json_file_value_serializer.h"
@@ -36,6 +37,25 @@ void BackupCallback(const base::FilePath& path) {
   base::CopyFile(path, backup_path);
 }
 
+bool SerializeValue(const base::Value& value, std::string* output) {
+  JSONStringValueSerializer serializer(output);
+  serializer.set_pretty_print(true);
+  return serializer.Serialize(value);
+}
+
+// Turning the encoded model into JSON costs about as much as encoding it for
+// large models, so it happens here along with the write rather than on the UI
+// thread.
+void SaveCallback(const base::FilePath& path, scoped_ptr<base::Value> value) {
+  std::string data;
+  if (!SerializeValue(*value, &data)) {
+    DLOG(WARNING) << "failed to serialize data to be saved in "
+                  << path.value();
+    return;
+  }
+  base::ImportantFileWriter::WriteFileAtomically(path, data);
+}
+
 // Adds node to the model's index, recursing through all children as well.
 void AddBookmarksToIndex(BookmarkLoadDetails* details,
                          BookmarkNode* node) {
@@ -120,17 +140,15 @@ BookmarkStorage::BookmarkStorage(
     BookmarkModel* model,
     base::SequencedTaskRunner* sequenced_task_runner)
     : model_(model),
-      writer_(context->GetPath().Append(chrome::kBookmarksFileName),
-              sequenced_task_runner) {
+      path_(context->GetPath().Append(chrome::kBookmarksFileName)) {
   sequenced_task_runner_ = sequenced_task_runner;
-  writer_.set_commit_interval(base::TimeDelta::FromMilliseconds(kSaveDelayMS));
   sequenced_task_runner_->PostTask(FROM_HERE,
-                                   base::Bind(&BackupCallback, writer_.path()));
+                                   base::Bind(&BackupCallback, path_));
 }
 
 BookmarkStorage::~BookmarkStorage() {
-  if (writer_.HasPendingWrite())
-    writer_.DoScheduledWrite();
+  if (save_timer_.IsRunning())
+    SaveNow();
 }
 
 void BookmarkStorage::LoadBookmarks(BookmarkLoadDetails* details) {
@@ -139,18 +157,22 @@ void BookmarkStorage::LoadBookmarks(BookmarkLoadDetails* details) {
   details_.reset(details);
   sequenced_task_runner_->PostTask(
       FROM_HERE,
-      base::Bind(&LoadCallback, writer_.path(), make_scoped_refptr(this),
+      base::Bind(&LoadCallback, path_, make_scoped_refptr(this),
                  details_.get()));
 }
 
 void BookmarkStorage::ScheduleSave() {
-  writer_.ScheduleWrite(this);
+  if (!save_timer_.IsRunning()) {
+    save_timer_.Start(FROM_HERE,
+                      base::TimeDelta::FromMilliseconds(kSaveDelayMS),
+                      this, &BookmarkStorage::DoScheduledSave);
+  }
 }
 
 void BookmarkStorage::BookmarkModelDeleted() {
   // We need to save now as otherwise by the time SaveNow is invoked
   // the model is gone.
-  if (writer_.HasPendingWrite())
+  if (save_timer_.IsRunning())
     SaveNow();
   model_ = NULL;
 }
@@ -158,9 +180,7 @@ void BookmarkStorage::BookmarkModelDeleted() {
 bool BookmarkStorage::SerializeData(std::string* output) {
   BookmarkCodec codec;
   scoped_ptr<base::Value> value(codec.Encode(model_));
-  JSONStringValueSerializer serializer(output);
-  serializer.set_pretty_print(true);
-  return serializer.Serialize(*(value.get()));
+  return SerializeValue(*value, output);
 }
 
 void BookmarkStorage::OnLoadFinished() {
@@ -178,9 +198,22 @@ bool BookmarkStorage::SaveNow() {
     return false;
   }
 
-  std::string data;
-  if (!SerializeData(&data))
+  save_timer_.Stop();
+
+  BookmarkCodec codec;
+  scoped_ptr<base::Value> value(codec.Encode(model_));
+  if (!value)
     return false;
-  writer_.WriteNow(data);
+
+  // Writes are posted in order to the same sequence, so a later save can't be
+  // overwritten by an earlier one.
+  sequenced_task_runner_->PostTask(
+      FROM_HERE,
+      base::MakeCriticalClosure(
+          base::Bind(&SaveCallback, path_, base::Passed(&value))));
   return true;
 }
+
+void BookmarkStorage::DoScheduledSave() {
+  SaveNow();
+}
@@ -5,9 +5,11 @@
 #ifndef CHROME_BROWSER_BOOKMARKS_BOOKMARK_STORAGE_H_
 #define CHROME_BROWSER_BOOKMARKS_BOOKMARK_STORAGE_H_
 
+#include "base/files/file_path.h"
 #include "base/files/important_file_writer.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/timer/timer.h"
 #include "chrome/browser/bookmarks/bookmark_model.h"
 
 class BookmarkIndex;
@@ -143,15 +145,22 @@ class BookmarkStorage : public base::ImportantFileWriter::DataSerializer,
 
   virtual ~BookmarkStorage();
 
-  // Serializes the data and schedules save using ImportantFileWriter.
-  // Returns true on successful serialization.
+  // Encodes the model and posts turning it into JSON and writing it safely
+  // to |sequenced_task_runner_|, so that only the encoding happens on the
+  // calling thread. Returns true on successful encoding.
   bool SaveNow();
 
+  // Invoked by |save_timer_|.
+  void DoScheduledSave();
+
   // The model. The model is NULL once BookmarkModelDeleted has been invoked.
   BookmarkModel* model_;
 
-  // Helper to write bookmark data safely.
-  base::ImportantFileWriter writer_;
+  // Path of the bookmarks file.
+  const base::FilePath path_;
+
+  // Coalesces the saves scheduled by model changes.
+  base::OneShotTimer<BookmarkStorage> save_timer_;
 
   // See class description of BookmarkLoadDetails for details on this.
   scoped_ptr<BookmarkLoadDetails> details_;
@@ -124,6 +124,11 @@ bool ShouldArchiveVisit(const VisitRow& visit) {
 // Prevents us from doing too much work any given time.
 const int kNumExpirePerIteration = 32;
 
+// The most pages of the main history file given back to the filesystem after
+// each archiving pass. Bounded so that the truncation stays a small part of
+// the pass; at 4kB pages this is 256kB.
+const int kMaxFreePagesPerIteration = 64;
+
 // The number of seconds between checking for items that should be expired when
 // we think there might be more items to expire. This timeout is used when the
 // last expiration found at least kNumExpirePerIteration and we want to check
@@ -665,6 +670,11 @@ bool ExpireHistoryBackend::ArchiveSomeOldHistory(
   // to not do anything if nothing was deleted.
   BroadcastDeleteNotifications(&deleted_dependencies, DELETION_ARCHIVED);
 
+  // Deleting rows only moves their pages onto the freelist; shrink the file a
+  // bit at a time so that a long expiration backlog doesn't leave it bloated.
+  if (!affected_visits.empty())
+    main_db_->ReleaseFreePages(kMaxFreePagesPerIteration);
+
   return more_to_expire;
 }
 
@@ -131,6 +131,12 @@ class HistoryDatabase : public DownloadDatabase,
   // unused space in the file. It can be VERY SLOW.
   void Vacuum();
 
+  // Truncates up to |max_pages| pages from the freelist off the end of the
+  // file. Unlike Vacuum() this is cheap and bounded, and may be called from
+  // within a transaction. It is a NOP unless the database was created with
+  // incremental auto-vacuum enabled.
+  void ReleaseFreePages(int max_pages);
+
   // Try to trim the cache memory used by the database.  If |aggressively| is
   // true try to trim all unused cache, otherwise trim by half.
   void TrimMemory(bool aggressively);
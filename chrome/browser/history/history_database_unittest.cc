@@ -4,13 +4,19 @@
 
 #include "chrome/browser/history/history_database.h"
 
+#include <string>
+#include <vector>
+
 #include "base/file_util.h"
 #include "base/files/file_path.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/path_service.h"
+#include "base/strings/stringprintf.h"
+#include "base/strings/utf_string_conversions.h"
 #include "chrome/common/chrome_paths.h"
 #include "sql/init_status.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
 
 namespace history {
 
@@ -46,4 +52,38 @@ TEST(HistoryDatabaseTest, DropBookmarks) {
   }
 }
 
+// Pages freed by deleting rows should be handed back to the filesystem by
+// ReleaseFreePages() without needing a full vacuum.
+TEST(HistoryDatabaseTest, ReleaseFreePages) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath db_file = temp_dir.path().AppendASCII("ReleaseFreePages.db");
+
+  HistoryDatabase history_db;
+  ASSERT_EQ(sql::INIT_OK, history_db.Init(db_file));
+
+  const base::string16 title(base::ASCIIToUTF16(std::string(1000, 'x')));
+  std::vector<URLID> ids;
+  for (int i = 0; i < 500; ++i) {
+    URLRow row(GURL(base::StringPrintf("http://www.google.com/%d", i)));
+    row.set_title(title);
+    URLID id = history_db.AddURL(row);
+    ASSERT_NE(0, id);
+    ids.push_back(id);
+  }
+  int64 full_size = 0;
+  ASSERT_TRUE(base::GetFileSize(db_file, &full_size));
+
+  for (size_t i = 0; i < ids.size(); ++i)
+    ASSERT_TRUE(history_db.DeleteURLRow(ids[i]));
+  int64 deleted_size = 0;
+  ASSERT_TRUE(base::GetFileSize(db_file, &deleted_size));
+  EXPECT_EQ(full_size, deleted_size);
+
+  history_db.ReleaseFreePages(10000);
+  int64 released_size = 0;
+  ASSERT_TRUE(base::GetFileSize(db_file, &released_size));
+  EXPECT_LT(released_size, full_size / 2);
+}
+
 }  // namespace history
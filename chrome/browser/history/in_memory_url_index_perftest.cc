@@ -0,0 +1,91 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <set>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "base/strings/string16.h"
+#include "base/strings/stringprintf.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/test/perf_log.h"
+#include "base/test/perf_time_logger.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "chrome/browser/history/history_types.h"
+#include "chrome/browser/history/url_index_private_data.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace history {
+
+namespace {
+
+const int kHistorySize = 100000;
+const char kLanguages[] = "en";
+
+// What the user types, one keystroke at a time.
+const char* const kTypedInputs[] = {
+  "site123",
+  "article 4567",
+  "www.site4 page",
+  "topic 42 about",
+};
+
+// Fills |data| with |count| significant rows spread over a thousand sites,
+// so that common words are shared by many rows and rare ones by few.
+void FillIndex(URLIndexPrivateData* data, int count) {
+  std::set<std::string> scheme_whitelist;
+  scheme_whitelist.insert("http");
+  scheme_whitelist.insert("https");
+  const base::Time now = base::Time::Now();
+  for (int i = 1; i <= count; ++i) {
+    URLRow row(GURL(base::StringPrintf(
+        "http://www.site%d.com/page/%d/article", i % 1000, i)), i);
+    row.set_title(base::ASCIIToUTF16(base::StringPrintf(
+        "Article %d about topic %d", i, i % 97)));
+    row.set_visit_count(kLowQualityMatchVisitLimit);
+    row.set_typed_count(i % 3);
+    row.set_last_visit(now - base::TimeDelta::FromMinutes(i));
+    data->UpdateURL(NULL, row, kLanguages, scheme_whitelist);
+  }
+}
+
+}  // namespace
+
+// Measures how long the quick provider's index takes to answer each keystroke
+// while typing into the omnibox, with a large history.
+TEST(InMemoryURLIndexPerfTest, Keystrokes) {
+  scoped_refptr<URLIndexPrivateData> data(new URLIndexPrivateData);
+  {
+    base::PerfTimeLogger timer("InMemoryURLIndex_Fill_100k");
+    FillIndex(data.get(), kHistorySize);
+    timer.Done();
+  }
+
+  base::TimeDelta total_time;
+  base::TimeDelta max_time;
+  int keystrokes = 0;
+  for (size_t i = 0; i < arraysize(kTypedInputs); ++i) {
+    const std::string input(kTypedInputs[i]);
+    for (size_t length = 1; length <= input.length(); ++length) {
+      base::ElapsedTimer timer;
+      data->HistoryItemsForTerms(base::ASCIIToUTF16(input.substr(0, length)),
+                                 base::string16::npos, kLanguages, NULL);
+      base::TimeDelta elapsed = timer.Elapsed();
+      total_time += elapsed;
+      max_time = std::max(max_time, elapsed);
+      ++keystrokes;
+    }
+  }
+
+  base::LogPerfResult("InMemoryURLIndex_Keystroke_Mean_100k",
+                      total_time.InMillisecondsF() / keystrokes, "ms");
+  base::LogPerfResult("InMemoryURLIndex_Keystroke_Max_100k",
+                      max_time.InMillisecondsF(), "ms");
+}
+
+}  // namespace history
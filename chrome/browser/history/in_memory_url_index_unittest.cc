@@ -1144,6 +1144,26 @@ TEST_F(InMemoryURLIndexTest, RebuildFromHistoryIfCacheOld) {
   ExpectPrivateDataEqual(*old_data.get(), new_data);
 }
 
+TEST_F(InMemoryURLIndexTest, RebuildInShards) {
+  // Read the rows as RebuildFromHistory() does.
+  URLIndexPrivateData::RowsAndVisits rows;
+  URLDatabase::URLEnumerator history_enum;
+  ASSERT_TRUE(history_database_->InitURLEnumeratorForSignificant(
+      &history_enum));
+  for (URLRow row; history_enum.GetNextURL(&row); ) {
+    rows.push_back(std::make_pair(row, VisitVector()));
+    history_database_->GetMostRecentVisitsForURL(row.id(), 10,
+                                                 &rows.back().second);
+  }
+  ASSERT_GT(rows.size(), 3u);
+
+  // Indexing the rows in several shards gives the same index, down to the
+  // word IDs, as the single shard the small test history was rebuilt with.
+  scoped_refptr<URLIndexPrivateData> sharded_data(new URLIndexPrivateData);
+  sharded_data->IndexRowsInShards(rows, 3, "en,ja,hi,zh", scheme_whitelist());
+  ExpectPrivateDataEqual(*GetPrivateData(), *sharded_data.get());
+}
+
 class InMemoryURLIndexCacheTest : public testing::Test {
  public:
   InMemoryURLIndexCacheTest() {}
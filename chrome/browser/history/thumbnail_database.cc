@@ -88,6 +88,9 @@ const int kCurrentVersionNumber = 7;
 const int kCompatibleVersionNumber = 7;
 const int kDeprecatedVersionNumber = 4;  // and earlier.
 
+// Upper bound on how much of the favicons file is memory-mapped.
+const int64 kMmapSize = 32 * 1024 * 1024;
+
 void FillIconMapping(const sql::Statement& statement,
                      const GURL& page_url,
                      history::IconMapping* icon_mapping) {
@@ -1141,6 +1144,11 @@ sql::InitStatus ThumbnailDatabase::OpenDatabase(sql::Connection* db,
   db->set_page_size(2048);
   db->set_cache_size(32);
 
+  // Favicon lookups are many small reads, so map the file where sqlite
+  // supports it, and prime the small cache up front.
+  db->set_mmap_size(kMmapSize);
+  db->set_preload_on_open();
+
   // Run the database in exclusive mode. Nobody else should be accessing the
   // database while we're running, and this will give somewhat improved perf.
   db->set_exclusive_locking();
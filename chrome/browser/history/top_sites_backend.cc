@@ -16,6 +16,13 @@ using content::BrowserThread;
 
 namespace history {
 
+namespace {
+
+// How long SetPageThumbnail() waits for more thumbnails before writing them.
+const int kThumbnailWriteDelayMs = 500;
+
+}  // namespace
+
 TopSitesBackend::TopSitesBackend()
     : db_(new TopSitesDatabase()) {
 }
@@ -28,6 +35,7 @@ void TopSitesBackend::Init(const base::FilePath& path) {
 }
 
 void TopSitesBackend::Shutdown() {
+  FlushPendingThumbnails();
   BrowserThread::PostTask(
       BrowserThread::DB, FROM_HERE,
       base::Bind(&TopSitesBackend::ShutdownDBOnDBThread, this));
@@ -36,6 +44,7 @@ void TopSitesBackend::Shutdown() {
 void TopSitesBackend::GetMostVisitedThumbnails(
     const GetMostVisitedThumbnailsCallback& callback,
     base::CancelableTaskTracker* tracker) {
+  FlushPendingThumbnails();
   scoped_refptr<MostVisitedThumbnails> thumbnails = new MostVisitedThumbnails();
 
   tracker->PostTaskAndReply(
@@ -48,6 +57,7 @@ void TopSitesBackend::GetMostVisitedThumbnails(
 }
 
 void TopSitesBackend::UpdateTopSites(const TopSitesDelta& delta) {
+  FlushPendingThumbnails();
   BrowserThread::PostTask(
       BrowserThread::DB, FROM_HERE,
       base::Bind(&TopSitesBackend::UpdateTopSitesOnDBThread, this, delta));
@@ -56,13 +66,20 @@ void TopSitesBackend::UpdateTopSites(const TopSitesDelta& delta) {
 void TopSitesBackend::SetPageThumbnail(const MostVisitedURL& url,
                                        int url_rank,
                                        const Images& thumbnail) {
-  BrowserThread::PostTask(
-      BrowserThread::DB, FROM_HERE,
-      base::Bind(&TopSitesBackend::SetPageThumbnailOnDBThread, this, url,
-                 url_rank, thumbnail));
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  if (pending_urls_.empty()) {
+    BrowserThread::PostDelayedTask(
+        BrowserThread::UI, FROM_HERE,
+        base::Bind(&TopSitesBackend::FlushPendingThumbnails, this),
+        base::TimeDelta::FromMilliseconds(kThumbnailWriteDelayMs));
+  }
+  pending_urls_.push_back(url);
+  pending_url_ranks_.push_back(url_rank);
+  pending_thumbnails_.push_back(thumbnail);
 }
 
 void TopSitesBackend::ResetDatabase() {
+  FlushPendingThumbnails();
   BrowserThread::PostTask(
       BrowserThread::DB, FROM_HERE,
       base::Bind(&TopSitesBackend::ResetDatabaseOnDBThread, this, db_path_));
@@ -70,6 +87,7 @@ void TopSitesBackend::ResetDatabase() {
 
 void TopSitesBackend::DoEmptyRequest(const base::Closure& reply,
                                      base::CancelableTaskTracker* tracker) {
+  FlushPendingThumbnails();
   tracker->PostTaskAndReply(
       BrowserThread::GetMessageLoopProxyForThread(BrowserThread::DB).get(),
       FROM_HERE,
@@ -82,6 +100,22 @@ TopSitesBackend::~TopSitesBackend() {
                  // nulling out db).
 }
 
+void TopSitesBackend::FlushPendingThumbnails() {
+  if (pending_urls_.empty())
+    return;
+
+  std::vector<MostVisitedURL> urls;
+  std::vector<int> url_ranks;
+  std::vector<Images> thumbnails;
+  urls.swap(pending_urls_);
+  url_ranks.swap(pending_url_ranks_);
+  thumbnails.swap(pending_thumbnails_);
+  BrowserThread::PostTask(
+      BrowserThread::DB, FROM_HERE,
+      base::Bind(&TopSitesBackend::SetPageThumbnailsOnDBThread, this, urls,
+                 url_ranks, thumbnails));
+}
+
 void TopSitesBackend::InitDBOnDBThread(const base::FilePath& path) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::DB));
   if (!db_->Init(path)) {
@@ -119,13 +153,14 @@ void TopSitesBackend::UpdateTopSitesOnDBThread(const TopSitesDelta& delta) {
     db_->UpdatePageRank(delta.moved[i].url, delta.moved[i].rank);
 }
 
-void TopSitesBackend::SetPageThumbnailOnDBThread(const MostVisitedURL& url,
-                                                 int url_rank,
-                                                 const Images& thumbnail) {
+void TopSitesBackend::SetPageThumbnailsOnDBThread(
+    const std::vector<MostVisitedURL>& urls,
+    const std::vector<int>& url_ranks,
+    const std::vector<Images>& thumbnails) {
   if (!db_)
     return;
 
-  db_->SetPageThumbnail(url, url_rank, thumbnail);
+  db_->SetPageThumbnails(urls, url_ranks, thumbnails);
 }
 
 void TopSitesBackend::ResetDatabaseOnDBThread(const base::FilePath& file_path) {
@@ -5,6 +5,8 @@
 #ifndef CHROME_BROWSER_HISTORY_TOP_SITES_BACKEND_H_
 #define CHROME_BROWSER_HISTORY_TOP_SITES_BACKEND_H_
 
+#include <vector>
+
 #include "base/callback.h"
 #include "base/files/file_path.h"
 #include "base/memory/ref_counted.h"
@@ -45,7 +47,8 @@ class TopSitesBackend : public base::RefCountedThreadSafe<TopSitesBackend> {
   // Updates top sites database from the specified delta.
   void UpdateTopSites(const TopSitesDelta& delta);
 
-  // Sets the thumbnail.
+  // Sets the thumbnail. Thumbnails set in quick succession, e.g. when many
+  // tabs are opened at once, are written to the database together.
   void SetPageThumbnail(const MostVisitedURL& url,
                         int url_rank,
                         const Images& thumbnail);
@@ -64,6 +67,10 @@ class TopSitesBackend : public base::RefCountedThreadSafe<TopSitesBackend> {
 
   virtual ~TopSitesBackend();
 
+  // Posts the thumbnails queued by SetPageThumbnail() to the DB thread. This
+  // is done before posting any other request, so that they keep their order.
+  void FlushPendingThumbnails();
+
   // Invokes Init on the db_.
   void InitDBOnDBThread(const base::FilePath& path);
 
@@ -77,10 +84,10 @@ class TopSitesBackend : public base::RefCountedThreadSafe<TopSitesBackend> {
   // Updates top sites.
   void UpdateTopSitesOnDBThread(const TopSitesDelta& delta);
 
-  // Sets the thumbnail.
-  void SetPageThumbnailOnDBThread(const MostVisitedURL& url,
-                                  int url_rank,
-                                  const Images& thumbnail);
+  // Sets the thumbnails.
+  void SetPageThumbnailsOnDBThread(const std::vector<MostVisitedURL>& urls,
+                                   const std::vector<int>& url_ranks,
+                                   const std::vector<Images>& thumbnails);
 
   // Resets the database.
   void ResetDatabaseOnDBThread(const base::FilePath& file_path);
@@ -89,6 +96,11 @@ class TopSitesBackend : public base::RefCountedThreadSafe<TopSitesBackend> {
 
   scoped_ptr<TopSitesDatabase> db_;
 
+  // Thumbnails waiting to be written, only accessed on the UI thread.
+  std::vector<MostVisitedURL> pending_urls_;
+  std::vector<int> pending_url_ranks_;
+  std::vector<Images> pending_thumbnails_;
+
   DISALLOW_COPY_AND_ASSIGN(TopSitesBackend);
 };
 
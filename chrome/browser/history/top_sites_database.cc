@@ -495,6 +495,22 @@ void TopSitesDatabase::SetPageThumbnail(const MostVisitedURL& url,
   transaction.Commit();
 }
 
+void TopSitesDatabase::SetPageThumbnails(
+    const std::vector<MostVisitedURL>& urls,
+    const std::vector<int>& new_ranks,
+    const std::vector<Images>& thumbnails) {
+  DCHECK_EQ(urls.size(), new_ranks.size());
+  DCHECK_EQ(urls.size(), thumbnails.size());
+  sql::Transaction transaction(db_.get());
+  transaction.Begin();
+
+  // The inner transactions only commit along with this one.
+  for (size_t i = 0; i < urls.size(); ++i)
+    SetPageThumbnail(urls[i], new_ranks[i], thumbnails[i]);
+
+  transaction.Commit();
+}
+
 bool TopSitesDatabase::UpdatePageThumbnail(
     const MostVisitedURL& url, const Images& thumbnail) {
   sql::Statement statement(db_->GetCachedStatement(
@@ -7,6 +7,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "base/gtest_prod_util.h"
 #include "chrome/browser/history/history_types.h"
@@ -47,6 +48,12 @@ class TopSitesDatabase {
                         int new_rank,
                         const Images& thumbnail);
 
+  // Sets the thumbnails of several URLs, as SetPageThumbnail does, within a
+  // single transaction so they are committed to disk together.
+  void SetPageThumbnails(const std::vector<MostVisitedURL>& urls,
+                         const std::vector<int>& new_ranks,
+                         const std::vector<Images>& thumbnails);
+
   // Sets the rank for a given URL. The URL must be in the database.
   // Use SetPageThumbnail if it's not.
   void UpdatePageRank(const MostVisitedURL& url, int new_rank);
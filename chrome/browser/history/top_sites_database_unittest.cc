@@ -476,4 +476,31 @@ TEST_F(TopSitesDatabaseTest, AddRemoveEditThumbnails) {
   EXPECT_EQ(kUrl0, urls[1].url);
 }
 
+TEST_F(TopSitesDatabaseTest, SetPageThumbnails) {
+  ASSERT_TRUE(CreateDatabaseFromSQL(file_name_, "TopSites.v3.sql"));
+
+  TopSitesDatabase db;
+  ASSERT_TRUE(db.Init(file_name_));
+
+  // Add a new URL and move an existing one in the same batch.
+  GURL mapsUrl = GURL("http://maps.google.com/");
+  std::vector<MostVisitedURL> batch_urls;
+  std::vector<int> batch_ranks;
+  batch_urls.push_back(MostVisitedURL(mapsUrl,
+                                      base::ASCIIToUTF16("Google Maps")));
+  batch_ranks.push_back(0);
+  batch_urls.push_back(MostVisitedURL(kUrl0, base::string16()));
+  batch_ranks.push_back(2);
+  db.SetPageThumbnails(batch_urls, batch_ranks,
+                       std::vector<Images>(batch_urls.size()));
+
+  MostVisitedURLList urls;
+  std::map<GURL, Images> thumbnails;
+  db.GetPageThumbnails(&urls, &thumbnails);
+  ASSERT_EQ(4u, urls.size());
+  ASSERT_EQ(4u, thumbnails.size());
+  EXPECT_EQ(mapsUrl, urls[0].url);
+  EXPECT_EQ(kUrl0, urls[2].url);
+}
+
 }  // namespace history
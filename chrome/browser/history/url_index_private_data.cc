@@ -13,11 +13,17 @@
 #include <vector>
 
 #include "base/basictypes.h"
+#include "base/bind.h"
 #include "base/file_util.h"
+#include "base/files/memory_mapped_file.h"
 #include "base/i18n/case_conversion.h"
+#include "base/memory/scoped_vector.h"
 #include "base/metrics/histogram.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/sys_info.h"
+#include "base/threading/worker_pool.h"
 #include "base/time/time.h"
 #include "chrome/browser/autocomplete/autocomplete_provider.h"
 #include "chrome/browser/autocomplete/url_prefix.h"
@@ -43,10 +49,45 @@ using in_memory_url_index::InMemoryURLIndexCacheItem;
 
 namespace {
 static const size_t kMaxVisitsToStoreInCache = 10u;
+
+// When one sorted ID list is at least this many times longer than the other,
+// IntersectSortedIDs() searches it for each of the short list's IDs instead
+// of walking both lists.
+static const size_t kIntersectSearchRatio = 16u;
+
+// Rebuilding the index from history uses at most this many shards, and only
+// as many as give each shard this many rows to index.
+static const size_t kMaxRebuildShards = 4u;
+static const size_t kMinRowsPerRebuildShard = 1000u;
 }  // anonymous namespace
 
 namespace history {
 
+namespace {
+
+// Sets |out| to the IDs found in both of the sorted vectors |a| and |b|.
+void IntersectSortedIDs(const HistoryIDVector& a,
+                        const HistoryIDVector& b,
+                        HistoryIDVector* out) {
+  out->clear();
+  const HistoryIDVector& shorter = a.size() <= b.size() ? a : b;
+  const HistoryIDVector& longer = a.size() <= b.size() ? b : a;
+  if (shorter.size() * kIntersectSearchRatio >= longer.size()) {
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                          std::back_inserter(*out));
+    return;
+  }
+  HistoryIDVector::const_iterator pos = longer.begin();
+  for (HistoryIDVector::const_iterator iter = shorter.begin();
+       iter != shorter.end() && pos != longer.end(); ++iter) {
+    pos = std::lower_bound(pos, longer.end(), *iter);
+    if (pos != longer.end() && *pos == *iter)
+      out->push_back(*iter);
+  }
+}
+
+}  // namespace
+
 typedef imui::InMemoryURLIndexCacheItem_WordListItem WordListItem;
 typedef imui::InMemoryURLIndexCacheItem_WordMapItem_WordMapEntry WordMapEntry;
 typedef imui::InMemoryURLIndexCacheItem_WordMapItem WordMapItem;
@@ -192,22 +233,19 @@ ScoredHistoryMatches URLIndexPrivateData::HistoryItemsForTerms(
   // approach.
   ResetSearchTermCache();
 
-  HistoryIDSet history_id_set = HistoryIDSetFromWords(lower_words);
+  HistoryIDVector history_ids = HistoryIDsFromWords(lower_words);
 
   // Trim the candidate pool if it is large. Note that we do not filter out
   // items that do not contain the search terms as proper substrings -- doing
   // so is the performance-costly operation we are trying to avoid in order
   // to maintain omnibox responsiveness.
   const size_t kItemsToScoreLimit = 500;
-  pre_filter_item_count_ = history_id_set.size();
+  pre_filter_item_count_ = history_ids.size();
   // If we trim the results set we do not want to cache the results for next
   // time as the user's ultimately desired result could easily be eliminated
   // in this early rough filter.
   bool was_trimmed = (pre_filter_item_count_ > kItemsToScoreLimit);
   if (was_trimmed) {
-    HistoryIDVector history_ids;
-    std::copy(history_id_set.begin(), history_id_set.end(),
-              std::back_inserter(history_ids));
     // Trim down the set by sorting by typed-count, visit-count, and last
     // visit.
     HistoryItemFactorGreater
@@ -216,10 +254,8 @@ ScoredHistoryMatches URLIndexPrivateData::HistoryItemsForTerms(
                       history_ids.begin() + kItemsToScoreLimit,
                       history_ids.end(),
                       item_factor_functor);
-    history_id_set.clear();
-    std::copy(history_ids.begin(), history_ids.begin() + kItemsToScoreLimit,
-              std::inserter(history_id_set, history_id_set.end()));
-    post_filter_item_count_ = history_id_set.size();
+    history_ids.resize(kItemsToScoreLimit);
+    post_filter_item_count_ = history_ids.size();
   }
 
   // Pass over all of the candidates filtering out any without a proper
@@ -245,7 +281,7 @@ ScoredHistoryMatches URLIndexPrivateData::HistoryItemsForTerms(
     // but this is such a rare edge case that it's not worth the time.
     return scored_items;
   }
-  scored_items = std::for_each(history_id_set.begin(), history_id_set.end(),
+  scored_items = std::for_each(history_ids.begin(), history_ids.end(),
       AddHistoryMatch(*this, languages, bookmark_service, lower_raw_string,
                       lower_raw_terms, base::Time::Now())).ScoredMatches();
 
@@ -399,15 +435,16 @@ scoped_refptr<URLIndexPrivateData> URLIndexPrivateData::RestoreFromFile(
   base::TimeTicks beginning_time = base::TimeTicks::Now();
   if (!base::PathExists(file_path))
     return NULL;
-  std::string data;
   // If there is no cache file then simply give up. This will cause us to
-  // attempt to rebuild from the history database.
-  if (!base::ReadFileToString(file_path, &data))
+  // attempt to rebuild from the history database. The file is parsed straight
+  // out of a memory mapping rather than copied into a buffer first.
+  base::MemoryMappedFile data;
+  if (!data.Initialize(file_path))
     return NULL;
 
   scoped_refptr<URLIndexPrivateData> restored_data(new URLIndexPrivateData);
   InMemoryURLIndexCacheItem index_cache;
-  if (!index_cache.ParseFromArray(data.c_str(), data.size())) {
+  if (!index_cache.ParseFromArray(data.data(), data.length())) {
     LOG(WARNING) << "Failed to parse URLIndexPrivateData cache data read from "
                  << file_path.value();
     return restored_data;
@@ -420,7 +457,7 @@ scoped_refptr<URLIndexPrivateData> URLIndexPrivateData::RestoreFromFile(
                       base::TimeTicks::Now() - beginning_time);
   UMA_HISTOGRAM_COUNTS("History.InMemoryURLHistoryItems",
                        restored_data->history_id_word_map_.size());
-  UMA_HISTOGRAM_COUNTS("History.InMemoryURLCacheSize", data.size());
+  UMA_HISTOGRAM_COUNTS("History.InMemoryURLCacheSize", data.length());
   UMA_HISTOGRAM_COUNTS_10000("History.InMemoryURLWords",
                              restored_data->word_map_.size());
   UMA_HISTOGRAM_COUNTS_10000("History.InMemoryURLChars",
@@ -446,11 +483,30 @@ scoped_refptr<URLIndexPrivateData> URLIndexPrivateData::RebuildFromHistory(
   if (!history_db->InitURLEnumeratorForSignificant(&history_enum))
     return NULL;
   rebuilt_data->last_time_rebuilt_from_history_ = base::Time::Now();
+
+  // Only the reads have to happen here on the history DB thread. Breaking the
+  // rows into words is independent per row, so that is spread over shards.
+  RowsAndVisits rows;
   for (URLRow row; history_enum.GetNextURL(&row); ) {
-    rebuilt_data->IndexRow(history_db, NULL, row, languages,
-                           scheme_whitelist);
+    if (!URLSchemeIsWhitelisted(row.url(), scheme_whitelist))
+      continue;
+    rows.push_back(std::make_pair(row, VisitVector()));
+    // Make sure the private data is going to get as many recent visits as
+    // ScoredHistoryMatch::GetFrecency() hopes to use.
+    DCHECK_GE(kMaxVisitsToStoreInCache, ScoredHistoryMatch::kMaxVisitsToScore);
+    history_db->GetMostRecentVisitsForURL(row.id(), kMaxVisitsToStoreInCache,
+                                          &rows.back().second);
   }
 
+  size_t shard_count = std::min(
+      static_cast<size_t>(base::SysInfo::NumberOfProcessors()),
+      kMaxRebuildShards);
+  shard_count = std::max(
+      std::min(shard_count, rows.size() / kMinRowsPerRebuildShard),
+      static_cast<size_t>(1));
+  rebuilt_data->IndexRowsInShards(rows, shard_count, languages,
+                                  scheme_whitelist);
+
   UMA_HISTOGRAM_TIMES("History.InMemoryURLIndexingTime",
                       base::TimeTicks::Now() - beginning_time);
   UMA_HISTOGRAM_COUNTS("History.InMemoryURLHistoryItems",
@@ -512,14 +568,14 @@ void URLIndexPrivateData::Clear() {
 
 URLIndexPrivateData::~URLIndexPrivateData() {}
 
-HistoryIDSet URLIndexPrivateData::HistoryIDSetFromWords(
+HistoryIDVector URLIndexPrivateData::HistoryIDsFromWords(
     const String16Vector& unsorted_words) {
   // Break the terms down into individual terms (words), get the candidate
   // set for each term, and intersect each to get a final candidate list.
   // Note that a single 'term' from the user's perspective might be
   // a string like "http://www.somewebsite.com" which, from our perspective,
   // is four words: 'http', 'www', 'somewebsite', and 'com'.
-  HistoryIDSet history_id_set;
+  HistoryIDVector history_ids;
   String16Vector words(unsorted_words);
   // Sort the words into the longest first as such are likely to narrow down
   // the results quicker. Also, single character words are the most expensive
@@ -528,29 +584,26 @@ HistoryIDSet URLIndexPrivateData::HistoryIDSetFromWords(
   for (String16Vector::iterator iter = words.begin(); iter != words.end();
        ++iter) {
     base::string16 uni_word = *iter;
-    HistoryIDSet term_history_set = HistoryIDsForTerm(uni_word);
-    if (term_history_set.empty()) {
-      history_id_set.clear();
+    HistoryIDVector term_history_ids = HistoryIDsForTerm(uni_word);
+    if (term_history_ids.empty()) {
+      history_ids.clear();
       break;
     }
     if (iter == words.begin()) {
-      history_id_set.swap(term_history_set);
+      history_ids.swap(term_history_ids);
     } else {
-      HistoryIDSet new_history_id_set;
-      std::set_intersection(history_id_set.begin(), history_id_set.end(),
-                            term_history_set.begin(), term_history_set.end(),
-                            std::inserter(new_history_id_set,
-                                          new_history_id_set.begin()));
-      history_id_set.swap(new_history_id_set);
+      HistoryIDVector new_history_ids;
+      IntersectSortedIDs(history_ids, term_history_ids, &new_history_ids);
+      history_ids.swap(new_history_ids);
     }
   }
-  return history_id_set;
+  return history_ids;
 }
 
-HistoryIDSet URLIndexPrivateData::HistoryIDsForTerm(
+HistoryIDVector URLIndexPrivateData::HistoryIDsForTerm(
     const base::string16& term) {
   if (term.empty())
-    return HistoryIDSet();
+    return HistoryIDVector();
 
   // TODO(mrossetti): Consider optimizing for very common terms such as
   // 'http[s]', 'www', 'com', etc. Or collect the top 100 more frequently
@@ -579,15 +632,15 @@ HistoryIDSet URLIndexPrivateData::HistoryIDsForTerm(
       size_t prefix_length = best_prefix->first.length();
       if (prefix_length == term_length) {
         best_prefix->second.used_ = true;
-        return best_prefix->second.history_id_set_;
+        return best_prefix->second.history_ids_;
       }
 
       // Otherwise we have a handy starting point.
       // If there are no history results for this prefix then we can bail early
       // as there will be no history results for the full term.
-      if (best_prefix->second.history_id_set_.empty()) {
+      if (best_prefix->second.history_ids_.empty()) {
         search_term_cache_[term] = SearchTermCacheItem();
-        return HistoryIDSet();
+        return HistoryIDVector();
       }
       word_id_set = best_prefix->second.word_id_set_;
       prefix_chars = Char16SetFromString16(best_prefix->first);
@@ -605,7 +658,7 @@ HistoryIDSet URLIndexPrivateData::HistoryIDsForTerm(
       // We might come up empty on the leftovers.
       if (leftover_set.empty()) {
         search_term_cache_[term] = SearchTermCacheItem();
-        return HistoryIDSet();
+        return HistoryIDVector();
       }
       // Or there may not have been a prefix from which to start.
       if (prefix_chars.empty()) {
@@ -633,28 +686,40 @@ HistoryIDSet URLIndexPrivateData::HistoryIDsForTerm(
     word_id_set = WordIDSetForTermChars(Char16SetFromString16(term));
   }
 
-  // If any words resulted then we can compose a set of history IDs by unioning
-  // the sets from each word.
-  HistoryIDSet history_id_set;
+  // If any words resulted then we can compose the history IDs by unioning
+  // the sets from each word: appending them all to one flat array, then
+  // sorting it and dropping the duplicates.
+  HistoryIDVector history_ids;
   if (!word_id_set.empty()) {
+    std::vector<const HistoryIDSet*> word_history_id_sets;
+    size_t total_size = 0;
     for (WordIDSet::iterator word_id_iter = word_id_set.begin();
          word_id_iter != word_id_set.end(); ++word_id_iter) {
       WordID word_id = *word_id_iter;
       WordIDHistoryMap::iterator word_iter = word_id_history_map_.find(word_id);
       if (word_iter != word_id_history_map_.end()) {
-        HistoryIDSet& word_history_id_set(word_iter->second);
-        history_id_set.insert(word_history_id_set.begin(),
-                              word_history_id_set.end());
+        word_history_id_sets.push_back(&word_iter->second);
+        total_size += word_iter->second.size();
       }
     }
+    history_ids.reserve(total_size);
+    for (size_t i = 0; i < word_history_id_sets.size(); ++i) {
+      history_ids.insert(history_ids.end(), word_history_id_sets[i]->begin(),
+                         word_history_id_sets[i]->end());
+    }
+    if (word_history_id_sets.size() > 1) {
+      std::sort(history_ids.begin(), history_ids.end());
+      history_ids.erase(std::unique(history_ids.begin(), history_ids.end()),
+                        history_ids.end());
+    }
   }
 
   // Record a new cache entry for this word if the term is longer than
   // a single character.
   if (term_length > 1)
-    search_term_cache_[term] = SearchTermCacheItem(word_id_set, history_id_set);
+    search_term_cache_[term] = SearchTermCacheItem(word_id_set, history_ids);
 
-  return history_id_set;
+  return history_ids;
 }
 
 WordIDSet URLIndexPrivateData::WordIDSetForTermChars(
@@ -741,14 +806,95 @@ bool URLIndexPrivateData::IndexRow(
                                               kMaxVisitsToStoreInCache,
                                               &recent_visits))
       UpdateRecentVisits(row_id, recent_visits);
-  } else {
-    DCHECK(history_service);
+  } else if (history_service) {
     ScheduleUpdateRecentVisits(history_service, row_id);
   }
 
   return true;
 }
 
+void URLIndexPrivateData::IndexRowsInShards(
+    const RowsAndVisits& rows,
+    size_t shard_count,
+    const std::string& languages,
+    const std::set<std::string>& scheme_whitelist) {
+  DCHECK_GE(shard_count, 1u);
+  std::vector<RowsAndVisits> shard_rows(shard_count);
+  const size_t rows_per_shard = (rows.size() + shard_count - 1) / shard_count;
+  for (size_t i = 0; i < rows.size(); ++i)
+    shard_rows[i / rows_per_shard].push_back(rows[i]);
+
+  // The first shard is indexed on this thread while the workers do the rest.
+  std::vector<scoped_refptr<URLIndexPrivateData> > shards;
+  ScopedVector<base::WaitableEvent> done_events;
+  for (size_t i = 0; i < shard_count; ++i) {
+    shards.push_back(new URLIndexPrivateData);
+    if (i == 0)
+      continue;
+    done_events.push_back(new base::WaitableEvent(false, false));
+    base::WorkerPool::PostTask(
+        FROM_HERE,
+        base::Bind(&URLIndexPrivateData::IndexShard, shards[i],
+                   base::Unretained(&shard_rows[i]), languages,
+                   scheme_whitelist, base::Unretained(done_events.back())),
+        true);
+  }
+  IndexShard(shards[0], &shard_rows[0], languages, scheme_whitelist, NULL);
+
+  for (size_t i = 0; i < shard_count; ++i) {
+    if (i > 0)
+      done_events[i - 1]->Wait();
+    MergeShard(*shards[i].get(), shard_rows[i]);
+  }
+}
+
+// static
+void URLIndexPrivateData::IndexShard(
+    scoped_refptr<URLIndexPrivateData> shard,
+    const RowsAndVisits* rows,
+    const std::string& languages,
+    const std::set<std::string>& scheme_whitelist,
+    base::WaitableEvent* done) {
+  DCHECK(shard->Empty());
+  for (RowsAndVisits::const_iterator iter = rows->begin();
+       iter != rows->end(); ++iter) {
+    if (shard->IndexRow(NULL, NULL, iter->first, languages, scheme_whitelist))
+      shard->UpdateRecentVisits(iter->first.id(), iter->second);
+  }
+  if (done)
+    done->Signal();
+}
+
+void URLIndexPrivateData::MergeShard(const URLIndexPrivateData& shard,
+                                     const RowsAndVisits& rows) {
+  for (RowsAndVisits::const_iterator iter = rows.begin(); iter != rows.end();
+       ++iter) {
+    HistoryID history_id = static_cast<HistoryID>(iter->first.id());
+    HistoryInfoMap::const_iterator info_iter =
+        shard.history_info_map_.find(history_id);
+    if (info_iter == shard.history_info_map_.end())
+      continue;  // The row wasn't indexed.
+    DCHECK(history_info_map_.find(history_id) == history_info_map_.end());
+    history_info_map_[history_id] = info_iter->second;
+    word_starts_map_[history_id] =
+        shard.word_starts_map_.find(history_id)->second;
+
+    // A row's words which are new to this index are new to the shard too, so
+    // the shard gave them ascending word IDs in the order that indexing the
+    // row here would have, and adding them in that order keeps the word IDs
+    // the same.
+    HistoryIDWordMap::const_iterator words_iter =
+        shard.history_id_word_map_.find(history_id);
+    if (words_iter == shard.history_id_word_map_.end())
+      continue;
+    const WordIDSet& word_ids(words_iter->second);
+    for (WordIDSet::const_iterator word_iter = word_ids.begin();
+         word_iter != word_ids.end(); ++word_iter)
+      AddWordToIndex(shard.word_list_[*word_iter], history_id);
+  }
+  search_term_cache_.clear();  // Invalidate the term cache.
+}
+
 void URLIndexPrivateData::AddRowWordsToIndex(const URLRow& row,
                                              RowWordStarts* word_starts,
                                              const std::string& languages) {
@@ -1258,9 +1404,9 @@ bool URLIndexPrivateData::URLSchemeIsWhitelisted(
 
 URLIndexPrivateData::SearchTermCacheItem::SearchTermCacheItem(
     const WordIDSet& word_id_set,
-    const HistoryIDSet& history_id_set)
+    const HistoryIDVector& history_ids)
     : word_id_set_(word_id_set),
-      history_id_set_(history_id_set),
+      history_ids_(history_ids),
       used_(true) {}
 
 URLIndexPrivateData::SearchTermCacheItem::SearchTermCacheItem()
@@ -7,6 +7,8 @@
 
 #include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "base/files/file_path.h"
 #include "base/gtest_prod_util.h"
@@ -18,6 +20,10 @@
 #include "chrome/browser/history/scored_history_match.h"
 #include "content/public/browser/notification_details.h"
 
+namespace base {
+class WaitableEvent;
+}
+
 class BookmarkService;
 class HistoryQuickProviderTest;
 
@@ -154,6 +160,7 @@ class URLIndexPrivateData
   FRIEND_TEST_ALL_PREFIXES(InMemoryURLIndexTest, HugeResultSet);
   FRIEND_TEST_ALL_PREFIXES(InMemoryURLIndexTest, ReadVisitsFromHistory);
   FRIEND_TEST_ALL_PREFIXES(InMemoryURLIndexTest, RebuildFromHistoryIfCacheOld);
+  FRIEND_TEST_ALL_PREFIXES(InMemoryURLIndexTest, RebuildInShards);
   FRIEND_TEST_ALL_PREFIXES(InMemoryURLIndexTest, Scoring);
   FRIEND_TEST_ALL_PREFIXES(InMemoryURLIndexTest, TitleSearch);
   FRIEND_TEST_ALL_PREFIXES(InMemoryURLIndexTest, TypedCharacterCaching);
@@ -171,7 +178,7 @@ class URLIndexPrivateData
   // no longer needed.
   //
   // Items stored in the search term cache. If a search term exactly matches one
-  // in the cache then we can quickly supply the proper |history_id_set_| (and
+  // in the cache then we can quickly supply the proper |history_ids_| (and
   // marking the cache item as being |used_|. If we find a prefix for a search
   // term in the cache (which is very likely to occur as the user types each
   // term into the omnibox) then we can short-circuit the index search for those
@@ -179,14 +186,14 @@ class URLIndexPrivateData
   // not mark the item as being |used_|.
   struct SearchTermCacheItem {
     SearchTermCacheItem(const WordIDSet& word_id_set,
-                        const HistoryIDSet& history_id_set);
+                        const HistoryIDVector& history_ids);
     // Creates a cache item for a term which has no results.
     SearchTermCacheItem();
 
     ~SearchTermCacheItem();
 
     WordIDSet word_id_set_;
-    HistoryIDSet history_id_set_;
+    HistoryIDVector history_ids_;  // Sorted.
     bool used_;  // True if this item has been used for the current term search.
   };
   typedef std::map<base::string16, SearchTermCacheItem> SearchTermCacheMap;
@@ -233,13 +240,15 @@ class URLIndexPrivateData
 
   // URL History indexing support functions.
 
-  // Composes a set of history item IDs by intersecting the set for each word
-  // in |unsorted_words|.
-  HistoryIDSet HistoryIDSetFromWords(const String16Vector& unsorted_words);
+  // Composes the sorted history item IDs found for every word in
+  // |unsorted_words| by intersecting the IDs for each word. Candidates are
+  // kept in sorted vectors rather than sets since they are rebuilt on every
+  // keystroke, and merging flat arrays is far cheaper than growing trees.
+  HistoryIDVector HistoryIDsFromWords(const String16Vector& unsorted_words);
 
-  // Helper function to HistoryIDSetFromWords which composes a set of history
+  // Helper function to HistoryIDsFromWords which composes the sorted history
   // ids for the given term given in |term|.
-  HistoryIDSet HistoryIDsForTerm(const base::string16& term);
+  HistoryIDVector HistoryIDsForTerm(const base::string16& term);
 
   // Given a set of Char16s, finds words containing those characters.
   WordIDSet WordIDSetForTermChars(const Char16Set& term_chars);
@@ -253,13 +262,39 @@ class URLIndexPrivateData
   // only be used on the historyDB thread.  If |history_db| is NULL, then
   // this function uses |history_service| to schedule a task on the
   // historyDB thread to fetch and update the recent visits
-  // information.
+  // information.  If both are NULL, the caller is responsible for supplying
+  // the recent visits with UpdateRecentVisits().
   bool IndexRow(HistoryDatabase* history_db,
                 HistoryService* history_service,
                 const URLRow& row,
                 const std::string& languages,
                 const std::set<std::string>& scheme_whitelist);
 
+  // History rows, each with its most recent visits, as read from the history
+  // database by RebuildFromHistory().
+  typedef std::vector<std::pair<URLRow, VisitVector> > RowsAndVisits;
+
+  // Indexes |rows| by splitting them into |shard_count| shards which are
+  // indexed in parallel on worker threads, then merged into this index in
+  // the order of |rows|. The word IDs come out the same as if the rows had
+  // been indexed one at a time.
+  void IndexRowsInShards(const RowsAndVisits& rows,
+                         size_t shard_count,
+                         const std::string& languages,
+                         const std::set<std::string>& scheme_whitelist);
+
+  // Indexes |rows| into the empty |shard|, then signals |done| if it is not
+  // NULL.
+  static void IndexShard(scoped_refptr<URLIndexPrivateData> shard,
+                         const RowsAndVisits* rows,
+                         const std::string& languages,
+                         const std::set<std::string>& scheme_whitelist,
+                         base::WaitableEvent* done);
+
+  // Adds the rows indexed by |shard|, in the order given by |rows|, and their
+  // words to this index. None of the rows may already be indexed here.
+  void MergeShard(const URLIndexPrivateData& shard, const RowsAndVisits& rows);
+
   // Parses and indexes the words in the URL and page title of |row| and
   // calculate the word starts in each, saving the starts in |word_starts|.
   // |languages| gives a list of language encodings by which the URLs and page
@@ -15,6 +15,7 @@
 #include "base/debug/trace_event.h"
 #include "base/logging.h"
 #include "base/metrics/field_trial.h"
+#include "base/path_service.h"
 #include "base/prefs/pref_registry_simple.h"
 #include "base/prefs/pref_service.h"
 #include "base/stl_util.h"
@@ -40,6 +41,7 @@
 #include "chrome/browser/net/sdch_dictionary_fetcher.h"
 #include "chrome/browser/net/spdyproxy/http_auth_handler_spdyproxy.h"
 #include "chrome/common/chrome_content_client.h"
+#include "chrome/common/chrome_paths.h"
 #include "chrome/common/chrome_switches.h"
 #include "chrome/common/chrome_version_info.h"
 #include "chrome/common/pref_names.h"
@@ -53,6 +55,7 @@
 #include "net/base/network_time_notifier.h"
 #include "net/base/sdch_manager.h"
 #include "net/cert/cert_verifier.h"
+#include "net/cert/cert_verifier_cache_persister.h"
 #include "net/cert/cert_verify_proc.h"
 #include "net/cert/ct_known_logs.h"
 #include "net/cert/ct_verifier.h"
@@ -578,6 +581,17 @@ void IOThread::InitAsync() {
     globals_->cert_verifier.reset(new net::MultiThreadedCertVerifier(
         net::CertVerifyProc::CreateDefault()));
   }
+  base::FilePath user_data_dir;
+  if (PathService::Get(chrome::DIR_USER_DATA, &user_data_dir)) {
+    // Both verifiers created above are MultiThreadedCertVerifiers.
+    globals_->cert_verifier_cache_persister.reset(
+        new net::CertVerifierCachePersister(
+            static_cast<net::MultiThreadedCertVerifier*>(
+                globals_->cert_verifier.get()),
+            user_data_dir,
+            BrowserThread::GetMessageLoopProxyForThread(BrowserThread::FILE)
+                .get()));
+  }
   globals_->transport_security_state.reset(new net::TransportSecurityState());
 #if !defined(USE_OPENSSL)
   // For now, Certificate Transparency is only implemented for platforms
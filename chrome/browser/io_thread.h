@@ -42,6 +42,7 @@ class EventRouterForwarder;
 
 namespace net {
 class CertVerifier;
+class CertVerifierCachePersister;
 class CookieStore;
 class CTVerifier;
 class FtpTransactionFactory;
@@ -115,6 +116,9 @@ class IOThread : public content::BrowserThreadDelegate {
     scoped_ptr<net::NetworkDelegate> system_network_delegate;
     scoped_ptr<net::HostResolver> host_resolver;
     scoped_ptr<net::CertVerifier> cert_verifier;
+    // Saves |cert_verifier|'s results across restarts. Declared after
+    // |cert_verifier| so that it is destroyed first.
+    scoped_ptr<net::CertVerifierCachePersister> cert_verifier_cache_persister;
     // The ServerBoundCertService must outlive the HttpTransactionFactory.
     scoped_ptr<net::ServerBoundCertService> system_server_bound_cert_service;
     // This TransportSecurityState doesn't load or save any state. It's only
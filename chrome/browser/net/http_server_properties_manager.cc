@@ -247,6 +247,20 @@ HttpServerPropertiesManager::GetServerNetworkStats(
   return http_server_properties_impl_->GetServerNetworkStats(host_port_pair);
 }
 
+void HttpServerPropertiesManager::SetExpectedConcurrentSockets(
+    const net::HostPortPair& origin,
+    int num_sockets) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  http_server_properties_impl_->SetExpectedConcurrentSockets(origin,
+                                                             num_sockets);
+}
+
+int HttpServerPropertiesManager::GetExpectedConcurrentSockets(
+    const net::HostPortPair& origin) const {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  return http_server_properties_impl_->GetExpectedConcurrentSockets(origin);
+}
+
 net::HttpPipelinedHostCapability
 HttpServerPropertiesManager::GetPipelineCapability(
     const net::HostPortPair& origin) {
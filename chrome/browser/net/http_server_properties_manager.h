@@ -149,6 +149,12 @@ class HttpServerPropertiesManager
   virtual const NetworkStats* GetServerNetworkStats(
       const net::HostPortPair& host_port_pair) const OVERRIDE;
 
+  virtual void SetExpectedConcurrentSockets(const net::HostPortPair& origin,
+                                            int num_sockets) OVERRIDE;
+
+  virtual int GetExpectedConcurrentSockets(
+      const net::HostPortPair& origin) const OVERRIDE;
+
   virtual net::HttpPipelinedHostCapability GetPipelineCapability(
       const net::HostPortPair& origin) OVERRIDE;
 
@@ -38,6 +38,8 @@
 #include "net/base/host_port_pair.h"
 #include "net/base/net_errors.h"
 #include "net/base/net_log.h"
+#include "net/base/network_change_notifier.h"
+#include "net/dns/host_cache.h"
 #include "net/dns/host_resolver.h"
 #include "net/dns/single_request_host_resolver.h"
 #include "net/url_request/url_request_context_getter.h"
@@ -86,6 +88,10 @@ static size_t g_max_parallel_resolves =
 // we change the format so that we discard old data.
 static const int kPredictorStartupFormatVersion = 1;
 
+// Keys of the dictionary saved in prefs::kDnsHostCache.
+static const char kHostCacheConnectionTypeKey[] = "connection_type";
+static const char kHostCacheEntriesKey[] = "entries";
+
 class Predictor::LookupRequest {
  public:
   LookupRequest(Predictor* predictor,
@@ -296,6 +302,9 @@ void Predictor::RegisterProfilePrefs(
                              user_prefs::PrefRegistrySyncable::UNSYNCABLE_PREF);
   registry->RegisterListPref(prefs::kDnsPrefetchingHostReferralList,
                              user_prefs::PrefRegistrySyncable::UNSYNCABLE_PREF);
+  registry->RegisterDictionaryPref(
+      prefs::kDnsHostCache,
+      user_prefs::PrefRegistrySyncable::UNSYNCABLE_PREF);
 }
 
 // --------------------- Start UI methods. ------------------------------------
@@ -318,12 +327,16 @@ void Predictor::InitNetworkPredictor(PrefService* user_prefs,
       static_cast<base::ListValue*>(user_prefs->GetList(
           prefs::kDnsPrefetchingHostReferralList)->DeepCopy());
 
+  base::DictionaryValue* host_cache =
+      user_prefs->GetDictionary(prefs::kDnsHostCache)->DeepCopy();
+
   // Now that we have the statistics in memory, wipe them from the Preferences
   // file. They will be serialized back on a clean shutdown. This way we only
   // have to worry about clearing our in-memory state when Clearing Browsing
   // Data.
   user_prefs->ClearPref(prefs::kDnsPrefetchingStartupList);
   user_prefs->ClearPref(prefs::kDnsPrefetchingHostReferralList);
+  user_prefs->ClearPref(prefs::kDnsHostCache);
 
 #if defined(OS_ANDROID) || defined(OS_IOS)
   // TODO(marq): Once https://codereview.chromium.org/30883003/ lands, also
@@ -342,7 +355,7 @@ void Predictor::InitNetworkPredictor(PrefService* user_prefs,
       base::Bind(
           &Predictor::FinalizeInitializationOnIOThread,
           base::Unretained(this),
-          urls, referral_list,
+          urls, referral_list, host_cache,
           io_thread, predictor_enabled));
 }
 
@@ -800,6 +813,7 @@ void Predictor::DiscardInitialNavigationHistory() {
 void Predictor::FinalizeInitializationOnIOThread(
     const UrlList& startup_urls,
     base::ListValue* referral_list,
+    base::DictionaryValue* host_cache,
     IOThread* io_thread,
     bool predictor_enabled) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
@@ -816,6 +830,11 @@ void Predictor::FinalizeInitializationOnIOThread(
   // TODO(groby): Check if WeakPtrFactory has the same constraint.
   weak_factory_.reset(new base::WeakPtrFactory<Predictor>(this));
 
+  // Restore the resolutions from the last session before prefetching, so that
+  // the startup list can be served from the cache.
+  DeserializeHostCache(*host_cache);
+  delete host_cache;
+
   // Prefetch these hostnames on startup.
   DnsPrefetchMotivatedList(startup_urls, UrlInfo::STARTUP_LIST_MOTIVATED);
   DeserializeReferrersThenDelete(referral_list);
@@ -879,6 +898,7 @@ void Predictor::DnsPrefetchMotivatedList(
 static void SaveDnsPrefetchStateForNextStartupAndTrimOnIOThread(
     base::ListValue* startup_list,
     base::ListValue* referral_list,
+    base::DictionaryValue* host_cache,
     base::WaitableEvent* completion,
     Predictor* predictor) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
@@ -888,7 +908,7 @@ static void SaveDnsPrefetchStateForNextStartupAndTrimOnIOThread(
     return;
   }
   predictor->SaveDnsPrefetchStateForNextStartupAndTrim(
-      startup_list, referral_list, completion);
+      startup_list, referral_list, host_cache, completion);
 }
 
 void Predictor::SaveStateForNextStartupAndTrim(PrefService* prefs) {
@@ -900,10 +920,12 @@ void Predictor::SaveStateForNextStartupAndTrim(PrefService* prefs) {
   ListPrefUpdate update_startup_list(prefs, prefs::kDnsPrefetchingStartupList);
   ListPrefUpdate update_referral_list(prefs,
                                       prefs::kDnsPrefetchingHostReferralList);
+  DictionaryPrefUpdate update_host_cache(prefs, prefs::kDnsHostCache);
   if (BrowserThread::CurrentlyOn(BrowserThread::IO)) {
     SaveDnsPrefetchStateForNextStartupAndTrimOnIOThread(
         update_startup_list.Get(),
         update_referral_list.Get(),
+        update_host_cache.Get(),
         &completion,
         this);
   } else {
@@ -914,6 +936,7 @@ void Predictor::SaveStateForNextStartupAndTrim(PrefService* prefs) {
             &SaveDnsPrefetchStateForNextStartupAndTrimOnIOThread,
             update_startup_list.Get(),
             update_referral_list.Get(),
+            update_host_cache.Get(),
             &completion,
             this));
 
@@ -931,6 +954,7 @@ void Predictor::SaveStateForNextStartupAndTrim(PrefService* prefs) {
 void Predictor::SaveDnsPrefetchStateForNextStartupAndTrim(
     base::ListValue* startup_list,
     base::ListValue* referral_list,
+    base::DictionaryValue* host_cache,
     base::WaitableEvent* completion) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
   if (initial_observer_.get())
@@ -940,10 +964,48 @@ void Predictor::SaveDnsPrefetchStateForNextStartupAndTrim(
   // enough to do any regular trimming of referrers.
   TrimReferrersNow();
   SerializeReferrers(referral_list);
+  SerializeHostCache(host_cache);
 
   completion->Signal();
 }
 
+void Predictor::SerializeHostCache(base::DictionaryValue* host_cache) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  host_cache->Clear();
+  net::HostCache* cache =
+      host_resolver_ ? host_resolver_->GetHostCache() : NULL;
+  if (!cache)
+    return;
+
+  base::ListValue* entries = new base::ListValue();
+  cache->GetAsListValue(entries, base::TimeTicks::Now(), base::Time::Now());
+  host_cache->SetInteger(kHostCacheConnectionTypeKey,
+                         net::NetworkChangeNotifier::GetConnectionType());
+  host_cache->Set(kHostCacheEntriesKey, entries);
+}
+
+void Predictor::DeserializeHostCache(const base::DictionaryValue& host_cache) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  net::HostCache* cache =
+      host_resolver_ ? host_resolver_->GetHostCache() : NULL;
+  int connection_type;
+  const base::ListValue* entries = NULL;
+  if (!cache ||
+      !host_cache.GetInteger(kHostCacheConnectionTypeKey, &connection_type) ||
+      !host_cache.GetList(kHostCacheEntriesKey, &entries)) {
+    return;
+  }
+
+  // Addresses resolved on a different network may not be reachable, or may
+  // not be the ones its resolver would hand out. A network change after this
+  // point clears the cache through the HostResolver as usual.
+  if (connection_type != net::NetworkChangeNotifier::GetConnectionType())
+    return;
+
+  cache->RestoreFromListValue(*entries, base::TimeTicks::Now(),
+                              base::Time::Now());
+}
+
 void Predictor::EnablePredictor(bool enable) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI) ||
          BrowserThread::CurrentlyOn(BrowserThread::IO));
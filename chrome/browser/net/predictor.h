@@ -40,6 +40,7 @@ class PrefService;
 class Profile;
 
 namespace base {
+class DictionaryValue;
 class ListValue;
 class WaitableEvent;
 }
@@ -198,6 +199,7 @@ class Predictor {
   void FinalizeInitializationOnIOThread(
       const std::vector<GURL>& urls_to_prefetch,
       base::ListValue* referral_list,
+      base::DictionaryValue* host_cache,
       IOThread* io_thread,
       bool predictor_enabled);
 
@@ -221,8 +223,17 @@ class Predictor {
   void SaveDnsPrefetchStateForNextStartupAndTrim(
       base::ListValue* startup_list,
       base::ListValue* referral_list,
+      base::DictionaryValue* host_cache,
       base::WaitableEvent* completion);
 
+  // Saves the unexpired entries of the host resolver's cache into |host_cache|
+  // along with the current connection type.
+  void SerializeHostCache(base::DictionaryValue* host_cache);
+
+  // Restores the entries saved by SerializeHostCache() into the host
+  // resolver's cache, unless the connection type has changed since.
+  void DeserializeHostCache(const base::DictionaryValue& host_cache);
+
   // May be called from either the IO or UI thread and will PostTask
   // to the IO thread if necessary.
   void EnablePredictor(bool enable);
@@ -0,0 +1,153 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/net/ssl_session_cache_persister.h"
+
+#include "base/bind.h"
+#include "base/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/hash.h"
+#include "base/logging.h"
+#include "base/pickle.h"
+#include "base/sequenced_task_runner.h"
+#include "base/task_runner_util.h"
+#include "components/os_crypt/os_crypt.h"
+#include "content/public/browser/browser_thread.h"
+#include "net/socket/ssl_client_socket.h"
+
+using content::BrowserThread;
+
+namespace chrome_browser_net {
+
+namespace {
+
+const base::FilePath::CharType kSSLSessionCacheFilename[] =
+    FILE_PATH_LITERAL("TLS Sessions");
+
+// Version of the file format. Increment it when the format changes, so that
+// files in the old format are discarded.
+const int kFormatVersion = 1;
+
+// How often sessions are saved while the profile is in use.
+const int kSaveIntervalMinutes = 5;
+
+std::string ReadSessionsFile(const base::FilePath& path, bool encrypt) {
+  std::string data;
+  if (!base::ReadFileToString(path, &data))
+    return std::string();
+  if (!encrypt)
+    return data;
+
+  std::string plaintext;
+  if (!OSCrypt::DecryptString(data, &plaintext))
+    return std::string();
+  return plaintext;
+}
+
+void WriteSessionsFile(const base::FilePath& path,
+                       const std::string& data,
+                       bool encrypt) {
+  if (!encrypt) {
+    base::ImportantFileWriter::WriteFileAtomically(path, data);
+    return;
+  }
+
+  std::string ciphertext;
+  if (!OSCrypt::EncryptString(data, &ciphertext)) {
+    // Never leave sessions from an earlier write behind.
+    base::DeleteFile(path, false);
+    return;
+  }
+  base::ImportantFileWriter::WriteFileAtomically(path, ciphertext);
+}
+
+}  // namespace
+
+SSLSessionCachePersister::SSLSessionCachePersister(
+    const std::string& ssl_session_cache_shard,
+    const base::FilePath& profile_path,
+    bool encrypt,
+    base::SequencedTaskRunner* file_task_runner)
+    : ssl_session_cache_shard_(ssl_session_cache_shard),
+      path_(profile_path.Append(kSSLSessionCacheFilename)),
+      encrypt_(encrypt),
+      file_task_runner_(file_task_runner),
+      last_saved_hash_(0),
+      weak_ptr_factory_(this) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+
+  base::PostTaskAndReplyWithResult(
+      file_task_runner_.get(),
+      FROM_HERE,
+      base::Bind(&ReadSessionsFile, path_, encrypt_),
+      base::Bind(&SSLSessionCachePersister::CompleteLoad,
+                 weak_ptr_factory_.GetWeakPtr()));
+
+  save_timer_.Start(FROM_HERE,
+                    base::TimeDelta::FromMinutes(kSaveIntervalMinutes),
+                    this,
+                    &SSLSessionCachePersister::Save);
+}
+
+SSLSessionCachePersister::~SSLSessionCachePersister() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  Save();
+}
+
+void SSLSessionCachePersister::Save() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+
+  net::SSLClientSocket::SessionCacheEntries entries;
+  net::SSLClientSocket::ExportSessionCache(ssl_session_cache_shard_, &entries);
+
+  Pickle pickle;
+  pickle.WriteInt(kFormatVersion);
+  pickle.WriteUInt64(entries.size());
+  for (net::SSLClientSocket::SessionCacheEntries::const_iterator it =
+           entries.begin();
+       it != entries.end(); ++it) {
+    pickle.WriteString(it->first);
+    pickle.WriteString(it->second);
+  }
+
+  std::string data(static_cast<const char*>(pickle.data()), pickle.size());
+  uint32 hash = base::Hash(data);
+  if (hash == last_saved_hash_)
+    return;
+  last_saved_hash_ = hash;
+
+  file_task_runner_->PostTask(
+      FROM_HERE, base::Bind(&WriteSessionsFile, path_, data, encrypt_));
+}
+
+void SSLSessionCachePersister::CompleteLoad(const std::string& data) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+
+  if (data.empty())
+    return;
+
+  Pickle pickle(data.data(), data.size());
+  PickleIterator iter(pickle);
+  int version;
+  uint64 count;
+  if (!iter.ReadInt(&version) || version != kFormatVersion ||
+      !iter.ReadUInt64(&count)) {
+    return;
+  }
+
+  net::SSLClientSocket::SessionCacheEntries entries;
+  for (uint64 i = 0; i < count; ++i) {
+    std::string key;
+    std::string session;
+    if (!iter.ReadString(&key) || !iter.ReadString(&session)) {
+      LOG(WARNING) << "Failed to load the TLS session cache.";
+      return;
+    }
+    entries.push_back(std::make_pair(key, session));
+  }
+
+  net::SSLClientSocket::ImportSessionCache(ssl_session_cache_shard_, entries);
+}
+
+}  // namespace chrome_browser_net
@@ -0,0 +1,69 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_NET_SSL_SESSION_CACHE_PERSISTER_H_
+#define CHROME_BROWSER_NET_SSL_SESSION_CACHE_PERSISTER_H_
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/timer/timer.h"
+
+namespace base {
+class SequencedTaskRunner;
+}
+
+namespace chrome_browser_net {
+
+// Saves the resumable TLS sessions of a profile to the profile directory, and
+// restores them when the profile is loaded, so that the first connections
+// after a restart can resume a session instead of doing a full handshake.
+//
+// Sessions carry the secrets needed to resume them, so the file can be
+// encrypted with OSCrypt. Reading, writing and encryption all happen on
+// |file_task_runner|.
+//
+// This class must be created, used and destroyed on the IO thread.
+class SSLSessionCachePersister {
+ public:
+  // |ssl_session_cache_shard| is the session cache shard used by the
+  // profile's sockets. The file is stored in |profile_path|, and encrypted if
+  // |encrypt| is true.
+  SSLSessionCachePersister(const std::string& ssl_session_cache_shard,
+                           const base::FilePath& profile_path,
+                           bool encrypt,
+                           base::SequencedTaskRunner* file_task_runner);
+
+  // Saves the sessions one last time.
+  ~SSLSessionCachePersister();
+
+ private:
+  // Exports the sessions of |ssl_session_cache_shard_| and writes them out,
+  // unless they haven't changed since the last write.
+  void Save();
+
+  // Imports the sessions serialized in |data|.
+  void CompleteLoad(const std::string& data);
+
+  const std::string ssl_session_cache_shard_;
+  const base::FilePath path_;
+  const bool encrypt_;
+  scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
+
+  // Hash of the last data written, to avoid rewriting an unchanged file.
+  uint32 last_saved_hash_;
+
+  base::RepeatingTimer<SSLSessionCachePersister> save_timer_;
+
+  base::WeakPtrFactory<SSLSessionCachePersister> weak_ptr_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(SSLSessionCachePersister);
+};
+
+}  // namespace chrome_browser_net
+
+#endif  // CHROME_BROWSER_NET_SSL_SESSION_CACHE_PERSISTER_H_
@@ -28,6 +28,7 @@
 #include "chrome/browser/net/http_server_properties_manager.h"
 #include "chrome/browser/net/predictor.h"
 #include "chrome/browser/net/sqlite_server_bound_cert_store.h"
+#include "chrome/browser/net/ssl_session_cache_persister.h"
 #include "chrome/browser/profiles/profile.h"
 #include "chrome/common/chrome_constants.h"
 #include "chrome/common/chrome_switches.h"
@@ -461,6 +462,17 @@ void ProfileImplIOData::InitializeInternal(
               .get());
   net::HttpNetworkSession::Params network_session_params;
   PopulateNetworkSessionParams(profile_params, &network_session_params);
+  if (!chrome_browser_net::ShouldUseInMemoryCookiesAndCache()) {
+    // Encrypt the sessions on the platforms that encrypt cookies. The others
+    // already protect the entire profile contents.
+    ssl_session_cache_persister_.reset(
+        new chrome_browser_net::SSLSessionCachePersister(
+            network_session_params.ssl_session_cache_shard,
+            profile_path_,
+            chrome_browser_net::GetCookieCryptoDelegate() != NULL,
+            BrowserThread::GetMessageLoopProxyForThread(BrowserThread::FILE)
+                .get()));
+  }
   net::HttpCache* main_cache = new net::HttpCache(
       network_session_params, main_backend);
   main_cache->InitializeInfiniteCache(lazy_params_->infinite_cache_path);
@@ -16,6 +16,7 @@
 namespace chrome_browser_net {
 class HttpServerPropertiesManager;
 class Predictor;
+class SSLSessionCachePersister;
 }  // namespace chrome_browser_net
 
 namespace content {
@@ -209,6 +210,9 @@ class ProfileImplIOData : public ProfileIOData {
 
   mutable scoped_ptr<chrome_browser_net::Predictor> predictor_;
 
+  mutable scoped_ptr<chrome_browser_net::SSLSessionCachePersister>
+      ssl_session_cache_persister_;
+
   mutable scoped_ptr<ChromeURLRequestContext> media_request_context_;
 
   mutable scoped_ptr<net::URLRequestJobFactory> main_job_factory_;
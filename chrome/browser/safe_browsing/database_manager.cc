@@ -42,6 +42,9 @@ namespace {
 // Timeout for match checks, e.g. download URLs, hashes.
 const int kCheckTimeoutMs = 10000;
 
+// Number of URLs remembered as not matching the browse database.
+const size_t kCleanBrowseUrlCacheSize = 512;
+
 // Records disposition information about the check.  |hit| should be
 // |true| if there were any prefix hits in |full_hashes|.
 void RecordGetHashCheckStatus(
@@ -147,7 +150,8 @@ SafeBrowsingDatabaseManager::SafeBrowsingDatabaseManager(
       update_in_progress_(false),
       database_update_in_progress_(false),
       closing_database_(false),
-      check_timeout_(base::TimeDelta::FromMilliseconds(kCheckTimeoutMs)) {
+      check_timeout_(base::TimeDelta::FromMilliseconds(kCheckTimeoutMs)),
+      clean_browse_urls_(kCleanBrowseUrlCacheSize) {
   DCHECK(sb_service_.get() != NULL);
 
   CommandLine* cmdline = CommandLine::ForCurrentProcess();
@@ -321,6 +325,11 @@ bool SafeBrowsingDatabaseManager::CheckBrowseUrl(const GURL& url,
   if (!CanCheckUrl(url))
     return true;
 
+  // Pages tend to load the same subresources over and over, skip hashing and
+  // probing the database again for those known not to match.
+  if (clean_browse_urls_.Get(url.spec()) != clean_browse_urls_.end())
+    return true;
+
   std::vector<SBThreatType> expected_threats;
   expected_threats.push_back(SB_THREAT_TYPE_URL_MALWARE);
   expected_threats.push_back(SB_THREAT_TYPE_URL_PHISHING);
@@ -346,8 +355,13 @@ bool SafeBrowsingDatabaseManager::CheckBrowseUrl(const GURL& url,
 
   UMA_HISTOGRAM_TIMES("SB2.FilterCheck", base::TimeTicks::Now() - start);
 
-  if (!prefix_match)
+  if (!prefix_match) {
+    // Prefixes previously found to be false positives can be forgotten
+    // between updates, so only remember URLs without any prefix match.
+    if (prefix_hits.empty())
+      clean_browse_urls_.Put(url.spec(), true);
     return true;  // URL is okay.
+  }
 
   // Needs to be asynchronous, since we could be in the constructor of a
   // ResourceDispatcherHost event handler which can't pause there.
@@ -526,6 +540,7 @@ void SafeBrowsingDatabaseManager::DoStopOnIOThread() {
     return;
 
   enabled_ = false;
+  clean_browse_urls_.Clear();
 
   // Delete queued checks, calling back any clients with 'SB_THREAT_TYPE_SAFE'.
   while (!queued_checks_.empty()) {
@@ -813,12 +828,20 @@ void SafeBrowsingDatabaseManager::DatabaseUpdateFinished(
   GetDatabase()->UpdateFinished(update_succeeded);
   DCHECK(database_update_in_progress_);
   database_update_in_progress_ = false;
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&SafeBrowsingDatabaseManager::ClearCleanBrowseUrls, this));
   BrowserThread::PostTask(
       BrowserThread::UI, FROM_HERE,
       base::Bind(&SafeBrowsingDatabaseManager::NotifyDatabaseUpdateFinished,
                  this, update_succeeded));
 }
 
+void SafeBrowsingDatabaseManager::ClearCleanBrowseUrls() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  clean_browse_urls_.Clear();
+}
+
 void SafeBrowsingDatabaseManager::OnCloseDatabase() {
   DCHECK_EQ(base::MessageLoop::current(),
             safe_browsing_thread_->message_loop());
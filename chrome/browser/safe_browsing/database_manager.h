@@ -16,6 +16,7 @@
 
 #include "base/callback.h"
 #include "base/containers/hash_tables.h"
+#include "base/containers/mru_cache.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/synchronization/lock.h"
@@ -283,6 +284,10 @@ class SafeBrowsingDatabaseManager
 
   void DatabaseUpdateFinished(bool update_succeeded);
 
+  // Forgets the URLs known not to match the browse database, once an update
+  // may have added prefixes.  Runs on the IO thread.
+  void ClearCleanBrowseUrls();
+
   // Called on the db thread to close the database.  See CloseDatabase().
   void OnCloseDatabase();
 
@@ -397,6 +402,11 @@ class SafeBrowsingDatabaseManager
   // Timeout to use for safe browsing checks.
   base::TimeDelta check_timeout_;
 
+  // URLs which had no prefix match in the browse database, most recently
+  // checked first.  Only used on the IO thread, and cleared after every
+  // database update.
+  base::HashingMRUCache<std::string, bool> clean_browse_urls_;
+
   DISALLOW_COPY_AND_ASSIGN(SafeBrowsingDatabaseManager);
 };
 
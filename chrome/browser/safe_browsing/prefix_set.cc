@@ -8,6 +8,7 @@
 #include <math.h>
 
 #include "base/file_util.h"
+#include "base/files/memory_mapped_file.h"
 #include "base/files/scoped_file.h"
 #include "base/logging.h"
 #include "base/md5.h"
@@ -145,21 +146,21 @@ void PrefixSet::GetPrefixes(std::vector<SBPrefix>* prefixes) const {
 
 // static
 scoped_ptr<PrefixSet> PrefixSet::LoadFile(const base::FilePath& filter_name) {
-  int64 size_64;
-  if (!base::GetFileSize(filter_name, &size_64))
-    return scoped_ptr<PrefixSet>();
-  using base::MD5Digest;
-  if (size_64 < static_cast<int64>(sizeof(FileHeader) + sizeof(MD5Digest)))
+  // The file is laid out exactly as the data is held in memory, so map it and
+  // check it in place, then copy the index and deltas out in one go each
+  // instead of reading them through stdio buffers into zero-filled vectors.
+  base::MemoryMappedFile mapped_file;
+  if (!mapped_file.Initialize(filter_name))
     return scoped_ptr<PrefixSet>();
 
-  base::ScopedFILE file(base::OpenFile(filter_name, "rb"));
-  if (!file.get())
+  using base::MD5Digest;
+  const size_t size = mapped_file.length();
+  if (size < sizeof(FileHeader) + sizeof(MD5Digest))
     return scoped_ptr<PrefixSet>();
 
+  const char* data = reinterpret_cast<const char*>(mapped_file.data());
   FileHeader header;
-  size_t read = fread(&header, sizeof(header), 1, file.get());
-  if (read != 1)
-    return scoped_ptr<PrefixSet>();
+  memcpy(&header, data, sizeof(header));
 
   // TODO(shess): Version 1 and 2 use the same file structure, with version 1
   // data using a signed sort.  For M-35, the data is re-sorted before return.
@@ -169,58 +170,32 @@ scoped_ptr<PrefixSet> PrefixSet::LoadFile(const base::FilePath& filter_name) {
     return scoped_ptr<PrefixSet>();
   }
 
-  IndexVector index;
-  const size_t index_bytes = sizeof(index[0]) * header.index_size;
-
-  std::vector<uint16> deltas;
-  const size_t deltas_bytes = sizeof(deltas[0]) * header.deltas_size;
+  const size_t index_bytes = sizeof(IndexPair) * header.index_size;
+  const size_t deltas_bytes = sizeof(uint16) * header.deltas_size;
 
   // Check for bogus sizes before allocating any space.
   const size_t expected_bytes =
       sizeof(header) + index_bytes + deltas_bytes + sizeof(MD5Digest);
-  if (static_cast<int64>(expected_bytes) != size_64)
+  if (expected_bytes != size)
     return scoped_ptr<PrefixSet>();
 
-  // The file looks valid, start building the digest.
-  base::MD5Context context;
-  base::MD5Init(&context);
-  base::MD5Update(&context, base::StringPiece(reinterpret_cast<char*>(&header),
-                                              sizeof(header)));
-
-  // Read the index vector.  Herb Sutter indicates that vectors are
-  // guaranteed to be contiuguous, so reading to where element 0 lives
-  // is valid.
-  if (header.index_size) {
-    index.resize(header.index_size);
-    read = fread(&(index[0]), sizeof(index[0]), index.size(), file.get());
-    if (read != index.size())
-      return scoped_ptr<PrefixSet>();
-    base::MD5Update(&context,
-                    base::StringPiece(reinterpret_cast<char*>(&(index[0])),
-                                      index_bytes));
-  }
-
-  // Read vector of deltas.
-  if (header.deltas_size) {
-    deltas.resize(header.deltas_size);
-    read = fread(&(deltas[0]), sizeof(deltas[0]), deltas.size(), file.get());
-    if (read != deltas.size())
-      return scoped_ptr<PrefixSet>();
-    base::MD5Update(&context,
-                    base::StringPiece(reinterpret_cast<char*>(&(deltas[0])),
-                                      deltas_bytes));
-  }
-
+  // The file looks valid, verify the digest over everything before it.
   base::MD5Digest calculated_digest;
-  base::MD5Final(&calculated_digest, &context);
-
-  base::MD5Digest file_digest;
-  read = fread(&file_digest, sizeof(file_digest), 1, file.get());
-  if (read != 1)
+  base::MD5Sum(data, size - sizeof(MD5Digest), &calculated_digest);
+  if (0 != memcmp(data + size - sizeof(MD5Digest), &calculated_digest,
+                  sizeof(calculated_digest))) {
     return scoped_ptr<PrefixSet>();
+  }
 
-  if (0 != memcmp(&file_digest, &calculated_digest, sizeof(file_digest)))
-    return scoped_ptr<PrefixSet>();
+  // The offsets are multiples of the element sizes from the start of the
+  // mapping, so the elements are suitably aligned.
+  const IndexPair* index_begin =
+      reinterpret_cast<const IndexPair*>(data + sizeof(header));
+  IndexVector index(index_begin, index_begin + header.index_size);
+
+  const uint16* deltas_begin = reinterpret_cast<const uint16*>(
+      data + sizeof(header) + index_bytes);
+  std::vector<uint16> deltas(deltas_begin, deltas_begin + header.deltas_size);
 
   // For version 1, fetch the prefixes and re-sort.
   if (header.version == 1) {
@@ -4,10 +4,14 @@
 
 #include "chrome/browser/safe_browsing/safe_browsing_store_file.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "base/file_util.h"
 #include "base/files/scoped_file.h"
 #include "base/md5.h"
 #include "base/metrics/histogram.h"
+#include "base/time/time.h"
 
 namespace {
 
@@ -83,6 +87,11 @@ bool WriteItem(const T& item, FILE* fp, base::MD5Context* context) {
   return true;
 }
 
+// Number of items ReadToContainer() and WriteContainer() move with each
+// fread() or fwrite(), and fold into the checksum at once.  Going item by item
+// made the per-call overhead dominate updates of large stores.
+const size_t kIOBlockItems = 1024;
+
 // Read |count| items into |values| from |fp|, and fold them into the
 // checksum in |context|.  Returns true on success.
 template <typename CT>
@@ -91,19 +100,49 @@ bool ReadToContainer(CT* values, size_t count, FILE* fp,
   if (!count)
     return true;
 
-  for (size_t i = 0; i < count; ++i) {
-    typename CT::value_type value;
-    if (!ReadItem(&value, fp, context))
+  typedef typename CT::value_type ValueType;
+  std::vector<ValueType> block(std::min(count, kIOBlockItems));
+  while (count) {
+    const size_t block_count = std::min(count, block.size());
+    if (fread(&block[0], sizeof(ValueType), block_count, fp) != block_count)
       return false;
 
+    if (context) {
+      base::MD5Update(context,
+                      base::StringPiece(reinterpret_cast<char*>(&block[0]),
+                                        sizeof(ValueType) * block_count));
+    }
+
     // push_back() is more obvious, but coded this way std::set can
     // also be read.
-    values->insert(values->end(), value);
+    for (size_t i = 0; i < block_count; ++i)
+      values->insert(values->end(), block[i]);
+    count -= block_count;
   }
 
   return true;
 }
 
+// Write all of |block| to |fp|, and fold the data into the checksum
+// in |context|, if non-NULL.  Returns true on success.
+template <typename T>
+bool WriteBlock(const std::vector<T>& block, FILE* fp,
+                base::MD5Context* context) {
+  if (block.empty())
+    return true;
+
+  const size_t ret = fwrite(&block[0], sizeof(T), block.size(), fp);
+  if (ret != block.size())
+    return false;
+
+  if (context) {
+    base::MD5Update(context,
+                    base::StringPiece(reinterpret_cast<const char*>(&block[0]),
+                                      sizeof(T) * block.size()));
+  }
+  return true;
+}
+
 // Write all of |values| to |fp|, and fold the data into the checksum
 // in |context|, if non-NULL.  Returns true on succsess.
 template <typename CT>
@@ -112,12 +151,19 @@ bool WriteContainer(const CT& values, FILE* fp,
   if (values.empty())
     return true;
 
+  typedef typename CT::value_type ValueType;
+  std::vector<ValueType> block;
+  block.reserve(std::min(values.size(), kIOBlockItems));
   for (typename CT::const_iterator iter = values.begin();
        iter != values.end(); ++iter) {
-    if (!WriteItem(*iter, fp, context))
-      return false;
+    block.push_back(*iter);
+    if (block.size() == kIOBlockItems) {
+      if (!WriteBlock(block, fp, context))
+        return false;
+      block.clear();
+    }
   }
-  return true;
+  return WriteBlock(block, fp, context);
 }
 
 // Delete the chunks in |deleted| from |chunks|.
@@ -601,6 +647,16 @@ bool SafeBrowsingStoreFile::DoUpdate(
   add_full_hashes.insert(add_full_hashes.end(),
                          pending_adds.begin(), pending_adds.end());
 
+  // Everything is in memory at this point, before the subs are knocked out,
+  // so this is the peak working set of the update.
+  const size_t working_set_bytes =
+      add_prefixes.size() * sizeof(SBAddPrefix) +
+      sub_prefixes.size() * sizeof(SBSubPrefix) +
+      add_full_hashes.capacity() * sizeof(SBAddFullHash) +
+      sub_full_hashes.capacity() * sizeof(SBSubFullHash);
+  UMA_HISTOGRAM_COUNTS("SB2.UpdateWorkingSetKilobytes",
+                       static_cast<int>(working_set_bytes / 1024));
+
   // Knock the subs from the adds and process deleted chunks.
   SBProcessSubs(&add_prefixes, &sub_prefixes,
                 &add_full_hashes, &sub_full_hashes,
@@ -680,10 +736,13 @@ bool SafeBrowsingStoreFile::FinishUpdate(
   DCHECK(builder);
   DCHECK(add_full_hashes_result);
 
+  const base::TimeTicks before = base::TimeTicks::Now();
   if (!DoUpdate(pending_adds, builder, add_full_hashes_result)) {
     CancelUpdate();
     return false;
   }
+  UMA_HISTOGRAM_LONG_TIMES("SB2.StoreUpdateTime",
+                           base::TimeTicks::Now() - before);
 
   DCHECK(!new_file_.get());
   DCHECK(!file_.get());
@@ -200,6 +200,42 @@ TEST_F(SafeBrowsingStoreFileTest, StorePrefix) {
   }
 }
 
+// Test that a store with more items than are read or written at once
+// round-trips intact.
+TEST_F(SafeBrowsingStoreFileTest, StoreManyPrefixes) {
+  const SBPrefix kPrefixCount = 5000;
+
+  EXPECT_TRUE(store_->BeginUpdate());
+  EXPECT_TRUE(store_->BeginChunk());
+  store_->SetAddChunk(kAddChunk1);
+  for (SBPrefix prefix = 0; prefix < kPrefixCount; ++prefix)
+    EXPECT_TRUE(store_->WriteAddPrefix(kAddChunk1, prefix * 3));
+  EXPECT_TRUE(store_->FinishChunk());
+
+  std::vector<SBAddFullHash> pending_adds;
+  {
+    safe_browsing::PrefixSetBuilder builder;
+    std::vector<SBAddFullHash> add_full_hashes_result;
+    EXPECT_TRUE(store_->FinishUpdate(pending_adds,
+                                     &builder,
+                                     &add_full_hashes_result));
+  }
+
+  // Read the data back from the file.
+  EXPECT_TRUE(store_->BeginUpdate());
+  safe_browsing::PrefixSetBuilder builder;
+  std::vector<SBAddFullHash> add_full_hashes_result;
+  EXPECT_TRUE(store_->FinishUpdate(pending_adds,
+                                   &builder,
+                                   &add_full_hashes_result));
+
+  std::vector<SBPrefix> prefixes_result;
+  builder.GetPrefixSet()->GetPrefixes(&prefixes_result);
+  ASSERT_EQ(kPrefixCount, prefixes_result.size());
+  for (SBPrefix prefix = 0; prefix < kPrefixCount; ++prefix)
+    EXPECT_EQ(prefix * 3, prefixes_result[prefix]);
+}
+
 // Test that subs knockout adds.
 TEST_F(SafeBrowsingStoreFileTest, SubKnockout) {
   EXPECT_TRUE(store_->BeginUpdate());
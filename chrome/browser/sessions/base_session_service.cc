@@ -79,6 +79,8 @@ BaseSessionService::BaseSessionService(SessionType type,
       weak_factory_(this),
       pending_reset_(false),
       commands_since_reset_(0),
+      bytes_since_reset_(0),
+      bytes_at_last_reset_(0),
       sequence_token_(
           content::BrowserThread::GetBlockingPool()->GetSequenceToken()) {
   if (profile) {
@@ -101,6 +103,7 @@ void BaseSessionService::DeleteLastSession() {
 void BaseSessionService::ScheduleCommand(SessionCommand* command) {
   DCHECK(command);
   commands_since_reset_++;
+  bytes_since_reset_ += command->size();
   pending_commands_.push_back(command);
   StartSaveTimer();
 }
@@ -123,6 +126,15 @@ void BaseSessionService::Save() {
   if (pending_commands_.empty())
     return;
 
+  if (pending_reset_) {
+    bytes_at_last_reset_ = 0;
+    for (std::vector<SessionCommand*>::const_iterator i =
+             pending_commands_.begin();
+         i != pending_commands_.end(); ++i) {
+      bytes_at_last_reset_ += (*i)->size();
+    }
+  }
+
   RunTaskOnBackendThread(
       FROM_HERE,
       base::Bind(&SessionBackend::AppendCommands, backend(),
@@ -134,6 +146,7 @@ void BaseSessionService::Save() {
 
   if (pending_reset_) {
     commands_since_reset_ = 0;
+    bytes_since_reset_ = 0;
     pending_reset_ = false;
   }
 }
@@ -77,6 +77,12 @@ class BaseSessionService : public CancelableRequestProvider {
   // Returns the number of commands sent down since the last reset.
   int commands_since_reset() const { return commands_since_reset_; }
 
+  // Returns the number of bytes of commands scheduled since the last reset.
+  int bytes_since_reset() const { return bytes_since_reset_; }
+
+  // Returns the number of bytes of commands the last reset wrote.
+  int bytes_at_last_reset() const { return bytes_at_last_reset_; }
+
   // Schedules a command. This adds |command| to pending_commands_ and
   // invokes StartSaveTimer to start a timer that invokes Save at a later
   // time.
@@ -185,6 +191,11 @@ class BaseSessionService : public CancelableRequestProvider {
   // The number of commands sent to the backend before doing a reset.
   int commands_since_reset_;
 
+  // The size of the commands scheduled since the last reset, and of the
+  // commands written by the last reset.
+  int bytes_since_reset_;
+  int bytes_at_last_reset_;
+
   // A token to make sure that all tasks will be serialized.
   base::SequencedWorkerPool::SequenceToken sequence_token_;
 
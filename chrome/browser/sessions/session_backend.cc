@@ -236,6 +236,19 @@ void SessionBackend::AppendCommands(
     current_session_file_.reset(NULL);
   }
   empty_file_ = false;
+
+  int bytes_written = 0;
+  for (std::vector<SessionCommand*>::const_iterator i = commands->begin();
+       i != commands->end(); ++i) {
+    bytes_written += (*i)->size() + sizeof(size_type) + sizeof(id_type);
+  }
+  if (type_ == BaseSessionService::TAB_RESTORE) {
+    UMA_HISTOGRAM_COUNTS("TabRestore.append_size", bytes_written);
+  } else if (reset_first) {
+    UMA_HISTOGRAM_COUNTS("SessionRestore.reset_size", bytes_written);
+  } else {
+    UMA_HISTOGRAM_COUNTS("SessionRestore.append_size", bytes_written);
+  }
   STLDeleteElements(commands);
   delete commands;
 }
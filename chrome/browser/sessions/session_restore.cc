@@ -19,6 +19,7 @@
 #include "base/platform_file.h"
 #include "base/stl_util.h"
 #include "base/strings/stringprintf.h"
+#include "base/sys_info.h"
 #include "base/task/cancelable_task_tracker.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/chrome_notification_types.h"
@@ -77,11 +78,22 @@ std::set<SessionRestoreImpl*>* active_session_restorers = NULL;
 // Initial delay (see class decription for details).
 static const int kInitialDelayTimerMS = 100;
 
+// Upper bound on the number of tabs TabLoader loads at the same time.
+static const size_t kMaxConcurrentTabLoads = 4;
+
+// Memory a loading tab is assumed to need. TabLoader doesn't start more loads
+// than fit in the physical memory available when the restore starts.
+static const int64 kMemoryPerTabLoadMB = 128;
+
 // TabLoader is responsible for loading tabs after session restore creates
 // tabs. New tabs are loaded after the current tab finishes loading, or a delay
 // is reached (initially kInitialDelayTimerMS). If the delay is reached before
 // a tab finishes loading a new tab is loaded and the time of the delay
-// doubled.
+// doubled. No new tab is loaded while |max_concurrent_loads_| tabs are loading,
+// so that restoring many tabs doesn't starve the selected ones.
+//
+// A tab the user selects before its turn is loaded by the browser right away;
+// TabLoader then treats it as one of the tabs that are loading.
 //
 // TabLoader keeps a reference to itself when it's loading. When it has finished
 // loading, it drops the reference. If another profile is restored while the
@@ -151,6 +163,10 @@ class TabLoader : public content::NotificationObserver,
   // Register for necessary notifications on a tab navigation controller.
   void RegisterForNotifications(NavigationController* controller);
 
+  // Returns how many tabs may load at the same time on this machine, based on
+  // the number of processors and the available physical memory.
+  static size_t ComputeMaxConcurrentLoads();
+
   // Called when a tab goes away or a load completes.
   void HandleTabClosedOrLoaded(NavigationController* controller);
 
@@ -190,6 +206,9 @@ class TabLoader : public content::NotificationObserver,
   // Max number of tabs that were loaded in parallel (for metrics).
   size_t max_parallel_tab_loads_;
 
+  // Number of tabs that may load at the same time.
+  const size_t max_concurrent_loads_;
+
   // For keeping TabLoader alive while it's loading even if no
   // SessionRestoreImpls reference it.
   scoped_refptr<TabLoader> this_retainer_;
@@ -254,7 +273,8 @@ TabLoader::TabLoader(base::TimeTicks restore_started)
       got_first_paint_(false),
       tab_count_(0),
       restore_started_(restore_started),
-      max_parallel_tab_loads_(0) {
+      max_parallel_tab_loads_(0),
+      max_concurrent_loads_(ComputeMaxConcurrentLoads()) {
 }
 
 TabLoader::~TabLoader() {
@@ -265,7 +285,7 @@ TabLoader::~TabLoader() {
 }
 
 void TabLoader::LoadNextTab() {
-  if (!tabs_to_load_.empty()) {
+  if (!tabs_to_load_.empty() && tabs_loading_.size() < max_concurrent_loads_) {
     NavigationController* tab = tabs_to_load_.front();
     DCHECK(tab);
     tabs_loading_.insert(tab);
@@ -290,10 +310,12 @@ void TabLoader::LoadNextTab() {
     }
   }
 
-  if (!tabs_to_load_.empty()) {
-    force_load_timer_.Stop();
+  force_load_timer_.Stop();
+  if (!tabs_to_load_.empty() && tabs_loading_.size() < max_concurrent_loads_) {
     // Each time we load a tab we also set a timer to force us to start loading
-    // the next tab if this one doesn't load quickly enough.
+    // the next tab if this one doesn't load quickly enough. Once the limit of
+    // concurrent loads is reached, the next tab is loaded when one of them
+    // finishes instead.
     force_load_timer_.Start(FROM_HERE,
         base::TimeDelta::FromMilliseconds(force_load_delay_),
         this, &TabLoader::ForceLoadTimerFired);
@@ -322,6 +344,13 @@ void TabLoader::Observe(int type,
       RenderWidgetHost* render_widget_host = GetRenderWidgetHost(tab);
       DCHECK(render_widget_host);
       render_widget_hosts_loading_.insert(render_widget_host);
+      // The tab was selected before its turn came, so it is loading already.
+      TabsToLoad::iterator i =
+          find(tabs_to_load_.begin(), tabs_to_load_.end(), tab);
+      if (i != tabs_to_load_.end()) {
+        tabs_to_load_.erase(i);
+        tabs_loading_.insert(tab);
+      }
       break;
     }
     case content::NOTIFICATION_WEB_CONTENTS_DESTROYED: {
@@ -450,6 +479,22 @@ void TabLoader::RegisterForNotifications(NavigationController* controller) {
   ++tab_count_;
 }
 
+// static
+size_t TabLoader::ComputeMaxConcurrentLoads() {
+  size_t max_loads = std::min(
+      kMaxConcurrentTabLoads,
+      static_cast<size_t>(std::max(1, base::SysInfo::NumberOfProcessors())));
+  int64 available_memory_mb =
+      base::SysInfo::AmountOfAvailablePhysicalMemory() / 1024 / 1024;
+  int64 loads_fitting_in_memory = available_memory_mb / kMemoryPerTabLoadMB;
+  if (available_memory_mb > 0 &&
+      loads_fitting_in_memory < static_cast<int64>(max_loads)) {
+    max_loads =
+        static_cast<size_t>(std::max<int64>(1, loads_fitting_in_memory));
+  }
+  return max_loads;
+}
+
 void TabLoader::HandleTabClosedOrLoaded(NavigationController* tab) {
   RemoveTab(tab);
   if (loading_)
@@ -83,7 +83,11 @@ static const SessionCommand::id_type kCommandSetTabUserAgentOverride = 18;
 static const SessionCommand::id_type kCommandSessionStorageAssociated = 19;
 static const SessionCommand::id_type kCommandSetActiveWindow = 20;
 
-// Every kWritesPerReset commands triggers recreating the file.
+// Every kWritesPerReset commands triggers recreating the file, once the
+// commands appended since the last reset are at least as large as what that
+// reset wrote. Rebuilding the commands costs time proportional to the size of
+// the session, so this keeps the cost of resets proportional to the amount of
+// data appended, even for sessions with many tabs.
 static const int kWritesPerReset = 250;
 
 namespace {
@@ -1482,6 +1486,7 @@ void SessionService::ScheduleCommand(SessionCommand* command) {
   // lose tabs/windows we want to restore from if we exit right after this.
   if (!pending_reset() && pending_window_close_ids_.empty() &&
       commands_since_reset() >= kWritesPerReset &&
+      bytes_since_reset() >= bytes_at_last_reset() &&
       (command->id() != kCommandTabClosed &&
        command->id() != kCommandWindowClosed)) {
     ScheduleReset();
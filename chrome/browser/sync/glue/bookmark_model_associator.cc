@@ -4,6 +4,7 @@
 
 #include "chrome/browser/sync/glue/bookmark_model_associator.h"
 
+#include <map>
 #include <stack>
 
 #include "base/bind.h"
@@ -64,36 +65,36 @@ const char kOtherBookmarksTag[] = "other_bookmarks";
 // limits; see write_node.cc).
 const int kTitleLimitBytes = 255;
 
-// Bookmark comparer for map of bookmark nodes.
-class BookmarkComparer {
+// The attributes a bookmark node is matched to a sync node by.
+class BookmarkMatchKey {
  public:
-  // Compares the two given nodes and returns whether node1 should appear
-  // before node2 in strict weak ordering.
-  bool operator()(const BookmarkNode* node1,
-                  const BookmarkNode* node2) const {
-    DCHECK(node1);
-    DCHECK(node2);
-
-    // Keep folder nodes before non-folder nodes.
-    if (node1->is_folder() != node2->is_folder())
-      return node1->is_folder();
-
+  BookmarkMatchKey(const GURL& url, const std::string& title, bool is_folder)
+      : url_(url),
+        is_folder_(is_folder) {
     // Truncate bookmark titles in the form sync does internally to avoid
     // mismatches due to sync munging titles.
-    std::string title1 = base::UTF16ToUTF8(node1->GetTitle());
-    syncer::SyncAPINameToServerName(title1, &title1);
-    base::TruncateUTF8ToByteSize(title1, kTitleLimitBytes, &title1);
+    syncer::SyncAPINameToServerName(title, &title_);
+    base::TruncateUTF8ToByteSize(title_, kTitleLimitBytes, &title_);
+  }
 
-    std::string title2 = base::UTF16ToUTF8(node2->GetTitle());
-    syncer::SyncAPINameToServerName(title2, &title2);
-    base::TruncateUTF8ToByteSize(title2, kTitleLimitBytes, &title2);
+  // Returns whether this key should appear before |other| in strict weak
+  // ordering.
+  bool operator<(const BookmarkMatchKey& other) const {
+    // Keep folder nodes before non-folder nodes.
+    if (is_folder_ != other.is_folder_)
+      return is_folder_;
 
-    int result = title1.compare(title2);
+    int result = title_.compare(other.title_);
     if (result != 0)
       return result < 0;
 
-    return node1->url() < node2->url();
+    return url_ < other.url_;
   }
+
+ private:
+  GURL url_;
+  std::string title_;
+  bool is_folder_;
 };
 
 // Provides the following abstraction: given a parent bookmark node, find best
@@ -111,10 +112,13 @@ class BookmarkNodeFinder {
                                        bool is_folder);
 
  private:
-  typedef std::multiset<const BookmarkNode*, BookmarkComparer> BookmarkNodesSet;
+  // The keys of the child nodes are computed once, up front, rather than on
+  // every comparison, since that converts and munges both titles.
+  typedef std::multimap<BookmarkMatchKey, const BookmarkNode*>
+      BookmarkNodesMap;
 
   const BookmarkNode* parent_node_;
-  BookmarkNodesSet child_nodes_;
+  BookmarkNodesMap child_nodes_;
 
   DISALLOW_COPY_AND_ASSIGN(BookmarkNodeFinder);
 };
@@ -139,24 +143,21 @@ class ScopedAssociationUpdater {
 BookmarkNodeFinder::BookmarkNodeFinder(const BookmarkNode* parent_node)
     : parent_node_(parent_node) {
   for (int i = 0; i < parent_node_->child_count(); ++i) {
-    child_nodes_.insert(parent_node_->GetChild(i));
+    const BookmarkNode* child = parent_node_->GetChild(i);
+    child_nodes_.insert(std::make_pair(
+        BookmarkMatchKey(child->url(), base::UTF16ToUTF8(child->GetTitle()),
+                         child->is_folder()),
+        child));
   }
 }
 
 const BookmarkNode* BookmarkNodeFinder::FindBookmarkNode(
     const GURL& url, const std::string& title, bool is_folder) {
-  // Create a bookmark node from the given bookmark attributes.
-  BookmarkNode temp_node(url);
-  temp_node.SetTitle(base::UTF8ToUTF16(title));
-  if (is_folder)
-    temp_node.set_type(BookmarkNode::FOLDER);
-  else
-    temp_node.set_type(BookmarkNode::URL);
-
   const BookmarkNode* result = NULL;
-  BookmarkNodesSet::iterator iter = child_nodes_.find(&temp_node);
+  BookmarkNodesMap::iterator iter =
+      child_nodes_.find(BookmarkMatchKey(url, title, is_folder));
   if (iter != child_nodes_.end()) {
-    result = *iter;
+    result = iter->second;
     // Remove the matched node so we don't match with it again.
     child_nodes_.erase(iter);
   }
@@ -0,0 +1,129 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/task_manager/process_sampler.h"
+
+#include <set>
+
+#include "base/bind.h"
+#include "base/location.h"
+#include "base/process/process_metrics.h"
+#include "base/sequenced_task_runner.h"
+#include "base/stl_util.h"
+
+#if defined(OS_MACOSX)
+#include "content/public/browser/browser_child_process_host.h"
+#endif
+
+namespace task_manager {
+
+ProcessSample::ProcessSample()
+    : cpu_usage(0),
+      idle_wakeups(0),
+      is_memory_sampled(false),
+      is_private_and_shared_valid(false),
+      private_bytes(0),
+      shared_bytes(0),
+      is_physical_memory_valid(false),
+      physical_memory(0) {}
+
+base::ProcessMetrics* CreateProcessMetrics(base::ProcessHandle process) {
+#if !defined(OS_MACOSX)
+  return base::ProcessMetrics::CreateProcessMetrics(process);
+#else
+  return base::ProcessMetrics::CreateProcessMetrics(
+      process, content::BrowserChildProcessHost::GetPortProvider());
+#endif
+}
+
+void SampleProcessMemory(base::ProcessMetrics* metrics, ProcessSample* sample) {
+  sample->is_memory_sampled = true;
+
+  base::WorkingSetKBytes ws_usage;
+  if (!metrics->GetWorkingSetKBytes(&ws_usage))
+    return;
+
+  sample->is_physical_memory_valid = true;
+#if defined(OS_LINUX)
+  // On Linux GetMemoryBytes() is GetWorkingSetKBytes() in bytes, and private
+  // memory is also resident, so one read of statm (or totmaps on Chrome OS)
+  // gives all three values.
+  sample->is_private_and_shared_valid = true;
+  sample->private_bytes = ws_usage.priv * 1024;
+  sample->shared_bytes = ws_usage.shared * 1024;
+  sample->physical_memory = sample->private_bytes;
+#else
+  // Memory = working_set.private + working_set.shareable.
+  // We exclude the shared memory.
+  sample->physical_memory = metrics->GetWorkingSetSize();
+  sample->physical_memory -= ws_usage.shared * 1024;
+  sample->is_private_and_shared_valid =
+      metrics->GetMemoryBytes(&sample->private_bytes, &sample->shared_bytes);
+#endif
+}
+
+ProcessSampler::ProcessSampler(
+    const scoped_refptr<base::SequencedTaskRunner>& task_runner)
+    : task_runner_(task_runner) {
+}
+
+ProcessSampler::~ProcessSampler() {
+  STLDeleteValues(&metrics_map_);
+}
+
+void ProcessSampler::Sample(const std::vector<base::ProcessHandle>& processes,
+                            bool sample_memory,
+                            const SampleCallback& callback) {
+  ProcessSamples* samples = new ProcessSamples;
+  task_runner_->PostTaskAndReply(
+      FROM_HERE,
+      base::Bind(&ProcessSampler::SampleOnTaskRunner, this, processes,
+                 sample_memory, samples),
+      base::Bind(&ProcessSampler::RunCallback, callback,
+                 base::Owned(samples)));
+}
+
+void ProcessSampler::SampleOnTaskRunner(
+    const std::vector<base::ProcessHandle>& processes,
+    bool sample_memory,
+    ProcessSamples* samples) {
+  DCHECK(task_runner_->RunsTasksOnCurrentThread());
+
+  // Forget the processes that are gone since the last sample.
+  std::set<base::ProcessHandle> current(processes.begin(), processes.end());
+  for (MetricsMap::iterator iter = metrics_map_.begin();
+       iter != metrics_map_.end();) {
+    if (current.count(iter->first)) {
+      ++iter;
+    } else {
+      delete iter->second;
+      metrics_map_.erase(iter++);
+    }
+  }
+
+  for (std::set<base::ProcessHandle>::const_iterator iter = current.begin();
+       iter != current.end(); ++iter) {
+    base::ProcessMetrics*& metrics = metrics_map_[*iter];
+    if (!metrics)
+      metrics = CreateProcessMetrics(*iter);
+
+    ProcessSample& sample((*samples)[*iter]);
+    sample.cpu_usage = metrics->GetCPUUsage();
+#if defined(OS_MACOSX)
+    // TODO: Implement GetIdleWakeupsPerSecond() on other platforms,
+    // crbug.com/120488
+    sample.idle_wakeups = metrics->GetIdleWakeupsPerSecond();
+#endif  // defined(OS_MACOSX)
+    if (sample_memory)
+      SampleProcessMemory(metrics, &sample);
+  }
+}
+
+// static
+void ProcessSampler::RunCallback(const SampleCallback& callback,
+                                 ProcessSamples* samples) {
+  callback.Run(*samples);
+}
+
+}  // namespace task_manager
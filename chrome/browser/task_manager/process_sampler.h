@@ -0,0 +1,95 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_TASK_MANAGER_PROCESS_SAMPLER_H_
+#define CHROME_BROWSER_TASK_MANAGER_PROCESS_SAMPLER_H_
+
+#include <map>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "base/memory/ref_counted.h"
+#include "base/process/process_handle.h"
+
+namespace base {
+class ProcessMetrics;
+class SequencedTaskRunner;
+}
+
+namespace task_manager {
+
+// The values sampled for one process in one refresh of the task manager.
+struct ProcessSample {
+  ProcessSample();
+
+  double cpu_usage;
+  int idle_wakeups;
+
+  // Whether the memory values below were sampled. They are only sampled when
+  // asked for, as reading them is the expensive part of a sample.
+  bool is_memory_sampled;
+
+  bool is_private_and_shared_valid;
+  size_t private_bytes;
+  size_t shared_bytes;
+
+  bool is_physical_memory_valid;
+  size_t physical_memory;
+};
+
+typedef std::map<base::ProcessHandle, ProcessSample> ProcessSamples;
+
+// Creates the ProcessMetrics for |process|. The caller owns the result.
+base::ProcessMetrics* CreateProcessMetrics(base::ProcessHandle process);
+
+// Fills the memory values of |sample| from |metrics|, reading each of the
+// underlying files once.
+void SampleProcessMemory(base::ProcessMetrics* metrics, ProcessSample* sample);
+
+// Samples the processes shown by the task manager on a task runner that may
+// block, typically a sequence of the blocking pool, so that the /proc reads
+// (or their equivalent on other platforms) stay off the UI thread. The
+// ProcessMetrics, which remember the CPU time of the previous sample, live
+// on that task runner.
+class ProcessSampler : public base::RefCountedThreadSafe<ProcessSampler> {
+ public:
+  typedef base::Callback<void(const ProcessSamples&)> SampleCallback;
+
+  explicit ProcessSampler(
+      const scoped_refptr<base::SequencedTaskRunner>& task_runner);
+
+  // Samples the CPU usage of each of |processes|, and their memory if
+  // |sample_memory|, then runs |callback| on the calling thread. Processes
+  // that are not in |processes| are forgotten.
+  void Sample(const std::vector<base::ProcessHandle>& processes,
+              bool sample_memory,
+              const SampleCallback& callback);
+
+ private:
+  friend class base::RefCountedThreadSafe<ProcessSampler>;
+
+  typedef std::map<base::ProcessHandle, base::ProcessMetrics*> MetricsMap;
+
+  ~ProcessSampler();
+
+  // Runs on |task_runner_|.
+  void SampleOnTaskRunner(const std::vector<base::ProcessHandle>& processes,
+                          bool sample_memory,
+                          ProcessSamples* samples);
+
+  static void RunCallback(const SampleCallback& callback,
+                          ProcessSamples* samples);
+
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+
+  // Only accessed on |task_runner_|. The ProcessMetrics are owned.
+  MetricsMap metrics_map_;
+
+  DISALLOW_COPY_AND_ASSIGN(ProcessSampler);
+};
+
+}  // namespace task_manager
+
+#endif  // CHROME_BROWSER_TASK_MANAGER_PROCESS_SAMPLER_H_
@@ -7,6 +7,7 @@
 #include "base/bind.h"
 #include "base/i18n/number_formatting.h"
 #include "base/i18n/rtl.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/prefs/pref_registry_simple.h"
 #include "base/process/process_metrics.h"
 #include "base/rand_util.h"
@@ -15,6 +16,7 @@
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/threading/sequenced_worker_pool.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/profiles/profile_manager.h"
 #include "chrome/browser/task_manager/background_information.h"
@@ -50,10 +52,6 @@
 #include "chrome/browser/task_manager/notification_resource_provider.h"
 #endif
 
-#if defined(OS_MACOSX)
-#include "content/public/browser/browser_child_process_host.h"
-#endif
-
 using content::BrowserThread;
 using content::ResourceRequestInfo;
 using content::WebContents;
@@ -219,6 +217,7 @@ TaskManagerModel::PerProcessValues::PerProcessValues()
       cpu_usage(0),
       is_idle_wakeups_valid(false),
       idle_wakeups(0),
+      is_memory_sampled(false),
       is_private_and_shared_valid(false),
       private_bytes(0),
       shared_bytes(0),
@@ -242,10 +241,17 @@ TaskManagerModel::PerProcessValues::~PerProcessValues() {}
 
 TaskManagerModel::TaskManagerModel(TaskManager* task_manager)
     : pending_video_memory_usage_stats_update_(false),
+      pending_process_sample_(false),
+      process_memory_requested_(false),
       update_requests_(0),
       listen_requests_(0),
       update_state_(IDLE),
       goat_salt_(base::RandUint64()) {
+  base::SequencedWorkerPool* pool = BrowserThread::GetBlockingPool();
+  process_sampler_ = new task_manager::ProcessSampler(
+      pool->GetSequencedTaskRunnerWithShutdownBehavior(
+          pool->GetSequenceToken(),
+          base::SequencedWorkerPool::SKIP_ON_SHUTDOWN));
   AddResourceProvider(
       new task_manager::BrowserProcessResourceProvider(task_manager));
   AddResourceProvider(new task_manager::WebContentsResourceProvider(
@@ -563,45 +569,32 @@ base::string16 TaskManagerModel::GetResourceV8MemoryAllocatedSize(
 bool TaskManagerModel::GetPrivateMemory(int index, size_t* result) const {
   *result = 0;
   base::ProcessHandle handle = GetResource(index)->GetProcess();
-  if (!CachePrivateAndSharedMemory(handle))
+  CacheProcessMemory(handle);
+  const PerProcessValues& values(per_process_cache_[handle]);
+  if (!values.is_private_and_shared_valid)
     return false;
-  *result = per_process_cache_[handle].private_bytes;
+  *result = values.private_bytes;
   return true;
 }
 
 bool TaskManagerModel::GetSharedMemory(int index, size_t* result) const {
   *result = 0;
   base::ProcessHandle handle = GetResource(index)->GetProcess();
-  if (!CachePrivateAndSharedMemory(handle))
+  CacheProcessMemory(handle);
+  const PerProcessValues& values(per_process_cache_[handle]);
+  if (!values.is_private_and_shared_valid)
     return false;
-  *result = per_process_cache_[handle].shared_bytes;
+  *result = values.shared_bytes;
   return true;
 }
 
 bool TaskManagerModel::GetPhysicalMemory(int index, size_t* result) const {
   *result = 0;
-
   base::ProcessHandle handle = GetResource(index)->GetProcess();
-  PerProcessValues& values(per_process_cache_[handle]);
-
-  if (!values.is_physical_memory_valid) {
-    base::WorkingSetKBytes ws_usage;
-    MetricsMap::const_iterator iter = metrics_map_.find(handle);
-    if (iter == metrics_map_.end() ||
-        !iter->second->GetWorkingSetKBytes(&ws_usage))
-      return false;
-
-    values.is_physical_memory_valid = true;
-#if defined(OS_LINUX)
-    // On Linux private memory is also resident. Just use it.
-    values.physical_memory = ws_usage.priv * 1024;
-#else
-    // Memory = working_set.private + working_set.shareable.
-    // We exclude the shared memory.
-    values.physical_memory = iter->second->GetWorkingSetSize();
-    values.physical_memory -= ws_usage.shared * 1024;
-#endif
-  }
+  CacheProcessMemory(handle);
+  const PerProcessValues& values(per_process_cache_[handle]);
+  if (!values.is_physical_memory_valid)
+    return false;
   *result = values.physical_memory;
   return true;
 }
@@ -998,19 +991,6 @@ void TaskManagerModel::AddResource(Resource* resource) {
     resources_.insert(++iter, resource);
   }
 
-  // Create the ProcessMetrics for this process if needed (not in map).
-  if (metrics_map_.find(process) == metrics_map_.end()) {
-    base::ProcessMetrics* pm =
-#if !defined(OS_MACOSX)
-        base::ProcessMetrics::CreateProcessMetrics(process);
-#else
-        base::ProcessMetrics::CreateProcessMetrics(
-            process, content::BrowserChildProcessHost::GetPortProvider());
-#endif
-
-    metrics_map_[process] = pm;
-  }
-
   // Notify the table that the contents have changed for it to redraw.
   FOR_EACH_OBSERVER(TaskManagerModelObserver, observer_list_,
                     OnItemsAdded(new_entry_index, 1));
@@ -1035,14 +1015,7 @@ void TaskManagerModel::RemoveResource(Resource* resource) {
   if (group_entries->empty()) {
     delete group_entries;
     group_map_.erase(process);
-
-    // Nobody is using this process, we don't need the process metrics anymore.
-    MetricsMap::iterator pm_iter = metrics_map_.find(process);
-    DCHECK(pm_iter != metrics_map_.end());
-    if (pm_iter != metrics_map_.end()) {
-      delete pm_iter->second;
-      metrics_map_.erase(process);
-    }
+    // |process_sampler_| drops the process metrics at its next sample.
   }
 
   // Prepare to remove the entry from the model list.
@@ -1152,9 +1125,6 @@ void TaskManagerModel::Clear() {
     // Clear the groups.
     STLDeleteValues(&group_map_);
 
-    // Clear the process related info.
-    STLDeleteValues(&metrics_map_);
-
     // Clear the network maps.
     current_byte_count_map_.clear();
 
@@ -1175,35 +1145,10 @@ void TaskManagerModel::Refresh() {
   goat_salt_ = base::RandUint64();
 
   per_resource_cache_.clear();
-  per_process_cache_.clear();
 
-  // Compute the CPU usage values.
-  // Note that we compute the CPU usage for all resources (instead of doing it
-  // lazily) as process_util::GetCPUUsage() returns the CPU usage since the last
-  // time it was called, and not calling it everytime would skew the value the
-  // next time it is retrieved (as it would be for more than 1 cycle).
-  // The same is true for idle wakeups.
-  for (ResourceList::iterator iter = resources_.begin();
-       iter != resources_.end(); ++iter) {
-    base::ProcessHandle process = (*iter)->GetProcess();
-    PerProcessValues& values(per_process_cache_[process]);
-    if (values.is_cpu_usage_valid && values.is_idle_wakeups_valid)
-      continue;
-    MetricsMap::iterator metrics_iter = metrics_map_.find(process);
-    DCHECK(metrics_iter != metrics_map_.end());
-    if (!values.is_cpu_usage_valid) {
-      values.is_cpu_usage_valid = true;
-      values.cpu_usage = metrics_iter->second->GetCPUUsage();
-    }
-#if defined(OS_MACOSX)
-    // TODO: Implement GetIdleWakeupsPerSecond() on other platforms,
-    // crbug.com/120488
-    if (!values.is_idle_wakeups_valid) {
-      values.is_idle_wakeups_valid = true;
-      values.idle_wakeups = metrics_iter->second->GetIdleWakeupsPerSecond();
-    }
-#endif  // defined(OS_MACOSX)
-  }
+  // Sample the per-process values on the blocking pool. The per-process cache
+  // is replaced when the sample comes back.
+  SampleProcesses();
 
   // Send a request to refresh GPU memory consumption values
   RefreshVideoMemoryUsageStats();
@@ -1345,6 +1290,59 @@ void TaskManagerModel::RefreshCallback() {
       base::TimeDelta::FromMilliseconds(kUpdateTimeMs));
 }
 
+void TaskManagerModel::SampleProcesses() {
+  if (pending_process_sample_)
+    return;
+
+  // Note that we sample the CPU usage of all processes (instead of doing it
+  // lazily) as ProcessMetrics::GetCPUUsage() returns the CPU usage since the
+  // last time it was called, and not calling it everytime would skew the value
+  // the next time it is retrieved (as it would be for more than 1 cycle).
+  // The same is true for idle wakeups.
+  std::vector<base::ProcessHandle> processes;
+  for (GroupMap::const_iterator iter = group_map_.begin();
+       iter != group_map_.end(); ++iter) {
+    processes.push_back(iter->first);
+  }
+  if (processes.empty())
+    return;
+
+  pending_process_sample_ = true;
+  process_sampler_->Sample(
+      processes,
+      process_memory_requested_,
+      base::Bind(&TaskManagerModel::OnProcessesSampled, this));
+  process_memory_requested_ = false;
+}
+
+void TaskManagerModel::OnProcessesSampled(
+    const task_manager::ProcessSamples& samples) {
+  pending_process_sample_ = false;
+
+  per_process_cache_.clear();
+  for (task_manager::ProcessSamples::const_iterator iter = samples.begin();
+       iter != samples.end(); ++iter) {
+    // Skip the processes that went away while sampling.
+    if (group_map_.find(iter->first) == group_map_.end())
+      continue;
+    const task_manager::ProcessSample& sample = iter->second;
+    PerProcessValues& values(per_process_cache_[iter->first]);
+    values.is_cpu_usage_valid = true;
+    values.cpu_usage = sample.cpu_usage;
+#if defined(OS_MACOSX)
+    values.is_idle_wakeups_valid = true;
+    values.idle_wakeups = sample.idle_wakeups;
+#endif  // defined(OS_MACOSX)
+    if (sample.is_memory_sampled)
+      CopyMemorySample(sample, &values);
+  }
+
+  if (!resources_.empty()) {
+    FOR_EACH_OBSERVER(TaskManagerModelObserver, observer_list_,
+                      OnItemsChanged(0, ResourceCount()));
+  }
+}
+
 void TaskManagerModel::RefreshVideoMemoryUsageStats() {
   if (pending_video_memory_usage_stats_update_)
     return;
@@ -1461,21 +1459,34 @@ base::string16 TaskManagerModel::GetMemCellText(int64 number) const {
 #endif
 }
 
-bool TaskManagerModel::CachePrivateAndSharedMemory(
-    base::ProcessHandle handle) const {
+void TaskManagerModel::CacheProcessMemory(base::ProcessHandle handle) const {
+  process_memory_requested_ = true;
+
   PerProcessValues& values(per_process_cache_[handle]);
-  if (values.is_private_and_shared_valid)
-    return true;
+  if (values.is_memory_sampled)
+    return;
 
-  MetricsMap::const_iterator iter = metrics_map_.find(handle);
-  if (iter == metrics_map_.end() ||
-      !iter->second->GetMemoryBytes(&values.private_bytes,
-                                    &values.shared_bytes)) {
-    return false;
-  }
+  // The last sample did not include memory, most likely because the memory
+  // columns were just shown. Read it here this once; the next samples will
+  // include it.
+  scoped_ptr<base::ProcessMetrics> metrics(
+      task_manager::CreateProcessMetrics(handle));
+  task_manager::ProcessSample sample;
+  task_manager::SampleProcessMemory(metrics.get(), &sample);
+  CopyMemorySample(sample, &values);
+}
 
-  values.is_private_and_shared_valid = true;
-  return true;
+// static
+void TaskManagerModel::CopyMemorySample(
+    const task_manager::ProcessSample& sample,
+    PerProcessValues* values) {
+  DCHECK(sample.is_memory_sampled);
+  values->is_memory_sampled = true;
+  values->is_private_and_shared_valid = sample.is_private_and_shared_valid;
+  values->private_bytes = sample.private_bytes;
+  values->shared_bytes = sample.shared_bytes;
+  values->is_physical_memory_valid = sample.is_physical_memory_valid;
+  values->physical_memory = sample.physical_memory;
 }
 
 bool TaskManagerModel::CacheWebCoreStats(int index) const {
@@ -17,6 +17,7 @@
 #include "base/strings/string16.h"
 #include "base/timer/timer.h"
 #include "chrome/browser/renderer_host/web_cache_manager.h"
+#include "chrome/browser/task_manager/process_sampler.h"
 #include "chrome/browser/task_manager/resource_provider.h"
 #include "chrome/browser/ui/host_desktop.h"
 #include "content/public/common/gpu_memory_stats.h"
@@ -26,10 +27,6 @@ class PrefRegistrySimple;
 class TaskManagerModel;
 class TaskManagerModelGpuDataManagerObserver;
 
-namespace base {
-class ProcessMetrics;
-}
-
 namespace content {
 class WebContents;
 }
@@ -87,6 +84,7 @@ class TaskManager {
   FRIEND_TEST_ALL_PREFIXES(TaskManagerTest, Basic);
   FRIEND_TEST_ALL_PREFIXES(TaskManagerTest, Resources);
   FRIEND_TEST_ALL_PREFIXES(TaskManagerTest, RefreshCalled);
+  FRIEND_TEST_ALL_PREFIXES(TaskManagerTest, SamplesMemoryWhenRequested);
   FRIEND_TEST_ALL_PREFIXES(TaskManagerWindowControllerTest, Init);
   FRIEND_TEST_ALL_PREFIXES(TaskManagerWindowControllerTest, Sort);
   FRIEND_TEST_ALL_PREFIXES(TaskManagerWindowControllerTest,
@@ -328,6 +326,7 @@ class TaskManagerModel : public base::RefCountedThreadSafe<TaskManagerModel> {
   friend class TaskManagerBrowserTest;
   FRIEND_TEST_ALL_PREFIXES(ExtensionApiTest, ProcessesVsTaskManager);
   FRIEND_TEST_ALL_PREFIXES(TaskManagerTest, RefreshCalled);
+  FRIEND_TEST_ALL_PREFIXES(TaskManagerTest, SamplesMemoryWhenRequested);
   FRIEND_TEST_ALL_PREFIXES(TaskManagerWindowControllerTest,
                            SelectionAdaptsToSorting);
 
@@ -395,6 +394,9 @@ class TaskManagerModel : public base::RefCountedThreadSafe<TaskManagerModel> {
     bool is_idle_wakeups_valid;
     int idle_wakeups;
 
+    // Whether the memory values below have been read, successfully or not.
+    bool is_memory_sampled;
+
     bool is_private_and_shared_valid;
     size_t private_bytes;
     size_t shared_bytes;
@@ -419,7 +421,6 @@ class TaskManagerModel : public base::RefCountedThreadSafe<TaskManagerModel> {
   typedef std::vector<scoped_refptr<task_manager::ResourceProvider> >
       ResourceProviderList;
   typedef std::map<base::ProcessHandle, ResourceList*> GroupMap;
-  typedef std::map<base::ProcessHandle, base::ProcessMetrics*> MetricsMap;
   typedef std::map<task_manager::Resource*, int64> ResourceValueMap;
   typedef std::map<task_manager::Resource*,
                    PerResourceValues> PerResourceCache;
@@ -454,6 +455,13 @@ class TaskManagerModel : public base::RefCountedThreadSafe<TaskManagerModel> {
 
   void RefreshVideoMemoryUsageStats();
 
+  // Asks |process_sampler_| for the CPU usage of every process, and for their
+  // memory if it was looked at since the last sample.
+  void SampleProcesses();
+
+  // Called on the UI thread with the results of SampleProcesses().
+  void OnProcessesSampled(const task_manager::ProcessSamples& samples);
+
   // Returns the network usage (in bytes per seconds) for the specified
   // resource. That's the value retrieved at the last timer's tick.
   int64 GetNetworkUsageForResource(task_manager::Resource* resource) const;
@@ -486,10 +494,15 @@ class TaskManagerModel : public base::RefCountedThreadSafe<TaskManagerModel> {
   // displayed in the task manager's memory cell.
   base::string16 GetMemCellText(int64 number) const;
 
-  // Verifies the private and shared memory for |handle| is valid in
-  // |per_process_cache_|. Returns true if the data in |per_process_cache_| is
-  // valid.
-  bool CachePrivateAndSharedMemory(base::ProcessHandle handle) const;
+  // Makes sure the memory values for |handle| have been read into
+  // |per_process_cache_|, and that the next sample includes memory. The
+  // values normally come from the last sample; they are read on the calling
+  // thread only right after the memory columns are shown.
+  void CacheProcessMemory(base::ProcessHandle handle) const;
+
+  // Copies the memory values of |sample| into |values|.
+  static void CopyMemorySample(const task_manager::ProcessSample& sample,
+                               PerProcessValues* values);
 
   // Verifies |webcore_stats| in |per_resource_cache_|, returning true on
   // success.
@@ -520,9 +533,15 @@ class TaskManagerModel : public base::RefCountedThreadSafe<TaskManagerModel> {
   // the model (but the actual Resources are owned by the ResourceProviders).
   GroupMap group_map_;
 
-  // A map to retrieve the process metrics for a process. The ProcessMetrics are
-  // owned by the model.
-  MetricsMap metrics_map_;
+  // Samples the processes in |group_map_| on the blocking pool.
+  scoped_refptr<task_manager::ProcessSampler> process_sampler_;
+
+  // Set to true when we've requested a sample and false once we get it.
+  bool pending_process_sample_;
+
+  // Whether some memory value was asked for since the last sample. Memory is
+  // only sampled when it is displayed, as it is the expensive part.
+  mutable bool process_memory_requested_;
 
   // A map that keeps track of the number of bytes read per process since last
   // tick. The Resources are owned by the ResourceProviders.
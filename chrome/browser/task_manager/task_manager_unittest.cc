@@ -8,7 +8,9 @@
 
 #include "base/message_loop/message_loop.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/threading/sequenced_worker_pool.h"
 #include "chrome/browser/task_manager/resource_provider.h"
+#include "content/public/browser/browser_thread.h"
 #include "grit/chromium_strings.h"
 #include "grit/generated_resources.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -63,6 +65,12 @@ class TestResource : public task_manager::Resource {
 }  // namespace
 
 class TaskManagerTest : public testing::Test {
+ protected:
+  // Waits for the process sample posted by TaskManagerModel::Refresh().
+  void WaitForProcessSample() {
+    content::BrowserThread::GetBlockingPool()->FlushForTesting();
+    base::MessageLoop::current()->RunUntilIdle();
+  }
 };
 
 TEST_F(TaskManagerTest, Basic) {
@@ -122,5 +130,37 @@ TEST_F(TaskManagerTest, RefreshCalled) {
   model->update_state_ = TaskManagerModel::TASK_PENDING;
   model->Refresh();
   ASSERT_TRUE(resource.refresh_called());
+  WaitForProcessSample();
+  task_manager.RemoveResource(&resource);
+}
+
+// Tests that the process memory is only sampled once it has been asked for.
+TEST_F(TaskManagerTest, SamplesMemoryWhenRequested) {
+  base::MessageLoop loop;
+  TaskManager task_manager;
+  TaskManagerModel* model = task_manager.model_.get();
+  TestResource resource;
+  base::ProcessHandle process = resource.GetProcess();
+
+  task_manager.AddResource(&resource);
+  model->update_state_ = TaskManagerModel::TASK_PENDING;
+  model->Refresh();
+  WaitForProcessSample();
+  EXPECT_TRUE(model->per_process_cache_[process].is_cpu_usage_valid);
+  EXPECT_FALSE(model->per_process_cache_[process].is_memory_sampled);
+
+  // The first request reads the memory synchronously.
+  size_t private_memory = 0;
+  model->GetPrivateMemory(0, &private_memory);
+  EXPECT_TRUE(model->per_process_cache_[process].is_memory_sampled);
+  EXPECT_TRUE(model->process_memory_requested_);
+
+  // The next sample includes it.
+  model->Refresh();
+  EXPECT_FALSE(model->process_memory_requested_);
+  WaitForProcessSample();
+  EXPECT_TRUE(model->per_process_cache_[process].is_cpu_usage_valid);
+  EXPECT_TRUE(model->per_process_cache_[process].is_memory_sampled);
+
   task_manager.RemoveResource(&resource);
 }
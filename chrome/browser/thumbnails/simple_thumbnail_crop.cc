@@ -5,6 +5,7 @@
 #include "chrome/browser/thumbnails/simple_thumbnail_crop.h"
 
 #include "base/metrics/histogram.h"
+#include "base/threading/sequenced_worker_pool.h"
 #include "content/public/browser/browser_thread.h"
 #include "skia/ext/platform_canvas.h"
 #include "ui/gfx/color_utils.h"
@@ -16,10 +17,20 @@
 
 namespace {
 static const char kThumbnailHistogramName[] = "Thumbnail.ComputeMS";
+
+void CallbackInvocationAdapter(
+    const thumbnails::ThumbnailingAlgorithm::ConsumerCallback& callback,
+    scoped_refptr<thumbnails::ThumbnailingContext> context,
+    const SkBitmap& thumbnail) {
+  callback.Run(*context.get(), thumbnail);
+}
+
 }
 
 namespace thumbnails {
 
+using content::BrowserThread;
+
 SimpleThumbnailCrop::SimpleThumbnailCrop(const gfx::Size& target_size)
     : target_size_(target_size) {
   DCHECK(!target_size.IsEmpty());
@@ -41,14 +52,41 @@ void SimpleThumbnailCrop::ProcessBitmap(
     scoped_refptr<ThumbnailingContext> context,
     const ConsumerCallback& callback,
     const SkBitmap& bitmap) {
-  DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
   if (bitmap.isNull() || bitmap.empty())
     return;
 
-  SkBitmap thumbnail = CreateThumbnail(
-      bitmap,
-      ComputeTargetSizeAtMaximumScale(target_size_),
-      &context->clip_result);
+  SkBitmap source_bitmap = bitmap;
+#if !defined(USE_AURA)
+  // The bitmap may be one of the magic ones in PlatformCanvas, which are only
+  // valid for the duration of this call (see CreateThumbnail()).
+  bitmap.copyTo(&source_bitmap, kPMColor_SkColorType);
+#endif
+
+  // Crop and downsample on the blocking pool, so that the thumbnails of
+  // several tabs can be processed in parallel without holding up the UI
+  // thread.
+  if (!BrowserThread::GetBlockingPool()->PostWorkerTaskWithShutdownBehavior(
+          FROM_HERE,
+          base::Bind(&ProcessBitmapOnWorker,
+                     source_bitmap,
+                     ComputeTargetSizeAtMaximumScale(target_size_),
+                     context,
+                     callback),
+          base::SequencedWorkerPool::SKIP_ON_SHUTDOWN)) {
+    LOG(WARNING) << "PostWorkerTask failed. The thumbnail for "
+                 << context->url << " will not be created.";
+  }
+}
+
+// static
+void SimpleThumbnailCrop::ProcessBitmapOnWorker(
+    const SkBitmap& bitmap,
+    const gfx::Size& thumbnail_size,
+    scoped_refptr<ThumbnailingContext> context,
+    const ConsumerCallback& callback) {
+  SkBitmap thumbnail =
+      CreateThumbnail(bitmap, thumbnail_size, &context->clip_result);
 
   context->score.boring_score = CalculateBoringScore(thumbnail);
   context->score.good_clipping =
@@ -56,7 +94,10 @@ void SimpleThumbnailCrop::ProcessBitmap(
        context->clip_result == CLIP_RESULT_TALLER_THAN_WIDE ||
        context->clip_result == CLIP_RESULT_NOT_CLIPPED);
 
-  callback.Run(*context.get(), thumbnail);
+  BrowserThread::PostTask(
+      BrowserThread::UI,
+      FROM_HERE,
+      base::Bind(&CallbackInvocationAdapter, callback, context, thumbnail));
 }
 
 double SimpleThumbnailCrop::CalculateBoringScore(const SkBitmap& bitmap) {
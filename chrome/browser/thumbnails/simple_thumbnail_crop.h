@@ -60,6 +60,13 @@ class SimpleThumbnailCrop : public ThumbnailingAlgorithm {
   virtual ~SimpleThumbnailCrop();
 
  private:
+  // Creates the thumbnail and scores it, then hands it to |callback| on the
+  // UI thread. Runs on the blocking pool.
+  static void ProcessBitmapOnWorker(const SkBitmap& bitmap,
+                                    const gfx::Size& thumbnail_size,
+                                    scoped_refptr<ThumbnailingContext> context,
+                                    const ConsumerCallback& callback);
+
   static SkBitmap CreateThumbnail(const SkBitmap& bitmap,
                                   const gfx::Size& desired_size,
                                   ClipResult* clip_result);
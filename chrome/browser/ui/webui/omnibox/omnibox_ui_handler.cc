@@ -63,6 +63,8 @@ void OmniboxUIHandler::RegisterMessages() {
 //   'results_by_provider': {
 //     'HistoryURL' : {
 //       'num_items': 3,
+//       'start_time_ms': 2,
+//       'done_time_ms': 41,
 //         ...
 //       }
 //     'Search' : {
@@ -95,11 +97,26 @@ void OmniboxUIHandler::OnResultChanged(bool default_match_changed) {
   AddResultToDictionary("combined_results", controller_->result().begin(),
                         controller_->result().end(), &result_to_output);
   // Fill results from each individual provider as well.
+  // Each provider's entry also tells how long its Start() took and, once it
+  // is done, how long after the start of the query it finished.
+  const AutocompleteController::ProviderTimings& timings =
+      controller_->provider_timings();
   for (ACProviders::const_iterator it(controller_->providers()->begin());
        it != controller_->providers()->end(); ++it) {
-    AddResultToDictionary(
-        std::string("results_by_provider.") + (*it)->GetName(),
-        (*it)->matches().begin(), (*it)->matches().end(), &result_to_output);
+    const std::string prefix =
+        std::string("results_by_provider.") + (*it)->GetName();
+    AddResultToDictionary(prefix, (*it)->matches().begin(),
+                          (*it)->matches().end(), &result_to_output);
+    AutocompleteController::ProviderTimings::const_iterator timing =
+        timings.find(*it);
+    if (timing == timings.end())
+      continue;
+    result_to_output.SetInteger(prefix + ".start_time_ms",
+        timing->second.start_time.InMilliseconds());
+    if (timing->second.done) {
+      result_to_output.SetInteger(prefix + ".done_time_ms",
+          timing->second.done_time.InMilliseconds());
+    }
   }
   // Add done; send the results.
   web_ui()->CallJavascriptFunction("omniboxDebug.handleNewAutocompleteResult",
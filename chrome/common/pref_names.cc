@@ -476,6 +476,11 @@ const char kDnsHostReferralList[] = "HostReferralList";
 const char kDnsPrefetchingHostReferralList[] =
     "dns_prefetching.host_referral_list";
 
+// The unexpired entries of the host resolver's cache at shutdown, and the
+// connection type they were resolved on. Restored during the next startup if
+// the connection type has not changed.
+const char kDnsHostCache[] = "dns_prefetching.host_cache";
+
 // Disables the SPDY protocol.
 const char kDisableSpdy[] = "spdy.disabled";
 
@@ -172,6 +172,7 @@ extern const char kDnsStartupPrefetchList[];  // OBSOLETE
 extern const char kDnsPrefetchingStartupList[];
 extern const char kDnsHostReferralList[];  // OBSOLETE
 extern const char kDnsPrefetchingHostReferralList[];
+extern const char kDnsHostCache[];
 extern const char kDisableSpdy[];
 extern const char kHttpServerProperties[];
 extern const char kSpdyServers[];
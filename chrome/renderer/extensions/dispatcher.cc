@@ -7,6 +7,7 @@
 #include "base/callback.h"
 #include "base/command_line.h"
 #include "base/debug/alias.h"
+#include "base/debug/trace_event.h"
 #include "base/json/json_reader.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/metrics/user_metrics_action.h"
@@ -450,6 +451,20 @@ void CallModuleMethod(const std::string& module_name,
       module_name, method_name, &arguments);
 }
 
+// Factories for native handlers that are registered lazily, so that they are
+// only created in the contexts that require them.
+template <class T>
+scoped_ptr<NativeHandler> CreateNativeHandler(ChromeV8Context* context) {
+  return scoped_ptr<NativeHandler>(new T(context));
+}
+
+template <class T>
+scoped_ptr<NativeHandler> CreateDispatcherNativeHandler(
+    Dispatcher* dispatcher,
+    ChromeV8Context* context) {
+  return scoped_ptr<NativeHandler>(new T(dispatcher, context));
+}
+
 }  // namespace
 
 Dispatcher::Dispatcher()
@@ -907,64 +922,69 @@ void Dispatcher::RegisterNativeHandlers(ModuleSystem* module_system,
       scoped_ptr<NativeHandler>(new RenderViewObserverNatives(this, context)));
 
   // Natives used by multiple APIs.
-  module_system->RegisterNativeHandler("file_system_natives",
-      scoped_ptr<NativeHandler>(new FileSystemNatives(context)));
-
-  // Custom bindings.
-  module_system->RegisterNativeHandler("app",
-      scoped_ptr<NativeHandler>(new AppBindings(this, context)));
-  module_system->RegisterNativeHandler("app_runtime",
-      scoped_ptr<NativeHandler>(
-          new AppRuntimeCustomBindings(this, context)));
-  module_system->RegisterNativeHandler("app_window_natives",
-      scoped_ptr<NativeHandler>(
-          new AppWindowCustomBindings(this, context)));
-  module_system->RegisterNativeHandler("blob_natives",
-      scoped_ptr<NativeHandler>(new BlobNativeHandler(context)));
-  module_system->RegisterNativeHandler("context_menus",
-      scoped_ptr<NativeHandler>(
-          new ContextMenusCustomBindings(this, context)));
-  module_system->RegisterNativeHandler(
-      "css_natives", scoped_ptr<NativeHandler>(new CssNativeHandler(context)));
-  module_system->RegisterNativeHandler("document_natives",
-      scoped_ptr<NativeHandler>(
-          new DocumentCustomBindings(this, context)));
-  module_system->RegisterNativeHandler("sync_file_system",
-      scoped_ptr<NativeHandler>(
-          new SyncFileSystemCustomBindings(this, context)));
-  module_system->RegisterNativeHandler("file_browser_handler",
-      scoped_ptr<NativeHandler>(new FileBrowserHandlerCustomBindings(
-          this, context)));
-  module_system->RegisterNativeHandler("file_browser_private",
-      scoped_ptr<NativeHandler>(new FileBrowserPrivateCustomBindings(
-          this, context)));
-  module_system->RegisterNativeHandler("i18n",
-      scoped_ptr<NativeHandler>(
-          new I18NCustomBindings(this, context)));
-  module_system->RegisterNativeHandler(
-      "id_generator",
-      scoped_ptr<NativeHandler>(new IdGeneratorCustomBindings(this, context)));
-  module_system->RegisterNativeHandler("mediaGalleries",
-      scoped_ptr<NativeHandler>(
-          new MediaGalleriesCustomBindings(this, context)));
-  module_system->RegisterNativeHandler("page_actions",
-      scoped_ptr<NativeHandler>(
-          new PageActionsCustomBindings(this, context)));
-  module_system->RegisterNativeHandler("page_capture",
-      scoped_ptr<NativeHandler>(
-          new PageCaptureCustomBindings(this, context)));
-  module_system->RegisterNativeHandler(
-      "pepper_request_natives",
-      scoped_ptr<NativeHandler>(new PepperRequestNatives(context)));
-  module_system->RegisterNativeHandler("runtime",
-      scoped_ptr<NativeHandler>(new RuntimeCustomBindings(this, context)));
-  module_system->RegisterNativeHandler("tabs",
-      scoped_ptr<NativeHandler>(new TabsCustomBindings(this, context)));
-  module_system->RegisterNativeHandler("webstore",
-      scoped_ptr<NativeHandler>(new WebstoreBindings(this, context)));
+  module_system->RegisterLazyNativeHandler("file_system_natives",
+      base::Bind(&CreateNativeHandler<FileSystemNatives>, context));
+
+  // Custom bindings. These are only used by the APIs they implement, so
+  // they are created on first use.
+  module_system->RegisterLazyNativeHandler("app",
+      base::Bind(&CreateDispatcherNativeHandler<AppBindings>, this, context));
+  module_system->RegisterLazyNativeHandler("app_runtime",
+      base::Bind(&CreateDispatcherNativeHandler<AppRuntimeCustomBindings>,
+                 this, context));
+  module_system->RegisterLazyNativeHandler("app_window_natives",
+      base::Bind(&CreateDispatcherNativeHandler<AppWindowCustomBindings>,
+                 this, context));
+  module_system->RegisterLazyNativeHandler("blob_natives",
+      base::Bind(&CreateNativeHandler<BlobNativeHandler>, context));
+  module_system->RegisterLazyNativeHandler("context_menus",
+      base::Bind(&CreateDispatcherNativeHandler<ContextMenusCustomBindings>,
+                 this, context));
+  module_system->RegisterLazyNativeHandler("css_natives",
+      base::Bind(&CreateNativeHandler<CssNativeHandler>, context));
+  module_system->RegisterLazyNativeHandler("document_natives",
+      base::Bind(&CreateDispatcherNativeHandler<DocumentCustomBindings>,
+                 this, context));
+  module_system->RegisterLazyNativeHandler("sync_file_system",
+      base::Bind(&CreateDispatcherNativeHandler<SyncFileSystemCustomBindings>,
+                 this, context));
+  module_system->RegisterLazyNativeHandler("file_browser_handler",
+      base::Bind(
+          &CreateDispatcherNativeHandler<FileBrowserHandlerCustomBindings>,
+          this, context));
+  module_system->RegisterLazyNativeHandler("file_browser_private",
+      base::Bind(
+          &CreateDispatcherNativeHandler<FileBrowserPrivateCustomBindings>,
+          this, context));
+  module_system->RegisterLazyNativeHandler("i18n",
+      base::Bind(&CreateDispatcherNativeHandler<I18NCustomBindings>,
+                 this, context));
+  module_system->RegisterLazyNativeHandler("id_generator",
+      base::Bind(&CreateDispatcherNativeHandler<IdGeneratorCustomBindings>,
+                 this, context));
+  module_system->RegisterLazyNativeHandler("mediaGalleries",
+      base::Bind(&CreateDispatcherNativeHandler<MediaGalleriesCustomBindings>,
+                 this, context));
+  module_system->RegisterLazyNativeHandler("page_actions",
+      base::Bind(&CreateDispatcherNativeHandler<PageActionsCustomBindings>,
+                 this, context));
+  module_system->RegisterLazyNativeHandler("page_capture",
+      base::Bind(&CreateDispatcherNativeHandler<PageCaptureCustomBindings>,
+                 this, context));
+  module_system->RegisterLazyNativeHandler("pepper_request_natives",
+      base::Bind(&CreateNativeHandler<PepperRequestNatives>, context));
+  module_system->RegisterLazyNativeHandler("runtime",
+      base::Bind(&CreateDispatcherNativeHandler<RuntimeCustomBindings>,
+                 this, context));
+  module_system->RegisterLazyNativeHandler("tabs",
+      base::Bind(&CreateDispatcherNativeHandler<TabsCustomBindings>,
+                 this, context));
+  module_system->RegisterLazyNativeHandler("webstore",
+      base::Bind(&CreateDispatcherNativeHandler<WebstoreBindings>,
+                 this, context));
 #if defined(ENABLE_WEBRTC)
-  module_system->RegisterNativeHandler("cast_streaming_natives",
-      scoped_ptr<NativeHandler>(new CastStreamingNativeHandler(context)));
+  module_system->RegisterLazyNativeHandler("cast_streaming_natives",
+      base::Bind(&CreateNativeHandler<CastStreamingNativeHandler>, context));
 #endif
 }
 
@@ -1114,6 +1134,8 @@ void Dispatcher::DidCreateScriptContext(
   return;
 #endif
 
+  TRACE_EVENT0("v8", "Dispatcher::DidCreateScriptContext");
+
   std::string extension_id = GetExtensionID(frame, world_id);
 
   const Extension* extension = extensions_.GetByID(extension_id);
@@ -338,6 +338,13 @@ void ModuleSystem::RegisterNativeHandler(const std::string& name,
     scoped_ptr<NativeHandler> native_handler) {
   native_handler_map_[name] =
       linked_ptr<NativeHandler>(native_handler.release());
+  native_handler_factory_map_.erase(name);
+}
+
+void ModuleSystem::RegisterLazyNativeHandler(
+    const std::string& name,
+    const NativeHandlerFactory& factory) {
+  native_handler_factory_map_[name] = factory;
 }
 
 void ModuleSystem::OverrideNativeHandlerForTest(const std::string& name) {
@@ -544,9 +551,18 @@ v8::Handle<v8::Value> ModuleSystem::RequireNativeFromString(
 
   NativeHandlerMap::iterator i = native_handler_map_.find(native_name);
   if (i == native_handler_map_.end()) {
-    Fatal(context_,
-          "Couldn't find native for requireNative(" + native_name + ")");
-    return v8::Undefined(GetIsolate());
+    NativeHandlerFactoryMap::iterator factory =
+        native_handler_factory_map_.find(native_name);
+    if (factory == native_handler_factory_map_.end()) {
+      Fatal(context_,
+            "Couldn't find native for requireNative(" + native_name + ")");
+      return v8::Undefined(GetIsolate());
+    }
+    scoped_ptr<NativeHandler> native_handler = factory->second.Run();
+    native_handler_factory_map_.erase(factory);
+    i = native_handler_map_.insert(std::make_pair(
+        native_name,
+        linked_ptr<NativeHandler>(native_handler.release()))).first;
   }
   return i->second->NewInstance();
 }
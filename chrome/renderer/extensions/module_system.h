@@ -5,6 +5,7 @@
 #ifndef CHROME_RENDERER_EXTENSIONS_MODULE_SYSTEM_H_
 #define CHROME_RENDERER_EXTENSIONS_MODULE_SYSTEM_H_
 
+#include "base/callback.h"
 #include "base/compiler_specific.h"
 #include "base/memory/linked_ptr.h"
 #include "base/memory/scoped_ptr.h"
@@ -57,6 +58,9 @@ class ModuleSystem : public ObjectBackedNativeHandler {
     std::string CreateExceptionString(const v8::TryCatch& try_catch);
   };
 
+  // Creates a native handler on demand.
+  typedef base::Callback<scoped_ptr<NativeHandler>()> NativeHandlerFactory;
+
   // Enables native bindings for the duration of its lifetime.
   class NativesEnabledScope {
    public:
@@ -102,6 +106,12 @@ class ModuleSystem : public ObjectBackedNativeHandler {
   void RegisterNativeHandler(const std::string& name,
                              scoped_ptr<NativeHandler> native_handler);
 
+  // Like RegisterNativeHandler(), but the handler is only created by
+  // |factory| on the first requireNative(|name|), so that contexts which
+  // never use it don't pay for setting it up.
+  void RegisterLazyNativeHandler(const std::string& name,
+                                 const NativeHandlerFactory& factory);
+
   // Causes requireNative(|name|) to look for its module in |source_map_|
   // instead of using a registered native handler. This can be used in unit
   // tests to mock out native modules.
@@ -146,6 +156,7 @@ class ModuleSystem : public ObjectBackedNativeHandler {
 
  private:
   typedef std::map<std::string, linked_ptr<NativeHandler> > NativeHandlerMap;
+  typedef std::map<std::string, NativeHandlerFactory> NativeHandlerFactoryMap;
 
   // Retrieves the lazily defined field specified by |property|.
   static void LazyFieldGetter(v8::Local<v8::String> property,
@@ -203,6 +214,10 @@ class ModuleSystem : public ObjectBackedNativeHandler {
   // A map from native handler names to native handlers.
   NativeHandlerMap native_handler_map_;
 
+  // Factories of the native handlers that haven't been required yet. They
+  // move to |native_handler_map_| once created.
+  NativeHandlerFactoryMap native_handler_factory_map_;
+
   // When 0, natives are disabled, otherwise indicates how many callers have
   // pinned natives as enabled.
   int natives_enabled_;
@@ -202,6 +202,34 @@ TEST_F(ModuleSystemTest, TestLazyFieldIsOnlyEvaledOnce) {
   context_->module_system()->Require("test");
 }
 
+namespace {
+
+scoped_ptr<NativeHandler> CreateCounterNatives(
+    extensions::ChromeV8Context* context,
+    int* created_count) {
+  ++*created_count;
+  return scoped_ptr<NativeHandler>(new CounterNatives(context));
+}
+
+}  // namespace
+
+TEST_F(ModuleSystemTest, TestLazyNativeHandlerIsCreatedOnFirstUse) {
+  ModuleSystem::NativesEnabledScope natives_enabled_scope(
+      context_->module_system());
+  int created_count = 0;
+  context_->module_system()->RegisterLazyNativeHandler(
+      "counter",
+      base::Bind(&CreateCounterNatives, context_.get(), &created_count));
+  RegisterModule("test",
+      "var assert = requireNative('assert');"
+      "var counter = requireNative('counter');"
+      "counter.Increment();"
+      "assert.AssertTrue(requireNative('counter').Get() == 1);");
+  EXPECT_EQ(0, created_count);
+  context_->module_system()->Require("test");
+  EXPECT_EQ(1, created_count);
+}
+
 TEST_F(ModuleSystemTest, TestRequireNativesAfterLazyEvaluation) {
   ModuleSystem::NativesEnabledScope natives_enabled_scope(
       context_->module_system());
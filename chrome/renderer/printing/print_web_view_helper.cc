@@ -1755,6 +1755,7 @@ bool PrintWebViewHelper::PreviewPageRendered(int page_number,
       print_pages_params_->params.preview_request_id;
 
   Send(new PrintHostMsg_DidPreviewPage(routing_id(), preview_page_params));
+  print_preview_context_.SentPreviewPage();
   return true;
 }
 
@@ -1763,6 +1764,7 @@ PrintWebViewHelper::PrintPreviewContext::PrintPreviewContext()
       current_page_index_(0),
       generate_draft_pages_(true),
       print_ready_metafile_page_count_(0),
+      sent_first_page_(false),
       error_(PREVIEW_ERROR_NONE),
       state_(UNINITIALIZED) {
 }
@@ -1850,6 +1852,7 @@ bool PrintWebViewHelper::PrintPreviewContext::CreatePreviewDocument(
 
   document_render_time_ = base::TimeDelta();
   begin_time_ = base::TimeTicks::Now();
+  sent_first_page_ = false;
 
   return true;
 }
@@ -1861,6 +1864,15 @@ void PrintWebViewHelper::PrintPreviewContext::RenderedPreviewPage(
   UMA_HISTOGRAM_TIMES("PrintPreview.RenderPDFPageTime", page_time);
 }
 
+void PrintWebViewHelper::PrintPreviewContext::SentPreviewPage() {
+  DCHECK(IsRendering());
+  if (sent_first_page_)
+    return;
+  sent_first_page_ = true;
+  UMA_HISTOGRAM_MEDIUM_TIMES("PrintPreview.TimeToFirstPage",
+                             base::TimeTicks::Now() - begin_time_);
+}
+
 void PrintWebViewHelper::PrintPreviewContext::AllPagesRendered() {
   DCHECK_EQ(RENDERING, state_);
   state_ = DONE;
@@ -358,6 +358,10 @@ class PrintWebViewHelper
     // rendering took.
     void RenderedPreviewPage(const base::TimeDelta& page_time);
 
+    // Called after a draft page has been sent to the browser, which can show
+    // it right away.
+    void SentPreviewPage();
+
     // Updates the print preview context when the required pages are rendered.
     void AllPagesRendered();
 
@@ -437,6 +441,9 @@ class PrintWebViewHelper
     base::TimeDelta document_render_time_;
     base::TimeTicks begin_time_;
 
+    // True once the first draft page has been sent to the browser.
+    bool sent_first_page_;
+
     enum PrintPreviewErrorBuckets error_;
 
     State state_;
@@ -11,6 +11,7 @@
 #include "base/strings/string16.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/threading/worker_pool.h"
 #include "chrome/common/render_messages.h"
 #include "chrome/renderer/extensions/extension_groups.h"
 #include "chrome/renderer/isolated_world_ids.h"
@@ -71,7 +72,8 @@ TranslateHelper::TranslateHelper(content::RenderView* render_view)
     : content::RenderViewObserver(render_view),
       page_id_(-1),
       translation_pending_(false),
-      weak_method_factory_(this) {
+      weak_method_factory_(this),
+      detection_weak_factory_(this) {
 }
 
 TranslateHelper::~TranslateHelper() {
@@ -92,43 +94,62 @@ void TranslateHelper::PageCaptured(int page_id,
   WebFrame* main_frame = GetMainFrame();
   if (!main_frame || render_view()->GetPageId() != page_id)
     return;
+  base::TimeTicks begin = base::TimeTicks::Now();
   page_id_ = page_id;
   WebDocument document = main_frame->document();
-  std::string content_language = document.contentLanguage().utf8();
+  LanguageDetectionDetails* details = new LanguageDetectionDetails;
+  details->url = GURL(document.url());
+  details->content_language = document.contentLanguage().utf8();
   WebElement html_element = document.documentElement();
-  std::string html_lang;
   // |html_element| can be null element, e.g. in
   // BrowserTest.WindowOpenClose.
   if (!html_element.isNull())
-    html_lang = html_element.getAttribute("lang").utf8();
-  std::string cld_language;
-  bool is_cld_reliable;
-  std::string language = translate::DeterminePageLanguage(
-      content_language, html_lang, contents, &cld_language, &is_cld_reliable);
+    details->html_root_language = html_element.getAttribute("lang").utf8();
 
-  if (language.empty())
-    return;
+  // TODO(hajimehoshi): If this affects performance, it should be set only if
+  // translate-internals tab exists.
+  details->contents = contents;
 
-  language_determined_time_ = base::TimeTicks::Now();
+  // CLD does not touch the document, so it runs on a worker thread rather
+  // than janking the page. Only the bookkeeping above stays here.
+  base::WorkerPool::PostTaskAndReply(
+      FROM_HERE,
+      base::Bind(&TranslateHelper::DeterminePageLanguageOnWorker, details),
+      base::Bind(&TranslateHelper::OnPageLanguageDetermined,
+                 detection_weak_factory_.GetWeakPtr(),
+                 page_id,
+                 IsTranslationAllowed(&document),
+                 base::TimeTicks::Now() - begin,
+                 base::Owned(details)),
+      false);
+}
 
-  GURL url(document.url());
-  LanguageDetectionDetails details;
-  details.time = base::Time::Now();
-  details.url = url;
-  details.content_language = content_language;
-  details.cld_language = cld_language;
-  details.is_cld_reliable = is_cld_reliable;
-  details.html_root_language = html_lang;
-  details.adopted_language = language;
+// static
+void TranslateHelper::DeterminePageLanguageOnWorker(
+    LanguageDetectionDetails* details) {
+  details->adopted_language = translate::DeterminePageLanguage(
+      details->content_language, details->html_root_language,
+      details->contents, &details->cld_language, &details->is_cld_reliable);
+}
 
-  // TODO(hajimehoshi): If this affects performance, it should be set only if
-  // translate-internals tab exists.
-  details.contents = contents;
+void TranslateHelper::OnPageLanguageDetermined(
+    int page_id,
+    bool is_translation_allowed,
+    base::TimeDelta main_thread_time,
+    LanguageDetectionDetails* details) {
+  // The page may have navigated away while CLD was running.
+  if (page_id_ != page_id || render_view()->GetPageId() != page_id)
+    return;
+  if (details->adopted_language.empty())
+    return;
 
+  base::TimeTicks begin = base::TimeTicks::Now();
+  language_determined_time_ = begin;
+  details->time = base::Time::Now();
   Send(new ChromeViewHostMsg_TranslateLanguageDetermined(
-      routing_id(),
-      details,
-      IsTranslationAllowed(&document) && !language.empty()));
+      routing_id(), *details, is_translation_allowed));
+  translate::ReportLanguageDetectionMainThreadTime(
+      main_thread_time + (base::TimeTicks::Now() - begin));
 }
 
 void TranslateHelper::CancelPendingTranslation() {
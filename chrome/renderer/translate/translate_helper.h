@@ -18,6 +18,8 @@ class WebDocument;
 class WebFrame;
 }
 
+struct LanguageDetectionDetails;
+
 // This class deals with page translation.
 // There is one TranslateHelper per RenderView.
 
@@ -26,7 +28,8 @@ class TranslateHelper : public content::RenderViewObserver {
   explicit TranslateHelper(content::RenderView* render_view);
   virtual ~TranslateHelper();
 
-  // Informs us that the page's text has been extracted.
+  // Informs us that the page's text has been extracted. Its language is
+  // determined on a worker thread and sent to the browser once known.
   void PageCaptured(int page_id, const base::string16& contents);
 
  protected:
@@ -128,6 +131,17 @@ class TranslateHelper : public content::RenderViewObserver {
   // with |error|.
   void NotifyBrowserTranslationFailed(TranslateErrors::Type error);
 
+  // Runs CLD over |details->contents| and fills in the CLD and adopted
+  // languages of |details|. Runs on a worker thread.
+  static void DeterminePageLanguageOnWorker(LanguageDetectionDetails* details);
+
+  // Called on the main thread once DeterminePageLanguageOnWorker() is done
+  // with |details|. |main_thread_time| is the time PageCaptured() took.
+  void OnPageLanguageDetermined(int page_id,
+                                bool is_translation_allowed,
+                                base::TimeDelta main_thread_time,
+                                LanguageDetectionDetails* details);
+
   // Convenience method to access the main frame.  Can return NULL, typically
   // if the page is being closed.
   blink::WebFrame* GetMainFrame();
@@ -148,6 +162,10 @@ class TranslateHelper : public content::RenderViewObserver {
   // Method factory used to make calls to TranslatePageImpl.
   base::WeakPtrFactory<TranslateHelper> weak_method_factory_;
 
+  // Factory for the replies of language detection. Unlike
+  // |weak_method_factory_|, not invalidated by CancelPendingTranslation().
+  base::WeakPtrFactory<TranslateHelper> detection_weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(TranslateHelper);
 };
 
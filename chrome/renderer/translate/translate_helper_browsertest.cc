@@ -2,12 +2,15 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include "base/run_loop.h"
+#include "base/threading/platform_thread.h"
 #include "base/time/time.h"
 #include "chrome/common/render_messages.h"
 #include "chrome/renderer/translate/translate_helper.h"
 #include "chrome/test/base/chrome_render_view_test.h"
 #include "components/translate/core/common/translate_constants.h"
 #include "content/public/renderer/render_view.h"
+#include "ipc/ipc_test_sink.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "third_party/WebKit/public/web/WebHistoryItem.h"
@@ -16,6 +19,25 @@ using testing::AtLeast;
 using testing::Return;
 using testing::_;
 
+namespace {
+
+// TranslateHelper runs CLD on a worker thread, so the language is only
+// reported once the reply has come back. Returns the message reporting it, or
+// NULL if it does not come in time.
+const IPC::Message* WaitForLanguageDetermined(IPC::TestSink* sink) {
+  for (int i = 0; i < 500; ++i) {
+    base::RunLoop().RunUntilIdle();
+    const IPC::Message* message = sink->GetUniqueMessageMatching(
+        ChromeViewHostMsg_TranslateLanguageDetermined::ID);
+    if (message)
+      return message;
+    base::PlatformThread::Sleep(base::TimeDelta::FromMilliseconds(10));
+  }
+  return NULL;
+}
+
+}  // namespace
+
 class TestTranslateHelper : public TranslateHelper {
  public:
   explicit TestTranslateHelper(content::RenderView* render_view)
@@ -345,8 +367,8 @@ TEST_F(ChromeRenderViewTest, TranslatablePage) {
   SendContentStateImmediately();
 
   LoadHTML("<html><body>A random page with random content.</body></html>");
-  const IPC::Message* message = render_thread_->sink().GetUniqueMessageMatching(
-      ChromeViewHostMsg_TranslateLanguageDetermined::ID);
+  const IPC::Message* message =
+      WaitForLanguageDetermined(&render_thread_->sink());
   ASSERT_NE(static_cast<IPC::Message*>(NULL), message);
   ChromeViewHostMsg_TranslateLanguageDetermined::Param params;
   ChromeViewHostMsg_TranslateLanguageDetermined::Read(message, &params);
@@ -356,8 +378,7 @@ TEST_F(ChromeRenderViewTest, TranslatablePage) {
   // Now the page specifies the META tag to prevent translation.
   LoadHTML("<html><head><meta name=\"google\" value=\"notranslate\"></head>"
            "<body>A random page with random content.</body></html>");
-  message = render_thread_->sink().GetUniqueMessageMatching(
-      ChromeViewHostMsg_TranslateLanguageDetermined::ID);
+  message = WaitForLanguageDetermined(&render_thread_->sink());
   ASSERT_NE(static_cast<IPC::Message*>(NULL), message);
   ChromeViewHostMsg_TranslateLanguageDetermined::Read(message, &params);
   EXPECT_FALSE(params.b) << "Page should not be translatable.";
@@ -366,8 +387,7 @@ TEST_F(ChromeRenderViewTest, TranslatablePage) {
   // Try the alternate version of the META tag (content instead of value).
   LoadHTML("<html><head><meta name=\"google\" content=\"notranslate\"></head>"
            "<body>A random page with random content.</body></html>");
-  message = render_thread_->sink().GetUniqueMessageMatching(
-      ChromeViewHostMsg_TranslateLanguageDetermined::ID);
+  message = WaitForLanguageDetermined(&render_thread_->sink());
   ASSERT_NE(static_cast<IPC::Message*>(NULL), message);
   ChromeViewHostMsg_TranslateLanguageDetermined::Read(message, &params);
   EXPECT_FALSE(params.b) << "Page should not be translatable.";
@@ -382,8 +402,8 @@ TEST_F(ChromeRenderViewTest, LanguageMetaTag) {
 
   LoadHTML("<html><head><meta http-equiv=\"content-language\" content=\"es\">"
            "</head><body>A random page with random content.</body></html>");
-  const IPC::Message* message = render_thread_->sink().GetUniqueMessageMatching(
-      ChromeViewHostMsg_TranslateLanguageDetermined::ID);
+  const IPC::Message* message =
+      WaitForLanguageDetermined(&render_thread_->sink());
   ASSERT_NE(static_cast<IPC::Message*>(NULL), message);
   ChromeViewHostMsg_TranslateLanguageDetermined::Param params;
   ChromeViewHostMsg_TranslateLanguageDetermined::Read(message, &params);
@@ -394,8 +414,7 @@ TEST_F(ChromeRenderViewTest, LanguageMetaTag) {
   LoadHTML("<html><head><meta http-equiv=\"content-language\" "
            "content=\" fr , es,en \">"
            "</head><body>A random page with random content.</body></html>");
-  message = render_thread_->sink().GetUniqueMessageMatching(
-      ChromeViewHostMsg_TranslateLanguageDetermined::ID);
+  message = WaitForLanguageDetermined(&render_thread_->sink());
   ASSERT_NE(static_cast<IPC::Message*>(NULL), message);
   ChromeViewHostMsg_TranslateLanguageDetermined::Read(message, &params);
   EXPECT_EQ("fr", params.a.adopted_language);
@@ -410,8 +429,8 @@ TEST_F(ChromeRenderViewTest, LanguageMetaTagCase) {
 
   LoadHTML("<html><head><meta http-equiv=\"Content-Language\" content=\"es\">"
            "</head><body>A random page with random content.</body></html>");
-  const IPC::Message* message = render_thread_->sink().GetUniqueMessageMatching(
-      ChromeViewHostMsg_TranslateLanguageDetermined::ID);
+  const IPC::Message* message =
+      WaitForLanguageDetermined(&render_thread_->sink());
   ASSERT_NE(static_cast<IPC::Message*>(NULL), message);
   ChromeViewHostMsg_TranslateLanguageDetermined::Param params;
   ChromeViewHostMsg_TranslateLanguageDetermined::Read(message, &params);
@@ -422,8 +441,7 @@ TEST_F(ChromeRenderViewTest, LanguageMetaTagCase) {
   LoadHTML("<html><head><meta http-equiv=\"Content-Language\" "
            "content=\" fr , es,en \">"
            "</head><body>A random page with random content.</body></html>");
-  message = render_thread_->sink().GetUniqueMessageMatching(
-      ChromeViewHostMsg_TranslateLanguageDetermined::ID);
+  message = WaitForLanguageDetermined(&render_thread_->sink());
   ASSERT_NE(static_cast<IPC::Message*>(NULL), message);
   ChromeViewHostMsg_TranslateLanguageDetermined::Read(message, &params);
   EXPECT_EQ("fr", params.a.adopted_language);
@@ -439,8 +457,8 @@ TEST_F(ChromeRenderViewTest, LanguageCommonMistakesAreCorrected) {
 
   LoadHTML("<html><head><meta http-equiv='Content-Language' content='EN_us'>"
            "</head><body>A random page with random content.</body></html>");
-  const IPC::Message* message = render_thread_->sink().GetUniqueMessageMatching(
-      ChromeViewHostMsg_TranslateLanguageDetermined::ID);
+  const IPC::Message* message =
+      WaitForLanguageDetermined(&render_thread_->sink());
   ASSERT_NE(static_cast<IPC::Message*>(NULL), message);
   ChromeViewHostMsg_TranslateLanguageDetermined::Param params;
   ChromeViewHostMsg_TranslateLanguageDetermined::Read(message, &params);
@@ -453,8 +471,8 @@ TEST_F(ChromeRenderViewTest, BackToTranslatablePage) {
   SendContentStateImmediately();
   LoadHTML("<html><head><meta http-equiv=\"content-language\" content=\"zh\">"
            "</head><body>This page is in Chinese.</body></html>");
-  const IPC::Message* message = render_thread_->sink().GetUniqueMessageMatching(
-      ChromeViewHostMsg_TranslateLanguageDetermined::ID);
+  const IPC::Message* message =
+      WaitForLanguageDetermined(&render_thread_->sink());
   ASSERT_NE(static_cast<IPC::Message*>(NULL), message);
   ChromeViewHostMsg_TranslateLanguageDetermined::Param params;
   ChromeViewHostMsg_TranslateLanguageDetermined::Read(message, &params);
@@ -463,8 +481,7 @@ TEST_F(ChromeRenderViewTest, BackToTranslatablePage) {
 
   LoadHTML("<html><head><meta http-equiv=\"content-language\" content=\"fr\">"
            "</head><body>This page is in French.</body></html>");
-  message = render_thread_->sink().GetUniqueMessageMatching(
-      ChromeViewHostMsg_TranslateLanguageDetermined::ID);
+  message = WaitForLanguageDetermined(&render_thread_->sink());
   ASSERT_NE(static_cast<IPC::Message*>(NULL), message);
   ChromeViewHostMsg_TranslateLanguageDetermined::Read(message, &params);
   EXPECT_EQ("fr", params.a.adopted_language);
@@ -472,8 +489,7 @@ TEST_F(ChromeRenderViewTest, BackToTranslatablePage) {
 
   GoBack(GetMainFrame()->previousHistoryItem());
 
-  message = render_thread_->sink().GetUniqueMessageMatching(
-      ChromeViewHostMsg_TranslateLanguageDetermined::ID);
+  message = WaitForLanguageDetermined(&render_thread_->sink());
   ASSERT_NE(static_cast<IPC::Message*>(NULL), message);
   ChromeViewHostMsg_TranslateLanguageDetermined::Read(message, &params);
   EXPECT_EQ("zh", params.a.adopted_language);
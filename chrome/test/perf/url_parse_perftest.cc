@@ -147,3 +147,50 @@ TEST(URLParse, KURL) {
 }
 
 #endif
+
+namespace {
+
+// Paths and hosts made mostly of characters that are already canonical, as in
+// most URLs seen in practice.
+const char kTypicalPaths[][96] = {
+  "/chromium/src/third_party/webkit/source/core/html/parser/html_parser.cpp",
+  "/search/results/for/url-parsing/in-chromium/index",
+  "/foo/bar_baz-123/qux",
+};
+const char kTypicalHosts[][48] = {
+  "www.google.com",
+  "static-content.images.example-cdn.net",
+  "mail.example.org",
+};
+
+}  // namespace
+
+TEST(URLCanon, Path) {
+  base::PerfTimeLogger timer("Typical_Path_Canon_AMillion");
+  for (int i = 0; i < 333333; i++) {  // divide by 3 so we get 1M
+    for (size_t j = 0; j < arraysize(kTypicalPaths); j++) {
+      url_canon::RawCanonOutput<1024> output;
+      url_parse::Component out_path;
+      url_canon::CanonicalizePath(
+          kTypicalPaths[j],
+          url_parse::Component(0, static_cast<int>(strlen(kTypicalPaths[j]))),
+          &output, &out_path);
+    }
+  }
+  timer.Done();
+}
+
+TEST(URLCanon, Host) {
+  base::PerfTimeLogger timer("Typical_Host_Canon_AMillion");
+  for (int i = 0; i < 333333; i++) {  // divide by 3 so we get 1M
+    for (size_t j = 0; j < arraysize(kTypicalHosts); j++) {
+      url_canon::RawCanonOutput<1024> output;
+      url_parse::Component out_host;
+      url_canon::CanonicalizeHost(
+          kTypicalHosts[j],
+          url_parse::Component(0, static_cast<int>(strlen(kTypicalHosts[j]))),
+          &output, &out_host);
+    }
+  }
+  timer.Done();
+}
@@ -24,6 +24,11 @@
 namespace {
 // Maximum number of distilled pages in an article.
 const size_t kMaxPagesInArticle = 32;
+
+// Maximum number of pages under distillation at once. The next and previous
+// page links are only known once a page is distilled, so at most one page in
+// each direction can be waiting at any time.
+const size_t kMaxConcurrentPageDistillations = 2;
 }
 
 namespace dom_distiller {
@@ -50,11 +55,12 @@ DistillerImpl::DistilledPageData::~DistilledPageData() {}
 DistillerImpl::DistillerImpl(
     const DistillerPageFactory& distiller_page_factory,
     const DistillerURLFetcherFactory& distiller_url_fetcher_factory)
-    : distiller_url_fetcher_factory_(distiller_url_fetcher_factory),
+    : distiller_page_factory_(distiller_page_factory),
+      distiller_url_fetcher_factory_(distiller_url_fetcher_factory),
+      max_concurrent_page_distillations_(kMaxConcurrentPageDistillations),
       max_pages_in_article_(kMaxPagesInArticle),
       destruction_allowed_(true),
       weak_factory_(this) {
-  page_distiller_.reset(new PageDistiller(distiller_page_factory));
 }
 
 DistillerImpl::~DistillerImpl() {
@@ -63,13 +69,38 @@ DistillerImpl::~DistillerImpl() {
 
 void DistillerImpl::Init() {
   DCHECK(AreAllPagesFinished());
-  page_distiller_->Init();
+  DCHECK(page_distillers_.empty());
+  // Create the first page distiller right away, so the first page starts
+  // loading as soon as DistillPage() is called.
+  idle_page_distillers_.push_back(GetIdlePageDistiller());
 }
 
 void DistillerImpl::SetMaxNumPagesInArticle(size_t max_num_pages) {
   max_pages_in_article_ = max_num_pages;
 }
 
+void DistillerImpl::SetMaxConcurrentPageDistillations(size_t max_concurrent) {
+  DCHECK_GE(max_concurrent, 1u);
+  max_concurrent_page_distillations_ = max_concurrent;
+}
+
+PageDistiller* DistillerImpl::GetIdlePageDistiller() {
+  if (!idle_page_distillers_.empty()) {
+    // Reuse the page distiller that became idle last, so that a chain of
+    // pages is distilled in the same DistillerPage.
+    PageDistiller* page_distiller = idle_page_distillers_.back();
+    idle_page_distillers_.pop_back();
+    return page_distiller;
+  }
+  if (page_distillers_.size() >= max_concurrent_page_distillations_)
+    return NULL;
+
+  PageDistiller* page_distiller = new PageDistiller(distiller_page_factory_);
+  page_distillers_.push_back(page_distiller);
+  page_distiller->Init();
+  return page_distiller;
+}
+
 bool DistillerImpl::AreAllPagesFinished() const {
   return started_pages_index_.empty() && waiting_pages_.empty();
 }
@@ -109,11 +140,15 @@ void DistillerImpl::DistillPage(const GURL& url,
   update_cb_ = update_cb;
 
   AddToDistillationQueue(0, url);
-  DistillNextPage();
+  DistillNextPages();
 }
 
-void DistillerImpl::DistillNextPage() {
-  if (!waiting_pages_.empty()) {
+void DistillerImpl::DistillNextPages() {
+  while (!waiting_pages_.empty()) {
+    PageDistiller* page_distiller = GetIdlePageDistiller();
+    if (!page_distiller)
+      return;
+
     std::map<int, GURL>::iterator front = waiting_pages_.begin();
     int page_num = front->first;
     const GURL url = front->second;
@@ -125,22 +160,25 @@ void DistillerImpl::DistillNextPage() {
     seen_urls_.insert(url.spec());
     pages_.push_back(new DistilledPageData());
     started_pages_index_[page_num] = pages_.size() - 1;
-    page_distiller_->DistillPage(
+    page_distiller->DistillPage(
         url,
         base::Bind(&DistillerImpl::OnPageDistillationFinished,
                    weak_factory_.GetWeakPtr(),
+                   base::Unretained(page_distiller),
                    page_num,
                    url));
   }
 }
 
 void DistillerImpl::OnPageDistillationFinished(
+    PageDistiller* page_distiller,
     int page_num,
     const GURL& page_url,
     scoped_ptr<DistilledPageInfo> distilled_page,
     bool distillation_successful) {
   DCHECK(distilled_page.get());
   DCHECK(started_pages_index_.find(page_num) != started_pages_index_.end());
+  idle_page_distillers_.push_back(page_distiller);
   if (distillation_successful) {
     DistilledPageData* page_data =
         GetPageAtIndex(started_pages_index_[page_num]);
@@ -172,10 +210,14 @@ void DistillerImpl::OnPageDistillationFinished(
       FetchImage(page_num, image_id, distilled_page->image_urls[img_num]);
     }
 
+    // Start on the neighbouring pages before reporting this one, so they load
+    // while the update is handled.
+    DistillNextPages();
     AddPageIfDone(page_num);
-    DistillNextPage();
   } else {
     started_pages_index_.erase(page_num);
+    // A page in the other direction may still be waiting.
+    DistillNextPages();
     RunDistillerCallbackIfDone();
   }
 }
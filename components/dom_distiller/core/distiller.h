@@ -7,6 +7,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "base/callback.h"
 #include "base/containers/hash_tables.h"
@@ -84,6 +85,10 @@ class DistillerImpl : public Distiller {
 
   void SetMaxNumPagesInArticle(size_t max_num_pages);
 
+  // Sets how many pages may be under distillation at once, each in its own
+  // DistillerPage. Must be at least 1.
+  void SetMaxConcurrentPageDistillations(size_t max_concurrent);
+
  private:
   // In case of multiple pages, the Distiller maintains state of multiple pages
   // as page numbers relative to the page number where distillation started.
@@ -110,7 +115,8 @@ class DistillerImpl : public Distiller {
                         const std::string& id,
                         const std::string& response);
 
-  void OnPageDistillationFinished(int page_num,
+  void OnPageDistillationFinished(PageDistiller* page_distiller,
+                                  int page_num,
                                   const GURL& page_url,
                                   scoped_ptr<DistilledPageInfo> distilled_page,
                                   bool distillation_successful);
@@ -119,8 +125,13 @@ class DistillerImpl : public Distiller {
                           const std::string& image_id,
                           const std::string& item);
 
-  // Distills the next page.
-  void DistillNextPage();
+  // Starts distilling waiting pages, lowest page numbers first, until there
+  // are no more waiting pages or no more page distillers to distill them.
+  void DistillNextPages();
+
+  // Returns an idle page distiller, creating one if fewer than
+  // |max_concurrent_page_distillations_| exist, or NULL.
+  PageDistiller* GetIdlePageDistiller();
 
   // Adds the |url| to |pages_to_be_distilled| if |page_num| is a valid relative
   // page number and |url| is valid. Ignores duplicate pages and urls.
@@ -151,8 +162,18 @@ class DistillerImpl : public Distiller {
   // state.
   const ArticleDistillationUpdate CreateDistillationUpdate() const;
 
+  const DistillerPageFactory& distiller_page_factory_;
   const DistillerURLFetcherFactory& distiller_url_fetcher_factory_;
-  scoped_ptr<PageDistiller> page_distiller_;
+
+  // Every page distiller created so far. At most one page is under
+  // distillation in each, so pages can be distilled concurrently in both
+  // directions from the first page.
+  ScopedVector<PageDistiller> page_distillers_;
+
+  // The page distillers in |page_distillers_| that are not distilling a page.
+  std::vector<PageDistiller*> idle_page_distillers_;
+  size_t max_concurrent_page_distillations_;
+
   DistillationFinishedCallback finished_cb_;
   DistillationUpdateCallback update_cb_;
 
@@ -311,18 +311,18 @@ ACTION_P2(CreateMockDistillerPageWithPendingJSCallback,
   return distiller_page;
 }
 
-ACTION_P3(CreateMockDistillerPages,
-          distiller_data,
-          pages_size,
-          start_page_num) {
-  const base::WeakPtr<DistillerPage::Delegate>& delegate = arg0;
+// Creates a mock distiller page that expects to distill the pages in
+// |page_nums| in that order.
+MockDistillerPage* CreateMockDistillerPageForPages(
+    const base::WeakPtr<DistillerPage::Delegate>& delegate,
+    const MultipageDistillerData* distiller_data,
+    const vector<int>& page_nums) {
   MockDistillerPage* distiller_page = new MockDistillerPage(delegate);
   EXPECT_CALL(*distiller_page, InitImpl());
   {
     testing::InSequence s;
-    vector<int> page_nums = GetPagesInSequence(start_page_num, pages_size);
-    for (size_t page_num = 0; page_num < pages_size; ++page_num) {
-      int page = page_nums[page_num];
+    for (size_t i = 0; i < page_nums.size(); ++i) {
+      int page = page_nums[i];
       GURL url = GURL(distiller_data->page_urls[page]);
       EXPECT_CALL(*distiller_page, LoadURLImpl(url))
           .WillOnce(testing::InvokeWithoutArgs(distiller_page,
@@ -335,6 +335,18 @@ ACTION_P3(CreateMockDistillerPages,
   return distiller_page;
 }
 
+ACTION_P3(CreateMockDistillerPages,
+          distiller_data,
+          pages_size,
+          start_page_num) {
+  return CreateMockDistillerPageForPages(
+      arg0, distiller_data, GetPagesInSequence(start_page_num, pages_size));
+}
+
+ACTION_P2(CreateMockDistillerPagesInOrder, distiller_data, page_nums) {
+  return CreateMockDistillerPageForPages(arg0, distiller_data, page_nums);
+}
+
 TEST_F(DistillerTest, DistillPage) {
   base::MessageLoopForUI loop;
   scoped_ptr<base::ListValue> list =
@@ -529,9 +541,22 @@ TEST_F(DistillerTest, DistillPreviousPage) {
   scoped_ptr<MultipageDistillerData> distiller_data =
       CreateMultipageDistillerDataWithoutImages(kNumPages);
 
+  // The previous and next pages are distilled concurrently, in two distiller
+  // pages. The one created first distills the starting page and then goes
+  // back, the other one goes forward.
+  vector<int> backward_page_nums;
+  for (int page = start_page_num; page >= 0; --page)
+    backward_page_nums.push_back(page);
+  vector<int> forward_page_nums;
+  for (int page = start_page_num + 1; page < static_cast<int>(kNumPages);
+       ++page) {
+    forward_page_nums.push_back(page);
+  }
   EXPECT_CALL(page_factory_, CreateDistillerPageMock(_))
-      .WillOnce(CreateMockDistillerPages(
-          distiller_data.get(), kNumPages, start_page_num));
+      .WillOnce(CreateMockDistillerPagesInOrder(distiller_data.get(),
+                                                backward_page_nums))
+      .WillOnce(CreateMockDistillerPagesInOrder(distiller_data.get(),
+                                                forward_page_nums));
 
   distiller_.reset(new DistillerImpl(page_factory_, url_fetcher_factory_));
   distiller_->Init();
@@ -539,6 +564,45 @@ TEST_F(DistillerTest, DistillPreviousPage) {
   base::MessageLoop::current()->RunUntilIdle();
   VerifyArticleProtoMatchesMultipageData(
       article_proto_.get(), distiller_data.get(), kNumPages);
+
+  // Every page is reported as soon as it is distilled, starting with the page
+  // distillation started on.
+  ASSERT_EQ(kNumPages, in_sequence_updates_.size());
+  ASSERT_EQ(1u, in_sequence_updates_[0].GetPagesSize());
+  EXPECT_EQ(distiller_data->page_urls[start_page_num],
+            in_sequence_updates_[0].GetDistilledPage(0).url());
+  for (size_t i = 0; i < kNumPages; ++i)
+    EXPECT_EQ(i + 1, in_sequence_updates_[i].GetPagesSize());
+}
+
+TEST_F(DistillerTest, PreviousPageFailureDoesNotStopNextPages) {
+  base::MessageLoopForUI loop;
+  const size_t kNumPages = 4;
+  int start_page_num = 1;
+  scoped_ptr<MultipageDistillerData> distiller_data =
+      CreateMultipageDistillerDataWithoutImages(kNumPages);
+  // Distilling page 0 fails.
+  distiller_data->distilled_values.erase(
+      distiller_data->distilled_values.begin());
+  distiller_data->distilled_values.insert(
+      distiller_data->distilled_values.begin(),
+      base::Value::CreateNullValue());
+
+  EXPECT_CALL(page_factory_, CreateDistillerPageMock(_))
+      .WillOnce(CreateMockDistillerPages(
+          distiller_data.get(), kNumPages, start_page_num));
+
+  distiller_.reset(new DistillerImpl(page_factory_, url_fetcher_factory_));
+  distiller_->SetMaxConcurrentPageDistillations(1);
+  distiller_->Init();
+  DistillPage(distiller_data->page_urls[start_page_num]);
+  base::MessageLoop::current()->RunUntilIdle();
+
+  // Pages 1 to 3 are still distilled.
+  ASSERT_TRUE(article_proto_);
+  ASSERT_EQ(3, article_proto_->pages_size());
+  for (int i = 0; i < article_proto_->pages_size(); ++i)
+    EXPECT_EQ(distiller_data->page_urls[i + 1], article_proto_->pages(i).url());
 }
 
 TEST_F(DistillerTest, IncrementalUpdates) {
@@ -555,6 +619,8 @@ TEST_F(DistillerTest, IncrementalUpdates) {
           distiller_data.get(), kNumPages, start_page_num));
 
   distiller_.reset(new DistillerImpl(page_factory_, url_fetcher_factory_));
+  // Distill one page at a time, so that the order of updates is known.
+  distiller_->SetMaxConcurrentPageDistillations(1);
   distiller_->Init();
   DistillPage(distiller_data->page_urls[start_page_num]);
   base::MessageLoop::current()->RunUntilIdle();
@@ -578,6 +644,8 @@ TEST_F(DistillerTest, IncrementalUpdatesDoNotDeleteFinalArticle) {
           distiller_data.get(), kNumPages, start_page_num));
 
   distiller_.reset(new DistillerImpl(page_factory_, url_fetcher_factory_));
+  // Distill one page at a time, so that the order of updates is known.
+  distiller_->SetMaxConcurrentPageDistillations(1);
   distiller_->Init();
   DistillPage(distiller_data->page_urls[start_page_num]);
   base::MessageLoop::current()->RunUntilIdle();
@@ -603,6 +671,8 @@ TEST_F(DistillerTest, DeletingArticleDoesNotInterfereWithUpdates) {
           distiller_data.get(), kNumPages, start_page_num));
 
   distiller_.reset(new DistillerImpl(page_factory_, url_fetcher_factory_));
+  // Distill one page at a time, so that the order of updates is known.
+  distiller_->SetMaxConcurrentPageDistillations(1);
   distiller_->Init();
   DistillPage(distiller_data->page_urls[start_page_num]);
   base::MessageLoop::current()->RunUntilIdle();
@@ -138,6 +138,14 @@ void PrecacheManager::OnDone() {
   DCHECK(is_precaching_);
   is_precaching_ = false;
 
+  BrowserThread::PostTask(
+      BrowserThread::DB, FROM_HERE,
+      base::Bind(&PrecacheDatabase::RecordPrecacheSession, precache_database_,
+                 base::TimeTicks::Now() - precache_fetcher_->start_time(),
+                 precache_fetcher_->bytes_fetched(),
+                 precache_fetcher_->num_fetches(),
+                 precache_fetcher_->was_stopped()));
+
   precache_fetcher_.reset();
 
   precache_completion_callback_.Run();
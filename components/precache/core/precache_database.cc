@@ -163,6 +163,20 @@ void PrecacheDatabase::RecordURLFetched(const GURL& url,
   MaybePostFlush();
 }
 
+void PrecacheDatabase::RecordPrecacheSession(const base::TimeDelta& duration,
+                                             int64 bytes, int num_fetches,
+                                             bool was_stopped) {
+  DCHECK(thread_checker_.CalledOnValidThread());
+
+  // Sessions are only reported to UMA, so they are recorded even if the
+  // database is inaccessible.
+  UMA_HISTOGRAM_LONG_TIMES("Precache.Session.Duration", duration);
+  UMA_HISTOGRAM_COUNTS("Precache.Session.DownloadedKB",
+                       static_cast<int>(bytes / 1024));
+  UMA_HISTOGRAM_COUNTS("Precache.Session.Fetches", num_fetches);
+  UMA_HISTOGRAM_BOOLEAN("Precache.Session.Stopped", was_stopped);
+}
+
 bool PrecacheDatabase::IsDatabaseAccessible() const {
   DCHECK(thread_checker_.CalledOnValidThread());
   DCHECK(db_);
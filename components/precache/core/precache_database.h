@@ -21,6 +21,7 @@ class GURL;
 namespace base {
 class FilePath;
 class Time;
+class TimeDelta;
 }
 
 namespace sql {
@@ -57,6 +58,13 @@ class PrecacheDatabase : public base::RefCountedThreadSafe<PrecacheDatabase> {
                         int64 size, bool was_cached,
                         bool is_connection_cellular);
 
+  // Report precache-related metrics for a precaching session that took
+  // |duration| and fetched |bytes| in |num_fetches| fetches. |was_stopped|
+  // indicates whether the session was stopped early because of the connection
+  // or the battery.
+  void RecordPrecacheSession(const base::TimeDelta& duration, int64 bytes,
+                             int num_fetches, bool was_stopped);
+
  private:
   friend class base::RefCountedThreadSafe<PrecacheDatabase>;
   friend class PrecacheDatabaseTest;
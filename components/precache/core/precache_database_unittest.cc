@@ -28,7 +28,11 @@ const char* kHistogramNames[] = {"Precache.DownloadedPrecacheMotivated",
                                  "Precache.DownloadedNonPrecache",
                                  "Precache.DownloadedNonPrecache.Cellular",
                                  "Precache.Saved",
-                                 "Precache.Saved.Cellular"};
+                                 "Precache.Saved.Cellular",
+                                 "Precache.Session.Duration",
+                                 "Precache.Session.DownloadedKB",
+                                 "Precache.Session.Fetches",
+                                 "Precache.Session.Stopped"};
 
 scoped_ptr<base::HistogramSamples> GetHistogramSamples(
     const char* histogram_name) {
@@ -74,6 +78,10 @@ class PrecacheDatabaseTest : public testing::Test {
     UMA_HISTOGRAM_COUNTS("Precache.DownloadedNonPrecache.Cellular", 0);
     UMA_HISTOGRAM_COUNTS("Precache.Saved", 0);
     UMA_HISTOGRAM_COUNTS("Precache.Saved.Cellular", 0);
+    UMA_HISTOGRAM_LONG_TIMES("Precache.Session.Duration", base::TimeDelta());
+    UMA_HISTOGRAM_COUNTS("Precache.Session.DownloadedKB", 0);
+    UMA_HISTOGRAM_COUNTS("Precache.Session.Fetches", 0);
+    UMA_HISTOGRAM_BOOLEAN("Precache.Session.Stopped", false);
 
     for (size_t i = 0; i < arraysize(kHistogramNames); i++) {
       initial_histogram_samples_[i] =
@@ -386,6 +394,17 @@ TEST_F(PrecacheDatabaseTest, SampleInteraction) {
   EXPECT_EQ(1, saved_bytes_cellular->GetCount(kSize1));
 }
 
+TEST_F(PrecacheDatabaseTest, PrecacheSession) {
+  precache_database_->RecordPrecacheSession(base::TimeDelta::FromSeconds(30),
+                                            50 * 1024, 7,
+                                            true /* was_stopped */);
+
+  ExpectNewSample("Precache.Session.Duration", 30 * 1000);
+  ExpectNewSample("Precache.Session.DownloadedKB", 50);
+  ExpectNewSample("Precache.Session.Fetches", 7);
+  ExpectNewSample("Precache.Session.Stopped", 1);
+}
+
 }  // namespace
 
 }  // namespace precache
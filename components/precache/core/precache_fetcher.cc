@@ -11,6 +11,8 @@
 #include "base/command_line.h"
 #include "base/compiler_specific.h"
 #include "base/containers/hash_tables.h"
+#include "base/power_monitor/power_monitor.h"
+#include "base/stl_util.h"
 #include "components/precache/core/precache_switches.h"
 #include "components/precache/core/proto/precache.pb.h"
 #include "net/base/escape.h"
@@ -26,6 +28,28 @@ namespace precache {
 
 namespace {
 
+// The most fetches precaching keeps in flight, as many as the connections a
+// browser opens to a host.
+const size_t kMaxFetchesInFlight = 6;
+
+// A window of the FetchConcurrencyTuner ends once this many fetches per fetch
+// in flight have completed.
+const size_t kWindowFetchesPerFetchInFlight = 4;
+
+// Throughput changes between windows smaller than this fraction are noise.
+const double kThroughputChangeThreshold = 0.1;
+
+// Returns true if precaching should not go on, as it would cost the user
+// data on a metered connection or battery.
+bool ShouldStopPrecaching() {
+  if (net::NetworkChangeNotifier::IsConnectionCellular(
+          net::NetworkChangeNotifier::GetConnectionType())) {
+    return true;
+  }
+  base::PowerMonitor* power_monitor = base::PowerMonitor::Get();
+  return power_monitor && power_monitor->IsOnBatteryPower();
+}
+
 GURL GetConfigURL() {
   const CommandLine& command_line = *CommandLine::ForCurrentProcess();
   if (command_line.HasSwitch(switches::kPrecacheConfigSettingsURL)) {
@@ -94,6 +118,59 @@ bool ParseProtoFromFetchResponse(const URLFetcher& source,
 
 }  // namespace
 
+FetchConcurrencyTuner::FetchConcurrencyTuner(size_t max_fetches_in_flight)
+    : max_fetches_in_flight_(max_fetches_in_flight),
+      fetches_in_flight_(1),
+      step_(1),
+      window_bytes_(0),
+      window_fetches_(0),
+      previous_throughput_(0) {
+  DCHECK_GE(max_fetches_in_flight_, 1u);
+}
+
+void FetchConcurrencyTuner::Start(const base::TimeTicks& now) {
+  window_start_ = now;
+  window_bytes_ = 0;
+  window_fetches_ = 0;
+}
+
+void FetchConcurrencyTuner::OnFetchComplete(int64 bytes,
+                                            const base::TimeTicks& now) {
+  window_bytes_ += bytes;
+  ++window_fetches_;
+  if (window_fetches_ < kWindowFetchesPerFetchInFlight * fetches_in_flight_)
+    return;
+
+  const double seconds = (now - window_start_).InSecondsF();
+  if (seconds <= 0) {
+    // Nothing to learn from a window that took no time.
+    Start(now);
+    return;
+  }
+  const double throughput = window_bytes_ / seconds;
+
+  bool move = true;
+  if (previous_throughput_ > 0) {
+    if (throughput < previous_throughput_ * (1 - kThroughputChangeThreshold)) {
+      // The last move made things worse, so go back.
+      step_ = -step_;
+    } else if (throughput <=
+               previous_throughput_ * (1 + kThroughputChangeThreshold)) {
+      move = false;
+    }
+  }
+
+  if (move) {
+    if (step_ > 0 && fetches_in_flight_ < max_fetches_in_flight_)
+      ++fetches_in_flight_;
+    else if (step_ < 0 && fetches_in_flight_ > 1)
+      --fetches_in_flight_;
+  }
+
+  previous_throughput_ = throughput;
+  Start(now);
+}
+
 // Class that fetches a URL, and runs the specified callback when the fetch is
 // complete. This class exists so that a different method can be run in
 // response to different kinds of fetches, e.g. OnConfigFetchComplete when
@@ -108,6 +185,8 @@ class PrecacheFetcher::Fetcher : public net::URLFetcherDelegate {
   virtual ~Fetcher() {}
   virtual void OnURLFetchComplete(const URLFetcher* source) OVERRIDE;
 
+  const URLFetcher* url_fetcher() const { return url_fetcher_.get(); }
+
  private:
   const base::Callback<void(const URLFetcher&)> callback_;
   scoped_ptr<URLFetcher> url_fetcher_;
@@ -135,7 +214,12 @@ PrecacheFetcher::PrecacheFetcher(
     PrecacheFetcher::PrecacheDelegate* precache_delegate)
     : starting_urls_(starting_urls),
       request_context_(request_context),
-      precache_delegate_(precache_delegate) {
+      precache_delegate_(precache_delegate),
+      is_manifest_fetch_in_flight_(false),
+      tuner_(kMaxFetchesInFlight),
+      bytes_fetched_(0),
+      num_fetches_(0),
+      was_stopped_(false) {
   DCHECK(request_context_);    // Request context must be non-NULL.
   DCHECK(precache_delegate_);  // Precache delegate must be non-NULL.
 
@@ -146,44 +230,109 @@ PrecacheFetcher::PrecacheFetcher(
 }
 
 PrecacheFetcher::~PrecacheFetcher() {
+  if (!start_time_.is_null()) {
+    net::NetworkChangeNotifier::RemoveConnectionTypeObserver(this);
+    if (base::PowerMonitor::Get())
+      base::PowerMonitor::Get()->RemoveObserver(this);
+  }
+  STLDeleteElements(&fetchers_);
 }
 
 void PrecacheFetcher::Start() {
-  DCHECK(!fetcher_);  // Start shouldn't be called repeatedly.
+  DCHECK(start_time_.is_null());  // Start shouldn't be called repeatedly.
 
   GURL config_url = GetConfigURL();
   DCHECK(config_url.is_valid());
 
+  start_time_ = base::TimeTicks::Now();
+  tuner_.Start(start_time_);
+  net::NetworkChangeNotifier::AddConnectionTypeObserver(this);
+  if (base::PowerMonitor::Get())
+    base::PowerMonitor::Get()->AddObserver(this);
+
   // Fetch the precache configuration settings from the server.
-  fetcher_.reset(new Fetcher(request_context_, config_url,
-                             base::Bind(&PrecacheFetcher::OnConfigFetchComplete,
-                                        base::Unretained(this))));
+  StartFetch(config_url, &PrecacheFetcher::OnConfigFetchComplete);
 }
 
-void PrecacheFetcher::StartNextFetch() {
-  if (!resource_urls_to_fetch_.empty()) {
-    // Fetch the next resource URL.
-    fetcher_.reset(
-        new Fetcher(request_context_, resource_urls_to_fetch_.front(),
-                    base::Bind(&PrecacheFetcher::OnResourceFetchComplete,
-                               base::Unretained(this))));
+void PrecacheFetcher::OnConnectionTypeChanged(
+    net::NetworkChangeNotifier::ConnectionType type) {
+  if (!fetchers_.empty() &&
+      net::NetworkChangeNotifier::IsConnectionCellular(type)) {
+    Stop();
+  }
+}
 
-    resource_urls_to_fetch_.pop_front();
+void PrecacheFetcher::OnPowerStateChange(bool on_battery_power) {
+  if (!fetchers_.empty() && on_battery_power)
+    Stop();
+}
+
+void PrecacheFetcher::StartFetch(
+    const GURL& url,
+    void (PrecacheFetcher::*callback)(const URLFetcher&)) {
+  fetchers_.insert(new Fetcher(request_context_, url,
+                               base::Bind(callback, base::Unretained(this))));
+}
+
+void PrecacheFetcher::StartNextFetches() {
+  if (ShouldStopPrecaching()) {
+    Stop();
     return;
   }
 
-  if (!manifest_urls_to_fetch_.empty()) {
-    // Fetch the next manifest URL.
-    fetcher_.reset(
-        new Fetcher(request_context_, manifest_urls_to_fetch_.front(),
-                    base::Bind(&PrecacheFetcher::OnManifestFetchComplete,
-                               base::Unretained(this))));
+  while (fetchers_.size() < tuner_.fetches_in_flight() &&
+         !resource_urls_to_fetch_.empty()) {
+    // Fetch the next resource URL.
+    StartFetch(resource_urls_to_fetch_.front(),
+               &PrecacheFetcher::OnResourceFetchComplete);
+    resource_urls_to_fetch_.pop_front();
+  }
 
+  if (fetchers_.size() < tuner_.fetches_in_flight() &&
+      resource_urls_to_fetch_.empty() && !is_manifest_fetch_in_flight_ &&
+      !manifest_urls_to_fetch_.empty()) {
+    // Fetch the next manifest URL.
+    StartFetch(manifest_urls_to_fetch_.front(),
+               &PrecacheFetcher::OnManifestFetchComplete);
     manifest_urls_to_fetch_.pop_front();
-    return;
+    is_manifest_fetch_in_flight_ = true;
+  }
+
+  if (fetchers_.empty()) {
+    // There are no more URLs to fetch, so end the precache cycle.
+    precache_delegate_->OnDone();
+    // OnDone may have deleted this PrecacheFetcher, so don't do anything after
+    // it is called.
   }
+}
+
+void PrecacheFetcher::FinishFetch(const URLFetcher& source) {
+  std::string response;
+  int64 bytes = source.GetResponseAsString(&response) ? response.size() : 0;
+  bytes_fetched_ += bytes;
+  ++num_fetches_;
+  tuner_.OnFetchComplete(bytes, base::TimeTicks::Now());
+
+  for (std::set<Fetcher*>::iterator it = fetchers_.begin();
+       it != fetchers_.end(); ++it) {
+    if ((*it)->url_fetcher() == &source) {
+      // This destroys |source|.
+      delete *it;
+      fetchers_.erase(it);
+      break;
+    }
+  }
+
+  StartNextFetches();
+}
+
+void PrecacheFetcher::Stop() {
+  was_stopped_ = true;
+  STLDeleteElements(&fetchers_);
+  is_manifest_fetch_in_flight_ = false;
+  manifest_urls_to_fetch_.clear();
+  resource_urls_to_fetch_.clear();
 
-  // There are no more URLs to fetch, so end the precache cycle.
   precache_delegate_->OnDone();
   // OnDone may have deleted this PrecacheFetcher, so don't do anything after it
   // is called.
@@ -226,10 +375,11 @@ void PrecacheFetcher::OnConfigFetchComplete(const URLFetcher& source) {
     }
   }
 
-  StartNextFetch();
+  FinishFetch(source);
 }
 
 void PrecacheFetcher::OnManifestFetchComplete(const URLFetcher& source) {
+  is_manifest_fetch_in_flight_ = false;
   PrecacheManifest manifest;
 
   if (ParseProtoFromFetchResponse(source, &manifest)) {
@@ -240,13 +390,13 @@ void PrecacheFetcher::OnManifestFetchComplete(const URLFetcher& source) {
     }
   }
 
-  StartNextFetch();
+  FinishFetch(source);
 }
 
 void PrecacheFetcher::OnResourceFetchComplete(const URLFetcher& source) {
   // The resource has already been put in the cache during the fetch process, so
   // nothing more needs to be done for the resource.
-  StartNextFetch();
+  FinishFetch(source);
 }
 
 }  // namespace precache
@@ -6,10 +6,14 @@
 #define COMPONENTS_PRECACHE_CORE_PRECACHE_FETCHER_H_
 
 #include <list>
+#include <set>
 
 #include "base/basictypes.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/power_monitor/power_observer.h"
+#include "base/time/time.h"
+#include "net/base/network_change_notifier.h"
 #include "url/gurl.h"
 
 namespace net {
@@ -19,6 +23,42 @@ class URLRequestContextGetter;
 
 namespace precache {
 
+// Picks how many fetches PrecacheFetcher keeps in flight at once. Starting
+// from one, it measures the throughput of each window of completed fetches,
+// and keeps moving the number of fetches in the same direction while that
+// raises the throughput, turning back when the throughput falls.
+class FetchConcurrencyTuner {
+ public:
+  // Up to |max_fetches_in_flight| fetches are kept in flight.
+  explicit FetchConcurrencyTuner(size_t max_fetches_in_flight);
+
+  size_t fetches_in_flight() const { return fetches_in_flight_; }
+
+  // Starts the first window at |now|.
+  void Start(const base::TimeTicks& now);
+
+  // Called when a fetch of |bytes| completes at |now|.
+  void OnFetchComplete(int64 bytes, const base::TimeTicks& now);
+
+ private:
+  const size_t max_fetches_in_flight_;
+  size_t fetches_in_flight_;
+
+  // +1 or -1, the way |fetches_in_flight_| moved last.
+  int step_;
+
+  // The current window.
+  base::TimeTicks window_start_;
+  int64 window_bytes_;
+  size_t window_fetches_;
+
+  // The throughput of the previous window, in bytes per second, or 0 before
+  // the end of the first window.
+  double previous_throughput_;
+
+  DISALLOW_COPY_AND_ASSIGN(FetchConcurrencyTuner);
+};
+
 // Public interface to code that fetches resources that the user is likely to
 // want to fetch in the future, putting them in the network stack disk cache.
 // Precaching is intended to be done when Chrome is not actively in use, likely
@@ -29,8 +69,12 @@ namespace precache {
 // server, sending it the list of starting URLs sequentially. For each starting
 // URL, the server returns a manifest of resource URLs that are good candidates
 // for precaching. Every resource returned is fetched, and responses are cached
-// as they are received. Destroying the PrecacheFetcher while it is precaching
-// will cancel any fetch in progress and cancel precaching.
+// as they are received. Resources are fetched a few at a time, as many as a
+// FetchConcurrencyTuner picks. Destroying the PrecacheFetcher while it is
+// precaching will cancel any fetch in progress and cancel precaching.
+//
+// Precaching stops early, as if it were done, if the connection becomes
+// cellular or the device goes on battery power.
 //
 // The URLs of the server-side component must be specified in order for the
 // PrecacheFetcher to work. This includes the URL that the precache
@@ -56,7 +100,9 @@ namespace precache {
 //  private:
 //   scoped_ptr<PrecacheFetcher> fetcher_;
 // };
-class PrecacheFetcher {
+class PrecacheFetcher
+    : public net::NetworkChangeNotifier::ConnectionTypeObserver,
+      public base::PowerObserver {
  public:
   class PrecacheDelegate {
    public:
@@ -76,19 +122,46 @@ class PrecacheFetcher {
 
   virtual ~PrecacheFetcher();
 
-  // Starts fetching resources to precache. URLs are fetched sequentially. Can
-  // be called from any thread. Start should only be called once on a
-  // PrecacheFetcher instance.
+  // Starts fetching resources to precache. Must be called on the thread the
+  // PrecacheFetcher is used on, which must have a MessageLoop. Start should
+  // only be called once on a PrecacheFetcher instance.
   void Start();
 
+  // What the precaching session did so far. Can be called after OnDone() to
+  // find out about the whole session.
+  base::TimeTicks start_time() const { return start_time_; }
+  int64 bytes_fetched() const { return bytes_fetched_; }
+  int num_fetches() const { return num_fetches_; }
+  // True if precaching stopped because of the connection or the battery.
+  bool was_stopped() const { return was_stopped_; }
+
+  // net::NetworkChangeNotifier::ConnectionTypeObserver:
+  virtual void OnConnectionTypeChanged(
+      net::NetworkChangeNotifier::ConnectionType type) OVERRIDE;
+
+  // base::PowerObserver:
+  virtual void OnPowerStateChange(bool on_battery_power) OVERRIDE;
+
  private:
   class Fetcher;
 
-  // Fetches the next resource or manifest URL, if any remain. Fetching is done
-  // sequentially and depth-first: all resources are fetched for a manifest
-  // before the next manifest is fetched. This is done to limit the length of
-  // the |resource_urls_to_fetch_| list, reducing the memory usage.
-  void StartNextFetch();
+  // Starts fetching |url|, and runs |callback| when done.
+  void StartFetch(const GURL& url,
+                  void (PrecacheFetcher::*callback)(const net::URLFetcher&));
+
+  // Fetches the next resource and manifest URLs, if any remain, up to the
+  // number of fetches the tuner allows. Fetching is done depth-first: all
+  // resources are fetched for a manifest before the next manifest is fetched.
+  // This is done to limit the length of the |resource_urls_to_fetch_| list,
+  // reducing the memory usage. Calls OnDone() if nothing is left to fetch.
+  void StartNextFetches();
+
+  // Accounts for the completed fetch |source|, destroys its Fetcher, and
+  // starts the next fetches. Must be the last thing the fetch callbacks do.
+  void FinishFetch(const net::URLFetcher& source);
+
+  // Cancels the fetches in progress, and ends precaching.
+  void Stop();
 
   // Called when the precache configuration settings have been fetched.
   // Determines the list of manifest URLs to fetch according to the list of
@@ -114,11 +187,20 @@ class PrecacheFetcher {
   // Non-owning pointer. Should not be NULL.
   PrecacheDelegate* precache_delegate_;
 
-  scoped_ptr<Fetcher> fetcher_;
+  // The fetches in progress. Owned.
+  std::set<Fetcher*> fetchers_;
+  bool is_manifest_fetch_in_flight_;
 
   std::list<GURL> manifest_urls_to_fetch_;
   std::list<GURL> resource_urls_to_fetch_;
 
+  FetchConcurrencyTuner tuner_;
+
+  base::TimeTicks start_time_;
+  int64 bytes_fetched_;
+  int num_fetches_;
+  bool was_stopped_;
+
   DISALLOW_COPY_AND_ASSIGN(PrecacheFetcher);
 };
 
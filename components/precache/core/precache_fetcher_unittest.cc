@@ -14,8 +14,13 @@
 #include "base/command_line.h"
 #include "base/compiler_specific.h"
 #include "base/message_loop/message_loop.h"
+#include "base/power_monitor/power_monitor.h"
+#include "base/power_monitor/power_monitor_source.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
 #include "components/precache/core/precache_switches.h"
 #include "components/precache/core/proto/precache.pb.h"
+#include "net/base/network_change_notifier.h"
 #include "net/http/http_response_headers.h"
 #include "net/http/http_status_code.h"
 #include "net/url_request/test_url_fetcher_factory.h"
@@ -72,6 +77,56 @@ class TestPrecacheDelegate : public PrecacheFetcher::PrecacheDelegate {
   bool was_on_done_called_;
 };
 
+class TestNetworkChangeNotifier : public net::NetworkChangeNotifier {
+ public:
+  TestNetworkChangeNotifier() : connection_type_(CONNECTION_UNKNOWN) {}
+
+  virtual ConnectionType GetCurrentConnectionType() const OVERRIDE {
+    return connection_type_;
+  }
+
+  void SetConnectionType(ConnectionType connection_type) {
+    connection_type_ = connection_type;
+    NotifyObserversOfConnectionTypeChange();
+  }
+
+ private:
+  ConnectionType connection_type_;
+
+  DISALLOW_COPY_AND_ASSIGN(TestNetworkChangeNotifier);
+};
+
+class TestPowerMonitorSource : public base::PowerMonitorSource {
+ public:
+  TestPowerMonitorSource() : on_battery_power_(false) {}
+
+  void SetOnBatteryPower(bool on_battery_power) {
+    on_battery_power_ = on_battery_power;
+    ProcessPowerEvent(POWER_STATE_EVENT);
+  }
+
+ protected:
+  virtual bool IsOnBatteryPowerImpl() OVERRIDE {
+    return on_battery_power_;
+  }
+
+ private:
+  bool on_battery_power_;
+
+  DISALLOW_COPY_AND_ASSIGN(TestPowerMonitorSource);
+};
+
+// Completes |num_fetches| fetches of |bytes| each on |tuner|, evenly spread
+// over the |duration| after |*now|, and advances |*now| past them.
+void CompleteFetches(FetchConcurrencyTuner* tuner, size_t num_fetches,
+                     int64 bytes, const base::TimeDelta& duration,
+                     base::TimeTicks* now) {
+  for (size_t i = 0; i < num_fetches; ++i) {
+    *now += duration / static_cast<int64>(num_fetches);
+    tuner->OnFetchComplete(bytes, *now);
+  }
+}
+
 class PrecacheFetcherTest : public testing::Test {
  public:
   PrecacheFetcherTest()
@@ -163,6 +218,148 @@ TEST_F(PrecacheFetcherTest, FullPrecache) {
   EXPECT_EQ(expected_requested_urls, url_callback_.requested_urls());
 
   EXPECT_TRUE(precache_delegate_.was_on_done_called());
+  EXPECT_EQ(7, precache_fetcher.num_fetches());
+  EXPECT_FALSE(precache_fetcher.was_stopped());
+}
+
+TEST_F(PrecacheFetcherTest, ConcurrentResourceFetches) {
+  CommandLine::ForCurrentProcess()->AppendSwitchASCII(
+      switches::kPrecacheConfigSettingsURL, kConfigURL);
+  CommandLine::ForCurrentProcess()->AppendSwitchASCII(
+      switches::kPrecacheManifestURLPrefix, kManfiestURLPrefix);
+
+  std::list<GURL> starting_urls(1, GURL("http://good-manifest.com"));
+
+  PrecacheConfigurationSettings config;
+  config.set_top_sites_count(1);
+
+  // Enough resources for the tuner to try more than one fetch in flight.
+  const int kNumResources = 40;
+  PrecacheManifest good_manifest;
+  std::multiset<GURL> expected_requested_urls;
+  for (int i = 0; i < kNumResources; ++i) {
+    GURL resource_url(base::StringPrintf("http://good-resource.com/%d", i));
+    good_manifest.add_resource()->set_url(resource_url.spec());
+    factory_.SetFakeResponse(resource_url, "good", net::HTTP_OK,
+                             net::URLRequestStatus::SUCCESS);
+    expected_requested_urls.insert(resource_url);
+  }
+
+  factory_.SetFakeResponse(GURL(kConfigURL), config.SerializeAsString(),
+                           net::HTTP_OK, net::URLRequestStatus::SUCCESS);
+  factory_.SetFakeResponse(GURL(kGoodManifestURL),
+                           good_manifest.SerializeAsString(), net::HTTP_OK,
+                           net::URLRequestStatus::SUCCESS);
+
+  PrecacheFetcher precache_fetcher(starting_urls, request_context_.get(),
+                                   &precache_delegate_);
+  precache_fetcher.Start();
+
+  base::MessageLoop::current()->RunUntilIdle();
+
+  expected_requested_urls.insert(GURL(kConfigURL));
+  expected_requested_urls.insert(GURL(kGoodManifestURL));
+  EXPECT_EQ(expected_requested_urls, url_callback_.requested_urls());
+
+  EXPECT_TRUE(precache_delegate_.was_on_done_called());
+  EXPECT_EQ(kNumResources + 2, precache_fetcher.num_fetches());
+  EXPECT_LE(kNumResources * 4, precache_fetcher.bytes_fetched());
+}
+
+TEST_F(PrecacheFetcherTest, StopWhenConnectionIsCellular) {
+  CommandLine::ForCurrentProcess()->AppendSwitchASCII(
+      switches::kPrecacheConfigSettingsURL, kConfigURL);
+
+  std::list<GURL> starting_urls(1, GURL("http://starting-url.com"));
+
+  PrecacheConfigurationSettings config;
+  config.set_top_sites_count(1);
+
+  factory_.SetFakeResponse(GURL(kConfigURL), config.SerializeAsString(),
+                           net::HTTP_OK, net::URLRequestStatus::SUCCESS);
+
+  TestNetworkChangeNotifier network_change_notifier;
+  PrecacheFetcher precache_fetcher(starting_urls, request_context_.get(),
+                                   &precache_delegate_);
+  precache_fetcher.Start();
+
+  // The connection becomes cellular while the config is being fetched, so no
+  // manifest should be fetched.
+  network_change_notifier.SetConnectionType(
+      net::NetworkChangeNotifier::CONNECTION_3G);
+
+  base::MessageLoop::current()->RunUntilIdle();
+
+  std::multiset<GURL> expected_requested_urls;
+  expected_requested_urls.insert(GURL(kConfigURL));
+  EXPECT_EQ(expected_requested_urls, url_callback_.requested_urls());
+
+  EXPECT_TRUE(precache_delegate_.was_on_done_called());
+  EXPECT_TRUE(precache_fetcher.was_stopped());
+}
+
+TEST_F(PrecacheFetcherTest, StopOnBatteryPower) {
+  CommandLine::ForCurrentProcess()->AppendSwitchASCII(
+      switches::kPrecacheConfigSettingsURL, kConfigURL);
+
+  std::list<GURL> starting_urls(1, GURL("http://starting-url.com"));
+
+  PrecacheConfigurationSettings config;
+  config.set_top_sites_count(1);
+
+  factory_.SetFakeResponse(GURL(kConfigURL), config.SerializeAsString(),
+                           net::HTTP_OK, net::URLRequestStatus::SUCCESS);
+
+  TestPowerMonitorSource* power_monitor_source = new TestPowerMonitorSource();
+  base::PowerMonitor power_monitor(
+      scoped_ptr<base::PowerMonitorSource>(power_monitor_source));
+  power_monitor_source->SetOnBatteryPower(true);
+
+  PrecacheFetcher precache_fetcher(starting_urls, request_context_.get(),
+                                   &precache_delegate_);
+  precache_fetcher.Start();
+
+  base::MessageLoop::current()->RunUntilIdle();
+
+  std::multiset<GURL> expected_requested_urls;
+  expected_requested_urls.insert(GURL(kConfigURL));
+  EXPECT_EQ(expected_requested_urls, url_callback_.requested_urls());
+
+  EXPECT_TRUE(precache_delegate_.was_on_done_called());
+  EXPECT_TRUE(precache_fetcher.was_stopped());
+}
+
+TEST(FetchConcurrencyTunerTest, FollowsThroughput) {
+  FetchConcurrencyTuner tuner(3);
+  base::TimeTicks now = base::TimeTicks::Now();
+  const base::TimeDelta kSecond = base::TimeDelta::FromSeconds(1);
+  tuner.Start(now);
+  EXPECT_EQ(1u, tuner.fetches_in_flight());
+
+  // Each window is four fetches per fetch in flight. The first one always
+  // moves up.
+  CompleteFetches(&tuner, 4, 1000, kSecond, &now);
+  EXPECT_EQ(2u, tuner.fetches_in_flight());
+
+  // Throughput keeps rising, but no more than three fetches are in flight.
+  CompleteFetches(&tuner, 8, 1000, kSecond, &now);
+  EXPECT_EQ(3u, tuner.fetches_in_flight());
+  CompleteFetches(&tuner, 12, 1000, kSecond, &now);
+  EXPECT_EQ(3u, tuner.fetches_in_flight());
+
+  // Throughput falls, so turn back, and keep going down while it rises.
+  CompleteFetches(&tuner, 12, 1000, 2 * kSecond, &now);
+  EXPECT_EQ(2u, tuner.fetches_in_flight());
+  CompleteFetches(&tuner, 8, 1000, kSecond, &now);
+  EXPECT_EQ(1u, tuner.fetches_in_flight());
+
+  // Throughput falls again, so turn back up.
+  CompleteFetches(&tuner, 4, 1000, kSecond, &now);
+  EXPECT_EQ(2u, tuner.fetches_in_flight());
+
+  // Changes within the noise leave things be.
+  CompleteFetches(&tuner, 8, 1050, 2 * kSecond, &now);
+  EXPECT_EQ(2u, tuner.fetches_in_flight());
 }
 
 TEST_F(PrecacheFetcherTest, ConfigFetchFailure) {
@@ -23,6 +23,8 @@ const char kTranslateTimeToTranslate[] = "Translate.TimeToTranslate";
 const char kTranslateUserActionDuration[] = "Translate.UserActionDuration";
 const char kTranslatePageScheme[] = "Translate.PageScheme";
 const char kTranslateSimilarLanguageMatch[] = "Translate.SimilarLanguageMatch";
+const char kTranslateLanguageDetectionMainThreadTime[] =
+    "Translate.LanguageDetectionMainThreadTime";
 
 const char kSchemeHttp[] = "http";
 const char kSchemeHttps[] = "https";
@@ -43,7 +45,9 @@ const MetricsEntry kMetricsEntries[] = {
     {UMA_TIME_TO_TRANSLATE, kTranslateTimeToTranslate},
     {UMA_USER_ACTION_DURATION, kTranslateUserActionDuration},
     {UMA_PAGE_SCHEME, kTranslatePageScheme},
-    {UMA_SIMILAR_LANGUAGE_MATCH, kTranslateSimilarLanguageMatch}, };
+    {UMA_SIMILAR_LANGUAGE_MATCH, kTranslateSimilarLanguageMatch},
+    {UMA_LANGUAGE_DETECTION_MAIN_THREAD_TIME,
+     kTranslateLanguageDetectionMainThreadTime}, };
 
 COMPILE_ASSERT(arraysize(kMetricsEntries) == UMA_MAX,
                arraysize_of_kMetricsEntries_should_be_UMA_MAX);
@@ -114,6 +118,10 @@ void ReportLanguageDetectionTime(base::TimeTicks begin, base::TimeTicks end) {
   UMA_HISTOGRAM_MEDIUM_TIMES(kRenderer4LanguageDetection, end - begin);
 }
 
+void ReportLanguageDetectionMainThreadTime(base::TimeDelta time) {
+  UMA_HISTOGRAM_TIMES(kTranslateLanguageDetectionMainThreadTime, time);
+}
+
 void ReportSimilarLanguageMatch(bool match) {
   UMA_HISTOGRAM_BOOLEAN(kTranslateSimilarLanguageMatch, match);
 }
@@ -24,6 +24,7 @@ enum MetricsNameIndex {
   UMA_USER_ACTION_DURATION,
   UMA_PAGE_SCHEME,
   UMA_SIMILAR_LANGUAGE_MATCH,
+  UMA_LANGUAGE_DETECTION_MAIN_THREAD_TIME,
   UMA_MAX,
 };
 
@@ -92,6 +93,10 @@ void ReportPageScheme(const std::string& scheme);
 // Called when CLD detects page language.
 void ReportLanguageDetectionTime(base::TimeTicks begin, base::TimeTicks end);
 
+// Called when the page language is determined, with the time the renderer
+// main thread spent on it. CLD itself runs on a worker thread.
+void ReportLanguageDetectionMainThreadTime(base::TimeDelta time);
+
 // Called when CLD agreed on a language which is different, but in the similar
 // language list.
 void ReportSimilarLanguageMatch(bool match);
@@ -282,3 +282,13 @@ TEST(TranslateMetricsTest, ReportLanguageDetectionTime) {
   recorder.CheckValueInLogs(9.009);
   recorder.CheckTotalCount(1);
 }
+
+TEST(TranslateMetricsTest, ReportLanguageDetectionMainThreadTime) {
+  MetricsRecorder recorder(translate::GetMetricsName(
+      translate::UMA_LANGUAGE_DETECTION_MAIN_THREAD_TIME));
+  recorder.CheckTotalCount(0);
+  translate::ReportLanguageDetectionMainThreadTime(
+      base::TimeDelta::FromMicroseconds(2500));
+  recorder.CheckValueInLogs(2.5);
+  recorder.CheckTotalCount(1);
+}
@@ -4,11 +4,14 @@
 
 #include "components/translate/language_detection/language_detection_util.h"
 
+#include <algorithm>
+
 #include "base/logging.h"
 #include "base/metrics/field_trial.h"
 #include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/third_party/icu/icu_utf.h"
 #include "base/time/time.h"
 #include "components/translate/core/common/translate_constants.h"
 #include "components/translate/core/common/translate_metrics.h"
@@ -25,6 +28,17 @@
 
 namespace {
 
+// The most characters of a page that CLD looks at. Beyond a few thousand
+// characters CLD rarely changes its mind, while its cost keeps growing.
+const size_t kMaxDetectionChars = 16 * 1024;
+
+// The size of each chunk sampled from a page for CLD.
+const size_t kDetectionChunkChars = 1024;
+
+// How many characters of the sample CLD looks at first. If CLD is not
+// confident, it looks at twice as many, until it has seen the whole sample.
+const size_t kFirstDetectionChars = 2 * 1024;
+
 // Similar language code list. Some languages are very similar and difficult
 // for CLD to distinguish.
 struct SimilarLanguageCode {
@@ -85,8 +99,8 @@ int GetCLDMajorVersion() {
 // Returns the ISO 639 language code of the specified |text|, or 'unknown' if it
 // failed.
 // |is_cld_reliable| will be set as true if CLD says the detection is reliable.
-std::string DetermineTextLanguage(const base::string16& text,
-                                  bool* is_cld_reliable) {
+std::string DetectTextLanguage(const base::string16& text,
+                               bool* is_cld_reliable) {
   std::string language = translate::kUnknownLanguageCode;
   int text_bytes = 0;
   bool is_reliable = false;
@@ -180,6 +194,28 @@ std::string DetermineTextLanguage(const base::string16& text,
   return language;
 }
 
+// Same as DetectTextLanguage(), but only looks at a sample of at most
+// |kMaxDetectionChars| of |text|, and stops at the first part of the sample
+// CLD is confident about.
+std::string DetermineTextLanguage(const base::string16& text,
+                                  bool* is_cld_reliable) {
+  base::string16 sample = translate::SampleTextForLanguageDetection(
+      text, kMaxDetectionChars, kDetectionChunkChars);
+  for (size_t length = kFirstDetectionChars;; length *= 2) {
+    if (length >= sample.size())
+      return DetectTextLanguage(sample, is_cld_reliable);
+
+    // Don't split a surrogate pair.
+    if (CBU16_IS_LEAD(sample[length - 1]))
+      --length;
+    std::string language =
+        DetectTextLanguage(sample.substr(0, length), is_cld_reliable);
+    // DetectTextLanguage() only returns a language when CLD is confident.
+    if (language != translate::kUnknownLanguageCode)
+      return language;
+  }
+}
+
 // Checks if CLD can complement a sub code when the page language doesn't know
 // the sub code.
 bool CanCLDComplementSubCode(
@@ -195,6 +231,49 @@ bool CanCLDComplementSubCode(
 
 namespace translate {
 
+base::string16 SampleTextForLanguageDetection(const base::string16& text,
+                                              size_t max_chars,
+                                              size_t chunk_chars) {
+  if (text.size() <= max_chars)
+    return text;
+  DCHECK_GT(max_chars, 0u);
+  DCHECK_GT(chunk_chars, 0u);
+
+  const size_t chunk = std::min(chunk_chars, max_chars);
+  const size_t num_chunks = max_chars / chunk;
+  const size_t stride = text.size() / num_chunks;
+  base::string16 sample;
+  sample.reserve(max_chars + num_chunks);
+  for (size_t i = 0; i < num_chunks; ++i) {
+    size_t begin = i * stride;
+    size_t end = std::min(begin + chunk, text.size());
+
+    // Don't cut words in half, unless the text has no whitespace to cut at,
+    // as in Chinese or Japanese.
+    if (begin > 0) {
+      size_t space = text.find_first_of(base::kWhitespaceUTF16, begin);
+      if (space != base::string16::npos && space + 1 < end)
+        begin = space + 1;
+    }
+    if (end < text.size()) {
+      size_t space = text.find_last_of(base::kWhitespaceUTF16, end);
+      if (space != base::string16::npos && space > begin)
+        end = space;
+    }
+
+    // Nor surrogate pairs.
+    if (begin < end && CBU16_IS_TRAIL(text[begin]))
+      ++begin;
+    if (begin < end && CBU16_IS_LEAD(text[end - 1]))
+      --end;
+
+    if (!sample.empty())
+      sample.push_back(' ');
+    sample.append(text, begin, end - begin);
+  }
+  return sample;
+}
+
 std::string DeterminePageLanguage(const std::string& code,
                                   const std::string& html_lang,
                                   const base::string16& contents,
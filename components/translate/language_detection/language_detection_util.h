@@ -12,12 +12,23 @@
 namespace translate {
 
 // Determines content page language from Content-Language code and contents.
+// Only a sample of |contents| is looked at, so this takes at most a few
+// milliseconds. It does not touch any page state, so it can be called on any
+// thread.
 std::string DeterminePageLanguage(const std::string& code,
                                   const std::string& html_lang,
                                   const base::string16& contents,
                                   std::string* cld_language,
                                   bool* is_cld_reliable);
 
+// Returns at most about |max_chars| characters of |text| to detect its language
+// from: all of it if it is short enough, or else chunks of |chunk_chars|
+// characters spread evenly over it, cut at whitespace where possible.
+// Called only by tests and DeterminePageLanguage().
+base::string16 SampleTextForLanguageDetection(const base::string16& text,
+                                              size_t max_chars,
+                                              size_t chunk_chars);
+
 // Corrects language code if it contains well-known mistakes.
 // Called only by tests.
 void CorrectLanguageCodeTypo(std::string* code);
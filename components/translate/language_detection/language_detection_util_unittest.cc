@@ -5,6 +5,8 @@
 #include "components/translate/language_detection/language_detection_util.h"
 
 #include "base/strings/string16.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
 #include "base/strings/utf_string_conversions.h"
 #include "components/translate/core/common/translate_constants.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -171,3 +173,86 @@ TEST_F(LanguageDetectionUtilTest, AdoptHtmlLang) {
   EXPECT_EQ("en", cld_language);
   EXPECT_TRUE(is_cld_reliable);
 }
+
+// Tests that short texts are looked at as a whole.
+TEST_F(LanguageDetectionUtilTest, SampleShortText) {
+  base::string16 text = base::ASCIIToUTF16("A short page.");
+  EXPECT_EQ(text, translate::SampleTextForLanguageDetection(text, 100, 10));
+}
+
+// Tests that long texts are sampled from beginning to end, without cutting
+// words in half.
+TEST_F(LanguageDetectionUtilTest, SampleLongText) {
+  base::string16 text;
+  for (int i = 0; i < 10000; ++i) {
+    if (i)
+      text.push_back(' ');
+    text += base::IntToString16(i);
+  }
+
+  base::string16 sample =
+      translate::SampleTextForLanguageDetection(text, 1000, 100);
+  EXPECT_LE(sample.size(), 1010u);
+  EXPECT_GE(sample.size(), 900u);
+
+  std::vector<base::string16> words;
+  base::SplitString(sample, ' ', &words);
+  int first_word = -1;
+  int last_word = -1;
+  for (size_t i = 0; i < words.size(); ++i) {
+    int word = -1;
+    ASSERT_TRUE(base::StringToInt(words[i], &word)) << words[i];
+    ASSERT_GT(word, last_word);
+    if (i == 0)
+      first_word = word;
+    last_word = word;
+  }
+  EXPECT_EQ(0, first_word);
+  EXPECT_GT(last_word, 8500);
+}
+
+// Tests that texts without whitespace, as in Chinese or Japanese, are sampled
+// too, without splitting surrogate pairs.
+TEST_F(LanguageDetectionUtilTest, SampleTextWithoutWhitespace) {
+  base::string16 text;
+  for (int i = 0; i < 5000; ++i) {
+    // U+20000, a CJK ideograph outside the Basic Multilingual Plane.
+    text.push_back(0xD840);
+    text.push_back(0xDC00);
+  }
+
+  base::string16 sample =
+      translate::SampleTextForLanguageDetection(text, 1000, 101);
+  EXPECT_LE(sample.size(), 1010u);
+  EXPECT_GE(sample.size(), 900u);
+
+  std::vector<base::string16> chunks;
+  base::SplitString(sample, ' ', &chunks);
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    ASSERT_EQ(0u, chunks[i].size() % 2);
+    for (size_t j = 0; j < chunks[i].size(); j += 2) {
+      EXPECT_EQ(0xD840, chunks[i][j]);
+      EXPECT_EQ(0xDC00, chunks[i][j + 1]);
+    }
+  }
+}
+
+// Tests that the language of a long page is still detected from its sample.
+TEST_F(LanguageDetectionUtilTest, DetectLongPage) {
+  base::string16 contents;
+  for (int i = 0; i < 1000; ++i) {
+    contents += base::ASCIIToUTF16(
+        "This is a long page apparently written in English, long enough that "
+        "only a sample of it is looked at. ");
+  }
+  std::string cld_language;
+  bool is_cld_reliable;
+  std::string language = translate::DeterminePageLanguage(std::string(),
+                                                          std::string(),
+                                                          contents,
+                                                          &cld_language,
+                                                          &is_cld_reliable);
+  EXPECT_EQ("en", language);
+  EXPECT_EQ("en", cld_language);
+  EXPECT_TRUE(is_cld_reliable);
+}
@@ -49,6 +49,12 @@ uint32 TreeSize(const std::vector<const StringPattern*>& patterns) {
   return result;
 }
 
+// Orders the edges of an Aho-Corasick node by their labels.
+bool CompareEdgeLabels(const std::pair<char, uint32>& a,
+                       const std::pair<char, uint32>& b) {
+  return a.first < b.first;
+}
+
 }  // namespace
 
 //
@@ -123,8 +129,14 @@ bool SubstringSetMatcher::Match(const std::string& text,
     }
     if (edge_from_current != AhoCorasickNode::kNoSuchEdge) {
       current_node = edge_from_current;
-      matches->insert(tree_[current_node].matches().begin(),
-                      tree_[current_node].matches().end());
+      // Report the patterns ending here and in the node's suffixes. The root's
+      // matches were reported above already.
+      for (uint32 node = current_node;
+           node != AhoCorasickNode::kNoSuchEdge && node != 0;
+           node = tree_[node].output_link()) {
+        matches->insert(tree_[node].matches().begin(),
+                        tree_[node].matches().end());
+      }
     } else {
       DCHECK_EQ(0u, current_node);
     }
@@ -199,6 +211,8 @@ void SubstringSetMatcher::CreateFailureEdges() {
        ++e) {
     const uint32& leads_to = e->second;
     tree_[leads_to].set_failure(0);
+    // Matches of the root are reported separately.
+    tree_[leads_to].set_output_link(AhoCorasickNode::kNoSuchEdge);
     queue.push(leads_to);
   }
 
@@ -224,7 +238,11 @@ void SubstringSetMatcher::CreateFailureEdges() {
               ? edge_from_failure
               : 0;
       tree_[leads_to].set_failure(follow_in_case_of_failure);
-      tree_[leads_to].AddMatches(tree_[follow_in_case_of_failure].matches());
+      const AhoCorasickNode& failure_node = tree_[follow_in_case_of_failure];
+      tree_[leads_to].set_output_link(
+          follow_in_case_of_failure != 0 && !failure_node.matches().empty()
+              ? follow_in_case_of_failure
+              : failure_node.output_link());
     }
   }
 }
@@ -232,7 +250,8 @@ void SubstringSetMatcher::CreateFailureEdges() {
 const uint32 SubstringSetMatcher::AhoCorasickNode::kNoSuchEdge = ~0;
 
 SubstringSetMatcher::AhoCorasickNode::AhoCorasickNode()
-    : failure_(kNoSuchEdge) {}
+    : failure_(kNoSuchEdge),
+      output_link_(kNoSuchEdge) {}
 
 SubstringSetMatcher::AhoCorasickNode::~AhoCorasickNode() {}
 
@@ -240,6 +259,7 @@ SubstringSetMatcher::AhoCorasickNode::AhoCorasickNode(
     const SubstringSetMatcher::AhoCorasickNode& other)
     : edges_(other.edges_),
       failure_(other.failure_),
+      output_link_(other.output_link_),
       matches_(other.matches_) {}
 
 SubstringSetMatcher::AhoCorasickNode&
@@ -247,26 +267,28 @@ SubstringSetMatcher::AhoCorasickNode::operator=(
     const SubstringSetMatcher::AhoCorasickNode& other) {
   edges_ = other.edges_;
   failure_ = other.failure_;
+  output_link_ = other.output_link_;
   matches_ = other.matches_;
   return *this;
 }
 
 uint32 SubstringSetMatcher::AhoCorasickNode::GetEdge(char c) const {
-  Edges::const_iterator i = edges_.find(c);
-  return i == edges_.end() ? kNoSuchEdge : i->second;
+  Edges::const_iterator i = std::lower_bound(
+      edges_.begin(), edges_.end(), std::make_pair(c, 0u), CompareEdgeLabels);
+  return (i == edges_.end() || i->first != c) ? kNoSuchEdge : i->second;
 }
 
 void SubstringSetMatcher::AhoCorasickNode::SetEdge(char c, uint32 node) {
-  edges_[c] = node;
+  Edges::iterator i = std::lower_bound(
+      edges_.begin(), edges_.end(), std::make_pair(c, 0u), CompareEdgeLabels);
+  if (i != edges_.end() && i->first == c)
+    i->second = node;
+  else
+    edges_.insert(i, std::make_pair(c, node));
 }
 
 void SubstringSetMatcher::AhoCorasickNode::AddMatch(StringPattern::ID id) {
-  matches_.insert(id);
-}
-
-void SubstringSetMatcher::AhoCorasickNode::AddMatches(
-    const SubstringSetMatcher::AhoCorasickNode::Matches& matches) {
-  matches_.insert(matches.begin(), matches.end());
+  matches_.push_back(id);
 }
 
 }  // namespace url_matcher
@@ -79,11 +79,19 @@ class URL_MATCHER_EXPORT SubstringSetMatcher {
   // If your brain thinks "Forget it, let's go shopping.", don't worry.
   // Take a nap and read an introductory text on the Aho Corasick algorithm.
   // It will make sense. Eventually.
+  //
+  // Each node only stores the IDs of the patterns ending in it. The patterns
+  // that end in the suffixes of a node are found through its output link,
+  // which points to the nearest node on its failure path that has matches of
+  // its own. Copying those matches into every node instead would cost memory
+  // proportional to the number of patterns times the depth of the tree.
   class AhoCorasickNode {
    public:
-    // Key: label of the edge, value: node index in |tree_| of parent class.
-    typedef std::map<char, uint32> Edges;
-    typedef std::set<StringPattern::ID> Matches;
+    // Pairs of the label of an edge and the index in |tree_| of the node it
+    // leads to, sorted by label. Most nodes have a single edge, which makes
+    // this much smaller than a map.
+    typedef std::vector<std::pair<char, uint32> > Edges;
+    typedef std::vector<StringPattern::ID> Matches;
 
     static const uint32 kNoSuchEdge;  // Represents an invalid node index.
 
@@ -99,8 +107,11 @@ class URL_MATCHER_EXPORT SubstringSetMatcher {
     uint32 failure() const { return failure_; }
     void set_failure(uint32 failure) { failure_ = failure; }
 
+    // The nearest node on the failure path with matches, or kNoSuchEdge.
+    uint32 output_link() const { return output_link_; }
+    void set_output_link(uint32 node) { output_link_ = node; }
+
     void AddMatch(StringPattern::ID id);
-    void AddMatches(const Matches& matches);
     const Matches& matches() const { return matches_; }
 
    private:
@@ -110,6 +121,9 @@ class URL_MATCHER_EXPORT SubstringSetMatcher {
     // Node index that failure edge leads to.
     uint32 failure_;
 
+    // Node index that output link leads to.
+    uint32 output_link_;
+
     // Identifiers of matches.
     Matches matches_;
   };
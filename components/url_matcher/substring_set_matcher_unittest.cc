@@ -8,6 +8,7 @@
 #include <string>
 #include <vector>
 
+#include "base/memory/scoped_vector.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace url_matcher {
@@ -167,4 +168,37 @@ TEST(SubstringSetMatcherTest, TestEmptyMatcher) {
   EXPECT_TRUE(matches.empty());
 }
 
+// Patterns that are suffixes of each other are reported through the chain of
+// output links; make sure none of them gets lost, including those that only
+// occur in the middle of a longer pattern.
+TEST(SubstringSetMatcherTest, TestNestedSuffixes) {
+  const char* const kPatterns[] = {
+    "a", "ba", "cba", "dcba", "xa", "bxa", "c", "dc", "", "edcbaf"
+  };
+  const char* const kTexts[] = {
+    "dcba", "edcbaf", "xxa", "bxa", "zzzz", "dc", "abcd", ""
+  };
+
+  ScopedVector<StringPattern> owned_patterns;
+  std::vector<const StringPattern*> patterns;
+  for (size_t i = 0; i < arraysize(kPatterns); ++i) {
+    owned_patterns.push_back(new StringPattern(kPatterns[i], i));
+    patterns.push_back(owned_patterns.back());
+  }
+  SubstringSetMatcher matcher;
+  matcher.RegisterPatterns(patterns);
+
+  for (size_t t = 0; t < arraysize(kTexts); ++t) {
+    const std::string text(kTexts[t]);
+    std::set<int> expected;
+    for (size_t i = 0; i < arraysize(kPatterns); ++i) {
+      if (text.find(kPatterns[i]) != std::string::npos)
+        expected.insert(i);
+    }
+    std::set<int> matches;
+    matcher.Match(text, &matches);
+    EXPECT_EQ(expected, matches) << text;
+  }
+}
+
 }  // namespace url_matcher
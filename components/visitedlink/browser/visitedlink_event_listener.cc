@@ -144,7 +144,11 @@ void VisitedLinkEventListener::NewTable(base::SharedMemory* table_memory) {
 }
 
 void VisitedLinkEventListener::Add(VisitedLinkMaster::Fingerprint fingerprint) {
-  pending_visited_links_.push_back(fingerprint);
+  // Past the threshold every renderer resets its visited state instead of
+  // applying the individual links, so there is no need to keep buffering them
+  // when a large batch is added.
+  if (pending_visited_links_.size() <= kVisitedLinkBufferThreshold)
+    pending_visited_links_.push_back(fingerprint);
 
   if (!coalesce_timer_.IsRunning()) {
     coalesce_timer_.Start(FROM_HERE,
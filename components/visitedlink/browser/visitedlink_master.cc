@@ -53,6 +53,13 @@ const unsigned VisitedLinkMaster::kDefaultTableSize = 16381;
 
 const size_t VisitedLinkMaster::kBigDeleteThreshold = 64;
 
+// Load limits for good performance/space. We are pretty conservative about
+// keeping the table not very full. This is because we use linear probing
+// which increases the likelihood of clumps of entries which will reduce
+// performance.
+const float VisitedLinkMaster::kMaxTableLoad = 0.5f;
+const float VisitedLinkMaster::kMinTableLoad = 0.2f;
+
 namespace {
 
 // Fills the given salt structure with some quasi-random values
@@ -301,15 +308,26 @@ void VisitedLinkMaster::AddURL(const GURL& url) {
 }
 
 void VisitedLinkMaster::AddURLs(const std::vector<GURL>& url) {
-  for (std::vector<GURL>::const_iterator i = url.begin();
-       i != url.end(); ++i) {
-    Hash index = TryToAddURL(*i);
-    if (!table_builder_.get() && index != null_hash_)
-      ResizeTableIfNecessary();
+  // While rebuilding, the table builder takes care of sizing and writing out
+  // the table, so just add the URLs.
+  if (table_builder_.get()) {
+    for (std::vector<GURL>::const_iterator i = url.begin();
+         i != url.end(); ++i)
+      TryToAddURL(*i);
+    return;
   }
 
-  // Keeps the file on disk up-to-date.
-  if (!table_builder_.get() && persist_to_disk_)
+  // Grow the table once for the whole batch rather than as it fills up: each
+  // resize rehashes every entry, writes the table to disk and sends it to all
+  // renderers, so a big batch could otherwise stall on several of them.
+  GrowTableForAdditions(url.size());
+  for (std::vector<GURL>::const_iterator i = url.begin();
+       i != url.end(); ++i)
+    TryToAddURL(*i);
+
+  // Many of the URLs may have been present already, leaving the table too
+  // empty. Resizing writes the file, otherwise keep it up-to-date here.
+  if (!ResizeTableIfNecessary() && persist_to_disk_)
     WriteFullTable();
 }
 
@@ -733,27 +751,32 @@ void VisitedLinkMaster::FreeURLTable() {
 bool VisitedLinkMaster::ResizeTableIfNecessary() {
   DCHECK(table_length_ > 0) << "Must have a table";
 
-  // Load limits for good performance/space. We are pretty conservative about
-  // keeping the table not very full. This is because we use linear probing
-  // which increases the likelihood of clumps of entries which will reduce
-  // performance.
-  const float max_table_load = 0.5f;  // Grow when we're > this full.
-  const float min_table_load = 0.2f;  // Shrink when we're < this full.
-
   float load = ComputeTableLoad();
-  if (load < max_table_load &&
+  if (load < kMaxTableLoad &&
       (table_length_ <= static_cast<float>(kDefaultTableSize) ||
-       load > min_table_load))
+       load > kMinTableLoad))
     return false;
 
   // Table needs to grow or shrink.
   int new_size = NewTableSizeForCount(used_items_);
   DCHECK(new_size > used_items_);
-  DCHECK(load <= min_table_load || new_size > table_length_);
+  DCHECK(load <= kMinTableLoad || new_size > table_length_);
   ResizeTable(new_size);
   return true;
 }
 
+bool VisitedLinkMaster::GrowTableForAdditions(size_t count) {
+  DCHECK(table_length_ > 0) << "Must have a table";
+
+  int32 expected_items = used_items_ + static_cast<int32>(
+      std::min(count, static_cast<size_t>(kint32max - used_items_)));
+  if (static_cast<float>(expected_items) / table_length_ < kMaxTableLoad)
+    return false;
+
+  ResizeTable(NewTableSizeForCount(expected_items));
+  return true;
+}
+
 void VisitedLinkMaster::ResizeTable(int32 new_size) {
   DCHECK(shared_memory_ && shared_memory_->memory() && hash_table_);
   shared_memory_serial_++;
@@ -182,6 +182,11 @@ class VisitedLinkMaster : public VisitedLinkCommon {
   // When creating a fresh new table, we use this many entries.
   static const unsigned kDefaultTableSize;
 
+  // The table grows when it is more than kMaxTableLoad full, and shrinks when
+  // it is less than kMinTableLoad full.
+  static const float kMaxTableLoad;
+  static const float kMinTableLoad;
+
   // When the user is deleting a boatload of URLs, we don't really want to do
   // individual writes for each of them. When the count exceeds this threshold,
   // we will write the whole table to disk at once instead of individual items.
@@ -299,6 +304,10 @@ class VisitedLinkMaster : public VisitedLinkCommon {
   // current count.
   void ResizeTable(int32 new_size);
 
+  // Grows the table ahead of time so that adding |count| more fingerprints
+  // will not need to resize it. Returns true if the table was resized.
+  bool GrowTableForAdditions(size_t count);
+
   // Returns the desired table size for |item_count| URLs.
   uint32 NewTableSizeForCount(int32 item_count) const;
 
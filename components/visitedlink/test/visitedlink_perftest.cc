@@ -106,6 +106,45 @@ TEST_F(VisitedLink, TestAddAndQuery) {
   CheckVisited(master, unadded_prefix, 0, add_count);
 }
 
+// Tests how long adding links stalls while the table grows, both when they are
+// added one at a time and as a single batch. The table is kept in memory so
+// that only the resizing is measured.
+TEST_F(VisitedLink, TestResizeUnderLoad) {
+  {
+    VisitedLinkMaster master(new DummyVisitedLinkEventListener(),
+                             NULL, false, true, db_path_, 0);
+    ASSERT_TRUE(master.Init());
+
+    TimeDelta total_time;
+    TimeDelta max_time;
+    for (int i = 0; i < load_test_add_count; i++) {
+      base::ElapsedTimer timer;
+      master.AddURL(TestURL(added_prefix, i));
+      TimeDelta elapsed = timer.Elapsed();
+      total_time += elapsed;
+      max_time = std::max(max_time, elapsed);
+    }
+    base::LogPerfResult("Visited_link_add_with_resize_total",
+                        total_time.InMillisecondsF(), "ms");
+    base::LogPerfResult("Visited_link_add_with_resize_max",
+                        max_time.InMillisecondsF(), "ms");
+  }
+
+  {
+    VisitedLinkMaster master(new DummyVisitedLinkEventListener(),
+                             NULL, false, true, db_path_, 0);
+    ASSERT_TRUE(master.Init());
+
+    std::vector<GURL> urls;
+    for (int i = 0; i < load_test_add_count; i++)
+      urls.push_back(TestURL(added_prefix, i));
+
+    base::PerfTimeLogger timer("Visited_link_add_batch_with_resize");
+    master.AddURLs(urls);
+    timer.Done();
+  }
+}
+
 // Tests how long it takes to write and read a large database to and from disk.
 TEST_F(VisitedLink, TestLoad) {
   // create a big DB
@@ -107,9 +107,11 @@ class TrackingVisitedLinkEventListener : public VisitedLinkMaster::Listener {
  public:
   TrackingVisitedLinkEventListener()
       : reset_count_(0),
-        add_count_(0) {}
+        add_count_(0),
+        new_table_count_(0) {}
 
   virtual void NewTable(base::SharedMemory* table) OVERRIDE {
+    new_table_count_++;
     if (table) {
       for (std::vector<VisitedLinkSlave>::size_type i = 0;
            i < g_slaves.size(); i++) {
@@ -125,14 +127,17 @@ class TrackingVisitedLinkEventListener : public VisitedLinkMaster::Listener {
   void SetUp() {
     reset_count_ = 0;
     add_count_ = 0;
+    new_table_count_ = 0;
   }
 
   int reset_count() const { return reset_count_; }
   int add_count() const { return add_count_; }
+  int new_table_count() const { return new_table_count_; }
 
  private:
   int reset_count_;
   int add_count_;
+  int new_table_count_;
 };
 
 class VisitedLinkTest : public testing::Test {
@@ -400,6 +405,31 @@ TEST_F(VisitedLinkTest, Resizing) {
   Reload();
 }
 
+// Tests that adding a batch of URLs to a small table resizes it only once.
+TEST_F(VisitedLinkTest, ResizingBatch) {
+  ASSERT_TRUE(InitVisited(17, true));
+  TrackingVisitedLinkEventListener* listener =
+      static_cast<TrackingVisitedLinkEventListener*>(master_->GetListener());
+  listener->SetUp();
+
+  std::vector<GURL> urls;
+  for (int i = 0; i < g_test_count; i++)
+    urls.push_back(TestURL(i));
+  master_->AddURLs(urls);
+
+  EXPECT_EQ(g_test_count, master_->GetUsedCount());
+  EXPECT_EQ(g_test_count, listener->add_count());
+  EXPECT_EQ(1, listener->new_table_count());
+  master_->DebugValidate();
+
+  // Adding URLs that are already present shouldn't resize again.
+  master_->AddURLs(urls);
+  EXPECT_EQ(g_test_count, master_->GetUsedCount());
+  EXPECT_EQ(1, listener->new_table_count());
+
+  Reload();
+}
+
 // Tests that if the database doesn't exist, it will be rebuilt from history.
 TEST_F(VisitedLinkTest, Rebuild) {
   // Add half of our URLs to history. This needs to be done before we
@@ -6,6 +6,7 @@
 
 #include "base/bind.h"
 #include "base/command_line.h"
+#include "base/debug/sampling_heap_profiler.h"
 #include "base/debug/trace_event.h"
 #include "base/file_util.h"
 #include "base/logging.h"
@@ -111,6 +112,7 @@
 
 #if defined(TCMALLOC_TRACE_MEMORY_SUPPORTED)
 #include "third_party/tcmalloc/chromium/src/gperftools/heap-profiler.h"
+#include "third_party/tcmalloc/chromium/src/gperftools/malloc_hook_c.h"
 #endif
 
 #if defined(USE_X11)
@@ -531,6 +533,12 @@ void BrowserMainLoop::MainMessageLoopStart() {
       ::HeapProfilerWithPseudoStackStart,
       ::HeapProfilerStop,
       ::GetHeapProfile));
+  sampling_heap_profiler_.reset(new base::debug::SamplingHeapProfiler(
+      base::MessageLoop::current()->message_loop_proxy(),
+      ::MallocHook_AddNewHook,
+      ::MallocHook_RemoveNewHook,
+      ::MallocHook_AddDeleteHook,
+      ::MallocHook_RemoveDeleteHook));
 #endif
 }
 
@@ -754,6 +762,7 @@ void BrowserMainLoop::ShutdownThreadsAndCleanUp() {
   }
 
   trace_memory_controller_.reset();
+  sampling_heap_profiler_.reset();
   system_stats_monitor_.reset();
 
 #if !defined(OS_IOS)
@@ -19,6 +19,7 @@ class MessageLoop;
 class PowerMonitor;
 class SystemMonitor;
 namespace debug {
+class SamplingHeapProfiler;
 class TraceMemoryController;
 class TraceEventSystemStatsMonitor;
 }  // namespace debug
@@ -182,6 +183,7 @@ class CONTENT_EXPORT BrowserMainLoop {
   scoped_ptr<base::Thread> indexed_db_thread_;
   scoped_ptr<MemoryObserver> memory_observer_;
   scoped_ptr<base::debug::TraceMemoryController> trace_memory_controller_;
+  scoped_ptr<base::debug::SamplingHeapProfiler> sampling_heap_profiler_;
   scoped_ptr<base::debug::TraceEventSystemStatsMonitor> system_stats_monitor_;
 
   bool is_tracing_startup_;
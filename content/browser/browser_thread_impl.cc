@@ -14,6 +14,7 @@
 #include "base/message_loop/message_loop_proxy.h"
 #include "base/threading/sequenced_worker_pool.h"
 #include "base/threading/thread_restrictions.h"
+#include "content/browser/browser_thread_task_monitor.h"
 #include "content/public/browser/browser_thread_delegate.h"
 
 namespace content {
@@ -31,6 +32,21 @@ static const char* g_browser_thread_names[BrowserThread::ID_COUNT] = {
   "Chrome_IOThread",  // IO
 };
 
+// Suffixes of the histograms of BrowserThreadTaskMonitor.
+static const char* g_browser_thread_histogram_names[BrowserThread::ID_COUNT] = {
+  "UI",
+  "DB",
+  "FILE",
+  "FILE_USER_BLOCKING",
+  "PROCESS_LAUNCHER",
+  "CACHE",
+  "IO",
+};
+
+// Tasks that take longer than this from being due to finishing are flagged
+// by BrowserThreadTaskMonitor.
+const int kLongTaskThresholdMs = 50;
+
 struct BrowserThreadGlobals {
   BrowserThreadGlobals()
       : blocking_pool(new base::SequencedWorkerPool(3, "BrowserBlocking")) {
@@ -96,6 +112,11 @@ void BrowserThreadImpl::FlushThreadPoolHelper() {
 void BrowserThreadImpl::Init() {
   BrowserThreadGlobals& globals = g_globals.Get();
 
+  task_monitor_.reset(new BrowserThreadTaskMonitor(
+      g_browser_thread_histogram_names[identifier_],
+      base::TimeDelta::FromMilliseconds(kLongTaskThresholdMs)));
+  message_loop()->AddTaskObserver(task_monitor_.get());
+
   using base::subtle::AtomicWord;
   AtomicWord* storage =
       reinterpret_cast<AtomicWord*>(&globals.thread_delegates[identifier_]);
@@ -205,6 +226,9 @@ void BrowserThreadImpl::CleanUp() {
 
   if (delegate)
     delegate->CleanUp();
+
+  message_loop()->RemoveTaskObserver(task_monitor_.get());
+  task_monitor_.reset();
 }
 
 void BrowserThreadImpl::Initialize() {
@@ -5,12 +5,15 @@
 #ifndef CONTENT_BROWSER_BROWSER_THREAD_IMPL_H_
 #define CONTENT_BROWSER_BROWSER_THREAD_IMPL_H_
 
+#include "base/memory/scoped_ptr.h"
 #include "base/threading/thread.h"
 #include "content/common/content_export.h"
 #include "content/public/browser/browser_thread.h"
 
 namespace content {
 
+class BrowserThreadTaskMonitor;
+
 class CONTENT_EXPORT BrowserThreadImpl : public BrowserThread,
                                          public base::Thread {
  public:
@@ -66,6 +69,10 @@ class CONTENT_EXPORT BrowserThreadImpl : public BrowserThread,
   // The identifier of this thread.  Only one thread can exist with a given
   // identifier at a given time.
   ID identifier_;
+
+  // Records the queueing delay and run time of the tasks of this thread.
+  // Only set while the thread runs, so not for the UI thread.
+  scoped_ptr<BrowserThreadTaskMonitor> task_monitor_;
 };
 
 }  // namespace content
@@ -0,0 +1,81 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/browser_thread_task_monitor.h"
+
+#include <algorithm>
+
+#include "base/debug/trace_event.h"
+#include "base/logging.h"
+#include "base/metrics/histogram.h"
+#include "base/pending_task.h"
+
+namespace content {
+
+namespace {
+
+base::HistogramBase* GetTimeHistogram(const std::string& name) {
+  return base::Histogram::FactoryTimeGet(
+      name,
+      base::TimeDelta::FromMilliseconds(1),
+      base::TimeDelta::FromSeconds(10),
+      50,
+      base::HistogramBase::kUmaTargetedHistogramFlag);
+}
+
+}  // namespace
+
+BrowserThreadTaskMonitor::BrowserThreadTaskMonitor(
+    const std::string& thread_name,
+    base::TimeDelta long_task_threshold)
+    : long_task_threshold_(long_task_threshold),
+      queueing_delay_histogram_(
+          GetTimeHistogram("BrowserThread.QueueingDelay." + thread_name)),
+      run_time_histogram_(
+          GetTimeHistogram("BrowserThread.RunTime." + thread_name)),
+      long_task_histogram_(base::BooleanHistogram::FactoryGet(
+          "BrowserThread.LongTask." + thread_name,
+          base::HistogramBase::kUmaTargetedHistogramFlag)) {
+}
+
+BrowserThreadTaskMonitor::~BrowserThreadTaskMonitor() {
+}
+
+void BrowserThreadTaskMonitor::WillProcessTask(
+    const base::PendingTask& pending_task) {
+  // A delayed task only starts queueing once its delay has passed.
+  base::TimeTicks due_time = pending_task.delayed_run_time.is_null() ?
+      pending_task.time_posted : pending_task.delayed_run_time;
+  RunningTask task;
+  task.start_time = base::TimeTicks::Now();
+  task.queueing_delay = std::max(task.start_time - due_time,
+                                 base::TimeDelta());
+  running_tasks_.push_back(task);
+  queueing_delay_histogram_->AddTime(task.queueing_delay);
+}
+
+void BrowserThreadTaskMonitor::DidProcessTask(
+    const base::PendingTask& pending_task) {
+  // The monitor may have been added while a task was running.
+  if (running_tasks_.empty())
+    return;
+  RunningTask task = running_tasks_.back();
+  running_tasks_.pop_back();
+  base::TimeDelta run_time = base::TimeTicks::Now() - task.start_time;
+  run_time_histogram_->AddTime(run_time);
+
+  bool is_long = task.queueing_delay + run_time > long_task_threshold_;
+  long_task_histogram_->AddBoolean(is_long);
+  if (!is_long)
+    return;
+  TRACE_EVENT_INSTANT2("browser", "BrowserThreadTaskMonitor::LongTask",
+                       TRACE_EVENT_SCOPE_THREAD,
+                       "src_file", pending_task.posted_from.file_name(),
+                       "src_func", pending_task.posted_from.function_name());
+  DVLOG(1) << "Task from " << pending_task.posted_from.ToString()
+           << " waited " << task.queueing_delay.InMillisecondsF()
+           << " ms and ran " << run_time.InMillisecondsF() << " ms";
+}
+
+}  // namespace content
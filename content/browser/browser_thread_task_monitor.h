@@ -0,0 +1,60 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CONTENT_BROWSER_BROWSER_THREAD_TASK_MONITOR_H_
+#define CONTENT_BROWSER_BROWSER_THREAD_TASK_MONITOR_H_
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/compiler_specific.h"
+#include "base/message_loop/message_loop.h"
+#include "base/time/time.h"
+#include "content/common/content_export.h"
+
+namespace base {
+class HistogramBase;
+}
+
+namespace content {
+
+// Records how long the tasks of a thread wait in its queue and how long they
+// run, in the histograms BrowserThread.QueueingDelay.<name> and
+// BrowserThread.RunTime.<name>. Tasks that take longer than a threshold from
+// being due to finishing are counted in BrowserThread.LongTask.<name> and
+// traced with their posting location. tracked_objects keeps the same
+// durations per posting location for about:profiler.
+class CONTENT_EXPORT BrowserThreadTaskMonitor
+    : public base::MessageLoop::TaskObserver {
+ public:
+  BrowserThreadTaskMonitor(const std::string& thread_name,
+                           base::TimeDelta long_task_threshold);
+  virtual ~BrowserThreadTaskMonitor();
+
+  // base::MessageLoop::TaskObserver implementation.
+  virtual void WillProcessTask(const base::PendingTask& pending_task) OVERRIDE;
+  virtual void DidProcessTask(const base::PendingTask& pending_task) OVERRIDE;
+
+ private:
+  struct RunningTask {
+    base::TimeTicks start_time;
+    base::TimeDelta queueing_delay;
+  };
+
+  const base::TimeDelta long_task_threshold_;
+  base::HistogramBase* queueing_delay_histogram_;
+  base::HistogramBase* run_time_histogram_;
+  base::HistogramBase* long_task_histogram_;
+
+  // The tasks that have started but not finished. There is more than one
+  // when a task runs a nested message loop.
+  std::vector<RunningTask> running_tasks_;
+
+  DISALLOW_COPY_AND_ASSIGN(BrowserThreadTaskMonitor);
+};
+
+}  // namespace content
+
+#endif  // CONTENT_BROWSER_BROWSER_THREAD_TASK_MONITOR_H_
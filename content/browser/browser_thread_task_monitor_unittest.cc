@@ -0,0 +1,117 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/browser_thread_task_monitor.h"
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/message_loop/message_loop.h"
+#include "base/metrics/histogram.h"
+#include "base/metrics/histogram_samples.h"
+#include "base/metrics/statistics_recorder.h"
+#include "base/threading/platform_thread.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace content {
+
+namespace {
+
+const int kSleepMs = 20;
+
+void Sleep() {
+  base::PlatformThread::Sleep(base::TimeDelta::FromMilliseconds(kSleepMs));
+}
+
+void RunNestedLoop() {
+  base::MessageLoop::ScopedNestableTaskAllower allow(
+      base::MessageLoop::current());
+  base::MessageLoop::current()->RunUntilIdle();
+}
+
+scoped_ptr<base::HistogramSamples> GetSamples(const std::string& name) {
+  base::HistogramBase* histogram =
+      base::StatisticsRecorder::FindHistogram(name);
+  if (!histogram)
+    return scoped_ptr<base::HistogramSamples>();
+  return histogram->SnapshotSamples();
+}
+
+}  // namespace
+
+class BrowserThreadTaskMonitorTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    base::StatisticsRecorder::Initialize();
+  }
+
+  virtual void TearDown() OVERRIDE {
+    if (monitor_)
+      message_loop_.RemoveTaskObserver(monitor_.get());
+  }
+
+  void StartMonitor(const std::string& name, base::TimeDelta threshold) {
+    monitor_.reset(new BrowserThreadTaskMonitor(name, threshold));
+    message_loop_.AddTaskObserver(monitor_.get());
+  }
+
+  base::MessageLoop message_loop_;
+  scoped_ptr<BrowserThreadTaskMonitor> monitor_;
+};
+
+TEST_F(BrowserThreadTaskMonitorTest, RecordsQueueingDelayAndRunTime) {
+  StartMonitor("Test1", base::TimeDelta::FromMilliseconds(kSleepMs));
+  message_loop_.PostTask(FROM_HERE, base::Bind(&Sleep));
+  // The task waits while this sleeps, then takes as long again to run.
+  Sleep();
+  message_loop_.RunUntilIdle();
+
+  scoped_ptr<base::HistogramSamples> queueing_delay =
+      GetSamples("BrowserThread.QueueingDelay.Test1");
+  ASSERT_TRUE(queueing_delay);
+  EXPECT_EQ(1, queueing_delay->TotalCount());
+  EXPECT_GE(queueing_delay->sum(), kSleepMs);
+
+  scoped_ptr<base::HistogramSamples> run_time =
+      GetSamples("BrowserThread.RunTime.Test1");
+  ASSERT_TRUE(run_time);
+  EXPECT_EQ(1, run_time->TotalCount());
+  EXPECT_GE(run_time->sum(), kSleepMs);
+
+  scoped_ptr<base::HistogramSamples> long_task =
+      GetSamples("BrowserThread.LongTask.Test1");
+  ASSERT_TRUE(long_task);
+  EXPECT_EQ(0, long_task->GetCount(0));
+  EXPECT_EQ(1, long_task->GetCount(1));
+}
+
+TEST_F(BrowserThreadTaskMonitorTest, ShortTaskIsNotLong) {
+  StartMonitor("Test2", base::TimeDelta::FromHours(1));
+  message_loop_.PostTask(FROM_HERE, base::Bind(&Sleep));
+  message_loop_.RunUntilIdle();
+
+  scoped_ptr<base::HistogramSamples> long_task =
+      GetSamples("BrowserThread.LongTask.Test2");
+  ASSERT_TRUE(long_task);
+  EXPECT_EQ(1, long_task->GetCount(0));
+  EXPECT_EQ(0, long_task->GetCount(1));
+}
+
+// Nested tasks are timed separately from the task that runs them.
+TEST_F(BrowserThreadTaskMonitorTest, NestedTasks) {
+  StartMonitor("Test3", base::TimeDelta::FromHours(1));
+  message_loop_.PostTask(FROM_HERE, base::Bind(&Sleep));
+  message_loop_.PostTask(FROM_HERE, base::Bind(&RunNestedLoop));
+  message_loop_.PostTask(FROM_HERE, base::Bind(&Sleep));
+  message_loop_.RunUntilIdle();
+
+  scoped_ptr<base::HistogramSamples> run_time =
+      GetSamples("BrowserThread.RunTime.Test3");
+  ASSERT_TRUE(run_time);
+  EXPECT_EQ(3, run_time->TotalCount());
+}
+
+}  // namespace content
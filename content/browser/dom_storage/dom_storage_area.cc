@@ -4,6 +4,8 @@
 
 #include "content/browser/dom_storage/dom_storage_area.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/location.h"
 #include "base/logging.h"
@@ -25,13 +27,47 @@ using webkit_database::DatabaseUtil;
 
 namespace content {
 
+// Changes are batched up for at least this long before being committed.
 static const int kCommitTimerSeconds = 1;
 
+// Areas that are written to continuously are committed less often, so that
+// the values that keep changing are written once per batch rather than once
+// per second. Sites staying under these rates never wait longer than
+// kCommitTimerSeconds.
+static const size_t kMaxCommitsPerHour = 60;
+static const size_t kMaxBytesPerHour = kPerStorageAreaQuota;
+
+DOMStorageArea::RateLimiter::RateLimiter(size_t desired_rate,
+                                         base::TimeDelta time_quantum)
+    : rate_(desired_rate), samples_(0), time_quantum_(time_quantum) {
+  DCHECK_GT(desired_rate, 0u);
+}
+
+base::TimeDelta DOMStorageArea::RateLimiter::ComputeDelayNeeded(
+    base::TimeDelta elapsed_time) const {
+  base::TimeDelta time_needed = base::TimeDelta::FromMicroseconds(
+      static_cast<int64>(time_quantum_.InMicroseconds() *
+                         (static_cast<double>(samples_) / rate_)));
+  if (time_needed > elapsed_time)
+    return time_needed - elapsed_time;
+  return base::TimeDelta();
+}
+
 DOMStorageArea::CommitBatch::CommitBatch()
   : clear_all_first(false) {
 }
 DOMStorageArea::CommitBatch::~CommitBatch() {}
 
+size_t DOMStorageArea::CommitBatch::GetDataSize() const {
+  size_t count = 0;
+  DOMStorageValuesMap::const_iterator it = changed_values.begin();
+  for (; it != changed_values.end(); ++it) {
+    count += (it->first.length() + it->second.string().length()) *
+             sizeof(base::char16);
+  }
+  return count;
+}
+
 
 // static
 const base::FilePath::CharType DOMStorageArea::kDatabaseFileExtension[] =
@@ -65,7 +101,10 @@ DOMStorageArea::DOMStorageArea(
                              kPerStorageAreaOverQuotaAllowance)),
       is_initial_import_done_(true),
       is_shutdown_(false),
-      commit_batches_in_flight_(0) {
+      commit_batches_in_flight_(0),
+      start_time_(base::TimeTicks::Now()),
+      commit_rate_limiter_(kMaxCommitsPerHour, base::TimeDelta::FromHours(1)),
+      data_rate_limiter_(kMaxBytesPerHour, base::TimeDelta::FromHours(1)) {
   if (!directory.empty()) {
     base::FilePath path = directory.Append(DatabaseFileNameFromOrigin(origin_));
     backing_.reset(new LocalStorageDatabaseAdapter(path));
@@ -88,7 +127,10 @@ DOMStorageArea::DOMStorageArea(
       session_storage_backing_(session_storage_backing),
       is_initial_import_done_(true),
       is_shutdown_(false),
-      commit_batches_in_flight_(0) {
+      commit_batches_in_flight_(0),
+      start_time_(base::TimeTicks::Now()),
+      commit_rate_limiter_(kMaxCommitsPerHour, base::TimeDelta::FromHours(1)),
+      data_rate_limiter_(kMaxBytesPerHour, base::TimeDelta::FromHours(1)) {
   DCHECK(namespace_id != kLocalStorageNamespaceId);
   if (session_storage_backing) {
     backing_.reset(new SessionStorageDatabaseAdapter(
@@ -107,6 +149,13 @@ void DOMStorageArea::ExtractValues(DOMStorageValuesMap* map) {
   map_->ExtractValues(map);
 }
 
+base::SharedMemory* DOMStorageArea::GetValuesSnapshot(size_t* size) {
+  if (is_shutdown_)
+    return NULL;
+  InitialImportIfNeeded();
+  return map_->GetSnapshot(size);
+}
+
 unsigned DOMStorageArea::Length() {
   if (is_shutdown_)
     return 0;
@@ -329,12 +378,20 @@ DOMStorageArea::CommitBatch* DOMStorageArea::CreateCommitBatchIfNeeded() {
       task_runner_->PostDelayedTask(
           FROM_HERE,
           base::Bind(&DOMStorageArea::OnCommitTimer, this),
-          base::TimeDelta::FromSeconds(kCommitTimerSeconds));
+          ComputeCommitDelay());
     }
   }
   return commit_batch_.get();
 }
 
+base::TimeDelta DOMStorageArea::ComputeCommitDelay() const {
+  base::TimeDelta elapsed_time = base::TimeTicks::Now() - start_time_;
+  return std::max(
+      base::TimeDelta::FromSeconds(kCommitTimerSeconds),
+      std::max(commit_rate_limiter_.ComputeDelayNeeded(elapsed_time),
+               data_rate_limiter_.ComputeDelayNeeded(elapsed_time)));
+}
+
 void DOMStorageArea::OnCommitTimer() {
   if (is_shutdown_)
     return;
@@ -349,6 +406,8 @@ void DOMStorageArea::OnCommitTimer() {
   // This method executes on the primary sequence, we schedule
   // a task for immediate execution on the commit sequence.
   DCHECK(task_runner_->IsRunningOnPrimarySequence());
+  commit_rate_limiter_.add_samples(1);
+  data_rate_limiter_.add_samples(commit_batch_->GetDataSize());
   bool success = task_runner_->PostShutdownBlockingTask(
       FROM_HERE,
       DOMStorageTaskRunner::COMMIT_SEQUENCE,
@@ -381,7 +440,7 @@ void DOMStorageArea::OnCommitComplete() {
     task_runner_->PostDelayedTask(
         FROM_HERE,
         base::Bind(&DOMStorageArea::OnCommitTimer, this),
-        base::TimeDelta::FromSeconds(kCommitTimerSeconds));
+        ComputeCommitDelay());
   }
 }
 
@@ -11,10 +11,15 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/strings/nullable_string16.h"
 #include "base/strings/string16.h"
+#include "base/time/time.h"
 #include "content/common/content_export.h"
 #include "content/common/dom_storage/dom_storage_types.h"
 #include "url/gurl.h"
 
+namespace base {
+class SharedMemory;
+}
+
 namespace content {
 
 class DOMStorageDatabaseAdapter;
@@ -51,6 +56,10 @@ class CONTENT_EXPORT DOMStorageArea
   // Writes a copy of the current set of values in the area to the |map|.
   void ExtractValues(DOMStorageValuesMap* map);
 
+  // Returns a read-only snapshot of the values in the area, see
+  // DOMStorageMap::GetSnapshot(). Areas sharing a map share its snapshot.
+  base::SharedMemory* GetValuesSnapshot(size_t* size);
+
   unsigned Length();
   base::NullableString16 Key(unsigned index);
   base::NullableString16 GetItem(const base::string16& key);
@@ -92,14 +101,36 @@ class CONTENT_EXPORT DOMStorageArea
   FRIEND_TEST_ALL_PREFIXES(DOMStorageAreaTest, CommitChangesAtShutdown);
   FRIEND_TEST_ALL_PREFIXES(DOMStorageAreaTest, DeleteOrigin);
   FRIEND_TEST_ALL_PREFIXES(DOMStorageAreaTest, PurgeMemory);
+  FRIEND_TEST_ALL_PREFIXES(DOMStorageAreaTest, RateLimiter);
   FRIEND_TEST_ALL_PREFIXES(DOMStorageContextImplTest, PersistentIds);
   friend class base::RefCountedThreadSafe<DOMStorageArea>;
 
+  // Tracks an amount of work, such as commits or bytes written, against
+  // a desired rate of work per |time_quantum|.
+  class CONTENT_EXPORT RateLimiter {
+   public:
+    RateLimiter(size_t desired_rate, base::TimeDelta time_quantum);
+
+    void add_samples(size_t samples) { samples_ += samples; }
+
+    // Returns how long to wait, |elapsed_time| after the limiter was
+    // created, before doing more work so as to stay within the rate.
+    base::TimeDelta ComputeDelayNeeded(base::TimeDelta elapsed_time) const;
+
+   private:
+    size_t rate_;
+    size_t samples_;
+    base::TimeDelta time_quantum_;
+  };
+
   struct CommitBatch {
     bool clear_all_first;
     DOMStorageValuesMap changed_values;
     CommitBatch();
     ~CommitBatch();
+
+    // The number of bytes this batch writes.
+    size_t GetDataSize() const;
   };
 
   ~DOMStorageArea();
@@ -113,6 +144,7 @@ class CONTENT_EXPORT DOMStorageArea
   // disk on the commit sequence, and to call back on the primary
   // task sequence when complete.
   CommitBatch* CreateCommitBatchIfNeeded();
+  base::TimeDelta ComputeCommitDelay() const;
   void OnCommitTimer();
   void CommitChanges(const CommitBatch* commit_batch);
   void OnCommitComplete();
@@ -131,6 +163,9 @@ class CONTENT_EXPORT DOMStorageArea
   bool is_shutdown_;
   scoped_ptr<CommitBatch> commit_batch_;
   int commit_batches_in_flight_;
+  base::TimeTicks start_time_;
+  RateLimiter commit_rate_limiter_;
+  RateLimiter data_rate_limiter_;
 };
 
 }  // namespace content
@@ -426,6 +426,37 @@ TEST_F(DOMStorageAreaTest, PurgeMemory) {
   EXPECT_NE(original_map, area->map_.get());
 }
 
+TEST_F(DOMStorageAreaTest, RateLimiter) {
+  // Limit to 10 samples per hour.
+  DOMStorageArea::RateLimiter rate_limiter(10, base::TimeDelta::FromHours(1));
+
+  // No samples have been added so no delay should be needed.
+  EXPECT_EQ(base::TimeDelta(),
+            rate_limiter.ComputeDelayNeeded(base::TimeDelta()));
+  EXPECT_EQ(base::TimeDelta(),
+            rate_limiter.ComputeDelayNeeded(base::TimeDelta::FromMinutes(1)));
+
+  // Add 5 samples, which is half the hourly allowance.
+  rate_limiter.add_samples(5);
+  EXPECT_EQ(base::TimeDelta::FromMinutes(30),
+            rate_limiter.ComputeDelayNeeded(base::TimeDelta()));
+  EXPECT_EQ(base::TimeDelta::FromMinutes(20),
+            rate_limiter.ComputeDelayNeeded(base::TimeDelta::FromMinutes(10)));
+  EXPECT_EQ(base::TimeDelta(),
+            rate_limiter.ComputeDelayNeeded(base::TimeDelta::FromMinutes(30)));
+  EXPECT_EQ(base::TimeDelta(),
+            rate_limiter.ComputeDelayNeeded(base::TimeDelta::FromHours(2)));
+
+  // Add 15 more samples, twice the hourly allowance in total.
+  rate_limiter.add_samples(15);
+  EXPECT_EQ(base::TimeDelta::FromHours(2),
+            rate_limiter.ComputeDelayNeeded(base::TimeDelta()));
+  EXPECT_EQ(base::TimeDelta::FromMinutes(90),
+            rate_limiter.ComputeDelayNeeded(base::TimeDelta::FromMinutes(30)));
+  EXPECT_EQ(base::TimeDelta(),
+            rate_limiter.ComputeDelayNeeded(base::TimeDelta::FromHours(2)));
+}
+
 TEST_F(DOMStorageAreaTest, DatabaseFileNames) {
   struct {
     const char* origin;
@@ -48,8 +48,12 @@ void DOMStorageHost::CloseStorageArea(int connection_id) {
   connections_.erase(found);
 }
 
-bool DOMStorageHost::ExtractAreaValues(
-    int connection_id, DOMStorageValuesMap* map, bool* send_log_get_messages) {
+bool DOMStorageHost::ShareAreaValues(
+    int connection_id, base::ProcessHandle process,
+    base::SharedMemoryHandle* handle, uint32* size,
+    DOMStorageValuesMap* map, bool* send_log_get_messages) {
+  *handle = base::SharedMemory::NULLHandle();
+  *size = 0;
   map->clear();
   DOMStorageArea* area = GetOpenArea(connection_id);
   if (!area)
@@ -63,7 +67,12 @@ bool DOMStorageHost::ExtractAreaValues(
         ns->PurgeMemory(DOMStorageNamespace::PURGE_AGGRESSIVE);
     }
   }
-  area->ExtractValues(map);
+  size_t snapshot_size = 0;
+  base::SharedMemory* snapshot = area->GetValuesSnapshot(&snapshot_size);
+  if (snapshot && snapshot->ShareReadOnlyToProcess(process, handle))
+    *size = snapshot_size;
+  else
+    area->ExtractValues(map);
   *send_log_get_messages = false;
   DOMStorageNamespace* ns = GetNamespace(connection_id);
   DCHECK(ns);
@@ -8,6 +8,8 @@
 #include <map>
 
 #include "base/memory/ref_counted.h"
+#include "base/memory/shared_memory.h"
+#include "base/process/process_handle.h"
 #include "base/strings/nullable_string16.h"
 #include "base/strings/string16.h"
 #include "content/browser/dom_storage/dom_storage_namespace.h"
@@ -36,8 +38,12 @@ class CONTENT_EXPORT DOMStorageHost {
   bool OpenStorageArea(int connection_id, int namespace_id,
                        const GURL& origin);
   void CloseStorageArea(int connection_id);
-  bool ExtractAreaValues(int connection_id, DOMStorageValuesMap* map,
-                         bool* send_log_get_messages);
+  // Shares a read-only snapshot of the area's values with |process|. If
+  // that fails, |handle| is left null and the values are copied to |map|.
+  bool ShareAreaValues(int connection_id, base::ProcessHandle process,
+                       base::SharedMemoryHandle* handle, uint32* size,
+                       DOMStorageValuesMap* map,
+                       bool* send_log_get_messages);
   unsigned GetAreaLength(int connection_id);
   base::NullableString16 GetAreaKey(int connection_id, unsigned index);
   base::NullableString16 GetAreaItem(int connection_id,
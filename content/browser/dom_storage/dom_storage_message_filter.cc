@@ -105,11 +105,15 @@ void DOMStorageMessageFilter::OnCloseStorageArea(int connection_id) {
   host_->CloseStorageArea(connection_id);
 }
 
-void DOMStorageMessageFilter::OnLoadStorageArea(int connection_id,
-                                                DOMStorageValuesMap* map,
-                                                bool* send_log_get_messages) {
+void DOMStorageMessageFilter::OnLoadStorageArea(
+    int connection_id,
+    base::SharedMemoryHandle* handle,
+    uint32* size,
+    DOMStorageValuesMap* map,
+    bool* send_log_get_messages) {
   DCHECK(!BrowserThread::CurrentlyOn(BrowserThread::IO));
-  if (!host_->ExtractAreaValues(connection_id, map, send_log_get_messages)) {
+  if (!host_->ShareAreaValues(connection_id, PeerHandle(), handle, size, map,
+                              send_log_get_messages)) {
     RecordAction(base::UserMetricsAction("BadMessageTerminate_DSMF_2"));
     BadMessageReceived();
   }
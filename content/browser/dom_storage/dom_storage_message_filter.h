@@ -7,6 +7,7 @@
 
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/shared_memory.h"
 #include "content/browser/dom_storage/dom_storage_context_impl.h"
 #include "content/common/dom_storage/dom_storage_types.h"
 #include "content/public/browser/browser_message_filter.h"
@@ -51,7 +52,8 @@ class DOMStorageMessageFilter
   void OnOpenStorageArea(int connection_id, int64 namespace_id,
                          const GURL& origin);
   void OnCloseStorageArea(int connection_id);
-  void OnLoadStorageArea(int connection_id, DOMStorageValuesMap* map,
+  void OnLoadStorageArea(int connection_id, base::SharedMemoryHandle* handle,
+                         uint32* size, DOMStorageValuesMap* map,
                          bool* send_log_get_messages);
   void OnSetItem(int connection_id, const base::string16& key,
                  const base::string16& value, const GURL& page_url);
@@ -1107,6 +1107,7 @@ bool GpuProcessHost::LaunchGpuProcess(const std::string& channel_id) {
 #if defined(ENABLE_WEBRTC)
     switches::kDisableWebRtcHWEncoding,
 #endif
+    switches::kEnableGpuShareGroupScheduling,
     switches::kEnableLogging,
     switches::kEnableShareGroupAsyncTextureUpload,
     switches::kGpuStartupDialog,
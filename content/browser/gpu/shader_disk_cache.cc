@@ -4,6 +4,8 @@
 
 #include "content/browser/gpu/shader_disk_cache.h"
 
+#include <utility>
+
 #include "base/threading/thread_checker.h"
 #include "content/browser/gpu/gpu_process_host.h"
 #include "content/public/browser/browser_thread.h"
@@ -64,7 +66,9 @@ class ShaderDiskCacheEntry
 };
 
 // ShaderDiskReadHelper is used to load all of the cached shaders from the
-// disk cache and send to the memory cache.
+// disk cache and send to the memory cache. The shaders are sent most recently
+// used first once they have all been read, so that the programs most likely
+// to be linked first are in the memory cache as early as possible.
 class ShaderDiskReadHelper
     : public base::ThreadChecker,
       public base::RefCounted<ShaderDiskReadHelper> {
@@ -100,6 +104,11 @@ class ShaderDiskReadHelper
   int host_id_;
   disk_cache::Entry* entry_;
 
+  // The key and data of the shaders read so far, by last use.
+  typedef std::multimap<base::Time, std::pair<std::string, std::string> >
+      LoadedShaderMap;
+  LoadedShaderMap loaded_shaders_;
+
   DISALLOW_COPY_AND_ASSIGN(ShaderDiskReadHelper);
 };
 
@@ -322,10 +331,10 @@ int ShaderDiskReadHelper::ReadComplete(int rv) {
   DCHECK(CalledOnValidThread());
   // Called through OnOpComplete, so we know |cache_| is valid.
   if (rv && rv == buf_->size()) {
-    GpuProcessHost* host = GpuProcessHost::FromID(host_id_);
-    if (host)
-      host->LoadedShader(entry_->GetKey(), std::string(buf_->data(),
-                                                       buf_->size()));
+    loaded_shaders_.insert(std::make_pair(
+        entry_->GetLastUsed(),
+        std::make_pair(entry_->GetKey(),
+                       std::string(buf_->data(), buf_->size()))));
   }
 
   buf_ = NULL;
@@ -341,6 +350,16 @@ int ShaderDiskReadHelper::IterationComplete(int rv) {
   // Called through OnOpComplete, so we know |cache_| is valid.
   cache_->backend()->EndEnumeration(&iter_);
   iter_ = NULL;
+
+  GpuProcessHost* host = GpuProcessHost::FromID(host_id_);
+  if (host) {
+    for (LoadedShaderMap::reverse_iterator it = loaded_shaders_.rbegin();
+         it != loaded_shaders_.rend();
+         ++it)
+      host->LoadedShader(it->second.first, it->second.second);
+  }
+  loaded_shaders_.clear();
+
   op_type_ = TERMINATE;
   return net::OK;
 }
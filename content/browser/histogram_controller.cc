@@ -6,6 +6,7 @@
 
 #include "base/bind.h"
 #include "base/metrics/histogram.h"
+#include "base/metrics/shared_histogram_reader.h"
 #include "content/browser/histogram_subscriber.h"
 #include "content/common/child_process_messages.h"
 #include "content/public/browser/browser_child_process_host_iterator.h"
@@ -54,6 +55,18 @@ void HistogramController::OnHistogramDataCollected(
   }
 }
 
+void HistogramController::RegisterSharedHistogramReader(
+    base::SharedHistogramReader* reader) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  shared_histogram_readers_.insert(reader);
+}
+
+void HistogramController::UnregisterSharedHistogramReader(
+    base::SharedHistogramReader* reader) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  shared_histogram_readers_.erase(reader);
+}
+
 void HistogramController::Register(HistogramSubscriber* subscriber) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
   DCHECK(!subscriber_);
@@ -70,6 +83,13 @@ void HistogramController::GetHistogramDataFromChildProcesses(
     int sequence_number) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
 
+  // Histograms in shared memory don't need a round trip to their process.
+  for (std::set<base::SharedHistogramReader*>::iterator it =
+           shared_histogram_readers_.begin();
+       it != shared_histogram_readers_.end(); ++it) {
+    (*it)->MergeDeltas();
+  }
+
   int pending_processes = 0;
   for (BrowserChildProcessHostIterator iter; !iter.Done(); ++iter) {
     int type = iter.GetData().process_type;
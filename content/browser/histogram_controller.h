@@ -5,11 +5,16 @@
 #ifndef CONTENT_BROWSER_HISTOGRAM_CONTROLLER_H_
 #define CONTENT_BROWSER_HISTOGRAM_CONTROLLER_H_
 
+#include <set>
 #include <string>
 #include <vector>
 
 #include "base/memory/singleton.h"
 
+namespace base {
+class SharedHistogramReader;
+}  // namespace base
+
 namespace content {
 
 class HistogramSubscriber;
@@ -54,6 +59,12 @@ class HistogramController {
       int sequence_number,
       const std::vector<std::string>& pickled_histograms);
 
+  // Register |reader| so that the histograms a child process records in shared
+  // memory are merged each time histogram data is collected, without waiting
+  // for the child. These are called on the IO thread.
+  void RegisterSharedHistogramReader(base::SharedHistogramReader* reader);
+  void UnregisterSharedHistogramReader(base::SharedHistogramReader* reader);
+
  private:
   friend struct DefaultSingletonTraits<HistogramController>;
 
@@ -64,6 +75,9 @@ class HistogramController {
 
   HistogramSubscriber* subscriber_;
 
+  // Only used on the IO thread.
+  std::set<base::SharedHistogramReader*> shared_histogram_readers_;
+
   DISALLOW_COPY_AND_ASSIGN(HistogramController);
 };
 
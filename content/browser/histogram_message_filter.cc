@@ -5,18 +5,64 @@
 #include "content/browser/histogram_message_filter.h"
 
 #include "base/command_line.h"
+#include "base/memory/shared_memory.h"
 #include "base/metrics/histogram.h"
+#include "base/metrics/shared_histogram_allocator.h"
+#include "base/metrics/shared_histogram_reader.h"
 #include "base/metrics/statistics_recorder.h"
 #include "content/browser/histogram_controller.h"
 #include "content/browser/tcmalloc_internals_request_job.h"
 #include "content/common/child_process_messages.h"
+#include "content/public/browser/render_process_host.h"
 #include "content/public/common/content_switches.h"
 
 namespace content {
 
+namespace {
+
+// Room for a few thousand histograms of the usual sizes.
+const uint32 kSharedHistogramMemorySize = 1024 * 1024;
+
+}  // namespace
+
 HistogramMessageFilter::HistogramMessageFilter()
     : BrowserMessageFilter(ChildProcessMsgStart) {}
 
+void HistogramMessageFilter::OnChannelConnected(int32 peer_pid) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  // In single process mode the renderer histograms are the browser ones.
+  if (!CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kEnableSharedMemoryHistograms) ||
+      RenderProcessHost::run_renderer_in_process()) {
+    return;
+  }
+
+  scoped_ptr<base::SharedMemory> memory(new base::SharedMemory);
+  base::SharedMemoryHandle memory_handle;
+  if (!memory->CreateAndMapAnonymous(kSharedHistogramMemorySize) ||
+      !memory->ShareToProcess(PeerHandle(), &memory_handle)) {
+    return;
+  }
+  shared_histogram_reader_.reset(new base::SharedHistogramReader(
+      make_scoped_ptr(new base::SharedHistogramAllocator(memory.Pass()))));
+  HistogramController::GetInstance()->RegisterSharedHistogramReader(
+      shared_histogram_reader_.get());
+  Send(new ChildProcessMsg_SetHistogramMemory(memory_handle,
+                                              kSharedHistogramMemorySize));
+}
+
+void HistogramMessageFilter::OnChannelClosing() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (!shared_histogram_reader_)
+    return;
+
+  // Keep what the child recorded since the last collection.
+  shared_histogram_reader_->MergeDeltas();
+  HistogramController::GetInstance()->UnregisterSharedHistogramReader(
+      shared_histogram_reader_.get());
+  shared_histogram_reader_.reset();
+}
+
 bool HistogramMessageFilter::OnMessageReceived(const IPC::Message& message,
                                               bool* message_was_ok) {
   bool handled = true;
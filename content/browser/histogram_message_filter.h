@@ -8,9 +8,14 @@
 #include <string>
 #include <vector>
 
+#include "base/memory/scoped_ptr.h"
 #include "content/public/browser/browser_message_filter.h"
 #include "content/public/common/process_type.h"
 
+namespace base {
+class SharedHistogramReader;
+}  // namespace base
+
 namespace content {
 
 // This class sends and receives histogram messages in the browser process.
@@ -19,6 +24,8 @@ class HistogramMessageFilter : public BrowserMessageFilter {
   HistogramMessageFilter();
 
   // BrowserMessageFilter implementation.
+  virtual void OnChannelConnected(int32 peer_pid) OVERRIDE;
+  virtual void OnChannelClosing() OVERRIDE;
   virtual bool OnMessageReceived(const IPC::Message& message,
                                  bool* message_was_ok) OVERRIDE;
 
@@ -31,6 +38,11 @@ class HistogramMessageFilter : public BrowserMessageFilter {
   void OnGetBrowserHistogram(const std::string& name,
                              std::string* histogram_json);
 
+  // Reads the histograms the child process records in shared memory, when
+  // switches::kEnableSharedMemoryHistograms is set. Only used on the IO
+  // thread.
+  scoped_ptr<base::SharedHistogramReader> shared_histogram_reader_;
+
   DISALLOW_COPY_AND_ASSIGN(HistogramMessageFilter);
 };
 
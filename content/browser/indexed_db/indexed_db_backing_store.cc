@@ -4,8 +4,10 @@
 
 #include "content/browser/indexed_db/indexed_db_backing_store.h"
 
+#include "base/bind.h"
 #include "base/file_util.h"
 #include "base/logging.h"
+#include "base/message_loop/message_loop.h"
 #include "base/metrics/histogram.h"
 #include "base/strings/string_piece.h"
 #include "base/strings/string_util.h"
@@ -70,6 +72,7 @@ enum IndexedDBBackingStoreErrorSource {
   DELETE_DATABASE,
   TRANSACTION_COMMIT_METHOD,  // TRANSACTION_COMMIT is a WinNT.h macro
   GET_DATABASE_NAMES,
+  SYNC_COMMITTED_TRANSACTIONS,
   INTERNAL_ERROR_MAX,
 };
 
@@ -2622,6 +2625,28 @@ IndexedDBBackingStore::OpenIndexCursor(
   return cursor.PassAs<IndexedDBBackingStore::Cursor>();
 }
 
+void IndexedDBBackingStore::SyncCommittedTransactions(
+    const SyncCallback& callback) {
+  pending_sync_callbacks_.push_back(callback);
+  if (pending_sync_callbacks_.size() > 1)
+    return;  // A sync is already posted.
+
+  base::MessageLoop::current()->PostTask(
+      FROM_HERE, base::Bind(&IndexedDBBackingStore::SyncPendingCommits, this));
+}
+
+void IndexedDBBackingStore::SyncPendingCommits() {
+  IDB_TRACE("IndexedDBBackingStore::SyncPendingCommits");
+  std::vector<SyncCallback> callbacks;
+  callbacks.swap(pending_sync_callbacks_);
+
+  leveldb::Status s = db_->Sync();
+  if (!s.ok())
+    INTERNAL_WRITE_ERROR(SYNC_COMMITTED_TRANSACTIONS);
+  for (size_t i = 0; i < callbacks.size(); ++i)
+    callbacks[i].Run(s);
+}
+
 IndexedDBBackingStore::Transaction::Transaction(
     IndexedDBBackingStore* backing_store)
     : backing_store_(backing_store) {}
@@ -2644,6 +2669,16 @@ leveldb::Status IndexedDBBackingStore::Transaction::Commit() {
   return s;
 }
 
+leveldb::Status IndexedDBBackingStore::Transaction::CommitWithoutSync() {
+  IDB_TRACE("IndexedDBBackingStore::Transaction::CommitWithoutSync");
+  DCHECK(transaction_.get());
+  leveldb::Status s = transaction_->CommitWithoutSync();
+  transaction_ = NULL;
+  if (!s.ok())
+    INTERNAL_WRITE_ERROR(TRANSACTION_COMMIT_METHOD);
+  return s;
+}
+
 void IndexedDBBackingStore::Transaction::Rollback() {
   IDB_TRACE("IndexedDBBackingStore::Transaction::Rollback");
   DCHECK(transaction_.get());
@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "base/basictypes.h"
+#include "base/callback.h"
 #include "base/files/file_path.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
@@ -286,12 +287,22 @@ class CONTENT_EXPORT IndexedDBBackingStore
       const IndexedDBKeyRange& key_range,
       indexed_db::CursorDirection);
 
+  typedef base::Callback<void(const leveldb::Status&)> SyncCallback;
+
+  // Runs |callback| once everything committed so far has reached disk. The
+  // sync is done after the tasks already queued on the current thread, so
+  // the transactions they commit share it.
+  virtual void SyncCommittedTransactions(const SyncCallback& callback);
+
   class Transaction {
    public:
     explicit Transaction(IndexedDBBackingStore* backing_store);
     virtual ~Transaction();
     virtual void Begin();
     virtual leveldb::Status Commit();
+    // Commits without waiting for the data to reach disk. Use
+    // SyncCommittedTransactions() to find out when it has.
+    virtual leveldb::Status CommitWithoutSync();
     virtual void Rollback();
     void Reset() {
       backing_store_ = NULL;
@@ -331,6 +342,8 @@ class CONTENT_EXPORT IndexedDBBackingStore
                              IndexedDBObjectStoreMetadata::IndexMap* map)
       WARN_UNUSED_RESULT;
 
+  void SyncPendingCommits();
+
   const GURL origin_url_;
 
   // The origin identifier is a key prefix unique to the origin used in the
@@ -344,6 +357,9 @@ class CONTENT_EXPORT IndexedDBBackingStore
   scoped_ptr<LevelDBDatabase> db_;
   scoped_ptr<LevelDBComparator> comparator_;
   base::OneShotTimer<IndexedDBBackingStore> close_timer_;
+
+  // Callbacks waiting for the next SyncPendingCommits().
+  std::vector<SyncCallback> pending_sync_callbacks_;
 };
 
 }  // namespace content
@@ -258,9 +258,16 @@ void IndexedDBCallbacks::OnSuccessWithPrefetch(
   params.ipc_cursor_id = ipc_cursor_id_;
   params.keys = msgKeys;
   params.primary_keys = msgPrimaryKeys;
+  size_t values_size = 0;
   std::vector<IndexedDBValue>::const_iterator iter;
   for (iter = values.begin(); iter != values.end(); ++iter)
-    params.values.push_back(iter->bits);
+    values_size += iter->bits.size();
+  params.values.reserve(values_size);
+  params.value_sizes.reserve(values.size());
+  for (iter = values.begin(); iter != values.end(); ++iter) {
+    params.values.append(iter->bits);
+    params.value_sizes.push_back(iter->bits.size());
+  }
   dispatcher_host_->Send(
       new IndexedDBMsg_CallbacksSuccessCursorPrefetch(params));
   dispatcher_host_ = NULL;
@@ -152,6 +152,11 @@ IndexedDBFakeBackingStore::OpenIndexCursor(
   return scoped_ptr<IndexedDBBackingStore::Cursor>();
 }
 
+void IndexedDBFakeBackingStore::SyncCommittedTransactions(
+    const SyncCallback& callback) {
+  callback.Run(leveldb::Status::OK());
+}
+
 IndexedDBFakeBackingStore::FakeTransaction::FakeTransaction(bool result)
     : IndexedDBBackingStore::Transaction(NULL), result_(result) {}
 void IndexedDBFakeBackingStore::FakeTransaction::Begin() {}
@@ -161,6 +166,10 @@ leveldb::Status IndexedDBFakeBackingStore::FakeTransaction::Commit() {
   else
     return leveldb::Status::IOError("test error");
 }
+leveldb::Status
+IndexedDBFakeBackingStore::FakeTransaction::CommitWithoutSync() {
+  return Commit();
+}
 void IndexedDBFakeBackingStore::FakeTransaction::Rollback() {}
 
 }  // namespace content
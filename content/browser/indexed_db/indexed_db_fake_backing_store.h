@@ -111,11 +111,15 @@ class IndexedDBFakeBackingStore : public IndexedDBBackingStore {
                                              indexed_db::CursorDirection)
       OVERRIDE;
 
+  virtual void SyncCommittedTransactions(const SyncCallback& callback)
+      OVERRIDE;
+
   class FakeTransaction : public IndexedDBBackingStore::Transaction {
    public:
     FakeTransaction(bool result);
     virtual void Begin() OVERRIDE;
     virtual leveldb::Status Commit() OVERRIDE;
+    virtual leveldb::Status CommitWithoutSync() OVERRIDE;
     virtual void Rollback() OVERRIDE;
 
    private:
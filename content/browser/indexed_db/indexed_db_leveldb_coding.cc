@@ -159,6 +159,19 @@
 // The sequence number is obsolete; it was used to allow two entries with the
 // same user (index) key in non-unique indexes prior to the inclusion of the
 // primary key in the data.
+//
+//
+// Sortable IDB keys
+// -----------------
+// EncodeSortableIDBKey() is an alternative coding of IDB keys whose bytes
+// compare with memcmp() in the same order as the keys. It is not used by
+// the backing store yet. Each key is a type byte followed by:
+//
+// Number, Date: the double as a big-endian uint64, with the sign bit flipped
+//   for positive values and all the bits flipped for negative ones.
+// String, Binary: the bytes (UTF-16BE for strings) with each 0x00 written
+//   as <0x00, 0xFF>, then <0x00, 0x01>.
+// Array: the sortable coding of each element, then 0x00.
 
 using base::StringPiece;
 using blink::WebIDBKeyType;
@@ -190,6 +203,18 @@ static const unsigned char kIndexedDBKeyArrayTypeByte = 4;
 static const unsigned char kIndexedDBKeyMinKeyTypeByte = 5;
 static const unsigned char kIndexedDBKeyBinaryTypeByte = 6;
 
+// Type bytes of the sortable key coding, in key order.
+static const unsigned char kSortableKeyArrayEndByte = 0x00;
+static const unsigned char kSortableKeyNumberTypeByte = 0x10;
+static const unsigned char kSortableKeyDateTypeByte = 0x20;
+static const unsigned char kSortableKeyStringTypeByte = 0x30;
+static const unsigned char kSortableKeyBinaryTypeByte = 0x40;
+static const unsigned char kSortableKeyArrayTypeByte = 0x50;
+
+static const unsigned char kSortableEscapeByte = 0x00;
+static const unsigned char kSortableEscapedZeroByte = 0xFF;
+static const unsigned char kSortableTerminatorByte = 0x01;
+
 static const unsigned char kIndexedDBKeyPathTypeCodedByte1 = 0;
 static const unsigned char kIndexedDBKeyPathTypeCodedByte2 = 0;
 
@@ -349,6 +374,67 @@ void EncodeIDBKey(const IndexedDBKey& value, std::string* into) {
   }
 }
 
+static void EncodeSortableDouble(double value, std::string* into) {
+  // -0 and 0 are the same key.
+  if (value == 0)
+    value = 0;
+  uint64 bits;
+  memcpy(&bits, &value, sizeof(bits));
+  const uint64 sign_bit = GG_UINT64_C(1) << 63;
+  bits = (bits & sign_bit) ? ~bits : bits | sign_bit;
+  for (int shift = 56; shift >= 0; shift -= 8)
+    into->push_back(static_cast<char>(bits >> shift));
+}
+
+static void EncodeSortableBytes(const std::string& value, std::string* into) {
+  for (std::string::const_iterator it = value.begin(); it != value.end();
+       ++it) {
+    into->push_back(*it);
+    if (static_cast<unsigned char>(*it) == kSortableEscapeByte)
+      into->push_back(kSortableEscapedZeroByte);
+  }
+  into->push_back(kSortableEscapeByte);
+  into->push_back(kSortableTerminatorByte);
+}
+
+void EncodeSortableIDBKey(const IndexedDBKey& value, std::string* into) {
+  DCHECK(value.IsValid());
+  switch (value.type()) {
+    case WebIDBKeyTypeArray: {
+      EncodeByte(kSortableKeyArrayTypeByte, into);
+      for (size_t i = 0; i < value.array().size(); ++i)
+        EncodeSortableIDBKey(value.array()[i], into);
+      EncodeByte(kSortableKeyArrayEndByte, into);
+      return;
+    }
+    case WebIDBKeyTypeBinary:
+      EncodeByte(kSortableKeyBinaryTypeByte, into);
+      EncodeSortableBytes(value.binary(), into);
+      return;
+    case WebIDBKeyTypeString: {
+      EncodeByte(kSortableKeyStringTypeByte, into);
+      std::string utf16;
+      EncodeString(value.string(), &utf16);
+      EncodeSortableBytes(utf16, into);
+      return;
+    }
+    case WebIDBKeyTypeDate:
+      EncodeByte(kSortableKeyDateTypeByte, into);
+      EncodeSortableDouble(value.date(), into);
+      return;
+    case WebIDBKeyTypeNumber:
+      EncodeByte(kSortableKeyNumberTypeByte, into);
+      EncodeSortableDouble(value.number(), into);
+      return;
+    case WebIDBKeyTypeNull:
+    case WebIDBKeyTypeInvalid:
+    case WebIDBKeyTypeMin:
+    default:
+      NOTREACHED();
+      return;
+  }
+}
+
 void EncodeIDBKeyPath(const IndexedDBKeyPath& value, std::string* into) {
   // May be typed, or may be a raw string. An invalid leading
   // byte is used to identify typed coding. New records are
@@ -546,6 +632,107 @@ bool DecodeIDBKey(StringPiece* slice, scoped_ptr<IndexedDBKey>* value) {
   return false;
 }
 
+static bool DecodeSortableDouble(StringPiece* slice, double* value) {
+  if (slice->size() < sizeof(uint64))
+    return false;
+
+  uint64 bits = 0;
+  for (size_t i = 0; i < sizeof(bits); ++i)
+    bits = (bits << 8) | static_cast<unsigned char>((*slice)[i]);
+  slice->remove_prefix(sizeof(bits));
+  const uint64 sign_bit = GG_UINT64_C(1) << 63;
+  bits = (bits & sign_bit) ? bits & ~sign_bit : ~bits;
+  memcpy(value, &bits, sizeof(*value));
+  return true;
+}
+
+static bool DecodeSortableBytes(StringPiece* slice, std::string* value) {
+  std::string decoded;
+  for (size_t i = 0; i < slice->size(); ++i) {
+    unsigned char c = (*slice)[i];
+    if (c != kSortableEscapeByte) {
+      decoded.push_back(c);
+      continue;
+    }
+    if (++i == slice->size())
+      return false;
+    c = (*slice)[i];
+    if (c == kSortableTerminatorByte) {
+      slice->remove_prefix(i + 1);
+      value->swap(decoded);
+      return true;
+    }
+    if (c != kSortableEscapedZeroByte)
+      return false;
+    decoded.push_back(kSortableEscapeByte);
+  }
+  return false;
+}
+
+bool DecodeSortableIDBKey(StringPiece* slice,
+                          scoped_ptr<IndexedDBKey>* value) {
+  unsigned char type;
+  if (!DecodeByte(slice, &type))
+    return false;
+
+  switch (type) {
+    case kSortableKeyArrayTypeByte: {
+      IndexedDBKey::KeyArray array;
+      for (;;) {
+        if (slice->empty())
+          return false;
+        if (static_cast<unsigned char>((*slice)[0]) ==
+            kSortableKeyArrayEndByte) {
+          slice->remove_prefix(1);
+          break;
+        }
+        scoped_ptr<IndexedDBKey> key;
+        if (!DecodeSortableIDBKey(slice, &key))
+          return false;
+        array.push_back(*key);
+      }
+      *value = make_scoped_ptr(new IndexedDBKey(array));
+      return true;
+    }
+    case kSortableKeyBinaryTypeByte: {
+      std::string binary;
+      if (!DecodeSortableBytes(slice, &binary))
+        return false;
+      *value = make_scoped_ptr(new IndexedDBKey(binary));
+      return true;
+    }
+    case kSortableKeyStringTypeByte: {
+      std::string utf16;
+      if (!DecodeSortableBytes(slice, &utf16) ||
+          utf16.size() % sizeof(base::char16)) {
+        return false;
+      }
+      StringPiece utf16_slice(utf16);
+      base::string16 s;
+      if (!DecodeString(&utf16_slice, &s))
+        return false;
+      *value = make_scoped_ptr(new IndexedDBKey(s));
+      return true;
+    }
+    case kSortableKeyDateTypeByte: {
+      double d;
+      if (!DecodeSortableDouble(slice, &d))
+        return false;
+      *value = make_scoped_ptr(new IndexedDBKey(d, WebIDBKeyTypeDate));
+      return true;
+    }
+    case kSortableKeyNumberTypeByte: {
+      double d;
+      if (!DecodeSortableDouble(slice, &d))
+        return false;
+      *value = make_scoped_ptr(new IndexedDBKey(d, WebIDBKeyTypeNumber));
+      return true;
+    }
+  }
+
+  return false;
+}
+
 bool DecodeDouble(StringPiece* slice, double* value) {
   if (slice->size() < sizeof(*value))
     return false;
@@ -607,6 +607,99 @@ TEST(IndexedDBLevelDBCodingTest, EncodeDecodeIDBKey) {
   }
 }
 
+TEST(IndexedDBLevelDBCodingTest, EncodeDecodeSortableIDBKey) {
+  scoped_ptr<IndexedDBKey> decoded_key;
+  std::string v;
+  StringPiece slice;
+
+  std::vector<IndexedDBKey> test_cases;
+  test_cases.push_back(IndexedDBKey(1234, WebIDBKeyTypeNumber));
+  test_cases.push_back(IndexedDBKey(-0.5, WebIDBKeyTypeNumber));
+  test_cases.push_back(IndexedDBKey(7890, WebIDBKeyTypeDate));
+  test_cases.push_back(IndexedDBKey(ASCIIToUTF16("Hello World!")));
+  test_cases.push_back(IndexedDBKey(base::string16(2, 0x100)));
+  test_cases.push_back(IndexedDBKey(std::string("\x00\x01\x00", 3)));
+  test_cases.push_back(IndexedDBKey(IndexedDBKey::KeyArray()));
+  test_cases.push_back(
+      CreateArrayIDBKey(IndexedDBKey(ASCIIToUTF16("a")),
+                        CreateArrayIDBKey(IndexedDBKey(std::string()))));
+
+  for (size_t i = 0; i < test_cases.size(); ++i) {
+    v.clear();
+    EncodeSortableIDBKey(test_cases[i], &v);
+    slice = StringPiece(v);
+    EXPECT_TRUE(DecodeSortableIDBKey(&slice, &decoded_key));
+    EXPECT_TRUE(decoded_key->Equals(test_cases[i]));
+    EXPECT_TRUE(slice.empty());
+
+    slice = StringPiece(v.data(), v.size() - 1);
+    EXPECT_FALSE(DecodeSortableIDBKey(&slice, &decoded_key));
+
+    slice = StringPiece();
+    EXPECT_FALSE(DecodeSortableIDBKey(&slice, &decoded_key));
+  }
+}
+
+TEST(IndexedDBLevelDBCodingTest, SortableIDBKeyOrder) {
+  // In ascending key order.
+  std::vector<IndexedDBKey> keys;
+  keys.push_back(IndexedDBKey(-std::numeric_limits<double>::infinity(),
+                              WebIDBKeyTypeNumber));
+  keys.push_back(IndexedDBKey(-1e10, WebIDBKeyTypeNumber));
+  keys.push_back(IndexedDBKey(-1, WebIDBKeyTypeNumber));
+  keys.push_back(IndexedDBKey(-0.5, WebIDBKeyTypeNumber));
+  keys.push_back(IndexedDBKey(0, WebIDBKeyTypeNumber));
+  keys.push_back(IndexedDBKey(0.5, WebIDBKeyTypeNumber));
+  keys.push_back(IndexedDBKey(1, WebIDBKeyTypeNumber));
+  keys.push_back(IndexedDBKey(1e10, WebIDBKeyTypeNumber));
+  keys.push_back(IndexedDBKey(std::numeric_limits<double>::infinity(),
+                              WebIDBKeyTypeNumber));
+  keys.push_back(IndexedDBKey(-1, WebIDBKeyTypeDate));
+  keys.push_back(IndexedDBKey(0, WebIDBKeyTypeDate));
+  keys.push_back(IndexedDBKey(1, WebIDBKeyTypeDate));
+  keys.push_back(IndexedDBKey(base::string16()));
+  keys.push_back(IndexedDBKey(base::string16(1, 0)));
+  keys.push_back(IndexedDBKey(base::string16(2, 0)));
+  keys.push_back(IndexedDBKey(ASCIIToUTF16("a")));
+  keys.push_back(IndexedDBKey(ASCIIToUTF16("a") + base::string16(1, 0)));
+  keys.push_back(IndexedDBKey(ASCIIToUTF16("ab")));
+  keys.push_back(IndexedDBKey(ASCIIToUTF16("b")));
+  keys.push_back(IndexedDBKey(base::string16(1, 0x100)));
+  keys.push_back(IndexedDBKey(base::string16(1, 0xffff)));
+  keys.push_back(IndexedDBKey(std::string()));
+  keys.push_back(IndexedDBKey(std::string("\x00", 1)));
+  keys.push_back(IndexedDBKey(std::string("\x00\x00", 2)));
+  keys.push_back(IndexedDBKey(std::string("\x00\xff", 2)));
+  keys.push_back(IndexedDBKey(std::string("\x01")));
+  keys.push_back(IndexedDBKey(std::string("\xff")));
+  keys.push_back(CreateArrayIDBKey());
+  keys.push_back(CreateArrayIDBKey(IndexedDBKey(0, WebIDBKeyTypeNumber)));
+  keys.push_back(CreateArrayIDBKey(IndexedDBKey(0, WebIDBKeyTypeNumber),
+                                   IndexedDBKey(0, WebIDBKeyTypeNumber)));
+  keys.push_back(CreateArrayIDBKey(IndexedDBKey(1, WebIDBKeyTypeNumber)));
+  keys.push_back(CreateArrayIDBKey(IndexedDBKey(base::string16())));
+  keys.push_back(CreateArrayIDBKey(CreateArrayIDBKey()));
+
+  std::vector<std::string> encoded(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i)
+    EncodeSortableIDBKey(keys[i], &encoded[i]);
+
+  for (size_t i = 0; i < keys.size(); ++i) {
+    for (size_t j = 0; j < keys.size(); ++j) {
+      int result = encoded[i].compare(encoded[j]);
+      EXPECT_EQ(keys[i].IsLessThan(keys[j]), result < 0) << i << " " << j;
+      EXPECT_EQ(keys[j].IsLessThan(keys[i]), result > 0) << i << " " << j;
+      EXPECT_EQ(i < j, result < 0) << i << " " << j;
+    }
+  }
+
+  // -0 and 0 are the same key.
+  std::string negative_zero;
+  EncodeSortableIDBKey(IndexedDBKey(-0.0, WebIDBKeyTypeNumber),
+                       &negative_zero);
+  EXPECT_EQ(encoded[4], negative_zero);
+}
+
 static std::string WrappedEncodeIDBKeyPath(const IndexedDBKeyPath& value) {
   std::string buffer;
   EncodeIDBKeyPath(value, &buffer);
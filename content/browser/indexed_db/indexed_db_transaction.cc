@@ -237,7 +237,18 @@ void IndexedDBTransaction::Commit() {
 
   state_ = FINISHED;
 
-  bool committed = !used_ || transaction_->Commit().ok();
+  // Read-write transactions don't wait for their data to reach disk: the
+  // transactions committed right after them share one sync, and the
+  // front-end is told they are complete once it is done. Version change
+  // transactions still sync on their own, since the open request waiting
+  // for them is completed in TransactionFinished().
+  const bool group_commit =
+      used_ && mode_ == indexed_db::TRANSACTION_READ_WRITE;
+  bool committed = true;
+  if (used_) {
+    committed = group_commit ? transaction_->CommitWithoutSync().ok()
+                             : transaction_->Commit().ok();
+  }
 
   // Backing store resources (held via cursors) must be released
   // before script callbacks are fired, as the script callbacks may
@@ -251,6 +262,14 @@ void IndexedDBTransaction::Commit() {
   // operations like closing connections.
   database_->transaction_coordinator().DidFinishTransaction(this);
 
+  if (committed && group_commit) {
+    abort_task_stack_.clear();
+    database_->TransactionFinished(this, true);
+    database_->backing_store()->SyncCommittedTransactions(
+        base::Bind(&IndexedDBTransaction::DidSyncCommit, this));
+    return;
+  }
+
   if (committed) {
     abort_task_stack_.clear();
     callbacks_->OnComplete(id_);
@@ -270,6 +289,22 @@ void IndexedDBTransaction::Commit() {
   database_ = NULL;
 }
 
+void IndexedDBTransaction::DidSyncCommit(const leveldb::Status& status) {
+  if (status.ok()) {
+    callbacks_->OnComplete(id_);
+  } else {
+    // The data may already have been read by later transactions, but the
+    // backing store is closed on this failure, as on any other commit error.
+    callbacks_->OnAbort(
+        id_,
+        IndexedDBDatabaseError(blink::WebIDBDatabaseExceptionUnknownError,
+                               "Internal error committing transaction."));
+    database_->TransactionCommitFailed();
+  }
+
+  database_ = NULL;
+}
+
 void IndexedDBTransaction::ProcessTaskQueue() {
   IDB_TRACE("IndexedDBTransaction::ProcessTaskQueue");
 
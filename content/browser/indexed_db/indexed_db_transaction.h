@@ -93,6 +93,10 @@ class CONTENT_EXPORT IndexedDBTransaction
   bool IsTaskQueueEmpty() const;
   bool HasPendingTasks() const;
 
+  // Called once the data written by a group committed transaction is on
+  // disk.
+  void DidSyncCommit(const leveldb::Status& status);
+
   void ProcessTaskQueue();
   void CloseOpenCursors();
   void Timeout();
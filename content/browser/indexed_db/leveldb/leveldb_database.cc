@@ -362,8 +362,25 @@ leveldb::Status LevelDBDatabase::Get(const StringPiece& key,
 }
 
 leveldb::Status LevelDBDatabase::Write(const LevelDBWriteBatch& write_batch) {
+  return Write(write_batch, kSyncWrites);
+}
+
+leveldb::Status LevelDBDatabase::WriteWithoutSync(
+    const LevelDBWriteBatch& write_batch) {
+  return Write(write_batch, false);
+}
+
+leveldb::Status LevelDBDatabase::Sync() {
+  // A synced write syncs the whole log, which holds all the earlier writes,
+  // so an empty one is enough.
+  scoped_ptr<LevelDBWriteBatch> write_batch = LevelDBWriteBatch::Create();
+  return Write(*write_batch);
+}
+
+leveldb::Status LevelDBDatabase::Write(const LevelDBWriteBatch& write_batch,
+                                       bool sync) {
   leveldb::WriteOptions write_options;
-  write_options.sync = kSyncWrites;
+  write_options.sync = sync;
 
   const leveldb::Status s =
       db_->Write(write_options, write_batch.write_batch_.get());
@@ -65,6 +65,11 @@ class CONTENT_EXPORT LevelDBDatabase {
                               bool* found,
                               const LevelDBSnapshot* = 0);
   leveldb::Status Write(const LevelDBWriteBatch& write_batch);
+  // Like Write(), but returns without waiting for the data to reach disk.
+  // It gets there with the next write that does wait, such as Sync().
+  leveldb::Status WriteWithoutSync(const LevelDBWriteBatch& write_batch);
+  // Waits for everything written so far to reach disk.
+  leveldb::Status Sync();
   scoped_ptr<LevelDBIterator> CreateIterator(const LevelDBSnapshot* = 0);
   const LevelDBComparator* Comparator() const;
   void Compact(const base::StringPiece& start, const base::StringPiece& stop);
@@ -75,6 +80,8 @@ class CONTENT_EXPORT LevelDBDatabase {
  private:
   friend class LevelDBSnapshot;
 
+  leveldb::Status Write(const LevelDBWriteBatch& write_batch, bool sync);
+
   scoped_ptr<leveldb::Env> env_;
   scoped_ptr<leveldb::Comparator> comparator_adapter_;
   scoped_ptr<leveldb::DB> db_;
@@ -86,6 +86,14 @@ leveldb::Status LevelDBTransaction::Get(const StringPiece& key,
 }
 
 leveldb::Status LevelDBTransaction::Commit() {
+  return Commit(true);
+}
+
+leveldb::Status LevelDBTransaction::CommitWithoutSync() {
+  return Commit(false);
+}
+
+leveldb::Status LevelDBTransaction::Commit(bool sync) {
   DCHECK(!finished_);
 
   if (data_.empty()) {
@@ -103,7 +111,8 @@ leveldb::Status LevelDBTransaction::Commit() {
       write_batch->Remove(iterator->first);
   }
 
-  leveldb::Status s = db_->Write(*write_batch);
+  leveldb::Status s =
+      sync ? db_->Write(*write_batch) : db_->WriteWithoutSync(*write_batch);
   if (s.ok()) {
     Clear();
     finished_ = true;
@@ -31,6 +31,9 @@ class CONTENT_EXPORT LevelDBTransaction
                       std::string* value,
                       bool* found);
   leveldb::Status Commit();
+  // Commits without waiting for the data to reach disk; see
+  // LevelDBDatabase::WriteWithoutSync().
+  leveldb::Status CommitWithoutSync();
   void Rollback();
 
   scoped_ptr<LevelDBIterator> CreateIterator();
@@ -120,6 +123,7 @@ class CONTENT_EXPORT LevelDBTransaction
     mutable bool data_changed_;
   };
 
+  leveldb::Status Commit(bool sync);
   void Set(const base::StringPiece& key, std::string* value, bool deleted);
   void Clear();
   void RegisterIterator(TransactionIterator* iterator);
@@ -21,10 +21,12 @@
 #include "content/browser/loader/resource_message_filter.h"
 #include "content/browser/loader/resource_request_info_impl.h"
 #include "content/browser/resource_context_impl.h"
+#include "content/common/resource_data_ring.h"
 #include "content/common/resource_messages.h"
 #include "content/common/view_messages.h"
 #include "content/public/browser/global_request_id.h"
 #include "content/public/browser/resource_dispatcher_host_delegate.h"
+#include "content/public/common/content_switches.h"
 #include "content/public/common/resource_response.h"
 #include "net/base/io_buffer.h"
 #include "net/base/load_flags.h"
@@ -82,6 +84,8 @@ AsyncResourceHandler::AsyncResourceHandler(
     : ResourceHandler(request),
       ResourceMessageDelegate(request),
       rdh_(rdh),
+      use_data_ring_(CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kEnableResourceDataRing)),
       pending_data_count_(0),
       allocation_size_(0),
       did_defer_(false),
@@ -103,6 +107,7 @@ bool AsyncResourceHandler::OnMessageReceived(const IPC::Message& message,
   IPC_BEGIN_MESSAGE_MAP_EX(AsyncResourceHandler, message, *message_was_ok)
     IPC_MESSAGE_HANDLER(ResourceHostMsg_FollowRedirect, OnFollowRedirect)
     IPC_MESSAGE_HANDLER(ResourceHostMsg_DataReceived_ACK, OnDataReceivedACK)
+    IPC_MESSAGE_HANDLER(ResourceHostMsg_DataConsumed, OnDataConsumed)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP_EX()
   return handled;
@@ -124,6 +129,10 @@ void AsyncResourceHandler::OnFollowRedirect(
 }
 
 void AsyncResourceHandler::OnDataReceivedACK(int request_id) {
+  // Chunks passed through the ring are recycled by RecycleConsumedChunks().
+  if (data_ring_)
+    return;
+
   if (pending_data_count_) {
     --pending_data_count_;
 
@@ -133,6 +142,15 @@ void AsyncResourceHandler::OnDataReceivedACK(int request_id) {
   }
 }
 
+void AsyncResourceHandler::OnDataConsumed(int request_id) {
+  if (!data_ring_)
+    return;
+
+  RecycleConsumedChunks();
+  if (CanReadIntoDataRing())
+    ResumeIfDeferred();
+}
+
 bool AsyncResourceHandler::OnUploadProgress(int request_id,
                                             uint64 position,
                                             uint64 size) {
@@ -246,6 +264,9 @@ bool AsyncResourceHandler::OnWillRead(int request_id,
   if (!EnsureResourceBufferIsInitialized())
     return false;
 
+  if (data_ring_)
+    RecycleConsumedChunks();
+
   DCHECK(buffer_->CanAllocate());
   char* memory = buffer_->Allocate(&allocation_size_);
   CHECK(memory);
@@ -284,8 +305,13 @@ bool AsyncResourceHandler::OnReadCompleted(int request_id, int bytes_read,
     int size;
     if (!buffer_->ShareToProcess(filter->PeerHandle(), &handle, &size))
       return false;
-    filter->Send(new ResourceMsg_SetDataBuffer(
-        request_id, handle, size, filter->peer_pid()));
+    if (data_ring_) {
+      filter->Send(new ResourceMsg_SetDataRing(
+          request_id, handle, size, filter->peer_pid()));
+    } else {
+      filter->Send(new ResourceMsg_SetDataBuffer(
+          request_id, handle, size, filter->peer_pid()));
+    }
     sent_first_data_msg_ = true;
   }
 
@@ -295,14 +321,35 @@ bool AsyncResourceHandler::OnReadCompleted(int request_id, int bytes_read,
   int encoded_data_length = current_transfer_size - reported_transfer_size_;
   reported_transfer_size_ = current_transfer_size;
 
-  filter->Send(new ResourceMsg_DataReceived(
-      request_id, data_offset, bytes_read, encoded_data_length));
+  if (data_ring_) {
+    // The renderer is only told about the data when it may have gone idle,
+    // and only tells us about its progress when we wait for it.
+    ResourceDataRing::Chunk chunk = { data_offset, bytes_read,
+                                      encoded_data_length };
+    if (data_ring_->Push(chunk))
+      filter->Send(new ResourceMsg_DataAvailable(request_id));
+  } else {
+    filter->Send(new ResourceMsg_DataReceived(
+        request_id, data_offset, bytes_read, encoded_data_length));
+  }
   ++pending_data_count_;
   UMA_HISTOGRAM_CUSTOM_COUNTS(
       "Net.AsyncResourceHandler_PendingDataCount",
       pending_data_count_, 0, 100, 100);
 
-  if (!buffer_->CanAllocate()) {
+  if (data_ring_) {
+    RecycleConsumedChunks();
+    if (!CanReadIntoDataRing()) {
+      // The renderer may have popped chunks before it saw the flag, in which
+      // case it won't signal us, so check again after setting it.
+      data_ring_->SetProducerWaiting();
+      RecycleConsumedChunks();
+      if (CanReadIntoDataRing())
+        data_ring_->ClearProducerWaiting();
+    }
+  }
+
+  if (data_ring_ ? !CanReadIntoDataRing() : !buffer_->CanAllocate()) {
     UMA_HISTOGRAM_CUSTOM_COUNTS(
         "Net.AsyncResourceHandler_PendingDataCount_WhenFull",
         pending_data_count_, 0, 100, 100);
@@ -393,9 +440,33 @@ bool AsyncResourceHandler::EnsureResourceBufferIsInitialized() {
   }
 
   buffer_ = new ResourceBuffer();
-  return buffer_->Initialize(kBufferSize,
-                             kMinAllocationSize,
-                             kMaxAllocationSize);
+  if (!use_data_ring_) {
+    return buffer_->Initialize(kBufferSize,
+                               kMinAllocationSize,
+                               kMaxAllocationSize);
+  }
+
+  if (!buffer_->InitializeWithControlBlock(
+          kBufferSize, kMinAllocationSize, kMaxAllocationSize,
+          static_cast<int>(ResourceDataRing::GetSizeInBytes()))) {
+    return false;
+  }
+  data_ring_.reset(new ResourceDataRing(buffer_->GetControlBlock()));
+  return true;
+}
+
+void AsyncResourceHandler::RecycleConsumedChunks() {
+  // Chunks are consumed in the order they were allocated.
+  int consumed = data_ring_->TakeConsumedCount();
+  DCHECK_LE(consumed, pending_data_count_);
+  for (; consumed > 0 && pending_data_count_ > 0; --consumed) {
+    --pending_data_count_;
+    buffer_->RecycleLeastRecentlyAllocated();
+  }
+}
+
+bool AsyncResourceHandler::CanReadIntoDataRing() {
+  return buffer_->CanAllocate() && !data_ring_->IsFull();
 }
 
 void AsyncResourceHandler::ResumeIfDeferred() {
@@ -8,6 +8,7 @@
 #include <string>
 
 #include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
 #include "content/browser/loader/resource_handler.h"
 #include "content/browser/loader/resource_message_delegate.h"
 #include "url/gurl.h"
@@ -19,6 +20,7 @@ class URLRequest;
 namespace content {
 class ResourceBuffer;
 class ResourceContext;
+class ResourceDataRing;
 class ResourceDispatcherHostImpl;
 class ResourceMessageFilter;
 class SharedIOBuffer;
@@ -72,16 +74,32 @@ class AsyncResourceHandler : public ResourceHandler,
                         bool has_new_first_party_for_cookies,
                         const GURL& new_first_party_for_cookies);
   void OnDataReceivedACK(int request_id);
+  void OnDataConsumed(int request_id);
 
   bool EnsureResourceBufferIsInitialized();
+
+  // Recycles the buffer space of the chunks the renderer has popped from
+  // |data_ring_|.
+  void RecycleConsumedChunks();
+
+  // Returns true if there is room for the next read, in both the buffer and
+  // |data_ring_|.
+  bool CanReadIntoDataRing();
+
   void ResumeIfDeferred();
   void OnDefer();
 
   scoped_refptr<ResourceBuffer> buffer_;
   ResourceDispatcherHostImpl* rdh_;
 
-  // Number of messages we've sent to the renderer that we haven't gotten an
-  // ACK for. This allows us to avoid having too many messages in flight.
+  // When set, the locations of the data in |buffer_| are passed to the
+  // renderer through this ring, which lives in the same shared memory, instead
+  // of DataReceived messages.
+  bool use_data_ring_;
+  scoped_ptr<ResourceDataRing> data_ring_;
+
+  // Number of chunks of data we've sent to the renderer that it hasn't
+  // consumed yet. This allows us to avoid having too many in flight.
   int pending_data_count_;
 
   int allocation_size_;
@@ -32,6 +32,7 @@ namespace content {
 
 ResourceBuffer::ResourceBuffer()
     : buf_size_(0),
+      control_block_size_(0),
       min_alloc_size_(0),
       max_alloc_size_(0),
       alloc_start_(-1),
@@ -44,23 +45,40 @@ ResourceBuffer::~ResourceBuffer() {
 bool ResourceBuffer::Initialize(int buffer_size,
                                 int min_allocation_size,
                                 int max_allocation_size) {
+  return InitializeWithControlBlock(
+      buffer_size, min_allocation_size, max_allocation_size, 0);
+}
+
+bool ResourceBuffer::InitializeWithControlBlock(int buffer_size,
+                                                int min_allocation_size,
+                                                int max_allocation_size,
+                                                int control_block_size) {
   DCHECK(!IsInitialized());
+  DCHECK_GE(control_block_size, 0);
 
   // It would be wasteful if these are not multiples of min_allocation_size.
   DCHECK_EQ(0, buffer_size % min_allocation_size);
   DCHECK_EQ(0, max_allocation_size % min_allocation_size);
 
   buf_size_ = buffer_size;
+  control_block_size_ = control_block_size;
   min_alloc_size_ = min_allocation_size;
   max_alloc_size_ = max_allocation_size;
 
-  return shared_mem_.CreateAndMapAnonymous(buf_size_);
+  return shared_mem_.CreateAndMapAnonymous(buf_size_ + control_block_size_);
 }
 
 bool ResourceBuffer::IsInitialized() const {
   return shared_mem_.memory() != NULL;
 }
 
+void* ResourceBuffer::GetControlBlock() {
+  DCHECK(IsInitialized());
+  if (!control_block_size_)
+    return NULL;
+  return static_cast<char*>(shared_mem_.memory()) + buf_size_;
+}
+
 bool ResourceBuffer::ShareToProcess(
     base::ProcessHandle process_handle,
     base::SharedMemoryHandle* shared_memory_handle,
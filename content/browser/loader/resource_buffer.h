@@ -69,8 +69,20 @@ class CONTENT_EXPORT ResourceBuffer
   bool Initialize(int buffer_size,
                   int min_allocation_size,
                   int max_allocation_size);
+
+  // Like Initialize(), but also maps |control_block_size| bytes right after
+  // the buffer, for state shared with the other process. Allocate() never
+  // returns them, and ShareToProcess() shares them along with the buffer,
+  // although the size it returns doesn't include them.
+  bool InitializeWithControlBlock(int buffer_size,
+                                  int min_allocation_size,
+                                  int max_allocation_size,
+                                  int control_block_size);
   bool IsInitialized() const;
 
+  // Returns the memory mapped after the buffer, or NULL if there is none.
+  void* GetControlBlock();
+
   // Returns a shared memory handle that can be passed to the given process.
   // The shared memory handle is only intended to be interpretted by code
   // running in the specified process.  NOTE: The caller should ensure that
@@ -106,6 +118,7 @@ class CONTENT_EXPORT ResourceBuffer
   base::SharedMemory shared_mem_;
 
   int buf_size_;
+  int control_block_size_;
   int min_alloc_size_;
   int max_alloc_size_;
 
@@ -134,4 +134,26 @@ TEST(ResourceBufferTest, Full) {
   EXPECT_FALSE(buf->CanAllocate());
 }
 
+TEST(ResourceBufferTest, ControlBlock) {
+  scoped_refptr<ResourceBuffer> buf = new ResourceBuffer();
+  EXPECT_TRUE(buf->InitializeWithControlBlock(20, 10, 10, 8));
+
+  char* control_block = static_cast<char*>(buf->GetControlBlock());
+  ASSERT_TRUE(control_block);
+
+  // Allocations never reach the control block.
+  int size;
+  char* first = buf->Allocate(&size);
+  EXPECT_EQ(10, size);
+  char* second = buf->Allocate(&size);
+  EXPECT_EQ(10, size);
+  EXPECT_EQ(control_block, second + size);
+  EXPECT_EQ(first + 10, second);
+  EXPECT_FALSE(buf->CanAllocate());
+
+  scoped_refptr<ResourceBuffer> plain = new ResourceBuffer();
+  EXPECT_TRUE(plain->Initialize(20, 10, 10));
+  EXPECT_FALSE(plain->GetControlBlock());
+}
+
 }  // namespace content
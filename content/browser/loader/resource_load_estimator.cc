@@ -0,0 +1,113 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/loader/resource_load_estimator.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "base/values.h"
+
+namespace content {
+
+namespace {
+
+// The weight of a new sample in the moving averages.
+const double kSampleWeight = 0.25;
+
+// Throughput samples over less time than this are mostly noise, so they are
+// combined with the following ones.
+const int kMinThroughputSampleMs = 50;
+
+// Throughput is sampled when the client goes idle, as the loads still in
+// flight have received bytes that aren't counted yet. Under constant load, it
+// is sampled after this long instead: the uncounted bytes then even out.
+const int kMaxThroughputSampleMs = 2000;
+
+double UpdateAverage(double average, double sample) {
+  if (average <= 0)
+    return sample;
+  return average + kSampleWeight * (sample - average);
+}
+
+}  // namespace
+
+const size_t ResourceLoadEstimator::kMinDelayableRequestWindow = 2;
+const size_t ResourceLoadEstimator::kMaxDelayableRequestWindow = 16;
+
+ResourceLoadEstimator::ResourceLoadEstimator()
+    : num_loads_in_flight_(0),
+      unsampled_bytes_(0),
+      throughput_bytes_per_second_(0),
+      average_response_bytes_(0) {
+}
+
+ResourceLoadEstimator::~ResourceLoadEstimator() {
+}
+
+void ResourceLoadEstimator::OnLoadStarted(base::TimeTicks now) {
+  UpdateBusyTime(now);
+  ++num_loads_in_flight_;
+}
+
+void ResourceLoadEstimator::OnLoadFinished(base::TimeTicks now,
+                                           int64 received_bytes,
+                                           base::TimeDelta rtt) {
+  DCHECK_GT(num_loads_in_flight_, 0);
+  UpdateBusyTime(now);
+  --num_loads_in_flight_;
+
+  if (rtt > base::TimeDelta()) {
+    rtt_ = base::TimeDelta::FromInternalValue(static_cast<int64>(
+        UpdateAverage(rtt_.ToInternalValue(), rtt.ToInternalValue())));
+  }
+
+  // Loads that didn't touch the network say nothing about its throughput, but
+  // the time they took still counts: they competed for the same slots.
+  if (received_bytes <= 0)
+    return;
+  average_response_bytes_ = UpdateAverage(average_response_bytes_,
+                                          received_bytes);
+  unsampled_bytes_ += received_bytes;
+  if (busy_time_.InMilliseconds() < kMinThroughputSampleMs)
+    return;
+  if (num_loads_in_flight_ > 0 &&
+      busy_time_.InMilliseconds() < kMaxThroughputSampleMs) {
+    return;
+  }
+  throughput_bytes_per_second_ = UpdateAverage(
+      throughput_bytes_per_second_, unsampled_bytes_ / busy_time_.InSecondsF());
+  unsampled_bytes_ = 0;
+  busy_time_ = base::TimeDelta();
+}
+
+bool ResourceLoadEstimator::HasEstimate() const {
+  return throughput_bytes_per_second_ > 0 && rtt_ > base::TimeDelta();
+}
+
+size_t ResourceLoadEstimator::GetDelayableRequestWindow(
+    size_t default_window) const {
+  if (!HasEstimate())
+    return default_window;
+  double bandwidth_delay_bytes =
+      throughput_bytes_per_second_ * rtt_.InSecondsF();
+  double window = 1 + bandwidth_delay_bytes / average_response_bytes_;
+  window = std::min<double>(window, kMaxDelayableRequestWindow);
+  return std::max(kMinDelayableRequestWindow, static_cast<size_t>(window));
+}
+
+void ResourceLoadEstimator::AddToDictionary(
+    base::DictionaryValue* dict) const {
+  dict->SetInteger("throughput_kbps",
+                   static_cast<int>(throughput_bytes_per_second_ * 8 / 1000));
+  dict->SetInteger("rtt_ms", static_cast<int>(rtt_.InMilliseconds()));
+}
+
+void ResourceLoadEstimator::UpdateBusyTime(base::TimeTicks now) {
+  if (num_loads_in_flight_ > 0 && now > last_update_)
+    busy_time_ += now - last_update_;
+  last_update_ = now;
+}
+
+}  // namespace content
@@ -0,0 +1,83 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CONTENT_BROWSER_LOADER_RESOURCE_LOAD_ESTIMATOR_H_
+#define CONTENT_BROWSER_LOADER_RESOURCE_LOAD_ESTIMATOR_H_
+
+#include "base/basictypes.h"
+#include "base/time/time.h"
+#include "content/common/content_export.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace content {
+
+// Estimates the throughput and round trip time of the network seen by one
+// ResourceScheduler client from the loads it completes, and derives how many
+// delayable requests it should keep in flight.
+//
+// Throughput is measured over the time the client has any load in flight,
+// rather than per load, so that concurrent loads sharing a link don't each
+// look slow. The estimates are exponentially weighted moving averages, so they
+// follow changes in the network without jumping on every sample.
+class CONTENT_EXPORT ResourceLoadEstimator {
+ public:
+  // The bounds of GetDelayableRequestWindow().
+  static const size_t kMinDelayableRequestWindow;
+  static const size_t kMaxDelayableRequestWindow;
+
+  ResourceLoadEstimator();
+  ~ResourceLoadEstimator();
+
+  // Called when the client starts and finishes a load. |received_bytes| is
+  // what was read from the network, and |rtt| is the time between sending the
+  // request and receiving the response headers, or zero if unknown, such as
+  // for cached responses.
+  void OnLoadStarted(base::TimeTicks now);
+  void OnLoadFinished(base::TimeTicks now,
+                      int64 received_bytes,
+                      base::TimeDelta rtt);
+
+  // Returns true once both throughput and round trip time have been measured.
+  bool HasEstimate() const;
+
+  // Returns the number of delayable requests that keeps the link busy without
+  // queuing behind each other: one more than the number of average responses
+  // that fit in the bandwidth-delay product, within the bounds above. Returns
+  // |default_window| until there is an estimate.
+  size_t GetDelayableRequestWindow(size_t default_window) const;
+
+  double throughput_bytes_per_second() const {
+    return throughput_bytes_per_second_;
+  }
+  base::TimeDelta rtt() const { return rtt_; }
+
+  // Adds the estimates to |dict|, for the net-log.
+  void AddToDictionary(base::DictionaryValue* dict) const;
+
+ private:
+  // Adds the time since |last_update_| to |busy_time_| if loads were in
+  // flight.
+  void UpdateBusyTime(base::TimeTicks now);
+
+  int num_loads_in_flight_;
+  base::TimeTicks last_update_;
+
+  // Bytes received, and time spent with loads in flight, since the last
+  // throughput sample.
+  int64 unsampled_bytes_;
+  base::TimeDelta busy_time_;
+
+  double throughput_bytes_per_second_;
+  double average_response_bytes_;
+  base::TimeDelta rtt_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResourceLoadEstimator);
+};
+
+}  // namespace content
+
+#endif  // CONTENT_BROWSER_LOADER_RESOURCE_LOAD_ESTIMATOR_H_
@@ -0,0 +1,106 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/loader/resource_load_estimator.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace content {
+
+namespace {
+
+const size_t kDefaultWindow = 10;
+
+base::TimeDelta Ms(int64 ms) {
+  return base::TimeDelta::FromMilliseconds(ms);
+}
+
+TEST(ResourceLoadEstimatorTest, NoEstimateWithoutSamples) {
+  ResourceLoadEstimator estimator;
+  EXPECT_FALSE(estimator.HasEstimate());
+  EXPECT_EQ(kDefaultWindow, estimator.GetDelayableRequestWindow(
+      kDefaultWindow));
+
+  // Loads that don't read from the network don't make an estimate either.
+  base::TimeTicks now = base::TimeTicks::Now();
+  estimator.OnLoadStarted(now);
+  estimator.OnLoadFinished(now + Ms(100), 0, base::TimeDelta());
+  EXPECT_FALSE(estimator.HasEstimate());
+  EXPECT_EQ(kDefaultWindow, estimator.GetDelayableRequestWindow(
+      kDefaultWindow));
+}
+
+TEST(ResourceLoadEstimatorTest, ConcurrentLoadsShareTheLink) {
+  ResourceLoadEstimator estimator;
+  base::TimeTicks now = base::TimeTicks::Now();
+
+  // Two loads of 50000 bytes over the same second: 100000 bytes per second,
+  // not 50000.
+  estimator.OnLoadStarted(now);
+  estimator.OnLoadStarted(now);
+  estimator.OnLoadFinished(now + Ms(1000), 50000, Ms(100));
+  estimator.OnLoadFinished(now + Ms(1000), 50000, Ms(100));
+  ASSERT_TRUE(estimator.HasEstimate());
+  EXPECT_DOUBLE_EQ(100000, estimator.throughput_bytes_per_second());
+  EXPECT_EQ(Ms(100), estimator.rtt());
+
+  // Idle time doesn't count.
+  now += Ms(5000);
+  estimator.OnLoadStarted(now);
+  estimator.OnLoadFinished(now + Ms(1000), 100000, Ms(100));
+  EXPECT_DOUBLE_EQ(100000, estimator.throughput_bytes_per_second());
+}
+
+TEST(ResourceLoadEstimatorTest, WindowFollowsBandwidthDelayProduct) {
+  base::TimeTicks now = base::TimeTicks::Now();
+
+  // A slow link: 20000 bytes per second and 400 ms round trips only fit 8000
+  // bytes in flight, less than one response.
+  ResourceLoadEstimator slow;
+  slow.OnLoadStarted(now);
+  slow.OnLoadFinished(now + Ms(1000), 20000, Ms(400));
+  EXPECT_EQ(ResourceLoadEstimator::kMinDelayableRequestWindow,
+            slow.GetDelayableRequestWindow(kDefaultWindow));
+
+  // 1000000 bytes per second and 100 ms round trips fit 5 responses of 20000
+  // bytes in flight.
+  ResourceLoadEstimator medium;
+  medium.OnLoadStarted(now);
+  medium.OnLoadFinished(now + Ms(20), 20000, Ms(100));
+  medium.OnLoadStarted(now + Ms(20));
+  medium.OnLoadFinished(now + Ms(40), 20000, Ms(100));
+  medium.OnLoadStarted(now + Ms(40));
+  medium.OnLoadFinished(now + Ms(60), 20000, Ms(100));
+  EXPECT_DOUBLE_EQ(1000000, medium.throughput_bytes_per_second());
+  EXPECT_EQ(6u, medium.GetDelayableRequestWindow(kDefaultWindow));
+
+  // A fast link is capped: 2000000 bytes per second and 200 ms round trips
+  // would fit 40 responses of 10000 bytes.
+  ResourceLoadEstimator fast;
+  for (int i = 0; i < 20; ++i)
+    fast.OnLoadStarted(now);
+  for (int i = 0; i < 20; ++i)
+    fast.OnLoadFinished(now + Ms(100), 10000, Ms(200));
+  EXPECT_DOUBLE_EQ(2000000, fast.throughput_bytes_per_second());
+  EXPECT_EQ(ResourceLoadEstimator::kMaxDelayableRequestWindow,
+            fast.GetDelayableRequestWindow(kDefaultWindow));
+}
+
+TEST(ResourceLoadEstimatorTest, MovingAverage) {
+  ResourceLoadEstimator estimator;
+  base::TimeTicks now = base::TimeTicks::Now();
+
+  estimator.OnLoadStarted(now);
+  estimator.OnLoadFinished(now + Ms(1000), 100000, Ms(100));
+  estimator.OnLoadStarted(now + Ms(1000));
+  estimator.OnLoadFinished(now + Ms(2000), 500000, Ms(500));
+
+  // The new samples move the estimates a quarter of the way.
+  EXPECT_DOUBLE_EQ(200000, estimator.throughput_bytes_per_second());
+  EXPECT_EQ(Ms(200), estimator.rtt());
+}
+
+}  // namespace
+
+}  // namespace content
@@ -4,8 +4,11 @@
 
 #include "content/browser/loader/resource_scheduler.h"
 
+#include "base/bind.h"
 #include "base/stl_util.h"
+#include "base/values.h"
 #include "content/common/resource_messages.h"
+#include "content/browser/loader/resource_load_estimator.h"
 #include "content/browser/loader/resource_message_delegate.h"
 #include "content/public/browser/resource_controller.h"
 #include "content/public/browser/resource_request_info.h"
@@ -13,6 +16,8 @@
 #include "ipc/ipc_message_macros.h"
 #include "net/base/host_port_pair.h"
 #include "net/base/load_flags.h"
+#include "net/base/load_timing_info.h"
+#include "net/base/net_log.h"
 #include "net/base/request_priority.h"
 #include "net/http/http_server_properties.h"
 #include "net/url_request/url_request.h"
@@ -23,6 +28,25 @@ namespace content {
 static const size_t kMaxNumDelayableRequestsPerClient = 10;
 static const size_t kMaxNumDelayableRequestsPerHost = 6;
 
+namespace {
+
+// Returns the parameters of the RESOURCE_SCHEDULER_DELAYED net-log events.
+base::Value* NetLogSchedulerStateCallback(
+    size_t max_delayable_requests,
+    size_t delayable_requests_in_flight,
+    const ResourceLoadEstimator* load_estimator,
+    net::NetLog::LogLevel /* log_level */) {
+  base::DictionaryValue* dict = new base::DictionaryValue();
+  dict->SetInteger("max_delayable_requests",
+                   static_cast<int>(max_delayable_requests));
+  dict->SetInteger("delayable_requests_in_flight",
+                   static_cast<int>(delayable_requests_in_flight));
+  load_estimator->AddToDictionary(dict);
+  return dict;
+}
+
+}  // namespace
+
 // A thin wrapper around net::PriorityQueue that deals with
 // ScheduledResourceRequests instead of PriorityQueue::Pointers.
 class ResourceScheduler::RequestQueue {
@@ -185,6 +209,7 @@ struct ResourceScheduler::Client {
   bool using_spdy_proxy;
   RequestQueue pending_requests;
   RequestSet in_flight_requests;
+  ResourceLoadEstimator load_estimator;
 };
 
 ResourceScheduler::ResourceScheduler() {
@@ -219,6 +244,7 @@ scoped_ptr<ResourceThrottle> ResourceScheduler::ScheduleRequest(
   if (ShouldStartRequest(request.get(), client) == START_REQUEST) {
     StartRequest(request.get(), client);
   } else {
+    LogSchedulerState(request.get(), client, true);
     client->pending_requests.Insert(request.get(), url_request->priority());
   }
   return request.PassAs<ResourceThrottle>();
@@ -241,10 +267,24 @@ void ResourceScheduler::RemoveRequest(ScheduledResourceRequest* request) {
   if (client->pending_requests.IsQueued(request)) {
     client->pending_requests.Erase(request);
     DCHECK(!ContainsKey(client->in_flight_requests, request));
+    request->url_request()->net_log().EndEvent(
+        net::NetLog::TYPE_RESOURCE_SCHEDULER_DELAYED);
   } else {
     size_t erased = client->in_flight_requests.erase(request);
     DCHECK(erased);
 
+    // Cached responses say nothing about the round trip time.
+    const net::URLRequest* url_request = request->url_request();
+    net::LoadTimingInfo load_timing;
+    url_request->GetLoadTimingInfo(&load_timing);
+    base::TimeDelta rtt;
+    if (!url_request->was_cached() && !load_timing.send_start.is_null() &&
+        !load_timing.receive_headers_end.is_null()) {
+      rtt = load_timing.receive_headers_end - load_timing.send_start;
+    }
+    client->load_estimator.OnLoadFinished(
+        base::TimeTicks::Now(), url_request->GetTotalReceivedBytes(), rtt);
+
     // Removing this request may have freed up another to load.
     LoadAnyStartablePendingRequests(client);
   }
@@ -332,9 +372,38 @@ void ResourceScheduler::OnReceivedSpdyProxiedHttpResponse(
 void ResourceScheduler::StartRequest(ScheduledResourceRequest* request,
                                      Client* client) {
   client->in_flight_requests.insert(request);
+  client->load_estimator.OnLoadStarted(base::TimeTicks::Now());
   request->Start();
 }
 
+void ResourceScheduler::LogSchedulerState(ScheduledResourceRequest* request,
+                                          Client* client,
+                                          bool delayed) {
+  const net::BoundNetLog& net_log = request->url_request()->net_log();
+  if (!net_log.IsLogging())
+    return;
+
+  net::HostPortPair host_port_pair =
+      net::HostPortPair::FromURL(request->url_request()->url());
+  size_t num_delayable_requests_in_flight = 0;
+  size_t num_requests_in_flight_for_host = 0;
+  GetNumDelayableRequestsInFlight(client, host_port_pair,
+                                  &num_delayable_requests_in_flight,
+                                  &num_requests_in_flight_for_host);
+  net::NetLog::ParametersCallback callback = base::Bind(
+      &NetLogSchedulerStateCallback,
+      GetMaxDelayableRequestsInFlight(client,
+                                      num_delayable_requests_in_flight),
+      num_delayable_requests_in_flight,
+      base::Unretained(&client->load_estimator));
+  if (delayed) {
+    net_log.BeginEvent(net::NetLog::TYPE_RESOURCE_SCHEDULER_DELAYED,
+                       callback);
+  } else {
+    net_log.EndEvent(net::NetLog::TYPE_RESOURCE_SCHEDULER_DELAYED, callback);
+  }
+}
+
 void ResourceScheduler::ReprioritizeRequest(ScheduledResourceRequest* request,
                                             net::RequestPriority new_priority) {
   if (request->url_request()->load_flags() & net::LOAD_IGNORE_LIMITS) {
@@ -388,6 +457,7 @@ void ResourceScheduler::LoadAnyStartablePendingRequests(Client* client) {
 
     if (query_result == START_REQUEST) {
       client->pending_requests.Erase(request);
+      LogSchedulerState(request, client, false);
       StartRequest(request, client);
 
       // StartRequest can modify the pending list, so we (re)start evaluation
@@ -438,6 +508,25 @@ void ResourceScheduler::GetNumDelayableRequestsInFlight(
   *total_for_active_host = same_host_count;
 }
 
+size_t ResourceScheduler::GetMaxDelayableRequestsInFlight(
+    Client* client,
+    size_t num_delayable_requests_in_flight) const {
+  const ResourceLoadEstimator& load_estimator = client->load_estimator;
+  if (!load_estimator.HasEstimate())
+    return kMaxNumDelayableRequestsPerClient;
+
+  // The requests that aren't delayable, such as scripts and stylesheets that
+  // block rendering, share the same link and come first, so they take their
+  // share of the window.
+  size_t window = load_estimator.GetDelayableRequestWindow(
+      kMaxNumDelayableRequestsPerClient);
+  size_t num_immediate_requests_in_flight =
+      client->in_flight_requests.size() - num_delayable_requests_in_flight;
+  if (num_immediate_requests_in_flight >= window)
+    return 1;
+  return window - num_immediate_requests_in_flight;
+}
+
 // ShouldStartRequest is the main scheduling algorithm.
 //
 // Requests are categorized into two categories:
@@ -454,7 +543,9 @@ void ResourceScheduler::GetNumDelayableRequestsInFlight(
 //   * If no high priority requests are in flight, start loading low priority
 //     requests.
 //   * Once the renderer has a <body>, start loading delayable requests.
-//   * Never exceed 10 delayable requests in flight per client.
+//   * Never exceed 10 delayable requests in flight per client. Once the
+//     client's throughput and round trip time have been measured, the limit
+//     is instead what keeps its link busy, less the other requests in flight.
 //   * Never exceed 6 delayable requests for a given host.
 //   * Prior to <body>, allow one delayable request to load at a time.
 ResourceScheduler::ShouldStartReqResult ResourceScheduler::ShouldStartRequest(
@@ -496,7 +587,9 @@ ResourceScheduler::ShouldStartReqResult ResourceScheduler::ShouldStartRequest(
                                   &num_delayable_requests_in_flight,
                                   &num_requests_in_flight_for_host);
 
-  if (num_delayable_requests_in_flight >= kMaxNumDelayableRequestsPerClient) {
+  if (num_delayable_requests_in_flight >=
+      GetMaxDelayableRequestsInFlight(client,
+                                      num_delayable_requests_in_flight)) {
     return DO_NOT_START_REQUEST_AND_STOP_SEARCHING;
   }
 
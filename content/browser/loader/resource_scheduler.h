@@ -99,6 +99,12 @@ class CONTENT_EXPORT ResourceScheduler : public base::NonThreadSafe {
   // Unthrottles the |request| and adds it to |client|.
   void StartRequest(ScheduledResourceRequest* request, Client* client);
 
+  // Logs the start or the end of the time |request| is held in the queue of
+  // |client|, with the state of |client| that decided it.
+  void LogSchedulerState(ScheduledResourceRequest* request,
+                         Client* client,
+                         bool delayed);
+
   // Update the queue position for |request|, possibly causing it to start
   // loading.
   //
@@ -120,6 +126,12 @@ class CONTENT_EXPORT ResourceScheduler : public base::NonThreadSafe {
       size_t* total_delayable,
       size_t* total_for_active_host) const;
 
+  // Returns the number of delayable requests |client| may have in flight,
+  // from its load estimates.
+  size_t GetMaxDelayableRequestsInFlight(
+      Client* client,
+      size_t num_delayable_requests_in_flight) const;
+
   enum ShouldStartReqResult {
     DO_NOT_START_REQUEST_AND_STOP_SEARCHING = -2,
     DO_NOT_START_REQUEST_AND_KEEP_SEARCHING = -1,
@@ -38,8 +38,8 @@ class TestRequest : public ResourceController {
   TestRequest(scoped_ptr<ResourceThrottle> throttle,
               scoped_ptr<net::URLRequest> url_request)
       : started_(false),
-        throttle_(throttle.Pass()),
-        url_request_(url_request.Pass()) {
+        url_request_(url_request.Pass()),
+        throttle_(throttle.Pass()) {
     throttle_->set_controller_for_testing(this);
   }
 
@@ -62,8 +62,9 @@ class TestRequest : public ResourceController {
 
  private:
   bool started_;
-  scoped_ptr<ResourceThrottle> throttle_;
+  // As in ResourceLoader, the throttle goes away before the request.
   scoped_ptr<net::URLRequest> url_request_;
+  scoped_ptr<ResourceThrottle> throttle_;
 };
 
 class CancelingTestRequest : public TestRequest {
@@ -4,6 +4,8 @@
 
 #include "content/browser/media/capture/content_video_capture_device_core.h"
 
+#include <algorithm>
+
 #include "base/basictypes.h"
 #include "base/bind.h"
 #include "base/callback_forward.h"
@@ -38,6 +40,18 @@ void DeleteCaptureMachineOnUIThread(
   capture_machine.reset();
 }
 
+// Shrinks |size| by a quarter in each dimension per step, keeping both
+// dimensions even and non-zero.
+gfx::Size ReduceCaptureSize(const gfx::Size& size, int steps) {
+  int width = size.width();
+  int height = size.height();
+  for (int i = 0; i < steps; ++i) {
+    width = width * 3 / 4;
+    height = height * 3 / 4;
+  }
+  return gfx::Size(std::max(2, MakeEven(width)), std::max(2, MakeEven(height)));
+}
+
 }  // namespace
 
 ThreadSafeCaptureOracle::ThreadSafeCaptureOracle(
@@ -68,8 +82,16 @@ bool ThreadSafeCaptureOracle::ObserveEventAndDecideCapture(
   if (!client_)
     return false;  // Capture is stopped.
 
+  // Step the resolution down while the consumer can't keep up, if it allows
+  // the resolution to change.
+  gfx::Size frame_size = capture_size_;
+  if (params_.allow_resolution_change) {
+    frame_size =
+        ReduceCaptureSize(capture_size_, oracle_->size_reduction_steps());
+  }
+
   scoped_refptr<media::VideoCaptureDevice::Client::Buffer> output_buffer =
-      client_->ReserveOutputBuffer(media::VideoFrame::I420, capture_size_);
+      client_->ReserveOutputBuffer(media::VideoFrame::I420, frame_size);
   const bool should_capture =
       oracle_->ObserveEventAndDecideCapture(event, event_time);
   const bool content_is_dirty =
@@ -82,6 +104,7 @@ bool ThreadSafeCaptureOracle::ObserveEventAndDecideCapture(
 
   // Consider the various reasons not to initiate a capture.
   if (should_capture && !output_buffer) {
+    oracle_->RecordBackpressure();
     TRACE_EVENT_INSTANT1("mirroring",
                          "EncodeLimited",
                          TRACE_EVENT_SCOPE_THREAD,
@@ -112,9 +135,9 @@ bool ThreadSafeCaptureOracle::ObserveEventAndDecideCapture(
                            "trigger", event_name);
   *storage = media::VideoFrame::WrapExternalPackedMemory(
       media::VideoFrame::I420,
-      capture_size_,
-      gfx::Rect(capture_size_),
-      capture_size_,
+      frame_size,
+      gfx::Rect(frame_size),
+      frame_size,
       static_cast<uint8*>(output_buffer->data()),
       output_buffer->size(),
       base::SharedMemory::NULLHandle(),
@@ -186,7 +209,7 @@ void ThreadSafeCaptureOracle::DidCaptureFrame(
       client_->OnIncomingCapturedVideoFrame(
           buffer,
           media::VideoCaptureFormat(
-              capture_size_, frame_rate_, media::PIXEL_FORMAT_I420),
+              frame->coded_size(), frame_rate_, media::PIXEL_FORMAT_I420),
           frame,
           timestamp);
     }
@@ -4,6 +4,8 @@
 
 #include "content/browser/media/capture/video_capture_oracle.h"
 
+#include <algorithm>
+
 #include "base/debug/trace_event.h"
 
 namespace content {
@@ -21,11 +23,26 @@ namespace {
 // further into the WebRTC encoding stack.
 const int kNumRedundantCapturesOfStaticContent = 200;
 
+// The largest multiple of the capture period that captures are spaced by
+// while the consumer can't keep up.
+const int kMaxBackpressureCapturePeriods = 4;
+
+// The largest number of steps by which the capture size is reduced.
+const int kMaxSizeReductionSteps = 3;
+
+// How many captures must go through at the target rate before the capture
+// size is stepped back up.  This is long enough that the stepping doesn't
+// oscillate at the edge of what the consumer can keep up with.
+const int kCapturesBeforeSizeIncrease = 60;
+
 }  // anonymous namespace
 
 VideoCaptureOracle::VideoCaptureOracle(base::TimeDelta capture_period,
                                        bool events_are_reliable)
     : capture_period_(capture_period),
+      min_capture_interval_(capture_period),
+      size_reduction_steps_(0),
+      captures_without_backpressure_(0),
       frame_number_(0),
       last_delivered_frame_number_(0),
       sampler_(capture_period_,
@@ -45,14 +62,57 @@ bool VideoCaptureOracle::ObserveEventAndDecideCapture(
   } else {
     should_sample = sampler_.IsOverdueForSamplingAt(event_time);
   }
+  last_event_time_ = event_time;
+
+  // Hold off while the consumer is pushing back.
+  if (should_sample && min_capture_interval_ > capture_period_ &&
+      !last_capture_time_.is_null() &&
+      event_time - last_capture_time_ < min_capture_interval_) {
+    should_sample = false;
+  }
   return should_sample;
 }
 
 int VideoCaptureOracle::RecordCapture() {
   sampler_.RecordSample();
+  last_capture_time_ = last_event_time_;
+
+  // The consumer had room for this frame, so step back towards the target
+  // capture rate.
+  last_backpressure_time_ = base::TimeTicks();
+  min_capture_interval_ =
+      std::max(capture_period_, min_capture_interval_ - capture_period_ / 4);
+  if (min_capture_interval_ == capture_period_ && size_reduction_steps_ > 0 &&
+      ++captures_without_backpressure_ >= kCapturesBeforeSizeIncrease) {
+    --size_reduction_steps_;
+    captures_without_backpressure_ = 0;
+  }
   return frame_number_;
 }
 
+void VideoCaptureOracle::RecordBackpressure() {
+  // Back off at most once per capture interval, not on every event.
+  if (!last_backpressure_time_.is_null() &&
+      last_event_time_ - last_backpressure_time_ < min_capture_interval_) {
+    return;
+  }
+  last_backpressure_time_ = last_event_time_;
+  captures_without_backpressure_ = 0;
+
+  // If the capture rate is as low as it goes, trade resolution for it.
+  const base::TimeDelta max_capture_interval =
+      capture_period_ * kMaxBackpressureCapturePeriods;
+  if (min_capture_interval_ == max_capture_interval &&
+      size_reduction_steps_ < kMaxSizeReductionSteps) {
+    ++size_reduction_steps_;
+  }
+  min_capture_interval_ =
+      std::min(max_capture_interval, min_capture_interval_ * 2);
+  TRACE_COUNTER1("mirroring",
+                 "MirroringMinCaptureIntervalUsec",
+                 min_capture_interval_.InMicroseconds());
+}
+
 bool VideoCaptureOracle::CompleteCapture(int frame_number,
                                          base::TimeTicks timestamp) {
   // Drop frame if previous frame number is higher or we're trying to deliver
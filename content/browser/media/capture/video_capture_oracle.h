@@ -76,17 +76,50 @@ class CONTENT_EXPORT VideoCaptureOracle {
   // CompleteCapture().
   int RecordCapture();
 
+  // Record that the capture decided by the last call to
+  // ObserveEventAndDecideCapture() could not start, because the consumer still
+  // holds every output buffer: the encoder is falling behind.  Until captures
+  // succeed again, they are spaced further apart so that the encoder is not
+  // handed a burst of frames as soon as it catches up.
+  void RecordBackpressure();
+
   // Record the completion of a capture.  Returns true iff the captured frame
   // should be delivered.
   bool CompleteCapture(int frame_number, base::TimeTicks timestamp);
 
   base::TimeDelta capture_period() const { return capture_period_; }
 
+  // The number of steps by which the capture size should be reduced.  This
+  // grows when the consumer keeps pushing back even at the lowest capture
+  // rate, and shrinks again once it has kept up at the target rate for a
+  // while.
+  int size_reduction_steps() const { return size_reduction_steps_; }
+
  private:
 
   // Time between frames.
   const base::TimeDelta capture_period_;
 
+  // Minimum time between the starts of two captures.  This grows above
+  // |capture_period_| while the consumer pushes back; see
+  // RecordBackpressure().
+  base::TimeDelta min_capture_interval_;
+
+  // The time of the event RecordBackpressure() last counted, if it was since
+  // the last capture.
+  base::TimeTicks last_backpressure_time_;
+
+  // See size_reduction_steps().
+  int size_reduction_steps_;
+
+  // The number of captures at |capture_period_| since the consumer last
+  // pushed back.
+  int captures_without_backpressure_;
+
+  // The time of the last observed event and of the last capture.
+  base::TimeTicks last_event_time_;
+  base::TimeTicks last_capture_time_;
+
   // Incremented every time a paint or update event occurs.
   int frame_number_;
 
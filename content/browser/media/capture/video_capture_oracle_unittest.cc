@@ -483,5 +483,91 @@ TEST(SmoothEventSamplerTest, DrawingAt60FpsWith60HzVsyncSampledAt30Hertz) {
   ReplayCheckingSamplerDecisions(data_points, arraysize(data_points), &sampler);
 }
 
+// Advances |t| by |vsync| until |oracle| decides to capture a compositor
+// update.
+void AdvanceToNextCapture(base::TimeDelta vsync,
+                          VideoCaptureOracle* oracle,
+                          base::TimeTicks* t) {
+  for (int i = 0; i < 100; ++i) {
+    *t += vsync;
+    if (oracle->ObserveEventAndDecideCapture(
+            VideoCaptureOracle::kCompositorUpdate, *t)) {
+      return;
+    }
+  }
+  FAIL() << "Oracle never decided to capture.";
+}
+
+TEST(VideoCaptureOracleTest, BacksOffWhileConsumerPushesBack) {
+  const base::TimeDelta capture_period = base::TimeDelta::FromSeconds(1) / 30;
+  const base::TimeDelta vsync = base::TimeDelta::FromSeconds(1) / 60;
+  VideoCaptureOracle oracle(capture_period, true);
+
+  base::TimeTicks t;
+  AdvanceToNextCapture(vsync, &oracle, &t);
+  oracle.RecordCapture();
+  base::TimeTicks last_capture = t;
+
+  // The consumer has no room for the next frame.
+  AdvanceToNextCapture(vsync, &oracle, &t);
+  EXPECT_GT(capture_period * 2, t - last_capture);
+  oracle.RecordBackpressure();
+
+  // Backpressure on every update only counts once.
+  AdvanceToNextCapture(vsync, &oracle, &t);
+  oracle.RecordBackpressure();
+  AdvanceToNextCapture(vsync, &oracle, &t);
+  EXPECT_LE(capture_period * 2, t - last_capture);
+  EXPECT_GT(capture_period * 3, t - last_capture);
+
+  // Once frames go through again, the capture rate recovers.
+  for (int i = 0; i < 10; ++i) {
+    oracle.RecordCapture();
+    last_capture = t;
+    AdvanceToNextCapture(vsync, &oracle, &t);
+  }
+  EXPECT_GT(capture_period + vsync / 2, t - last_capture);
+}
+
+TEST(VideoCaptureOracleTest, StepsCaptureSizeUnderSustainedBackpressure) {
+  const base::TimeDelta capture_period = base::TimeDelta::FromSeconds(1) / 30;
+  const base::TimeDelta vsync = base::TimeDelta::FromSeconds(1) / 60;
+  VideoCaptureOracle oracle(capture_period, true);
+
+  base::TimeTicks t;
+  AdvanceToNextCapture(vsync, &oracle, &t);
+  oracle.RecordCapture();
+
+  // The consumer has no room for any frame.  Lowering the capture rate is
+  // tried first.
+  base::TimeTicks end = t + capture_period * 4;
+  while (t < end) {
+    AdvanceToNextCapture(vsync, &oracle, &t);
+    oracle.RecordBackpressure();
+  }
+  EXPECT_EQ(0, oracle.size_reduction_steps());
+
+  // Then the capture size, down to a limit.
+  end = t + base::TimeDelta::FromSeconds(1);
+  while (t < end) {
+    AdvanceToNextCapture(vsync, &oracle, &t);
+    oracle.RecordBackpressure();
+  }
+  EXPECT_EQ(3, oracle.size_reduction_steps());
+
+  // The size is stepped back up only after the consumer keeps up at the full
+  // capture rate for a while.
+  for (int i = 0; i < 20; ++i) {
+    oracle.RecordCapture();
+    AdvanceToNextCapture(vsync, &oracle, &t);
+  }
+  EXPECT_EQ(3, oracle.size_reduction_steps());
+  for (int i = 0; i < 1000 && oracle.size_reduction_steps() > 0; ++i) {
+    oracle.RecordCapture();
+    AdvanceToNextCapture(vsync, &oracle, &t);
+  }
+  EXPECT_EQ(0, oracle.size_reduction_steps());
+}
+
 }  // namespace
 }  // namespace content
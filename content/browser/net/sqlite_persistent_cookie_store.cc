@@ -143,11 +143,17 @@ class SQLitePersistentCookieStore::Backend
     OperationType op() const { return op_; }
     const net::CanonicalCookie& cc() const { return cc_; }
 
+    void set_last_access_date(const base::Time& date) {
+      cc_.SetLastAccessDate(date);
+    }
+
    private:
     OperationType op_;
     net::CanonicalCookie cc_;
   };
 
+  typedef std::list<PendingOperation*> PendingOperationsList;
+
  private:
   // Creates or loads the SQLite database on background runner.
   void LoadAndNotifyInBackground(const LoadedCallback& loaded_callback,
@@ -196,6 +202,10 @@ class SQLitePersistentCookieStore::Backend
   // Batch a cookie operation (add or delete)
   void BatchOperation(PendingOperation::OperationType op,
                       const net::CanonicalCookie& cc);
+  // Adds |po| to |pending_|, collapsing it with a pending operation on the
+  // same cookie where possible.  Returns false if |po| was collapsed rather
+  // than queued.  Must be called with |lock_| held.
+  bool AddPendingOperation(scoped_ptr<PendingOperation> po);
   // Commit our pending operations to the database.
   void Commit();
   // Close() executed on the background runner.
@@ -217,12 +227,16 @@ class SQLitePersistentCookieStore::Backend
   scoped_ptr<sql::Connection> db_;
   sql::MetaTable meta_table_;
 
-  typedef std::list<PendingOperation*> PendingOperationsList;
   PendingOperationsList pending_;
   PendingOperationsList::size_type num_pending_;
+  // Maps the creation time of each cookie with a pending operation to its
+  // latest operation in |pending_|.
+  typedef std::map<int64, PendingOperationsList::iterator> PendingOperationsMap;
+  PendingOperationsMap pending_by_creation_;
   // True if the persistent store should skip delete on exit rules.
   bool force_keep_session_state_;
-  // Guard |cookies_|, |pending_|, |num_pending_|, |force_keep_session_state_|
+  // Guard |cookies_|, |pending_|, |num_pending_|, |pending_by_creation_|,
+  // |force_keep_session_state_|
   base::Lock lock_;
 
   // Temporary buffer for cookies loaded from DB. Accumulates cookies to reduce
@@ -935,8 +949,9 @@ void SQLitePersistentCookieStore::Backend::BatchOperation(
   PendingOperationsList::size_type num_pending;
   {
     base::AutoLock locked(lock_);
-    pending_.push_back(po.release());
-    num_pending = ++num_pending_;
+    if (!AddPendingOperation(po.Pass()))
+      return;
+    num_pending = num_pending_;
   }
 
   if (num_pending == 1) {
@@ -952,6 +967,46 @@ void SQLitePersistentCookieStore::Backend::BatchOperation(
   }
 }
 
+bool SQLitePersistentCookieStore::Backend::AddPendingOperation(
+    scoped_ptr<PendingOperation> po) {
+  lock_.AssertAcquired();
+
+  // Cookies are identified by their creation time in the database.
+  int64 creation = po->cc().CreationDate().ToInternalValue();
+  PendingOperationsMap::iterator found = pending_by_creation_.find(creation);
+  if (found != pending_by_creation_.end() &&
+      (*found->second)->op() != PendingOperation::COOKIE_DELETE) {
+    PendingOperation* previous = *found->second;
+    switch (po->op()) {
+      case PendingOperation::COOKIE_UPDATEACCESS:
+        // Fold the new access time into the pending add or update.
+        previous->set_last_access_date(po->cc().LastAccessDate());
+        return false;
+
+      case PendingOperation::COOKIE_DELETE: {
+        // The pending add or update is superseded.  A cookie that was added
+        // in this batch never has to reach the database at all.
+        bool was_added = previous->op() == PendingOperation::COOKIE_ADD;
+        delete previous;
+        pending_.erase(found->second);
+        pending_by_creation_.erase(found);
+        --num_pending_;
+        if (was_added)
+          return false;
+        break;
+      }
+
+      default:
+        break;
+    }
+  }
+
+  pending_.push_back(po.release());
+  pending_by_creation_[creation] = --pending_.end();
+  ++num_pending_;
+  return true;
+}
+
 void SQLitePersistentCookieStore::Backend::Commit() {
   DCHECK(background_task_runner_->RunsTasksOnCurrentThread());
 
@@ -959,6 +1014,7 @@ void SQLitePersistentCookieStore::Backend::Commit() {
   {
     base::AutoLock locked(lock_);
     pending_.swap(ops);
+    pending_by_creation_.clear();
     num_pending_ = 0;
   }
 
@@ -51,6 +51,13 @@ class SQLitePersistentCookieStorePerfTest : public testing::Test {
     loaded_event_.Wait();
   }
 
+  void Flush() {
+    base::WaitableEvent event(false, false);
+    store_->Flush(base::Bind(&base::WaitableEvent::Signal,
+                             base::Unretained(&event)));
+    event.Wait();
+  }
+
   scoped_refptr<base::SequencedTaskRunner> background_task_runner() {
     return pool_owner_->pool()->GetSequencedTaskRunner(
         pool_owner_->pool()->GetNamedSequenceToken("background"));
@@ -140,4 +147,27 @@ TEST_F(SQLitePersistentCookieStorePerfTest, TestLoadPerformance) {
   ASSERT_EQ(15000U, cookies_.size());
 }
 
+// Test the performance of committing short-lived cookies, which are added,
+// accessed and deleted again before the batch is written.
+TEST_F(SQLitePersistentCookieStorePerfTest, TestCommitChurnPerformance) {
+  Load();
+  ASSERT_EQ(15000U, cookies_.size());
+
+  GURL gurl("www.churn.com");
+  base::Time t = base::Time::Now();
+  base::PerfTimeLogger timer("Commit churned cookies");
+  for (int cookie_num = 0; cookie_num < 5000; ++cookie_num) {
+    t += base::TimeDelta::FromInternalValue(10);
+    net::CanonicalCookie cookie(
+        gurl, base::StringPrintf("Churn_%d", cookie_num), "1", ".churn.com",
+        "/", t, t, t, false, false, net::COOKIE_PRIORITY_DEFAULT);
+    store_->AddCookie(cookie);
+    cookie.SetLastAccessDate(t + base::TimeDelta::FromSeconds(1));
+    store_->UpdateCookieAccessTime(cookie);
+    store_->DeleteCookie(cookie);
+  }
+  Flush();
+  timer.Done();
+}
+
 }  // namespace content
@@ -358,6 +358,35 @@ TEST_F(SQLitePersistentCookieStoreTest, TestFlush) {
   ASSERT_GT(info.size, base_size);
 }
 
+// Test that operations on the same cookie are collapsed before being written.
+TEST_F(SQLitePersistentCookieStoreTest, TestCoalescePendingOperations) {
+  InitializeStore(false, false);
+  base::Time t = base::Time::Now();
+  base::Time later = t + base::TimeDelta::FromMinutes(1);
+
+  // A cookie that is added and deleted within one batch is never written.
+  AddCookie("A", "B", "foo.bar", "/", t);
+  net::CanonicalCookie deleted(GURL(), "A", "B", "foo.bar", "/", t, t, t,
+                               false, false, net::COOKIE_PRIORITY_DEFAULT);
+  store_->DeleteCookie(deleted);
+
+  // A cookie whose access time is updated is written with the latest one.
+  base::Time t2 = t + base::TimeDelta::FromMicroseconds(1);
+  AddCookie("C", "D", "foo.bar", "/", t2);
+  store_->UpdateCookieAccessTime(
+      net::CanonicalCookie(GURL(), "C", "D", "foo.bar", "/", t2, t2, later,
+                           false, false, net::COOKIE_PRIORITY_DEFAULT));
+  Flush();
+  DestroyStore();
+
+  CanonicalCookieVector cookies;
+  CreateAndLoad(false, false, &cookies);
+  ASSERT_EQ(1U, cookies.size());
+  EXPECT_EQ("C", cookies[0]->Name());
+  EXPECT_EQ(later, cookies[0]->LastAccessDate());
+  STLDeleteElements(&cookies);
+}
+
 // Test loading old session cookies from the disk.
 TEST_F(SQLitePersistentCookieStoreTest, TestLoadOldSessionCookies) {
   InitializeStore(false, true);
@@ -0,0 +1,87 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/renderer_host/input/input_latency_aggregator.h"
+
+#include <algorithm>
+
+#include "base/debug/trace_event.h"
+#include "base/logging.h"
+
+namespace content {
+namespace {
+
+// Returns the |percentile|th percentile of |sorted_samples| using the
+// nearest-rank method.
+int64 NearestRank(const std::vector<int64>& sorted_samples, int percentile) {
+  DCHECK(!sorted_samples.empty());
+  size_t rank = (sorted_samples.size() * percentile + 99) / 100;
+  return sorted_samples[std::max<size_t>(rank, 1) - 1];
+}
+
+}  // namespace
+
+InputLatencyAggregator::Window::Window() : next(0), samples_since_report(0) {}
+
+InputLatencyAggregator::Window::~Window() {}
+
+InputLatencyAggregator::InputLatencyAggregator(size_t window_size)
+    : window_size_(window_size) {
+  DCHECK_GT(window_size_, 0u);
+}
+
+InputLatencyAggregator::~InputLatencyAggregator() {}
+
+void InputLatencyAggregator::AddSample(const std::string& metric,
+                                       base::TimeDelta latency) {
+  Window& window = windows_[metric];
+  if (window.samples.size() < window_size_) {
+    window.samples.push_back(latency.InMicroseconds());
+  } else {
+    window.samples[window.next] = latency.InMicroseconds();
+    window.next = (window.next + 1) % window_size_;
+  }
+
+  if (++window.samples_since_report == window_size_) {
+    window.samples_since_report = 0;
+    ReportPercentiles(metric);
+  }
+}
+
+bool InputLatencyAggregator::GetPercentiles(const std::string& metric,
+                                            Percentiles* percentiles) const {
+  WindowMap::const_iterator it = windows_.find(metric);
+  if (it == windows_.end())
+    return false;
+
+  std::vector<int64> sorted_samples(it->second.samples);
+  std::sort(sorted_samples.begin(), sorted_samples.end());
+  percentiles->p50 = base::TimeDelta::FromMicroseconds(
+      NearestRank(sorted_samples, 50));
+  percentiles->p95 = base::TimeDelta::FromMicroseconds(
+      NearestRank(sorted_samples, 95));
+  percentiles->p99 = base::TimeDelta::FromMicroseconds(
+      NearestRank(sorted_samples, 99));
+  return true;
+}
+
+void InputLatencyAggregator::ReportPercentiles(
+    const std::string& metric) const {
+  bool tracing_enabled = false;
+  TRACE_EVENT_CATEGORY_GROUP_ENABLED("latencyInfo", &tracing_enabled);
+  if (!tracing_enabled)
+    return;
+
+  Percentiles percentiles;
+  if (!GetPercentiles(metric, &percentiles))
+    return;
+  TRACE_COPY_COUNTER1("latencyInfo", (metric + ".p50").c_str(),
+                      percentiles.p50.InMicroseconds());
+  TRACE_COPY_COUNTER1("latencyInfo", (metric + ".p95").c_str(),
+                      percentiles.p95.InMicroseconds());
+  TRACE_COPY_COUNTER1("latencyInfo", (metric + ".p99").c_str(),
+                      percentiles.p99.InMicroseconds());
+}
+
+}  // namespace content
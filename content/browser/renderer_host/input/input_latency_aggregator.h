@@ -0,0 +1,68 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CONTENT_BROWSER_RENDERER_HOST_INPUT_INPUT_LATENCY_AGGREGATOR_H_
+#define CONTENT_BROWSER_RENDERER_HOST_INPUT_INPUT_LATENCY_AGGREGATOR_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/time/time.h"
+#include "content/common/content_export.h"
+
+namespace content {
+
+// Keeps the most recent samples of each input latency metric, such as the
+// time from the creation of a touch event to the frame swap it caused, and
+// computes percentiles over them. Every |window_size| samples of a metric,
+// its 50th, 95th and 99th percentiles are reported to tracing as counters
+// named after the metric, so that tail latency can be followed over time in
+// traces of regular builds. Histograms only show the overall distribution.
+class CONTENT_EXPORT InputLatencyAggregator {
+ public:
+  struct Percentiles {
+    base::TimeDelta p50;
+    base::TimeDelta p95;
+    base::TimeDelta p99;
+  };
+
+  explicit InputLatencyAggregator(size_t window_size);
+  ~InputLatencyAggregator();
+
+  // Adds a latency sample of |metric|, evicting the oldest sample of the
+  // metric if its window is full.
+  void AddSample(const std::string& metric, base::TimeDelta latency);
+
+  // Computes the percentiles of the samples in the window of |metric|.
+  // Returns false if there are no samples for |metric|.
+  bool GetPercentiles(const std::string& metric,
+                      Percentiles* percentiles) const;
+
+ private:
+  // The samples of a metric, in microseconds. Once |samples| holds
+  // |window_size_| samples, |next| is the index of the oldest one.
+  struct Window {
+    Window();
+    ~Window();
+
+    std::vector<int64> samples;
+    size_t next;
+    size_t samples_since_report;
+  };
+  typedef std::map<std::string, Window> WindowMap;
+
+  // Reports the percentiles of |metric| to tracing.
+  void ReportPercentiles(const std::string& metric) const;
+
+  const size_t window_size_;
+  WindowMap windows_;
+
+  DISALLOW_COPY_AND_ASSIGN(InputLatencyAggregator);
+};
+
+}  // namespace content
+
+#endif  // CONTENT_BROWSER_RENDERER_HOST_INPUT_INPUT_LATENCY_AGGREGATOR_H_
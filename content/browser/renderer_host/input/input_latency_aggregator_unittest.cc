@@ -0,0 +1,67 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/renderer_host/input/input_latency_aggregator.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+using base::TimeDelta;
+
+namespace content {
+
+TEST(InputLatencyAggregatorTest, NoSamples) {
+  InputLatencyAggregator aggregator(10);
+  InputLatencyAggregator::Percentiles percentiles;
+  EXPECT_FALSE(aggregator.GetPercentiles("Touch", &percentiles));
+}
+
+TEST(InputLatencyAggregatorTest, Percentiles) {
+  InputLatencyAggregator aggregator(100);
+  // Add the samples out of order; the percentiles must not depend on it.
+  for (int i = 100; i > 0; --i)
+    aggregator.AddSample("Touch", TimeDelta::FromMilliseconds(i));
+
+  InputLatencyAggregator::Percentiles percentiles;
+  ASSERT_TRUE(aggregator.GetPercentiles("Touch", &percentiles));
+  EXPECT_EQ(50, percentiles.p50.InMilliseconds());
+  EXPECT_EQ(95, percentiles.p95.InMilliseconds());
+  EXPECT_EQ(99, percentiles.p99.InMilliseconds());
+}
+
+TEST(InputLatencyAggregatorTest, SingleSample) {
+  InputLatencyAggregator aggregator(100);
+  aggregator.AddSample("Touch", TimeDelta::FromMilliseconds(7));
+
+  InputLatencyAggregator::Percentiles percentiles;
+  ASSERT_TRUE(aggregator.GetPercentiles("Touch", &percentiles));
+  EXPECT_EQ(7, percentiles.p50.InMilliseconds());
+  EXPECT_EQ(7, percentiles.p99.InMilliseconds());
+}
+
+TEST(InputLatencyAggregatorTest, WindowSlides) {
+  InputLatencyAggregator aggregator(10);
+  for (int i = 1; i <= 25; ++i)
+    aggregator.AddSample("Touch", TimeDelta::FromMilliseconds(i));
+
+  // Only the last ten samples, 16 to 25, are left.
+  InputLatencyAggregator::Percentiles percentiles;
+  ASSERT_TRUE(aggregator.GetPercentiles("Touch", &percentiles));
+  EXPECT_EQ(20, percentiles.p50.InMilliseconds());
+  EXPECT_EQ(25, percentiles.p95.InMilliseconds());
+  EXPECT_EQ(25, percentiles.p99.InMilliseconds());
+}
+
+TEST(InputLatencyAggregatorTest, MetricsAreSeparate) {
+  InputLatencyAggregator aggregator(10);
+  aggregator.AddSample("Touch", TimeDelta::FromMilliseconds(1));
+  aggregator.AddSample("Scroll", TimeDelta::FromMilliseconds(100));
+
+  InputLatencyAggregator::Percentiles percentiles;
+  ASSERT_TRUE(aggregator.GetPercentiles("Touch", &percentiles));
+  EXPECT_EQ(1, percentiles.p99.InMilliseconds());
+  ASSERT_TRUE(aggregator.GetPercentiles("Scroll", &percentiles));
+  EXPECT_EQ(100, percentiles.p50.InMilliseconds());
+}
+
+}  // namespace content
@@ -2,6 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <deque>
+
 #include "base/basictypes.h"
 #include "base/command_line.h"
 #include "base/memory/scoped_ptr.h"
@@ -88,15 +90,30 @@ class NullInputRouterClient : public InputRouterClient {
 
 class NullIPCSender : public IPC::Sender {
  public:
-  NullIPCSender() : sent_count_(0) {}
+  NullIPCSender()
+      : sent_count_(0),
+        last_sent_event_type_(WebInputEvent::Undefined) {}
   virtual ~NullIPCSender() {}
 
   virtual bool Send(IPC::Message* message) OVERRIDE {
+    if (message->type() == InputMsg_HandleInputEvent::ID) {
+      PickleIterator iter(*message);
+      const char* data;
+      int data_length;
+      if (message->ReadData(&iter, &data, &data_length)) {
+        last_sent_event_type_ =
+            reinterpret_cast<const WebInputEvent*>(data)->type;
+      }
+    }
     delete message;
     ++sent_count_;
     return true;
   }
 
+  WebInputEvent::Type last_sent_event_type() const {
+    return last_sent_event_type_;
+  }
+
   size_t GetAndResetSentEventCount() {
     size_t message_count = sent_count_;
     sent_count_ = 0;
@@ -107,6 +124,7 @@ class NullIPCSender : public IPC::Sender {
 
  private:
   size_t sent_count_;
+  WebInputEvent::Type last_sent_event_type_;
 };
 
 // TODO(jdduke): Use synthetic gesture pipeline, crbug.com/344598.
@@ -301,6 +319,70 @@ class InputRouterImplPerfTest : public testing::Test {
     }
   }
 
+  // Sends |events_per_frame| of |events| per frame to a renderer that handles
+  // a single input event per frame, as happens when the input device reports
+  // at a higher rate than the display refreshes. Reports how many events
+  // reach the renderer per frame, and how many frames pass on average before
+  // an event is acked.
+  template <typename EventType>
+  void SimulateEventSequenceAtFrameRate(const char* test_name,
+                                        const std::vector<EventType>& events,
+                                        size_t events_per_frame,
+                                        size_t iterations) {
+    OnHasTouchEventHandlers(true);
+
+    size_t frame = 0;
+    size_t renderer_event_count = 0;
+    size_t acked_event_count = 0;
+    size_t total_ack_latency_frames = 0;
+    std::deque<size_t> send_frames;
+    while (iterations--) {
+      size_t i = 0;
+      size_t in_flight_count = 0;
+      while (i < events.size() || in_flight_count) {
+        for (size_t j = 0; j < events_per_frame && i < events.size();
+             ++i, ++j) {
+          SendEvent(events[i], CreateLatencyInfo());
+          send_frames.push_back(frame);
+        }
+        in_flight_count += GetAndResetSentEventCount();
+
+        // The renderer handles the event sent to it, which may release the
+        // next, coalesced, event.
+        if (in_flight_count) {
+          SendEventAck(sender_->last_sent_event_type(),
+                       INPUT_EVENT_ACK_STATE_CONSUMED);
+          --in_flight_count;
+          ++renderer_event_count;
+          in_flight_count += GetAndResetSentEventCount();
+        }
+
+        for (size_t acks = GetAndResetAckCount(); acks; --acks) {
+          ASSERT_FALSE(send_frames.empty());
+          total_ack_latency_frames += frame - send_frames.front();
+          send_frames.pop_front();
+          ++acked_event_count;
+        }
+        ++frame;
+      }
+    }
+    EXPECT_TRUE(send_frames.empty());
+
+    perf_test::PrintResult("renderer_events_per_frame",
+                           "",
+                           test_name,
+                           static_cast<double>(renderer_event_count) / frame,
+                           "events",
+                           true);
+    perf_test::PrintResult(
+        "avg_ack_latency",
+        "",
+        test_name,
+        static_cast<double>(total_ack_latency_frames) / acked_event_count,
+        "frames",
+        true);
+  }
+
   void SimulateTouchAndScrollEventSequence(const char* test_name,
                                            size_t steps,
                                            gfx::Vector2dF origin,
@@ -346,6 +428,9 @@ const size_t kDefaultIterations(100);
 const gfx::Vector2dF kDefaultOrigin(100, 100);
 const gfx::Vector2dF kDefaultDistance(500, 500);
 
+// Input devices reporting at 240Hz on a 60Hz display.
+const size_t kEventsPerFrame(4);
+
 TEST_F(InputRouterImplPerfTest, TouchSwipe) {
   SimulateEventSequence(
       "TouchSwipe ",
@@ -386,4 +471,20 @@ TEST_F(InputRouterImplPerfTest, TouchSwipeToGestureScroll) {
                                       kDefaultIterations);
 }
 
+TEST_F(InputRouterImplPerfTest, TouchSwipeAtFrameRate) {
+  SimulateEventSequenceAtFrameRate(
+      "TouchSwipeAtFrameRate ",
+      BuildTouchSequence(kDefaultSteps, kDefaultOrigin, kDefaultDistance),
+      kEventsPerFrame,
+      kDefaultIterations);
+}
+
+TEST_F(InputRouterImplPerfTest, GestureScrollAtFrameRate) {
+  SimulateEventSequenceAtFrameRate(
+      "GestureScrollAtFrameRate ",
+      BuildScrollSequence(kDefaultSteps, kDefaultOrigin, kDefaultDistance),
+      kEventsPerFrame,
+      kDefaultIterations);
+}
+
 }  // namespace content
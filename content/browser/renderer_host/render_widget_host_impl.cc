@@ -33,6 +33,7 @@
 #include "content/browser/renderer_host/backing_store.h"
 #include "content/browser/renderer_host/backing_store_manager.h"
 #include "content/browser/renderer_host/dip_util.h"
+#include "content/browser/renderer_host/input/input_latency_aggregator.h"
 #include "content/browser/renderer_host/input/input_router_impl.h"
 #include "content/browser/renderer_host/input/synthetic_gesture.h"
 #include "content/browser/renderer_host/input/synthetic_gesture_controller.h"
@@ -104,6 +105,23 @@ typedef base::hash_map<RenderWidgetHostID, RenderWidgetHostImpl*>
 base::LazyInstance<RoutingIDWidgetMap> g_routing_id_widget_map =
     LAZY_INSTANCE_INITIALIZER;
 
+// Number of recent samples of each input latency metric whose percentiles are
+// reported to tracing.
+const size_t kInputLatencyWindowSize = 200;
+
+// Aggregates the input latencies of all widgets, on the UI thread.
+struct InputLatencyAggregatorHolder {
+  InputLatencyAggregatorHolder() : aggregator(kInputLatencyWindowSize) {}
+
+  InputLatencyAggregator aggregator;
+};
+base::LazyInstance<InputLatencyAggregatorHolder>::Leaky
+    g_input_latency_aggregator = LAZY_INSTANCE_INITIALIZER;
+
+void AddInputLatencySample(const std::string& metric, base::TimeDelta latency) {
+  g_input_latency_aggregator.Get().aggregator.AddSample(metric, latency);
+}
+
 int GetInputRouterViewFlagsFromCompositorFrameMetadata(
     const cc::CompositorFrameMetadata metadata) {
   int view_flags = InputRouter::VIEW_FLAGS_NONE;
@@ -2366,6 +2384,7 @@ void RenderWidgetHostImpl::ComputeTouchLatency(
       1,
       20000,
       100);
+  AddInputLatencySample("Event.Latency.Browser.TouchUI", ui_delta);
 
   if (latency_info.FindLatency(ui::INPUT_EVENT_LATENCY_ACKED_TOUCH_COMPONENT,
                                0,
@@ -2379,6 +2398,7 @@ void RenderWidgetHostImpl::ComputeTouchLatency(
         1,
         1000000,
         100);
+    AddInputLatencySample("Event.Latency.Browser.TouchAcked", acked_delta);
   }
 }
 
@@ -2419,6 +2439,7 @@ void RenderWidgetHostImpl::FrameSwapped(const ui::LatencyInfo& latency_info) {
           1,
           1000000,
           100);
+      AddInputLatencySample("Event.Latency.TouchToScrollUpdateSwap", delta);
     }
   }
 }
@@ -4,6 +4,8 @@
 
 #include "content/browser/service_worker/embedded_worker_instance.h"
 
+#include "base/debug/trace_event.h"
+#include "base/metrics/histogram.h"
 #include "content/browser/service_worker/embedded_worker_registry.h"
 #include "content/common/service_worker/embedded_worker_messages.h"
 #include "ipc/ipc_message.h"
@@ -22,6 +24,9 @@ ServiceWorkerStatusCode EmbeddedWorkerInstance::Start(
   if (!ChooseProcess())
     return SERVICE_WORKER_ERROR_PROCESS_NOT_FOUND;
   status_ = STARTING;
+  start_time_ = base::TimeTicks::Now();
+  TRACE_EVENT_ASYNC_BEGIN0("ServiceWorker", "EmbeddedWorkerInstance::Start",
+                           this);
   ServiceWorkerStatusCode status = registry_->StartWorker(
       process_id_,
       embedded_worker_id_,
@@ -30,6 +35,8 @@ ServiceWorkerStatusCode EmbeddedWorkerInstance::Start(
   if (status != SERVICE_WORKER_OK) {
     status_ = STOPPED;
     process_id_ = -1;
+    TRACE_EVENT_ASYNC_END1("ServiceWorker", "EmbeddedWorkerInstance::Start",
+                           this, "status", status);
   }
   return status;
 }
@@ -86,6 +93,10 @@ void EmbeddedWorkerInstance::OnStarted(int thread_id) {
     return;
   DCHECK(status_ == STARTING);
   status_ = RUNNING;
+  TRACE_EVENT_ASYNC_END1("ServiceWorker", "EmbeddedWorkerInstance::Start",
+                         this, "status", SERVICE_WORKER_OK);
+  UMA_HISTOGRAM_TIMES("ServiceWorker.StartWorker.Time",
+                      base::TimeTicks::Now() - start_time_);
   thread_id_ = thread_id;
   FOR_EACH_OBSERVER(Observer, observer_list_, OnStarted());
 }
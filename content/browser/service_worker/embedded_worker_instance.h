@@ -13,6 +13,7 @@
 #include "base/logging.h"
 #include "base/memory/ref_counted.h"
 #include "base/observer_list.h"
+#include "base/time/time.h"
 #include "content/common/content_export.h"
 #include "content/common/service_worker/service_worker_status_code.h"
 
@@ -121,6 +122,9 @@ class CONTENT_EXPORT EmbeddedWorkerInstance {
   int process_id_;
   int thread_id_;
 
+  // When the pending Start() was requested, for startup latency metrics.
+  base::TimeTicks start_time_;
+
   ProcessRefMap process_refs_;
   ObserverList<Observer> observer_list_;
 
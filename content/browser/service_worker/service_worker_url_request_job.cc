@@ -5,6 +5,8 @@
 #include "content/browser/service_worker/service_worker_url_request_job.h"
 
 #include "base/bind.h"
+#include "base/debug/trace_event.h"
+#include "base/metrics/histogram.h"
 #include "base/strings/stringprintf.h"
 #include "content/browser/service_worker/service_worker_fetch_dispatcher.h"
 #include "content/browser/service_worker/service_worker_provider_host.h"
@@ -143,6 +145,9 @@ void ServiceWorkerURLRequestJob::StartRequest() {
 
       // Send a fetch event to the ServiceWorker associated to the
       // provider_host.
+      fetch_start_time_ = base::TimeTicks::Now();
+      TRACE_EVENT_ASYNC_BEGIN0("ServiceWorker",
+                               "ServiceWorkerURLRequestJob::FetchEvent", this);
       fetch_dispatcher_.reset(new ServiceWorkerFetchDispatcher(
           request(), provider_host_->associated_version(),
           base::Bind(&ServiceWorkerURLRequestJob::DidDispatchFetchEvent,
@@ -159,6 +164,11 @@ void ServiceWorkerURLRequestJob::DidDispatchFetchEvent(
     ServiceWorkerFetchEventResult fetch_result,
     const ServiceWorkerResponse& response) {
   fetch_dispatcher_.reset();
+  TRACE_EVENT_ASYNC_END1("ServiceWorker",
+                         "ServiceWorkerURLRequestJob::FetchEvent", this,
+                         "status", status);
+  UMA_HISTOGRAM_TIMES("ServiceWorker.FetchEvent.Time",
+                      base::TimeTicks::Now() - fetch_start_time_);
 
   // Check if we're not orphaned.
   if (!request())
@@ -172,6 +182,7 @@ void ServiceWorkerURLRequestJob::DidDispatchFetchEvent(
     // TODO(kinuko): Would be nice to log the error case.
     response_type_ = FALLBACK_TO_NETWORK;
     NotifyRestartRequired();
+    return;
   }
 
   if (fetch_result == SERVICE_WORKER_FETCH_EVENT_RESULT_FALLBACK) {
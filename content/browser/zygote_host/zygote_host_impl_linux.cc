@@ -9,6 +9,8 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+
 #include "base/base_switches.h"
 #include "base/command_line.h"
 #include "base/environment.h"
@@ -28,6 +30,7 @@
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/sys_info.h"
 #include "base/time/time.h"
 #include "content/browser/renderer_host/render_sandbox_host_linux.h"
 #include "content/common/child_process_sandbox_support_impl_linux.h"
@@ -46,6 +49,38 @@
 
 namespace content {
 
+namespace {
+
+// Below this much available memory, the zygote keeps no renderers ready.
+const int64 kMinAvailableMBForRendererPool = 512;
+// Below this much, it keeps a single one.
+const int64 kMinAvailableMBForFullRendererPool = 2048;
+
+// Returns how many renderers the zygote should keep ready. Pooled renderers
+// share most of their pages with the zygote, but each still dirties a few
+// megabytes, so the pool shrinks as memory gets short.
+int GetRendererPoolSize() {
+  const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+  int size;
+  if (command_line.HasSwitch(switches::kRendererPoolSize) &&
+      base::StringToInt(
+          command_line.GetSwitchValueASCII(switches::kRendererPoolSize),
+          &size) &&
+      size >= 0) {
+    return std::min(size, kZygoteMaxRendererPoolSize);
+  }
+
+  const int64 available_mb =
+      base::SysInfo::AmountOfAvailablePhysicalMemory() / (1024 * 1024);
+  if (available_mb < kMinAvailableMBForRendererPool)
+    return 0;
+  if (available_mb < kMinAvailableMBForFullRendererPool)
+    return 1;
+  return kZygoteMaxRendererPoolSize;
+}
+
+}  // namespace
+
 // static
 ZygoteHost* ZygoteHost::GetInstance() {
   return ZygoteHostImpl::GetInstance();
@@ -60,6 +95,7 @@ ZygoteHostImpl::ZygoteHostImpl()
       sandbox_binary_(),
       have_read_sandbox_status_word_(false),
       sandbox_status_(0),
+      renderer_pool_size_(0),
       child_tracking_lock_(),
       list_of_running_zygote_children_(),
       should_teardown_after_last_child_exits_(false) {}
@@ -218,6 +254,9 @@ void ZygoteHostImpl::Init(const std::string& sandbox_cmd) {
   if (!SendMessage(pickle, NULL))
     LOG(FATAL) << "Cannot communicate with zygote";
   // We don't wait for the reply. We'll read it in ReadReply.
+
+  // Have renderers ready for the first tabs.
+  SetRendererPoolSize(GetRendererPoolSize());
 }
 
 void ZygoteHostImpl::TearDownAfterLastChild() {
@@ -300,6 +339,18 @@ ssize_t ZygoteHostImpl::ReadReply(void* buf, size_t buf_len) {
   return HANDLE_EINTR(read(control_fd_, buf, buf_len));
 }
 
+void ZygoteHostImpl::SetRendererPoolSize(int size) {
+  if (size == renderer_pool_size_)
+    return;
+
+  Pickle pickle;
+  pickle.WriteInt(kZygoteCommandSetRendererPoolSize);
+  pickle.WriteInt(size);
+  // The zygote doesn't reply.
+  if (SendMessage(pickle, NULL))
+    renderer_pool_size_ = size;
+}
+
 pid_t ZygoteHostImpl::ForkRequest(
     const std::vector<std::string>& argv,
     const std::vector<FileDescriptorInfo>& mapping,
@@ -375,6 +426,11 @@ pid_t ZygoteHostImpl::ForkRequest(
 
     if (pid <= 0)
       return base::kNullProcessHandle;
+
+    // The zygote refills its renderer pool after replying, so adapt the pool
+    // to the memory available now that this renderer has been started.
+    if (process_type == switches::kRendererProcess)
+      SetRendererPoolSize(GetRendererPoolSize());
   }
 
 #if !defined(OS_OPENBSD)
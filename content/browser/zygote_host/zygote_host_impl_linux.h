@@ -83,6 +83,11 @@ class CONTENT_EXPORT ZygoteHostImpl : public ZygoteHost {
 
   ssize_t ReadReply(void* buf, size_t buflen);
 
+  // Asks the zygote to keep |size| renderers ready, if that is not already
+  // the size of its renderer pool. The caller is responsible for acquiring
+  // |control_lock_|.
+  void SetRendererPoolSize(int size);
+
   int control_fd_;  // the socket to the zygote
   // A lock protecting all communication with the zygote. This lock must be
   // acquired before sending a command and released after the result has been
@@ -94,6 +99,9 @@ class CONTENT_EXPORT ZygoteHostImpl : public ZygoteHost {
   std::string sandbox_binary_;
   bool have_read_sandbox_status_word_;
   int sandbox_status_;
+  // The last renderer pool size sent to the zygote. Protected by
+  // |control_lock_|.
+  int renderer_pool_size_;
   // A lock protecting list_of_running_zygote_children_ and
   // should_teardown_after_last_child_exits_.
   base::Lock child_tracking_lock_;
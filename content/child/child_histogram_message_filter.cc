@@ -9,6 +9,7 @@
 #include "base/bind.h"
 #include "base/message_loop/message_loop.h"
 #include "base/metrics/histogram_delta_serialization.h"
+#include "base/metrics/shared_histogram_allocator.h"
 #include "content/child/child_process.h"
 #include "content/child/child_thread.h"
 #include "content/common/child_process_messages.h"
@@ -36,6 +37,8 @@ bool ChildHistogramMessageFilter::OnMessageReceived(
   IPC_BEGIN_MESSAGE_MAP(ChildHistogramMessageFilter, message)
     IPC_MESSAGE_HANDLER(ChildProcessMsg_GetChildHistogramData,
                         OnGetChildHistogramData)
+    IPC_MESSAGE_HANDLER(ChildProcessMsg_SetHistogramMemory,
+                        OnSetHistogramMemory)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
   return handled;
@@ -51,6 +54,21 @@ void ChildHistogramMessageFilter::OnGetChildHistogramData(int sequence_number) {
   UploadAllHistograms(sequence_number);
 }
 
+void ChildHistogramMessageFilter::OnSetHistogramMemory(
+    const base::SharedMemoryHandle& memory_handle,
+    uint32 memory_size) {
+  scoped_ptr<base::SharedMemory> memory(
+      new base::SharedMemory(memory_handle, false));
+  if (base::SharedHistogramAllocator::GetGlobal() ||
+      !memory->Map(memory_size)) {
+    return;
+  }
+  scoped_ptr<base::SharedHistogramAllocator> allocator(
+      new base::SharedHistogramAllocator(memory.Pass()));
+  if (allocator->IsValid())
+    base::SharedHistogramAllocator::SetGlobal(allocator.Pass());
+}
+
 void ChildHistogramMessageFilter::UploadAllHistograms(int sequence_number) {
   if (!histogram_delta_serialization_) {
     histogram_delta_serialization_.reset(
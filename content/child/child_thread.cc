@@ -13,6 +13,7 @@
 #include "base/basictypes.h"
 #include "base/command_line.h"
 #include "base/debug/leak_annotations.h"
+#include "base/debug/sampling_heap_profiler.h"
 #include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/message_loop/message_loop.h"
@@ -52,6 +53,7 @@
 
 #if defined(TCMALLOC_TRACE_MEMORY_SUPPORTED)
 #include "third_party/tcmalloc/chromium/src/gperftools/heap-profiler.h"
+#include "third_party/tcmalloc/chromium/src/gperftools/malloc_hook_c.h"
 #endif
 
 using tracked_objects::ThreadData;
@@ -312,6 +314,12 @@ void ChildThread::Init() {
       ::HeapProfilerWithPseudoStackStart,
       ::HeapProfilerStop,
       ::GetHeapProfile));
+  sampling_heap_profiler_.reset(new base::debug::SamplingHeapProfiler(
+      message_loop_->message_loop_proxy(),
+      ::MallocHook_AddNewHook,
+      ::MallocHook_RemoveNewHook,
+      ::MallocHook_AddDeleteHook,
+      ::MallocHook_RemoveDeleteHook));
 #endif
 
   shared_bitmap_manager_.reset(
@@ -21,6 +21,7 @@ namespace base {
 class MessageLoop;
 
 namespace debug {
+class SamplingHeapProfiler;
 class TraceMemoryController;
 }  // namespace debug
 }  // namespace base
@@ -244,6 +245,10 @@ class CONTENT_EXPORT ChildThread : public IPC::Listener, public IPC::Sender {
   // starts profiling the tcmalloc heap.
   scoped_ptr<base::debug::TraceMemoryController> trace_memory_controller_;
 
+  // Samples heap allocations cheaply while the memory.sampling trace
+  // category is enabled.
+  scoped_ptr<base::debug::SamplingHeapProfiler> sampling_heap_profiler_;
+
   scoped_ptr<base::PowerMonitor> power_monitor_;
 
   bool in_browser_process_;
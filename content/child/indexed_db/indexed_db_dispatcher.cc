@@ -617,11 +617,16 @@ void IndexedDBDispatcher::OnSuccessCursorPrefetch(
   int32 ipc_cursor_id = p.ipc_cursor_id;
   const std::vector<IndexedDBKey>& keys = p.keys;
   const std::vector<IndexedDBKey>& primary_keys = p.primary_keys;
-  std::vector<WebData> values(p.values.size());
-  for (size_t i = 0; i < p.values.size(); ++i) {
-    if (p.values[i].size())
-      values[i].assign(&*p.values[i].begin(), p.values[i].size());
+  DCHECK_EQ(keys.size(), p.value_sizes.size());
+  std::vector<WebData> values(p.value_sizes.size());
+  size_t offset = 0;
+  for (size_t i = 0; i < p.value_sizes.size(); ++i) {
+    DCHECK_LE(p.value_sizes[i], p.values.size() - offset);
+    if (p.value_sizes[i])
+      values[i].assign(p.values.data() + offset, p.value_sizes[i]);
+    offset += p.value_sizes[i];
   }
+  DCHECK_EQ(p.values.size(), offset);
   WebIDBCursorImpl* cursor = cursors_[ipc_cursor_id];
   DCHECK(cursor);
   cursor->SetPrefetchData(keys, primary_keys, values);
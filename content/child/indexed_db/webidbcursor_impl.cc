@@ -4,6 +4,7 @@
 
 #include "content/child/indexed_db/webidbcursor_impl.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "content/child/indexed_db/indexed_db_dispatcher.h"
@@ -82,16 +83,27 @@ void WebIDBCursorImpl::continueFunction(const WebIDBKey& key,
     }
 
     if (continue_count_ > kPrefetchContinueThreshold) {
+      // Increase prefetch_amount_ exponentially while the IPC round trip is
+      // what the iteration is waiting on, i.e. the last prefetch was used up
+      // faster than it took to arrive. For slower consumers the round trip
+      // is already hidden, and larger prefetches would only cost memory.
+      base::TimeTicks now = base::TimeTicks::Now();
+      if (!prefetch_data_time_.is_null()) {
+        base::TimeDelta drain_time = now - prefetch_data_time_;
+        if (drain_time <= prefetch_data_time_ - prefetch_request_time_ ||
+            drain_time.InMilliseconds() < kFastPrefetchDrainMs) {
+          prefetch_amount_ = std::min(prefetch_amount_ * 2,
+                                      static_cast<int>(kMaxPrefetchAmount));
+        }
+      }
+      prefetch_request_time_ = now;
+      prefetch_data_time_ = base::TimeTicks();
+
       // Request pre-fetch.
       ++pending_onsuccess_callbacks_;
       dispatcher->RequestIDBCursorPrefetch(
           prefetch_amount_, callbacks.release(), ipc_cursor_id_);
 
-      // Increase prefetch_amount_ exponentially.
-      prefetch_amount_ *= 2;
-      if (prefetch_amount_ > kMaxPrefetchAmount)
-        prefetch_amount_ = kMaxPrefetchAmount;
-
       return;
     }
   } else {
@@ -126,6 +138,7 @@ void WebIDBCursorImpl::SetPrefetchData(
   prefetch_keys_.assign(keys.begin(), keys.end());
   prefetch_primary_keys_.assign(primary_keys.begin(), primary_keys.end());
   prefetch_values_.assign(values.begin(), values.end());
+  prefetch_data_time_ = base::TimeTicks::Now();
 
   used_prefetches_ = 0;
   pending_onsuccess_callbacks_ = 0;
@@ -180,6 +193,7 @@ void WebIDBCursorImpl::CachedContinue(WebIDBCallbacks* callbacks) {
 void WebIDBCursorImpl::ResetPrefetchCache() {
   continue_count_ = 0;
   prefetch_amount_ = kMinPrefetchAmount;
+  prefetch_data_time_ = base::TimeTicks();
 
   if (!prefetch_keys_.size()) {
     // No prefetch cache, so no need to reset the cursor in the back-end.
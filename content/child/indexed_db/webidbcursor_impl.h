@@ -12,6 +12,7 @@
 #include "base/compiler_specific.h"
 #include "base/gtest_prod_util.h"
 #include "base/memory/ref_counted.h"
+#include "base/time/time.h"
 #include "content/common/content_export.h"
 #include "content/common/indexed_db/indexed_db_key.h"
 #include "third_party/WebKit/public/platform/WebData.h"
@@ -77,12 +78,20 @@ class CONTENT_EXPORT WebIDBCursorImpl
   // Number of items to request in next prefetch.
   int prefetch_amount_;
 
+  // When the last prefetch was requested and when its data arrived, used to
+  // decide whether the next prefetch should be larger.
+  base::TimeTicks prefetch_request_time_;
+  base::TimeTicks prefetch_data_time_;
+
   scoped_refptr<ThreadSafeSender> thread_safe_sender_;
 
   enum { kInvalidCursorId = -1 };
   enum { kPrefetchContinueThreshold = 2 };
   enum { kMinPrefetchAmount = 5 };
-  enum { kMaxPrefetchAmount = 100 };
+  enum { kMaxPrefetchAmount = 500 };
+  // Consumers draining a prefetch faster than this are always considered
+  // fast enough to deserve a larger one.
+  enum { kFastPrefetchDrainMs = 1 };
 };
 
 }  // namespace content
@@ -19,6 +19,7 @@
 #include "content/child/request_info.h"
 #include "content/child/site_isolation_policy.h"
 #include "content/common/inter_process_time_ticks_converter.h"
+#include "content/common/resource_data_ring.h"
 #include "content/common/resource_messages.h"
 #include "content/common/service_worker/service_worker_types.h"
 #include "content/public/child/resource_dispatcher_delegate.h"
@@ -413,6 +414,40 @@ void ResourceDispatcher::OnSetDataBuffer(int request_id,
   request_info->buffer_size = shm_size;
 }
 
+void ResourceDispatcher::OnSetDataRing(int request_id,
+                                       base::SharedMemoryHandle shm_handle,
+                                       int shm_size,
+                                       base::ProcessId renderer_pid) {
+  TRACE_EVENT0("loader", "ResourceDispatcher::OnSetDataRing");
+  PendingRequestInfo* request_info = GetPendingRequestInfo(request_id);
+  if (!request_info)
+    return;
+
+  bool shm_valid = base::SharedMemory::IsHandleValid(shm_handle);
+  CHECK(shm_valid && shm_size > 0);
+
+  // The ring follows the data, and is written to as chunks are popped.
+  request_info->buffer.reset(
+      new base::SharedMemory(shm_handle, false));
+
+  bool ok = request_info->buffer->Map(
+      shm_size + ResourceDataRing::GetSizeInBytes());
+  if (!ok) {
+    base::ProcessId renderer_pid_copy = renderer_pid;
+    base::debug::Alias(&renderer_pid_copy);
+
+    base::SharedMemoryHandle shm_handle_copy = shm_handle;
+    base::debug::Alias(&shm_handle_copy);
+
+    CrashOnMapFailure();
+    return;
+  }
+
+  request_info->buffer_size = shm_size;
+  request_info->data_ring.reset(new ResourceDataRing(
+      static_cast<char*>(request_info->buffer->memory()) + shm_size));
+}
+
 void ResourceDispatcher::OnReceivedData(int request_id,
                                         int data_offset,
                                         int data_length,
@@ -421,52 +456,93 @@ void ResourceDispatcher::OnReceivedData(int request_id,
   DCHECK_GT(data_length, 0);
   PendingRequestInfo* request_info = GetPendingRequestInfo(request_id);
   if (request_info && data_length > 0) {
-    CHECK(base::SharedMemory::IsHandleValid(request_info->buffer->handle()));
-    CHECK_GE(request_info->buffer_size, data_offset + data_length);
-
-    // Ensure that the SHM buffer remains valid for the duration of this scope.
-    // It is possible for CancelPendingRequest() to be called before we exit
-    // this scope.
-    linked_ptr<base::SharedMemory> retain_buffer(request_info->buffer);
-
-    base::TimeTicks time_start = base::TimeTicks::Now();
-
-    const char* data_ptr = static_cast<char*>(request_info->buffer->memory());
-    CHECK(data_ptr);
-    CHECK(data_ptr + data_offset);
-
-    // Check whether this response data is compliant with our cross-site
-    // document blocking policy. We only do this for the first packet.
-    std::string alternative_data;
-    if (request_info->site_isolation_metadata.get()) {
-      request_info->blocked_response =
-          SiteIsolationPolicy::ShouldBlockResponse(
-              request_info->site_isolation_metadata, data_ptr + data_offset,
-              data_length, &alternative_data);
-      request_info->site_isolation_metadata.reset();
-    }
-
-    // When the response is not blocked.
-    if (!request_info->blocked_response) {
-      request_info->peer->OnReceivedData(
-          data_ptr + data_offset, data_length, encoded_data_length);
-    } else if (alternative_data.size() > 0) {
-      // When the response is blocked, and when we have any alternative data to
-      // send to the renderer. When |alternative_data| is zero-sized, we do not
-      // call peer's callback.
-      request_info->peer->OnReceivedData(alternative_data.data(),
-                                         alternative_data.size(),
-                                         alternative_data.size());
-    }
-
-    UMA_HISTOGRAM_TIMES("ResourceDispatcher.OnReceivedDataTime",
-                        base::TimeTicks::Now() - time_start);
+    DeliverReceivedData(request_id, request_info, data_offset, data_length,
+                        encoded_data_length);
   }
 
   // Acknowledge the reception of this data.
   message_sender()->Send(new ResourceHostMsg_DataReceived_ACK(request_id));
 }
 
+void ResourceDispatcher::OnDataAvailable(int request_id) {
+  TRACE_EVENT0("loader", "ResourceDispatcher::OnDataAvailable");
+  DrainDataRing(request_id);
+}
+
+void ResourceDispatcher::DeliverReceivedData(int request_id,
+                                             PendingRequestInfo* request_info,
+                                             int data_offset,
+                                             int data_length,
+                                             int encoded_data_length) {
+  CHECK(base::SharedMemory::IsHandleValid(request_info->buffer->handle()));
+  CHECK_GE(request_info->buffer_size, data_offset + data_length);
+
+  // Ensure that the SHM buffer remains valid for the duration of this scope.
+  // It is possible for CancelPendingRequest() to be called before we exit
+  // this scope.
+  linked_ptr<base::SharedMemory> retain_buffer(request_info->buffer);
+
+  base::TimeTicks time_start = base::TimeTicks::Now();
+
+  const char* data_ptr = static_cast<char*>(request_info->buffer->memory());
+  CHECK(data_ptr);
+  CHECK(data_ptr + data_offset);
+
+  // Check whether this response data is compliant with our cross-site
+  // document blocking policy. We only do this for the first packet.
+  std::string alternative_data;
+  if (request_info->site_isolation_metadata.get()) {
+    request_info->blocked_response =
+        SiteIsolationPolicy::ShouldBlockResponse(
+            request_info->site_isolation_metadata, data_ptr + data_offset,
+            data_length, &alternative_data);
+    request_info->site_isolation_metadata.reset();
+  }
+
+  // When the response is not blocked.
+  if (!request_info->blocked_response) {
+    request_info->peer->OnReceivedData(
+        data_ptr + data_offset, data_length, encoded_data_length);
+  } else if (alternative_data.size() > 0) {
+    // When the response is blocked, and when we have any alternative data to
+    // send to the renderer. When |alternative_data| is zero-sized, we do not
+    // call peer's callback.
+    request_info->peer->OnReceivedData(alternative_data.data(),
+                                       alternative_data.size(),
+                                       alternative_data.size());
+  }
+
+  UMA_HISTOGRAM_TIMES("ResourceDispatcher.OnReceivedDataTime",
+                      base::TimeTicks::Now() - time_start);
+}
+
+void ResourceDispatcher::DrainDataRing(int request_id) {
+  PendingRequestInfo* request_info = GetPendingRequestInfo(request_id);
+  while (request_info && request_info->data_ring.get() &&
+         !request_info->is_deferred) {
+    // The peer may cancel the request, which destroys |request_info|.
+    linked_ptr<ResourceDataRing> data_ring(request_info->data_ring);
+    ResourceDataRing::Chunk chunk;
+    if (!data_ring->Peek(&chunk))
+      return;
+
+    // The chunk was written by the browser, which may be compromised.
+    CHECK_GT(chunk.length, 0);
+    CHECK_GE(chunk.offset, 0);
+    CHECK_LE(chunk.length, request_info->buffer_size);
+    CHECK_LE(chunk.offset, request_info->buffer_size - chunk.length);
+
+    DeliverReceivedData(request_id, request_info, chunk.offset, chunk.length,
+                        chunk.encoded_length);
+
+    // Only tell the browser about the space we freed if it is waiting for it.
+    if (data_ring->Pop())
+      message_sender()->Send(new ResourceHostMsg_DataConsumed(request_id));
+
+    request_info = GetPendingRequestInfo(request_id);
+  }
+}
+
 void ResourceDispatcher::OnDownloadedData(int request_id,
                                           int data_len,
                                           int encoded_data_length) {
@@ -531,11 +607,22 @@ void ResourceDispatcher::OnRequestComplete(
     const ResourceMsg_RequestCompleteData& request_complete_data) {
   TRACE_EVENT0("loader", "ResourceDispatcher::OnRequestComplete");
 
+  // The data in the ring was pushed before the request completed.
+  DrainDataRing(request_id);
+
   PendingRequestInfo* request_info = GetPendingRequestInfo(request_id);
   if (!request_info)
     return;
+  if (request_info->is_deferred) {
+    // The peer deferred the request while taking data from the ring, so the
+    // rest of the data and this message wait for it to resume.
+    request_info->deferred_message_queue.push_front(
+        new ResourceMsg_RequestComplete(request_id, request_complete_data));
+    return;
+  }
   request_info->completion_time = ConsumeIOTimestamp();
   request_info->buffer.reset();
+  request_info->data_ring.reset();
   request_info->buffer_size = 0;
 
   ResourceLoaderBridge::Peer* peer = request_info->peer;
@@ -663,7 +750,9 @@ void ResourceDispatcher::DispatchMessage(const IPC::Message& message) {
                         OnReceivedCachedMetadata)
     IPC_MESSAGE_HANDLER(ResourceMsg_ReceivedRedirect, OnReceivedRedirect)
     IPC_MESSAGE_HANDLER(ResourceMsg_SetDataBuffer, OnSetDataBuffer)
+    IPC_MESSAGE_HANDLER(ResourceMsg_SetDataRing, OnSetDataRing)
     IPC_MESSAGE_HANDLER(ResourceMsg_DataReceived, OnReceivedData)
+    IPC_MESSAGE_HANDLER(ResourceMsg_DataAvailable, OnDataAvailable)
     IPC_MESSAGE_HANDLER(ResourceMsg_DataDownloaded, OnDownloadedData)
     IPC_MESSAGE_HANDLER(ResourceMsg_RequestComplete, OnRequestComplete)
   IPC_END_MESSAGE_MAP()
@@ -673,6 +762,13 @@ void ResourceDispatcher::FlushDeferredMessages(int request_id) {
   PendingRequestList::iterator it = pending_requests_.find(request_id);
   if (it == pending_requests_.end())  // The request could have become invalid.
     return;
+  if (it->second.is_deferred)
+    return;
+  // Data in the ring may have been left behind when the request was deferred.
+  DrainDataRing(request_id);
+  it = pending_requests_.find(request_id);
+  if (it == pending_requests_.end())
+    return;
   PendingRequestInfo& request_info = it->second;
   if (request_info.is_deferred)
     return;
@@ -693,7 +789,10 @@ void ResourceDispatcher::FlushDeferredMessages(int request_id) {
     if (index != pending_requests_.end()) {
       PendingRequestInfo& pending_request = index->second;
       if (pending_request.is_deferred) {
-        pending_request.deferred_message_queue.swap(q);
+        // Keep any message the handler queued, such as a RequestComplete that
+        // has to wait for the data ring to be drained.
+        pending_request.deferred_message_queue.insert(
+            pending_request.deferred_message_queue.begin(), q.begin(), q.end());
         return;
       }
     }
@@ -772,7 +871,9 @@ bool ResourceDispatcher::IsResourceDispatcherMessage(
     case ResourceMsg_ReceivedCachedMetadata::ID:
     case ResourceMsg_ReceivedRedirect::ID:
     case ResourceMsg_SetDataBuffer::ID:
+    case ResourceMsg_SetDataRing::ID:
     case ResourceMsg_DataReceived::ID:
+    case ResourceMsg_DataAvailable::ID:
     case ResourceMsg_DataDownloaded::ID:
     case ResourceMsg_RequestComplete::ID:
       return true;
@@ -796,7 +897,8 @@ void ResourceDispatcher::ReleaseResourcesInDataMessage(
 
   // If the message contains a shared memory handle, we should close the handle
   // or there will be a memory leak.
-  if (message.type() == ResourceMsg_SetDataBuffer::ID) {
+  if (message.type() == ResourceMsg_SetDataBuffer::ID ||
+      message.type() == ResourceMsg_SetDataRing::ID) {
     base::SharedMemoryHandle shm_handle;
     if (IPC::ParamTraits<base::SharedMemoryHandle>::Read(&message,
                                                          &iter,
@@ -24,6 +24,7 @@
 struct ResourceMsg_RequestCompleteData;
 
 namespace content {
+class ResourceDataRing;
 class ResourceDispatcherDelegate;
 struct RequestInfo;
 struct ResourceResponseHead;
@@ -117,6 +118,9 @@ class CONTENT_EXPORT ResourceDispatcher : public IPC::Listener {
     base::TimeTicks response_start;
     base::TimeTicks completion_time;
     linked_ptr<base::SharedMemory> buffer;
+    // Set instead of passing DataReceived messages when the browser passes the
+    // locations of the data through the shared memory.
+    linked_ptr<ResourceDataRing> data_ring;
     linked_ptr<SiteIsolationResponseMetaData> site_isolation_metadata;
     bool blocked_response;
     int buffer_size;
@@ -146,11 +150,17 @@ class CONTENT_EXPORT ResourceDispatcher : public IPC::Listener {
       base::SharedMemoryHandle shm_handle,
       int shm_size,
       base::ProcessId renderer_pid);
+  void OnSetDataRing(
+      int request_id,
+      base::SharedMemoryHandle shm_handle,
+      int shm_size,
+      base::ProcessId renderer_pid);
   void OnReceivedData(
       int request_id,
       int data_offset,
       int data_length,
       int encoded_data_length);
+  void OnDataAvailable(int request_id);
   void OnDownloadedData(
       int request_id,
       int data_len,
@@ -159,6 +169,18 @@ class CONTENT_EXPORT ResourceDispatcher : public IPC::Listener {
       int request_id,
       const ResourceMsg_RequestCompleteData &request_complete_data);
 
+  // Passes the data at |data_offset| in the shared memory buffer of the request
+  // to its peer.
+  void DeliverReceivedData(int request_id,
+                           PendingRequestInfo* request_info,
+                           int data_offset,
+                           int data_length,
+                           int encoded_data_length);
+
+  // Delivers the chunks in the data ring of the given request, if any, until
+  // it is empty or the request is deferred.
+  void DrainDataRing(int request_id);
+
   // Dispatch the message to one of the message response handlers.
   void DispatchMessage(const IPC::Message& message);
 
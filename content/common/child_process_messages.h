@@ -98,6 +98,12 @@ IPC_MESSAGE_CONTROL1(ChildProcessMsg_GetChildProfilerData,
 IPC_MESSAGE_CONTROL1(ChildProcessMsg_GetChildHistogramData,
                      int /* sequence_number */)
 
+// Sent to child processes to make the histograms they create from now on
+// record into the given shared memory, which the browser reads directly.
+IPC_MESSAGE_CONTROL2(ChildProcessMsg_SetHistogramMemory,
+                     base::SharedMemoryHandle /* memory_handle */,
+                     uint32 /* memory_size */)
+
 // Sent to child processes to dump their handle table.
 IPC_MESSAGE_CONTROL0(ChildProcessMsg_DumpHandles)
 
@@ -4,7 +4,11 @@
 
 #include "content/common/dom_storage/dom_storage_map.h"
 
+#include <string.h>
+
 #include "base/logging.h"
+#include "base/memory/shared_memory.h"
+#include "base/pickle.h"
 
 namespace content {
 
@@ -29,7 +33,8 @@ size_t CountBytes(const DOMStorageValuesMap& values) {
 
 DOMStorageMap::DOMStorageMap(size_t quota)
     : bytes_used_(0),
-      quota_(quota) {
+      quota_(quota),
+      snapshot_size_(0) {
   ResetKeyIterator();
 }
 
@@ -82,6 +87,7 @@ bool DOMStorageMap::SetItem(
 
   values_[key] = base::NullableString16(value, false);
   ResetKeyIterator();
+  snapshot_.reset();
   bytes_used_ = new_bytes_used;
   return true;
 }
@@ -95,6 +101,7 @@ bool DOMStorageMap::RemoveItem(
   *old_value = found->second.string();
   values_.erase(found);
   ResetKeyIterator();
+  snapshot_.reset();
   bytes_used_ -= size_of_item(key, *old_value);
   return true;
 }
@@ -104,6 +111,56 @@ void DOMStorageMap::SwapValues(DOMStorageValuesMap* values) {
   values_.swap(*values);
   bytes_used_ = CountBytes(values_);
   ResetKeyIterator();
+  snapshot_.reset();
+}
+
+base::SharedMemory* DOMStorageMap::GetSnapshot(size_t* size) {
+  if (!snapshot_) {
+    Pickle pickle;
+    pickle.WriteUInt32(values_.size());
+    DOMStorageValuesMap::const_iterator it = values_.begin();
+    for (; it != values_.end(); ++it) {
+      pickle.WriteString16(it->first);
+      pickle.WriteBool(it->second.is_null());
+      pickle.WriteString16(it->second.string());
+    }
+
+    scoped_ptr<base::SharedMemory> snapshot(new base::SharedMemory);
+    if (!snapshot->CreateAndMapAnonymous(pickle.size()))
+      return NULL;
+    memcpy(snapshot->memory(), pickle.data(), pickle.size());
+    snapshot->Unmap();
+    snapshot_ = snapshot.Pass();
+    snapshot_size_ = pickle.size();
+  }
+  *size = snapshot_size_;
+  return snapshot_.get();
+}
+
+// static
+bool DOMStorageMap::ReadSnapshot(const void* data, size_t size,
+                                 DOMStorageValuesMap* map) {
+  Pickle pickle(static_cast<const char*>(data), static_cast<int>(size));
+  PickleIterator iter(pickle);
+  uint32 count;
+  if (!iter.ReadUInt32(&count))
+    return false;
+
+  DOMStorageValuesMap values;
+  for (uint32 i = 0; i < count; ++i) {
+    base::string16 key;
+    bool is_null;
+    base::string16 value;
+    if (!iter.ReadString16(&key) || !iter.ReadBool(&is_null) ||
+        !iter.ReadString16(&value)) {
+      return false;
+    }
+    // The keys were written in order, so each one goes at the end.
+    values.insert(values.end(),
+                  std::make_pair(key, base::NullableString16(value, is_null)));
+  }
+  map->swap(values);
+  return true;
 }
 
 DOMStorageMap* DOMStorageMap::DeepCopy() const {
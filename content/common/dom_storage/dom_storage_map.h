@@ -8,11 +8,16 @@
 #include <map>
 
 #include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/strings/nullable_string16.h"
 #include "base/strings/string16.h"
 #include "content/common/content_export.h"
 #include "content/common/dom_storage/dom_storage_types.h"
 
+namespace base {
+class SharedMemory;
+}
+
 namespace content {
 
 // A wrapper around a std::map that adds refcounting and
@@ -38,6 +43,16 @@ class CONTENT_EXPORT DOMStorageMap
   // Writes a copy of the current set of values_ to the |map|.
   void ExtractValues(DOMStorageValuesMap* map) const { *map = values_; }
 
+  // Returns a copy of values_ serialized into shared memory, which can be
+  // read back with ReadSnapshot(), or NULL on failure. |size| is set to the
+  // size of the data. The snapshot is kept until values_ change, so that
+  // renderers loading an unchanged map all map the same pages.
+  base::SharedMemory* GetSnapshot(size_t* size);
+
+  // Reads the values of a snapshot, mapped at |data|, into |map|.
+  static bool ReadSnapshot(const void* data, size_t size,
+                           DOMStorageValuesMap* map);
+
   // Creates a new instance of DOMStorageMap containing
   // a deep copy of values_.
   DOMStorageMap* DeepCopy() const;
@@ -57,6 +72,9 @@ class CONTENT_EXPORT DOMStorageMap
   unsigned last_key_index_;
   size_t bytes_used_;
   size_t quota_;
+
+  scoped_ptr<base::SharedMemory> snapshot_;
+  size_t snapshot_size_;
 };
 
 }  // namespace content
@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include "base/memory/shared_memory.h"
 #include "base/strings/utf_string_conversions.h"
 #include "content/common/dom_storage/dom_storage_map.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -123,4 +124,44 @@ TEST(DOMStorageMapTest, EnforcesQuota) {
   EXPECT_EQ(kValue, old_nullable_value.string());
 }
 
+TEST(DOMStorageMapTest, Snapshot) {
+  const base::string16 kKey(ASCIIToUTF16("key"));
+  const base::string16 kValue(ASCIIToUTF16("value"));
+  const base::string16 kKey2(ASCIIToUTF16("key2"));
+  const size_t kQuota = 1024;
+  base::NullableString16 old_nullable_value;
+
+  scoped_refptr<DOMStorageMap> map(new DOMStorageMap(kQuota));
+  EXPECT_TRUE(map->SetItem(kKey, kValue, &old_nullable_value));
+  EXPECT_TRUE(map->SetItem(kKey2, base::string16(), &old_nullable_value));
+
+  size_t size = 0;
+  base::SharedMemory* snapshot = map->GetSnapshot(&size);
+  ASSERT_TRUE(snapshot);
+  EXPECT_GT(size, 0u);
+
+  // Unchanged maps keep their snapshot.
+  size_t second_size = 0;
+  EXPECT_EQ(snapshot, map->GetSnapshot(&second_size));
+  EXPECT_EQ(size, second_size);
+
+  DOMStorageValuesMap values;
+  ASSERT_TRUE(snapshot->Map(size));
+  EXPECT_TRUE(DOMStorageMap::ReadSnapshot(snapshot->memory(), size, &values));
+  snapshot->Unmap();
+  DOMStorageValuesMap expected;
+  map->ExtractValues(&expected);
+  EXPECT_EQ(expected, values);
+
+  // Changes are reflected in the next snapshot.
+  base::string16 old_value;
+  EXPECT_TRUE(map->RemoveItem(kKey, &old_value));
+  snapshot = map->GetSnapshot(&size);
+  ASSERT_TRUE(snapshot);
+  ASSERT_TRUE(snapshot->Map(size));
+  EXPECT_TRUE(DOMStorageMap::ReadSnapshot(snapshot->memory(), size, &values));
+  EXPECT_EQ(1u, values.size());
+  EXPECT_EQ(1u, values.count(kKey2));
+}
+
 }  // namespace content
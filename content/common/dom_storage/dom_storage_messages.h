@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 // Multiply-included message file, no traditional include guard.
+#include "base/memory/shared_memory.h"
 #include "content/common/dom_storage/dom_storage_types.h"
 #include "content/public/common/common_param_traits.h"
 #include "ipc/ipc_message_macros.h"
@@ -73,10 +74,14 @@ IPC_MESSAGE_CONTROL1(DOMStorageHostMsg_CloseStorageArea,
 
 // Retrieves the set of key/value pairs for the area. Used to prime
 // the renderer-side cache. A completion notification is sent in response.
+// The values are returned as a read-only shared memory snapshot, see
+// content::DOMStorageMap::GetSnapshot(), or in the map if the handle is null.
 // The response will also indicate whether the renderer should send
 // messagse to the browser for get operations for logging purposes.
-IPC_SYNC_MESSAGE_CONTROL1_2(DOMStorageHostMsg_LoadStorageArea,
+IPC_SYNC_MESSAGE_CONTROL1_4(DOMStorageHostMsg_LoadStorageArea,
                             int /* connection_id */,
+                            base::SharedMemoryHandle /* values_snapshot */,
+                            uint32 /* values_snapshot_size */,
                             content::DOMStorageValuesMap,
                             bool /* send_log_get_messages */)
 
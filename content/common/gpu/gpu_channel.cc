@@ -9,6 +9,7 @@
 #include "content/common/gpu/gpu_channel.h"
 
 #include <queue>
+#include <set>
 #include <vector>
 
 #include "base/bind.h"
@@ -411,6 +412,8 @@ GpuChannel::GpuChannel(GpuChannelManager* gpu_channel_manager,
   channel_id_ = IPC::Channel::GenerateVerifiedChannelID("gpu");
   const CommandLine* command_line = CommandLine::ForCurrentProcess();
   log_messages_ = command_line->HasSwitch(switches::kLogPluginMessages);
+  share_group_scheduling_ =
+      command_line->HasSwitch(switches::kEnableGpuShareGroupScheduling);
 }
 
 
@@ -727,9 +730,17 @@ void GpuChannel::HandleMessage() {
   GpuCommandBufferStub* stub = stubs_.Lookup(m->routing_id());
 
   do {
-    if (stub) {
-      if (!stub->IsScheduled())
+    if (stub && !stub->IsScheduled()) {
+      // Contexts in other share groups don't depend on this one other than
+      // through sync points, which deschedule the waiting stub, so their
+      // messages don't need to wait for it to be scheduled again.
+      if (!share_group_scheduling_ || !MoveIndependentMessageToFront())
         return;
+      m = deferred_messages_.front();
+      stub = stubs_.Lookup(m->routing_id());
+      DCHECK(stub && stub->IsScheduled());
+    }
+    if (stub) {
       if (stub->IsPreempted()) {
         OnScheduled();
         return;
@@ -790,6 +801,30 @@ void GpuChannel::HandleMessage() {
   }
 }
 
+bool GpuChannel::MoveIndependentMessageToFront() {
+  // Share groups with a message that has to be handled first.
+  std::set<gpu::gles2::ContextGroup*> blocked_groups;
+  for (std::deque<IPC::Message*>::iterator it = deferred_messages_.begin();
+       it != deferred_messages_.end();
+       ++it) {
+    GpuCommandBufferStub* stub = stubs_.Lookup((*it)->routing_id());
+    // Control and video encoder messages are kept in order with everything.
+    if (!stub)
+      return false;
+    gpu::gles2::ContextGroup* group = stub->context_group();
+    if (blocked_groups.count(group))
+      continue;
+    if (stub->IsScheduled()) {
+      IPC::Message* message = *it;
+      deferred_messages_.erase(it);
+      deferred_messages_.push_front(message);
+      return true;
+    }
+    blocked_groups.insert(group);
+  }
+  return false;
+}
+
 void GpuChannel::OnCreateOffscreenCommandBuffer(
     const gfx::Size& size,
     const GPUCreateCommandBufferConfig& init_params,
@@ -162,6 +162,11 @@ class GpuChannel : public IPC::Listener,
 
   void HandleMessage();
 
+  // Moves the first queued message of a share group whose stub can handle it
+  // to the front of the queue, if that doesn't reorder it with any message of
+  // its share group or any control message. Returns false if there is none.
+  bool MoveIndependentMessageToFront();
+
   // Message handlers.
   void OnCreateOffscreenCommandBuffer(
       const gfx::Size& size,
@@ -225,6 +230,10 @@ class GpuChannel : public IPC::Listener,
   bool processed_get_state_fast_;
   IPC::Message* currently_processing_message_;
 
+  // True if messages of one share group may be handled while a stub of
+  // another one is descheduled. See kEnableGpuShareGroupScheduling.
+  bool share_group_scheduling_;
+
   base::WeakPtrFactory<GpuChannel> weak_factory_;
 
   scoped_refptr<GpuChannelMessageFilter> filter_;
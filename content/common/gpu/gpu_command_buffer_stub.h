@@ -112,6 +112,11 @@ class GpuCommandBufferStub
   gpu::GpuScheduler* scheduler() const { return scheduler_.get(); }
   GpuChannel* channel() const { return channel_; }
 
+  // Shared by all the stubs in the same share group.
+  gpu::gles2::ContextGroup* context_group() const {
+    return context_group_.get();
+  }
+
   // Identifies the target surface.
   int32 surface_id() const { return surface_id_; }
 
@@ -30,6 +30,9 @@ const int kDelayedScheduleManageTimeoutMs = 67;
 
 const uint64 kBytesAllocatedUnmanagedStep = 16 * 1024 * 1024;
 
+// How long a memory pressure signal keeps allocations lowered.
+const int kMemoryPressureTimeoutMs = 10000;
+
 void TrackValueChanged(uint64 old_size, uint64 new_size, uint64* total_size) {
   DCHECK(new_size > old_size || *total_size >= (old_size - new_size));
   *total_size += (new_size - old_size);
@@ -55,6 +58,9 @@ GpuMemoryManager::GpuMemoryManager(
       max_surfaces_with_frontbuffer_soft_limit_(
           max_surfaces_with_frontbuffer_soft_limit),
       priority_cutoff_(MemoryAllocation::CUTOFF_ALLOW_EVERYTHING),
+      under_memory_pressure_(false),
+      memory_pressure_level_(
+          base::MemoryPressureListener::MEMORY_PRESSURE_MODERATE),
       bytes_available_gpu_memory_(0),
       bytes_available_gpu_memory_overridden_(false),
       bytes_minimum_per_client_(0),
@@ -99,6 +105,10 @@ GpuMemoryManager::GpuMemoryManager(
     bytes_available_gpu_memory_overridden_ = true;
   } else
     bytes_available_gpu_memory_ = GetDefaultAvailableGpuMemory();
+
+  memory_pressure_listener_.reset(new base::MemoryPressureListener(
+      base::Bind(&GpuMemoryManager::OnMemoryPressure,
+                 base::Unretained(this))));
 }
 
 GpuMemoryManager::~GpuMemoryManager() {
@@ -388,10 +398,62 @@ void GpuMemoryManager::GetVideoMemoryUsageStats(
       bytes_allocated_historical_max_;
 }
 
+void GpuMemoryManager::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  under_memory_pressure_ = true;
+  memory_pressure_level_ = level;
+  memory_pressure_time_ = base::TimeTicks::Now();
+  ScheduleManage(kScheduleManageNow);
+
+  // Re-manage once the pressure times out, to restore the allocations.
+  if (disable_schedule_manage_)
+    return;
+  base::MessageLoop::current()->PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&GpuMemoryManager::ScheduleManage,
+                 AsWeakPtr(),
+                 kScheduleManageNow),
+      base::TimeDelta::FromMilliseconds(kMemoryPressureTimeoutMs));
+}
+
+void GpuMemoryManager::UpdateMemoryPressure() {
+  if (under_memory_pressure_ &&
+      base::TimeTicks::Now() - memory_pressure_time_ >=
+          base::TimeDelta::FromMilliseconds(kMemoryPressureTimeoutMs)) {
+    under_memory_pressure_ = false;
+  }
+}
+
+MemoryAllocation::PriorityCutoff GpuMemoryManager::GetPriorityCutoff() const {
+  if (!under_memory_pressure_)
+    return priority_cutoff_;
+  // Under moderate pressure drop everything that is merely prepaint, and
+  // under critical pressure keep only what is needed to draw.
+  MemoryAllocation::PriorityCutoff cutoff =
+      memory_pressure_level_ ==
+          base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL ?
+      MemoryAllocation::CUTOFF_ALLOW_REQUIRED_ONLY :
+      MemoryAllocation::CUTOFF_ALLOW_NICE_TO_HAVE;
+  return std::min(cutoff, priority_cutoff_);
+}
+
+uint64 GpuMemoryManager::GetMaxSurfacesWithFrontbuffer() const {
+  // Under critical pressure, only visible clients keep their frontbuffers.
+  if (under_memory_pressure_ &&
+      memory_pressure_level_ ==
+          base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL) {
+    return 0;
+  }
+  return max_surfaces_with_frontbuffer_soft_limit_;
+}
+
 void GpuMemoryManager::Manage() {
   manage_immediate_scheduled_ = false;
   delayed_manage_callback_.Cancel();
 
+  // Expire any memory pressure signal that has timed out.
+  UpdateMemoryPressure();
+
   // Update the amount of GPU memory available on the system.
   UpdateAvailableGpuMemory();
 
@@ -646,8 +708,11 @@ void GpuMemoryManager::AssignSurfacesAllocations() {
   // Compute allocation when for all clients.
   ComputeVisibleSurfacesAllocations();
 
-  // Distribute the remaining memory to visible clients.
-  DistributeRemainingMemoryToVisibleSurfaces();
+  // Distribute the remaining memory to visible clients, unless the system
+  // is short on memory, in which case clients are held to what they asked
+  // for.
+  if (!under_memory_pressure_)
+    DistributeRemainingMemoryToVisibleSurfaces();
 
   // Send that allocation to the clients.
   ClientStateList clients = clients_visible_mru_;
@@ -671,7 +736,7 @@ void GpuMemoryManager::AssignSurfacesAllocations() {
 
     allocation.bytes_limit_when_visible =
         client_state->bytes_allocation_when_visible_;
-    allocation.priority_cutoff_when_visible = priority_cutoff_;
+    allocation.priority_cutoff_when_visible = GetPriorityCutoff();
 
     client_state->client_->SetMemoryAllocation(allocation);
     client_state->client_->SuggestHaveFrontBuffer(!client_state->hibernated_);
@@ -720,7 +785,7 @@ void GpuMemoryManager::SetClientsHibernatedState() const {
        it != clients_nonvisible_mru_.end();
        ++it) {
     GpuMemoryManagerClientState* client_state = *it;
-    if (non_hibernated_clients < max_surfaces_with_frontbuffer_soft_limit_) {
+    if (non_hibernated_clients < GetMaxSurfacesWithFrontbuffer()) {
       client_state->hibernated_ = false;
       client_state->tracking_group_->hibernated_ = false;
       non_hibernated_clients++;
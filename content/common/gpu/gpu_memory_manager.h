@@ -12,7 +12,10 @@
 #include "base/cancelable_callback.h"
 #include "base/containers/hash_tables.h"
 #include "base/gtest_prod_util.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "content/common/content_export.h"
 #include "content/public/common/gpu_memory_stats.h"
 #include "gpu/command_buffer/common/gpu_memory_allocation.h"
@@ -101,6 +104,8 @@ class CONTENT_EXPORT GpuMemoryManager :
                            UnmanagedTracking);
   FRIEND_TEST_ALL_PREFIXES(GpuMemoryManagerTest,
                            DefaultAllocation);
+  FRIEND_TEST_ALL_PREFIXES(GpuMemoryManagerTest,
+                           MemoryPressure);
 
   typedef std::map<gpu::gles2::MemoryTracker*, GpuMemoryTrackingGroup*>
       TrackingGroupMap;
@@ -109,6 +114,19 @@ class CONTENT_EXPORT GpuMemoryManager :
 
   void Manage();
   void SetClientsHibernatedState() const;
+
+  // Record a memory pressure signal and re-manage right away, so that clients
+  // are told to drop their lowest priority memory while it still matters.
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
+
+  // Forget the last memory pressure signal once it is old enough, since there
+  // is no signal for the pressure going away.
+  void UpdateMemoryPressure();
+
+  // The priority cutoff and frontbuffer limit, lowered under memory pressure.
+  gpu::MemoryAllocation::PriorityCutoff GetPriorityCutoff() const;
+  uint64 GetMaxSurfacesWithFrontbuffer() const;
   void AssignSurfacesAllocations();
   void AssignNonSurfacesAllocations();
 
@@ -230,6 +248,12 @@ class CONTENT_EXPORT GpuMemoryManager :
   // The priority cutoff used for all renderers.
   gpu::MemoryAllocation::PriorityCutoff priority_cutoff_;
 
+  // The most recent memory pressure signal, if any, and when it arrived.
+  scoped_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+  bool under_memory_pressure_;
+  base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level_;
+  base::TimeTicks memory_pressure_time_;
+
   // The maximum amount of memory that may be allocated for GPU resources
   uint64 bytes_available_gpu_memory_;
   bool bytes_available_gpu_memory_overridden_;
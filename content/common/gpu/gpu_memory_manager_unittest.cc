@@ -609,4 +609,47 @@ TEST_F(GpuMemoryManagerTest, DefaultAllocation) {
             memmgr_.GetDefaultClientAllocation());
 }
 
+// Test that memory pressure lowers allocations until it times out.
+TEST_F(GpuMemoryManagerTest, MemoryPressure) {
+  // Set memory manager constants for this test
+  memmgr_.TestingSetAvailableGpuMemory(64);
+  memmgr_.TestingSetMinimumClientAllocation(8);
+
+  FakeClient stub1(&memmgr_, GenerateUniqueSurfaceId(), true);
+  FakeClient stub2(&memmgr_, GenerateUniqueSurfaceId(), false);
+  SetClientStats(&stub1, 8, 12);
+
+  // Without pressure the visible client gets its nice-to-have amount plus
+  // a share of the remaining memory.
+  Manage();
+  EXPECT_EQ(32u, stub1.BytesWhenVisible());
+  EXPECT_TRUE(stub2.suggest_have_frontbuffer_);
+
+  // Under moderate pressure it is held to its nice-to-have amount.
+  memmgr_.OnMemoryPressure(
+      base::MemoryPressureListener::MEMORY_PRESSURE_MODERATE);
+  Manage();
+  EXPECT_EQ(16u, stub1.BytesWhenVisible());
+  EXPECT_LE(stub1.allocation_.priority_cutoff_when_visible,
+            MemoryAllocation::CUTOFF_ALLOW_NICE_TO_HAVE);
+  EXPECT_TRUE(stub2.suggest_have_frontbuffer_);
+
+  // Under critical pressure only what is required is kept, and nonvisible
+  // clients drop their frontbuffers.
+  memmgr_.OnMemoryPressure(
+      base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL);
+  Manage();
+  EXPECT_EQ(MemoryAllocation::CUTOFF_ALLOW_REQUIRED_ONLY,
+            stub1.allocation_.priority_cutoff_when_visible);
+  EXPECT_FALSE(stub2.suggest_have_frontbuffer_);
+
+  // Once the pressure times out, allocations are restored.
+  memmgr_.memory_pressure_time_ -= base::TimeDelta::FromSeconds(60);
+  Manage();
+  EXPECT_EQ(32u, stub1.BytesWhenVisible());
+  EXPECT_EQ(memmgr_.priority_cutoff_,
+            stub1.allocation_.priority_cutoff_when_visible);
+  EXPECT_TRUE(stub2.suggest_have_frontbuffer_);
+}
+
 }  // namespace content
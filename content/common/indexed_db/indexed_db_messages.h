@@ -255,7 +255,10 @@ IPC_STRUCT_BEGIN(IndexedDBMsg_CallbacksSuccessCursorPrefetch_Params)
   IPC_STRUCT_MEMBER(int32, ipc_cursor_id)
   IPC_STRUCT_MEMBER(std::vector<content::IndexedDBKey>, keys)
   IPC_STRUCT_MEMBER(std::vector<content::IndexedDBKey>, primary_keys)
-  IPC_STRUCT_MEMBER(std::vector<std::string>, values)
+  // The values are concatenated into one string, |value_sizes| gives the
+  // length of each of them.
+  IPC_STRUCT_MEMBER(std::string, values)
+  IPC_STRUCT_MEMBER(std::vector<uint32>, value_sizes)
 IPC_STRUCT_END()
 
 IPC_STRUCT_BEGIN(IndexedDBIndexMetadata)
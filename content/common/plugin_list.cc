@@ -284,6 +284,48 @@ void PluginList::SetPlugins(const std::vector<WebPluginInfo>& plugins) {
     loading_state_ = LOADING_STATE_UP_TO_DATE;
 
   plugins_list_ = plugins;
+  BuildMimeTypeIndexLocked();
+}
+
+void PluginList::BuildMimeTypeIndexLocked() {
+  lock_.AssertAcquired();
+  mime_type_index_.clear();
+  pattern_plugins_.clear();
+  for (size_t i = 0; i < plugins_list_.size(); ++i) {
+    const std::vector<WebPluginMimeType>& mime_types =
+        plugins_list_[i].mime_types;
+    bool has_pattern = false;
+    for (size_t j = 0; j < mime_types.size(); ++j) {
+      const std::string& mime_type = mime_types[j].mime_type;
+      if (mime_type.find_first_of("*;") != std::string::npos) {
+        has_pattern = true;
+        continue;
+      }
+      std::vector<size_t>& indices = mime_type_index_[mime_type];
+      if (indices.empty() || indices.back() != i)
+        indices.push_back(i);
+    }
+    if (has_pattern)
+      pattern_plugins_.push_back(i);
+  }
+}
+
+void PluginList::GetCandidatePluginsLocked(const std::string& mime_type,
+                                           std::vector<size_t>* indices) {
+  lock_.AssertAcquired();
+  indices->clear();
+  MimeTypeIndex::const_iterator it =
+      mime_type_index_.find(mime_type.substr(0, mime_type.find(';')));
+  if (it == mime_type_index_.end()) {
+    *indices = pattern_plugins_;
+    return;
+  }
+  indices->resize(it->second.size() + pattern_plugins_.size());
+  std::vector<size_t>::iterator end =
+      std::set_union(it->second.begin(), it->second.end(),
+                     pattern_plugins_.begin(), pattern_plugins_.end(),
+                     indices->begin());
+  indices->erase(end, indices->end());
 }
 
 void PluginList::set_will_load_plugins_callback(const base::Closure& callback) {
@@ -328,11 +370,15 @@ void PluginList::GetPluginInfoArray(
   std::set<base::FilePath> visited_plugins;
 
   // Add in plugins by mime type.
-  for (size_t i = 0; i < plugins_list_.size(); ++i) {
-    if (SupportsType(plugins_list_[i], mime_type, allow_wildcard)) {
-      base::FilePath path = plugins_list_[i].path;
+  std::vector<size_t> candidates;
+  if (!mime_type.empty())
+    GetCandidatePluginsLocked(mime_type, &candidates);
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    const WebPluginInfo& plugin = plugins_list_[candidates[i]];
+    if (SupportsType(plugin, mime_type, allow_wildcard)) {
+      base::FilePath path = plugin.path;
       if (visited_plugins.insert(path).second) {
-        info->push_back(plugins_list_[i]);
+        info->push_back(plugin);
         if (actual_mime_types)
           actual_mime_types->push_back(mime_type);
       }
@@ -5,6 +5,7 @@
 #ifndef CONTENT_COMMON_PLUGIN_LIST_H_
 #define CONTENT_COMMON_PLUGIN_LIST_H_
 
+#include <map>
 #include <set>
 #include <string>
 #include <utility>
@@ -209,6 +210,16 @@ class CONTENT_EXPORT PluginList {
   // called while holding |lock_|.
   void RemoveExtraPluginPathLocked(const base::FilePath& plugin_path);
 
+  // Rebuilds |mime_type_index_| and |pattern_plugins_| from |plugins_list_|.
+  // Should only be called while holding |lock_|.
+  void BuildMimeTypeIndexLocked();
+
+  // Returns the positions in |plugins_list_| of the plugins that may support
+  // |mime_type|, in increasing order. They still need to be checked with
+  // SupportsType(). Should only be called while holding |lock_|.
+  void GetCandidatePluginsLocked(const std::string& mime_type,
+                                 std::vector<size_t>* indices);
+
   //
   // Command-line switches
   //
@@ -240,6 +251,16 @@ class CONTENT_EXPORT PluginList {
   // A list holding all plug-ins.
   std::vector<WebPluginInfo> plugins_list_;
 
+  // Maps the MIME types that plug-ins list literally, without wildcards or
+  // parameters, to the positions of those plug-ins in |plugins_list_|, so that
+  // looking up a type doesn't go through every plug-in.
+  typedef std::map<std::string, std::vector<size_t> > MimeTypeIndex;
+  MimeTypeIndex mime_type_index_;
+
+  // The positions of the plug-ins that list a MIME type pattern, which may
+  // match any type.
+  std::vector<size_t> pattern_plugins_;
+
   // Callback that is invoked whenever the PluginList will reload the plugins.
   base::Closure will_load_plugins_callback_;
 
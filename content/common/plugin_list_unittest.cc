@@ -136,6 +136,52 @@ TEST_F(PluginListTest, GetPluginInfoArray) {
   EXPECT_EQ(kFooMimeType, actual_mime_types.front());
 }
 
+TEST_F(PluginListTest, GetPluginInfoArrayWithPatterns) {
+  WebPluginInfo baz_plugin(base::ASCIIToUTF16("Baz Plugin"),
+                           base::FilePath(FILE_PATH_LITERAL("/baz.plugin")),
+                           base::ASCIIToUTF16("3.4.5"),
+                           base::ASCIIToUTF16("baz"));
+  baz_plugin.mime_types.push_back(
+      WebPluginMimeType("application/*", std::string(), std::string()));
+  plugin_list_.RegisterInternalPlugin(baz_plugin, false);
+  plugin_list_.RefreshPlugins();
+
+  GURL target_url("http://example.com/test");
+  std::vector<WebPluginInfo> plugins;
+
+  // Plugins that list the type and plugins whose pattern matches it are both
+  // returned, in the order they were registered.
+  plugin_list_.GetPluginInfoArray(target_url,
+                                  std::string(kFooMimeType) + ";version=2",
+                                  false, // allow_wildcard
+                                  NULL,  // use_stale
+                                  false, // include_npapi
+                                  &plugins,
+                                  NULL);
+  ASSERT_EQ(2u, plugins.size());
+  EXPECT_TRUE(Equals(foo_plugin_, plugins[0]));
+  EXPECT_TRUE(Equals(baz_plugin, plugins[1]));
+
+  plugin_list_.GetPluginInfoArray(target_url,
+                                  "application/x-other",
+                                  false, // allow_wildcard
+                                  NULL,  // use_stale
+                                  false, // include_npapi
+                                  &plugins,
+                                  NULL);
+  ASSERT_EQ(1u, plugins.size());
+  EXPECT_TRUE(Equals(baz_plugin, plugins[0]));
+
+  plugin_list_.GetPluginInfoArray(target_url,
+                                  "text/plain",
+                                  false, // allow_wildcard
+                                  NULL,  // use_stale
+                                  false, // include_npapi
+                                  &plugins,
+                                  NULL);
+  EXPECT_EQ(0u, plugins.size());
+}
+
 #if defined(OS_POSIX) && !defined(OS_MACOSX)
 
 // Test parsing a simple description: Real Audio.
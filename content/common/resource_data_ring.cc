@@ -0,0 +1,110 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/common/resource_data_ring.h"
+
+#include "base/logging.h"
+
+namespace content {
+
+// The layout of the shared memory. The cursors count chunks, and wrap around.
+// Each one is only written by one side, and is kept on its own cache line so
+// that the two sides don't slow each other down.
+struct ResourceDataRing::Control {
+  // Written by the producer.
+  base::subtle::Atomic32 write_index;
+  char padding1[60];
+
+  // Written by the consumer.
+  base::subtle::Atomic32 read_index;
+  char padding2[60];
+
+  // Set by the producer, cleared by whichever side sees it first.
+  base::subtle::Atomic32 producer_waiting;
+  char padding3[60];
+
+  // Written by the producer before it publishes them with |write_index|.
+  Chunk chunks[kCapacity];
+};
+
+const int ResourceDataRing::kCapacity;
+
+// static
+size_t ResourceDataRing::GetSizeInBytes() {
+  return sizeof(Control);
+}
+
+ResourceDataRing::ResourceDataRing(void* memory)
+    : control_(static_cast<Control*>(memory)),
+      write_index_(0),
+      consumed_index_(0),
+      read_index_(0) {
+  DCHECK(control_);
+}
+
+ResourceDataRing::~ResourceDataRing() {
+}
+
+bool ResourceDataRing::IsFull() const {
+  return write_index_ - consumed_index_ >= static_cast<uint32>(kCapacity);
+}
+
+bool ResourceDataRing::Push(const Chunk& chunk) {
+  DCHECK(!IsFull());
+  control_->chunks[write_index_ % kCapacity] = chunk;
+  ++write_index_;
+  base::subtle::Release_Store(&control_->write_index,
+                              static_cast<int32>(write_index_));
+
+  // The consumer stores its cursor and then loads ours, so with a full barrier
+  // between our store and our load, at least one side sees the other's update.
+  base::subtle::MemoryBarrier();
+  uint32 read_index =
+      static_cast<uint32>(base::subtle::NoBarrier_Load(&control_->read_index));
+  return read_index == write_index_ - 1;
+}
+
+int ResourceDataRing::TakeConsumedCount() {
+  uint32 read_index =
+      static_cast<uint32>(base::subtle::Acquire_Load(&control_->read_index));
+  uint32 consumed = read_index - consumed_index_;
+  if (consumed > write_index_ - consumed_index_) {
+    // The consumer can't have popped chunks that weren't pushed.
+    return 0;
+  }
+  consumed_index_ = read_index;
+  return static_cast<int>(consumed);
+}
+
+void ResourceDataRing::SetProducerWaiting() {
+  base::subtle::NoBarrier_Store(&control_->producer_waiting, 1);
+  base::subtle::MemoryBarrier();
+}
+
+void ResourceDataRing::ClearProducerWaiting() {
+  base::subtle::NoBarrier_Store(&control_->producer_waiting, 0);
+}
+
+bool ResourceDataRing::Peek(Chunk* chunk) {
+  uint32 write_index =
+      static_cast<uint32>(base::subtle::Acquire_Load(&control_->write_index));
+  if (write_index == read_index_)
+    return false;
+  *chunk = control_->chunks[read_index_ % kCapacity];
+  return true;
+}
+
+bool ResourceDataRing::Pop() {
+  ++read_index_;
+  base::subtle::Release_Store(&control_->read_index,
+                              static_cast<int32>(read_index_));
+
+  // Pairs with the barrier in SetProducerWaiting(), and makes the next Peek()
+  // see any chunk whose Push() didn't see this pop.
+  base::subtle::MemoryBarrier();
+  return base::subtle::NoBarrier_AtomicExchange(
+      &control_->producer_waiting, 0) != 0;
+}
+
+}  // namespace content
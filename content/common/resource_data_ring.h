@@ -0,0 +1,98 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CONTENT_COMMON_RESOURCE_DATA_RING_H_
+#define CONTENT_COMMON_RESOURCE_DATA_RING_H_
+
+#include "base/atomicops.h"
+#include "base/basictypes.h"
+#include "content/common/content_export.h"
+
+namespace content {
+
+// A single-producer, single-consumer queue of the chunks of response data that
+// the browser (the producer) wrote to a shared memory buffer for a child
+// process (the consumer). It lives in the same shared memory, right after the
+// buffer, so chunks are passed without an IPC each.
+//
+// The two sides only need to wake each other up on state transitions:
+// - Push() returns true when the consumer had taken every chunk, so the
+//   consumer must be told that there is data again.
+// - Pop() returns true when the producer has called SetProducerWaiting()
+//   because it ran out of space, so the producer must be told that there is
+//   space again.
+// Both sides check the other's cursor after publishing their own, so neither
+// can go idle while the other thinks it is busy.
+//
+// A ResourceDataRing object only holds one side's view of the ring, so the
+// producer and the consumer each wrap the memory with their own object.
+class CONTENT_EXPORT ResourceDataRing {
+ public:
+  struct Chunk {
+    int32 offset;
+    int32 length;
+    int32 encoded_length;
+  };
+
+  // The number of chunks the ring can hold.
+  static const int kCapacity = 128;
+
+  // Returns the size of the shared memory used by the ring.
+  static size_t GetSizeInBytes();
+
+  // |memory| must be GetSizeInBytes() long, and zero-filled before either side
+  // uses it, as newly created shared memory is.
+  explicit ResourceDataRing(void* memory);
+  ~ResourceDataRing();
+
+  // Producer side ------------------------------------------------------------
+
+  // Returns true if there is no room for another chunk until the consumer
+  // pops one and TakeConsumedCount() sees it.
+  bool IsFull() const;
+
+  // Appends |chunk|. Returns true if the consumer had already popped every
+  // chunk, in which case it must be signalled.
+  bool Push(const Chunk& chunk);
+
+  // Returns the number of chunks the consumer has popped since the last call,
+  // in the order they were pushed. Their data may be overwritten. The count
+  // written by the consumer isn't trusted: it can't exceed what was pushed.
+  int TakeConsumedCount();
+
+  // Asks the consumer to signal the next time it pops a chunk. The caller
+  // must call TakeConsumedCount() after this, as the consumer may have popped
+  // chunks just before.
+  void SetProducerWaiting();
+  void ClearProducerWaiting();
+
+  // Consumer side ------------------------------------------------------------
+
+  // Copies the oldest chunk into |chunk|, and returns false if there is none.
+  bool Peek(Chunk* chunk);
+
+  // Removes the oldest chunk, after the caller is done with its data. Returns
+  // true if the producer is waiting for space, in which case it must be
+  // signalled.
+  bool Pop();
+
+ private:
+  struct Control;
+
+  Control* control_;
+
+  // The number of chunks pushed, and the number known to have been consumed,
+  // on the producer side.
+  uint32 write_index_;
+  uint32 consumed_index_;
+
+  // The number of chunks popped, on the consumer side.
+  uint32 read_index_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResourceDataRing);
+};
+
+}  // namespace content
+
+#endif  // CONTENT_COMMON_RESOURCE_DATA_RING_H_
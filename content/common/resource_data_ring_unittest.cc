@@ -0,0 +1,115 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/common/resource_data_ring.h"
+
+#include <vector>
+
+#include "base/atomicops.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace content {
+namespace {
+
+class ResourceDataRingTest : public testing::Test {
+ protected:
+  ResourceDataRingTest()
+      : memory_(ResourceDataRing::GetSizeInBytes()),
+        producer_(&memory_[0]),
+        consumer_(&memory_[0]) {
+  }
+
+  static ResourceDataRing::Chunk MakeChunk(int offset) {
+    ResourceDataRing::Chunk chunk = { offset, 10, 20 };
+    return chunk;
+  }
+
+  std::vector<char> memory_;
+  ResourceDataRing producer_;
+  ResourceDataRing consumer_;
+};
+
+TEST_F(ResourceDataRingTest, PushAndPop) {
+  ResourceDataRing::Chunk chunk;
+  EXPECT_FALSE(consumer_.Peek(&chunk));
+
+  EXPECT_TRUE(producer_.Push(MakeChunk(0)));
+  EXPECT_FALSE(producer_.Push(MakeChunk(10)));
+
+  ASSERT_TRUE(consumer_.Peek(&chunk));
+  EXPECT_EQ(0, chunk.offset);
+  EXPECT_EQ(10, chunk.length);
+  EXPECT_EQ(20, chunk.encoded_length);
+  EXPECT_FALSE(consumer_.Pop());
+  EXPECT_EQ(1, producer_.TakeConsumedCount());
+
+  ASSERT_TRUE(consumer_.Peek(&chunk));
+  EXPECT_EQ(10, chunk.offset);
+  EXPECT_FALSE(consumer_.Pop());
+  EXPECT_FALSE(consumer_.Peek(&chunk));
+  EXPECT_EQ(1, producer_.TakeConsumedCount());
+  EXPECT_EQ(0, producer_.TakeConsumedCount());
+
+  // The consumer has taken everything, so it must be signalled again.
+  EXPECT_TRUE(producer_.Push(MakeChunk(20)));
+}
+
+TEST_F(ResourceDataRingTest, Full) {
+  for (int i = 0; i < ResourceDataRing::kCapacity; ++i) {
+    EXPECT_FALSE(producer_.IsFull());
+    producer_.Push(MakeChunk(i));
+  }
+  EXPECT_TRUE(producer_.IsFull());
+
+  // Popped chunks only make room once the producer takes them.
+  ResourceDataRing::Chunk chunk;
+  ASSERT_TRUE(consumer_.Peek(&chunk));
+  EXPECT_EQ(0, chunk.offset);
+  consumer_.Pop();
+  EXPECT_TRUE(producer_.IsFull());
+  EXPECT_EQ(1, producer_.TakeConsumedCount());
+  EXPECT_FALSE(producer_.IsFull());
+
+  // The chunks wrap around.
+  producer_.Push(MakeChunk(ResourceDataRing::kCapacity));
+  for (int i = 1; i <= ResourceDataRing::kCapacity; ++i) {
+    ASSERT_TRUE(consumer_.Peek(&chunk));
+    EXPECT_EQ(i, chunk.offset);
+    consumer_.Pop();
+  }
+  EXPECT_FALSE(consumer_.Peek(&chunk));
+  EXPECT_EQ(ResourceDataRing::kCapacity, producer_.TakeConsumedCount());
+}
+
+TEST_F(ResourceDataRingTest, ProducerWaiting) {
+  producer_.Push(MakeChunk(0));
+  producer_.Push(MakeChunk(10));
+  producer_.SetProducerWaiting();
+  EXPECT_EQ(0, producer_.TakeConsumedCount());
+
+  // Only the first pop after the producer starts waiting signals it.
+  EXPECT_TRUE(consumer_.Pop());
+  EXPECT_FALSE(consumer_.Pop());
+  EXPECT_EQ(2, producer_.TakeConsumedCount());
+
+  producer_.Push(MakeChunk(20));
+  producer_.SetProducerWaiting();
+  producer_.ClearProducerWaiting();
+  EXPECT_FALSE(consumer_.Pop());
+}
+
+TEST_F(ResourceDataRingTest, BogusConsumer) {
+  producer_.Push(MakeChunk(0));
+
+  // A consumer can't claim to have popped chunks that weren't pushed.
+  ResourceDataRing::Chunk chunk;
+  ASSERT_TRUE(consumer_.Peek(&chunk));
+  consumer_.Pop();
+  consumer_.Pop();
+  EXPECT_EQ(0, producer_.TakeConsumedCount());
+  EXPECT_FALSE(producer_.IsFull());
+}
+
+}  // namespace
+}  // namespace content
@@ -286,6 +286,21 @@ IPC_MESSAGE_CONTROL4(ResourceMsg_DataReceived,
                      int /* data_length */,
                      int /* encoded_data_length */)
 
+// Sent instead of SetDataBuffer when the locations of the data are passed
+// through a ResourceDataRing instead of DataReceived messages. The shared
+// memory holds |shm_size| bytes of data followed by the ring. The renderer maps
+// it writable, so that it can pop chunks from the ring.
+IPC_MESSAGE_CONTROL4(ResourceMsg_SetDataRing,
+                     int /* request_id */,
+                     base::SharedMemoryHandle /* shm_handle */,
+                     int /* shm_size */,
+                     base::ProcessId /* renderer_pid */)
+
+// Sent when the ResourceDataRing of a request goes from empty to non-empty.
+// The renderer pops chunks until the ring is empty again.
+IPC_MESSAGE_CONTROL1(ResourceMsg_DataAvailable,
+                     int /* request_id */)
+
 // Sent when some data from a resource request has been downloaded to
 // file. This is only called in the 'download_to_file' case and replaces
 // ResourceMsg_DataReceived in the call sequence in that case.
@@ -328,6 +343,11 @@ IPC_SYNC_MESSAGE_ROUTED2_1(ResourceHostMsg_SyncLoad,
 IPC_MESSAGE_CONTROL1(ResourceHostMsg_DataReceived_ACK,
                      int /* request_id */)
 
+// Sent when the renderer pops a chunk from a ResourceDataRing while the browser
+// is waiting for space to read more data.
+IPC_MESSAGE_CONTROL1(ResourceHostMsg_DataConsumed,
+                     int /* request_id */)
+
 // Sent when the renderer has processed a DataDownloaded message.
 IPC_MESSAGE_CONTROL1(ResourceHostMsg_DataDownloaded_ACK,
                      int /* request_id */)
@@ -42,9 +42,16 @@ enum {
   kZygoteCommandGetTerminationStatus = 2,
 
   // Read a bitmask of kSandboxLinux*
-  kZygoteCommandGetSandboxStatus = 3
+  kZygoteCommandGetSandboxStatus = 3,
+
+  // Set how many forked renderers the zygote keeps ready for the next
+  // renderer fork requests.
+  kZygoteCommandSetRendererPoolSize = 4
 };
 
+// The largest number of forked renderers the zygote keeps ready.
+const int kZygoteMaxRendererPoolSize = 2;
+
 }  // namespace content
 
 #endif  // CONTENT_COMMON_ZYGOTE_COMMANDS_LINUX_H_
@@ -448,6 +448,12 @@ const char kEnableGpuClientTracing[]        = "enable-gpu-client-tracing";
 // impl-side painting.
 const char kEnableGpuRasterization[]        = "enable-gpu-rasterization";
 
+// Lets the GPU process handle the messages of contexts in one share group
+// while contexts in another share group of the same channel are descheduled,
+// instead of handling all of a channel's messages in order.
+const char kEnableGpuShareGroupScheduling[] =
+    "enable-gpu-share-group-scheduling";
+
 // When using CPU rasterizing generate low resolution tiling. Low res
 // tiles may be displayed during fast scrolls especially on slower devices.
 const char kEnableLowResTiling[] = "enable-low-res-tiling";
@@ -523,6 +529,11 @@ const char kEnableRegionBasedColumns[] =
 const char kEnableRepaintAfterLayout[] =
     "enable-repaint-after-layout";
 
+// Passes response data to renderers through a ring of chunk locations in the
+// shared data buffer, instead of an IPC and an acknowledgement per chunk.
+const char kEnableResourceDataRing[] =
+    "enable-resource-data-ring";
+
 // Enables targeted style recalculation optimizations.
 const char kEnableTargetedStyleRecalc[] =
     "enable-targeted-style-recalc";
@@ -531,6 +542,11 @@ const char kEnableTargetedStyleRecalc[] =
 // is denied by the sandbox.
 const char kEnableSandboxLogging[]          = "enable-sandbox-logging";
 
+// Makes renderers record their histograms in memory shared with the browser,
+// which reads them directly instead of receiving them pickled over IPC.
+const char kEnableSharedMemoryHistograms[]  =
+    "enable-shared-memory-histograms";
+
 // Enables the Skia benchmarking extension
 const char kEnableSkiaBenchmarking[]        = "enable-skia-benchmarking";
 
@@ -792,6 +808,11 @@ const char kRendererAssertTest[]            = "renderer-assert-test";
 // command line. Useful values might be "valgrind" or "xterm -e gdb --args".
 const char kRendererCmdPrefix[]             = "renderer-cmd-prefix";
 
+// On Linux, the number of renderers the zygote forks ahead of time, so that
+// new renderers start faster. Overrides the size picked from the available
+// memory; 0 disables the pool.
+const char kRendererPoolSize[]              = "renderer-pool-size";
+
 // Causes the process to run as renderer instead of as browser.
 const char kRendererProcess[]               = "renderer";
 
@@ -7,8 +7,10 @@
 #include <list>
 #include <map>
 
+#include "base/memory/shared_memory.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/synchronization/lock.h"
+#include "content/common/dom_storage/dom_storage_map.h"
 #include "content/common/dom_storage/dom_storage_messages.h"
 #include "content/common/dom_storage/dom_storage_types.h"
 #include "content/renderer/dom_storage/dom_storage_cached_area.h"
@@ -239,8 +241,18 @@ void DomStorageDispatcher::ProxyImpl::LoadArea(
     int connection_id, DOMStorageValuesMap* values, bool* send_log_get_messages,
     const CompletionCallback& callback) {
   PushPendingCallback(callback);
+  base::SharedMemoryHandle handle = base::SharedMemory::NULLHandle();
+  uint32 size = 0;
   throttling_filter_->SendThrottled(new DOMStorageHostMsg_LoadStorageArea(
-      connection_id, values, send_log_get_messages));
+      connection_id, &handle, &size, values, send_log_get_messages));
+  if (!base::SharedMemory::IsHandleValid(handle))
+    return;
+
+  // The cache is primed only once, so rather than let the page see an
+  // empty area, treat a failure like running out of memory.
+  base::SharedMemory snapshot(handle, true);
+  CHECK(snapshot.Map(size));
+  CHECK(DOMStorageMap::ReadSnapshot(snapshot.memory(), size, values));
 }
 
 void DomStorageDispatcher::ProxyImpl::SetItem(
@@ -237,9 +237,18 @@ InputHandlerProxy::EventDisposition InputHandlerProxy::HandleInputEvent(
       if (input_handler_->HaveTouchEventHandlersAt(
               gfx::Point(touch_event.touches[i].position.x,
                          touch_event.touches[i].position.y))) {
+        TRACE_EVENT_INSTANT0(
+            "input",
+            "InputHandlerProxy::handle_input touch handler hit",
+            TRACE_EVENT_SCOPE_THREAD);
         return DID_NOT_HANDLE;
       }
     }
+    // None of the new touch points hit a touch handler region, so the whole
+    // touch sequence is handled without involving the main thread.
+    TRACE_EVENT_INSTANT0("input",
+                         "InputHandlerProxy::handle_input touch handler missed",
+                         TRACE_EVENT_SCOPE_THREAD);
     return DROP_EVENT;
   } else if (WebInputEvent::isKeyboardEventType(event.type)) {
     CancelCurrentFling(true);
@@ -57,7 +57,9 @@ class MediaStreamAudioProcessor::MediaStreamAudioConverter
                             const media::AudioParameters& sink_params)
      : source_params_(source_params),
        sink_params_(sink_params),
-       audio_converter_(source_params, sink_params_, false) {
+       audio_converter_(source_params, sink_params_,
+                        source_params.sample_rate() ==
+                            sink_params.sample_rate()) {
     // An instance of MediaStreamAudioConverter may be created in the main
     // render thread and used in the audio thread, for example, the
     // |MediaStreamAudioProcessor::capture_converter_|.
@@ -149,6 +151,10 @@ class MediaStreamAudioProcessor::MediaStreamAudioConverter
 
   // TODO(xians): consider using SincResampler to save some memcpy.
   // Handles mixing and resampling between input and output parameters.
+  // |fifo_| already rebuffers the source data, so the converter's own FIFO,
+  // which would copy the data once more, is disabled when not resampling.
+  // It can't be disabled when resampling, since only with the FIFO enabled
+  // does the resampler ask for input in chunks of the source buffer size.
   media::AudioConverter audio_converter_;
   scoped_ptr<media::AudioBus> audio_wrapper_;
   scoped_ptr<media::AudioFifo> fifo_;
@@ -441,8 +447,6 @@ void MediaStreamAudioProcessor::InitializeRenderConverterIfNeeded(
       kAudioProcessingSampleRate / 100);
   render_converter_.reset(
       new MediaStreamAudioConverter(source_params, sink_params));
-  render_data_bus_ = media::AudioBus::Create(number_of_channels,
-                                             frames_per_buffer);
 }
 
 int MediaStreamAudioProcessor::ProcessData(webrtc::AudioFrame* audio_frame,
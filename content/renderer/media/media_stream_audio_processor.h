@@ -166,9 +166,6 @@ class CONTENT_EXPORT MediaStreamAudioProcessor :
   // AudioFrame used to hold the output of |render_converter_|.
   webrtc::AudioFrame render_frame_;
 
-  // Data bus to help converting interleaved data to an AudioBus.
-  scoped_ptr<media::AudioBus> render_data_bus_;
-
   // Raw pointer to the WebRtcPlayoutDataSource, which is valid for the
   // lifetime of RenderThread.
   WebRtcPlayoutDataSource* const playout_data_source_;
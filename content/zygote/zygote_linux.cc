@@ -10,6 +10,8 @@
 #include <sys/types.h>
 #include <sys/wait.h>
 
+#include <algorithm>
+
 #include "base/command_line.h"
 #include "base/debug/trace_event.h"
 #include "base/file_util.h"
@@ -25,6 +27,7 @@
 #include "content/common/set_process_title.h"
 #include "content/common/zygote_commands_linux.h"
 #include "content/public/common/content_descriptors.h"
+#include "content/public/common/content_switches.h"
 #include "content/public/common/result_codes.h"
 #include "content/public/common/sandbox_linux.h"
 #include "content/public/common/zygote_fork_delegate_linux.h"
@@ -53,7 +56,8 @@ int LookUpFd(const base::GlobalDescriptors::Mapping& fd_mapping, uint32_t key) {
 
 Zygote::Zygote(int sandbox_flags,
                ZygoteForkDelegate* helper)
-    : sandbox_flags_(sandbox_flags),
+    : renderer_pool_size_(0),
+      sandbox_flags_(sandbox_flags),
       helper_(helper),
       initial_uma_sample_(0),
       initial_uma_boundary_value_(0) {
@@ -103,6 +107,10 @@ bool Zygote::ProcessRequests() {
     // This function call can return multiple times, once per fork().
     if (HandleRequestFromBrowser(kZygoteSocketPairFd))
       return true;
+    // Replace the renderers claimed by the request. This also returns in a
+    // pooled renderer once it is claimed.
+    if (FillRendererPool())
+      return true;
   }
 }
 
@@ -160,6 +168,11 @@ bool Zygote::HandleRequestFromBrowser(int fd) {
       case kZygoteCommandGetSandboxStatus:
         HandleGetSandboxStatus(fd, pickle, iter);
         return false;
+      case kZygoteCommandSetRendererPoolSize:
+        if (!fds.empty())
+          break;
+        HandleSetRendererPoolSize(pickle, iter);
+        return false;
       default:
         NOTREACHED();
         break;
@@ -352,6 +365,10 @@ int Zygote::ForkWithRealPid(const std::string& process_type,
 #endif
     close(pipe_fds[0]);
     close(dummy_fd);
+    // Only the zygote may hand fork requests to pooled renderers.
+    for (size_t i = 0; i < renderer_pool_.size(); ++i)
+      close(renderer_pool_[i].claim_fd);
+    renderer_pool_.clear();
     return 0;
   } else {
     // In the parent process.
@@ -428,49 +445,88 @@ int Zygote::ForkWithRealPid(const std::string& process_type,
   return -1;
 }
 
-base::ProcessId Zygote::ReadArgsAndFork(const Pickle& pickle,
-                                        PickleIterator iter,
-                                        std::vector<int>& fds,
-                                        std::string* uma_name,
-                                        int* uma_sample,
-                                        int* uma_boundary_value) {
-  std::vector<std::string> args;
+bool Zygote::ReadForkArgs(const Pickle& pickle,
+                          PickleIterator iter,
+                          const std::vector<int>& fds,
+                          std::string* process_type,
+                          std::vector<std::string>* args,
+                          base::GlobalDescriptors::Mapping* mapping,
+                          std::string* channel_id) {
   int argc = 0;
   int numfds = 0;
-  base::GlobalDescriptors::Mapping mapping;
-  std::string process_type;
-  std::string channel_id;
   const std::string channel_id_prefix = std::string("--")
       + switches::kProcessChannelID + std::string("=");
 
-  if (!pickle.ReadString(&iter, &process_type))
-    return -1;
+  if (!pickle.ReadString(&iter, process_type))
+    return false;
   if (!pickle.ReadInt(&iter, &argc))
-    return -1;
+    return false;
 
   for (int i = 0; i < argc; ++i) {
     std::string arg;
     if (!pickle.ReadString(&iter, &arg))
-      return -1;
-    args.push_back(arg);
+      return false;
+    args->push_back(arg);
     if (arg.compare(0, channel_id_prefix.length(), channel_id_prefix) == 0)
-      channel_id = arg;
+      *channel_id = arg;
   }
 
   if (!pickle.ReadInt(&iter, &numfds))
-    return -1;
+    return false;
   if (numfds != static_cast<int>(fds.size()))
-    return -1;
+    return false;
 
   for (int i = 0; i < numfds; ++i) {
     base::GlobalDescriptors::Key key;
     if (!pickle.ReadUInt32(&iter, &key))
-      return -1;
-    mapping.push_back(std::make_pair(key, fds[i]));
+      return false;
+    mapping->push_back(std::make_pair(key, fds[i]));
   }
 
-  mapping.push_back(std::make_pair(
+  mapping->push_back(std::make_pair(
       static_cast<uint32_t>(kSandboxIPCChannel), GetSandboxFD()));
+  return true;
+}
+
+void Zygote::SetUpChild(const std::vector<std::string>& args,
+                        const base::GlobalDescriptors::Mapping& mapping) {
+  close(kZygoteSocketPairFd);  // Our socket from the browser.
+  if (UsingSUIDSandbox())
+    close(kZygoteIdFd);  // Another socket from the browser.
+  base::GlobalDescriptors::GetInstance()->Reset(mapping);
+
+  // Reset the process-wide command line to our new command line.
+  CommandLine::Reset();
+  CommandLine::Init(0, NULL);
+  CommandLine::ForCurrentProcess()->InitFromArgv(args);
+
+  // Update the process title. The argv was already cached by the call to
+  // SetProcessTitleFromCommandLine in ChromeMain, so we can pass NULL here
+  // (we don't have the original argv at this point).
+  SetProcessTitleFromCommandLine(NULL);
+}
+
+base::ProcessId Zygote::ReadArgsAndFork(const Pickle& pickle,
+                                        PickleIterator iter,
+                                        std::vector<int>& fds,
+                                        std::string* uma_name,
+                                        int* uma_sample,
+                                        int* uma_boundary_value) {
+  std::vector<std::string> args;
+  base::GlobalDescriptors::Mapping mapping;
+  std::string process_type;
+  std::string channel_id;
+
+  if (!ReadForkArgs(pickle, iter, fds, &process_type, &args, &mapping,
+                    &channel_id)) {
+    return -1;
+  }
+
+  if (process_type == switches::kRendererProcess) {
+    base::ProcessId child_pid = ClaimPooledRenderer(pickle, fds);
+    if (child_pid > 0)
+      return child_pid;
+  }
 
   // Returns twice, once per process.
   base::ProcessId child_pid = ForkWithRealPid(process_type, mapping, channel_id,
@@ -478,24 +534,10 @@ base::ProcessId Zygote::ReadArgsAndFork(const Pickle& pickle,
                                               uma_boundary_value);
   if (!child_pid) {
     // This is the child process.
-
-    close(kZygoteSocketPairFd);  // Our socket from the browser.
-    if (UsingSUIDSandbox())
-      close(kZygoteIdFd);  // Another socket from the browser.
-    base::GlobalDescriptors::GetInstance()->Reset(mapping);
-
-    // Reset the process-wide command line to our new command line.
-    CommandLine::Reset();
-    CommandLine::Init(0, NULL);
-    CommandLine::ForCurrentProcess()->InitFromArgv(args);
-
-    // Update the process title. The argv was already cached by the call to
-    // SetProcessTitleFromCommandLine in ChromeMain, so we can pass NULL here
-    // (we don't have the original argv at this point).
-    SetProcessTitleFromCommandLine(NULL);
+    SetUpChild(args, mapping);
   } else if (child_pid < 0) {
     LOG(ERROR) << "Zygote could not fork: process_type " << process_type
-        << " numfds " << numfds << " child_pid " << child_pid;
+        << " numfds " << fds.size() << " child_pid " << child_pid;
   }
   return child_pid;
 }
@@ -549,4 +591,108 @@ bool Zygote::HandleGetSandboxStatus(int fd,
   return false;
 }
 
+void Zygote::HandleSetRendererPoolSize(const Pickle& pickle,
+                                       PickleIterator iter) {
+  int size;
+  if (!pickle.ReadInt(&iter, &size) || size < 0) {
+    LOG(WARNING) << "Error parsing SetRendererPoolSize request from browser";
+    return;
+  }
+
+  renderer_pool_size_ = std::min(size, kZygoteMaxRendererPoolSize);
+  while (renderer_pool_.size() > renderer_pool_size_) {
+    DropPooledRenderer(renderer_pool_.back());
+    renderer_pool_.pop_back();
+  }
+}
+
+bool Zygote::FillRendererPool() {
+  while (renderer_pool_.size() < renderer_pool_size_) {
+    int claim_fds[2];
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, claim_fds) != 0) {
+      PLOG(ERROR) << "Failed to create renderer pool socket";
+      return false;
+    }
+
+    std::string uma_name;
+    int uma_sample;
+    int uma_boundary_value;
+    base::ProcessId real_pid = ForkWithRealPid(
+        switches::kRendererProcess, base::GlobalDescriptors::Mapping(),
+        std::string(), &uma_name, &uma_sample, &uma_boundary_value);
+    if (real_pid == 0) {
+      // This is the pooled renderer.
+      close(claim_fds[0]);
+      WaitForClaim(claim_fds[1]);
+      return true;
+    }
+
+    close(claim_fds[1]);
+    if (real_pid < 0) {
+      close(claim_fds[0]);
+      LOG(ERROR) << "Zygote could not fork a pooled renderer";
+      return false;
+    }
+
+    PooledRenderer renderer;
+    renderer.real_pid = real_pid;
+    renderer.internal_pid = process_info_map_[real_pid].internal_pid;
+    renderer.claim_fd = claim_fds[0];
+    renderer_pool_.push_back(renderer);
+  }
+  return false;
+}
+
+void Zygote::WaitForClaim(int claim_fd) {
+  std::vector<int> fds;
+  char buf[kZygoteMaxMessageLength];
+  const ssize_t len = UnixDomainSocket::RecvMsg(claim_fd, buf, sizeof(buf),
+                                                &fds);
+  if (len <= 0) {
+    // The zygote dropped us, or exited.
+    _exit(0);
+  }
+  close(claim_fd);
+
+  // The zygote has already checked the request.
+  Pickle pickle(buf, len);
+  PickleIterator iter(pickle);
+  int kind;
+  std::string process_type;
+  std::vector<std::string> args;
+  base::GlobalDescriptors::Mapping mapping;
+  std::string channel_id;
+  if (!pickle.ReadInt(&iter, &kind) || kind != kZygoteCommandFork ||
+      !ReadForkArgs(pickle, iter, fds, &process_type, &args, &mapping,
+                    &channel_id)) {
+    LOG(FATAL) << "Invalid fork request for pooled renderer";
+  }
+  SetUpChild(args, mapping);
+}
+
+base::ProcessId Zygote::ClaimPooledRenderer(const Pickle& pickle,
+                                            const std::vector<int>& fds) {
+  while (!renderer_pool_.empty()) {
+    PooledRenderer renderer = renderer_pool_.front();
+    renderer_pool_.pop_front();
+    if (UnixDomainSocket::SendMsg(renderer.claim_fd, pickle.data(),
+                                  pickle.size(), fds)) {
+      close(renderer.claim_fd);
+      return renderer.real_pid;
+    }
+    // The renderer died while waiting in the pool.
+    PLOG(ERROR) << "Failed to claim pooled renderer";
+    DropPooledRenderer(renderer);
+  }
+  return -1;
+}
+
+void Zygote::DropPooledRenderer(const PooledRenderer& renderer) {
+  // Closing the socket makes the renderer exit.
+  close(renderer.claim_fd);
+  if (HANDLE_EINTR(waitpid(renderer.internal_pid, NULL, 0)) < 0)
+    PLOG(ERROR) << "Failed to reap pooled renderer";
+  process_info_map_.erase(renderer.real_pid);
+}
+
 }  // namespace content
@@ -5,6 +5,7 @@
 #ifndef CONTENT_ZYGOTE_ZYGOTE_H_
 #define CONTENT_ZYGOTE_ZYGOTE_H_
 
+#include <deque>
 #include <string>
 #include <vector>
 
@@ -42,6 +43,17 @@ class Zygote {
   typedef base::SmallMap< std::map<base::ProcessHandle, ZygoteProcessInfo> >
       ZygoteProcessMap;
 
+  // A renderer forked ahead of time, waiting for the fork request it will
+  // serve.
+  struct PooledRenderer {
+    // Pid as it appears outside of the sandbox.
+    base::ProcessHandle real_pid;
+    // Pid from inside the Zygote's PID namespace.
+    base::ProcessHandle internal_pid;
+    // Our end of the socket the fork request is passed on through.
+    int claim_fd;
+  };
+
   // Retrieve a ZygoteProcessInfo from the process_info_map_.
   // Returns true and write to process_info if |pid| can be found, return
   // false otherwise.
@@ -84,6 +96,21 @@ class Zygote {
                       int* uma_sample,
                       int* uma_boundary_value);
 
+  // Unpacks the process type, arguments and descriptors of a fork request.
+  // Returns false if the request is malformed.
+  bool ReadForkArgs(const Pickle& pickle,
+                    PickleIterator iter,
+                    const std::vector<int>& fds,
+                    std::string* process_type,
+                    std::vector<std::string>* args,
+                    base::GlobalDescriptors::Mapping* mapping,
+                    std::string* channel_id);
+
+  // Installs the command line and descriptors of a fork request in a new
+  // child process, forked or claimed from the renderer pool.
+  void SetUpChild(const std::vector<std::string>& args,
+                  const base::GlobalDescriptors::Mapping& mapping);
+
   // Unpacks process type and arguments from |pickle| and forks a new process.
   // Returns -1 on error, otherwise returns twice, returning 0 to the child
   // process and the child process ID to the parent process, like fork().
@@ -107,12 +134,41 @@ class Zygote {
                               const Pickle& pickle,
                               PickleIterator iter);
 
+  void HandleSetRendererPoolSize(const Pickle& pickle, PickleIterator iter);
+
+  // ---------------------------------------------------------------------------
+  // The renderer pool...
+
+  // Forks renderers until the pool has |renderer_pool_size_| of them. Returns
+  // true if we are in a pooled renderer that has been claimed, and thus need
+  // to unwind back into ChromeMain.
+  bool FillRendererPool();
+
+  // Blocks a pooled renderer until a fork request arrives on |claim_fd|, and
+  // sets it up for that request. Exits if the zygote drops it instead.
+  void WaitForClaim(int claim_fd);
+
+  // Hands the fork request |pickle|, with its descriptors |fds|, to a pooled
+  // renderer. Returns the renderer's PID, or -1 if the pool is empty.
+  base::ProcessId ClaimPooledRenderer(const Pickle& pickle,
+                                      const std::vector<int>& fds);
+
+  // Terminates and reaps an unclaimed pooled renderer.
+  void DropPooledRenderer(const PooledRenderer& renderer);
+
   // The Zygote needs to keep some information about each process. Most
   // notably what the PID of the process is inside the PID namespace of
   // the Zygote and whether or not a process was started by the
   // ZygoteForkDelegate helper.
   ZygoteProcessMap process_info_map_;
 
+  // Renderers forked ahead of fork requests, so that a new renderer does
+  // not wait for the fork and for the lookup of its real PID. They get their
+  // command line and descriptors, and so their sandbox settings, only when
+  // claimed.
+  std::deque<PooledRenderer> renderer_pool_;
+  size_t renderer_pool_size_;
+
   const int sandbox_flags_;
   ZygoteForkDelegate* helper_;
 
@@ -15,6 +15,8 @@
       'third_party/bsdiff_apply.cc',
       'third_party/bsdiff_create.cc',
       'third_party/paged_array.h',
+      'third_party/suffix_array.cc',
+      'third_party/suffix_array.h',
       'courgette.h',
       'crc.cc',
       'crc.h',
@@ -108,7 +110,8 @@
         'streams_unittest.cc',
         'typedrva_unittest.cc',
         'versioning_unittest.cc',
-        'third_party/paged_array_unittest.cc'
+        'third_party/paged_array_unittest.cc',
+        'third_party/suffix_array_unittest.cc',
       ],
       'dependencies': [
         'courgette_lib',
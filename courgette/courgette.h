@@ -90,6 +90,22 @@ Status ApplyEnsemblePatch(const base::FilePath::CharType* old_file_name,
 Status GenerateEnsemblePatch(SourceStream* old, SourceStream* target,
                              SinkStream* patch);
 
+// Sets how many elements of an ensemble GenerateEnsemblePatch() and
+// ApplyEnsemblePatch() transform at the same time, each on its own thread.
+// Each element in flight holds its disassembled programs in memory, so this
+// also bounds the extra memory used. The default is the number of
+// processors, at most 4. 1 transforms the elements one at a time on the
+// calling thread. Set it before generating or applying patches.
+void SetMaxParallelElements(size_t count);
+
+// Receives the wall time of each stage of GenerateEnsemblePatch() and
+// ApplyEnsemblePatch(), such as "transform elements", when it ends.
+typedef void (*StageTimingCallback)(const char* stage, double seconds);
+
+// Sets the callback for stage timings, or NULL for none. Set it before
+// generating or applying patches.
+void SetStageTimingCallback(StageTimingCallback callback);
+
 // Detects the type of an executable file, and it's length. The length
 // may be slightly smaller than some executables (like ELF), but will include
 // all bytes the courgette algorithm has special benefit for.
@@ -28,6 +28,10 @@ void PrintHelp() {
     "  courgette -disadj <executable_file> <reference> <binary_assembly_file>\n"
     "  courgette -gen <v1> <v2> <patch>\n"
     "  courgette -apply <v1> <patch> <v2>\n"
+    "\n"
+    "Options for -gen and -apply:\n"
+    "  -threads=N  transform up to N elements in parallel\n"
+    "  -timing     print the time taken by each stage\n"
     "\n");
 }
 
@@ -47,6 +51,10 @@ void Problem(const char* format, ...) {
   exit(1);
 }
 
+void PrintStageTiming(const char* stage, double seconds) {
+  fprintf(stderr, "%-28s %8.3fs\n", stage, seconds);
+}
+
 std::string ReadOrFail(const base::FilePath& file_name, const char* kind) {
   int64 file_size = 0;
   if (!base::GetFileSize(file_name, &file_size))
@@ -460,6 +468,17 @@ int main(int argc, const char* argv[]) {
     if (!base::StringToInt(repeat_switch, &repeat_count))
       repeat_count = 1;
 
+  std::string threads_switch = command_line.GetSwitchValueASCII("threads");
+  if (!threads_switch.empty()) {
+    int threads = 0;
+    if (!base::StringToInt(threads_switch, &threads) || threads < 1)
+      UsageProblem("-threads=N needs a positive N");
+    courgette::SetMaxParallelElements(threads);
+  }
+
+  if (command_line.HasSwitch("timing"))
+    courgette::SetStageTimingCallback(&PrintStageTiming);
+
   if (cmd_sup + cmd_dis + cmd_asm + cmd_disadj + cmd_make_patch +
       cmd_apply_patch + cmd_make_bsdiff_patch + cmd_apply_bsdiff_patch +
       cmd_spread_1_adjusted + cmd_spread_1_unadjusted
@@ -4,8 +4,13 @@
 
 #include "courgette/ensemble.h"
 
+#include <algorithm>
+
 #include "base/basictypes.h"
+#include "base/logging.h"
+#include "base/memory/scoped_vector.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/sys_info.h"
 
 #include "courgette/region.h"
 #include "courgette/simple_delta.h"
@@ -13,6 +18,76 @@
 
 namespace courgette {
 
+namespace {
+
+// The most elements transformed at the same time by default. Disassembled
+// programs take several times the size of the executable, so even machines
+// with many processors should not transform too many at once.
+const size_t kDefaultMaxParallelElements = 4;
+
+// 0 until SetMaxParallelElements() is called.
+size_t g_max_parallel_elements = 0;
+
+StageTimingCallback g_stage_timing_callback = NULL;
+
+}  // namespace
+
+void SetMaxParallelElements(size_t count) {
+  DCHECK_GT(count, 0u);
+  g_max_parallel_elements = count;
+}
+
+size_t MaxParallelElements() {
+  if (g_max_parallel_elements)
+    return g_max_parallel_elements;
+  return std::min(
+      kDefaultMaxParallelElements,
+      static_cast<size_t>(std::max(base::SysInfo::NumberOfProcessors(), 1)));
+}
+
+void RunElementTasks(
+    const std::vector<base::DelegateSimpleThread::Delegate*>& tasks) {
+  if (tasks.empty())
+    return;
+  ScopedVector<base::DelegateSimpleThread> threads;
+  for (size_t i = 1;  i < tasks.size();  ++i) {
+    base::DelegateSimpleThread* thread =
+        new base::DelegateSimpleThread(tasks[i], "courgette_element");
+    thread->Start();
+    threads.push_back(thread);
+  }
+  tasks[0]->Run();
+  for (size_t i = 0;  i < threads.size();  ++i)
+    threads[i]->Join();
+}
+
+void SetStageTimingCallback(StageTimingCallback callback) {
+  g_stage_timing_callback = callback;
+}
+
+StageTimer::StageTimer() : stage_(NULL) {
+}
+
+StageTimer::~StageTimer() {
+  EndStage();
+}
+
+void StageTimer::StartStage(const char* stage) {
+  EndStage();
+  stage_ = stage;
+  start_ = base::TimeTicks::Now();
+}
+
+void StageTimer::EndStage() {
+  if (!stage_)
+    return;
+  double seconds = (base::TimeTicks::Now() - start_).InSecondsF();
+  VLOG(1) << "done " << stage_ << " " << seconds << "s";
+  if (g_stage_timing_callback)
+    g_stage_timing_callback(stage_, seconds);
+  stage_ = NULL;
+}
+
 Element::Element(ExecutableType kind,
                  Ensemble* ensemble,
                  const Region& region)
@@ -21,6 +21,8 @@
 #include <string>
 
 #include "base/basictypes.h"
+#include "base/threading/simple_thread.h"
+#include "base/time/time.h"
 
 #include "courgette/courgette.h"
 #include "courgette/region.h"
@@ -244,5 +246,36 @@ class TransformationPatchGenerator {
   TransformationPatcher* patcher_;
 };
 
+// Returns how many elements to transform at the same time. See
+// SetMaxParallelElements().
+size_t MaxParallelElements();
+
+// Runs all |tasks| at the same time, one on the calling thread and the others
+// on threads of their own, and returns once they are all done. Callers pass
+// at most MaxParallelElements() tasks at a time.
+void RunElementTasks(
+    const std::vector<base::DelegateSimpleThread::Delegate*>& tasks);
+
+// Times consecutive stages of patch generation or application. Each stage
+// lasts until the next one starts or the timer is destroyed, and its time is
+// reported to VLOG(1) and to the callback passed to SetStageTimingCallback().
+class StageTimer {
+ public:
+  StageTimer();
+  ~StageTimer();
+
+  // Ends the current stage, if any, and starts |stage|, which must be a
+  // literal.
+  void StartStage(const char* stage);
+
+ private:
+  void EndStage();
+
+  const char* stage_;
+  base::TimeTicks start_;
+
+  DISALLOW_COPY_AND_ASSIGN(StageTimer);
+};
+
 }  // namespace
 #endif  // COURGETTE_ENSEMBLE_H_
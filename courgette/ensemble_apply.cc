@@ -6,10 +6,13 @@
 
 #include "courgette/ensemble.h"
 
+#include <algorithm>
+
 #include "base/basictypes.h"
 #include "base/file_util.h"
 #include "base/files/memory_mapped_file.h"
 #include "base/logging.h"
+#include "base/memory/scoped_vector.h"
 #include "courgette/crc.h"
 #include "courgette/region.h"
 #include "courgette/streams.h"
@@ -18,6 +21,63 @@
 
 namespace courgette {
 
+namespace {
+
+// Transforms the old element of one patcher, possibly on a thread of its own.
+class TransformTask : public base::DelegateSimpleThread::Delegate {
+ public:
+  explicit TransformTask(TransformationPatcher* patcher)
+      : patcher_(patcher),
+        status_(C_GENERAL_ERROR) {
+  }
+
+  // base::DelegateSimpleThread::Delegate overrides:
+  virtual void Run() OVERRIDE {
+    status_ = patcher_->Transform(&parameters_, &transformed_element_);
+  }
+
+  SourceStreamSet* parameters() { return &parameters_; }
+  SinkStreamSet* transformed_element() { return &transformed_element_; }
+  Status status() const { return status_; }
+
+ private:
+  TransformationPatcher* patcher_;
+  SourceStreamSet parameters_;
+  SinkStreamSet transformed_element_;
+  Status status_;
+
+  DISALLOW_COPY_AND_ASSIGN(TransformTask);
+};
+
+// Reforms the new element of one patcher into a stream of its own, possibly
+// on a thread of its own.
+class ReformTask : public base::DelegateSimpleThread::Delegate {
+ public:
+  explicit ReformTask(TransformationPatcher* patcher)
+      : patcher_(patcher),
+        status_(C_GENERAL_ERROR) {
+  }
+
+  // base::DelegateSimpleThread::Delegate overrides:
+  virtual void Run() OVERRIDE {
+    status_ = patcher_->Reform(&transformed_element_, &reformed_element_);
+  }
+
+  SourceStreamSet* transformed_element() { return &transformed_element_; }
+  SinkStream* reformed_element() { return &reformed_element_; }
+  Status status() const { return status_; }
+
+ private:
+  TransformationPatcher* patcher_;
+  SourceStreamSet transformed_element_;
+  SinkStream reformed_element_;
+  Status status_;
+
+  DISALLOW_COPY_AND_ASSIGN(ReformTask);
+};
+
+}  // namespace
+
 // EnsemblePatchApplication is all the logic and data required to apply the
 // multi-stage patch.
 class EnsemblePatchApplication {
@@ -199,19 +259,32 @@ Status EnsemblePatchApplication::SubpatchTransformParameters(
 Status EnsemblePatchApplication::TransformUp(
     SourceStreamSet* parameters,
     SinkStreamSet* transformed_elements) {
-  for (size_t i = 0;  i < patchers_.size();  ++i) {
-    SourceStreamSet single_parameters;
-    if (!parameters->ReadSet(&single_parameters))
-      return C_STREAM_ERROR;
-    SinkStreamSet single_transformed_element;
-    Status status = patchers_[i]->Transform(&single_parameters,
-                                            &single_transformed_element);
-    if (status != C_OK)
-      return status;
-    if (!single_parameters.Empty())
-      return C_STREAM_NOT_CONSUMED;
-    if (!transformed_elements->WriteSet(&single_transformed_element))
-      return C_STREAM_ERROR;
+  // Transform a few elements at a time in parallel, and append their results
+  // in order before starting the next few.
+  const size_t batch_size = MaxParallelElements();
+  for (size_t first = 0;  first < patchers_.size();  first += batch_size) {
+    size_t end = std::min(first + batch_size, patchers_.size());
+    ScopedVector<TransformTask> tasks;
+    std::vector<base::DelegateSimpleThread::Delegate*> delegates;
+    for (size_t i = first;  i < end;  ++i) {
+      TransformTask* task = new TransformTask(patchers_[i]);
+      tasks.push_back(task);
+      delegates.push_back(task);
+      if (!parameters->ReadSet(task->parameters()))
+        return C_STREAM_ERROR;
+    }
+
+    RunElementTasks(delegates);
+
+    for (size_t i = 0;  i < tasks.size();  ++i) {
+      TransformTask* task = tasks[i];
+      if (task->status() != C_OK)
+        return task->status();
+      if (!task->parameters()->Empty())
+        return C_STREAM_NOT_CONSUMED;
+      if (!transformed_elements->WriteSet(task->transformed_element()))
+        return C_STREAM_ERROR;
+    }
   }
 
   if (!parameters->Empty())
@@ -242,16 +315,32 @@ Status EnsemblePatchApplication::TransformDown(
   if (!basic_elements->Write(base_region_.start(), base_region_.length()))
     return C_STREAM_ERROR;
 
-  for (size_t i = 0;  i < patchers_.size();  ++i) {
-    SourceStreamSet single_corrected_element;
-    if (!transformed_elements->ReadSet(&single_corrected_element))
-      return C_STREAM_ERROR;
-    Status status = patchers_[i]->Reform(&single_corrected_element,
-                                         basic_elements);
-    if (status != C_OK)
-      return status;
-    if (!single_corrected_element.Empty())
-      return C_STREAM_NOT_CONSUMED;
+  // Each element is reformed into a stream of its own, so that a few can be
+  // assembled in parallel, and then appended in order.
+  const size_t batch_size = MaxParallelElements();
+  for (size_t first = 0;  first < patchers_.size();  first += batch_size) {
+    size_t end = std::min(first + batch_size, patchers_.size());
+    ScopedVector<ReformTask> tasks;
+    std::vector<base::DelegateSimpleThread::Delegate*> delegates;
+    for (size_t i = first;  i < end;  ++i) {
+      ReformTask* task = new ReformTask(patchers_[i]);
+      tasks.push_back(task);
+      delegates.push_back(task);
+      if (!transformed_elements->ReadSet(task->transformed_element()))
+        return C_STREAM_ERROR;
+    }
+
+    RunElementTasks(delegates);
+
+    for (size_t i = 0;  i < tasks.size();  ++i) {
+      ReformTask* task = tasks[i];
+      if (task->status() != C_OK)
+        return task->status();
+      if (!task->transformed_element()->Empty())
+        return C_STREAM_NOT_CONSUMED;
+      if (!basic_elements->Append(task->reformed_element()))
+        return C_STREAM_ERROR;
+    }
   }
 
   if (!transformed_elements->Empty())
@@ -309,7 +398,9 @@ Status ApplyEnsemblePatch(SourceStream* base,
                           SinkStream* output) {
   Status status;
   EnsemblePatchApplication patch_process;
+  StageTimer timer;
 
+  timer.StartStage("read header");
   status = patch_process.ReadHeader(patch);
   if (status != C_OK)
     return status;
@@ -340,6 +431,7 @@ Status ApplyEnsemblePatch(SourceStream* base,
   if (status != C_OK)
     return status;
 
+  timer.StartStage("patch parameters");
   SourceStreamSet corrected_parameters;
   status = patch_process.SubpatchTransformParameters(&predicted_parameters,
                                                      parameter_correction,
@@ -347,12 +439,14 @@ Status ApplyEnsemblePatch(SourceStream* base,
   if (status != C_OK)
     return status;
 
+  timer.StartStage("transform elements");
   SinkStreamSet transformed_elements;
   status = patch_process.TransformUp(&corrected_parameters,
                                      &transformed_elements);
   if (status != C_OK)
     return status;
 
+  timer.StartStage("patch transformed elements");
   SourceStreamSet corrected_transformed_elements;
   status = patch_process.SubpatchTransformedElements(
           &transformed_elements,
@@ -361,6 +455,7 @@ Status ApplyEnsemblePatch(SourceStream* base,
   if (status != C_OK)
     return status;
 
+  timer.StartStage("reform elements");
   SinkStream original_ensemble_and_corrected_base_elements;
   status = patch_process.TransformDown(
       &corrected_transformed_elements,
@@ -368,6 +463,7 @@ Status ApplyEnsemblePatch(SourceStream* base,
   if (status != C_OK)
     return status;
 
+  timer.StartStage("patch ensemble");
   SourceStream final_patch_prediction;
   final_patch_prediction.Init(original_ensemble_and_corrected_base_elements);
   status = patch_process.SubpatchFinalOutput(&final_patch_prediction,
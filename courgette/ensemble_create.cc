@@ -14,11 +14,14 @@
 
 #include "courgette/ensemble.h"
 
+#include <algorithm>
 #include <limits>
 #include <vector>
 
 #include "base/basictypes.h"
 #include "base/logging.h"
+#include "base/memory/scoped_vector.h"
+#include "base/threading/simple_thread.h"
 #include "base/time/time.h"
 
 #include "courgette/crc.h"
@@ -33,6 +36,72 @@
 
 namespace courgette {
 
+namespace {
+
+// Transforms the old and new elements of one generator, possibly on a thread
+// of its own.
+class TransformTask : public base::DelegateSimpleThread::Delegate {
+ public:
+  explicit TransformTask(TransformationPatchGenerator* generator)
+      : generator_(generator),
+        status_(C_GENERAL_ERROR) {
+  }
+
+  // base::DelegateSimpleThread::Delegate overrides:
+  virtual void Run() OVERRIDE {
+    status_ = generator_->Transform(&parameters_,
+                                    &predicted_transformed_element_,
+                                    &corrected_transformed_element_);
+  }
+
+  SourceStreamSet* parameters() { return &parameters_; }
+  SinkStreamSet* predicted_transformed_element() {
+    return &predicted_transformed_element_;
+  }
+  SinkStreamSet* corrected_transformed_element() {
+    return &corrected_transformed_element_;
+  }
+  Status status() const { return status_; }
+
+ private:
+  TransformationPatchGenerator* generator_;
+  SourceStreamSet parameters_;
+  SinkStreamSet predicted_transformed_element_;
+  SinkStreamSet corrected_transformed_element_;
+  Status status_;
+
+  DISALLOW_COPY_AND_ASSIGN(TransformTask);
+};
+
+// Reforms the new element of one generator into a stream of its own,
+// possibly on a thread of its own.
+class ReformTask : public base::DelegateSimpleThread::Delegate {
+ public:
+  explicit ReformTask(TransformationPatchGenerator* generator)
+      : generator_(generator),
+        status_(C_GENERAL_ERROR) {
+  }
+
+  // base::DelegateSimpleThread::Delegate overrides:
+  virtual void Run() OVERRIDE {
+    status_ = generator_->Reform(&transformed_element_, &reformed_element_);
+  }
+
+  SourceStreamSet* transformed_element() { return &transformed_element_; }
+  SinkStream* reformed_element() { return &reformed_element_; }
+  Status status() const { return status_; }
+
+ private:
+  TransformationPatchGenerator* generator_;
+  SourceStreamSet transformed_element_;
+  SinkStream reformed_element_;
+  Status status_;
+
+  DISALLOW_COPY_AND_ASSIGN(ReformTask);
+};
+
+}  // namespace
+
 TransformationPatchGenerator::TransformationPatchGenerator(
     Element* old_element,
     Element* new_element,
@@ -245,7 +314,9 @@ Status GenerateEnsemblePatch(SourceStream* base,
                              SinkStream* final_patch) {
   VLOG(1) << "start GenerateEnsemblePatch";
   base::Time start_time = base::Time::Now();
+  StageTimer timer;
 
+  timer.StartStage("find elements");
   Region old_region(base->Buffer(), base->Remaining());
   Region new_region(update->Buffer(), update->Remaining());
   Ensemble old_ensemble(old_region, "old");
@@ -283,6 +354,7 @@ Status GenerateEnsemblePatch(SourceStream* base,
   //
   // Generate sub-patch for parameters.
   //
+  timer.StartStage("diff parameters");
   SinkStreamSet predicted_parameters_sink;
   SinkStreamSet corrected_parameters_sink;
 
@@ -327,6 +399,7 @@ Status GenerateEnsemblePatch(SourceStream* base,
   //
   // Generate sub-patch for elements.
   //
+  timer.StartStage("transform elements");
   corrected_parameters_source.Init(linearized_corrected_parameters);
   SourceStreamSet corrected_parameters_source_set;
   if (!corrected_parameters_source_set.Init(&corrected_parameters_source))
@@ -335,26 +408,38 @@ Status GenerateEnsemblePatch(SourceStream* base,
   SinkStreamSet predicted_transformed_elements;
   SinkStreamSet corrected_transformed_elements;
 
-  for (size_t i = 0;  i < number_of_transformations;  ++i) {
-    SourceStreamSet single_parameters;
-    if (!corrected_parameters_source_set.ReadSet(&single_parameters))
-      return C_STREAM_ERROR;
-    SinkStreamSet single_predicted_transformed_element;
-    SinkStreamSet single_corrected_transformed_element;
-    Status status = generators[i]->Transform(
-        &single_parameters,
-        &single_predicted_transformed_element,
-        &single_corrected_transformed_element);
-    if (status != C_OK)
-      return status;
-    if (!single_parameters.Empty())
-      return C_STREAM_NOT_CONSUMED;
-    if (!predicted_transformed_elements.WriteSet(
-            &single_predicted_transformed_element))
-      return C_STREAM_ERROR;
-    if (!corrected_transformed_elements.WriteSet(
-            &single_corrected_transformed_element))
-      return C_STREAM_ERROR;
+  // Disassembling, adjusting and encoding the elements dominates the time.
+  // Transform a few elements at a time in parallel, and append their results
+  // in order before starting the next few.
+  const size_t batch_size = MaxParallelElements();
+  for (size_t first = 0;  first < number_of_transformations;
+       first += batch_size) {
+    size_t end = std::min(first + batch_size, number_of_transformations);
+    ScopedVector<TransformTask> tasks;
+    std::vector<base::DelegateSimpleThread::Delegate*> delegates;
+    for (size_t i = first;  i < end;  ++i) {
+      TransformTask* task = new TransformTask(generators[i]);
+      tasks.push_back(task);
+      delegates.push_back(task);
+      if (!corrected_parameters_source_set.ReadSet(task->parameters()))
+        return C_STREAM_ERROR;
+    }
+
+    RunElementTasks(delegates);
+
+    for (size_t i = 0;  i < tasks.size();  ++i) {
+      TransformTask* task = tasks[i];
+      if (task->status() != C_OK)
+        return task->status();
+      if (!task->parameters()->Empty())
+        return C_STREAM_NOT_CONSUMED;
+      if (!predicted_transformed_elements.WriteSet(
+              task->predicted_transformed_element()))
+        return C_STREAM_ERROR;
+      if (!corrected_transformed_elements.WriteSet(
+              task->corrected_transformed_element()))
+        return C_STREAM_ERROR;
+    }
   }
 
   if (!corrected_parameters_source_set.Empty())
@@ -370,6 +455,7 @@ Status GenerateEnsemblePatch(SourceStream* base,
           &linearized_corrected_transformed_elements))
     return C_STREAM_ERROR;
 
+  timer.StartStage("diff transformed elements");
   SourceStream predicted_transformed_elements_source;
   SourceStream corrected_transformed_elements_source;
   predicted_transformed_elements_source
@@ -390,6 +476,7 @@ Status GenerateEnsemblePatch(SourceStream* base,
   //
   // Generate sub-patch for whole enchilada.
   //
+  timer.StartStage("reform elements");
   SinkStream predicted_ensemble;
 
   if (!predicted_ensemble.Write(base->Buffer(), base->Remaining()))
@@ -402,17 +489,31 @@ Status GenerateEnsemblePatch(SourceStream* base,
       .Init(&corrected_transformed_elements_source))
     return C_STREAM_ERROR;
 
-  for (size_t i = 0;  i < number_of_transformations;  ++i) {
-    SourceStreamSet single_corrected_transformed_element;
-    if (!corrected_transformed_elements_source_set.ReadSet(
-            &single_corrected_transformed_element))
-      return C_STREAM_ERROR;
-    Status status = generators[i]->Reform(&single_corrected_transformed_element,
-                                          &predicted_ensemble);
-    if (status != C_OK)
-      return status;
-    if (!single_corrected_transformed_element.Empty())
-      return C_STREAM_NOT_CONSUMED;
+  for (size_t first = 0;  first < number_of_transformations;
+       first += batch_size) {
+    size_t end = std::min(first + batch_size, number_of_transformations);
+    ScopedVector<ReformTask> tasks;
+    std::vector<base::DelegateSimpleThread::Delegate*> delegates;
+    for (size_t i = first;  i < end;  ++i) {
+      ReformTask* task = new ReformTask(generators[i]);
+      tasks.push_back(task);
+      delegates.push_back(task);
+      if (!corrected_transformed_elements_source_set.ReadSet(
+              task->transformed_element()))
+        return C_STREAM_ERROR;
+    }
+
+    RunElementTasks(delegates);
+
+    for (size_t i = 0;  i < tasks.size();  ++i) {
+      ReformTask* task = tasks[i];
+      if (task->status() != C_OK)
+        return task->status();
+      if (!task->transformed_element()->Empty())
+        return C_STREAM_NOT_CONSUMED;
+      if (!predicted_ensemble.Append(task->reformed_element()))
+        return C_STREAM_ERROR;
+    }
   }
 
   if (!corrected_transformed_elements_source_set.Empty())
@@ -423,6 +524,7 @@ Status GenerateEnsemblePatch(SourceStream* base,
 
   FreeGenerators(&generators);
 
+  timer.StartStage("diff ensemble");
   size_t final_patch_input_size = predicted_ensemble.Length();
   SourceStream predicted_ensemble_source;
   predicted_ensemble_source.Init(predicted_ensemble);
@@ -14,6 +14,7 @@ class EnsembleTest : public BaseTest {
   void PeEnsemble() const;
   void Pe64Ensemble() const;
   void Elf32Ensemble() const;
+  void PeEnsembleInParallel() const;
 };
 
 void EnsembleTest::TestEnsemble(std::string src_bytes,
@@ -103,6 +104,42 @@ void EnsembleTest::Pe64Ensemble() const {
   TestEnsemble(src_bytes, tgt_bytes);
 }
 
+// Elements transformed in parallel must give the same patch as elements
+// transformed one at a time.
+void EnsembleTest::PeEnsembleInParallel() const {
+  std::list<std::string> src_ensemble;
+  std::list<std::string> tgt_ensemble;
+
+  src_ensemble.push_back("en-US.dll");
+  src_ensemble.push_back("setup1.exe");
+  src_ensemble.push_back("elf-32-1");
+
+  tgt_ensemble.push_back("en-US.dll");
+  tgt_ensemble.push_back("setup2.exe");
+  tgt_ensemble.push_back("elf-32-2");
+
+  std::string src_bytes = FilesContents(src_ensemble);
+  std::string tgt_bytes = FilesContents(tgt_ensemble);
+
+  courgette::SinkStream patches[2];
+  const size_t kMaxParallelElements[2] = { 1, 3 };
+  for (size_t i = 0;  i < arraysize(patches);  ++i) {
+    courgette::SetMaxParallelElements(kMaxParallelElements[i]);
+    courgette::SourceStream source;
+    courgette::SourceStream target;
+    source.Init(src_bytes);
+    target.Init(tgt_bytes);
+    EXPECT_EQ(courgette::C_OK,
+              courgette::GenerateEnsemblePatch(&source, &target, &patches[i]));
+  }
+
+  ASSERT_EQ(patches[0].Length(), patches[1].Length());
+  EXPECT_FALSE(memcmp(patches[0].Buffer(), patches[1].Buffer(),
+                      patches[0].Length()));
+
+  TestEnsemble(src_bytes, tgt_bytes);
+}
+
 // Ensemble tests still take too long on Windows so disabling for now
 // TODO(dgarrett) http://code.google.com/p/chromium/issues/detail?id=101614
 
@@ -117,3 +154,7 @@ TEST_F(EnsembleTest, DISABLED_PE64) {
 TEST_F(EnsembleTest, DISABLED_Elf32) {
   Elf32Ensemble();
 }
+
+TEST_F(EnsembleTest, DISABLED_PEInParallel) {
+  PeEnsembleInParallel();
+}
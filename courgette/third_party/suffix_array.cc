@@ -0,0 +1,243 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "courgette/third_party/suffix_array.h"
+
+#include <new>
+
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+
+namespace courgette {
+
+namespace {
+
+// The text as the top level of SA-IS sees it: every byte shifted up by one,
+// followed by a sentinel 0 that is smaller than any other character.
+class ShiftedText {
+ public:
+  ShiftedText(const uint8* text, int size) : text_(text), size_(size) {}
+
+  int operator[](int i) const { return i < size_ ? text_[i] + 1 : 0; }
+
+ private:
+  const uint8* text_;
+  int size_;
+};
+
+// The part of a PagedArray<int> from |offset| on. The suffix array and the
+// reduced text of every recursion step are windows of the top level array.
+class Window {
+ public:
+  Window(PagedArray<int>* array, int offset)
+      : array_(array), offset_(offset) {
+  }
+
+  int& operator[](int i) const { return (*array_)[offset_ + i]; }
+
+  Window Subwindow(int offset) const {
+    return Window(array_, offset_ + offset);
+  }
+
+ private:
+  PagedArray<int>* array_;
+  int offset_;
+};
+
+// One bit per position: whether the suffix starting there is S-type, that is
+// smaller than the suffix after it, or L-type, larger.
+class SuffixTypes {
+ public:
+  SuffixTypes() {}
+
+  bool Allocate(int size) {
+    bits_.reset(new(std::nothrow) uint8[size / 8 + 1]);
+    return bits_.get() != NULL;
+  }
+
+  bool IsS(int i) const { return (bits_[i >> 3] >> (i & 7)) & 1; }
+
+  void Set(int i, bool is_s) {
+    if (is_s)
+      bits_[i >> 3] |= 1 << (i & 7);
+    else
+      bits_[i >> 3] &= ~(1 << (i & 7));
+  }
+
+  // Whether |i| is a leftmost S-type position, an S-type position preceded by
+  // an L-type one.
+  bool IsLMS(int i) const { return i > 0 && IsS(i) && !IsS(i - 1); }
+
+ private:
+  scoped_ptr<uint8[]> bits_;
+
+  DISALLOW_COPY_AND_ASSIGN(SuffixTypes);
+};
+
+// Sets |buckets|[c] to the start, or the end if |ends|, of the range of the
+// suffix array holding the suffixes that start with character c.
+template <typename Text>
+void GetBuckets(const Text& text, int size, int alphabet_size, bool ends,
+                int* buckets) {
+  for (int c = 0; c < alphabet_size; ++c)
+    buckets[c] = 0;
+  for (int i = 0; i < size; ++i)
+    ++buckets[text[i]];
+  int sum = 0;
+  for (int c = 0; c < alphabet_size; ++c) {
+    sum += buckets[c];
+    buckets[c] = ends ? sum : sum - buckets[c];
+  }
+}
+
+// Induces the order of the L-type suffixes from the sorted suffixes already
+// in |suffix_array|, scanning left to right.
+template <typename Text>
+void InduceL(const Text& text, Window suffix_array, int size,
+             int alphabet_size, const SuffixTypes& types, int* buckets) {
+  GetBuckets(text, size, alphabet_size, false, buckets);
+  for (int i = 0; i < size; ++i) {
+    int j = suffix_array[i] - 1;
+    if (j >= 0 && !types.IsS(j))
+      suffix_array[buckets[text[j]]++] = j;
+  }
+}
+
+// Induces the order of the S-type suffixes from the sorted L-type suffixes,
+// scanning right to left.
+template <typename Text>
+void InduceS(const Text& text, Window suffix_array, int size,
+             int alphabet_size, const SuffixTypes& types, int* buckets) {
+  GetBuckets(text, size, alphabet_size, true, buckets);
+  for (int i = size - 1; i >= 0; --i) {
+    int j = suffix_array[i] - 1;
+    if (j >= 0 && types.IsS(j))
+      suffix_array[--buckets[text[j]]] = j;
+  }
+}
+
+// Sorts the suffixes of |text|[0, |size|), whose characters are in
+// [0, |alphabet_size|) and whose last character is a unique smallest one.
+// |size| must be at least 2.
+template <typename Text>
+bool SAIS(const Text& text, Window suffix_array, int size,
+          int alphabet_size) {
+  DCHECK_GE(size, 2);
+
+  SuffixTypes types;
+  if (!types.Allocate(size))
+    return false;
+  types.Set(size - 1, true);
+  for (int i = size - 2; i >= 0; --i) {
+    types.Set(i, text[i] < text[i + 1] ||
+                 (text[i] == text[i + 1] && types.IsS(i + 1)));
+  }
+
+  scoped_ptr<int[]> buckets(new(std::nothrow) int[alphabet_size]);
+  if (!buckets)
+    return false;
+
+  // Sort the LMS substrings, the substrings from one LMS position to the
+  // next, by inducing from the LMS positions in arbitrary order.
+  GetBuckets(text, size, alphabet_size, true, buckets.get());
+  for (int i = 0; i < size; ++i)
+    suffix_array[i] = -1;
+  for (int i = 1; i < size; ++i) {
+    if (types.IsLMS(i))
+      suffix_array[--buckets[text[i]]] = i;
+  }
+  InduceL(text, suffix_array, size, alphabet_size, types, buckets.get());
+  InduceS(text, suffix_array, size, alphabet_size, types, buckets.get());
+
+  // Move the sorted LMS positions to the front. There are at most size / 2.
+  int lms_count = 0;
+  for (int i = 0; i < size; ++i) {
+    if (types.IsLMS(suffix_array[i]))
+      suffix_array[lms_count++] = suffix_array[i];
+  }
+
+  // Name each LMS substring by its rank, equal substrings getting the same
+  // name, and store the name of the substring at position p at
+  // lms_count + p / 2. LMS positions are at least two apart, so this slot is
+  // free and unique.
+  for (int i = lms_count; i < size; ++i)
+    suffix_array[i] = -1;
+  int names = 0;
+  int previous = -1;
+  for (int i = 0; i < lms_count; ++i) {
+    int position = suffix_array[i];
+    bool differ = previous < 0;
+    for (int d = 0; !differ; ++d) {
+      if (text[position + d] != text[previous + d] ||
+          types.IsS(position + d) != types.IsS(previous + d)) {
+        differ = true;
+      } else if (d > 0 && (types.IsLMS(position + d) ||
+                           types.IsLMS(previous + d))) {
+        break;
+      }
+    }
+    if (differ) {
+      ++names;
+      previous = position;
+    }
+    suffix_array[lms_count + position / 2] = names - 1;
+  }
+
+  // Gather the names, in text order, at the end of the array. This is the
+  // reduced text, whose suffixes sort like the LMS suffixes of |text|.
+  for (int i = size - 1, j = size - 1; i >= lms_count; --i) {
+    if (suffix_array[i] >= 0)
+      suffix_array[j--] = suffix_array[i];
+  }
+  Window reduced_text = suffix_array.Subwindow(size - lms_count);
+
+  // Sort the reduced text into the front of the array, recursing only when
+  // some names are repeated.
+  if (names < lms_count) {
+    buckets.reset();
+    if (!SAIS(reduced_text, suffix_array, lms_count, names))
+      return false;
+    buckets.reset(new(std::nothrow) int[alphabet_size]);
+    if (!buckets)
+      return false;
+  } else {
+    for (int i = 0; i < lms_count; ++i)
+      suffix_array[reduced_text[i]] = i;
+  }
+
+  // Map the sorted reduced suffixes back to LMS positions, put them at the
+  // ends of their buckets, and induce the order of all suffixes from them.
+  for (int i = 1, j = 0; i < size; ++i) {
+    if (types.IsLMS(i))
+      reduced_text[j++] = i;
+  }
+  for (int i = 0; i < lms_count; ++i)
+    suffix_array[i] = reduced_text[suffix_array[i]];
+  for (int i = lms_count; i < size; ++i)
+    suffix_array[i] = -1;
+  GetBuckets(text, size, alphabet_size, true, buckets.get());
+  for (int i = lms_count - 1; i >= 0; --i) {
+    int j = suffix_array[i];
+    suffix_array[i] = -1;
+    suffix_array[--buckets[text[j]]] = j;
+  }
+  InduceL(text, suffix_array, size, alphabet_size, types, buckets.get());
+  InduceS(text, suffix_array, size, alphabet_size, types, buckets.get());
+  return true;
+}
+
+}  // namespace
+
+bool BuildSuffixArray(const uint8* text, int size,
+                      PagedArray<int>* suffix_array) {
+  DCHECK_GE(size, 0);
+  if (size == 0) {
+    (*suffix_array)[0] = 0;
+    return true;
+  }
+  // The sentinel ends the text, so the empty suffix sorts first.
+  return SAIS(ShiftedText(text, size), Window(suffix_array, 0), size + 1, 257);
+}
+
+}  // namespace courgette
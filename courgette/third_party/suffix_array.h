@@ -0,0 +1,31 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef COURGETTE_THIRD_PARTY_SUFFIX_ARRAY_H_
+#define COURGETTE_THIRD_PARTY_SUFFIX_ARRAY_H_
+
+#include "base/basictypes.h"
+#include "courgette/third_party/paged_array.h"
+
+namespace courgette {
+
+// Builds the suffix array of |text|[0, |size|) into |suffix_array|, which must
+// hold |size| + 1 elements. The empty suffix sorts first, so on return
+// suffix_array[0] == size and suffix_array[1 .. size] are the starts of the
+// non-empty suffixes in lexicographic order. This is the layout of the array
+// I[] built by bsdiff's qsufsort().
+//
+// Uses the SA-IS algorithm of Nong, Zhang and Chan, "Two Efficient Algorithms
+// for Linear Time Suffix Array Construction". It runs in linear time and,
+// unlike qsufsort, needs no second array of |size| + 1 ranks: the reduced
+// problem of each recursion step is solved inside |suffix_array| itself. The
+// only other storage is a bit per character and a bucket table per level.
+//
+// Returns false if that storage can't be allocated.
+bool BuildSuffixArray(const uint8* text, int size,
+                      PagedArray<int>* suffix_array);
+
+}  // namespace courgette
+
+#endif  // COURGETTE_THIRD_PARTY_SUFFIX_ARRAY_H_
@@ -0,0 +1,98 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "courgette/third_party/suffix_array.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+// Orders suffixes of |text_| by comparing them directly.
+class SuffixLess {
+ public:
+  explicit SuffixLess(const std::string& text) : text_(text) {}
+
+  bool operator()(int a, int b) const {
+    return text_.compare(a, std::string::npos,
+                         text_, b, std::string::npos) < 0;
+  }
+
+ private:
+  const std::string& text_;
+};
+
+void ExpectSuffixArray(const std::string& text) {
+  const int size = static_cast<int>(text.size());
+  std::vector<int> expected(size + 1);
+  for (int i = 0; i <= size; ++i)
+    expected[i] = i;
+  std::sort(expected.begin(), expected.end(), SuffixLess(text));
+
+  courgette::PagedArray<int> suffix_array;
+  ASSERT_TRUE(suffix_array.Allocate(size + 1));
+  ASSERT_TRUE(courgette::BuildSuffixArray(
+      reinterpret_cast<const uint8*>(text.data()), size, &suffix_array));
+  for (int i = 0; i <= size; ++i)
+    ASSERT_EQ(expected[i], suffix_array[i]) << "at " << i;
+}
+
+}  // namespace
+
+TEST(SuffixArrayTest, Small) {
+  ExpectSuffixArray("");
+  ExpectSuffixArray("a");
+  ExpectSuffixArray("ab");
+  ExpectSuffixArray("ba");
+  ExpectSuffixArray("banana");
+  ExpectSuffixArray("mississippi");
+  ExpectSuffixArray("abracadabra");
+}
+
+TEST(SuffixArrayTest, AllBytes) {
+  std::string text;
+  for (int i = 255; i >= 0; --i)
+    text.push_back(static_cast<char>(i));
+  text.push_back('\0');
+  text.push_back('\xff');
+  ExpectSuffixArray(text);
+}
+
+// Repetitive texts make the LMS substrings repeat, so SA-IS recurses.
+TEST(SuffixArrayTest, Repetitive) {
+  ExpectSuffixArray(std::string(1000, 'a'));
+  ExpectSuffixArray(std::string(1000, '\0'));
+
+  std::string periodic;
+  for (int i = 0; i < 300; ++i)
+    periodic += "abcab";
+  ExpectSuffixArray(periodic);
+
+  // Fibonacci strings are notoriously deep for suffix sorting.
+  std::string previous = "a";
+  std::string fibonacci = "ab";
+  while (fibonacci.size() < 5000) {
+    std::string next = fibonacci + previous;
+    previous = fibonacci;
+    fibonacci = next;
+  }
+  ExpectSuffixArray(fibonacci);
+}
+
+TEST(SuffixArrayTest, Random) {
+  unsigned int seed = 1;
+  for (int alphabet_size = 2; alphabet_size <= 256; alphabet_size *= 4) {
+    std::string text;
+    for (int i = 0; i < 10000; ++i) {
+      seed = seed * 1103515245 + 12345;
+      text.push_back(static_cast<char>((seed >> 16) % alphabet_size));
+    }
+    ExpectSuffixArray(text);
+  }
+}
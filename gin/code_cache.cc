@@ -0,0 +1,92 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gin/code_cache.h"
+
+#include "base/containers/mru_cache.h"
+#include "base/lazy_instance.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/sha1.h"
+#include "base/synchronization/lock.h"
+#include "gin/converter.h"
+#include "gin/per_isolate_data.h"
+#include "gin/public/code_cache.h"
+
+namespace gin {
+
+namespace {
+
+// The default CodeCache, kept in memory. The scripts gin compiles are mostly
+// the same few modules, loaded by every isolate, so a small cache is enough.
+class MemoryCodeCache : public CodeCache {
+ public:
+  MemoryCodeCache() : cache_(kMaxEntries) {}
+
+  virtual bool Get(const std::string& key, std::string* data) OVERRIDE {
+    base::AutoLock locked(lock_);
+    Cache::iterator it = cache_.Get(key);
+    if (it == cache_.end())
+      return false;
+    *data = it->second;
+    return true;
+  }
+
+  virtual void Put(const std::string& key, const std::string& data) OVERRIDE {
+    base::AutoLock locked(lock_);
+    cache_.Put(key, data);
+  }
+
+ private:
+  typedef base::MRUCache<std::string, std::string> Cache;
+
+  static const size_t kMaxEntries = 64;
+
+  base::Lock lock_;
+  Cache cache_;
+};
+
+base::LazyInstance<MemoryCodeCache>::Leaky g_shared_code_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
+// Returns the preparse data for |source|, whose text is |source_utf8|,
+// preparsing it if |code_cache| doesn't have it yet. Returns NULL if |source|
+// can't be preparsed, in which case compiling it will report the error.
+v8::ScriptData* GetPreparseData(CodeCache* code_cache,
+                                const std::string& source_utf8,
+                                v8::Handle<v8::String> source) {
+  const std::string key = base::SHA1HashString(source_utf8);
+  std::string data;
+  if (code_cache->Get(key, &data))
+    return v8::ScriptData::New(data.data(), static_cast<int>(data.size()));
+
+  scoped_ptr<v8::ScriptData> preparse_data(v8::ScriptData::PreCompile(source));
+  if (!preparse_data || preparse_data->HasError())
+    return NULL;
+  code_cache->Put(
+      key, std::string(preparse_data->Data(), preparse_data->Length()));
+  return preparse_data.release();
+}
+
+}  // namespace
+
+// static
+CodeCache* CodeCache::GetSharedInstance() {
+  return g_shared_code_cache.Pointer();
+}
+
+v8::Handle<v8::Script> CompileScript(v8::Isolate* isolate,
+                                     const std::string& source,
+                                     const std::string& resource_name) {
+  v8::Handle<v8::String> v8_source = StringToV8(isolate, source);
+  v8::ScriptOrigin origin(StringToV8(isolate, resource_name));
+
+  scoped_ptr<v8::ScriptData> preparse_data;
+  CodeCache* code_cache = PerIsolateData::From(isolate)->code_cache();
+  if (code_cache)
+    preparse_data.reset(GetPreparseData(code_cache, source, v8_source));
+
+  return v8::Script::Compile(v8_source, &origin, preparse_data.get());
+}
+
+}  // namespace gin
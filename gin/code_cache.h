@@ -0,0 +1,28 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef GIN_CODE_CACHE_H_
+#define GIN_CODE_CACHE_H_
+
+#include <string>
+
+#include "gin/gin_export.h"
+#include "v8/include/v8.h"
+
+namespace gin {
+
+// Compiles |source|, named |resource_name|, in the current context. If the
+// isolate has a CodeCache, the preparse data V8 produces for |source| is
+// looked up in it first and stored in it after, so that only the first
+// isolate to compile a given script, typically one of the built-in modules,
+// pays for preparsing it. Returns an empty handle if |source| doesn't
+// compile, in which case the caller's TryCatch has the error.
+GIN_EXPORT v8::Handle<v8::Script> CompileScript(
+    v8::Isolate* isolate,
+    const std::string& source,
+    const std::string& resource_name);
+
+}  // namespace gin
+
+#endif  // GIN_CODE_CACHE_H_
@@ -0,0 +1,100 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gin/code_cache.h"
+
+#include <map>
+
+#include "base/compiler_specific.h"
+#include "gin/converter.h"
+#include "gin/public/code_cache.h"
+#include "gin/public/isolate_holder.h"
+#include "gin/shell_runner.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace gin {
+
+namespace {
+
+class CountingCodeCache : public CodeCache {
+ public:
+  CountingCodeCache() : hits_(0), misses_(0) {}
+
+  virtual bool Get(const std::string& key, std::string* data) OVERRIDE {
+    std::map<std::string, std::string>::const_iterator it = entries_.find(key);
+    if (it == entries_.end()) {
+      ++misses_;
+      return false;
+    }
+    ++hits_;
+    *data = it->second;
+    return true;
+  }
+
+  virtual void Put(const std::string& key, const std::string& data) OVERRIDE {
+    entries_[key] = data;
+  }
+
+  int hits() const { return hits_; }
+  int misses() const { return misses_; }
+  size_t size() const { return entries_.size(); }
+
+ private:
+  std::map<std::string, std::string> entries_;
+  int hits_;
+  int misses_;
+};
+
+// Runs |source| in a new isolate that uses |code_cache|, and returns the
+// value the script leaves in |result|.
+std::string RunInNewIsolate(CodeCache* code_cache, const std::string& source) {
+  IsolateHolder instance;
+  instance.SetCodeCache(code_cache);
+
+  ShellRunnerDelegate delegate;
+  v8::Isolate* isolate = instance.isolate();
+  ShellRunner runner(&delegate, isolate);
+  Runner::Scope scope(&runner);
+  runner.Run(source, "test_data.js");
+
+  std::string result;
+  Converter<std::string>::FromV8(
+      isolate, runner.global()->Get(StringToV8(isolate, "result")), &result);
+  return result;
+}
+
+const char kSource[] =
+    "function f() { return 'PASS'; }\n"
+    "this.result = f();\n";
+
+}  // namespace
+
+TEST(CodeCacheTest, SharedBetweenIsolates) {
+  CountingCodeCache code_cache;
+
+  EXPECT_EQ("PASS", RunInNewIsolate(&code_cache, kSource));
+  EXPECT_EQ(0, code_cache.hits());
+  EXPECT_EQ(1, code_cache.misses());
+  EXPECT_EQ(1u, code_cache.size());
+
+  // The second isolate compiles the script with the cached data.
+  EXPECT_EQ("PASS", RunInNewIsolate(&code_cache, kSource));
+  EXPECT_EQ(1, code_cache.hits());
+  EXPECT_EQ(1, code_cache.misses());
+}
+
+TEST(CodeCacheTest, KeyedBySource) {
+  CountingCodeCache code_cache;
+
+  EXPECT_EQ("PASS", RunInNewIsolate(&code_cache, kSource));
+  EXPECT_EQ("FAIL", RunInNewIsolate(&code_cache, "this.result = 'FAIL';\n"));
+  EXPECT_EQ(0, code_cache.hits());
+  EXPECT_EQ(2u, code_cache.size());
+}
+
+TEST(CodeCacheTest, Disabled) {
+  EXPECT_EQ("PASS", RunInNewIsolate(NULL, kSource));
+}
+
+}  // namespace gin
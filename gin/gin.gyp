@@ -26,6 +26,8 @@
         'arguments.h',
         'array_buffer.cc',
         'array_buffer.h',
+        'code_cache.cc',
+        'code_cache.h',
         'context_holder.cc',
         'converter.cc',
         'converter.h',
@@ -55,6 +57,7 @@
         'per_context_data.h',
         'per_isolate_data.cc',
         'per_isolate_data.h',
+        'public/code_cache.h',
         'public/context_holder.h',
         'public/gin_embedders.h',
         'public/isolate_holder.h',
@@ -118,6 +121,7 @@
         'gin_test',
       ],
       'sources': [
+        'code_cache_unittest.cc',
         'converter_unittest.cc',
         'interceptor_unittest.cc',
         'modules/module_registry_unittest.cc',
@@ -8,11 +8,14 @@
 #include <string.h>
 
 #include "base/logging.h"
+#include "base/metrics/histogram.h"
 #include "base/rand_util.h"
 #include "base/sys_info.h"
+#include "base/time/time.h"
 #include "gin/array_buffer.h"
 #include "gin/function_template.h"
 #include "gin/per_isolate_data.h"
+#include "gin/public/code_cache.h"
 
 namespace gin {
 
@@ -47,6 +50,7 @@ void EnsureV8Initialized(bool gin_managed) {
 
 IsolateHolder::IsolateHolder()
   : isolate_owner_(true) {
+  base::TimeTicks start = base::TimeTicks::Now();
   EnsureV8Initialized(true);
   isolate_ = v8::Isolate::New();
   v8::ResourceConstraints constraints;
@@ -54,6 +58,8 @@ IsolateHolder::IsolateHolder()
                                 base::SysInfo::NumberOfProcessors());
   v8::SetResourceConstraints(isolate_, &constraints);
   Init(ArrayBufferAllocator::SharedInstance());
+  UMA_HISTOGRAM_TIMES("Gin.IsolateCreationTime",
+                      base::TimeTicks::Now() - start);
 }
 
 IsolateHolder::IsolateHolder(v8::Isolate* isolate,
@@ -73,6 +79,11 @@ void IsolateHolder::Init(v8::ArrayBuffer::Allocator* allocator) {
   v8::Isolate::Scope isolate_scope(isolate_);
   v8::HandleScope handle_scope(isolate_);
   isolate_data_.reset(new PerIsolateData(isolate_, allocator));
+  isolate_data_->set_code_cache(CodeCache::GetSharedInstance());
+}
+
+void IsolateHolder::SetCodeCache(CodeCache* code_cache) {
+  isolate_data_->set_code_cache(code_cache);
 }
 
 }  // namespace gin
@@ -18,7 +18,7 @@ namespace gin {
 
 PerIsolateData::PerIsolateData(Isolate* isolate,
                                ArrayBuffer::Allocator* allocator)
-    : isolate_(isolate), allocator_(allocator) {
+    : isolate_(isolate), allocator_(allocator), code_cache_(NULL) {
   isolate_->SetData(kEmbedderNativeGin, this);
 }
 
@@ -14,6 +14,7 @@
 
 namespace gin {
 
+class CodeCache;
 class IndexedPropertyInterceptor;
 class NamedPropertyInterceptor;
 class WrappableBase;
@@ -61,6 +62,11 @@ class GIN_EXPORT PerIsolateData {
   v8::Isolate* isolate() { return isolate_; }
   v8::ArrayBuffer::Allocator* allocator() { return allocator_; }
 
+  // The cache CompileScript() uses, or NULL if scripts are compiled from
+  // scratch. Not owned.
+  CodeCache* code_cache() { return code_cache_; }
+  void set_code_cache(CodeCache* code_cache) { code_cache_ = code_cache; }
+
  private:
   typedef std::map<
       WrapperInfo*, v8::Eternal<v8::ObjectTemplate> > ObjectTemplateMap;
@@ -75,6 +81,7 @@ class GIN_EXPORT PerIsolateData {
   // owned by the IsolateHolder, which also owns the PerIsolateData.
   v8::Isolate* isolate_;
   v8::ArrayBuffer::Allocator* allocator_;
+  CodeCache* code_cache_;
   ObjectTemplateMap object_templates_;
   FunctionTemplateMap function_templates_;
   IndexedPropertyInterceptorMap indexed_interceptors_;
@@ -0,0 +1,34 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef GIN_PUBLIC_CODE_CACHE_H_
+#define GIN_PUBLIC_CODE_CACHE_H_
+
+#include <string>
+
+#include "gin/gin_export.h"
+
+namespace gin {
+
+// Stores the data V8 produces when it compiles a script, so that compiling
+// the same script again, in this isolate or another one, can skip that work.
+// Gin keys the data by a hash of the script source. Implementations are
+// shared between isolates, which may live on different threads, so they must
+// be thread-safe.
+class GIN_EXPORT CodeCache {
+ public:
+  virtual ~CodeCache() {}
+
+  // Returns true and fills |data| if there is data for |key|.
+  virtual bool Get(const std::string& key, std::string* data) = 0;
+  virtual void Put(const std::string& key, const std::string& data) = 0;
+
+  // Returns the in-memory cache that IsolateHolder uses unless told
+  // otherwise. It lives for the rest of the process.
+  static CodeCache* GetSharedInstance();
+};
+
+}  // namespace gin
+
+#endif  // GIN_PUBLIC_CODE_CACHE_H_
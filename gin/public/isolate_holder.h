@@ -12,6 +12,7 @@
 
 namespace gin {
 
+class CodeCache;
 class PerIsolateData;
 
 // To embed Gin, first create an instance of IsolateHolder to hold the
@@ -24,6 +25,10 @@ class PerIsolateData;
 // pass them to IsolateHolder.
 //
 // It is not possible to mix the two.
+//
+// Scripts that gin compiles in the isolate share the preparse data V8
+// produces for them with other isolates through a CodeCache, by default
+// CodeCache::GetSharedInstance().
 class GIN_EXPORT IsolateHolder {
  public:
   IsolateHolder();
@@ -33,6 +38,10 @@ class GIN_EXPORT IsolateHolder {
 
   v8::Isolate* isolate() { return isolate_; }
 
+  // Replaces the CodeCache of the isolate. |code_cache| is not owned and must
+  // outlive the isolate. NULL turns the cache off.
+  void SetCodeCache(CodeCache* code_cache);
+
  private:
   void Init(v8::ArrayBuffer::Allocator* allocator);
 
@@ -4,6 +4,7 @@
 
 #include "gin/shell_runner.h"
 
+#include "gin/code_cache.h"
 #include "gin/converter.h"
 #include "gin/modules/module_registry.h"
 #include "gin/per_context_data.h"
@@ -67,8 +68,7 @@ void ShellRunner::Run(const std::string& source,
                       const std::string& resource_name) {
   TryCatch try_catch;
   v8::Isolate* isolate = GetContextHolder()->isolate();
-  v8::Handle<Script> script = Script::Compile(
-      StringToV8(isolate, source), StringToV8(isolate, resource_name));
+  v8::Handle<Script> script = CompileScript(isolate, source, resource_name);
   if (try_catch.HasCaught()) {
     delegate_->UnhandledException(this, try_catch);
     return;
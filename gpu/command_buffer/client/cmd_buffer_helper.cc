@@ -22,8 +22,12 @@ CommandBufferHelper::CommandBufferHelper(CommandBuffer* command_buffer)
       token_(0),
       put_(0),
       last_put_sent_(0),
-#if defined(CMD_HELPER_PERIODIC_FLUSH_CHECK)
       commands_issued_(0),
+      entries_flushed_(0),
+      deferred_periodic_flush_count_(0),
+#if defined(CMD_HELPER_PERIODIC_FLUSH_CHECK)
+      last_flush_get_offset_(0),
+      consumed_entries_per_second_(0),
 #endif
       usable_(true),
       context_lost_(false),
@@ -160,7 +164,12 @@ void CommandBufferHelper::Flush() {
     put_ = 0;
 
   if (usable() && last_put_sent_ != put_) {
-    last_flush_time_ = clock();
+    clock_t current_time = clock();
+#if defined(CMD_HELPER_PERIODIC_FLUSH_CHECK)
+    UpdateConsumptionRate(current_time);
+#endif
+    entries_flushed_ += PendingEntries();
+    last_flush_time_ = current_time;
     last_put_sent_ = put_;
     command_buffer_->Flush(put_);
     ++flush_generation_;
@@ -168,11 +177,48 @@ void CommandBufferHelper::Flush() {
   }
 }
 
+int32 CommandBufferHelper::PendingEntries() const {
+  if (!total_entry_count_)
+    return 0;
+  return (put_ + total_entry_count_ - last_put_sent_) % total_entry_count_;
+}
+
 #if defined(CMD_HELPER_PERIODIC_FLUSH_CHECK)
 void CommandBufferHelper::PeriodicFlushCheck() {
   clock_t current_time = clock();
-  if (current_time - last_flush_time_ > kPeriodicFlushDelay * CLOCKS_PER_SEC)
-    Flush();
+  clock_t elapsed = current_time - last_flush_time_;
+  if (elapsed <= kPeriodicFlushDelay * CLOCKS_PER_SEC)
+    return;
+
+  // Flushing to a service that is still busy with earlier commands just
+  // extends its work, but flushing to an idle one wakes it up. Don't do that
+  // for less work than it gets through in one period, unless the commands
+  // have been waiting for too long.
+  bool service_idle = get_offset() == last_put_sent_;
+  if (service_idle &&
+      PendingEntries() < consumed_entries_per_second_ * kPeriodicFlushDelay &&
+      elapsed <= kMaxPeriodicFlushDelay * CLOCKS_PER_SEC) {
+    ++deferred_periodic_flush_count_;
+    return;
+  }
+  Flush();
+}
+
+void CommandBufferHelper::UpdateConsumptionRate(clock_t current_time) {
+  int32 get = get_offset();
+  // A service that has caught up was idle for part of the interval, so only
+  // measure one that is still busy.
+  if (get != last_put_sent_ && current_time > last_flush_time_) {
+    int32 consumed = (get + total_entry_count_ - last_flush_get_offset_) %
+                     total_entry_count_;
+    float rate = consumed * static_cast<float>(CLOCKS_PER_SEC) /
+                 (current_time - last_flush_time_);
+    consumed_entries_per_second_ =
+        consumed_entries_per_second_ > 0
+            ? (consumed_entries_per_second_ + rate) / 2
+            : rate;
+  }
+  last_flush_get_offset_ = get;
 }
 #endif
 
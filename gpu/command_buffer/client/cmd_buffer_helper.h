@@ -21,6 +21,10 @@ namespace gpu {
 #define CMD_HELPER_PERIODIC_FLUSH_CHECK
 const int kCommandsPerFlushCheck = 100;
 const float kPeriodicFlushDelay = 1.0f / (5.0f * 60.0f);
+// Periodic flushes that would wake an idle service with less work than it
+// gets through in kPeriodicFlushDelay are deferred, but never for longer
+// than this.
+const float kMaxPeriodicFlushDelay = 4.0f * kPeriodicFlushDelay;
 #endif
 
 const int kAutoFlushSmall = 16;  // 1/16 of the buffer
@@ -94,12 +98,12 @@ class GPU_EXPORT CommandBufferHelper {
   // Called prior to each command being issued. Waits for a certain amount of
   // space to be available. Returns address of space.
   CommandBufferEntry* GetSpace(int32 entries) {
+    ++commands_issued_;
 #if defined(CMD_HELPER_PERIODIC_FLUSH_CHECK)
     // Allow this command buffer to be pre-empted by another if a "reasonable"
     // amount of work has been done. On highend machines, this reduces the
     // latency of GPU commands. However, on Android, this can cause the
     // kernel to thrash between generating GPU commands and executing them.
-    ++commands_issued_;
     if (flush_automatically_ &&
         (commands_issued_ % kCommandsPerFlushCheck == 0)) {
       PeriodicFlushCheck();
@@ -248,6 +252,14 @@ class GPU_EXPORT CommandBufferHelper {
 
   uint32 flush_generation() const { return flush_generation_; }
 
+  // Counters for this context, to tell how well commands are batched into
+  // flushes. The number of flushes is flush_generation().
+  uint32 commands_issued() const { return commands_issued_; }
+  uint32 entries_flushed() const { return entries_flushed_; }
+  uint32 deferred_periodic_flush_count() const {
+    return deferred_periodic_flush_count_;
+  }
+
   void FreeRingBuffer();
 
   bool HaveRingBuffer() const {
@@ -277,9 +289,16 @@ class GPU_EXPORT CommandBufferHelper {
   // false if there was an error.
   bool WaitForGetOffsetInRange(int32 start, int32 end);
 
+  // Returns the number of entries added since the last flush.
+  int32 PendingEntries() const;
+
 #if defined(CMD_HELPER_PERIODIC_FLUSH_CHECK)
   // Calls Flush if automatic flush conditions are met.
   void PeriodicFlushCheck();
+
+  // Updates the estimate of how fast the service consumes commands from how
+  // far it got since the last flush.
+  void UpdateConsumptionRate(clock_t current_time);
 #endif
 
   CommandBuffer* command_buffer_;
@@ -293,8 +312,15 @@ class GPU_EXPORT CommandBufferHelper {
   int32 put_;
   int32 last_put_sent_;
 
+  uint32 commands_issued_;
+  uint32 entries_flushed_;
+  uint32 deferred_periodic_flush_count_;
+
 #if defined(CMD_HELPER_PERIODIC_FLUSH_CHECK)
-  int commands_issued_;
+  // The service's get offset as of the last flush, and the number of entries
+  // per second it was measured to consume while busy, or 0 if unknown.
+  int32 last_flush_get_offset_;
+  float consumed_entries_per_second_;
 #endif
 
   bool usable_;
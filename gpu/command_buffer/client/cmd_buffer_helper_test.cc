@@ -662,4 +662,37 @@ TEST_F(CommandBufferHelperTest, TestFlushGeneration) {
   EXPECT_EQ(error::kNoError, GetError());
 }
 
+// Checks the helper's command and flush counters.
+TEST_F(CommandBufferHelperTest, TestFlushCounters) {
+  // Explicit flushing only.
+  helper_->SetAutomaticFlushes(false);
+
+  uint32 commands_issued = helper_->commands_issued();
+  uint32 entries_flushed = helper_->entries_flushed();
+  uint32 flush_generation = GetHelperFlushGeneration();
+
+  // Two commands of 2 and 3 entries, arguments included.
+  AddUniqueCommandWithExpect(error::kNoError, 2);
+  AddUniqueCommandWithExpect(error::kNoError, 3);
+  EXPECT_EQ(commands_issued + 2, helper_->commands_issued());
+  EXPECT_EQ(entries_flushed, helper_->entries_flushed());
+
+  helper_->Flush();
+  EXPECT_EQ(entries_flushed + 5, helper_->entries_flushed());
+  EXPECT_EQ(flush_generation + 1, GetHelperFlushGeneration());
+
+  // Flushing without new commands doesn't count.
+  helper_->Flush();
+  EXPECT_EQ(entries_flushed + 5, helper_->entries_flushed());
+  EXPECT_EQ(flush_generation + 1, GetHelperFlushGeneration());
+
+  helper_->Finish();
+
+  // Check that the commands did happen.
+  Mock::VerifyAndClearExpectations(api_mock_.get());
+
+  // Check the error status.
+  EXPECT_EQ(error::kNoError, GetError());
+}
+
 }  // namespace gpu
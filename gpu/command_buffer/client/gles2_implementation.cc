@@ -1407,6 +1407,20 @@ void GLES2Implementation::BufferDataHelper(
     return;
   }
 
+  // Too large for the transfer buffer. Rather than copying it in pieces,
+  // each of which may have to wait for the service to drain the ring, try to
+  // send it all at once from mapped memory, which is freed by token.
+  buffer.Release();
+  int32 shm_id = 0;
+  unsigned int shm_offset = 0;
+  void* mem = mapped_memory_->Alloc(size, &shm_id, &shm_offset);
+  if (mem) {
+    memcpy(mem, data, size);
+    helper_->BufferData(target, size, shm_id, shm_offset, usage);
+    mapped_memory_->FreePendingToken(mem, helper_->InsertToken());
+    return;
+  }
+
   // Make the buffer with BufferData then send via BufferSubData
   helper_->BufferData(target, size, 0, 0, usage);
   BufferSubDataHelperImpl(target, 0, size, data, &buffer);
@@ -1756,7 +1770,24 @@ void GLES2Implementation::TexImage2D(
     return;
   }
 
-  // No, so send it using TexSubImage2D.
+  // No, so try to send it all at once from mapped memory.
+  buffer.Release();
+  int32 shm_id = 0;
+  unsigned int shm_offset = 0;
+  void* mem = mapped_memory_->Alloc(size, &shm_id, &shm_offset);
+  if (mem) {
+    CopyRectToBuffer(
+        pixels, height, unpadded_row_size, src_padded_row_size, unpack_flip_y_,
+        mem, padded_row_size);
+    helper_->TexImage2D(
+        target, level, internalformat, width, height, border, format, type,
+        shm_id, shm_offset);
+    mapped_memory_->FreePendingToken(mem, helper_->InsertToken());
+    CheckGLError();
+    return;
+  }
+
+  // Otherwise send it using TexSubImage2D.
   helper_->TexImage2D(
      target, level, internalformat, width, height, border, format, type,
      0, 0);
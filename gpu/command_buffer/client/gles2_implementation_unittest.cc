@@ -2298,14 +2298,12 @@ TEST_F(GLES2ImplementationTest, TexImage2D) {
       pixels, mem2.ptr));
 }
 
-// Test TexImage2D with 2 writes
-TEST_F(GLES2ImplementationTest, TexImage2D2Writes) {
+// Test TexImage2D with more data than fits in the transfer buffer.
+TEST_F(GLES2ImplementationTest, TexImage2DLargerThanTransferBuffer) {
   struct Cmds {
+    cmd::SetToken release_token;
     cmds::TexImage2D tex_image_2d;
-    cmds::TexSubImage2D tex_sub_image_2d1;
-    cmd::SetToken set_token1;
-    cmds::TexSubImage2D tex_sub_image_2d2;
-    cmd::SetToken set_token2;
+    cmd::SetToken set_token;
   };
   const GLenum kTarget = GL_TEXTURE_2D;
   const GLint kLevel = 0;
@@ -2325,80 +2323,33 @@ TEST_F(GLES2ImplementationTest, TexImage2D2Writes) {
   ASSERT_TRUE(GLES2Util::ComputeImageDataSizes(
       kWidth, kHeight, kFormat, kType, kPixelStoreUnpackAlignment,
       &size, NULL, NULL));
-  uint32 half_size = 0;
-  ASSERT_TRUE(GLES2Util::ComputeImageDataSizes(
-      kWidth, kHeight / 2, kFormat, kType, kPixelStoreUnpackAlignment,
-      &half_size, NULL, NULL));
 
   scoped_ptr<uint8[]> pixels(new uint8[size]);
   for (uint32 ii = 0; ii < size; ++ii) {
     pixels[ii] = static_cast<uint8>(ii);
   }
 
-  ExpectedMemoryInfo mem1 = GetExpectedMemory(half_size);
-  ExpectedMemoryInfo mem2 = GetExpectedMemory(half_size);
+  // The transfer buffer is tried first, and released unused.
+  GetExpectedMemory(MaxTransferBufferSize());
 
+  // The pixels are sent in one piece from mapped memory instead.
+  const int32 shm_id = command_buffer()->GetNextFreeTransferBufferId();
   Cmds expected;
+  expected.release_token.Init(GetNextToken());
   expected.tex_image_2d.Init(
       kTarget, kLevel, kFormat, kWidth, kHeight, kBorder, kFormat, kType,
-      0, 0);
-  expected.tex_sub_image_2d1.Init(
-      kTarget, kLevel, 0, 0, kWidth, kHeight / 2, kFormat, kType,
-      mem1.id, mem1.offset, true);
-  expected.set_token1.Init(GetNextToken());
-  expected.tex_sub_image_2d2.Init(
-      kTarget, kLevel, 0, kHeight / 2, kWidth, kHeight / 2, kFormat, kType,
-      mem2.id, mem2.offset, true);
-  expected.set_token2.Init(GetNextToken());
-
-  // TODO(gman): Make it possible to run this test
-  // EXPECT_CALL(*command_buffer(), OnFlush())
-  //     .WillOnce(CheckRectAction(
-  //         kWidth, kHeight / 2, kFormat, kType, kPixelStoreUnpackAlignment,
-  //         false, pixels.get(),
-  //         GetExpectedTransferAddressFromOffsetAs<uint8>(offset1, half_size)))
-  //     .RetiresOnSaturation();
+      shm_id, 0);
+  expected.set_token.Init(GetNextToken());
 
   gl_->TexImage2D(
       kTarget, kLevel, kFormat, kWidth, kHeight, kBorder, kFormat, kType,
       pixels.get());
   EXPECT_EQ(0, memcmp(&expected, commands_, sizeof(expected)));
   EXPECT_TRUE(CheckRect(
-      kWidth, kHeight / 2, kFormat, kType, kPixelStoreUnpackAlignment, false,
-      pixels.get() + kHeight / 2 * padded_row_size, mem2.ptr));
-
-  ClearCommands();
-  gl_->PixelStorei(GL_UNPACK_FLIP_Y_CHROMIUM, GL_TRUE);
-  const void* commands2 = GetPut();
-  ExpectedMemoryInfo mem3 = GetExpectedMemory(half_size);
-  ExpectedMemoryInfo mem4 = GetExpectedMemory(half_size);
-  expected.tex_image_2d.Init(
-      kTarget, kLevel, kFormat, kWidth, kHeight, kBorder, kFormat, kType,
-      0, 0);
-  expected.tex_sub_image_2d1.Init(
-      kTarget, kLevel, 0, kHeight / 2, kWidth, kHeight / 2, kFormat, kType,
-      mem3.id, mem3.offset, true);
-  expected.set_token1.Init(GetNextToken());
-  expected.tex_sub_image_2d2.Init(
-      kTarget, kLevel, 0, 0, kWidth, kHeight / 2, kFormat, kType,
-      mem4.id, mem4.offset, true);
-  expected.set_token2.Init(GetNextToken());
-
-  // TODO(gman): Make it possible to run this test
-  // EXPECT_CALL(*command_buffer(), OnFlush())
-  //     .WillOnce(CheckRectAction(
-  //         kWidth, kHeight / 2, kFormat, kType, kPixelStoreUnpackAlignment,
-  //         true, pixels.get(),
-  //         GetExpectedTransferAddressFromOffsetAs<uint8>(offset3, half_size)))
-  //     .RetiresOnSaturation();
-
-  gl_->TexImage2D(
-      kTarget, kLevel, kFormat, kWidth, kHeight, kBorder, kFormat, kType,
-      pixels.get());
-  EXPECT_EQ(0, memcmp(&expected, commands2, sizeof(expected)));
-  EXPECT_TRUE(CheckRect(
-      kWidth, kHeight / 2, kFormat, kType, kPixelStoreUnpackAlignment, true,
-      pixels.get() + kHeight / 2 * padded_row_size, mem4.ptr));
+      kWidth, kHeight, kFormat, kType, kPixelStoreUnpackAlignment, false,
+      pixels.get(),
+      static_cast<uint8*>(
+          command_buffer()->GetTransferBuffer(shm_id)->memory())));
 }
 
 // Test TexSubImage2D with GL_PACK_FLIP_Y set and partial multirow transfers
@@ -2763,30 +2714,31 @@ TEST_F(GLES2ImplementationTest, CreateProgram) {
 
 TEST_F(GLES2ImplementationTest, BufferDataLargerThanTransferBuffer) {
   struct Cmds {
-    cmds::BufferData set_size;
-    cmds::BufferSubData copy_data1;
-    cmd::SetToken set_token1;
-    cmds::BufferSubData copy_data2;
-    cmd::SetToken set_token2;
+    cmd::SetToken release_token;
+    cmds::BufferData set_data;
+    cmd::SetToken set_token;
   };
   const unsigned kUsableSize =
       kTransferBufferSize - GLES2Implementation::kStartingOffset;
   uint8 buf[kUsableSize * 2] = { 0, };
+  for (size_t ii = 0; ii < arraysize(buf); ++ii)
+    buf[ii] = static_cast<uint8>(ii);
 
-  ExpectedMemoryInfo mem1 = GetExpectedMemory(kUsableSize);
-  ExpectedMemoryInfo mem2 = GetExpectedMemory(kUsableSize);
+  // The transfer buffer is tried first, and released unused.
+  GetExpectedMemory(kUsableSize);
 
+  // The data is sent in one piece from mapped memory instead.
+  const int32 shm_id = command_buffer()->GetNextFreeTransferBufferId();
   Cmds expected;
-  expected.set_size.Init(
-      GL_ARRAY_BUFFER, arraysize(buf), 0, 0, GL_DYNAMIC_DRAW);
-  expected.copy_data1.Init(
-      GL_ARRAY_BUFFER, 0, kUsableSize, mem1.id, mem1.offset);
-  expected.set_token1.Init(GetNextToken());
-  expected.copy_data2.Init(
-      GL_ARRAY_BUFFER, kUsableSize, kUsableSize, mem2.id, mem2.offset);
-  expected.set_token2.Init(GetNextToken());
+  expected.release_token.Init(GetNextToken());
+  expected.set_data.Init(
+      GL_ARRAY_BUFFER, arraysize(buf), shm_id, 0, GL_DYNAMIC_DRAW);
+  expected.set_token.Init(GetNextToken());
   gl_->BufferData(GL_ARRAY_BUFFER, arraysize(buf), buf, GL_DYNAMIC_DRAW);
   EXPECT_EQ(0, memcmp(&expected, commands_, sizeof(expected)));
+  EXPECT_EQ(0, memcmp(buf,
+                      command_buffer()->GetTransferBuffer(shm_id)->memory(),
+                      arraysize(buf)));
 }
 
 TEST_F(GLES2ImplementationTest, CapabilitiesAreCached) {
@@ -4,11 +4,15 @@
 
 #include "gpu/command_buffer/service/async_pixel_transfer_manager_idle.h"
 
+#include <algorithm>
+#include <set>
+
 #include "base/bind.h"
 #include "base/debug/trace_event.h"
 #include "base/debug/trace_event_synthetic_delay.h"
 #include "base/lazy_instance.h"
 #include "base/memory/weak_ptr.h"
+#include "gpu/command_buffer/common/gles2_cmd_utils.h"
 #include "gpu/command_buffer/service/safe_shared_memory_pool.h"
 #include "ui/gl/scoped_binders.h"
 
@@ -25,6 +29,11 @@ SafeSharedMemoryPool* safe_shared_memory_pool() {
 
 static uint64 g_next_pixel_transfer_state_id = 1;
 
+// Sub image uploads larger than this are split into bands of rows, one per
+// task, so that a single call to ProcessMorePendingTransfers() never blocks
+// the GPU thread with a large upload.
+const uint32 kMaxBytesPerTask = 256 * 1024;
+
 void PerformNotifyCompletion(
     AsyncMemoryParams mem_params,
     ScopedSafeSharedMemory* safe_shared_memory,
@@ -69,6 +78,7 @@ class AsyncPixelTransferDelegateIdle
   void PerformAsyncTexSubImage2D(
       AsyncTexSubImage2DParams tex_params,
       AsyncMemoryParams mem_params,
+      bool completes_transfer,
       ScopedSafeSharedMemory* safe_shared_memory);
 
   uint64 id_;
@@ -129,16 +139,53 @@ void AsyncPixelTransferDelegateIdle::AsyncTexSubImage2D(
   DCHECK_LE(mem_params.shm_data_offset + mem_params.shm_data_size,
             mem_params.shm_size);
 
-  shared_state_->tasks.push_back(AsyncPixelTransferManagerIdle::Task(
-      id_,
-      base::Bind(
-          &AsyncPixelTransferDelegateIdle::PerformAsyncTexSubImage2D,
-          AsWeakPtr(),
-          tex_params,
-          mem_params,
-          base::Owned(new ScopedSafeSharedMemory(safe_shared_memory_pool(),
-                                                 mem_params.shared_memory,
-                                                 mem_params.shm_size)))));
+  // Rows are padded to the unpack alignment, except for the last one.
+  uint32 size = 0;
+  uint32 unpadded_row_size = 0;
+  uint32 padded_row_size = 0;
+  GLsizei band_height = tex_params.height;
+  if (mem_params.shm_data_size > kMaxBytesPerTask &&
+      tex_params.height > 1 &&
+      gles2::GLES2Util::ComputeImageDataSizes(tex_params.width,
+                                              1,
+                                              tex_params.format,
+                                              tex_params.type,
+                                              1,
+                                              &size,
+                                              &unpadded_row_size,
+                                              &padded_row_size)) {
+    padded_row_size = (mem_params.shm_data_size - unpadded_row_size) /
+                      (tex_params.height - 1);
+    if (padded_row_size >= unpadded_row_size && padded_row_size > 0)
+      band_height = std::max(kMaxBytesPerTask / padded_row_size, 1u);
+  }
+
+  bool split = band_height < tex_params.height;
+  for (GLsizei y = 0; y < tex_params.height; y += band_height) {
+    AsyncTexSubImage2DParams band_tex_params = tex_params;
+    AsyncMemoryParams band_mem_params = mem_params;
+    if (split) {
+      band_tex_params.yoffset += y;
+      band_tex_params.height = std::min(band_height, tex_params.height - y);
+      band_mem_params.shm_data_offset += y * padded_row_size;
+      band_mem_params.shm_data_size =
+          (band_tex_params.height - 1) * padded_row_size + unpadded_row_size;
+    }
+    bool completes_transfer = y + band_height >= tex_params.height;
+
+    shared_state_->tasks.push_back(AsyncPixelTransferManagerIdle::Task(
+        id_,
+        base::Bind(
+            &AsyncPixelTransferDelegateIdle::PerformAsyncTexSubImage2D,
+            AsWeakPtr(),
+            band_tex_params,
+            band_mem_params,
+            completes_transfer,
+            base::Owned(new ScopedSafeSharedMemory(safe_shared_memory_pool(),
+                                                   mem_params.shared_memory,
+                                                   mem_params.shm_size))),
+        split));
+  }
 
   transfer_in_progress_ = true;
 }
@@ -148,16 +195,17 @@ bool  AsyncPixelTransferDelegateIdle::TransferIsInProgress() {
 }
 
 void AsyncPixelTransferDelegateIdle::WaitForTransferCompletion() {
-  for (std::list<AsyncPixelTransferManagerIdle::Task>::iterator iter =
-           shared_state_->tasks.begin();
-       iter != shared_state_->tasks.end();
-       ++iter) {
-    if (iter->transfer_id != id_)
+  // A split transfer has a task for each of its bands.
+  std::list<AsyncPixelTransferManagerIdle::Task>::iterator iter =
+      shared_state_->tasks.begin();
+  while (iter != shared_state_->tasks.end()) {
+    if (iter->transfer_id != id_) {
+      ++iter;
       continue;
+    }
 
     (*iter).task.Run();
-    shared_state_->tasks.erase(iter);
-    break;
+    iter = shared_state_->tasks.erase(iter);
   }
 
   shared_state_->ProcessNotificationTasks();
@@ -204,6 +252,7 @@ void AsyncPixelTransferDelegateIdle::PerformAsyncTexImage2D(
 void AsyncPixelTransferDelegateIdle::PerformAsyncTexSubImage2D(
     AsyncTexSubImage2DParams tex_params,
     AsyncMemoryParams mem_params,
+    bool completes_transfer,
     ScopedSafeSharedMemory* safe_shared_memory) {
   TRACE_EVENT2("gpu", "PerformAsyncTexSubImage2D",
                "width", tex_params.width,
@@ -247,23 +296,35 @@ void AsyncPixelTransferDelegateIdle::PerformAsyncTexSubImage2D(
         data);
   }
 
+  shared_state_->total_texture_upload_time +=
+      base::TimeTicks::HighResNow() - begin_time;
+  if (!completes_transfer)
+    return;
+
   TRACE_EVENT_SYNTHETIC_DELAY_END("gpu.AsyncTexImage");
   transfer_in_progress_ = false;
   shared_state_->texture_upload_count++;
-  shared_state_->total_texture_upload_time +=
-      base::TimeTicks::HighResNow() - begin_time;
 }
 
 AsyncPixelTransferManagerIdle::Task::Task(
     uint64 transfer_id, const base::Closure& task)
     : transfer_id(transfer_id),
-      task(task) {
+      task(task),
+      split(false) {
+}
+
+AsyncPixelTransferManagerIdle::Task::Task(
+    uint64 transfer_id, const base::Closure& task, bool split)
+    : transfer_id(transfer_id),
+      task(task),
+      split(split) {
 }
 
 AsyncPixelTransferManagerIdle::Task::~Task() {}
 
 AsyncPixelTransferManagerIdle::SharedState::SharedState()
-    : texture_upload_count(0) {}
+    : texture_upload_count(0),
+      processed_split_task(false) {}
 
 AsyncPixelTransferManagerIdle::SharedState::~SharedState() {}
 
@@ -321,12 +382,38 @@ void AsyncPixelTransferManagerIdle::ProcessMorePendingTransfers() {
 
   // First task should always be a pixel transfer task.
   DCHECK(shared_state_.tasks.front().transfer_id);
-  shared_state_.tasks.front().task.Run();
-  shared_state_.tasks.pop_front();
+
+  // Alternate the bands of a split transfer with the unsplit transfers queued
+  // after it, so that those don't wait for all of it.
+  std::list<Task>::iterator task = shared_state_.tasks.begin();
+  if (task->split && shared_state_.processed_split_task) {
+    std::list<Task>::iterator unsplit_task = FindUnsplitTransferTask();
+    if (unsplit_task != shared_state_.tasks.end())
+      task = unsplit_task;
+  }
+  shared_state_.processed_split_task = task->split;
+
+  task->task.Run();
+  shared_state_.tasks.erase(task);
 
   shared_state_.ProcessNotificationTasks();
 }
 
+std::list<AsyncPixelTransferManagerIdle::Task>::iterator
+AsyncPixelTransferManagerIdle::FindUnsplitTransferTask() {
+  std::set<uint64> seen_transfer_ids;
+  for (std::list<Task>::iterator it = shared_state_.tasks.begin();
+       it != shared_state_.tasks.end();
+       ++it) {
+    if (!it->transfer_id)
+      continue;
+    if (!it->split && !seen_transfer_ids.count(it->transfer_id))
+      return it;
+    seen_transfer_ids.insert(it->transfer_id);
+  }
+  return shared_state_.tasks.end();
+}
+
 bool AsyncPixelTransferManagerIdle::NeedsProcessMorePendingTransfers() {
   return !shared_state_.tasks.empty();
 }
@@ -28,12 +28,17 @@ class AsyncPixelTransferManagerIdle : public AsyncPixelTransferManager {
 
   struct Task {
     Task(uint64 transfer_id, const base::Closure& task);
+    Task(uint64 transfer_id, const base::Closure& task, bool split);
     ~Task();
 
     // This is non-zero if pixel transfer task.
     uint64 transfer_id;
 
     base::Closure task;
+
+    // True if the task uploads one band of rows of a transfer that was
+    // split into several tasks.
+    bool split;
   };
 
   // State shared between Managers and Delegates.
@@ -45,6 +50,10 @@ class AsyncPixelTransferManagerIdle : public AsyncPixelTransferManager {
     int texture_upload_count;
     base::TimeDelta total_texture_upload_time;
     std::list<Task> tasks;
+
+    // True if the last pixel transfer task processed was part of a split
+    // transfer.
+    bool processed_split_task;
   };
 
  private:
@@ -53,6 +62,10 @@ class AsyncPixelTransferManagerIdle : public AsyncPixelTransferManager {
       gles2::TextureRef* ref,
       const AsyncTexImage2DParams& define_params) OVERRIDE;
 
+  // Returns the first task of a transfer that wasn't split, if no earlier
+  // task belongs to the same transfer, or tasks.end().
+  std::list<Task>::iterator FindUnsplitTransferTask();
+
   SharedState shared_state_;
 
   DISALLOW_COPY_AND_ASSIGN(AsyncPixelTransferManagerIdle);
@@ -6,12 +6,21 @@
 
 #include <string>
 #include "base/memory/scoped_ptr.h"
+#include "base/metrics/histogram.h"
 #include "gpu/command_buffer/service/shader_manager.h"
 
 namespace gpu {
 namespace gles2 {
 
-ProgramCache::ProgramCache() {}
+namespace {
+
+// The number of links after startup whose cache hits are reported, which is
+// when a miss delays the first frames.
+const int kStartupLinkCount = 20;
+
+}  // namespace
+
+ProgramCache::ProgramCache() : link_hit_count_(0), link_miss_count_(0) {}
 ProgramCache::~ProgramCache() {}
 
 void ProgramCache::Clear() {
@@ -19,6 +28,22 @@ void ProgramCache::Clear() {
   link_status_.clear();
 }
 
+void ProgramCache::RecordLink(bool cache_hit) {
+  if (link_hit_count_ + link_miss_count_ < kStartupLinkCount) {
+    UMA_HISTOGRAM_BOOLEAN("GPU.ProgramCache.StartupLinkCacheHit", cache_hit);
+  } else if (link_hit_count_ + link_miss_count_ == kStartupLinkCount) {
+    UMA_HISTOGRAM_CUSTOM_COUNTS("GPU.ProgramCache.StartupLinkCacheHits",
+                                link_hit_count_,
+                                0,
+                                kStartupLinkCount,
+                                kStartupLinkCount + 1);
+  }
+  if (cache_hit)
+    ++link_hit_count_;
+  else
+    ++link_miss_count_;
+}
+
 ProgramCache::LinkedProgramStatus ProgramCache::GetLinkedProgramStatus(
     const std::string& untranslated_a,
     const ShaderTranslatorInterface* translator_a,
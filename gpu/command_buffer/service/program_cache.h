@@ -74,6 +74,14 @@ class GPU_EXPORT ProgramCache {
   // clears the cache
   void Clear();
 
+  // Records whether a link could be served from the cache.
+  void RecordLink(bool cache_hit);
+
+  // The number of links served from the cache, and the number that weren't,
+  // since the cache was created.
+  int link_hit_count() const { return link_hit_count_; }
+  int link_miss_count() const { return link_miss_count_; }
+
   // Only for testing
   void LinkedProgramCacheSuccess(const std::string& shader_a,
                                  const ShaderTranslatorInterface* translator_a,
@@ -109,6 +117,9 @@ class GPU_EXPORT ProgramCache {
 
   LinkStatusMap link_status_;
 
+  int link_hit_count_;
+  int link_miss_count_;
+
   DISALLOW_COPY_AND_ASSIGN(ProgramCache);
 };
 
@@ -197,5 +197,15 @@ TEST_F(ProgramCacheTest, StatusClear) {
             cache_->GetLinkedProgramStatus(shader1, NULL, shader3, NULL, NULL));
 }
 
+TEST_F(ProgramCacheTest, LinkCounts) {
+  EXPECT_EQ(0, cache_->link_hit_count());
+  EXPECT_EQ(0, cache_->link_miss_count());
+  cache_->RecordLink(false);
+  cache_->RecordLink(true);
+  cache_->RecordLink(true);
+  EXPECT_EQ(2, cache_->link_hit_count());
+  EXPECT_EQ(1, cache_->link_miss_count());
+}
+
 }  // namespace gles2
 }  // namespace gpu
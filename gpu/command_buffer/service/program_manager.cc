@@ -644,6 +644,7 @@ bool Program::Link(ShaderManager* manager,
       link = success != ProgramCache::PROGRAM_LOAD_SUCCESS;
       UMA_HISTOGRAM_BOOLEAN("GPU.ProgramCache.LoadBinarySuccess", !link);
     }
+    cache->RecordLink(!link);
   }
 
   if (link) {
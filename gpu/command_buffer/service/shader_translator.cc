@@ -10,6 +10,7 @@
 #include "base/at_exit.h"
 #include "base/debug/trace_event.h"
 #include "base/logging.h"
+#include "base/sha1.h"
 #include "base/strings/string_number_conversions.h"
 
 namespace {
@@ -18,6 +19,17 @@ using gpu::gles2::ShaderTranslator;
 
 bool g_translator_initialized = false;
 
+// The number of translations each translator keeps.
+const size_t kMaxCachedTranslations = 64;
+
+scoped_ptr<char[]> CopyToArray(const std::string& str) {
+  if (str.empty())
+    return scoped_ptr<char[]>();
+  scoped_ptr<char[]> array(new char[str.size() + 1]);
+  memcpy(array.get(), str.c_str(), str.size() + 1);
+  return array.Pass();
+}
+
 void FinalizeShaderTranslator(void* /* dummy */) {
   TRACE_EVENT0("gpu", "ShFinalize");
   ShFinalize();
@@ -117,10 +129,17 @@ ShaderTranslator::DestructionObserver::DestructionObserver() {
 ShaderTranslator::DestructionObserver::~DestructionObserver() {
 }
 
+ShaderTranslator::Translation::Translation() {
+}
+
+ShaderTranslator::Translation::~Translation() {
+}
+
 ShaderTranslator::ShaderTranslator()
     : compiler_(NULL),
       implementation_is_glsl_es_(false),
-      driver_bug_workarounds_(static_cast<ShCompileOptions>(0)) {
+      driver_bug_workarounds_(static_cast<ShCompileOptions>(0)),
+      translation_cache_(kMaxCachedTranslations) {
 }
 
 bool ShaderTranslator::Init(
@@ -169,6 +188,21 @@ bool ShaderTranslator::Translate(const char* shader) {
   DCHECK(shader != NULL);
   ClearResults();
 
+  // The options are fixed at Init(), so the source alone identifies the
+  // translation.
+  std::string source_hash = base::SHA1HashString(shader);
+  TranslationCache::iterator it = translation_cache_.Get(source_hash);
+  if (it != translation_cache_.end()) {
+    const Translation& translation = it->second;
+    translated_shader_ = CopyToArray(translation.translated_shader);
+    info_log_ = CopyToArray(translation.info_log);
+    attrib_map_ = translation.attrib_map;
+    uniform_map_ = translation.uniform_map;
+    varying_map_ = translation.varying_map;
+    name_map_ = translation.name_map;
+    return true;
+  }
+
   bool success = false;
   {
     TRACE_EVENT0("gpu", "ShCompile");
@@ -200,6 +234,19 @@ bool ShaderTranslator::Translate(const char* shader) {
     info_log_.reset();
   }
 
+  if (success) {
+    Translation translation;
+    if (translated_shader_)
+      translation.translated_shader = translated_shader_.get();
+    if (info_log_)
+      translation.info_log = info_log_.get();
+    translation.attrib_map = attrib_map_;
+    translation.uniform_map = uniform_map_;
+    translation.varying_map = varying_map_;
+    translation.name_map = name_map_;
+    translation_cache_.Put(source_hash, translation);
+  }
+
   return success;
 }
 
@@ -9,6 +9,7 @@
 
 #include "base/basictypes.h"
 #include "base/containers/hash_tables.h"
+#include "base/containers/mru_cache.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/observer_list.h"
@@ -96,7 +97,10 @@ class ShaderTranslatorInterface {
   virtual ~ShaderTranslatorInterface() {}
 };
 
-// Implementation of ShaderTranslatorInterface
+// Implementation of ShaderTranslatorInterface. The results of the most recent
+// successful translations are kept, keyed by a hash of the source, so that
+// translating a source again, for example from another context sharing this
+// translator through ShaderTranslatorCache, doesn't run the compiler.
 class GPU_EXPORT ShaderTranslator
     : public base::RefCounted<ShaderTranslator>,
       NON_EXPORTED_BASE(public ShaderTranslatorInterface) {
@@ -144,6 +148,19 @@ class GPU_EXPORT ShaderTranslator
  private:
   friend class base::RefCounted<ShaderTranslator>;
 
+  // The results of a successful translation.
+  struct Translation {
+    Translation();
+    ~Translation();
+
+    std::string translated_shader;
+    std::string info_log;
+    VariableMap attrib_map;
+    VariableMap uniform_map;
+    VariableMap varying_map;
+    NameMap name_map;
+  };
+
   virtual ~ShaderTranslator();
   void ClearResults();
   int GetCompileOptions() const;
@@ -160,6 +177,9 @@ class GPU_EXPORT ShaderTranslator
   ShCompileOptions driver_bug_workarounds_;
   ObserverList<DestructionObserver> destruction_observers_;
 
+  typedef base::MRUCache<std::string, Translation> TranslationCache;
+  TranslationCache translation_cache_;
+
   DISALLOW_COPY_AND_ASSIGN(ShaderTranslator);
 };
 
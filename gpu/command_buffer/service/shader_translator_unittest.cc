@@ -159,6 +159,41 @@ TEST_F(ShaderTranslatorTest, GetAttributes) {
   EXPECT_EQ("vPosition", iter->second.name);
 }
 
+TEST_F(ShaderTranslatorTest, RepeatedTranslation) {
+  const char* shader =
+      "attribute vec4 vPosition;\n"
+      "void main() {\n"
+      "  gl_Position = vPosition;\n"
+      "}";
+  const char* other_shader =
+      "void main() {\n"
+      "  gl_Position = vec4(1.0);\n"
+      "}";
+
+  ASSERT_TRUE(vertex_translator_->Translate(shader));
+  ASSERT_TRUE(vertex_translator_->translated_shader() != NULL);
+  std::string translated_shader = vertex_translator_->translated_shader();
+  ASSERT_TRUE(vertex_translator_->Translate(other_shader));
+  EXPECT_TRUE(vertex_translator_->attrib_map().empty());
+
+  // Translating the first source again gives the same results.
+  EXPECT_TRUE(vertex_translator_->Translate(shader));
+  EXPECT_TRUE(vertex_translator_->info_log() == NULL);
+  ASSERT_TRUE(vertex_translator_->translated_shader() != NULL);
+  EXPECT_EQ(translated_shader, vertex_translator_->translated_shader());
+  EXPECT_TRUE(vertex_translator_->uniform_map().empty());
+  const ShaderTranslator::VariableMap& attrib_map =
+      vertex_translator_->attrib_map();
+  EXPECT_EQ(1u, attrib_map.size());
+  EXPECT_TRUE(attrib_map.find("vPosition") != attrib_map.end());
+
+  // Failed translations aren't kept.
+  EXPECT_FALSE(vertex_translator_->Translate("foo-bar"));
+  EXPECT_TRUE(vertex_translator_->info_log() != NULL);
+  EXPECT_FALSE(vertex_translator_->Translate("foo-bar"));
+  EXPECT_TRUE(vertex_translator_->info_log() != NULL);
+}
+
 TEST_F(ShaderTranslatorTest, GetUniforms) {
   const char* shader =
       "precision mediump float;\n"
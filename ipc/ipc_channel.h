@@ -204,6 +204,12 @@ class IPC_EXPORT Channel : public Sender {
   static void SetGlobalPid(int pid);
 #endif
 
+#if defined(OS_POSIX) && !defined(OS_NACL)
+  // Returns the number of system calls the channels of this process have made
+  // to write messages. Used by performance tests.
+  static int GetSendSyscallCountForTesting();
+#endif
+
 #if defined(OS_ANDROID)
   // Most tests are single process and work the same on all platforms. However
   // in some cases we want to test multi-process, and Android differs in that it
@@ -13,9 +13,7 @@
 #include <sys/un.h>
 #include <unistd.h>
 
-#if defined(OS_OPENBSD)
 #include <sys/uio.h>
-#endif
 
 #include <map>
 #include <string>
@@ -23,6 +21,7 @@
 #include "base/command_line.h"
 #include "base/file_util.h"
 #include "base/files/file_path.h"
+#include "base/atomicops.h"
 #include "base/location.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
@@ -161,6 +160,13 @@ bool SocketWriteErrorIsRecoverable() {
 #endif  // OS_MACOSX
 }
 
+// The number of system calls made to write messages, for performance tests.
+base::subtle::Atomic32 g_send_syscall_count = 0;
+
+void CountSendSyscall() {
+  base::subtle::NoBarrier_AtomicIncrement(&g_send_syscall_count, 1);
+}
+
 }  // namespace
 
 #if defined(OS_ANDROID)
@@ -399,10 +405,30 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
     const char* out_bytes = reinterpret_cast<const char*>(msg->data()) +
         message_send_bytes_written_;
 
+    struct iovec iov[kMaxMessagesPerWrite];
+    iov[0].iov_base = const_cast<char*>(out_bytes);
+    iov[0].iov_len = amt_to_write;
+    size_t num_messages = 1;
+
+    // Messages without descriptors are written together with the ones without
+    // descriptors queued behind them, saving a system call per message.
+    if (message_send_bytes_written_ > 0 ||
+        msg->file_descriptor_set()->empty()) {
+      while (num_messages < output_queue_.size() &&
+             num_messages < kMaxMessagesPerWrite) {
+        Message* next = output_queue_[num_messages];
+        if (!next->file_descriptor_set()->empty())
+          break;
+        iov[num_messages].iov_base = const_cast<void*>(next->data());
+        iov[num_messages].iov_len = next->size();
+        amt_to_write += next->size();
+        num_messages++;
+      }
+    }
+
     struct msghdr msgh = {0};
-    struct iovec iov = {const_cast<char*>(out_bytes), amt_to_write};
-    msgh.msg_iov = &iov;
-    msgh.msg_iovlen = 1;
+    msgh.msg_iov = iov;
+    msgh.msg_iovlen = num_messages;
     char buf[CMSG_SPACE(
         sizeof(int) * FileDescriptorSet::kMaxDescriptorsPerMessage)];
 
@@ -448,8 +474,9 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
         struct iovec fd_pipe_iov = { const_cast<char *>(""), 1 };
         msgh.msg_iov = &fd_pipe_iov;
         fd_written = fd_pipe_;
+        CountSendSyscall();
         bytes_written = HANDLE_EINTR(sendmsg(fd_pipe_, &msgh, MSG_DONTWAIT));
-        msgh.msg_iov = &iov;
+        msgh.msg_iov = iov;
         msgh.msg_controllen = 0;
         if (bytes_written > 0) {
           CloseFileDescriptors(msg);
@@ -460,12 +487,13 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
 
     if (bytes_written == 1) {
       fd_written = pipe_;
+      CountSendSyscall();
 #if defined(IPC_USES_READWRITE)
       if ((mode_ & MODE_CLIENT_FLAG) && IsHelloMessage(*msg)) {
         DCHECK_EQ(msg->file_descriptor_set()->size(), 1U);
       }
       if (!msgh.msg_controllen) {
-        bytes_written = HANDLE_EINTR(write(pipe_, out_bytes, amt_to_write));
+        bytes_written = HANDLE_EINTR(writev(pipe_, iov, num_messages));
       } else
 #endif  // IPC_USES_READWRITE
       {
@@ -498,12 +526,24 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
       return false;
     }
 
-    if (static_cast<size_t>(bytes_written) != amt_to_write) {
-      if (bytes_written > 0) {
-        // If write() fails with EAGAIN then bytes_written will be -1.
-        message_send_bytes_written_ += bytes_written;
-      }
+    // Drop the messages that were written in full, and keep track of where
+    // we are in the first one that was not.
+    size_t bytes_left = bytes_written > 0 ? bytes_written : 0;
+    for (size_t i = 0; i < num_messages && bytes_left >= iov[i].iov_len; ++i) {
+      bytes_left -= iov[i].iov_len;
+      message_send_bytes_written_ = 0;
 
+      // Message sent OK!
+      Message* sent = output_queue_.front();
+      DVLOG(2) << "sent message @" << sent << " on channel @" << this
+               << " with type " << sent->type() << " on fd " << pipe_;
+      delete sent;
+      output_queue_.pop_front();
+    }
+    // If write() fails with EAGAIN then bytes_written will be -1.
+    message_send_bytes_written_ += bytes_left;
+
+    if (static_cast<size_t>(bytes_written) != amt_to_write) {
       // Tell libevent to call us back once things are unblocked.
       is_blocked_on_write_ = true;
       base::MessageLoopForIO::current()->WatchFileDescriptor(
@@ -513,14 +553,6 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
           &write_watcher_,
           this);
       return true;
-    } else {
-      message_send_bytes_written_ = 0;
-
-      // Message sent OK!
-      DVLOG(2) << "sent message @" << msg << " on channel @" << this
-               << " with type " << msg->type() << " on fd " << pipe_;
-      delete output_queue_.front();
-      output_queue_.pop();
     }
   }
   return true;
@@ -536,7 +568,7 @@ bool Channel::ChannelImpl::Send(Message* message) {
 #endif  // IPC_MESSAGE_LOG_ENABLED
 
   message->TraceMessageBegin();
-  output_queue_.push(message);
+  output_queue_.push_back(message);
   if (!is_blocked_on_write_ && !waiting_connect_) {
     return ProcessOutgoingMessages();
   }
@@ -606,7 +638,7 @@ void Channel::ChannelImpl::ResetToAcceptingConnectionState() {
 
   while (!output_queue_.empty()) {
     Message* m = output_queue_.front();
-    output_queue_.pop();
+    output_queue_.pop_front();
     delete m;
   }
 
@@ -776,7 +808,7 @@ void Channel::ChannelImpl::QueueHelloMessage() {
     DCHECK_EQ(msg->file_descriptor_set()->size(), 1U);
   }
 #endif  // IPC_USES_READWRITE
-  output_queue_.push(msg.release());
+  output_queue_.push_back(msg.release());
 }
 
 Channel::ChannelImpl::ReadState Channel::ChannelImpl::ReadData(
@@ -961,7 +993,7 @@ void Channel::ChannelImpl::QueueCloseFDMessage(int fd, int hops) {
         NOTREACHED() << "Unable to pickle close fd.";
       }
       // Send(msg.release());
-      output_queue_.push(msg.release());
+      output_queue_.push_back(msg.release());
       break;
     }
 
@@ -1123,4 +1155,9 @@ void Channel::SetGlobalPid(int pid) {
 }
 #endif  // OS_LINUX
 
+// static
+int Channel::GetSendSyscallCountForTesting() {
+  return base::subtle::NoBarrier_Load(&g_send_syscall_count);
+}
+
 }  // namespace IPC
@@ -9,7 +9,7 @@
 
 #include <sys/socket.h>  // for CMSG macros
 
-#include <queue>
+#include <deque>
 #include <set>
 #include <string>
 #include <vector>
@@ -157,7 +157,10 @@ class Channel::ChannelImpl : public internal::ChannelReader,
   std::string pipe_name_;
 
   // Messages to be sent are queued here.
-  std::queue<Message*> output_queue_;
+  std::deque<Message*> output_queue_;
+
+  // At most this many queued messages are written with a single system call.
+  static const size_t kMaxMessagesPerWrite = 64;
 
   // We assume a worst case: kReadBufferSize bytes of messages, where each
   // message has no payload and a full complement of descriptors.
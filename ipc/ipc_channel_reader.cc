@@ -4,6 +4,8 @@
 
 #include "ipc/ipc_channel_reader.h"
 
+#include <string.h>
+
 #include "ipc/ipc_listener.h"
 #include "ipc/ipc_logging.h"
 #include "ipc/ipc_message_macros.h"
@@ -11,7 +13,9 @@
 namespace IPC {
 namespace internal {
 
-ChannelReader::ChannelReader(Listener* listener) : listener_(listener) {
+ChannelReader::ChannelReader(Listener* listener)
+    : listener_(listener),
+      large_message_bytes_read_(0) {
   memset(input_buf_, 0, sizeof(input_buf_));
 }
 
@@ -21,6 +25,32 @@ ChannelReader::~ChannelReader() {
 bool ChannelReader::ProcessIncomingMessages() {
   while (true) {
     int bytes_read = 0;
+#if defined(OS_POSIX)
+    // Reads complete synchronously here, so the rest of a message that does
+    // not fit in |input_buf_| can be read directly into a buffer sized for
+    // the whole message.
+    if (large_message_buf_.empty() && !MaybeStartLargeMessage())
+      return false;
+    if (!large_message_buf_.empty()) {
+      ReadState read_state = ReadData(
+          &large_message_buf_[large_message_bytes_read_],
+          static_cast<int>(large_message_buf_.size() -
+                           large_message_bytes_read_),
+          &bytes_read);
+      if (read_state == READ_FAILED)
+        return false;
+      if (read_state == READ_PENDING)
+        return true;
+
+      DCHECK(bytes_read > 0);
+      large_message_bytes_read_ += bytes_read;
+      if (large_message_bytes_read_ == large_message_buf_.size() &&
+          !DispatchLargeMessage()) {
+        return false;
+      }
+      continue;
+    }
+#endif
     ReadState read_state = ReadData(input_buf_, Channel::kReadBufferSize,
                                     &bytes_read);
     if (read_state == READ_FAILED)
@@ -76,25 +106,8 @@ bool ChannelReader::DispatchInputData(const char* input_data,
     if (message_tail) {
       int len = static_cast<int>(message_tail - p);
       Message m(p, len);
-      if (!WillDispatchInputMessage(&m))
+      if (!DispatchMessage(&m))
         return false;
-
-#ifdef IPC_MESSAGE_LOG_ENABLED
-      Logging* logger = Logging::GetInstance();
-      std::string name;
-      logger->GetMessageText(m.type(), &name, &m, NULL);
-      TRACE_EVENT1("toplevel", "ChannelReader::DispatchInputData",
-                   "name", name);
-#else
-      TRACE_EVENT2("toplevel", "ChannelReader::DispatchInputData",
-                   "class", IPC_MESSAGE_ID_CLASS(m.type()),
-                   "line", IPC_MESSAGE_ID_LINE(m.type()));
-#endif
-      m.TraceMessageEnd();
-      if (IsInternalMessage(m))
-        HandleInternalMessage(m);
-      else
-        listener_->OnMessageReceived(m);
       p = message_tail;
     } else {
       // Last message is partial.
@@ -102,14 +115,79 @@ bool ChannelReader::DispatchInputData(const char* input_data,
     }
   }
 
-  // Save any partial data in the overflow buffer.
-  input_overflow_buf_.assign(p, end - p);
+  // Save any partial data in the overflow buffer. When the data is already
+  // there, only drop the dispatched messages rather than copying it again.
+  if (p >= input_overflow_buf_.data() &&
+      p <= input_overflow_buf_.data() + input_overflow_buf_.size()) {
+    input_overflow_buf_.erase(0, p - input_overflow_buf_.data());
+  } else {
+    input_overflow_buf_.assign(p, end - p);
+  }
 
   if (input_overflow_buf_.empty() && !DidEmptyInputBuffers())
     return false;
   return true;
 }
 
+bool ChannelReader::DispatchMessage(Message* m) {
+  if (!WillDispatchInputMessage(m))
+    return false;
+
+#ifdef IPC_MESSAGE_LOG_ENABLED
+  Logging* logger = Logging::GetInstance();
+  std::string name;
+  logger->GetMessageText(m->type(), &name, m, NULL);
+  TRACE_EVENT1("toplevel", "ChannelReader::DispatchInputData",
+               "name", name);
+#else
+  TRACE_EVENT2("toplevel", "ChannelReader::DispatchInputData",
+               "class", IPC_MESSAGE_ID_CLASS(m->type()),
+               "line", IPC_MESSAGE_ID_LINE(m->type()));
+#endif
+  m->TraceMessageEnd();
+  if (IsInternalMessage(*m))
+    HandleInternalMessage(*m);
+  else
+    listener_->OnMessageReceived(*m);
+  return true;
+}
+
+#if defined(OS_POSIX)
+bool ChannelReader::MaybeStartLargeMessage() {
+  size_t message_size;
+  if (!Message::PeekNext(input_overflow_buf_.data(),
+                         input_overflow_buf_.data() +
+                             input_overflow_buf_.size(),
+                         &message_size) ||
+      message_size <= Channel::kReadBufferSize ||
+      message_size <= input_overflow_buf_.size()) {
+    return true;
+  }
+  if (message_size > Channel::kMaximumMessageSize) {
+    input_overflow_buf_.clear();
+    LOG(ERROR) << "IPC message is too big";
+    return false;
+  }
+
+  large_message_buf_.resize(message_size);
+  memcpy(&large_message_buf_[0], input_overflow_buf_.data(),
+         input_overflow_buf_.size());
+  large_message_bytes_read_ = input_overflow_buf_.size();
+  input_overflow_buf_.clear();
+  return true;
+}
+
+bool ChannelReader::DispatchLargeMessage() {
+  Message m(&large_message_buf_[0],
+            static_cast<int>(large_message_buf_.size()));
+  bool dispatched = DispatchMessage(&m);
+  std::vector<char>().swap(large_message_buf_);
+  large_message_bytes_read_ = 0;
+  if (!dispatched)
+    return false;
+  return DidEmptyInputBuffers();
+}
+#endif
 
 }  // namespace internal
 }  // namespace IPC
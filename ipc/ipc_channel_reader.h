@@ -5,6 +5,9 @@
 #ifndef IPC_IPC_CHANNEL_READER_H_
 #define IPC_IPC_CHANNEL_READER_H_
 
+#include <string>
+#include <vector>
+
 #include "base/basictypes.h"
 #include "ipc/ipc_channel.h"
 
@@ -90,6 +93,20 @@ class ChannelReader {
   // Returns true on success. False means channel error.
   bool DispatchInputData(const char* input_data, int input_data_len);
 
+  // Dispatches a single complete message. Returns false on channel error.
+  bool DispatchMessage(Message* m);
+
+#if defined(OS_POSIX)
+  // Moves the start of a message larger than |input_buf_| from the overflow
+  // buffer to |large_message_buf_|, sized for the whole message. Returns
+  // false if the message is too big.
+  bool MaybeStartLargeMessage();
+
+  // Dispatches the message completed in |large_message_buf_|, and frees the
+  // buffer. Returns false on channel error.
+  bool DispatchLargeMessage();
+#endif
+
   Listener* listener_;
 
   // We read from the pipe into this buffer. Managed by DispatchInputData, do
@@ -100,6 +117,11 @@ class ChannelReader {
   // this buffer.
   std::string input_overflow_buf_;
 
+  // A message larger than |input_buf_| is read directly into this buffer, so
+  // that it is not copied into the overflow buffer one read at a time.
+  std::vector<char> large_message_buf_;
+  size_t large_message_bytes_read_;
+
   DISALLOW_COPY_AND_ASSIGN(ChannelReader);
 };
 
@@ -179,6 +179,16 @@ class IPC_EXPORT Message : public Pickle {
     return Pickle::FindNext(sizeof(Header), range_start, range_end);
   }
 
+  // Sets |message_size| to the size of the message that starts at
+  // range_start, even if it is not entirely in the given data range. Returns
+  // false if the message header is not in the range.
+  static bool PeekNext(const char* range_start,
+                       const char* range_end,
+                       size_t* message_size) {
+    return Pickle::PeekNext(sizeof(Header), range_start, range_end,
+                            message_size);
+  }
+
 #if defined(OS_POSIX)
   // On POSIX, a message supports reading / writing FileDescriptor objects.
   // This is used to pass a file descriptor to the peer of an IPC channel.
@@ -107,6 +107,64 @@ static inline void LogParam(const P& p, std::string* l) {
   ParamTraits<Type>::Log(static_cast<const Type& >(p), l);
 }
 
+namespace internal {
+
+// Helpers for the macro-generated struct traits, which write and read a struct
+// as a single block when that gives the same bytes as writing its members one
+// at a time. That is the case when the members are all of the types below,
+// which are written as they are in memory and take any value when read, and
+// when the traits list them in order and they cover the whole struct. Other
+// structs are still written, and validated, one member at a time.
+typedef char NotBlockType;
+struct BlockType {
+  char dummy[2];
+};
+template <typename T> NotBlockType BlockTypeTest(const T&);
+BlockType BlockTypeTest(const int&);
+BlockType BlockTypeTest(const unsigned int&);
+BlockType BlockTypeTest(const long&);
+BlockType BlockTypeTest(const unsigned long&);
+BlockType BlockTypeTest(const long long&);
+BlockType BlockTypeTest(const unsigned long long&);
+BlockType BlockTypeTest(const float&);
+BlockType BlockTypeTest(const double&);
+
+// True at compile time if |member| is of one of the types above.
+#define IPC_IS_BLOCK_MEMBER(member) \
+  (sizeof(IPC::internal::BlockTypeTest(member)) == \
+   sizeof(IPC::internal::BlockType))
+
+// Accumulates the members of a struct, to find whether it can be written as
+// a block. Everything it computes is known at compile time once inlined.
+class BlockLayout {
+ public:
+  explicit BlockLayout(const void* start)
+      : start_(static_cast<const char*>(start)),
+        size_(0),
+        is_block_(true) {}
+
+  void AddMember(const void* member, size_t size, bool is_block_type) {
+    // Pickle pads every member to 32 bits, so smaller members would not come
+    // out the same.
+    is_block_ = is_block_ && is_block_type && size % sizeof(uint32) == 0 &&
+        static_cast<const char*>(member) == start_ + size_;
+    size_ += size;
+  }
+
+  void AddParent() { is_block_ = false; }
+
+  bool IsBlock(size_t struct_size) const {
+    return is_block_ && size_ == struct_size;
+  }
+
+ private:
+  const char* start_;
+  size_t size_;
+  bool is_block_;
+};
+
+}  // namespace internal
+
 // Primitive ParamTraits -------------------------------------------------------
 
 template <>
@@ -4,10 +4,87 @@
 
 #include "ipc/ipc_message_utils.h"
 
+#include <string.h>
+
+#include <string>
+
 #include "base/files/file_path.h"
 #include "ipc/ipc_message.h"
+#include "ipc/ipc_message_macros.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+namespace {
+
+// Only made of members that are written as they are in memory.
+struct BlockStruct {
+  int32 a;
+  uint32 b;
+  int64 c;
+  double d;
+  float e;
+  int32 f;
+};
+
+enum TestEnum {
+  TEST_ENUM_FIRST,
+  TEST_ENUM_LAST
+};
+
+// Has members that need to be validated, or that are not plain data.
+struct MixedStruct {
+  int32 a;
+  bool b;
+  TestEnum c;
+  std::string d;
+};
+
+// Has padding between its members on most platforms.
+struct PaddedStruct {
+  int32 a;
+  int64 b;
+};
+
+}  // namespace
+
+#define TEST_STRUCT_TRAITS() \
+  IPC_ENUM_TRAITS_MAX_VALUE(TestEnum, TEST_ENUM_LAST) \
+  IPC_STRUCT_TRAITS_BEGIN(BlockStruct) \
+    IPC_STRUCT_TRAITS_MEMBER(a) \
+    IPC_STRUCT_TRAITS_MEMBER(b) \
+    IPC_STRUCT_TRAITS_MEMBER(c) \
+    IPC_STRUCT_TRAITS_MEMBER(d) \
+    IPC_STRUCT_TRAITS_MEMBER(e) \
+    IPC_STRUCT_TRAITS_MEMBER(f) \
+  IPC_STRUCT_TRAITS_END() \
+  IPC_STRUCT_TRAITS_BEGIN(MixedStruct) \
+    IPC_STRUCT_TRAITS_MEMBER(a) \
+    IPC_STRUCT_TRAITS_MEMBER(b) \
+    IPC_STRUCT_TRAITS_MEMBER(c) \
+    IPC_STRUCT_TRAITS_MEMBER(d) \
+  IPC_STRUCT_TRAITS_END() \
+  IPC_STRUCT_TRAITS_BEGIN(PaddedStruct) \
+    IPC_STRUCT_TRAITS_MEMBER(a) \
+    IPC_STRUCT_TRAITS_MEMBER(b) \
+  IPC_STRUCT_TRAITS_END()
+
+// Declare the traits, then generate their methods.
+TEST_STRUCT_TRAITS()
+
+#include "ipc/param_traits_write_macros.h"
+namespace IPC {
+TEST_STRUCT_TRAITS()
+}  // namespace IPC
+
+#include "ipc/param_traits_read_macros.h"
+namespace IPC {
+TEST_STRUCT_TRAITS()
+}  // namespace IPC
+
+#include "ipc/param_traits_log_macros.h"
+namespace IPC {
+TEST_STRUCT_TRAITS()
+}  // namespace IPC
+
 namespace IPC {
 namespace {
 
@@ -70,5 +147,82 @@ TEST(IPCMessageUtilsTest, ParameterValidation) {
   ASSERT_FALSE(ParamTraits<base::FilePath>::Read(&message, &iter, &bad_path));
 }
 
+// Tests that structs of plain data, written as a single block, come out the
+// same as when written one member at a time.
+TEST(IPCMessageUtilsTest, BlockStruct) {
+  BlockStruct in = { -1, 2, 3, 4.5, 6.5f, 7 };
+  Message message;
+  WriteParam(&message, in);
+
+  Message expected;
+  WriteParam(&expected, in.a);
+  WriteParam(&expected, in.b);
+  WriteParam(&expected, in.c);
+  WriteParam(&expected, in.d);
+  WriteParam(&expected, in.e);
+  WriteParam(&expected, in.f);
+  ASSERT_EQ(expected.payload_size(), message.payload_size());
+  EXPECT_EQ(0, memcmp(expected.payload(), message.payload(),
+                      message.payload_size()));
+
+  PickleIterator iter(message);
+  BlockStruct out;
+  ASSERT_TRUE(ReadParam(&message, &iter, &out));
+  EXPECT_EQ(in.a, out.a);
+  EXPECT_EQ(in.b, out.b);
+  EXPECT_EQ(in.c, out.c);
+  EXPECT_EQ(in.d, out.d);
+  EXPECT_EQ(in.e, out.e);
+  EXPECT_EQ(in.f, out.f);
+  EXPECT_FALSE(ReadParam(&message, &iter, &out));
+
+  // A truncated struct is rejected.
+  Message truncated;
+  WriteParam(&truncated, in.a);
+  PickleIterator truncated_iter(truncated);
+  EXPECT_FALSE(ReadParam(&truncated, &truncated_iter, &out));
+}
+
+// Tests that members which need it are still validated one at a time.
+TEST(IPCMessageUtilsTest, MixedStruct) {
+  MixedStruct in;
+  in.a = 1;
+  in.b = true;
+  in.c = TEST_ENUM_LAST;
+  in.d = "hello";
+  Message message;
+  WriteParam(&message, in);
+
+  PickleIterator iter(message);
+  MixedStruct out;
+  ASSERT_TRUE(ReadParam(&message, &iter, &out));
+  EXPECT_EQ(in.a, out.a);
+  EXPECT_EQ(in.b, out.b);
+  EXPECT_EQ(in.c, out.c);
+  EXPECT_EQ(in.d, out.d);
+
+  Message bad_enum;
+  WriteParam(&bad_enum, in.a);
+  WriteParam(&bad_enum, in.b);
+  bad_enum.WriteInt(TEST_ENUM_LAST + 1);
+  WriteParam(&bad_enum, in.d);
+  PickleIterator bad_iter(bad_enum);
+  EXPECT_FALSE(ReadParam(&bad_enum, &bad_iter, &out));
+}
+
+// Tests that padding is not written.
+TEST(IPCMessageUtilsTest, PaddedStruct) {
+  PaddedStruct in = { 1, 2 };
+  Message message;
+  WriteParam(&message, in);
+  EXPECT_EQ(sizeof(in.a) + sizeof(in.b), message.payload_size());
+
+  PickleIterator iter(message);
+  PaddedStruct out;
+  ASSERT_TRUE(ReadParam(&message, &iter, &out));
+  EXPECT_EQ(in.a, out.a);
+  EXPECT_EQ(in.b, out.b);
+}
+
 }  // namespace
 }  // namespace IPC
@@ -12,6 +12,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/pickle.h"
 #include "base/strings/stringprintf.h"
+#include "base/test/perf_log.h"
 #include "base/test/perf_time_logger.h"
 #include "base/threading/thread.h"
 #include "base/time/time.h"
@@ -185,6 +186,7 @@ class PerformanceChannelListener : public IPC::Listener {
       std::string test_name = base::StringPrintf(
           "IPC_Perf_%dx_%u", msg_count_, static_cast<unsigned>(msg_size_));
       perf_logger_.reset(new base::PerfTimeLogger(test_name.c_str()));
+      start_time_ = now;
     } else {
       DCHECK_EQ(payload_.size(), reflected_payload.size());
 
@@ -196,6 +198,10 @@ class PerformanceChannelListener : public IPC::Listener {
       if (count_down_ == 0) {
         perf_logger_.reset();  // Stop the perf timer now.
         latency_tracker_.ShowResults();
+        // Each payload crossed the channel twice.
+        double megabytes = 2.0 * msg_count_ * msg_size_ / (1024 * 1024);
+        VLOG(1) << "Throughput: "
+                << megabytes / (now - start_time_).InSecondsF() << " MB/s";
         base::MessageLoop::current()->QuitWhenIdle();
         return true;
       }
@@ -216,10 +222,29 @@ class PerformanceChannelListener : public IPC::Listener {
 
   int count_down_;
   std::string payload_;
+  base::TimeTicks start_time_;
   EventTimeTracker latency_tracker_;
   scoped_ptr<base::PerfTimeLogger> perf_logger_;
 };
 
+// Bounces |msg_count| messages of |msg_size| bytes off the client.
+void RunPingPong(IPC::Sender* sender,
+                 PerformanceChannelListener* listener,
+                 int msg_count,
+                 size_t msg_size) {
+  listener->SetTestParams(msg_count, msg_size);
+
+  // This initial message will kick-start the ping-pong of messages.
+  IPC::Message* message = new IPC::Message(0, 2, IPC::Message::PRIORITY_NORMAL);
+  message->WriteInt64(base::TimeTicks::Now().ToInternalValue());
+  message->WriteInt(-1);
+  message->WriteString("hello");
+  sender->Send(message);
+
+  // Run message loop.
+  base::MessageLoop::current()->Run();
+}
+
 TEST_F(IPCChannelPerfTest, Performance) {
   Init("PerformanceClient");
 
@@ -235,19 +260,113 @@ TEST_F(IPCChannelPerfTest, Performance) {
   const size_t kMsgSize[5] = {12, 144, 1728, 20736, 248832};
   const int kMessageCount[5] = {50000, 50000, 50000, 12000, 1000};
 
-  for (size_t i = 0; i < 5; i++) {
-    listener.SetTestParams(kMessageCount[i], kMsgSize[i]);
+  for (size_t i = 0; i < 5; i++)
+    RunPingPong(sender(), &listener, kMessageCount[i], kMsgSize[i]);
+
+  // Send quit message.
+  IPC::Message* message = new IPC::Message(0, 2, IPC::Message::PRIORITY_NORMAL);
+  message->WriteInt64(base::TimeTicks::Now().ToInternalValue());
+  message->WriteInt(-1);
+  message->WriteString("quit");
+  sender()->Send(message);
+
+  EXPECT_TRUE(WaitForClientShutdown());
+  DestroyChannel();
+}
+
+// Measures throughput from 64 B to 64 MB messages, which exercises the large
+// message read path of the channel.
+TEST_F(IPCChannelPerfTest, ThroughputSweep) {
+  Init("PerformanceClient");
+
+  PerformanceChannelListener listener;
+  CreateChannel(&listener);
+  listener.Init(channel());
+  ASSERT_TRUE(ConnectChannel());
+  ASSERT_TRUE(StartClient());
+
+  // Move about 64 MB each way per size, with at least a few messages.
+  const size_t kMinMsgSize = 64;
+  const size_t kMaxMsgSize = 64 * 1024 * 1024;
+  const size_t kBytesPerSize = 64 * 1024 * 1024;
+  for (size_t msg_size = kMinMsgSize; msg_size <= kMaxMsgSize; msg_size *= 4) {
+    int msg_count = static_cast<int>(
+        std::min<size_t>(50000, std::max<size_t>(4, kBytesPerSize / msg_size)));
+    RunPingPong(sender(), &listener, msg_count, msg_size);
+  }
+
+  // Send quit message.
+  IPC::Message* message = new IPC::Message(0, 2, IPC::Message::PRIORITY_NORMAL);
+  message->WriteInt64(base::TimeTicks::Now().ToInternalValue());
+  message->WriteInt(-1);
+  message->WriteString("quit");
+  sender()->Send(message);
+
+  EXPECT_TRUE(WaitForClientShutdown());
+  DestroyChannel();
+}
+
+#if defined(OS_POSIX)
+// Counts the messages the client bounces back, and quits once all the
+// messages of a burst are back.
+class BurstChannelListener : public IPC::Listener {
+ public:
+  BurstChannelListener() : count_down_(0) {}
+  virtual ~BurstChannelListener() {}
 
-    // This initial message will kick-start the ping-pong of messages.
-    IPC::Message* message =
-        new IPC::Message(0, 2, IPC::Message::PRIORITY_NORMAL);
-    message->WriteInt64(base::TimeTicks::Now().ToInternalValue());
-    message->WriteInt(-1);
-    message->WriteString("hello");
-    sender()->Send(message);
+  // Call this before running the message loop.
+  void SetMessageCount(int msg_count) {
+    DCHECK_EQ(0, count_down_);
+    count_down_ = msg_count;
+  }
 
-    // Run message loop.
-    base::MessageLoop::current()->Run();
+  virtual bool OnMessageReceived(const IPC::Message& message) OVERRIDE {
+    CHECK(count_down_ > 0);
+    if (--count_down_ == 0)
+      base::MessageLoop::current()->QuitWhenIdle();
+    return true;
+  }
+
+ private:
+  int count_down_;
+};
+
+// Sends bursts of small messages without waiting for replies, so that they
+// queue up behind a full socket, and reports how many system calls it took
+// to write them.
+TEST_F(IPCChannelPerfTest, BurstSyscallsPerMessage) {
+  Init("PerformanceClient");
+
+  BurstChannelListener listener;
+  CreateChannel(&listener);
+  ASSERT_TRUE(ConnectChannel());
+  ASSERT_TRUE(StartClient());
+
+  const int kMessageCount = 100000;
+  const size_t kMsgSize[3] = {12, 144, 1728};
+  for (size_t i = 0; i < arraysize(kMsgSize); i++) {
+    listener.SetMessageCount(kMessageCount);
+    std::string payload(kMsgSize[i], 'a');
+    std::string test_name = base::StringPrintf(
+        "IPC_Burst_%dx_%u", kMessageCount, static_cast<unsigned>(kMsgSize[i]));
+    int syscalls_before = IPC::Channel::GetSendSyscallCountForTesting();
+    {
+      base::PerfTimeLogger logger(test_name.c_str());
+      for (int j = 0; j < kMessageCount; j++) {
+        IPC::Message* message =
+            new IPC::Message(0, 2, IPC::Message::PRIORITY_NORMAL);
+        message->WriteInt64(base::TimeTicks::Now().ToInternalValue());
+        message->WriteInt(j);
+        message->WriteString(payload);
+        sender()->Send(message);
+      }
+      base::MessageLoop::current()->Run();
+    }
+    int syscalls =
+        IPC::Channel::GetSendSyscallCountForTesting() - syscalls_before;
+    base::LogPerfResult((test_name + "_syscalls_per_message").c_str(),
+                        static_cast<double>(syscalls) / kMessageCount,
+                        "syscalls");
   }
 
   // Send quit message.
@@ -260,6 +379,7 @@ TEST_F(IPCChannelPerfTest, Performance) {
   EXPECT_TRUE(WaitForClientShutdown());
   DestroyChannel();
 }
+#endif  // defined(OS_POSIX)
 
 // This message loop bounces all messages back to the sender.
 MULTIPROCESS_IPC_TEST_CLIENT_MAIN(PerformanceClient) {
@@ -5,6 +5,8 @@
 #ifndef IPC_PARAM_TRAITS_READ_MACROS_H_
 #define IPC_PARAM_TRAITS_READ_MACROS_H_
 
+#include <string.h>
+
 // Null out all the macros that need nulling.
 #include "ipc/ipc_message_null_macros.h"
 
@@ -22,13 +24,32 @@
 #undef IPC_STRUCT_TRAITS_MEMBER
 #undef IPC_STRUCT_TRAITS_PARENT
 #undef IPC_STRUCT_TRAITS_END
+// The first pass over the members finds whether the struct can be read as
+// a block (see IPC::internal::BlockLayout), the second one reads them.
 #define IPC_STRUCT_TRAITS_BEGIN(struct_name) \
   bool ParamTraits<struct_name>:: \
       Read(const Message* m, PickleIterator* iter, param_type* p) { \
-    return
-#define IPC_STRUCT_TRAITS_MEMBER(name) ReadParam(m, iter, &p->name) &&
-#define IPC_STRUCT_TRAITS_PARENT(type) ParamTraits<type>::Read(m, iter, p) &&
-#define IPC_STRUCT_TRAITS_END() 1; }
+    IPC::internal::BlockLayout layout(p); \
+    for (int pass = 0; pass < 2; ++pass) { \
+      if (pass == 1 && layout.IsBlock(sizeof(*p))) { \
+        const char* data; \
+        if (!m->ReadBytes(iter, &data, static_cast<int>(sizeof(*p)))) \
+          return false; \
+        memcpy(static_cast<void*>(p), data, sizeof(*p)); \
+        return true; \
+      }
+#define IPC_STRUCT_TRAITS_MEMBER(name) \
+      if (pass == 0) \
+        layout.AddMember(&p->name, sizeof(p->name), \
+                         IPC_IS_BLOCK_MEMBER(p->name)); \
+      else if (!ReadParam(m, iter, &p->name)) \
+        return false;
+#define IPC_STRUCT_TRAITS_PARENT(type) \
+      if (pass == 0) \
+        layout.AddParent(); \
+      else if (!ParamTraits<type>::Read(m, iter, p)) \
+        return false;
+#define IPC_STRUCT_TRAITS_END() } return true; }
 
 #undef IPC_ENUM_TRAITS_VALIDATE
 #define IPC_ENUM_TRAITS_VALIDATE(enum_name, validation_expression)    \
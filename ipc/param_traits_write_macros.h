@@ -22,11 +22,28 @@
 #undef IPC_STRUCT_TRAITS_MEMBER
 #undef IPC_STRUCT_TRAITS_PARENT
 #undef IPC_STRUCT_TRAITS_END
+// The first pass over the members finds whether the struct can be written as
+// a block (see IPC::internal::BlockLayout), the second one writes them.
 #define IPC_STRUCT_TRAITS_BEGIN(struct_name) \
-  void ParamTraits<struct_name>::Write(Message* m, const param_type& p) {
-#define IPC_STRUCT_TRAITS_MEMBER(name) WriteParam(m, p.name);
-#define IPC_STRUCT_TRAITS_PARENT(type) ParamTraits<type>::Write(m, p);
-#define IPC_STRUCT_TRAITS_END() }
+  void ParamTraits<struct_name>::Write(Message* m, const param_type& p) { \
+    IPC::internal::BlockLayout layout(&p); \
+    for (int pass = 0; pass < 2; ++pass) { \
+      if (pass == 1 && layout.IsBlock(sizeof(p))) { \
+        m->WriteBytes(&p, static_cast<int>(sizeof(p))); \
+        return; \
+      }
+#define IPC_STRUCT_TRAITS_MEMBER(name) \
+      if (pass == 0) \
+        layout.AddMember(&p.name, sizeof(p.name), \
+                         IPC_IS_BLOCK_MEMBER(p.name)); \
+      else \
+        WriteParam(m, p.name);
+#define IPC_STRUCT_TRAITS_PARENT(type) \
+      if (pass == 0) \
+        layout.AddParent(); \
+      else \
+        ParamTraits<type>::Write(m, p);
+#define IPC_STRUCT_TRAITS_END() } }
 
 #undef IPC_ENUM_TRAITS_VALIDATE
 #define IPC_ENUM_TRAITS_VALIDATE(enum_name, validation_expression) \
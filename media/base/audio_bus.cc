@@ -6,10 +6,15 @@
 
 #include "base/logging.h"
 #include "base/numerics/safe_conversions.h"
+#include "build/build_config.h"
 #include "media/audio/audio_parameters.h"
 #include "media/base/limits.h"
 #include "media/base/vector_math.h"
 
+#if defined(ARCH_CPU_X86_FAMILY) && defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace media {
 
 static const uint8 kUint8Bias = 128;
@@ -83,6 +88,122 @@ static void ToInterleavedInternal(const AudioBus* source, int start_frame,
   }
 }
 
+#if defined(ARCH_CPU_X86_FAMILY) && defined(__SSE2__)
+// SSE2 versions of the 16-bit cases of the above, which is what nearly all
+// audio devices use. They give exactly the same results. Mono and stereo,
+// the most common layouts, are (de)interleaved in registers; other layouts
+// only have their sample conversion vectorized. The frames left over at the
+// end are handed to the templates above.
+
+// Converts 4 samples, sign extended to 32 bits, to floats.
+static inline __m128 Int16x4ToFloat(__m128i samples) {
+  const __m128 v = _mm_cvtepi32_ps(samples);
+  const __m128 negative = _mm_cmplt_ps(v, _mm_setzero_ps());
+  const __m128 scale =
+      _mm_or_ps(_mm_and_ps(negative, _mm_set1_ps(-(1.0f / kint16min))),
+                _mm_andnot_ps(negative, _mm_set1_ps(1.0f / kint16max)));
+  return _mm_mul_ps(v, scale);
+}
+
+// Converts 4 floats to 16-bit samples, clamped and sign extended to 32 bits.
+static inline __m128i FloatToInt16x4(const float* src) {
+  const __m128 v = _mm_loadu_ps(src);
+  const __m128 negative = _mm_cmplt_ps(v, _mm_setzero_ps());
+  const __m128 scale =
+      _mm_or_ps(_mm_and_ps(negative, _mm_set1_ps(-kint16min)),
+                _mm_andnot_ps(negative, _mm_set1_ps(kint16max)));
+  __m128 sample = _mm_mul_ps(v, scale);
+  sample = _mm_max_ps(sample, _mm_set1_ps(kint16min));
+  sample = _mm_min_ps(sample, _mm_set1_ps(kint16max));
+  return _mm_cvttps_epi32(sample);
+}
+
+// Converts 8 floats to 16-bit samples.
+static inline __m128i FloatToInt16x8(const float* src) {
+  return _mm_packs_epi32(FloatToInt16x4(src), FloatToInt16x4(src + 4));
+}
+
+static void FromInterleavedInt16_SSE2(const int16* source, int start_frame,
+                                      int frames, AudioBus* dest) {
+  const int channels = dest->channels();
+  const int end_frame = start_frame + frames;
+  int i = start_frame;
+  if (channels == 1) {
+    float* mono = dest->channel(0);
+    for (; i + 8 <= end_frame; i += 8, source += 8) {
+      const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+          source));
+      _mm_storeu_ps(mono + i, Int16x4ToFloat(
+          _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16)));
+      _mm_storeu_ps(mono + i + 4, Int16x4ToFloat(
+          _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16)));
+    }
+  } else if (channels == 2) {
+    float* left = dest->channel(0);
+    float* right = dest->channel(1);
+    for (; i + 4 <= end_frame; i += 4, source += 8) {
+      // Each 32-bit lane holds one frame, left sample in the low half.
+      const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+          source));
+      _mm_storeu_ps(left + i, Int16x4ToFloat(
+          _mm_srai_epi32(_mm_slli_epi32(v, 16), 16)));
+      _mm_storeu_ps(right + i, Int16x4ToFloat(_mm_srai_epi32(v, 16)));
+    }
+  } else {
+    for (; i + 4 <= end_frame; i += 4, source += 4 * channels) {
+      for (int ch = 0; ch < channels; ++ch) {
+        const __m128i v = _mm_setr_epi32(source[ch],
+                                         source[channels + ch],
+                                         source[2 * channels + ch],
+                                         source[3 * channels + ch]);
+        _mm_storeu_ps(dest->channel(ch) + i, Int16x4ToFloat(v));
+      }
+    }
+  }
+
+  FromInterleavedInternal<int16, int16, 0>(
+      source, i, end_frame - i, dest, 1.0f / kint16min, 1.0f / kint16max);
+}
+
+static void ToInterleavedInt16_SSE2(const AudioBus* source, int start_frame,
+                                    int frames, int16* dest) {
+  const int channels = source->channels();
+  const int end_frame = start_frame + frames;
+  int i = start_frame;
+  if (channels == 1) {
+    const float* mono = source->channel(0);
+    for (; i + 8 <= end_frame; i += 8, dest += 8) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dest),
+                       FloatToInt16x8(mono + i));
+    }
+  } else if (channels == 2) {
+    const float* left = source->channel(0);
+    const float* right = source->channel(1);
+    for (; i + 8 <= end_frame; i += 8, dest += 16) {
+      const __m128i l = FloatToInt16x8(left + i);
+      const __m128i r = FloatToInt16x8(right + i);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dest),
+                       _mm_unpacklo_epi16(l, r));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 8),
+                       _mm_unpackhi_epi16(l, r));
+    }
+  } else {
+    int16 samples[8];
+    for (; i + 8 <= end_frame; i += 8, dest += 8 * channels) {
+      for (int ch = 0; ch < channels; ++ch) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(samples),
+                         FloatToInt16x8(source->channel(ch) + i));
+        for (int j = 0; j < 8; ++j)
+          dest[j * channels + ch] = samples[j];
+      }
+    }
+  }
+
+  ToInterleavedInternal<int16, int16, 0>(
+      source, i, end_frame - i, dest, kint16min, kint16max);
+}
+#endif
+
 static void ValidateConfig(int channels, int frames) {
   CHECK_GT(frames, 0);
   CHECK_GT(channels, 0);
@@ -236,7 +357,6 @@ void AudioBus::BuildChannelData(int channels, int aligned_frames, float* data) {
     channel_data_.push_back(data + i * aligned_frames);
 }
 
-// TODO(dalecurtis): See if intrinsic optimizations help any here.
 void AudioBus::FromInterleavedPartial(const void* source, int start_frame,
                                       int frames, int bytes_per_sample) {
   CheckOverflow(start_frame, frames, frames_);
@@ -247,9 +367,14 @@ void AudioBus::FromInterleavedPartial(const void* source, int start_frame,
           1.0f / kint8min, 1.0f / kint8max);
       break;
     case 2:
+#if defined(ARCH_CPU_X86_FAMILY) && defined(__SSE2__)
+      FromInterleavedInt16_SSE2(
+          static_cast<const int16*>(source), start_frame, frames, this);
+#else
       FromInterleavedInternal<int16, int16, 0>(
           source, start_frame, frames, this,
           1.0f / kint16min, 1.0f / kint16max);
+#endif
       break;
     case 4:
       FromInterleavedInternal<int32, int32, 0>(
@@ -279,7 +404,6 @@ void AudioBus::ToInterleaved(int frames, int bytes_per_sample,
   ToInterleavedPartial(0, frames, bytes_per_sample, dest);
 }
 
-// TODO(dalecurtis): See if intrinsic optimizations help any here.
 void AudioBus::ToInterleavedPartial(int start_frame, int frames,
                                     int bytes_per_sample, void* dest) const {
   CheckOverflow(start_frame, frames, frames_);
@@ -289,8 +413,13 @@ void AudioBus::ToInterleavedPartial(int start_frame, int frames,
           this, start_frame, frames, dest, kint8min, kint8max);
       break;
     case 2:
+#if defined(ARCH_CPU_X86_FAMILY) && defined(__SSE2__)
+      ToInterleavedInt16_SSE2(
+          this, start_frame, frames, static_cast<int16*>(dest));
+#else
       ToInterleavedInternal<int16, int16, 0>(
           this, start_frame, frames, dest, kint16min, kint16max);
+#endif
       break;
     case 4:
       ToInterleavedInternal<int32, int32, 0>(
@@ -50,4 +50,24 @@ TEST(AudioBusPerfTest, Interleave) {
   RunInterleaveBench<int32>(bus.get(), "int32");
 }
 
+// 16-bit is the common device format and has vectorized paths for each of
+// these layouts, so benchmark them separately.
+TEST(AudioBusPerfTest, InterleaveInt16Layouts) {
+  static const struct {
+    int channels;
+    const char* trace_name;
+  } kLayouts[] = {
+    { 1, "int16_mono" },
+    { 2, "int16_stereo" },
+    { 6, "int16_5_1" },
+  };
+  for (size_t i = 0; i < arraysize(kLayouts); ++i) {
+    scoped_ptr<AudioBus> bus =
+        AudioBus::Create(kLayouts[i].channels, 48000 * 120);
+    FakeAudioRenderCallback callback(0.2);
+    callback.Render(bus.get(), 0);
+    RunInterleaveBench<int16>(bus.get(), kLayouts[i].trace_name);
+  }
+}
+
 } // namespace media
@@ -2,6 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+
 #include "base/strings/stringprintf.h"
 #include "base/time/time.h"
 #include "build/build_config.h"
@@ -382,6 +384,46 @@ TEST_F(AudioBusTest, ToInterleavedPartial) {
       kPartialFrames * sizeof(*kTestVectorInt16) * kTestVectorChannels), 0);
 }
 
+// Verify 16-bit interleaving in the common channel layouts, with enough frames
+// to cover both the vectorized and remainder paths, and with out of range
+// values which must be clamped.
+TEST_F(AudioBusTest, Int16InterleaveLayouts) {
+  static const int kLayoutChannels[] = { 1, 2, kChannels };
+  for (size_t i = 0; i < arraysize(kLayoutChannels); ++i) {
+    const int channels = kLayoutChannels[i];
+    SCOPED_TRACE(base::StringPrintf("%d channels", channels));
+
+    scoped_ptr<AudioBus> bus = AudioBus::Create(channels, kFrameCount);
+    for (int ch = 0; ch < channels; ++ch) {
+      for (int j = 0; j < kFrameCount; ++j)
+        bus->channel(ch)[j] = ((j * 7 + ch * 3) % 31) / 10.0f - 1.5f;
+    }
+
+    std::vector<int16> interleaved(channels * kFrameCount);
+    bus->ToInterleaved(kFrameCount, sizeof(interleaved[0]), &interleaved[0]);
+    for (int ch = 0; ch < channels; ++ch) {
+      for (int j = 0; j < kFrameCount; ++j) {
+        const float v = bus->channel(ch)[j];
+        const int16 expected =
+            v <= -1 ? kint16min :
+            v >= 1 ? kint16max :
+            static_cast<int16>(v < 0 ? -v * kint16min : v * kint16max);
+        ASSERT_EQ(expected, interleaved[j * channels + ch]);
+      }
+    }
+
+    scoped_ptr<AudioBus> result = AudioBus::Create(channels, kFrameCount);
+    result->FromInterleaved(
+        &interleaved[0], kFrameCount, sizeof(interleaved[0]));
+    for (int ch = 0; ch < channels; ++ch) {
+      for (int j = 0; j < kFrameCount; ++j) {
+        const float v = std::max(-1.0f, std::min(1.0f, bus->channel(ch)[j]));
+        ASSERT_NEAR(v, result->channel(ch)[j], 1.0f / kint16max);
+      }
+    }
+  }
+}
+
 TEST_F(AudioBusTest, Scale) {
   scoped_ptr<AudioBus> bus = AudioBus::Create(kChannels, kFrameCount);
 
@@ -60,6 +60,22 @@ TEST(AudioConverterPerfTest, ConvertBenchmark) {
   RunConvertBenchmark(input_params, output_params, false, "convert");
 }
 
+// Conversions between the common rates use SincResampler's polyphase kernels.
+// Compare against an output rate which doesn't reduce to a small fraction of
+// the input rate, for which the kernels are interpolated instead.
+TEST(AudioConverterPerfTest, ConvertBenchmarkPolyphase) {
+  AudioParameters input_params(
+      AudioParameters::AUDIO_PCM_LINEAR, CHANNEL_LAYOUT_5_1, 44100, 16, 441);
+  AudioParameters output_params(
+      AudioParameters::AUDIO_PCM_LINEAR, CHANNEL_LAYOUT_5_1, 48000, 16, 480);
+  RunConvertBenchmark(input_params, output_params, false, "convert_polyphase");
+
+  AudioParameters arbitrary_output_params(
+      AudioParameters::AUDIO_PCM_LINEAR, CHANNEL_LAYOUT_5_1, 48001, 16, 480);
+  RunConvertBenchmark(
+      input_params, arbitrary_output_params, false, "convert_interpolated");
+}
+
 TEST(AudioConverterPerfTest, ConvertBenchmarkFIFO) {
   // Create input and output parameters to convert between common buffer sizes
   // without any resampling for the FIFO vs no FIFO benchmarks.
@@ -4,9 +4,12 @@
 
 #include "media/base/audio_renderer_mixer.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/bind_helpers.h"
 #include "base/logging.h"
+#include "base/metrics/histogram.h"
 
 namespace media {
 
@@ -20,7 +23,9 @@ AudioRendererMixer::AudioRendererMixer(
       pause_delay_(base::TimeDelta::FromSeconds(kPauseDelaySeconds)),
       last_play_time_(base::TimeTicks::Now()),
       // Initialize |playing_| to true since Start() results in an auto-play.
-      playing_(true) {
+      playing_(true),
+      render_count_(0),
+      silent_render_count_(0) {
   audio_sink_->Initialize(output_params, this);
   audio_sink_->Start();
 }
@@ -29,6 +34,15 @@ AudioRendererMixer::~AudioRendererMixer() {
   // AudioRendererSinks must be stopped before being destructed.
   audio_sink_->Stop();
 
+  // Render() calls which couldn't mix, per million; zero for nearly all
+  // mixers, so only report the ones which actually played something.
+  if (render_count_ > 0) {
+    UMA_HISTOGRAM_COUNTS(
+        "Media.AudioRendererMixer.SilentRendersPerMillion",
+        static_cast<int>(
+            1000000.0 * silent_render_count_ / render_count_));
+  }
+
   // Ensures that all mixer inputs have stopped themselves prior to destruction
   // and have called RemoveMixerInput().
   DCHECK_EQ(mixer_inputs_.size(), 0U);
@@ -46,35 +60,63 @@ void AudioRendererMixer::AddMixerInput(AudioConverter::InputCallback* input,
 
   DCHECK(mixer_inputs_.find(input) == mixer_inputs_.end());
   mixer_inputs_[input] = error_cb;
-  audio_converter_.AddInput(input);
+
+  // Handed to |audio_converter_| by the next Render().
+  pending_inputs_.push_back(input);
 }
 
 void AudioRendererMixer::RemoveMixerInput(
     AudioConverter::InputCallback* input) {
+  // Waits for any Render() in progress, after which |input| is never called.
+  base::AutoLock converter_auto_lock(converter_lock_);
   base::AutoLock auto_lock(mixer_inputs_lock_);
-  audio_converter_.RemoveInput(input);
 
   DCHECK(mixer_inputs_.find(input) != mixer_inputs_.end());
   mixer_inputs_.erase(input);
+
+  std::vector<AudioConverter::InputCallback*>::iterator it =
+      std::find(pending_inputs_.begin(), pending_inputs_.end(), input);
+  if (it != pending_inputs_.end())
+    pending_inputs_.erase(it);
+  else
+    audio_converter_.RemoveInput(input);
 }
 
 int AudioRendererMixer::Render(AudioBus* audio_bus,
                                int audio_delay_milliseconds) {
-  base::AutoLock auto_lock(mixer_inputs_lock_);
+  ++render_count_;
+
+  // RemoveMixerInput() is only ever holding |converter_lock_| for a moment, but
+  // the thread doing so may be preempted, so play silence rather than wait.
+  if (!converter_lock_.Try()) {
+    ++silent_render_count_;
+    audio_bus->Zero();
+    return audio_bus->frames();
+  }
 
-  // If there are no mixer inputs and we haven't seen one for a while, pause the
-  // sink to avoid wasting resources when media elements are present but remain
-  // in the pause state.
-  const base::TimeTicks now = base::TimeTicks::Now();
-  if (!mixer_inputs_.empty()) {
-    last_play_time_ = now;
-  } else if (now - last_play_time_ >= pause_delay_ && playing_) {
-    audio_sink_->Pause();
-    playing_ = false;
+  // Likewise, new inputs and the pause check can wait for the next Render().
+  if (mixer_inputs_lock_.Try()) {
+    for (size_t i = 0; i < pending_inputs_.size(); ++i)
+      audio_converter_.AddInput(pending_inputs_[i]);
+    pending_inputs_.clear();
+
+    // If there are no mixer inputs and we haven't seen one for a while, pause
+    // the sink to avoid wasting resources when media elements are present but
+    // remain in the pause state.
+    const base::TimeTicks now = base::TimeTicks::Now();
+    if (!mixer_inputs_.empty()) {
+      last_play_time_ = now;
+    } else if (now - last_play_time_ >= pause_delay_ && playing_) {
+      audio_sink_->Pause();
+      playing_ = false;
+    }
+    mixer_inputs_lock_.Release();
   }
 
+  // Each input is mixed in by AudioConverter with vector_math::FMAC().
   audio_converter_.ConvertWithDelay(
       base::TimeDelta::FromMilliseconds(audio_delay_milliseconds), audio_bus);
+  converter_lock_.Release();
   return audio_bus->frames();
 }
 
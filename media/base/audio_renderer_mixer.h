@@ -6,6 +6,7 @@
 #define MEDIA_BASE_AUDIO_RENDERER_MIXER_H_
 
 #include <map>
+#include <vector>
 
 #include "base/synchronization/lock.h"
 #include "base/time/time.h"
@@ -43,22 +44,43 @@ class MEDIA_EXPORT AudioRendererMixer
   // Output sink for this mixer.
   scoped_refptr<AudioRendererSink> audio_sink_;
 
-  // Set of mixer inputs to be mixed by this mixer.  Access is thread-safe
-  // through |mixer_inputs_lock_|.
+  // Render() runs on the audio device thread and must never wait on the
+  // threads adding and removing inputs, so it only ever Try()s the locks below.
+  //
+  // |mixer_inputs_lock_| guards the set of mixer inputs, the inputs added since
+  // the last Render() and the pause state.  It's held only briefly.
+  // |converter_lock_| guards |audio_converter_| and is held by Render() while
+  // mixing.  AddMixerInput() doesn't need it, Render() picks up new inputs
+  // from |pending_inputs_|, but RemoveMixerInput() does, since the input must
+  // never be called again once it returns.  The lock order is
+  // |converter_lock_| then |mixer_inputs_lock_|.
+
+  // Set of mixer inputs to be mixed by this mixer.
   typedef std::map<AudioConverter::InputCallback*, base::Closure>
       AudioRendererMixerInputSet;
   AudioRendererMixerInputSet mixer_inputs_;
+
+  // Inputs in |mixer_inputs_| which haven't been added to |audio_converter_|.
+  std::vector<AudioConverter::InputCallback*> pending_inputs_;
   base::Lock mixer_inputs_lock_;
 
   // Handles mixing and resampling between input and output parameters.
   AudioConverter audio_converter_;
+  base::Lock converter_lock_;
 
   // Handles physical stream pause when no inputs are playing.  For latency
-  // reasons we don't want to immediately pause the physical stream.
+  // reasons we don't want to immediately pause the physical stream.  Guarded
+  // by |mixer_inputs_lock_|.
   base::TimeDelta pause_delay_;
   base::TimeTicks last_play_time_;
   bool playing_;
 
+  // Number of Render() calls, and of those which rendered silence because an
+  // input was being removed at the time.  Only used on the audio device
+  // thread, and reported to UMA on destruction.
+  int render_count_;
+  int silent_render_count_;
+
   DISALLOW_COPY_AND_ASSIGN(AudioRendererMixer);
 };
 
@@ -393,6 +393,24 @@ TEST_P(AudioRendererMixerBehavioralTest, OnRenderError) {
     mixer_inputs_[i]->Stop();
 }
 
+// Ensure inputs added to the mixer are picked up by the next Render(), and
+// that an input removed before then is never called.
+TEST_P(AudioRendererMixerBehavioralTest, InputRemovedBeforeRender) {
+  InitializeInputs(2);
+  for (size_t i = 0; i < mixer_inputs_.size(); ++i) {
+    mixer_inputs_[i]->Start();
+    mixer_inputs_[i]->Play();
+  }
+  mixer_inputs_[1]->Pause();
+
+  mixer_callback_->Render(audio_bus_.get(), 0);
+  EXPECT_NE(-1, fake_callbacks_[0]->last_audio_delay_milliseconds());
+  EXPECT_EQ(-1, fake_callbacks_[1]->last_audio_delay_milliseconds());
+
+  for (size_t i = 0; i < mixer_inputs_.size(); ++i)
+    mixer_inputs_[i]->Stop();
+}
+
 // Ensure constructing an AudioRendererMixerInput, but not initializing it does
 // not call RemoveMixer().
 TEST_P(AudioRendererMixerBehavioralTest, NoInitialize) {
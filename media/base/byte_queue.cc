@@ -31,8 +31,12 @@ void ByteQueue::Push(const uint8* data, int size) {
 
   size_t size_needed = used_ + size;
 
-  // Check to see if we need a bigger buffer.
-  if (size_needed > size_) {
+  // Check to see if we need a bigger buffer. Also grow it if it is more than
+  // half full and the new data doesn't fit after the front: compacting it
+  // would then free little space, and a queue that is consumed more slowly
+  // than it is filled would move its contents on nearly every Push().
+  if (size_needed > size_ ||
+      (offset_ + size_needed > size_ && size_needed > size_ / 2)) {
     size_t new_size = 2 * size_;
     while (size_needed > new_size && new_size > size_)
       new_size *= 2;
@@ -51,6 +55,7 @@ void ByteQueue::Push(const uint8* data, int size) {
     offset_ = 0;
   } else if ((offset_ + used_ + size) > size_) {
     // The buffer is big enough, but we need to move the data in the queue.
+    // At most half the buffer is moved, and at least half is left free.
     memmove(buffer_.get(), front(), used_);
     offset_ = 0;
   }
@@ -72,11 +77,10 @@ void ByteQueue::Pop(int count) {
   offset_ += count;
   used_ -= count;
 
-  // Move the offset back to 0 if we have reached the end of the buffer.
-  if (offset_ == size_) {
-    DCHECK_EQ(used_, 0);
+  // Move the offset back to 0 once the queue is empty, so that the next
+  // Push() has the whole buffer without moving anything.
+  if (used_ == 0)
     offset_ = 0;
-  }
 }
 
 uint8* ByteQueue::front() const { return buffer_.get() + offset_; }
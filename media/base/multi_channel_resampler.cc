@@ -25,6 +25,7 @@ MultiChannelResampler::MultiChannelResampler(int channels,
         io_sample_rate_ratio, request_size, base::Bind(
             &MultiChannelResampler::ProvideInput, base::Unretained(this), i)));
   }
+  ShareKernels();
 
   // Setup the wrapped AudioBus for channel data.
   wrapped_resampler_audio_bus_->set_frames(request_size);
@@ -106,6 +107,15 @@ void MultiChannelResampler::Flush() {
 void MultiChannelResampler::SetRatio(double io_sample_rate_ratio) {
   for (size_t i = 0; i < resamplers_.size(); ++i)
     resamplers_[i]->SetRatio(io_sample_rate_ratio);
+  ShareKernels();
+}
+
+void MultiChannelResampler::ShareKernels() {
+  // All channels are resampled in lockstep at the same ratio, so have them
+  // read from one set of kernels, which then stays in the cache from one
+  // channel to the next.
+  for (size_t i = 1; i < resamplers_.size(); ++i)
+    resamplers_[i]->ShareKernelsWith(*resamplers_[0]);
 }
 
 int MultiChannelResampler::ChunkSize() const {
@@ -56,6 +56,9 @@ class MEDIA_EXPORT MultiChannelResampler {
   // each channel (in channel order) as SincResampler needs more data.
   void ProvideInput(int channel, int frames, float* destination);
 
+  // Makes every resampler use the kernels of the first one.
+  void ShareKernels();
+
   // Source of data for resampling.
   ReadCB read_cb_;
 
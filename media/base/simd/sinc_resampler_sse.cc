@@ -45,4 +45,29 @@ float SincResampler::Convolve_SSE(const float* input_ptr, const float* k1,
   return result;
 }
 
+float SincResampler::ConvolveSingle_SSE(const float* input_ptr,
+                                        const float* k) {
+  __m128 m_sums = _mm_setzero_ps();
+
+  // Based on |input_ptr| alignment, we need to use loadu or load.
+  if (reinterpret_cast<uintptr_t>(input_ptr) & 0x0F) {
+    for (int i = 0; i < kKernelSize; i += 4) {
+      m_sums = _mm_add_ps(m_sums, _mm_mul_ps(_mm_loadu_ps(input_ptr + i),
+                                             _mm_load_ps(k + i)));
+    }
+  } else {
+    for (int i = 0; i < kKernelSize; i += 4) {
+      m_sums = _mm_add_ps(m_sums, _mm_mul_ps(_mm_load_ps(input_ptr + i),
+                                             _mm_load_ps(k + i)));
+    }
+  }
+
+  // Sum components together.
+  float result;
+  m_sums = _mm_add_ps(_mm_movehl_ps(m_sums, m_sums), m_sums);
+  _mm_store_ss(&result, _mm_add_ss(m_sums, _mm_shuffle_ps(m_sums, m_sums, 1)));
+
+  return result;
+}
+
 }  // namespace media
@@ -0,0 +1,103 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "media/base/vector_math_testing.h"
+
+#include <algorithm>
+
+#include <immintrin.h>  // NOLINT
+
+namespace media {
+namespace vector_math {
+
+// The inputs are only guaranteed to be kRequiredAlignment (16 byte) aligned,
+// so unaligned loads and stores are used throughout; they run at full speed
+// on aligned data.
+
+void FMUL_AVX(const float src[], float scale, int len, float dest[]) {
+  const int rem = len % 8;
+  const int last_index = len - rem;
+  __m256 m_scale = _mm256_set1_ps(scale);
+  for (int i = 0; i < last_index; i += 8) {
+    _mm256_storeu_ps(dest + i,
+                     _mm256_mul_ps(_mm256_loadu_ps(src + i), m_scale));
+  }
+
+  // Handle any remaining values that wouldn't fit in an AVX pass.
+  for (int i = last_index; i < len; ++i)
+    dest[i] = src[i] * scale;
+}
+
+void FMAC_AVX(const float src[], float scale, int len, float dest[]) {
+  const int rem = len % 8;
+  const int last_index = len - rem;
+  __m256 m_scale = _mm256_set1_ps(scale);
+  for (int i = 0; i < last_index; i += 8) {
+    _mm256_storeu_ps(dest + i, _mm256_add_ps(_mm256_loadu_ps(dest + i),
+                     _mm256_mul_ps(_mm256_loadu_ps(src + i), m_scale)));
+  }
+
+  // Handle any remaining values that wouldn't fit in an AVX pass.
+  for (int i = last_index; i < len; ++i)
+    dest[i] += src[i] * scale;
+}
+
+std::pair<float, float> EWMAAndMaxPower_AVX(
+    float initial_value, const float src[], int len, float smoothing_factor) {
+  // This is the same as EWMAAndMaxPower_SSE(), see there for how the
+  // recurrence is split into lanes, but with 8 lanes: lane 7 holds z[n] and
+  // lane 0 holds z[n-7], each weighted by (1-a)^8 per iteration.
+  const int rem = len % 8;
+  const int last_index = len - rem;
+
+  const __m256 smoothing_factor_x8 = _mm256_set1_ps(smoothing_factor);
+  const float weight_prev = 1.0f - smoothing_factor;
+  const __m256 weight_prev_x8 = _mm256_set1_ps(weight_prev);
+  const __m256 weight_prev_squared_x8 =
+      _mm256_mul_ps(weight_prev_x8, weight_prev_x8);
+  const __m256 weight_prev_4th_x8 =
+      _mm256_mul_ps(weight_prev_squared_x8, weight_prev_squared_x8);
+  const __m256 weight_prev_8th_x8 =
+      _mm256_mul_ps(weight_prev_4th_x8, weight_prev_4th_x8);
+
+  __m256 max_x8 = _mm256_setzero_ps();
+  __m256 ewma_x8 = _mm256_setr_ps(
+      0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, initial_value);
+  int i;
+  for (i = 0; i < last_index; i += 8) {
+    ewma_x8 = _mm256_mul_ps(ewma_x8, weight_prev_8th_x8);
+    const __m256 sample_x8 = _mm256_loadu_ps(src + i);
+    const __m256 sample_squared_x8 = _mm256_mul_ps(sample_x8, sample_x8);
+    max_x8 = _mm256_max_ps(max_x8, sample_squared_x8);
+    ewma_x8 = _mm256_add_ps(ewma_x8,
+                            _mm256_mul_ps(sample_squared_x8,
+                                          smoothing_factor_x8));
+  }
+
+  // y[n] = z[n] + (1-a)^1(z[n-1]) + ... + (1-a)^7(z[n-7])
+  float ewma_lanes[8];
+  float max_lanes[8];
+  _mm256_storeu_ps(ewma_lanes, ewma_x8);
+  _mm256_storeu_ps(max_lanes, max_x8);
+  float ewma = ewma_lanes[0];
+  for (int lane = 1; lane < 8; ++lane)
+    ewma = ewma * weight_prev + ewma_lanes[lane];
+
+  std::pair<float, float> result(
+      ewma, *std::max_element(max_lanes, max_lanes + 8));
+
+  // Handle remaining values at the end of |src|.
+  for (; i < len; ++i) {
+    result.first *= weight_prev;
+    const float sample = src[i];
+    const float sample_squared = sample * sample;
+    result.first += sample_squared * smoothing_factor;
+    result.second = std::max(result.second, sample_squared);
+  }
+
+  return result;
+}
+
+}  // namespace vector_math
+}  // namespace media
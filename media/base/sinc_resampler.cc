@@ -72,6 +72,15 @@
 //
 // Note: we're glossing over how the sub-sample handling works with
 // |virtual_source_idx_|, etc.
+//
+// Fixed ratios:
+//
+// When the ratio reduces to a fraction input_step / phase_count with a small
+// enough phase_count, every output frame lies at one of phase_count sub-sample
+// offsets.  We precompute the kernel for each of them (a polyphase filter
+// bank) and step through the offsets with integer arithmetic, which needs one
+// convolution per output frame instead of two, and is exact rather than an
+// interpolation between neighboring kernels.
 
 // MSVC++ requires this to be set before any other includes to get M_PI.
 #define _USE_MATH_DEFINES
@@ -106,33 +115,92 @@ static double SincScaleFactor(double io_ratio) {
   return sinc_scale_factor;
 }
 
+// Finds the smallest |phase_count| no larger than kMaxPolyphaseCount for which
+// |io_ratio| * |phase_count| is an integer, returned in |input_step|.
+static bool FindPolyphaseFraction(double io_ratio,
+                                  int* input_step,
+                                  int* phase_count) {
+  // Sample rates are integers, so a ratio of two of them is only off from the
+  // exact fraction by rounding.
+  static const double kEpsilon = 1e-9;
+  for (int i = 1; i <= SincResampler::kMaxPolyphaseCount; ++i) {
+    const double step = io_ratio * i;
+    const double rounded_step = floor(step + 0.5);
+    if (rounded_step >= 1 && fabs(step - rounded_step) < kEpsilon * step) {
+      *input_step = static_cast<int>(rounded_step);
+      *phase_count = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+SincResampler::PolyphaseKernels::PolyphaseKernels(int input_step,
+                                                  int phase_count)
+    : input_step_(input_step),
+      phase_count_(phase_count),
+      kernels_(static_cast<float*>(base::AlignedAlloc(
+          sizeof(float) * kKernelSize * phase_count, 16))) {
+  // Blackman window parameters.
+  static const double kAlpha = 0.16;
+  static const double kA0 = 0.5 * (1.0 - kAlpha);
+  static const double kA1 = 0.5;
+  static const double kA2 = 0.5 * kAlpha;
+
+  const double sinc_scale_factor =
+      SincScaleFactor(static_cast<double>(input_step) / phase_count);
+  for (int phase = 0; phase < phase_count; ++phase) {
+    const double subsample_offset = static_cast<double>(phase) / phase_count;
+    float* const kernel = kernels_.get() + phase * kKernelSize;
+    for (int i = 0; i < kKernelSize; ++i) {
+      const double pre_sinc = M_PI * (i - kKernelSize / 2 - subsample_offset);
+      const double x = (i - subsample_offset) / kKernelSize;
+      const double window =
+          kA0 - kA1 * cos(2.0 * M_PI * x) + kA2 * cos(4.0 * M_PI * x);
+      kernel[i] = pre_sinc == 0 ?
+          sinc_scale_factor * window :
+          window * sin(sinc_scale_factor * pre_sinc) / pre_sinc;
+    }
+  }
+}
+
+SincResampler::PolyphaseKernels::~PolyphaseKernels() {}
+
 // If we know the minimum architecture at compile time, avoid CPU detection.
 // Force NaCl code to use C routines since (at present) nothing there uses these
 // methods and plumbing the -msse built library is non-trivial.
 #if defined(ARCH_CPU_X86_FAMILY) && !defined(OS_NACL)
 #if defined(__SSE__)
 #define CONVOLVE_FUNC Convolve_SSE
+#define CONVOLVE_SINGLE_FUNC ConvolveSingle_SSE
 void SincResampler::InitializeCPUSpecificFeatures() {}
 #else
 // X86 CPU detection required.  Functions will be set by
 // InitializeCPUSpecificFeatures().
 // TODO(dalecurtis): Once Chrome moves to an SSE baseline this can be removed.
 #define CONVOLVE_FUNC g_convolve_proc_
+#define CONVOLVE_SINGLE_FUNC g_convolve_single_proc_
 
 typedef float (*ConvolveProc)(const float*, const float*, const float*, double);
 static ConvolveProc g_convolve_proc_ = NULL;
+typedef float (*ConvolveSingleProc)(const float*, const float*);
+static ConvolveSingleProc g_convolve_single_proc_ = NULL;
 
 void SincResampler::InitializeCPUSpecificFeatures() {
   CHECK(!g_convolve_proc_);
-  g_convolve_proc_ = base::CPU().has_sse() ? Convolve_SSE : Convolve_C;
+  const bool has_sse = base::CPU().has_sse();
+  g_convolve_proc_ = has_sse ? Convolve_SSE : Convolve_C;
+  g_convolve_single_proc_ = has_sse ? ConvolveSingle_SSE : ConvolveSingle_C;
 }
 #endif
 #elif defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
 #define CONVOLVE_FUNC Convolve_NEON
+#define CONVOLVE_SINGLE_FUNC ConvolveSingle_NEON
 void SincResampler::InitializeCPUSpecificFeatures() {}
 #else
 // Unknown architecture.
 #define CONVOLVE_FUNC Convolve_C
+#define CONVOLVE_SINGLE_FUNC ConvolveSingle_C
 void SincResampler::InitializeCPUSpecificFeatures() {}
 #endif
 
@@ -168,6 +236,7 @@ SincResampler::SincResampler(double io_sample_rate_ratio,
          sizeof(*kernel_window_storage_.get()) * kKernelStorageSize);
 
   InitializeKernel();
+  InitializePolyphaseKernels();
 }
 
 SincResampler::~SincResampler() {
@@ -228,6 +297,23 @@ void SincResampler::InitializeKernel() {
   }
 }
 
+void SincResampler::InitializePolyphaseKernels() {
+  int input_step, phase_count;
+  if (!FindPolyphaseFraction(io_sample_rate_ratio_, &input_step,
+                             &phase_count)) {
+    polyphase_kernels_ = NULL;
+    return;
+  }
+
+  // Kernels shared with other resamplers may already be the right ones.
+  if (polyphase_kernels_.get() &&
+      polyphase_kernels_->input_step() == input_step &&
+      polyphase_kernels_->phase_count() == phase_count) {
+    return;
+  }
+  polyphase_kernels_ = new PolyphaseKernels(input_step, phase_count);
+}
+
 void SincResampler::SetRatio(double io_sample_rate_ratio) {
   if (fabs(io_sample_rate_ratio_ - io_sample_rate_ratio) <
       std::numeric_limits<double>::epsilon()) {
@@ -253,6 +339,13 @@ void SincResampler::SetRatio(double io_sample_rate_ratio) {
       }
     }
   }
+
+  InitializePolyphaseKernels();
+}
+
+void SincResampler::ShareKernelsWith(const SincResampler& other) {
+  DCHECK_EQ(io_sample_rate_ratio_, other.io_sample_rate_ratio_);
+  polyphase_kernels_ = other.polyphase_kernels_;
 }
 
 void SincResampler::Resample(int frames, float* destination) {
@@ -270,6 +363,47 @@ void SincResampler::Resample(int frames, float* destination) {
   // actually has an impact on ARM performance.  See inner loop comment below.
   const double current_io_ratio = io_sample_rate_ratio_;
   const float* const kernel_ptr = kernel_storage_.get();
+  while (remaining_frames && polyphase_kernels_.get()) {
+    // Step through the phases of the fixed ratio exactly.  Only the sub-sample
+    // offset of |virtual_source_idx_| is kept between calls, from which the
+    // phase is recovered by rounding.
+    const PolyphaseKernels* const kernels = polyphase_kernels_.get();
+    const int phase_count = kernels->phase_count();
+    const int source_step = kernels->input_step() / phase_count;
+    const int phase_step = kernels->input_step() % phase_count;
+    int source_idx = virtual_source_idx_;
+    int phase = static_cast<int>(
+        (virtual_source_idx_ - source_idx) * phase_count + 0.5);
+    if (phase == phase_count) {
+      phase = 0;
+      ++source_idx;
+    }
+
+    while (source_idx < block_size_ && remaining_frames) {
+      *destination++ =
+          CONVOLVE_SINGLE_FUNC(r1_ + source_idx, kernels->kernel(phase));
+      source_idx += source_step;
+      phase += phase_step;
+      if (phase >= phase_count) {
+        phase -= phase_count;
+        ++source_idx;
+      }
+      --remaining_frames;
+    }
+    virtual_source_idx_ =
+        source_idx + static_cast<double>(phase) / phase_count;
+    if (!remaining_frames)
+      break;
+
+    // Wrap back around to the start and refresh the buffer, as below.
+    DCHECK_GE(virtual_source_idx_, block_size_);
+    virtual_source_idx_ -= block_size_;
+    memcpy(r1_, r3_, sizeof(*input_buffer_.get()) * kKernelSize);
+    if (r0_ == r2_)
+      UpdateRegions(true);
+    read_cb_.Run(request_frames_, r0_);
+  }
+
   while (remaining_frames) {
     // Note: The loop construct here can severely impact performance on ARM
     // or when built with clang.  See https://codereview.chromium.org/18566009/
@@ -332,6 +466,7 @@ void SincResampler::Resample(int frames, float* destination) {
 }
 
 #undef CONVOLVE_FUNC
+#undef CONVOLVE_SINGLE_FUNC
 
 int SincResampler::ChunkSize() const {
   return block_size_ / io_sample_rate_ratio_;
@@ -365,6 +500,14 @@ float SincResampler::Convolve_C(const float* input_ptr, const float* k1,
       + kernel_interpolation_factor * sum2;
 }
 
+float SincResampler::ConvolveSingle_C(const float* input_ptr, const float* k) {
+  float sum = 0;
+  int n = kKernelSize;
+  while (n--)
+    sum += *input_ptr++ * *k++;
+  return sum;
+}
+
 #if defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
 float SincResampler::Convolve_NEON(const float* input_ptr, const float* k1,
                                    const float* k2,
@@ -392,6 +535,18 @@ float SincResampler::Convolve_NEON(const float* input_ptr, const float* k1,
   float32x2_t m_half = vadd_f32(vget_high_f32(m_sums1), vget_low_f32(m_sums1));
   return vget_lane_f32(vpadd_f32(m_half, m_half), 0);
 }
+
+float SincResampler::ConvolveSingle_NEON(const float* input_ptr,
+                                         const float* k) {
+  float32x4_t m_sums = vmovq_n_f32(0);
+  const float* upper = input_ptr + kKernelSize;
+  for (; input_ptr < upper; input_ptr += 4, k += 4)
+    m_sums = vmlaq_f32(m_sums, vld1q_f32(input_ptr), vld1q_f32(k));
+
+  // Sum components together.
+  float32x2_t m_half = vadd_f32(vget_high_f32(m_sums), vget_low_f32(m_sums));
+  return vget_lane_f32(vpadd_f32(m_half, m_half), 0);
+}
 #endif
 
 }  // namespace media
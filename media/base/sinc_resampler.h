@@ -9,6 +9,7 @@
 #include "base/callback.h"
 #include "base/gtest_prod_util.h"
 #include "base/memory/aligned_memory.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "build/build_config.h"
 #include "media/base/media_export.h"
@@ -33,6 +34,12 @@ class MEDIA_EXPORT SincResampler {
     // at the expense of allocating more memory.
     kKernelOffsetCount = 32,
     kKernelStorageSize = kKernelSize * (kKernelOffsetCount + 1),
+
+    // Ratios which reduce to a fraction with at most this many output frames
+    // per cycle (e.g., 44.1kHz -> 48kHz is 147 / 160) get one precomputed
+    // kernel per output phase, which avoids interpolating between kernels.
+    // 441 covers conversions to 44.1kHz; larger values cost more memory.
+    kMaxPolyphaseCount = 441,
   };
 
   // Selects runtime specific CPU features like SSE.  Must be called before
@@ -71,13 +78,50 @@ class MEDIA_EXPORT SincResampler {
   // Resample() is in progress.
   void SetRatio(double io_sample_rate_ratio);
 
+  // Makes this resampler use the precomputed kernels of |other|, which must
+  // have the same ratio, instead of its own.  Lets resamplers running in
+  // lockstep, such as the channels of a MultiChannelResampler, share a single
+  // filter bank in the cache.  Not thread safe, do not call while Resample()
+  // is in progress.
+  void ShareKernelsWith(const SincResampler& other);
+
   float* get_kernel_for_testing() { return kernel_storage_.get(); }
 
  private:
   FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, Convolve);
   FRIEND_TEST_ALL_PREFIXES(SincResamplerPerfTest, Convolve);
+  FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, Polyphase);
+
+  // One windowed sinc() kernel for each output phase of a fixed ratio, shared
+  // between resamplers via ShareKernelsWith().  See the .cc file.
+  class PolyphaseKernels : public base::RefCountedThreadSafe<PolyphaseKernels> {
+   public:
+    // Computes the kernels for the ratio |input_step| / |phase_count|, using
+    // the same windowed sinc() as InitializeKernel().
+    PolyphaseKernels(int input_step, int phase_count);
+
+    int input_step() const { return input_step_; }
+    int phase_count() const { return phase_count_; }
+
+    // The kernel for the output frame at sub-sample offset
+    // |phase| / phase_count(), 16-byte aligned.
+    const float* kernel(int phase) const {
+      return kernels_.get() + phase * kKernelSize;
+    }
+
+   private:
+    friend class base::RefCountedThreadSafe<PolyphaseKernels>;
+    ~PolyphaseKernels();
+
+    const int input_step_;
+    const int phase_count_;
+    scoped_ptr<float[], base::AlignedFreeDeleter> kernels_;
+
+    DISALLOW_COPY_AND_ASSIGN(PolyphaseKernels);
+  };
 
   void InitializeKernel();
+  void InitializePolyphaseKernels();
   void UpdateRegions(bool second_load);
 
   // Compute convolution of |k1| and |k2| over |input_ptr|, resultant sums are
@@ -96,6 +140,15 @@ class MEDIA_EXPORT SincResampler {
                              double kernel_interpolation_factor);
 #endif
 
+  // Compute the convolution of the single kernel |k| over |input_ptr|, for
+  // the polyphase kernels.  Implementations are chosen as for Convolve_*().
+  static float ConvolveSingle_C(const float* input_ptr, const float* k);
+#if defined(ARCH_CPU_X86_FAMILY)
+  static float ConvolveSingle_SSE(const float* input_ptr, const float* k);
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
+  static float ConvolveSingle_NEON(const float* input_ptr, const float* k);
+#endif
+
   // The ratio of input / output sample rates.
   double io_sample_rate_ratio_;
 
@@ -125,6 +178,10 @@ class MEDIA_EXPORT SincResampler {
   scoped_ptr<float[], base::AlignedFreeDeleter> kernel_pre_sinc_storage_;
   scoped_ptr<float[], base::AlignedFreeDeleter> kernel_window_storage_;
 
+  // Used instead of the kernels above when |io_sample_rate_ratio_| is a
+  // fraction with a small enough denominator, NULL otherwise.
+  scoped_refptr<PolyphaseKernels> polyphase_kernels_;
+
   // Data from the source is copied into this buffer for each processing pass.
   scoped_ptr<float[], base::AlignedFreeDeleter> input_buffer_;
 
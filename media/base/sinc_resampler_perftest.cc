@@ -18,9 +18,17 @@ static const int kBenchmarkIterations = 50000000;
 static const double kSampleRateRatio = 192000.0 / 44100.0;
 static const double kKernelInterpolationFactor = 0.5;
 
+static const int kResampleIterations = 20000;
+static const int kResampleFrames = 4800;
+
 // Helper function to provide no input to SincResampler's Convolve benchmark.
 static void DoNothing(int frames, float* destination) {}
 
+// Helper function to provide silence to SincResampler's Resample benchmark.
+static void ProvideSilence(int frames, float* destination) {
+  memset(destination, 0, sizeof(*destination) * frames);
+}
+
 // Define platform independent function name for Convolve* tests.
 #if defined(ARCH_CPU_X86_FAMILY)
 #define CONVOLVE_FUNC Convolve_SSE
@@ -73,4 +81,34 @@ TEST(SincResamplerPerfTest, Convolve) {
 
 #undef CONVOLVE_FUNC
 
+static void RunResampleBenchmark(double io_ratio,
+                                 const std::string& trace_name) {
+  SincResampler resampler(io_ratio,
+                          SincResampler::kDefaultRequestSize,
+                          base::Bind(&ProvideSilence));
+  scoped_ptr<float[]> destination(new float[kResampleFrames]);
+
+  base::TimeTicks start = base::TimeTicks::HighResNow();
+  for (int i = 0; i < kResampleIterations; ++i)
+    resampler.Resample(kResampleFrames, destination.get());
+  double total_time_milliseconds =
+      (base::TimeTicks::HighResNow() - start).InMillisecondsF();
+  perf_test::PrintResult("sinc_resampler_resample",
+                         "",
+                         trace_name,
+                         kResampleIterations / total_time_milliseconds,
+                         "runs/ms",
+                         true);
+}
+
+// Benchmark Resample() for a fixed ratio, which uses the precomputed polyphase
+// kernels, against an arbitrary ratio very close to it, which interpolates
+// between kernels instead.
+TEST(SincResamplerPerfTest, Resample) {
+  static const double kFixedRatio = 44100.0 / 48000.0;
+  RunResampleBenchmark(kFixedRatio, "polyphase_44100_to_48000");
+  RunResampleBenchmark(kFixedRatio * (1 + 1e-7),
+                       "interpolated_44100_to_48000");
+}
+
 } // namespace media
@@ -110,8 +110,10 @@ TEST(SincResamplerTest, DISABLED_SetRatioBench) {
 // Define platform independent function name for Convolve* tests.
 #if defined(ARCH_CPU_X86_FAMILY)
 #define CONVOLVE_FUNC Convolve_SSE
+#define CONVOLVE_SINGLE_FUNC ConvolveSingle_SSE
 #elif defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
 #define CONVOLVE_FUNC Convolve_NEON
+#define CONVOLVE_SINGLE_FUNC ConvolveSingle_NEON
 #endif
 
 // Ensure various optimized Convolve() methods return the same value.  Only run
@@ -153,9 +155,57 @@ TEST(SincResamplerTest, Convolve) {
       resampler.kernel_storage_.get() + 1, resampler.kernel_storage_.get(),
       resampler.kernel_storage_.get(), kKernelInterpolationFactor);
   EXPECT_NEAR(result2, result, kEpsilon);
+
+  // Test ConvolveSingle() w/ aligned and unaligned input pointers.
+  result = resampler.ConvolveSingle_C(
+      resampler.kernel_storage_.get(), resampler.kernel_storage_.get());
+  result2 = resampler.CONVOLVE_SINGLE_FUNC(
+      resampler.kernel_storage_.get(), resampler.kernel_storage_.get());
+  EXPECT_NEAR(result2, result, kEpsilon);
+  result = resampler.ConvolveSingle_C(
+      resampler.kernel_storage_.get() + 1, resampler.kernel_storage_.get());
+  result2 = resampler.CONVOLVE_SINGLE_FUNC(
+      resampler.kernel_storage_.get() + 1, resampler.kernel_storage_.get());
+  EXPECT_NEAR(result2, result, kEpsilon);
 }
 #endif
 
+#undef CONVOLVE_FUNC
+#undef CONVOLVE_SINGLE_FUNC
+
+// Test that fixed ratios get polyphase kernels, which match the interpolated
+// kernels at the offsets they have in common, and that others don't.
+TEST(SincResamplerTest, Polyphase) {
+  MockSource mock_source;
+  SincResampler resampler(
+      44100.0 / 48000.0, SincResampler::kDefaultRequestSize,
+      base::Bind(&MockSource::ProvideInput, base::Unretained(&mock_source)));
+  ASSERT_TRUE(resampler.polyphase_kernels_.get());
+  EXPECT_EQ(147, resampler.polyphase_kernels_->input_step());
+  EXPECT_EQ(160, resampler.polyphase_kernels_->phase_count());
+
+  // Phase 5 of 160 is offset 1 of SincResampler::kKernelOffsetCount.
+  for (int i = 0; i < SincResampler::kKernelSize; ++i) {
+    EXPECT_NEAR(resampler.kernel_storage_[i],
+                resampler.polyphase_kernels_->kernel(0)[i], 1e-6);
+    EXPECT_NEAR(resampler.kernel_storage_[SincResampler::kKernelSize + i],
+                resampler.polyphase_kernels_->kernel(5)[i], 1e-6);
+  }
+
+  resampler.SetRatio(M_PI);
+  EXPECT_FALSE(resampler.polyphase_kernels_.get());
+
+  // Channels of a MultiChannelResampler share their kernels.
+  resampler.SetRatio(48000.0 / 44100.0);
+  ASSERT_TRUE(resampler.polyphase_kernels_.get());
+  SincResampler other_resampler(
+      48000.0 / 44100.0, SincResampler::kDefaultRequestSize,
+      base::Bind(&MockSource::ProvideInput, base::Unretained(&mock_source)));
+  other_resampler.ShareKernelsWith(resampler);
+  EXPECT_EQ(resampler.polyphase_kernels_.get(),
+            other_resampler.polyphase_kernels_.get());
+}
+
 // Fake audio source for testing the resampler.  Generates a sinusoidal linear
 // chirp (http://en.wikipedia.org/wiki/Chirp) which can be tuned to stress the
 // resampler for the specific sample rate conversion being used.
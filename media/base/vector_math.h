@@ -15,7 +15,7 @@ namespace vector_math {
 // Required alignment for inputs and outputs to all vector math functions
 enum { kRequiredAlignment = 16 };
 
-// Selects runtime specific optimizations such as SSE.  Must be called prior to
+// Selects runtime specific optimizations such as AVX.  Must be called prior to
 // calling FMAC() or FMUL().  Called during media library initialization; most
 // users should never have to call this.
 MEDIA_EXPORT void Initialize();
@@ -107,6 +107,14 @@ TEST_F(VectorMathPerfTest, FMAC) {
   RunBenchmark(
       vector_math::FMAC_FUNC, true, "vector_math_fmac", "optimized_aligned");
 #endif
+#if defined(ARCH_CPU_X86_FAMILY)
+  if (base::CPU().has_avx()) {
+    RunBenchmark(
+        vector_math::FMAC_AVX, false, "vector_math_fmac", "avx_unaligned");
+    RunBenchmark(
+        vector_math::FMAC_AVX, true, "vector_math_fmac", "avx_aligned");
+  }
+#endif
 }
 
 #undef FMAC_FUNC
@@ -138,6 +146,14 @@ TEST_F(VectorMathPerfTest, FMUL) {
   RunBenchmark(
       vector_math::FMUL_FUNC, true, "vector_math_fmul", "optimized_aligned");
 #endif
+#if defined(ARCH_CPU_X86_FAMILY)
+  if (base::CPU().has_avx()) {
+    RunBenchmark(
+        vector_math::FMUL_AVX, false, "vector_math_fmul", "avx_unaligned");
+    RunBenchmark(
+        vector_math::FMUL_AVX, true, "vector_math_fmul", "avx_aligned");
+  }
+#endif
 }
 
 #undef FMUL_FUNC
@@ -174,6 +190,18 @@ TEST_F(VectorMathPerfTest, EWMAAndMaxPower) {
                "vector_math_ewma_and_max_power",
                "optimized_aligned");
 #endif
+#if defined(ARCH_CPU_X86_FAMILY)
+  if (base::CPU().has_avx()) {
+    RunBenchmark(vector_math::EWMAAndMaxPower_AVX,
+                 kVectorSize - 1,
+                 "vector_math_ewma_and_max_power",
+                 "avx_unaligned");
+    RunBenchmark(vector_math::EWMAAndMaxPower_AVX,
+                 kVectorSize,
+                 "vector_math_ewma_and_max_power",
+                 "avx_aligned");
+  }
+#endif
 }
 
 #undef EWMAAndMaxPower_FUNC
@@ -13,7 +13,8 @@ VideoDecoderConfig::VideoDecoderConfig()
     : codec_(kUnknownVideoCodec),
       profile_(VIDEO_CODEC_PROFILE_UNKNOWN),
       format_(VideoFrame::UNKNOWN),
-      is_encrypted_(false) {
+      is_encrypted_(false),
+      low_delay_(false) {
 }
 
 VideoDecoderConfig::VideoDecoderConfig(VideoCodec codec,
@@ -24,7 +25,8 @@ VideoDecoderConfig::VideoDecoderConfig(VideoCodec codec,
                                        const gfx::Size& natural_size,
                                        const uint8* extra_data,
                                        size_t extra_data_size,
-                                       bool is_encrypted) {
+                                       bool is_encrypted)
+    : low_delay_(false) {
   Initialize(codec, profile, format, coded_size, visible_rect, natural_size,
              extra_data, extra_data_size, is_encrypted, true);
 }
@@ -108,7 +110,8 @@ bool VideoDecoderConfig::Matches(const VideoDecoderConfig& config) const {
           (extra_data_size() == config.extra_data_size()) &&
           (!extra_data() || !memcmp(extra_data(), config.extra_data(),
                                     extra_data_size())) &&
-          (is_encrypted() == config.is_encrypted()));
+          (is_encrypted() == config.is_encrypted()) &&
+          (low_delay() == config.low_delay()));
 }
 
 std::string VideoDecoderConfig::AsHumanReadableString() const {
@@ -125,7 +128,8 @@ std::string VideoDecoderConfig::AsHumanReadableString() const {
     << " natural size: [" << natural_size().width()
     << "," << natural_size().height() << "]"
     << " has extra data? " << (extra_data() ? "true" : "false")
-    << " encrypted? " << (is_encrypted() ? "true" : "false");
+    << " encrypted? " << (is_encrypted() ? "true" : "false")
+    << " low delay? " << (low_delay() ? "true" : "false");
   return s.str();
 }
 
@@ -167,4 +171,12 @@ bool VideoDecoderConfig::is_encrypted() const {
   return is_encrypted_;
 }
 
+bool VideoDecoderConfig::low_delay() const {
+  return low_delay_;
+}
+
+void VideoDecoderConfig::set_low_delay(bool low_delay) {
+  low_delay_ = low_delay;
+}
+
 }  // namespace media
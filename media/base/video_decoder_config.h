@@ -135,6 +135,12 @@ class MEDIA_EXPORT VideoDecoderConfig {
   // can be encrypted or not encrypted.
   bool is_encrypted() const;
 
+  // Whether the stream is latency sensitive, e.g. a real-time communication
+  // stream, so decoders should avoid buffering frames internally.  Defaults to
+  // false.
+  bool low_delay() const;
+  void set_low_delay(bool low_delay);
+
  private:
   VideoCodec codec_;
   VideoCodecProfile profile_;
@@ -149,6 +155,8 @@ class MEDIA_EXPORT VideoDecoderConfig {
 
   bool is_encrypted_;
 
+  bool low_delay_;
+
   // Not using DISALLOW_COPY_AND_ASSIGN here intentionally to allow the compiler
   // generated copy constructor and assignment operator. Since the extra data is
   // typically small, the performance impact is minimal.
@@ -149,6 +149,23 @@ class MEDIA_EXPORT VideoFrame : public base::RefCountedThreadSafe<VideoFrame> {
       base::TimeDelta timestamp,
       const base::Closure& no_longer_needed_cb);
 
+  // Same as WrapExternalYuvData() but for YV12A frames, whose alpha plane is
+  // given by |a_stride| and |a_data|.
+  static scoped_refptr<VideoFrame> WrapExternalYuvaData(
+      const gfx::Size& coded_size,
+      const gfx::Rect& visible_rect,
+      const gfx::Size& natural_size,
+      int32 y_stride,
+      int32 u_stride,
+      int32 v_stride,
+      int32 a_stride,
+      uint8* y_data,
+      uint8* u_data,
+      uint8* v_data,
+      uint8* a_data,
+      base::TimeDelta timestamp,
+      const base::Closure& no_longer_needed_cb);
+
   // Wraps |frame| and calls |no_longer_needed_cb| when the wrapper VideoFrame
   // gets destroyed. |visible_rect| must be a sub rect within
   // frame->visible_rect().
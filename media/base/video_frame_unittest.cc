@@ -236,6 +236,35 @@ TEST(VideoFrame, WrapVideoFrame) {
   EXPECT_TRUE(no_longer_needed_triggered);
 }
 
+static void SetTrueCallback(bool* called) {
+  *called = true;
+}
+
+TEST(VideoFrame, WrapExternalYuvaData) {
+  const int kWidth = 4;
+  const int kHeight = 4;
+  const gfx::Size size(kWidth, kHeight);
+  uint8 y_data[kWidth * kHeight];
+  uint8 u_data[kWidth * kHeight / 4];
+  uint8 v_data[kWidth * kHeight / 4];
+  uint8 a_data[kWidth * kHeight];
+  bool no_longer_needed_called = false;
+  {
+    scoped_refptr<VideoFrame> frame = VideoFrame::WrapExternalYuvaData(
+        size, gfx::Rect(size), size, kWidth, kWidth / 2, kWidth / 2, kWidth,
+        y_data, u_data, v_data, a_data, base::TimeDelta(),
+        base::Bind(&SetTrueCallback, &no_longer_needed_called));
+    EXPECT_EQ(VideoFrame::YV12A, frame->format());
+    EXPECT_EQ(y_data, frame->data(VideoFrame::kYPlane));
+    EXPECT_EQ(u_data, frame->data(VideoFrame::kUPlane));
+    EXPECT_EQ(v_data, frame->data(VideoFrame::kVPlane));
+    EXPECT_EQ(a_data, frame->data(VideoFrame::kAPlane));
+    EXPECT_EQ(kWidth, frame->stride(VideoFrame::kAPlane));
+    EXPECT_FALSE(no_longer_needed_called);
+  }
+  EXPECT_TRUE(no_longer_needed_called);
+}
+
 // Ensure each frame is properly sized and allocated.  Will trigger OOB reads
 // and writes as well as incorrect frame hashes otherwise.
 TEST(VideoFrame, CheckFrameExtents) {
@@ -60,7 +60,12 @@ void PacedSender::RegisterVideoSsrc(uint32 video_ssrc) {
 }
 
 bool PacedSender::SendPackets(const PacketList& packets) {
-  return SendPacketsToTransport(packets, &packet_list_, false);
+  // A list of packets always belongs to a single frame, and so to a single
+  // stream.
+  PacketList* packet_list = &video_packet_list_;
+  if (!packets.empty() && GetSsrc(packets.front()) == audio_ssrc_)
+    packet_list = &audio_packet_list_;
+  return SendPacketsToTransport(packets, packet_list, false);
 }
 
 bool PacedSender::ResendPackets(const PacketList& packets) {
@@ -72,7 +77,7 @@ bool PacedSender::SendPacketsToTransport(const PacketList& packets,
                                          bool retransmit) {
   UpdateBurstSize(packets.size());
 
-  if (!packets_not_sent->empty()) {
+  if (HasPacketsQueuedAhead(packets_not_sent)) {
     packets_not_sent->insert(
         packets_not_sent->end(), packets.begin(), packets.end());
     return true;
@@ -130,51 +135,60 @@ void PacedSender::SendNextPacketBurst() {
   ScheduleNextSend();
 }
 
-void PacedSender::SendStoredPackets() {
-  if (packet_list_.empty() && resend_packet_list_.empty())
-    return;
+bool PacedSender::HasPacketsQueuedAhead(const PacketList* packet_list) const {
+  if (!resend_packet_list_.empty())
+    return true;
+  if (packet_list == &resend_packet_list_)
+    return false;
+  if (!audio_packet_list_.empty())
+    return true;
+  if (packet_list == &audio_packet_list_)
+    return false;
+  return !video_packet_list_.empty();
+}
 
-  size_t packets_to_send = burst_size_;
-  PacketList packets_to_resend;
+void PacedSender::DequeuePackets(PacketList* packet_list,
+                                 bool retransmit,
+                                 size_t max_packets,
+                                 PacketList* packets_to_send) {
+  PacketList::iterator it = packet_list->begin();
+  std::advance(it, std::min(max_packets, packet_list->size()));
 
-  // Send our re-send packets first.
-  if (!resend_packet_list_.empty()) {
-    PacketList::iterator it = resend_packet_list_.begin();
-    size_t packets_to_send_now =
-        std::min(packets_to_send, resend_packet_list_.size());
-    std::advance(it, packets_to_send_now);
-
-    for (PacketList::iterator log_it = resend_packet_list_.begin();
-         log_it != it;
-         ++log_it) {
-      LogPacketEvent(*log_it, true);
-    }
-    packets_to_resend.insert(
-        packets_to_resend.begin(), resend_packet_list_.begin(), it);
-    resend_packet_list_.erase(resend_packet_list_.begin(), it);
-    packets_to_send -= packets_to_resend.size();
+  for (PacketList::iterator log_it = packet_list->begin(); log_it != it;
+       ++log_it) {
+    LogPacketEvent(*log_it, retransmit);
   }
-  if (!packet_list_.empty() && packets_to_send > 0) {
-    PacketList::iterator it = packet_list_.begin();
-    size_t packets_to_send_now = std::min(packets_to_send, packet_list_.size());
-    std::advance(it, packets_to_send_now);
-
-    for (PacketList::iterator log_it = packet_list_.begin(); log_it != it;
-         ++log_it) {
-      LogPacketEvent(*log_it, false);
-    }
-
-    packets_to_resend.insert(packets_to_resend.end(), packet_list_.begin(), it);
-    packet_list_.erase(packet_list_.begin(), it);
-
-    if (packet_list_.empty()) {
-      burst_size_ = 1;  // Reset burst size after we sent the last stored packet
-      packets_sent_in_burst_ = 0;
-    } else {
-      packets_sent_in_burst_ = packets_to_resend.size();
-    }
+
+  packets_to_send->insert(packets_to_send->end(), packet_list->begin(), it);
+  packet_list->erase(packet_list->begin(), it);
+}
+
+void PacedSender::SendStoredPackets() {
+  if (resend_packet_list_.empty() && audio_packet_list_.empty() &&
+      video_packet_list_.empty()) {
+    return;
   }
-  TransmitPackets(packets_to_resend);
+
+  // Drain the lanes in order of priority.
+  PacketList packets_to_send;
+  DequeuePackets(&resend_packet_list_, true, burst_size_, &packets_to_send);
+  DequeuePackets(&audio_packet_list_,
+                 false,
+                 burst_size_ - packets_to_send.size(),
+                 &packets_to_send);
+  DequeuePackets(&video_packet_list_,
+                 false,
+                 burst_size_ - packets_to_send.size(),
+                 &packets_to_send);
+
+  if (resend_packet_list_.empty() && audio_packet_list_.empty() &&
+      video_packet_list_.empty()) {
+    burst_size_ = 1;  // Reset burst size after we sent the last stored packet
+    packets_sent_in_burst_ = 0;
+  } else {
+    packets_sent_in_burst_ = packets_to_send.size();
+  }
+  TransmitPackets(packets_to_send);
 }
 
 bool PacedSender::TransmitPackets(const PacketList& packets) {
@@ -187,21 +201,29 @@ bool PacedSender::TransmitPackets(const PacketList& packets) {
 
 void PacedSender::UpdateBurstSize(size_t packets_to_send) {
   packets_to_send = std::max(packets_to_send,
-                             resend_packet_list_.size() + packet_list_.size());
+                             resend_packet_list_.size() +
+                                 audio_packet_list_.size() +
+                                 video_packet_list_.size());
 
   packets_to_send += (kPacingMaxBurstsPerFrame - 1);  // Round up.
   burst_size_ =
       std::max(packets_to_send / kPacingMaxBurstsPerFrame, burst_size_);
 }
 
-void PacedSender::LogPacketEvent(const Packet& packet, bool retransmit) {
-  // Get SSRC from packet and compare with the audio_ssrc / video_ssrc to see
-  // if the packet is audio or video.
+// static
+uint32 PacedSender::GetSsrc(const Packet& packet) {
   DCHECK_GE(packet.size(), 12u);
   base::BigEndianReader reader(reinterpret_cast<const char*>(&packet[8]), 4);
   uint32 ssrc;
   bool success = reader.ReadU32(&ssrc);
   DCHECK(success);
+  return ssrc;
+}
+
+void PacedSender::LogPacketEvent(const Packet& packet, bool retransmit) {
+  // Get SSRC from packet and compare with the audio_ssrc / video_ssrc to see
+  // if the packet is audio or video.
+  uint32 ssrc = GetSsrc(packet);
   bool is_audio;
   if (ssrc == audio_ssrc_) {
     is_audio = true;
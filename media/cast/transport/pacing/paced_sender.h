@@ -77,11 +77,25 @@ class PacedSender : public PacedPacketSender,
                               PacketList* packets_not_sent,
                               bool retransmit);
 
+  // Returns true if packets headed for |packet_list| have to wait for the
+  // packets already stored in it or in a lane of higher priority.
+  bool HasPacketsQueuedAhead(const PacketList* packet_list) const;
+
+  // Moves up to |max_packets| packets from the front of |packet_list| to the
+  // end of |packets_to_send|, logging each of them.
+  void DequeuePackets(PacketList* packet_list,
+                      bool retransmit,
+                      size_t max_packets,
+                      PacketList* packets_to_send);
+
   // Actually sends the packets to the transport.
   bool TransmitPackets(const PacketList& packets);
   void SendStoredPackets();
   void UpdateBurstSize(size_t num_of_packets);
 
+  // Reads the SSRC from the RTP header of |packet|.
+  static uint32 GetSsrc(const Packet& packet);
+
   void LogPacketEvent(const Packet& packet, bool retransmit);
 
   base::TickClock* const clock_;  // Not owned by this class.
@@ -93,10 +107,13 @@ class PacedSender : public PacedPacketSender,
   size_t burst_size_;
   size_t packets_sent_in_burst_;
   base::TimeTicks time_last_process_;
-  // Note: We can't combine the |packet_list_| and the |resend_packet_list_|
-  // since then we might get reordering of the retransmitted packets.
-  PacketList packet_list_;
+  // Packets are stored in one lane per priority: retransmissions first, then
+  // audio, which is small and the most sensitive to delay, then video.
+  // Note: We can't combine the lanes since then we might get reordering of
+  // the retransmitted packets.
   PacketList resend_packet_list_;
+  PacketList audio_packet_list_;
+  PacketList video_packet_list_;
 
   // NOTE: Weak pointers must be invalidated before all other member variables.
   base::WeakPtrFactory<PacedSender> weak_factory_;
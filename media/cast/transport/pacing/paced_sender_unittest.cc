@@ -200,24 +200,22 @@ TEST_F(PacedSenderTest, PaceWithNack) {
   testing_clock_.Advance(timeout);
   task_runner_->RunTasks();
 
-  // End of NACK plus a packet from the oldest frame.
+  // End of NACK.
   mock_transport_.AddExpectedSize(kNackSize, 6);
-  mock_transport_.AddExpectedSize(kSize1, 1);
   testing_clock_.Advance(timeout);
   task_runner_->RunTasks();
 
-  // Add second frame.
-  // Make sure we don't delay the second frame due to the previous packets.
+  // Add second frame, which is audio.
   EXPECT_TRUE(paced_sender_->SendPackets(second_frame_packets));
 
-  // Last packets of frame 1 and the first packets of frame 2.
-  mock_transport_.AddExpectedSize(kSize1, 5);
-  mock_transport_.AddExpectedSize(kSize2, 2);
+  // The audio frame goes out ahead of the packets of frame 1 that are still
+  // queued.
+  mock_transport_.AddExpectedSize(kSize2, 9);
   testing_clock_.Advance(timeout);
   task_runner_->RunTasks();
 
-  // Last packets of frame 2.
-  mock_transport_.AddExpectedSize(kSize2, 7);
+  // Last packets of frame 1.
+  mock_transport_.AddExpectedSize(kSize1, 6);
   testing_clock_.Advance(timeout);
   task_runner_->RunTasks();
 
@@ -254,6 +252,32 @@ TEST_F(PacedSenderTest, PaceWithNack) {
             video_retransmitted_event_count);
 }
 
+TEST_F(PacedSenderTest, AudioAheadOfQueuedVideo) {
+  PacketList video_packets = CreatePacketList(kSize1, 9, false);
+  PacketList audio_packets = CreatePacketList(kSize2, 1, true);
+
+  mock_transport_.AddExpectedSize(kSize1, 3);
+  EXPECT_TRUE(paced_sender_->SendPackets(video_packets));
+
+  base::TimeDelta timeout = base::TimeDelta::FromMilliseconds(10);
+  mock_transport_.AddExpectedSize(kSize1, 3);
+  testing_clock_.Advance(timeout);
+  task_runner_->RunTasks();
+
+  // The burst is used up, so the audio packet is stored, but it goes out
+  // before the video packets that were queued first.
+  EXPECT_TRUE(paced_sender_->SendPackets(audio_packets));
+  EXPECT_TRUE(mock_transport_.expected_packet_size_.empty());
+
+  mock_transport_.AddExpectedSize(kSize2, 1);
+  mock_transport_.AddExpectedSize(kSize1, 2);
+  testing_clock_.Advance(timeout);
+  task_runner_->RunTasks();
+
+  mock_transport_.AddExpectedSize(kSize1, 1);
+  EXPECT_TRUE(RunUntilEmpty(3));
+}
+
 TEST_F(PacedSenderTest, PaceWith60fps) {
   // Testing what happen when we get multiple NACK requests for a fully lost
   // frames just as we sent the first packets in a frame.
@@ -4,12 +4,24 @@
 
 #include "media/filters/blocking_url_protocol.h"
 
+#include <string.h>
+
+#include <algorithm>
+
 #include "base/bind.h"
 #include "media/base/data_source.h"
 #include "media/ffmpeg/ffmpeg_common.h"
 
 namespace media {
 
+// Bounds of the read-ahead window. The lower one is twice the size of
+// FFmpegGlue's AVIO buffer, the upper one keeps a single blocking read short
+// on slow connections.
+enum {
+  kMinReadAheadSize = 64 * 1024,
+  kMaxReadAheadSize = 512 * 1024
+};
+
 BlockingUrlProtocol::BlockingUrlProtocol(
     DataSource* data_source,
     const base::Closure& error_cb)
@@ -18,7 +30,11 @@ BlockingUrlProtocol::BlockingUrlProtocol(
       aborted_(true, false),  // We never want to reset |aborted_|.
       read_complete_(false, false),
       last_read_bytes_(0),
-      read_position_(0) {
+      read_position_(0),
+      read_ahead_position_(0),
+      read_ahead_bytes_(0),
+      read_ahead_size_(kMinReadAheadSize),
+      max_read_ahead_size_(kMaxReadAheadSize) {
 }
 
 BlockingUrlProtocol::~BlockingUrlProtocol() {}
@@ -27,6 +43,15 @@ void BlockingUrlProtocol::Abort() {
   aborted_.Signal();
 }
 
+void BlockingUrlProtocol::SetBitrate(int bitrate) {
+  if (bitrate <= 0)
+    return;
+  max_read_ahead_size_ = std::max(
+      static_cast<int>(kMinReadAheadSize),
+      std::min(bitrate / 8, static_cast<int>(kMaxReadAheadSize)));
+  read_ahead_size_ = std::min(read_ahead_size_, max_read_ahead_size_);
+}
+
 int BlockingUrlProtocol::Read(int size, uint8* data) {
   // Read errors are unrecoverable.
   if (aborted_.IsSignaled())
@@ -38,26 +63,40 @@ int BlockingUrlProtocol::Read(int size, uint8* data) {
   if (data_source_->GetSize(&file_size) && read_position_ >= file_size)
     return 0;
 
-  // Blocking read from data source until either:
-  //   1) |last_read_bytes_| is set and |read_complete_| is signalled
-  //   2) |aborted_| is signalled
-  data_source_->Read(read_position_, size, data, base::Bind(
-      &BlockingUrlProtocol::SignalReadCompleted, base::Unretained(this)));
-
-  base::WaitableEvent* events[] = { &aborted_, &read_complete_ };
-  size_t index = base::WaitableEvent::WaitMany(events, arraysize(events));
-
-  if (events[index] == &aborted_)
-    return AVERROR(EIO);
-
-  if (last_read_bytes_ == DataSource::kReadError) {
-    aborted_.Signal();
-    error_cb_.Run();
-    return AVERROR(EIO);
+  const int64 read_ahead_end = read_ahead_position_ + read_ahead_bytes_;
+  if (read_position_ < read_ahead_position_ ||
+      read_position_ >= read_ahead_end) {
+    // Widen the window while FFmpeg reads sequentially, and go back to the
+    // smallest one once it seeks elsewhere.
+    if (read_ahead_bytes_ > 0 && read_position_ == read_ahead_end) {
+      read_ahead_size_ = std::min(read_ahead_size_ * 2, max_read_ahead_size_);
+    } else {
+      read_ahead_size_ = kMinReadAheadSize;
+    }
+
+    if (size >= read_ahead_size_ || data_source_->IsStreaming()) {
+      int bytes_read = ReadFromDataSource(read_position_, size, data);
+      if (bytes_read > 0)
+        read_position_ += bytes_read;
+      return bytes_read;
+    }
+
+    if (!read_ahead_buffer_)
+      read_ahead_buffer_.reset(new uint8[kMaxReadAheadSize]);
+    read_ahead_position_ = read_position_;
+    read_ahead_bytes_ = 0;
+    int bytes_read = ReadFromDataSource(
+        read_position_, read_ahead_size_, read_ahead_buffer_.get());
+    if (bytes_read <= 0)
+      return bytes_read;
+    read_ahead_bytes_ = bytes_read;
   }
 
-  read_position_ += last_read_bytes_;
-  return last_read_bytes_;
+  const int offset = read_position_ - read_ahead_position_;
+  const int bytes_copied = std::min(size, read_ahead_bytes_ - offset);
+  memcpy(data, read_ahead_buffer_.get() + offset, bytes_copied);
+  read_position_ += bytes_copied;
+  return bytes_copied;
 }
 
 bool BlockingUrlProtocol::GetPosition(int64* position_out) {
@@ -84,6 +123,29 @@ bool BlockingUrlProtocol::IsStreaming() {
   return data_source_->IsStreaming();
 }
 
+int BlockingUrlProtocol::ReadFromDataSource(int64 position, int size,
+                                            uint8* data) {
+  // Blocking read from data source until either:
+  //   1) |last_read_bytes_| is set and |read_complete_| is signalled
+  //   2) |aborted_| is signalled
+  data_source_->Read(position, size, data, base::Bind(
+      &BlockingUrlProtocol::SignalReadCompleted, base::Unretained(this)));
+
+  base::WaitableEvent* events[] = { &aborted_, &read_complete_ };
+  size_t index = base::WaitableEvent::WaitMany(events, arraysize(events));
+
+  if (events[index] == &aborted_)
+    return AVERROR(EIO);
+
+  if (last_read_bytes_ == DataSource::kReadError) {
+    aborted_.Signal();
+    error_cb_.Run();
+    return AVERROR(EIO);
+  }
+
+  return last_read_bytes_;
+}
+
 void BlockingUrlProtocol::SignalReadCompleted(int size) {
   last_read_bytes_ = size;
   read_complete_.Signal();
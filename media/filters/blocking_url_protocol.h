@@ -7,6 +7,7 @@
 
 #include "base/basictypes.h"
 #include "base/callback.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/synchronization/waitable_event.h"
 #include "media/filters/ffmpeg_glue.h"
 
@@ -16,6 +17,12 @@ class DataSource;
 
 // An implementation of FFmpegURLProtocol that blocks until the underlying
 // asynchronous DataSource::Read() operation completes.
+//
+// To save a round trip to |data_source_| for every small read FFmpeg makes,
+// sequential reads are served from a read-ahead buffer. Its window doubles
+// with each sequential miss, up to about a second of media once the bitrate is
+// known, and shrinks back after a seek. Streaming sources, which may not have
+// the data after the requested range yet, are always read directly.
 class MEDIA_EXPORT BlockingUrlProtocol : public FFmpegURLProtocol {
  public:
   // Implements FFmpegURLProtocol using the given |data_source|. |error_cb| is
@@ -30,6 +37,10 @@ class MEDIA_EXPORT BlockingUrlProtocol : public FFmpegURLProtocol {
   // returns all subsequent calls to Read() will immediately fail.
   void Abort();
 
+  // Limits the read-ahead window to about one second of media at |bitrate|
+  // bits per second. Must not be called while a Read() is in progress.
+  void SetBitrate(int bitrate);
+
   // FFmpegURLProtocol implementation.
   virtual int Read(int size, uint8* data) OVERRIDE;
   virtual bool GetPosition(int64* position_out) OVERRIDE;
@@ -38,6 +49,10 @@ class MEDIA_EXPORT BlockingUrlProtocol : public FFmpegURLProtocol {
   virtual bool IsStreaming() OVERRIDE;
 
  private:
+  // Blocks on a DataSource::Read() of |size| bytes at |position| into |data|.
+  // Returns the number of bytes read or AVERROR(EIO) on failure.
+  int ReadFromDataSource(int64 position, int size, uint8* data);
+
   // Sets |last_read_bytes_| and signals the blocked thread that the read
   // has completed.
   void SignalReadCompleted(int size);
@@ -55,6 +70,16 @@ class MEDIA_EXPORT BlockingUrlProtocol : public FFmpegURLProtocol {
   // Cached position within the data source.
   int64 read_position_;
 
+  // Read-ahead buffer holding |read_ahead_bytes_| bytes of the data source
+  // starting at |read_ahead_position_|, and the size of the next read into it.
+  scoped_ptr<uint8[]> read_ahead_buffer_;
+  int64 read_ahead_position_;
+  int read_ahead_bytes_;
+  int read_ahead_size_;
+
+  // Largest |read_ahead_size_| allowed by the bitrate of the media.
+  int max_read_ahead_size_;
+
   DISALLOW_IMPLICIT_CONSTRUCTORS(BlockingUrlProtocol);
 };
 
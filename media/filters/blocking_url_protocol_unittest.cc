@@ -5,6 +5,7 @@
 #include "base/bind.h"
 #include "base/files/file_path.h"
 #include "base/synchronization/waitable_event.h"
+#include "media/base/decoder_buffer.h"
 #include "media/base/test_data_util.h"
 #include "media/ffmpeg/ffmpeg_common.h"
 #include "media/filters/blocking_url_protocol.h"
@@ -75,6 +76,35 @@ TEST_F(BlockingUrlProtocolTest, Read) {
   EXPECT_EQ(size, position);
 }
 
+TEST_F(BlockingUrlProtocolTest, ReadAhead) {
+  scoped_refptr<DecoderBuffer> file_data =
+      ReadTestDataFile("bear-320x240.webm");
+  ASSERT_TRUE(url_protocol_.SetPosition(0));
+
+  // Read the whole file in small chunks, which come from the read-ahead
+  // buffer, and make sure they match the file.
+  uint8 buffer[100];
+  int64 position = 0;
+  while (position < file_data->data_size()) {
+    int bytes_read = url_protocol_.Read(sizeof(buffer), buffer);
+    ASSERT_GT(bytes_read, 0);
+    ASSERT_EQ(0, memcmp(file_data->data() + position, buffer, bytes_read));
+    position += bytes_read;
+  }
+  EXPECT_EQ(0, url_protocol_.Read(sizeof(buffer), buffer));
+
+  // Seek backwards and read across the end of the read-ahead buffer.
+  const int64 kSeekPosition = 1000;
+  ASSERT_TRUE(url_protocol_.SetPosition(kSeekPosition));
+  std::vector<uint8> large_buffer(256 * 1024);
+  int bytes_read = url_protocol_.Read(large_buffer.size(), &large_buffer[0]);
+  ASSERT_GT(bytes_read, 0);
+  EXPECT_EQ(0, memcmp(file_data->data() + kSeekPosition, &large_buffer[0],
+                      bytes_read));
+  EXPECT_TRUE(url_protocol_.GetPosition(&position));
+  EXPECT_EQ(kSeekPosition + bytes_read, position);
+}
+
 TEST_F(BlockingUrlProtocolTest, ReadError) {
   data_source_.force_read_errors_for_testing();
 
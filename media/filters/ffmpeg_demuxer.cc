@@ -686,8 +686,10 @@ void FFmpegDemuxer::OnFindStreamInfoDone(const PipelineStatusCB& status_cb,
   int64 filesize_in_bytes = 0;
   url_protocol_->GetSize(&filesize_in_bytes);
   bitrate_ = CalculateBitrate(format_context, max_duration, filesize_in_bytes);
-  if (bitrate_ > 0)
+  if (bitrate_ > 0) {
     data_source_->SetBitrate(bitrate_);
+    url_protocol_->SetBitrate(bitrate_);
+  }
 
   // Audio logging
   if (audio_stream) {
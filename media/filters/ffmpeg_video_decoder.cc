@@ -13,6 +13,7 @@
 #include "base/location.h"
 #include "base/single_thread_task_runner.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/sys_info.h"
 #include "media/base/bind_to_current_loop.h"
 #include "media/base/decoder_buffer.h"
 #include "media/base/limits.h"
@@ -26,8 +27,8 @@
 
 namespace media {
 
-// Always try to use three threads for video decoding.  There is little reason
-// not to since current day CPUs tend to be multi-core and we measured
+// Always try to use at least two threads for video decoding.  There is little
+// reason not to since current day CPUs tend to be multi-core and we measured
 // performance benefits on older machines such as P4s with hyperthreading.
 //
 // Handling decoding on separate threads also frees up the pipeline thread to
@@ -38,28 +39,71 @@ namespace media {
 static const int kDecodeThreads = 2;
 static const int kMaxDecodeThreads = 16;
 
-// Returns the number of threads given the FFmpeg CodecID. Also inspects the
+// Frames up to this many pixels get kDecodeThreads, larger ones get more in
+// proportion; e.g., 1440p gets four threads and 4K gets eight.
+static const int kPixelsPerDecodeThreads = 1920 * 1080;
+
+// Returns the number of threads to decode |config| with. Also inspects the
 // command line for a valid --video-threads flag.
-static int GetThreadCount(AVCodecID codec_id) {
+static int GetThreadCount(const VideoDecoderConfig& config) {
   // Refer to http://crbug.com/93932 for tsan suppressions on decoding.
   int decode_threads = kDecodeThreads;
 
   const CommandLine* cmd_line = CommandLine::ForCurrentProcess();
   std::string threads(cmd_line->GetSwitchValueASCII(switches::kVideoThreads));
-  if (threads.empty() || !base::StringToInt(threads, &decode_threads))
+  if (!threads.empty() && base::StringToInt(threads, &decode_threads)) {
+    decode_threads = std::max(decode_threads, 0);
+    decode_threads = std::min(decode_threads, kMaxDecodeThreads);
     return decode_threads;
+  }
+
+  // Only the codecs FFmpeg has multithreaded decoders for benefit from more
+  // threads; for the others they're just overhead.
+  switch (config.codec()) {
+    case kCodecH264:
+    case kCodecVP8:
+    case kCodecVP9:
+    case kCodecMPEG4: {
+      const int64 pixels = static_cast<int64>(config.coded_size().width()) *
+          config.coded_size().height();
+      decode_threads = std::max(kDecodeThreads, static_cast<int>(
+          (pixels * kDecodeThreads + kPixelsPerDecodeThreads - 1) /
+              kPixelsPerDecodeThreads));
+      break;
+    }
+    default:
+      break;
+  }
+
+  // Threads beyond the number of cores would only compete with each other.
+  decode_threads = std::min(
+      decode_threads, std::max(kDecodeThreads,
+                               base::SysInfo::NumberOfProcessors()));
+  return std::min(decode_threads, kMaxDecodeThreads);
+}
 
-  decode_threads = std::max(decode_threads, 0);
-  decode_threads = std::min(decode_threads, kMaxDecodeThreads);
-  return decode_threads;
+// Returns the FFmpeg threading modes allowed for |config|. Frame threading
+// decodes a frame per thread, so it adds a frame of delay for each thread,
+// which latency sensitive streams can't afford. Slice threading adds no delay
+// but only helps streams which are coded as several slices.
+static int GetThreadType(const VideoDecoderConfig& config) {
+  if (config.low_delay())
+    return FF_THREAD_SLICE;
+  return FF_THREAD_FRAME | FF_THREAD_SLICE;
 }
 
 FFmpegVideoDecoder::FFmpegVideoDecoder(
     const scoped_refptr<base::SingleThreadTaskRunner>& task_runner)
     : task_runner_(task_runner), state_(kUninitialized) {}
 
+static void ReleaseVideoBufferImpl(void* opaque, uint8* data) {
+  scoped_refptr<VideoFrame> video_frame;
+  video_frame.swap(reinterpret_cast<VideoFrame**>(&opaque));
+}
+
 int FFmpegVideoDecoder::GetVideoBuffer(AVCodecContext* codec_context,
-                                       AVFrame* frame) {
+                                       AVFrame* frame,
+                                       int flags) {
   // Don't use |codec_context_| here! With threaded decoding,
   // it will contain unsynchronized width/height/pix_fmt values,
   // whereas |codec_context| contains the current threads's
@@ -93,34 +137,28 @@ int FFmpegVideoDecoder::GetVideoBuffer(AVCodecContext* codec_context,
                               natural_size, kNoTimestamp());
 
   for (int i = 0; i < 3; i++) {
-    frame->base[i] = video_frame->data(i);
     frame->data[i] = video_frame->data(i);
     frame->linesize[i] = video_frame->stride(i);
   }
 
-  frame->opaque = NULL;
-  video_frame.swap(reinterpret_cast<VideoFrame**>(&frame->opaque));
-  frame->type = FF_BUFFER_TYPE_USER;
   frame->width = codec_context->width;
   frame->height = codec_context->height;
   frame->format = codec_context->pix_fmt;
 
+  // FFmpeg decodes straight into the pooled VideoFrame, which the AVBufferRef
+  // keeps a reference to until FFmpeg is done with the frame, e.g. when it's
+  // no longer needed as a reference for other frames.
+  void* opaque = NULL;
+  video_frame.swap(reinterpret_cast<VideoFrame**>(&opaque));
+  frame->buf[0] = av_buffer_create(
+      frame->data[0], VideoFrame::AllocationSize(format, size),
+      ReleaseVideoBufferImpl, opaque, 0);
   return 0;
 }
 
-static int GetVideoBufferImpl(AVCodecContext* s, AVFrame* frame) {
+static int GetVideoBufferImpl(AVCodecContext* s, AVFrame* frame, int flags) {
   FFmpegVideoDecoder* decoder = static_cast<FFmpegVideoDecoder*>(s->opaque);
-  return decoder->GetVideoBuffer(s, frame);
-}
-
-static void ReleaseVideoBufferImpl(AVCodecContext* s, AVFrame* frame) {
-  scoped_refptr<VideoFrame> video_frame;
-  video_frame.swap(reinterpret_cast<VideoFrame**>(&frame->opaque));
-
-  // The FFmpeg API expects us to zero the data pointers in
-  // this callback
-  memset(frame->data, 0, sizeof(frame->data));
-  frame->opaque = NULL;
+  return decoder->GetVideoBuffer(s, frame, flags);
 }
 
 void FFmpegVideoDecoder::Initialize(const VideoDecoderConfig& config,
@@ -282,9 +320,6 @@ bool FFmpegVideoDecoder::FFmpegDecode(
     scoped_refptr<VideoFrame>* video_frame) {
   DCHECK(video_frame);
 
-  // Reset frame to default values.
-  avcodec_get_frame_defaults(av_frame_.get());
-
   // Create a packet for input data.
   // Due to FFmpeg API changes we no longer have const read-only pointers.
   AVPacket packet;
@@ -299,7 +334,7 @@ bool FFmpegVideoDecoder::FFmpegDecode(
     // Let FFmpeg handle presentation timestamp reordering.
     codec_context_->reordered_opaque = buffer->timestamp().InMicroseconds();
 
-    // This is for codecs not using get_buffer to initialize
+    // This is for codecs not using get_buffer2 to initialize
     // |av_frame_->reordered_opaque|
     av_frame_->reordered_opaque = codec_context_->reordered_opaque;
   }
@@ -333,18 +368,23 @@ bool FFmpegVideoDecoder::FFmpegDecode(
       !av_frame_->data[VideoFrame::kVPlane]) {
     LOG(ERROR) << "Video frame was produced yet has invalid frame data.";
     *video_frame = NULL;
+    av_frame_unref(av_frame_.get());
     return false;
   }
 
-  if (!av_frame_->opaque) {
+  if (!av_frame_->buf[0]) {
     LOG(ERROR) << "VideoFrame object associated with frame data not set.";
+    av_frame_unref(av_frame_.get());
     return false;
   }
-  *video_frame = static_cast<VideoFrame*>(av_frame_->opaque);
+  *video_frame =
+      static_cast<VideoFrame*>(av_buffer_get_opaque(av_frame_->buf[0]));
 
   (*video_frame)->SetTimestamp(
       base::TimeDelta::FromMicroseconds(av_frame_->reordered_opaque));
 
+  // Drop this reference to the frame, |video_frame| holds its own.
+  av_frame_unref(av_frame_.get());
   return true;
 }
 
@@ -364,11 +404,12 @@ bool FFmpegVideoDecoder::ConfigureDecoder() {
   // Enable motion vector search (potentially slow), strong deblocking filter
   // for damaged macroblocks, and set our error detection sensitivity.
   codec_context_->error_concealment = FF_EC_GUESS_MVS | FF_EC_DEBLOCK;
-  codec_context_->thread_count = GetThreadCount(codec_context_->codec_id);
+  codec_context_->thread_count = GetThreadCount(config_);
+  codec_context_->thread_type = GetThreadType(config_);
   codec_context_->opaque = this;
   codec_context_->flags |= CODEC_FLAG_EMU_EDGE;
-  codec_context_->get_buffer = GetVideoBufferImpl;
-  codec_context_->release_buffer = ReleaseVideoBufferImpl;
+  codec_context_->get_buffer2 = GetVideoBufferImpl;
+  codec_context_->refcounted_frames = 1;
 
   AVCodec* codec = avcodec_find_decoder(codec_context_->codec_id);
   if (!codec || avcodec_open2(codec_context_.get(), codec, NULL) < 0) {
@@ -366,6 +366,22 @@ TEST_F(FFmpegVideoDecoderTest, DecodeFrame_Normal) {
 
 // Verify current behavior for 0 byte frames. FFmpeg simply ignores
 // the 0 byte frames.
+// Low delay streams don't use frame threading, so the frame must come out of
+// the decoder right away rather than after an end of stream buffer.
+TEST_F(FFmpegVideoDecoderTest, DecodeFrame_LowDelay) {
+  VideoDecoderConfig config = TestVideoConfig::Normal();
+  config.set_low_delay(true);
+  InitializeWithConfig(config);
+
+  VideoDecoder::Status status;
+  scoped_refptr<VideoFrame> video_frame;
+  Decode(i_frame_buffer_, &status, &video_frame);
+
+  EXPECT_EQ(VideoDecoder::kOk, status);
+  ASSERT_TRUE(video_frame.get());
+  EXPECT_FALSE(video_frame->end_of_stream());
+}
+
 TEST_F(FFmpegVideoDecoderTest, DecodeFrame_0ByteFrame) {
   Initialize();
 
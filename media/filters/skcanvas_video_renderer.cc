@@ -34,6 +34,16 @@ static bool IsEitherYV12OrYV12AOrYV16OrNative(
       format == media::VideoFrame::YV12A;
 }
 
+// Returns true if the total matrix of |canvas| has no skew and neither flips
+// nor mirrors, i.e. it only translates and scales by positive factors.
+static bool HasScaleOnlyMatrix(SkCanvas* canvas) {
+  const SkMatrix& total_matrix = canvas->getTotalMatrix();
+  return SkScalarNearlyZero(total_matrix.getSkewX()) &&
+         SkScalarNearlyZero(total_matrix.getSkewY()) &&
+         total_matrix.getScaleX() > 0 &&
+         total_matrix.getScaleY() > 0;
+}
+
 // CanFastPaint is a helper method to determine the conditions for fast
 // painting. The conditions are:
 // 1. No skew in canvas matrix.
@@ -49,15 +59,7 @@ static bool CanFastPaint(SkCanvas* canvas, uint8 alpha,
   if (alpha != 0xFF || !IsEitherYV12OrYV16(format))
     return false;
 
-  const SkMatrix& total_matrix = canvas->getTotalMatrix();
-  // Perform the following checks here:
-  // 1. Check for skewing factors of the transformation matrix. They should be
-  //    zero.
-  // 2. Check for mirroring and flipping. Make sure they are greater than zero.
-  if (SkScalarNearlyZero(total_matrix.getSkewX()) &&
-      SkScalarNearlyZero(total_matrix.getSkewY()) &&
-      total_matrix.getScaleX() > 0 &&
-      total_matrix.getScaleY() > 0) {
+  if (HasScaleOnlyMatrix(canvas)) {
     SkBaseDevice* device = canvas->getDevice();
     const SkBitmap::Config config = device->config();
 
@@ -69,6 +71,33 @@ static bool CanFastPaint(SkCanvas* canvas, uint8 alpha,
   return false;
 }
 
+// Returns the size, in device pixels, that |video_frame| should be converted
+// to when it is painted to |dest_rect| on |canvas| by the slow path. This is
+// the size of the projected destination rect if the frame gets scaled down
+// without skewing or mirroring, so that the conversion and the downscale happen
+// in one pass, and the visible size of the frame otherwise.
+static gfx::Size GetSlowPaintBitmapSize(
+    const scoped_refptr<media::VideoFrame>& video_frame,
+    SkCanvas* canvas,
+    const SkRect& dest_rect) {
+  const gfx::Size visible_size = video_frame->visible_rect().size();
+  if (!IsEitherYV12OrYV16(video_frame->format()) ||
+      !HasScaleOnlyMatrix(canvas)) {
+    return visible_size;
+  }
+
+  SkRect local_dest_rect;
+  canvas->getTotalMatrix().mapRect(&local_dest_rect, dest_rect);
+  SkIRect local_dest_irect;
+  local_dest_rect.round(&local_dest_irect);
+  if (local_dest_irect.isEmpty() ||
+      local_dest_irect.width() >= visible_size.width() ||
+      local_dest_irect.height() >= visible_size.height()) {
+    return visible_size;
+  }
+  return gfx::Size(local_dest_irect.width(), local_dest_irect.height());
+}
+
 // Fast paint does YUV => RGB, scaling, blitting all in one step into the
 // canvas. It's not always safe and appropriate to perform fast paint.
 // CanFastPaint() is used to determine the conditions.
@@ -183,11 +212,14 @@ static void FastPaint(
   bitmap.unlockPixels();
 }
 
-// Converts a VideoFrame containing YUV data to a SkBitmap containing RGB data.
+// Converts a VideoFrame containing YUV data to a SkBitmap containing RGB data,
+// scaling it to |bitmap_size| on the way if that differs from the visible size
+// of |video_frame|; only YV12 and YV16 frames can be scaled.
 //
-// |bitmap| will be (re)allocated to match the dimensions of |video_frame|.
+// |bitmap| will be (re)allocated to match |bitmap_size|.
 static void ConvertVideoFrameToBitmap(
     const scoped_refptr<media::VideoFrame>& video_frame,
+    const gfx::Size& bitmap_size,
     SkBitmap* bitmap) {
   DCHECK(IsEitherYV12OrYV12AOrYV16OrNative(video_frame->format()))
       << video_frame->format();
@@ -196,13 +228,17 @@ static void ConvertVideoFrameToBitmap(
               video_frame->stride(media::VideoFrame::kVPlane));
   }
 
+  const bool scale = bitmap_size != video_frame->visible_rect().size();
+  DCHECK(!scale || IsEitherYV12OrYV16(video_frame->format()))
+      << video_frame->format();
+
   // Check if |bitmap| needs to be (re)allocated.
   if (bitmap->isNull() ||
-      bitmap->width() != video_frame->visible_rect().width() ||
-      bitmap->height() != video_frame->visible_rect().height()) {
+      bitmap->width() != bitmap_size.width() ||
+      bitmap->height() != bitmap_size.height()) {
     bitmap->setConfig(SkBitmap::kARGB_8888_Config,
-                      video_frame->visible_rect().width(),
-                      video_frame->visible_rect().height());
+                      bitmap_size.width(),
+                      bitmap_size.height());
     bitmap->allocPixels();
     bitmap->setIsVolatile(true);
   }
@@ -225,6 +261,28 @@ static void ConvertVideoFrameToBitmap(
                 (video_frame->visible_rect().x() >> 1);
   }
 
+  if (scale) {
+    media::ScaleYUVToRGB32(
+        video_frame->data(media::VideoFrame::kYPlane) + y_offset,
+        video_frame->data(media::VideoFrame::kUPlane) + uv_offset,
+        video_frame->data(media::VideoFrame::kVPlane) + uv_offset,
+        static_cast<uint8*>(bitmap->getPixels()),
+        video_frame->visible_rect().width(),
+        video_frame->visible_rect().height(),
+        bitmap_size.width(),
+        bitmap_size.height(),
+        video_frame->stride(media::VideoFrame::kYPlane),
+        video_frame->stride(media::VideoFrame::kUPlane),
+        bitmap->rowBytes(),
+        video_frame->format() == media::VideoFrame::YV16 ? media::YV16
+                                                         : media::YV12,
+        media::ROTATE_0,
+        media::FILTER_BILINEAR);
+    bitmap->notifyPixelsChanged();
+    bitmap->unlockPixels();
+    return;
+  }
+
   switch (video_frame->format()) {
     case media::VideoFrame::YV12:
     case media::VideoFrame::YV12J:
@@ -318,10 +376,15 @@ void SkCanvasVideoRenderer::Paint(media::VideoFrame* video_frame,
     return;
   }
 
-  // Check if we should convert and update |last_frame_|.
+  // Check if we should convert and update |last_frame_|. Repaints of the same
+  // frame at the same size reuse it.
+  const gfx::Size bitmap_size =
+      GetSlowPaintBitmapSize(video_frame, canvas, dest);
   if (last_frame_.isNull() ||
-      video_frame->GetTimestamp() != last_frame_timestamp_) {
-    ConvertVideoFrameToBitmap(video_frame, &last_frame_);
+      video_frame->GetTimestamp() != last_frame_timestamp_ ||
+      last_frame_.width() != bitmap_size.width() ||
+      last_frame_.height() != bitmap_size.height()) {
+    ConvertVideoFrameToBitmap(video_frame, bitmap_size, &last_frame_);
     last_frame_timestamp_ = video_frame->GetTimestamp();
   }
 
@@ -34,7 +34,8 @@ class MEDIA_EXPORT SkCanvasVideoRenderer {
 
  private:
   // An RGB bitmap and corresponding timestamp of the previously converted
-  // video frame data.
+  // video frame data. The bitmap is smaller than the frame when the slow path
+  // scales the frame down while converting it.
   SkBitmap last_frame_;
   base::TimeDelta last_frame_timestamp_;
 
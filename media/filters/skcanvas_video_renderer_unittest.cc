@@ -301,6 +301,18 @@ TEST_F(SkCanvasVideoRendererTest, SlowPaint_SameVideoFrame) {
   EXPECT_EQ(SK_ColorRED, GetColor(slow_path_canvas()));
 }
 
+TEST_F(SkCanvasVideoRendererTest, SlowPaint_LargerSameVideoFrame) {
+  // The larger frame gets scaled down while it is converted, which is cached
+  // too.
+  Paint(larger_frame(), slow_path_canvas(), kRed);
+  EXPECT_EQ(SK_ColorRED, GetColor(slow_path_canvas()));
+  EXPECT_EQ(SK_ColorRED, GetColorAt(slow_path_canvas(), kWidth - 1,
+                                                        kHeight - 1));
+
+  Paint(larger_frame(), slow_path_canvas(), kBlue);
+  EXPECT_EQ(SK_ColorRED, GetColor(slow_path_canvas()));
+}
+
 TEST_F(SkCanvasVideoRendererTest, FastPaint_CroppedFrame) {
   Paint(cropped_frame(), fast_path_canvas(), kNone);
   // Check the corners.
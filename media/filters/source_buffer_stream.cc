@@ -65,12 +65,12 @@ class SourceBufferRange {
   void AppendBuffersToEnd(const BufferQueue& buffers);
   bool CanAppendBuffersToEnd(const BufferQueue& buffers) const;
 
-  // Appends the buffers from |range| into this range.
+  // Moves the buffers from |range| into this range, leaving |range| empty.
   // The first buffer in |range| must come directly after the last buffer
-  // in this range.
+  // in this range. The cost is linear in the size of the smaller range.
   // If |transfer_current_position| is true, |range|'s |next_buffer_index_|
   // is transfered to this SourceBufferRange.
-  void AppendRangeToEnd(const SourceBufferRange& range,
+  void AppendRangeToEnd(SourceBufferRange* range,
                         bool transfer_current_position);
   bool CanAppendRangeToEnd(const SourceBufferRange& range) const;
 
@@ -1038,7 +1038,7 @@ void SourceBufferStream::MergeWithAdjacentRangeIfNecessary(
   }
 
   bool transfer_current_position = selected_range_ == *next_range_itr;
-  range_with_new_buffers->AppendRangeToEnd(**next_range_itr,
+  range_with_new_buffers->AppendRangeToEnd(*next_range_itr,
                                            transfer_current_position);
   // Update |selected_range_| pointer if |range| has become selected after
   // merges.
@@ -2044,15 +2044,44 @@ void SourceBufferRange::ResetNextBufferPosition() {
   next_buffer_index_ = -1;
 }
 
-void SourceBufferRange::AppendRangeToEnd(const SourceBufferRange& range,
+void SourceBufferRange::AppendRangeToEnd(SourceBufferRange* range,
                                          bool transfer_current_position) {
-  DCHECK(CanAppendRangeToEnd(range));
+  DCHECK(CanAppendRangeToEnd(*range));
   DCHECK(!buffers_.empty());
 
-  if (transfer_current_position && range.next_buffer_index_ >= 0)
-    next_buffer_index_ = range.next_buffer_index_ + buffers_.size();
+  if (transfer_current_position && range->next_buffer_index_ >= 0)
+    next_buffer_index_ = range->next_buffer_index_ + buffers_.size();
 
-  AppendBuffersToEnd(range.buffers_);
+  if (range->buffers_.size() <= buffers_.size()) {
+    AppendBuffersToEnd(range->buffers_);
+  } else {
+    // |range| is the larger one, e.g. a long buffered range that a newly
+    // appended media segment has just reached. Prepend this range's buffers
+    // to it and take over its storage instead of copying all of it here.
+    // Shifting |range|'s index base keeps its |keyframe_map_| entries valid.
+    range->keyframe_map_index_base_ -= buffers_.size();
+    for (KeyframeMap::const_iterator itr = keyframe_map_.begin();
+         itr != keyframe_map_.end(); ++itr) {
+      range->keyframe_map_.insert(std::make_pair(
+          itr->first,
+          itr->second - keyframe_map_index_base_ +
+              range->keyframe_map_index_base_));
+    }
+    range->buffers_.insert(range->buffers_.begin(),
+                           buffers_.begin(), buffers_.end());
+    range->size_in_bytes_ += size_in_bytes_;
+
+    buffers_.swap(range->buffers_);
+    keyframe_map_.swap(range->keyframe_map_);
+    keyframe_map_index_base_ = range->keyframe_map_index_base_;
+    size_in_bytes_ = range->size_in_bytes_;
+  }
+
+  range->buffers_.clear();
+  range->keyframe_map_.clear();
+  range->keyframe_map_index_base_ = 0;
+  range->next_buffer_index_ = -1;
+  range->size_in_bytes_ = 0;
 }
 
 bool SourceBufferRange::CanAppendRangeToEnd(
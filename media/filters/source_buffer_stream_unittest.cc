@@ -1999,6 +1999,28 @@ TEST_F(SourceBufferStreamTest, GetNextBuffer_AfterMerges) {
   CheckExpectedBuffers(11, 14);
 }
 
+TEST_F(SourceBufferStreamTest, GetNextBuffer_AfterMergeIntoLongerRange) {
+  // Append 20 buffers at positions 10 through 29.
+  NewSegmentAppend(10, 20);
+
+  // Seek to buffer at position 15.
+  Seek(15);
+
+  // Append 5 buffers at positions 5 through 9, which get merged into the
+  // longer range after them.
+  NewSegmentAppend(5, 5);
+  CheckExpectedRanges("{ [5,29) }");
+
+  // Make sure the next buffers are correct.
+  CheckExpectedBuffers(15, 29);
+
+  // Make sure the keyframes of both ranges can still be seeked to.
+  Seek(5);
+  CheckExpectedBuffers(5, 14);
+  Seek(20);
+  CheckExpectedBuffers(20, 29);
+}
+
 TEST_F(SourceBufferStreamTest, GetNextBuffer_ExhaustThenAppend) {
   // Append 4 buffers at positions 0 through 3.
   NewSegmentAppend(0, 4);
@@ -72,7 +72,7 @@ static int GetThreadCount(const VideoDecoderConfig& config) {
 }
 
 // Maximum number of frame buffers that can be used (by both chromium and libvpx
-// combined) for VP9 Decoding.
+// combined) for each VP9 decoder context.
 // TODO(vigneshv): Investigate if this can be relaxed to a higher number.
 static const uint32 kVP9MaxFrameBuffers = VP9_MAXIMUM_REF_BUFFERS +
                                           VPX_MAXIMUM_WORK_BUFFERS +
@@ -81,7 +81,9 @@ static const uint32 kVP9MaxFrameBuffers = VP9_MAXIMUM_REF_BUFFERS +
 class VpxVideoDecoder::MemoryPool
     : public base::RefCountedThreadSafe<VpxVideoDecoder::MemoryPool> {
  public:
-  MemoryPool();
+  // |max_frame_buffers| is the number of frame buffers libvpx and chromium
+  // may hold at once across all decoder contexts sharing the pool.
+  explicit MemoryPool(uint32 max_frame_buffers);
 
   // Callback that will be called by libvpx when it needs a frame buffer.
   // Parameters:
@@ -100,8 +102,10 @@ class VpxVideoDecoder::MemoryPool
                                      vpx_codec_frame_buffer *fb);
 
   // Generates a "no_longer_needed" closure that holds a reference
-  // to this pool.
-  base::Closure CreateFrameCallback(void* fb_priv_data);
+  // to this pool and to the frame buffers given by |fb_priv_data| and, if not
+  // NULL, |alpha_fb_priv_data|.
+  base::Closure CreateFrameCallback(void* fb_priv_data,
+                                    void* alpha_fb_priv_data);
 
  private:
   friend class base::RefCountedThreadSafe<VpxVideoDecoder::MemoryPool>;
@@ -120,8 +124,11 @@ class VpxVideoDecoder::MemoryPool
   VP9FrameBuffer* GetFreeFrameBuffer(size_t min_size);
 
   // Method that gets called when a VideoFrame that references this pool gets
-  // destroyed.
-  void OnVideoFrameDestroyed(VP9FrameBuffer* frame_buffer);
+  // destroyed. |alpha_frame_buffer| may be NULL.
+  void OnVideoFrameDestroyed(VP9FrameBuffer* frame_buffer,
+                             VP9FrameBuffer* alpha_frame_buffer);
+
+  const uint32 max_frame_buffers_;
 
   // Frame buffers to be used by libvpx for VP9 Decoding.
   std::vector<VP9FrameBuffer*> frame_buffers_;
@@ -129,7 +136,8 @@ class VpxVideoDecoder::MemoryPool
   DISALLOW_COPY_AND_ASSIGN(MemoryPool);
 };
 
-VpxVideoDecoder::MemoryPool::MemoryPool() {}
+VpxVideoDecoder::MemoryPool::MemoryPool(uint32 max_frame_buffers)
+    : max_frame_buffers_(max_frame_buffers) {}
 
 VpxVideoDecoder::MemoryPool::~MemoryPool() {
   STLDeleteElements(&frame_buffers_);
@@ -146,7 +154,7 @@ VpxVideoDecoder::MemoryPool::VP9FrameBuffer*
 
   if (i == frame_buffers_.size()) {
     // Maximum number of frame buffers reached.
-    if (i == kVP9MaxFrameBuffers)
+    if (i == max_frame_buffers_)
       return NULL;
 
     // Create a new frame buffer.
@@ -188,17 +196,23 @@ int32 VpxVideoDecoder::MemoryPool::ReleaseVP9FrameBuffer(
 }
 
 base::Closure VpxVideoDecoder::MemoryPool::CreateFrameCallback(
-    void* fb_priv_data) {
+    void* fb_priv_data, void* alpha_fb_priv_data) {
   VP9FrameBuffer* frame_buffer = static_cast<VP9FrameBuffer*>(fb_priv_data);
   ++frame_buffer->ref_cnt;
+  VP9FrameBuffer* alpha_frame_buffer =
+      static_cast<VP9FrameBuffer*>(alpha_fb_priv_data);
+  if (alpha_frame_buffer)
+    ++alpha_frame_buffer->ref_cnt;
   return BindToCurrentLoop(
              base::Bind(&MemoryPool::OnVideoFrameDestroyed, this,
-                        frame_buffer));
+                        frame_buffer, alpha_frame_buffer));
 }
 
 void VpxVideoDecoder::MemoryPool::OnVideoFrameDestroyed(
-    VP9FrameBuffer* frame_buffer) {
+    VP9FrameBuffer* frame_buffer, VP9FrameBuffer* alpha_frame_buffer) {
   --frame_buffer->ref_cnt;
+  if (alpha_frame_buffer)
+    --alpha_frame_buffer->ref_cnt;
 }
 
 VpxVideoDecoder::VpxVideoDecoder(
@@ -268,25 +282,30 @@ bool VpxVideoDecoder::ConfigureDecoder(const VideoDecoderConfig& config) {
   if (!vpx_codec_)
     return false;
 
-  // We use our own buffers for VP9 so that there is no need to copy data after
-  // decoding.
-  if (config.codec() == kCodecVP9) {
-    memory_pool_ = new MemoryPool();
-    if (vpx_codec_set_frame_buffer_functions(vpx_codec_,
-                                             &MemoryPool::GetVP9FrameBuffer,
-                                             &MemoryPool::ReleaseVP9FrameBuffer,
-                                             memory_pool_)) {
-      LOG(ERROR) << "Failed to configure external buffers.";
-      return false;
-    }
-  }
-
   if (config.format() == VideoFrame::YV12A) {
     vpx_codec_alpha_ = InitializeVpxContext(vpx_codec_alpha_, config);
     if (!vpx_codec_alpha_)
       return false;
   }
 
+  // We use our own buffers for VP9 so that there is no need to copy data after
+  // decoding. Both the color and the alpha contexts share one pool.
+  if (config.codec() == kCodecVP9) {
+    memory_pool_ = new MemoryPool(vpx_codec_alpha_ ? 2 * kVP9MaxFrameBuffers
+                                                   : kVP9MaxFrameBuffers);
+    vpx_codec_ctx* contexts[] = { vpx_codec_, vpx_codec_alpha_ };
+    for (size_t i = 0; i < arraysize(contexts) && contexts[i]; ++i) {
+      if (vpx_codec_set_frame_buffer_functions(
+              contexts[i],
+              &MemoryPool::GetVP9FrameBuffer,
+              &MemoryPool::ReleaseVP9FrameBuffer,
+              memory_pool_)) {
+        LOG(ERROR) << "Failed to configure external buffers.";
+        return false;
+      }
+    }
+  }
+
   return true;
 }
 
@@ -493,7 +512,30 @@ void VpxVideoDecoder::CopyVpxImageTo(const vpx_image* vpx_image,
                        vpx_image->planes[VPX_PLANE_U],
                        vpx_image->planes[VPX_PLANE_V],
                        kNoTimestamp(),
-                       memory_pool_->CreateFrameCallback(vpx_image->fb_priv));
+                       memory_pool_->CreateFrameCallback(vpx_image->fb_priv,
+                                                         NULL));
+    return;
+  }
+
+  // VP9 with alpha decodes both images into |memory_pool_|, so they can be
+  // wrapped too. Frames without alpha data, or whose alpha image doesn't
+  // match, are copied below.
+  if (memory_pool_ && vpx_image_alpha &&
+      vpx_image_alpha->d_w == vpx_image->d_w &&
+      vpx_image_alpha->d_h == vpx_image->d_h) {
+    *video_frame = VideoFrame::WrapExternalYuvaData(
+                       size, gfx::Rect(size), config_.natural_size(),
+                       vpx_image->stride[VPX_PLANE_Y],
+                       vpx_image->stride[VPX_PLANE_U],
+                       vpx_image->stride[VPX_PLANE_V],
+                       vpx_image_alpha->stride[VPX_PLANE_Y],
+                       vpx_image->planes[VPX_PLANE_Y],
+                       vpx_image->planes[VPX_PLANE_U],
+                       vpx_image->planes[VPX_PLANE_V],
+                       vpx_image_alpha->planes[VPX_PLANE_Y],
+                       kNoTimestamp(),
+                       memory_pool_->CreateFrameCallback(
+                           vpx_image->fb_priv, vpx_image_alpha->fb_priv));
     return;
   }
 
@@ -44,6 +44,27 @@ TEST_F(OffsetByteQueueTest, SetUp) {
   EXPECT_EQ(255, buf[size-1]);
 }
 
+TEST_F(OffsetByteQueueTest, PushAndPopKeepOrder) {
+  // Push more than is popped so the underlying buffer both grows and gets
+  // compacted, and check the bytes still come out in order.
+  uint8 buf[100];
+  int64 next_value = queue_->tail();
+  for (int i = 0; i < 100; i++) {
+    for (int j = 0; j < 100; j++)
+      buf[j] = (next_value + j) & 0xff;
+    queue_->Push(buf, sizeof(buf));
+    next_value += sizeof(buf);
+    queue_->Pop(60);
+  }
+
+  const uint8* data;
+  int size;
+  queue_->Peek(&data, &size);
+  EXPECT_EQ(queue_->tail() - queue_->head(), size);
+  for (int i = 0; i < size; i++)
+    ASSERT_EQ((queue_->head() + i) & 0xff, data[i]) << i;
+}
+
 TEST_F(OffsetByteQueueTest, PeekAt) {
   const uint8* buf;
   int size;
@@ -10,6 +10,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "mojo/public/system/macros.h"
 #include "mojo/public/tests/test_support.h"
@@ -158,7 +159,73 @@ class CorePerftest : public testing::Test {
     assert(result == MOJO_RESULT_SHOULD_WAIT);
   }
 
+  static void DataPipe_WriteAndRead(void* closure) {
+    CorePerftest* self = static_cast<CorePerftest*>(closure);
+    MojoResult result MOJO_ALLOW_UNUSED;
+    uint32_t num_bytes = self->num_bytes_;
+    result = MojoWriteData(self->h0_, self->buffer_, &num_bytes,
+                           MOJO_WRITE_DATA_FLAG_ALL_OR_NONE);
+    assert(result == MOJO_RESULT_OK);
+    num_bytes = self->num_bytes_;
+    result = MojoReadData(self->h1_, self->buffer_, &num_bytes,
+                          MOJO_READ_DATA_FLAG_ALL_OR_NONE);
+    assert(result == MOJO_RESULT_OK);
+  }
+
+  // Like |DataPipe_WriteAndRead()|, but the data is produced directly into and
+  // consumed directly from the data pipe's buffer.
+  static void DataPipe_TwoPhaseWriteAndRead(void* closure) {
+    CorePerftest* self = static_cast<CorePerftest*>(closure);
+    MojoResult result MOJO_ALLOW_UNUSED;
+    void* write_buffer = NULL;
+    uint32_t num_bytes = self->num_bytes_;
+    result = MojoBeginWriteData(self->h0_, &write_buffer, &num_bytes,
+                                MOJO_WRITE_DATA_FLAG_NONE);
+    assert(result == MOJO_RESULT_OK);
+    assert(num_bytes >= self->num_bytes_);
+    memset(write_buffer, 'x', self->num_bytes_);
+    result = MojoEndWriteData(self->h0_, self->num_bytes_);
+    assert(result == MOJO_RESULT_OK);
+    const void* read_buffer = NULL;
+    num_bytes = self->num_bytes_;
+    result = MojoBeginReadData(self->h1_, &read_buffer, &num_bytes,
+                               MOJO_READ_DATA_FLAG_NONE);
+    assert(result == MOJO_RESULT_OK);
+    assert(num_bytes >= self->num_bytes_);
+    result = MojoEndReadData(self->h1_, self->num_bytes_);
+    assert(result == MOJO_RESULT_OK);
+  }
+
  protected:
+  // Runs |test| for a range of data sizes over a fresh data pipe, whose
+  // capacity is a multiple of all of them so that two-phase operations never
+  // have to wrap around.
+  void DoDataPipeTest(const char* name, void (*test)(void*)) {
+    static const uint32_t kNumBytes[] = { 10u, 100u, 1000u, 10000u };
+    const MojoCreateDataPipeOptions options = {
+      static_cast<uint32_t>(sizeof(MojoCreateDataPipeOptions)),
+      MOJO_CREATE_DATA_PIPE_OPTIONS_FLAG_NONE,
+      1u,  // |element_num_bytes|.
+      100000u  // |capacity_num_bytes|.
+    };
+    char buffer[10000] = { 0 };
+    buffer_ = buffer;
+    for (size_t i = 0; i < MOJO_ARRAYSIZE(kNumBytes); i++) {
+      MojoResult result MOJO_ALLOW_UNUSED;
+      result = MojoCreateDataPipe(&options, &h0_, &h1_);
+      assert(result == MOJO_RESULT_OK);
+      num_bytes_ = kNumBytes[i];
+      char test_name[200];
+      sprintf(test_name, "%s_%ubytes", name, static_cast<unsigned>(num_bytes_));
+      mojo::test::IterateAndReportPerf(test_name, test, this);
+      result = MojoClose(h0_);
+      assert(result == MOJO_RESULT_OK);
+      result = MojoClose(h1_);
+      assert(result == MOJO_RESULT_OK);
+    }
+    buffer_ = NULL;
+  }
+
 #if !defined(WIN32)
   void DoMessagePipeThreadedTest(unsigned num_writers,
                                  unsigned num_readers,
@@ -312,6 +379,15 @@ TEST_F(CorePerftest, MessagePipe_EmptyRead) {
   assert(result == MOJO_RESULT_OK);
 }
 
+TEST_F(CorePerftest, DataPipe_WriteAndRead) {
+  DoDataPipeTest("DataPipe_WriteAndRead", &CorePerftest::DataPipe_WriteAndRead);
+}
+
+TEST_F(CorePerftest, DataPipe_TwoPhaseWriteAndRead) {
+  DoDataPipeTest("DataPipe_TwoPhaseWriteAndRead",
+                 &CorePerftest::DataPipe_TwoPhaseWriteAndRead);
+}
+
 #if !defined(WIN32)
 TEST_F(CorePerftest, MessagePipe_Threaded) {
   DoMessagePipeThreadedTest(1u, 1u, 100u);
@@ -40,55 +40,48 @@ RawChannel::WriteBuffer::~WriteBuffer() {
 void RawChannel::WriteBuffer::GetBuffers(std::vector<Buffer>* buffers) const {
   buffers->clear();
 
-  size_t bytes_to_write = GetTotalBytesToWrite();
-  if (bytes_to_write == 0)
-    return;
-
-  MessageInTransit* message = message_queue_.front();
-  if (!message->secondary_buffer_size()) {
-    // Only write from the main buffer.
-    DCHECK_LT(offset_, message->main_buffer_size());
-    DCHECK_LE(bytes_to_write, message->main_buffer_size());
-    Buffer buffer = {
-        static_cast<const char*>(message->main_buffer()) + offset_,
-        bytes_to_write};
-    buffers->push_back(buffer);
-    return;
-  }
+  size_t num_messages = GetNumMessagesToWrite();
+  for (size_t i = 0; i < num_messages; i++) {
+    MessageInTransit* message = message_queue_[i];
+    // Only the first message may have been partially sent.
+    size_t offset = (i == 0) ? offset_ : 0;
+    DCHECK_LT(offset, message->total_size());
+
+    if (offset < message->main_buffer_size()) {
+      Buffer buffer = {
+          static_cast<const char*>(message->main_buffer()) + offset,
+          message->main_buffer_size() - offset};
+      buffers->push_back(buffer);
+      offset = message->main_buffer_size();
+    }
 
-  if (offset_ >= message->main_buffer_size()) {
-    // Only write from the secondary buffer.
-    DCHECK_LT(offset_ - message->main_buffer_size(),
-              message->secondary_buffer_size());
-    DCHECK_LE(bytes_to_write, message->secondary_buffer_size());
-    Buffer buffer = {
-        static_cast<const char*>(message->secondary_buffer()) +
-            (offset_ - message->main_buffer_size()),
-        bytes_to_write};
-    buffers->push_back(buffer);
-    return;
+    if (message->secondary_buffer_size()) {
+      DCHECK_LT(offset - message->main_buffer_size(),
+                message->secondary_buffer_size());
+      Buffer buffer = {
+          static_cast<const char*>(message->secondary_buffer()) +
+              (offset - message->main_buffer_size()),
+          message->total_size() - offset};
+      buffers->push_back(buffer);
+    }
   }
+}
 
-  // Write from both buffers.
-  DCHECK_EQ(bytes_to_write, message->main_buffer_size() - offset_ +
-                                message->secondary_buffer_size());
-  Buffer buffer1 = {
-      static_cast<const char*>(message->main_buffer()) + offset_,
-      message->main_buffer_size() - offset_};
-  buffers->push_back(buffer1);
-  Buffer buffer2 = {
-      static_cast<const char*>(message->secondary_buffer()),
-      message->secondary_buffer_size()};
-  buffers->push_back(buffer2);
+size_t RawChannel::WriteBuffer::GetNumMessagesToWrite() const {
+  return message_queue_.size() < kMaxMessagesPerWrite ? message_queue_.size() :
+                                                        kMaxMessagesPerWrite;
 }
 
 size_t RawChannel::WriteBuffer::GetTotalBytesToWrite() const {
   if (message_queue_.empty())
     return 0;
 
-  MessageInTransit* message = message_queue_.front();
-  DCHECK_LT(offset_, message->total_size());
-  return message->total_size() - offset_;
+  DCHECK_LT(offset_, message_queue_.front()->total_size());
+  size_t num_messages = GetNumMessagesToWrite();
+  size_t total_bytes = 0;
+  for (size_t i = 0; i < num_messages; i++)
+    total_bytes += message_queue_[i]->total_size();
+  return total_bytes - offset_;
 }
 
 RawChannel::RawChannel(Delegate* delegate,
@@ -323,13 +316,18 @@ bool RawChannel::OnWriteCompletedNoLock(bool result, size_t bytes_written) {
   DCHECK(!write_buffer_->message_queue_.empty());
 
   if (result) {
-    if (bytes_written < write_buffer_->GetTotalBytesToWrite()) {
-      // Partial (or no) write.
-      write_buffer_->offset_ += bytes_written;
-    } else {
-      // Complete write.
-      DCHECK_EQ(bytes_written, write_buffer_->GetTotalBytesToWrite());
-      delete write_buffer_->message_queue_.front();
+    DCHECK_LE(bytes_written, write_buffer_->GetTotalBytesToWrite());
+    // Remove all the messages that were completely written; the write may have
+    // ended partway through the next one.
+    while (bytes_written > 0) {
+      MessageInTransit* message = write_buffer_->message_queue_.front();
+      size_t bytes_remaining = message->total_size() - write_buffer_->offset_;
+      if (bytes_written < bytes_remaining) {
+        write_buffer_->offset_ += bytes_written;
+        break;
+      }
+      bytes_written -= bytes_remaining;
+      delete message;
       write_buffer_->message_queue_.pop_front();
       write_buffer_->offset_ = 0;
     }
@@ -130,6 +130,11 @@ class MOJO_SYSTEM_IMPL_EXPORT RawChannel {
       size_t size;
     };
 
+    // The maximum number of queued messages that |GetBuffers()| returns, so
+    // that they can be written with a single (gather) write. Each message
+    // contributes at most two buffers.
+    static const size_t kMaxMessagesPerWrite = 8;
+
     WriteBuffer();
     ~WriteBuffer();
 
@@ -140,11 +145,17 @@ class MOJO_SYSTEM_IMPL_EXPORT RawChannel {
    private:
     friend class RawChannel;
 
+    // Returns the number of messages (from the front of |message_queue_|) that
+    // |GetBuffers()| covers.
+    size_t GetNumMessagesToWrite() const;
+
     // TODO(vtl): When C++11 is available, switch this to a deque of
     // |scoped_ptr|/|unique_ptr|s.
     std::deque<MessageInTransit*> message_queue_;
     // The first message may have been partially sent. |offset_| indicates the
-    // position in the first message where to start the next write.
+    // position in the first message where to start the next write. (A write
+    // may complete several messages, but only the first one remaining can be
+    // partially sent.)
     size_t offset_;
 
     DISALLOW_COPY_AND_ASSIGN(WriteBuffer);
@@ -162,7 +162,9 @@ RawChannel::IOResult RawChannelPosix::WriteNoLock(size_t* bytes_written) {
     // |SIGPIPE| (on Mac, this is suppressed on the socket itself using
     // |setsockopt()|, since |MSG_NOSIGNAL| is not supported -- see
     // platform_channel_pair_posix.cc).
-    const size_t kMaxBufferCount = 10;
+    // Each of the (up to) |WriteBuffer::kMaxMessagesPerWrite| messages may
+    // contribute two buffers.
+    const size_t kMaxBufferCount = 2 * WriteBuffer::kMaxMessagesPerWrite;
     iovec iov[kMaxBufferCount];
     size_t buffer_count = std::min(buffers.size(), kMaxBufferCount);
 
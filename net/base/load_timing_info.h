@@ -70,6 +70,12 @@ struct NET_EXPORT LoadTimingInfo {
     base::TimeTicks dns_start;
     base::TimeTicks dns_end;
 
+    // When IPv6 and IPv4 addresses are resolved separately to race the address
+    // families, the times each family finished resolving. |dns_end| is then
+    // the time the first usable family resolved. Null otherwise.
+    base::TimeTicks ipv6_dns_end;
+    base::TimeTicks ipv4_dns_end;
+
     // The time spent establishing the connection. Connect time includes proxy
     // connect times (Though not proxy_resolve times), DNS lookup times, time
     // spent waiting in certain queues, TCP, and SSL time.
@@ -94,6 +94,10 @@
 
 #include <string>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "net/base/mime_sniffer.h"
 
 #include "base/basictypes.h"
@@ -412,6 +416,10 @@ static bool SniffForHTML(const char* content,
     if (!IsAsciiWhitespace(*pos))
       break;
   }
+  // Every sniffable tag starts with '<', so most content is ruled out without
+  // comparing it against each of them.
+  if (pos == end || *pos != '<')
+    return false;
   static base::HistogramBase* counter(NULL);
   if (!counter) {
     counter = UMASnifferHistogramGet("mime_sniffer.kSniffableTags2",
@@ -670,6 +678,42 @@ static char kByteLooksBinary[] = {
   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 0xF0 - 0xFF
 };
 
+// Returns true if any of the |size| bytes of |content| looks binary.
+static bool HasBinaryLookingByte(const char* content, size_t size) {
+  size_t i = 0;
+#if defined(__SSE2__)
+  // The comparisons are signed, so non-ASCII bytes (negative values) aren't
+  // control characters, as they should. The control characters that don't
+  // look binary are the same as in kByteLooksBinary.
+  const __m128i before_nul = _mm_set1_epi8(-1);
+  const __m128i space = _mm_set1_epi8(' ');
+  const __m128i tab = _mm_set1_epi8('\t');
+  const __m128i line_feed = _mm_set1_epi8('\n');
+  const __m128i form_feed = _mm_set1_epi8('\f');
+  const __m128i carriage_return = _mm_set1_epi8('\r');
+  const __m128i escape = _mm_set1_epi8(0x1B);
+  for (; i + 16 <= size; i += 16) {
+    __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&content[i]));
+    __m128i control = _mm_and_si128(_mm_cmpgt_epi8(chunk, before_nul),
+                                    _mm_cmplt_epi8(chunk, space));
+    __m128i text = _mm_or_si128(
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, tab),
+                                  _mm_cmpeq_epi8(chunk, line_feed)),
+                     _mm_or_si128(_mm_cmpeq_epi8(chunk, form_feed),
+                                  _mm_cmpeq_epi8(chunk, carriage_return))),
+        _mm_cmpeq_epi8(chunk, escape));
+    if (_mm_movemask_epi8(_mm_andnot_si128(text, control)))
+      return true;
+  }
+#endif
+  for (; i < size; ++i) {
+    if (kByteLooksBinary[static_cast<unsigned char>(content[i])])
+      return true;
+  }
+  return false;
+}
+
 // Returns true and sets result to "application/octet-stream" if the content
 // appears to be binary data. Otherwise, returns false and sets "text/plain".
 // Clears have_enough_content if more data could possibly change the result.
@@ -701,13 +745,11 @@ static bool SniffBinary(const char* content,
     return false;
   }
 
-  // Next we look to see if any of the bytes "look binary."
-  for (size_t i = 0; i < size; ++i) {
-    // If we a see a binary-looking byte, we think the content is binary.
-    if (kByteLooksBinary[static_cast<unsigned char>(content[i])]) {
-      result->assign("application/octet-stream");
-      return true;
-    }
+  // Next we look to see if any of the bytes "look binary." If we a see a
+  // binary-looking byte, we think the content is binary.
+  if (HasBinaryLookingByte(content, size)) {
+    result->assign("application/octet-stream");
+    return true;
   }
 
   // No evidence either way. Default to non-binary and, if truncated, clear
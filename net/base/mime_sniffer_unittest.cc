@@ -394,6 +394,23 @@ TEST(MimeSnifferTest, LooksBinary) {
   EXPECT_EQ("application/octet-stream", mime_type);
 }
 
+// Checks every byte value at every position within a run of bytes, so that it
+// is looked at both in and after the blocks the sniffer scans at once.
+TEST(MimeSnifferTest, LooksBinaryEveryByte) {
+  for (int byte = 0; byte < 0x100; ++byte) {
+    bool looks_binary = byte < 0x20 && byte != '\t' && byte != '\n' &&
+                        byte != '\f' && byte != '\r' && byte != 0x1B;
+    for (size_t pos = 0; pos < 40; ++pos) {
+      std::string content(40, 'x');
+      content[pos] = static_cast<char>(byte);
+      EXPECT_EQ(looks_binary ? "application/octet-stream" : "text/plain",
+                SniffMimeType(content, "http://www.example.com/",
+                              "text/plain"))
+          << "byte " << byte << " at " << pos;
+    }
+  }
+}
+
 TEST(MimeSnifferTest, OfficeTest) {
   SnifferTest tests[] = {
     // Check for URLs incorrectly reported as Microsoft Office files.
@@ -70,6 +70,11 @@ EVENT_TYPE(HOST_RESOLVER_IMPL_IPV6_SUPPORTED)
 // This event is logged when a request is handled by a cache entry.
 EVENT_TYPE(HOST_RESOLVER_IMPL_CACHE_HIT)
 
+// This event is logged when a request is handled by a cache entry whose TTL
+// has expired but which is still within the stale period. A background Job is
+// started to refresh the entry.
+EVENT_TYPE(HOST_RESOLVER_IMPL_STALE_CACHE_HIT)
+
 // This event is logged when a request is handled by a HOSTS entry.
 EVENT_TYPE(HOST_RESOLVER_IMPL_HOSTS_HIT)
 
@@ -106,6 +111,10 @@ EVENT_TYPE(HOST_RESOLVER_IMPL_JOB_EVICTED)
 // PriorityDispatch.
 EVENT_TYPE(HOST_RESOLVER_IMPL_JOB_STARTED)
 
+// This event is logged for a HostResolverImpl::Job that refreshes a stale
+// cache entry. Such a Job keeps running after all its requests are cancelled.
+EVENT_TYPE(HOST_RESOLVER_IMPL_JOB_REFRESH)
+
 // This event is created when HostResolverImpl::ProcJob is about to start a new
 // attempt to resolve the host.
 //
@@ -762,6 +771,18 @@ EVENT_TYPE(URL_REQUEST_REDIRECTED)
 // block it, and when the delegate allows the request to resume.
 EVENT_TYPE(URL_REQUEST_DELEGATE)
 
+// Measures the time a request is held back by the ResourceScheduler because
+// its client has enough delayable requests in flight. Both the BEGIN and the
+// END phases have the following parameters attached, describing the state the
+// decision was made on:
+//   {
+//     "max_delayable_requests": <The number of delayable requests allowed>,
+//     "delayable_requests_in_flight": <The number already in flight>,
+//     "throughput_kbps": <The estimated throughput, or 0 if unknown>,
+//     "rtt_ms": <The estimated round trip time, or 0 if unknown>,
+//   }
+EVENT_TYPE(RESOURCE_SCHEDULER_DELAYED)
+
 // Logged when a delegate informs the URL_REQUEST of what's currently blocking
 // the request. The parameters attached to the begin event are:
 //   {
@@ -823,6 +844,18 @@ EVENT_TYPE(HTTP_CACHE_WRITE_INFO)
 EVENT_TYPE(HTTP_CACHE_READ_DATA)
 EVENT_TYPE(HTTP_CACHE_WRITE_DATA)
 
+// Measures the time a transaction reads a disk cache entry's body while
+// another transaction is still writing it, instead of waiting for the writer
+// to finish. The END phase contains the following parameters:
+//
+//   {
+//     "body_complete": <True if the writer stored the whole body>,
+//   }
+//
+// The event has no parameters if the transaction needs to validate the entry
+// and goes back to waiting for the writer instead.
+EVENT_TYPE(HTTP_CACHE_READ_WHILE_WRITING)
+
 // ------------------------------------------------------------------------
 // Disk Cache / Memory Cache
 // ------------------------------------------------------------------------
@@ -1209,6 +1242,18 @@ EVENT_TYPE(SPDY_SESSION_STREAM_STALLED_BY_SESSION_SEND_WINDOW)
 // A stream is stalled by its send window being closed.
 EVENT_TYPE(SPDY_SESSION_STREAM_STALLED_BY_STREAM_SEND_WINDOW)
 
+// How long the writes of the session waited in its write queue, logged
+// when it is closing. Priorities with no writes are left out.
+//   {
+//     <priority>: {
+//       "writes"    : <The number of frames written>,
+//       "average_ms": <The average time they waited>,
+//       "max_ms"    : <The longest time one waited>,
+//     },
+//     ...
+//   }
+EVENT_TYPE(SPDY_SESSION_WRITE_QUEUE_LATENCY)
+
 // Session is closing
 //   {
 //     "net_error"  : <The error status of the closure>,
@@ -1335,6 +1380,10 @@ EVENT_TYPE(QUIC_SESSION)
 //   }
 EVENT_TYPE(QUIC_SESSION_CLOSE_ON_ERROR)
 
+// Session moved its connection to a new socket after the local IP address
+// changed.
+EVENT_TYPE(QUIC_SESSION_MIGRATED)
+
 // Session received a QUIC packet.
 //   {
 //     "peer_address": <The ip:port of the peer>,
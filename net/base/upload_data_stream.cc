@@ -188,6 +188,11 @@ int UploadDataStream::ReadInternal(scoped_refptr<DrainableIOBuffer> buf,
     if (buf->BytesRemaining() == 0)
       break;
 
+    // Have the next element read ahead too, so that its data is ready when
+    // this one ends rather than waiting for a file read then.
+    if (element_index_ + 1 < element_readers_.size())
+      element_readers_[element_index_ + 1]->StartReadAhead();
+
     int result = reader->Read(
         buf.get(),
         buf->BytesRemaining(),
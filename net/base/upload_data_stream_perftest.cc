@@ -0,0 +1,103 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/file_util.h"
+#include "base/files/file_path.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/memory/scoped_vector.h"
+#include "base/message_loop/message_loop.h"
+#include "base/run_loop.h"
+#include "base/test/perf_time_logger.h"
+#include "base/threading/thread.h"
+#include "base/time/time.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/base/test_completion_callback.h"
+#include "net/base/upload_data_stream.h"
+#include "net/base/upload_file_element_reader.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+const int kNumFiles = 8;
+const int kFileSize = 1024 * 1024;
+const int kBufferSize = 1 << 14;  // 16KB, as HttpStreamParser uses.
+
+class UploadDataStreamPerfTest : public testing::Test {
+ protected:
+  UploadDataStreamPerfTest() : file_thread_("UploadDataStreamPerfTestFile") {}
+
+  virtual void SetUp() {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    ASSERT_TRUE(file_thread_.Start());
+    const std::string data(kFileSize, 'x');
+    for (int i = 0; i < kNumFiles; ++i) {
+      base::FilePath path;
+      ASSERT_TRUE(base::CreateTemporaryFileInDir(temp_dir_.path(), &path));
+      ASSERT_EQ(kFileSize, base::WriteFile(path, data.data(), kFileSize));
+      file_paths_.push_back(path);
+    }
+  }
+
+  virtual void TearDown() {
+    file_thread_.Stop();
+    base::RunLoop().RunUntilIdle();
+  }
+
+  // Reads a stream of all the files in buffers of |kBufferSize| bytes. When
+  // |send_delay| is not zero, waits that long after each read, as a socket
+  // write would.
+  void ReadFiles(const std::string& description, base::TimeDelta send_delay) {
+    ScopedVector<UploadElementReader> element_readers;
+    for (size_t i = 0; i < file_paths_.size(); ++i) {
+      element_readers.push_back(new UploadFileElementReader(
+          file_thread_.message_loop_proxy().get(), file_paths_[i], 0,
+          kuint64max, base::Time()));
+    }
+    UploadDataStream stream(element_readers.Pass(), 0);
+    TestCompletionCallback init_callback;
+    ASSERT_EQ(OK, init_callback.GetResult(
+        stream.Init(init_callback.callback())));
+
+    scoped_refptr<IOBuffer> buf = new IOBuffer(kBufferSize);
+    base::PerfTimeLogger timer(description.c_str());
+    while (!stream.IsEOF()) {
+      TestCompletionCallback read_callback;
+      ASSERT_LT(0, read_callback.GetResult(
+          stream.Read(buf.get(), kBufferSize, read_callback.callback())));
+      if (send_delay != base::TimeDelta()) {
+        base::RunLoop run_loop;
+        base::MessageLoop::current()->PostDelayedTask(
+            FROM_HERE, run_loop.QuitClosure(), send_delay);
+        run_loop.Run();
+      }
+    }
+    timer.Done();
+    EXPECT_EQ(static_cast<uint64>(kNumFiles) * kFileSize, stream.position());
+  }
+
+  base::MessageLoopForIO message_loop_;
+  base::Thread file_thread_;
+  base::ScopedTempDir temp_dir_;
+  std::vector<base::FilePath> file_paths_;
+};
+
+TEST_F(UploadDataStreamPerfTest, ReadFiles) {
+  ReadFiles("Read upload files", base::TimeDelta());
+}
+
+TEST_F(UploadDataStreamPerfTest, ReadFilesWhileSending) {
+  ReadFiles("Read upload files while sending",
+            base::TimeDelta::FromMicroseconds(50));
+}
+
+}  // namespace
+
+}  // namespace net
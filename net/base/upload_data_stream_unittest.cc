@@ -362,6 +362,58 @@ TEST_F(UploadDataStreamTest, FileAndBytes) {
   ASSERT_TRUE(stream.IsEOF());
 }
 
+// The next file element is read ahead while the current one is read, so the
+// stream doesn't wait for the file at the element boundary.
+TEST_F(UploadDataStreamTest, ReadAheadNextFile) {
+  base::FilePath first_file_path;
+  ASSERT_TRUE(base::CreateTemporaryFileInDir(temp_dir_.path(),
+                                             &first_file_path));
+  const std::string first_file_data(kTestBufferSize, 'a');
+  ASSERT_EQ(static_cast<int>(first_file_data.size()),
+            base::WriteFile(first_file_path, first_file_data.data(),
+                            first_file_data.size()));
+  base::FilePath second_file_path;
+  ASSERT_TRUE(base::CreateTemporaryFileInDir(temp_dir_.path(),
+                                             &second_file_path));
+  ASSERT_EQ(static_cast<int>(kTestDataSize),
+            base::WriteFile(second_file_path, kTestData, kTestDataSize));
+
+  element_readers_.push_back(
+      new UploadFileElementReader(base::MessageLoopProxy::current().get(),
+                                  first_file_path,
+                                  0,
+                                  kuint64max,
+                                  base::Time()));
+  element_readers_.push_back(
+      new UploadFileElementReader(base::MessageLoopProxy::current().get(),
+                                  second_file_path,
+                                  0,
+                                  kuint64max,
+                                  base::Time()));
+
+  TestCompletionCallback init_callback;
+  UploadDataStream stream(element_readers_.Pass(), 0);
+  ASSERT_EQ(ERR_IO_PENDING, stream.Init(init_callback.callback()));
+  ASSERT_EQ(OK, init_callback.WaitForResult());
+
+  // The first read fills the buffer with the first file.
+  scoped_refptr<IOBuffer> buf = new IOBuffer(kTestBufferSize);
+  TestCompletionCallback read_callback1;
+  ASSERT_EQ(ERR_IO_PENDING,
+            stream.Read(buf.get(), kTestBufferSize, read_callback1.callback()));
+  ASSERT_EQ(static_cast<int>(kTestBufferSize), read_callback1.WaitForResult());
+  EXPECT_EQ(first_file_data, std::string(buf->data(), kTestBufferSize));
+  base::RunLoop().RunUntilIdle();
+
+  // The second file was read meanwhile.
+  TestCompletionCallback read_callback2;
+  ASSERT_EQ(static_cast<int>(kTestDataSize),
+            stream.Read(buf.get(), kTestBufferSize, read_callback2.callback()));
+  EXPECT_EQ(std::string(kTestData), std::string(buf->data(), kTestDataSize));
+  EXPECT_TRUE(stream.IsEOF());
+  EXPECT_FALSE(read_callback2.have_result());
+}
+
 TEST_F(UploadDataStreamTest, Chunk) {
   const uint64 kStreamSize = kTestDataSize*2;
   UploadDataStream stream(UploadDataStream::CHUNKED, 0);
@@ -18,4 +18,7 @@ bool UploadElementReader::IsInMemory() const {
   return false;
 }
 
+void UploadElementReader::StartReadAhead() {
+}
+
 }  // namespace net
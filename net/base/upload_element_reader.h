@@ -53,6 +53,11 @@ class NET_EXPORT UploadElementReader {
                    int buf_length,
                    const CompletionCallback& callback) = 0;
 
+  // Starts reading data ahead of Read() calls, if the reader supports it, so
+  // that the data is ready by the time it is needed. Must only be called after
+  // a successful Init(). The default implementation does nothing.
+  virtual void StartReadAhead();
+
  private:
   DISALLOW_COPY_AND_ASSIGN(UploadElementReader);
 };
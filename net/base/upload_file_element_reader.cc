@@ -4,6 +4,8 @@
 
 #include "net/base/upload_file_element_reader.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/file_util.h"
 #include "base/location.h"
@@ -22,6 +24,9 @@ uint64 overriding_content_length = 0;
 
 }  // namespace
 
+const int UploadFileElementReader::kReadAheadChunkSize = 64 * 1024;
+const size_t UploadFileElementReader::kMaxReadAheadChunks = 4;
+
 UploadFileElementReader::UploadFileElementReader(
     base::TaskRunner* task_runner,
     const base::FilePath& path,
@@ -35,6 +40,10 @@ UploadFileElementReader::UploadFileElementReader(
       expected_modification_time_(expected_modification_time),
       content_length_(0),
       bytes_remaining_(0),
+      bytes_unread_(0),
+      file_read_pending_(false),
+      read_ahead_error_(OK),
+      pending_read_buf_length_(0),
       weak_ptr_factory_(this) {
   DCHECK(task_runner_.get());
 }
@@ -76,27 +85,62 @@ int UploadFileElementReader::Read(IOBuffer* buf,
                                   int buf_length,
                                   const CompletionCallback& callback) {
   DCHECK(!callback.is_null());
+  DCHECK(pending_read_callback_.is_null());
 
   uint64 num_bytes_to_read =
       std::min(BytesRemaining(), static_cast<uint64>(buf_length));
   if (num_bytes_to_read == 0)
     return 0;
 
-  int result = file_stream_->Read(
-      buf, num_bytes_to_read,
-      base::Bind(base::IgnoreResult(&UploadFileElementReader::OnReadCompleted),
-                 weak_ptr_factory_.GetWeakPtr(),
-                 callback));
-  // Even in async mode, FileStream::Read() may return the result synchronously.
-  if (result != ERR_IO_PENDING)
-    return OnReadCompleted(CompletionCallback(), result);
-  return ERR_IO_PENDING;
+  if (read_ahead_chunks_.empty() && read_ahead_error_ == OK) {
+    StartReadAhead();
+    if (read_ahead_chunks_.empty() && read_ahead_error_ == OK) {
+      DCHECK(file_read_pending_);
+      pending_read_buf_ = buf;
+      pending_read_buf_length_ = static_cast<int>(num_bytes_to_read);
+      pending_read_callback_ = callback;
+      return ERR_IO_PENDING;
+    }
+  }
+
+  int result = CopyReadAheadData(buf, static_cast<int>(num_bytes_to_read));
+  StartReadAhead();
+  return result;
+}
+
+void UploadFileElementReader::StartReadAhead() {
+  while (!file_read_pending_ && read_ahead_error_ == OK &&
+         bytes_unread_ > 0 &&
+         read_ahead_chunks_.size() < kMaxReadAheadChunks) {
+    DCHECK(file_stream_);
+    int chunk_size = static_cast<int>(
+        std::min(bytes_unread_, static_cast<uint64>(kReadAheadChunkSize)));
+    scoped_refptr<IOBuffer> chunk = new IOBuffer(chunk_size);
+    file_read_pending_ = true;
+    int result = file_stream_->Read(
+        chunk.get(), chunk_size,
+        base::Bind(&UploadFileElementReader::OnReadAheadCompleted,
+                   weak_ptr_factory_.GetWeakPtr(),
+                   chunk));
+    // Even in async mode, FileStream::Read() may return the result
+    // synchronously.
+    if (result == ERR_IO_PENDING)
+      return;
+    DidReadAhead(chunk.get(), result);
+  }
 }
 
 void UploadFileElementReader::Reset() {
   weak_ptr_factory_.InvalidateWeakPtrs();
   bytes_remaining_ = 0;
   content_length_ = 0;
+  bytes_unread_ = 0;
+  read_ahead_chunks_.clear();
+  file_read_pending_ = false;
+  read_ahead_error_ = OK;
+  pending_read_buf_ = NULL;
+  pending_read_buf_length_ = 0;
+  pending_read_callback_.Reset();
   file_stream_.reset();
 }
 
@@ -182,23 +226,74 @@ void UploadFileElementReader::OnGetFileInfoCompleted(
 
   content_length_ = length;
   bytes_remaining_ = GetContentLength();
+  bytes_unread_ = bytes_remaining_;
   callback.Run(OK);
 }
 
-int UploadFileElementReader::OnReadCompleted(
-    const CompletionCallback& callback,
+void UploadFileElementReader::OnReadAheadCompleted(
+    scoped_refptr<IOBuffer> chunk,
     int result) {
+  DidReadAhead(chunk.get(), result);
+  StartReadAhead();
+
+  if (pending_read_callback_.is_null())
+    return;
+  if (read_ahead_chunks_.empty() && read_ahead_error_ == OK) {
+    DCHECK(file_read_pending_);
+    return;
+  }
+
+  scoped_refptr<IOBuffer> buf;
+  buf.swap(pending_read_buf_);
+  CompletionCallback callback = pending_read_callback_;
+  pending_read_callback_.Reset();
+  int read_result = CopyReadAheadData(buf.get(), pending_read_buf_length_);
+  // Copying freed up room to read further ahead while the caller sends the
+  // data.
+  StartReadAhead();
+  callback.Run(read_result);
+}
+
+void UploadFileElementReader::DidReadAhead(IOBuffer* chunk, int result) {
+  DCHECK(file_read_pending_);
+  DCHECK_NE(ERR_IO_PENDING, result);
+  file_read_pending_ = false;
+
   if (result == 0)  // Reached end-of-file earlier than expected.
     result = ERR_UPLOAD_FILE_CHANGED;
 
-  if (result > 0) {
-    DCHECK_GE(bytes_remaining_, static_cast<uint64>(result));
-    bytes_remaining_ -= result;
+  if (result < 0) {
+    read_ahead_error_ = result;
+    return;
   }
 
-  if (!callback.is_null())
-    callback.Run(result);
-  return result;
+  DCHECK_GE(bytes_unread_, static_cast<uint64>(result));
+  bytes_unread_ -= result;
+  read_ahead_chunks_.push_back(new DrainableIOBuffer(chunk, result));
+}
+
+int UploadFileElementReader::CopyReadAheadData(IOBuffer* buf,
+                                               int buf_length) {
+  if (read_ahead_chunks_.empty()) {
+    DCHECK_NE(OK, read_ahead_error_);
+    return read_ahead_error_;
+  }
+
+  int bytes_copied = 0;
+  while (bytes_copied < buf_length && !read_ahead_chunks_.empty()) {
+    DrainableIOBuffer* chunk = read_ahead_chunks_.front().get();
+    int num_bytes =
+        std::min(chunk->BytesRemaining(), buf_length - bytes_copied);
+    memcpy(buf->data() + bytes_copied, chunk->data(), num_bytes);
+    chunk->DidConsume(num_bytes);
+    bytes_copied += num_bytes;
+    if (chunk->BytesRemaining() == 0)
+      read_ahead_chunks_.pop_front();
+  }
+
+  DCHECK_GE(bytes_remaining_, static_cast<uint64>(bytes_copied));
+  bytes_remaining_ -= bytes_copied;
+  return bytes_copied;
 }
 
 UploadFileElementReader::ScopedOverridingContentLengthForTests::
@@ -5,6 +5,8 @@
 #ifndef NET_BASE_UPLOAD_FILE_ELEMENT_READER_H_
 #define NET_BASE_UPLOAD_FILE_ELEMENT_READER_H_
 
+#include <deque>
+
 #include "base/compiler_specific.h"
 #include "base/files/file.h"
 #include "base/files/file_path.h"
@@ -21,11 +23,21 @@ class TaskRunner;
 
 namespace net {
 
+class DrainableIOBuffer;
 class FileStream;
+class IOBuffer;
 
 // An UploadElementReader implementation for file.
+//
+// The file is read ahead of Read() calls in chunks of up to
+// kReadAheadChunkSize bytes, keeping up to kMaxReadAheadChunks of them, so
+// that the next file read is in flight on |task_runner| while the caller is
+// sending the data already read.
 class NET_EXPORT UploadFileElementReader : public UploadElementReader {
  public:
+  static const int kReadAheadChunkSize;
+  static const size_t kMaxReadAheadChunks;
+
   // |task_runner| is used to perform file operations. It must not be NULL.
   UploadFileElementReader(base::TaskRunner* task_runner,
                           const base::FilePath& path,
@@ -49,6 +61,7 @@ class NET_EXPORT UploadFileElementReader : public UploadElementReader {
   virtual int Read(IOBuffer* buf,
                    int buf_length,
                    const CompletionCallback& callback) OVERRIDE;
+  virtual void StartReadAhead() OVERRIDE;
 
  private:
   FRIEND_TEST_ALL_PREFIXES(UploadDataStreamTest, FileSmallerThanLength);
@@ -69,8 +82,16 @@ class NET_EXPORT UploadFileElementReader : public UploadElementReader {
                               base::File::Info* file_info,
                               bool result);
 
-  // This method is used to implement Read().
-  int OnReadCompleted(const CompletionCallback& callback, int result);
+  // These methods are used to implement Read() and StartReadAhead().
+  // OnReadAheadCompleted() is called when an asynchronous file read into
+  // |chunk| completes, DidReadAhead() records the result of any file read.
+  void OnReadAheadCompleted(scoped_refptr<IOBuffer> chunk, int result);
+  void DidReadAhead(IOBuffer* chunk, int result);
+
+  // Copies up to |buf_length| bytes of read-ahead data into |buf|, and returns
+  // the number of bytes copied, or the read-ahead error if there is no data
+  // left before it.
+  int CopyReadAheadData(IOBuffer* buf, int buf_length);
 
   // Sets an value to override the result for GetContentLength().
   // Used for tests.
@@ -87,6 +108,26 @@ class NET_EXPORT UploadFileElementReader : public UploadElementReader {
   scoped_ptr<FileStream> file_stream_;
   uint64 content_length_;
   uint64 bytes_remaining_;
+
+  // Bytes not read from the file yet. The difference with |bytes_remaining_|
+  // is in |read_ahead_chunks_|.
+  uint64 bytes_unread_;
+
+  // Data read from the file but not returned by Read() yet, in file order.
+  std::deque<scoped_refptr<DrainableIOBuffer> > read_ahead_chunks_;
+
+  // True while a file read is in flight.
+  bool file_read_pending_;
+
+  // The error that stopped reading ahead, returned once the data before it
+  // has been read.
+  int read_ahead_error_;
+
+  // A Read() waiting for the file read in flight.
+  scoped_refptr<IOBuffer> pending_read_buf_;
+  int pending_read_buf_length_;
+  CompletionCallback pending_read_callback_;
+
   base::WeakPtrFactory<UploadFileElementReader> weak_ptr_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(UploadFileElementReader);
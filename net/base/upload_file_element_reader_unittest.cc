@@ -70,13 +70,54 @@ TEST_F(UploadFileElementReaderTest, ReadPartially) {
   EXPECT_EQ(bytes_.size() - buf.size(), reader_->BytesRemaining());
   EXPECT_EQ(std::vector<char>(bytes_.begin(), bytes_.begin() + kHalfSize), buf);
 
+  // The second half was read ahead with the first one.
   TestCompletionCallback read_callback2;
-  EXPECT_EQ(ERR_IO_PENDING,
+  EXPECT_EQ(static_cast<int>(buf.size()),
             reader_->Read(
                 wrapped_buffer.get(), buf.size(), read_callback2.callback()));
-  EXPECT_EQ(static_cast<int>(buf.size()), read_callback2.WaitForResult());
   EXPECT_EQ(0U, reader_->BytesRemaining());
   EXPECT_EQ(std::vector<char>(bytes_.begin() + kHalfSize, bytes_.end()), buf);
+  EXPECT_FALSE(read_callback2.have_result());
+}
+
+TEST_F(UploadFileElementReaderTest, ReadAhead) {
+  // More data than fits in the read-ahead chunks, and not a multiple of the
+  // read size.
+  const size_t kFileSize =
+      UploadFileElementReader::kReadAheadChunkSize *
+          (UploadFileElementReader::kMaxReadAheadChunks + 2) + 1000;
+  std::vector<char> file_data(kFileSize);
+  for (size_t i = 0; i < file_data.size(); ++i)
+    file_data[i] = static_cast<char>(i * 7);
+  ASSERT_EQ(static_cast<int>(kFileSize),
+            base::WriteFile(temp_file_path_, &file_data[0], kFileSize));
+
+  TestCompletionCallback init_callback;
+  ASSERT_EQ(ERR_IO_PENDING, reader_->Init(init_callback.callback()));
+  EXPECT_EQ(OK, init_callback.WaitForResult());
+  ASSERT_EQ(kFileSize, reader_->BytesRemaining());
+
+  const int kReadSize = 10000;
+  scoped_refptr<IOBuffer> buf = new IOBuffer(kReadSize);
+  std::vector<char> data_read;
+  int num_sync_reads = 0;
+  while (reader_->BytesRemaining() > 0) {
+    // Let the reads ahead complete, as they would while sending the data.
+    base::RunLoop().RunUntilIdle();
+    TestCompletionCallback read_callback;
+    int result = reader_->Read(buf.get(), kReadSize, read_callback.callback());
+    if (result == ERR_IO_PENDING)
+      result = read_callback.WaitForResult();
+    else
+      ++num_sync_reads;
+    ASSERT_LT(0, result);
+    data_read.insert(data_read.end(), buf->data(), buf->data() + result);
+  }
+  EXPECT_EQ(file_data, data_read);
+
+  // Only the first read had to wait for the file.
+  EXPECT_EQ(static_cast<int>(data_read.size() / kReadSize),
+            num_sync_reads);
 }
 
 TEST_F(UploadFileElementReaderTest, ReadAll) {
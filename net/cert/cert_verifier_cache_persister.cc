@@ -0,0 +1,91 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/cert/cert_verifier_cache_persister.h"
+
+#include "base/bind.h"
+#include "base/file_util.h"
+#include "base/logging.h"
+#include "base/message_loop/message_loop.h"
+#include "base/message_loop/message_loop_proxy.h"
+#include "base/pickle.h"
+#include "base/sequenced_task_runner.h"
+#include "base/task_runner_util.h"
+
+namespace {
+
+std::string LoadCacheFile(const base::FilePath& path) {
+  std::string result;
+  if (!base::ReadFileToString(path, &result))
+    return std::string();
+  return result;
+}
+
+}  // namespace
+
+namespace net {
+
+CertVerifierCachePersister::CertVerifierCachePersister(
+    MultiThreadedCertVerifier* verifier,
+    const base::FilePath& directory,
+    base::SequencedTaskRunner* file_task_runner)
+    : verifier_(verifier),
+      writer_(directory.AppendASCII("CertVerifierCache"), file_task_runner),
+      foreground_runner_(base::MessageLoop::current()->message_loop_proxy()),
+      weak_ptr_factory_(this) {
+  verifier_->SetCacheDelegate(this);
+
+  base::PostTaskAndReplyWithResult(
+      file_task_runner,
+      FROM_HERE,
+      base::Bind(&LoadCacheFile, writer_.path()),
+      base::Bind(&CertVerifierCachePersister::CompleteLoad,
+                 weak_ptr_factory_.GetWeakPtr()));
+}
+
+CertVerifierCachePersister::~CertVerifierCachePersister() {
+  DCHECK(foreground_runner_->RunsTasksOnCurrentThread());
+
+  if (writer_.HasPendingWrite())
+    writer_.DoScheduledWrite();
+
+  verifier_->SetCacheDelegate(NULL);
+}
+
+void CertVerifierCachePersister::CacheIsDirty(
+    MultiThreadedCertVerifier* verifier) {
+  DCHECK(foreground_runner_->RunsTasksOnCurrentThread());
+  DCHECK_EQ(verifier_, verifier);
+
+  writer_.ScheduleWrite(this);
+}
+
+bool CertVerifierCachePersister::SerializeData(std::string* data) {
+  DCHECK(foreground_runner_->RunsTasksOnCurrentThread());
+
+  Pickle pickle;
+  verifier_->PersistCache(&pickle);
+  data->assign(static_cast<const char*>(pickle.data()), pickle.size());
+  return true;
+}
+
+bool CertVerifierCachePersister::LoadEntries(const std::string& serialized) {
+  DCHECK(foreground_runner_->RunsTasksOnCurrentThread());
+
+  Pickle pickle(serialized.data(), serialized.size());
+  return verifier_->LoadCache(pickle);
+}
+
+void CertVerifierCachePersister::CompleteLoad(const std::string& serialized) {
+  DCHECK(foreground_runner_->RunsTasksOnCurrentThread());
+
+  if (serialized.empty())
+    return;
+
+  // A corrupt or outdated file is simply replaced on the next write.
+  if (!LoadEntries(serialized))
+    LOG(WARNING) << "Failed to load the certificate verification cache.";
+}
+
+}  // namespace net
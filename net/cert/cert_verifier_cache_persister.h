@@ -0,0 +1,74 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// CertVerifierCachePersister saves the certificate verification results cached
+// by a MultiThreadedCertVerifier to disk, and loads them at startup, so that
+// the first TLS connections after a restart don't all pay for building and
+// verifying a chain.
+//
+// As with TransportSecurityPersister, loading doesn't block startup: results
+// are loaded on the file task runner and merged into the cache when ready.
+// Writes are batched with an ImportantFileWriter.
+
+#ifndef NET_CERT_CERT_VERIFIER_CACHE_PERSISTER_H_
+#define NET_CERT_CERT_VERIFIER_CACHE_PERSISTER_H_
+
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/files/important_file_writer.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "net/base/net_export.h"
+#include "net/cert/multi_threaded_cert_verifier.h"
+
+namespace base {
+class SequencedTaskRunner;
+}
+
+namespace net {
+
+// Reads and updates the on-disk cache of certificate verification results.
+// Clients of this class should create, destroy, and call into it from the
+// thread |verifier| lives on.
+class NET_EXPORT CertVerifierCachePersister
+    : public MultiThreadedCertVerifier::CacheDelegate,
+      public base::ImportantFileWriter::DataSerializer {
+ public:
+  CertVerifierCachePersister(MultiThreadedCertVerifier* verifier,
+                             const base::FilePath& directory,
+                             base::SequencedTaskRunner* file_task_runner);
+  virtual ~CertVerifierCachePersister();
+
+  // MultiThreadedCertVerifier::CacheDelegate:
+  virtual void CacheIsDirty(MultiThreadedCertVerifier* verifier) OVERRIDE;
+
+  // ImportantFileWriter::DataSerializer:
+  //
+  // Serializes the results cached by |verifier_| with
+  // MultiThreadedCertVerifier::PersistCache().
+  virtual bool SerializeData(std::string* data) OVERRIDE;
+
+  // Adds the results in |serialized| to the cache of |verifier_|. Returns false
+  // if |serialized| could not be parsed.
+  bool LoadEntries(const std::string& serialized);
+
+ private:
+  void CompleteLoad(const std::string& serialized);
+
+  MultiThreadedCertVerifier* verifier_;
+
+  // Helper for safely writing the data.
+  base::ImportantFileWriter writer_;
+
+  scoped_refptr<base::SequencedTaskRunner> foreground_runner_;
+
+  base::WeakPtrFactory<CertVerifierCachePersister> weak_ptr_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(CertVerifierCachePersister);
+};
+
+}  // namespace net
+
+#endif  // NET_CERT_CERT_VERIFIER_CACHE_PERSISTER_H_
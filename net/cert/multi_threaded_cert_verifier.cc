@@ -11,6 +11,7 @@
 #include "base/compiler_specific.h"
 #include "base/message_loop/message_loop.h"
 #include "base/metrics/histogram.h"
+#include "base/pickle.h"
 #include "base/stl_util.h"
 #include "base/synchronization/lock.h"
 #include "base/threading/worker_pool.h"
@@ -78,6 +79,14 @@ const unsigned kMaxCacheEntries = 256;
 // The number of seconds for which we'll cache a cache entry.
 const unsigned kTTLSecs = 1800;  // 30 minutes.
 
+// Version of the format written by PersistCache(). Increment it when the
+// format changes, so that results persisted in the old format are discarded.
+const int kCacheFormatVersion = 1;
+
+uint32 GetCRLSetSequence(const CRLSet* crl_set) {
+  return crl_set ? crl_set->sequence() : 0;
+}
+
 }  // namespace
 
 MultiThreadedCertVerifier::CachedResult::CachedResult() : error(ERR_FAILED) {}
@@ -257,6 +266,7 @@ class CertVerifierWorker {
         cert_verifier_->HandleResult(cert_.get(),
                                      hostname_,
                                      flags_,
+                                     GetCRLSetSequence(crl_set_.get()),
                                      additional_trust_anchors_,
                                      error_,
                                      verify_result_);
@@ -395,7 +405,8 @@ MultiThreadedCertVerifier::MultiThreadedCertVerifier(
       cache_hits_(0),
       inflight_joins_(0),
       verify_proc_(verify_proc),
-      trust_anchor_provider_(NULL) {
+      trust_anchor_provider_(NULL),
+      cache_delegate_(NULL) {
   CertDatabase::GetInstance()->AddObserver(this);
 }
 
@@ -410,6 +421,132 @@ void MultiThreadedCertVerifier::SetCertTrustAnchorProvider(
   trust_anchor_provider_ = trust_anchor_provider;
 }
 
+void MultiThreadedCertVerifier::SetCacheDelegate(CacheDelegate* cache_delegate) {
+  DCHECK(CalledOnValidThread());
+  cache_delegate_ = cache_delegate;
+}
+
+void MultiThreadedCertVerifier::PersistCache(Pickle* pickle) {
+  DCHECK(CalledOnValidThread());
+
+  const CacheValidityPeriod now(base::Time::Now());
+  CacheExpirationFunctor expiration_functor;
+
+  pickle->WriteInt(kCacheFormatVersion);
+  for (CertVerifierCache::Iterator it(cache_); it.HasNext(); it.Advance()) {
+    const RequestParams& key = it.key();
+    const CachedResult& cached_result = it.value();
+    const CertVerifyResult& result = cached_result.result;
+    if (!expiration_functor(now, it.expiration()) || !result.verified_cert)
+      continue;
+
+    // Each entry is preceded by true, and the list is terminated by false.
+    pickle->WriteBool(true);
+    pickle->WriteString(key.hostname);
+    pickle->WriteInt(key.flags);
+    pickle->WriteUInt32(key.crl_set_sequence);
+    pickle->WriteInt(static_cast<int>(key.hash_values.size()));
+    for (size_t i = 0; i < key.hash_values.size(); ++i) {
+      pickle->WriteBytes(key.hash_values[i].data,
+                         sizeof(key.hash_values[i].data));
+    }
+    pickle->WriteInt64(it.expiration().verification_time.ToInternalValue());
+    pickle->WriteInt64(it.expiration().expiration_time.ToInternalValue());
+
+    pickle->WriteInt(cached_result.error);
+    result.verified_cert->Persist(pickle);
+    pickle->WriteUInt32(result.cert_status);
+    pickle->WriteBool(result.has_md5);
+    pickle->WriteBool(result.has_md2);
+    pickle->WriteBool(result.has_md4);
+    pickle->WriteInt(static_cast<int>(result.public_key_hashes.size()));
+    for (size_t i = 0; i < result.public_key_hashes.size(); ++i)
+      pickle->WriteString(result.public_key_hashes[i].ToString());
+    pickle->WriteBool(result.is_issued_by_known_root);
+    pickle->WriteBool(result.is_issued_by_additional_trust_anchor);
+    pickle->WriteBool(result.common_name_fallback_used);
+  }
+  pickle->WriteBool(false);
+}
+
+bool MultiThreadedCertVerifier::LoadCache(const Pickle& pickle) {
+  DCHECK(CalledOnValidThread());
+
+  const CacheValidityPeriod now(base::Time::Now());
+  CacheExpirationFunctor expiration_functor;
+
+  PickleIterator iter(pickle);
+  int version;
+  if (!iter.ReadInt(&version) || version != kCacheFormatVersion)
+    return false;
+
+  bool has_entry;
+  while (iter.ReadBool(&has_entry)) {
+    if (!has_entry)
+      return true;
+
+    RequestParams key;
+    int num_hash_values;
+    if (!iter.ReadString(&key.hostname) ||
+        !iter.ReadInt(&key.flags) ||
+        !iter.ReadUInt32(&key.crl_set_sequence) ||
+        !iter.ReadInt(&num_hash_values) ||
+        num_hash_values < 0) {
+      return false;
+    }
+    key.hash_values.resize(num_hash_values);
+    for (int i = 0; i < num_hash_values; ++i) {
+      const char* data;
+      if (!iter.ReadBytes(&data, sizeof(key.hash_values[i].data)))
+        return false;
+      memcpy(key.hash_values[i].data, data, sizeof(key.hash_values[i].data));
+    }
+
+    int64 verification_time;
+    int64 expiration_time;
+    CachedResult cached_result;
+    CertVerifyResult& result = cached_result.result;
+    if (!iter.ReadInt64(&verification_time) ||
+        !iter.ReadInt64(&expiration_time) ||
+        !iter.ReadInt(&cached_result.error)) {
+      return false;
+    }
+    result.verified_cert = X509Certificate::CreateFromPickle(
+        pickle, &iter, X509Certificate::PICKLETYPE_CERTIFICATE_CHAIN_V3);
+    int num_public_key_hashes;
+    if (!result.verified_cert.get() ||
+        !iter.ReadUInt32(&result.cert_status) ||
+        !iter.ReadBool(&result.has_md5) ||
+        !iter.ReadBool(&result.has_md2) ||
+        !iter.ReadBool(&result.has_md4) ||
+        !iter.ReadInt(&num_public_key_hashes) ||
+        num_public_key_hashes < 0) {
+      return false;
+    }
+    result.public_key_hashes.resize(num_public_key_hashes);
+    for (int i = 0; i < num_public_key_hashes; ++i) {
+      std::string hash;
+      if (!iter.ReadString(&hash) ||
+          !result.public_key_hashes[i].FromString(hash)) {
+        return false;
+      }
+    }
+    if (!iter.ReadBool(&result.is_issued_by_known_root) ||
+        !iter.ReadBool(&result.is_issued_by_additional_trust_anchor) ||
+        !iter.ReadBool(&result.common_name_fallback_used)) {
+      return false;
+    }
+
+    CacheValidityPeriod validity(
+        base::Time::FromInternalValue(verification_time),
+        base::Time::FromInternalValue(expiration_time));
+    if (!expiration_functor(now, validity) || cache_.Get(key, now))
+      continue;
+    cache_.Put(key, cached_result, now, validity);
+  }
+  return false;
+}
+
 int MultiThreadedCertVerifier::Verify(X509Certificate* cert,
                                       const std::string& hostname,
                                       int flags,
@@ -433,7 +570,8 @@ int MultiThreadedCertVerifier::Verify(X509Certificate* cert,
           trust_anchor_provider_->GetAdditionalTrustAnchors() : empty_cert_list;
 
   const RequestParams key(cert->fingerprint(), cert->ca_fingerprint(),
-                          hostname, flags, additional_trust_anchors);
+                          hostname, flags, GetCRLSetSequence(crl_set),
+                          additional_trust_anchors);
   const CertVerifierCache::value_type* cached_entry =
       cache_.Get(key, CacheValidityPeriod(base::Time::Now()));
   if (cached_entry) {
@@ -494,9 +632,11 @@ MultiThreadedCertVerifier::RequestParams::RequestParams(
     const SHA1HashValue& ca_fingerprint_arg,
     const std::string& hostname_arg,
     int flags_arg,
+    uint32 crl_set_sequence_arg,
     const CertificateList& additional_trust_anchors)
     : hostname(hostname_arg),
-      flags(flags_arg) {
+      flags(flags_arg),
+      crl_set_sequence(crl_set_sequence_arg) {
   hash_values.reserve(2 + additional_trust_anchors.size());
   hash_values.push_back(cert_fingerprint_arg);
   hash_values.push_back(ca_fingerprint_arg);
@@ -504,15 +644,22 @@ MultiThreadedCertVerifier::RequestParams::RequestParams(
     hash_values.push_back(additional_trust_anchors[i]->fingerprint());
 }
 
+MultiThreadedCertVerifier::RequestParams::RequestParams()
+    : flags(0),
+      crl_set_sequence(0) {
+}
+
 MultiThreadedCertVerifier::RequestParams::~RequestParams() {}
 
 bool MultiThreadedCertVerifier::RequestParams::operator<(
     const RequestParams& other) const {
-  // |flags| is compared before |cert_fingerprint|, |ca_fingerprint|, and
-  // |hostname| under assumption that integer comparisons are faster than
-  // memory and string comparisons.
+  // |flags| and |crl_set_sequence| are compared before |cert_fingerprint|,
+  // |ca_fingerprint|, and |hostname| under assumption that integer comparisons
+  // are faster than memory and string comparisons.
   if (flags != other.flags)
     return flags < other.flags;
+  if (crl_set_sequence != other.crl_set_sequence)
+    return crl_set_sequence < other.crl_set_sequence;
   if (hostname != other.hostname)
     return hostname < other.hostname;
   return std::lexicographical_compare(
@@ -527,13 +674,15 @@ void MultiThreadedCertVerifier::HandleResult(
     X509Certificate* cert,
     const std::string& hostname,
     int flags,
+    uint32 crl_set_sequence,
     const CertificateList& additional_trust_anchors,
     int error,
     const CertVerifyResult& verify_result) {
   DCHECK(CalledOnValidThread());
 
   const RequestParams key(cert->fingerprint(), cert->ca_fingerprint(),
-                          hostname, flags, additional_trust_anchors);
+                          hostname, flags, crl_set_sequence,
+                          additional_trust_anchors);
 
   CachedResult cached_result;
   cached_result.error = error;
@@ -542,6 +691,8 @@ void MultiThreadedCertVerifier::HandleResult(
   cache_.Put(
       key, cached_result, CacheValidityPeriod(now),
       CacheValidityPeriod(now, now + base::TimeDelta::FromSeconds(kTTLSecs)));
+  if (cache_delegate_)
+    cache_delegate_->CacheIsDirty(this);
 
   std::map<RequestParams, CertVerifierJob*>::iterator j;
   j = inflight_.find(key);
@@ -561,6 +712,8 @@ void MultiThreadedCertVerifier::OnCACertChanged(
   DCHECK(CalledOnValidThread());
 
   ClearCache();
+  if (cache_delegate_)
+    cache_delegate_->CacheIsDirty(this);
 }
 
 }  // namespace net
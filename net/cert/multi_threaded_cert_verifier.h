@@ -22,6 +22,8 @@
 #include "net/cert/cert_verify_result.h"
 #include "net/cert/x509_cert_types.h"
 
+class Pickle;
+
 namespace net {
 
 class CertTrustAnchorProvider;
@@ -37,6 +39,16 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier
       NON_EXPORTED_BASE(public base::NonThreadSafe),
       public CertDatabase::Observer {
  public:
+  // Notified when the cache of verification results changes, so that it can
+  // be persisted.
+  class NET_EXPORT_PRIVATE CacheDelegate {
+   public:
+    virtual void CacheIsDirty(MultiThreadedCertVerifier* verifier) = 0;
+
+   protected:
+    virtual ~CacheDelegate() {}
+  };
+
   explicit MultiThreadedCertVerifier(CertVerifyProc* verify_proc);
 
   // When the verifier is destroyed, all certificate verifications requests are
@@ -53,6 +65,19 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier
   void SetCertTrustAnchorProvider(
       CertTrustAnchorProvider* trust_anchor_provider);
 
+  // Sets the CacheDelegate to notify, which may be NULL. It must outlive the
+  // MultiThreadedCertVerifier or be reset before it is destroyed.
+  void SetCacheDelegate(CacheDelegate* cache_delegate);
+
+  // Serializes the unexpired cached results into |pickle|, so that they can be
+  // restored with LoadCache() after a restart.
+  void PersistCache(Pickle* pickle);
+
+  // Adds the cached results serialized by PersistCache() which have not
+  // expired yet. Results cached since startup are not overwritten. Returns
+  // false if |pickle| is malformed or uses another format version.
+  bool LoadCache(const Pickle& pickle);
+
   // CertVerifier implementation
   virtual int Verify(X509Certificate* cert,
                      const std::string& hostname,
@@ -78,6 +103,7 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier
                            RequestParamsComparators);
   FRIEND_TEST_ALL_PREFIXES(MultiThreadedCertVerifierTest,
                            CertTrustAnchorProvider);
+  FRIEND_TEST_ALL_PREFIXES(MultiThreadedCertVerifierTest, PersistCache);
 
   // Input parameters of a certificate verification request.
   struct NET_EXPORT_PRIVATE RequestParams {
@@ -85,13 +111,17 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier
                   const SHA1HashValue& ca_fingerprint_arg,
                   const std::string& hostname_arg,
                   int flags_arg,
+                  uint32 crl_set_sequence_arg,
                   const CertificateList& additional_trust_anchors);
+    RequestParams();
     ~RequestParams();
 
     bool operator<(const RequestParams& other) const;
 
     std::string hostname;
     int flags;
+    // Sequence number of the CRLSet the result was checked against, or 0.
+    uint32 crl_set_sequence;
     std::vector<SHA1HashValue> hash_values;
   };
 
@@ -132,6 +162,7 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier
   void HandleResult(X509Certificate* cert,
                     const std::string& hostname,
                     int flags,
+                    uint32 crl_set_sequence,
                     const CertificateList& additional_trust_anchors,
                     int error,
                     const CertVerifyResult& verify_result);
@@ -161,6 +192,8 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier
 
   CertTrustAnchorProvider* trust_anchor_provider_;
 
+  CacheDelegate* cache_delegate_;
+
   DISALLOW_COPY_AND_ASSIGN(MultiThreadedCertVerifier);
 };
 
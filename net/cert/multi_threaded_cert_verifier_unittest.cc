@@ -7,6 +7,7 @@
 #include "base/bind.h"
 #include "base/files/file_path.h"
 #include "base/format_macros.h"
+#include "base/pickle.h"
 #include "base/strings/stringprintf.h"
 #include "net/base/net_errors.h"
 #include "net/base/net_log.h"
@@ -121,6 +122,69 @@ TEST_F(MultiThreadedCertVerifierTest, CacheHit) {
   ASSERT_EQ(1u, verifier_.GetCacheSize());
 }
 
+// Tests that cached results survive being persisted and loaded into a new
+// verifier.
+TEST_F(MultiThreadedCertVerifierTest, PersistCache) {
+  base::FilePath certs_dir = GetTestCertsDirectory();
+  scoped_refptr<X509Certificate> test_cert(
+      ImportCertFromFile(certs_dir, "ok_cert.pem"));
+  ASSERT_NE(static_cast<X509Certificate*>(NULL), test_cert);
+
+  int error;
+  CertVerifyResult verify_result;
+  TestCompletionCallback callback;
+  CertVerifier::RequestHandle request_handle;
+
+  error = verifier_.Verify(test_cert.get(),
+                           "www.example.com",
+                           0,
+                           NULL,
+                           &verify_result,
+                           callback.callback(),
+                           &request_handle,
+                           BoundNetLog());
+  ASSERT_EQ(ERR_IO_PENDING, error);
+  error = callback.WaitForResult();
+  ASSERT_TRUE(IsCertificateError(error));
+  ASSERT_EQ(1u, verifier_.GetCacheSize());
+
+  Pickle pickle;
+  verifier_.PersistCache(&pickle);
+
+  MultiThreadedCertVerifier restored(new MockCertVerifyProc());
+  EXPECT_TRUE(restored.LoadCache(pickle));
+  ASSERT_EQ(1u, restored.GetCacheSize());
+
+  // Loading the same results again doesn't add duplicates.
+  EXPECT_TRUE(restored.LoadCache(pickle));
+  ASSERT_EQ(1u, restored.GetCacheSize());
+
+  CertVerifyResult restored_result;
+  error = restored.Verify(test_cert.get(),
+                          "www.example.com",
+                          0,
+                          NULL,
+                          &restored_result,
+                          callback.callback(),
+                          &request_handle,
+                          BoundNetLog());
+  // Synchronous completion from the loaded cache.
+  ASSERT_NE(ERR_IO_PENDING, error);
+  ASSERT_TRUE(IsCertificateError(error));
+  ASSERT_TRUE(request_handle == NULL);
+  EXPECT_EQ(1u, restored.cache_hits());
+  EXPECT_EQ(verify_result.cert_status, restored_result.cert_status);
+  ASSERT_TRUE(restored_result.verified_cert.get());
+  EXPECT_TRUE(test_cert->Equals(restored_result.verified_cert.get()));
+
+  // Results written in an unknown format are rejected.
+  Pickle bad_pickle;
+  bad_pickle.WriteInt(-1);
+  MultiThreadedCertVerifier rejected(new MockCertVerifyProc());
+  EXPECT_FALSE(rejected.LoadCache(bad_pickle));
+  EXPECT_EQ(0u, rejected.GetCacheSize());
+}
+
 // Tests the same server certificate with different intermediate CA
 // certificates.  These should be treated as different certificate chains even
 // though the two X509Certificate objects contain the same server certificate.
@@ -335,51 +399,59 @@ TEST_F(MultiThreadedCertVerifierTest, RequestParamsComparators) {
   } tests[] = {
     {  // Test for basic equivalence.
       MultiThreadedCertVerifier::RequestParams(a_key, a_key, "www.example.test",
-                                               0, test_list),
+                                               0, 0, test_list),
       MultiThreadedCertVerifier::RequestParams(a_key, a_key, "www.example.test",
-                                               0, test_list),
+                                               0, 0, test_list),
       0,
     },
     {  // Test that different certificates but with the same CA and for
        // the same host are different validation keys.
       MultiThreadedCertVerifier::RequestParams(a_key, a_key, "www.example.test",
-                                               0, test_list),
+                                               0, 0, test_list),
       MultiThreadedCertVerifier::RequestParams(z_key, a_key, "www.example.test",
-                                               0, test_list),
+                                               0, 0, test_list),
       -1,
     },
     {  // Test that the same EE certificate for the same host, but with
        // different chains are different validation keys.
       MultiThreadedCertVerifier::RequestParams(a_key, z_key, "www.example.test",
-                                               0, test_list),
+                                               0, 0, test_list),
       MultiThreadedCertVerifier::RequestParams(a_key, a_key, "www.example.test",
-                                               0, test_list),
+                                               0, 0, test_list),
       1,
     },
     {  // The same certificate, with the same chain, but for different
        // hosts are different validation keys.
       MultiThreadedCertVerifier::RequestParams(a_key, a_key,
-                                               "www1.example.test", 0,
+                                               "www1.example.test", 0, 0,
                                                test_list),
       MultiThreadedCertVerifier::RequestParams(a_key, a_key,
-                                               "www2.example.test", 0,
+                                               "www2.example.test", 0, 0,
                                                test_list),
       -1,
     },
     {  // The same certificate, chain, and host, but with different flags
        // are different validation keys.
       MultiThreadedCertVerifier::RequestParams(a_key, a_key, "www.example.test",
-                                               CertVerifier::VERIFY_EV_CERT,
+                                               CertVerifier::VERIFY_EV_CERT, 0,
                                                test_list),
       MultiThreadedCertVerifier::RequestParams(a_key, a_key, "www.example.test",
-                                               0, test_list),
+                                               0, 0, test_list),
       1,
     },
+    {  // The same certificate, chain, and host, but checked against different
+       // CRLSets are different validation keys.
+      MultiThreadedCertVerifier::RequestParams(a_key, a_key, "www.example.test",
+                                               0, 1, test_list),
+      MultiThreadedCertVerifier::RequestParams(a_key, a_key, "www.example.test",
+                                               0, 2, test_list),
+      -1,
+    },
     {  // Different additional_trust_anchors.
       MultiThreadedCertVerifier::RequestParams(a_key, a_key, "www.example.test",
-                                               0, empty_list),
+                                               0, 0, empty_list),
       MultiThreadedCertVerifier::RequestParams(a_key, a_key, "www.example.test",
-                                               0, test_list),
+                                               0, 0, test_list),
       -1,
     },
   };
@@ -987,7 +987,11 @@ void CookieMonster::DeleteCanonicalCookieAsync(
   scoped_refptr<DeleteCanonicalCookieTask> task =
       new DeleteCanonicalCookieTask(this, cookie, callback);
 
-  DoCookieTask(task);
+  // Only the cookies for the key of |cookie| need to be loaded.
+  std::string host(cookie.Domain());
+  if (!host.empty() && host[0] == '.')
+    host.erase(0, 1);
+  DoCookieTaskForURL(task, GURL("http://" + host));
 }
 
 void CookieMonster::SetCookieWithOptionsAsync(
@@ -1154,7 +1158,6 @@ CookieList CookieMonster::GetAllCookiesForURLWithOptions(
 
   std::vector<CanonicalCookie*> cookie_ptrs;
   FindCookiesForHostAndDomain(url, options, false, &cookie_ptrs);
-  std::sort(cookie_ptrs.begin(), cookie_ptrs.end(), CookieSorter);
 
   CookieList cookies;
   for (std::vector<CanonicalCookie*>::const_iterator it = cookie_ptrs.begin();
@@ -1318,7 +1321,6 @@ std::string CookieMonster::GetCookiesWithOptions(const GURL& url,
 
   std::vector<CanonicalCookie*> cookies;
   FindCookiesForHostAndDomain(url, options, true, &cookies);
-  std::sort(cookies.begin(), cookies.end(), CookieSorter);
 
   std::string cookie_line = BuildCookieLine(cookies);
 
@@ -1766,8 +1768,15 @@ CookieMonster::CookieMap::iterator CookieMonster::InternalInsertCookie(
   if ((cc->IsPersistent() || persist_session_cookies_) && store_.get() &&
       sync_to_store)
     store_->AddCookie(*cc);
+  // Keep the cookies for each key in CookieSorter order, so that the cookies
+  // found for a URL are already in the order in which they are sent.
+  CookieMapItPair its = cookies_.equal_range(key);
+  CookieMap::iterator position = its.first;
+  while (position != its.second && !CookieSorter(cc, position->second))
+    ++position;
   CookieMap::iterator inserted =
-      cookies_.insert(CookieMap::value_type(key, cc));
+      cookies_.insert(position, CookieMap::value_type(key, cc));
+  DCHECK(++CookieMap::iterator(inserted) == position);
   if (delegate_.get()) {
     delegate_->OnCookieChanged(
         *cc, false, CookieMonsterDelegate::CHANGE_COOKIE_EXPLICIT);
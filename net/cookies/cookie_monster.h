@@ -95,6 +95,10 @@ class NET_EXPORT CookieMonster : public CookieStore {
   // not legal to have domain cookies without an eTLD+1).  This rule
   // excludes cookies for, e.g, ".com", ".co.uk", or ".internalnetwork".
   // This behavior is the same as the behavior in Firefox v 3.6.10.
+  //
+  // The cookies sharing a key are kept ordered the way they are sent in a
+  // Cookie header (longest path first, then oldest first), so that looking up
+  // the cookies for a URL never needs to sort them.
 
   // NOTE(deanm):
   // I benchmarked hash_multimap vs multimap.  We're going to be query-heavy
@@ -499,6 +503,8 @@ class NET_EXPORT CookieMonster : public CookieStore {
 
   void SetDefaultCookieableSchemes();
 
+  // Appends the cookies to be sent to |url| to |cookies|, longest path first
+  // and then oldest first.
   void FindCookiesForHostAndDomain(const GURL& url,
                                    const CookieOptions& options,
                                    bool update_access_time,
@@ -182,6 +182,36 @@ TEST_F(CookieMonsterTest, TestAddCookieOnManyHosts) {
   timer3.Done();
 }
 
+TEST_F(CookieMonsterTest, TestQueryManyPaths) {
+  scoped_refptr<CookieMonster> cm(new CookieMonster(NULL, NULL));
+  SetCookieCallback setCookieCallback;
+
+  // Stay below the per-domain limit so that no garbage collection happens.
+  // Cookies are set deepest path last, so that they are stored in an order
+  // that is the opposite of the one they are sent in.
+  const int kNumPaths = 10;
+  const int kCookiesPerPath = 10;
+  std::string path;
+  for (int i = 0; i < kNumPaths; ++i) {
+    path += base::StringPrintf("/d%d", i);
+    for (int j = 0; j < kCookiesPerPath; ++j) {
+      setCookieCallback.SetCookie(
+          cm.get(), GURL(kGoogleURL),
+          base::StringPrintf("a%d_%d=b; path=%s", i, j, path.c_str()));
+    }
+  }
+
+  GetCookiesCallback getCookiesCallback;
+  GURL gurl(kGoogleURL + path + "/page.html");
+
+  base::PerfTimeLogger timer("Cookie_monster_query_many_paths");
+  for (int i = 0; i < kNumCookies; ++i) {
+    const std::string& cookies = getCookiesCallback.GetCookies(cm.get(), gurl);
+    EXPECT_EQ(kNumPaths * kCookiesPerPath, CountInString(cookies, '='));
+  }
+  timer.Done();
+}
+
 TEST_F(CookieMonsterTest, TestDomainTree) {
   scoped_refptr<CookieMonster> cm(new CookieMonster(NULL, NULL));
   GetCookiesCallback getCookiesCallback;
@@ -1058,7 +1058,7 @@ TEST_F(DeferredCookieTaskTest, DeferredDeleteCanonicalCookie) {
 
   MockDeleteCookieCallback delete_cookie_callback;
 
-  BeginWith(DeleteCanonicalCookieAction(
+  BeginWithForDomainKey("google.com", DeleteCanonicalCookieAction(
       &cookie_monster(), cookie, &delete_cookie_callback));
 
   WaitForLoadCall();
@@ -2,6 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <set>
+
 #include "base/basictypes.h"
 #include "base/file_util.h"
 #include "base/metrics/field_trial.h"
@@ -20,6 +22,7 @@
 #include "net/disk_cache/blockfile/experiments.h"
 #include "net/disk_cache/blockfile/histogram_macros.h"
 #include "net/disk_cache/blockfile/mapped_file.h"
+#include "net/disk_cache/blockfile/sharded_backend.h"
 #include "net/disk_cache/cache_util.h"
 #include "net/disk_cache/disk_cache_test_base.h"
 #include "net/disk_cache/disk_cache_test_util.h"
@@ -453,6 +456,74 @@ TEST_F(DiskCacheTest, CreateBackend) {
   base::MessageLoop::current()->RunUntilIdle();
 }
 
+// Tests that a sharded cache spreads its entries over its shards, and that the
+// operations on the whole cache reach all of them.
+TEST_F(DiskCacheTest, ShardedBackend) {
+  ASSERT_TRUE(CleanupCacheDir());
+  base::Thread cache_thread("CacheThread");
+  ASSERT_TRUE(cache_thread.StartWithOptions(
+      base::Thread::Options(base::MessageLoop::TYPE_IO, 0)));
+  net::TestCompletionCallback cb;
+
+  scoped_ptr<disk_cache::Backend> cache;
+  int rv = disk_cache::CreateCacheBackend(
+      net::DISK_CACHE, net::CACHE_BACKEND_SHARDED_BLOCKFILE, cache_path_, 0,
+      false, cache_thread.message_loop_proxy().get(), NULL, &cache,
+      cb.callback());
+  ASSERT_EQ(net::OK, cb.GetResult(rv));
+  disk_cache::ShardedBackend* sharded_cache =
+      static_cast<disk_cache::ShardedBackend*>(cache.get());
+
+  const int kNumEntries = 40;
+  std::set<size_t> shards;
+  for (int i = 0; i < kNumEntries; i++) {
+    std::string key = base::StringPrintf("key%d", i);
+    disk_cache::Entry* entry;
+    rv = cache->CreateEntry(key, &entry, cb.callback());
+    ASSERT_EQ(net::OK, cb.GetResult(rv));
+    entry->Close();
+    shards.insert(sharded_cache->GetShardIndex(key));
+  }
+  EXPECT_LT(1U, shards.size());
+  EXPECT_EQ(kNumEntries, cache->GetEntryCount());
+
+  disk_cache::Entry* entry;
+  rv = cache->OpenEntry("key7", &entry, cb.callback());
+  ASSERT_EQ(net::OK, cb.GetResult(rv));
+  EXPECT_EQ("key7", entry->GetKey());
+  entry->Close();
+
+  // The enumeration goes through every shard.
+  std::set<std::string> keys;
+  void* iter = NULL;
+  for (;;) {
+    rv = cache->OpenNextEntry(&iter, &entry, cb.callback());
+    if (cb.GetResult(rv) != net::OK)
+      break;
+    keys.insert(entry->GetKey());
+    entry->Close();
+  }
+  EXPECT_TRUE(iter == NULL);
+  EXPECT_EQ(static_cast<size_t>(kNumEntries), keys.size());
+
+  rv = cache->OpenNextEntry(&iter, &entry, cb.callback());
+  ASSERT_EQ(net::OK, cb.GetResult(rv));
+  entry->Close();
+  cache->EndEnumeration(&iter);
+  EXPECT_TRUE(iter == NULL);
+
+  rv = cache->DoomEntry("key7", cb.callback());
+  EXPECT_EQ(net::OK, cb.GetResult(rv));
+  EXPECT_EQ(kNumEntries - 1, cache->GetEntryCount());
+
+  rv = cache->DoomAllEntries(cb.callback());
+  EXPECT_EQ(net::OK, cb.GetResult(rv));
+  EXPECT_EQ(0, cache->GetEntryCount());
+
+  cache.reset();
+  base::MessageLoop::current()->RunUntilIdle();
+}
+
 // Tests that |BackendImpl| fails to initialize with a missing file.
 TEST_F(DiskCacheBackendTest, CreateBackend_MissingFile) {
   ASSERT_TRUE(CopyTestCache("bad_entry"));
@@ -0,0 +1,294 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/blockfile/sharded_backend.h"
+
+#include "base/bind.h"
+#include "base/hash.h"
+#include "base/logging.h"
+#include "base/memory/ref_counted.h"
+#include "base/message_loop/message_loop.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/thread.h"
+#include "net/base/net_errors.h"
+#include "net/disk_cache/blockfile/backend_impl.h"
+
+namespace {
+
+// The index table of each shard uses the low bits of the hash of the keys,
+// so pick the shard with higher bits.
+const int kShardHashShift = 24;
+
+int DoomAllShardEntries(disk_cache::Backend* shard,
+                        const net::CompletionCallback& callback) {
+  return shard->DoomAllEntries(callback);
+}
+
+int DoomShardEntriesBetween(base::Time initial_time,
+                            base::Time end_time,
+                            disk_cache::Backend* shard,
+                            const net::CompletionCallback& callback) {
+  return shard->DoomEntriesBetween(initial_time, end_time, callback);
+}
+
+int DoomShardEntriesSince(base::Time initial_time,
+                          disk_cache::Backend* shard,
+                          const net::CompletionCallback& callback) {
+  return shard->DoomEntriesSince(initial_time, callback);
+}
+
+int InitShard(disk_cache::Backend* shard,
+              const net::CompletionCallback& callback) {
+  return static_cast<disk_cache::BackendImpl*>(shard)->Init(callback);
+}
+
+}  // namespace
+
+namespace disk_cache {
+
+// Collects the results of an operation started on every shard, and reports
+// the first error, or net::OK once all of them are done.
+class ShardedBackend::Barrier : public base::RefCounted<Barrier> {
+ public:
+  explicit Barrier(const CompletionCallback& callback)
+      : callback_(callback),
+        pending_(0),
+        started_(false),
+        result_(net::OK) {}
+
+  // Records |result|, as returned when starting the operation on a shard.
+  void AddStartResult(int result) {
+    DCHECK(!started_);
+    if (result == net::ERR_IO_PENDING)
+      ++pending_;
+    else
+      AddResult(result);
+  }
+
+  // Called once the operation has been started on every shard. Returns the
+  // result of the whole operation, or net::ERR_IO_PENDING if the callback
+  // will receive it.
+  int Start() {
+    started_ = true;
+    return pending_ ? net::ERR_IO_PENDING : result_;
+  }
+
+  // Callback of the operation on a shard.
+  void OnShardComplete(int result) {
+    AddResult(result);
+    DCHECK_GT(pending_, 0);
+    if (!--pending_ && started_)
+      callback_.Run(result_);
+  }
+
+ private:
+  friend class base::RefCounted<Barrier>;
+  ~Barrier() {}
+
+  void AddResult(int result) {
+    if (result_ == net::OK)
+      result_ = result;
+  }
+
+  CompletionCallback callback_;
+  int pending_;
+  bool started_;
+  int result_;
+
+  DISALLOW_COPY_AND_ASSIGN(Barrier);
+};
+
+struct ShardedBackend::Iterator {
+  Iterator() : shard(0), shard_iter(NULL) {}
+
+  size_t shard;
+  void* shard_iter;
+};
+
+ShardedBackend::ShardedBackend(const base::FilePath& path, int num_shards,
+                               net::NetLog* net_log)
+    : path_(path),
+      num_shards_(num_shards),
+      max_bytes_(0),
+      cache_type_(net::DISK_CACHE),
+      flags_(kNone),
+      net_log_(net_log) {
+  DCHECK_GT(num_shards_, 0);
+}
+
+ShardedBackend::~ShardedBackend() {
+  // Each shard waits for its cache thread to clean up.
+  shards_.clear();
+  threads_.clear();
+}
+
+int ShardedBackend::Init(const CompletionCallback& callback) {
+  DCHECK(shards_.empty());
+  for (int i = 0; i < num_shards_; ++i) {
+    base::Thread* thread =
+        new base::Thread(base::StringPrintf("CacheShard%d", i).c_str());
+    threads_.push_back(thread);
+    if (!thread->StartWithOptions(
+            base::Thread::Options(base::MessageLoop::TYPE_IO, 0))) {
+      base::MessageLoop::current()->PostTask(
+          FROM_HERE, base::Bind(callback, net::ERR_FAILED));
+      return net::ERR_IO_PENDING;
+    }
+
+    BackendImpl* shard = new BackendImpl(
+        path_.AppendASCII(base::StringPrintf("shard_%d", i)),
+        thread->message_loop_proxy().get(), net_log_);
+    shards_.push_back(shard);
+    if (max_bytes_)
+      shard->SetMaxSize(max_bytes_ / num_shards_);
+    shard->SetType(cache_type_);
+    shard->SetFlags(flags_);
+  }
+  return RunOnAllShards(base::Bind(&InitShard), callback);
+}
+
+bool ShardedBackend::SetMaxSize(int max_bytes) {
+  DCHECK(shards_.empty());
+  if (max_bytes < 0)
+    return false;
+  max_bytes_ = max_bytes;
+  return true;
+}
+
+void ShardedBackend::SetType(net::CacheType type) {
+  DCHECK(shards_.empty());
+  DCHECK_NE(net::MEMORY_CACHE, type);
+  cache_type_ = type;
+}
+
+void ShardedBackend::SetFlags(uint32 flags) {
+  DCHECK(shards_.empty());
+  flags_ = flags;
+}
+
+size_t ShardedBackend::GetShardIndex(const std::string& key) const {
+  return (base::Hash(key) >> kShardHashShift) % num_shards_;
+}
+
+net::CacheType ShardedBackend::GetCacheType() const {
+  return cache_type_;
+}
+
+int32 ShardedBackend::GetEntryCount() const {
+  int32 count = 0;
+  for (size_t i = 0; i < shards_.size(); ++i)
+    count += shard(i)->GetEntryCount();
+  return count;
+}
+
+int ShardedBackend::OpenEntry(const std::string& key, Entry** entry,
+                              const CompletionCallback& callback) {
+  return shard(GetShardIndex(key))->OpenEntry(key, entry, callback);
+}
+
+int ShardedBackend::CreateEntry(const std::string& key, Entry** entry,
+                                const CompletionCallback& callback) {
+  return shard(GetShardIndex(key))->CreateEntry(key, entry, callback);
+}
+
+int ShardedBackend::DoomEntry(const std::string& key,
+                              const CompletionCallback& callback) {
+  return shard(GetShardIndex(key))->DoomEntry(key, callback);
+}
+
+int ShardedBackend::DoomAllEntries(const CompletionCallback& callback) {
+  return RunOnAllShards(base::Bind(&DoomAllShardEntries), callback);
+}
+
+int ShardedBackend::DoomEntriesBetween(const base::Time initial_time,
+                                       const base::Time end_time,
+                                       const CompletionCallback& callback) {
+  return RunOnAllShards(
+      base::Bind(&DoomShardEntriesBetween, initial_time, end_time), callback);
+}
+
+int ShardedBackend::DoomEntriesSince(const base::Time initial_time,
+                                     const CompletionCallback& callback) {
+  return RunOnAllShards(base::Bind(&DoomShardEntriesSince, initial_time),
+                        callback);
+}
+
+int ShardedBackend::OpenNextEntry(void** iter, Entry** next_entry,
+                                  const CompletionCallback& callback) {
+  DCHECK(!callback.is_null());
+  if (!*iter)
+    *iter = new Iterator;
+  return OpenNextEntryFromShard(iter, next_entry, callback);
+}
+
+void ShardedBackend::EndEnumeration(void** iter) {
+  Iterator* iterator = static_cast<Iterator*>(*iter);
+  if (iterator && iterator->shard_iter)
+    shard(iterator->shard)->EndEnumeration(&iterator->shard_iter);
+  delete iterator;
+  *iter = NULL;
+}
+
+void ShardedBackend::GetStats(
+    std::vector<std::pair<std::string, std::string> >* stats) {
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    std::vector<std::pair<std::string, std::string> > shard_stats;
+    shard(i)->GetStats(&shard_stats);
+    for (size_t j = 0; j < shard_stats.size(); ++j) {
+      stats->push_back(std::make_pair(
+          base::StringPrintf("Shard %d %s", static_cast<int>(i),
+                             shard_stats[j].first.c_str()),
+          shard_stats[j].second));
+    }
+  }
+}
+
+void ShardedBackend::OnExternalCacheHit(const std::string& key) {
+  shard(GetShardIndex(key))->OnExternalCacheHit(key);
+}
+
+int ShardedBackend::RunOnAllShards(const ShardOperation& operation,
+                                   const CompletionCallback& callback) {
+  scoped_refptr<Barrier> barrier(new Barrier(callback));
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    barrier->AddStartResult(operation.Run(
+        shard(i), base::Bind(&Barrier::OnShardComplete, barrier)));
+  }
+  return barrier->Start();
+}
+
+int ShardedBackend::OpenNextEntryFromShard(void** iter, Entry** next_entry,
+                                           const CompletionCallback& callback) {
+  Iterator* iterator = static_cast<Iterator*>(*iter);
+  while (iterator->shard < shards_.size()) {
+    int rv = shard(iterator->shard)->OpenNextEntry(
+        &iterator->shard_iter, next_entry,
+        base::Bind(&ShardedBackend::OnOpenNextEntryComplete, AsWeakPtr(),
+                   iter, next_entry, callback));
+    if (rv != net::ERR_FAILED)
+      return rv;
+    // The shard released its iterator along with the failure.
+    ++iterator->shard;
+    iterator->shard_iter = NULL;
+  }
+  delete iterator;
+  *iter = NULL;
+  return net::ERR_FAILED;
+}
+
+void ShardedBackend::OnOpenNextEntryComplete(void** iter, Entry** next_entry,
+                                             const CompletionCallback& callback,
+                                             int result) {
+  if (result == net::ERR_FAILED) {
+    Iterator* iterator = static_cast<Iterator*>(*iter);
+    ++iterator->shard;
+    iterator->shard_iter = NULL;
+    result = OpenNextEntryFromShard(iter, next_entry, callback);
+    if (result == net::ERR_IO_PENDING)
+      return;
+  }
+  callback.Run(result);
+}
+
+}  // namespace disk_cache
@@ -0,0 +1,130 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// See net/disk_cache/disk_cache.h for the public interface of the cache.
+
+#ifndef NET_DISK_CACHE_BLOCKFILE_SHARDED_BACKEND_H_
+#define NET_DISK_CACHE_BLOCKFILE_SHARDED_BACKEND_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "base/compiler_specific.h"
+#include "base/files/file_path.h"
+#include "base/memory/scoped_vector.h"
+#include "base/memory/weak_ptr.h"
+#include "net/base/net_export.h"
+#include "net/disk_cache/disk_cache.h"
+
+namespace base {
+class Thread;
+}
+
+namespace net {
+class NetLog;
+}
+
+namespace disk_cache {
+
+class BackendImpl;
+
+// This class implements the Backend interface on top of a number of shards,
+// each a BackendImpl with its own files, in a sub directory of the cache
+// directory, and its own cache thread. Entries are assigned to a shard by the
+// hash of their key, so the operations of different entries are spread over
+// the cache threads instead of all being serialized on one of them.
+//
+// The number of shards is part of the on-disk layout: a cache must always be
+// opened with the number of shards it was created with.
+class NET_EXPORT_PRIVATE ShardedBackend
+    : public Backend,
+      public base::SupportsWeakPtr<ShardedBackend> {
+ public:
+  ShardedBackend(const base::FilePath& path, int num_shards,
+                 net::NetLog* net_log);
+  virtual ~ShardedBackend();
+
+  // Starts the cache threads and initializes the shards. The whole cache
+  // fails to initialize if any of the shards does. Like BackendImpl::Init(),
+  // always completes through |callback|.
+  int Init(const CompletionCallback& callback);
+
+  // Set the maximum size for the whole cache, split evenly across shards, the
+  // cache type and the BackendFlags of the shards. Must be called before
+  // Init().
+  bool SetMaxSize(int max_bytes);
+  void SetType(net::CacheType type);
+  void SetFlags(uint32 flags);
+
+  // Returns the index of the shard storing the entry for |key|.
+  size_t GetShardIndex(const std::string& key) const;
+
+  // Backend implementation.
+  virtual net::CacheType GetCacheType() const OVERRIDE;
+  virtual int32 GetEntryCount() const OVERRIDE;
+  virtual int OpenEntry(const std::string& key, Entry** entry,
+                        const CompletionCallback& callback) OVERRIDE;
+  virtual int CreateEntry(const std::string& key, Entry** entry,
+                          const CompletionCallback& callback) OVERRIDE;
+  virtual int DoomEntry(const std::string& key,
+                        const CompletionCallback& callback) OVERRIDE;
+  virtual int DoomAllEntries(const CompletionCallback& callback) OVERRIDE;
+  virtual int DoomEntriesBetween(base::Time initial_time,
+                                 base::Time end_time,
+                                 const CompletionCallback& callback) OVERRIDE;
+  virtual int DoomEntriesSince(base::Time initial_time,
+                               const CompletionCallback& callback) OVERRIDE;
+  virtual int OpenNextEntry(void** iter, Entry** next_entry,
+                            const CompletionCallback& callback) OVERRIDE;
+  virtual void EndEnumeration(void** iter) OVERRIDE;
+  virtual void GetStats(
+      std::vector<std::pair<std::string, std::string> >* stats) OVERRIDE;
+  virtual void OnExternalCacheHit(const std::string& key) OVERRIDE;
+
+ private:
+  class Barrier;
+  struct Iterator;
+
+  // Starts |operation| on a shard, with a callback for its result.
+  typedef base::Callback<int(Backend*, const CompletionCallback&)>
+      ShardOperation;
+
+  // Runs |operation| on every shard, and returns the first error it returned,
+  // or net::OK, either directly or through |callback|.
+  int RunOnAllShards(const ShardOperation& operation,
+                     const CompletionCallback& callback);
+
+  // Opens the next entry of the enumeration |iter| into |next_entry|, moving on
+  // to the next shards while the current one has no more entries.
+  int OpenNextEntryFromShard(void** iter, Entry** next_entry,
+                             const CompletionCallback& callback);
+
+  // Called when the shard being enumerated returns |result| for the
+  // enumeration |iter|.
+  void OnOpenNextEntryComplete(void** iter, Entry** next_entry,
+                               const CompletionCallback& callback,
+                               int result);
+
+  BackendImpl* shard(size_t index) const { return shards_[index]; }
+
+  const base::FilePath path_;
+  const int num_shards_;
+  int max_bytes_;
+  net::CacheType cache_type_;
+  uint32 flags_;
+  net::NetLog* const net_log_;
+
+  // The threads outlive the shards using them.
+  ScopedVector<base::Thread> threads_;
+  ScopedVector<BackendImpl> shards_;
+
+  DISALLOW_COPY_AND_ASSIGN(ShardedBackend);
+};
+
+}  // namespace disk_cache
+
+#endif  // NET_DISK_CACHE_BLOCKFILE_SHARDED_BACKEND_H_
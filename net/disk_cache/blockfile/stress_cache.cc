@@ -10,6 +10,8 @@
 // The child application has two threads: one to exercise the cache in an
 // infinite loop, and another one to asynchronously kill the process.
 
+// With --sharded, the cache is a ShardedBackend instead of a BackendImpl.
+
 // A regular build should never crash.
 // To test that the disk cache doesn't generate critical errors with regular
 // application level crashes, edit stress_support.h.
@@ -37,6 +39,7 @@
 #include "net/base/net_errors.h"
 #include "net/base/test_completion_callback.h"
 #include "net/disk_cache/blockfile/backend_impl.h"
+#include "net/disk_cache/blockfile/sharded_backend.h"
 #include "net/disk_cache/blockfile/stress_support.h"
 #include "net/disk_cache/blockfile/trace.h"
 #include "net/disk_cache/disk_cache.h"
@@ -51,12 +54,17 @@ using base::Time;
 const int kError = -1;
 const int kExpectedCrash = 100;
 
+const char kShardedSwitch[] = "sharded";
+const int kNumShards = 4;
+
 // Starts a new process.
-int RunSlave(int iteration) {
+int RunSlave(int iteration, bool sharded) {
   base::FilePath exe;
   PathService::Get(base::FILE_EXE, &exe);
 
   CommandLine cmdline(exe);
+  if (sharded)
+    cmdline.AppendSwitch(kShardedSwitch);
   cmdline.AppendArg(base::IntToString(iteration));
 
   base::ProcessHandle handle;
@@ -74,9 +82,9 @@ int RunSlave(int iteration) {
 }
 
 // Main loop for the master process.
-int MasterCode() {
+int MasterCode(bool sharded) {
   for (int i = 0; i < 100000; i++) {
-    int ret = RunSlave(i);
+    int ret = RunSlave(i, sharded);
     if (kExpectedCrash != ret)
       return ret;
   }
@@ -100,28 +108,41 @@ std::string GenerateStressKey() {
 // This thread will loop forever, adding and removing entries from the cache.
 // iteration is the current crash cycle, so the entries on the cache are marked
 // to know which instance of the application wrote them.
-void StressTheCache(int iteration) {
+void StressTheCache(int iteration, bool sharded) {
   int cache_size = 0x2000000;  // 32MB.
   uint32 mask = 0xfff;  // 4096 entries.
 
   base::FilePath path;
   PathService::Get(base::DIR_TEMP, &path);
-  path = path.AppendASCII("cache_test_stress");
+  path = path.AppendASCII(sharded ? "cache_test_stress_sharded" :
+                                    "cache_test_stress");
 
   base::Thread cache_thread("CacheThread");
   if (!cache_thread.StartWithOptions(
           base::Thread::Options(base::MessageLoop::TYPE_IO, 0)))
     return;
 
-  disk_cache::BackendImpl* cache =
-      new disk_cache::BackendImpl(path, mask,
-                                  cache_thread.message_loop_proxy().get(),
-                                  NULL);
-  cache->SetMaxSize(cache_size);
-  cache->SetFlags(disk_cache::kNoLoadProtection);
-
+  disk_cache::Backend* cache;
   net::TestCompletionCallback cb;
-  int rv = cache->Init(cb.callback());
+  int rv;
+  if (sharded) {
+    // The shards run on cache threads of their own, and can't be given a mask.
+    disk_cache::ShardedBackend* sharded_cache =
+        new disk_cache::ShardedBackend(path, kNumShards, NULL);
+    sharded_cache->SetMaxSize(cache_size);
+    sharded_cache->SetFlags(disk_cache::kNoLoadProtection);
+    rv = sharded_cache->Init(cb.callback());
+    cache = sharded_cache;
+  } else {
+    disk_cache::BackendImpl* cache_impl =
+        new disk_cache::BackendImpl(path, mask,
+                                    cache_thread.message_loop_proxy().get(),
+                                    NULL);
+    cache_impl->SetMaxSize(cache_size);
+    cache_impl->SetFlags(disk_cache::kNoLoadProtection);
+    rv = cache_impl->Init(cb.callback());
+    cache = cache_impl;
+  }
 
   if (cb.GetResult(rv) != net::OK) {
     printf("Unable to initialize cache.\n");
@@ -262,8 +283,11 @@ int main(int argc, const char* argv[]) {
   // Setup an AtExitManager so Singleton objects will be destructed.
   base::AtExitManager at_exit_manager;
 
-  if (argc < 2)
-    return MasterCode();
+  CommandLine::Init(argc, argv);
+  const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+  const bool sharded = command_line.HasSwitch(kShardedSwitch);
+  if (command_line.GetArgs().empty())
+    return MasterCode(sharded);
 
   logging::SetLogAssertHandler(CrashHandler);
   logging::SetLogMessageHandler(MessageHandler);
@@ -271,7 +295,6 @@ int main(int argc, const char* argv[]) {
 #if defined(OS_WIN)
   logging::LogEventProvider::Initialize(kStressCacheTraceProviderName);
 #else
-  CommandLine::Init(argc, argv);
   logging::LoggingSettings settings;
   settings.logging_dest = logging::LOG_TO_SYSTEM_DEBUG_LOG;
   logging::InitLogging(settings);
@@ -281,14 +304,17 @@ int main(int argc, const char* argv[]) {
   base::PlatformThread::Sleep(base::TimeDelta::FromSeconds(3));
   base::MessageLoopForIO message_loop;
 
-  char* end;
-  long int iteration = strtol(argv[1], &end, 0);
+  int iteration;
+  if (!base::StringToInt(command_line.GetArgs()[0], &iteration)) {
+    printf("invalid iteration\n");
+    return kError;
+  }
 
   if (!StartCrashThread()) {
     printf("failed to start thread\n");
     return kError;
   }
 
-  StressTheCache(iteration);
+  StressTheCache(iteration, sharded);
   return 0;
 }
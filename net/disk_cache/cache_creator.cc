@@ -8,6 +8,7 @@
 #include "net/base/cache_type.h"
 #include "net/base/net_errors.h"
 #include "net/disk_cache/blockfile/backend_impl.h"
+#include "net/disk_cache/blockfile/sharded_backend.h"
 #include "net/disk_cache/cache_util.h"
 #include "net/disk_cache/disk_cache.h"
 #include "net/disk_cache/memory/mem_backend_impl.h"
@@ -19,6 +20,10 @@
 
 namespace {
 
+// The number of shards of a CACHE_BACKEND_SHARDED_BLOCKFILE cache. Changing it
+// makes the existing caches unusable.
+const int kNumCacheShards = 4;
+
 // Builds an instance of the backend depending on platform, type, experiments
 // etc. Takes care of the retry state. This object will self-destroy when
 // finished.
@@ -91,6 +96,17 @@ int CacheCreator::Run() {
     return simple_cache->Init(
         base::Bind(&CacheCreator::OnIOComplete, base::Unretained(this)));
   }
+  if (backend_type_ == net::CACHE_BACKEND_SHARDED_BLOCKFILE) {
+    // The shards run on cache threads of their own.
+    disk_cache::ShardedBackend* sharded_cache =
+        new disk_cache::ShardedBackend(path_, kNumCacheShards, net_log_);
+    created_cache_.reset(sharded_cache);
+    sharded_cache->SetMaxSize(max_bytes_);
+    sharded_cache->SetType(type_);
+    sharded_cache->SetFlags(flags_);
+    return sharded_cache->Init(
+        base::Bind(&CacheCreator::OnIOComplete, base::Unretained(this)));
+  }
   disk_cache::BackendImpl* new_cache =
       new disk_cache::BackendImpl(path_, thread_.get(), net_log_);
   created_cache_.reset(new_cache);
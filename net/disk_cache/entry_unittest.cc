@@ -6,6 +6,7 @@
 #include "base/bind.h"
 #include "base/bind_helpers.h"
 #include "base/file_util.h"
+#include "base/files/file_enumerator.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/threading/platform_thread.h"
@@ -18,7 +19,9 @@
 #include "net/disk_cache/blockfile/entry_impl.h"
 #include "net/disk_cache/disk_cache_test_base.h"
 #include "net/disk_cache/disk_cache_test_util.h"
+#include "net/disk_cache/memory/mem_backend_impl.h"
 #include "net/disk_cache/memory/mem_entry_impl.h"
+#include "net/disk_cache/simple/simple_backend_impl.h"
 #include "net/disk_cache/simple/simple_entry_format.h"
 #include "net/disk_cache/simple/simple_entry_impl.h"
 #include "net/disk_cache/simple/simple_synchronous_entry.h"
@@ -989,6 +992,51 @@ TEST_F(DiskCacheEntryTest, MemoryOnlyTruncateData) {
   TruncateData(0);
 }
 
+// Tests that the streams of cold entries are compressed when the memory cache
+// is told to, so that more entries fit, and that their data is unchanged.
+TEST_F(DiskCacheEntryTest, MemoryOnlyCompressColdEntries) {
+  SetMemoryOnlyMode();
+  SetMaxSize(4 * 1024 * 1024);
+  InitCache();
+  mem_cache_->SetCompressColdEntries(true);
+
+  const int kSize = 256 * 1024;
+  const int kNumEntries = 40;
+  scoped_refptr<net::IOBuffer> buffer1(new net::IOBuffer(kSize));
+  for (int i = 0; i < kSize; i++)
+    buffer1->data()[i] = 'a' + (i / 64) % 26;
+
+  // Without compression these would take 10 MB.
+  for (int i = 0; i < kNumEntries; i++) {
+    disk_cache::Entry* entry;
+    ASSERT_EQ(net::OK, CreateEntry(base::StringPrintf("key%d", i), &entry));
+    EXPECT_EQ(kSize, WriteData(entry, 1, 0, buffer1.get(), kSize, false));
+    entry->Close();
+  }
+  EXPECT_EQ(kNumEntries, cache_->GetEntryCount());
+
+  scoped_refptr<net::IOBuffer> buffer2(new net::IOBuffer(kSize));
+  for (int i = 0; i < kNumEntries; i++) {
+    disk_cache::Entry* entry;
+    ASSERT_EQ(net::OK, OpenEntry(base::StringPrintf("key%d", i), &entry));
+    EXPECT_EQ(kSize, entry->GetDataSize(1));
+    memset(buffer2->data(), 0, kSize);
+    EXPECT_EQ(kSize, ReadData(entry, 1, 0, buffer2.get(), kSize));
+    EXPECT_EQ(0, memcmp(buffer1->data(), buffer2->data(), kSize));
+
+    // Writing to a compressed stream works on the original data.
+    entry->Close();
+    ASSERT_EQ(net::OK, OpenEntry(base::StringPrintf("key%d", i), &entry));
+    EXPECT_EQ(10, WriteData(entry, 1, kSize - 10, buffer1.get(), 10, true));
+    EXPECT_EQ(kSize, entry->GetDataSize(1));
+    EXPECT_EQ(kSize, ReadData(entry, 1, 0, buffer2.get(), kSize));
+    EXPECT_EQ(0, memcmp(buffer1->data(), buffer2->data(), kSize - 10));
+    EXPECT_EQ(0, memcmp(buffer1->data(), buffer2->data() + kSize - 10, 10));
+    entry->Close();
+  }
+  EXPECT_EQ(kNumEntries, cache_->GetEntryCount());
+}
+
 void DiskCacheEntryTest::ZeroLengthIO(int stream_index) {
   std::string key("the first key");
   disk_cache::Entry* entry;
@@ -3972,4 +4020,79 @@ TEST_F(DiskCacheEntryTest, SimpleCacheTruncateLargeSparseFile) {
   entry->Close();
 }
 
+
+// Checks that entries with the same body share a single copy of it on disk,
+// until one of them is modified.
+TEST_F(DiskCacheEntryTest, SimpleCacheDedupBodies) {
+  SetSimpleCacheMode();
+  InitCache();
+  simple_cache_impl_->set_dedup_bodies(true);
+
+  const int kHeadersSize = 100;
+  const int kBodySize = 32 * 1024;
+  scoped_refptr<net::IOBuffer> headers(new net::IOBuffer(kHeadersSize));
+  scoped_refptr<net::IOBuffer> body(new net::IOBuffer(kBodySize));
+  CacheTestFillBuffer(headers->data(), kHeadersSize, false);
+  CacheTestFillBuffer(body->data(), kBodySize, false);
+
+  const char* const kKeys[] = { "first", "second" };
+  for (size_t i = 0; i < arraysize(kKeys); ++i) {
+    disk_cache::Entry* entry = NULL;
+    ASSERT_EQ(net::OK, CreateEntry(kKeys[i], &entry));
+    EXPECT_EQ(kHeadersSize,
+              WriteData(entry, 0, 0, headers.get(), kHeadersSize, false));
+    EXPECT_EQ(kBodySize, WriteData(entry, 1, 0, body.get(), kBodySize, false));
+    entry->Close();
+  }
+  disk_cache::SimpleBackendImpl::FlushWorkerPoolForTesting();
+  base::MessageLoop::current()->RunUntilIdle();
+
+  base::FileEnumerator bodies(
+      cache_path_.AppendASCII(disk_cache::kSimpleBodiesDirectory), false,
+      base::FileEnumerator::FILES);
+  int body_count = 0;
+  while (!bodies.Next().empty())
+    ++body_count;
+  EXPECT_EQ(1, body_count);
+
+  scoped_refptr<net::IOBuffer> read_buffer(new net::IOBuffer(kBodySize));
+  for (size_t i = 0; i < arraysize(kKeys); ++i) {
+    disk_cache::Entry* entry = NULL;
+    ASSERT_EQ(net::OK, OpenEntry(kKeys[i], &entry));
+    EXPECT_EQ(kHeadersSize, entry->GetDataSize(0));
+    EXPECT_EQ(kBodySize, entry->GetDataSize(1));
+    EXPECT_EQ(kHeadersSize,
+              ReadData(entry, 0, 0, read_buffer.get(), kHeadersSize));
+    EXPECT_EQ(0, memcmp(headers->data(), read_buffer->data(), kHeadersSize));
+    EXPECT_EQ(kBodySize, ReadData(entry, 1, 0, read_buffer.get(), kBodySize));
+    EXPECT_EQ(0, memcmp(body->data(), read_buffer->data(), kBodySize));
+    entry->Close();
+  }
+
+  // Modifying one of the bodies leaves the other one alone.
+  disk_cache::Entry* entry = NULL;
+  ASSERT_EQ(net::OK, OpenEntry(kKeys[1], &entry));
+  EXPECT_EQ(kHeadersSize,
+            WriteData(entry, 1, kBodySize, headers.get(), kHeadersSize, false));
+  entry->Close();
+
+  ASSERT_EQ(net::OK, OpenEntry(kKeys[1], &entry));
+  EXPECT_EQ(kBodySize + kHeadersSize, entry->GetDataSize(1));
+  EXPECT_EQ(kBodySize, ReadData(entry, 1, 0, read_buffer.get(), kBodySize));
+  EXPECT_EQ(0, memcmp(body->data(), read_buffer->data(), kBodySize));
+  EXPECT_EQ(kHeadersSize,
+            ReadData(entry, 1, kBodySize, read_buffer.get(), kHeadersSize));
+  EXPECT_EQ(0, memcmp(headers->data(), read_buffer->data(), kHeadersSize));
+  EXPECT_EQ(kHeadersSize,
+            ReadData(entry, 0, 0, read_buffer.get(), kHeadersSize));
+  EXPECT_EQ(0, memcmp(headers->data(), read_buffer->data(), kHeadersSize));
+  entry->Close();
+
+  ASSERT_EQ(net::OK, OpenEntry(kKeys[0], &entry));
+  EXPECT_EQ(kBodySize, entry->GetDataSize(1));
+  EXPECT_EQ(kBodySize, ReadData(entry, 1, 0, read_buffer.get(), kBodySize));
+  EXPECT_EQ(0, memcmp(body->data(), read_buffer->data(), kBodySize));
+  entry->Close();
+}
+
 #endif  // defined(OS_POSIX)
@@ -29,7 +29,10 @@ int LowWaterAdjust(int high_water) {
 namespace disk_cache {
 
 MemBackendImpl::MemBackendImpl(net::NetLog* net_log)
-    : max_size_(0), current_size_(0), net_log_(net_log) {}
+    : max_size_(0),
+      current_size_(0),
+      compress_cold_entries_(false),
+      net_log_(net_log) {}
 
 MemBackendImpl::~MemBackendImpl() {
   EntryMap::iterator it = entries_.begin();
@@ -40,6 +40,15 @@ class NET_EXPORT_PRIVATE MemBackendImpl : public Backend {
   // Sets the maximum size for the total amount of data stored by this instance.
   bool SetMaxSize(int max_bytes);
 
+  // Sets whether the streams of the entries are compressed while the entries
+  // are not in use, and decompressed when read or written again. The storage
+  // used by a compressed stream is its compressed size, so more entries fit in
+  // the cache when their data compresses well.
+  void SetCompressColdEntries(bool compress) {
+    compress_cold_entries_ = compress;
+  }
+  bool compress_cold_entries() const { return compress_cold_entries_; }
+
   // Permanently deletes an entry.
   void InternalDoomEntry(MemEntryImpl* entry);
 
@@ -109,6 +118,7 @@ class NET_EXPORT_PRIVATE MemBackendImpl : public Backend {
   MemRankings rankings_;  // Rankings to be able to trim the cache.
   int32 max_size_;        // Maximum data size for this instance.
   int32 current_size_;
+  bool compress_cold_entries_;
 
   net::NetLog* net_log_;
 
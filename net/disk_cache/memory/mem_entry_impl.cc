@@ -12,6 +12,7 @@
 #include "net/base/net_errors.h"
 #include "net/disk_cache/memory/mem_backend_impl.h"
 #include "net/disk_cache/net_log_parameters.h"
+#include "third_party/zlib/zlib.h"
 
 using base::Time;
 
@@ -25,6 +26,9 @@ const int kMaxSparseEntryBits = 12;
 // Sparse entry has maximum size of 4KB.
 const int kMaxSparseEntrySize = 1 << kMaxSparseEntryBits;
 
+// Streams smaller than this are not worth compressing.
+const int kMinCompressedStreamSize = 1024;
+
 // Convert global offset to child index.
 inline int ToChildIndex(int64 offset) {
   return static_cast<int>(offset >> kMaxSparseEntryBits);
@@ -159,8 +163,12 @@ void MemEntryImpl::Close() {
   DCHECK(type() == kParentEntry);
   ref_count_--;
   DCHECK_GE(ref_count_, 0);
-  if (!ref_count_ && doomed_)
+  if (!ref_count_ && doomed_) {
     InternalDoom();
+    return;
+  }
+  if (!ref_count_ && backend_->compress_cold_entries())
+    CompressStreams();
 }
 
 std::string MemEntryImpl::GetKey() const {
@@ -274,7 +282,7 @@ int MemEntryImpl::ReadyForSparseIO(const CompletionCallback& callback) {
 
 MemEntryImpl::~MemEntryImpl() {
   for (int i = 0; i < NUM_STREAMS; i++)
-    backend_->ModifyStorageSize(data_size_[i], 0);
+    backend_->ModifyStorageSize(GetStoredSize(i), 0);
   backend_->ModifyStorageSize(static_cast<int32>(key_.size()), 0);
   net_log_.EndEvent(net::NetLog::TYPE_DISK_CACHE_MEM_ENTRY_IMPL);
 }
@@ -296,6 +304,9 @@ int MemEntryImpl::InternalReadData(int index, int offset, IOBuffer* buf,
   if (offset + buf_len > entry_size)
     buf_len = entry_size - offset;
 
+  if (!DecompressStream(index))
+    return net::ERR_FAILED;
+
   UpdateRank(false);
 
   memcpy(buf->data(), &(data_[index])[offset], buf_len);
@@ -320,6 +331,9 @@ int MemEntryImpl::InternalWriteData(int index, int offset, IOBuffer* buf,
     return net::ERR_FAILED;
   }
 
+  if (!DecompressStream(index))
+    return net::ERR_FAILED;
+
   // Read the size at this point.
   int entry_size = GetDataSize(index);
 
@@ -528,6 +542,61 @@ void MemEntryImpl::PrepareTarget(int index, int offset, int buf_len) {
   memset(&(data_[index])[entry_size], 0, offset - entry_size);
 }
 
+int32 MemEntryImpl::GetStoredSize(int index) const {
+  if (!compressed_data_[index].empty())
+    return static_cast<int32>(compressed_data_[index].size());
+  return data_size_[index];
+}
+
+void MemEntryImpl::CompressStreams() {
+  // Sparse data lives in child entries, which are never closed, so only the
+  // streams of a parent entry are compressed.
+  DCHECK_EQ(kParentEntry, type());
+  for (int i = 0; i < NUM_STREAMS; i++) {
+    if (data_size_[i] < kMinCompressedStreamSize ||
+        !compressed_data_[i].empty()) {
+      continue;
+    }
+
+    uLongf compressed_size = compressBound(data_size_[i]);
+    std::vector<char> buffer(compressed_size);
+    int rv = compress2(reinterpret_cast<Bytef*>(&buffer[0]), &compressed_size,
+                       reinterpret_cast<const Bytef*>(&(data_[i])[0]),
+                       data_size_[i], Z_BEST_SPEED);
+    if (rv != Z_OK || compressed_size >= static_cast<uLongf>(data_size_[i]))
+      continue;
+
+    std::vector<char>(buffer.begin(), buffer.begin() + compressed_size).swap(
+        compressed_data_[i]);
+    std::vector<char>().swap(data_[i]);
+    backend_->ModifyStorageSize(data_size_[i],
+                                static_cast<int32>(compressed_size));
+  }
+}
+
+bool MemEntryImpl::DecompressStream(int index) {
+  if (compressed_data_[index].empty())
+    return true;
+
+  DCHECK(data_[index].empty());
+  std::vector<char> data(data_size_[index]);
+  uLongf size = data_size_[index];
+  int rv = uncompress(
+      reinterpret_cast<Bytef*>(&data[0]), &size,
+      reinterpret_cast<const Bytef*>(&(compressed_data_[index])[0]),
+      compressed_data_[index].size());
+  if (rv != Z_OK || size != static_cast<uLongf>(data_size_[index])) {
+    NOTREACHED();
+    return false;
+  }
+
+  int32 compressed_size = static_cast<int32>(compressed_data_[index].size());
+  data_[index].swap(data);
+  std::vector<char>().swap(compressed_data_[index]);
+  backend_->ModifyStorageSize(compressed_size, data_size_[index]);
+  return true;
+}
+
 void MemEntryImpl::UpdateRank(bool modified) {
   Time current = Time::Now();
   last_used_ = current;
@@ -131,6 +131,17 @@ class MemEntryImpl : public Entry {
   // Grows and cleans up the data buffer.
   void PrepareTarget(int index, int offset, int buf_len);
 
+  // Returns the number of bytes of memory used by the data of stream |index|.
+  int32 GetStoredSize(int index) const;
+
+  // Replaces the data of every stream with its compressed version, when the
+  // backend compresses cold entries and it takes less memory that way.
+  void CompressStreams();
+
+  // Restores the data of stream |index| if it is compressed. Returns false if
+  // it cannot be decompressed.
+  bool DecompressStream(int index);
+
   // Updates ranking information.
   void UpdateRank(bool modified);
 
@@ -160,6 +171,8 @@ class MemEntryImpl : public Entry {
   std::string key_;
   std::vector<char> data_[NUM_STREAMS];  // User data.
   int32 data_size_[NUM_STREAMS];
+  // Compressed user data, used instead of |data_| while not empty.
+  std::vector<char> compressed_data_[NUM_STREAMS];
   int ref_count_;
 
   int child_id_;              // The ID of a child entry.
@@ -27,6 +27,7 @@
 #include "base/time/time.h"
 #include "net/base/net_errors.h"
 #include "net/disk_cache/cache_util.h"
+#include "net/disk_cache/simple/simple_batching_task_runner.h"
 #include "net/disk_cache/simple/simple_entry_format.h"
 #include "net/disk_cache/simple/simple_entry_impl.h"
 #include "net/disk_cache/simple/simple_histogram_macros.h"
@@ -210,6 +211,9 @@ SimpleBackendImpl::SimpleBackendImpl(const FilePath& path,
           cache_type == net::DISK_CACHE ?
               SimpleEntryImpl::OPTIMISTIC_OPERATIONS :
               SimpleEntryImpl::NON_OPTIMISTIC_OPERATIONS),
+      dedup_bodies_(
+          base::FieldTrialList::FindFullName("SimpleCacheBodyDedup") ==
+              "Enabled"),
       net_log_(net_log) {
   MaybeHistogramFdLimit(cache_type_);
 }
@@ -221,8 +225,11 @@ SimpleBackendImpl::~SimpleBackendImpl() {
 int SimpleBackendImpl::Init(const CompletionCallback& completion_callback) {
   MaybeCreateSequencedWorkerPool();
 
-  worker_pool_ = g_sequenced_worker_pool->GetTaskRunnerWithShutdownBehavior(
-      SequencedWorkerPool::CONTINUE_ON_SHUTDOWN);
+  // Entries post their operations to the worker pool as they come, so under
+  // load many small tasks queue up there; batch them.
+  worker_pool_ = new SimpleBatchingTaskRunner(
+      g_sequenced_worker_pool->GetTaskRunnerWithShutdownBehavior(
+          SequencedWorkerPool::CONTINUE_ON_SHUTDOWN).get());
 
   index_.reset(new SimpleIndex(MessageLoopProxy::current(), this, cache_type_,
                                make_scoped_ptr(new SimpleIndexFile(
@@ -494,6 +501,7 @@ SimpleBackendImpl::DiskStatResult SimpleBackendImpl::InitCacheStructureOnDisk(
                << path.LossyDisplayName();
     result.net_error = net::ERR_FAILED;
   } else {
+    SimpleSynchronousEntry::DeleteUnreferencedBodies(path);
     bool mtime_result =
         disk_cache::simple_util::GetMTime(path, &result.cache_dir_mtime);
     DCHECK(mtime_result);
@@ -64,6 +64,11 @@ class NET_EXPORT_PRIVATE SimpleBackendImpl : public Backend,
   // Returns the maximum file size permitted in this backend.
   int GetMaxFileSize() const;
 
+  // Whether the bodies of the entries closed from now on are deduplicated.
+  // Enabled with the "SimpleCacheBodyDedup" field trial.
+  void set_dedup_bodies(bool dedup_bodies) { dedup_bodies_ = dedup_bodies; }
+  bool dedup_bodies() const { return dedup_bodies_; }
+
   // Removes |entry| from the |active_entries_| set, forcing future Open/Create
   // operations to construct a new object.
   void OnDeactivated(const SimpleEntryImpl* entry);
@@ -202,6 +207,7 @@ class NET_EXPORT_PRIVATE SimpleBackendImpl : public Backend,
 
   int orig_max_size_;
   const SimpleEntryImpl::OperationsMode entry_operations_mode_;
+  bool dedup_bodies_;
 
   EntryMap active_entries_;
 
@@ -0,0 +1,63 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/simple/simple_batching_task_runner.h"
+
+#include <vector>
+
+#include "base/bind.h"
+#include "base/location.h"
+#include "base/logging.h"
+
+namespace disk_cache {
+
+SimpleBatchingTaskRunner::SimpleBatchingTaskRunner(
+    base::TaskRunner* worker_pool)
+    : worker_pool_(worker_pool),
+      scheduled_batches_(0) {
+  DCHECK(worker_pool_.get());
+}
+
+SimpleBatchingTaskRunner::~SimpleBatchingTaskRunner() {}
+
+bool SimpleBatchingTaskRunner::PostDelayedTask(
+    const tracked_objects::Location& from_here,
+    const base::Closure& task,
+    base::TimeDelta delay) {
+  if (delay > base::TimeDelta())
+    return worker_pool_->PostDelayedTask(from_here, task, delay);
+
+  {
+    base::AutoLock auto_lock(lock_);
+    pending_tasks_.push_back(task);
+    if (pending_tasks_.size() <= scheduled_batches_ * kMaxTasksPerBatch)
+      return true;
+    ++scheduled_batches_;
+  }
+  // If this fails, the worker pool is shutting down and won't run any more
+  // tasks anyway.
+  return worker_pool_->PostTask(
+      FROM_HERE, base::Bind(&SimpleBatchingTaskRunner::RunBatch, this));
+}
+
+bool SimpleBatchingTaskRunner::RunsTasksOnCurrentThread() const {
+  return worker_pool_->RunsTasksOnCurrentThread();
+}
+
+void SimpleBatchingTaskRunner::RunBatch() {
+  std::vector<base::Closure> batch;
+  {
+    base::AutoLock auto_lock(lock_);
+    DCHECK_GT(scheduled_batches_, 0U);
+    --scheduled_batches_;
+    while (!pending_tasks_.empty() && batch.size() < kMaxTasksPerBatch) {
+      batch.push_back(pending_tasks_.front());
+      pending_tasks_.pop_front();
+    }
+  }
+  for (size_t i = 0; i < batch.size(); ++i)
+    batch[i].Run();
+}
+
+}  // namespace disk_cache
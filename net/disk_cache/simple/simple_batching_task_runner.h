@@ -0,0 +1,63 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_DISK_CACHE_SIMPLE_SIMPLE_BATCHING_TASK_RUNNER_H_
+#define NET_DISK_CACHE_SIMPLE_SIMPLE_BATCHING_TASK_RUNNER_H_
+
+#include <deque>
+
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "base/compiler_specific.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "base/task_runner.h"
+#include "net/base/net_export.h"
+
+namespace disk_cache {
+
+// SimpleBatchingTaskRunner runs the tasks posted to it on |worker_pool|, a
+// batch of them per worker pool task. While the worker pool is busy, the
+// tasks of the simple cache operations posted for many entries pile up, and
+// each later worker pool task runs up to kMaxTasksPerBatch of them instead of
+// one. An idle worker pool still picks every task right away.
+//
+// Tasks posted with a delay are not batched. The tasks of a batch run one
+// after another, so tasks posted to a SimpleBatchingTaskRunner must not block
+// on each other.
+class NET_EXPORT_PRIVATE SimpleBatchingTaskRunner : public base::TaskRunner {
+ public:
+  static const size_t kMaxTasksPerBatch = 8;
+
+  explicit SimpleBatchingTaskRunner(base::TaskRunner* worker_pool);
+
+  // base::TaskRunner implementation.
+  virtual bool PostDelayedTask(const tracked_objects::Location& from_here,
+                               const base::Closure& task,
+                               base::TimeDelta delay) OVERRIDE;
+  virtual bool RunsTasksOnCurrentThread() const OVERRIDE;
+
+ private:
+  virtual ~SimpleBatchingTaskRunner();
+
+  // Runs on |worker_pool_|, and runs the next batch of |pending_tasks_|.
+  void RunBatch();
+
+  const scoped_refptr<base::TaskRunner> worker_pool_;
+
+  // Protects the members below, as tasks may be posted from any thread.
+  base::Lock lock_;
+
+  std::deque<base::Closure> pending_tasks_;
+
+  // Number of RunBatch() tasks posted to |worker_pool_| which have not
+  // started yet. There are always enough of them to run |pending_tasks_|.
+  size_t scheduled_batches_;
+
+  DISALLOW_COPY_AND_ASSIGN(SimpleBatchingTaskRunner);
+};
+
+}  // namespace disk_cache
+
+#endif  // NET_DISK_CACHE_SIMPLE_SIMPLE_BATCHING_TASK_RUNNER_H_
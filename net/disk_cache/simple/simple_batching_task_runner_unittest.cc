@@ -0,0 +1,95 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/simple/simple_batching_task_runner.h"
+
+#include <vector>
+
+#include "base/bind.h"
+#include "base/location.h"
+#include "base/memory/ref_counted.h"
+#include "base/task_runner.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace disk_cache {
+
+namespace {
+
+// A worker pool which runs its tasks only when asked to.
+class ManualTaskRunner : public base::TaskRunner {
+ public:
+  ManualTaskRunner() {}
+
+  virtual bool PostDelayedTask(const tracked_objects::Location& from_here,
+                               const base::Closure& task,
+                               base::TimeDelta delay) OVERRIDE {
+    tasks_.push_back(task);
+    return true;
+  }
+
+  virtual bool RunsTasksOnCurrentThread() const OVERRIDE { return true; }
+
+  size_t num_tasks() const { return tasks_.size(); }
+
+  void RunTasks() {
+    std::vector<base::Closure> tasks;
+    tasks.swap(tasks_);
+    for (size_t i = 0; i < tasks.size(); ++i)
+      tasks[i].Run();
+  }
+
+ private:
+  virtual ~ManualTaskRunner() {}
+
+  std::vector<base::Closure> tasks_;
+
+  DISALLOW_COPY_AND_ASSIGN(ManualTaskRunner);
+};
+
+void AppendValue(std::vector<int>* values, int value) {
+  values->push_back(value);
+}
+
+}  // namespace
+
+TEST(SimpleBatchingTaskRunnerTest, IdleWorkerPool) {
+  scoped_refptr<ManualTaskRunner> worker_pool(new ManualTaskRunner);
+  scoped_refptr<SimpleBatchingTaskRunner> task_runner(
+      new SimpleBatchingTaskRunner(worker_pool.get()));
+
+  std::vector<int> values;
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(task_runner->PostTask(FROM_HERE,
+                                      base::Bind(&AppendValue, &values, i)));
+    EXPECT_EQ(1U, worker_pool->num_tasks());
+    worker_pool->RunTasks();
+  }
+  ASSERT_EQ(3U, values.size());
+  for (int i = 0; i < 3; ++i)
+    EXPECT_EQ(i, values[i]);
+}
+
+TEST(SimpleBatchingTaskRunnerTest, BusyWorkerPool) {
+  scoped_refptr<ManualTaskRunner> worker_pool(new ManualTaskRunner);
+  scoped_refptr<SimpleBatchingTaskRunner> task_runner(
+      new SimpleBatchingTaskRunner(worker_pool.get()));
+
+  // The tasks posted while the worker pool is busy are run by as few worker
+  // pool tasks as the batch size allows.
+  const int kNumTasks = 2 * SimpleBatchingTaskRunner::kMaxTasksPerBatch + 1;
+  std::vector<int> values;
+  for (int i = 0; i < kNumTasks; ++i) {
+    EXPECT_TRUE(task_runner->PostTask(FROM_HERE,
+                                      base::Bind(&AppendValue, &values, i)));
+  }
+  EXPECT_EQ(3U, worker_pool->num_tasks());
+  worker_pool->RunTasks();
+  EXPECT_EQ(0U, worker_pool->num_tasks());
+
+  ASSERT_EQ(static_cast<size_t>(kNumTasks), values.size());
+  for (int i = 0; i < kNumTasks; ++i)
+    EXPECT_EQ(i, values[i]);
+}
+
+}  // namespace disk_cache
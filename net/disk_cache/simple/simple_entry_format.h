@@ -27,6 +27,12 @@ const uint64 kSimpleSparseRangeMagicNumber = GG_UINT64_C(0xeb97bf016553676b);
 //   - a SimpleFileEOF record for stream 1.
 //   - the data from stream 0.
 //   - a SimpleFileEOF record for stream 0.
+//
+// When the body of the entry is deduplicated, stream 1 is not stored in this
+// file, its SimpleFileEOF record has the FLAG_EXTERNAL_BODY flag and the size
+// of the stream, and the stream is stored, without a header, in a file of the
+// "bodies" directory named after its SHA-256 hash, which the entry links to
+// as its "_b" file. All the entries with the same body share that file.
 
 // A file containing stream 2 in the Simple cache consists of:
 //   - a SimpleFileHeader.
@@ -36,6 +42,9 @@ const uint64 kSimpleSparseRangeMagicNumber = GG_UINT64_C(0xeb97bf016553676b);
 static const int kSimpleEntryFileCount = 2;
 static const int kSimpleEntryStreamCount = 3;
 
+// The directory of the cache holding the deduplicated bodies.
+static const char kSimpleBodiesDirectory[] = "bodies";
+
 struct NET_EXPORT_PRIVATE SimpleFileHeader {
   SimpleFileHeader();
 
@@ -48,6 +57,7 @@ struct NET_EXPORT_PRIVATE SimpleFileHeader {
 struct NET_EXPORT_PRIVATE SimpleFileEOF {
   enum Flags {
     FLAG_HAS_CRC32 = (1U << 0),
+    FLAG_EXTERNAL_BODY = (1U << 1),
   };
 
   SimpleFileEOF();
@@ -55,7 +65,8 @@ struct NET_EXPORT_PRIVATE SimpleFileEOF {
   uint64 final_magic_number;
   uint32 flags;
   uint32 data_crc32;
-  // |stream_size| is only used in the EOF record for stream 0.
+  // |stream_size| is only used in the EOF record for stream 0, and in the one
+  // for stream 1 when it has the FLAG_EXTERNAL_BODY flag.
   uint32 stream_size;
 };
 
@@ -782,7 +782,8 @@ void SimpleEntryImpl::CloseInternal() {
                    SimpleEntryStat(last_used_, last_modified_, data_size_,
                                    sparse_data_size_),
                    base::Passed(&crc32s_to_write),
-                   stream_0_data_);
+                   stream_0_data_,
+                   !doomed_ && backend_.get() && backend_->dedup_bodies());
     Closure reply = base::Bind(&SimpleEntryImpl::CloseOperationComplete, this);
     synchronous_entry_ = NULL;
     worker_pool_->PostTaskAndReply(FROM_HERE, task, reply);
@@ -172,6 +172,10 @@ class NET_EXPORT_PRIVATE SimpleIndex
   base::hash_set<uint64> removed_entries_;
   bool initialized_;
 
+  // The entry_hash of the entries inserted, removed or updated since the last
+  // time the index was written to disk.
+  base::hash_set<uint64> changed_entries_;
+
   scoped_ptr<SimpleIndexFile> index_file_;
 
   scoped_refptr<base::SingleThreadTaskRunner> io_thread_;
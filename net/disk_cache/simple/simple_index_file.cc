@@ -4,6 +4,10 @@
 
 #include "net/disk_cache/simple/simple_index_file.h"
 
+#include <string.h>
+
+#include <algorithm>
+#include <string>
 #include <vector>
 
 #include "base/file_util.h"
@@ -30,6 +34,12 @@ const int kEntryFilesSuffixLength = 2;
 
 const uint64 kMaxEntiresInIndex = 100000000;
 
+const uint64 kSimpleIndexJournalMagicNumber = GG_UINT64_C(0x6a6f75726e616c21);
+
+// The whole index file is rewritten once the journal holds more entries than
+// this, or than a quarter of the entries of the index, whichever is larger.
+const size_t kMinJournaledEntriesBeforeRewrite = 1000;
+
 uint32 CalculatePickleCRC(const Pickle& pickle) {
   return crc32(crc32(0, Z_NULL, 0),
                reinterpret_cast<const Bytef*>(pickle.payload()),
@@ -75,6 +85,49 @@ bool WritePickleFile(Pickle* pickle, const base::FilePath& file_name) {
   return true;
 }
 
+// Appends |pickle| to |journal_data|, prefixed by its size as the records of
+// the index journal are.
+void AppendJournalRecord(const Pickle& pickle, std::string* journal_data) {
+  const uint32 record_size = pickle.size();
+  journal_data->append(reinterpret_cast<const char*>(&record_size),
+                       sizeof(record_size));
+  journal_data->append(static_cast<const char*>(pickle.data()), pickle.size());
+}
+
+// Reads the record at |*offset| in the index journal |data| of length |length|
+// into |record|, and advances |*offset| past it. Returns false if the journal
+// ends before the record does.
+bool ReadJournalRecord(const char* data, size_t length, size_t* offset,
+                       scoped_ptr<Pickle>* record) {
+  uint32 record_size;
+  if (length - *offset < sizeof(record_size))
+    return false;
+  memcpy(&record_size, data + *offset, sizeof(record_size));
+  *offset += sizeof(record_size);
+  if (record_size > length - *offset)
+    return false;
+  record->reset(new Pickle(data + *offset, record_size));
+  *offset += record_size;
+  return (*record)->data() != NULL;
+}
+
+// Starts a new journal for the index file with the CRC |index_crc|.
+bool WriteJournalHeader(uint32 index_crc, const base::FilePath& file_name) {
+  Pickle header;
+  header.WriteUInt64(kSimpleIndexJournalMagicNumber);
+  header.WriteUInt32(kSimpleVersion);
+  header.WriteUInt32(index_crc);
+  std::string journal_data;
+  AppendJournalRecord(header, &journal_data);
+  int bytes_written =
+      base::WriteFile(file_name, journal_data.data(), journal_data.size());
+  if (bytes_written != implicit_cast<int>(journal_data.size())) {
+    base::DeleteFile(file_name, /* recursive = */ false);
+    return false;
+  }
+  return true;
+}
+
 // Called for each cache directory traversal iteration.
 void ProcessEntryFile(SimpleIndex::EntrySet* entries,
                       const base::FilePath& file_path) {
@@ -143,6 +196,8 @@ const char SimpleIndexFile::kIndexFileName[] = "the-real-index";
 const char SimpleIndexFile::kIndexDirectory[] = "index-dir";
 // static
 const char SimpleIndexFile::kTempIndexFileName[] = "temp-index";
+// static
+const char SimpleIndexFile::kJournalFileName[] = "the-real-index-journal";
 
 SimpleIndexFile::IndexMetadata::IndexMetadata()
     : magic_number_(kSimpleIndexMagicNumber),
@@ -195,6 +250,13 @@ void SimpleIndexFile::SyncWriteToDisk(net::CacheType cache_type,
   // part of a Create operation does not fit into the time budget for the index
   // flush delay. This simple approach will be reconsidered if it does not allow
   // for maintaining freshness.
+  //
+  // The journal is deleted first, as the records appended to it from now on
+  // are relative to the new index file. Until the new journal is started,
+  // appending to it fails, and a lost write leaves a stale index behind.
+  const base::FilePath journal_filename =
+      index_filename.DirName().AppendASCII(kJournalFileName);
+  base::DeleteFile(journal_filename, /* recursive = */ false);
   base::Time cache_dir_mtime;
   if (!simple_util::GetMTime(cache_directory, &cache_dir_mtime)) {
     LOG(ERROR) << "Could obtain information about cache age";
@@ -215,6 +277,10 @@ void SimpleIndexFile::SyncWriteToDisk(net::CacheType cache_type,
   // Atomically rename the temporary index file to become the real one.
   bool result = base::ReplaceFile(temp_index_filename, index_filename, NULL);
   DCHECK(result);
+  if (!WriteJournalHeader(pickle->headerT<PickleHeader>()->crc,
+                          journal_filename)) {
+    LOG(ERROR) << "Failed to write the index journal file";
+  }
 
   if (app_on_background) {
     SIMPLE_CACHE_UMA(TIMES,
@@ -245,7 +311,11 @@ SimpleIndexFile::SimpleIndexFile(
       index_file_(cache_directory_.AppendASCII(kIndexDirectory)
                       .AppendASCII(kIndexFileName)),
       temp_index_file_(cache_directory_.AppendASCII(kIndexDirectory)
-                           .AppendASCII(kTempIndexFileName)) {
+                           .AppendASCII(kTempIndexFileName)),
+      journal_file_(cache_directory_.AppendASCII(kIndexDirectory)
+                        .AppendASCII(kJournalFileName)),
+      wrote_index_file_(false),
+      journaled_entries_(0) {
 }
 
 SimpleIndexFile::~SimpleIndexFile() {}
@@ -260,10 +330,31 @@ void SimpleIndexFile::LoadIndexEntries(base::Time cache_last_modified,
   worker_pool_->PostTaskAndReply(FROM_HERE, task, callback);
 }
 
-void SimpleIndexFile::WriteToDisk(const SimpleIndex::EntrySet& entry_set,
-                                  uint64 cache_size,
-                                  const base::TimeTicks& start,
-                                  bool app_on_background) {
+void SimpleIndexFile::WriteToDisk(
+    const SimpleIndex::EntrySet& entry_set,
+    const base::hash_set<uint64>& changed_entries,
+    uint64 cache_size,
+    const base::TimeTicks& start,
+    bool app_on_background) {
+  const size_t max_journaled_entries =
+      std::max(kMinJournaledEntriesBeforeRewrite, entry_set.size() / 4);
+  if (wrote_index_file_ &&
+      journaled_entries_ + changed_entries.size() <= max_journaled_entries) {
+    if (changed_entries.empty())
+      return;
+    journaled_entries_ += changed_entries.size();
+    scoped_ptr<Pickle> record =
+        SerializeJournalRecord(entry_set, changed_entries);
+    cache_thread_->PostTask(FROM_HERE, base::Bind(
+        &SimpleIndexFile::SyncAppendToJournal,
+        cache_directory_,
+        journal_file_,
+        base::Passed(&record)));
+    return;
+  }
+
+  wrote_index_file_ = true;
+  journaled_entries_ = 0;
   IndexMetadata index_metadata(entry_set.size(), cache_size);
   scoped_ptr<Pickle> pickle = Serialize(index_metadata, entry_set);
   cache_thread_->PostTask(FROM_HERE, base::Bind(
@@ -286,7 +377,9 @@ void SimpleIndexFile::SyncLoadIndexEntries(
     SimpleIndexLoadResult* out_result) {
   // Load the index and find its age.
   base::Time last_cache_seen_by_index;
-  SyncLoadFromDisk(index_file_path, &last_cache_seen_by_index, out_result);
+  SyncLoadFromDisk(index_file_path,
+                   index_file_path.DirName().AppendASCII(kJournalFileName),
+                   &last_cache_seen_by_index, out_result);
 
   // Consider the index loaded if it is fresh.
   const bool index_file_existed = base::PathExists(index_file_path);
@@ -327,9 +420,11 @@ void SimpleIndexFile::SyncLoadIndexEntries(
 }
 
 // static
-void SimpleIndexFile::SyncLoadFromDisk(const base::FilePath& index_filename,
-                                       base::Time* out_last_cache_seen_by_index,
-                                       SimpleIndexLoadResult* out_result) {
+void SimpleIndexFile::SyncLoadFromDisk(
+    const base::FilePath& index_filename,
+    const base::FilePath& journal_filename,
+    base::Time* out_last_cache_seen_by_index,
+    SimpleIndexLoadResult* out_result) {
   out_result->Reset();
 
   base::MemoryMappedFile index_file_map;
@@ -345,8 +440,89 @@ void SimpleIndexFile::SyncLoadFromDisk(const base::FilePath& index_filename,
       out_last_cache_seen_by_index,
       out_result);
 
-  if (!out_result->did_load)
+  if (!out_result->did_load) {
     base::DeleteFile(index_filename, false);
+    return;
+  }
+
+  Pickle index_pickle(reinterpret_cast<const char*>(index_file_map.data()),
+                      index_file_map.length());
+  SyncReplayJournal(journal_filename,
+                    index_pickle.headerT<PickleHeader>()->crc,
+                    out_last_cache_seen_by_index,
+                    &out_result->entries);
+}
+
+// static
+void SimpleIndexFile::SyncReplayJournal(
+    const base::FilePath& journal_filename,
+    uint32 index_crc,
+    base::Time* out_last_cache_seen_by_index,
+    SimpleIndex::EntrySet* entries) {
+  base::MemoryMappedFile journal_file_map;
+  if (!journal_file_map.Initialize(journal_filename))
+    return;
+  const char* data = reinterpret_cast<const char*>(journal_file_map.data());
+  const size_t length = journal_file_map.length();
+
+  size_t offset = 0;
+  scoped_ptr<Pickle> header;
+  if (!ReadJournalRecord(data, length, &offset, &header))
+    return;
+  PickleIterator header_it(*header);
+  uint64 magic_number;
+  uint32 version;
+  uint32 journal_index_crc;
+  if (!header_it.ReadUInt64(&magic_number) ||
+      !header_it.ReadUInt32(&version) ||
+      !header_it.ReadUInt32(&journal_index_crc) ||
+      magic_number != kSimpleIndexJournalMagicNumber ||
+      version != kSimpleVersion || journal_index_crc != index_crc) {
+    return;
+  }
+
+  // A record may have been partially appended, so stop at the first one which
+  // does not check out.
+  scoped_ptr<Pickle> record;
+  while (ReadJournalRecord(data, length, &offset, &record)) {
+    if (record->headerT<PickleHeader>()->crc != CalculatePickleCRC(*record)) {
+      LOG(WARNING) << "Invalid record in Simple Index journal.";
+      return;
+    }
+
+    PickleIterator record_it(*record);
+    uint64 number_of_entries;
+    if (!record_it.ReadUInt64(&number_of_entries))
+      return;
+    SimpleIndex::EntrySet record_entries;
+    std::vector<uint64> removed_entries;
+    for (uint64 i = 0; i < number_of_entries; ++i) {
+      uint64 hash_key;
+      bool present;
+      if (!record_it.ReadUInt64(&hash_key) || !record_it.ReadBool(&present))
+        return;
+      if (!present) {
+        removed_entries.push_back(hash_key);
+        continue;
+      }
+      EntryMetadata entry_metadata;
+      if (!entry_metadata.Deserialize(&record_it))
+        return;
+      record_entries[hash_key] = entry_metadata;
+    }
+    int64 cache_last_modified;
+    if (!record_it.ReadInt64(&cache_last_modified))
+      return;
+
+    for (size_t i = 0; i < removed_entries.size(); ++i)
+      entries->erase(removed_entries[i]);
+    for (SimpleIndex::EntrySet::const_iterator it = record_entries.begin();
+         it != record_entries.end(); ++it) {
+      (*entries)[it->first] = it->second;
+    }
+    *out_last_cache_seen_by_index =
+        base::Time::FromInternalValue(cache_last_modified);
+  }
 }
 
 // static
@@ -364,6 +540,24 @@ scoped_ptr<Pickle> SimpleIndexFile::Serialize(
   return pickle.Pass();
 }
 
+// static
+scoped_ptr<Pickle> SimpleIndexFile::SerializeJournalRecord(
+    const SimpleIndex::EntrySet& entries,
+    const base::hash_set<uint64>& changed_entries) {
+  scoped_ptr<Pickle> pickle(new Pickle(sizeof(SimpleIndexFile::PickleHeader)));
+
+  pickle->WriteUInt64(changed_entries.size());
+  for (base::hash_set<uint64>::const_iterator it = changed_entries.begin();
+       it != changed_entries.end(); ++it) {
+    pickle->WriteUInt64(*it);
+    SimpleIndex::EntrySet::const_iterator entry = entries.find(*it);
+    pickle->WriteBool(entry != entries.end());
+    if (entry != entries.end())
+      entry->second.Serialize(pickle.get());
+  }
+  return pickle.Pass();
+}
+
 // static
 void SimpleIndexFile::Deserialize(const char* data, int data_len,
                                   base::Time* out_cache_last_modified,
@@ -428,6 +622,28 @@ void SimpleIndexFile::Deserialize(const char* data, int data_len,
   out_result->did_load = true;
 }
 
+// static
+void SimpleIndexFile::SyncAppendToJournal(
+    const base::FilePath& cache_directory,
+    const base::FilePath& journal_filename,
+    scoped_ptr<Pickle> pickle) {
+  base::Time cache_dir_mtime;
+  if (!simple_util::GetMTime(cache_directory, &cache_dir_mtime)) {
+    LOG(ERROR) << "Could obtain information about cache age";
+    return;
+  }
+  SerializeFinalData(cache_dir_mtime, pickle.get());
+
+  // The record is appended along with its size, so that a later load sees
+  // either all of it or a truncated record.
+  std::string record;
+  AppendJournalRecord(*pickle, &record);
+  if (base::AppendToFile(journal_filename, record.data(), record.size()) !=
+      implicit_cast<int>(record.size())) {
+    LOG(ERROR) << "Failed to append to the index journal file";
+  }
+}
+
 // static
 void SimpleIndexFile::SyncRestoreFromDisk(
     const base::FilePath& cache_directory,
@@ -435,6 +651,8 @@ void SimpleIndexFile::SyncRestoreFromDisk(
     SimpleIndexLoadResult* out_result) {
   VLOG(1) << "Simple Cache Index is being restored from disk.";
   base::DeleteFile(index_file_path, /* recursive = */ false);
+  base::DeleteFile(index_file_path.DirName().AppendASCII(kJournalFileName),
+                   /* recursive = */ false);
   out_result->Reset();
   SimpleIndex::EntrySet* entries = &out_result->entries;
 
@@ -46,6 +46,13 @@ struct NET_EXPORT_PRIVATE SimpleIndexLoadResult {
 // see SimpleIndexFile::Serialize() and SeeSimpleIndexFile::LoadFromDisk()
 // methods.
 //
+// Between two writes of the whole index file, the entries changed since the
+// previous write are appended to a journal file instead. The journal starts
+// with the CRC of the index file it applies to, followed by records of changed
+// entries, each prefixed by its size. Loading the index replays the valid
+// records of the journal on top of the index file. See
+// SimpleIndexFile::SerializeJournalRecord() and SyncReplayJournal().
+//
 // The non-static methods must run on the IO thread. All the real
 // work is done in the static methods, which are run on the cache thread
 // or in worker threads. Synchronization between methods is the
@@ -85,8 +92,11 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
                                 const base::Closure& callback,
                                 SimpleIndexLoadResult* out_result);
 
-  // Write the specified set of entries to disk.
+  // Write the specified set of entries to disk. |changed_entries| are the
+  // hashes of the entries changed since the previous call; unless it is time to
+  // rewrite the whole index file, only those are appended to the journal.
   virtual void WriteToDisk(const SimpleIndex::EntrySet& entry_set,
+                           const base::hash_set<uint64>& changed_entries,
                            uint64 cache_size,
                            const base::TimeTicks& start,
                            bool app_on_background);
@@ -108,11 +118,22 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
                                    const base::FilePath& index_file_path,
                                    SimpleIndexLoadResult* out_result);
 
-  // Load the index file from disk returning an EntrySet.
+  // Load the index file, and the journal in |journal_filename|, from disk
+  // returning an EntrySet.
   static void SyncLoadFromDisk(const base::FilePath& index_filename,
+                               const base::FilePath& journal_filename,
                                base::Time* out_last_cache_seen_by_index,
                                SimpleIndexLoadResult* out_result);
 
+  // Applies to |entries| the records of the journal in |journal_filename|
+  // written after the index file with the CRC |index_crc|, up to the first
+  // invalid one. |out_last_cache_seen_by_index| is advanced to the cache
+  // modification time of the last record applied.
+  static void SyncReplayJournal(const base::FilePath& journal_filename,
+                                uint32 index_crc,
+                                base::Time* out_last_cache_seen_by_index,
+                                SimpleIndex::EntrySet* entries);
+
   // Returns a scoped_ptr for a newly allocated Pickle containing the serialized
   // data to be written to a file. Note: the pickle is not in a consistent state
   // immediately after calling this menthod, one needs to call
@@ -121,6 +142,13 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
       const SimpleIndexFile::IndexMetadata& index_metadata,
       const SimpleIndex::EntrySet& entries);
 
+  // Returns a newly allocated Pickle holding the state of |changed_entries|
+  // in |entries|: their metadata, or their absence for removed entries. Like
+  // the pickle returned by Serialize(), it needs SerializeFinalData.
+  static scoped_ptr<Pickle> SerializeJournalRecord(
+      const SimpleIndex::EntrySet& entries,
+      const base::hash_set<uint64>& changed_entries);
+
   // Appends cache modification time data to the serialized format. This is
   // performed on a thread accessing the disk. It is not combined with the main
   // serialization path to avoid extra thread hops or copying the pickle to the
@@ -151,6 +179,11 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
                               const base::TimeTicks& start_time,
                               bool app_on_background);
 
+  // Appends the journal record |pickle| to the journal file.
+  static void SyncAppendToJournal(const base::FilePath& cache_directory,
+                                  const base::FilePath& journal_filename,
+                                  scoped_ptr<Pickle> pickle);
+
   // Scan the index directory for entries, returning an EntrySet of all entries
   // found.
   static void SyncRestoreFromDisk(const base::FilePath& cache_directory,
@@ -174,10 +207,20 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
   const base::FilePath cache_directory_;
   const base::FilePath index_file_;
   const base::FilePath temp_index_file_;
+  const base::FilePath journal_file_;
+
+  // Whether the whole index file has been written since |this| was created.
+  // The index file is always rewritten first, so that the journal does not
+  // need to account for the changes made before the index was loaded.
+  bool wrote_index_file_;
+
+  // Number of entries journaled since the index file was last written.
+  size_t journaled_entries_;
 
   static const char kIndexDirectory[];
   static const char kIndexFileName[];
   static const char kTempIndexFileName[];
+  static const char kJournalFileName[];
 
   DISALLOW_COPY_AND_ASSIGN(SimpleIndexFile);
 };
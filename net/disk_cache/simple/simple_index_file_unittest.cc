@@ -207,8 +207,8 @@ TEST_F(SimpleIndexFileTest, DISABLED_WriteThenLoadIndex) {
   const uint64 kCacheSize = 456U;
   {
     WrappedSimpleIndexFile simple_index_file(cache_dir.path());
-    simple_index_file.WriteToDisk(entries, kCacheSize,
-                                  base::TimeTicks(), false);
+    simple_index_file.WriteToDisk(entries, base::hash_set<uint64>(),
+                                  kCacheSize, base::TimeTicks(), false);
     base::RunLoop().RunUntilIdle();
     EXPECT_TRUE(base::PathExists(simple_index_file.GetIndexFilePath()));
   }
@@ -233,6 +233,59 @@ TEST_F(SimpleIndexFileTest, DISABLED_WriteThenLoadIndex) {
     EXPECT_EQ(1U, load_index_result.entries.count(kHashes[i]));
 }
 
+TEST_F(SimpleIndexFileTest, WriteJournalThenLoadIndex) {
+  base::ScopedTempDir cache_dir;
+  ASSERT_TRUE(cache_dir.CreateUniqueTempDir());
+
+  SimpleIndex::EntrySet entries;
+  static const uint64 kHashes[] = { 11, 22, 33 };
+  for (size_t i = 0; i < arraysize(kHashes); ++i) {
+    SimpleIndex::InsertInEntrySet(
+        kHashes[i], EntryMetadata(Time(), kHashes[i]), &entries);
+  }
+
+  const uint64 kCacheSize = 456U;
+  {
+    WrappedSimpleIndexFile simple_index_file(cache_dir.path());
+    // The first write is of the whole index file.
+    simple_index_file.WriteToDisk(entries, base::hash_set<uint64>(),
+                                  kCacheSize, base::TimeTicks(), false);
+    base::RunLoop().RunUntilIdle();
+    ASSERT_TRUE(base::PathExists(simple_index_file.GetIndexFilePath()));
+
+    // The next ones only append the changed entries to the journal.
+    base::hash_set<uint64> changed_entries;
+    entries.erase(11);
+    changed_entries.insert(11);
+    entries[22].SetEntrySize(222);
+    changed_entries.insert(22);
+    simple_index_file.WriteToDisk(entries, changed_entries, kCacheSize,
+                                  base::TimeTicks(), false);
+    changed_entries.clear();
+    SimpleIndex::InsertInEntrySet(44, EntryMetadata(Time(), 44), &entries);
+    changed_entries.insert(44);
+    simple_index_file.WriteToDisk(entries, changed_entries, kCacheSize,
+                                  base::TimeTicks(), false);
+    base::RunLoop().RunUntilIdle();
+  }
+
+  WrappedSimpleIndexFile simple_index_file(cache_dir.path());
+  SimpleIndexLoadResult load_index_result;
+  simple_index_file.LoadIndexEntries(Time(), GetCallback(),
+                                     &load_index_result);
+  base::RunLoop().RunUntilIdle();
+
+  ASSERT_TRUE(callback_called());
+  EXPECT_TRUE(load_index_result.did_load);
+  EXPECT_FALSE(load_index_result.flush_required);
+  EXPECT_EQ(3U, load_index_result.entries.size());
+  EXPECT_EQ(0U, load_index_result.entries.count(11));
+  ASSERT_EQ(1U, load_index_result.entries.count(22));
+  EXPECT_EQ(222, load_index_result.entries[22].GetEntrySize());
+  EXPECT_EQ(1U, load_index_result.entries.count(33));
+  EXPECT_EQ(1U, load_index_result.entries.count(44));
+}
+
 TEST_F(SimpleIndexFileTest, LoadCorruptIndex) {
   base::ScopedTempDir cache_dir;
   ASSERT_TRUE(cache_dir.CreateUniqueTempDir());
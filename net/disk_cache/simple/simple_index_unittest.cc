@@ -67,6 +67,7 @@ class MockSimpleIndexFile : public SimpleIndexFile,
   }
 
   virtual void WriteToDisk(const SimpleIndex::EntrySet& entry_set,
+                           const base::hash_set<uint64>& changed_entries,
                            uint64 cache_size,
                            const base::TimeTicks& start,
                            bool app_on_background) OVERRIDE {
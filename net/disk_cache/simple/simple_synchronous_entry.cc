@@ -12,10 +12,14 @@
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
 #include "base/file_util.h"
+#include "base/files/file_enumerator.h"
 #include "base/hash.h"
 #include "base/location.h"
 #include "base/sha1.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/stringprintf.h"
+#include "crypto/secure_hash.h"
+#include "crypto/sha2.h"
 #include "net/base/io_buffer.h"
 #include "net/base/net_errors.h"
 #include "net/disk_cache/simple/simple_backend_version.h"
@@ -103,6 +107,13 @@ void RecordCloseResult(net::CacheType cache_type, CloseResult result) {
                    "SyncCloseResult", cache_type, result, WRITE_RESULT_MAX);
 }
 
+// Bodies smaller than this are not deduplicated: the shared file and the
+// link cost about as much disk space as they would save.
+const int kMinDedupBodySize = 16 * 1024;
+
+// The size of the chunks in which bodies are hashed and copied.
+const int kBodyCopyBufferSize = 64 * 1024;
+
 bool CanOmitEmptyFile(int file_index) {
   DCHECK_LE(0, file_index);
   DCHECK_GT(disk_cache::kSimpleEntryFileCount, file_index);
@@ -116,6 +127,7 @@ namespace disk_cache {
 using simple_util::GetEntryHashKey;
 using simple_util::GetFilenameFromEntryHashAndFileIndex;
 using simple_util::GetSparseFilenameFromEntryHash;
+using simple_util::GetBodyLinkFilenameFromEntryHash;
 using simple_util::GetDataSizeFromKeyAndFileSize;
 using simple_util::GetFileSizeFromKeyAndDataSize;
 using simple_util::GetFileIndexFromStreamIndex;
@@ -287,8 +299,13 @@ void SimpleSynchronousEntry::ReadData(const EntryOperationData& in_entry_op,
   DCHECK_LT(0, in_entry_op.buf_len);
   DCHECK(!empty_file_omitted_[file_index]);
   File* file = const_cast<File*>(&files_[file_index]);
-  int bytes_read =
-      file->Read(file_offset, out_buf->data(), in_entry_op.buf_len);
+  int bytes_read;
+  if (in_entry_op.index == 1 && external_body_) {
+    bytes_read = const_cast<File*>(&body_file_)->Read(
+        in_entry_op.offset, out_buf->data(), in_entry_op.buf_len);
+  } else {
+    bytes_read = file->Read(file_offset, out_buf->data(), in_entry_op.buf_len);
+  }
   if (bytes_read > 0) {
     entry_stat->set_last_used(Time::Now());
     *out_crc32 = crc32(crc32(0L, Z_NULL, 0),
@@ -346,6 +363,18 @@ void SimpleSynchronousEntry::WriteData(const EntryOperationData& in_entry_op,
   }
   DCHECK(!empty_file_omitted_[file_index]);
 
+  // The part of a deduplicated body the write truncates away is not copied.
+  if (index == 1 && external_body_ &&
+      !MaterializeBody(*out_entry_stat,
+                       truncate ? std::min(offset,
+                                           out_entry_stat->data_size(index))
+                                : out_entry_stat->data_size(index))) {
+    RecordWriteResult(cache_type_, WRITE_RESULT_WRITE_FAILURE);
+    Doom();
+    *out_result = net::ERR_CACHE_WRITE_FAILURE;
+    return;
+  }
+
   if (extending_by_write) {
     // The EOF record and the eventual stream afterward need to be zeroed out.
     const int64 file_eof_offset =
@@ -621,10 +650,39 @@ void SimpleSynchronousEntry::CheckEOFRecord(int index,
 void SimpleSynchronousEntry::Close(
     const SimpleEntryStat& entry_stat,
     scoped_ptr<std::vector<CRCRecord> > crc32s_to_write,
-    net::GrowableIOBuffer* stream_0_data) {
+    net::GrowableIOBuffer* stream_0_data,
+    bool dedup_body) {
   DCHECK(stream_0_data);
+  if (dedup_body && !external_body_ && !empty_file_omitted_[0] &&
+      entry_stat.data_size(1) >= kMinDedupBodySize) {
+    for (std::vector<CRCRecord>::const_iterator it = crc32s_to_write->begin();
+         it != crc32s_to_write->end(); ++it) {
+      if (it->index == 1 && it->has_crc32) {
+        DedupBody(entry_stat);
+        break;
+      }
+    }
+  }
+  if (stream_0_moved_) {
+    // The EOF record of stream 0 moves along with it.
+    bool has_stream_0_record = false;
+    for (std::vector<CRCRecord>::const_iterator it = crc32s_to_write->begin();
+         it != crc32s_to_write->end(); ++it) {
+      if (it->index == 0)
+        has_stream_0_record = true;
+    }
+    if (!has_stream_0_record) {
+      crc32s_to_write->push_back(CRCRecord(
+          0, true,
+          crc32(crc32(0, Z_NULL, 0),
+                reinterpret_cast<const Bytef*>(stream_0_data->data()),
+                entry_stat.data_size(0))));
+    }
+  }
+  const SimpleEntryStat layout_stat = GetFileLayoutStat(entry_stat);
+
   // Write stream 0 data.
-  int stream_0_offset = entry_stat.GetOffsetInFile(key_, 0, 0);
+  int stream_0_offset = layout_stat.GetOffsetInFile(key_, 0, 0);
   if (files_[0].Write(stream_0_offset, stream_0_data->data(),
                       entry_stat.data_size(0)) !=
       entry_stat.data_size(0)) {
@@ -646,8 +704,10 @@ void SimpleSynchronousEntry::Close(
     eof_record.flags = 0;
     if (it->has_crc32)
       eof_record.flags |= SimpleFileEOF::FLAG_HAS_CRC32;
+    if (stream_index == 1 && external_body_)
+      eof_record.flags |= SimpleFileEOF::FLAG_EXTERNAL_BODY;
     eof_record.data_crc32 = it->data_crc32;
-    int eof_offset = entry_stat.GetEOFOffsetInFile(key_, stream_index);
+    int eof_offset = layout_stat.GetEOFOffsetInFile(key_, stream_index);
     // If stream 0 changed size, the file needs to be resized, otherwise the
     // next open will yield wrong stream sizes. On stream 1 and stream 2 proper
     // resizing of the file is handled in SimpleSynchronousEntry::WriteData().
@@ -673,7 +733,7 @@ void SimpleSynchronousEntry::Close(
       continue;
 
     files_[i].Close();
-    const int64 file_size = entry_stat.GetFileSize(key_, i);
+    const int64 file_size = layout_stat.GetFileSize(key_, i);
     SIMPLE_CACHE_UMA(CUSTOM_COUNTS,
                      "LastClusterSize", cache_type_,
                      file_size % 4096, 0, 4097, 50);
@@ -685,6 +745,7 @@ void SimpleSynchronousEntry::Close(
 
   if (sparse_file_open())
     sparse_file_.Close();
+  body_file_.Close();
 
   if (files_created_) {
     const int stream2_file_index = GetFileIndexFromStreamIndex(2);
@@ -705,7 +766,9 @@ SimpleSynchronousEntry::SimpleSynchronousEntry(net::CacheType cache_type,
       entry_hash_(entry_hash),
       key_(key),
       have_open_files_(false),
-      initialized_(false) {
+      initialized_(false),
+      external_body_(false),
+      stream_0_moved_(false) {
   for (int i = 0; i < kSimpleEntryFileCount; ++i)
     empty_file_omitted_[i] = false;
 }
@@ -950,6 +1013,11 @@ int SimpleSynchronousEntry::InitializeForOpen(
           total_data_size, out_entry_stat, stream_0_data, out_stream_0_crc32);
       if (ret_value_stream_0 != net::OK)
         return ret_value_stream_0;
+      if (out_entry_stat->data_size(1) == 0 &&
+          !OpenBodyFileIfExternal(out_entry_stat)) {
+        DLOG(WARNING) << "Could not open the body file of the entry.";
+        return net::ERR_FAILED;
+      }
     } else {
       out_entry_stat->set_data_size(
           2, GetDataSizeFromKeyAndFileSize(key_, out_entry_stat->data_size(2)));
@@ -1104,7 +1172,8 @@ int SimpleSynchronousEntry::GetEOFRecordData(int index,
                                              uint32* out_crc32,
                                              int* out_data_size) const {
   SimpleFileEOF eof_record;
-  int file_offset = entry_stat.GetEOFOffsetInFile(key_, index);
+  int file_offset =
+      GetFileLayoutStat(entry_stat).GetEOFOffsetInFile(key_, index);
   int file_index = GetFileIndexFromStreamIndex(index);
   File* file = const_cast<File*>(&files_[file_index]);
   if (file->Read(file_offset, reinterpret_cast<char*>(&eof_record),
@@ -1128,10 +1197,140 @@ int SimpleSynchronousEntry::GetEOFRecordData(int index,
   return net::OK;
 }
 
+SimpleEntryStat SimpleSynchronousEntry::GetFileLayoutStat(
+    const SimpleEntryStat& entry_stat) const {
+  SimpleEntryStat layout_stat(entry_stat);
+  if (external_body_)
+    layout_stat.set_data_size(1, 0);
+  return layout_stat;
+}
+
+bool SimpleSynchronousEntry::OpenBodyFileIfExternal(
+    SimpleEntryStat* out_entry_stat) {
+  DCHECK_EQ(0, out_entry_stat->data_size(1));
+  SimpleFileEOF eof_record;
+  int eof_offset = out_entry_stat->GetEOFOffsetInFile(key_, 1);
+  if (files_[0].Read(eof_offset, reinterpret_cast<char*>(&eof_record),
+                     sizeof(eof_record)) != sizeof(eof_record) ||
+      eof_record.final_magic_number != kSimpleFinalMagicNumber ||
+      !(eof_record.flags & SimpleFileEOF::FLAG_EXTERNAL_BODY)) {
+    // Stream 1 is empty, or was never written.
+    return true;
+  }
+
+  body_file_.Initialize(
+      path_.AppendASCII(GetBodyLinkFilenameFromEntryHash(entry_hash_)),
+      File::FLAG_OPEN | File::FLAG_READ);
+  if (!body_file_.IsValid() ||
+      body_file_.GetLength() != implicit_cast<int64>(eof_record.stream_size)) {
+    return false;
+  }
+  external_body_ = true;
+  out_entry_stat->set_data_size(1, eof_record.stream_size);
+  return true;
+}
+
+bool SimpleSynchronousEntry::DedupBody(const SimpleEntryStat& entry_stat) {
+  DCHECK(!external_body_);
+  const int body_size = entry_stat.data_size(1);
+  const int64 body_offset = entry_stat.GetOffsetInFile(key_, 0, 1);
+  scoped_ptr<char[]> buf(new char[kBodyCopyBufferSize]);
+
+  scoped_ptr<crypto::SecureHash> hash(
+      crypto::SecureHash::Create(crypto::SecureHash::SHA256));
+  for (int offset = 0; offset < body_size; offset += kBodyCopyBufferSize) {
+    const int len = std::min(body_size - offset, kBodyCopyBufferSize);
+    if (files_[0].Read(body_offset + offset, buf.get(), len) != len)
+      return false;
+    hash->Update(buf.get(), len);
+  }
+  uint8 digest[crypto::kSHA256Length];
+  hash->Finish(digest, sizeof(digest));
+
+  const FilePath bodies_path = path_.AppendASCII(kSimpleBodiesDirectory);
+  const FilePath body_path =
+      bodies_path.AppendASCII(base::HexEncode(digest, sizeof(digest)));
+  int64 existing_body_size;
+  const bool hit = base::GetFileSize(body_path, &existing_body_size) &&
+                   existing_body_size == body_size;
+  if (!hit) {
+    // The body is written under a name of its own first, so that an entry
+    // with the same body closing at the same time never links to a partial
+    // file.
+    if (!base::CreateDirectory(bodies_path))
+      return false;
+    const FilePath temp_path = bodies_path.AppendASCII(
+        GetBodyLinkFilenameFromEntryHash(entry_hash_));
+    File temp_file(temp_path, File::FLAG_CREATE_ALWAYS | File::FLAG_WRITE);
+    bool copied = temp_file.IsValid();
+    for (int offset = 0; copied && offset < body_size;
+         offset += kBodyCopyBufferSize) {
+      const int len = std::min(body_size - offset, kBodyCopyBufferSize);
+      copied = files_[0].Read(body_offset + offset, buf.get(), len) == len &&
+               temp_file.Write(offset, buf.get(), len) == len;
+    }
+    temp_file.Close();
+    if (!copied || !base::ReplaceFile(temp_path, body_path, NULL)) {
+      base::DeleteFile(temp_path, false);
+      return false;
+    }
+  }
+
+  const FilePath link_path =
+      path_.AppendASCII(GetBodyLinkFilenameFromEntryHash(entry_hash_));
+  base::DeleteFile(link_path, false);
+  if (!simple_util::CreateHardLink(body_path, link_path))
+    return false;
+
+  SIMPLE_CACHE_UMA(BOOLEAN, "BodyDedupHit", cache_type_, hit);
+  if (hit) {
+    SIMPLE_CACHE_UMA(MEMORY_KB, "BodyDedupSizeSaved", cache_type_,
+                     body_size / 1024);
+  }
+  external_body_ = true;
+  stream_0_moved_ = true;
+  return true;
+}
+
+bool SimpleSynchronousEntry::MaterializeBody(
+    const SimpleEntryStat& entry_stat,
+    int body_size) {
+  DCHECK(external_body_);
+  DCHECK_LE(body_size, entry_stat.data_size(1));
+  const int64 body_offset = entry_stat.GetOffsetInFile(key_, 0, 1);
+  scoped_ptr<char[]> buf(new char[kBodyCopyBufferSize]);
+  for (int offset = 0; offset < body_size; offset += kBodyCopyBufferSize) {
+    const int len = std::min(body_size - offset, kBodyCopyBufferSize);
+    if (body_file_.Read(offset, buf.get(), len) != len ||
+        files_[0].Write(body_offset + offset, buf.get(), len) != len) {
+      return false;
+    }
+  }
+  body_file_.Close();
+  base::DeleteFile(
+      path_.AppendASCII(GetBodyLinkFilenameFromEntryHash(entry_hash_)), false);
+  external_body_ = false;
+  stream_0_moved_ = true;
+  return true;
+}
+
 void SimpleSynchronousEntry::Doom() const {
   DeleteFilesForEntryHash(path_, entry_hash_);
 }
 
+// static
+void SimpleSynchronousEntry::DeleteUnreferencedBodies(const FilePath& path) {
+  base::FileEnumerator enumerator(path.AppendASCII(kSimpleBodiesDirectory),
+                                  false /* recursive */,
+                                  base::FileEnumerator::FILES);
+  for (FilePath body_path = enumerator.Next(); !body_path.empty();
+       body_path = enumerator.Next()) {
+    // The only name left is the one in the bodies directory.
+    if (simple_util::GetHardLinkCount(body_path) <= 1)
+      base::DeleteFile(body_path, false);
+  }
+}
+
 // static
 bool SimpleSynchronousEntry::DeleteFileForEntryHash(
     const FilePath& path,
@@ -1154,6 +1353,8 @@ bool SimpleSynchronousEntry::DeleteFilesForEntryHash(
   FilePath to_delete = path.AppendASCII(
       GetSparseFilenameFromEntryHash(entry_hash));
   base::DeleteFile(to_delete, false);
+  to_delete = path.AppendASCII(GetBodyLinkFilenameFromEntryHash(entry_hash));
+  base::DeleteFile(to_delete, false);
   return result;
 }
 
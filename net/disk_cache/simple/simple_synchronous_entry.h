@@ -166,10 +166,16 @@ class SimpleSynchronousEntry {
                          int* out_result);
 
   // Close all streams, and add write EOF records to streams indicated by the
-  // CRCRecord entries in |crc32s_to_write|.
+  // CRCRecord entries in |crc32s_to_write|. If |dedup_body| is true and stream
+  // 1 was written in full, moves it to the shared body file with its contents.
   void Close(const SimpleEntryStat& entry_stat,
              scoped_ptr<std::vector<CRCRecord> > crc32s_to_write,
-             net::GrowableIOBuffer* stream_0_data);
+             net::GrowableIOBuffer* stream_0_data,
+             bool dedup_body);
+
+  // Deletes the shared body files no entry links to anymore from the cache in
+  // |path|.
+  static void DeleteUnreferencedBodies(const base::FilePath& path);
 
   const base::FilePath& path() const { return path_; }
   std::string key() const { return key_; }
@@ -254,6 +260,24 @@ class SimpleSynchronousEntry {
       scoped_refptr<net::GrowableIOBuffer>* stream_0_data,
       uint32* out_stream_0_crc32) const;
 
+  // Returns |entry_stat| with the data sizes of the streams as stored in the
+  // entry files; a deduplicated stream 1 takes no space in file 0.
+  SimpleEntryStat GetFileLayoutStat(const SimpleEntryStat& entry_stat) const;
+
+  // Opens the shared body file if the EOF record of stream 1 says the stream
+  // is stored there, and sets its size in |out_entry_stat|. Returns false if
+  // the body file cannot be opened.
+  bool OpenBodyFileIfExternal(SimpleEntryStat* out_entry_stat);
+
+  // Moves stream 1 from file 0 to the shared body file with the same contents,
+  // creating that file if no other entry has it. Returns false, leaving stream
+  // 1 in file 0, on failure.
+  bool DedupBody(const SimpleEntryStat& entry_stat);
+
+  // Copies the first |body_size| bytes of stream 1 back from the shared body
+  // file to file 0, before the stream gets modified.
+  bool MaterializeBody(const SimpleEntryStat& entry_stat, int body_size);
+
   int GetEOFRecordData(int index,
                        const SimpleEntryStat& entry_stat,
                        bool* out_has_crc32,
@@ -330,6 +354,13 @@ class SimpleSynchronousEntry {
   // written).
   int64 sparse_tail_offset_;
 
+  // The link to the shared body file, open when stream 1 is stored there.
+  base::File body_file_;
+  bool external_body_;
+
+  // True if stream 1 moved in or out of file 0, which moves stream 0.
+  bool stream_0_moved_;
+
   // True if the entry was created, or false if it was opened. Used to log
   // SimpleCache.*.EntryCreatedWithStream2Omitted only for created entries.
   bool files_created_;
@@ -6,6 +6,10 @@
 
 #include <limits>
 
+#if defined(OS_POSIX)
+#include <unistd.h>
+#endif
+
 #include "base/file_util.h"
 #include "base/format_macros.h"
 #include "base/logging.h"
@@ -88,6 +92,10 @@ std::string GetSparseFilenameFromEntryHash(uint64 entry_hash) {
   return base::StringPrintf("%016" PRIx64 "_s", entry_hash);
 }
 
+std::string GetBodyLinkFilenameFromEntryHash(uint64 entry_hash) {
+  return base::StringPrintf("%016" PRIx64 "_b", entry_hash);
+}
+
 std::string GetFilenameFromKeyAndFileIndex(const std::string& key,
                                            int file_index) {
   return GetEntryHashKeyAsHexString(key) +
@@ -134,6 +142,28 @@ bool GetMTime(const base::FilePath& path, base::Time* out_mtime) {
   return true;
 }
 
+bool CreateHardLink(const base::FilePath& existing_path,
+                    const base::FilePath& new_path) {
+#if defined(OS_POSIX)
+  base::ThreadRestrictions::AssertIOAllowed();
+  return link(existing_path.value().c_str(), new_path.value().c_str()) == 0;
+#else
+  return false;
+#endif
+}
+
+int GetHardLinkCount(const base::FilePath& path) {
+#if defined(OS_POSIX)
+  base::ThreadRestrictions::AssertIOAllowed();
+  struct stat file_stat;
+  if (stat(path.value().c_str(), &file_stat) != 0)
+    return 0;
+  return file_stat.st_nlink;
+#else
+  return 0;
+#endif
+}
+
 }  // namespace simple_backend
 
 }  // namespace disk_cache
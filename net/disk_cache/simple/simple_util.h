@@ -51,6 +51,10 @@ std::string GetFilenameFromEntryHashAndFileIndex(uint64 entry_hash,
 // Given a |key| for an entry, returns the name of the sparse data file.
 std::string GetSparseFilenameFromEntryHash(uint64 entry_hash);
 
+// Given a |key| for an entry, returns the name of its link to the shared body
+// file holding stream 1, when the body is deduplicated.
+std::string GetBodyLinkFilenameFromEntryHash(uint64 entry_hash);
+
 // Given the size of a file holding a stream in the simple backend and the key
 // to an entry, returns the number of bytes in the stream.
 NET_EXPORT_PRIVATE int32 GetDataSizeFromKeyAndFileSize(const std::string& key,
@@ -69,6 +73,14 @@ NET_EXPORT_PRIVATE int GetFileIndexFromStreamIndex(int stream_index);
 // functions in file.h, the time resolution is milliseconds.
 NET_EXPORT_PRIVATE bool GetMTime(const base::FilePath& path,
                                  base::Time* out_mtime);
+
+// Makes |new_path| another name of the file at |existing_path|. Returns false
+// if that fails, or if the platform has no hard links.
+NET_EXPORT_PRIVATE bool CreateHardLink(const base::FilePath& existing_path,
+                                       const base::FilePath& new_path);
+
+// Returns the number of names of the file at |path|, or 0 on failure.
+NET_EXPORT_PRIVATE int GetHardLinkCount(const base::FilePath& path);
 }  // namespace simple_backend
 
 }  // namespace disk_cache
@@ -8,10 +8,24 @@
 #include "base/metrics/field_trial.h"
 #include "base/metrics/histogram.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/values.h"
 #include "net/base/net_errors.h"
+#include "net/base/net_util.h"
 
 namespace net {
 
+namespace {
+
+// Keys of the dictionaries written by HostCache::GetAsListValue().
+const char kHostnameKey[] = "hostname";
+const char kAddressFamilyKey[] = "address_family";
+const char kFlagsKey[] = "flags";
+const char kExpirationKey[] = "expiration";
+const char kAddressesKey[] = "addresses";
+const char kCanonicalNameKey[] = "canonical_name";
+
+}  // namespace
+
 //-----------------------------------------------------------------------------
 
 HostCache::Entry::Entry(int error, const AddressList& addrlist,
@@ -46,7 +60,27 @@ const HostCache::Entry* HostCache::Lookup(const Key& key,
   if (caching_is_disabled())
     return NULL;
 
-  return entries_.Get(key, now);
+  const Entry* entry = entries_.Get(key, now);
+  if (!entry || now >= entry->expires)
+    return NULL;
+  return entry;
+}
+
+const HostCache::Entry* HostCache::LookupStale(const Key& key,
+                                               base::TimeTicks now,
+                                               bool* is_stale) {
+  DCHECK(CalledOnValidThread());
+  DCHECK(is_stale);
+  if (caching_is_disabled())
+    return NULL;
+
+  // |entries_| only holds on to expired entries which were successful and are
+  // still within their stale period.
+  const Entry* entry = entries_.Get(key, now);
+  if (!entry)
+    return NULL;
+  *is_stale = now >= entry->expires;
+  return entry;
 }
 
 void HostCache::Set(const Key& key,
@@ -57,7 +91,23 @@ void HostCache::Set(const Key& key,
   if (caching_is_disabled())
     return;
 
-  entries_.Put(key, entry, now, now + ttl);
+  Entry stored_entry(entry);
+  stored_entry.expires = now + ttl;
+  base::TimeTicks stale_expiration = stored_entry.expires;
+  if (entry.error == OK)
+    stale_expiration += max_stale_age_;
+  entries_.Put(key, stored_entry, now, stale_expiration);
+}
+
+void HostCache::set_max_stale_age(base::TimeDelta max_stale_age) {
+  DCHECK(CalledOnValidThread());
+  DCHECK(max_stale_age >= base::TimeDelta());
+  max_stale_age_ = max_stale_age;
+}
+
+base::TimeDelta HostCache::max_stale_age() const {
+  DCHECK(CalledOnValidThread());
+  return max_stale_age_;
 }
 
 void HostCache::clear() {
@@ -70,6 +120,91 @@ size_t HostCache::size() const {
   return entries_.size();
 }
 
+void HostCache::GetAsListValue(base::ListValue* entry_list,
+                               base::TimeTicks now,
+                               base::Time wall_now) const {
+  DCHECK(CalledOnValidThread());
+  DCHECK(entry_list);
+
+  for (EntryMap::Iterator it(entries_); it.HasNext(); it.Advance()) {
+    const Key& key = it.key();
+    const Entry& entry = it.value();
+    // Negative entries are short-lived and not worth restoring.
+    if (entry.error != OK || entry.expires <= now)
+      continue;
+
+    base::ListValue* addresses = new base::ListValue();
+    for (size_t i = 0; i < entry.addrlist.size(); ++i)
+      addresses->AppendString(entry.addrlist[i].ToStringWithoutPort());
+
+    // base::Value can't hold an int64, so save the expiration as a string.
+    base::Time expiration = wall_now + (entry.expires - now);
+    base::DictionaryValue* entry_dict = new base::DictionaryValue();
+    entry_dict->SetString(kHostnameKey, key.hostname);
+    entry_dict->SetInteger(kAddressFamilyKey, key.address_family);
+    entry_dict->SetInteger(kFlagsKey, key.host_resolver_flags);
+    entry_dict->SetString(kExpirationKey,
+                          base::Int64ToString(expiration.ToInternalValue()));
+    entry_dict->Set(kAddressesKey, addresses);
+    entry_dict->SetString(kCanonicalNameKey, entry.addrlist.canonical_name());
+    entry_list->Append(entry_dict);
+  }
+}
+
+bool HostCache::RestoreFromListValue(const base::ListValue& entry_list,
+                                     base::TimeTicks now,
+                                     base::Time wall_now) {
+  DCHECK(CalledOnValidThread());
+  if (caching_is_disabled())
+    return true;
+
+  for (base::ListValue::const_iterator it = entry_list.begin();
+       it != entry_list.end(); ++it) {
+    const base::DictionaryValue* entry_dict = NULL;
+    std::string hostname;
+    int address_family;
+    int flags;
+    std::string expiration_string;
+    int64 expiration_value;
+    const base::ListValue* addresses = NULL;
+    std::string canonical_name;
+    if (!(*it)->GetAsDictionary(&entry_dict) ||
+        !entry_dict->GetString(kHostnameKey, &hostname) ||
+        !entry_dict->GetInteger(kAddressFamilyKey, &address_family) ||
+        address_family < 0 || address_family > ADDRESS_FAMILY_LAST ||
+        !entry_dict->GetInteger(kFlagsKey, &flags) ||
+        !entry_dict->GetString(kExpirationKey, &expiration_string) ||
+        !base::StringToInt64(expiration_string, &expiration_value) ||
+        !entry_dict->GetList(kAddressesKey, &addresses) ||
+        !entry_dict->GetString(kCanonicalNameKey, &canonical_name)) {
+      return false;
+    }
+
+    base::TimeDelta ttl =
+        base::Time::FromInternalValue(expiration_value) - wall_now;
+    if (ttl <= base::TimeDelta())
+      continue;
+
+    AddressList addrlist;
+    for (size_t i = 0; i < addresses->GetSize(); ++i) {
+      std::string address_string;
+      IPAddressNumber address;
+      if (!addresses->GetString(i, &address_string) ||
+          !ParseIPLiteralToNumber(address_string, &address)) {
+        return false;
+      }
+      addrlist.push_back(IPEndPoint(address, 0));
+    }
+    addrlist.set_canonical_name(canonical_name);
+
+    Key key(hostname, static_cast<AddressFamily>(address_family), flags);
+    if (entries_.Get(key, now))
+      continue;
+    Set(key, Entry(OK, addrlist), now, ttl);
+  }
+  return true;
+}
+
 size_t HostCache::max_entries() const {
   DCHECK(CalledOnValidThread());
   return entries_.max_entries();
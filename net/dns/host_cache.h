@@ -17,6 +17,10 @@
 #include "net/base/expiring_cache.h"
 #include "net/base/net_export.h"
 
+namespace base {
+class ListValue;
+}
+
 namespace net {
 
 // Cache used by HostResolver to map hostnames to their resolved result.
@@ -36,6 +40,8 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
     AddressList addrlist;
     // TTL obtained from the nameserver. Negative if unknown.
     base::TimeDelta ttl;
+    // Time at which the entry expires. Set by HostCache::Set().
+    base::TimeTicks expires;
   };
 
   struct Key {
@@ -82,6 +88,13 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
   // |now|. If there is no such entry, returns NULL.
   const Entry* Lookup(const Key& key, base::TimeTicks now);
 
+  // Like Lookup(), but also returns a successful entry for |key| which expired
+  // less than max_stale_age() before |now|. Sets |*is_stale| to whether the
+  // returned entry has expired.
+  const Entry* LookupStale(const Key& key,
+                           base::TimeTicks now,
+                           bool* is_stale);
+
   // Overwrites or creates an entry for |key|.
   // |entry| is the value to set, |now| is the current time
   // |ttl| is the "time to live".
@@ -96,6 +109,28 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
   // Returns the number of entries in the cache.
   size_t size() const;
 
+  // Sets how long successful entries are kept after they expire, so that
+  // LookupStale() can still return them. Applies to entries set afterwards.
+  // Defaults to zero, which disables stale entries.
+  void set_max_stale_age(base::TimeDelta max_stale_age);
+  base::TimeDelta max_stale_age() const;
+
+  // Appends a dictionary for each unexpired, successful entry to |entry_list|,
+  // so that the cache can be restored by RestoreFromListValue() after a
+  // restart. Expiration times are saved as wall-clock times based on
+  // |wall_now|, which should correspond to |now|.
+  void GetAsListValue(base::ListValue* entry_list,
+                      base::TimeTicks now,
+                      base::Time wall_now) const;
+
+  // Adds the entries saved by GetAsListValue() which have not expired by
+  // |wall_now|, keeping their remaining TTL. Entries already in the cache are
+  // more recent and are not overwritten. Returns false if |entry_list| is
+  // malformed, in which case it may have been partially restored.
+  bool RestoreFromListValue(const base::ListValue& entry_list,
+                            base::TimeTicks now,
+                            base::Time wall_now);
+
   // Following are used by net_internals UI.
   size_t max_entries() const;
 
@@ -114,8 +149,12 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
 
   // Map from hostname (presumably in lowercase canonicalized format) to
   // a resolved result entry.
+  // Entries in |entries_| expire at the end of their stale period, while
+  // Entry::expires holds the end of their TTL.
   EntryMap entries_;
 
+  base::TimeDelta max_stale_age_;
+
   DISALLOW_COPY_AND_ASSIGN(HostCache);
 };
 
@@ -8,7 +8,9 @@
 #include "base/stl_util.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
+#include "base/values.h"
 #include "net/base/net_errors.h"
+#include "net/base/net_util.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace net {
@@ -85,6 +87,123 @@ TEST(HostCacheTest, Basic) {
   EXPECT_FALSE(cache.Lookup(key2, now));
 }
 
+// Successful entries are served by LookupStale() for |max_stale_age| after
+// their TTL, failed entries are not.
+TEST(HostCacheTest, Stale) {
+  const base::TimeDelta kTTL = base::TimeDelta::FromSeconds(10);
+  const base::TimeDelta kMaxStaleAge = base::TimeDelta::FromSeconds(5);
+
+  HostCache cache(kMaxCacheEntries);
+  cache.set_max_stale_age(kMaxStaleAge);
+
+  // Start at t=0.
+  base::TimeTicks now;
+
+  HostCache::Key key1 = Key("foobar.com");
+  HostCache::Key key2 = Key("foobar2.com");
+  HostCache::Entry entry = HostCache::Entry(OK, AddressList());
+  HostCache::Entry failure = HostCache::Entry(ERR_NAME_NOT_RESOLVED,
+                                              AddressList());
+
+  cache.Set(key1, entry, now, kTTL);
+  cache.Set(key2, failure, now, kTTL);
+
+  bool is_stale = true;
+  EXPECT_TRUE(cache.Lookup(key1, now));
+  EXPECT_TRUE(cache.LookupStale(key1, now, &is_stale));
+  EXPECT_FALSE(is_stale);
+
+  // Advance to t=10; both entries are expired, but |key1| is still stale.
+  now += kTTL;
+
+  EXPECT_FALSE(cache.Lookup(key1, now));
+  EXPECT_FALSE(cache.Lookup(key2, now));
+  is_stale = false;
+  EXPECT_TRUE(cache.LookupStale(key1, now, &is_stale));
+  EXPECT_TRUE(is_stale);
+  EXPECT_FALSE(cache.LookupStale(key2, now, &is_stale));
+
+  // Refreshing |key1| makes it fresh again.
+  cache.Set(key1, entry, now, kTTL);
+  EXPECT_TRUE(cache.LookupStale(key1, now, &is_stale));
+  EXPECT_FALSE(is_stale);
+
+  // Advance to t=25; the stale period of |key1| has passed.
+  now += kTTL + kMaxStaleAge;
+
+  EXPECT_FALSE(cache.Lookup(key1, now));
+  EXPECT_FALSE(cache.LookupStale(key1, now, &is_stale));
+}
+
+// Unexpired, successful entries survive a round trip through
+// GetAsListValue() and RestoreFromListValue() with their remaining TTL.
+TEST(HostCacheTest, SerializeAndRestore) {
+  const base::TimeDelta kTTL = base::TimeDelta::FromSeconds(10);
+
+  HostCache cache(kMaxCacheEntries);
+
+  // Start at t=0.
+  base::TimeTicks now;
+  base::Time wall_now = base::Time::FromDoubleT(1000);
+
+  IPAddressNumber address;
+  ASSERT_TRUE(ParseIPLiteralToNumber("192.168.1.1", &address));
+  AddressList addrlist = AddressList::CreateFromIPAddress(address, 0);
+  addrlist.set_canonical_name("canonical.foobar.com");
+
+  HostCache::Key key1 = Key("foobar.com");
+  HostCache::Key key2 = Key("foobar2.com");
+  HostCache::Key key3 = Key("foobar3.com");
+  cache.Set(key1, HostCache::Entry(OK, addrlist), now, kTTL);
+  cache.Set(key2, HostCache::Entry(ERR_NAME_NOT_RESOLVED, AddressList()),
+            now, kTTL);
+  cache.Set(key3, HostCache::Entry(OK, addrlist), now,
+            base::TimeDelta::FromSeconds(2));
+
+  // Advance to t=5; |key3| has expired.
+  now += base::TimeDelta::FromSeconds(5);
+  wall_now += base::TimeDelta::FromSeconds(5);
+
+  base::ListValue entry_list;
+  cache.GetAsListValue(&entry_list, now, wall_now);
+  EXPECT_EQ(1u, entry_list.GetSize());
+
+  // Restore into a new cache one second of wall time later, with a different
+  // TimeTicks base.
+  HostCache restored_cache(kMaxCacheEntries);
+  base::TimeTicks restore_now = now + base::TimeDelta::FromHours(1);
+  wall_now += base::TimeDelta::FromSeconds(1);
+  EXPECT_TRUE(restored_cache.RestoreFromListValue(entry_list, restore_now,
+                                                  wall_now));
+  EXPECT_EQ(1u, restored_cache.size());
+
+  const HostCache::Entry* entry = restored_cache.Lookup(key1, restore_now);
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(OK, entry->error);
+  ASSERT_EQ(1u, entry->addrlist.size());
+  EXPECT_EQ(address, entry->addrlist[0].address());
+  EXPECT_EQ("canonical.foobar.com", entry->addrlist.canonical_name());
+  EXPECT_FALSE(restored_cache.Lookup(key2, restore_now));
+
+  // Four seconds of TTL remained.
+  EXPECT_TRUE(restored_cache.Lookup(
+      key1, restore_now + base::TimeDelta::FromSeconds(3)));
+  EXPECT_FALSE(restored_cache.Lookup(
+      key1, restore_now + base::TimeDelta::FromSeconds(4)));
+
+  // Entries which expired while the browser was not running are dropped.
+  HostCache late_cache(kMaxCacheEntries);
+  EXPECT_TRUE(late_cache.RestoreFromListValue(
+      entry_list, restore_now, wall_now + base::TimeDelta::FromSeconds(4)));
+  EXPECT_EQ(0u, late_cache.size());
+
+  // Malformed input is rejected.
+  base::ListValue bad_list;
+  bad_list.AppendString("foobar.com");
+  EXPECT_FALSE(late_cache.RestoreFromListValue(bad_list, restore_now,
+                                               wall_now));
+}
+
 // Try caching entries for a failed resolve attempt -- since we set the TTL of
 // such entries to 0 it won't store, but it will kick out the previous result.
 TEST(HostCacheTest, NoCacheZeroTTL) {
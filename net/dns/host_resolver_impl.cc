@@ -1205,6 +1205,7 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
         priority_tracker_(priority),
         had_non_speculative_request_(false),
         had_dns_config_(false),
+        is_refresh_(false),
         num_occupied_job_slots_(0),
         dns_task_error_(OK),
         creation_time_(base::TimeTicks::Now()),
@@ -1271,6 +1272,13 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
     }
   }
 
+  // Marks this Job as refreshing a stale cache entry. Such a Job runs to
+  // completion and caches its result even if it has no Requests.
+  void MarkAsRefresh() {
+    is_refresh_ = true;
+    net_log_.AddEvent(NetLog::TYPE_HOST_RESOLVER_IMPL_JOB_REFRESH);
+  }
+
   void AddRequest(scoped_ptr<Request> req) {
     DCHECK_EQ(key_.hostname, req->info().hostname());
 
@@ -1316,7 +1324,7 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
                                  req->request_net_log().source(),
                                  priority()));
 
-    if (num_active_requests() > 0) {
+    if (num_active_requests() > 0 || is_refresh_) {
       UpdatePriority();
     } else {
       // If we were called from a Request's callback within CompleteRequests,
@@ -1358,7 +1366,11 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
   // Attempts to serve the job from HOSTS. Returns true if succeeded and
   // this Job was destroyed.
   bool ServeFromHosts() {
-    DCHECK_GT(num_active_requests(), 0u);
+    DCHECK(num_active_requests() > 0 || is_refresh_);
+    // A refresh Job without Requests has no port to serve HOSTS entries with,
+    // so leave it running.
+    if (num_active_requests() == 0)
+      return false;
     AddressList addr_list;
     if (resolver_->ServeFromHosts(key(),
                                   requests_.front()->info(),
@@ -1665,7 +1677,7 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
       handle_.Reset();
     }
 
-    if (num_active_requests() == 0) {
+    if (num_active_requests() == 0 && !is_refresh_) {
       net_log_.AddEvent(NetLog::TYPE_CANCELLED);
       net_log_.EndEventWithNetErrorCode(NetLog::TYPE_HOST_RESOLVER_IMPL_JOB,
                                         OK);
@@ -1675,7 +1687,7 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
     net_log_.EndEventWithNetErrorCode(NetLog::TYPE_HOST_RESOLVER_IMPL_JOB,
                                       entry.error);
 
-    DCHECK(!requests_.empty());
+    DCHECK(!requests_.empty() || is_refresh_);
 
     if (entry.error == OK) {
       // Record this histogram here, when we know the system has a valid DNS
@@ -1750,6 +1762,9 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
   // Distinguishes measurements taken while DnsClient was fully configured.
   bool had_dns_config_;
 
+  // True if this Job refreshes a stale cache entry, see MarkAsRefresh().
+  bool is_refresh_;
+
   // Number of slots occupied by this Job in resolver's PrioritizedDispatcher.
   unsigned num_occupied_job_slots_;
 
@@ -1939,8 +1954,15 @@ int HostResolverImpl::ResolveHelper(const Key& key,
   int net_error = ERR_UNEXPECTED;
   if (ResolveAsIP(key, info, &net_error, addresses))
     return net_error;
-  if (ServeFromCache(key, info, &net_error, addresses)) {
-    request_net_log.AddEvent(NetLog::TYPE_HOST_RESOLVER_IMPL_CACHE_HIT);
+  bool is_stale = false;
+  if (ServeFromCache(key, info, &net_error, addresses, &is_stale)) {
+    if (is_stale) {
+      request_net_log.AddEvent(
+          NetLog::TYPE_HOST_RESOLVER_IMPL_STALE_CACHE_HIT);
+      StartRefreshJob(key, request_net_log);
+    } else {
+      request_net_log.AddEvent(NetLog::TYPE_HOST_RESOLVER_IMPL_CACHE_HIT);
+    }
     return net_error;
   }
   // TODO(szym): Do not do this if nsswitch.conf instructs not to.
@@ -2050,14 +2072,16 @@ bool HostResolverImpl::ResolveAsIP(const Key& key,
 bool HostResolverImpl::ServeFromCache(const Key& key,
                                       const RequestInfo& info,
                                       int* net_error,
-                                      AddressList* addresses) {
+                                      AddressList* addresses,
+                                      bool* is_stale) {
   DCHECK(addresses);
   DCHECK(net_error);
+  DCHECK(is_stale);
   if (!info.allow_cached_response() || !cache_.get())
     return false;
 
-  const HostCache::Entry* cache_entry = cache_->Lookup(
-      key, base::TimeTicks::Now());
+  const HostCache::Entry* cache_entry = cache_->LookupStale(
+      key, base::TimeTicks::Now(), is_stale);
   if (!cache_entry)
     return false;
 
@@ -2070,6 +2094,29 @@ bool HostResolverImpl::ServeFromCache(const Key& key,
   return true;
 }
 
+void HostResolverImpl::StartRefreshJob(const Key& key,
+                                       const BoundNetLog& request_net_log) {
+  // A Job already in flight for |key| will update the cache when it completes.
+  JobMap::iterator jobit = jobs_.find(key);
+  if (jobit != jobs_.end())
+    return;
+
+  Job* job =
+      new Job(weak_ptr_factory_.GetWeakPtr(), key, IDLE, request_net_log);
+  job->MarkAsRefresh();
+  job->Schedule(false);
+
+  // Check for queue overflow.
+  if (dispatcher_.num_queued_jobs() > max_queued_jobs_) {
+    Job* evicted = static_cast<Job*>(dispatcher_.EvictOldestLowest());
+    DCHECK(evicted);
+    evicted->OnEvicted();  // Deletes |evicted|.
+    if (evicted == job)
+      return;
+  }
+  jobs_.insert(jobit, std::make_pair(key, job));
+}
+
 bool HostResolverImpl::ServeFromHosts(const Key& key,
                                       const RequestInfo& info,
                                       AddressList* addresses) {
@@ -179,11 +179,17 @@ class NET_EXPORT HostResolverImpl
 
   // If |key| is not found in cache returns false, otherwise returns
   // true, sets |net_error| to the cached error code and fills |addresses|
-  // if it is a positive entry.
+  // if it is a positive entry. Sets |is_stale| if the entry's TTL has expired
+  // but it is still within the cache's stale period.
   bool ServeFromCache(const Key& key,
                       const RequestInfo& info,
                       int* net_error,
-                      AddressList* addresses);
+                      AddressList* addresses,
+                      bool* is_stale);
+
+  // Starts an IDLE priority Job to refresh the stale cache entry for |key|,
+  // unless a Job for |key| is already outstanding.
+  void StartRefreshJob(const Key& key, const BoundNetLog& request_net_log);
 
   // If we have a DnsClient with a valid DnsConfig, and |key| is found in the
   // HOSTS file, returns true and fills |addresses|. Otherwise returns false.
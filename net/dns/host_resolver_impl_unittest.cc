@@ -909,6 +909,42 @@ TEST_F(HostResolverImplTest, FlushCacheOnIPAddressChange) {
   EXPECT_EQ(OK, req->WaitForResult());
 }
 
+// Test that a stale cache entry is served synchronously while a single
+// background Job refreshes it.
+TEST_F(HostResolverImplTest, ServeStaleAndRefresh) {
+  proc_->SignalMultiple(2u);  // One for the initial resolve, one for refresh.
+
+  Request* req = CreateRequest("host1", 70);
+  EXPECT_EQ(ERR_IO_PENDING, req->Resolve());
+  EXPECT_EQ(OK, req->WaitForResult());
+
+  // Replace the cached entry with one that expired a minute ago.
+  HostCache* cache = resolver_->GetHostCache();
+  cache->set_max_stale_age(base::TimeDelta::FromMinutes(5));
+  ASSERT_EQ(1u, cache->size());
+  HostCache::EntryMap::Iterator it(cache->entries());
+  HostCache::Key key = it.key();
+  HostCache::Entry entry = it.value();
+  cache->Set(key, entry,
+             base::TimeTicks::Now() - base::TimeDelta::FromMinutes(2),
+             base::TimeDelta::FromMinutes(1));
+
+  // The stale entry is served synchronously, and a refresh Job is started.
+  req = CreateRequest("host1", 75);
+  EXPECT_EQ(OK, req->Resolve());
+  EXPECT_TRUE(req->HasOneAddress("127.0.0.1", 75));
+
+  // A request which bypasses the cache attaches to the refresh Job.
+  HostResolver::RequestInfo info(HostPortPair("host1", 80));
+  info.set_allow_cached_response(false);
+  req = CreateRequest(info, DEFAULT_PRIORITY);
+  EXPECT_EQ(ERR_IO_PENDING, req->Resolve());
+  EXPECT_EQ(OK, req->WaitForResult());
+
+  EXPECT_EQ(2u, proc_->GetCaptureList().size());
+  EXPECT_TRUE(cache->Lookup(key, base::TimeTicks::Now()));
+}
+
 // Test that IP address changes send ERR_NETWORK_CHANGED to pending requests.
 TEST_F(HostResolverImplTest, AbortOnIPAddressChanged) {
   Request* req = CreateRequest("host1", 70);
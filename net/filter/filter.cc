@@ -10,6 +10,7 @@
 #include "net/base/mime_util.h"
 #include "net/base/net_util.h"
 #include "net/filter/gzip_filter.h"
+#include "net/filter/lzma_filter.h"
 #include "net/filter/sdch_filter.h"
 
 namespace {
@@ -18,6 +19,7 @@ namespace {
 const char kDeflate[]      = "deflate";
 const char kGZip[]         = "gzip";
 const char kXGZip[]        = "x-gzip";
+const char kLzma[]         = "lzma";
 const char kSdch[]         = "sdch";
 // compress and x-compress are currently not supported.  If we decide to support
 // them, we'll need the same mime type compatibility hack we have for gzip.  For
@@ -141,6 +143,8 @@ Filter::FilterType Filter::ConvertEncodingToType(
   } else if (LowerCaseEqualsASCII(filter_type, kGZip) ||
              LowerCaseEqualsASCII(filter_type, kXGZip)) {
     type_id = FILTER_TYPE_GZIP;
+  } else if (LowerCaseEqualsASCII(filter_type, kLzma)) {
+    type_id = FILTER_TYPE_LZMA;
   } else if (LowerCaseEqualsASCII(filter_type, kSdch)) {
     type_id = FILTER_TYPE_SDCH;
   } else {
@@ -350,6 +354,13 @@ Filter* Filter::InitGZipFilter(FilterType type_id, int buffer_size) {
   return gz_filter->InitDecoding(type_id) ? gz_filter.release() : NULL;
 }
 
+// static
+Filter* Filter::InitLzmaFilter(int buffer_size) {
+  scoped_ptr<LzmaFilter> lzma_filter(new LzmaFilter());
+  lzma_filter->InitBuffer(buffer_size);
+  return lzma_filter->InitDecoding() ? lzma_filter.release() : NULL;
+}
+
 // static
 Filter* Filter::InitSdchFilter(FilterType type_id,
                                const FilterContext& filter_context,
@@ -371,6 +382,9 @@ Filter* Filter::PrependNewFilter(FilterType type_id,
     case FILTER_TYPE_GZIP:
       first_filter.reset(InitGZipFilter(type_id, buffer_size));
       break;
+    case FILTER_TYPE_LZMA:
+      first_filter.reset(InitLzmaFilter(buffer_size));
+      break;
     case FILTER_TYPE_SDCH:
     case FILTER_TYPE_SDCH_POSSIBLE:
       if (SdchManager::Global() && SdchManager::sdch_enabled()) {
@@ -396,7 +410,23 @@ void Filter::InitBuffer(int buffer_size) {
   stream_buffer_size_ = buffer_size;
 }
 
+bool Filter::IsPassThrough() const {
+  return false;
+}
+
 void Filter::PushDataIntoNextFilter() {
+  if (IsPassThrough() && !next_filter_->stream_data_len_) {
+    // The next filter reads straight out of our stream_buffer_. Our buffer is
+    // only refilled once our stream_data_len_ is 0 and the chain asks for
+    // more data, which the next filter only does once it has consumed all of
+    // its input.
+    next_filter_->next_stream_data_ = next_stream_data_;
+    next_filter_->stream_data_len_ = stream_data_len_;
+    next_stream_data_ = NULL;
+    stream_data_len_ = 0;
+    last_status_ = FILTER_NEED_MORE_DATA;
+    return;
+  }
   IOBuffer* next_buffer = next_filter_->stream_buffer();
   int next_size = next_filter_->stream_buffer_size();
   last_status_ = ReadFilteredData(next_buffer->data(), &next_size);
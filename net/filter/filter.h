@@ -127,6 +127,7 @@ class NET_EXPORT_PRIVATE Filter {
     FILTER_TYPE_DEFLATE,
     FILTER_TYPE_GZIP,
     FILTER_TYPE_GZIP_HELPING_SDCH,  // Gzip possible, but pass through allowed.
+    FILTER_TYPE_LZMA,
     FILTER_TYPE_SDCH,
     FILTER_TYPE_SDCH_POSSIBLE,  // Sdch possible, but pass through allowed.
     FILTER_TYPE_UNSUPPORTED,
@@ -222,6 +223,11 @@ class NET_EXPORT_PRIVATE Filter {
   // Copy pre-filter data directly to destination buffer without decoding.
   FilterStatus CopyOut(char* dest_buffer, int* dest_len);
 
+  // Returns true if all remaining pre-filter data would be output by CopyOut()
+  // unchanged. A pass through filter in a chain lends its stream_buffer_ to
+  // the next filter instead of copying into the next filter's buffer.
+  virtual bool IsPassThrough() const;
+
   FilterStatus last_status() const { return last_status_; }
 
   // Buffer to hold the data to be filtered (the input queue).
@@ -253,6 +259,7 @@ class NET_EXPORT_PRIVATE Filter {
   // Helper methods for PrependNewFilter. If initialization is successful,
   // they return a fully initialized Filter. Otherwise, return NULL.
   static Filter* InitGZipFilter(FilterType type_id, int buffer_size);
+  static Filter* InitLzmaFilter(int buffer_size);
   static Filter* InitSdchFilter(FilterType type_id,
                                 const FilterContext& filter_context,
                                 int buffer_size);
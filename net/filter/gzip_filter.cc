@@ -64,6 +64,13 @@ bool GZipFilter::InitDecoding(Filter::FilterType filter_type) {
   return true;
 }
 
+bool GZipFilter::IsPassThrough() const {
+  // Only an SDCH body that turned out not to be gzipped; data after a gzip
+  // footer still needs the footer skipped first.
+  return decoding_status_ == DECODING_DONE &&
+         gzip_header_status_ == GZIP_GET_INVALID_HEADER;
+}
+
 Filter::FilterStatus GZipFilter::ReadFilteredData(char* dest_buffer,
                                                   int* dest_len) {
   if (!dest_buffer || !dest_len || *dest_len <= 0)
@@ -0,0 +1,164 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/filter/lzma_filter.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "third_party/lzma_sdk/LzmaDec.h"
+
+namespace net {
+
+namespace {
+
+// Coder properties plus the 64 bit uncompressed size.
+const size_t kHeaderSize = LZMA_PROPS_SIZE + 8;
+
+void* LzmaAlloc(void* p, size_t size) {
+  return malloc(size);
+}
+
+void LzmaFree(void* p, void* address) {
+  free(address);
+}
+
+ISzAlloc g_lzma_alloc = { LzmaAlloc, LzmaFree };
+
+}  // namespace
+
+struct LzmaFilter::Decoder {
+  Decoder() {
+    LzmaDec_Construct(&state);
+  }
+  ~Decoder() {
+    LzmaDec_Free(&state, &g_lzma_alloc);
+  }
+
+  CLzmaDec state;
+};
+
+bool LzmaFilter::g_lzma_enabled_ = false;
+
+LzmaFilter::LzmaFilter()
+    : decoding_status_(DECODING_UNINITIALIZED),
+      is_size_known_(false),
+      remaining_size_(0) {
+}
+
+LzmaFilter::~LzmaFilter() {
+}
+
+// static
+void LzmaFilter::EnableLzma(bool enabled) {
+  g_lzma_enabled_ = enabled;
+}
+
+bool LzmaFilter::InitDecoding() {
+  if (decoding_status_ != DECODING_UNINITIALIZED)
+    return false;
+  decoder_.reset(new Decoder);
+  decoding_status_ = DECODING_HEADER;
+  return true;
+}
+
+Filter::FilterStatus LzmaFilter::ReadFilteredData(char* dest_buffer,
+                                                  int* dest_len) {
+  if (!dest_buffer || !dest_len || *dest_len <= 0)
+    return Filter::FILTER_ERROR;
+
+  if (decoding_status_ == DECODING_DONE) {
+    // Ignore anything after the end of the stream.
+    next_stream_data_ = NULL;
+    stream_data_len_ = 0;
+    *dest_len = 0;
+    return Filter::FILTER_DONE;
+  }
+
+  if (decoding_status_ == DECODING_HEADER) {
+    Filter::FilterStatus status = ReadHeader();
+    if (status != Filter::FILTER_OK) {
+      *dest_len = 0;
+      return status;
+    }
+  }
+
+  if (decoding_status_ != DECODING_IN_PROGRESS)
+    return Filter::FILTER_ERROR;
+
+  // The decoder may hold back output when it runs out of room, so it is
+  // called even without new input.
+  SizeT output_size = *dest_len;
+  ELzmaFinishMode finish_mode = LZMA_FINISH_ANY;
+  if (is_size_known_ && remaining_size_ <= output_size) {
+    output_size = static_cast<SizeT>(remaining_size_);
+    finish_mode = LZMA_FINISH_END;
+  }
+  SizeT input_size = stream_data_len_;
+  ELzmaStatus lzma_status;
+  SRes result = LzmaDec_DecodeToBuf(
+      &decoder_->state,
+      reinterpret_cast<Byte*>(dest_buffer), &output_size,
+      reinterpret_cast<const Byte*>(next_stream_data_), &input_size,
+      finish_mode, &lzma_status);
+  if (result != SZ_OK) {
+    decoding_status_ = DECODING_ERROR;
+    return Filter::FILTER_ERROR;
+  }
+
+  *dest_len = output_size;
+  stream_data_len_ -= input_size;
+  next_stream_data_ = stream_data_len_ ? next_stream_data_ + input_size : NULL;
+  if (is_size_known_)
+    remaining_size_ -= output_size;
+
+  if (lzma_status == LZMA_STATUS_FINISHED_WITH_MARK ||
+      (is_size_known_ && remaining_size_ == 0)) {
+    decoding_status_ = DECODING_DONE;
+    return Filter::FILTER_DONE;
+  }
+  if (stream_data_len_ == 0)
+    return Filter::FILTER_NEED_MORE_DATA;
+  return Filter::FILTER_OK;
+}
+
+Filter::FilterStatus LzmaFilter::ReadHeader() {
+  DCHECK_LT(header_.size(), kHeaderSize);
+  if (!next_stream_data_ || stream_data_len_ <= 0)
+    return Filter::FILTER_NEED_MORE_DATA;
+
+  size_t amount = std::min(kHeaderSize - header_.size(),
+                           static_cast<size_t>(stream_data_len_));
+  header_.append(next_stream_data_, amount);
+  stream_data_len_ -= amount;
+  next_stream_data_ = stream_data_len_ ? next_stream_data_ + amount : NULL;
+  if (header_.size() < kHeaderSize)
+    return Filter::FILTER_NEED_MORE_DATA;
+
+  const Byte* header = reinterpret_cast<const Byte*>(header_.data());
+  uint32 dictionary_size = 0;
+  for (int i = 0; i < 4; ++i)
+    dictionary_size |= static_cast<uint32>(header[1 + i]) << (8 * i);
+  uint64 size = 0;
+  for (int i = 0; i < 8; ++i)
+    size |= static_cast<uint64>(header[LZMA_PROPS_SIZE + i]) << (8 * i);
+
+  if (dictionary_size > kMaxDictionarySize ||
+      LzmaDec_Allocate(&decoder_->state, header, LZMA_PROPS_SIZE,
+                       &g_lzma_alloc) != SZ_OK) {
+    DVLOG(1) << "Unsupported lzma header";
+    decoding_status_ = DECODING_ERROR;
+    return Filter::FILTER_ERROR;
+  }
+  LzmaDec_Init(&decoder_->state);
+
+  is_size_known_ = (size != kuint64max);
+  remaining_size_ = size;
+  decoding_status_ = DECODING_IN_PROGRESS;
+  return Filter::FILTER_OK;
+}
+
+}  // namespace net
@@ -0,0 +1,201 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/filter/lzma_filter.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/strings/stringprintf.h"
+#include "net/base/io_buffer.h"
+#include "net/filter/mock_filter_context.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/lzma_sdk/LzmaEnc.h"
+
+namespace net {
+
+namespace {
+
+const int kDefaultBufferSize = 4096;
+const int kSmallBufferSize = 128;
+
+void* TestAlloc(void* p, size_t size) {
+  return malloc(size);
+}
+
+void TestFree(void* p, void* address) {
+  free(address);
+}
+
+ISzAlloc g_test_alloc = { TestAlloc, TestFree };
+
+// Returns |input| in the .lzma format. If |write_size| is false, the header
+// leaves the size unspecified and the stream ends with an end marker instead.
+std::string LzmaEncodeString(const std::string& input, bool write_size) {
+  CLzmaEncProps props;
+  LzmaEncProps_Init(&props);
+  props.level = 5;
+  props.dictSize = 1 << 16;
+
+  std::vector<Byte> output(13 + input.size() + input.size() / 2 + 1024);
+  SizeT props_size = LZMA_PROPS_SIZE;
+  SizeT output_size = output.size() - 13;
+  SRes result = LzmaEncode(
+      &output[13], &output_size,
+      reinterpret_cast<const Byte*>(input.data()), input.size(),
+      &props, &output[0], &props_size, write_size ? 0 : 1,
+      NULL, &g_test_alloc, &g_test_alloc);
+  EXPECT_EQ(SZ_OK, result);
+  EXPECT_EQ(static_cast<SizeT>(LZMA_PROPS_SIZE), props_size);
+  uint64 size = write_size ? input.size() : kuint64max;
+  for (int i = 0; i < 8; ++i)
+    output[LZMA_PROPS_SIZE + i] = static_cast<Byte>(size >> (8 * i));
+  return std::string(reinterpret_cast<char*>(&output[0]), 13 + output_size);
+}
+
+}  // namespace
+
+class LzmaFilterTest : public testing::Test {
+ protected:
+  virtual void SetUp() {
+    for (int i = 0; i < 500; ++i) {
+      source_ += base::StringPrintf(
+          "<li><a href=\"/item/%d\">Item number %d</a></li>\n", i, i % 17);
+    }
+  }
+
+  Filter* CreateFilter() {
+    std::vector<Filter::FilterType> filter_types;
+    filter_types.push_back(Filter::FILTER_TYPE_LZMA);
+    return Filter::Factory(filter_types, filter_context_);
+  }
+
+  // Feeds |encoded| to |filter| |input_block_size| bytes at a time, reading
+  // into an |output_block_size| byte buffer, and appends the output to
+  // |output|. Returns the last status of the filter.
+  Filter::FilterStatus Decode(Filter* filter,
+                              const std::string& encoded,
+                              int input_block_size,
+                              int output_block_size,
+                              std::string* output) {
+    std::vector<char> buffer(output_block_size);
+    size_t position = 0;
+    Filter::FilterStatus status = Filter::FILTER_NEED_MORE_DATA;
+    int output_len = 0;
+    while (status != Filter::FILTER_DONE && status != Filter::FILTER_ERROR) {
+      // Like URLRequestJob, only supply more input once the filter asks for
+      // it without having filled the output buffer.
+      if (status == Filter::FILTER_NEED_MORE_DATA &&
+          output_len < output_block_size) {
+        if (position == encoded.size())
+          break;
+        int amount = std::min(
+            std::min(input_block_size, filter->stream_buffer_size()),
+            static_cast<int>(encoded.size() - position));
+        memcpy(filter->stream_buffer()->data(), encoded.data() + position,
+               amount);
+        filter->FlushStreamBuffer(amount);
+        position += amount;
+      }
+      output_len = output_block_size;
+      status = filter->ReadData(&buffer[0], &output_len);
+      output->append(&buffer[0], output_len);
+    }
+    return status;
+  }
+
+  MockFilterContext filter_context_;
+  std::string source_;
+};
+
+TEST_F(LzmaFilterTest, DecodeWithSize) {
+  std::string encoded = LzmaEncodeString(source_, true);
+  EXPECT_LT(encoded.size(), source_.size());
+
+  scoped_ptr<Filter> filter(CreateFilter());
+  ASSERT_TRUE(filter.get());
+  std::string output;
+  EXPECT_EQ(Filter::FILTER_DONE,
+            Decode(filter.get(), encoded, kDefaultBufferSize,
+                   kDefaultBufferSize, &output));
+  EXPECT_EQ(source_, output);
+}
+
+TEST_F(LzmaFilterTest, DecodeWithEndMark) {
+  std::string encoded = LzmaEncodeString(source_, false);
+
+  scoped_ptr<Filter> filter(CreateFilter());
+  ASSERT_TRUE(filter.get());
+  std::string output;
+  EXPECT_EQ(Filter::FILTER_DONE,
+            Decode(filter.get(), encoded, kDefaultBufferSize,
+                   kDefaultBufferSize, &output));
+  EXPECT_EQ(source_, output);
+}
+
+// Feeds and reads a few bytes at a time, splitting the header.
+TEST_F(LzmaFilterTest, DecodeWithSmallBuffers) {
+  const int kBlockSizes[][2] = { { 1, 1 }, { 7, kSmallBufferSize },
+                                 { kSmallBufferSize, 3 } };
+  for (int write_size = 0; write_size < 2; ++write_size) {
+    std::string encoded = LzmaEncodeString(source_, write_size != 0);
+    for (size_t i = 0; i < arraysize(kBlockSizes); ++i) {
+      scoped_ptr<Filter> filter(CreateFilter());
+      ASSERT_TRUE(filter.get());
+      std::string output;
+      EXPECT_EQ(Filter::FILTER_DONE,
+                Decode(filter.get(), encoded, kBlockSizes[i][0],
+                       kBlockSizes[i][1], &output)) << i;
+      EXPECT_EQ(source_, output) << i;
+    }
+  }
+}
+
+TEST_F(LzmaFilterTest, DecodeEmpty) {
+  for (int write_size = 0; write_size < 2; ++write_size) {
+    std::string encoded = LzmaEncodeString(std::string(), write_size != 0);
+    scoped_ptr<Filter> filter(CreateFilter());
+    ASSERT_TRUE(filter.get());
+    std::string output;
+    EXPECT_EQ(Filter::FILTER_DONE,
+              Decode(filter.get(), encoded, kDefaultBufferSize,
+                     kDefaultBufferSize, &output));
+    EXPECT_TRUE(output.empty());
+  }
+}
+
+TEST_F(LzmaFilterTest, DictionaryTooLarge) {
+  std::string encoded = LzmaEncodeString(source_, true);
+  // Ask for a 128MB dictionary.
+  encoded[1] = encoded[2] = encoded[3] = '\0';
+  encoded[4] = '\x08';
+
+  scoped_ptr<Filter> filter(CreateFilter());
+  ASSERT_TRUE(filter.get());
+  std::string output;
+  EXPECT_EQ(Filter::FILTER_ERROR,
+            Decode(filter.get(), encoded, kDefaultBufferSize,
+                   kDefaultBufferSize, &output));
+}
+
+TEST_F(LzmaFilterTest, CorruptData) {
+  std::string encoded = LzmaEncodeString(source_, true);
+  // Flip bits in the LZMA stream; the first byte of a valid stream is zero.
+  encoded[13] = '\xff';
+
+  scoped_ptr<Filter> filter(CreateFilter());
+  ASSERT_TRUE(filter.get());
+  std::string output;
+  EXPECT_EQ(Filter::FILTER_ERROR,
+            Decode(filter.get(), encoded, kDefaultBufferSize,
+                   kDefaultBufferSize, &output));
+}
+
+}  // namespace net
@@ -959,6 +959,42 @@ TEST_F(SdchFilterTest, DefaultGzipIfSdch) {
   EXPECT_EQ(output, expanded_);
 }
 
+TEST_F(SdchFilterTest, GzipHelperPassesSdchThrough) {
+  // Construct a valid SDCH dictionary from a VCDIFF dictionary.
+  const std::string kSampleDomain = "sdchtest.com";
+  std::string dictionary(NewSdchDictionary(kSampleDomain));
+
+  std::string url_string = "http://" + kSampleDomain;
+
+  GURL url(url_string);
+  EXPECT_TRUE(sdch_manager_->AddSdchDictionary(dictionary, url));
+
+  std::string sdch_compressed(NewSdchCompressedData(dictionary));
+
+  // Claim sdch content and really send it without gzip, so that the gzip
+  // filter added by FixupEncodingTypes() turns into a pass through filter,
+  // which hands its input buffer straight to the sdch filter.
+  std::vector<Filter::FilterType> filter_types;
+  filter_types.push_back(Filter::FILTER_TYPE_SDCH);
+
+  MockFilterContext filter_context;
+  filter_context.SetMimeType("anything/mime");
+  filter_context.SetSdchResponse(true);
+  Filter::FixupEncodingTypes(filter_context, &filter_types);
+  ASSERT_EQ(filter_types.size(), 2u);
+  EXPECT_EQ(filter_types[1], Filter::FILTER_TYPE_GZIP_HELPING_SDCH);
+  filter_context.SetURL(url);
+
+  const size_t kBlockSizes[][2] = { { 100, 100 }, { 7, 3 }, { 1, 1 } };
+  for (size_t i = 0; i < arraysize(kBlockSizes); ++i) {
+    scoped_ptr<Filter> filter(Filter::Factory(filter_types, filter_context));
+    std::string output;
+    EXPECT_TRUE(FilterTestData(sdch_compressed, kBlockSizes[i][0],
+                               kBlockSizes[i][1], filter.get(), &output));
+    EXPECT_EQ(output, expanded_) << i;
+  }
+}
+
 TEST_F(SdchFilterTest, AcceptGzipSdchIfGzip) {
   // Construct a valid SDCH dictionary from a VCDIFF dictionary.
   const std::string kSampleDomain = "sdchtest.com";
@@ -34,6 +34,7 @@
 #include "net/base/upload_data_stream.h"
 #include "net/disk_cache/disk_cache.h"
 #include "net/http/disk_cache_based_quic_server_info.h"
+#include "net/http/http_cache_prefetcher.h"
 #include "net/http/http_cache_transaction.h"
 #include "net/http/http_network_layer.h"
 #include "net/http/http_network_session.h"
@@ -95,7 +96,8 @@ HttpCache::ActiveEntry::ActiveEntry(disk_cache::Entry* entry)
     : disk_entry(entry),
       writer(NULL),
       will_process_pending_queue(false),
-      doomed(false) {
+      doomed(false),
+      shared_writing(false) {
 }
 
 HttpCache::ActiveEntry::~ActiveEntry() {
@@ -293,6 +295,7 @@ HttpCache::HttpCache(const net::HttpNetworkSession::Params& params,
       mode_(NORMAL),
       quic_server_info_factory_(params.enable_quic_persist_server_info ?
           new QuicServerInfoFactoryAdaptor(this) : NULL),
+      read_while_writing_(false),
       network_layer_(new HttpNetworkLayer(new HttpNetworkSession(params))) {
   HttpNetworkSession* session = network_layer_->GetSession();
   session->quic_stream_factory()->set_quic_server_info_factory(
@@ -308,7 +311,8 @@ HttpCache::HttpCache(HttpNetworkSession* session,
       backend_factory_(backend_factory),
       building_backend_(false),
       mode_(NORMAL),
-      network_layer_(new HttpNetworkLayer(session)) {
+      network_layer_(new HttpNetworkLayer(session)),
+      read_while_writing_(false) {
 }
 
 HttpCache::HttpCache(HttpTransactionFactory* network_layer,
@@ -318,7 +322,8 @@ HttpCache::HttpCache(HttpTransactionFactory* network_layer,
       backend_factory_(backend_factory),
       building_backend_(false),
       mode_(NORMAL),
-      network_layer_(network_layer) {
+      network_layer_(network_layer),
+      read_while_writing_(false) {
 }
 
 HttpCache::~HttpCache() {
@@ -331,12 +336,16 @@ HttpCache::~HttpCache() {
     entry->will_process_pending_queue = false;
     entry->pending_queue.clear();
     entry->readers.clear();
+    entry->shared_readers.clear();
     entry->writer = NULL;
     DeactivateEntry(entry);
   }
 
   STLDeleteElements(&doomed_entries_);
 
+  // The prefetched entries must be closed while the disk cache is alive.
+  prefetcher_.reset();
+
   // Before deleting pending_ops_, we have to make sure that the disk cache is
   // done with said operations, or it will attempt to use deleted data.
   disk_cache_.reset();
@@ -411,6 +420,13 @@ void HttpCache::WriteMetadata(const GURL& url,
   writer->Write(url, expected_response_time, buf, buf_len);
 }
 
+void HttpCache::set_prefetch_subresources(bool value) {
+  if (!value)
+    prefetcher_.reset();
+  else if (!prefetcher_.get())
+    prefetcher_.reset(new HttpCachePrefetcher(this));
+}
+
 void HttpCache::CloseAllConnections() {
   net::HttpNetworkLayer* network =
       static_cast<net::HttpNetworkLayer*>(network_layer_.get());
@@ -647,6 +663,7 @@ void HttpCache::FinalizeDoomedEntry(ActiveEntry* entry) {
   DCHECK(entry->doomed);
   DCHECK(!entry->writer);
   DCHECK(entry->readers.empty());
+  DCHECK(entry->shared_readers.empty());
   DCHECK(entry->pending_queue.empty());
 
   ActiveEntriesSet::iterator it = doomed_entries_.find(entry);
@@ -675,6 +692,7 @@ void HttpCache::DeactivateEntry(ActiveEntry* entry) {
   DCHECK(!entry->writer);
   DCHECK(entry->disk_entry);
   DCHECK(entry->readers.empty());
+  DCHECK(entry->shared_readers.empty());
   DCHECK(entry->pending_queue.empty());
 
   std::string key = entry->disk_entry->GetKey();
@@ -815,6 +833,15 @@ int HttpCache::AddTransactionToEntry(ActiveEntry* entry, Transaction* trans) {
   //
   // NOTE: If the transaction can only write, then the entry should not be in
   // use (since any existing entry should have already been doomed).
+  //
+  // While the writer is writing the body of the response, transactions that
+  // would just read it don't have to wait for the writer to finish: they can
+  // follow it as it writes. See StartSharedWriting().
+
+  if (entry->writer && entry->shared_writing && trans->CanReadWhileWriting()) {
+    AddSharedReader(entry, trans);
+    return OK;
+  }
 
   if (entry->writer || entry->will_process_pending_queue) {
     entry->pending_queue.push_back(trans);
@@ -845,6 +872,13 @@ int HttpCache::AddTransactionToEntry(ActiveEntry* entry, Transaction* trans) {
 
 void HttpCache::DoneWithEntry(ActiveEntry* entry, Transaction* trans,
                               bool cancel) {
+  TransactionList::iterator it = std::find(entry->shared_readers.begin(),
+                                           entry->shared_readers.end(), trans);
+  if (it != entry->shared_readers.end()) {
+    entry->shared_readers.erase(it);
+    return;
+  }
+
   // If we already posted a task to move on to the next transaction and this was
   // the writer, there is nothing to cancel.
   if (entry->will_process_pending_queue && entry->readers.empty())
@@ -853,6 +887,10 @@ void HttpCache::DoneWithEntry(ActiveEntry* entry, Transaction* trans,
   if (entry->writer) {
     DCHECK(trans == entry->writer);
 
+    // The readers following the writer can't get the rest of the body.
+    if (entry->shared_writing)
+      FinishSharedWriting(entry, false);
+
     // Assume there was a failure.
     bool success = false;
     if (cancel) {
@@ -875,6 +913,12 @@ void HttpCache::DoneWritingToEntry(ActiveEntry* entry, bool success) {
 
   entry->writer = NULL;
 
+  // The readers that followed the writer keep reading the entry as regular
+  // readers.
+  if (entry->shared_writing)
+    FinishSharedWriting(entry, success);
+  entry->readers.splice(entry->readers.end(), entry->shared_readers);
+
   if (success) {
     ProcessPendingQueue(entry);
   } else {
@@ -884,8 +928,14 @@ void HttpCache::DoneWritingToEntry(ActiveEntry* entry, bool success) {
     TransactionList pending_queue;
     pending_queue.swap(entry->pending_queue);
 
-    entry->disk_entry->Doom();
-    DestroyEntry(entry);
+    if (entry->readers.empty()) {
+      entry->disk_entry->Doom();
+      DestroyEntry(entry);
+    } else if (!entry->doomed) {
+      // The readers are still using the entry, so it goes away once they are
+      // done with it.
+      DoomActiveEntry(entry->disk_entry->GetKey());
+    }
 
     // We need to do something about these pending entries, which now need to
     // be added to a new entry.
@@ -922,6 +972,44 @@ void HttpCache::ConvertWriterToReader(ActiveEntry* entry) {
   ProcessPendingQueue(entry);
 }
 
+void HttpCache::StartSharedWriting(ActiveEntry* entry) {
+  DCHECK(entry->writer);
+  if (!read_while_writing_ || entry->shared_writing || entry->doomed)
+    return;
+
+  entry->shared_writing = true;
+  base::MessageLoop::current()->PostTask(
+      FROM_HERE,
+      base::Bind(&HttpCache::OnSharedWritingStarted, AsWeakPtr(),
+                 entry->disk_entry->GetKey()));
+}
+
+void HttpCache::FinishSharedWriting(ActiveEntry* entry, bool body_complete) {
+  DCHECK(entry->shared_writing);
+  entry->shared_writing = false;
+
+  for (TransactionList::iterator it = entry->shared_readers.begin();
+       it != entry->shared_readers.end(); ++it) {
+    (*it)->OnSharedWriterDone(body_complete);
+  }
+}
+
+void HttpCache::OnSharedEntryDataWritten(ActiveEntry* entry) {
+  if (!entry->shared_writing)
+    return;
+
+  for (TransactionList::iterator it = entry->shared_readers.begin();
+       it != entry->shared_readers.end(); ++it) {
+    (*it)->OnSharedWriterProgress();
+  }
+}
+
+void HttpCache::AddSharedReader(ActiveEntry* entry, Transaction* trans) {
+  DCHECK(entry->shared_writing);
+  entry->shared_readers.push_back(trans);
+  trans->OnSharedReadingStarted();
+}
+
 LoadState HttpCache::GetLoadStateForPendingTransaction(
       const Transaction* trans) {
   ActiveEntriesMap::const_iterator i = active_entries_.find(trans->key());
@@ -1037,6 +1125,32 @@ void HttpCache::OnProcessPendingQueue(ActiveEntry* entry) {
   }
 }
 
+void HttpCache::OnSharedWritingStarted(const std::string& key) {
+  // The writer may be gone by now.
+  ActiveEntry* entry = FindActiveEntry(key);
+  if (!entry || !entry->writer || !entry->shared_writing)
+    return;
+
+  // The waiting transactions are let in one at a time, as each of them may
+  // destroy others while running its callback.
+  TransactionList::iterator it = entry->pending_queue.begin();
+  for (; it != entry->pending_queue.end(); ++it) {
+    if ((*it)->CanReadWhileWriting())
+      break;
+  }
+  if (it == entry->pending_queue.end())
+    return;
+
+  Transaction* next = *it;
+  entry->pending_queue.erase(it);
+  AddSharedReader(entry, next);
+
+  base::MessageLoop::current()->PostTask(
+      FROM_HERE,
+      base::Bind(&HttpCache::OnSharedWritingStarted, AsWeakPtr(), key));
+  next->io_callback().Run(OK);
+}
+
 void HttpCache::OnIOComplete(int result, PendingOp* pending_op) {
   WorkItemOperation op = pending_op->writer->operation();
 
@@ -46,6 +46,7 @@ namespace net {
 class CertVerifier;
 class HostResolver;
 class HttpAuthHandlerFactory;
+class HttpCachePrefetcher;
 class HttpNetworkSession;
 class HttpResponseInfo;
 class HttpServerProperties;
@@ -174,6 +175,17 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
   void set_mode(Mode value) { mode_ = value; }
   Mode mode() { return mode_; }
 
+  // Enables or disables recording the subresources of each navigation, and
+  // opening their entries ahead of time on later navigations to the same
+  // origin. See HttpCachePrefetcher.
+  void set_prefetch_subresources(bool value);
+  bool prefetch_subresources() const { return prefetcher_.get() != NULL; }
+
+  // Enables or disables letting transactions read an entry while another one
+  // is still writing its body, instead of waiting for the writer to finish.
+  void set_read_while_writing(bool value) { read_while_writing_ = value; }
+  bool read_while_writing() const { return read_while_writing_; }
+
   // Close currently active sockets so that fresh page loads will not use any
   // recycled connections.  For sockets currently in use, they may not close
   // immediately, but they will not be reusable. This is for debugging.
@@ -221,6 +233,7 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
   class Transaction;
   class WorkItem;
   friend class Transaction;
+  friend class HttpCachePrefetcher;
   friend class ViewCacheHelper;
   struct PendingOp;  // Info for an entry under construction.
 
@@ -237,6 +250,11 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
     TransactionList    pending_queue;
     bool               will_process_pending_queue;
     bool               doomed;
+
+    // True while |writer| is filling the body of the entry and the
+    // |shared_readers| can read it at the same time.
+    bool               shared_writing;
+    TransactionList    shared_readers;
   };
 
   typedef base::hash_map<std::string, ActiveEntry*> ActiveEntriesMap;
@@ -339,6 +357,20 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
   // transactions can start reading from this entry.
   void ConvertWriterToReader(ActiveEntry* entry);
 
+  // Called when the writer of |entry| starts writing the body of the response,
+  // so that readers can join it if read_while_writing() is enabled.
+  void StartSharedWriting(ActiveEntry* entry);
+
+  // Called when the writer of |entry| leaves it. |body_complete| is true if
+  // the whole body was written.
+  void FinishSharedWriting(ActiveEntry* entry, bool body_complete);
+
+  // Called when the writer of |entry| appends data to the body.
+  void OnSharedEntryDataWritten(ActiveEntry* entry);
+
+  // Lets |trans| read |entry| while it is written.
+  void AddSharedReader(ActiveEntry* entry, Transaction* trans);
+
   // Returns the LoadState of the provided pending transaction.
   LoadState GetLoadStateForPendingTransaction(const Transaction* trans);
 
@@ -361,6 +393,10 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
 
   void OnProcessPendingQueue(ActiveEntry* entry);
 
+  // Lets the first transaction waiting for the writer of the entry for |key|
+  // that can read while it writes in.
+  void OnSharedWritingStarted(const std::string& key);
+
   // Callbacks ----------------------------------------------------------------
 
   // Processes BackendCallback notifications.
@@ -406,6 +442,10 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
 
   scoped_ptr<PlaybackCacheMap> playback_cache_map_;
 
+  scoped_ptr<HttpCachePrefetcher> prefetcher_;
+
+  bool read_while_writing_;
+
   DISALLOW_COPY_AND_ASSIGN(HttpCache);
 };
 
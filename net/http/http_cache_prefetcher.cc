@@ -0,0 +1,296 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/http/http_cache_prefetcher.h"
+
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/pickle.h"
+#include "net/base/io_buffer.h"
+#include "net/base/load_flags.h"
+#include "net/base/net_errors.h"
+#include "net/disk_cache/disk_cache.h"
+#include "net/http/http_cache.h"
+#include "net/http/http_request_info.h"
+
+namespace {
+
+const int kManifestVersion = 1;
+
+// Manifests larger than this are ignored.
+const int kMaxManifestSize = 64 * 1024;
+
+// How much of the body of each entry is read ahead of time.
+const int kMaxPrefetchedBodySize = 64 * 1024;
+
+// The prefetching reads only bring the data closer to memory; their results
+// are not needed.
+void IgnoreResult(int result) {}
+
+bool SameKeys(std::vector<std::string> a, std::vector<std::string> b) {
+  std::sort(a.begin(), a.end());
+  std::sort(b.begin(), b.end());
+  return a == b;
+}
+
+}  // namespace
+
+namespace net {
+
+// The disk cache writes the entry it opens or creates to a location that has
+// to outlive the HttpCachePrefetcher, so it is owned by the callback of the
+// operation. See DiskCacheBasedQuicServerInfo::CacheOperationDataShim.
+struct HttpCachePrefetcher::EntryShim {
+  EntryShim() : entry(NULL) {}
+
+  disk_cache::Entry* entry;
+};
+
+HttpCachePrefetcher::HttpCachePrefetcher(HttpCache* cache)
+    : cache_(cache),
+      weak_factory_(this) {
+  DCHECK(cache_);
+}
+
+HttpCachePrefetcher::~HttpCachePrefetcher() {
+  ReleasePrefetchedEntries();
+}
+
+// static
+std::string HttpCachePrefetcher::GetManifestKey(const GURL& origin) {
+  return "subresources:" + origin.spec();
+}
+
+void HttpCachePrefetcher::OnTransactionStarted(const HttpRequestInfo& request,
+                                               const std::string& key) {
+  if (request.method != "GET")
+    return;
+
+  if (request.load_flags & LOAD_MAIN_FRAME) {
+    FinishRecording();
+    ReleasePrefetchedEntries();
+
+    GURL origin = request.url.GetOrigin();
+    if (!origin.SchemeIsHTTPOrHTTPS())
+      return;
+    recording_origin_ = origin;
+    recording_key_ = key;
+    recording_start_ = base::TimeTicks::Now();
+    ReadManifest(origin);
+    return;
+  }
+
+  if (!recording_origin_.is_valid())
+    return;
+
+  if (base::TimeTicks::Now() - recording_start_ >
+      base::TimeDelta::FromSeconds(kRecordingWindowSeconds)) {
+    FinishRecording();
+    return;
+  }
+
+  if (key == recording_key_ || recorded_keys_.size() >= kMaxManifestEntries ||
+      std::find(recorded_keys_.begin(), recorded_keys_.end(), key) !=
+          recorded_keys_.end()) {
+    return;
+  }
+  recorded_keys_.push_back(key);
+}
+
+void HttpCachePrefetcher::FinishRecording() {
+  if (recording_origin_.is_valid() && !recorded_keys_.empty() &&
+      !SameKeys(recorded_keys_, manifest_keys_)) {
+    WriteManifest(recording_origin_, recorded_keys_);
+  }
+  recording_origin_ = GURL();
+  recording_key_.clear();
+  recorded_keys_.clear();
+  manifest_keys_.clear();
+}
+
+void HttpCachePrefetcher::ReleasePrefetchedEntries() {
+  release_timer_.Stop();
+  for (size_t i = 0; i < prefetched_entries_.size(); ++i)
+    prefetched_entries_[i]->Close();
+  prefetched_entries_.clear();
+}
+
+void HttpCachePrefetcher::ReadManifest(const GURL& origin) {
+  disk_cache::Backend* backend = cache_->GetCurrentBackend();
+  if (!backend)
+    return;
+
+  EntryShim* shim = new EntryShim;
+  CompletionCallback callback =
+      base::Bind(&HttpCachePrefetcher::OnManifestEntryOpened,
+                 weak_factory_.GetWeakPtr(), origin,
+                 base::Owned(shim));  // Ownership assigned.
+  int rv = backend->OpenEntry(GetManifestKey(origin), &shim->entry, callback);
+  if (rv != ERR_IO_PENDING)
+    callback.Run(rv);
+}
+
+void HttpCachePrefetcher::OnManifestEntryOpened(const GURL& origin,
+                                                EntryShim* shim,
+                                                int result) {
+  if (result != OK)
+    return;
+
+  disk_cache::Entry* entry = shim->entry;
+  int size = entry->GetDataSize(HttpCache::kResponseInfoIndex);
+  if (origin != recording_origin_ || size <= 0 || size > kMaxManifestSize) {
+    entry->Close();
+    return;
+  }
+
+  // The read completes even if the entry is closed first.
+  scoped_refptr<IOBuffer> buf(new IOBuffer(size));
+  CompletionCallback callback =
+      base::Bind(&HttpCachePrefetcher::OnManifestRead,
+                 weak_factory_.GetWeakPtr(), origin, buf);
+  int rv = entry->ReadData(HttpCache::kResponseInfoIndex, 0, buf.get(), size,
+                           callback);
+  entry->Close();
+  if (rv != ERR_IO_PENDING)
+    callback.Run(rv);
+}
+
+void HttpCachePrefetcher::OnManifestRead(const GURL& origin,
+                                         scoped_refptr<IOBuffer> buf,
+                                         int result) {
+  if (origin != recording_origin_ || result <= 0)
+    return;
+
+  Pickle pickle(buf->data(), result);
+  PickleIterator iter(pickle);
+  int version;
+  int count;
+  if (!pickle.ReadInt(&iter, &version) || version != kManifestVersion ||
+      !pickle.ReadInt(&iter, &count) || count < 0 ||
+      count > static_cast<int>(kMaxManifestEntries)) {
+    return;
+  }
+
+  std::vector<std::string> keys;
+  for (int i = 0; i < count; ++i) {
+    std::string key;
+    if (!pickle.ReadString(&iter, &key))
+      return;
+    keys.push_back(key);
+  }
+  manifest_keys_.swap(keys);
+
+  for (size_t i = 0; i < manifest_keys_.size(); ++i) {
+    // Entries in use by a transaction already are not worth prefetching.
+    if (!cache_->FindActiveEntry(manifest_keys_[i]))
+      PrefetchEntry(manifest_keys_[i]);
+  }
+  release_timer_.Start(
+      FROM_HERE,
+      base::TimeDelta::FromSeconds(kPrefetchedEntryLifetimeSeconds),
+      this, &HttpCachePrefetcher::ReleasePrefetchedEntries);
+}
+
+void HttpCachePrefetcher::PrefetchEntry(const std::string& key) {
+  disk_cache::Backend* backend = cache_->GetCurrentBackend();
+  if (!backend)
+    return;
+
+  EntryShim* shim = new EntryShim;
+  CompletionCallback callback =
+      base::Bind(&HttpCachePrefetcher::OnPrefetchedEntryOpened,
+                 weak_factory_.GetWeakPtr(),
+                 base::Owned(shim));  // Ownership assigned.
+  int rv = backend->OpenEntry(key, &shim->entry, callback);
+  if (rv != ERR_IO_PENDING)
+    callback.Run(rv);
+}
+
+void HttpCachePrefetcher::OnPrefetchedEntryOpened(EntryShim* shim,
+                                                  int result) {
+  if (result != OK)
+    return;
+
+  // The entry is kept open, so that the transaction asking for it gets it
+  // without waiting for the disk, until it is released.
+  disk_cache::Entry* entry = shim->entry;
+  prefetched_entries_.push_back(entry);
+
+  int size = entry->GetDataSize(HttpCache::kResponseInfoIndex);
+  if (size > 0) {
+    scoped_refptr<IOBuffer> buf(new IOBuffer(size));
+    entry->ReadData(HttpCache::kResponseInfoIndex, 0, buf.get(), size,
+                    base::Bind(&IgnoreResult));
+  }
+  size = std::min(entry->GetDataSize(HttpCache::kResponseContentIndex),
+                  kMaxPrefetchedBodySize);
+  if (size > 0) {
+    scoped_refptr<IOBuffer> buf(new IOBuffer(size));
+    entry->ReadData(HttpCache::kResponseContentIndex, 0, buf.get(), size,
+                    base::Bind(&IgnoreResult));
+  }
+}
+
+void HttpCachePrefetcher::WriteManifest(const GURL& origin,
+                                        const std::vector<std::string>& keys) {
+  disk_cache::Backend* backend = cache_->GetCurrentBackend();
+  if (!backend)
+    return;
+
+  Pickle pickle;
+  pickle.WriteInt(kManifestVersion);
+  pickle.WriteInt(static_cast<int>(keys.size()));
+  for (size_t i = 0; i < keys.size(); ++i)
+    pickle.WriteString(keys[i]);
+  if (static_cast<int>(pickle.size()) > kMaxManifestSize)
+    return;
+
+  scoped_refptr<IOBuffer> buf(new IOBuffer(pickle.size()));
+  memcpy(buf->data(), pickle.data(), pickle.size());
+
+  std::string manifest_key = GetManifestKey(origin);
+  EntryShim* shim = new EntryShim;
+  CompletionCallback callback =
+      base::Bind(&HttpCachePrefetcher::OnManifestEntryReadyForWrite,
+                 weak_factory_.GetWeakPtr(), manifest_key, buf,
+                 static_cast<int>(pickle.size()), true,
+                 base::Owned(shim));  // Ownership assigned.
+  int rv = backend->CreateEntry(manifest_key, &shim->entry, callback);
+  if (rv != ERR_IO_PENDING)
+    callback.Run(rv);
+}
+
+void HttpCachePrefetcher::OnManifestEntryReadyForWrite(
+    const std::string& manifest_key,
+    scoped_refptr<IOBuffer> buf,
+    int buf_len,
+    bool created,
+    EntryShim* shim,
+    int result) {
+  if (result != OK) {
+    disk_cache::Backend* backend = cache_->GetCurrentBackend();
+    if (!created || !backend)
+      return;
+
+    // The manifest exists already, so replace its contents.
+    EntryShim* open_shim = new EntryShim;
+    CompletionCallback callback =
+        base::Bind(&HttpCachePrefetcher::OnManifestEntryReadyForWrite,
+                   weak_factory_.GetWeakPtr(), manifest_key, buf, buf_len,
+                   false, base::Owned(open_shim));  // Ownership assigned.
+    int rv = backend->OpenEntry(manifest_key, &open_shim->entry, callback);
+    if (rv != ERR_IO_PENDING)
+      callback.Run(rv);
+    return;
+  }
+
+  // The write completes even if the entry is closed first.
+  shim->entry->WriteData(HttpCache::kResponseInfoIndex, 0, buf.get(), buf_len,
+                         base::Bind(&IgnoreResult), true);
+  shim->entry->Close();
+}
+
+}  // namespace net
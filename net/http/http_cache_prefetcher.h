@@ -0,0 +1,113 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_HTTP_HTTP_CACHE_PREFETCHER_H_
+#define NET_HTTP_HTTP_CACHE_PREFETCHER_H_
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "net/base/net_export.h"
+#include "url/gurl.h"
+
+namespace disk_cache {
+class Entry;
+}
+
+namespace net {
+
+class HttpCache;
+class IOBuffer;
+struct HttpRequestInfo;
+
+// HttpCachePrefetcher records the cache entries used by the subresources of a
+// navigation, and stores their keys on a "subresource manifest" entry of the
+// cache, one per origin. When the origin is navigated to again, the entries
+// listed on its manifest are opened and read ahead of time, all in parallel,
+// so that the disk work is mostly done by the time the renderer asks for each
+// subresource, and the transactions for them find their entries already open.
+//
+// The subresources of a navigation are taken to be the requests that follow
+// it, until the next navigation or for up to kRecordingWindowSeconds.
+class NET_EXPORT_PRIVATE HttpCachePrefetcher {
+ public:
+  // The maximum number of entries listed on a manifest.
+  static const size_t kMaxManifestEntries = 64;
+
+  // For how long the requests following a navigation are recorded.
+  static const int kRecordingWindowSeconds = 10;
+
+  // For how long the prefetched entries are kept open.
+  static const int kPrefetchedEntryLifetimeSeconds = 30;
+
+  explicit HttpCachePrefetcher(HttpCache* cache);
+  ~HttpCachePrefetcher();
+
+  // Returns the key of the cache entry storing the manifest of |origin|.
+  static std::string GetManifestKey(const GURL& origin);
+
+  // Called when a transaction for |request| starts reading from the entry
+  // with the given |key|.
+  void OnTransactionStarted(const HttpRequestInfo& request,
+                            const std::string& key);
+
+  // Returns the number of prefetched entries currently kept open.
+  size_t prefetched_entry_count() const { return prefetched_entries_.size(); }
+
+ private:
+  struct EntryShim;
+
+  // Stores the entries recorded for the current navigation, if they changed,
+  // and stops recording.
+  void FinishRecording();
+
+  // Closes the entries opened ahead of time.
+  void ReleasePrefetchedEntries();
+
+  // Reads the manifest of |origin| and prefetches the entries it lists.
+  void ReadManifest(const GURL& origin);
+  void OnManifestEntryOpened(const GURL& origin, EntryShim* shim, int result);
+  void OnManifestRead(const GURL& origin, scoped_refptr<IOBuffer> buf,
+                      int result);
+
+  // Opens and reads the entry with |key| ahead of time.
+  void PrefetchEntry(const std::string& key);
+  void OnPrefetchedEntryOpened(EntryShim* shim, int result);
+
+  // Replaces the manifest of |origin| with |keys|.
+  void WriteManifest(const GURL& origin, const std::vector<std::string>& keys);
+  void OnManifestEntryReadyForWrite(const std::string& manifest_key,
+                                    scoped_refptr<IOBuffer> buf,
+                                    int buf_len,
+                                    bool created,
+                                    EntryShim* shim,
+                                    int result);
+
+  HttpCache* const cache_;
+
+  // The navigation being recorded.
+  GURL recording_origin_;
+  std::string recording_key_;
+  base::TimeTicks recording_start_;
+  std::vector<std::string> recorded_keys_;
+
+  // The keys read from the manifest of |recording_origin_|.
+  std::vector<std::string> manifest_keys_;
+
+  std::vector<disk_cache::Entry*> prefetched_entries_;
+  base::OneShotTimer<HttpCachePrefetcher> release_timer_;
+
+  base::WeakPtrFactory<HttpCachePrefetcher> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(HttpCachePrefetcher);
+};
+
+}  // namespace net
+
+#endif  // NET_HTTP_HTTP_CACHE_PREFETCHER_H_
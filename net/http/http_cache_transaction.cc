@@ -16,6 +16,7 @@
 #include "base/bind.h"
 #include "base/compiler_specific.h"
 #include "base/memory/ref_counted.h"
+#include "base/message_loop/message_loop.h"
 #include "base/metrics/field_trial.h"
 #include "base/metrics/histogram.h"
 #include "base/metrics/sparse_histogram.h"
@@ -23,6 +24,7 @@
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/time/time.h"
+#include "base/values.h"
 #include "net/base/completion_callback.h"
 #include "net/base/io_buffer.h"
 #include "net/base/load_flags.h"
@@ -32,6 +34,7 @@
 #include "net/base/upload_data_stream.h"
 #include "net/cert/cert_status_flags.h"
 #include "net/disk_cache/disk_cache.h"
+#include "net/http/http_cache_prefetcher.h"
 #include "net/http/http_network_session.h"
 #include "net/http/http_request_info.h"
 #include "net/http/http_response_headers.h"
@@ -117,6 +120,14 @@ void RecordVaryHeaderHistogram(const net::HttpResponseInfo* response) {
   UMA_HISTOGRAM_ENUMERATION("HttpCache.Vary", vary, VARY_MAX);
 }
 
+base::Value* NetLogReadWhileWritingCallback(
+    bool body_complete,
+    net::NetLog::LogLevel /* log_level */) {
+  base::DictionaryValue* dict = new base::DictionaryValue();
+  dict->SetBoolean("body_complete", body_complete);
+  return dict;
+}
+
 }  // namespace
 
 namespace net {
@@ -203,6 +214,11 @@ HttpCache::Transaction::Transaction(
       done_reading_(false),
       vary_mismatch_(false),
       couldnt_conditionalize_request_(false),
+      shared_reader_(false),
+      sharing_refused_(false),
+      waiting_for_shared_writer_(false),
+      shared_writer_done_(false),
+      shared_body_incomplete_(false),
       io_buf_len_(0),
       read_offset_(0),
       effective_load_flags_(0),
@@ -278,6 +294,47 @@ bool HttpCache::Transaction::AddTruncatedFlag() {
   return true;
 }
 
+bool HttpCache::Transaction::CanReadWhileWriting() const {
+  if (sharing_refused_ || partial_.get() || !request_ ||
+      request_->method != "GET") {
+    return false;
+  }
+  if (effective_load_flags_ & LOAD_VALIDATE_CACHE)
+    return false;
+  return mode_ == READ || mode_ == READ_WRITE;
+}
+
+void HttpCache::Transaction::OnSharedReadingStarted() {
+  DCHECK(!shared_reader_);
+  shared_reader_ = true;
+  shared_reading_since_ = TimeTicks::Now();
+  net_log_.BeginEvent(NetLog::TYPE_HTTP_CACHE_READ_WHILE_WRITING);
+}
+
+void HttpCache::Transaction::OnSharedWriterProgress() {
+  if (!waiting_for_shared_writer_)
+    return;
+
+  // The writer is in the middle of its own IO, so resume reading later.
+  waiting_for_shared_writer_ = false;
+  base::MessageLoop::current()->PostTask(
+      FROM_HERE,
+      base::Bind(&Transaction::OnIOComplete, weak_factory_.GetWeakPtr(), OK));
+}
+
+void HttpCache::Transaction::OnSharedWriterDone(bool body_complete) {
+  DCHECK(shared_reader_);
+  shared_writer_done_ = true;
+  shared_body_incomplete_ = !body_complete;
+  net_log_.EndEvent(NetLog::TYPE_HTTP_CACHE_READ_WHILE_WRITING,
+                    base::Bind(&NetLogReadWhileWritingCallback,
+                               body_complete));
+  // This is how long the transaction would have waited for the writer.
+  UMA_HISTOGRAM_TIMES("HttpCache.ReadWhileWritingTimeSaved",
+                      TimeTicks::Now() - shared_reading_since_);
+  OnSharedWriterProgress();
+}
+
 LoadState HttpCache::Transaction::GetWriterLoadState() const {
   if (network_trans_.get())
     return network_trans_->GetLoadState();
@@ -406,6 +463,10 @@ int HttpCache::Transaction::Read(IOBuffer* buf, int buf_len,
     mode_ = NONE;
   }
 
+  // Other transactions can read the body as we write it.
+  if (mode_ == WRITE && entry_ && !partial_.get())
+    cache_->StartSharedWriting(entry_);
+
   reading_ = true;
   int rv;
 
@@ -856,6 +917,9 @@ int HttpCache::Transaction::DoGetBackendComplete(int result) {
   if (!(mode_ & READ) && effective_load_flags_ & LOAD_ONLY_FROM_CACHE)
     return ERR_CACHE_MISS;
 
+  if (cache_->prefetcher_.get() && (mode_ & READ))
+    cache_->prefetcher_->OnTransactionStarted(*request_, cache_key_);
+
   if (mode_ == NONE) {
     if (partial_.get()) {
       partial_->RestoreHeaders(&custom_request_->extra_headers);
@@ -1457,6 +1521,25 @@ int HttpCache::Transaction::DoCacheReadResponseComplete(int result) {
   if (response_.headers->GetContentLength() == current_size)
     truncated_ = false;
 
+  if (shared_reader_ && mode_ == READ_WRITE) {
+    // The writer is still writing this response, so it can only be used
+    // without validation.
+    if (response_.headers->response_code() != 200 || truncated_ ||
+        RequiresValidation()) {
+      if (!shared_writer_done_)
+        net_log_.EndEvent(NetLog::TYPE_HTTP_CACHE_READ_WHILE_WRITING);
+      cache_->DoneWithEntry(entry_, this, false);
+      entry_ = NULL;
+      shared_reader_ = false;
+      sharing_refused_ = true;
+      vary_mismatch_ = false;
+      next_state_ = STATE_INIT_ENTRY;
+      return OK;
+    }
+    mode_ = READ;
+    RecordOfflineStatus(effective_load_flags_, OFFLINE_STATUS_FRESH_CACHE);
+  }
+
   // We now have access to the cache entry.
   //
   //  o if we are a reader for the transaction, then we can start reading the
@@ -1598,6 +1681,15 @@ int HttpCache::Transaction::DoCacheReadDataComplete(int result) {
 
   if (result > 0) {
     read_offset_ += result;
+  } else if (result == 0 && shared_reader_ && !shared_writer_done_) {
+    // Wait for the writer to append more data.
+    waiting_for_shared_writer_ = true;
+    next_state_ = STATE_CACHE_READ_DATA;
+    return ERR_IO_PENDING;
+  } else if (result == 0 && shared_reader_ && shared_body_incomplete_) {
+    cache_->DoneWithEntry(entry_, this, false);
+    entry_ = NULL;
+    return ERR_CACHE_READ_FAILURE;
   } else if (result == 0) {  // End of file.
     RecordHistograms();
     cache_->DoneReadingFromEntry(entry_, this);
@@ -1642,6 +1734,8 @@ int HttpCache::Transaction::DoCacheWriteDataComplete(int result) {
     int64 body_size = response_.headers->GetContentLength();
     if (body_size >= 0 && body_size <= current_size)
       done_reading_ = true;
+    if (result > 0)
+      cache_->OnSharedEntryDataWritten(entry_);
   }
 
   if (partial_.get()) {
@@ -101,6 +101,23 @@ class HttpCache::Transaction : public HttpTransaction {
 
   const CompletionCallback& io_callback() { return io_callback_; }
 
+  // Returns true if this transaction can read the entry while another
+  // transaction is still writing its body. That is only the case for simple
+  // reads of the whole resource, that will use the stored response if it
+  // doesn't need validation.
+  bool CanReadWhileWriting() const;
+
+  // Called when this transaction is let in to read the entry while the writer
+  // is still writing the body.
+  void OnSharedReadingStarted();
+
+  // Called when the writer appended data to the body of the entry.
+  void OnSharedWriterProgress();
+
+  // Called when the writer leaves the entry. |body_complete| is true if the
+  // whole body was written.
+  void OnSharedWriterDone(bool body_complete);
+
   const BoundNetLog& net_log() const;
 
   // HttpTransaction methods:
@@ -412,6 +429,11 @@ class HttpCache::Transaction : public HttpTransaction {
   bool done_reading_;  // All available data was read.
   bool vary_mismatch_;  // The request doesn't match the stored vary data.
   bool couldnt_conditionalize_request_;
+  bool shared_reader_;  // We read the entry while the writer writes it.
+  bool sharing_refused_;  // We must wait for the writer to finish.
+  bool waiting_for_shared_writer_;  // We read all the data written so far.
+  bool shared_writer_done_;  // The writer left the entry.
+  bool shared_body_incomplete_;  // The writer didn't write the whole body.
   scoped_refptr<IOBuffer> read_buf_;
   int io_buf_len_;
   int read_offset_;
@@ -427,6 +449,7 @@ class HttpCache::Transaction : public HttpTransaction {
   base::TimeTicks entry_lock_waiting_since_;
   base::TimeTicks first_cache_access_since_;
   base::TimeTicks send_request_since_;
+  base::TimeTicks shared_reading_since_;
 
   int64 total_received_bytes_;
 
@@ -24,6 +24,7 @@
 #include "net/cert/cert_status_flags.h"
 #include "net/disk_cache/disk_cache.h"
 #include "net/http/http_byte_range.h"
+#include "net/http/http_cache_prefetcher.h"
 #include "net/http/http_request_headers.h"
 #include "net/http/http_request_info.h"
 #include "net/http/http_response_headers.h"
@@ -6416,3 +6417,169 @@ TEST(HttpCache, ReceivedBytesRange) {
 
   RemoveMockTransaction(&kRangeGET_TransactionOK);
 }
+
+// Tests that the entries used by the subresources of a navigation are opened
+// ahead of time when the same origin is navigated to again.
+TEST(HttpCache, PrefetchSubresources) {
+  MockHttpCache cache;
+  cache.http_cache()->set_prefetch_subresources(true);
+
+  ScopedMockTransaction main_frame(kSimpleGET_Transaction);
+  main_frame.load_flags |= net::LOAD_MAIN_FRAME;
+  MockTransaction subresource_transaction(kSimpleGET_Transaction);
+  subresource_transaction.url = "http://www.google.com/logo.png";
+  ScopedMockTransaction subresource(subresource_transaction);
+  MockTransaction manifest_transaction(kSimpleGET_Transaction);
+  std::string manifest_key =
+      net::HttpCachePrefetcher::GetManifestKey(GURL(main_frame.url));
+  manifest_transaction.url = manifest_key.c_str();
+  ScopedMockTransaction manifest(manifest_transaction);
+
+  // The first navigation records the subresource, and the next one stores it
+  // on the manifest of the origin.
+  RunTransactionTest(cache.http_cache(), main_frame);
+  RunTransactionTest(cache.http_cache(), subresource);
+  RunTransactionTest(cache.http_cache(), main_frame);
+  base::MessageLoop::current()->RunUntilIdle();
+
+  disk_cache::Entry* entry;
+  ASSERT_TRUE(cache.OpenBackendEntry(manifest_key, &entry));
+  EXPECT_LT(0, entry->GetDataSize(0));
+  entry->Close();
+
+  // Another navigation opens the main entry, the manifest and the
+  // subresource entry.
+  int open_count = cache.disk_cache()->open_count();
+  RunTransactionTest(cache.http_cache(), main_frame);
+  base::MessageLoop::current()->RunUntilIdle();
+  EXPECT_EQ(open_count + 3, cache.disk_cache()->open_count());
+
+  // The subresource is served from the cache.
+  RunTransactionTest(cache.http_cache(), subresource);
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+}
+
+// Tests that transactions waiting for the writer of an entry read the body
+// while the writer is still writing it.
+TEST(HttpCache, ReadWhileWriting) {
+  MockHttpCache cache;
+  cache.http_cache()->set_read_while_writing(true);
+
+  MockHttpRequest request(kSimpleGET_Transaction);
+  Context writer;
+  ASSERT_EQ(net::OK, cache.CreateTransaction(&writer.trans));
+  writer.result = writer.trans->Start(
+      &request, writer.callback.callback(), net::BoundNetLog());
+  EXPECT_EQ(net::OK, writer.callback.GetResult(writer.result));
+
+  std::vector<Context*> context_list;
+  const int kNumTransactions = 3;
+  for (int i = 0; i < kNumTransactions; ++i) {
+    context_list.push_back(new Context());
+    Context* c = context_list[i];
+    ASSERT_EQ(net::OK, cache.CreateTransaction(&c->trans));
+    c->result = c->trans->Start(
+        &request, c->callback.callback(), net::BoundNetLog());
+    EXPECT_EQ(net::ERR_IO_PENDING, c->result);
+  }
+
+  // Nothing happens until the writer starts reading the body.
+  base::MessageLoop::current()->RunUntilIdle();
+  for (int i = 0; i < kNumTransactions; ++i)
+    EXPECT_FALSE(context_list[i]->callback.have_result());
+
+  std::string expected(kSimpleGET_Transaction.data);
+  const int kFirstPartSize = 10;
+  scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(kFirstPartSize));
+  int rv = writer.trans->Read(buf.get(), kFirstPartSize,
+                              writer.callback.callback());
+  EXPECT_EQ(kFirstPartSize, writer.callback.GetResult(rv));
+  std::string writer_content(buf->data(), kFirstPartSize);
+
+  // The other transactions join the writer and read what it wrote so far, and
+  // then wait for more.
+  std::vector<std::string> contents(kNumTransactions);
+  std::vector<scoped_refptr<net::IOBuffer> > buffers;
+  for (int i = 0; i < kNumTransactions; ++i) {
+    Context* c = context_list[i];
+    EXPECT_EQ(net::OK, c->callback.WaitForResult());
+    EXPECT_EQ(1, cache.network_layer()->transaction_count());
+
+    buffers.push_back(new net::IOBuffer(256));
+    rv = c->trans->Read(buffers[i].get(), 256, c->callback.callback());
+    rv = c->callback.GetResult(rv);
+    ASSERT_EQ(kFirstPartSize, rv);
+    contents[i].append(buffers[i]->data(), rv);
+
+    c->result = c->trans->Read(buffers[i].get(), 256, c->callback.callback());
+    EXPECT_EQ(net::ERR_IO_PENDING, c->result);
+  }
+  base::MessageLoop::current()->RunUntilIdle();
+  for (int i = 0; i < kNumTransactions; ++i)
+    EXPECT_FALSE(context_list[i]->callback.have_result());
+
+  // The rest of the body is written.
+  std::string rest;
+  EXPECT_EQ(net::OK, ReadTransaction(writer.trans.get(), &rest));
+  writer_content.append(rest);
+  EXPECT_EQ(expected, writer_content);
+
+  for (int i = 0; i < kNumTransactions; ++i) {
+    Context* c = context_list[i];
+    rv = c->callback.WaitForResult();
+    ASSERT_LT(0, rv);
+    contents[i].append(buffers[i]->data(), rv);
+    std::string content;
+    EXPECT_EQ(net::OK, ReadTransaction(c->trans.get(), &content));
+    contents[i].append(content);
+    EXPECT_EQ(expected, contents[i]);
+  }
+
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+  EXPECT_EQ(0, cache.disk_cache()->open_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+
+  for (int i = 0; i < kNumTransactions; ++i)
+    delete context_list[i];
+}
+
+// Tests that the transactions reading an entry while it is written fail if
+// the writer goes away before writing the whole body.
+TEST(HttpCache, ReadWhileWriting_WriterCancelled) {
+  MockHttpCache cache;
+  cache.http_cache()->set_read_while_writing(true);
+
+  MockHttpRequest request(kSimpleGET_Transaction);
+  Context* writer = new Context();
+  ASSERT_EQ(net::OK, cache.CreateTransaction(&writer->trans));
+  writer->result = writer->trans->Start(
+      &request, writer->callback.callback(), net::BoundNetLog());
+  EXPECT_EQ(net::OK, writer->callback.GetResult(writer->result));
+
+  Context reader;
+  ASSERT_EQ(net::OK, cache.CreateTransaction(&reader.trans));
+  reader.result = reader.trans->Start(
+      &request, reader.callback.callback(), net::BoundNetLog());
+  EXPECT_EQ(net::ERR_IO_PENDING, reader.result);
+
+  const int kFirstPartSize = 10;
+  scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(256));
+  int rv = writer->trans->Read(buf.get(), kFirstPartSize,
+                               writer->callback.callback());
+  EXPECT_EQ(kFirstPartSize, writer->callback.GetResult(rv));
+  EXPECT_EQ(net::OK, reader.callback.WaitForResult());
+
+  rv = reader.trans->Read(buf.get(), 256, reader.callback.callback());
+  EXPECT_EQ(kFirstPartSize, reader.callback.GetResult(rv));
+  rv = reader.trans->Read(buf.get(), 256, reader.callback.callback());
+  EXPECT_EQ(net::ERR_IO_PENDING, rv);
+
+  delete writer;
+  EXPECT_EQ(net::ERR_CACHE_READ_FAILURE, reader.callback.WaitForResult());
+  reader.trans.reset();
+
+  // The incomplete entry was not kept.
+  RunTransactionTest(cache.http_cache(), kSimpleGET_Transaction);
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+  EXPECT_EQ(2, cache.disk_cache()->create_count());
+}
@@ -153,6 +153,8 @@ class NET_EXPORT HttpNetworkSession
     return net_log_;
   }
 
+  ClientSocketPoolManager* GetSocketPoolManager(SocketPoolType pool_type);
+
   // Creates a Value summary of the state of the socket pools. The caller is
   // responsible for deleting the returned value.
   base::Value* SocketPoolInfoToValue() const;
@@ -183,8 +185,6 @@ class NET_EXPORT HttpNetworkSession
 
   ~HttpNetworkSession();
 
-  ClientSocketPoolManager* GetSocketPoolManager(SocketPoolType pool_type);
-
   NetLog* const net_log_;
   NetworkDelegate* const network_delegate_;
   const base::WeakPtr<HttpServerProperties> http_server_properties_;
@@ -0,0 +1,80 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "base/test/perf_time_logger.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+const int kIterations = 20000;
+
+// A response as sent by an API server, with large cookie and content
+// security policy headers.
+std::string GetResponseHeaders() {
+  std::string headers =
+      "HTTP/1.1 200 OK\r\n"
+      "Date: Tue, 13 May 2014 08:12:31 GMT\r\n"
+      "Content-Type: application/json; charset=UTF-8\r\n"
+      "Cache-Control: private, max-age=0, must-revalidate\r\n"
+      "Content-Security-Policy: default-src 'self'; script-src 'self' "
+      "'unsafe-eval' https://apis.example.com https://ssl.example-analytics"
+      ".com https://static.example.net; style-src 'self' 'unsafe-inline' "
+      "https://fonts.example.com; img-src 'self' data: https://*.example.com "
+      "https://*.example-static.com; connect-src 'self' https://api.example"
+      ".com wss://push.example.com; frame-src https://accounts.example.com; "
+      "report-uri /csp-report\r\n";
+  for (int i = 0; i < 8; ++i) {
+    headers += "Set-Cookie: SESSION" + std::string(1, 'A' + i) + "=" +
+               std::string(400, 'a' + i) +
+               "; expires=Wed, 12-Nov-2014 08:12:31 GMT; path=/; "
+               "domain=.example.com; Secure; HttpOnly\r\n";
+  }
+  headers +=
+      "Vary: Accept-Encoding\r\n"
+      "Content-Encoding: gzip\r\n"
+      "Server: api-frontend\r\n"
+      "X-XSS-Protection: 1; mode=block\r\n"
+      "X-Frame-Options: SAMEORIGIN\r\n"
+      "Content-Length: 13504\r\n"
+      "\r\n";
+  return headers;
+}
+
+TEST(HttpResponseHeadersPerfTest, LocateEndOfHeaders) {
+  std::string headers = GetResponseHeaders();
+  int expected = static_cast<int>(headers.size());
+
+  base::PerfTimeLogger timer("Locate end of HTTP response headers");
+  for (int i = 0; i < kIterations; ++i) {
+    ASSERT_EQ(expected,
+              HttpUtil::LocateEndOfHeaders(headers.data(), headers.size()));
+  }
+  timer.Done();
+}
+
+TEST(HttpResponseHeadersPerfTest, ParseHeaders) {
+  std::string headers = GetResponseHeaders();
+
+  base::PerfTimeLogger timer("Parse HTTP response headers");
+  for (int i = 0; i < kIterations; ++i) {
+    int end_of_headers =
+        HttpUtil::LocateEndOfHeaders(headers.data(), headers.size());
+    scoped_refptr<HttpResponseHeaders> parsed(new HttpResponseHeaders(
+        HttpUtil::AssembleRawHeaders(headers.data(), end_of_headers)));
+    ASSERT_EQ(13504, parsed->GetContentLength());
+  }
+  timer.Done();
+}
+
+}  // namespace
+
+}  // namespace net
@@ -149,6 +149,16 @@ class NET_EXPORT HttpServerProperties {
   virtual const NetworkStats* GetServerNetworkStats(
       const HostPortPair& host_port_pair) const = 0;
 
+  // Sets the number of sockets navigations to |origin| were seen to use at
+  // once, so they can be connected ahead of time on the next navigation.
+  virtual void SetExpectedConcurrentSockets(const HostPortPair& origin,
+                                            int num_sockets) = 0;
+
+  // Returns the number of sockets set by SetExpectedConcurrentSockets(), or 0
+  // if none was.
+  virtual int GetExpectedConcurrentSockets(
+      const HostPortPair& origin) const = 0;
+
   virtual HttpPipelinedHostCapability GetPipelineCapability(
       const HostPortPair& origin) = 0;
 
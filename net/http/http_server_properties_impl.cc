@@ -21,6 +21,7 @@ static const int kDefaultNumHostsToRemember = 200;
 HttpServerPropertiesImpl::HttpServerPropertiesImpl()
     : alternate_protocol_map_(AlternateProtocolMap::NO_AUTO_EVICT),
       spdy_settings_map_(SpdySettingsMap::NO_AUTO_EVICT),
+      expected_concurrent_sockets_map_(kDefaultNumHostsToRemember),
       pipeline_capability_map_(
         new CachedPipelineCapabilityMap(kDefaultNumHostsToRemember)),
       weak_ptr_factory_(this) {
@@ -163,6 +164,7 @@ void HttpServerPropertiesImpl::Clear() {
   spdy_servers_table_.clear();
   alternate_protocol_map_.Clear();
   spdy_settings_map_.Clear();
+  expected_concurrent_sockets_map_.Clear();
   pipeline_capability_map_->Clear();
 }
 
@@ -362,6 +364,22 @@ HttpServerPropertiesImpl::GetServerNetworkStats(
   return &it->second;
 }
 
+void HttpServerPropertiesImpl::SetExpectedConcurrentSockets(
+    const HostPortPair& origin,
+    int num_sockets) {
+  DCHECK_LE(0, num_sockets);
+  expected_concurrent_sockets_map_.Put(origin, num_sockets);
+}
+
+int HttpServerPropertiesImpl::GetExpectedConcurrentSockets(
+    const HostPortPair& origin) const {
+  ExpectedConcurrentSocketsMap::const_iterator it =
+      expected_concurrent_sockets_map_.Peek(origin);
+  if (it == expected_concurrent_sockets_map_.end())
+    return 0;
+  return it->second;
+}
+
 HttpPipelinedHostCapability HttpServerPropertiesImpl::GetPipelineCapability(
     const HostPortPair& origin) {
   HttpPipelinedHostCapability capability = PIPELINE_UNKNOWN;
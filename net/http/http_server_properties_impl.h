@@ -136,6 +136,12 @@ class NET_EXPORT HttpServerPropertiesImpl
   virtual const NetworkStats* GetServerNetworkStats(
       const HostPortPair& host_port_pair) const OVERRIDE;
 
+  virtual void SetExpectedConcurrentSockets(const HostPortPair& origin,
+                                            int num_sockets) OVERRIDE;
+
+  virtual int GetExpectedConcurrentSockets(
+      const HostPortPair& origin) const OVERRIDE;
+
   virtual HttpPipelinedHostCapability GetPipelineCapability(
       const HostPortPair& origin) OVERRIDE;
 
@@ -154,6 +160,7 @@ class NET_EXPORT HttpServerPropertiesImpl
   // pair) that either support or not support SPDY protocol.
   typedef base::hash_map<std::string, bool> SpdyServerHostPortTable;
   typedef std::map<HostPortPair, NetworkStats> ServerNetworkStatsMap;
+  typedef base::MRUCache<HostPortPair, int> ExpectedConcurrentSocketsMap;
   typedef std::map<HostPortPair, HostPortPair> CanonicalHostMap;
   typedef std::vector<std::string> CanonicalSufficList;
 
@@ -165,6 +172,7 @@ class NET_EXPORT HttpServerPropertiesImpl
   AlternateProtocolMap alternate_protocol_map_;
   SpdySettingsMap spdy_settings_map_;
   ServerNetworkStatsMap server_network_stats_map_;
+  ExpectedConcurrentSocketsMap expected_concurrent_sockets_map_;
   scoped_ptr<CachedPipelineCapabilityMap> pipeline_capability_map_;
   // Contains a map of servers which could share the same alternate protocol.
   // Map from a Canonical host/port (host is some postfix of host names) to an
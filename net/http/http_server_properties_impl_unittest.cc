@@ -550,6 +550,24 @@ TEST_F(SpdySettingsServerPropertiesTest, MRUOfGetSpdySettings) {
   EXPECT_EQ(value1, flags_and_value1_ret.second);
 }
 
+typedef HttpServerPropertiesImplTest ExpectedConcurrentSocketsTest;
+
+TEST_F(ExpectedConcurrentSocketsTest, SetAndGet) {
+  HostPortPair origin("www.google.com", 443);
+  HostPortPair other_origin("mail.google.com", 443);
+  EXPECT_EQ(0, impl_.GetExpectedConcurrentSockets(origin));
+
+  impl_.SetExpectedConcurrentSockets(origin, 4);
+  EXPECT_EQ(4, impl_.GetExpectedConcurrentSockets(origin));
+  EXPECT_EQ(0, impl_.GetExpectedConcurrentSockets(other_origin));
+
+  impl_.SetExpectedConcurrentSockets(origin, 2);
+  EXPECT_EQ(2, impl_.GetExpectedConcurrentSockets(origin));
+
+  impl_.Clear();
+  EXPECT_EQ(0, impl_.GetExpectedConcurrentSockets(origin));
+}
+
 }  // namespace
 
 }  // namespace net
@@ -188,6 +188,10 @@ class NET_EXPORT_PRIVATE HttpStreamParser {
   // -1 if not found yet.
   int response_header_start_offset_;
 
+  // Where to resume looking for the end of the headers in |read_buf_|, so
+  // that headers received over many reads are not scanned over and over.
+  int response_header_search_offset_;
+
   // The amount of received data.  If connection is reused then intermediate
   // value may be bigger than final.
   int64 received_bytes_;
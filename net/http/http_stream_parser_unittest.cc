@@ -804,6 +804,37 @@ TEST(HttpStreamParser, ReceivedBytesIncludesContinueHeader) {
   EXPECT_EQ(response_size, get_runner.parser()->received_bytes());
 }
 
+// Test that the end of the headers is found when every read ends at a
+// different place within the end-of-headers marker.
+TEST(HttpStreamParser, ReadHeadersOneByteAtATime) {
+  const char* const kResponses[] = {
+    "HTTP/1.1 200 OK\r\nContent-Length: 7\r\n\r\n",
+    "HTTP/1.1 200 OK\nContent-Length: 7\n\n",
+    "HTTP/1.1 200 OK\nContent-Length: 7\n\r\n",
+  };
+  for (size_t i = 0; i < arraysize(kResponses); ++i) {
+    std::string headers = kResponses[i];
+    std::string body = "content";
+    // MockRead does not copy the data, so the blocks have to outlive it.
+    std::vector<std::string> blocks;
+    for (size_t j = 0; j < headers.size(); ++j)
+      blocks.push_back(headers.substr(j, 1));
+
+    SimpleGetRunner get_runner;
+    for (size_t j = 0; j < blocks.size(); ++j)
+      get_runner.AddRead(blocks[j]);
+    get_runner.AddRead(body);
+    get_runner.SetupParserAndSendRequest();
+    get_runner.ReadHeaders();
+    EXPECT_EQ(7, get_runner.response_info()->headers->GetContentLength());
+    int64 headers_size = headers.size();
+    EXPECT_EQ(headers_size, get_runner.parser()->received_bytes());
+    int body_size = body.size();
+    int read_lengths[] = {body_size, 0};
+    get_runner.ReadBody(body_size, read_lengths);
+  }
+}
+
 }  // namespace
 
 }  // namespace net
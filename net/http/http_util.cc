@@ -507,18 +507,18 @@ int HttpUtil::LocateStartOfStatusLine(const char* buf, int buf_len) {
 }
 
 int HttpUtil::LocateEndOfHeaders(const char* buf, int buf_len, int i) {
-  bool was_lf = false;
-  char last_c = '\0';
-  for (; i < buf_len; ++i) {
-    char c = buf[i];
-    if (c == '\n') {
-      if (was_lf)
-        return i + 1;
-      was_lf = true;
-    } else if (c != '\r' || last_c != '\n') {
-      was_lf = false;
-    }
-    last_c = c;
+  // Jump from LF to LF with memchr, which scans many bytes at a time, rather
+  // than looking at every byte of the (possibly large) header block.
+  while (i < buf_len) {
+    const char* lf = static_cast<const char*>(memchr(buf + i, '\n',
+                                                     buf_len - i));
+    if (!lf)
+      return -1;
+    i = lf - buf + 1;
+    if (i < buf_len && buf[i] == '\n')
+      return i + 1;
+    if (i + 1 < buf_len && buf[i] == '\r' && buf[i + 1] == '\n')
+      return i + 2;
   }
   return -1;
 }
@@ -565,10 +565,33 @@ static const char* FindFirstNonLWS(const char* begin, const char* end) {
   return end;  // Not found.
 }
 
+// Helper used by AssembleRawHeaders, to find the first CR or LF.  Looks for
+// the LF first, so that the CR is only searched for within the line.
+static const char* FindLineEnd(const char* begin, const char* end) {
+  const char* lf = static_cast<const char*>(memchr(begin, '\n', end - begin));
+  if (!lf)
+    lf = end;
+  const char* cr = static_cast<const char*>(memchr(begin, '\r', lf - begin));
+  return cr ? cr : lf;
+}
+
+// Helper used by AssembleRawHeaders, to copy [begin, end) to |output| minus
+// any '\0', which would otherwise be taken for a line terminator.
+static void AppendWithoutNulls(const char* begin,
+                               const char* end,
+                               std::string* output) {
+  const char* nul;
+  while ((nul = static_cast<const char*>(memchr(begin, '\0', end - begin)))) {
+    output->append(begin, nul);
+    begin = nul + 1;
+  }
+  output->append(begin, end);
+}
+
 std::string HttpUtil::AssembleRawHeaders(const char* input_begin,
                                          int input_len) {
   std::string raw_headers;
-  raw_headers.reserve(input_len);
+  raw_headers.reserve(input_len + 2);
 
   const char* input_end = input_begin + input_len;
 
@@ -580,47 +603,46 @@ std::string HttpUtil::AssembleRawHeaders(const char* input_begin,
 
   // Copy the status line.
   const char* status_line_end = FindStatusLineEnd(input_begin, input_end);
-  raw_headers.append(input_begin, status_line_end);
+  AppendWithoutNulls(input_begin, status_line_end, &raw_headers);
 
   // After the status line, every subsequent line is a header line segment.
   // Should a segment start with LWS, it is a continuation of the previous
   // line's field-value.
 
-  // TODO(ericroman): is this too permissive? (delimits on [\r\n]+)
-  base::CStringTokenizer lines(status_line_end, input_end, "\r\n");
-
   // This variable is true when the previous line was continuable.
   bool prev_line_continuable = false;
 
-  while (lines.GetNext()) {
-    const char* line_begin = lines.token_begin();
-    const char* line_end = lines.token_end();
+  // TODO(ericroman): is this too permissive? (delimits on [\r\n]+)
+  const char* line_end = status_line_end;
+  while (true) {
+    const char* line_begin = line_end;
+    while (line_begin != input_end &&
+           (*line_begin == '\r' || *line_begin == '\n')) {
+      ++line_begin;
+    }
+    if (line_begin == input_end)
+      break;
+    line_end = FindLineEnd(line_begin, input_end);
 
     if (prev_line_continuable && IsLWS(*line_begin)) {
       // Join continuation; reduce the leading LWS to a single SP.
       raw_headers.push_back(' ');
-      raw_headers.append(FindFirstNonLWS(line_begin, line_end), line_end);
+      AppendWithoutNulls(FindFirstNonLWS(line_begin, line_end), line_end,
+                         &raw_headers);
     } else {
-      // Terminate the previous line.
-      raw_headers.push_back('\n');
+      // Terminate the previous line.  Use '\0' as the canonical line
+      // terminator.
+      raw_headers.push_back('\0');
 
       // Copy the raw data to output.
-      raw_headers.append(line_begin, line_end);
+      AppendWithoutNulls(line_begin, line_end, &raw_headers);
 
       // Check if the current line can be continued.
       prev_line_continuable = IsLineSegmentContinuable(line_begin, line_end);
     }
   }
 
-  raw_headers.append("\n\n", 2);
-
-  // Use '\0' as the canonical line terminator. If the input already contained
-  // any embeded '\0' characters we will strip them first to avoid interpreting
-  // them as line breaks.
-  raw_headers.erase(std::remove(raw_headers.begin(), raw_headers.end(), '\0'),
-                    raw_headers.end());
-  std::replace(raw_headers.begin(), raw_headers.end(), '\n', '\0');
-
+  raw_headers.append("\0\0", 2);
   return raw_headers;
 }
 
@@ -271,14 +271,34 @@ TEST(HttpUtilTest, LocateEndOfHeaders) {
     { "foo\nbar\n\njunk", 9 },
     { "foo\nbar\n\r\njunk", 10 },
     { "foo\nbar\r\n\njunk", 10 },
+    { "foo\r\nbar\r\n", -1 },
+    { "foo\nbar\n\r", -1 },
+    { "foo\n\r\r\nbar", -1 },
+    { "\n\n", 2 },
+    { "", -1 },
   };
   for (size_t i = 0; i < ARRAYSIZE_UNSAFE(tests); ++i) {
     int input_len = static_cast<int>(strlen(tests[i].input));
     int eoh = HttpUtil::LocateEndOfHeaders(tests[i].input, input_len);
-    EXPECT_EQ(tests[i].expected_result, eoh);
+    EXPECT_EQ(tests[i].expected_result, eoh) << tests[i].input;
   }
 }
 
+TEST(HttpUtilTest, LocateEndOfHeadersFromOffset) {
+  std::string headers = "HTTP/1.1 200 OK\r\nSet-Cookie: " +
+                        std::string(10000, 'x') + "\r\n\r\nbody";
+  int expected = static_cast<int>(headers.size()) - 4;
+  EXPECT_EQ(expected, HttpUtil::LocateEndOfHeaders(headers.data(),
+                                                   headers.size()));
+  // Searching may resume anywhere up to the LF starting the marker.
+  EXPECT_EQ(expected, HttpUtil::LocateEndOfHeaders(headers.data(),
+                                                   headers.size(),
+                                                   expected - 3));
+  EXPECT_EQ(-1, HttpUtil::LocateEndOfHeaders(headers.data(), headers.size(),
+                                             expected - 2));
+  EXPECT_EQ(-1, HttpUtil::LocateEndOfHeaders(headers.data(), expected - 1));
+}
+
 TEST(HttpUtilTest, AssembleRawHeaders) {
   struct {
     const char* input;  // with '|' representing '\0'
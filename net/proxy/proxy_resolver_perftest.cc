@@ -227,3 +227,49 @@ TEST(ProxyResolverPerfTest, ProxyResolverV8) {
   PacPerfSuiteRunner runner(&resolver, "ProxyResolverV8");
   runner.RunAllTests();
 }
+
+TEST(ProxyResolverPerfTest, ProxyResolverV8WithResultCache) {
+  // This has to be done on the main thread.
+  net::ProxyResolverV8::RememberDefaultIsolate();
+
+  MockJSBindings js_bindings;
+  net::ProxyResolverV8 resolver;
+  resolver.set_js_bindings(&js_bindings);
+  resolver.set_result_cache_ttl(base::TimeDelta::FromMinutes(5));
+  PacPerfSuiteRunner runner(&resolver, "ProxyResolverV8WithResultCache");
+  runner.RunAllTests();
+}
+
+// Measures how long it takes to load each PAC script into a new resolver, as
+// happens for each new worker thread. All but the first load of a script use
+// the shared preparse data.
+TEST(ProxyResolverPerfTest, ProxyResolverV8SetPacScript) {
+  // This has to be done on the main thread.
+  net::ProxyResolverV8::RememberDefaultIsolate();
+
+  const int kNumLoads = 20;
+  for (size_t i = 0; i < arraysize(kPerfTests); ++i) {
+    base::FilePath path;
+    PathService::Get(base::DIR_SOURCE_ROOT, &path);
+    path = path.AppendASCII("net");
+    path = path.AppendASCII("data");
+    path = path.AppendASCII("proxy_resolver_perftest");
+    path = path.AppendASCII(kPerfTests[i].pac_name);
+    std::string file_contents;
+    ASSERT_TRUE(base::ReadFileToString(path, &file_contents));
+    scoped_refptr<net::ProxyResolverScriptData> script_data =
+        net::ProxyResolverScriptData::FromUTF8(file_contents);
+
+    std::string perf_test_name =
+        std::string("ProxyResolverV8SetPacScript_") + kPerfTests[i].pac_name;
+    base::PerfTimeLogger timer(perf_test_name.c_str());
+    for (int load = 0; load < kNumLoads; ++load) {
+      MockJSBindings js_bindings;
+      net::ProxyResolverV8 resolver;
+      resolver.set_js_bindings(&js_bindings);
+      ASSERT_EQ(net::OK,
+                resolver.SetPacScript(script_data, net::CompletionCallback()));
+    }
+    timer.Done();
+  }
+}
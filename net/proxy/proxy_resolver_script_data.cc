@@ -5,10 +5,21 @@
 #include "net/proxy/proxy_resolver_script_data.h"
 
 #include "base/logging.h"
+#include "base/sha1.h"
 #include "base/strings/utf_string_conversions.h"
 
 namespace net {
 
+namespace {
+
+std::string HashScript(const base::string16& utf16) {
+  return base::SHA1HashString(std::string(
+      reinterpret_cast<const char*>(utf16.data()),
+      utf16.size() * sizeof(base::char16)));
+}
+
+}  // namespace
+
 // static
 scoped_refptr<ProxyResolverScriptData> ProxyResolverScriptData::FromUTF8(
     const std::string& utf8) {
@@ -41,6 +52,11 @@ const base::string16& ProxyResolverScriptData::utf16() const {
   return utf16_;
 }
 
+const std::string& ProxyResolverScriptData::hash() const {
+  DCHECK_EQ(TYPE_SCRIPT_CONTENTS, type_);
+  return hash_;
+}
+
 const GURL& ProxyResolverScriptData::url() const {
   DCHECK_EQ(TYPE_SCRIPT_URL, type_);
   return url_;
@@ -53,7 +69,7 @@ bool ProxyResolverScriptData::Equals(
 
   switch (type()) {
     case TYPE_SCRIPT_CONTENTS:
-      return utf16() == other->utf16();
+      return hash() == other->hash() && utf16() == other->utf16();
     case TYPE_SCRIPT_URL:
       return url() == other->url();
     case TYPE_AUTO_DETECT:
@@ -68,7 +84,8 @@ ProxyResolverScriptData::ProxyResolverScriptData(Type type,
                                                  const base::string16& utf16)
     : type_(type),
       url_(url),
-      utf16_(utf16) {
+      utf16_(utf16),
+      hash_(type == TYPE_SCRIPT_CONTENTS ? HashScript(utf16) : std::string()) {
 }
 
 ProxyResolverScriptData::~ProxyResolverScriptData() {}
@@ -5,6 +5,8 @@
 #ifndef NET_PROXY_PROXY_RESOLVER_SCRIPT_DATA_H_
 #define NET_PROXY_PROXY_RESOLVER_SCRIPT_DATA_H_
 
+#include <string>
+
 #include "base/memory/ref_counted.h"
 #include "base/strings/string16.h"
 #include "net/base/net_export.h"
@@ -49,6 +51,11 @@ class NET_EXPORT_PRIVATE ProxyResolverScriptData
   // (only valid for type() == TYPE_SCRIPT_CONTENTS).
   const base::string16& utf16() const;
 
+  // Returns a SHA-1 hash of utf16(), used to share per-script state (such as
+  // V8 preparse data) between resolvers.
+  // (only valid for type() == TYPE_SCRIPT_CONTENTS).
+  const std::string& hash() const;
+
   // Returns the URL of the script.
   // (only valid for type() == TYPE_SCRIPT_URL).
   const GURL& url() const;
@@ -67,6 +74,7 @@ class NET_EXPORT_PRIVATE ProxyResolverScriptData
   const Type type_;
   const GURL url_;
   const base::string16 utf16_;
+  const std::string hash_;
 };
 
 }  // namespace net
@@ -9,6 +9,8 @@
 
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
+#include "base/containers/mru_cache.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/strings/string_tokenizer.h"
 #include "base/strings/string_util.h"
@@ -336,6 +338,64 @@ bool IsInNetEx(const std::string& ip_address, const std::string& ip_prefix) {
   return IPNumberMatchesPrefix(address, prefix, prefix_length_in_bits);
 }
 
+// Process-wide cache of V8 preparse data for PAC scripts, keyed by
+// ProxyResolverScriptData::hash(). Preparse data lets V8 skip over the bodies
+// of functions while compiling, which is most of a large PAC script. Every
+// ProxyResolverV8 compiles the script in its own context, so sharing the data
+// between them means only the first one pays for preparsing it.
+class PreparseDataCache {
+ public:
+  PreparseDataCache() : cache_(kMaxEntries) {}
+
+  bool Get(const std::string& hash, std::string* data) {
+    base::AutoLock locked(lock_);
+    Cache::iterator it = cache_.Get(hash);
+    if (it == cache_.end())
+      return false;
+    *data = it->second;
+    return true;
+  }
+
+  void Put(const std::string& hash, const std::string& data) {
+    base::AutoLock locked(lock_);
+    cache_.Put(hash, data);
+  }
+
+ private:
+  typedef base::MRUCache<std::string, std::string> Cache;
+
+  // There is normally a single PAC script in use, but keep a few around so
+  // that switching between networks doesn't require preparsing again.
+  static const size_t kMaxEntries = 4;
+
+  base::Lock lock_;
+  Cache cache_;
+};
+
+base::LazyInstance<PreparseDataCache>::Leaky g_preparse_data_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
+// Returns the preparse data for |source|, whose hash is |hash|, preparsing it
+// if it isn't cached yet. Returns NULL if |source| can't be preparsed, in
+// which case compiling it will report the error.
+v8::ScriptData* GetPreparseData(const std::string& hash,
+                                v8::Handle<v8::String> source) {
+  std::string data;
+  if (g_preparse_data_cache.Get().Get(hash, &data))
+    return v8::ScriptData::New(data.data(), static_cast<int>(data.size()));
+
+  scoped_ptr<v8::ScriptData> preparse_data(v8::ScriptData::PreCompile(source));
+  if (!preparse_data || preparse_data->HasError())
+    return NULL;
+  g_preparse_data_cache.Get().Put(
+      hash, std::string(preparse_data->Data(), preparse_data->Length()));
+  return preparse_data.release();
+}
+
+// The maximum number of FindProxyForURL() results cached by a
+// ProxyResolverV8, when its result cache is enabled.
+const size_t kMaxCachedResults = 256;
+
 }  // namespace
 
 // ProxyResolverV8::Context ---------------------------------------------------
@@ -480,15 +540,19 @@ class ProxyResolverV8::Context {
             isolate_,
             PROXY_RESOLVER_SCRIPT
             PROXY_RESOLVER_SCRIPT_EX),
-        kPacUtilityResourceName);
+        kPacUtilityResourceName,
+        NULL);
     if (rv != OK) {
       NOTREACHED();
       return rv;
     }
 
     // Add the user's PAC code to the environment.
-    rv =
-        RunScript(ScriptDataToV8String(isolate_, pac_script), kPacResourceName);
+    v8::Local<v8::String> pac_source = ScriptDataToV8String(isolate_,
+                                                            pac_script);
+    scoped_ptr<v8::ScriptData> preparse_data(
+        GetPreparseData(pac_script->hash(), pac_source));
+    rv = RunScript(pac_source, kPacResourceName, preparse_data.get());
     if (rv != OK)
       return rv;
 
@@ -527,15 +591,19 @@ class ProxyResolverV8::Context {
     js_bindings()->OnError(line_number, error_message);
   }
 
-  // Compiles and runs |script| in the current V8 context.
+  // Compiles and runs |script| in the current V8 context, using
+  // |preparse_data| if it isn't NULL.
   // Returns OK on success, otherwise an error code.
-  int RunScript(v8::Handle<v8::String> script, const char* script_name) {
+  int RunScript(v8::Handle<v8::String> script,
+                const char* script_name,
+                v8::ScriptData* preparse_data) {
     v8::TryCatch try_catch;
 
     // Compile the script.
     v8::ScriptOrigin origin =
         v8::ScriptOrigin(ASCIILiteralToV8String(isolate_, script_name));
-    v8::Local<v8::Script> code = v8::Script::Compile(script, &origin);
+    v8::Local<v8::Script> code =
+        v8::Script::Compile(script, &origin, preparse_data);
 
     // Execute.
     if (!code.IsEmpty())
@@ -708,7 +776,8 @@ class ProxyResolverV8::Context {
 
 ProxyResolverV8::ProxyResolverV8()
     : ProxyResolver(true /*expects_pac_bytes*/),
-      js_bindings_(NULL) {
+      js_bindings_(NULL),
+      result_cache_(kMaxCachedResults) {
 }
 
 ProxyResolverV8::~ProxyResolverV8() {}
@@ -725,12 +794,35 @@ int ProxyResolverV8::GetProxyForURL(
   if (!context_)
     return ERR_FAILED;
 
+  if (result_cache_ttl_ > base::TimeDelta()) {
+    ResultCache::iterator it = result_cache_.Get(query_url.spec());
+    if (it != result_cache_.end()) {
+      if (base::TimeTicks::Now() < it->second.expiration) {
+        results->UsePacString(it->second.pac_string);
+        return OK;
+      }
+      result_cache_.Erase(it);
+    }
+  }
+
   // Otherwise call into V8.
   int rv = context_->ResolveProxy(query_url, results);
 
+  if (rv == OK && result_cache_ttl_ > base::TimeDelta()) {
+    CachedResult result;
+    result.pac_string = results->ToPacString();
+    result.expiration = base::TimeTicks::Now() + result_cache_ttl_;
+    result_cache_.Put(query_url.spec(), result);
+  }
+
   return rv;
 }
 
+void ProxyResolverV8::set_result_cache_ttl(base::TimeDelta ttl) {
+  result_cache_ttl_ = ttl;
+  result_cache_.Clear();
+}
+
 void ProxyResolverV8::CancelRequest(RequestHandle request) {
   // This is a synchronous ProxyResolver; no possibility for async requests.
   NOTREACHED();
@@ -752,6 +844,7 @@ int ProxyResolverV8::SetPacScript(
   DCHECK(js_bindings_);
 
   context_.reset();
+  result_cache_.Clear();
   if (script_data->utf16().empty())
     return ERR_PAC_SCRIPT_FAILED;
 
@@ -5,8 +5,12 @@
 #ifndef NET_PROXY_PROXY_RESOLVER_V8_H_
 #define NET_PROXY_PROXY_RESOLVER_V8_H_
 
+#include <string>
+
 #include "base/compiler_specific.h"
+#include "base/containers/mru_cache.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/time/time.h"
 #include "net/base/net_export.h"
 #include "net/proxy/proxy_resolver.h"
 
@@ -77,6 +81,12 @@ class NET_EXPORT_PRIVATE ProxyResolverV8 : public ProxyResolver {
   JSBindings* js_bindings() const { return js_bindings_; }
   void set_js_bindings(JSBindings* js_bindings) { js_bindings_ = js_bindings; }
 
+  // Enables caching successful FindProxyForURL() results for |ttl|, per URL.
+  // PAC scripts can depend on DNS and on the time of day, so a cached result
+  // may be up to |ttl| out of date. The cache is cleared when a new PAC script
+  // is set. A zero |ttl|, the default, disables the cache.
+  void set_result_cache_ttl(base::TimeDelta ttl);
+
   // ProxyResolver implementation:
   virtual int GetProxyForURL(const GURL& url,
                              ProxyInfo* results,
@@ -118,10 +128,19 @@ class NET_EXPORT_PRIVATE ProxyResolverV8 : public ProxyResolver {
   // SetPacScript().
   class Context;
 
+  struct CachedResult {
+    std::string pac_string;
+    base::TimeTicks expiration;
+  };
+  typedef base::MRUCache<std::string, CachedResult> ResultCache;
+
   scoped_ptr<Context> context_;
 
   JSBindings* js_bindings_;
 
+  base::TimeDelta result_cache_ttl_;
+  ResultCache result_cache_;
+
   DISALLOW_COPY_AND_ASSIGN(ProxyResolverV8);
 };
 
@@ -310,6 +310,81 @@ TEST(ProxyResolverV8Test, SideEffects) {
   }
 }
 
+// Run a PAC script which has side-effects, with the result cache enabled.
+TEST(ProxyResolverV8Test, ResultCache) {
+  ProxyResolverV8WithMockBindings resolver;
+  resolver.set_result_cache_ttl(base::TimeDelta::FromHours(1));
+  int result = resolver.SetPacScriptFromDisk("side_effects.js");
+  EXPECT_EQ(OK, result);
+
+  // Repeated queries for the same URL are answered from the cache, without
+  // running the script again.
+  for (int i = 0; i < 3; ++i) {
+    ProxyInfo proxy_info;
+    result = resolver.GetProxyForURL(
+        kQueryUrl, &proxy_info, CompletionCallback(), NULL, BoundNetLog());
+    EXPECT_EQ(OK, result);
+    EXPECT_EQ("sideffect_0:80", proxy_info.proxy_server().ToURI());
+  }
+
+  // Other URLs still run the script.
+  {
+    ProxyInfo proxy_info;
+    result = resolver.GetProxyForURL(
+        GURL("http://other.com"), &proxy_info, CompletionCallback(), NULL,
+        BoundNetLog());
+    EXPECT_EQ(OK, result);
+    EXPECT_EQ("sideffect_1:80", proxy_info.proxy_server().ToURI());
+  }
+
+  // Disabling the cache drops the cached results.
+  resolver.set_result_cache_ttl(base::TimeDelta());
+  {
+    ProxyInfo proxy_info;
+    result = resolver.GetProxyForURL(
+        kQueryUrl, &proxy_info, CompletionCallback(), NULL, BoundNetLog());
+    EXPECT_EQ(OK, result);
+    EXPECT_EQ("sideffect_2:80", proxy_info.proxy_server().ToURI());
+  }
+
+  // Reloading the script drops the cached results too.
+  resolver.set_result_cache_ttl(base::TimeDelta::FromHours(1));
+  {
+    ProxyInfo proxy_info;
+    result = resolver.GetProxyForURL(
+        kQueryUrl, &proxy_info, CompletionCallback(), NULL, BoundNetLog());
+    EXPECT_EQ(OK, result);
+    EXPECT_EQ("sideffect_3:80", proxy_info.proxy_server().ToURI());
+  }
+  result = resolver.SetPacScriptFromDisk("side_effects.js");
+  EXPECT_EQ(OK, result);
+  {
+    ProxyInfo proxy_info;
+    result = resolver.GetProxyForURL(
+        kQueryUrl, &proxy_info, CompletionCallback(), NULL, BoundNetLog());
+    EXPECT_EQ(OK, result);
+    EXPECT_EQ("sideffect_0:80", proxy_info.proxy_server().ToURI());
+  }
+}
+
+// Load the same PAC script into several resolvers. All but the first reuse the
+// preparse data of the first one.
+TEST(ProxyResolverV8Test, SharedPreparseData) {
+  for (int i = 0; i < 3; ++i) {
+    ProxyResolverV8WithMockBindings resolver;
+    int result = resolver.SetPacScriptFromDisk("passthrough.js");
+    EXPECT_EQ(OK, result);
+
+    ProxyInfo proxy_info;
+    result = resolver.GetProxyForURL(GURL("http://query.com/path"), &proxy_info,
+                                     CompletionCallback(), NULL, BoundNetLog());
+    EXPECT_EQ(OK, result);
+    EXPECT_EQ("http.query.com.path.query.com:80",
+              proxy_info.proxy_server().ToURI());
+    EXPECT_EQ(0U, resolver.mock_js_bindings()->errors.size());
+  }
+}
+
 // Execute a PAC script which throws an exception in FindProxyForURL.
 TEST(ProxyResolverV8Test, UnhandledException) {
   ProxyResolverV8WithMockBindings resolver;
@@ -20,6 +20,7 @@
 #include "net/base/net_errors.h"
 #include "net/base/net_log.h"
 #include "net/base/net_util.h"
+#include "net/dns/dns_config_service.h"
 #include "net/proxy/dhcp_proxy_script_fetcher.h"
 #include "net/proxy/multi_threaded_proxy_resolver.h"
 #include "net/proxy/network_delegate_error_observer.h"
@@ -76,6 +77,11 @@ namespace {
 // sorts of problems.
 const int64 kDelayAfterNetworkChangesMs = 2000;
 
+// The number of networks whose proxy auto-config decisions are remembered.
+// Users typically move between a handful of networks, such as home, office
+// and a VPN.
+const size_t kMaxCachedDecisions = 8;
+
 // This is the default policy for polling the PAC script.
 //
 // In response to a failure, the poll intervals are:
@@ -568,6 +574,7 @@ class ProxyService::ProxyScriptDeciderPoller {
         dhcp_proxy_script_fetcher_(dhcp_proxy_script_fetcher),
         last_error_(init_net_error),
         last_script_data_(init_script_data),
+        revalidating_(false),
         last_poll_time_(TimeTicks::Now()) {
     // Set the initial poll delay.
     next_poll_mode_ = poll_policy()->GetNextDelay(
@@ -587,6 +594,19 @@ class ProxyService::ProxyScriptDeciderPoller {
     return prev;
   }
 
+  // Checks the decision again after |delay| rather than when the poll policy
+  // says to. This is used when the decision was reused from an earlier visit
+  // to the network, so may be stale.
+  void RevalidateAfter(TimeDelta delay) {
+    DCHECK(!decider_.get());
+    // Cancel any poll scheduled by the constructor.
+    weak_factory_.InvalidateWeakPtrs();
+    revalidating_ = true;
+    next_poll_mode_ = PacPollPolicy::MODE_USE_TIMER;
+    next_poll_delay_ = delay;
+    StartPollTimer();
+  }
+
   void set_quick_check_enabled(bool enabled) { quick_check_enabled_ = enabled; }
   bool quick_check_enabled() const { return quick_check_enabled_; }
 
@@ -662,6 +682,12 @@ class ProxyService::ProxyScriptDeciderPoller {
 
     decider_.reset();
 
+    // Once the decision is confirmed, poll as though it had just been made.
+    if (revalidating_) {
+      revalidating_ = false;
+      next_poll_delay_ = TimeDelta::FromSeconds(-1);
+    }
+
     // Decide when the next poll should take place, and possibly start the
     // next timer.
     next_poll_mode_ = poll_policy()->GetNextDelay(
@@ -711,6 +737,7 @@ class ProxyService::ProxyScriptDeciderPoller {
   scoped_ptr<ProxyScriptDecider> decider_;
   TimeDelta next_poll_delay_;
   PacPollPolicy::Mode next_poll_mode_;
+  bool revalidating_;
 
   TimeTicks last_poll_time_;
 
@@ -877,6 +904,10 @@ class ProxyService::PacRequest
 
 // ProxyService ---------------------------------------------------------------
 
+ProxyService::CachedDecision::CachedDecision() {}
+
+ProxyService::CachedDecision::~CachedDecision() {}
+
 ProxyService::ProxyService(ProxyConfigService* config_service,
                            ProxyResolver* resolver,
                            NetLog* net_log)
@@ -886,7 +917,8 @@ ProxyService::ProxyService(ProxyConfigService* config_service,
       net_log_(net_log),
       stall_proxy_auto_config_delay_(TimeDelta::FromMilliseconds(
           kDelayAfterNetworkChangesMs)),
-      quick_check_enabled_(true) {
+      quick_check_enabled_(true),
+      init_from_cached_decision_(false) {
   NetworkChangeNotifier::AddIPAddressObserver(this);
   NetworkChangeNotifier::AddDNSObserver(this);
   ResetConfigService(config_service);
@@ -1138,7 +1170,13 @@ void ProxyService::OnInitProxyResolverComplete(int result) {
       init_proxy_resolver_->script_data(),
       NULL));
   script_poller_->set_quick_check_enabled(quick_check_enabled_);
+  if (init_from_cached_decision_) {
+    // Confirm the decision in the background, once the network has settled.
+    script_poller_->RevalidateAfter(std::max(
+        TimeDelta(), stall_proxy_autoconfig_until_ - TimeTicks::Now()));
+  }
 
+  UpdateDecisionCache(result);
   init_proxy_resolver_.reset();
 
   if (result != OK) {
@@ -1358,6 +1396,7 @@ void ProxyService::ResetConfigService(
 void ProxyService::ForceReloadProxyConfig() {
   DCHECK(CalledOnValidThread());
   ResetProxyConfig(false);
+  decision_cache_.clear();
   ApplyProxyConfigIfAvailable();
 }
 
@@ -1493,6 +1532,9 @@ void ProxyService::InitializeUsingLastFetchedConfig() {
   // Start downloading + testing the PAC scripts for this new configuration.
   current_state_ = STATE_WAITING_FOR_INIT_PROXY_RESOLVER;
 
+  if (InitializeUsingCachedDecision())
+    return;
+
   // If we changed networks recently, we should delay running proxy auto-config.
   TimeDelta wait_delay =
       stall_proxy_autoconfig_until_ - TimeTicks::Now();
@@ -1524,6 +1566,8 @@ void ProxyService::InitializeUsingDecidedConfig(
 
   current_state_ = STATE_WAITING_FOR_INIT_PROXY_RESOLVER;
 
+  init_network_identity_ = GetNetworkIdentity();
+  init_from_cached_decision_ = false;
   init_proxy_resolver_.reset(new InitProxyResolver());
   int rv = init_proxy_resolver_->StartSkipDecider(
       resolver_.get(),
@@ -1537,6 +1581,90 @@ void ProxyService::InitializeUsingDecidedConfig(
     OnInitProxyResolverComplete(rv);
 }
 
+bool ProxyService::InitializeUsingCachedDecision() {
+  DCHECK_EQ(STATE_WAITING_FOR_INIT_PROXY_RESOLVER, current_state_);
+
+  init_network_identity_ = GetNetworkIdentity();
+  init_from_cached_decision_ = false;
+  if (init_network_identity_.empty())
+    return false;
+
+  DecisionCache::iterator it = decision_cache_.find(init_network_identity_);
+  if (it == decision_cache_.end() ||
+      !it->second.fetched_config.Equals(fetched_config_)) {
+    return false;
+  }
+
+  // Apply the decision without waiting for the network to settle; the script
+  // poller confirms it once it has.
+  it->second.last_used = TimeTicks::Now();
+  init_from_cached_decision_ = true;
+  init_proxy_resolver_.reset(new InitProxyResolver());
+  int rv = init_proxy_resolver_->StartSkipDecider(
+      resolver_.get(),
+      it->second.effective_config,
+      OK,
+      it->second.script_data.get(),
+      base::Bind(&ProxyService::OnInitProxyResolverComplete,
+                 base::Unretained(this)));
+
+  if (rv != ERR_IO_PENDING)
+    OnInitProxyResolverComplete(rv);
+  return true;
+}
+
+void ProxyService::UpdateDecisionCache(int result) {
+  DCHECK(init_proxy_resolver_.get());
+  // The decision may have been made while moving between networks, in which
+  // case it can't be attributed to either.
+  if (init_network_identity_.empty() ||
+      init_network_identity_ != GetNetworkIdentity()) {
+    return;
+  }
+
+  if (result != OK) {
+    decision_cache_.erase(init_network_identity_);
+    return;
+  }
+
+  if (decision_cache_.size() >= kMaxCachedDecisions &&
+      decision_cache_.find(init_network_identity_) == decision_cache_.end()) {
+    DecisionCache::iterator oldest = decision_cache_.begin();
+    for (DecisionCache::iterator it = decision_cache_.begin();
+         it != decision_cache_.end(); ++it) {
+      if (it->second.last_used < oldest->second.last_used)
+        oldest = it;
+    }
+    decision_cache_.erase(oldest);
+  }
+
+  CachedDecision& decision = decision_cache_[init_network_identity_];
+  decision.fetched_config = fetched_config_;
+  decision.effective_config = init_proxy_resolver_->effective_config();
+  decision.script_data = init_proxy_resolver_->script_data();
+  decision.last_used = TimeTicks::Now();
+}
+
+std::string ProxyService::GetNetworkIdentity() const {
+  if (!network_identity_callback_.is_null())
+    return network_identity_callback_.Run();
+
+  // The nameservers and search suffixes tell networks apart well enough to
+  // pick a proxy configuration, which is revalidated in any case.
+  DnsConfig dns_config;
+  NetworkChangeNotifier::GetDnsConfig(&dns_config);
+  if (!dns_config.IsValid())
+    return std::string();
+
+  std::string identity = NetworkChangeNotifier::ConnectionTypeToString(
+      NetworkChangeNotifier::GetConnectionType());
+  for (size_t i = 0; i < dns_config.nameservers.size(); ++i)
+    identity += " " + dns_config.nameservers[i].ToString();
+  for (size_t i = 0; i < dns_config.search.size(); ++i)
+    identity += " " + dns_config.search[i];
+  return identity;
+}
+
 void ProxyService::OnIPAddressChanged() {
   // See the comment block by |kDelayAfterNetworkChangesMs| for info.
   stall_proxy_autoconfig_until_ =
@@ -5,6 +5,7 @@
 #ifndef NET_PROXY_PROXY_SERVICE_H_
 #define NET_PROXY_PROXY_SERVICE_H_
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -266,6 +267,15 @@ class NET_EXPORT ProxyService : public NetworkChangeNotifier::IPAddressObserver,
 
   bool quick_check_enabled() const { return quick_check_enabled_; }
 
+  typedef base::Callback<std::string(void)> NetworkIdentityCallback;
+
+  // This method should only be used by unit tests. Overrides how the network
+  // that the machine is attached to is identified, which otherwise is derived
+  // from its DNS configuration.
+  void set_network_identity_callback(const NetworkIdentityCallback& callback) {
+    network_identity_callback_ = callback;
+  }
+
 #if defined(SPDY_PROXY_AUTH_ORIGIN)
   // Values of the UMA DataReductionProxy.BypassInfo{Primary|Fallback}
   // histograms. This enum must remain synchronized with the enum of the same
@@ -311,6 +321,22 @@ class NET_EXPORT ProxyService : public NetworkChangeNotifier::IPAddressObserver,
   // which expects requests to finish in the order they were added.
   typedef std::vector<scoped_refptr<PacRequest> > PendingRequests;
 
+  // The outcome of proxy auto-config on a network, which is applied straight
+  // away when reconnecting to that network.
+  struct CachedDecision {
+    CachedDecision();
+    ~CachedDecision();
+
+    // The settings the decision was made for.
+    ProxyConfig fetched_config;
+    ProxyConfig effective_config;
+    scoped_refptr<ProxyResolverScriptData> script_data;
+    base::TimeTicks last_used;
+  };
+
+  // Maps network identities to the decision last made on that network.
+  typedef std::map<std::string, CachedDecision> DecisionCache;
+
   enum State {
     STATE_NONE,
     STATE_WAITING_FOR_PROXY_CONFIG,
@@ -363,6 +389,18 @@ class NET_EXPORT ProxyService : public NetworkChangeNotifier::IPAddressObserver,
   // Start initialization using |fetched_config_|.
   void InitializeUsingLastFetchedConfig();
 
+  // Starts initializing using a decision cached for the current network, if
+  // any. Returns false if there is none.
+  bool InitializeUsingCachedDecision();
+
+  // Remembers the outcome |result| of initializing the ProxyResolver as the
+  // decision for |init_network_identity_|.
+  void UpdateDecisionCache(int result);
+
+  // Returns a string identifying the network the machine is attached to, or
+  // an empty string if it can't be told apart from other networks.
+  std::string GetNetworkIdentity() const;
+
   // Start the initialization skipping past the "decision" phase.
   void InitializeUsingDecidedConfig(
       int decider_result,
@@ -444,6 +482,17 @@ class NET_EXPORT ProxyService : public NetworkChangeNotifier::IPAddressObserver,
   // Whether child ProxyScriptDeciders should use QuickCheck
   bool quick_check_enabled_;
 
+  // Proxy auto-config decisions for the networks seen recently, so that
+  // switching back to one of them doesn't wait on PAC and WPAD fetches again.
+  DecisionCache decision_cache_;
+
+  // The network |init_proxy_resolver_| was started on, and whether it is
+  // applying a decision from |decision_cache_|.
+  std::string init_network_identity_;
+  bool init_from_cached_decision_;
+
+  NetworkIdentityCallback network_identity_callback_;
+
   DISALLOW_COPY_AND_ASSIGN(ProxyService);
 };
 
@@ -0,0 +1,306 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/quic/congestion_control/bbr_sender.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "net/quic/congestion_control/rtt_stats.h"
+
+using std::max;
+
+namespace net {
+
+namespace {
+// The gain used in STARTUP, 2/ln(2), is the smallest which doubles the
+// sending rate every round trip.
+const float kStartupGain = 2.885f;
+// The gain used in DRAIN drains the queue built by STARTUP in a round trip.
+const float kDrainGain = 1 / kStartupGain;
+// The congestion window leaves room for delayed and aggregated acks.
+const float kCongestionWindowGain = 2.0f;
+// The pacing gains of PROBE_BW, each used for a minimum RTT: probe for more
+// bandwidth, drain the queue the probe built, then cruise.
+const float kPacingGainCycle[] = { 1.25f, 0.75f, 1, 1, 1, 1, 1, 1 };
+// PROBE_BW starts cruising.
+const size_t kInitialCycleIndex = 2;
+// STARTUP ends when the bandwidth estimate has grown by less than 25% for
+// three round trips in a row.
+const float kStartupGrowthTarget = 1.25f;
+const int64 kRoundTripsWithoutGrowthBeforeExitingStartup = 3;
+const QuicByteCount kMinimumCongestionWindow = 4 * kMaxPacketSize;
+const QuicByteCount kInitialCongestionWindow = 10 * kMaxPacketSize;
+// Packets are sent as long as they are due within this delay, since the
+// alarm which sends them is not more precise.
+const int64 kPacingGranularityMs = 1;
+}  // namespace
+
+BbrSender::BbrSender(const QuicClock* clock, const RttStats* rtt_stats)
+    : clock_(clock),
+      rtt_stats_(rtt_stats),
+      mode_(STARTUP),
+      bytes_in_flight_(0),
+      delivered_(0),
+      delivered_time_(QuicTime::Zero()),
+      round_trip_count_(0),
+      largest_sent_sequence_number_(0),
+      current_round_trip_end_(0),
+      bandwidth_samples_(kBandwidthWindowRoundTrips,
+                         BandwidthSample(-1, QuicBandwidth::Zero())),
+      startup_bandwidth_(QuicBandwidth::Zero()),
+      rounds_without_bandwidth_growth_(0),
+      last_checked_round_(0),
+      cycle_index_(kInitialCycleIndex),
+      cycle_start_time_(QuicTime::Zero()),
+      next_send_time_(QuicTime::Zero()),
+      initial_congestion_window_(kInitialCongestionWindow) {
+}
+
+BbrSender::~BbrSender() {}
+
+void BbrSender::SetFromConfig(const QuicConfig& config, bool is_server) {
+  if (is_server) {
+    // Set the initial window size.
+    initial_congestion_window_ =
+        config.server_initial_congestion_window() * kMaxPacketSize;
+  }
+}
+
+void BbrSender::OnIncomingQuicCongestionFeedbackFrame(
+    const QuicCongestionFeedbackFrame& /*feedback*/,
+    QuicTime /*feedback_receive_time*/) {
+  // The model is built from acks only.
+}
+
+void BbrSender::OnPacketAcked(QuicPacketSequenceNumber acked_sequence_number,
+                              QuicByteCount /*acked_bytes*/) {
+  SentPacketMap::iterator it = sent_packets_.find(acked_sequence_number);
+  if (it == sent_packets_.end()) {
+    // Sent before this sender was in use.
+    return;
+  }
+  const SentPacket& packet = it->second;
+  QuicTime now = clock_->Now();
+  bytes_in_flight_ -= packet.bytes;
+  delivered_ += packet.bytes;
+  delivered_time_ = now;
+
+  if (acked_sequence_number > current_round_trip_end_) {
+    ++round_trip_count_;
+    current_round_trip_end_ = largest_sent_sequence_number_;
+  }
+
+  // The delivery rate is the data acked since this packet was sent, over
+  // the time it took.
+  QuicTime::Delta interval = now.Subtract(packet.delivered_time);
+  if (!interval.IsZero()) {
+    UpdateBandwidthFilter(QuicBandwidth::FromBytesAndTimeDelta(
+        delivered_ - packet.delivered, interval));
+  }
+  sent_packets_.erase(it);
+
+  MaybeUpdateMode(now);
+}
+
+void BbrSender::OnPacketLost(QuicPacketSequenceNumber /*sequence_number*/,
+                             QuicTime /*ack_receive_time*/) {
+  // Losses do not change the model. The lost packet is abandoned next.
+}
+
+bool BbrSender::OnPacketSent(QuicTime sent_time,
+                             QuicPacketSequenceNumber sequence_number,
+                             QuicByteCount bytes,
+                             TransmissionType /*transmission_type*/,
+                             HasRetransmittableData is_retransmittable) {
+  // Only data packets are congestion controlled.
+  if (is_retransmittable != HAS_RETRANSMITTABLE_DATA) {
+    return false;
+  }
+
+  // Idle time does not count in the delivery rate.
+  if (bytes_in_flight_ == 0) {
+    delivered_time_ = sent_time;
+  }
+  sent_packets_.insert(std::make_pair(
+      sequence_number, SentPacket(bytes, delivered_, delivered_time_)));
+  bytes_in_flight_ += bytes;
+  largest_sent_sequence_number_ =
+      max(largest_sent_sequence_number_, sequence_number);
+
+  next_send_time_ = QuicTime::Max(next_send_time_, sent_time).Add(
+      PacingRate().TransferTime(bytes));
+  return true;
+}
+
+void BbrSender::OnRetransmissionTimeout(bool packets_retransmitted) {
+  sent_packets_.clear();
+  bytes_in_flight_ = 0;
+  if (packets_retransmitted) {
+    // The path changed too much for the model to be of use, so rebuild it.
+    mode_ = STARTUP;
+    bandwidth_samples_.assign(kBandwidthWindowRoundTrips,
+                              BandwidthSample(-1, QuicBandwidth::Zero()));
+    startup_bandwidth_ = QuicBandwidth::Zero();
+    rounds_without_bandwidth_growth_ = 0;
+  }
+}
+
+void BbrSender::OnPacketAbandoned(QuicPacketSequenceNumber sequence_number,
+                                  QuicByteCount /*abandoned_bytes*/) {
+  SentPacketMap::iterator it = sent_packets_.find(sequence_number);
+  if (it == sent_packets_.end()) {
+    return;
+  }
+  bytes_in_flight_ -= it->second.bytes;
+  sent_packets_.erase(it);
+}
+
+QuicTime::Delta BbrSender::TimeUntilSend(
+    QuicTime now,
+    TransmissionType transmission_type,
+    HasRetransmittableData has_retransmittable_data,
+    IsHandshake handshake) {
+  if (transmission_type == TLP_RETRANSMISSION ||
+      transmission_type == HANDSHAKE_RETRANSMISSION ||
+      has_retransmittable_data == NO_RETRANSMITTABLE_DATA ||
+      handshake == IS_HANDSHAKE) {
+    // Like TcpCubicSender, always send ACKs, handshake packets and tail loss
+    // probes immediately.
+    return QuicTime::Delta::Zero();
+  }
+  if (bytes_in_flight_ >= GetCongestionWindow()) {
+    return QuicTime::Delta::Infinite();
+  }
+  QuicTime send_deadline =
+      now.Add(QuicTime::Delta::FromMilliseconds(kPacingGranularityMs));
+  if (next_send_time_ <= send_deadline) {
+    return QuicTime::Delta::Zero();
+  }
+  return next_send_time_.Subtract(now);
+}
+
+QuicBandwidth BbrSender::BandwidthEstimate() const {
+  QuicBandwidth bandwidth = QuicBandwidth::Zero();
+  for (size_t i = 0; i < bandwidth_samples_.size(); ++i) {
+    const BandwidthSample& sample = bandwidth_samples_[i];
+    if (sample.round_trip >= 0 &&
+        sample.round_trip + kBandwidthWindowRoundTrips > round_trip_count_ &&
+        sample.bandwidth > bandwidth) {
+      bandwidth = sample.bandwidth;
+    }
+  }
+  return bandwidth;
+}
+
+QuicBandwidth BbrSender::PacingRate() const {
+  QuicBandwidth bandwidth = BandwidthEstimate();
+  if (bandwidth.IsZero()) {
+    // Before any sample, pace the initial window over the initial RTT.
+    bandwidth = QuicBandwidth::FromBytesAndTimeDelta(
+        initial_congestion_window_, rtt_stats_->SmoothedRtt());
+  }
+  switch (mode_) {
+    case STARTUP:
+      return bandwidth.Scale(kStartupGain);
+    case DRAIN:
+      return bandwidth.Scale(kDrainGain);
+    case PROBE_BW:
+      return bandwidth.Scale(kPacingGainCycle[cycle_index_]);
+  }
+  NOTREACHED();
+  return bandwidth;
+}
+
+void BbrSender::UpdateRtt(QuicTime::Delta /*rtt_sample*/) {
+  // The minimum RTT is read from |rtt_stats_|.
+}
+
+QuicTime::Delta BbrSender::RetransmissionDelay() const {
+  if (!rtt_stats_->HasUpdates()) {
+    return QuicTime::Delta::Zero();
+  }
+  return QuicTime::Delta::FromMicroseconds(
+      rtt_stats_->SmoothedRtt().ToMicroseconds() +
+      4 * rtt_stats_->mean_deviation().ToMicroseconds());
+}
+
+QuicByteCount BbrSender::GetCongestionWindow() const {
+  if (BandwidthEstimate().IsZero()) {
+    return initial_congestion_window_;
+  }
+  return TargetCongestionWindow(mode_ == STARTUP ? kStartupGain
+                                                 : kCongestionWindowGain);
+}
+
+QuicTime::Delta BbrSender::MinRtt() const {
+  if (rtt_stats_->min_rtt().IsZero()) {
+    return rtt_stats_->SmoothedRtt();
+  }
+  return rtt_stats_->min_rtt();
+}
+
+QuicByteCount BbrSender::TargetCongestionWindow(float gain) const {
+  QuicByteCount bandwidth_delay_product =
+      BandwidthEstimate().ToBytesPerPeriod(MinRtt());
+  return max(static_cast<QuicByteCount>(gain * bandwidth_delay_product),
+             kMinimumCongestionWindow);
+}
+
+void BbrSender::UpdateBandwidthFilter(QuicBandwidth sample) {
+  BandwidthSample& current =
+      bandwidth_samples_[round_trip_count_ % kBandwidthWindowRoundTrips];
+  if (current.round_trip != round_trip_count_) {
+    current = BandwidthSample(round_trip_count_, sample);
+  } else if (sample > current.bandwidth) {
+    current.bandwidth = sample;
+  }
+}
+
+void BbrSender::MaybeUpdateMode(QuicTime now) {
+  switch (mode_) {
+    case STARTUP:
+      if (round_trip_count_ == last_checked_round_) {
+        return;
+      }
+      last_checked_round_ = round_trip_count_;
+      if (BandwidthEstimate() >=
+              startup_bandwidth_.Scale(kStartupGrowthTarget)) {
+        startup_bandwidth_ = BandwidthEstimate();
+        rounds_without_bandwidth_growth_ = 0;
+        return;
+      }
+      if (++rounds_without_bandwidth_growth_ <
+              kRoundTripsWithoutGrowthBeforeExitingStartup) {
+        return;
+      }
+      DVLOG(1) << "Exiting STARTUP; bandwidth estimate: "
+               << BandwidthEstimate().ToKBitsPerSecond() << " kbps";
+      mode_ = DRAIN;
+      // Fall through, the queue may be empty already.
+    case DRAIN:
+      if (bytes_in_flight_ > TargetCongestionWindow(1)) {
+        return;
+      }
+      mode_ = PROBE_BW;
+      cycle_index_ = kInitialCycleIndex;
+      cycle_start_time_ = now;
+      return;
+    case PROBE_BW: {
+      float gain = kPacingGainCycle[cycle_index_];
+      bool cycle_done = now.Subtract(cycle_start_time_) > MinRtt();
+      // Stop draining as soon as the queue is gone.
+      if (gain < 1 && bytes_in_flight_ <= TargetCongestionWindow(1)) {
+        cycle_done = true;
+      }
+      if (cycle_done) {
+        cycle_index_ = (cycle_index_ + 1) % arraysize(kPacingGainCycle);
+        cycle_start_time_ = now;
+      }
+      return;
+    }
+  }
+}
+
+}  // namespace net
@@ -0,0 +1,174 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// Model based send side congestion algorithm, in the style of BBR. It
+// estimates the bottleneck bandwidth from the delivery rate of the acked
+// packets and the minimum RTT from RttStats, and paces packets out at the
+// estimated bandwidth, keeping about one bandwidth-delay product in flight,
+// instead of backing off on every loss.
+
+#ifndef NET_QUIC_CONGESTION_CONTROL_BBR_SENDER_H_
+#define NET_QUIC_CONGESTION_CONTROL_BBR_SENDER_H_
+
+#include <map>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/compiler_specific.h"
+#include "net/base/net_export.h"
+#include "net/quic/congestion_control/send_algorithm_interface.h"
+#include "net/quic/quic_bandwidth.h"
+#include "net/quic/quic_protocol.h"
+#include "net/quic/quic_time.h"
+
+namespace net {
+
+class RttStats;
+
+namespace test {
+class BbrSenderPeer;
+}  // namespace test
+
+class NET_EXPORT_PRIVATE BbrSender : public SendAlgorithmInterface {
+ public:
+  enum Mode {
+    // Doubles the sending rate every round trip, until the bandwidth estimate
+    // stops growing.
+    STARTUP,
+    // Sends below the estimated bandwidth, to drain the queue built during
+    // STARTUP.
+    DRAIN,
+    // Sends at the estimated bandwidth, probing for more once per cycle.
+    PROBE_BW,
+  };
+
+  enum {
+    // The bandwidth estimate is the maximum delivery rate sampled over this
+    // many round trips.
+    kBandwidthWindowRoundTrips = 10,
+  };
+
+  BbrSender(const QuicClock* clock, const RttStats* rtt_stats);
+  virtual ~BbrSender();
+
+  // Start implementation of SendAlgorithmInterface.
+  virtual void SetFromConfig(const QuicConfig& config, bool is_server) OVERRIDE;
+  virtual void OnIncomingQuicCongestionFeedbackFrame(
+      const QuicCongestionFeedbackFrame& feedback,
+      QuicTime feedback_receive_time) OVERRIDE;
+  virtual void OnPacketAcked(QuicPacketSequenceNumber acked_sequence_number,
+                             QuicByteCount acked_bytes) OVERRIDE;
+  virtual void OnPacketLost(QuicPacketSequenceNumber sequence_number,
+                            QuicTime ack_receive_time) OVERRIDE;
+  virtual bool OnPacketSent(QuicTime sent_time,
+                            QuicPacketSequenceNumber sequence_number,
+                            QuicByteCount bytes,
+                            TransmissionType transmission_type,
+                            HasRetransmittableData is_retransmittable) OVERRIDE;
+  virtual void OnRetransmissionTimeout(bool packets_retransmitted) OVERRIDE;
+  virtual void OnPacketAbandoned(QuicPacketSequenceNumber sequence_number,
+                                 QuicByteCount abandoned_bytes) OVERRIDE;
+  virtual QuicTime::Delta TimeUntilSend(
+      QuicTime now,
+      TransmissionType transmission_type,
+      HasRetransmittableData has_retransmittable_data,
+      IsHandshake handshake) OVERRIDE;
+  virtual QuicBandwidth BandwidthEstimate() const OVERRIDE;
+  virtual void UpdateRtt(QuicTime::Delta rtt_sample) OVERRIDE;
+  virtual QuicTime::Delta RetransmissionDelay() const OVERRIDE;
+  virtual QuicByteCount GetCongestionWindow() const OVERRIDE;
+  // End implementation of SendAlgorithmInterface.
+
+  Mode mode() const { return mode_; }
+
+  // The rate packets are currently paced at.
+  QuicBandwidth PacingRate() const;
+
+ private:
+  friend class test::BbrSenderPeer;
+
+  // The state of the connection when a packet was sent, from which the
+  // delivery rate is sampled when the packet is acked.
+  struct SentPacket {
+    SentPacket(QuicByteCount bytes,
+               QuicByteCount delivered,
+               QuicTime delivered_time)
+        : bytes(bytes), delivered(delivered), delivered_time(delivered_time) {}
+
+    QuicByteCount bytes;
+    QuicByteCount delivered;
+    QuicTime delivered_time;
+  };
+  typedef std::map<QuicPacketSequenceNumber, SentPacket> SentPacketMap;
+
+  // The maximum delivery rate sampled during a round trip.
+  struct BandwidthSample {
+    BandwidthSample(int64 round_trip, QuicBandwidth bandwidth)
+        : round_trip(round_trip), bandwidth(bandwidth) {}
+
+    int64 round_trip;
+    QuicBandwidth bandwidth;
+  };
+
+  // Returns the minimum RTT, or the smoothed RTT before any RTT sample.
+  QuicTime::Delta MinRtt() const;
+
+  // Returns |gain| times the estimated bandwidth-delay product, and at least
+  // the minimum congestion window.
+  QuicByteCount TargetCongestionWindow(float gain) const;
+
+  // Records the delivery rate |sample|, measured during round trip
+  // |round_trip_count_|, in the windowed maximum filter.
+  void UpdateBandwidthFilter(QuicBandwidth sample);
+
+  // Moves on to the next mode, or the next gain of the probing cycle, once
+  // the current one is done.
+  void MaybeUpdateMode(QuicTime now);
+
+  const QuicClock* clock_;
+  const RttStats* rtt_stats_;
+
+  Mode mode_;
+
+  // The packets sent and not yet acked, lost or abandoned.
+  SentPacketMap sent_packets_;
+  QuicByteCount bytes_in_flight_;
+
+  // Total bytes acked so far, and when the last of them was.
+  QuicByteCount delivered_;
+  QuicTime delivered_time_;
+
+  // Round trips are counted by the acks of packets which were sent after the
+  // start of the current round trip.
+  int64 round_trip_count_;
+  QuicPacketSequenceNumber largest_sent_sequence_number_;
+  QuicPacketSequenceNumber current_round_trip_end_;
+
+  // The samples of the last kBandwidthWindowRoundTrips round trips, indexed
+  // by round trip count modulo kBandwidthWindowRoundTrips.
+  std::vector<BandwidthSample> bandwidth_samples_;
+
+  // For STARTUP: the bandwidth estimate at the last time it grew enough, and
+  // the number of round trips since then.
+  QuicBandwidth startup_bandwidth_;
+  int64 rounds_without_bandwidth_growth_;
+  int64 last_checked_round_;
+
+  // For PROBE_BW: the current index into the cycle of pacing gains, and when
+  // it started.
+  size_t cycle_index_;
+  QuicTime cycle_start_time_;
+
+  // When the next packet may be sent, for pacing.
+  QuicTime next_send_time_;
+
+  // The congestion window used before any bandwidth sample.
+  QuicByteCount initial_congestion_window_;
+
+  DISALLOW_COPY_AND_ASSIGN(BbrSender);
+};
+
+}  // namespace net
+
+#endif  // NET_QUIC_CONGESTION_CONTROL_BBR_SENDER_H_
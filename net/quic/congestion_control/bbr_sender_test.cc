@@ -0,0 +1,301 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/quic/congestion_control/bbr_sender.h"
+
+#include <deque>
+
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "net/quic/congestion_control/rtt_stats.h"
+#include "net/quic/congestion_control/tcp_cubic_sender.h"
+#include "net/quic/quic_connection_stats.h"
+#include "net/quic/test_tools/mock_clock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+namespace test {
+
+const QuicByteCount kPacketSize = kDefaultTCPMSS;
+
+class BbrSenderPeer : public BbrSender {
+ public:
+  explicit BbrSenderPeer(const QuicClock* clock)
+      : BbrSender(clock, &rtt_stats_) {
+  }
+
+  QuicByteCount bytes_in_flight() const {
+    return bytes_in_flight_;
+  }
+
+  RttStats rtt_stats_;
+};
+
+// A bottleneck link with a buffer deep enough never to drop a packet, and a
+// fixed propagation delay. Packets are acked one by one as they come out of
+// the link.
+class BottleneckLink {
+ public:
+  struct Result {
+    Result() : bytes_delivered(0), rtt_samples(0),
+               total_rtt(QuicTime::Delta::Zero()) {}
+
+    QuicTime::Delta AverageRtt() const {
+      return QuicTime::Delta::FromMicroseconds(
+          total_rtt.ToMicroseconds() / rtt_samples);
+    }
+
+    QuicByteCount bytes_delivered;
+    int64 rtt_samples;
+    QuicTime::Delta total_rtt;
+  };
+
+  BottleneckLink(QuicBandwidth bandwidth, QuicTime::Delta min_rtt)
+      : bandwidth_(bandwidth),
+        min_rtt_(min_rtt) {
+  }
+
+  // Runs a bulk transfer by |sender| for |duration|, and measures the
+  // throughput and the RTT after |warmup|.
+  Result Run(MockClock* clock,
+             SendAlgorithmInterface* sender,
+             RttStats* rtt_stats,
+             QuicTime::Delta warmup,
+             QuicTime::Delta duration) {
+    Result result;
+    QuicTime start = clock->Now();
+    QuicTime end = start.Add(duration);
+    QuicTime link_free_time = start;
+    QuicPacketSequenceNumber sequence_number = 1;
+    std::deque<InFlightPacket> in_flight;
+
+    while (clock->Now() < end) {
+      QuicTime now = clock->Now();
+      QuicTime::Delta delay = sender->TimeUntilSend(
+          now, NOT_RETRANSMISSION, HAS_RETRANSMITTABLE_DATA, NOT_HANDSHAKE);
+      while (delay.IsZero()) {
+        sender->OnPacketSent(now, sequence_number, kPacketSize,
+                             NOT_RETRANSMISSION, HAS_RETRANSMITTABLE_DATA);
+        link_free_time = QuicTime::Max(now, link_free_time).Add(
+            bandwidth_.TransferTime(kPacketSize));
+        InFlightPacket packet = { sequence_number, now,
+                                  link_free_time.Add(min_rtt_) };
+        in_flight.push_back(packet);
+        ++sequence_number;
+        delay = sender->TimeUntilSend(
+            now, NOT_RETRANSMISSION, HAS_RETRANSMITTABLE_DATA, NOT_HANDSHAKE);
+      }
+
+      QuicTime next_event = end;
+      if (!delay.IsInfinite() && now.Add(delay) < next_event) {
+        next_event = now.Add(delay);
+      }
+      if (!in_flight.empty() && in_flight.front().ack_time < next_event) {
+        next_event = in_flight.front().ack_time;
+      }
+      clock->AdvanceTime(next_event.Subtract(now));
+
+      while (!in_flight.empty() &&
+             in_flight.front().ack_time <= clock->Now()) {
+        const InFlightPacket& packet = in_flight.front();
+        QuicTime::Delta rtt = clock->Now().Subtract(packet.sent_time);
+        rtt_stats->UpdateRtt(rtt, QuicTime::Delta::Zero());
+        sender->UpdateRtt(rtt);
+        sender->OnPacketAcked(packet.sequence_number, kPacketSize);
+        if (packet.sent_time.Subtract(start) >= warmup) {
+          result.bytes_delivered += kPacketSize;
+          ++result.rtt_samples;
+          result.total_rtt = result.total_rtt.Add(rtt);
+        }
+        in_flight.pop_front();
+      }
+    }
+    return result;
+  }
+
+ private:
+  struct InFlightPacket {
+    QuicPacketSequenceNumber sequence_number;
+    QuicTime sent_time;
+    QuicTime ack_time;
+  };
+
+  const QuicBandwidth bandwidth_;
+  const QuicTime::Delta min_rtt_;
+};
+
+class BbrSenderTest : public ::testing::Test {
+ protected:
+  BbrSenderTest()
+      : sender_(new BbrSenderPeer(&clock_)),
+        sequence_number_(1),
+        acked_sequence_number_(0) {
+    clock_.AdvanceTime(QuicTime::Delta::FromMilliseconds(1));
+  }
+
+  void SendPacket() {
+    sender_->OnPacketSent(clock_.Now(), sequence_number_++, kPacketSize,
+                          NOT_RETRANSMISSION, HAS_RETRANSMITTABLE_DATA);
+  }
+
+  bool CanSend() {
+    return sender_->TimeUntilSend(clock_.Now(), NOT_RETRANSMISSION,
+                                  HAS_RETRANSMITTABLE_DATA,
+                                  NOT_HANDSHAKE).IsZero();
+  }
+
+  void AckPacket(QuicTime::Delta rtt) {
+    sender_->rtt_stats_.UpdateRtt(rtt, QuicTime::Delta::Zero());
+    sender_->UpdateRtt(rtt);
+    sender_->OnPacketAcked(++acked_sequence_number_, kPacketSize);
+  }
+
+  MockClock clock_;
+  scoped_ptr<BbrSenderPeer> sender_;
+  QuicPacketSequenceNumber sequence_number_;
+  QuicPacketSequenceNumber acked_sequence_number_;
+};
+
+TEST_F(BbrSenderTest, PacesInitialWindow) {
+  EXPECT_EQ(BbrSender::STARTUP, sender_->mode());
+  EXPECT_TRUE(sender_->BandwidthEstimate().IsZero());
+  EXPECT_EQ(10 * kMaxPacketSize, sender_->GetCongestionWindow());
+
+  // The initial window is paced out over the initial RTT, sped up by the
+  // startup gain, rather than sent in a burst.
+  EXPECT_TRUE(CanSend());
+  SendPacket();
+  QuicTime::Delta delay = sender_->TimeUntilSend(
+      clock_.Now(), NOT_RETRANSMISSION, HAS_RETRANSMITTABLE_DATA,
+      NOT_HANDSHAKE);
+  EXPECT_FALSE(delay.IsZero());
+  EXPECT_FALSE(delay.IsInfinite());
+  EXPECT_EQ(sender_->PacingRate().TransferTime(kPacketSize), delay);
+
+  // Acks and handshake packets are never held back.
+  EXPECT_TRUE(sender_->TimeUntilSend(clock_.Now(), NOT_RETRANSMISSION,
+                                     NO_RETRANSMITTABLE_DATA,
+                                     NOT_HANDSHAKE).IsZero());
+  EXPECT_TRUE(sender_->TimeUntilSend(clock_.Now(), NOT_RETRANSMISSION,
+                                     HAS_RETRANSMITTABLE_DATA,
+                                     IS_HANDSHAKE).IsZero());
+
+  clock_.AdvanceTime(delay);
+  EXPECT_TRUE(CanSend());
+}
+
+TEST_F(BbrSenderTest, OnlyRetransmittablePacketsAreInFlight) {
+  EXPECT_FALSE(sender_->OnPacketSent(clock_.Now(), 1, kPacketSize,
+                                     NOT_RETRANSMISSION,
+                                     NO_RETRANSMITTABLE_DATA));
+  EXPECT_EQ(0u, sender_->bytes_in_flight());
+  EXPECT_TRUE(sender_->OnPacketSent(clock_.Now(), 2, kPacketSize,
+                                    NOT_RETRANSMISSION,
+                                    HAS_RETRANSMITTABLE_DATA));
+  EXPECT_EQ(kPacketSize, sender_->bytes_in_flight());
+  sender_->OnPacketAbandoned(2, kPacketSize);
+  EXPECT_EQ(0u, sender_->bytes_in_flight());
+}
+
+TEST_F(BbrSenderTest, BandwidthSampledFromDeliveryRate) {
+  const QuicTime::Delta kRtt = QuicTime::Delta::FromMilliseconds(100);
+  for (int i = 0; i < 10; ++i) {
+    SendPacket();
+  }
+  // The ten packets are delivered 10ms apart, one every 10ms.
+  clock_.AdvanceTime(kRtt);
+  AckPacket(kRtt);
+  for (int i = 1; i < 10; ++i) {
+    clock_.AdvanceTime(QuicTime::Delta::FromMilliseconds(10));
+    AckPacket(kRtt);
+  }
+  EXPECT_EQ(0u, sender_->bytes_in_flight());
+  // The first sample covers the whole RTT, the last ones only the ten
+  // packets acked within the last 190ms.
+  EXPECT_EQ(QuicBandwidth::FromBytesAndTimeDelta(
+                10 * kPacketSize, QuicTime::Delta::FromMilliseconds(190)),
+            sender_->BandwidthEstimate());
+  EXPECT_EQ(static_cast<QuicByteCount>(
+                2.885f * sender_->BandwidthEstimate().ToBytesPerPeriod(kRtt)),
+            sender_->GetCongestionWindow());
+}
+
+TEST_F(BbrSenderTest, RetransmissionTimeoutRestartsStartup) {
+  QuicBandwidth kBandwidth = QuicBandwidth::FromKBitsPerSecond(10000);
+  BottleneckLink link(kBandwidth, QuicTime::Delta::FromMilliseconds(100));
+  link.Run(&clock_, sender_.get(), &sender_->rtt_stats_,
+           QuicTime::Delta::Zero(), QuicTime::Delta::FromSeconds(5));
+  EXPECT_EQ(BbrSender::PROBE_BW, sender_->mode());
+  EXPECT_FALSE(sender_->BandwidthEstimate().IsZero());
+
+  // An RTO without retransmissions keeps the model.
+  sender_->OnRetransmissionTimeout(false);
+  EXPECT_EQ(BbrSender::PROBE_BW, sender_->mode());
+  EXPECT_EQ(0u, sender_->bytes_in_flight());
+
+  sender_->OnRetransmissionTimeout(true);
+  EXPECT_EQ(BbrSender::STARTUP, sender_->mode());
+  EXPECT_TRUE(sender_->BandwidthEstimate().IsZero());
+}
+
+TEST_F(BbrSenderTest, ConvergesToBottleneckBandwidth) {
+  QuicBandwidth kBandwidth = QuicBandwidth::FromKBitsPerSecond(10000);
+  const QuicTime::Delta kMinRtt = QuicTime::Delta::FromMilliseconds(100);
+  BottleneckLink link(kBandwidth, kMinRtt);
+  BottleneckLink::Result result =
+      link.Run(&clock_, sender_.get(), &sender_->rtt_stats_,
+               QuicTime::Delta::FromSeconds(5),
+               QuicTime::Delta::FromSeconds(20));
+
+  EXPECT_EQ(BbrSender::PROBE_BW, sender_->mode());
+  EXPECT_LE(kBandwidth.Scale(0.95f), sender_->BandwidthEstimate());
+  EXPECT_GE(kBandwidth.Scale(1.05f), sender_->BandwidthEstimate());
+  // The link is kept busy, with a short queue.
+  EXPECT_LE(kBandwidth.Scale(0.95f).ToBytesPerPeriod(
+                QuicTime::Delta::FromSeconds(15)),
+            result.bytes_delivered);
+  EXPECT_GT(kMinRtt.Multiply(1.5), result.AverageRtt());
+}
+
+// Compares the senders on a link with a deep buffer: both fill the link, but
+// TCP cubic fills the buffer as well, until its congestion window is maxed
+// out, while BbrSender keeps the queue short.
+TEST_F(BbrSenderTest, ShorterQueueThanCubicOnDeepBuffer) {
+  QuicBandwidth kBandwidth = QuicBandwidth::FromKBitsPerSecond(10000);
+  const QuicTime::Delta kMinRtt = QuicTime::Delta::FromMilliseconds(100);
+  const QuicTime::Delta kWarmup = QuicTime::Delta::FromSeconds(5);
+  const QuicTime::Delta kDuration = QuicTime::Delta::FromSeconds(20);
+  BottleneckLink link(kBandwidth, kMinRtt);
+
+  BottleneckLink::Result bbr_result = link.Run(
+      &clock_, sender_.get(), &sender_->rtt_stats_, kWarmup, kDuration);
+
+  MockClock cubic_clock;
+  cubic_clock.AdvanceTime(QuicTime::Delta::FromMilliseconds(1));
+  RttStats cubic_rtt_stats;
+  QuicConnectionStats cubic_stats;
+  // About four bandwidth-delay products.
+  const QuicTcpCongestionWindow kMaxCongestionWindow = 400;
+  TcpCubicSender cubic(&cubic_clock, &cubic_rtt_stats, false,
+                       kMaxCongestionWindow, &cubic_stats);
+  // Large enough for the receive window not to limit the sender.
+  QuicCongestionFeedbackFrame feedback;
+  feedback.type = kTCP;
+  feedback.tcp.receive_window = kMaxCongestionWindow * kDefaultTCPMSS;
+  cubic.OnIncomingQuicCongestionFeedbackFrame(feedback, cubic_clock.Now());
+  BottleneckLink::Result cubic_result = link.Run(
+      &cubic_clock, &cubic, &cubic_rtt_stats, kWarmup, kDuration);
+
+  DVLOG(1) << "BBR: " << bbr_result.bytes_delivered << " bytes, "
+           << bbr_result.AverageRtt().ToMilliseconds() << "ms average RTT";
+  DVLOG(1) << "Cubic: " << cubic_result.bytes_delivered << " bytes, "
+           << cubic_result.AverageRtt().ToMilliseconds() << "ms average RTT";
+  EXPECT_LE(cubic_result.bytes_delivered * 95 / 100,
+            bbr_result.bytes_delivered);
+  EXPECT_GT(cubic_result.AverageRtt().ToMicroseconds() / 2,
+            bbr_result.AverageRtt().ToMicroseconds());
+}
+
+}  // namespace test
+}  // namespace net
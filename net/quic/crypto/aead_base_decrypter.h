@@ -50,6 +50,11 @@ class NET_EXPORT_PRIVATE AeadBaseDecrypter : public QuicDecrypter {
   virtual QuicData* DecryptPacket(QuicPacketSequenceNumber sequence_number,
                                   base::StringPiece associated_data,
                                   base::StringPiece ciphertext) OVERRIDE;
+  virtual bool DecryptPacketIntoBuffer(QuicPacketSequenceNumber sequence_number,
+                                       base::StringPiece associated_data,
+                                       base::StringPiece ciphertext,
+                                       char* output,
+                                       size_t* output_length) OVERRIDE;
   virtual base::StringPiece GetKey() const OVERRIDE;
   virtual base::StringPiece GetNoncePrefix() const OVERRIDE;
 
@@ -49,6 +49,10 @@ class NET_EXPORT_PRIVATE AeadBaseEncrypter : public QuicEncrypter {
   virtual QuicData* EncryptPacket(QuicPacketSequenceNumber sequence_number,
                                   base::StringPiece associated_data,
                                   base::StringPiece plaintext) OVERRIDE;
+  virtual bool EncryptPacketIntoBuffer(QuicPacketSequenceNumber sequence_number,
+                                       base::StringPiece associated_data,
+                                       base::StringPiece plaintext,
+                                       char* output) OVERRIDE;
   virtual size_t GetKeySize() const OVERRIDE;
   virtual size_t GetNoncePrefixSize() const OVERRIDE;
   virtual size_t GetMaxPlaintextSize(size_t ciphertext_size) const OVERRIDE;
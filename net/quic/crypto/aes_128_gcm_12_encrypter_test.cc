@@ -4,6 +4,7 @@
 
 #include "net/quic/crypto/aes_128_gcm_12_encrypter.h"
 
+#include "net/quic/crypto/aes_128_gcm_12_decrypter.h"
 #include "net/quic/test_tools/quic_test_utils.h"
 
 using base::StringPiece;
@@ -291,5 +292,42 @@ TEST(Aes128Gcm12EncrypterTest, GetCiphertextSize) {
   EXPECT_EQ(22u, encrypter.GetCiphertextSize(10));
 }
 
+TEST(Aes128Gcm12EncrypterTest, EncryptPacketIntoBuffer) {
+  string key(16, 'k');
+  string nonce_prefix(4, 'n');
+  string associated_data("associated data");
+  string plaintext(1000, 'p');
+  const QuicPacketSequenceNumber kSequenceNumber = 42;
+
+  Aes128Gcm12Encrypter encrypter;
+  ASSERT_TRUE(encrypter.SetKey(key));
+  ASSERT_TRUE(encrypter.SetNoncePrefix(nonce_prefix));
+  scoped_ptr<QuicData> encrypted(
+      encrypter.EncryptPacket(kSequenceNumber, associated_data, plaintext));
+  ASSERT_TRUE(encrypted.get());
+
+  // Encrypting straight into a buffer gives the same ciphertext.
+  size_t ciphertext_size = encrypter.GetCiphertextSize(plaintext.length());
+  ASSERT_EQ(ciphertext_size, encrypted->length());
+  scoped_ptr<char[]> ciphertext(new char[ciphertext_size]);
+  ASSERT_TRUE(encrypter.EncryptPacketIntoBuffer(
+      kSequenceNumber, associated_data, plaintext, ciphertext.get()));
+  test::CompareCharArraysWithHexError("ciphertext", ciphertext.get(),
+                                      ciphertext_size, encrypted->data(),
+                                      encrypted->length());
+
+  // And decrypting it into a buffer gives back the plaintext.
+  Aes128Gcm12Decrypter decrypter;
+  ASSERT_TRUE(decrypter.SetKey(key));
+  ASSERT_TRUE(decrypter.SetNoncePrefix(nonce_prefix));
+  scoped_ptr<char[]> decrypted(new char[ciphertext_size]);
+  size_t decrypted_length = 0;
+  ASSERT_TRUE(decrypter.DecryptPacketIntoBuffer(
+      kSequenceNumber, associated_data,
+      StringPiece(ciphertext.get(), ciphertext_size), decrypted.get(),
+      &decrypted_length));
+  EXPECT_EQ(plaintext, string(decrypted.get(), decrypted_length));
+}
+
 }  // namespace test
 }  // namespace net
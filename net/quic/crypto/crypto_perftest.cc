@@ -0,0 +1,113 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/strings/string_piece.h"
+#include "base/test/perf_time_logger.h"
+#include "net/quic/crypto/aes_128_gcm_12_decrypter.h"
+#include "net/quic/crypto/aes_128_gcm_12_encrypter.h"
+#include "net/quic/crypto/chacha20_poly1305_decrypter.h"
+#include "net/quic/crypto/chacha20_poly1305_encrypter.h"
+#include "net/quic/crypto/quic_decrypter.h"
+#include "net/quic/crypto/quic_encrypter.h"
+#include "net/quic/quic_protocol.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+using base::StringPiece;
+using std::string;
+
+const int kIterations = 100000;
+
+// The payload of a full sized packet.
+const size_t kPlaintextSize = 1350;
+
+void RunEncryptTest(const char* name,
+                    QuicEncrypter* encrypter,
+                    size_t key_size,
+                    size_t nonce_prefix_size) {
+  ASSERT_TRUE(encrypter->SetKey(string(key_size, 'k')));
+  ASSERT_TRUE(encrypter->SetNoncePrefix(string(nonce_prefix_size, 'n')));
+  string associated_data(20, 'a');
+  string plaintext(kPlaintextSize, 'p');
+  scoped_ptr<char[]> ciphertext(
+      new char[encrypter->GetCiphertextSize(kPlaintextSize)]);
+
+  base::PerfTimeLogger timer(name);
+  for (int i = 0; i < kIterations; ++i) {
+    ASSERT_TRUE(encrypter->EncryptPacketIntoBuffer(
+        i, associated_data, plaintext, ciphertext.get()));
+  }
+  timer.Done();
+}
+
+void RunDecryptTest(const char* name,
+                    QuicEncrypter* encrypter,
+                    QuicDecrypter* decrypter,
+                    size_t key_size,
+                    size_t nonce_prefix_size) {
+  string key(key_size, 'k');
+  string nonce_prefix(nonce_prefix_size, 'n');
+  ASSERT_TRUE(encrypter->SetKey(key));
+  ASSERT_TRUE(encrypter->SetNoncePrefix(nonce_prefix));
+  ASSERT_TRUE(decrypter->SetKey(key));
+  ASSERT_TRUE(decrypter->SetNoncePrefix(nonce_prefix));
+  string associated_data(20, 'a');
+  string plaintext(kPlaintextSize, 'p');
+  const QuicPacketSequenceNumber kSequenceNumber = 1;
+  scoped_ptr<QuicData> ciphertext(encrypter->EncryptPacket(
+      kSequenceNumber, associated_data, plaintext));
+  ASSERT_TRUE(ciphertext.get());
+  char decrypted[kMaxPacketSize];
+  size_t decrypted_length = 0;
+
+  base::PerfTimeLogger timer(name);
+  for (int i = 0; i < kIterations; ++i) {
+    ASSERT_TRUE(decrypter->DecryptPacketIntoBuffer(
+        kSequenceNumber, associated_data, ciphertext->AsStringPiece(),
+        decrypted, &decrypted_length));
+  }
+  timer.Done();
+  EXPECT_EQ(kPlaintextSize, decrypted_length);
+}
+
+TEST(QuicCryptoPerfTest, EncryptAes128Gcm12) {
+  Aes128Gcm12Encrypter encrypter;
+  RunEncryptTest("Encrypt AES-128-GCM-12 packets", &encrypter,
+                 encrypter.GetKeySize(), encrypter.GetNoncePrefixSize());
+}
+
+TEST(QuicCryptoPerfTest, DecryptAes128Gcm12) {
+  Aes128Gcm12Encrypter encrypter;
+  Aes128Gcm12Decrypter decrypter;
+  RunDecryptTest("Decrypt AES-128-GCM-12 packets", &encrypter, &decrypter,
+                 encrypter.GetKeySize(), encrypter.GetNoncePrefixSize());
+}
+
+TEST(QuicCryptoPerfTest, EncryptChaCha20Poly1305) {
+  if (!ChaCha20Poly1305Encrypter::IsSupported())
+    return;
+  ChaCha20Poly1305Encrypter encrypter;
+  RunEncryptTest("Encrypt ChaCha20-Poly1305 packets", &encrypter,
+                 encrypter.GetKeySize(), encrypter.GetNoncePrefixSize());
+}
+
+TEST(QuicCryptoPerfTest, DecryptChaCha20Poly1305) {
+  if (!ChaCha20Poly1305Encrypter::IsSupported())
+    return;
+  ChaCha20Poly1305Encrypter encrypter;
+  ChaCha20Poly1305Decrypter decrypter;
+  RunDecryptTest("Decrypt ChaCha20-Poly1305 packets", &encrypter, &decrypter,
+                 encrypter.GetKeySize(), encrypter.GetNoncePrefixSize());
+}
+
+}  // namespace
+
+}  // namespace net
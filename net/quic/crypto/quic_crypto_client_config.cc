@@ -4,9 +4,11 @@
 
 #include "net/quic/crypto/quic_crypto_client_config.h"
 
+#include "base/cpu.h"
 #include "base/stl_util.h"
 #include "base/strings/string_util.h"
 #include "net/quic/crypto/cert_compressor.h"
+#include "net/quic/crypto/chacha20_poly1305_encrypter.h"
 #include "net/quic/crypto/channel_id.h"
 #include "net/quic/crypto/common_cert_set.h"
 #include "net/quic/crypto/crypto_framer.h"
@@ -31,6 +33,19 @@ using std::vector;
 
 namespace net {
 
+namespace {
+
+// Returns true if the CPU has instructions that make AES-GCM fast.
+bool HasAesHardwareSupport() {
+#if defined(ARCH_CPU_X86_FAMILY)
+  return base::CPU().has_aesni();
+#else
+  return false;
+#endif
+}
+
+}  // namespace
+
 QuicCryptoClientConfig::QuicCryptoClientConfig() {}
 
 QuicCryptoClientConfig::~QuicCryptoClientConfig() {
@@ -250,9 +265,17 @@ void QuicCryptoClientConfig::SetDefaults() {
   kexs[0] = kC255;
   kexs[1] = kP256;
 
-  // Authenticated encryption algorithms.
-  aead.resize(1);
-  aead[0] = kAESG;
+  // Authenticated encryption algorithms. Without AES instructions,
+  // ChaCha20-Poly1305 is much faster than AES-GCM, so prefer it.
+  aead.clear();
+  if (ChaCha20Poly1305Encrypter::IsSupported() && !HasAesHardwareSupport()) {
+    aead.push_back(kCC12);
+    aead.push_back(kAESG);
+  } else {
+    aead.push_back(kAESG);
+    if (ChaCha20Poly1305Encrypter::IsSupported())
+      aead.push_back(kCC12);
+  }
 }
 
 QuicCryptoClientConfig::CachedState* QuicCryptoClientConfig::LookupOrCreate(
@@ -365,9 +388,10 @@ QuicErrorCode QuicCryptoClientConfig::FillClientHello(
     return QUIC_INVALID_CRYPTO_MESSAGE_PARAMETER;
   }
 
+  // The client knows which AEAD is fastest on its CPU, so its order wins.
   size_t key_exchange_index;
   if (!QuicUtils::FindMutualTag(
-          aead, their_aeads, num_their_aeads, QuicUtils::PEER_PRIORITY,
+          aead, their_aeads, num_their_aeads, QuicUtils::LOCAL_PRIORITY,
           &out_params->aead, NULL) ||
       !QuicUtils::FindMutualTag(
           kexs, their_key_exchanges, num_their_key_exchanges,
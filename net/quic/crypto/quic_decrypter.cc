@@ -4,11 +4,14 @@
 
 #include "net/quic/crypto/quic_decrypter.h"
 
+#include "base/memory/scoped_ptr.h"
 #include "net/quic/crypto/aes_128_gcm_12_decrypter.h"
 #include "net/quic/crypto/chacha20_poly1305_decrypter.h"
 #include "net/quic/crypto/crypto_protocol.h"
 #include "net/quic/crypto/null_decrypter.h"
 
+using base::StringPiece;
+
 namespace net {
 
 // static
@@ -26,4 +29,21 @@ QuicDecrypter* QuicDecrypter::Create(QuicTag algorithm) {
   }
 }
 
+bool QuicDecrypter::DecryptPacketIntoBuffer(
+    QuicPacketSequenceNumber sequence_number,
+    StringPiece associated_data,
+    StringPiece ciphertext,
+    char* output,
+    size_t* output_length) {
+  scoped_ptr<QuicData> plaintext(
+      DecryptPacket(sequence_number, associated_data, ciphertext));
+  if (plaintext.get() == NULL) {
+    return false;
+  }
+  DCHECK_LE(plaintext->length(), ciphertext.length());
+  memcpy(output, plaintext->data(), plaintext->length());
+  *output_length = plaintext->length();
+  return true;
+}
+
 }  // namespace net
@@ -4,11 +4,14 @@
 
 #include "net/quic/crypto/quic_encrypter.h"
 
+#include "base/memory/scoped_ptr.h"
 #include "net/quic/crypto/aes_128_gcm_12_encrypter.h"
 #include "net/quic/crypto/chacha20_poly1305_encrypter.h"
 #include "net/quic/crypto/crypto_protocol.h"
 #include "net/quic/crypto/null_encrypter.h"
 
+using base::StringPiece;
+
 namespace net {
 
 // static
@@ -26,4 +29,18 @@ QuicEncrypter* QuicEncrypter::Create(QuicTag algorithm) {
   }
 }
 
+bool QuicEncrypter::EncryptPacketIntoBuffer(
+    QuicPacketSequenceNumber sequence_number,
+    StringPiece associated_data,
+    StringPiece plaintext,
+    char* output) {
+  scoped_ptr<QuicData> ciphertext(
+      EncryptPacket(sequence_number, associated_data, plaintext));
+  if (ciphertext.get() == NULL) {
+    return false;
+  }
+  memcpy(output, ciphertext->data(), ciphertext->length());
+  return true;
+}
+
 }  // namespace net
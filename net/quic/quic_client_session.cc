@@ -38,6 +38,9 @@ enum HandshakeState {
   NUM_HANDSHAKE_STATES = 4
 };
 
+// The number of packets read from the socket at once.
+const int kMaxPacketsPerRead = 16;
+
 void RecordHandshakeState(HandshakeState state) {
   UMA_HISTOGRAM_ENUMERATION("Net.QuicHandshakeState", state,
                             NUM_HANDSHAKE_STATES);
@@ -100,7 +103,8 @@ QuicClientSession::QuicClientSession(
       stream_factory_(stream_factory),
       socket_(socket.Pass()),
       writer_(writer.Pass()),
-      read_buffer_(new IOBufferWithSize(kMaxPacketSize)),
+      read_buffer_(
+          new IOBufferWithSize(kMaxPacketSize * kMaxPacketsPerRead)),
       server_info_(server_info.Pass()),
       read_pending_(false),
       num_total_streams_(0),
@@ -497,10 +501,12 @@ void QuicClientSession::StartReading() {
     return;
   }
   read_pending_ = true;
-  int rv = socket_->Read(read_buffer_.get(),
-                         read_buffer_->size(),
-                         base::Bind(&QuicClientSession::OnReadComplete,
-                                    weak_factory_.GetWeakPtr()));
+  int rv = socket_->ReadMultiple(read_buffer_.get(),
+                                 kMaxPacketSize,
+                                 kMaxPacketsPerRead,
+                                 &read_packet_sizes_,
+                                 base::Bind(&QuicClientSession::OnReadComplete,
+                                            weak_factory_.GetWeakPtr()));
   if (rv == ERR_IO_PENDING) {
     num_packets_read_ = 0;
     return;
@@ -526,6 +532,23 @@ void QuicClientSession::CloseSessionOnError(int error) {
   NotifyFactoryOfSessionClosed();
 }
 
+void QuicClientSession::MigrateToSocket(
+    scoped_ptr<DatagramClientSocket> socket) {
+  DCHECK(connection()->connected());
+  // Closing the old socket cancels its pending read and write.
+  socket_->Close();
+  read_pending_ = false;
+
+  scoped_ptr<QuicDefaultPacketWriter> writer(
+      new QuicDefaultPacketWriter(socket.get()));
+  writer->SetConnection(connection());
+  connection()->MigrateToWriter(writer.get());
+  writer_ = writer.Pass();
+  socket_ = socket.Pass();
+  net_log_.AddEvent(NetLog::TYPE_QUIC_SESSION_MIGRATED);
+  StartReading();
+}
+
 void QuicClientSession::CloseSessionOnErrorInner(int net_error,
                                                  QuicErrorCode quic_error) {
   if (!callback_.is_null()) {
@@ -588,35 +611,45 @@ base::WeakPtr<QuicClientSession> QuicClientSession::GetWeakPtr() {
 
 void QuicClientSession::OnReadComplete(int result) {
   read_pending_ = false;
-  if (result == 0)
-    result = ERR_CONNECTION_CLOSED;
-
   if (result < 0) {
-    DVLOG(1) << "Closing session on read error: " << result;
-    UMA_HISTOGRAM_SPARSE_SLOWLY("Net.QuicSession.ReadError", -result);
-    NotifyFactoryOfSessionGoingAway();
-    CloseSessionOnErrorInner(result, QUIC_PACKET_READ_ERROR);
-    NotifyFactoryOfSessionClosedLater();
+    OnReadError(result);
     return;
   }
 
+  // The packets are processed straight from |read_buffer_|, which is
+  // only read into again once they all are.
   scoped_refptr<IOBufferWithSize> buffer(read_buffer_);
-  read_buffer_ = new IOBufferWithSize(kMaxPacketSize);
-  QuicEncryptedPacket packet(buffer->data(), result);
   IPEndPoint local_address;
   IPEndPoint peer_address;
   socket_->GetLocalAddress(&local_address);
   socket_->GetPeerAddress(&peer_address);
-  // ProcessUdpPacket might result in |this| being deleted, so we
-  // use a weak pointer to be safe.
-  connection()->ProcessUdpPacket(local_address, peer_address, packet);
-  if (!connection()->connected()) {
-    NotifyFactoryOfSessionClosedLater();
-    return;
+  DCHECK_EQ(static_cast<size_t>(result), read_packet_sizes_.size());
+  for (int i = 0; i < result; ++i) {
+    if (read_packet_sizes_[i] == 0) {
+      OnReadError(ERR_CONNECTION_CLOSED);
+      return;
+    }
+    QuicEncryptedPacket packet(buffer->data() + i * kMaxPacketSize,
+                               read_packet_sizes_[i]);
+    // ProcessUdpPacket might result in |this| being deleted, so we
+    // use a weak pointer to be safe.
+    connection()->ProcessUdpPacket(local_address, peer_address, packet);
+    if (!connection()->connected()) {
+      NotifyFactoryOfSessionClosedLater();
+      return;
+    }
   }
   StartReading();
 }
 
+void QuicClientSession::OnReadError(int result) {
+  DVLOG(1) << "Closing session on read error: " << result;
+  UMA_HISTOGRAM_SPARSE_SLOWLY("Net.QuicSession.ReadError", -result);
+  NotifyFactoryOfSessionGoingAway();
+  CloseSessionOnErrorInner(result, QUIC_PACKET_READ_ERROR);
+  NotifyFactoryOfSessionClosedLater();
+}
+
 void QuicClientSession::NotifyFactoryOfSessionGoingAway() {
   if (stream_factory_)
     stream_factory_->OnSessionGoingAway(this);
@@ -11,6 +11,7 @@
 #define NET_QUIC_QUIC_CLIENT_SESSION_H_
 
 #include <string>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "base/containers/hash_tables.h"
@@ -157,6 +158,11 @@ class NET_EXPORT_PRIVATE QuicClientSession : public QuicClientSessionBase {
   // that this session has been closed, which will delete the session.
   void CloseSessionOnError(int error);
 
+  // Moves the connection to |socket|, which is connected to the same server
+  // from a new local address, and starts reading from it.  The streams keep
+  // going on the new socket.
+  void MigrateToSocket(scoped_ptr<DatagramClientSocket> socket);
+
   base::Value* GetInfoAsValue(const std::set<HostPortPair>& aliases) const;
 
   const BoundNetLog& net_log() const { return net_log_; }
@@ -184,9 +190,13 @@ class NET_EXPORT_PRIVATE QuicClientSession : public QuicClientSessionBase {
   typedef std::list<StreamRequest*> StreamRequestQueue;
 
   QuicReliableClientStream* CreateOutgoingReliableStreamImpl();
-  // A completion callback invoked when a read completes.
+  // A completion callback invoked when a read completes. |result| is the
+  // number of packets read into |read_buffer_|.
   void OnReadComplete(int result);
 
+  // Closes the session after a read returned |result|.
+  void OnReadError(int result);
+
   void OnClosedStream();
 
   // A Session may be closed via any of three methods:
@@ -218,7 +228,9 @@ class NET_EXPORT_PRIVATE QuicClientSession : public QuicClientSessionBase {
   QuicStreamFactory* stream_factory_;
   scoped_ptr<DatagramClientSocket> socket_;
   scoped_ptr<QuicDefaultPacketWriter> writer_;
+  // Holds kMaxPacketsPerRead packets of kMaxPacketSize bytes.
   scoped_refptr<IOBufferWithSize> read_buffer_;
+  std::vector<int> read_packet_sizes_;
   scoped_ptr<QuicServerInfo> server_info_;
   scoped_ptr<CertVerifyResult> cert_verify_result_;
   ObserverSet observers_;
@@ -228,7 +240,8 @@ class NET_EXPORT_PRIVATE QuicClientSession : public QuicClientSessionBase {
   size_t num_total_streams_;
   BoundNetLog net_log_;
   QuicConnectionLogger logger_;
-  // Number of packets read in the current read loop.
+  // Number of reads, of up to kMaxPacketsPerRead packets each, in the
+  // current read loop.
   size_t num_packets_read_;
   base::WeakPtrFactory<QuicClientSession> weak_factory_;
 
@@ -398,6 +398,9 @@ bool QuicConfig::negotiated() {
 
 void QuicConfig::SetDefaults() {
   QuicTagVector congestion_control;
+  if (FLAGS_enable_quic_bbr) {
+    congestion_control.push_back(kTBBR);
+  }
   if (FLAGS_enable_quic_pacing) {
     congestion_control.push_back(kPACE);
   }
@@ -417,6 +420,9 @@ void QuicConfig::SetDefaults() {
 
 void QuicConfig::EnablePacing(bool enable_pacing) {
   QuicTagVector congestion_control;
+  if (FLAGS_enable_quic_bbr) {
+    congestion_control.push_back(kTBBR);
+  }
   if (enable_pacing) {
     congestion_control.push_back(kPACE);
   }
@@ -1084,6 +1084,13 @@ void QuicConnection::WriteIfNotBlocked() {
   }
 }
 
+void QuicConnection::MigrateToWriter(QuicPacketWriter* writer) {
+  DCHECK(!is_server_);
+  writer_ = writer;
+  self_address_ = IPEndPoint();
+  WriteIfNotBlocked();
+}
+
 bool QuicConnection::ProcessValidatedPacket() {
   if (address_migrating_) {
     SendConnectionCloseWithDetails(
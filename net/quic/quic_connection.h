@@ -282,6 +282,12 @@ class NET_EXPORT_PRIVATE QuicConnection
   // If the socket is not blocked, writes queued packets.
   void WriteIfNotBlocked();
 
+  // Switches a client connection to |writer|, which must outlive it, after
+  // the local address changed.  The connection ID, the streams and the
+  // congestion state are kept, and the new self address is taken from the
+  // next packet received.
+  void MigrateToWriter(QuicPacketWriter* writer);
+
   // Do any work which logically would be done in OnPacket but can not be
   // safely done until the packet is validated.  Returns true if the packet
   // can be handled, false otherwise.
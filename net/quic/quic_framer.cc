@@ -1419,8 +1419,11 @@ bool QuicFramer::ProcessReceivedInfo(uint8 frame_type,
       set_detailed_error("Unable to read missing sequence number range.");
       return false;
     }
+    // The ranges are in descending order, so each number goes first in
+    // the set, and inserting there takes constant time.
     for (size_t i = 0; i <= range_length; ++i) {
-      received_info->missing_packets.insert(last_sequence_number - i);
+      received_info->missing_packets.insert(
+          received_info->missing_packets.begin(), last_sequence_number - i);
     }
     // Subtract an extra 1 to ensure ranges are represented efficiently and
     // can't overlap by 1 sequence number.  This allows a missing_delta of 0
@@ -1759,19 +1762,21 @@ QuicEncryptedPacket* QuicFramer::EncryptPacket(
     const QuicPacket& packet) {
   DCHECK(encrypter_[level].get() != NULL);
 
-  scoped_ptr<QuicData> out(encrypter_[level]->EncryptPacket(
-      packet_sequence_number, packet.AssociatedData(), packet.Plaintext()));
-  if (out.get() == NULL) {
+  // The ciphertext is written right after the header, in the buffer of the
+  // encrypted packet.
+  StringPiece header_data = packet.BeforePlaintext();
+  StringPiece plaintext = packet.Plaintext();
+  size_t len = header_data.length() +
+      encrypter_[level]->GetCiphertextSize(plaintext.length());
+  scoped_ptr<char[]> buffer(new char[len]);
+  memcpy(buffer.get(), header_data.data(), header_data.length());
+  if (!encrypter_[level]->EncryptPacketIntoBuffer(
+          packet_sequence_number, packet.AssociatedData(), plaintext,
+          buffer.get() + header_data.length())) {
     RaiseError(QUIC_ENCRYPTION_FAILURE);
     return NULL;
   }
-  StringPiece header_data = packet.BeforePlaintext();
-  size_t len =  header_data.length() + out->length();
-  char* buffer = new char[len];
-  // TODO(rch): eliminate this buffer copy by passing in a buffer to Encrypt().
-  memcpy(buffer, header_data.data(), header_data.length());
-  memcpy(buffer + header_data.length(), out->data(), out->length());
-  return new QuicEncryptedPacket(buffer, len, true);
+  return new QuicEncryptedPacket(buffer.release(), len, true);
 }
 
 size_t QuicFramer::GetMaxPlaintextSize(size_t ciphertext_size) {
@@ -1798,24 +1803,27 @@ bool QuicFramer::DecryptPayload(const QuicPacketHeader& header,
     return false;
   }
   DCHECK(decrypter_.get() != NULL);
-  decrypted_.reset(decrypter_->DecryptPacket(
+  // ProcessPacket rejects packets larger than the buffer.
+  DCHECK_LE(encrypted.length(), sizeof(decrypted_buffer_));
+  size_t decrypted_length = 0;
+  bool success = decrypter_->DecryptPacketIntoBuffer(
       header.packet_sequence_number,
       GetAssociatedDataFromEncryptedPacket(
           packet,
           header.public_header.connection_id_length,
           header.public_header.version_flag,
           header.public_header.sequence_number_length),
-      encrypted));
-  if  (decrypted_.get() == NULL && alternative_decrypter_.get() != NULL) {
-    decrypted_.reset(alternative_decrypter_->DecryptPacket(
+      encrypted, decrypted_buffer_, &decrypted_length);
+  if  (!success && alternative_decrypter_.get() != NULL) {
+    success = alternative_decrypter_->DecryptPacketIntoBuffer(
         header.packet_sequence_number,
         GetAssociatedDataFromEncryptedPacket(
             packet,
             header.public_header.connection_id_length,
             header.public_header.version_flag,
             header.public_header.sequence_number_length),
-        encrypted));
-    if (decrypted_.get() != NULL) {
+        encrypted, decrypted_buffer_, &decrypted_length);
+    if (success) {
       if (alternative_decrypter_latch_) {
         // Switch to the alternative decrypter and latch so that we cannot
         // switch back.
@@ -1827,11 +1835,11 @@ bool QuicFramer::DecryptPayload(const QuicPacketHeader& header,
     }
   }
 
-  if  (decrypted_.get() == NULL) {
+  if  (!success) {
     return false;
   }
 
-  reader_.reset(new QuicDataReader(decrypted_->data(), decrypted_->length()));
+  reader_.reset(new QuicDataReader(decrypted_buffer_, decrypted_length));
   return true;
 }
 
@@ -245,7 +245,8 @@ void InsertMissingPacketsBetween(ReceivedPacketInfo* received_info,
                                  QuicPacketSequenceNumber lower,
                                  QuicPacketSequenceNumber higher) {
   for (QuicPacketSequenceNumber i = lower; i < higher; ++i) {
-    received_info->missing_packets.insert(i);
+    received_info->missing_packets.insert(
+        received_info->missing_packets.end(), i);
   }
 }
 
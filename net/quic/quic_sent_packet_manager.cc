@@ -8,6 +8,7 @@
 
 #include "base/logging.h"
 #include "base/stl_util.h"
+#include "net/quic/congestion_control/bbr_sender.h"
 #include "net/quic/congestion_control/pacing_sender.h"
 #include "net/quic/crypto/crypto_protocol.h"
 #include "net/quic/quic_ack_notifier_manager.h"
@@ -33,6 +34,10 @@ bool FLAGS_track_retransmission_history = false;
 // request pacing for the server to enable it.
 bool FLAGS_enable_quic_pacing = true;
 
+// If true, QUIC connections will support the model based BbrSender in place
+// of TCP cubic.  The client must also request it for the server to use it.
+bool FLAGS_enable_quic_bbr = false;
+
 namespace net {
 namespace {
 static const int kDefaultRetransmissionTimeMs = 500;
@@ -94,7 +99,10 @@ void QuicSentPacketManager::SetFromConfig(const QuicConfig& config) {
         << "Client did not set an initial RTT, but did negotiate one.";
     rtt_stats_.set_initial_rtt_us(config.initial_round_trip_time_us());
   }
-  if (config.congestion_control() == kPACE) {
+  if (config.congestion_control() == kTBBR && FLAGS_enable_quic_bbr) {
+    // BbrSender paces by itself.
+    send_algorithm_.reset(new BbrSender(clock_, &rtt_stats_));
+  } else if (config.congestion_control() == kPACE) {
     MaybeEnablePacing();
   }
   send_algorithm_->SetFromConfig(config, is_server_);
@@ -160,8 +168,12 @@ void QuicSentPacketManager::DiscardUnackedPacket(
 void QuicSentPacketManager::HandleAckForSentPackets(
     const ReceivedPacketInfo& received_info) {
   // Go through the packets we have not received an ack for and see if this
-  // incoming_ack shows they've been seen by the peer.
+  // incoming_ack shows they've been seen by the peer.  Both the unacked
+  // packets and the missing ones are sorted, so walk them side by side
+  // rather than looking up each unacked packet in |missing_packets|.
   QuicUnackedPacketMap::const_iterator it = unacked_packets_.begin();
+  SequenceNumberSet::const_iterator missing_it =
+      received_info.missing_packets.begin();
   while (it != unacked_packets_.end()) {
     QuicPacketSequenceNumber sequence_number = it->first;
     if (sequence_number > received_info.largest_observed) {
@@ -169,7 +181,12 @@ void QuicSentPacketManager::HandleAckForSentPackets(
       break;
     }
 
-    if (IsAwaitingPacket(received_info, sequence_number)) {
+    while (missing_it != received_info.missing_packets.end() &&
+           *missing_it < sequence_number) {
+      ++missing_it;
+    }
+    if (missing_it != received_info.missing_packets.end() &&
+        *missing_it == sequence_number) {
       ++it;
       continue;
     }
@@ -334,12 +351,7 @@ QuicSentPacketManager::MarkPacketHandled(
     ++all_transmissions_it;
   }
 
-  QuicUnackedPacketMap::const_iterator next_unacked = unacked_packets_.begin();
-  while (next_unacked != unacked_packets_.end() &&
-         next_unacked->first < sequence_number) {
-    ++next_unacked;
-  }
-  return next_unacked;
+  return unacked_packets_.lower_bound(sequence_number);
 }
 
 bool QuicSentPacketManager::IsUnacked(
@@ -536,7 +548,6 @@ void QuicSentPacketManager::MaybeRetransmitOnAckFrame(
     QuicPacketSequenceNumber sequence_number = it->first;
     DVLOG(1) << "still missing packet " << sequence_number;
     // Acks must be handled previously, so ensure it's missing and not acked.
-    DCHECK(IsAwaitingPacket(received_info, sequence_number));
 
     // Consider it multiple nacks when there is a gap between the missing packet
     // and the largest observed, since the purpose of a nack threshold is to
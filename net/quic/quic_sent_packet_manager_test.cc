@@ -12,6 +12,7 @@
 
 using std::vector;
 using testing::_;
+using testing::AnyNumber;
 using testing::Return;
 using testing::StrictMock;
 
@@ -683,6 +684,40 @@ TEST_F(QuicSentPacketManagerTest, FackRetransmit14PacketsAlternateAcks) {
   }
 }
 
+TEST_F(QuicSentPacketManagerTest, AckManyPacketsInFlight) {
+  const QuicPacketSequenceNumber kNumSentPackets = 5000;
+  for (QuicPacketSequenceNumber i = 1; i <= kNumSentPackets; ++i) {
+    SendDataPacket(i);
+  }
+
+  // Ack every even packet and nack every odd one.
+  ReceivedPacketInfo received_info;
+  received_info.largest_observed = kNumSentPackets;
+  received_info.delta_time_largest_observed =
+      QuicTime::Delta::FromMilliseconds(5);
+  for (QuicPacketSequenceNumber i = 1; i < kNumSentPackets; i += 2) {
+    received_info.missing_packets.insert(i);
+  }
+  EXPECT_CALL(*send_algorithm_, UpdateRtt(_));
+  EXPECT_CALL(*send_algorithm_, OnPacketAcked(_, _))
+      .Times(kNumSentPackets / 2);
+  EXPECT_CALL(*send_algorithm_, OnPacketLost(_, _)).Times(AnyNumber());
+  EXPECT_CALL(*send_algorithm_, OnPacketAbandoned(_, _)).Times(AnyNumber());
+  manager_.OnIncomingAck(received_info, clock_.Now());
+  EXPECT_EQ(kNumSentPackets / 2,
+            QuicSentPacketManagerPeer::GetUnackedPackets(&manager_).size());
+  for (QuicPacketSequenceNumber i = 1; i <= kNumSentPackets; ++i) {
+    EXPECT_EQ(i % 2 == 1, manager_.IsUnacked(i)) << i;
+  }
+
+  // Now ack the odd packets too, which leaves nothing to retransmit.
+  received_info.missing_packets.clear();
+  EXPECT_CALL(*send_algorithm_, OnPacketAcked(_, _)).Times(AnyNumber());
+  manager_.OnIncomingAck(received_info, clock_.Now());
+  EXPECT_FALSE(manager_.HasUnackedPackets());
+  EXPECT_FALSE(manager_.HasPendingRetransmissions());
+}
+
 TEST_F(QuicSentPacketManagerTest, Rtt) {
   QuicPacketSequenceNumber sequence_number = 1;
   QuicTime::Delta expected_rtt = QuicTime::Delta::FromMilliseconds(15);
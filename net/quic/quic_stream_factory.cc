@@ -213,11 +213,9 @@ void QuicStreamFactory::Job::OnIOComplete(int rv) {
 }
 
 int QuicStreamFactory::Job::DoResolveHost() {
-  // Start loading the data now, and wait for it after we resolve the host.
-  if (server_info_) {
+  // The data is loading already, wait for it after we resolve the host.
+  if (server_info_)
     disk_cache_load_start_time_ = base::TimeTicks::Now();
-    server_info_->Start();
-  }
 
   io_state_ = STATE_RESOLVE_HOST_COMPLETE;
   return host_resolver_.Resolve(
@@ -358,6 +356,8 @@ scoped_ptr<QuicHttpStream> QuicStreamRequest::ReleaseStream() {
   return stream_.Pass();
 }
 
+const size_t QuicStreamFactory::kMaxPreloadedServerInfos = 10;
+
 QuicStreamFactory::QuicStreamFactory(
     HostResolver* host_resolver,
     ClientSocketFactory* client_socket_factory,
@@ -383,6 +383,7 @@ QuicStreamFactory::QuicStreamFactory(
       supported_versions_(supported_versions),
       enable_port_selection_(enable_port_selection),
       enable_pacing_(enable_pacing),
+      enable_connection_migration_(false),
       port_seed_(random_generator_->RandUint64()),
       weak_factory_(this) {
   config_.SetDefaults();
@@ -401,6 +402,15 @@ QuicStreamFactory::~QuicStreamFactory() {
   CloseAllSessions(ERR_ABORTED);
   STLDeleteElements(&all_sessions_);
   STLDeleteValues(&active_jobs_);
+  STLDeleteValues(&preloaded_server_infos_);
+}
+
+void QuicStreamFactory::set_quic_server_info_factory(
+    QuicServerInfoFactory* quic_server_info_factory) {
+  DCHECK(!quic_server_info_factory_);
+  quic_server_info_factory_ = quic_server_info_factory;
+  if (quic_server_info_factory_)
+    PreloadServerInfos();
 }
 
 int QuicStreamFactory::Create(const HostPortPair& host_port_pair,
@@ -428,7 +438,7 @@ int QuicStreamFactory::Create(const HostPortPair& host_port_pair,
         crypto_config_.LookupOrCreate(session_key);
     DCHECK(cached);
     if (cached->IsEmpty()) {
-      quic_server_info = quic_server_info_factory_->GetForServer(session_key);
+      quic_server_info = GetServerInfo(session_key);
     }
   }
   scoped_ptr<Job> job(new Job(this, host_resolver_, host_port_pair, is_https,
@@ -606,6 +616,38 @@ void QuicStreamFactory::CloseAllSessions(int error) {
   DCHECK(all_sessions_.empty());
 }
 
+void QuicStreamFactory::MigrateAllSessions(int error) {
+  // Closing a session removes it from |all_sessions_|.
+  SessionSet sessions(all_sessions_);
+  for (SessionSet::const_iterator it = sessions.begin();
+       it != sessions.end(); ++it) {
+    QuicClientSession* session = *it;
+    if (!ContainsKey(all_sessions_, session))
+      continue;
+    // Without a confirmed handshake, the server may not know the connection
+    // well enough to accept it from a new address.
+    if (!session->IsCryptoHandshakeConfirmed() ||
+        !session->connection()->connected()) {
+      session->CloseSessionOnError(error);
+      continue;
+    }
+
+    scoped_ptr<DatagramClientSocket> socket(
+        client_socket_factory_->CreateDatagramClientSocket(
+            DatagramSocket::DEFAULT_BIND, RandIntCallback(),
+            session->net_log().net_log(), session->net_log().source()));
+    int rv = socket->Connect(session->peer_address());
+    if (rv == OK)
+      rv = ConfigureSocket(socket.get());
+    UMA_HISTOGRAM_BOOLEAN("Net.QuicSession.ConnectionMigration", rv == OK);
+    if (rv != OK) {
+      session->CloseSessionOnError(error);
+      continue;
+    }
+    session->MigrateToSocket(socket.Pass());
+  }
+}
+
 base::Value* QuicStreamFactory::QuicStreamFactoryInfoToValue() const {
   base::ListValue* list = new base::ListValue();
 
@@ -628,7 +670,11 @@ base::Value* QuicStreamFactory::QuicStreamFactoryInfoToValue() const {
 }
 
 void QuicStreamFactory::OnIPAddressChanged() {
-  CloseAllSessions(ERR_NETWORK_CHANGED);
+  if (enable_connection_migration_) {
+    MigrateAllSessions(ERR_NETWORK_CHANGED);
+  } else {
+    CloseAllSessions(ERR_NETWORK_CHANGED);
+  }
   require_confirmation_ = true;
 }
 
@@ -695,22 +741,9 @@ int QuicStreamFactory::CreateSession(
     DCHECK_EQ(0u, port_suggester->call_count());
   }
 
-  // We should adaptively set this buffer size, but for now, we'll use a size
-  // that is more than large enough for a full receive window, and yet
-  // does not consume "too much" memory.  If we see bursty packet loss, we may
-  // revisit this setting and test for its impact.
-  const int32 kSocketBufferSize(TcpReceiver::kReceiveWindowTCP);
-  if (!socket->SetReceiveBufferSize(kSocketBufferSize)) {
-    HistogramCreateSessionFailure(CREATION_ERROR_SETTING_RECEIVE_BUFFER);
-    return ERR_SOCKET_SET_RECEIVE_BUFFER_SIZE_ERROR;
-  }
-  // Set a buffer large enough to contain the initial CWND's worth of packet
-  // to work around the problem with CHLO packets being sent out with the
-  // wrong encryption level, when the send buffer is full.
-  if (!socket->SetSendBufferSize(kMaxPacketSize * 20)) {
-    HistogramCreateSessionFailure(CREATION_ERROR_SETTING_SEND_BUFFER);
-    return ERR_SOCKET_SET_SEND_BUFFER_SIZE_ERROR;
-  }
+  rv = ConfigureSocket(socket.get());
+  if (rv != OK)
+    return rv;
 
   scoped_ptr<QuicDefaultPacketWriter> writer(
       new QuicDefaultPacketWriter(socket.get()));
@@ -749,6 +782,26 @@ int QuicStreamFactory::CreateSession(
   return OK;
 }
 
+int QuicStreamFactory::ConfigureSocket(DatagramClientSocket* socket) {
+  // We should adaptively set this buffer size, but for now, we'll use a size
+  // that is more than large enough for a full receive window, and yet
+  // does not consume "too much" memory.  If we see bursty packet loss, we may
+  // revisit this setting and test for its impact.
+  const int32 kSocketBufferSize(TcpReceiver::kReceiveWindowTCP);
+  if (!socket->SetReceiveBufferSize(kSocketBufferSize)) {
+    HistogramCreateSessionFailure(CREATION_ERROR_SETTING_RECEIVE_BUFFER);
+    return ERR_SOCKET_SET_RECEIVE_BUFFER_SIZE_ERROR;
+  }
+  // Set a buffer large enough to contain the initial CWND's worth of packet
+  // to work around the problem with CHLO packets being sent out with the
+  // wrong encryption level, when the send buffer is full.
+  if (!socket->SetSendBufferSize(kMaxPacketSize * 20)) {
+    HistogramCreateSessionFailure(CREATION_ERROR_SETTING_SEND_BUFFER);
+    return ERR_SOCKET_SET_SEND_BUFFER_SIZE_ERROR;
+  }
+  return OK;
+}
+
 bool QuicStreamFactory::HasActiveJob(const QuicSessionKey& key) const {
   return ContainsKey(active_jobs_, key);
 }
@@ -789,6 +842,53 @@ void QuicStreamFactory::InitializeCachedState(
   }
 }
 
+void QuicStreamFactory::PreloadServerInfos() {
+  if (!http_server_properties_)
+    return;
+
+  // The map is in most recently used order.
+  const AlternateProtocolMap& alternate_protocol_map =
+      http_server_properties_->alternate_protocol_map();
+  for (AlternateProtocolMap::const_iterator it =
+           alternate_protocol_map.begin();
+       it != alternate_protocol_map.end() &&
+           preloaded_server_infos_.size() < kMaxPreloadedServerInfos;
+       ++it) {
+    if (it->second.protocol != QUIC)
+      continue;
+
+    // Requests for an origin are sent to its alternate port, and only
+    // port 443 is assumed to be https.
+    QuicSessionKey session_key(
+        HostPortPair(it->first.host(), it->second.port),
+        it->first.port() == 443, kPrivacyModeDisabled);
+    if (ContainsKey(preloaded_server_infos_, session_key))
+      continue;
+    QuicServerInfo* server_info =
+        quic_server_info_factory_->GetForServer(session_key);
+    if (!server_info)
+      continue;
+    server_info->Start();
+    preloaded_server_infos_[session_key] = server_info;
+  }
+}
+
+QuicServerInfo* QuicStreamFactory::GetServerInfo(
+    const QuicSessionKey& session_key) {
+  ServerInfoMap::iterator it = preloaded_server_infos_.find(session_key);
+  if (it != preloaded_server_infos_.end()) {
+    QuicServerInfo* server_info = it->second;
+    preloaded_server_infos_.erase(it);
+    return server_info;
+  }
+
+  QuicServerInfo* server_info =
+      quic_server_info_factory_->GetForServer(session_key);
+  if (server_info)
+    server_info->Start();
+  return server_info;
+}
+
 void QuicStreamFactory::ExpireBrokenAlternateProtocolMappings() {
   base::TimeTicks now = base::TimeTicks::Now();
   while (!broken_alternate_protocol_list_.empty()) {
@@ -35,6 +35,7 @@ class QuicClientSession;
 class QuicConnectionHelper;
 class QuicCryptoClientStreamFactory;
 class QuicRandom;
+class QuicServerInfo;
 class QuicServerInfoFactory;
 class QuicSessionKey;
 class QuicStreamFactory;
@@ -86,6 +87,10 @@ class NET_EXPORT_PRIVATE QuicStreamFactory
     : public NetworkChangeNotifier::IPAddressObserver,
       public CertDatabase::Observer {
  public:
+  // The maximum number of servers whose QuicServerInfo is loaded ahead of
+  // time.
+  static const size_t kMaxPreloadedServerInfos;
+
   QuicStreamFactory(
       HostResolver* host_resolver,
       ClientSocketFactory* client_socket_factory,
@@ -130,12 +135,16 @@ class NET_EXPORT_PRIVATE QuicStreamFactory
   // Closes all current sessions.
   void CloseAllSessions(int error);
 
+  // Moves the sessions which have completed their handshake to new sockets,
+  // and closes the others with |error|.
+  void MigrateAllSessions(int error);
+
   base::Value* QuicStreamFactoryInfoToValue() const;
 
   // NetworkChangeNotifier::IPAddressObserver methods:
 
-  // Until the servers support roaming, close all connections when the local
-  // IP address changes.
+  // Unless connection migration is enabled, close all connections when the
+  // local IP address changes.
   virtual void OnIPAddressChanged() OVERRIDE;
 
   // CertDatabase::Observer methods:
@@ -154,14 +163,26 @@ class NET_EXPORT_PRIVATE QuicStreamFactory
 
   bool enable_port_selection() const { return enable_port_selection_; }
 
+  // Also starts loading the QuicServerInfo of the servers most recently
+  // known to support QUIC, so that the first requests to them after startup
+  // find it ready and can use 0-RTT.
   void set_quic_server_info_factory(
-      QuicServerInfoFactory* quic_server_info_factory) {
-    DCHECK(!quic_server_info_factory_);
-    quic_server_info_factory_ = quic_server_info_factory;
-  }
+      QuicServerInfoFactory* quic_server_info_factory);
 
   bool enable_pacing() const { return enable_pacing_; }
 
+  bool enable_connection_migration() const {
+    return enable_connection_migration_;
+  }
+
+  // When enabled, sessions which have completed their handshake move to a
+  // new socket when the local IP address changes, instead of being closed.
+  // This requires servers which accept packets of a connection from a new
+  // client address.
+  void set_enable_connection_migration(bool enable_connection_migration) {
+    enable_connection_migration_ = enable_connection_migration;
+  }
+
  private:
   class Job;
   friend class test::QuicStreamFactoryPeer;
@@ -191,6 +212,7 @@ class NET_EXPORT_PRIVATE QuicStreamFactory
   typedef std::map<QuicStreamRequest*, Job*> RequestMap;
   typedef std::set<QuicStreamRequest*> RequestSet;
   typedef std::map<Job*, RequestSet> JobRequestsMap;
+  typedef std::map<QuicSessionKey, QuicServerInfo*> ServerInfoMap;
 
   // Returns a newly created QuicHttpStream owned by the caller, if a
   // matching session already exists.  Returns NULL otherwise.
@@ -210,11 +232,22 @@ class NET_EXPORT_PRIVATE QuicStreamFactory
   void ActivateSession(const QuicSessionKey& key,
                        QuicClientSession* session);
 
+  // Sets the buffer sizes of the |socket| of a session.
+  int ConfigureSocket(DatagramClientSocket* socket);
+
   // Initializes the cached state associated with |session_key| in
   // |crypto_config_| with the information in |server_info|.
   void InitializeCachedState(const QuicSessionKey& session_key,
                              const scoped_ptr<QuicServerInfo>& server_info);
 
+  // Starts loading the QuicServerInfo of the most recently used servers with
+  // a QUIC alternate protocol, up to kMaxPreloadedServerInfos of them.
+  void PreloadServerInfos();
+
+  // Returns the QuicServerInfo for |session_key|, already started, or NULL.
+  // It was preloaded if one is available.
+  QuicServerInfo* GetServerInfo(const QuicSessionKey& session_key);
+
   void ExpireBrokenAlternateProtocolMappings();
   void ScheduleBrokenAlternateProtocolMappingsExpiration();
 
@@ -262,6 +295,10 @@ class NET_EXPORT_PRIVATE QuicStreamFactory
   QuicConfig config_;
   QuicCryptoClientConfig crypto_config_;
 
+  // Owning pointers to the QuicServerInfos loaded ahead of time, until a job
+  // takes them.
+  ServerInfoMap preloaded_server_infos_;
+
   JobMap active_jobs_;
   JobRequestsMap job_requests_map_;
   RequestMap active_requests_;
@@ -276,6 +313,9 @@ class NET_EXPORT_PRIVATE QuicStreamFactory
   // True if packet pacing should be advertised during the crypto handshake.
   bool enable_pacing_;
 
+  // True if sessions move to a new socket when the local IP address changes.
+  bool enable_connection_migration_;
+
   // Each profile will (probably) have a unique port_seed_ value.  This value is
   // used to help seed a pseudo-random number generator (PortSuggester) so that
   // we consistently (within this profile) suggest the same ephemeral port when
@@ -5,17 +5,21 @@
 #include "net/quic/quic_stream_factory.h"
 
 #include "base/run_loop.h"
+#include "base/stl_util.h"
 #include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
 #include "net/base/test_data_directory.h"
 #include "net/cert/cert_verifier.h"
 #include "net/dns/mock_host_resolver.h"
 #include "net/http/http_response_headers.h"
 #include "net/http/http_response_info.h"
+#include "net/http/http_server_properties_impl.h"
 #include "net/http/http_util.h"
 #include "net/quic/crypto/crypto_handshake.h"
 #include "net/quic/crypto/proof_verifier_chromium.h"
 #include "net/quic/crypto/quic_decrypter.h"
 #include "net/quic/crypto/quic_encrypter.h"
+#include "net/quic/crypto/quic_server_info.h"
 #include "net/quic/quic_http_stream.h"
 #include "net/quic/quic_session_key.h"
 #include "net/quic/test_tools/mock_clock.h"
@@ -37,6 +41,59 @@ namespace test {
 namespace {
 const char kDefaultServerHostName[] = "www.google.com";
 const int kDefaultServerPort = 443;
+
+// A QuicServerInfo which has no data and is always ready.
+class MockQuicServerInfo : public QuicServerInfo {
+ public:
+  explicit MockQuicServerInfo(const QuicSessionKey& server_key)
+      : QuicServerInfo(server_key),
+        started_(false) {}
+  virtual ~MockQuicServerInfo() {}
+
+  virtual void Start() OVERRIDE {
+    EXPECT_FALSE(started_);
+    started_ = true;
+  }
+
+  virtual int WaitForDataReady(const CompletionCallback& callback) OVERRIDE {
+    EXPECT_TRUE(started_);
+    return OK;
+  }
+
+  virtual bool IsDataReady() OVERRIDE { return true; }
+
+  virtual bool IsReadyToPersist() OVERRIDE { return true; }
+
+  virtual void Persist() OVERRIDE {}
+
+  bool started() const { return started_; }
+
+ private:
+  bool started_;
+
+  DISALLOW_COPY_AND_ASSIGN(MockQuicServerInfo);
+};
+
+class MockQuicServerInfoFactory : public QuicServerInfoFactory {
+ public:
+  MockQuicServerInfoFactory() {}
+  virtual ~MockQuicServerInfoFactory() {}
+
+  virtual QuicServerInfo* GetForServer(
+      const QuicSessionKey& server_key) OVERRIDE {
+    server_keys_.push_back(server_key);
+    return new MockQuicServerInfo(server_key);
+  }
+
+  // The keys GetForServer was called with, in order.
+  const vector<QuicSessionKey>& server_keys() const { return server_keys_; }
+
+ private:
+  vector<QuicSessionKey> server_keys_;
+
+  DISALLOW_COPY_AND_ASSIGN(MockQuicServerInfoFactory);
+};
+
 }  // namespace anonymous
 
 class QuicStreamFactoryPeer {
@@ -70,6 +127,20 @@ class QuicStreamFactoryPeer {
     return factory->CreateIfSessionExists(server_key, net_log);
   }
 
+  static bool HasPreloadedServerInfo(QuicStreamFactory* factory,
+                                     const QuicSessionKey& server_key) {
+    return ContainsKey(factory->preloaded_server_infos_, server_key);
+  }
+
+  static size_t GetNumPreloadedServerInfos(QuicStreamFactory* factory) {
+    return factory->preloaded_server_infos_.size();
+  }
+
+  static QuicServerInfo* GetServerInfo(QuicStreamFactory* factory,
+                                       const QuicSessionKey& server_key) {
+    return factory->GetServerInfo(server_key);
+  }
+
   static bool IsLiveSession(QuicStreamFactory* factory,
                             QuicClientSession* session) {
     for (QuicStreamFactory::SessionSet::iterator it =
@@ -948,6 +1019,67 @@ TEST_P(QuicStreamFactoryTest, OnIPAddressChanged) {
   EXPECT_TRUE(socket_data2.at_write_eof());
 }
 
+TEST_P(QuicStreamFactoryTest, OnIPAddressChangedWithMigration) {
+  factory_.set_enable_connection_migration(true);
+
+  MockRead reads[] = {
+    MockRead(ASYNC, 0, 0)  // EOF
+  };
+  DeterministicSocketData socket_data(reads, arraysize(reads), NULL, 0);
+  socket_factory_.AddSocketDataProvider(&socket_data);
+  socket_data.StopAfter(1);
+
+  MockRead reads2[] = {
+    MockRead(ASYNC, 0, 0)  // EOF
+  };
+  scoped_ptr<QuicEncryptedPacket> rst(ConstructRstPacket());
+  std::vector<MockWrite> writes2;
+  if (GetParam() > QUIC_VERSION_13)
+    writes2.push_back(MockWrite(ASYNC, rst->data(), rst->length(), 1));
+  DeterministicSocketData socket_data2(reads2, arraysize(reads2),
+                                       writes2.empty() ? NULL  : &writes2[0],
+                                       writes2.size());
+  socket_factory_.AddSocketDataProvider(&socket_data2);
+  socket_data2.StopAfter(1);
+
+  QuicStreamRequest request(&factory_);
+  EXPECT_EQ(ERR_IO_PENDING,
+            request.Request(host_port_pair_,
+                            is_https_,
+                            privacy_mode_,
+                            "GET",
+                            net_log_,
+                            callback_.callback()));
+
+  EXPECT_EQ(OK, callback_.WaitForResult());
+  scoped_ptr<QuicHttpStream> stream = request.ReleaseStream();
+  HttpRequestInfo request_info;
+  EXPECT_EQ(OK, stream->InitializeStream(&request_info,
+                                         DEFAULT_PRIORITY,
+                                         net_log_, CompletionCallback()));
+  QuicClientSession* session = QuicStreamFactoryPeer::GetActiveSession(
+      &factory_, host_port_pair_, is_https_);
+
+  // Change the IP address and verify that the session moved to a new socket,
+  // and that the stream is still waiting for its response.
+  factory_.OnIPAddressChanged();
+  EXPECT_EQ(2u, socket_factory_.udp_client_sockets().size());
+  EXPECT_TRUE(QuicStreamFactoryPeer::IsLiveSession(&factory_, session));
+  EXPECT_EQ(session, QuicStreamFactoryPeer::GetActiveSession(
+      &factory_, host_port_pair_, is_https_));
+  EXPECT_EQ(ERR_IO_PENDING,
+            stream->ReadResponseHeaders(callback_.callback()));
+  EXPECT_TRUE(factory_.require_confirmation());
+
+  stream.reset();  // Will reset stream 5 on the new socket.
+  socket_data2.RunFor(2);
+
+  EXPECT_TRUE(socket_data.at_read_eof());
+  EXPECT_TRUE(socket_data.at_write_eof());
+  EXPECT_TRUE(socket_data2.at_read_eof());
+  EXPECT_TRUE(socket_data2.at_write_eof());
+}
+
 TEST_P(QuicStreamFactoryTest, OnCertAdded) {
   MockRead reads[] = {
     MockRead(ASYNC, 0, 0)  // EOF
@@ -1147,5 +1279,60 @@ TEST_P(QuicStreamFactoryTest, CryptoConfigWhenProofIsInvalid) {
   }
 }
 
+TEST_P(QuicStreamFactoryTest, PreloadServerInfos) {
+  HttpServerPropertiesImpl http_server_properties;
+  const size_t kNumQuicServers =
+      QuicStreamFactory::kMaxPreloadedServerInfos + 2;
+  for (size_t i = 0; i < kNumQuicServers; ++i) {
+    http_server_properties.SetAlternateProtocol(
+        HostPortPair(base::StringPrintf("www%d.example.com",
+                                        static_cast<int>(i)), 80),
+        443, QUIC);
+  }
+  // Servers without QUIC are not preloaded.
+  http_server_properties.SetAlternateProtocol(
+      HostPortPair("spdy.example.com", 443), 443, NPN_SPDY_3);
+
+  QuicStreamFactory factory(
+      &host_resolver_, &socket_factory_, http_server_properties.GetWeakPtr(),
+      cert_verifier_.get(), &crypto_client_stream_factory_,
+      &random_generator_, new MockClock(), kDefaultMaxPacketSize,
+      SupportedVersions(GetParam()), true, true);
+  MockQuicServerInfoFactory server_info_factory;
+  factory.set_quic_server_info_factory(&server_info_factory);
+
+  // The most recently used servers are preloaded, at their alternate port.
+  ASSERT_EQ(QuicStreamFactory::kMaxPreloadedServerInfos,
+            server_info_factory.server_keys().size());
+  EXPECT_EQ(QuicStreamFactory::kMaxPreloadedServerInfos,
+            QuicStreamFactoryPeer::GetNumPreloadedServerInfos(&factory));
+  QuicSessionKey newest_key(HostPortPair("www11.example.com", 443), false,
+                            kPrivacyModeDisabled);
+  QuicSessionKey oldest_key(HostPortPair("www0.example.com", 443), false,
+                            kPrivacyModeDisabled);
+  EXPECT_TRUE(newest_key == server_info_factory.server_keys()[0]);
+  EXPECT_TRUE(QuicStreamFactoryPeer::HasPreloadedServerInfo(&factory,
+                                                            newest_key));
+  EXPECT_FALSE(QuicStreamFactoryPeer::HasPreloadedServerInfo(&factory,
+                                                             oldest_key));
+
+  // A preloaded QuicServerInfo is handed out once, already started.
+  scoped_ptr<QuicServerInfo> server_info(
+      QuicStreamFactoryPeer::GetServerInfo(&factory, newest_key));
+  ASSERT_TRUE(server_info.get());
+  EXPECT_TRUE(static_cast<MockQuicServerInfo*>(server_info.get())->started());
+  EXPECT_FALSE(QuicStreamFactoryPeer::HasPreloadedServerInfo(&factory,
+                                                             newest_key));
+  EXPECT_EQ(QuicStreamFactory::kMaxPreloadedServerInfos,
+            server_info_factory.server_keys().size());
+
+  // Other servers get a new one, started as well.
+  server_info.reset(QuicStreamFactoryPeer::GetServerInfo(&factory, oldest_key));
+  ASSERT_TRUE(server_info.get());
+  EXPECT_TRUE(static_cast<MockQuicServerInfo*>(server_info.get())->started());
+  EXPECT_EQ(QuicStreamFactory::kMaxPreloadedServerInfos + 1,
+            server_info_factory.server_keys().size());
+}
+
 }  // namespace test
 }  // namespace net
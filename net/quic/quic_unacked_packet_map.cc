@@ -10,6 +10,7 @@
 #include "net/quic/quic_utils_chromium.h"
 
 using std::max;
+using std::min;
 
 namespace net {
 
@@ -51,8 +52,45 @@ QuicUnackedPacketMap::TransmissionInfo::TransmissionInfo(
   all_transmissions->insert(sequence_number);
 }
 
+QuicUnackedPacketMap::const_iterator::const_iterator(
+    const QuicUnackedPacketMap* map,
+    QuicPacketSequenceNumber sequence_number)
+    : map_(map),
+      sequence_number_(sequence_number) {
+  SkipRemovedPackets();
+}
+
+const QuicUnackedPacketMap::Entry&
+QuicUnackedPacketMap::const_iterator::operator*() const {
+  return *map_->FindEntry(sequence_number_);
+}
+
+const QuicUnackedPacketMap::Entry*
+QuicUnackedPacketMap::const_iterator::operator->() const {
+  return map_->FindEntry(sequence_number_);
+}
+
+QuicUnackedPacketMap::const_iterator&
+QuicUnackedPacketMap::const_iterator::operator++() {
+  ++sequence_number_;
+  SkipRemovedPackets();
+  return *this;
+}
+
+void QuicUnackedPacketMap::const_iterator::SkipRemovedPackets() {
+  // Packets before this one may have been removed from the front of the map.
+  sequence_number_ = max(sequence_number_, map_->least_unacked_);
+  sequence_number_ = min(sequence_number_, map_->end_sequence_number());
+  while (sequence_number_ < map_->end_sequence_number() &&
+         map_->FindEntry(sequence_number_) == NULL) {
+    ++sequence_number_;
+  }
+}
+
 QuicUnackedPacketMap::QuicUnackedPacketMap()
     : largest_sent_packet_(0),
+      least_unacked_(0),
+      num_unacked_packets_(0),
       bytes_in_flight_(0),
       pending_crypto_packet_count_(0) {
 }
@@ -60,6 +98,9 @@ QuicUnackedPacketMap::QuicUnackedPacketMap()
 QuicUnackedPacketMap::~QuicUnackedPacketMap() {
   for (UnackedPacketMap::iterator it = unacked_packets_.begin();
        it != unacked_packets_.end(); ++it) {
+    if (IsRemoved(*it)) {
+      continue;
+    }
     delete it->second.retransmittable_frames;
     // Only delete all_transmissions once, for the newest packet.
     if (it->first == *it->second.all_transmissions->rbegin()) {
@@ -73,18 +114,21 @@ QuicUnackedPacketMap::~QuicUnackedPacketMap() {
 void QuicUnackedPacketMap::AddPacket(
     const SerializedPacket& serialized_packet) {
   if (!unacked_packets_.empty()) {
-    bool is_old_packet = unacked_packets_.rbegin()->first >=
+    bool is_old_packet = unacked_packets_.back().first >=
         serialized_packet.sequence_number;
     LOG_IF(DFATAL, is_old_packet) << "Old packet serialized: "
                                   << serialized_packet.sequence_number
                                   << " vs: "
-                                  << unacked_packets_.rbegin()->first;
+                                  << unacked_packets_.back().first;
+    if (is_old_packet) {
+      return;
+    }
   }
 
-  unacked_packets_[serialized_packet.sequence_number] =
-      TransmissionInfo(serialized_packet.retransmittable_frames,
-                       serialized_packet.sequence_number,
-                       serialized_packet.sequence_number_length);
+  AddEntry(serialized_packet.sequence_number,
+           TransmissionInfo(serialized_packet.retransmittable_frames,
+                            serialized_packet.sequence_number,
+                            serialized_packet.sequence_number_length));
   if (serialized_packet.retransmittable_frames != NULL &&
       serialized_packet.retransmittable_frames->HasCryptoHandshake()
           == IS_HANDSHAKE) {
@@ -95,13 +139,13 @@ void QuicUnackedPacketMap::AddPacket(
 void QuicUnackedPacketMap::OnRetransmittedPacket(
     QuicPacketSequenceNumber old_sequence_number,
     QuicPacketSequenceNumber new_sequence_number) {
-  DCHECK(ContainsKey(unacked_packets_, old_sequence_number));
+  DCHECK(IsUnacked(old_sequence_number));
   DCHECK(unacked_packets_.empty() ||
-         unacked_packets_.rbegin()->first < new_sequence_number);
+         unacked_packets_.back().first < new_sequence_number);
 
   // TODO(ianswett): Discard and lose the packet lazily instead of immediately.
   TransmissionInfo* transmission_info =
-      FindOrNull(unacked_packets_, old_sequence_number);
+      &FindEntry(old_sequence_number)->second;
   RetransmittableFrames* frames = transmission_info->retransmittable_frames;
   LOG_IF(DFATAL, frames == NULL) << "Attempt to retransmit packet with no "
                                  << "retransmittable frames: "
@@ -110,83 +154,92 @@ void QuicUnackedPacketMap::OnRetransmittedPacket(
   // We keep the old packet in the unacked packet list until it, or one of
   // the retransmissions of it are acked.
   transmission_info->retransmittable_frames = NULL;
-  unacked_packets_[new_sequence_number] =
-      TransmissionInfo(frames,
-                       new_sequence_number,
-                       transmission_info->sequence_number_length,
-                       transmission_info->all_transmissions);
+  // Copy what is needed before adding the new entry, which may invalidate
+  // |transmission_info|.
+  QuicSequenceNumberLength sequence_number_length =
+      transmission_info->sequence_number_length;
+  SequenceNumberSet* all_transmissions = transmission_info->all_transmissions;
+  AddEntry(new_sequence_number,
+           TransmissionInfo(frames,
+                            new_sequence_number,
+                            sequence_number_length,
+                            all_transmissions));
 }
 
 void QuicUnackedPacketMap::ClearPreviousRetransmissions(size_t num_to_clear) {
-  UnackedPacketMap::iterator it = unacked_packets_.begin();
-  while (it != unacked_packets_.end() && num_to_clear > 0) {
-    QuicPacketSequenceNumber sequence_number = it->first;
+  while (!unacked_packets_.empty() && num_to_clear > 0) {
+    // The first entry is never a removed one.
+    const Entry& entry = unacked_packets_.front();
     // If this is a pending packet, or has retransmittable data, then there is
     // no point in clearing out any further packets, because they would not
     // affect the high water mark.
-    if (it->second.pending || it->second.retransmittable_frames != NULL) {
+    if (entry.second.pending || entry.second.retransmittable_frames != NULL) {
       break;
     }
 
-    ++it;
-    RemovePacket(sequence_number);
+    RemovePacket(entry.first);
     --num_to_clear;
   }
 }
 
 bool QuicUnackedPacketMap::HasRetransmittableFrames(
     QuicPacketSequenceNumber sequence_number) const {
-  const TransmissionInfo* transmission_info =
-      FindOrNull(unacked_packets_, sequence_number);
-  if (transmission_info == NULL) {
+  const Entry* entry = FindEntry(sequence_number);
+  if (entry == NULL) {
     return false;
   }
 
-  return transmission_info->retransmittable_frames != NULL;
+  return entry->second.retransmittable_frames != NULL;
 }
 
 void QuicUnackedPacketMap::NackPacket(QuicPacketSequenceNumber sequence_number,
                                       size_t min_nacks) {
-  UnackedPacketMap::iterator it = unacked_packets_.find(sequence_number);
-  if (it == unacked_packets_.end()) {
+  Entry* entry = FindEntry(sequence_number);
+  if (entry == NULL) {
     LOG(DFATAL) << "NackPacket called for packet that is not unacked: "
                 << sequence_number;
     return;
   }
 
-  it->second.nack_count = max(min_nacks, it->second.nack_count);
+  entry->second.nack_count = max(min_nacks, entry->second.nack_count);
 }
 
 void QuicUnackedPacketMap::RemovePacket(
     QuicPacketSequenceNumber sequence_number) {
-  UnackedPacketMap::iterator it = unacked_packets_.find(sequence_number);
-  if (it == unacked_packets_.end()) {
+  Entry* entry = FindEntry(sequence_number);
+  if (entry == NULL) {
     LOG(DFATAL) << "packet is not unacked: " << sequence_number;
     return;
   }
-  const TransmissionInfo& transmission_info = it->second;
-  transmission_info.all_transmissions->erase(sequence_number);
-  if (transmission_info.all_transmissions->empty()) {
-    delete transmission_info.all_transmissions;
+  TransmissionInfo* transmission_info = &entry->second;
+  transmission_info->all_transmissions->erase(sequence_number);
+  if (transmission_info->all_transmissions->empty()) {
+    delete transmission_info->all_transmissions;
   }
-  if (transmission_info.retransmittable_frames != NULL) {
-    if (transmission_info.retransmittable_frames->HasCryptoHandshake()
+  if (transmission_info->retransmittable_frames != NULL) {
+    if (transmission_info->retransmittable_frames->HasCryptoHandshake()
             == IS_HANDSHAKE) {
       --pending_crypto_packet_count_;
     }
-    delete transmission_info.retransmittable_frames;
+    delete transmission_info->retransmittable_frames;
+  }
+  *transmission_info = TransmissionInfo();
+  --num_unacked_packets_;
+
+  while (!unacked_packets_.empty() && IsRemoved(unacked_packets_.front())) {
+    unacked_packets_.pop_front();
+    ++least_unacked_;
   }
-  unacked_packets_.erase(it);
 }
 
 void QuicUnackedPacketMap::NeuterPacket(
     QuicPacketSequenceNumber sequence_number) {
-  UnackedPacketMap::iterator it = unacked_packets_.find(sequence_number);
-  if (it == unacked_packets_.end()) {
+  Entry* entry = FindEntry(sequence_number);
+  if (entry == NULL) {
     LOG(DFATAL) << "packet is not unacked: " << sequence_number;
     return;
   }
-  TransmissionInfo* transmission_info = &it->second;
+  TransmissionInfo* transmission_info = &entry->second;
   if (transmission_info->all_transmissions->size() > 1) {
     transmission_info->all_transmissions->erase(sequence_number);
     transmission_info->all_transmissions = new SequenceNumberSet();
@@ -200,33 +253,32 @@ void QuicUnackedPacketMap::NeuterPacket(
 
 bool QuicUnackedPacketMap::IsUnacked(
     QuicPacketSequenceNumber sequence_number) const {
-  return ContainsKey(unacked_packets_, sequence_number);
+  return FindEntry(sequence_number) != NULL;
 }
 
 bool QuicUnackedPacketMap::IsPending(
     QuicPacketSequenceNumber sequence_number) const {
-  const TransmissionInfo* transmission_info =
-      FindOrNull(unacked_packets_, sequence_number);
-  return transmission_info != NULL && transmission_info->pending;
+  const Entry* entry = FindEntry(sequence_number);
+  return entry != NULL && entry->second.pending;
 }
 
 void QuicUnackedPacketMap::SetNotPending(
     QuicPacketSequenceNumber sequence_number) {
-  UnackedPacketMap::iterator it = unacked_packets_.find(sequence_number);
-  if (it == unacked_packets_.end()) {
+  Entry* entry = FindEntry(sequence_number);
+  if (entry == NULL) {
     LOG(DFATAL) << "SetNotPending called for packet that is not unacked: "
                 << sequence_number;
     return;
   }
-  if (it->second.pending) {
-    LOG_IF(DFATAL, bytes_in_flight_ < it->second.bytes_sent);
-    bytes_in_flight_ -= it->second.bytes_sent;
-    it->second.pending = false;
+  if (entry->second.pending) {
+    LOG_IF(DFATAL, bytes_in_flight_ < entry->second.bytes_sent);
+    bytes_in_flight_ -= entry->second.bytes_sent;
+    entry->second.pending = false;
   }
 }
 
 bool QuicUnackedPacketMap::HasUnackedPackets() const {
-  return !unacked_packets_.empty();
+  return num_unacked_packets_ > 0;
 }
 
 bool QuicUnackedPacketMap::HasPendingPackets() const {
@@ -242,7 +294,9 @@ bool QuicUnackedPacketMap::HasPendingPackets() const {
 const QuicUnackedPacketMap::TransmissionInfo&
     QuicUnackedPacketMap::GetTransmissionInfo(
         QuicPacketSequenceNumber sequence_number) const {
-  return unacked_packets_.find(sequence_number)->second;
+  const Entry* entry = FindEntry(sequence_number);
+  DCHECK(entry != NULL) << "Packet is not unacked: " << sequence_number;
+  return entry->second;
 }
 
 QuicTime QuicUnackedPacketMap::GetLastPacketSentTime() const {
@@ -272,7 +326,7 @@ QuicTime QuicUnackedPacketMap::GetFirstPendingPacketSentTime() const {
 }
 
 size_t QuicUnackedPacketMap::GetNumUnackedPackets() const {
-  return unacked_packets_.size();
+  return num_unacked_packets_;
 }
 
 bool QuicUnackedPacketMap::HasMultiplePendingPackets() const {
@@ -321,14 +375,13 @@ QuicUnackedPacketMap::GetLeastUnackedSentPacket() const {
     return 0;
   }
 
-  return unacked_packets_.begin()->first;
+  return unacked_packets_.front().first;
 }
 
 SequenceNumberSet QuicUnackedPacketMap::GetUnackedPackets() const {
   SequenceNumberSet unacked_packets;
-  for (UnackedPacketMap::const_iterator it = unacked_packets_.begin();
-       it != unacked_packets_.end(); ++it) {
-    unacked_packets.insert(it->first);
+  for (const_iterator it = begin(); it != end(); ++it) {
+    unacked_packets.insert(unacked_packets.end(), it->first);
   }
   return unacked_packets;
 }
@@ -337,19 +390,64 @@ void QuicUnackedPacketMap::SetPending(QuicPacketSequenceNumber sequence_number,
                                       QuicTime sent_time,
                                       QuicByteCount bytes_sent) {
   DCHECK_LT(0u, sequence_number);
-  UnackedPacketMap::iterator it = unacked_packets_.find(sequence_number);
-  if (it == unacked_packets_.end()) {
+  Entry* entry = FindEntry(sequence_number);
+  if (entry == NULL) {
     LOG(DFATAL) << "OnPacketSent called for packet that is not unacked: "
                 << sequence_number;
     return;
   }
-  DCHECK(!it->second.pending);
+  DCHECK(!entry->second.pending);
 
   largest_sent_packet_ = max(sequence_number, largest_sent_packet_);
   bytes_in_flight_ += bytes_sent;
-  it->second.sent_time = sent_time;
-  it->second.bytes_sent = bytes_sent;
-  it->second.pending = true;
+  entry->second.sent_time = sent_time;
+  entry->second.bytes_sent = bytes_sent;
+  entry->second.pending = true;
+}
+
+QuicUnackedPacketMap::const_iterator QuicUnackedPacketMap::begin() const {
+  return const_iterator(this, least_unacked_);
+}
+
+QuicUnackedPacketMap::const_iterator QuicUnackedPacketMap::end() const {
+  return const_iterator(this, end_sequence_number());
+}
+
+QuicUnackedPacketMap::const_iterator QuicUnackedPacketMap::lower_bound(
+    QuicPacketSequenceNumber sequence_number) const {
+  return const_iterator(this, sequence_number);
+}
+
+const QuicUnackedPacketMap::Entry* QuicUnackedPacketMap::FindEntry(
+    QuicPacketSequenceNumber sequence_number) const {
+  if (sequence_number < least_unacked_ ||
+      sequence_number >= end_sequence_number()) {
+    return NULL;
+  }
+  const Entry& entry = unacked_packets_[sequence_number - least_unacked_];
+  return IsRemoved(entry) ? NULL : &entry;
+}
+
+QuicUnackedPacketMap::Entry* QuicUnackedPacketMap::FindEntry(
+    QuicPacketSequenceNumber sequence_number) {
+  return const_cast<Entry*>(
+      static_cast<const QuicUnackedPacketMap*>(this)->FindEntry(
+          sequence_number));
+}
+
+void QuicUnackedPacketMap::AddEntry(
+    QuicPacketSequenceNumber sequence_number,
+    const TransmissionInfo& transmission_info) {
+  if (unacked_packets_.empty()) {
+    least_unacked_ = sequence_number;
+  }
+  DCHECK_GE(sequence_number, end_sequence_number());
+  while (end_sequence_number() < sequence_number) {
+    unacked_packets_.push_back(
+        Entry(end_sequence_number(), TransmissionInfo()));
+  }
+  unacked_packets_.push_back(Entry(sequence_number, transmission_info));
+  ++num_unacked_packets_;
 }
 
 }  // namespace net
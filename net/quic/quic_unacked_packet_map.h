@@ -5,7 +5,9 @@
 #ifndef NET_QUIC_QUIC_UNACKED_PACKET_MAP_H_
 #define NET_QUIC_QUIC_UNACKED_PACKET_MAP_H_
 
-#include "net/base/linked_hash_map.h"
+#include <deque>
+#include <utility>
+
 #include "net/quic/quic_protocol.h"
 
 namespace net {
@@ -13,6 +15,10 @@ namespace net {
 // Class which tracks unacked packets, including those packets which are
 // currently pending, and the relationship between packets which
 // contain the same data (via retransmissions)
+//
+// Packets are stored in a deque indexed by their sequence number, starting at
+// the least unacked packet, so looking up a packet takes constant time and
+// iterating visits the packets in order of sequence number.
 class NET_EXPORT_PRIVATE QuicUnackedPacketMap {
  public:
   struct NET_EXPORT_PRIVATE TransmissionInfo {
@@ -111,13 +117,42 @@ class NET_EXPORT_PRIVATE QuicUnackedPacketMap {
   // in the ack frame for new acks.
   void ClearPreviousRetransmissions(size_t num_to_clear);
 
-  typedef linked_hash_map<QuicPacketSequenceNumber,
-                          TransmissionInfo> UnackedPacketMap;
+  typedef std::pair<QuicPacketSequenceNumber, TransmissionInfo> Entry;
+
+  // Iterates over the unacked packets in order of sequence number.  Unlike
+  // iterators into the deque, it remains valid when other packets are
+  // removed from the map.
+  class NET_EXPORT_PRIVATE const_iterator {
+   public:
+    const_iterator(const QuicUnackedPacketMap* map,
+                   QuicPacketSequenceNumber sequence_number);
+
+    const Entry& operator*() const;
+    const Entry* operator->() const;
+    const_iterator& operator++();
+
+    bool operator==(const const_iterator& other) const {
+      return sequence_number_ == other.sequence_number_;
+    }
+    bool operator!=(const const_iterator& other) const {
+      return sequence_number_ != other.sequence_number_;
+    }
+
+   private:
+    // Moves forward to the first unacked packet at or after
+    // |sequence_number_|, or to the end of the map.
+    void SkipRemovedPackets();
+
+    const QuicUnackedPacketMap* map_;
+    QuicPacketSequenceNumber sequence_number_;
+  };
 
-  typedef UnackedPacketMap::const_iterator const_iterator;
+  const_iterator begin() const;
+  const_iterator end() const;
 
-  const_iterator begin() const { return unacked_packets_.begin(); }
-  const_iterator end() const { return unacked_packets_.end(); }
+  // Returns an iterator to the first unacked packet whose sequence number is
+  // not less than |sequence_number|.
+  const_iterator lower_bound(QuicPacketSequenceNumber sequence_number) const;
 
   // Returns true if there are unacked packets that are pending.
   bool HasPendingPackets() const;
@@ -152,6 +187,28 @@ class NET_EXPORT_PRIVATE QuicUnackedPacketMap {
   void NeuterPacket(QuicPacketSequenceNumber sequence_number);
 
  private:
+  // Entries of packets which have been removed, or were never added, have no
+  // all_transmissions.
+  typedef std::deque<Entry> UnackedPacketMap;
+
+  static bool IsRemoved(const Entry& entry) {
+    return entry.second.all_transmissions == NULL;
+  }
+
+  // Returns the entry of |sequence_number|, or NULL if it is not unacked.
+  const Entry* FindEntry(QuicPacketSequenceNumber sequence_number) const;
+  Entry* FindEntry(QuicPacketSequenceNumber sequence_number);
+
+  // Appends the entry for |sequence_number|, after empty entries for any
+  // sequence numbers skipped since the last one.
+  void AddEntry(QuicPacketSequenceNumber sequence_number,
+                const TransmissionInfo& transmission_info);
+
+  // The sequence number one past the last entry.
+  QuicPacketSequenceNumber end_sequence_number() const {
+    return least_unacked_ + unacked_packets_.size();
+  }
+
   QuicPacketSequenceNumber largest_sent_packet_;
 
   // Newly serialized retransmittable and fec packets are added to this map,
@@ -162,7 +219,12 @@ class NET_EXPORT_PRIVATE QuicUnackedPacketMap {
   // If the old packet is acked before the new packet, then the old entry will
   // be removed from the map and the new entry's retransmittable frames will be
   // set to NULL.
+  // The first entry is always unacked, so after packets are removed from the
+  // front, the removed entries which follow are popped too.
   UnackedPacketMap unacked_packets_;
+  // The sequence number of the first entry of |unacked_packets_|.
+  QuicPacketSequenceNumber least_unacked_;
+  size_t num_unacked_packets_;
 
   size_t bytes_in_flight_;
   // Number of outstanding crypto handshake packets.
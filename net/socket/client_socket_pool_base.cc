@@ -38,6 +38,16 @@ const int kCleanupInterval = 10;  // DO NOT INCREASE THIS TIMEOUT.
 // after a certain timeout has passed without receiving an ACK.
 bool g_connect_backup_jobs_enabled = true;
 
+// An idle socket can't be reused if it is disconnected or has received data
+// unexpectedly (hence no longer idle).  The unread data would be mistaken for
+// the beginning of the next response if we were to reuse the socket for a new
+// request.
+bool IsReusableIdleSocket(const StreamSocket* socket) {
+  if (socket->WasEverUsed())
+    return socket->IsConnectedAndIdle();
+  return socket->IsConnected();
+}
+
 }  // namespace
 
 ConnectJob::ConnectJob(const std::string& group_name,
@@ -178,6 +188,7 @@ ClientSocketPoolBaseHelper::~ClientSocketPoolBaseHelper() {
   // cleaned up prior to |this| being destroyed.
   FlushWithError(ERR_ABORTED);
   DCHECK(group_map_.empty());
+  DCHECK(idle_socket_expiry_map_.empty());
   DCHECK(pending_callback_map_.empty());
   DCHECK_EQ(0, connecting_socket_count_);
   CHECK(higher_pools_.empty());
@@ -224,12 +235,7 @@ bool ClientSocketPoolBaseHelper::IsStalled() const {
   // |max_sockets_per_group_|.  (If the number of sockets is equal to
   // |max_sockets_per_group_|, then the request is stalled on the group limit,
   // which does not count.)
-  for (GroupMap::const_iterator it = group_map_.begin();
-       it != group_map_.end(); ++it) {
-    if (it->second->IsStalledOnPoolMaxSockets(max_sockets_per_group_))
-      return true;
-  }
-  return false;
+  return FindTopStalledGroup(NULL, NULL);
 }
 
 void ClientSocketPoolBaseHelper::AddLowerLayeredPool(
@@ -274,6 +280,7 @@ int ClientSocketPoolBaseHelper::RequestSocket(
     request.reset();
   } else {
     group->InsertPendingRequest(request.Pass());
+    pending_request_groups_.insert(group_name);
     // Have to do this asynchronously, as closing sockets in higher level pools
     // call back in to |this|, which will cause all sorts of fun and exciting
     // re-entrancy issues if the socket pool is doing something else at the
@@ -404,7 +411,7 @@ int ClientSocketPoolBaseHelper::RequestSocketInternal(
                     connect_job->connect_timing(), handle, base::TimeDelta(),
                     group, request.net_log());
     } else {
-      AddIdleSocket(connect_job->PassSocket(), group);
+      AddIdleSocket(connect_job->PassSocket(), group_name, group);
     }
   } else if (rv == ERR_IO_PENDING) {
     // If we don't have any sockets in this group, set a timer for potentially
@@ -449,6 +456,7 @@ bool ClientSocketPoolBaseHelper::AssignIdleSocketToRequest(
   for (std::list<IdleSocket>::iterator it = idle_sockets->begin();
        it != idle_sockets->end();) {
     if (!it->socket->IsConnectedAndIdle()) {
+      RemoveFromIdleSocketExpiryMap(*it);
       DecrementIdleCount();
       delete it->socket;
       it = idle_sockets->erase(it);
@@ -470,6 +478,7 @@ bool ClientSocketPoolBaseHelper::AssignIdleSocketToRequest(
     idle_socket_it = idle_sockets->begin();
 
   if (idle_socket_it != idle_sockets->end()) {
+    RemoveFromIdleSocketExpiryMap(*idle_socket_it);
     DecrementIdleCount();
     base::TimeDelta idle_time =
         base::TimeTicks::Now() - idle_socket_it->start_time;
@@ -648,52 +657,68 @@ base::DictionaryValue* ClientSocketPoolBaseHelper::GetInfoAsValue(
   return dict;
 }
 
-bool ClientSocketPoolBaseHelper::IdleSocket::ShouldCleanup(
-    base::TimeTicks now,
-    base::TimeDelta timeout) const {
-  bool timed_out = (now - start_time) >= timeout;
-  if (timed_out)
-    return true;
-  if (socket->WasEverUsed())
-    return !socket->IsConnectedAndIdle();
-  return !socket->IsConnected();
-}
-
 void ClientSocketPoolBaseHelper::CleanupIdleSockets(bool force) {
   if (idle_socket_count_ == 0)
     return;
 
-  // Current time value. Retrieving it once at the function start rather than
-  // inside the inner loop, since it shouldn't change by any meaningful amount.
+  // Idle sockets are ordered by expiry time, so only the ones that are due are
+  // visited.
   base::TimeTicks now = base::TimeTicks::Now();
+  while (!idle_socket_expiry_map_.empty()) {
+    IdleSocketExpiryMap::iterator it = idle_socket_expiry_map_.begin();
+    if (!force && it->first.first > now)
+      break;
+    CloseIdleSocket(it);
+  }
+}
 
-  GroupMap::iterator i = group_map_.begin();
-  while (i != group_map_.end()) {
-    Group* group = i->second;
-
-    std::list<IdleSocket>::iterator j = group->mutable_idle_sockets()->begin();
-    while (j != group->idle_sockets().end()) {
-      base::TimeDelta timeout =
-          j->socket->WasEverUsed() ?
-          used_idle_socket_timeout_ : unused_idle_socket_timeout_;
-      if (force || j->ShouldCleanup(now, timeout)) {
-        delete j->socket;
-        j = group->mutable_idle_sockets()->erase(j);
-        DecrementIdleCount();
-      } else {
-        ++j;
-      }
-    }
+void ClientSocketPoolBaseHelper::OnCleanupTimerFired() {
+  CleanupIdleSockets(false);
 
-    // Delete group if no longer needed.
-    if (group->IsEmpty()) {
-      RemoveGroup(i++);
+  // Sockets that haven't timed out yet must still be checked for having been
+  // disconnected or having received data.  See the comment on
+  // kCleanupInterval.
+  IdleSocketExpiryMap::iterator it = idle_socket_expiry_map_.begin();
+  while (it != idle_socket_expiry_map_.end()) {
+    if (IsReusableIdleSocket(it->first.second)) {
+      ++it;
     } else {
-      ++i;
+      // CloseIdleSocket() only erases |it| from the map, so the incremented
+      // iterator stays valid.
+      CloseIdleSocket(it++);
     }
   }
 }
 
+void ClientSocketPoolBaseHelper::CloseIdleSocket(
+    IdleSocketExpiryMap::iterator it) {
+  GroupMap::iterator group_it = group_map_.find(it->second);
+  CHECK(group_it != group_map_.end());
+  Group* group = group_it->second;
+
+  std::list<IdleSocket>* idle_sockets = group->mutable_idle_sockets();
+  std::list<IdleSocket>::iterator j = idle_sockets->begin();
+  while (j != idle_sockets->end() && j->socket != it->first.second)
+    ++j;
+  CHECK(j != idle_sockets->end());
+
+  delete j->socket;
+  idle_sockets->erase(j);
+  idle_socket_expiry_map_.erase(it);
+  DecrementIdleCount();
+
+  // Delete group if no longer needed.
+  if (group->IsEmpty())
+    RemoveGroup(group_it);
+}
+
+void ClientSocketPoolBaseHelper::RemoveFromIdleSocketExpiryMap(
+    const IdleSocket& idle_socket) {
+  size_t erased = idle_socket_expiry_map_.erase(
+      IdleSocketExpiryKey(idle_socket.expiry_time, idle_socket.socket));
+  DCHECK_EQ(1u, erased);
+}
+
 ClientSocketPoolBaseHelper::Group* ClientSocketPoolBaseHelper::GetOrCreateGroup(
     const std::string& group_name) {
   GroupMap::iterator it = group_map_.find(group_name);
@@ -712,6 +737,7 @@ void ClientSocketPoolBaseHelper::RemoveGroup(const std::string& group_name) {
 }
 
 void ClientSocketPoolBaseHelper::RemoveGroup(GroupMap::iterator it) {
+  pending_request_groups_.erase(it->first);
   delete it->second;
   group_map_.erase(it);
 }
@@ -777,7 +803,7 @@ void ClientSocketPoolBaseHelper::ReleaseSocket(const std::string& group_name,
       id == pool_generation_number_;
   if (can_reuse) {
     // Add it to the idle list.
-    AddIdleSocket(socket.Pass(), group);
+    AddIdleSocket(socket.Pass(), group_name, group);
     OnAvailableSocketSlot(group_name, group);
   } else {
     socket.reset();
@@ -831,11 +857,17 @@ bool ClientSocketPoolBaseHelper::FindTopStalledGroup(
   Group* top_group = NULL;
   const std::string* top_group_name = NULL;
   bool has_stalled_group = false;
-  for (GroupMap::const_iterator i = group_map_.begin();
-       i != group_map_.end(); ++i) {
-    Group* curr_group = i->second;
-    if (!curr_group->has_pending_requests())
+  std::set<std::string>::iterator i = pending_request_groups_.begin();
+  while (i != pending_request_groups_.end()) {
+    GroupMap::const_iterator group_it = group_map_.find(*i);
+    if (group_it == group_map_.end() ||
+        !group_it->second->has_pending_requests()) {
+      // The group's requests have all been serviced or cancelled since it was
+      // added, so stop tracking it.
+      pending_request_groups_.erase(i++);
       continue;
+    }
+    Group* curr_group = group_it->second;
     if (curr_group->IsStalledOnPoolMaxSockets(max_sockets_per_group_)) {
       if (!group)
         return true;
@@ -844,9 +876,10 @@ bool ClientSocketPoolBaseHelper::FindTopStalledGroup(
           curr_group->TopPendingPriority() > top_group->TopPendingPriority();
       if (has_higher_priority) {
         top_group = curr_group;
-        top_group_name = &i->first;
+        top_group_name = &group_it->first;
       }
     }
+    ++i;
   }
 
   if (top_group) {
@@ -889,7 +922,7 @@ void ClientSocketPoolBaseHelper::OnConnectJobComplete(
       request->net_log().EndEvent(NetLog::TYPE_SOCKET_POOL);
       InvokeUserCallbackLater(request->handle(), request->callback(), result);
     } else {
-      AddIdleSocket(socket.Pass(), group);
+      AddIdleSocket(socket.Pass(), group_name, group);
       OnAvailableSocketSlot(group_name, group);
       CheckForStalledSocketGroups();
     }
@@ -999,13 +1032,19 @@ void ClientSocketPoolBaseHelper::HandOutSocket(
 
 void ClientSocketPoolBaseHelper::AddIdleSocket(
     scoped_ptr<StreamSocket> socket,
+    const std::string& group_name,
     Group* group) {
   DCHECK(socket);
   IdleSocket idle_socket;
   idle_socket.socket = socket.release();
   idle_socket.start_time = base::TimeTicks::Now();
+  idle_socket.expiry_time = idle_socket.start_time +
+      (idle_socket.socket->WasEverUsed() ?
+          used_idle_socket_timeout_ : unused_idle_socket_timeout_);
 
   group->mutable_idle_sockets()->push_back(idle_socket);
+  idle_socket_expiry_map_[IdleSocketExpiryKey(
+      idle_socket.expiry_time, idle_socket.socket)] = group_name;
   IncrementIdleCount();
 }
 
@@ -1072,21 +1111,14 @@ bool ClientSocketPoolBaseHelper::CloseOneIdleSocketExceptInGroup(
     const Group* exception_group) {
   CHECK_GT(idle_socket_count(), 0);
 
-  for (GroupMap::iterator i = group_map_.begin(); i != group_map_.end(); ++i) {
-    Group* group = i->second;
-    if (exception_group == group)
+  for (IdleSocketExpiryMap::iterator it = idle_socket_expiry_map_.begin();
+       it != idle_socket_expiry_map_.end(); ++it) {
+    if (exception_group &&
+        group_map_.find(it->second)->second == exception_group) {
       continue;
-    std::list<IdleSocket>* idle_sockets = group->mutable_idle_sockets();
-
-    if (!idle_sockets->empty()) {
-      delete idle_sockets->front().socket;
-      idle_sockets->pop_front();
-      DecrementIdleCount();
-      if (group->IsEmpty())
-        RemoveGroup(i);
-
-      return true;
     }
+    CloseIdleSocket(it);
+    return true;
   }
 
   return false;
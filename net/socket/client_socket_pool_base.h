@@ -28,6 +28,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/basictypes.h"
@@ -303,11 +304,7 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
   // sockets that timed out or can't be reused.  Made public for testing.
   void CleanupIdleSockets(bool force);
 
-  // Closes one idle socket.  Picks the first one encountered.
-  // TODO(willchan): Consider a better algorithm for doing this.  Perhaps we
-  // should keep an ordered list of idle sockets, and close them in order.
-  // Requires maintaining more state.  It's not clear if it's worth it since
-  // I'm not sure if we hit this situation often.
+  // Closes one idle socket.  Picks the one closest to timing out.
   bool CloseOneIdleSocket();
 
   // Checks higher layered pools to see if they can close an idle connection.
@@ -335,24 +332,22 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
  private:
   friend class base::RefCounted<ClientSocketPoolBaseHelper>;
 
-  // Entry for a persistent socket which became idle at time |start_time|.
+  // Entry for a persistent socket which became idle at time |start_time|, and
+  // which times out at |expiry_time|.
   struct IdleSocket {
     IdleSocket() : socket(NULL) {}
 
-    // An idle socket should be removed if it can't be reused, or has been idle
-    // for too long. |now| is the current time value (TimeTicks::Now()).
-    // |timeout| is the length of time to wait before timing out an idle socket.
-    //
-    // An idle socket can't be reused if it is disconnected or has received
-    // data unexpectedly (hence no longer idle).  The unread data would be
-    // mistaken for the beginning of the next response if we were to reuse the
-    // socket for a new request.
-    bool ShouldCleanup(base::TimeTicks now, base::TimeDelta timeout) const;
-
     StreamSocket* socket;
     base::TimeTicks start_time;
+    base::TimeTicks expiry_time;
   };
 
+  // Index of the idle sockets of all groups, ordered by the time at which they
+  // time out (ties are broken by socket address).  Maps to the name of the
+  // group owning the socket.
+  typedef std::pair<base::TimeTicks, const StreamSocket*> IdleSocketExpiryKey;
+  typedef std::map<IdleSocketExpiryKey, std::string> IdleSocketExpiryMap;
+
   typedef PriorityQueue<const Request*> RequestQueue;
   typedef std::map<const ClientSocketHandle*, const Request*> RequestMap;
 
@@ -506,17 +501,23 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
   // Start cleanup timer for idle sockets.
   void StartIdleSocketTimer();
 
-  // Scans the group map for groups which have an available socket slot and
-  // at least one pending request. Returns true if any groups are stalled, and
+  // Scans the groups with pending requests for ones which have an available
+  // socket slot. Returns true if any groups are stalled, and
   // if so (and if both |group| and |group_name| are not NULL), fills |group|
   // and |group_name| with data of the stalled group having highest priority.
   bool FindTopStalledGroup(Group** group, std::string* group_name) const;
 
   // Called when timer_ fires.  This method scans the idle sockets removing
   // sockets that timed out or can't be reused.
-  void OnCleanupTimerFired() {
-    CleanupIdleSockets(false);
-  }
+  void OnCleanupTimerFired();
+
+  // Closes the idle socket referred to by |it|, removing its group if it is no
+  // longer needed.
+  void CloseIdleSocket(IdleSocketExpiryMap::iterator it);
+
+  // Removes |idle_socket|, which its group no longer holds, from
+  // |idle_socket_expiry_map_|.
+  void RemoveFromIdleSocketExpiryMap(const IdleSocket& idle_socket);
 
   // Removes |job| from |group|, which must already own |job|.
   void RemoveConnectJob(ConnectJob* job, Group* group);
@@ -536,8 +537,11 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
                      Group* group,
                      const BoundNetLog& net_log);
 
-  // Adds |socket| to the list of idle sockets for |group|.
-  void AddIdleSocket(scoped_ptr<StreamSocket> socket, Group* group);
+  // Adds |socket| to the list of idle sockets for |group|, which is named
+  // |group_name|.
+  void AddIdleSocket(scoped_ptr<StreamSocket> socket,
+                     const std::string& group_name,
+                     Group* group);
 
   // Iterates through |group_map_|, canceling all ConnectJobs and deleting
   // groups if they are no longer needed.
@@ -590,6 +594,16 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
 
   GroupMap group_map_;
 
+  // Names of the groups which may have pending requests.  Entries are added
+  // when a request is queued and pruned lazily by FindTopStalledGroup(), so
+  // that the scan for stalled groups doesn't visit groups that only hold idle
+  // or active sockets.
+  mutable std::set<std::string> pending_request_groups_;
+
+  // All idle sockets, ordered by expiry time.  Holds exactly
+  // |idle_socket_count_| entries.
+  IdleSocketExpiryMap idle_socket_expiry_map_;
+
   // Map of the ClientSocketHandles for which we have a pending Task to invoke a
   // callback.  This is necessary since, before we invoke said callback, it's
   // possible that the request is cancelled.
@@ -2384,6 +2384,26 @@ TEST_F(ClientSocketPoolBaseTest, CleanupTimedOutIdleSockets) {
       entries, 1, NetLog::TYPE_SOCKET_POOL_REUSED_AN_EXISTING_SOCKET));
 }
 
+// Make sure that timed out idle sockets are cleaned up across all groups, and
+// that groups left empty are removed.
+TEST_F(ClientSocketPoolBaseTest, CleanupTimedOutIdleSocketsInAllGroups) {
+  CreatePoolWithIdleTimeouts(
+      kDefaultMaxSockets, kDefaultMaxSocketsPerGroup,
+      base::TimeDelta(),  // Time out unused sockets immediately.
+      base::TimeDelta::FromDays(1));  // Don't time out used sockets.
+
+  connect_job_factory_->set_job_type(TestConnectJob::kMockJob);
+
+  pool_->RequestSockets("a", &params_, 2, BoundNetLog());
+  pool_->RequestSockets("b", &params_, 1, BoundNetLog());
+  ASSERT_EQ(3, pool_->IdleSocketCount());
+
+  pool_->CleanupTimedOutIdleSockets();
+  EXPECT_EQ(0, pool_->IdleSocketCount());
+  EXPECT_FALSE(pool_->HasGroup("a"));
+  EXPECT_FALSE(pool_->HasGroup("b"));
+}
+
 // Make sure that we process all pending requests even when we're stalling
 // because of multiple releasing disconnected sockets.
 TEST_F(ClientSocketPoolBaseTest, MultipleReleasingDisconnectedSockets) {
@@ -4,6 +4,7 @@
 
 #include "net/socket/client_socket_pool_manager.h"
 
+#include <algorithm>
 #include <string>
 
 #include "base/basictypes.h"
@@ -12,6 +13,7 @@
 #include "net/base/load_flags.h"
 #include "net/http/http_proxy_client_socket_pool.h"
 #include "net/http/http_request_info.h"
+#include "net/http/http_server_properties.h"
 #include "net/http/http_stream_factory.h"
 #include "net/proxy/proxy_info.h"
 #include "net/socket/client_socket_handle.h"
@@ -64,6 +66,10 @@ COMPILE_ASSERT(arraysize(g_max_sockets_per_proxy_server) ==
                    HttpNetworkSession::NUM_SOCKET_POOL_TYPES,
                max_sockets_per_proxy_server_length_mismatch);
 
+// The sockets requested for an origin this long after a navigation to it
+// started are counted as the ones its first burst of subresources needs.
+const int kNavigationBurstSeconds = 2;
+
 // The meat of the implementation for the InitSocketHandleForHttpRequest,
 // InitSocketHandleForRawConnect and PreconnectSocketsForHttpRequest methods.
 int InitSocketPoolHelper(const GURL& request_url,
@@ -296,9 +302,48 @@ int InitSocketPoolHelper(const GURL& request_url,
 
 }  // namespace
 
-ClientSocketPoolManager::ClientSocketPoolManager() {}
+ClientSocketPoolManager::ClientSocketPoolManager() : navigation_sockets_(0) {}
 ClientSocketPoolManager::~ClientSocketPoolManager() {}
 
+int ClientSocketPoolManager::OnHttpSocketRequested(
+    const HostPortPair& origin,
+    int load_flags,
+    HttpServerProperties* http_server_properties) {
+  DCHECK(http_server_properties);
+  if (load_flags & LOAD_MAIN_FRAME) {
+    FinishNavigation(http_server_properties);
+    navigation_origin_ = origin;
+    navigation_start_ = base::TimeTicks::Now();
+    navigation_sockets_ = 1;
+    return http_server_properties->GetExpectedConcurrentSockets(origin);
+  }
+
+  if (navigation_sockets_ == 0)
+    return 0;
+
+  if (base::TimeTicks::Now() - navigation_start_ >
+      base::TimeDelta::FromSeconds(kNavigationBurstSeconds)) {
+    FinishNavigation(http_server_properties);
+    return 0;
+  }
+
+  if (origin.Equals(navigation_origin_))
+    ++navigation_sockets_;
+  return 0;
+}
+
+void ClientSocketPoolManager::FinishNavigation(
+    HttpServerProperties* http_server_properties) {
+  if (navigation_sockets_ == 0)
+    return;
+  http_server_properties->SetExpectedConcurrentSockets(
+      navigation_origin_,
+      std::min(navigation_sockets_,
+               max_sockets_per_group(HttpNetworkSession::NORMAL_SOCKET_POOL)));
+  navigation_origin_ = HostPortPair();
+  navigation_sockets_ = 0;
+}
+
 // static
 int ClientSocketPoolManager::max_sockets_per_pool(
     HttpNetworkSession::SocketPoolType pool_type) {
@@ -378,6 +423,28 @@ int InitSocketHandleForHttpRequest(
     const OnHostResolutionCallback& resolution_callback,
     const CompletionCallback& callback) {
   DCHECK(socket_handle);
+  base::WeakPtr<HttpServerProperties> http_server_properties =
+      session->http_server_properties();
+  if (http_server_properties) {
+    HostPortPair origin = HostPortPair::FromURL(request_url);
+    int num_warmup_sockets =
+        session->GetSocketPoolManager(HttpNetworkSession::NORMAL_SOCKET_POOL)
+            ->OnHttpSocketRequested(origin, request_load_flags,
+                                    http_server_properties.get());
+    // Warm up the connections the subresources of the page are expected to
+    // need, while the main resource is fetched. A SPDY session is shared by
+    // all of them.
+    if (num_warmup_sockets > 1 &&
+        !http_server_properties->SupportsSpdy(origin)) {
+      InitSocketPoolHelper(
+          request_url, request_extra_headers, request_load_flags,
+          request_priority, session, proxy_info, force_spdy_over_ssl,
+          want_spdy_over_npn, ssl_config_for_origin, ssl_config_for_proxy,
+          false, privacy_mode, net_log, num_warmup_sockets, NULL,
+          HttpNetworkSession::NORMAL_SOCKET_POOL, OnHostResolutionCallback(),
+          CompletionCallback());
+    }
+  }
   return InitSocketPoolHelper(
       request_url, request_extra_headers, request_load_flags, request_priority,
       session, proxy_info, force_spdy_over_ssl, want_spdy_over_npn,
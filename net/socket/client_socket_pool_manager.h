@@ -9,7 +9,9 @@
 #ifndef NET_SOCKET_CLIENT_SOCKET_POOL_MANAGER_H_
 #define NET_SOCKET_CLIENT_SOCKET_POOL_MANAGER_H_
 
+#include "base/time/time.h"
 #include "net/base/completion_callback.h"
+#include "net/base/host_port_pair.h"
 #include "net/base/net_export.h"
 #include "net/base/request_priority.h"
 #include "net/http/http_network_session.h"
@@ -27,9 +29,9 @@ OnHostResolutionCallback;
 
 class BoundNetLog;
 class ClientSocketHandle;
-class HostPortPair;
 class HttpNetworkSession;
 class HttpProxyClientSocketPool;
+class HttpServerProperties;
 class HttpRequestHeaders;
 class ProxyInfo;
 class TransportClientSocketPool;
@@ -80,6 +82,28 @@ class NET_EXPORT_PRIVATE ClientSocketPoolManager {
   // Creates a Value summary of the state of the socket pools. The caller is
   // responsible for deleting the returned value.
   virtual base::Value* SocketPoolInfoToValue() const = 0;
+
+  // Called when an HTTP transaction requests a socket for |origin|. Learns
+  // how many sockets the subresources of a navigation to an origin request in
+  // the first moments after it starts, and records it in
+  // |http_server_properties|. Returns the number of sockets to connect to
+  // |origin| ahead of time: the learned figure when |load_flags| has
+  // LOAD_MAIN_FRAME, 0 otherwise.
+  int OnHttpSocketRequested(const HostPortPair& origin,
+                            int load_flags,
+                            HttpServerProperties* http_server_properties);
+
+ private:
+  // Records the number of sockets requested during the current navigation,
+  // if any, and stops counting them.
+  void FinishNavigation(HttpServerProperties* http_server_properties);
+
+  // The origin of the latest navigation, while its sockets are counted.
+  HostPortPair navigation_origin_;
+  base::TimeTicks navigation_start_;
+  int navigation_sockets_;
+
+  DISALLOW_COPY_AND_ASSIGN(ClientSocketPoolManager);
 };
 
 // A helper method that uses the passed in proxy information to initialize a
@@ -0,0 +1,79 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/socket/client_socket_pool_manager.h"
+
+#include "net/base/host_port_pair.h"
+#include "net/base/load_flags.h"
+#include "net/http/http_server_properties_impl.h"
+#include "net/socket/mock_client_socket_pool_manager.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+class ClientSocketPoolManagerTest : public testing::Test {
+ protected:
+  ClientSocketPoolManagerTest()
+      : origin_("www.example.com", 443),
+        other_origin_("cdn.example.net", 443) {}
+
+  MockClientSocketPoolManager manager_;
+  HttpServerPropertiesImpl http_server_properties_;
+  const HostPortPair origin_;
+  const HostPortPair other_origin_;
+};
+
+TEST_F(ClientSocketPoolManagerTest, LearnsSocketsOfNavigation) {
+  // Nothing is known about the origin yet.
+  EXPECT_EQ(0, manager_.OnHttpSocketRequested(origin_, LOAD_MAIN_FRAME,
+                                              &http_server_properties_));
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(0, manager_.OnHttpSocketRequested(origin_, LOAD_NORMAL,
+                                                &http_server_properties_));
+  }
+  // Sockets for other origins are not counted.
+  EXPECT_EQ(0, manager_.OnHttpSocketRequested(other_origin_, LOAD_NORMAL,
+                                              &http_server_properties_));
+
+  // The next navigation records the previous one, and preconnects the main
+  // resource and its three subresources.
+  EXPECT_EQ(4, manager_.OnHttpSocketRequested(origin_, LOAD_MAIN_FRAME,
+                                              &http_server_properties_));
+  EXPECT_EQ(4, http_server_properties_.GetExpectedConcurrentSockets(origin_));
+  EXPECT_EQ(0, http_server_properties_.GetExpectedConcurrentSockets(
+                   other_origin_));
+
+  // Navigating elsewhere records that only the main resource was fetched.
+  EXPECT_EQ(0, manager_.OnHttpSocketRequested(other_origin_, LOAD_MAIN_FRAME,
+                                              &http_server_properties_));
+  EXPECT_EQ(1, http_server_properties_.GetExpectedConcurrentSockets(origin_));
+}
+
+TEST_F(ClientSocketPoolManagerTest, LimitedToMaxSocketsPerGroup) {
+  int max_sockets = ClientSocketPoolManager::max_sockets_per_group(
+      HttpNetworkSession::NORMAL_SOCKET_POOL);
+  manager_.OnHttpSocketRequested(origin_, LOAD_MAIN_FRAME,
+                                 &http_server_properties_);
+  for (int i = 0; i < 2 * max_sockets; ++i) {
+    manager_.OnHttpSocketRequested(origin_, LOAD_NORMAL,
+                                   &http_server_properties_);
+  }
+  EXPECT_EQ(max_sockets,
+            manager_.OnHttpSocketRequested(origin_, LOAD_MAIN_FRAME,
+                                           &http_server_properties_));
+}
+
+TEST_F(ClientSocketPoolManagerTest, IgnoresSocketsBeforeNavigation) {
+  EXPECT_EQ(0, manager_.OnHttpSocketRequested(origin_, LOAD_NORMAL,
+                                              &http_server_properties_));
+  EXPECT_EQ(0, manager_.OnHttpSocketRequested(origin_, LOAD_MAIN_FRAME,
+                                              &http_server_properties_));
+  EXPECT_EQ(0, http_server_properties_.GetExpectedConcurrentSockets(origin_));
+}
+
+}  // namespace
+
+}  // namespace net
@@ -6,6 +6,8 @@
 #define NET_SOCKET_SSL_CLIENT_SOCKET_H_
 
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "base/gtest_prod_util.h"
 #include "net/base/completion_callback.h"
@@ -113,6 +115,24 @@ class NET_EXPORT SSLClientSocket : public SSLSocket {
   // sessions.
   static void ClearSessionCache();
 
+  // A list of (server key, serialized session) pairs that can be saved and
+  // restored across restarts. The server key identifies the host, port and
+  // privacy mode of the session, but not the session cache shard.
+  typedef std::vector<std::pair<std::string, std::string> >
+      SessionCacheEntries;
+
+  // Appends to |entries| the resumable sessions cached for sockets using the
+  // session cache shard |ssl_session_cache_shard|, most recently used first.
+  // Does nothing if the SSL library's session cache can't be exported.
+  static void ExportSessionCache(const std::string& ssl_session_cache_shard,
+                                 SessionCacheEntries* entries);
+
+  // Adds |entries|, as returned by ExportSessionCache(), to the session cache
+  // for sockets using the shard |ssl_session_cache_shard|. The shard doesn't
+  // need to be the one the sessions were exported from.
+  static void ImportSessionCache(const std::string& ssl_session_cache_shard,
+                                 const SessionCacheEntries& entries);
+
   virtual bool set_was_npn_negotiated(bool negotiated);
 
   virtual bool was_spdy_negotiated() const;
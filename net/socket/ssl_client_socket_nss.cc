@@ -2816,6 +2816,20 @@ void SSLClientSocket::ClearSessionCache() {
   SSL_ClearSessionCache();
 }
 
+// static
+void SSLClientSocket::ExportSessionCache(
+    const std::string& ssl_session_cache_shard,
+    SessionCacheEntries* entries) {
+  // NSS keeps its client session cache internally and has no API to export
+  // it.
+}
+
+// static
+void SSLClientSocket::ImportSessionCache(
+    const std::string& ssl_session_cache_shard,
+    const SessionCacheEntries& entries) {
+}
+
 bool SSLClientSocketNSS::GetSSLInfo(SSLInfo* ssl_info) {
   EnterFunction("");
   ssl_info->Reset();
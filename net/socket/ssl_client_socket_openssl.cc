@@ -474,6 +474,42 @@ void SSLClientSocket::ClearSessionCache() {
   OpenSSLClientKeyStore::GetInstance()->Flush();
 }
 
+// static
+void SSLClientSocket::ExportSessionCache(
+    const std::string& ssl_session_cache_shard,
+    SessionCacheEntries* entries) {
+  SSLClientSocketOpenSSL::SSLContext* context =
+      SSLClientSocketOpenSSL::SSLContext::GetInstance();
+  // Cache keys are built by GetSocketSessionCacheKey(), and end with
+  // "/<shard>" or, in privacy mode, "/pm/<shard>". Strip the shard so that the
+  // sessions can be imported under a different one.
+  SSLSessionCacheOpenSSL::SerializedSessions sessions;
+  context->session_cache()->ExportSessions("/" + ssl_session_cache_shard,
+                                           &sessions);
+  for (SSLSessionCacheOpenSSL::SerializedSessions::const_iterator it =
+           sessions.begin();
+       it != sessions.end(); ++it) {
+    entries->push_back(std::make_pair(
+        it->first.substr(0, it->first.size() - ssl_session_cache_shard.size()),
+        it->second));
+  }
+}
+
+// static
+void SSLClientSocket::ImportSessionCache(
+    const std::string& ssl_session_cache_shard,
+    const SessionCacheEntries& entries) {
+  SSLClientSocketOpenSSL::SSLContext* context =
+      SSLClientSocketOpenSSL::SSLContext::GetInstance();
+  SSLSessionCacheOpenSSL::SerializedSessions sessions;
+  for (SessionCacheEntries::const_iterator it = entries.begin();
+       it != entries.end(); ++it) {
+    sessions.push_back(
+        std::make_pair(it->first + ssl_session_cache_shard, it->second));
+  }
+  context->session_cache()->ImportSessions(sessions);
+}
+
 SSLClientSocketOpenSSL::SSLClientSocketOpenSSL(
     scoped_ptr<ClientSocketHandle> transport_socket,
     const HostPortPair& host_and_port,
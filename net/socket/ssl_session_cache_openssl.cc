@@ -13,6 +13,8 @@
 #include "base/containers/hash_tables.h"
 #include "base/lazy_instance.h"
 #include "base/logging.h"
+#include "base/stl_util.h"
+#include "base/strings/string_util.h"
 #include "base/synchronization/lock.h"
 
 namespace net {
@@ -246,6 +248,81 @@ class SSLSessionCacheOpenSSLImpl {
         session, GetSSLSessionExIndex(), reinterpret_cast<void*>(1));
   }
 
+  // See SSLSessionCacheOpenSSL::ExportSessions().
+  void ExportSessions(const std::string& key_suffix,
+                      SSLSessionCacheOpenSSL::SerializedSessions* sessions) {
+    base::AutoLock locked(lock_);
+    long now = static_cast<long>(::time(NULL));
+    for (MRUSessionList::const_iterator it = ordering_.begin();
+         it != ordering_.end(); ++it) {
+      SSL_SESSION* session = *it;
+      if (!SSL_SESSION_get_ex_data(session, GetSSLSessionExIndex()))
+        continue;
+      if (session->time + session->timeout <= now)
+        continue;
+
+      SessionIdIndex::const_iterator id_it = id_index_.find(SessionId(session));
+      DCHECK(id_it != id_index_.end());
+      const std::string& cache_key = id_it->second->first;
+      if (!EndsWith(cache_key, key_suffix, true))
+        continue;
+
+      int length = i2d_SSL_SESSION(session, NULL);
+      if (length <= 0)
+        continue;
+      std::string data(length, '\0');
+      unsigned char* out =
+          reinterpret_cast<unsigned char*>(string_as_array(&data));
+      if (i2d_SSL_SESSION(session, &out) != length)
+        continue;
+
+      sessions->push_back(std::make_pair(cache_key, data));
+    }
+  }
+
+  // See SSLSessionCacheOpenSSL::ImportSessions().
+  size_t ImportSessions(
+      const SSLSessionCacheOpenSSL::SerializedSessions& sessions) {
+    base::AutoLock locked(lock_);
+    long now = static_cast<long>(::time(NULL));
+    size_t imported = 0;
+    for (SSLSessionCacheOpenSSL::SerializedSessions::const_iterator it =
+             sessions.begin();
+         it != sessions.end() && key_index_.size() < config_.max_entries;
+         ++it) {
+      const std::string& cache_key = it->first;
+      if (cache_key.empty() || key_index_.find(cache_key) != key_index_.end())
+        continue;
+
+      const unsigned char* in =
+          reinterpret_cast<const unsigned char*>(it->second.data());
+      SSL_SESSION* session =
+          d2i_SSL_SESSION(NULL, &in, static_cast<long>(it->second.size()));
+      if (!session)
+        continue;
+      if (session->session_id_length == 0 ||
+          session->time + session->timeout <= now ||
+          id_index_.find(SessionId(session)) != id_index_.end()) {
+        SSL_SESSION_free(session);
+        continue;
+      }
+
+      DVLOG(2) << "Import session " << session << " for " << cache_key;
+      SSL_SESSION_set_ex_data(
+          session, GetSSLSessionExIndex(), reinterpret_cast<void*>(1));
+      ordering_.push_back(session);
+      MRUSessionList::iterator node = ordering_.end();
+      --node;
+      KeyIndex::iterator key_it =
+          key_index_.insert(std::make_pair(cache_key, node)).first;
+      id_index_[SessionId(session)] = key_it;
+      ++imported;
+    }
+
+    DCHECK_EQ(key_index_.size(), id_index_.size());
+    return imported;
+  }
+
   // Flush all entries from the cache.
   void Flush() {
     base::AutoLock lock(lock_);
@@ -505,4 +582,15 @@ void SSLSessionCacheOpenSSL::MarkSSLSessionAsGood(SSL* ssl) {
 
 void SSLSessionCacheOpenSSL::Flush() { impl_->Flush(); }
 
+void SSLSessionCacheOpenSSL::ExportSessions(
+    const std::string& key_suffix,
+    SerializedSessions* sessions) const {
+  impl_->ExportSessions(key_suffix, sessions);
+}
+
+size_t SSLSessionCacheOpenSSL::ImportSessions(
+    const SerializedSessions& sessions) {
+  return impl_->ImportSessions(sessions);
+}
+
 }  // namespace net
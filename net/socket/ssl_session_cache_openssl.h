@@ -6,6 +6,8 @@
 #define NET_SOCKET_SSL_SESSION_CACHE_OPENSSL_H
 
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "net/base/net_export.h"
@@ -66,6 +68,10 @@ class NET_EXPORT SSLSessionCacheOpenSSL {
     int timeout_seconds;
   };
 
+  // A list of (cache key, serialized session) pairs, used to save sessions
+  // across restarts. Sessions are serialized with i2d_SSL_SESSION().
+  typedef std::vector<std::pair<std::string, std::string> > SerializedSessions;
+
   SSLSessionCacheOpenSSL() : impl_(NULL) {}
 
   // Construct a new cache instance.
@@ -125,6 +131,19 @@ class NET_EXPORT SSLSessionCacheOpenSSL {
   // the system's certificate store has changed.
   void Flush();
 
+  // Appends to |sessions| the cached sessions whose cache key ends with
+  // |key_suffix|, from the most to the least recently used. Only sessions
+  // that were marked as good and haven't expired are exported.
+  void ExportSessions(const std::string& key_suffix,
+                      SerializedSessions* sessions) const;
+
+  // Adds |sessions|, as returned by ExportSessions(), to the cache. They are
+  // marked as good and considered less recently used than any session already
+  // in the cache. Sessions that have expired, can't be parsed, or whose key
+  // already has a session are skipped, and no session is evicted to make room.
+  // Returns the number of sessions added.
+  size_t ImportSessions(const SerializedSessions& sessions);
+
   // TODO(digit): Move to client code.
   static const int kDefaultTimeoutSeconds = 60 * 60;
   static const size_t kMaxEntries = 1024;
@@ -375,4 +375,53 @@ TEST_F(SSLSessionCacheOpenSSLTest, CheckExpiration) {
   EXPECT_EQ(1U, cache_.size());
 }
 
+// Check that sessions can be exported and imported into another cache.
+TEST_F(SSLSessionCacheOpenSSLTest, ExportAndImportSessions) {
+  ScopedSSL good_ssl(NewSSL("www.good.com:443/shard"));
+  AddToCache(good_ssl.get());
+  cache_.MarkSSLSessionAsGood(good_ssl.get());
+  SSL_SESSION* good_session = good_ssl.get()->session;
+
+  // Sessions that weren't marked as good, or that belong to another shard,
+  // are not exported.
+  ScopedSSL pending_ssl(NewSSL("www.pending.com:443/shard"));
+  AddToCache(pending_ssl.get());
+  ScopedSSL other_ssl(NewSSL("www.good.com:443/other"));
+  AddToCache(other_ssl.get());
+  cache_.MarkSSLSessionAsGood(other_ssl.get());
+  EXPECT_EQ(3U, cache_.size());
+
+  SSLSessionCacheOpenSSL::SerializedSessions sessions;
+  cache_.ExportSessions("/shard", &sessions);
+  ASSERT_EQ(1U, sessions.size());
+  EXPECT_EQ("www.good.com:443/shard", sessions[0].first);
+
+  // Import into a fresh cache. The imported session is resumable right away.
+  crypto::ScopedOpenSSL<SSL_CTX, SSL_CTX_free> ctx2(
+      SSL_CTX_new(SSLv23_client_method()));
+  SSLSessionCacheOpenSSL cache2(ctx2.get(), kDefaultConfig);
+  EXPECT_EQ(1U, cache2.ImportSessions(sessions));
+  EXPECT_EQ(1U, cache2.size());
+
+  ScopedSSL resumed_ssl(SSL_new(ctx2.get()));
+  SSLKeyHelper::Set(resumed_ssl.get(), "www.good.com:443/shard");
+  EXPECT_TRUE(cache2.SetSSLSession(resumed_ssl.get()));
+  ASSERT_TRUE(resumed_ssl.get()->session);
+  EXPECT_EQ(good_session->session_id_length,
+            resumed_ssl.get()->session->session_id_length);
+  EXPECT_EQ(0, memcmp(good_session->session_id,
+                      resumed_ssl.get()->session->session_id,
+                      good_session->session_id_length));
+
+  // Importing again doesn't replace the cached session.
+  EXPECT_EQ(0U, cache2.ImportSessions(sessions));
+  EXPECT_EQ(1U, cache2.size());
+
+  // Garbage is ignored.
+  SSLSessionCacheOpenSSL::SerializedSessions garbage;
+  garbage.push_back(std::make_pair("www.bad.com:443/shard", "garbage"));
+  EXPECT_EQ(0U, cache2.ImportSessions(garbage));
+  EXPECT_EQ(1U, cache2.size());
+}
+
 }  // namespace net
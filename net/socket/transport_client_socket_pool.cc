@@ -33,8 +33,16 @@ namespace net {
 // don't synchronize.
 const int TransportConnectJob::kIPv6FallbackTimerInMs = 300;
 
+// RFC 6555 recommends a delay of 150 to 250ms before racing the second
+// address family.
+const int TransportConnectJob::kAddressFamilyRaceStaggerInMs = 150;
+
 namespace {
 
+// Whether new TransportConnectJobs resolve and race address families
+// separately.
+bool g_race_address_families_enabled = false;
+
 // Returns true iff all addresses in |list| are in the IPv6 family.
 bool AddressListOnlyContainsIPv6(const AddressList& list) {
   DCHECK(!list.empty());
@@ -96,6 +104,16 @@ TransportConnectJob::TransportConnectJob(
       client_socket_factory_(client_socket_factory),
       resolver_(host_resolver),
       next_state_(STATE_NONE),
+      race_address_families_(
+          g_race_address_families_enabled &&
+          params->destination().address_family() ==
+              ADDRESS_FAMILY_UNSPECIFIED),
+      ipv4_resolver_(host_resolver),
+      ipv6_resolve_result_(ERR_IO_PENDING),
+      ipv4_resolve_result_(ERR_IO_PENDING),
+      ipv6_connect_started_(false),
+      ipv4_connect_started_(false),
+      connect_result_(OK),
       interval_between_connects_(CONNECT_INTERVAL_GT_20MS) {
 }
 
@@ -108,6 +126,7 @@ LoadState TransportConnectJob::GetLoadState() const {
   switch (next_state_) {
     case STATE_RESOLVE_HOST:
     case STATE_RESOLVE_HOST_COMPLETE:
+    case STATE_RESOLVE_OTHER_FAMILY_COMPLETE:
       return LOAD_STATE_RESOLVING_HOST;
     case STATE_TRANSPORT_CONNECT:
     case STATE_TRANSPORT_CONNECT_COMPLETE:
@@ -129,6 +148,29 @@ void TransportConnectJob::MakeAddressListStartWithIPv4(AddressList* list) {
   }
 }
 
+// static
+AddressList TransportConnectJob::InterleaveAddressFamilies(
+    const AddressList& ipv6_list,
+    const AddressList& ipv4_list) {
+  AddressList list;
+  list.set_canonical_name(ipv6_list.canonical_name().empty() ?
+      ipv4_list.canonical_name() : ipv6_list.canonical_name());
+  for (size_t i = 0; i < ipv6_list.size() || i < ipv4_list.size(); ++i) {
+    if (i < ipv6_list.size())
+      list.push_back(ipv6_list[i]);
+    if (i < ipv4_list.size())
+      list.push_back(ipv4_list[i]);
+  }
+  return list;
+}
+
+// static
+bool TransportConnectJob::set_race_address_families_enabled(bool enabled) {
+  bool old_value = g_race_address_families_enabled;
+  g_race_address_families_enabled = enabled;
+  return old_value;
+}
+
 void TransportConnectJob::OnIOComplete(int result) {
   int rv = DoLoop(result);
   if (rv != ERR_IO_PENDING)
@@ -157,6 +199,9 @@ int TransportConnectJob::DoLoop(int result) {
       case STATE_TRANSPORT_CONNECT_COMPLETE:
         rv = DoTransportConnectComplete(rv);
         break;
+      case STATE_RESOLVE_OTHER_FAMILY_COMPLETE:
+        rv = DoResolveOtherFamilyComplete(rv);
+        break;
       default:
         NOTREACHED();
         rv = ERR_FAILED;
@@ -171,6 +216,9 @@ int TransportConnectJob::DoResolveHost() {
   next_state_ = STATE_RESOLVE_HOST_COMPLETE;
   connect_timing_.dns_start = base::TimeTicks::Now();
 
+  if (race_address_families_)
+    return ResolveAddressFamilies();
+
   return resolver_.Resolve(
       params_->destination(),
       priority(),
@@ -225,7 +273,8 @@ int TransportConnectJob::DoTransportConnect() {
       addresses_.front().GetFamily() == ADDRESS_FAMILY_IPV6 &&
       !AddressListOnlyContainsIPv6(addresses_)) {
     fallback_timer_.Start(FROM_HERE,
-        base::TimeDelta::FromMilliseconds(kIPv6FallbackTimerInMs),
+        base::TimeDelta::FromMilliseconds(race_address_families_ ?
+            kAddressFamilyRaceStaggerInMs : kIPv6FallbackTimerInMs),
         this, &TransportConnectJob::DoIPv6FallbackTransportConnect);
   }
   return rv;
@@ -306,6 +355,33 @@ int TransportConnectJob::DoTransportConnectComplete(int result) {
     SetSocket(transport_socket_.Pass());
     fallback_timer_.Stop();
   } else {
+    if (race_address_families_) {
+      transport_socket_.reset();
+      // Let a racing connect finish.
+      if (fallback_transport_socket_.get()) {
+        next_state_ = STATE_TRANSPORT_CONNECT_COMPLETE;
+        return ERR_IO_PENDING;
+      }
+      // Don't wait for the stagger to connect to the other family.
+      if (fallback_addresses_.get()) {
+        fallback_timer_.Stop();
+        addresses_ = *fallback_addresses_;
+        fallback_addresses_.reset();
+        next_state_ = STATE_TRANSPORT_CONNECT;
+        return OK;
+      }
+      int rv = TakeResolvedAddresses(&addresses_);
+      if (rv == OK) {
+        next_state_ = STATE_TRANSPORT_CONNECT;
+        return OK;
+      }
+      if (rv == ERR_IO_PENDING) {
+        connect_result_ = result;
+        next_state_ = STATE_RESOLVE_OTHER_FAMILY_COMPLETE;
+        return ERR_IO_PENDING;
+      }
+    }
+
     // Be a bit paranoid and kill off the fallback members to prevent reuse.
     fallback_transport_socket_.reset();
     fallback_addresses_.reset();
@@ -314,6 +390,15 @@ int TransportConnectJob::DoTransportConnectComplete(int result) {
   return result;
 }
 
+int TransportConnectJob::DoResolveOtherFamilyComplete(int result) {
+  // The other family failed to resolve, so report why the connect failed.
+  if (result != OK)
+    return connect_result_;
+
+  next_state_ = STATE_TRANSPORT_CONNECT;
+  return OK;
+}
+
 void TransportConnectJob::DoIPv6FallbackTransportConnect() {
   // The timer should only fire while we're waiting for the main connect to
   // succeed.
@@ -323,10 +408,13 @@ void TransportConnectJob::DoIPv6FallbackTransportConnect() {
   }
 
   DCHECK(!fallback_transport_socket_.get());
-  DCHECK(!fallback_addresses_.get());
 
-  fallback_addresses_.reset(new AddressList(addresses_));
-  MakeAddressListStartWithIPv4(fallback_addresses_.get());
+  // |fallback_addresses_| is already set when racing a separately resolved
+  // address family.
+  if (!fallback_addresses_.get()) {
+    fallback_addresses_.reset(new AddressList(addresses_));
+    MakeAddressListStartWithIPv4(fallback_addresses_.get());
+  }
   fallback_transport_socket_ =
       client_socket_factory_->CreateTransportClientSocket(
           *fallback_addresses_, net_log().net_log(), net_log().source());
@@ -369,11 +457,13 @@ void TransportConnectJob::DoIPv6FallbackTransportConnectComplete(int result) {
         base::TimeDelta::FromMinutes(10),
         100);
 
-    UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Latency_IPv4_Wins_Race",
-        connect_duration,
-        base::TimeDelta::FromMilliseconds(1),
-        base::TimeDelta::FromMinutes(10),
-        100);
+    if (fallback_addresses_->front().GetFamily() == ADDRESS_FAMILY_IPV4) {
+      UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Latency_IPv4_Wins_Race",
+          connect_duration,
+          base::TimeDelta::FromMilliseconds(1),
+          base::TimeDelta::FromMinutes(10),
+          100);
+    }
     SetSocket(fallback_transport_socket_.Pass());
     next_state_ = STATE_NONE;
     transport_socket_.reset();
@@ -385,6 +475,100 @@ void TransportConnectJob::DoIPv6FallbackTransportConnectComplete(int result) {
   NotifyDelegateOfCompletion(result);  // Deletes |this|
 }
 
+int TransportConnectJob::ResolveAddressFamilies() {
+  HostResolver::RequestInfo ipv6_info(params_->destination());
+  ipv6_info.set_address_family(ADDRESS_FAMILY_IPV6);
+  HostResolver::RequestInfo ipv4_info(params_->destination());
+  ipv4_info.set_address_family(ADDRESS_FAMILY_IPV4);
+
+  int rv = resolver_.Resolve(
+      ipv6_info,
+      priority(),
+      &ipv6_addresses_,
+      base::Bind(&TransportConnectJob::OnAddressFamilyResolved,
+                 base::Unretained(this), ADDRESS_FAMILY_IPV6),
+      net_log());
+  if (rv != ERR_IO_PENDING)
+    RecordAddressFamilyResolved(ADDRESS_FAMILY_IPV6, rv);
+
+  rv = ipv4_resolver_.Resolve(
+      ipv4_info,
+      priority(),
+      &ipv4_addresses_,
+      base::Bind(&TransportConnectJob::OnAddressFamilyResolved,
+                 base::Unretained(this), ADDRESS_FAMILY_IPV4),
+      net_log());
+  if (rv != ERR_IO_PENDING)
+    RecordAddressFamilyResolved(ADDRESS_FAMILY_IPV4, rv);
+
+  return TakeResolvedAddresses(&addresses_);
+}
+
+void TransportConnectJob::OnAddressFamilyResolved(AddressFamily family,
+                                                  int result) {
+  RecordAddressFamilyResolved(family, result);
+
+  if (next_state_ == STATE_RESOLVE_HOST_COMPLETE ||
+      next_state_ == STATE_RESOLVE_OTHER_FAMILY_COMPLETE) {
+    int rv = TakeResolvedAddresses(&addresses_);
+    if (rv != ERR_IO_PENDING)
+      OnIOComplete(rv);  // May delete |this|.
+    return;
+  }
+
+  // Otherwise the first family is connecting. Race the other family against
+  // it once the stagger has passed.
+  if (next_state_ != STATE_TRANSPORT_CONNECT_COMPLETE ||
+      fallback_timer_.IsRunning() || fallback_transport_socket_.get()) {
+    return;
+  }
+  AddressList other_addresses;
+  if (TakeResolvedAddresses(&other_addresses) != OK)
+    return;
+  fallback_addresses_.reset(new AddressList(other_addresses));
+  base::TimeDelta delay =
+      base::TimeDelta::FromMilliseconds(kAddressFamilyRaceStaggerInMs) -
+      (base::TimeTicks::Now() - connect_timing_.connect_start);
+  fallback_timer_.Start(FROM_HERE, std::max(delay, base::TimeDelta()),
+                        this,
+                        &TransportConnectJob::DoIPv6FallbackTransportConnect);
+}
+
+void TransportConnectJob::RecordAddressFamilyResolved(AddressFamily family,
+                                                      int result) {
+  DCHECK_NE(ERR_IO_PENDING, result);
+  if (family == ADDRESS_FAMILY_IPV6) {
+    ipv6_resolve_result_ = result;
+    connect_timing_.ipv6_dns_end = base::TimeTicks::Now();
+  } else {
+    DCHECK_EQ(ADDRESS_FAMILY_IPV4, family);
+    ipv4_resolve_result_ = result;
+    connect_timing_.ipv4_dns_end = base::TimeTicks::Now();
+  }
+}
+
+int TransportConnectJob::TakeResolvedAddresses(AddressList* addresses) {
+  bool ipv6_ready = ipv6_resolve_result_ == OK && !ipv6_connect_started_;
+  bool ipv4_ready = ipv4_resolve_result_ == OK && !ipv4_connect_started_;
+  if (ipv6_ready && ipv4_ready) {
+    *addresses = InterleaveAddressFamilies(ipv6_addresses_, ipv4_addresses_);
+  } else if (ipv6_ready) {
+    *addresses = ipv6_addresses_;
+  } else if (ipv4_ready) {
+    *addresses = ipv4_addresses_;
+  } else if (ipv6_resolve_result_ == ERR_IO_PENDING ||
+             ipv4_resolve_result_ == ERR_IO_PENDING) {
+    return ERR_IO_PENDING;
+  } else {
+    // Prefer the IPv4 error, since hosts without AAAA records are common.
+    return ipv4_resolve_result_ != OK ? ipv4_resolve_result_ :
+                                        ipv6_resolve_result_;
+  }
+  ipv6_connect_started_ |= ipv6_ready;
+  ipv4_connect_started_ |= ipv4_ready;
+  return OK;
+}
+
 int TransportConnectJob::ConnectInternal() {
   next_state_ = STATE_RESOLVE_HOST;
   return DoLoop(OK);
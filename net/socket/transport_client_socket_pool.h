@@ -63,6 +63,12 @@ class NET_EXPORT_PRIVATE TransportSocketParams
 // (kIPv6FallbackTimerInMs) and start a connect() to a IPv4 address if the timer
 // fires. Then we race the IPv4 connect() against the IPv6 connect() (which has
 // a headstart) and return the one that completes first to the socket pool.
+//
+// When racing address families is enabled (RFC 6555), IPv6 and IPv4 addresses
+// are resolved separately and the connect starts as soon as the first family
+// resolves. The other family is raced against it after
+// kAddressFamilyRaceStaggerInMs once it resolves. If both families are already
+// resolved, their addresses are interleaved.
 class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
  public:
   TransportConnectJob(const std::string& group_name,
@@ -82,7 +88,17 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
   // WARNING: this method should only be used to implement the prefer-IPv4 hack.
   static void MakeAddressListStartWithIPv4(AddressList* addrlist);
 
+  // Returns a list alternating between the addresses of |ipv6_list| and
+  // |ipv4_list|, starting with IPv6.
+  static AddressList InterleaveAddressFamilies(const AddressList& ipv6_list,
+                                               const AddressList& ipv4_list);
+
+  // Sets whether new TransportConnectJobs race address families. Returns the
+  // previous value. Disabled by default.
+  static bool set_race_address_families_enabled(bool enabled);
+
   static const int kIPv6FallbackTimerInMs;
+  static const int kAddressFamilyRaceStaggerInMs;
 
  private:
   enum State {
@@ -90,6 +106,9 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
     STATE_RESOLVE_HOST_COMPLETE,
     STATE_TRANSPORT_CONNECT,
     STATE_TRANSPORT_CONNECT_COMPLETE,
+    // Entered when racing address families, if connecting to the first
+    // resolved family failed while the other family is still resolving.
+    STATE_RESOLVE_OTHER_FAMILY_COMPLETE,
     STATE_NONE,
   };
 
@@ -108,11 +127,24 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
   int DoResolveHostComplete(int result);
   int DoTransportConnect();
   int DoTransportConnectComplete(int result);
+  int DoResolveOtherFamilyComplete(int result);
 
   // Not part of the state machine.
   void DoIPv6FallbackTransportConnect();
   void DoIPv6FallbackTransportConnectComplete(int result);
 
+  // Starts separate IPv6 and IPv4 resolutions. Returns OK if the addresses of
+  // at least one family are available.
+  int ResolveAddressFamilies();
+  void OnAddressFamilyResolved(AddressFamily family, int result);
+  void RecordAddressFamilyResolved(AddressFamily family, int result);
+
+  // Sets |addresses| to the resolved addresses of the families not connected
+  // to yet, interleaving them if both are available, and marks those families
+  // as connected to. Returns ERR_IO_PENDING if no addresses are available yet
+  // but a resolution is pending, or an error if there is nothing left to try.
+  int TakeResolvedAddresses(AddressList* addresses);
+
   // Begins the host resolution and the TCP connect.  Returns OK on success
   // and ERR_IO_PENDING if it cannot immediately service the request.
   // Otherwise, it returns a net error code.
@@ -124,6 +156,20 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
   AddressList addresses_;
   State next_state_;
 
+  // Members used when racing address families. |resolver_| is used for IPv6.
+  const bool race_address_families_;
+  SingleRequestHostResolver ipv4_resolver_;
+  AddressList ipv6_addresses_;
+  AddressList ipv4_addresses_;
+  // ERR_IO_PENDING until the resolution of the family completes.
+  int ipv6_resolve_result_;
+  int ipv4_resolve_result_;
+  // Whether the addresses of the family were handed to a connect.
+  bool ipv6_connect_started_;
+  bool ipv4_connect_started_;
+  // Result of the failed connect that is waiting for the other family.
+  int connect_result_;
+
   scoped_ptr<StreamSocket> transport_socket_;
 
   scoped_ptr<StreamSocket> fallback_transport_socket_;
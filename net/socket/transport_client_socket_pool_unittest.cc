@@ -572,6 +572,36 @@ TEST(TransportConnectJobTest, MakeAddrListStartWithIPv4) {
   EXPECT_EQ(ADDRESS_FAMILY_IPV6, addrlist[3].GetFamily());
 }
 
+TEST(TransportConnectJobTest, InterleaveAddressFamilies) {
+  IPAddressNumber ip_number;
+  ASSERT_TRUE(ParseIPLiteralToNumber("192.168.1.1", &ip_number));
+  IPEndPoint addrlist_v4_1(ip_number, 80);
+  ASSERT_TRUE(ParseIPLiteralToNumber("2001:4860:b006::64", &ip_number));
+  IPEndPoint addrlist_v6_1(ip_number, 80);
+  ASSERT_TRUE(ParseIPLiteralToNumber("2001:4860:b006::66", &ip_number));
+  IPEndPoint addrlist_v6_2(ip_number, 80);
+
+  AddressList ipv6_list;
+  ipv6_list.push_back(addrlist_v6_1);
+  ipv6_list.push_back(addrlist_v6_2);
+  AddressList ipv4_list;
+  ipv4_list.push_back(addrlist_v4_1);
+  ipv4_list.set_canonical_name("canonical.example.com");
+
+  AddressList addrlist =
+      TransportConnectJob::InterleaveAddressFamilies(ipv6_list, ipv4_list);
+  ASSERT_EQ(3u, addrlist.size());
+  EXPECT_TRUE(addrlist[0] == addrlist_v6_1);
+  EXPECT_TRUE(addrlist[1] == addrlist_v4_1);
+  EXPECT_TRUE(addrlist[2] == addrlist_v6_2);
+  EXPECT_EQ("canonical.example.com", addrlist.canonical_name());
+
+  addrlist =
+      TransportConnectJob::InterleaveAddressFamilies(AddressList(), ipv4_list);
+  ASSERT_EQ(1u, addrlist.size());
+  EXPECT_TRUE(addrlist[0] == addrlist_v4_1);
+}
+
 TEST_F(TransportClientSocketPoolTest, Basic) {
   TestCompletionCallback callback;
   ClientSocketHandle handle;
@@ -1370,6 +1400,64 @@ TEST_F(TransportClientSocketPoolTest, IPv4HasNoFallback) {
   EXPECT_EQ(1, client_socket_factory_.allocation_count());
 }
 
+// Test that when racing address families, the IPv4 connect starts after the
+// stagger once IPv4 resolves, and wins over a stalled IPv6 connect.
+TEST_F(TransportClientSocketPoolTest, RaceAddressFamiliesIPv4Wins) {
+  bool race_address_families_enabled =
+      TransportConnectJob::set_race_address_families_enabled(true);
+
+  // Create a pool without backup jobs.
+  ClientSocketPoolBaseHelper::set_connect_backup_jobs_enabled(false);
+  TransportClientSocketPool pool(kMaxSockets,
+                                 kMaxSocketsPerGroup,
+                                 histograms_.get(),
+                                 host_resolver_.get(),
+                                 &client_socket_factory_,
+                                 NULL);
+
+  MockClientSocketFactory::ClientSocketType case_types[] = {
+    // This is the IPv6 socket.
+    MockClientSocketFactory::MOCK_STALLED_CLIENT_SOCKET,
+    // This is the IPv4 socket.
+    MockClientSocketFactory::MOCK_PENDING_CLIENT_SOCKET
+  };
+
+  client_socket_factory_.set_client_socket_types(case_types, 2);
+
+  // The families are resolved separately.
+  host_resolver_->rules()->AddRuleForAddressFamily(
+      "*", ADDRESS_FAMILY_IPV6, "2:abcd::3:4:ff");
+  host_resolver_->rules()->AddRuleForAddressFamily(
+      "*", ADDRESS_FAMILY_IPV4, "2.2.2.2");
+
+  TestCompletionCallback callback;
+  ClientSocketHandle handle;
+  int rv = handle.Init("a", params_, LOW, callback.callback(), &pool,
+                       BoundNetLog());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+  EXPECT_FALSE(handle.is_initialized());
+  EXPECT_FALSE(handle.socket());
+
+  EXPECT_EQ(OK, callback.WaitForResult());
+  EXPECT_TRUE(handle.is_initialized());
+  EXPECT_TRUE(handle.socket());
+  IPEndPoint endpoint;
+  handle.socket()->GetLocalAddress(&endpoint);
+  EXPECT_EQ(kIPv4AddressSize, endpoint.address().size());
+  EXPECT_EQ(2, client_socket_factory_.allocation_count());
+
+  // Both families report when they resolved.
+  const LoadTimingInfo::ConnectTiming& connect_timing =
+      handle.connect_timing();
+  EXPECT_FALSE(connect_timing.ipv6_dns_end.is_null());
+  EXPECT_FALSE(connect_timing.ipv4_dns_end.is_null());
+  EXPECT_LE(connect_timing.dns_start, connect_timing.ipv6_dns_end);
+  EXPECT_LE(connect_timing.dns_start, connect_timing.ipv4_dns_end);
+
+  TransportConnectJob::set_race_address_families_enabled(
+      race_address_families_enabled);
+}
+
 }  // namespace
 
 }  // namespace net
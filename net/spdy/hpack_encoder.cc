@@ -29,13 +29,10 @@ bool HpackEncoder::EncodeHeaderSet(const std::map<string, string>& header_set,
       std::vector<StringPiece> crumbs;
       CookieToCrumbs(it->second, &crumbs);
       for (size_t i = 0; i != crumbs.size(); i++) {
-        if (!output_stream.AppendLiteralHeaderNoIndexingWithName(
-            it->first, crumbs[i])) {
+        if (!AppendLiteralHeader(it->first, crumbs[i], &output_stream))
           return false;
-        }
       }
-    } else if (!output_stream.AppendLiteralHeaderNoIndexingWithName(
-        it->first, it->second)) {
+    } else if (!AppendLiteralHeader(it->first, it->second, &output_stream)) {
       return false;
     }
   }
@@ -43,6 +40,17 @@ bool HpackEncoder::EncodeHeaderSet(const std::map<string, string>& header_set,
   return true;
 }
 
+bool HpackEncoder::AppendLiteralHeader(StringPiece name,
+                                       StringPiece value,
+                                       HpackOutputStream* output_stream) const {
+  uint32 name_index = context_.GetStaticNameIndex(name);
+  if (name_index != 0) {
+    return output_stream->AppendLiteralHeaderNoIndexingWithIndexedName(
+        name_index, value);
+  }
+  return output_stream->AppendLiteralHeaderNoIndexingWithName(name, value);
+}
+
 void HpackEncoder::CookieToCrumbs(StringPiece cookie,
                                   std::vector<StringPiece>* out) {
   out->clear();
@@ -19,6 +19,8 @@
 
 namespace net {
 
+class HpackOutputStream;
+
 namespace test {
 class HpackEncoderPeer;
 }  // namespace test
@@ -39,6 +41,12 @@ class NET_EXPORT_PRIVATE HpackEncoder {
   static void CookieToCrumbs(base::StringPiece cookie,
                              std::vector<base::StringPiece>* out);
 
+  // Appends a literal header without indexing, referring to |name| by its
+  // index if it is in the static table.
+  bool AppendLiteralHeader(base::StringPiece name,
+                           base::StringPiece value,
+                           HpackOutputStream* output_stream) const;
+
   uint32 max_string_literal_size_;
   HpackEncodingContext context_;
 
@@ -96,6 +96,22 @@ TEST(HpackEncoderTest, CookieCrumbling) {
             "\x40\x06""Cookie\x0bkey2=value2", encoded_header_set);
 }
 
+// Test that the names of the static table are encoded by their index.
+TEST(HpackEncoderTest, StaticTableNames) {
+  HpackEncoder encoder;
+
+  std::map<string, string> header_set;
+  header_set[":method"] = "GET";
+  header_set["user-agent"] = "agent";
+  header_set["x-name"] = "value";
+
+  string encoded_header_set;
+  EXPECT_TRUE(encoder.EncodeHeaderSet(header_set, &encoded_header_set));
+  EXPECT_EQ("\x42\x03GET"
+            "\x79\x05" "agent"
+            "\x40\x06x-name\x05value", encoded_header_set);
+}
+
 // Test that trying to encode a header set with a too-long header
 // field will fail.
 TEST(HpackEncoderTest, HeaderTooLarge) {
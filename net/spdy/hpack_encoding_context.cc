@@ -5,9 +5,12 @@
 #include "net/spdy/hpack_encoding_context.h"
 
 #include <cstddef>
+#include <utility>
 
+#include "base/containers/hash_tables.h"
 #include "base/logging.h"
 #include "base/macros.h"
+#include "base/memory/singleton.h"
 #include "net/spdy/hpack_constants.h"
 #include "net/spdy/hpack_entry.h"
 
@@ -99,6 +102,27 @@ const StaticEntry kStaticTable[] = {
 
 const size_t kStaticEntryCount = arraysize(kStaticTable);
 
+// StaticNameIndex is a Singleton mapping the names of the static table to the
+// offset of their first entry, so that encoders don't have to search the
+// table for each header.
+struct StaticNameIndex {
+ public:
+  StaticNameIndex() {
+    for (size_t i = 0; i != kStaticEntryCount; ++i) {
+      StringPiece name(kStaticTable[i].name, kStaticTable[i].name_len);
+      // Keeps the first entry of each name.
+      offsets.insert(std::make_pair(name, static_cast<uint32>(i)));
+    }
+  }
+
+  static StaticNameIndex* GetInstance() {
+    return Singleton<StaticNameIndex>::get();
+  }
+
+  // The names point into |kStaticTable|.
+  base::hash_map<StringPiece, uint32> offsets;
+};
+
 }  // namespace
 
 // Must match HpackEntry::kUntouched.
@@ -141,6 +165,15 @@ StringPiece HpackEncodingContext::GetValueAt(uint32 index) const {
   return header_table_.GetEntry(index).value();
 }
 
+uint32 HpackEncodingContext::GetStaticNameIndex(StringPiece name) const {
+  const base::hash_map<StringPiece, uint32>& offsets =
+      StaticNameIndex::GetInstance()->offsets;
+  base::hash_map<StringPiece, uint32>::const_iterator it = offsets.find(name);
+  if (it == offsets.end())
+    return 0;
+  return header_table_.GetEntryCount() + it->second + 1;
+}
+
 bool HpackEncodingContext::IsReferencedAt(uint32 index) const {
   CHECK_GE(index, 1u);
   CHECK_LE(index, GetEntryCount());
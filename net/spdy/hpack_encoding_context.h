@@ -58,6 +58,10 @@ class NET_EXPORT_PRIVATE HpackEncodingContext {
 
   base::StringPiece GetValueAt(uint32 index) const;
 
+  // Returns the index of the first static table entry with the given name,
+  // or 0 if there is none. Runs in constant time.
+  uint32 GetStaticNameIndex(base::StringPiece name) const;
+
   bool IsReferencedAt(uint32 index) const;
 
   uint32 GetTouchCountAt(uint32 index) const;
@@ -215,6 +215,29 @@ TEST(HpackEncodingContextTest, LiteralHeaderIncrementalIndexingDoesNotFit) {
   EXPECT_EQ(0u, encoding_context.GetMutableEntryCount());
 }
 
+// The static names are found at their first static entry, which moves with
+// the size of the header table.
+TEST(HpackEncodingContextTest, GetStaticNameIndex) {
+  HpackEncodingContext encoding_context;
+
+  EXPECT_EQ(1u, encoding_context.GetStaticNameIndex(":authority"));
+  EXPECT_EQ(2u, encoding_context.GetStaticNameIndex(":method"));
+  EXPECT_EQ(8u, encoding_context.GetStaticNameIndex(":status"));
+  EXPECT_EQ(60u, encoding_context.GetStaticNameIndex("www-authenticate"));
+  EXPECT_EQ(0u, encoding_context.GetStaticNameIndex("name"));
+  EXPECT_EQ(0u, encoding_context.GetStaticNameIndex("Cookie"));
+
+  uint32 index = 0;
+  std::vector<uint32> removed_referenced_indices;
+  EXPECT_TRUE(
+      encoding_context.ProcessLiteralHeaderWithIncrementalIndexing(
+          ":method", "PUT", &index, &removed_referenced_indices));
+  EXPECT_EQ(3u, encoding_context.GetStaticNameIndex(":method"));
+  EXPECT_EQ(":method",
+            encoding_context.GetNameAt(
+                encoding_context.GetStaticNameIndex(":method")).as_string());
+}
+
 }  // namespace
 
 }  // namespace net
@@ -263,14 +263,22 @@ bool HpackHuffmanTable::DecodeString(HpackInputStream* in,
   bool peeked_success = in->PeekBits(&bits_available, &bits);
 
   while (true) {
+    uint8 table_index = 0;
     const DecodeTable* table = &decode_tables_[0];
     uint32 index = bits >> (32 - kDecodeTableRootBits);
 
+    // Most codes are resolved by the root table alone. Stop as soon as a
+    // terminal (self-referential) or invalid entry is reached, instead of
+    // walking the full depth of the table hierarchy.
     for (int i = 0; i != kDecodeIterations; i++) {
       DCHECK_LT(index, table->size());
-      DCHECK_LT(Entry(*table, index).next_table_index, decode_tables_.size());
+      const DecodeEntry& entry = Entry(*table, index);
+      DCHECK_LT(entry.next_table_index, decode_tables_.size());
+      if (entry.next_table_index == table_index || entry.length == 0)
+        break;
 
-      table = &decode_tables_[Entry(*table, index).next_table_index];
+      table_index = entry.next_table_index;
+      table = &decode_tables_[table_index];
       // Mask and shift the portion of the code being indexed into low bits.
       index = (bits << table->prefix_length) >> (32 - table->indexed_length);
     }
@@ -34,6 +34,14 @@ bool HpackOutputStream::AppendLiteralHeaderNoIndexingWithName(
   return true;
 }
 
+bool HpackOutputStream::AppendLiteralHeaderNoIndexingWithIndexedName(
+    uint32 name_index, StringPiece value) {
+  DCHECK_NE(name_index, 0u);
+  AppendPrefix(kLiteralNoIndexOpcode);
+  AppendUint32(name_index);
+  return AppendStringLiteral(value);
+}
+
 void HpackOutputStream::TakeString(string* output) {
   // This must hold, since all public functions cause the buffer to
   // end on a byte boundary.
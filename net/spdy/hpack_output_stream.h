@@ -32,6 +32,13 @@ class NET_EXPORT_PRIVATE HpackOutputStream {
   // Corresponds to 4.2.
   void AppendIndexedHeader(uint32 index_or_zero);
 
+  // Corresponds to 4.3.1 (first form), with the name given by the entry at
+  // |name_index|, which must be non-zero. Returns whether or not the append
+  // was successful; if the append was unsuccessful, no other member function
+  // may be called.
+  bool AppendLiteralHeaderNoIndexingWithIndexedName(uint32 name_index,
+                                                    base::StringPiece value);
+
   // Corresponds to 4.3.1 (second form). Returns whether or not the
   // append was successful; if the append was unsuccessful, no other
   // member function may be called.
@@ -288,6 +288,21 @@ TEST(HpackOutputStreamTest, AppendLiteralHeaderNoIndexingWithName) {
   EXPECT_EQ("\x40\x04name\x05value", str);
 }
 
+// Test that encoding a literal header without indexing with an indexed
+// name encodes the index and the value as a string literal.
+TEST(HpackOutputStreamTest, AppendLiteralHeaderNoIndexingWithIndexedName) {
+  HpackOutputStream output_stream(kuint32max);
+  EXPECT_TRUE(output_stream.AppendLiteralHeaderNoIndexingWithIndexedName(
+      2, "value"));
+  EXPECT_TRUE(output_stream.AppendLiteralHeaderNoIndexingWithIndexedName(
+      0x3f, "value"));
+
+  string str;
+  output_stream.TakeString(&str);
+  const char kExpected[] = "\x42\x05value" "\x7f\x00\x05value";
+  EXPECT_EQ(string(kExpected, arraysize(kExpected) - 1), str);
+}
+
 // Test that trying to encode a header with a too-long header name or
 // value will fail.
 TEST(HpackOutputStreamTest, AppendLiteralHeaderNoIndexingWithNameTooLong) {
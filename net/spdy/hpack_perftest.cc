@@ -0,0 +1,214 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/strings/string_piece.h"
+#include "base/test/perf_time_logger.h"
+#include "net/spdy/hpack_constants.h"
+#include "net/spdy/hpack_decoder.h"
+#include "net/spdy/hpack_encoder.h"
+#include "net/spdy/hpack_huffman_table.h"
+#include "net/spdy/hpack_input_stream.h"
+#include "net/spdy/hpack_output_stream.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+using base::StringPiece;
+using std::string;
+
+const int kIterations = 10000;
+
+struct HeaderField {
+  const char* name;
+  const char* value;
+};
+
+// Header sets as sent and received by a browser loading a typical page: the
+// navigation, a script, a stylesheet and an image.
+const HeaderField kRequestHeaders[][8] = {
+  {
+    { ":method", "GET" },
+    { ":path", "/search?q=hpack+header+compression&ie=UTF-8" },
+    { ":scheme", "https" },
+    { ":authority", "www.example.com" },
+    { "accept", "text/html,application/xhtml+xml,application/xml;q=0.9,"
+                "image/webp,*/*;q=0.8" },
+    { "accept-encoding", "gzip,deflate,sdch" },
+    { "user-agent", "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 "
+                    "(KHTML, like Gecko) Chrome/35.0.1916.114 Safari/537.36" },
+    { "cookie", "PREF=ID=0123456789abcdef:FF=0:TM=1400000000:LM=1400000000:"
+                "S=AbCdEfGhIjKlMnOp; NID=67=abcdefghijklmnopqrstuvwxyz0123; "
+                "SID=DQAAAKAAAABcdefghijklmnopqrstuvwxyz" },
+  },
+  {
+    { ":method", "GET" },
+    { ":path", "/static/js/main.min.js?v=20140512" },
+    { ":scheme", "https" },
+    { ":authority", "static.example.com" },
+    { "accept", "*/*" },
+    { "accept-encoding", "gzip,deflate,sdch" },
+    { "referer", "https://www.example.com/search?q=hpack+header+compression" },
+    { "user-agent", "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 "
+                    "(KHTML, like Gecko) Chrome/35.0.1916.114 Safari/537.36" },
+  },
+  {
+    { ":method", "GET" },
+    { ":path", "/static/css/site.css" },
+    { ":scheme", "https" },
+    { ":authority", "static.example.com" },
+    { "accept", "text/css,*/*;q=0.1" },
+    { "accept-language", "en-US,en;q=0.8" },
+    { "if-modified-since", "Mon, 12 May 2014 10:00:00 GMT" },
+    { "if-none-match", "\"5370a6c0-3e1d\"" },
+  },
+  {
+    { ":method", "GET" },
+    { ":path", "/images/logo_2x.png" },
+    { ":scheme", "https" },
+    { ":authority", "static.example.com" },
+    { "accept", "image/webp,*/*;q=0.8" },
+    { "accept-encoding", "gzip,deflate,sdch" },
+    { "x-client-data", "CJS2yQEIpLbJAQiptskBCMS2yQEInobKAQjuiMoB" },
+    { "cache-control", "max-age=0" },
+  },
+};
+
+const HeaderField kResponseHeaders[][8] = {
+  {
+    { ":status", "200" },
+    { "content-type", "text/html; charset=UTF-8" },
+    { "content-encoding", "gzip" },
+    { "date", "Tue, 13 May 2014 08:12:31 GMT" },
+    { "cache-control", "private, max-age=0" },
+    { "expires", "-1" },
+    { "server", "gws" },
+    { "set-cookie", "NID=67=abcdefghijklmnopqrstuvwxyz0123; "
+                    "expires=Wed, 12-Nov-2014 08:12:31 GMT; path=/; "
+                    "domain=.example.com; HttpOnly" },
+  },
+  {
+    { ":status", "200" },
+    { "content-type", "text/javascript; charset=UTF-8" },
+    { "content-length", "183422" },
+    { "date", "Tue, 13 May 2014 08:12:31 GMT" },
+    { "expires", "Wed, 13 May 2015 08:12:31 GMT" },
+    { "last-modified", "Mon, 12 May 2014 10:00:00 GMT" },
+    { "cache-control", "public, max-age=31536000" },
+    { "vary", "Accept-Encoding" },
+  },
+  {
+    { ":status", "304" },
+    { "date", "Tue, 13 May 2014 08:12:31 GMT" },
+    { "etag", "\"5370a6c0-3e1d\"" },
+    { "cache-control", "public, max-age=86400" },
+    { "server", "nginx/1.4.6 (Ubuntu)" },
+    { "x-content-type-options", "nosniff" },
+    { "alternate-protocol", "443:quic" },
+    { "x-xss-protection", "1; mode=block" },
+  },
+  {
+    { ":status", "200" },
+    { "content-type", "image/png" },
+    { "content-length", "13504" },
+    { "accept-ranges", "bytes" },
+    { "age", "38541" },
+    { "date", "Tue, 13 May 2014 08:12:31 GMT" },
+    { "last-modified", "Fri, 04 Apr 2014 17:29:33 GMT" },
+    { "access-control-allow-origin", "*" },
+  },
+};
+
+std::vector<std::map<string, string> > GetHeaderSets() {
+  std::vector<std::map<string, string> > header_sets;
+  for (size_t i = 0; i != arraysize(kRequestHeaders); ++i) {
+    std::map<string, string> header_set;
+    for (size_t j = 0; j != arraysize(kRequestHeaders[i]); ++j)
+      header_set[kRequestHeaders[i][j].name] = kRequestHeaders[i][j].value;
+    header_sets.push_back(header_set);
+  }
+  for (size_t i = 0; i != arraysize(kResponseHeaders); ++i) {
+    std::map<string, string> header_set;
+    for (size_t j = 0; j != arraysize(kResponseHeaders[i]); ++j)
+      header_set[kResponseHeaders[i][j].name] = kResponseHeaders[i][j].value;
+    header_sets.push_back(header_set);
+  }
+  return header_sets;
+}
+
+TEST(HpackPerfTest, EncodeHeaderSets) {
+  std::vector<std::map<string, string> > header_sets = GetHeaderSets();
+  HpackEncoder encoder;
+  string encoded;
+  size_t total_size = 0;
+
+  base::PerfTimeLogger timer("Encode HPACK header sets");
+  for (int i = 0; i < kIterations; ++i) {
+    for (size_t j = 0; j != header_sets.size(); ++j) {
+      ASSERT_TRUE(encoder.EncodeHeaderSet(header_sets[j], &encoded));
+      total_size += encoded.size();
+    }
+  }
+  timer.Done();
+  EXPECT_LT(0u, total_size);
+}
+
+TEST(HpackPerfTest, DecodeHeaderSets) {
+  std::vector<std::map<string, string> > header_sets = GetHeaderSets();
+  HpackEncoder encoder;
+  std::vector<string> encoded(header_sets.size());
+  for (size_t i = 0; i != header_sets.size(); ++i)
+    ASSERT_TRUE(encoder.EncodeHeaderSet(header_sets[i], &encoded[i]));
+
+  HpackDecoder decoder(ObtainHpackHuffmanTable());
+  base::PerfTimeLogger timer("Decode HPACK header sets");
+  for (int i = 0; i < kIterations; ++i) {
+    for (size_t j = 0; j != encoded.size(); ++j) {
+      ASSERT_TRUE(decoder.HandleControlFrameHeadersData(
+          1, encoded[j].data(), encoded[j].size()));
+      ASSERT_TRUE(decoder.HandleControlFrameHeadersComplete(1));
+    }
+  }
+  timer.Done();
+  EXPECT_EQ(header_sets.back(), decoder.decoded_block());
+}
+
+TEST(HpackPerfTest, DecodeHuffmanStrings) {
+  const HpackHuffmanTable& table(ObtainHpackHuffmanTable());
+  std::vector<std::map<string, string> > header_sets = GetHeaderSets();
+  std::vector<string> values;
+  std::vector<string> encoded;
+  for (size_t i = 0; i != header_sets.size(); ++i) {
+    for (std::map<string, string>::const_iterator it = header_sets[i].begin();
+         it != header_sets[i].end(); ++it) {
+      HpackOutputStream output_stream(kuint32max);
+      table.EncodeString(it->second, &output_stream);
+      encoded.push_back(string());
+      output_stream.TakeString(&encoded.back());
+      values.push_back(it->second);
+    }
+  }
+
+  string decoded;
+  base::PerfTimeLogger timer("Decode HPACK Huffman strings");
+  for (int i = 0; i < kIterations; ++i) {
+    for (size_t j = 0; j != encoded.size(); ++j) {
+      HpackInputStream input_stream(kuint32max, encoded[j]);
+      ASSERT_TRUE(table.DecodeString(&input_stream, values[j].size(),
+                                     &decoded));
+    }
+  }
+  timer.Done();
+  EXPECT_EQ(values.back(), decoded);
+}
+
+}  // namespace
+
+}  // namespace net
@@ -56,6 +56,10 @@ class SpdyBuffer::SharedFrameIOBuffer : public IOBuffer {
   DISALLOW_COPY_AND_ASSIGN(SharedFrameIOBuffer);
 };
 
+SpdyBuffer::SharedFrame::SharedFrame() {}
+
+SpdyBuffer::SharedFrame::~SharedFrame() {}
+
 SpdyBuffer::SpdyBuffer(scoped_ptr<SpdyFrame> frame)
     : shared_frame_(new SharedFrame()),
       offset_(0) {
@@ -72,6 +76,18 @@ SpdyBuffer::SpdyBuffer(const char* data, size_t size) :
   shared_frame_->data = MakeSpdyFrame(data, size);
 }
 
+SpdyBuffer::SpdyBuffer(IOBuffer* buffer, const char* data, size_t size)
+    : shared_frame_(new SharedFrame()),
+      offset_(0) {
+  DCHECK(buffer);
+  DCHECK(data);
+  CHECK_GT(size, 0u);
+  CHECK_LE(size, kMaxSpdyFrameSize);
+  shared_frame_->data.reset(
+      new SpdyFrame(const_cast<char*>(data), size, false /* owns_buffer */));
+  shared_frame_->backing_buffer = buffer;
+}
+
 SpdyBuffer::~SpdyBuffer() {
   if (GetRemainingSize() > 0)
     ConsumeHelper(GetRemainingSize(), DISCARD);
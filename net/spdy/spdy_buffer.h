@@ -53,6 +53,12 @@ class NET_EXPORT_PRIVATE SpdyBuffer {
   // non-NULL and |size| must be non-zero.
   SpdyBuffer(const char* data, size_t size);
 
+  // Construct with the |size| bytes of |buffer| starting at |data|,
+  // without copying them. |buffer| is kept alive as long as the data
+  // may be used, so it must not be written to afterwards. |size| must
+  // be non-zero.
+  SpdyBuffer(IOBuffer* buffer, const char* data, size_t size);
+
   // If there are bytes remaining in the buffer, triggers a call to
   // any consume callbacks with a DISCARD source.
   ~SpdyBuffer();
@@ -87,8 +93,18 @@ class NET_EXPORT_PRIVATE SpdyBuffer {
   void ConsumeHelper(size_t consume_size, ConsumeSource consume_source);
 
   // Ref-count the passed-in SpdyFrame to support the semantics of
-  // |GetIOBufferForRemainingData()|.
-  typedef base::RefCountedData<scoped_ptr<SpdyFrame> > SharedFrame;
+  // |GetIOBufferForRemainingData()|. If the frame doesn't own its
+  // data, the data belongs to |backing_buffer|.
+  struct SharedFrame : public base::RefCounted<SharedFrame> {
+    SharedFrame();
+
+    scoped_ptr<SpdyFrame> data;
+    scoped_refptr<IOBuffer> backing_buffer;
+
+   private:
+    friend class base::RefCounted<SharedFrame>;
+    ~SharedFrame();
+  };
 
   class SharedFrameIOBuffer;
 
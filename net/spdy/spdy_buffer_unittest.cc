@@ -55,6 +55,29 @@ TEST_F(SpdyBufferTest, DataConstructor) {
   EXPECT_EQ(std::string(kData, kDataSize), BufferToString(buffer));
 }
 
+// Construct a SpdyBuffer from a slice of an IOBuffer and make sure
+// it references the data instead of copying it, and keeps the IOBuffer
+// alive.
+TEST_F(SpdyBufferTest, IOBufferConstructor) {
+  scoped_refptr<IOBuffer> io_buffer(new IOBuffer(kDataSize + 3));
+  std::memcpy(io_buffer->data() + 3, kData, kDataSize);
+
+  scoped_ptr<SpdyBuffer> buffer(
+      new SpdyBuffer(io_buffer.get(), io_buffer->data() + 3, kDataSize));
+  EXPECT_EQ(io_buffer->data() + 3, buffer->GetRemainingData());
+  EXPECT_EQ(kDataSize, buffer->GetRemainingSize());
+  EXPECT_FALSE(io_buffer->HasOneRef());
+
+  scoped_refptr<IOBuffer> remaining_data =
+      buffer->GetIOBufferForRemainingData();
+  IOBuffer* raw_io_buffer = io_buffer.get();
+  io_buffer = NULL;
+  buffer.reset();
+  EXPECT_EQ(raw_io_buffer->data() + 3, remaining_data->data());
+  EXPECT_EQ(std::string(kData, kDataSize),
+            std::string(remaining_data->data(), kDataSize));
+}
+
 void IncrementBy(size_t* x,
                  SpdyBuffer::ConsumeSource expected_consume_source,
                  size_t delta,
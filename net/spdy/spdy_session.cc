@@ -46,6 +46,10 @@ namespace net {
 namespace {
 
 const int kReadBufferSize = 8 * 1024;
+// DATA payloads smaller than this are copied out of the read buffer rather
+// than referenced, so that a few small frames do not each pin a whole read
+// buffer while they wait to be read by their streams.
+const size_t kMinReferencedDataSize = 1024;
 const int kDefaultConnectionAtRiskOfLossSeconds = 10;
 const int kHungIntervalSeconds = 10;
 
@@ -125,6 +129,28 @@ base::Value* NetLogSpdySessionCloseCallback(int net_error,
   return dict;
 }
 
+base::Value* NetLogSpdyWriteQueueLatencyCallback(
+    const SpdyWriteQueue* write_queue,
+    NetLog::LogLevel /* log_level */) {
+  base::DictionaryValue* dict = new base::DictionaryValue();
+  for (int i = MINIMUM_PRIORITY; i <= MAXIMUM_PRIORITY; ++i) {
+    RequestPriority priority = static_cast<RequestPriority>(i);
+    const SpdyWriteQueue::QueueLatency& latency =
+        write_queue->GetQueueLatency(priority);
+    if (latency.num_writes == 0)
+      continue;
+    base::DictionaryValue* priority_dict = new base::DictionaryValue();
+    priority_dict->SetInteger("writes", latency.num_writes);
+    priority_dict->SetInteger(
+        "average_ms",
+        static_cast<int>(latency.total.InMilliseconds() / latency.num_writes));
+    priority_dict->SetInteger("max_ms",
+                              static_cast<int>(latency.max.InMilliseconds()));
+    dict->Set(RequestPriorityToString(priority), priority_dict);
+  }
+  return dict;
+}
+
 base::Value* NetLogSpdySessionCallback(const HostPortProxyPair* host_pair,
                                        NetLog::LogLevel /* log_level */) {
   base::DictionaryValue* dict = new base::DictionaryValue();
@@ -442,6 +468,7 @@ SpdySession::SpdySession(
     bool enable_sending_initial_data,
     bool enable_compression,
     bool enable_ping_based_connection_checking,
+    bool enable_byte_fair_write_scheduling,
     NextProto default_protocol,
     size_t stream_initial_recv_window_size,
     size_t initial_max_concurrent_streams,
@@ -508,6 +535,7 @@ SpdySession::SpdySession(
   DCHECK_GE(protocol_, kProtoSPDYMinimumVersion);
   DCHECK_LE(protocol_, kProtoSPDYMaximumVersion);
   DCHECK(HttpStreamFactory::spdy_enabled());
+  write_queue_.set_byte_fair_scheduling(enable_byte_fair_write_scheduling);
   net_log_.BeginEvent(
       NetLog::TYPE_SPDY_SESSION,
       base::Bind(&NetLogSpdySessionCallback, &host_port_proxy_pair()));
@@ -1230,6 +1258,10 @@ int SpdySession::DoRead() {
   CHECK(connection_);
   CHECK(connection_->socket());
   read_state_ = READ_STATE_DO_READ_COMPLETE;
+  // The DATA frames of the last read may still reference the read buffer;
+  // leave it to them and read into a new one.
+  if (!read_buffer_->HasOneRef())
+    read_buffer_ = new IOBuffer(kReadBufferSize);
   return connection_->socket()->Read(
       read_buffer_.get(),
       kReadBufferSize,
@@ -1390,6 +1422,7 @@ int SpdySession::DoWrite() {
     }
     in_flight_write_frame_type_ = frame_type;
     in_flight_write_frame_size_ = in_flight_write_->GetRemainingSize();
+    write_queue_.ChargeDequeuedWrite(in_flight_write_frame_size_);
     DCHECK_GE(in_flight_write_frame_size_,
               buffered_spdy_framer_->GetFrameMinimumSize());
     in_flight_write_stream_ = stream;
@@ -1544,6 +1577,9 @@ SpdySession::CloseSessionResult SpdySession::DoCloseSession(
   if (availability_state_ == STATE_CLOSED)
     return SESSION_ALREADY_CLOSED;
 
+  net_log_.AddEvent(
+      NetLog::TYPE_SPDY_SESSION_WRITE_QUEUE_LATENCY,
+      base::Bind(&NetLogSpdyWriteQueueLatencyCallback, &write_queue_));
   net_log_.AddEvent(
       NetLog::TYPE_SPDY_SESSION_CLOSE,
       base::Bind(&NetLogSpdySessionCloseCallback, err, &description));
@@ -1928,7 +1964,14 @@ void SpdySession::OnStreamFrameData(SpdyStreamId stream_id,
   if (data) {
     DCHECK_GT(len, 0u);
     CHECK_LE(len, static_cast<size_t>(kReadBufferSize));
-    buffer.reset(new SpdyBuffer(data, len));
+    // The framer hands out DATA payloads straight from the read buffer, so
+    // large ones are referenced there instead of being copied.
+    if (len >= kMinReferencedDataSize && data >= read_buffer_->data() &&
+        data + len <= read_buffer_->data() + kReadBufferSize) {
+      buffer.reset(new SpdyBuffer(read_buffer_.get(), data, len));
+    } else {
+      buffer.reset(new SpdyBuffer(data, len));
+    }
 
     if (flow_control_state_ == FLOW_CONTROL_STREAM_AND_SESSION) {
       DecreaseRecvWindowSize(static_cast<int32>(len));
@@ -206,13 +206,16 @@ class NET_EXPORT SpdySession : public BufferedSpdyFramerVisitorInterface,
   // |spdy_session_key| is the host/port that this session connects to, privacy
   // and proxy configuration settings that it's using.
   // |session| is the HttpNetworkSession.  |net_log| is the NetLog that we log
-  // network events to.
+  // network events to. |enable_byte_fair_write_scheduling| makes the streams
+  // share the connection in proportion to their priority instead of writing
+  // strictly by priority (see SpdyWriteQueue).
   SpdySession(const SpdySessionKey& spdy_session_key,
               const base::WeakPtr<HttpServerProperties>& http_server_properties,
               bool verify_domain_authentication,
               bool enable_sending_initial_data,
               bool enable_compression,
               bool enable_ping_based_connection_checking,
+              bool enable_byte_fair_write_scheduling,
               NextProto default_protocol,
               size_t stream_initial_recv_window_size,
               size_t initial_max_concurrent_streams,
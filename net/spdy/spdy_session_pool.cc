@@ -49,6 +49,7 @@ SpdySessionPool::SpdySessionPool(
       enable_compression_(enable_compression),
       enable_ping_based_connection_checking_(
           enable_ping_based_connection_checking),
+      enable_byte_fair_write_scheduling_(false),
       // TODO(akalin): Force callers to have a valid value of
       // |default_protocol_|.
       default_protocol_(
@@ -96,6 +97,7 @@ base::WeakPtr<SpdySession> SpdySessionPool::CreateAvailableSessionFromSocket(
                       enable_sending_initial_data_,
                       enable_compression_,
                       enable_ping_based_connection_checking_,
+                      enable_byte_fair_write_scheduling_,
                       default_protocol_,
                       stream_initial_recv_window_size_,
                       initial_max_concurrent_streams_,
@@ -61,6 +61,12 @@ class NET_EXPORT SpdySessionPool
       const std::string& trusted_spdy_proxy);
   virtual ~SpdySessionPool();
 
+  // Enables or disables byte-fair write scheduling in the sessions created
+  // from then on. See SpdyWriteQueue.
+  void set_enable_byte_fair_write_scheduling(bool value) {
+    enable_byte_fair_write_scheduling_ = value;
+  }
+
   // In the functions below, a session is "available" if this pool has
   // a reference to it and there is some SpdySessionKey for which
   // FindAvailableSession() will return it. A session is "unavailable"
@@ -215,6 +221,8 @@ class NET_EXPORT SpdySessionPool
   bool force_single_domain_;
   bool enable_compression_;
   bool enable_ping_based_connection_checking_;
+  // Defaults to false.
+  bool enable_byte_fair_write_scheduling_;
   const NextProto default_protocol_;
   size_t stream_initial_recv_window_size_;
   size_t initial_max_concurrent_streams_;
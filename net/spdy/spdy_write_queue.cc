@@ -4,6 +4,7 @@
 
 #include "net/spdy/spdy_write_queue.h"
 
+#include <algorithm>
 #include <cstddef>
 
 #include "base/logging.h"
@@ -13,30 +14,70 @@
 
 namespace net {
 
-SpdyWriteQueue::PendingWrite::PendingWrite() : frame_producer(NULL) {}
+namespace {
+
+// Returns the virtual time taken by writing |size| bytes at |priority|.
+// Each priority weighs twice as much as the one below it.
+uint64 GetVirtualWriteTime(RequestPriority priority, size_t size) {
+  return static_cast<uint64>(size) << (MAXIMUM_PRIORITY - priority);
+}
+
+}  // namespace
+
+SpdyWriteQueue::QueueLatency::QueueLatency() : num_writes(0) {}
+
+SpdyWriteQueue::PendingWrite::PendingWrite()
+    : frame_producer(NULL),
+      priority(MINIMUM_PRIORITY),
+      sequence_number(0) {}
 
 SpdyWriteQueue::PendingWrite::PendingWrite(
     SpdyFrameType frame_type,
     SpdyBufferProducer* frame_producer,
-    const base::WeakPtr<SpdyStream>& stream)
+    const base::WeakPtr<SpdyStream>& stream,
+    RequestPriority priority,
+    uint64 sequence_number)
     : frame_type(frame_type),
       frame_producer(frame_producer),
       stream(stream),
-      has_stream(stream.get() != NULL) {}
+      has_stream(stream.get() != NULL),
+      priority(priority),
+      enqueue_time(base::TimeTicks::Now()),
+      sequence_number(sequence_number) {}
 
 SpdyWriteQueue::PendingWrite::~PendingWrite() {}
 
-SpdyWriteQueue::SpdyWriteQueue() {}
+SpdyWriteQueue::StreamWrites::StreamWrites()
+    : priority(MINIMUM_PRIORITY),
+      start_time(0) {}
+
+SpdyWriteQueue::StreamWrites::~StreamWrites() {}
+
+SpdyWriteQueue::SpdyWriteQueue()
+    : byte_fair_scheduling_(false),
+      virtual_time_(0),
+      stream_to_charge_(NULL),
+      next_sequence_number_(0) {}
 
 SpdyWriteQueue::~SpdyWriteQueue() {
   Clear();
 }
 
+void SpdyWriteQueue::set_byte_fair_scheduling(bool value) {
+  DCHECK(IsEmpty());
+  byte_fair_scheduling_ = value;
+}
+
 bool SpdyWriteQueue::IsEmpty() const {
   for (int i = MINIMUM_PRIORITY; i <= MAXIMUM_PRIORITY; i++) {
     if (!queue_[i].empty())
       return false;
   }
+  for (StreamWritesMap::const_iterator it = stream_writes_.begin();
+       it != stream_writes_.end(); ++it) {
+    if (!it->second.writes.empty())
+      return false;
+  }
   return true;
 }
 
@@ -48,26 +89,100 @@ void SpdyWriteQueue::Enqueue(RequestPriority priority,
   CHECK_LE(priority, MAXIMUM_PRIORITY);
   if (stream.get())
     DCHECK_EQ(stream->priority(), priority);
-  queue_[priority].push_back(
-      PendingWrite(frame_type, frame_producer.release(), stream));
+  PendingWrite pending_write(frame_type, frame_producer.release(), stream,
+                             priority, next_sequence_number_++);
+  if (!byte_fair_scheduling_ || !stream.get()) {
+    queue_[priority].push_back(pending_write);
+    return;
+  }
+
+  StreamWrites* stream_writes = &stream_writes_[stream.get()];
+  if (stream_writes->writes.empty()) {
+    // A stream that had nothing to write does not get to catch up on
+    // the time it was idle.
+    stream_writes->priority = priority;
+    stream_writes->start_time =
+        std::max(stream_writes->start_time, virtual_time_);
+  }
+  stream_writes->writes.push_back(pending_write);
 }
 
 bool SpdyWriteQueue::Dequeue(SpdyFrameType* frame_type,
                              scoped_ptr<SpdyBufferProducer>* frame_producer,
                              base::WeakPtr<SpdyStream>* stream) {
+  stream_to_charge_ = NULL;
   for (int i = MAXIMUM_PRIORITY; i >= MINIMUM_PRIORITY; --i) {
     if (!queue_[i].empty()) {
       PendingWrite pending_write = queue_[i].front();
       queue_[i].pop_front();
-      *frame_type = pending_write.frame_type;
-      frame_producer->reset(pending_write.frame_producer);
-      *stream = pending_write.stream;
-      if (pending_write.has_stream)
-        DCHECK(stream->get());
+      TakePendingWrite(pending_write, frame_type, frame_producer, stream);
       return true;
     }
   }
-  return false;
+
+  // Pick the stream whose next write starts the earliest in virtual
+  // time, breaking ties by priority and then FIFO.
+  StreamWritesMap::iterator next = stream_writes_.end();
+  for (StreamWritesMap::iterator it = stream_writes_.begin();
+       it != stream_writes_.end(); ++it) {
+    if (it->second.writes.empty())
+      continue;
+    if (next == stream_writes_.end() ||
+        it->second.start_time < next->second.start_time ||
+        (it->second.start_time == next->second.start_time &&
+         (it->second.priority > next->second.priority ||
+          (it->second.priority == next->second.priority &&
+           it->second.writes.front().sequence_number <
+               next->second.writes.front().sequence_number)))) {
+      next = it;
+    }
+  }
+  if (next == stream_writes_.end())
+    return false;
+
+  virtual_time_ = next->second.start_time;
+  stream_to_charge_ = next->first;
+  PendingWrite pending_write = next->second.writes.front();
+  next->second.writes.pop_front();
+  TakePendingWrite(pending_write, frame_type, frame_producer, stream);
+  return true;
+}
+
+void SpdyWriteQueue::ChargeDequeuedWrite(size_t frame_size) {
+  if (!stream_to_charge_)
+    return;
+  StreamWritesMap::iterator it = stream_writes_.find(stream_to_charge_);
+  stream_to_charge_ = NULL;
+  if (it == stream_writes_.end())
+    return;
+  it->second.start_time +=
+      GetVirtualWriteTime(it->second.priority, frame_size);
+}
+
+const SpdyWriteQueue::QueueLatency& SpdyWriteQueue::GetQueueLatency(
+    RequestPriority priority) const {
+  CHECK_GE(priority, MINIMUM_PRIORITY);
+  CHECK_LE(priority, MAXIMUM_PRIORITY);
+  return queue_latency_[priority];
+}
+
+void SpdyWriteQueue::TakePendingWrite(
+    const PendingWrite& pending_write,
+    SpdyFrameType* frame_type,
+    scoped_ptr<SpdyBufferProducer>* frame_producer,
+    base::WeakPtr<SpdyStream>* stream) {
+  *frame_type = pending_write.frame_type;
+  frame_producer->reset(pending_write.frame_producer);
+  *stream = pending_write.stream;
+  if (pending_write.has_stream)
+    DCHECK(stream->get());
+
+  QueueLatency* latency = &queue_latency_[pending_write.priority];
+  base::TimeDelta waited =
+      base::TimeTicks::Now() - pending_write.enqueue_time;
+  ++latency->num_writes;
+  latency->total += waited;
+  latency->max = std::max(latency->max, waited);
 }
 
 void SpdyWriteQueue::RemovePendingWritesForStream(
@@ -103,6 +218,18 @@ void SpdyWriteQueue::RemovePendingWritesForStream(
     }
   }
   queue->erase(out_it, queue->end());
+
+  StreamWritesMap::iterator stream_it = stream_writes_.find(stream.get());
+  if (stream_it != stream_writes_.end()) {
+    std::deque<PendingWrite>* writes = &stream_it->second.writes;
+    for (std::deque<PendingWrite>::iterator it = writes->begin();
+         it != writes->end(); ++it) {
+      delete it->frame_producer;
+    }
+    stream_writes_.erase(stream_it);
+  }
+  if (stream_to_charge_ == stream.get())
+    stream_to_charge_ = NULL;
 }
 
 void SpdyWriteQueue::RemovePendingWritesForStreamsAfter(
@@ -123,6 +250,21 @@ void SpdyWriteQueue::RemovePendingWritesForStreamsAfter(
     }
     queue->erase(out_it, queue->end());
   }
+
+  for (StreamWritesMap::iterator stream_it = stream_writes_.begin();
+       stream_it != stream_writes_.end(); ++stream_it) {
+    std::deque<PendingWrite>* writes = &stream_it->second.writes;
+    if (writes->empty() || !writes->front().stream.get())
+      continue;
+    SpdyStreamId stream_id = writes->front().stream->stream_id();
+    if (stream_id <= last_good_stream_id && stream_id != 0)
+      continue;
+    for (std::deque<PendingWrite>::iterator it = writes->begin();
+         it != writes->end(); ++it) {
+      delete it->frame_producer;
+    }
+    writes->clear();
+  }
 }
 
 void SpdyWriteQueue::Clear() {
@@ -133,6 +275,16 @@ void SpdyWriteQueue::Clear() {
     }
     queue_[i].clear();
   }
+  for (StreamWritesMap::iterator stream_it = stream_writes_.begin();
+       stream_it != stream_writes_.end(); ++stream_it) {
+    std::deque<PendingWrite>* writes = &stream_it->second.writes;
+    for (std::deque<PendingWrite>::iterator it = writes->begin();
+         it != writes->end(); ++it) {
+      delete it->frame_producer;
+    }
+  }
+  stream_writes_.clear();
+  stream_to_charge_ = NULL;
 }
 
 }  // namespace net
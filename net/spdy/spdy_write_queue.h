@@ -6,10 +6,12 @@
 #define NET_SPDY_SPDY_WRITE_QUEUE_H_
 
 #include <deque>
+#include <map>
 
 #include "base/basictypes.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "net/base/net_export.h"
 #include "net/base/request_priority.h"
 #include "net/spdy/spdy_protocol.h"
@@ -22,11 +24,32 @@ class SpdyStream;
 
 // A queue of SpdyBufferProducers to produce frames to write. Ordered
 // by priority, and then FIFO.
+//
+// With byte-fair scheduling enabled, only the frames not associated
+// with a stream are still ordered that way, and they go before all
+// the others. The streams share the connection instead, each getting
+// a number of bytes proportional to a weight given by its priority,
+// so that low priority streams are not starved and a large upload
+// does not hold back the small requests of higher priority.
 class NET_EXPORT_PRIVATE SpdyWriteQueue {
  public:
+  // How long the writes of a priority waited in the queue.
+  struct QueueLatency {
+    QueueLatency();
+
+    int num_writes;
+    base::TimeDelta total;
+    base::TimeDelta max;
+  };
+
   SpdyWriteQueue();
   ~SpdyWriteQueue();
 
+  // Enables or disables byte-fair scheduling of the writes of
+  // streams. Must only be changed while the queue is empty.
+  void set_byte_fair_scheduling(bool value);
+  bool byte_fair_scheduling() const { return byte_fair_scheduling_; }
+
   // Returns whether there is anything in the write queue,
   // i.e. whether the next call to Dequeue will return true.
   bool IsEmpty() const;
@@ -49,6 +72,14 @@ class NET_EXPORT_PRIVATE SpdyWriteQueue {
                scoped_ptr<SpdyBufferProducer>* frame_producer,
                base::WeakPtr<SpdyStream>* stream);
 
+  // Charges the stream of the last dequeued frame producer with the
+  // |frame_size| bytes of the frame it produced. Does nothing unless
+  // byte-fair scheduling is enabled.
+  void ChargeDequeuedWrite(size_t frame_size);
+
+  // Returns how long the dequeued writes of |priority| waited.
+  const QueueLatency& GetQueueLatency(RequestPriority priority) const;
+
   // Removes all pending writes for the given stream, which must be
   // non-NULL.
   void RemovePendingWritesForStream(const base::WeakPtr<SpdyStream>& stream);
@@ -70,17 +101,63 @@ class NET_EXPORT_PRIVATE SpdyWriteQueue {
     base::WeakPtr<SpdyStream> stream;
     // Whether |stream| was non-NULL when enqueued.
     bool has_stream;
+    RequestPriority priority;
+    base::TimeTicks enqueue_time;
+    // Orders the writes of different streams that are otherwise tied.
+    uint64 sequence_number;
 
     PendingWrite();
     PendingWrite(SpdyFrameType frame_type,
                  SpdyBufferProducer* frame_producer,
-                 const base::WeakPtr<SpdyStream>& stream);
+                 const base::WeakPtr<SpdyStream>& stream,
+                 RequestPriority priority,
+                 uint64 sequence_number);
     ~PendingWrite();
   };
 
-  // The actual write queue, binned by priority.
+  // The pending writes of a stream, with byte-fair scheduling.
+  struct StreamWrites {
+    StreamWrites();
+    ~StreamWrites();
+
+    RequestPriority priority;
+    // The virtual time at which the next write of the stream starts.
+    // Each byte written by the stream moves it forward by the inverse
+    // of the weight of the stream.
+    uint64 start_time;
+    std::deque<PendingWrite> writes;
+  };
+
+  // Streams are kept here until their writes are removed, even while
+  // they have none, so that they keep their place in virtual time.
+  typedef std::map<SpdyStream*, StreamWrites> StreamWritesMap;
+
+  // Takes |pending_write| out into the output parameters of Dequeue().
+  void TakePendingWrite(const PendingWrite& pending_write,
+                        SpdyFrameType* frame_type,
+                        scoped_ptr<SpdyBufferProducer>* frame_producer,
+                        base::WeakPtr<SpdyStream>* stream);
+
+  bool byte_fair_scheduling_;
+
+  // The actual write queue, binned by priority. With byte-fair
+  // scheduling, it only holds the writes not associated with a
+  // stream.
   std::deque<PendingWrite> queue_[NUM_PRIORITIES];
 
+  // The writes of streams, with byte-fair scheduling.
+  StreamWritesMap stream_writes_;
+
+  // The start time of the last stream write dequeued.
+  uint64 virtual_time_;
+
+  // The stream to charge by ChargeDequeuedWrite(), if any.
+  SpdyStream* stream_to_charge_;
+
+  uint64 next_sequence_number_;
+
+  QueueLatency queue_latency_[NUM_PRIORITIES];
+
   DISALLOW_COPY_AND_ASSIGN(SpdyWriteQueue);
 };
 
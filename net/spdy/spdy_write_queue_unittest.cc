@@ -247,6 +247,151 @@ TEST_F(SpdyWriteQueueTest, Clear) {
   EXPECT_FALSE(write_queue.Dequeue(&frame_type, &frame_producer, &stream));
 }
 
+// Dequeues the next frame producer of |write_queue|, charges the
+// queue with the size of the frame it produces and returns the data
+// of the frame as an int. Fills in |stream| with the stream of the
+// frame.
+int DequeueAndChargeInt(SpdyWriteQueue* write_queue, SpdyStream** stream) {
+  SpdyFrameType frame_type = DATA;
+  scoped_ptr<SpdyBufferProducer> frame_producer;
+  base::WeakPtr<SpdyStream> weak_stream;
+  EXPECT_TRUE(
+      write_queue->Dequeue(&frame_type, &frame_producer, &weak_stream));
+  if (!frame_producer)
+    return -1;
+  scoped_ptr<SpdyBuffer> buffer = frame_producer->ProduceBuffer();
+  write_queue->ChargeDequeuedWrite(buffer->GetRemainingSize());
+  *stream = weak_stream.get();
+  int i = 0;
+  EXPECT_TRUE(base::StringToInt(
+      std::string(buffer->GetRemainingData(), buffer->GetRemainingSize()),
+      &i));
+  return i;
+}
+
+// With byte-fair scheduling, streams of the same priority should take
+// turns writing frames of the same size.
+TEST_F(SpdyWriteQueueTest, ByteFairInterleavesStreams) {
+  SpdyWriteQueue write_queue;
+  write_queue.set_byte_fair_scheduling(true);
+
+  scoped_ptr<SpdyStream> stream1(MakeTestStream(DEFAULT_PRIORITY));
+  scoped_ptr<SpdyStream> stream2(MakeTestStream(DEFAULT_PRIORITY));
+  for (int i = 0; i < 3; ++i) {
+    write_queue.Enqueue(DEFAULT_PRIORITY, DATA, IntToProducer(i),
+                        stream1->GetWeakPtr());
+  }
+  for (int i = 0; i < 3; ++i) {
+    write_queue.Enqueue(DEFAULT_PRIORITY, DATA, IntToProducer(i),
+                        stream2->GetWeakPtr());
+  }
+
+  for (int i = 0; i < 3; ++i) {
+    SpdyStream* stream = NULL;
+    EXPECT_EQ(i, DequeueAndChargeInt(&write_queue, &stream));
+    EXPECT_EQ(stream1.get(), stream);
+    EXPECT_EQ(i, DequeueAndChargeInt(&write_queue, &stream));
+    EXPECT_EQ(stream2.get(), stream);
+  }
+  EXPECT_TRUE(write_queue.IsEmpty());
+}
+
+// With byte-fair scheduling, a stream should get to write twice as
+// many bytes as a stream one priority below it.
+TEST_F(SpdyWriteQueueTest, ByteFairWeighsByPriority) {
+  SpdyWriteQueue write_queue;
+  write_queue.set_byte_fair_scheduling(true);
+
+  scoped_ptr<SpdyStream> stream_medium(MakeTestStream(MEDIUM));
+  scoped_ptr<SpdyStream> stream_highest(MakeTestStream(HIGHEST));
+  for (int i = 0; i < 10; ++i) {
+    write_queue.Enqueue(MEDIUM, DATA, IntToProducer(i),
+                        stream_medium->GetWeakPtr());
+    write_queue.Enqueue(HIGHEST, DATA, IntToProducer(i),
+                        stream_highest->GetWeakPtr());
+  }
+
+  int highest_writes = 0;
+  int medium_writes = 0;
+  for (int i = 0; i < 6; ++i) {
+    SpdyStream* stream = NULL;
+    DequeueAndChargeInt(&write_queue, &stream);
+    if (stream == stream_highest.get())
+      ++highest_writes;
+    else if (stream == stream_medium.get())
+      ++medium_writes;
+  }
+  EXPECT_EQ(4, highest_writes);
+  EXPECT_EQ(2, medium_writes);
+}
+
+// With byte-fair scheduling, the frames not associated with a stream
+// should be dequeued before those of streams, even if of lower
+// priority and enqueued later.
+TEST_F(SpdyWriteQueueTest, ByteFairSessionFramesFirst) {
+  SpdyWriteQueue write_queue;
+  write_queue.set_byte_fair_scheduling(true);
+
+  scoped_ptr<SpdyStream> stream1(MakeTestStream(HIGHEST));
+  write_queue.Enqueue(HIGHEST, DATA, IntToProducer(1), stream1->GetWeakPtr());
+  write_queue.Enqueue(LOWEST, PING, IntToProducer(2),
+                      base::WeakPtr<SpdyStream>());
+
+  SpdyStream* stream = NULL;
+  EXPECT_EQ(2, DequeueAndChargeInt(&write_queue, &stream));
+  EXPECT_EQ(NULL, stream);
+  EXPECT_EQ(1, DequeueAndChargeInt(&write_queue, &stream));
+  EXPECT_EQ(stream1.get(), stream);
+  EXPECT_TRUE(write_queue.IsEmpty());
+}
+
+// With byte-fair scheduling, RemovePendingWritesForStream() should
+// remove the writes of the stream only.
+TEST_F(SpdyWriteQueueTest, ByteFairRemovePendingWritesForStream) {
+  SpdyWriteQueue write_queue;
+  write_queue.set_byte_fair_scheduling(true);
+
+  scoped_ptr<SpdyStream> stream1(MakeTestStream(DEFAULT_PRIORITY));
+  scoped_ptr<SpdyStream> stream2(MakeTestStream(DEFAULT_PRIORITY));
+  for (int i = 0; i < 10; ++i) {
+    write_queue.Enqueue(DEFAULT_PRIORITY, DATA, IntToProducer(i),
+                        (((i % 2) == 0) ? stream1 : stream2)->GetWeakPtr());
+  }
+
+  write_queue.RemovePendingWritesForStream(stream2->GetWeakPtr());
+
+  for (int i = 0; i < 10; i += 2) {
+    SpdyStream* stream = NULL;
+    EXPECT_EQ(i, DequeueAndChargeInt(&write_queue, &stream));
+    EXPECT_EQ(stream1.get(), stream);
+  }
+  EXPECT_TRUE(write_queue.IsEmpty());
+}
+
+// The time the dequeued writes waited should be tracked by priority.
+TEST_F(SpdyWriteQueueTest, QueueLatency) {
+  SpdyWriteQueue write_queue;
+
+  write_queue.Enqueue(LOW, SYN_STREAM, IntToProducer(1),
+                      base::WeakPtr<SpdyStream>());
+  write_queue.Enqueue(LOW, SYN_STREAM, IntToProducer(2),
+                      base::WeakPtr<SpdyStream>());
+  write_queue.Enqueue(HIGHEST, SYN_STREAM, IntToProducer(3),
+                      base::WeakPtr<SpdyStream>());
+
+  SpdyFrameType frame_type = DATA;
+  scoped_ptr<SpdyBufferProducer> frame_producer;
+  base::WeakPtr<SpdyStream> stream;
+  ASSERT_TRUE(write_queue.Dequeue(&frame_type, &frame_producer, &stream));
+  ASSERT_TRUE(write_queue.Dequeue(&frame_type, &frame_producer, &stream));
+
+  EXPECT_EQ(1, write_queue.GetQueueLatency(HIGHEST).num_writes);
+  EXPECT_EQ(1, write_queue.GetQueueLatency(LOW).num_writes);
+  EXPECT_LE(write_queue.GetQueueLatency(LOW).max,
+            write_queue.GetQueueLatency(LOW).total);
+  EXPECT_EQ(0, write_queue.GetQueueLatency(IDLE).num_writes);
+}
+
 }  // namespace
 
 }  // namespace net
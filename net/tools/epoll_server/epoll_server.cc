@@ -463,8 +463,19 @@ void EpollServer::RegisterAlarm(int64 timeout_time_in_us, AlarmCB* ac) {
   }
   VLOG(4) << "RegisteringAlarm at : " << timeout_time_in_us;
 
-  TimeToAlarmCBMap::iterator alarm_iter =
-      alarm_map_.insert(std::make_pair(timeout_time_in_us, ac));
+  // Alarms are mostly registered for "now plus a timeout", so the new
+  // deadline is usually no earlier than every registered one. Hinting the
+  // insert at the end makes that common case amortized constant time instead
+  // of a full O(log n) descent. Entries with equal deadlines still end up in
+  // registration order, exactly as with an unhinted insert.
+  TimeToAlarmCBMap::iterator alarm_iter;
+  if (alarm_map_.empty() ||
+      alarm_map_.rbegin()->first <= timeout_time_in_us) {
+    alarm_iter = alarm_map_.insert(alarm_map_.end(),
+                                   std::make_pair(timeout_time_in_us, ac));
+  } else {
+    alarm_iter = alarm_map_.insert(std::make_pair(timeout_time_in_us, ac));
+  }
 
   all_alarms_.insert(ac);
   // Pass the iterator to the EpollAlarmCallbackInterface.
@@ -8,6 +8,7 @@
 #include <sys/file.h>
 #include <sys/stat.h>
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -43,6 +44,10 @@ int32 FLAGS_accept_backlog_size = 1024;
 //  SO_REUSEPORT);
 bool FLAGS_reuseport = false;
 
+// The number of worker threads, each with its own epoll server and
+//  connections, that accept from each listening socket);
+int32 FLAGS_worker_threads = 1;
+
 // Flag to force spdy, even if NPN is not negotiated.
 bool FLAGS_force_spdy = false;
 
@@ -198,6 +203,10 @@ int main(int argc, char** argv) {
         "\t--ssl-session-expiry=<seconds> (default is 300)\n"
         "\t--ssl-disable-compression\n"
         "\t--idle-timeout=<seconds> (default is 300)\n"
+        "\t--worker-threads=<n> (default is 1)\n"
+        "\t  * The number of threads accepting and serving connections"
+        " for each\n"
+        "\t    listen ip:port.\n"
         "\t--pidfile=<filepath> (default /var/run/flip-server.pid)\n"
         "\t--help\n");
     exit(0);
@@ -260,6 +269,11 @@ int main(int argc, char** argv) {
         atoi(cl.GetSwitchValueASCII("idle-timeout").c_str());
   }
 
+  if (cl.HasSwitch("worker-threads")) {
+    FLAGS_worker_threads =
+        std::max(1, atoi(cl.GetSwitchValueASCII("worker-threads").c_str()));
+  }
+
   if (cl.HasSwitch("force_spdy"))
     net::SMConnection::set_force_spdy(true);
 
@@ -292,6 +306,7 @@ int main(int argc, char** argv) {
             << g_proxy_config.ssl_disable_compression_;
   LOG(INFO) << "Connection idle timeout : "
             << g_proxy_config.idle_socket_timeout_s_;
+  LOG(INFO) << "Worker threads          : " << FLAGS_worker_threads;
 
   // Proxy Acceptors
   while (true) {
@@ -382,18 +397,16 @@ int main(int argc, char** argv) {
   for (i = 0; i < g_proxy_config.acceptors_.size(); i++) {
     net::FlipAcceptor* acceptor = g_proxy_config.acceptors_[i];
 
-    sm_worker_threads_.push_back(new net::SMAcceptorThread(
-        acceptor, (net::MemoryCache*)acceptor->memory_cache_));
-    // Note that spdy_memory_cache is not threadsafe, it is merely
-    // thread compatible. Thus, if ever we are to spawn multiple threads,
-    // we either must make the MemoryCache threadsafe, or use
-    // a separate MemoryCache for each thread.
-    //
-    // The latter is what is currently being done as we spawn
-    // a separate thread for each http and spdy server acceptor.
-
-    sm_worker_threads_.back()->InitWorker();
-    sm_worker_threads_.back()->Start();
+    // All the workers of an acceptor watch its (non-blocking) listening
+    // socket, and whichever wakes first accepts the connection. They share
+    // the acceptor's MemoryCache: it is not threadsafe, but it is filled
+    // before any thread starts and only read afterwards, which is safe.
+    for (int worker = 0; worker < FLAGS_worker_threads; ++worker) {
+      sm_worker_threads_.push_back(new net::SMAcceptorThread(
+          acceptor, (net::MemoryCache*)acceptor->memory_cache_));
+      sm_worker_threads_.back()->InitWorker();
+      sm_worker_threads_.back()->Start();
+    }
   }
 
   while (!wantExit) {
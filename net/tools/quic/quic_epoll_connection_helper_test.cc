@@ -4,6 +4,9 @@
 
 #include "net/tools/quic/quic_epoll_connection_helper.h"
 
+#include <vector>
+
+#include "base/memory/scoped_vector.h"
 #include "net/quic/crypto/quic_random.h"
 #include "net/tools/quic/test_tools/mock_epoll_server.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -103,6 +106,47 @@ TEST_F(QuicEpollConnectionHelperTest, CreateAlarmAndReset) {
   EXPECT_TRUE(delegate->fired());
 }
 
+// Models a server with many connections, each of which re-arms its alarm as
+// packets arrive, and checks that alarms registered both in and out of
+// deadline order fire exactly when due.
+TEST_F(QuicEpollConnectionHelperTest, ManyAlarmsSetAndCancel) {
+  const int kNumAlarms = 1000;
+  const QuicClock* clock = helper_.GetClock();
+  QuicTime start = clock->Now();
+
+  ScopedVector<QuicAlarm> alarms;
+  std::vector<TestDelegate*> delegates;
+  for (int i = 0; i < kNumAlarms; ++i) {
+    delegates.push_back(new TestDelegate());
+    alarms.push_back(helper_.CreateAlarm(delegates.back()));
+  }
+
+  // Arm every alarm at an increasing deadline, as a burst of packets would.
+  for (int i = 0; i < kNumAlarms; ++i) {
+    alarms[i]->Set(start.Add(QuicTime::Delta::FromMicroseconds(i + 1)));
+  }
+  // Re-arm the odd alarms, pushing them out past all the even ones, in
+  // reverse order so that deadlines are registered out of order as well.
+  for (int i = kNumAlarms - 1; i >= 0; --i) {
+    if (i % 2 == 0)
+      continue;
+    alarms[i]->Cancel();
+    alarms[i]->Set(
+        start.Add(QuicTime::Delta::FromMicroseconds(kNumAlarms + i + 1)));
+  }
+
+  epoll_server_.AdvanceByExactlyAndCallCallbacks(kNumAlarms);
+  for (int i = 0; i < kNumAlarms; ++i) {
+    EXPECT_EQ(i % 2 == 0, delegates[i]->fired()) << i;
+  }
+
+  epoll_server_.AdvanceByExactlyAndCallCallbacks(kNumAlarms);
+  for (int i = 0; i < kNumAlarms; ++i) {
+    EXPECT_TRUE(delegates[i]->fired()) << i;
+    EXPECT_FALSE(alarms[i]->IsSet()) << i;
+  }  EXPECT_EQ(0u, epoll_server_.NumberOfAlarms());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace tools
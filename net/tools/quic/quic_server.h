@@ -64,6 +64,12 @@ class QuicServer : public EpollCallbackInterface {
 
   virtual void OnShutdown(EpollServer* eps, int fd) OVERRIDE {}
 
+  // Sets SO_REUSEPORT on the listening socket, so that several servers (e.g.
+  // one per thread, each with its own dispatcher) can listen on the same port
+  // and have the kernel spread clients across them. Must be called before
+  // Listen().
+  void set_reuse_port(bool reuse_port) { reuse_port_ = reuse_port; }
+
   void SetStrikeRegisterNoStartupPeriod() {
     crypto_config_.set_strike_register_no_startup_period();
   }
@@ -109,6 +115,9 @@ class QuicServer : public EpollCallbackInterface {
   // If true, use recvmmsg for reading.
   bool use_recvmmsg_;
 
+  // If true, the listening socket is bound with SO_REUSEPORT.
+  bool reuse_port_;
+
   // config_ contains non-crypto parameters that are negotiated in the crypto
   // handshake.
   QuicConfig config_;
@@ -11,7 +11,10 @@
 #include "base/basictypes.h"
 #include "base/command_line.h"
 #include "base/logging.h"
+#include "base/memory/scoped_vector.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/simple_thread.h"
 #include "net/base/ip_endpoint.h"
 #include "net/tools/quic/quic_in_memory_cache.h"
 #include "net/tools/quic/quic_server.h"
@@ -20,6 +23,32 @@
 
 int32 FLAGS_port = 6121;
 
+// The number of threads, each running its own server (and so its own epoll
+// server, dispatcher and time wait list) on the port.
+int32 FLAGS_num_threads = 1;
+
+namespace {
+
+// Runs a server's event loop forever on a worker thread.
+class ServerLoop : public base::DelegateSimpleThread::Delegate {
+ public:
+  explicit ServerLoop(net::tools::QuicServer* server) : server_(server) {}
+  virtual ~ServerLoop() {}
+
+  virtual void Run() OVERRIDE {
+    while (1) {
+      server_->WaitForEvents();
+    }
+  }
+
+ private:
+  net::tools::QuicServer* server_;
+
+  DISALLOW_COPY_AND_ASSIGN(ServerLoop);
+};
+
+}  // namespace
+
 int main(int argc, char *argv[]) {
   CommandLine::Init(argc, argv);
   CommandLine* line = CommandLine::ForCurrentProcess();
@@ -35,6 +64,8 @@ int main(int argc, char *argv[]) {
         "Options:\n"
         "-h, --help                  show this help message and exit\n"
         "--port=<port>               specify the port to listen on\n"
+        "--num_threads=<n>           number of server threads sharing the\n"
+        "                            port via SO_REUSEPORT (default 1)\n"
         "--quic_in_memory_cache_dir  directory containing response data\n"
         "                            to load\n";
     std::cout << help_str;
@@ -53,19 +84,44 @@ int main(int argc, char *argv[]) {
     }
   }
 
+  if (line->HasSwitch("num_threads")) {
+    int num_threads;
+    if (base::StringToInt(line->GetSwitchValueASCII("num_threads"),
+                          &num_threads) && num_threads > 0) {
+      FLAGS_num_threads = num_threads;
+    }
+  }
+
   base::AtExitManager exit_manager;
 
   net::IPAddressNumber ip;
   CHECK(net::ParseIPLiteralToNumber("::", &ip));
 
-  net::tools::QuicServer server;
+  // The kernel hashes each client's address to one of the sockets sharing the
+  // port, so all packets of a connection reach the same server as long as the
+  // client's address doesn't change.
+  ScopedVector<net::tools::QuicServer> servers;
+  for (int i = 0; i < FLAGS_num_threads; ++i) {
+    net::tools::QuicServer* server = new net::tools::QuicServer;
+    servers.push_back(server);
+    server->set_reuse_port(FLAGS_num_threads > 1);
+    if (!server->Listen(net::IPEndPoint(ip, FLAGS_port))) {
+      return 1;
+    }
+  }
 
-  if (!server.Listen(net::IPEndPoint(ip, FLAGS_port))) {
-    return 1;
+  // The first server runs on the main thread; the others get one thread each.
+  ScopedVector<ServerLoop> loops;
+  ScopedVector<base::DelegateSimpleThread> threads;
+  for (int i = 1; i < FLAGS_num_threads; ++i) {
+    loops.push_back(new ServerLoop(servers[i]));
+    threads.push_back(new base::DelegateSimpleThread(
+        loops.back(), base::StringPrintf("QuicServer%d", i)));
+    threads.back()->Start();
   }
 
   while (1) {
-    server.WaitForEvents();
+    servers[0]->WaitForEvents();
   }
 
   return 0;
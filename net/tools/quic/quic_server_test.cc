@@ -4,6 +4,8 @@
 
 #include "net/tools/quic/quic_server.h"
 
+#include "net/base/ip_endpoint.h"
+#include "net/base/net_util.h"
 #include "net/quic/crypto/quic_random.h"
 #include "net/quic/quic_utils.h"
 #include "net/tools/quic/test_tools/mock_quic_dispatcher.h"
@@ -56,6 +58,24 @@ TEST_F(QuicServerDispatchPacketTest, DispatchPacket) {
   DispatchPacket(encrypted_valid_packet);
 }
 
+TEST(QuicServerTest, ListenWithReusePort) {
+  IPAddressNumber ip;
+  ASSERT_TRUE(ParseIPLiteralToNumber("127.0.0.1", &ip));
+
+  QuicServer first_server;
+  first_server.set_reuse_port(true);
+  ASSERT_TRUE(first_server.Listen(IPEndPoint(ip, 0)));
+
+  // A second server can share the port, as a server thread would.
+  QuicServer second_server;
+  second_server.set_reuse_port(true);
+  EXPECT_TRUE(second_server.Listen(IPEndPoint(ip, first_server.port())));
+  EXPECT_EQ(first_server.port(), second_server.port());
+
+  second_server.Shutdown();
+  first_server.Shutdown();
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace tools
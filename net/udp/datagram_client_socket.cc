@@ -0,0 +1,41 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/udp/datagram_client_socket.h"
+
+#include "base/bind.h"
+#include "base/logging.h"
+
+namespace net {
+
+namespace {
+
+void OnDatagramRead(std::vector<int>* packet_sizes,
+                    const CompletionCallback& callback,
+                    int result) {
+  if (result >= 0) {
+    packet_sizes->push_back(result);
+    result = 1;
+  }
+  callback.Run(result);
+}
+
+}  // namespace
+
+int DatagramClientSocket::ReadMultiple(IOBuffer* buf,
+                                       int packet_len,
+                                       int max_packets,
+                                       std::vector<int>* packet_sizes,
+                                       const CompletionCallback& callback) {
+  DCHECK_GT(max_packets, 0);
+  packet_sizes->clear();
+  int rv = Read(buf, packet_len,
+                base::Bind(&OnDatagramRead, packet_sizes, callback));
+  if (rv < 0)
+    return rv;
+  packet_sizes->push_back(rv);
+  return 1;
+}
+
+}  // namespace net
@@ -5,6 +5,8 @@
 #ifndef NET_UDP_DATAGRAM_CLIENT_SOCKET_H_
 #define NET_UDP_DATAGRAM_CLIENT_SOCKET_H_
 
+#include <vector>
+
 #include "net/socket/socket.h"
 #include "net/udp/datagram_socket.h"
 
@@ -20,6 +22,20 @@ class NET_EXPORT_PRIVATE DatagramClientSocket : public DatagramSocket,
   // Initialize this socket as a client socket to server at |address|.
   // Returns a network error code.
   virtual int Connect(const IPEndPoint& address) = 0;
+
+  // Reads up to |max_packets| datagrams at once, the i-th into |buf| at
+  // offset i * |packet_len|, and fills in |packet_sizes| with their sizes.
+  // |buf| must hold |max_packets| * |packet_len| bytes. Returns the number
+  // of datagrams read, or a net error code. If ERR_IO_PENDING is returned,
+  // the caller must keep |buf| and |packet_sizes| alive until |callback| is
+  // called with the result.
+  //
+  // The default implementation reads a single datagram with Read().
+  virtual int ReadMultiple(IOBuffer* buf,
+                           int packet_len,
+                           int max_packets,
+                           std::vector<int>* packet_sizes,
+                           const CompletionCallback& callback);
 };
 
 }  // namespace net
@@ -28,6 +28,21 @@ int UDPClientSocket::Read(IOBuffer* buf,
   return socket_.Read(buf, buf_len, callback);
 }
 
+int UDPClientSocket::ReadMultiple(IOBuffer* buf,
+                                  int packet_len,
+                                  int max_packets,
+                                  std::vector<int>* packet_sizes,
+                                  const CompletionCallback& callback) {
+#if defined(OS_POSIX)
+  return socket_.ReadMultiple(buf, packet_len, max_packets, packet_sizes,
+                              callback);
+#else
+  // Overlapped reads complete one datagram at a time.
+  return DatagramClientSocket::ReadMultiple(buf, packet_len, max_packets,
+                                            packet_sizes, callback);
+#endif
+}
+
 int UDPClientSocket::Write(IOBuffer* buf,
                           int buf_len,
                           const CompletionCallback& callback) {
@@ -27,6 +27,11 @@ class NET_EXPORT_PRIVATE UDPClientSocket : public DatagramClientSocket {
   virtual int Connect(const IPEndPoint& address) OVERRIDE;
   virtual int Read(IOBuffer* buf, int buf_len,
                    const CompletionCallback& callback) OVERRIDE;
+  virtual int ReadMultiple(IOBuffer* buf,
+                           int packet_len,
+                           int max_packets,
+                           std::vector<int>* packet_sizes,
+                           const CompletionCallback& callback) OVERRIDE;
   virtual int Write(IOBuffer* buf, int buf_len,
                     const CompletionCallback& callback) OVERRIDE;
   virtual void Close() OVERRIDE;
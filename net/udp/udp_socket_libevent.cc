@@ -75,6 +75,9 @@ UDPSocketLibevent::UDPSocketLibevent(
           write_watcher_(this),
           read_buf_len_(0),
           recv_from_address_(NULL),
+          read_max_packets_(0),
+          read_packet_sizes_(NULL),
+          pending_read_error_(OK),
           write_buf_len_(0),
           net_log_(BoundNetLog::Make(net_log, NetLog::SOURCE_UDP_SOCKET)) {
   net_log_.BeginEvent(NetLog::TYPE_SOCKET_ALIVE,
@@ -99,6 +102,9 @@ void UDPSocketLibevent::Close() {
   read_buf_len_ = 0;
   read_callback_.Reset();
   recv_from_address_ = NULL;
+  read_max_packets_ = 0;
+  read_packet_sizes_ = NULL;
+  pending_read_error_ = OK;
   write_buf_ = NULL;
   write_buf_len_ = 0;
   write_callback_.Reset();
@@ -164,6 +170,40 @@ int UDPSocketLibevent::Read(IOBuffer* buf,
   return RecvFrom(buf, buf_len, NULL, callback);
 }
 
+int UDPSocketLibevent::ReadMultiple(IOBuffer* buf,
+                                    int packet_len,
+                                    int max_packets,
+                                    std::vector<int>* packet_sizes,
+                                    const CompletionCallback& callback) {
+  DCHECK(CalledOnValidThread());
+  DCHECK_NE(kInvalidSocket, socket_);
+  DCHECK(read_callback_.is_null());
+  DCHECK(!recv_from_address_);
+  DCHECK(!callback.is_null());  // Synchronous operation not supported
+  DCHECK_GT(packet_len, 0);
+  DCHECK_GT(max_packets, 0);
+
+  int nread = InternalRecvMultiple(buf, packet_len, max_packets, packet_sizes);
+  if (nread != ERR_IO_PENDING)
+    return nread;
+
+  if (!base::MessageLoopForIO::current()->WatchFileDescriptor(
+          socket_, true, base::MessageLoopForIO::WATCH_READ,
+          &read_socket_watcher_, &read_watcher_)) {
+    PLOG(ERROR) << "WatchFileDescriptor failed on read";
+    int result = MapSystemError(errno);
+    LogRead(result, NULL, 0, NULL);
+    return result;
+  }
+
+  read_buf_ = buf;
+  read_buf_len_ = packet_len;
+  read_max_packets_ = max_packets;
+  read_packet_sizes_ = packet_sizes;
+  read_callback_ = callback;
+  return ERR_IO_PENDING;
+}
+
 int UDPSocketLibevent::RecvFrom(IOBuffer* buf,
                                 int buf_len,
                                 IPEndPoint* address,
@@ -376,12 +416,16 @@ void UDPSocketLibevent::DoWriteCallback(int rv) {
 }
 
 void UDPSocketLibevent::DidCompleteRead() {
-  int result =
+  int result = read_packet_sizes_ ?
+      InternalRecvMultiple(read_buf_.get(), read_buf_len_, read_max_packets_,
+                           read_packet_sizes_) :
       InternalRecvFrom(read_buf_.get(), read_buf_len_, recv_from_address_);
   if (result != ERR_IO_PENDING) {
     read_buf_ = NULL;
     read_buf_len_ = 0;
     recv_from_address_ = NULL;
+    read_max_packets_ = 0;
+    read_packet_sizes_ = NULL;
     bool ok = read_socket_watcher_.StopWatchingFileDescriptor();
     DCHECK(ok);
     DoReadCallback(result);
@@ -485,6 +529,65 @@ int UDPSocketLibevent::InternalRecvFrom(IOBuffer* buf, int buf_len,
   return result;
 }
 
+int UDPSocketLibevent::InternalRecvMultiple(IOBuffer* buf,
+                                            int packet_len,
+                                            int max_packets,
+                                            std::vector<int>* packet_sizes) {
+  packet_sizes->clear();
+
+#if defined(OS_LINUX)
+  scoped_ptr<SockaddrStorage[]> storage(new SockaddrStorage[max_packets]);
+  std::vector<struct iovec> iovs(max_packets);
+  std::vector<struct mmsghdr> messages(max_packets);
+  for (int i = 0; i < max_packets; ++i) {
+    iovs[i].iov_base = buf->data() + i * packet_len;
+    iovs[i].iov_len = packet_len;
+    messages[i].msg_hdr.msg_name = storage[i].addr;
+    messages[i].msg_hdr.msg_namelen = storage[i].addr_len;
+    messages[i].msg_hdr.msg_iov = &iovs[i];
+    messages[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  int count = HANDLE_EINTR(
+      recvmmsg(socket_, &messages[0], max_packets, 0, NULL));
+  if (count < 0) {
+    int result = MapSystemError(errno);
+    if (result != ERR_IO_PENDING)
+      LogRead(result, NULL, 0, NULL);
+    return result;
+  }
+  for (int i = 0; i < count; ++i) {
+    int size = static_cast<int>(messages[i].msg_len);
+    packet_sizes->push_back(size);
+    LogRead(size, buf->data() + i * packet_len,
+            messages[i].msg_hdr.msg_namelen, storage[i].addr);
+  }
+  return count;
+#else
+  // Read the datagrams already received one by one. An error after the
+  // first one is kept for the next read to report, as recvmmsg() does.
+  if (pending_read_error_ != OK) {
+    int result = pending_read_error_;
+    pending_read_error_ = OK;
+    return result;
+  }
+  while (static_cast<int>(packet_sizes->size()) < max_packets) {
+    scoped_refptr<IOBuffer> packet(new WrappedIOBuffer(
+        buf->data() + packet_sizes->size() * packet_len));
+    int result = InternalRecvFrom(packet.get(), packet_len, NULL);
+    if (result < 0) {
+      if (packet_sizes->empty())
+        return result;
+      if (result != ERR_IO_PENDING)
+        pending_read_error_ = result;
+      break;
+    }
+    packet_sizes->push_back(result);
+  }
+  return static_cast<int>(packet_sizes->size());
+#endif
+}
+
 int UDPSocketLibevent::InternalSendTo(IOBuffer* buf, int buf_len,
                                       const IPEndPoint* address) {
   SockaddrStorage storage;
@@ -5,6 +5,8 @@
 #ifndef NET_UDP_UDP_SOCKET_LIBEVENT_H_
 #define NET_UDP_UDP_SOCKET_LIBEVENT_H_
 
+#include <vector>
+
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/message_loop/message_loop.h"
@@ -56,6 +58,16 @@ class NET_EXPORT UDPSocketLibevent : public base::NonThreadSafe {
   // has been connected.
   int Read(IOBuffer* buf, int buf_len, const CompletionCallback& callback);
 
+  // Read several datagrams from the socket in one go, as described by
+  // DatagramClientSocket::ReadMultiple(). Uses recvmmsg() where available.
+  // Only usable from the client-side of a UDP socket, after the socket
+  // has been connected.
+  int ReadMultiple(IOBuffer* buf,
+                   int packet_len,
+                   int max_packets,
+                   std::vector<int>* packet_sizes,
+                   const CompletionCallback& callback);
+
   // Write to the socket.
   // Only usable from the client-side of a UDP socket, after the socket
   // has been connected.
@@ -231,6 +243,10 @@ class NET_EXPORT UDPSocketLibevent : public base::NonThreadSafe {
 
   int InternalConnect(const IPEndPoint& address);
   int InternalRecvFrom(IOBuffer* buf, int buf_len, IPEndPoint* address);
+  int InternalRecvMultiple(IOBuffer* buf,
+                           int packet_len,
+                           int max_packets,
+                           std::vector<int>* packet_sizes);
   int InternalSendTo(IOBuffer* buf, int buf_len, const IPEndPoint* address);
 
   // Applies |socket_options_| to |socket_|. Should be called before
@@ -278,6 +294,13 @@ class NET_EXPORT UDPSocketLibevent : public base::NonThreadSafe {
   scoped_refptr<IOBuffer> read_buf_;
   int read_buf_len_;
   IPEndPoint* recv_from_address_;
+  // Set while a ReadMultiple() is pending, in which case |read_buf_len_| is
+  // the size of each datagram.
+  int read_max_packets_;
+  std::vector<int>* read_packet_sizes_;
+  // Where recvmmsg() is not available, an error hit by ReadMultiple() after
+  // reading some datagrams, to be returned by the next read.
+  int pending_read_error_;
 
   // The buffer used by InternalWrite() to retry Write requests
   scoped_refptr<IOBuffer> write_buf_;
@@ -425,6 +425,68 @@ TEST_F(UDPSocketTest, VerifyConnectBindsAddr) {
   DCHECK(simple_message == str);
 }
 
+// Datagrams received by a client socket while no read was pending should be
+// returned together by ReadMultiple(), each in its own slot of the buffer.
+TEST_F(UDPSocketTest, ReadMultiple) {
+  const int kPort = 9999;
+  const int kMaxPackets = 8;
+  const char* const kMessages[] = { "first", "second message", "third" };
+
+  // Setup the server to listen.
+  IPEndPoint bind_address;
+  CreateUDPAddress("127.0.0.1", kPort, &bind_address);
+  UDPServerSocket server(NULL, NetLog::Source());
+  server.AllowAddressReuse();
+  int rv = server.Listen(bind_address);
+  ASSERT_EQ(OK, rv);
+
+  // Setup the client.
+  IPEndPoint server_address;
+  CreateUDPAddress("127.0.0.1", kPort, &server_address);
+  UDPClientSocket client(DatagramSocket::DEFAULT_BIND,
+                         RandIntCallback(),
+                         NULL,
+                         NetLog::Source());
+  rv = client.Connect(server_address);
+  EXPECT_EQ(OK, rv);
+
+  // Client sends to the server so it learns the client's address.
+  std::string simple_message("hello world!");
+  rv = WriteSocket(&client, simple_message);
+  EXPECT_EQ(simple_message.length(), static_cast<size_t>(rv));
+  std::string str = RecvFromSocket(&server);
+  DCHECK(simple_message == str);
+
+  for (size_t i = 0; i < arraysize(kMessages); ++i) {
+    rv = SendToSocket(&server, kMessages[i]);
+    EXPECT_EQ(strlen(kMessages[i]), static_cast<size_t>(rv));
+  }
+
+  // Read until all the messages are in, in case they are not all
+  // available at once.
+  scoped_refptr<IOBufferWithSize> buffer(
+      new IOBufferWithSize(kMaxRead * kMaxPackets));
+  std::vector<std::string> received;
+  while (received.size() < arraysize(kMessages)) {
+    TestCompletionCallback callback;
+    std::vector<int> packet_sizes;
+    rv = client.ReadMultiple(buffer.get(), kMaxRead, kMaxPackets,
+                             &packet_sizes, callback.callback());
+    if (rv == ERR_IO_PENDING)
+      rv = callback.WaitForResult();
+    ASSERT_GT(rv, 0);
+    ASSERT_EQ(static_cast<size_t>(rv), packet_sizes.size());
+    for (int j = 0; j < rv; ++j) {
+      received.push_back(
+          std::string(buffer->data() + j * kMaxRead, packet_sizes[j]));
+    }
+  }
+
+  ASSERT_EQ(arraysize(kMessages), received.size());
+  for (size_t i = 0; i < arraysize(kMessages); ++i)
+    EXPECT_EQ(kMessages[i], received[i]);
+}
+
 TEST_F(UDPSocketTest, ClientGetLocalPeerAddresses) {
   struct TestData {
     std::string remote_address;
@@ -0,0 +1,675 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// End-to-end benchmarks of the network stack. URLRequests go through
+// HttpNetworkTransaction, the socket pools and HTTP/1.1, SPDY or QUIC to a
+// server in this process, listening on the loopback interface. Like the QUIC
+// server in net/tools/quic, this only builds on Linux.
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/bind.h"
+#include "base/compiler_specific.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/message_loop/message_loop.h"
+#include "base/process/process_handle.h"
+#include "base/process/process_metrics.h"
+#include "base/run_loop.h"
+#include "base/stl_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/thread.h"
+#include "base/time/time.h"
+#include "net/base/host_port_pair.h"
+#include "net/base/io_buffer.h"
+#include "net/base/ip_endpoint.h"
+#include "net/base/net_errors.h"
+#include "net/base/net_util.h"
+#include "net/http/http_network_layer.h"
+#include "net/http/http_network_session.h"
+#include "net/http/http_stream_factory.h"
+#include "net/quic/quic_config.h"
+#include "net/quic/quic_protocol.h"
+#include "net/quic/quic_time.h"
+#include "net/server/http_server.h"
+#include "net/server/http_server_request_info.h"
+#include "net/socket/next_proto.h"
+#include "net/socket/stream_listen_socket.h"
+#include "net/socket/tcp_listen_socket.h"
+#include "net/spdy/buffered_spdy_framer.h"
+#include "net/spdy/spdy_protocol.h"
+#include "net/tools/quic/quic_dispatcher.h"
+#include "net/tools/quic/quic_in_memory_cache.h"
+#include "net/tools/quic/test_tools/packet_dropping_test_writer.h"
+#include "net/tools/quic/test_tools/quic_dispatcher_peer.h"
+#include "net/tools/quic/test_tools/quic_in_memory_cache_peer.h"
+#include "net/tools/quic/test_tools/quic_server_peer.h"
+#include "net/tools/quic/test_tools/server_thread.h"
+#include "net/url_request/url_request.h"
+#include "net/url_request/url_request_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "url/gurl.h"
+
+namespace net {
+
+namespace {
+
+using tools::QuicDispatcher;
+using tools::QuicInMemoryCache;
+using tools::test::PacketDroppingTestWriter;
+using tools::test::QuicDispatcherPeer;
+using tools::test::QuicInMemoryCachePeer;
+using tools::test::QuicServerPeer;
+using tools::test::ServerThread;
+
+const char kLoopbackAddress[] = "127.0.0.1";
+const char kPath[] = "/loopback";
+const int kReadBufferSize = 32 * 1024;
+
+enum Protocol {
+  PROTOCOL_HTTP,
+  PROTOCOL_SPDY,
+  PROTOCOL_QUIC,
+};
+
+const char* const kProtocolNames[] = { "http", "spdy", "quic" };
+
+struct LoopbackConfig {
+  const char* name;
+  // Requests sent in total, and at most in flight at once. HTTP/1.1 requests
+  // queue for the six connections per host the socket pools allow, as they
+  // would in the browser.
+  int num_requests;
+  int max_in_flight;
+  // Size of every response body. Responses fit in the initial SPDY/3 stream
+  // window, so the SPDY server does not need to do flow control.
+  size_t response_size;
+  // Delay the server adds to every response (HTTP/1.1 and SPDY) or to every
+  // packet it sends (QUIC).
+  int latency_ms;
+  // Percentage of the server's packets that are dropped. QUIC only: loss on a
+  // loopback TCP connection cannot be simulated from userspace.
+  int loss_percent;
+};
+
+const LoopbackConfig kConfigs[] = {
+  { "small", 5000, 1000, 1024, 0, 0 },
+  { "medium", 2000, 200, 32 * 1024, 0, 0 },
+  { "latency", 2000, 1000, 1024, 20, 0 },
+  { "lossy", 1000, 100, 32 * 1024, 10, 2 },
+};
+
+GURL GetLoopbackURL(uint16 port) {
+  return GURL(base::StringPrintf("http://%s:%u%s", kLoopbackAddress,
+                                 static_cast<unsigned>(port), kPath));
+}
+
+// A server that answers every request with the same body. Lives on the IO
+// thread of a LoopbackServerThread.
+class LoopbackServer {
+ public:
+  virtual ~LoopbackServer() {}
+
+  // Starts listening on the loopback interface and returns the port.
+  virtual uint16 Listen() = 0;
+};
+
+// Runs a LoopbackServer on its own IO thread. StreamListenSocket spins until
+// the peer has read what it sends, so the servers cannot share the thread of
+// the URLRequests.
+class LoopbackServerThread {
+ public:
+  // Takes ownership of |server|, and returns once it is listening.
+  explicit LoopbackServerThread(LoopbackServer* server)
+      : thread_("LoopbackServer"),
+        server_(server),
+        port_(0) {
+    CHECK(thread_.StartWithOptions(
+        base::Thread::Options(base::MessageLoop::TYPE_IO, 0)));
+    base::WaitableEvent listening(false, false);
+    thread_.message_loop()->PostTask(
+        FROM_HERE,
+        base::Bind(&LoopbackServerThread::ListenOnThread,
+                   base::Unretained(this), &listening));
+    listening.Wait();
+  }
+
+  ~LoopbackServerThread() {
+    thread_.message_loop()->DeleteSoon(FROM_HERE, server_.release());
+    thread_.Stop();
+  }
+
+  uint16 port() const { return port_; }
+
+ private:
+  void ListenOnThread(base::WaitableEvent* listening) {
+    port_ = server_->Listen();
+    listening->Signal();
+  }
+
+  base::Thread thread_;
+  scoped_ptr<LoopbackServer> server_;
+  uint16 port_;
+
+  DISALLOW_COPY_AND_ASSIGN(LoopbackServerThread);
+};
+
+// Serves HTTP/1.1 with net::HttpServer.
+class HttpLoopbackServer : public LoopbackServer,
+                           public HttpServer::Delegate {
+ public:
+  HttpLoopbackServer(const std::string& body, base::TimeDelta latency)
+      : body_(body),
+        latency_(latency),
+        weak_factory_(this) {
+  }
+
+  virtual uint16 Listen() OVERRIDE {
+    TCPListenSocketFactory socket_factory(kLoopbackAddress, 0);
+    server_ = new HttpServer(socket_factory, this);
+    IPEndPoint address;
+    CHECK_EQ(OK, server_->GetLocalAddress(&address));
+    return address.port();
+  }
+
+  // HttpServer::Delegate implementation.
+  virtual void OnHttpRequest(int connection_id,
+                             const HttpServerRequestInfo& info) OVERRIDE {
+    base::MessageLoop::current()->PostDelayedTask(
+        FROM_HERE,
+        base::Bind(&HttpLoopbackServer::Respond, weak_factory_.GetWeakPtr(),
+                   connection_id),
+        latency_);
+  }
+
+  virtual void OnWebSocketRequest(int connection_id,
+                                  const HttpServerRequestInfo& info) OVERRIDE {
+    NOTREACHED();
+  }
+
+  virtual void OnWebSocketMessage(int connection_id,
+                                  const std::string& data) OVERRIDE {
+    NOTREACHED();
+  }
+
+  virtual void OnClose(int connection_id) OVERRIDE {}
+
+ private:
+  void Respond(int connection_id) {
+    server_->Send200(connection_id, body_, "text/plain");
+  }
+
+  const std::string body_;
+  const base::TimeDelta latency_;
+  scoped_refptr<HttpServer> server_;
+  base::WeakPtrFactory<HttpLoopbackServer> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(HttpLoopbackServer);
+};
+
+// One connection of SpdyLoopbackServer. Speaks just enough SPDY/3 to answer
+// SYN_STREAMs and PINGs.
+class SpdyLoopbackConnection : public BufferedSpdyFramerVisitorInterface {
+ public:
+  SpdyLoopbackConnection(scoped_ptr<StreamListenSocket> socket,
+                         const std::string& body,
+                         base::TimeDelta latency)
+      : socket_(socket.Pass()),
+        framer_(SPDY3, true),
+        body_(body),
+        latency_(latency),
+        weak_factory_(this) {
+    framer_.set_visitor(this);
+  }
+
+  virtual ~SpdyLoopbackConnection() {}
+
+  void OnRead(const char* data, int len) {
+    framer_.ProcessInput(data, len);
+  }
+
+  // BufferedSpdyFramerVisitorInterface implementation.
+  virtual void OnError(SpdyFramer::SpdyError error_code) OVERRIDE {
+    LOG(ERROR) << "SPDY error: " << SpdyFramer::ErrorCodeToString(error_code);
+  }
+
+  virtual void OnStreamError(SpdyStreamId stream_id,
+                             const std::string& description) OVERRIDE {
+    LOG(ERROR) << "SPDY stream error: " << description;
+  }
+
+  virtual void OnSynStream(SpdyStreamId stream_id,
+                           SpdyStreamId associated_stream_id,
+                           SpdyPriority priority,
+                           bool fin,
+                           bool unidirectional,
+                           const SpdyHeaderBlock& headers) OVERRIDE {
+    base::MessageLoop::current()->PostDelayedTask(
+        FROM_HERE,
+        base::Bind(&SpdyLoopbackConnection::Respond,
+                   weak_factory_.GetWeakPtr(), stream_id),
+        latency_);
+  }
+
+  virtual void OnSynReply(SpdyStreamId stream_id,
+                          bool fin,
+                          const SpdyHeaderBlock& headers) OVERRIDE {}
+  virtual void OnHeaders(SpdyStreamId stream_id,
+                         bool fin,
+                         const SpdyHeaderBlock& headers) OVERRIDE {}
+  virtual void OnDataFrameHeader(SpdyStreamId stream_id,
+                                 size_t length,
+                                 bool fin) OVERRIDE {}
+  virtual void OnStreamFrameData(SpdyStreamId stream_id,
+                                 const char* data,
+                                 size_t len,
+                                 bool fin) OVERRIDE {}
+  virtual void OnSettings(bool clear_persisted) OVERRIDE {}
+  virtual void OnSetting(SpdySettingsIds id,
+                         uint8 flags,
+                         uint32 value) OVERRIDE {}
+
+  virtual void OnPing(SpdyPingId unique_id, bool is_ack) OVERRIDE {
+    if (is_ack)
+      return;
+    scoped_ptr<SpdyFrame> frame(
+        framer_.CreatePingFrame(static_cast<uint32>(unique_id), true));
+    Send(*frame);
+  }
+
+  virtual void OnRstStream(SpdyStreamId stream_id,
+                           SpdyRstStreamStatus status) OVERRIDE {}
+  virtual void OnGoAway(SpdyStreamId last_accepted_stream_id,
+                        SpdyGoAwayStatus status) OVERRIDE {}
+  virtual void OnWindowUpdate(SpdyStreamId stream_id,
+                              uint32 delta_window_size) OVERRIDE {}
+  virtual void OnPushPromise(SpdyStreamId stream_id,
+                             SpdyStreamId promised_stream_id) OVERRIDE {}
+
+ private:
+  void Respond(SpdyStreamId stream_id) {
+    SpdyHeaderBlock headers;
+    headers[":status"] = "200";
+    headers[":version"] = "HTTP/1.1";
+    headers["content-type"] = "text/plain";
+    headers["content-length"] = base::Uint64ToString(body_.size());
+    scoped_ptr<SpdyFrame> reply(
+        framer_.CreateSynReply(stream_id, CONTROL_FLAG_NONE, &headers));
+    Send(*reply);
+    scoped_ptr<SpdyFrame> data(framer_.CreateDataFrame(
+        stream_id, body_.data(), body_.size(), DATA_FLAG_FIN));
+    Send(*data);
+  }
+
+  void Send(const SpdyFrame& frame) {
+    socket_->Send(frame.data(), frame.size());
+  }
+
+  scoped_ptr<StreamListenSocket> socket_;
+  BufferedSpdyFramer framer_;
+  const std::string body_;
+  const base::TimeDelta latency_;
+  base::WeakPtrFactory<SpdyLoopbackConnection> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(SpdyLoopbackConnection);
+};
+
+// Serves SPDY/3 over plain TCP, as HttpStreamFactory::force_spdy_always()
+// makes the client speak it.
+class SpdyLoopbackServer : public LoopbackServer,
+                           public StreamListenSocket::Delegate {
+ public:
+  SpdyLoopbackServer(const std::string& body, base::TimeDelta latency)
+      : body_(body),
+        latency_(latency) {
+  }
+
+  virtual ~SpdyLoopbackServer() {
+    STLDeleteValues(&connections_);
+  }
+
+  virtual uint16 Listen() OVERRIDE {
+    TCPListenSocketFactory socket_factory(kLoopbackAddress, 0);
+    server_ = socket_factory.CreateAndListen(this);
+    IPEndPoint address;
+    CHECK_EQ(OK, server_->GetLocalAddress(&address));
+    return address.port();
+  }
+
+  // StreamListenSocket::Delegate implementation.
+  virtual void DidAccept(StreamListenSocket* server,
+                         scoped_ptr<StreamListenSocket> socket) OVERRIDE {
+    StreamListenSocket* key = socket.get();
+    connections_[key] =
+        new SpdyLoopbackConnection(socket.Pass(), body_, latency_);
+  }
+
+  virtual void DidRead(StreamListenSocket* socket,
+                       const char* data,
+                       int len) OVERRIDE {
+    ConnectionMap::iterator it = connections_.find(socket);
+    DCHECK(it != connections_.end());
+    it->second->OnRead(data, len);
+  }
+
+  virtual void DidClose(StreamListenSocket* socket) OVERRIDE {
+    ConnectionMap::iterator it = connections_.find(socket);
+    DCHECK(it != connections_.end());
+    // The socket is still on the stack, so it cannot be deleted yet.
+    base::MessageLoop::current()->DeleteSoon(FROM_HERE, it->second);
+    connections_.erase(it);
+  }
+
+ private:
+  typedef std::map<StreamListenSocket*, SpdyLoopbackConnection*>
+      ConnectionMap;
+
+  const std::string body_;
+  const base::TimeDelta latency_;
+  scoped_ptr<StreamListenSocket> server_;
+  ConnectionMap connections_;
+
+  DISALLOW_COPY_AND_ASSIGN(SpdyLoopbackServer);
+};
+
+class ServerWriterDelegate : public PacketDroppingTestWriter::Delegate {
+ public:
+  explicit ServerWriterDelegate(QuicDispatcher* dispatcher)
+      : dispatcher_(dispatcher) {}
+  virtual ~ServerWriterDelegate() {}
+  virtual void OnCanWrite() OVERRIDE { dispatcher_->OnCanWrite(); }
+
+ private:
+  QuicDispatcher* dispatcher_;
+
+  DISALLOW_COPY_AND_ASSIGN(ServerWriterDelegate);
+};
+
+// Serves QUIC with the QuicServer from net/tools/quic, on its own thread. The
+// responses come from QuicInMemoryCache; latency and loss are applied to the
+// server's packets by a PacketDroppingTestWriter.
+class QuicLoopbackServer {
+ public:
+  QuicLoopbackServer(const std::string& body,
+                     base::TimeDelta latency,
+                     int loss_percent) {
+    IPAddressNumber ip;
+    CHECK(ParseIPLiteralToNumber(kLoopbackAddress, &ip));
+    QuicConfig config;
+    config.SetDefaults();
+    thread_.reset(new ServerThread(IPEndPoint(ip, 0), config,
+                                   QuicSupportedVersions(), true));
+    thread_->Initialize();
+
+    QuicInMemoryCachePeer::ResetForTests();
+    QuicInMemoryCache::GetInstance()->AddSimpleResponse(
+        "GET", GetLoopbackURL(port()).spec(), "HTTP/1.1", "200", "OK", body);
+
+    QuicDispatcher* dispatcher =
+        QuicServerPeer::GetDispatcher(thread_->server());
+    // Owned by |dispatcher|.
+    PacketDroppingTestWriter* writer = new PacketDroppingTestWriter();
+    QuicDispatcherPeer::UseWriter(dispatcher, writer);
+    writer->Initialize(QuicDispatcherPeer::GetHelper(dispatcher),
+                       new ServerWriterDelegate(dispatcher));
+    writer->set_fake_packet_delay(
+        QuicTime::Delta::FromMicroseconds(latency.InMicroseconds()));
+    writer->set_fake_packet_loss_percentage(loss_percent);
+    thread_->Start();
+  }
+
+  ~QuicLoopbackServer() {
+    thread_->Quit();
+    thread_->Join();
+    QuicInMemoryCachePeer::ResetForTests();
+  }
+
+  uint16 port() { return static_cast<uint16>(thread_->GetPort()); }
+
+ private:
+  scoped_ptr<ServerThread> thread_;
+
+  DISALLOW_COPY_AND_ASSIGN(QuicLoopbackServer);
+};
+
+// A URLRequestContext without an HTTP cache, so that every request goes to
+// the server on |port| over |protocol|.
+class LoopbackURLRequestContext : public TestURLRequestContext {
+ public:
+  LoopbackURLRequestContext(Protocol protocol, uint16 port)
+      : TestURLRequestContext(true) {
+    Init();
+    HttpNetworkSession::Params params;
+    params.host_resolver = host_resolver();
+    params.cert_verifier = cert_verifier();
+    params.transport_security_state = transport_security_state();
+    params.proxy_service = proxy_service();
+    params.ssl_config_service = ssl_config_service();
+    params.http_auth_handler_factory = http_auth_handler_factory();
+    params.network_delegate = network_delegate();
+    params.http_server_properties = http_server_properties();
+    params.net_log = net_log();
+    if (protocol == PROTOCOL_SPDY) {
+      params.spdy_default_protocol = kProtoSPDY3;
+      params.enable_spdy_ping_based_connection_checking = false;
+    } else if (protocol == PROTOCOL_QUIC) {
+      params.enable_quic = true;
+      params.origin_to_force_quic_on = HostPortPair(kLoopbackAddress, port);
+    }
+    context_storage_.set_http_transaction_factory(
+        new HttpNetworkLayer(new HttpNetworkSession(params)));
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(LoopbackURLRequestContext);
+};
+
+// Keeps up to |max_in_flight| requests for |url| going until |num_requests|
+// have completed, and records how long each of them took.
+class LoadGenerator : public URLRequest::Delegate {
+ public:
+  LoadGenerator(URLRequestContext* context, const GURL& url)
+      : context_(context),
+        url_(url),
+        num_requests_(0),
+        num_started_(0),
+        num_failures_(0),
+        bytes_received_(0),
+        buffer_(new IOBuffer(kReadBufferSize)) {
+  }
+
+  virtual ~LoadGenerator() {
+    DCHECK(in_flight_.empty());
+  }
+
+  // Returns once all the requests have completed.
+  void Run(int num_requests, int max_in_flight) {
+    num_requests_ = num_requests;
+    base::RunLoop run_loop;
+    quit_closure_ = run_loop.QuitClosure();
+    for (int i = 0; i < max_in_flight && num_started_ < num_requests_; ++i)
+      StartRequest();
+    run_loop.Run();
+  }
+
+  const std::vector<base::TimeDelta>& latencies() const { return latencies_; }
+  int num_failures() const { return num_failures_; }
+  int64 bytes_received() const { return bytes_received_; }
+
+  // URLRequest::Delegate implementation.
+  virtual void OnResponseStarted(URLRequest* request) OVERRIDE {
+    if (!request->status().is_success() ||
+        request->GetResponseCode() != 200) {
+      OnRequestDone(request, false);
+      return;
+    }
+    ReadBody(request);
+  }
+
+  virtual void OnReadCompleted(URLRequest* request, int bytes_read) OVERRIDE {
+    if (bytes_read <= 0) {
+      OnRequestDone(request, request->status().is_success());
+      return;
+    }
+    bytes_received_ += bytes_read;
+    ReadBody(request);
+  }
+
+ private:
+  void StartRequest() {
+    ++num_started_;
+    URLRequest* request = new URLRequest(url_, DEFAULT_PRIORITY, this,
+                                         context_);
+    in_flight_[request] = base::TimeTicks::Now();
+    request->Start();
+  }
+
+  void ReadBody(URLRequest* request) {
+    // The bodies are thrown away, so all the requests share one buffer.
+    int bytes_read = 0;
+    while (request->Read(buffer_.get(), kReadBufferSize, &bytes_read)) {
+      if (bytes_read == 0) {
+        OnRequestDone(request, true);
+        return;
+      }
+      bytes_received_ += bytes_read;
+    }
+    if (!request->status().is_io_pending())
+      OnRequestDone(request, false);
+  }
+
+  void OnRequestDone(URLRequest* request, bool success) {
+    std::map<URLRequest*, base::TimeTicks>::iterator it =
+        in_flight_.find(request);
+    DCHECK(it != in_flight_.end());
+    latencies_.push_back(base::TimeTicks::Now() - it->second);
+    if (!success)
+      ++num_failures_;
+    in_flight_.erase(it);
+    delete request;
+
+    if (num_started_ < num_requests_)
+      StartRequest();
+    else if (in_flight_.empty())
+      quit_closure_.Run();
+  }
+
+  URLRequestContext* context_;
+  const GURL url_;
+  int num_requests_;
+  int num_started_;
+  int num_failures_;
+  int64 bytes_received_;
+  scoped_refptr<IOBuffer> buffer_;
+  // Owns the requests, and maps them to their start times.
+  std::map<URLRequest*, base::TimeTicks> in_flight_;
+  std::vector<base::TimeDelta> latencies_;
+  base::Closure quit_closure_;
+
+  DISALLOW_COPY_AND_ASSIGN(LoadGenerator);
+};
+
+class URLRequestLoopbackPerfTest : public testing::Test {
+ protected:
+  virtual void TearDown() OVERRIDE {
+    HttpStreamFactory::ResetStaticSettingsToInit();
+  }
+
+  // Sends the requests of |config| to the server on |port| and prints the
+  // requests per second, the median and 99th percentile latencies and the
+  // CPU time per byte of response body. The CPU time is that of the whole
+  // process, so it includes the server.
+  void RunRequests(Protocol protocol,
+                   const LoopbackConfig& config,
+                   uint16 port) {
+    LoopbackURLRequestContext context(protocol, port);
+    LoadGenerator generator(&context, GetLoopbackURL(port));
+    scoped_ptr<base::ProcessMetrics> metrics(
+        base::ProcessMetrics::CreateProcessMetrics(
+            base::GetCurrentProcessHandle()));
+    metrics->GetPlatformIndependentCPUUsage();
+    base::TimeTicks start = base::TimeTicks::Now();
+    generator.Run(config.num_requests, config.max_in_flight);
+    base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+    double cpu_seconds =
+        metrics->GetPlatformIndependentCPUUsage() / 100 * elapsed.InSecondsF();
+
+    EXPECT_EQ(0, generator.num_failures());
+    EXPECT_EQ(static_cast<int64>(config.num_requests * config.response_size),
+              generator.bytes_received());
+
+    std::vector<base::TimeDelta> latencies = generator.latencies();
+    std::sort(latencies.begin(), latencies.end());
+    const std::string modifier = std::string("_") + kProtocolNames[protocol];
+    perf_test::PrintResult("requests", modifier, config.name,
+                           config.num_requests / elapsed.InSecondsF(),
+                           "requests/s", true);
+    perf_test::PrintResult("latency_p50", modifier, config.name,
+                           latencies[latencies.size() / 2].InMillisecondsF(),
+                           "ms", true);
+    perf_test::PrintResult(
+        "latency_p99", modifier, config.name,
+        latencies[latencies.size() * 99 / 100].InMillisecondsF(), "ms", true);
+    perf_test::PrintResult(
+        "cpu_per_byte", modifier, config.name,
+        cpu_seconds * base::Time::kNanosecondsPerSecond /
+            std::max<int64>(generator.bytes_received(), 1),
+        "ns/byte", true);
+  }
+
+  static std::string GetBody(const LoopbackConfig& config) {
+    return std::string(config.response_size, 'x');
+  }
+
+  static base::TimeDelta GetLatency(const LoopbackConfig& config) {
+    return base::TimeDelta::FromMilliseconds(config.latency_ms);
+  }
+
+  base::MessageLoopForIO message_loop_;
+};
+
+}  // namespace
+
+TEST_F(URLRequestLoopbackPerfTest, Http) {
+  for (size_t i = 0; i < arraysize(kConfigs); ++i) {
+    const LoopbackConfig& config = kConfigs[i];
+    if (config.loss_percent)
+      continue;
+    LoopbackServerThread server(
+        new HttpLoopbackServer(GetBody(config), GetLatency(config)));
+    RunRequests(PROTOCOL_HTTP, config, server.port());
+  }
+}
+
+TEST_F(URLRequestLoopbackPerfTest, Spdy) {
+  HttpStreamFactory::set_force_spdy_over_ssl(false);
+  HttpStreamFactory::set_force_spdy_always(true);
+  for (size_t i = 0; i < arraysize(kConfigs); ++i) {
+    const LoopbackConfig& config = kConfigs[i];
+    if (config.loss_percent)
+      continue;
+    LoopbackServerThread server(
+        new SpdyLoopbackServer(GetBody(config), GetLatency(config)));
+    RunRequests(PROTOCOL_SPDY, config, server.port());
+  }
+}
+
+TEST_F(URLRequestLoopbackPerfTest, Quic) {
+  for (size_t i = 0; i < arraysize(kConfigs); ++i) {
+    const LoopbackConfig& config = kConfigs[i];
+    QuicLoopbackServer server(GetBody(config), GetLatency(config),
+                              config.loss_percent);
+    RunRequests(PROTOCOL_QUIC, config, server.port());
+  }
+}
+
+}  // namespace net
@@ -4,20 +4,81 @@
 
 #include "net/websockets/websocket_deflate_predictor_impl.h"
 
+#include <algorithm>
+
+#include "net/websockets/websocket_frame.h"
+
 namespace net {
 
 typedef WebSocketDeflatePredictor::Result Result;
 
+const uint64 WebSocketDeflatePredictorImpl::kMinimumMessageSizeToDeflate;
+const int WebSocketDeflatePredictorImpl::kIneffectiveCompressionPercent;
+const int WebSocketDeflatePredictorImpl::kProbeInterval;
+
+WebSocketDeflatePredictorImpl::WebSocketDeflatePredictorImpl()
+    : compressed_percent_(0),
+      messages_since_deflate_(0),
+      input_bytes_(0),
+      written_bytes_(0),
+      is_writing_message_(false),
+      is_writing_compressed_message_(false) {}
+
 Result WebSocketDeflatePredictorImpl::Predict(
     const ScopedVector<WebSocketFrame>& frames,
     size_t frame_index) {
+  // Sum up the message if all of its frames are already available.
+  uint64 message_size = 0;
+  bool is_whole_message_visible = false;
+  for (size_t i = frame_index; i < frames.size(); ++i) {
+    const WebSocketFrame* frame = frames[i];
+    if (!WebSocketFrameHeader::IsKnownDataOpCode(frame->header.opcode))
+      continue;
+    message_size += frame->header.payload_length;
+    if (frame->header.final) {
+      is_whole_message_visible = true;
+      break;
+    }
+  }
+  if (is_whole_message_visible &&
+      message_size < kMinimumMessageSizeToDeflate) {
+    return DO_NOT_DEFLATE;
+  }
+
+  if (compressed_percent_ >= kIneffectiveCompressionPercent &&
+      ++messages_since_deflate_ < kProbeInterval) {
+    return DO_NOT_DEFLATE;
+  }
+  messages_since_deflate_ = 0;
   return DEFLATE;
 }
 
 void WebSocketDeflatePredictorImpl::RecordInputDataFrame(
-    const WebSocketFrame* frame) {}
+    const WebSocketFrame* frame) {
+  input_bytes_ += frame->header.payload_length;
+}
 
 void WebSocketDeflatePredictorImpl::RecordWrittenDataFrame(
-    const WebSocketFrame* frame) {}
+    const WebSocketFrame* frame) {
+  if (!is_writing_message_) {
+    is_writing_message_ = true;
+    is_writing_compressed_message_ = frame->header.reserved1;
+  }
+  written_bytes_ += frame->header.payload_length;
+  if (!frame->header.final)
+    return;
+
+  // By the time the final frame of a message is written, all of its input
+  // frames have been recorded and none of the next message's have.
+  if (is_writing_compressed_message_ && input_bytes_ > 0) {
+    int percent = static_cast<int>(
+        std::min<uint64>(written_bytes_ * 100 / input_bytes_, 100));
+    compressed_percent_ = (compressed_percent_ + percent) / 2;
+  }
+  input_bytes_ = 0;
+  written_bytes_ = 0;
+  is_writing_message_ = false;
+  is_writing_compressed_message_ = false;
+}
 
 }  // namespace net
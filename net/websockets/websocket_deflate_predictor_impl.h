@@ -15,15 +15,46 @@ namespace net {
 
 struct WebSocketFrame;
 
+// WebSocketDeflatePredictorImpl skips compressing messages that are too
+// small to benefit from it, and stops compressing altogether while recent
+// messages turn out to be incompressible, compressing one message every
+// |kProbeInterval| messages to notice when the data becomes compressible
+// again. It never returns TRY_DEFLATE, so it can be used with either context
+// take over mode.
 class NET_EXPORT_PRIVATE WebSocketDeflatePredictorImpl
     : public WebSocketDeflatePredictor {
  public:
+  // Messages known to be smaller than this are sent uncompressed.
+  static const uint64 kMinimumMessageSizeToDeflate = 8;
+  // Compression is considered ineffective when compressed messages are on
+  // average at least this many percent of their original size.
+  static const int kIneffectiveCompressionPercent = 95;
+  // While compression is ineffective, every |kProbeInterval|-th message is
+  // still compressed.
+  static const int kProbeInterval = 16;
+
+  WebSocketDeflatePredictorImpl();
   virtual ~WebSocketDeflatePredictorImpl() {}
 
   virtual Result Predict(const ScopedVector<WebSocketFrame>& frames,
                          size_t frame_index) OVERRIDE;
   virtual void RecordInputDataFrame(const WebSocketFrame* frame) OVERRIDE;
   virtual void RecordWrittenDataFrame(const WebSocketFrame* frame) OVERRIDE;
+
+ private:
+  // Moving average of compressed size / original size of compressed
+  // messages, in percent.
+  int compressed_percent_;
+  // The number of messages predicted since the last one predicted DEFLATE.
+  int messages_since_deflate_;
+
+  // Accounting for the message currently being written.
+  uint64 input_bytes_;
+  uint64 written_bytes_;
+  bool is_writing_message_;
+  bool is_writing_compressed_message_;
+
+  DISALLOW_COPY_AND_ASSIGN(WebSocketDeflatePredictorImpl);
 };
 
 }  // namespace net
@@ -5,7 +5,9 @@
 #include "net/websockets/websocket_deflate_predictor_impl.h"
 
 #include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/memory/scoped_vector.h"
+#include "net/base/io_buffer.h"
 #include "net/websockets/websocket_frame.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -24,6 +26,86 @@ TEST(WebSocketDeflatePredictorImpl, Predict) {
   EXPECT_EQ(WebSocketDeflatePredictor::DEFLATE, result);
 }
 
+// Creates a data frame with a |size| byte payload.
+WebSocketFrame* CreateDataFrame(WebSocketFrameHeader::OpCode opcode,
+                                bool final,
+                                bool compressed,
+                                size_t size) {
+  WebSocketFrame* frame = new WebSocketFrame(opcode);
+  frame->header.final = final;
+  frame->header.reserved1 = compressed;
+  frame->header.payload_length = size;
+  frame->data = new IOBufferWithSize(size);
+  return frame;
+}
+
+TEST(WebSocketDeflatePredictorImpl, PredictSmallMessage) {
+  WebSocketDeflatePredictorImpl predictor;
+  ScopedVector<WebSocketFrame> frames;
+  frames.push_back(CreateDataFrame(WebSocketFrameHeader::kOpCodeText,
+                                   false, false, 3));
+  frames.push_back(new WebSocketFrame(WebSocketFrameHeader::kOpCodePing));
+  frames.push_back(CreateDataFrame(WebSocketFrameHeader::kOpCodeContinuation,
+                                   true, false, 4));
+
+  EXPECT_EQ(WebSocketDeflatePredictor::DO_NOT_DEFLATE,
+            predictor.Predict(frames, 0));
+}
+
+TEST(WebSocketDeflatePredictorImpl, PredictLargeMessage) {
+  WebSocketDeflatePredictorImpl predictor;
+  ScopedVector<WebSocketFrame> frames;
+  frames.push_back(CreateDataFrame(WebSocketFrameHeader::kOpCodeText,
+                                   true, false, 1000));
+
+  EXPECT_EQ(WebSocketDeflatePredictor::DEFLATE, predictor.Predict(frames, 0));
+}
+
+TEST(WebSocketDeflatePredictorImpl, PredictPartiallyVisibleMessage) {
+  WebSocketDeflatePredictorImpl predictor;
+  ScopedVector<WebSocketFrame> frames;
+  // Only the beginning of the message is visible, so its size is unknown.
+  frames.push_back(CreateDataFrame(WebSocketFrameHeader::kOpCodeText,
+                                   false, false, 1));
+
+  EXPECT_EQ(WebSocketDeflatePredictor::DEFLATE, predictor.Predict(frames, 0));
+}
+
+TEST(WebSocketDeflatePredictorImpl, StopAndProbeWhenIncompressible) {
+  WebSocketDeflatePredictorImpl predictor;
+  ScopedVector<WebSocketFrame> frames;
+  frames.push_back(CreateDataFrame(WebSocketFrameHeader::kOpCodeBinary,
+                                   true, false, 1000));
+
+  // Compressed messages which do not get any smaller.
+  int num_deflated = 0;
+  while (predictor.Predict(frames, 0) == WebSocketDeflatePredictor::DEFLATE) {
+    ASSERT_GT(10, ++num_deflated);
+    scoped_ptr<WebSocketFrame> written(CreateDataFrame(
+        WebSocketFrameHeader::kOpCodeBinary, true, true, 1000));
+    predictor.RecordInputDataFrame(frames[0]);
+    predictor.RecordWrittenDataFrame(written.get());
+  }
+
+  // The loop above already made the first DO_NOT_DEFLATE prediction.
+  for (int i = 2; i < WebSocketDeflatePredictorImpl::kProbeInterval; ++i) {
+    predictor.RecordInputDataFrame(frames[0]);
+    predictor.RecordWrittenDataFrame(frames[0]);
+    EXPECT_EQ(WebSocketDeflatePredictor::DO_NOT_DEFLATE,
+              predictor.Predict(frames, 0)) << i;
+  }
+  predictor.RecordInputDataFrame(frames[0]);
+  predictor.RecordWrittenDataFrame(frames[0]);
+  EXPECT_EQ(WebSocketDeflatePredictor::DEFLATE, predictor.Predict(frames, 0));
+
+  // The probe finds the data compressible again.
+  scoped_ptr<WebSocketFrame> written(CreateDataFrame(
+      WebSocketFrameHeader::kOpCodeBinary, true, true, 100));
+  predictor.RecordInputDataFrame(frames[0]);
+  predictor.RecordWrittenDataFrame(written.get());
+  EXPECT_EQ(WebSocketDeflatePredictor::DEFLATE, predictor.Predict(frames, 0));
+}
+
 }  // namespace
 
 }  // namespace net
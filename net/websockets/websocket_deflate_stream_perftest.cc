@@ -0,0 +1,170 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/rand_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/perf_log.h"
+#include "base/timer/elapsed_timer.h"
+#include "net/base/completion_callback.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/websockets/websocket_deflate_predictor.h"
+#include "net/websockets/websocket_deflate_predictor_impl.h"
+#include "net/websockets/websocket_deflate_stream.h"
+#include "net/websockets/websocket_deflater.h"
+#include "net/websockets/websocket_frame.h"
+#include "net/websockets/websocket_stream.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+const int kNumMessages = 20000;
+
+// Swallows written frames, counting their payload bytes.
+class NullWebSocketStream : public WebSocketStream {
+ public:
+  explicit NullWebSocketStream(uint64* bytes_written)
+      : bytes_written_(bytes_written) {}
+
+  virtual int ReadFrames(ScopedVector<WebSocketFrame>* frames,
+                         const CompletionCallback& callback) OVERRIDE {
+    return ERR_IO_PENDING;
+  }
+  virtual int WriteFrames(ScopedVector<WebSocketFrame>* frames,
+                          const CompletionCallback& callback) OVERRIDE {
+    for (size_t i = 0; i < frames->size(); ++i)
+      *bytes_written_ += (*frames)[i]->header.payload_length;
+    frames->clear();
+    return OK;
+  }
+  virtual void Close() OVERRIDE {}
+  virtual std::string GetSubProtocol() const OVERRIDE { return std::string(); }
+  virtual std::string GetExtensions() const OVERRIDE { return std::string(); }
+
+ private:
+  uint64* bytes_written_;
+};
+
+// The behaviour of WebSocketDeflatePredictorImpl before it made any
+// predictions, as a baseline.
+class AlwaysDeflatePredictor : public WebSocketDeflatePredictor {
+ public:
+  virtual Result Predict(const ScopedVector<WebSocketFrame>& frames,
+                         size_t frame_index) OVERRIDE {
+    return DEFLATE;
+  }
+  virtual void RecordInputDataFrame(const WebSocketFrame* frame) OVERRIDE {}
+  virtual void RecordWrittenDataFrame(const WebSocketFrame* frame) OVERRIDE {}
+};
+
+// A feed of small JSON updates, like a ticker.
+std::string MakeTick(int i) {
+  return base::StringPrintf("{\"s\":\"SYM%d\",\"p\":%d.%02d}",
+                            i % 50, 100 + i % 37, i % 100);
+}
+
+// Larger, repetitive JSON documents.
+std::string MakeDocument(int i) {
+  std::string document = "{\"items\":[";
+  for (int j = 0; j < 16; ++j) {
+    document += base::StringPrintf(
+        "{\"id\":%d,\"name\":\"item %d\",\"tags\":[\"a\",\"b\"]},", i + j, j);
+  }
+  document += "{}]}";
+  return document;
+}
+
+// Already compressed data, such as images.
+std::string MakeRandom(int i) {
+  return base::RandBytesAsString(1024 + i % 3072);
+}
+
+typedef std::string (*MessageGenerator)(int);
+
+void RunMix(const char* mix_name,
+            const MessageGenerator* generators,
+            size_t num_generators,
+            WebSocketFrameHeader::OpCode opcode) {
+  // Generate the messages up front so that only the stream is timed.
+  std::vector<scoped_refptr<IOBufferWithSize> > messages;
+  uint64 bytes_input = 0;
+  for (int i = 0; i < kNumMessages; ++i) {
+    std::string data = generators[i % num_generators](i);
+    messages.push_back(new IOBufferWithSize(data.size()));
+    memcpy(messages.back()->data(), data.data(), data.size());
+    bytes_input += data.size();
+  }
+
+  for (int predicting = 0; predicting < 2; ++predicting) {
+    uint64 bytes_written = 0;
+    scoped_ptr<WebSocketDeflatePredictor> predictor;
+    if (predicting)
+      predictor.reset(new WebSocketDeflatePredictorImpl);
+    else
+      predictor.reset(new AlwaysDeflatePredictor);
+    WebSocketDeflateStream stream(
+        scoped_ptr<WebSocketStream>(new NullWebSocketStream(&bytes_written)),
+        WebSocketDeflater::TAKE_OVER_CONTEXT,
+        15,
+        predictor.Pass());
+
+    base::ElapsedTimer timer;
+    for (int i = 0; i < kNumMessages; ++i) {
+      ScopedVector<WebSocketFrame> frames;
+      WebSocketFrame* frame = new WebSocketFrame(opcode);
+      frame->header.final = true;
+      frame->header.payload_length = messages[i]->size();
+      frame->data = messages[i];
+      frames.push_back(frame);
+      ASSERT_EQ(OK, stream.WriteFrames(&frames, CompletionCallback()));
+    }
+    double seconds = timer.Elapsed().InSecondsF();
+
+    std::string name = base::StringPrintf(
+        "WebSocketDeflateStream_%s_%s", mix_name,
+        predicting ? "Predicted" : "AlwaysDeflate");
+    base::LogPerfResult((name + "_Throughput").c_str(),
+                        bytes_input / seconds / (1024 * 1024), "MB/s");
+    base::LogPerfResult((name + "_Ratio").c_str(),
+                        100.0 * bytes_written / bytes_input, "%");
+  }
+}
+
+TEST(WebSocketDeflateStreamPerfTest, Ticks) {
+  const MessageGenerator kGenerators[] = { &MakeTick };
+  RunMix("Ticks", kGenerators, arraysize(kGenerators),
+         WebSocketFrameHeader::kOpCodeText);
+}
+
+TEST(WebSocketDeflateStreamPerfTest, Documents) {
+  const MessageGenerator kGenerators[] = { &MakeDocument };
+  RunMix("Documents", kGenerators, arraysize(kGenerators),
+         WebSocketFrameHeader::kOpCodeText);
+}
+
+TEST(WebSocketDeflateStreamPerfTest, Incompressible) {
+  const MessageGenerator kGenerators[] = { &MakeRandom };
+  RunMix("Incompressible", kGenerators, arraysize(kGenerators),
+         WebSocketFrameHeader::kOpCodeBinary);
+}
+
+TEST(WebSocketDeflateStreamPerfTest, Mixed) {
+  const MessageGenerator kGenerators[] = {
+    &MakeTick, &MakeTick, &MakeTick, &MakeDocument, &MakeRandom,
+  };
+  RunMix("Mixed", kGenerators, arraysize(kGenerators),
+         WebSocketFrameHeader::kOpCodeBinary);
+}
+
+}  // namespace
+
+}  // namespace net
@@ -6,7 +6,6 @@
 
 #include <string.h>
 #include <algorithm>
-#include <deque>
 #include <vector>
 
 #include "base/logging.h"
@@ -15,8 +14,16 @@
 
 namespace net {
 
+namespace {
+
+// The minimum amount of free space at the end of |buffer_| made available to
+// zlib for each call of deflate().
+const size_t kOutputChunkSize = 4096;
+
+}  // namespace
+
 WebSocketDeflater::WebSocketDeflater(ContextTakeOverMode mode)
-    : mode_(mode), are_bytes_added_(false) {}
+    : mode_(mode), output_size_(0), are_bytes_added_(false) {}
 
 WebSocketDeflater::~WebSocketDeflater() {
   if (stream_) {
@@ -43,8 +50,6 @@ bool WebSocketDeflater::Initialize(int window_bits) {
     stream_.reset();
     return false;
   }
-  const size_t kFixedBufferSize = 4096;
-  fixed_buffer_.resize(kFixedBufferSize);
   return true;
 }
 
@@ -66,7 +71,8 @@ bool WebSocketDeflater::Finish() {
     // Since consecutive calls of deflate with Z_SYNC_FLUSH and no input
     // lead to an error, we create and return the output for the empty input
     // manually.
-    buffer_.push_back('\x00');
+    ReserveOutput(1);
+    buffer_[output_size_++] = '\x00';
     ResetContext();
     return true;
   }
@@ -85,7 +91,7 @@ bool WebSocketDeflater::Finish() {
     ResetContext();
     return false;
   }
-  buffer_.resize(buffer_.size() - 4);
+  output_size_ -= 4;
   ResetContext();
   return true;
 }
@@ -93,16 +99,20 @@ bool WebSocketDeflater::Finish() {
 void WebSocketDeflater::PushSyncMark() {
   DCHECK(!are_bytes_added_);
   const char data[] = {'\x00', '\x00', '\xff', '\xff'};
-  buffer_.insert(buffer_.end(), &data[0], &data[sizeof(data)]);
+  ReserveOutput(sizeof(data));
+  memcpy(&buffer_[output_size_], data, sizeof(data));
+  output_size_ += sizeof(data);
 }
 
 scoped_refptr<IOBufferWithSize> WebSocketDeflater::GetOutput(size_t size) {
-  std::deque<char>::iterator begin = buffer_.begin();
-  std::deque<char>::iterator end = begin + std::min(size, buffer_.size());
+  size = std::min(size, output_size_);
 
-  scoped_refptr<IOBufferWithSize> result = new IOBufferWithSize(end - begin);
-  std::copy(begin, end, result->data());
-  buffer_.erase(begin, end);
+  scoped_refptr<IOBufferWithSize> result = new IOBufferWithSize(size);
+  if (size) {
+    memcpy(result->data(), &buffer_[0], size);
+    output_size_ -= size;
+    memmove(&buffer_[0], &buffer_[0] + size, output_size_);
+  }
   return result;
 }
 
@@ -115,13 +125,19 @@ void WebSocketDeflater::ResetContext() {
 int WebSocketDeflater::Deflate(int flush) {
   int result = Z_OK;
   do {
-    stream_->next_out = reinterpret_cast<Bytef*>(&fixed_buffer_[0]);
-    stream_->avail_out = fixed_buffer_.size();
+    ReserveOutput(kOutputChunkSize);
+    size_t available = buffer_.size() - output_size_;
+    stream_->next_out = reinterpret_cast<Bytef*>(&buffer_[output_size_]);
+    stream_->avail_out = available;
     result = deflate(stream_.get(), flush);
-    size_t size = fixed_buffer_.size() - stream_->avail_out;
-    buffer_.insert(buffer_.end(), &fixed_buffer_[0], &fixed_buffer_[0] + size);
+    output_size_ += available - stream_->avail_out;
   } while (result == Z_OK);
   return result;
 }
 
+void WebSocketDeflater::ReserveOutput(size_t size) {
+  if (buffer_.size() - output_size_ < size)
+    buffer_.resize(std::max(output_size_ + size, buffer_.size() * 2));
+}
+
 }  // namespace net
@@ -5,7 +5,6 @@
 #ifndef NET_WEBSOCKETS_WEBSOCKET_DEFLATER_H_
 #define NET_WEBSOCKETS_WEBSOCKET_DEFLATER_H_
 
-#include <deque>
 #include <vector>
 
 #include "base/basictypes.h"
@@ -54,16 +53,22 @@ class NET_EXPORT_PRIVATE WebSocketDeflater {
   scoped_refptr<IOBufferWithSize> GetOutput(size_t size);
 
   // Returns the size of the current deflated output.
-  size_t CurrentOutputSize() const { return buffer_.size(); }
+  size_t CurrentOutputSize() const { return output_size_; }
 
  private:
   void ResetContext();
   int Deflate(int flush);
+  // Makes room for at least |size| more bytes of output after the current
+  // output.
+  void ReserveOutput(size_t size);
 
   scoped_ptr<z_stream_s> stream_;
   ContextTakeOverMode mode_;
-  std::deque<char> buffer_;
-  std::vector<char> fixed_buffer_;
+  // Deflated output is the first |output_size_| bytes of |buffer_|. zlib
+  // writes into the rest of |buffer_| directly, so that output is copied only
+  // once, into the IOBuffer returned by GetOutput(). |buffer_| never shrinks.
+  std::vector<char> buffer_;
+  size_t output_size_;
   // true if bytes were added after last Finish().
   bool are_bytes_added_;
 
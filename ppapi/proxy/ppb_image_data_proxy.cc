@@ -133,8 +133,13 @@ class ImageDataInstanceCache {
  private:
   void IncrementInsertionPoint();
 
-  // We'll store this many ImageDatas per instance.
-  const static int kCacheSize = 2;
+  // We'll store this many ImageDatas per instance. A plugin that paints a
+  // frame while the previous one is still on its way to the renderer has
+  // three images in use: the one it paints, the one being flushed and the one
+  // the renderer displays. With fewer entries, the image the renderer gives
+  // back is evicted by the one being flushed before the plugin asks for its
+  // next image, and every frame allocates new shared memory.
+  const static int kCacheSize = 3;
 
   ImageDataCacheEntry images_[kCacheSize];
 
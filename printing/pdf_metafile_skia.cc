@@ -123,8 +123,9 @@ bool PdfMetafileSkia::GetData(void* dst_buffer,
   if (dst_buffer_size < GetDataSize())
     return false;
 
-  SkAutoDataUnref data(data_->pdf_stream_.copyToData());
-  memcpy(dst_buffer, data->bytes(), dst_buffer_size);
+  // Copy straight out of the stream: copyToData() would keep a second copy
+  // of the whole document alive in the stream.
+  data_->pdf_stream_.copyTo(dst_buffer);
   return true;
 }
 
@@ -231,21 +232,17 @@ PdfMetafileSkia::PdfMetafileSkia()
 
 PdfMetafileSkia* PdfMetafileSkia::GetMetafileForCurrentPage() {
   SkPDFDocument pdf_doc(SkPDFDocument::kDraftMode_Flags);
-  SkDynamicMemoryWStream pdf_stream;
   if (!pdf_doc.appendPage(data_->current_page_.get()))
     return NULL;
 
-  if (!pdf_doc.emitPDF(&pdf_stream))
-    return NULL;
-
-  SkAutoDataUnref data(pdf_stream.copyToData());
-  if (data->size() == 0)
+  // Emit the page straight into the new metafile, rather than into a stream
+  // that then gets copied twice.
+  scoped_ptr<PdfMetafileSkia> metafile(new PdfMetafileSkia);
+  if (!pdf_doc.emitPDF(&metafile->data_->pdf_stream_) ||
+      metafile->GetDataSize() == 0) {
     return NULL;
-
-  PdfMetafileSkia* metafile = new PdfMetafileSkia;
-  metafile->InitFromData(data->bytes(),
-                         base::checked_cast<uint32>(data->size()));
-  return metafile;
+  }
+  return metafile.release();
 }
 
 }  // namespace printing
@@ -4,6 +4,8 @@
 
 #include "remoting/codec/video_encoder_vpx.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/logging.h"
 #include "base/sys_info.h"
@@ -29,6 +31,26 @@ namespace {
 // map for the encoder.
 const int kMacroBlockSize = 16;
 
+// libvpx writes at most 8 token partitions, and more threads than that don't
+// pay off for desktop content.
+const int kMaxEncoderThreads = 8;
+
+// Returns the number of threads libvpx should encode with. Multiple threads
+// give a great boost in performance on systems with adequate processing power,
+// but can really hurt on low end Windows systems (http://crbug.com/99179), so
+// systems with two cores or less use one. Otherwise half of the cores are
+// used, leaving the rest to capturing and to the rest of the host, rounded
+// down to a power of two to match the number of token partitions.
+int GetEncoderThreadCount() {
+  int cores = base::SysInfo::NumberOfProcessors();
+  if (cores <= 2)
+    return 1;
+  int threads = 1;
+  while (threads * 2 <= std::min(cores / 2, kMaxEncoderThreads))
+    threads *= 2;
+  return threads;
+}
+
 ScopedVpxCodec CreateVP8Codec(const webrtc::DesktopSize& size) {
   ScopedVpxCodec codec(new vpx_codec_ctx_t);
 
@@ -51,11 +73,8 @@ ScopedVpxCodec CreateVP8Codec(const webrtc::DesktopSize& size) {
   // encoding.
   config.g_profile = 2;
 
-  // Using 2 threads gives a great boost in performance for most systems with
-  // adequate processing power. NB: Going to multiple threads on low end
-  // windows systems can really hurt performance.
-  // http://crbug.com/99179
-  config.g_threads = (base::SysInfo::NumberOfProcessors() > 2) ? 2 : 1;
+  // libvpx encodes macroblock rows in parallel on |g_threads| threads.
+  config.g_threads = GetEncoderThreadCount();
   config.rc_min_quantizer = 20;
   config.rc_max_quantizer = 30;
   config.g_timebase.num = 1;
@@ -74,6 +93,17 @@ ScopedVpxCodec CreateVP8Codec(const webrtc::DesktopSize& size) {
   if (vpx_codec_control(codec.get(), VP8E_SET_NOISE_SENSITIVITY, 0))
     return ScopedVpxCodec();
 
+  // Write one token partition per thread, so that clients can decode
+  // macroblock rows in parallel as well. The control takes the log2 of the
+  // number of partitions.
+  int token_partitions = 0;
+  while ((2 << token_partitions) <= static_cast<int>(config.g_threads))
+    ++token_partitions;
+  if (vpx_codec_control(codec.get(), VP8E_SET_TOKEN_PARTITIONS,
+                        token_partitions)) {
+    return ScopedVpxCodec();
+  }
+
   return codec.Pass();
 }
 
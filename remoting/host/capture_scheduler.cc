@@ -24,6 +24,11 @@ const int64 kDefaultMinimumIntervalMs = 33;
 // available while 1 means using 100% of all CPUs available.
 const double kRecordingCpuConsumption = 0.5;
 
+// Frames being captured, encoded or sent at the same time by default. Two let
+// capturing and encoding of one frame overlap with sending the previous one,
+// while keeping latency low.
+const int kDefaultMaxPendingFrames = 2;
+
 }  // namespace
 
 namespace remoting {
@@ -33,8 +38,10 @@ CaptureScheduler::CaptureScheduler()
     : minimum_interval_(
           base::TimeDelta::FromMilliseconds(kDefaultMinimumIntervalMs)),
       num_of_processors_(base::SysInfo::NumberOfProcessors()),
+      max_pending_frames_(kDefaultMaxPendingFrames),
       capture_time_(kStatisticsWindow),
-      encode_time_(kStatisticsWindow) {
+      encode_time_(kStatisticsWindow),
+      send_time_(kStatisticsWindow) {
   DCHECK(num_of_processors_);
 }
 
@@ -49,6 +56,13 @@ base::TimeDelta CaptureScheduler::NextCaptureDelay() {
       (capture_time_.Average() + encode_time_.Average()) /
       (kRecordingCpuConsumption * num_of_processors_));
 
+  // Frames captured faster than the network takes them would only wait for a
+  // free slot in the pipeline, growing stale. Spread the captures out over the
+  // time the pipeline takes to drain instead.
+  base::TimeDelta network_delay = base::TimeDelta::FromMilliseconds(
+      send_time_.Average() / max_pending_frames_);
+  delay = std::max(delay, network_delay);
+
   if (delay < minimum_interval_)
     return minimum_interval_;
   return delay;
@@ -62,6 +76,15 @@ void CaptureScheduler::RecordEncodeTime(base::TimeDelta encode_time) {
   encode_time_.Record(encode_time.InMilliseconds());
 }
 
+void CaptureScheduler::RecordSendTime(base::TimeDelta send_time) {
+  send_time_.Record(send_time.InMilliseconds());
+}
+
+void CaptureScheduler::set_max_pending_frames(int max_pending_frames) {
+  DCHECK_GE(max_pending_frames, 1);
+  max_pending_frames_ = max_pending_frames;
+}
+
 void CaptureScheduler::SetNumOfProcessorsForTest(int num_of_processors) {
   num_of_processors_ = num_of_processors;
 }
@@ -4,7 +4,9 @@
 
 // This class chooses a capture interval so as to limit CPU usage to not exceed
 // a specified %age. It bases this on the CPU usage of recent capture and encode
-// operations, and on the number of available CPUs.
+// operations, and on the number of available CPUs. It also keeps captures from
+// outpacing the network: with up to max_pending_frames() frames in flight,
+// frames can't be sent faster than that many per recent send time.
 
 #ifndef REMOTING_HOST_CAPTURE_SCHEDULER_H_
 #define REMOTING_HOST_CAPTURE_SCHEDULER_H_
@@ -27,19 +29,31 @@ class CaptureScheduler {
   void RecordCaptureTime(base::TimeDelta capture_time);
   void RecordEncodeTime(base::TimeDelta encode_time);
 
+  // Records the time from handing a frame to the network until it was written
+  // to the (flow controlled) video channel.
+  void RecordSendTime(base::TimeDelta send_time);
+
   // Sets minimum interval between frames.
   void set_minimum_interval(base::TimeDelta minimum_interval) {
     minimum_interval_ = minimum_interval;
   }
 
+  // The number of frames that may be captured, encoded or sent at the same
+  // time. Deeper pipelines keep high-latency links busy, at the cost of the
+  // latency of each frame.
+  int max_pending_frames() const { return max_pending_frames_; }
+  void set_max_pending_frames(int max_pending_frames);
+
   // Overrides the number of processors for testing.
   void SetNumOfProcessorsForTest(int num_of_processors);
 
  private:
   base::TimeDelta minimum_interval_;
   int num_of_processors_;
+  int max_pending_frames_;
   RunningAverage capture_time_;
   RunningAverage encode_time_;
+  RunningAverage send_time_;
 
   DISALLOW_COPY_AND_ASSIGN(CaptureScheduler);
 };
@@ -84,4 +84,25 @@ TEST(CaptureSchedulerTest, RollingAverageDifferentTimes) {
   }
 }
 
+// Captures are spread out over the time the network takes to send the frames
+// in flight.
+TEST(CaptureSchedulerTest, SendTimeLimitsCaptureRate) {
+  const int kSendTimeMs = 300;
+  const int kMaxPendingFrames[] = { 1, 2, 4, 10 };
+  const int kTestResults[] = { 300, 150, 75, 50 };
+
+  for (size_t i = 0; i < arraysize(kMaxPendingFrames); ++i) {
+    CaptureScheduler scheduler;
+    scheduler.SetNumOfProcessorsForTest(8);
+    scheduler.set_minimum_interval(
+        base::TimeDelta::FromMilliseconds(kMinumumFrameIntervalMs));
+    scheduler.set_max_pending_frames(kMaxPendingFrames[i]);
+    scheduler.RecordCaptureTime(base::TimeDelta::FromMilliseconds(10));
+    scheduler.RecordEncodeTime(base::TimeDelta::FromMilliseconds(10));
+    scheduler.RecordSendTime(base::TimeDelta::FromMilliseconds(kSendTimeMs));
+    EXPECT_EQ(kTestResults[i], scheduler.NextCaptureDelay().InMilliseconds())
+        << i;
+  }
+}
+
 }  // namespace remoting
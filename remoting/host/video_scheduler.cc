@@ -27,10 +27,6 @@
 
 namespace remoting {
 
-// Maximum number of frames that can be processed simultaneously.
-// TODO(hclam): Move this value to CaptureScheduler.
-static const int kMaxPendingFrames = 2;
-
 VideoScheduler::VideoScheduler(
     scoped_refptr<base::SingleThreadTaskRunner> capture_task_runner,
     scoped_refptr<base::SingleThreadTaskRunner> encode_task_runner,
@@ -157,6 +153,22 @@ void VideoScheduler::UpdateSequenceNumber(int64 sequence_number) {
   sequence_number_ = sequence_number;
 }
 
+void VideoScheduler::SetMaxPendingFrames(int max_pending_frames) {
+  if (!capture_task_runner_->BelongsToCurrentThread()) {
+    DCHECK(network_task_runner_->BelongsToCurrentThread());
+    capture_task_runner_->PostTask(
+        FROM_HERE, base::Bind(&VideoScheduler::SetMaxPendingFrames,
+                              this, max_pending_frames));
+    return;
+  }
+
+  scheduler_.set_max_pending_frames(max_pending_frames);
+
+  // A deeper pipeline may have room for a capture that was skipped.
+  if (did_skip_frame_)
+    CaptureNextFrame();
+}
+
 // Private methods -----------------------------------------------------------
 
 VideoScheduler::~VideoScheduler() {
@@ -205,10 +217,10 @@ void VideoScheduler::CaptureNextFrame() {
   if (!capturer_ || is_paused_)
     return;
 
-  // Make sure we have at most two outstanding recordings. We can simply return
-  // if we can't make a capture now, the next capture will be started by the
-  // end of an encode operation.
-  if (pending_frames_ >= kMaxPendingFrames || capture_pending_) {
+  // Make sure we have a limited number of outstanding recordings. We can
+  // simply return if we can't make a capture now, the next capture will be
+  // started once a frame has been sent.
+  if (pending_frames_ >= scheduler_.max_pending_frames() || capture_pending_) {
     did_skip_frame_ = true;
     return;
   }
@@ -217,7 +229,7 @@ void VideoScheduler::CaptureNextFrame() {
 
   // At this point we are going to perform one capture so save the current time.
   pending_frames_++;
-  DCHECK_LE(pending_frames_, kMaxPendingFrames);
+  DCHECK_LE(pending_frames_, scheduler_.max_pending_frames());
 
   // Before doing a capture schedule for the next one.
   ScheduleNextCapture();
@@ -228,9 +240,11 @@ void VideoScheduler::CaptureNextFrame() {
   capturer_->Capture(webrtc::DesktopRegion());
 }
 
-void VideoScheduler::FrameCaptureCompleted() {
+void VideoScheduler::FrameCaptureCompleted(base::TimeDelta send_time) {
   DCHECK(capture_task_runner_->BelongsToCurrentThread());
 
+  scheduler_.RecordSendTime(send_time);
+
   // Decrement the pending capture count.
   pending_frames_--;
   DCHECK_GE(pending_frames_, 0);
@@ -250,17 +264,19 @@ void VideoScheduler::SendVideoPacket(scoped_ptr<VideoPacket> packet) {
     return;
 
   video_stub_->ProcessVideoPacket(
-      packet.Pass(), base::Bind(&VideoScheduler::VideoFrameSentCallback, this));
+      packet.Pass(), base::Bind(&VideoScheduler::VideoFrameSentCallback, this,
+                                base::TimeTicks::Now()));
 }
 
-void VideoScheduler::VideoFrameSentCallback() {
+void VideoScheduler::VideoFrameSentCallback(base::TimeTicks send_start_time) {
   DCHECK(network_task_runner_->BelongsToCurrentThread());
 
   if (!video_stub_)
     return;
 
   capture_task_runner_->PostTask(
-      FROM_HERE, base::Bind(&VideoScheduler::FrameCaptureCompleted, this));
+      FROM_HERE, base::Bind(&VideoScheduler::FrameCaptureCompleted, this,
+                            base::TimeTicks::Now() - send_start_time));
 }
 
 void VideoScheduler::SendCursorShape(
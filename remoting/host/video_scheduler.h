@@ -112,6 +112,11 @@ class VideoScheduler : public base::RefCountedThreadSafe<VideoScheduler>,
   // Sequence numbers are used for performance measurements.
   void UpdateSequenceNumber(int64 sequence_number);
 
+  // Sets how many frames may be captured, encoded or sent at the same time.
+  // The default of 2 keeps latency low; deeper pipelines keep links with a
+  // long round trip busy.
+  void SetMaxPendingFrames(int max_pending_frames);
+
  private:
   friend class base::RefCountedThreadSafe<VideoScheduler>;
   virtual ~VideoScheduler();
@@ -131,7 +136,8 @@ class VideoScheduler : public base::RefCountedThreadSafe<VideoScheduler>,
   void CaptureNextFrame();
 
   // Called when a frame capture has been encoded & sent to the client.
-  void FrameCaptureCompleted();
+  // |send_time| is the time the network took to send it.
+  void FrameCaptureCompleted(base::TimeDelta send_time);
 
   // Network thread -----------------------------------------------------------
 
@@ -139,8 +145,9 @@ class VideoScheduler : public base::RefCountedThreadSafe<VideoScheduler>,
   void SendVideoPacket(scoped_ptr<VideoPacket> packet);
 
   // Callback passed to |video_stub_| for the last packet in each frame, to
-  // rate-limit frame captures to network throughput.
-  void VideoFrameSentCallback();
+  // rate-limit frame captures to network throughput. |send_start_time| is when
+  // the packet was passed to |video_stub_|.
+  void VideoFrameSentCallback(base::TimeTicks send_start_time);
 
   // Send updated cursor shape to client.
   void SendCursorShape(scoped_ptr<protocol::CursorShapeInfo> cursor_shape);
@@ -174,8 +181,9 @@ class VideoScheduler : public base::RefCountedThreadSafe<VideoScheduler>,
   scoped_ptr<base::OneShotTimer<VideoScheduler> > capture_timer_;
 
   // The number of frames being processed, i.e. frames that we are currently
-  // capturing, encoding or sending. The value is capped at 2 to minimize
-  // latency.
+  // capturing, encoding or sending. The value is capped at
+  // |scheduler_|.max_pending_frames(), so that frames queued behind a slow
+  // network hold back new captures.
   int pending_frames_;
 
   // Set when the capturer is capturing a frame.
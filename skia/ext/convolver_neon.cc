@@ -0,0 +1,168 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "skia/ext/convolver_neon.h"
+
+#include <string.h>
+
+#include "skia/ext/convolver.h"
+
+// This file is built on every platform, but only has code on NEON ones.
+#if defined(SIMD_ARM_NEON)
+
+#include <arm_neon.h>
+
+namespace skia {
+
+namespace {
+
+// Widens the four pixels in |src8| to 16 bits per channel and accumulates
+// them, multiplied by |coeff|, into one accumulator per pixel.
+inline void Accumulate4Pixels(uint8x16_t src8,
+                              int16_t coeff,
+                              int32x4_t accum[4]) {
+  int16x8_t src16_lo = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(src8)));
+  int16x8_t src16_hi = vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(src8)));
+  accum[0] = vmlal_n_s16(accum[0], vget_low_s16(src16_lo), coeff);
+  accum[1] = vmlal_n_s16(accum[1], vget_high_s16(src16_lo), coeff);
+  accum[2] = vmlal_n_s16(accum[2], vget_low_s16(src16_hi), coeff);
+  accum[3] = vmlal_n_s16(accum[3], vget_high_s16(src16_hi), coeff);
+}
+
+// Brings the four accumulated pixels back to 8 bits per channel, clamping
+// them to 0-255.
+inline uint8x16_t Pack4Pixels(const int32x4_t accum[4]) {
+  uint16x8_t pixels01 = vcombine_u16(
+      vqmovun_s32(vshrq_n_s32(accum[0], ConvolutionFilter1D::kShiftBits)),
+      vqmovun_s32(vshrq_n_s32(accum[1], ConvolutionFilter1D::kShiftBits)));
+  uint16x8_t pixels23 = vcombine_u16(
+      vqmovun_s32(vshrq_n_s32(accum[2], ConvolutionFilter1D::kShiftBits)),
+      vqmovun_s32(vshrq_n_s32(accum[3], ConvolutionFilter1D::kShiftBits)));
+  return vcombine_u8(vqmovn_u16(pixels01), vqmovn_u16(pixels23));
+}
+
+template<bool has_alpha>
+void ConvolveVertically_neon(const ConvolutionFilter1D::Fixed* filter_values,
+                             int filter_length,
+                             unsigned char* const* source_data_rows,
+                             int pixel_width,
+                             unsigned char* out_row) {
+  // Output four pixels per iteration. The rows are padded to a multiple of
+  // 16 pixels, so the loads may run past |pixel_width|, but the stores don't.
+  for (int out_x = 0; out_x < pixel_width; out_x += 4) {
+    int32x4_t accum[4] = {
+      vdupq_n_s32(0), vdupq_n_s32(0), vdupq_n_s32(0), vdupq_n_s32(0)
+    };
+    for (int filter_y = 0; filter_y < filter_length; filter_y++) {
+      Accumulate4Pixels(vld1q_u8(&source_data_rows[filter_y][out_x << 2]),
+                        filter_values[filter_y],
+                        accum);
+    }
+
+    uint8x16_t pixels = Pack4Pixels(accum);
+    if (has_alpha) {
+      // Make sure the alpha channel is no smaller than any color channel, as
+      // the C++ version does.
+      uint32x4_t pixels32 = vreinterpretq_u32_u8(pixels);
+      uint8x16_t max_color = vmaxq_u8(
+          pixels,
+          vmaxq_u8(vreinterpretq_u8_u32(vshrq_n_u32(pixels32, 8)),
+                   vreinterpretq_u8_u32(vshrq_n_u32(pixels32, 16))));
+      max_color = vreinterpretq_u8_u32(
+          vshlq_n_u32(vreinterpretq_u32_u8(max_color), 24));
+      pixels = vmaxq_u8(pixels, max_color);
+    } else {
+      // No alpha channel, the image is opaque.
+      pixels = vorrq_u8(pixels, vreinterpretq_u8_u32(vdupq_n_u32(0xff000000)));
+    }
+
+    if (out_x + 4 <= pixel_width) {
+      vst1q_u8(&out_row[out_x << 2], pixels);
+    } else {
+      unsigned char last_pixels[16];
+      vst1q_u8(last_pixels, pixels);
+      memcpy(&out_row[out_x << 2], last_pixels, (pixel_width - out_x) << 2);
+    }
+  }
+}
+
+}  // namespace
+
+// Convolves horizontally along a single row. The row data is given in
+// |src_data| and continues for the num_values() of the filter. Unlike the
+// SSE2 version this never reads past the last pixel of the filter.
+void ConvolveHorizontally_neon(const unsigned char* src_data,
+                               const ConvolutionFilter1D& filter,
+                               unsigned char* out_row,
+                               bool /*has_alpha*/) {
+  int num_values = filter.num_values();
+  for (int out_x = 0; out_x < num_values; out_x++) {
+    int filter_offset, filter_length;
+    const ConvolutionFilter1D::Fixed* filter_values =
+        filter.FilterForValue(out_x, &filter_offset, &filter_length);
+    const unsigned char* row_to_filter = &src_data[filter_offset << 2];
+
+    // Accumulate four coefficients per iteration, one accumulator per tap,
+    // then the remaining ones a pixel at a time.
+    int32x4_t accum[4] = {
+      vdupq_n_s32(0), vdupq_n_s32(0), vdupq_n_s32(0), vdupq_n_s32(0)
+    };
+    int filter_x = 0;
+    for (; filter_x + 4 <= filter_length; filter_x += 4) {
+      uint8x16_t src8 = vld1q_u8(&row_to_filter[filter_x << 2]);
+      int16x8_t src16_lo = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(src8)));
+      int16x8_t src16_hi =
+          vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(src8)));
+      accum[0] = vmlal_n_s16(accum[0], vget_low_s16(src16_lo),
+                             filter_values[filter_x]);
+      accum[1] = vmlal_n_s16(accum[1], vget_high_s16(src16_lo),
+                             filter_values[filter_x + 1]);
+      accum[2] = vmlal_n_s16(accum[2], vget_low_s16(src16_hi),
+                             filter_values[filter_x + 2]);
+      accum[3] = vmlal_n_s16(accum[3], vget_high_s16(src16_hi),
+                             filter_values[filter_x + 3]);
+    }
+    for (; filter_x < filter_length; filter_x++) {
+      uint32_t pixel;
+      memcpy(&pixel, &row_to_filter[filter_x << 2], sizeof(pixel));
+      int16x4_t src16 = vget_low_s16(vreinterpretq_s16_u16(
+          vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(pixel)))));
+      accum[0] = vmlal_n_s16(accum[0], src16, filter_values[filter_x]);
+    }
+    int32x4_t sum = vaddq_s32(vaddq_s32(accum[0], accum[1]),
+                              vaddq_s32(accum[2], accum[3]));
+
+    // Bring the value back in range and store the new pixel.
+    uint16x4_t sum16 =
+        vqmovun_s32(vshrq_n_s32(sum, ConvolutionFilter1D::kShiftBits));
+    uint32_t pixel = vget_lane_u32(
+        vreinterpret_u32_u8(vqmovn_u16(vcombine_u16(sum16, sum16))), 0);
+    memcpy(&out_row[out_x << 2], &pixel, sizeof(pixel));
+  }
+}
+
+void ConvolveVertically_neon(const ConvolutionFilter1D::Fixed* filter_values,
+                             int filter_length,
+                             unsigned char* const* source_data_rows,
+                             int pixel_width,
+                             unsigned char* out_row,
+                             bool has_alpha) {
+  if (has_alpha) {
+    ConvolveVertically_neon<true>(filter_values,
+                                  filter_length,
+                                  source_data_rows,
+                                  pixel_width,
+                                  out_row);
+  } else {
+    ConvolveVertically_neon<false>(filter_values,
+                                   filter_length,
+                                   source_data_rows,
+                                   pixel_width,
+                                   out_row);
+  }
+}
+
+}  // namespace skia
+
+#endif  // SIMD_ARM_NEON
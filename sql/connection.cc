@@ -8,6 +8,7 @@
 
 #include "base/files/file_path.h"
 #include "base/file_util.h"
+#include "base/format_macros.h"
 #include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/metrics/histogram.h"
@@ -26,6 +27,9 @@
 
 namespace {
 
+// Number of statements kept prepared by GetUniqueStatement().
+const size_t kUniqueStatementCacheSize = 16;
+
 // Spin for up to a second waiting for the lock to clear when setting
 // up the database.
 // TODO(shess): Better story on this.  http://crbug.com/56559
@@ -214,8 +218,11 @@ Connection::Connection()
     : db_(NULL),
       page_size_(0),
       cache_size_(0),
+      mmap_size_(0),
+      preload_on_open_(false),
       exclusive_locking_(false),
       restrict_to_user_(false),
+      unique_statement_cache_(kUniqueStatementCacheSize),
       transaction_nesting_(0),
       needs_rollback_(false),
       in_memory_(false),
@@ -267,6 +274,7 @@ void Connection::CloseInternal(bool forced) {
 
   // Release cached statements.
   statement_cache_.clear();
+  unique_statement_cache_.Clear();
 
   // With cached statements released, in-use statements will remain.
   // Closing the database while statements are in use is an API
@@ -707,7 +715,7 @@ scoped_refptr<Connection::StatementRef> Connection::GetCachedStatement(
     return i->second;
   }
 
-  scoped_refptr<StatementRef> statement = GetUniqueStatement(sql);
+  scoped_refptr<StatementRef> statement = PrepareStatement(sql);
   if (statement->is_valid())
     statement_cache_[id] = statement;  // Only cache valid statements.
   return statement;
@@ -715,6 +723,27 @@ scoped_refptr<Connection::StatementRef> Connection::GetCachedStatement(
 
 scoped_refptr<Connection::StatementRef> Connection::GetUniqueStatement(
     const char* sql) {
+  UniqueStatementCache::iterator i = unique_statement_cache_.Get(sql);
+  if (i != unique_statement_cache_.end()) {
+    // A statement still referenced elsewhere may be mid-step, so only the
+    // idle ones are handed out again.  Like GetCachedStatement(), reset it in
+    // case it still has some stuff bound.
+    if (i->second->HasOneRef() && i->second->is_valid()) {
+      AssertIOAllowed();
+      sqlite3_reset(i->second->stmt());
+      return i->second;
+    }
+    return PrepareStatement(sql);
+  }
+
+  scoped_refptr<StatementRef> statement = PrepareStatement(sql);
+  if (statement->is_valid())
+    unique_statement_cache_.Put(sql, statement);
+  return statement;
+}
+
+scoped_refptr<Connection::StatementRef> Connection::PrepareStatement(
+    const char* sql) {
   AssertIOAllowed();
 
   // Return inactive statement.
@@ -1000,6 +1029,12 @@ bool Connection::OpenInternal(const std::string& file_name,
     ignore_result(ExecuteWithTimeout(sql.c_str(), kBusyTimeout));
   }
 
+  if (mmap_size_ != 0) {
+    const std::string sql =
+        base::StringPrintf("PRAGMA mmap_size=%" PRId64, mmap_size_);
+    ignore_result(ExecuteWithTimeout(sql.c_str(), kBusyTimeout));
+  }
+
   if (!ExecuteWithTimeout("PRAGMA secure_delete=ON", kBusyTimeout)) {
     bool was_poisoned = poisoned_;
     Close();
@@ -1008,6 +1043,9 @@ bool Connection::OpenInternal(const std::string& file_name,
     return false;
   }
 
+  if (preload_on_open_)
+    Preload();
+
   return true;
 }
 
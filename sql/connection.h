@@ -13,6 +13,7 @@
 #include "base/basictypes.h"
 #include "base/callback.h"
 #include "base/compiler_specific.h"
+#include "base/containers/mru_cache.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/threading/thread_restrictions.h"
@@ -105,6 +106,17 @@ class SQL_EXPORT Connection {
   // called before Open() to have an effect.
   void set_cache_size(int cache_size) { cache_size_ = cache_size; }
 
+  // Sets the maximum number of bytes of the database file which sqlite will
+  // read through a memory mapping instead of issuing read() calls. Zero, the
+  // default, leaves memory-mapped I/O disabled. This must be called before
+  // Open() to have an effect, and is ignored by sqlite versions which do not
+  // support "PRAGMA mmap_size".
+  void set_mmap_size(int64 mmap_size) { mmap_size_ = mmap_size; }
+
+  // Call to have Open() prime the filesystem cache with Preload() once the
+  // database is configured.
+  void set_preload_on_open() { preload_on_open_ = true; }
+
   // Call to put the database in exclusive locking mode. There is no "back to
   // normal" flag because of some additional requirements sqlite puts on this
   // transaition (requires another access to the DB) and because we don't
@@ -352,9 +364,11 @@ class SQL_EXPORT Connection {
   // valid SQL, returns true.
   bool IsSQLValid(const char* sql);
 
-  // Returns a non-cached statement for the given SQL. Use this for SQL that
-  // is only executed once or only rarely (there is overhead associated with
-  // keeping a statement cached).
+  // Returns a statement for the given SQL which is not kept in the
+  // StatementID cache. Use this for SQL that is only executed once or only
+  // rarely (there is overhead associated with keeping a statement cached).
+  // The most recently used of these statements are still kept prepared, keyed
+  // by their SQL text, and handed out again when nobody else holds them.
   //
   // See GetCachedStatement above for examples and error information.
   scoped_refptr<StatementRef> GetUniqueStatement(const char* sql);
@@ -535,6 +549,9 @@ class SQL_EXPORT Connection {
   bool ExecuteWithTimeout(const char* sql, base::TimeDelta ms_timeout)
       WARN_UNUSED_RESULT;
 
+  // Compiles |sql| into a new statement, bypassing both statement caches.
+  scoped_refptr<StatementRef> PrepareStatement(const char* sql);
+
   // Internal helper for const functions.  Like GetUniqueStatement(),
   // except the statement is not entered into open_statements_,
   // allowing this function to be const.  Open statements can block
@@ -555,6 +572,8 @@ class SQL_EXPORT Connection {
   // use the default value.
   int page_size_;
   int cache_size_;
+  int64 mmap_size_;
+  bool preload_on_open_;
   bool exclusive_locking_;
   bool restrict_to_user_;
 
@@ -564,6 +583,12 @@ class SQL_EXPORT Connection {
       CachedStatementMap;
   CachedStatementMap statement_cache_;
 
+  // The statements most recently handed out by GetUniqueStatement(), keyed by
+  // their SQL text.  An entry is only reused while this is its only reference.
+  typedef base::MRUCache<std::string, scoped_refptr<StatementRef> >
+      UniqueStatementCache;
+  UniqueStatementCache unique_statement_cache_;
+
   // A list of all StatementRefs we've given out. Each ref must register with
   // us when it's created or destroyed. This allows us to potentially close
   // any open statements when we encounter an error.
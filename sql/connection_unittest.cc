@@ -168,6 +168,43 @@ TEST_F(SQLConnectionTest, CachedStatement) {
   EXPECT_FALSE(db().HasCachedStatement(SQL_FROM_HERE));
 }
 
+TEST_F(SQLConnectionTest, UniqueStatementReuse) {
+  const char kSql[] = "SELECT a FROM foo WHERE b = ?";
+
+  ASSERT_TRUE(db().Execute("CREATE TABLE foo (a, b)"));
+  ASSERT_TRUE(db().Execute("INSERT INTO foo(a, b) VALUES (12, 13)"));
+
+  const void* first_ref = db().GetUniqueStatement(kSql).get();
+  {
+    sql::Statement s(db().GetUniqueStatement(kSql));
+    s.BindInt(0, 13);
+    ASSERT_TRUE(s.Step());
+    EXPECT_EQ(12, s.ColumnInt(0));
+  }
+
+  // The idle statement is handed out again, with nothing left bound.
+  EXPECT_EQ(first_ref, db().GetUniqueStatement(kSql).get());
+  sql::Statement s(db().GetUniqueStatement(kSql));
+  EXPECT_FALSE(s.Step());
+
+  // While it is in use, a new statement is prepared instead.
+  EXPECT_NE(first_ref, db().GetUniqueStatement(kSql).get());
+}
+
+TEST_F(SQLConnectionTest, MmapAndPreloadOnOpen) {
+  ASSERT_TRUE(db().Execute("CREATE TABLE foo (a, b)"));
+  ASSERT_TRUE(db().Execute("INSERT INTO foo(a, b) VALUES (12, 13)"));
+  db().Close();
+
+  db().set_mmap_size(1024 * 1024);
+  db().set_preload_on_open();
+  ASSERT_TRUE(db().Open(db_path()));
+
+  sql::Statement s(db().GetUniqueStatement("SELECT a FROM foo"));
+  ASSERT_TRUE(s.Step());
+  EXPECT_EQ(12, s.ColumnInt(0));
+}
+
 TEST_F(SQLConnectionTest, IsSQLValidTest) {
   ASSERT_TRUE(db().Execute("CREATE TABLE foo (a, b)"));
   ASSERT_TRUE(db().IsSQLValid("SELECT a FROM foo"));
@@ -4,6 +4,7 @@
 
 #include "sql/statement.h"
 
+#include "base/debug/trace_event.h"
 #include "base/logging.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
@@ -17,13 +18,15 @@ namespace sql {
 Statement::Statement()
     : ref_(new Connection::StatementRef(NULL, NULL, false)),
       stepped_(false),
-      succeeded_(false) {
+      succeeded_(false),
+      step_count_(0) {
 }
 
 Statement::Statement(scoped_refptr<Connection::StatementRef> ref)
     : ref_(ref),
       stepped_(false),
-      succeeded_(false) {
+      succeeded_(false),
+      step_count_(0) {
 }
 
 Statement::~Statement() {
@@ -58,7 +61,7 @@ bool Statement::Run() {
     return false;
 
   stepped_ = true;
-  return CheckError(sqlite3_step(ref_->stmt())) == SQLITE_DONE;
+  return CheckError(StepInternal()) == SQLITE_DONE;
 }
 
 bool Statement::Step() {
@@ -67,7 +70,21 @@ bool Statement::Step() {
     return false;
 
   stepped_ = true;
-  return CheckError(sqlite3_step(ref_->stmt())) == SQLITE_ROW;
+  return CheckError(StepInternal()) == SQLITE_ROW;
+}
+
+int Statement::StepInternal() {
+  bool tracing = false;
+  TRACE_EVENT_CATEGORY_GROUP_ENABLED(TRACE_DISABLED_BY_DEFAULT("sql"),
+                                     &tracing);
+  if (!tracing)
+    return sqlite3_step(ref_->stmt());
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  int rc = sqlite3_step(ref_->stmt());
+  step_time_ += base::TimeTicks::Now() - start;
+  ++step_count_;
+  return rc;
 }
 
 void Statement::Reset(bool clear_bound_vars) {
@@ -79,8 +96,35 @@ void Statement::Reset(bool clear_bound_vars) {
     if (clear_bound_vars)
       sqlite3_clear_bindings(ref_->stmt());
     sqlite3_reset(ref_->stmt());
+
+    // One event per execution, named by the SQL so that profiles can be
+    // aggregated by statement.
+    if (step_count_) {
+      TRACE_EVENT_COPY_INSTANT2(TRACE_DISABLED_BY_DEFAULT("sql"),
+                                sqlite3_sql(ref_->stmt()),
+                                TRACE_EVENT_SCOPE_THREAD,
+                                "steps", step_count_,
+                                "step_time_us",
+                                step_time_.InMicroseconds());
+
+#if defined(SQLITE_DBSTATUS_CACHE_HIT)
+      // Page cache counters are per connection and only exist in sqlite
+      // 3.7.9 and later.
+      sqlite3* db = sqlite3_db_handle(ref_->stmt());
+      int hits = 0;
+      int misses = 0;
+      int unused = 0;
+      sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_HIT, &hits, &unused, 0);
+      sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_MISS, &misses, &unused, 0);
+      TRACE_COUNTER_ID2(TRACE_DISABLED_BY_DEFAULT("sql"), "sql::PageCache",
+                        db, "hits", hits, "misses", misses);
+#endif
+    }
   }
 
+  step_count_ = 0;
+  step_time_ = base::TimeDelta();
+
   succeeded_ = false;
   stepped_ = false;
 }
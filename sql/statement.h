@@ -11,6 +11,7 @@
 #include "base/basictypes.h"
 #include "base/memory/ref_counted.h"
 #include "base/strings/string16.h"
+#include "base/time/time.h"
 #include "sql/connection.h"
 #include "sql/sql_export.h"
 
@@ -173,6 +174,10 @@ class SQL_EXPORT Statement {
   // ensuring that contracts are honored in error edge cases.
   bool CheckValid() const;
 
+  // Calls sqlite3_step() for Run() and Step(), timing it when the sql
+  // tracing category is enabled.
+  int StepInternal();
+
   // The actual sqlite statement. This may be unique to us, or it may be cached
   // by the connection, which is why it's refcounted. This pointer is
   // guaranteed non-NULL.
@@ -186,6 +191,11 @@ class SQL_EXPORT Statement {
   // See Succeeded() for what this holds.
   bool succeeded_;
 
+  // Steps taken and time spent in sqlite3_step() since the last Reset(),
+  // only collected while tracing the sql category.  Reset() reports them.
+  int step_count_;
+  base::TimeDelta step_time_;
+
   DISALLOW_COPY_AND_ASSIGN(Statement);
 };
 
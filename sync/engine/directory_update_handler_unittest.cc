@@ -7,6 +7,7 @@
 #include "base/compiler_specific.h"
 #include "base/message_loop/message_loop.h"
 #include "base/stl_util.h"
+#include "base/strings/string_number_conversions.h"
 #include "sync/engine/syncer_proto_util.h"
 #include "sync/internal_api/public/base/model_type.h"
 #include "sync/internal_api/public/test/test_entry_factory.h"
@@ -469,6 +470,35 @@ TEST_F(DirectoryUpdateHandlerApplyUpdateTest,
   }
 }
 
+// Test that a deep folder hierarchy received leaves first is applied in full.
+TEST_F(DirectoryUpdateHandlerApplyUpdateTest, BookmarkDeepHierarchyReversed) {
+  const int kDepth = 10;
+  std::vector<int64> handles;
+  for (int i = kDepth - 1; i >= 0; --i) {
+    std::string parent_id = i == 0 ?
+        syncable::GetNullId().GetServerId() :
+        "folder" + base::IntToString(i - 1);
+    handles.push_back(
+        entry_factory()->CreateUnappliedNewBookmarkItemWithParent(
+            "folder" + base::IntToString(i), DefaultBookmarkSpecifics(),
+            parent_id));
+  }
+
+  sessions::StatusController status;
+  ApplyBookmarkUpdates(&status);
+  EXPECT_EQ(0, status.num_hierarchy_conflicts());
+  EXPECT_EQ(kDepth, status.num_updates_applied());
+
+  {
+    syncable::ReadTransaction trans(FROM_HERE, directory());
+    for (size_t i = 0; i < handles.size(); ++i) {
+      syncable::Entry e(&trans, syncable::GET_BY_HANDLE, handles[i]);
+      ASSERT_TRUE(e.good());
+      EXPECT_FALSE(e.GetIsUnappliedUpdate());
+    }
+  }
+}
+
 // Try to apply changes on an item that is both IS_UNSYNCED and
 // IS_UNAPPLIED_UPDATE.  Conflict resolution should be performed.
 TEST_F(DirectoryUpdateHandlerApplyUpdateTest, SimpleBookmarkConflict) {
@@ -4,6 +4,8 @@
 
 #include "sync/engine/update_applicator.h"
 
+#include <algorithm>
+#include <map>
 #include <vector>
 
 #include "base/logging.h"
@@ -19,6 +21,105 @@ namespace syncer {
 
 using syncable::ID;
 
+namespace {
+
+// Depth markers used while ordering updates.
+const int kUnknownDepth = -1;
+const int kDepthInProgress = -2;
+
+// What OrderForApplication() needs to know about one update.
+struct PendingUpdate {
+  int64 handle;
+  bool is_del;
+  syncable::Id parent_id;
+  int depth;
+};
+
+// Sorts non-deletions before deletions, non-deletions parents first and
+// deletions children first.
+class PendingUpdateOrder {
+ public:
+  explicit PendingUpdateOrder(const std::vector<PendingUpdate>& updates)
+      : updates_(updates) {}
+
+  bool operator()(size_t a, size_t b) const {
+    const PendingUpdate& lhs = updates_[a];
+    const PendingUpdate& rhs = updates_[b];
+    if (lhs.is_del != rhs.is_del)
+      return rhs.is_del;
+    return lhs.is_del ? lhs.depth > rhs.depth : lhs.depth < rhs.depth;
+  }
+
+ private:
+  const std::vector<PendingUpdate>& updates_;
+};
+
+// Reorders |handles| so that an update's parent is applied before it, and a
+// deleted folder's children are deleted before it, whenever both are part of
+// |handles|.  Depths only count ancestors that are among the updates, since
+// those already in the tree don't hold anything up.  Moves are applied before
+// deletions so that children leaving a deleted folder are gone by the time it
+// is deleted.  Types without a hierarchy keep their order.
+void OrderForApplication(syncable::BaseTransaction* trans,
+                         std::vector<int64>* handles) {
+  std::vector<PendingUpdate> updates;
+  updates.reserve(handles->size());
+  std::map<syncable::Id, size_t> index_by_id;
+  for (std::vector<int64>::const_iterator i = handles->begin();
+       i != handles->end(); ++i) {
+    syncable::Entry entry(trans, syncable::GET_BY_HANDLE, *i);
+    PendingUpdate update;
+    update.handle = *i;
+    update.is_del = entry.good() && entry.GetServerIsDel();
+    update.depth = kUnknownDepth;
+    if (entry.good()) {
+      // Deletions wait on their children in the local tree, everything else
+      // on its new parent in the server's tree.
+      update.parent_id = update.is_del ? entry.GetParentId()
+                                       : entry.GetServerParentId();
+      index_by_id[entry.GetId()] = updates.size();
+    }
+    updates.push_back(update);
+  }
+
+  for (size_t i = 0; i < updates.size(); ++i) {
+    if (updates[i].depth != kUnknownDepth)
+      continue;
+    // Walk up until reaching an update with a known depth, or the top of the
+    // updates' hierarchy.  Loops are cut where they are found; applying them
+    // fails with a hierarchy conflict in any order.
+    std::vector<size_t> chain;
+    int depth = 0;
+    size_t current = i;
+    while (true) {
+      if (updates[current].depth >= 0) {
+        depth = updates[current].depth + 1;
+        break;
+      }
+      if (updates[current].depth == kDepthInProgress)
+        break;
+      updates[current].depth = kDepthInProgress;
+      chain.push_back(current);
+      std::map<syncable::Id, size_t>::const_iterator parent =
+          index_by_id.find(updates[current].parent_id);
+      if (parent == index_by_id.end())
+        break;
+      current = parent->second;
+    }
+    for (size_t j = chain.size(); j-- > 0; )
+      updates[chain[j]].depth = depth++;
+  }
+
+  std::vector<size_t> order(updates.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+  std::stable_sort(order.begin(), order.end(), PendingUpdateOrder(updates));
+  for (size_t i = 0; i < order.size(); ++i)
+    (*handles)[i] = updates[order[i]].handle;
+}
+
+}  // namespace
+
 UpdateApplicator::UpdateApplicator(Cryptographer* cryptographer)
     : cryptographer_(cryptographer),
       updates_applied_(0),
@@ -32,9 +133,11 @@ UpdateApplicator::~UpdateApplicator() {
 // Attempt to apply all updates, using multiple passes if necessary.
 //
 // Some updates must be applied in order.  For example, children must be created
-// after their parent folder is created.  This function runs an O(n^2) algorithm
-// that will keep trying until there is nothing left to apply, or it stops
-// making progress, which would indicate that the hierarchy is invalid.
+// after their parent folder is created.  The updates are first sorted so that
+// a single pass applies them in a valid order.  Anything that still fails,
+// like an update whose parent arrives in a later batch, is retried until
+// there is nothing left to apply, or no progress is made, which would indicate
+// that the hierarchy is invalid.
 //
 // The update applicator also has to deal with simple conflicts, which occur
 // when an item is modified on both the server and the local model.  We remember
@@ -47,6 +150,7 @@ void UpdateApplicator::AttemptApplications(
     syncable::WriteTransaction* trans,
     const std::vector<int64>& handles) {
   std::vector<int64> to_apply = handles;
+  OrderForApplication(trans, &to_apply);
 
   DVLOG(1) << "UpdateApplicator running over " << to_apply.size() << " items.";
   while (!to_apply.empty()) {
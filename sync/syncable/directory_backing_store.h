@@ -101,8 +101,10 @@ class SYNC_EXPORT_PRIVATE DirectoryBackingStore : public base::NonThreadSafe {
   bool LoadInfo(Directory::KernelLoadInfo* info);
 
   // Save/update helpers for entries.  Return false if sqlite commit fails.
+  // |buffer| is scratch space for serializing the entry's protobufs.
   static bool SaveEntryToDB(sql::Statement* save_statement,
-                            const EntryKernel& entry);
+                            const EntryKernel& entry,
+                            std::string* buffer);
   bool SaveNewEntryToDB(const EntryKernel& entry);
   bool UpdateEntryToDB(const EntryKernel& entry);
 
@@ -0,0 +1,68 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// Converts a trace written by TraceLog::SetStreamingFile() to the JSON format
+// of TraceLog::Flush(), which about:tracing can load.
+//
+// Usage: trace_to_json <binary trace> [<json output>]
+// The JSON goes to stdout if no output file is given.
+
+#include <stdio.h>
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/debug/trace_event_impl.h"
+#include "base/file_util.h"
+#include "base/files/file_path.h"
+
+namespace {
+
+void AppendToString(std::string* out, const std::string& json) {
+  out->append(json);
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+  CommandLine::Init(argc, argv);
+  const CommandLine::StringVector& args =
+      CommandLine::ForCurrentProcess()->GetArgs();
+  if (args.empty() || args.size() > 2) {
+    fprintf(stderr, "Usage: trace_to_json <binary trace> [<json output>]\n");
+    return 1;
+  }
+
+  std::string binary;
+  if (!base::ReadFileToString(base::FilePath(args[0]), &binary)) {
+    fprintf(stderr, "Failed to read the binary trace.\n");
+    return 1;
+  }
+
+  std::string events;
+  if (!base::debug::TraceEvent::AppendBinaryEventsAsJSON(binary, &events)) {
+    fprintf(stderr, "The binary trace is malformed.\n");
+    return 1;
+  }
+
+  std::string json;
+  base::debug::TraceResultBuffer result_buffer;
+  result_buffer.SetOutputCallback(base::Bind(&AppendToString, &json));
+  result_buffer.Start();
+  result_buffer.AddFragment(events);
+  result_buffer.Finish();
+
+  if (args.size() == 1) {
+    fwrite(json.data(), 1, json.size(), stdout);
+    return 0;
+  }
+  int size = static_cast<int>(json.size());
+  if (base::WriteFile(base::FilePath(args[1]), json.data(), size) !=
+      size) {
+    fprintf(stderr, "Failed to write the JSON output.\n");
+    return 1;
+  }
+  return 0;
+}
@@ -6,6 +6,13 @@
 
 #include <errno.h>
 
+#include "build/build_config.h"
+
+#if defined(OS_POSIX)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 #include "base/file_util.h"
 #include "base/files/memory_mapped_file.h"
 #include "base/logging.h"
@@ -204,6 +211,22 @@ base::RefCountedStaticMemory* DataPack::GetStaticMemory(
   return new base::RefCountedStaticMemory(piece.data(), piece.length());
 }
 
+void DataPack::PrefetchResource(uint16 resource_id) const {
+#if defined(OS_POSIX)
+  base::StringPiece piece;
+  if (!GetStringPiece(resource_id, &piece) || piece.empty())
+    return;
+
+  // The whole pack is a single mapping, so ask the kernel to read ahead just
+  // the pages of this resource. madvise() needs a page aligned start.
+  const uintptr_t page_mask = sysconf(_SC_PAGESIZE) - 1;
+  const uintptr_t begin = reinterpret_cast<uintptr_t>(piece.data());
+  const uintptr_t aligned_begin = begin & ~page_mask;
+  madvise(reinterpret_cast<void*>(aligned_begin),
+          begin + piece.size() - aligned_begin, MADV_WILLNEED);
+#endif
+}
+
 ResourceHandle::TextEncodingType DataPack::GetTextEncodingType() const {
   return text_encoding_type_;
 }
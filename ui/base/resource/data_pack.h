@@ -52,6 +52,7 @@ class UI_BASE_EXPORT DataPack : public ResourceHandle {
                               base::StringPiece* data) const OVERRIDE;
   virtual base::RefCountedStaticMemory* GetStaticMemory(
       uint16 resource_id) const OVERRIDE;
+  virtual void PrefetchResource(uint16 resource_id) const OVERRIDE;
   virtual TextEncodingType GetTextEncodingType() const OVERRIDE;
   virtual ui::ScaleFactor GetScaleFactor() const OVERRIDE;
 
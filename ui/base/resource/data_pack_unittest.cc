@@ -89,6 +89,26 @@ TEST(DataPackTest, LoadFromFile) {
   ASSERT_FALSE(pack.GetStringPiece(140, &data));
 }
 
+// Prefetching only hints the kernel, so the data reads the same afterwards.
+TEST(DataPackTest, PrefetchResource) {
+  base::ScopedTempDir dir;
+  ASSERT_TRUE(dir.CreateUniqueTempDir());
+  base::FilePath data_path = dir.path().Append(FILE_PATH_LITERAL("sample.pak"));
+  ASSERT_EQ(base::WriteFile(data_path, kSamplePakContents, kSamplePakSize),
+            static_cast<int>(kSamplePakSize));
+
+  DataPack pack(SCALE_FACTOR_100P);
+  ASSERT_TRUE(pack.LoadFromPath(data_path));
+
+  pack.PrefetchResource(4);
+  pack.PrefetchResource(1);  // Zero-length.
+  pack.PrefetchResource(140);  // Missing.
+
+  base::StringPiece data;
+  ASSERT_TRUE(pack.GetStringPiece(4, &data));
+  EXPECT_EQ("this is id 4", data);
+}
+
 INSTANTIATE_TEST_CASE_P(WriteBINARY, DataPackTest, ::testing::Values(
     DataPack::BINARY));
 INSTANTIATE_TEST_CASE_P(WriteUTF8, DataPackTest, ::testing::Values(
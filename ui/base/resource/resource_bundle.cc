@@ -7,9 +7,11 @@
 #include <vector>
 
 #include "base/big_endian.h"
+#include "base/bind.h"
 #include "base/command_line.h"
 #include "base/file_util.h"
 #include "base/files/file.h"
+#include "base/location.h"
 #include "base/logging.h"
 #include "base/memory/ref_counted_memory.h"
 #include "base/metrics/histogram.h"
@@ -18,6 +20,8 @@
 #include "base/strings/string_piece.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/synchronization/lock.h"
+#include "base/task_runner.h"
+#include "base/time/time.h"
 #include "build/build_config.h"
 #include "grit/app_locale_settings.h"
 #include "skia/ext/image_operations.h"
@@ -104,8 +108,12 @@ class ResourceBundle::ResourceBundleImageSource : public gfx::ImageSkiaSource {
     SkBitmap image;
     bool fell_back_to_1x = false;
     ScaleFactor scale_factor = GetSupportedScaleFactor(scale);
-    bool found = rb_->LoadBitmap(resource_id_, &scale_factor,
+    base::TimeTicks start_time = base::TimeTicks::Now();
+    bool found = rb_->TakePreloadedBitmap(resource_id_, &scale_factor,
+                                          &image, &fell_back_to_1x) ||
+                 rb_->LoadBitmap(resource_id_, &scale_factor,
                                  &image, &fell_back_to_1x);
+    rb_->RecordImageDecodeTime(base::TimeTicks::Now() - start_time);
     if (!found)
       return gfx::ImageSkiaRep();
 
@@ -144,6 +152,22 @@ class ResourceBundle::ResourceBundleImageSource : public gfx::ImageSkiaSource {
   DISALLOW_COPY_AND_ASSIGN(ResourceBundleImageSource);
 };
 
+struct ResourceBundle::PreloadedBitmap {
+  PreloadedBitmap()
+      : decoded(false),
+        scale_factor(SCALE_FACTOR_NONE),
+        fell_back_to_1x(false) {
+  }
+
+  // False while the decode is pending on the task runner.
+  bool decoded;
+
+  // The results of LoadBitmap().
+  ScaleFactor scale_factor;
+  SkBitmap bitmap;
+  bool fell_back_to_1x;
+};
+
 // static
 std::string ResourceBundle::InitSharedInstanceWithLocale(
     const std::string& pref_locale, Delegate* delegate) {
@@ -355,6 +379,12 @@ gfx::Image& ResourceBundle::GetImageNamed(int resource_id) {
 
     float scale = PlatformGetImageScale();
 
+    {
+      base::AutoLock lock_scope(*images_and_fonts_lock_);
+      if (recording_image_loads_)
+        recorded_image_loads_.push_back(resource_id);
+    }
+
     // TODO(oshima): Consider reading the image size from png IHDR chunk and
     // skip decoding here and remove #ifdef below.
     // ResourceBundle::GetSharedInstance() is destroyed after the
@@ -387,6 +417,58 @@ gfx::Image& ResourceBundle::GetNativeImageNamed(int resource_id) {
   return GetNativeImageNamed(resource_id, RTL_DISABLED);
 }
 
+void ResourceBundle::StartRecordingImageLoads() {
+  base::AutoLock lock_scope(*images_and_fonts_lock_);
+  recording_image_loads_ = true;
+  recorded_image_loads_.clear();
+  recorded_decode_time_ = base::TimeDelta();
+}
+
+std::vector<int> ResourceBundle::StopRecordingImageLoads() {
+  std::vector<int> resource_ids;
+  base::TimeDelta decode_time;
+  {
+    base::AutoLock lock_scope(*images_and_fonts_lock_);
+    DCHECK(recording_image_loads_);
+    recording_image_loads_ = false;
+    resource_ids.swap(recorded_image_loads_);
+    decode_time = recorded_decode_time_;
+  }
+  UMA_HISTOGRAM_COUNTS("ResourceBundle.RecordedImageLoads",
+                       resource_ids.size());
+  UMA_HISTOGRAM_TIMES("ResourceBundle.RecordedImageDecodeTime", decode_time);
+  return resource_ids;
+}
+
+void ResourceBundle::PreloadImages(const std::vector<int>& resource_ids,
+                                   base::TaskRunner* task_runner) {
+  // The scale factor ResourceBundleImageSource is first asked for.
+  const ScaleFactor scale_factor =
+      GetSupportedScaleFactor(PlatformGetImageScale());
+  for (size_t i = 0; i < resource_ids.size(); ++i) {
+    const int resource_id = resource_ids[i];
+    {
+      base::AutoLock lock_scope(*images_and_fonts_lock_);
+      const std::pair<int, ScaleFactor> key(resource_id, scale_factor);
+      if (images_.count(resource_id) || preloaded_bitmaps_.count(key))
+        continue;
+      preloaded_bitmaps_[key] = new PreloadedBitmap;
+    }
+
+    for (size_t j = 0; j < data_packs_.size(); ++j) {
+      const ScaleFactor pack_scale_factor = data_packs_[j]->GetScaleFactor();
+      if (pack_scale_factor == scale_factor ||
+          pack_scale_factor == SCALE_FACTOR_NONE) {
+        data_packs_[j]->PrefetchResource(resource_id);
+      }
+    }
+    task_runner->PostTask(FROM_HERE,
+                          base::Bind(&ResourceBundle::PreloadBitmap,
+                                     base::Unretained(this),
+                                     resource_id, scale_factor));
+  }
+}
+
 base::RefCountedStaticMemory* ResourceBundle::LoadDataResourceBytes(
     int resource_id) const {
   return LoadDataResourceBytesForScale(resource_id, ui::SCALE_FACTOR_NONE);
@@ -531,11 +613,13 @@ ResourceBundle::ResourceBundle(Delegate* delegate)
     : delegate_(delegate),
       images_and_fonts_lock_(new base::Lock),
       locale_resources_data_lock_(new base::Lock),
-      max_scale_factor_(SCALE_FACTOR_100P) {
+      max_scale_factor_(SCALE_FACTOR_100P),
+      recording_image_loads_(false) {
 }
 
 ResourceBundle::~ResourceBundle() {
   FreeImages();
+  STLDeleteValues(&preloaded_bitmaps_);
   UnloadLocaleResources();
 }
 
@@ -753,6 +837,56 @@ bool ResourceBundle::LoadBitmap(int resource_id,
   return false;
 }
 
+void ResourceBundle::PreloadBitmap(int resource_id, ScaleFactor scale_factor) {
+  const std::pair<int, ScaleFactor> key(resource_id, scale_factor);
+  {
+    base::AutoLock lock_scope(*images_and_fonts_lock_);
+    if (!preloaded_bitmaps_.count(key))
+      return;
+  }
+
+  scoped_ptr<PreloadedBitmap> preloaded(new PreloadedBitmap);
+  preloaded->scale_factor = scale_factor;
+  preloaded->decoded = LoadBitmap(resource_id, &preloaded->scale_factor,
+                                  &preloaded->bitmap,
+                                  &preloaded->fell_back_to_1x);
+
+  base::AutoLock lock_scope(*images_and_fonts_lock_);
+  PreloadedBitmapMap::iterator it = preloaded_bitmaps_.find(key);
+  if (it == preloaded_bitmaps_.end())
+    return;
+  delete it->second;
+  if (preloaded->decoded)
+    it->second = preloaded.release();
+  else
+    preloaded_bitmaps_.erase(it);
+}
+
+bool ResourceBundle::TakePreloadedBitmap(int resource_id,
+                                         ScaleFactor* scale_factor,
+                                         SkBitmap* bitmap,
+                                         bool* fell_back_to_1x) {
+  base::AutoLock lock_scope(*images_and_fonts_lock_);
+  PreloadedBitmapMap::iterator it =
+      preloaded_bitmaps_.find(std::make_pair(resource_id, *scale_factor));
+  if (it == preloaded_bitmaps_.end())
+    return false;
+  scoped_ptr<PreloadedBitmap> preloaded(it->second);
+  preloaded_bitmaps_.erase(it);
+  if (!preloaded->decoded)
+    return false;
+  *scale_factor = preloaded->scale_factor;
+  bitmap->swap(preloaded->bitmap);
+  *fell_back_to_1x = preloaded->fell_back_to_1x;
+  return true;
+}
+
+void ResourceBundle::RecordImageDecodeTime(base::TimeDelta decode_time) {
+  base::AutoLock lock_scope(*images_and_fonts_lock_);
+  if (recording_image_loads_)
+    recorded_decode_time_ += decode_time;
+}
+
 gfx::Image& ResourceBundle::GetEmptyImage() {
   base::AutoLock lock(*images_and_fonts_lock_);
 
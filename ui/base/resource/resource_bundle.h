@@ -7,6 +7,8 @@
 
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "base/files/file_path.h"
@@ -15,6 +17,7 @@
 #include "base/memory/scoped_vector.h"
 #include "base/strings/string16.h"
 #include "base/strings/string_piece.h"
+#include "base/time/time.h"
 #include "build/build_config.h"
 #include "ui/base/layout.h"
 #include "ui/base/ui_base_export.h"
@@ -28,6 +31,7 @@ namespace base {
 class File;
 class Lock;
 class RefCountedStaticMemory;
+class TaskRunner;
 }
 
 namespace ui {
@@ -204,6 +208,24 @@ class UI_BASE_EXPORT ResourceBundle {
   // Same as GetNativeImageNamed() except that RTL is not enabled.
   gfx::Image& GetNativeImageNamed(int resource_id);
 
+  // Starts recording the ids of the images GetImageNamed() loads from the
+  // data packs, for example until the first browser window has painted.
+  void StartRecordingImageLoads();
+
+  // Stops recording and returns the ids recorded since
+  // StartRecordingImageLoads(), in load order. Reports to UMA how long the
+  // recorded loads spent decoding.
+  std::vector<int> StopRecordingImageLoads();
+
+  // Decodes the images |resource_ids| on |task_runner|, at the scale
+  // GetImageNamed() will ask for, so that GetImageNamed() only has to pick up
+  // the bitmaps. Meant to be called early at startup with the ids recorded
+  // during the previous startup, after the data packs have been added. The
+  // data of the images is prefetched from the packs on the calling thread.
+  // The ResourceBundle must outlive the posted tasks.
+  void PreloadImages(const std::vector<int>& resource_ids,
+                     base::TaskRunner* task_runner);
+
   // Loads the raw bytes of a scale independent data resource.
   base::RefCountedStaticMemory* LoadDataResourceBytes(int resource_id) const;
 
@@ -260,6 +282,7 @@ class UI_BASE_EXPORT ResourceBundle {
   FRIEND_TEST_ALL_PREFIXES(ResourceBundleTest, DelegateGetPathForLocalePack);
   FRIEND_TEST_ALL_PREFIXES(ResourceBundleTest, DelegateGetImageNamed);
   FRIEND_TEST_ALL_PREFIXES(ResourceBundleTest, DelegateGetNativeImageNamed);
+  FRIEND_TEST_ALL_PREFIXES(ResourceBundleImageTest, PreloadImages);
 
   friend class ResourceBundleImageTest;
   friend class ResourceBundleTest;
@@ -267,6 +290,8 @@ class UI_BASE_EXPORT ResourceBundle {
   class ResourceBundleImageSource;
   friend class ResourceBundleImageSource;
 
+  struct PreloadedBitmap;
+
   // Ctor/dtor are private, since we're a singleton.
   explicit ResourceBundle(Delegate* delegate);
   ~ResourceBundle();
@@ -330,6 +355,22 @@ class UI_BASE_EXPORT ResourceBundle {
                   SkBitmap* bitmap,
                   bool* fell_back_to_1x) const;
 
+  // Decodes the image |resource_id| for |scale_factor| into its entry in
+  // |preloaded_bitmaps_|, unless the entry has been taken meanwhile. Runs on
+  // the task runner passed to PreloadImages().
+  void PreloadBitmap(int resource_id, ScaleFactor scale_factor);
+
+  // Like LoadBitmap(), but takes the bitmap preloaded for |resource_id| and
+  // |*scale_factor|. Returns false if there is none or it isn't decoded yet;
+  // in the latter case the preload is cancelled.
+  bool TakePreloadedBitmap(int resource_id,
+                           ScaleFactor* scale_factor,
+                           SkBitmap* bitmap,
+                           bool* fell_back_to_1x);
+
+  // Adds |decode_time| to |recorded_decode_time_| while recording.
+  void RecordImageDecodeTime(base::TimeDelta decode_time);
+
   // Returns true if missing scaled resources should be visually indicated when
   // drawing the fallback (e.g., by tinting the image).
   static bool ShouldHighlightMissingScaledResources();
@@ -372,7 +413,8 @@ class UI_BASE_EXPORT ResourceBundle {
   // be NULL.
   Delegate* delegate_;
 
-  // Protects |images_| and font-related members.
+  // Protects |images_|, |preloaded_bitmaps_|, the recording state and
+  // font-related members.
   scoped_ptr<base::Lock> images_and_fonts_lock_;
 
   // Protects |locale_resources_data_|.
@@ -392,6 +434,18 @@ class UI_BASE_EXPORT ResourceBundle {
 
   gfx::Image empty_image_;
 
+  // Bitmaps requested by PreloadImages(), by resource id and scale factor.
+  // Entries are removed as GetImageNamed() takes them.
+  typedef std::map<std::pair<int, ScaleFactor>, PreloadedBitmap*>
+      PreloadedBitmapMap;
+  PreloadedBitmapMap preloaded_bitmaps_;
+
+  // State of StartRecordingImageLoads(): the ids loaded so far and the time
+  // spent decoding them.
+  bool recording_image_loads_;
+  std::vector<int> recorded_image_loads_;
+  base::TimeDelta recorded_decode_time_;
+
   // The various font lists used. Cached to avoid repeated GDI
   // creation/destruction.
   scoped_ptr<gfx::FontList> base_font_list_;
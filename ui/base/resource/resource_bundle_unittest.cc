@@ -11,7 +11,9 @@
 #include "base/files/scoped_temp_dir.h"
 #include "base/logging.h"
 #include "base/memory/ref_counted_memory.h"
+#include "base/message_loop/message_loop.h"
 #include "base/path_service.h"
+#include "base/run_loop.h"
 #include "base/strings/utf_string_conversions.h"
 #include "grit/ui_resources.h"
 #include "testing/gmock/include/gmock/gmock.h"
@@ -486,6 +488,52 @@ TEST_F(ResourceBundleImageTest, GetImageNamed) {
               scale_factor == ui::SCALE_FACTOR_200P);
 }
 
+// Test that GetImageNamed() picks up the bitmaps decoded by PreloadImages(),
+// and that it cancels preloads that haven't run yet.
+TEST_F(ResourceBundleImageTest, PreloadImages) {
+  std::vector<ScaleFactor> supported_factors;
+  supported_factors.push_back(SCALE_FACTOR_100P);
+  test::ScopedSetSupportedScaleFactors scoped_supported(supported_factors);
+  base::MessageLoop message_loop;
+  base::FilePath data_path = dir_path().AppendASCII("sample.pak");
+  CreateDataPackWithSingleBitmap(data_path, 10, base::StringPiece());
+
+  ResourceBundle* resource_bundle = CreateResourceBundleWithEmptyLocalePak();
+  resource_bundle->AddDataPackFromPath(data_path, SCALE_FACTOR_100P);
+  std::vector<int> resource_ids(1, 3);
+
+  // A preload that has run hands over its bitmap.
+  resource_bundle->PreloadImages(resource_ids,
+                                 message_loop.message_loop_proxy().get());
+  EXPECT_EQ(1u, resource_bundle->preloaded_bitmaps_.size());
+  base::RunLoop().RunUntilIdle();
+  ScaleFactor scale_factor = SCALE_FACTOR_100P;
+  SkBitmap bitmap;
+  bool fell_back_to_1x = true;
+  EXPECT_TRUE(resource_bundle->TakePreloadedBitmap(3, &scale_factor, &bitmap,
+                                                   &fell_back_to_1x));
+  EXPECT_EQ(SCALE_FACTOR_100P, scale_factor);
+  EXPECT_EQ(10, bitmap.width());
+  EXPECT_FALSE(fell_back_to_1x);
+  EXPECT_TRUE(resource_bundle->preloaded_bitmaps_.empty());
+
+  // A pending preload is cancelled by the load it was meant for.
+  resource_bundle->PreloadImages(resource_ids,
+                                 message_loop.message_loop_proxy().get());
+  resource_bundle->StartRecordingImageLoads();
+  gfx::ImageSkia* image_skia = resource_bundle->GetImageSkiaNamed(3);
+  EXPECT_EQ(10, image_skia->width());
+  EXPECT_EQ(resource_ids, resource_bundle->StopRecordingImageLoads());
+  EXPECT_TRUE(resource_bundle->preloaded_bitmaps_.empty());
+  base::RunLoop().RunUntilIdle();
+  EXPECT_TRUE(resource_bundle->preloaded_bitmaps_.empty());
+
+  // Loaded images aren't preloaded again.
+  resource_bundle->PreloadImages(resource_ids,
+                                 message_loop.message_loop_proxy().get());
+  EXPECT_TRUE(resource_bundle->preloaded_bitmaps_.empty());
+}
+
 // Test that GetImageNamed() behaves properly for images which GRIT has
 // annotated as having fallen back to 1x.
 TEST_F(ResourceBundleImageTest, GetImageNamedFallback1x) {
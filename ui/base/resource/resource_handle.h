@@ -41,6 +41,10 @@ class UI_BASE_EXPORT ResourceHandle {
   virtual base::RefCountedStaticMemory* GetStaticMemory(
       uint16 resource_id) const = 0;
 
+  // Hints that resource |resource_id| is about to be read, so that its data
+  // can be paged in ahead of use. The default implementation does nothing.
+  virtual void PrefetchResource(uint16 resource_id) const {}
+
   // Get the encoding type of text resources.
   virtual TextEncodingType GetTextEncodingType() const = 0;
 
@@ -80,39 +80,6 @@ class TransformTransition : public LayerAnimationElement {
   DISALLOW_COPY_AND_ASSIGN(TransformTransition);
 };
 
-// InterpolatedTransformTransition ---------------------------------------------
-
-class InterpolatedTransformTransition : public LayerAnimationElement {
- public:
-  InterpolatedTransformTransition(InterpolatedTransform* interpolated_transform,
-                                  base::TimeDelta duration)
-      : LayerAnimationElement(TRANSFORM, duration),
-        interpolated_transform_(interpolated_transform) {
-  }
-  virtual ~InterpolatedTransformTransition() {}
-
- protected:
-  virtual void OnStart(LayerAnimationDelegate* delegate) OVERRIDE {
-  }
-
-  virtual bool OnProgress(double t, LayerAnimationDelegate* delegate) OVERRIDE {
-    delegate->SetTransformFromAnimation(
-        interpolated_transform_->Interpolate(static_cast<float>(t)));
-    return true;
-  }
-
-  virtual void OnGetTarget(TargetValue* target) const OVERRIDE {
-    target->transform = interpolated_transform_->Interpolate(1.0f);
-  }
-
-  virtual void OnAbort(LayerAnimationDelegate* delegate) OVERRIDE {}
-
- private:
-  scoped_ptr<InterpolatedTransform> interpolated_transform_;
-
-  DISALLOW_COPY_AND_ASSIGN(InterpolatedTransformTransition);
-};
-
 // BoundsTransition ------------------------------------------------------------
 
 class BoundsTransition : public LayerAnimationElement {
@@ -497,6 +464,71 @@ class ThreadedTransformTransition : public ThreadedLayerAnimationElement {
   DISALLOW_COPY_AND_ASSIGN(ThreadedTransformTransition);
 };
 
+// ThreadedInterpolatedTransformTransition -------------------------------------
+
+// Runs an InterpolatedTransform, such as the rotations and scales about a
+// pivot of the window animations, on the compositor thread, so that a busy UI
+// thread doesn't make it stutter.
+class ThreadedInterpolatedTransformTransition
+    : public ThreadedLayerAnimationElement {
+ public:
+  ThreadedInterpolatedTransformTransition(
+      InterpolatedTransform* interpolated_transform,
+      base::TimeDelta duration)
+      : ThreadedLayerAnimationElement(TRANSFORM, duration),
+        interpolated_transform_(
+            new SharedInterpolatedTransform(interpolated_transform)),
+        device_scale_factor_(1.0f) {
+  }
+  virtual ~ThreadedInterpolatedTransformTransition() {}
+
+ protected:
+  virtual void OnStart(LayerAnimationDelegate* delegate) OVERRIDE {
+    device_scale_factor_ = delegate->GetDeviceScaleFactor();
+  }
+
+  virtual void OnAbort(LayerAnimationDelegate* delegate) OVERRIDE {
+    if (delegate && Started()) {
+      ThreadedLayerAnimationElement::OnAbort(delegate);
+      delegate->SetTransformFromAnimation(Interpolate(
+          gfx::Tween::CalculateValue(tween_type(),
+                                     last_progressed_fraction())));
+    }
+  }
+
+  virtual void OnEnd(LayerAnimationDelegate* delegate) OVERRIDE {
+    delegate->SetTransformFromAnimation(Interpolate(1.0));
+  }
+
+  virtual scoped_ptr<cc::Animation> CreateCCAnimation() OVERRIDE {
+    scoped_ptr<cc::AnimationCurve> animation_curve(
+        new InterpolatedTransformCurveAdapter(tween_type(),
+                                              interpolated_transform_,
+                                              device_scale_factor_,
+                                              duration()));
+    scoped_ptr<cc::Animation> animation(
+        cc::Animation::Create(animation_curve.Pass(),
+                              animation_id(),
+                              animation_group_id(),
+                              cc::Animation::Transform));
+    return animation.Pass();
+  }
+
+  virtual void OnGetTarget(TargetValue* target) const OVERRIDE {
+    target->transform = Interpolate(1.0);
+  }
+
+ private:
+  gfx::Transform Interpolate(double t) const {
+    return interpolated_transform_->get().Interpolate(static_cast<float>(t));
+  }
+
+  scoped_refptr<SharedInterpolatedTransform> interpolated_transform_;
+  float device_scale_factor_;
+
+  DISALLOW_COPY_AND_ASSIGN(ThreadedInterpolatedTransformTransition);
+};
+
 // InverseTransformTransision --------------------------------------------------
 
 class InverseTransformTransition : public ThreadedLayerAnimationElement {
@@ -813,7 +845,8 @@ LayerAnimationElement*
 LayerAnimationElement::CreateInterpolatedTransformElement(
     InterpolatedTransform* interpolated_transform,
     base::TimeDelta duration) {
-  return new InterpolatedTransformTransition(interpolated_transform, duration);
+  return new ThreadedInterpolatedTransformTransition(interpolated_transform,
+                                                     duration);
 }
 
 // static
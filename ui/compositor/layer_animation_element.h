@@ -91,7 +91,8 @@ class COMPOSITOR_EXPORT LayerAnimationElement {
   // existing transform. That is, it does not interpolate between the existing
   // transform and the last value the interpolated transform will assume. It is
   // therefore important that the value of the interpolated at time 0 matches
-  // the current transform.
+  // the current transform. The element runs on the compositor thread, so the
+  // interpolated transform must not be modified once the element is created.
   static LayerAnimationElement* CreateInterpolatedTransformElement(
       InterpolatedTransform* interpolated_transform,
       base::TimeDelta duration);
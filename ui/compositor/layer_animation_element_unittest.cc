@@ -13,6 +13,7 @@
 #include "ui/compositor/scoped_animation_duration_scale_mode.h"
 #include "ui/compositor/test/test_layer_animation_delegate.h"
 #include "ui/compositor/test/test_utils.h"
+#include "ui/gfx/interpolated_transform.h"
 #include "ui/gfx/rect.h"
 #include "ui/gfx/transform.h"
 
@@ -431,6 +432,52 @@ TEST(LayerAnimationElementTest, AbortTransformElement) {
                           delegate.GetTransformForAnimation());
 }
 
+// Check that the interpolated transform element runs on the compositor thread
+// and updates the delegate when it ends or is aborted.
+TEST(LayerAnimationElementTest, InterpolatedTransformElement) {
+  TestLayerAnimationDelegate delegate;
+  InterpolatedRotation rotation(-30.0f, 30.0f);
+  base::TimeTicks start_time;
+  base::TimeTicks effective_start_time;
+  base::TimeDelta delta = base::TimeDelta::FromSeconds(1);
+  scoped_ptr<LayerAnimationElement> element(
+      LayerAnimationElement::CreateInterpolatedTransformElement(
+          new InterpolatedRotation(-30.0f, 30.0f), delta));
+  EXPECT_TRUE(element->IsThreaded());
+
+  gfx::Tween::Type tween_type = gfx::Tween::EASE_IN;
+  element->set_tween_type(tween_type);
+
+  for (int i = 0; i < 2; ++i) {
+    delegate.SetTransformFromAnimation(rotation.Interpolate(0.0f));
+    start_time = effective_start_time + delta;
+    element->set_requested_start_time(start_time);
+    element->Start(&delegate, 1);
+    element->Progress(start_time, &delegate);
+    effective_start_time = start_time + delta;
+    element->set_effective_start_time(effective_start_time);
+    element->Progress(effective_start_time + delta/2, &delegate);
+    EXPECT_FLOAT_EQ(0.5, element->last_progressed_fraction());
+
+    if (i == 0) {
+      // Aborting leaves the layer where the compositor thread had it.
+      element->Abort(&delegate);
+      CheckApproximatelyEqual(
+          rotation.Interpolate(static_cast<float>(
+              gfx::Tween::CalculateValue(tween_type, 0.5))),
+          delegate.GetTransformForAnimation());
+    } else {
+      element->Progress(effective_start_time + delta, &delegate);
+      CheckApproximatelyEqual(rotation.Interpolate(1.0f),
+                              delegate.GetTransformForAnimation());
+    }
+  }
+
+  LayerAnimationElement::TargetValue target_value(&delegate);
+  element->GetTargetValue(&target_value);
+  CheckApproximatelyEqual(rotation.Interpolate(1.0f), target_value.transform);
+}
+
 } // namespace
 
 } // namespace ui
@@ -4,6 +4,9 @@
 
 #include "ui/compositor/transform_animation_curve_adapter.h"
 
+#include "ui/compositor/layer.h"
+#include "ui/gfx/interpolated_transform.h"
+
 namespace ui {
 
 TransformAnimationCurveAdapter::TransformAnimationCurveAdapter(
@@ -110,4 +113,59 @@ bool InverseTransformCurveAdapter::AnimatedBoundsForBox(
   return false;
 }
 
+SharedInterpolatedTransform::SharedInterpolatedTransform(
+    InterpolatedTransform* interpolated_transform)
+    : interpolated_transform_(interpolated_transform) {
+}
+
+SharedInterpolatedTransform::~SharedInterpolatedTransform() {
+}
+
+InterpolatedTransformCurveAdapter::InterpolatedTransformCurveAdapter(
+    gfx::Tween::Type tween_type,
+    scoped_refptr<SharedInterpolatedTransform> interpolated_transform,
+    float device_scale_factor,
+    base::TimeDelta duration)
+    : tween_type_(tween_type),
+      interpolated_transform_(interpolated_transform),
+      device_scale_factor_(device_scale_factor),
+      duration_(duration) {
+}
+
+InterpolatedTransformCurveAdapter::~InterpolatedTransformCurveAdapter() {
+}
+
+double InterpolatedTransformCurveAdapter::Duration() const {
+  return duration_.InSecondsF();
+}
+
+scoped_ptr<cc::AnimationCurve>
+InterpolatedTransformCurveAdapter::Clone() const {
+  scoped_ptr<InterpolatedTransformCurveAdapter> to_return(
+      new InterpolatedTransformCurveAdapter(tween_type_,
+                                            interpolated_transform_,
+                                            device_scale_factor_,
+                                            duration_));
+  return to_return.PassAs<cc::AnimationCurve>();
+}
+
+gfx::Transform InterpolatedTransformCurveAdapter::GetValue(double t) const {
+  double progress = 1.0;
+  if (t <= 0.0)
+    progress = 0.0;
+  else if (t < duration_.InSecondsF())
+    progress = t / duration_.InSecondsF();
+
+  return Layer::ConvertTransformToCCTransform(
+      interpolated_transform_->get().Interpolate(static_cast<float>(
+          gfx::Tween::CalculateValue(tween_type_, progress))),
+      device_scale_factor_);
+}
+
+bool InterpolatedTransformCurveAdapter::AnimatedBoundsForBox(
+    const gfx::BoxF& box,
+    gfx::BoxF* bounds) const {
+  return false;
+}
+
 }  // namespace ui
@@ -5,6 +5,8 @@
 #ifndef UI_COMPOSITOR_TRANSFORM_ANIMATION_CURVE_ADAPTER_H_
 #define UI_COMPOSITOR_TRANSFORM_ANIMATION_CURVE_ADAPTER_H_
 
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/time/time.h"
 #include "cc/animation/animation_curve.h"
 #include "ui/compositor/compositor_export.h"
@@ -14,6 +16,8 @@
 
 namespace ui {
 
+class InterpolatedTransform;
+
 class COMPOSITOR_EXPORT TransformAnimationCurveAdapter
     : public cc::TransformAnimationCurve {
  public:
@@ -66,6 +70,57 @@ class COMPOSITOR_EXPORT InverseTransformCurveAdapter
   DISALLOW_ASSIGN(InverseTransformCurveAdapter);
 };
 
+// An InterpolatedTransform shared by the UI thread and the copies of a curve
+// on the compositor thread. It must not be modified once shared.
+class COMPOSITOR_EXPORT SharedInterpolatedTransform
+    : public base::RefCountedThreadSafe<SharedInterpolatedTransform> {
+ public:
+  // Takes ownership of |interpolated_transform|.
+  explicit SharedInterpolatedTransform(
+      InterpolatedTransform* interpolated_transform);
+
+  const InterpolatedTransform& get() const { return *interpolated_transform_; }
+
+ private:
+  friend class base::RefCountedThreadSafe<SharedInterpolatedTransform>;
+
+  ~SharedInterpolatedTransform();
+
+  scoped_ptr<InterpolatedTransform> interpolated_transform_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedInterpolatedTransform);
+};
+
+// Evaluates an InterpolatedTransform, such as a rotation about a pivot, on the
+// compositor thread. The values are converted to the coordinate space of the
+// cc layer, as Layer::SetTransform() does.
+class COMPOSITOR_EXPORT InterpolatedTransformCurveAdapter
+    : public cc::TransformAnimationCurve {
+ public:
+  InterpolatedTransformCurveAdapter(
+      gfx::Tween::Type tween_type,
+      scoped_refptr<SharedInterpolatedTransform> interpolated_transform,
+      float device_scale_factor,
+      base::TimeDelta duration);
+
+  virtual ~InterpolatedTransformCurveAdapter();
+
+  // TransformAnimationCurve implementation.
+  virtual double Duration() const OVERRIDE;
+  virtual scoped_ptr<AnimationCurve> Clone() const OVERRIDE;
+  virtual gfx::Transform GetValue(double t) const OVERRIDE;
+  virtual bool AnimatedBoundsForBox(const gfx::BoxF& box,
+                                    gfx::BoxF* bounds) const OVERRIDE;
+
+ private:
+  gfx::Tween::Type tween_type_;
+  scoped_refptr<SharedInterpolatedTransform> interpolated_transform_;
+  float device_scale_factor_;
+  base::TimeDelta duration_;
+
+  DISALLOW_ASSIGN(InterpolatedTransformCurveAdapter);
+};
+
 }  // namespace ui
 
 #endif  // UI_COMPOSITOR_TRANSFORM_ANIMATION_CURVE_ADAPTER_H_
@@ -8,7 +8,9 @@
 
 #include "base/time/time.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "ui/compositor/layer.h"
 #include "ui/compositor/test/test_utils.h"
+#include "ui/gfx/interpolated_transform.h"
 
 namespace ui {
 
@@ -54,6 +56,44 @@ TEST(InverseTransformCurveAdapterTest, InversesTransform) {
   }
 }
 
+// Check that the interpolated transform curve and its clones follow the
+// tweened interpolated transform, in the coordinate space of the cc layer.
+TEST(InterpolatedTransformCurveAdapterTest, FollowsInterpolatedTransform) {
+  const float kDeviceScaleFactor = 2.0f;
+  base::TimeDelta duration = base::TimeDelta::FromSeconds(2);
+  InterpolatedTransformAboutPivot expected(
+      gfx::Point(10, 20), new InterpolatedRotation(-30.0f, 30.0f));
+
+  InterpolatedTransformCurveAdapter curve(
+      gfx::Tween::EASE_IN,
+      new SharedInterpolatedTransform(new InterpolatedTransformAboutPivot(
+          gfx::Point(10, 20), new InterpolatedRotation(-30.0f, 30.0f))),
+      kDeviceScaleFactor,
+      duration);
+  scoped_ptr<cc::AnimationCurve> clone(curve.Clone());
+  EXPECT_DOUBLE_EQ(2.0, clone->Duration());
+
+  static const int kSteps = 10;
+  for (int i = 0; i <= kSteps; ++i) {
+    std::ostringstream message;
+    message << "Step " << i << " of " << kSteps;
+    SCOPED_TRACE(message.str());
+    double progress = static_cast<double>(i) / kSteps;
+    gfx::Transform expected_transform = Layer::ConvertTransformToCCTransform(
+        expected.Interpolate(static_cast<float>(
+            gfx::Tween::CalculateValue(gfx::Tween::EASE_IN, progress))),
+        kDeviceScaleFactor);
+    double t = progress * duration.InSecondsF();
+    CheckApproximatelyEqual(expected_transform, curve.GetValue(t));
+    CheckApproximatelyEqual(expected_transform,
+                            clone->ToTransformAnimationCurve()->GetValue(t));
+  }
+
+  // Times outside the curve clamp to its ends.
+  CheckApproximatelyEqual(curve.GetValue(0.0), curve.GetValue(-1.0));
+  CheckApproximatelyEqual(curve.GetValue(2.0), curve.GetValue(3.0));
+}
+
 } // namespace
 
 } // namespace ui
@@ -128,6 +128,9 @@ class PngDecoderState {
   // Set to true when we've found the end of the data.
   bool done;
 
+  // Told about each row as it is written to |bitmap|, if not null.
+  PNGCodec::IncrementalDecoder::RowCallback row_callback;
+
  private:
   DISALLOW_COPY_AND_ASSIGN(PngDecoderState);
 };
@@ -279,6 +282,9 @@ void DecodeInfoCallback(png_struct* png_ptr, png_info* info_ptr) {
     state->bitmap->setConfig(SkBitmap::kARGB_8888_Config,
                              state->width, state->height);
     state->bitmap->allocPixels();
+    // Rows may be looked at before they are decoded.
+    if (!state->row_callback.is_null())
+      state->bitmap->eraseARGB(0, 0, 0, 0);
   } else if (state->output) {
     state->output->resize(
         state->width * state->output_channels * state->height);
@@ -306,6 +312,9 @@ void DecodeRowCallback(png_struct* png_ptr, png_byte* new_row,
 
   unsigned char* dest = &base[state->width * state->output_channels * row_num];
   png_progressive_combine_row(png_ptr, dest, new_row);
+
+  if (!state->row_callback.is_null())
+    state->row_callback.Run(static_cast<int>(row_num), pass);
 }
 
 void DecodeEndCallback(png_struct* png_ptr, png_info* info) {
@@ -438,39 +447,94 @@ bool PNGCodec::Decode(const unsigned char* input, size_t input_size,
 bool PNGCodec::Decode(const unsigned char* input, size_t input_size,
                       SkBitmap* bitmap) {
   DCHECK(bitmap);
-  png_struct* png_ptr = NULL;
-  png_info* info_ptr = NULL;
-  if (!BuildPNGStruct(input, input_size, &png_ptr, &info_ptr))
-    return false;
+  IncrementalDecoder decoder(bitmap, IncrementalDecoder::RowCallback());
+  return decoder.AppendData(input, input_size) && decoder.done();
+}
 
-  PngReadStructDestroyer destroyer(&png_ptr, &info_ptr);
-  if (setjmp(png_jmpbuf(png_ptr))) {
-    // The destroyer will ensure that the structures are cleaned up in this
-    // case, even though we may get here as a jump from random parts of the
-    // PNG library called below.
-    return false;
+// Holds the libpng structs, which can't be declared in the header.
+class PNGCodec::IncrementalDecoder::State {
+ public:
+  State(SkBitmap* bitmap, const RowCallback& row_callback)
+      : decoder_state(bitmap),
+        png_ptr(NULL),
+        info_ptr(NULL),
+        failed(false) {
+    decoder_state.row_callback = row_callback;
   }
 
-  PngDecoderState state(bitmap);
+  ~State() {
+    if (png_ptr)
+      png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+  }
 
-  png_set_progressive_read_fn(png_ptr, &state, &DecodeInfoCallback,
-                              &DecodeRowCallback, &DecodeEndCallback);
-  png_process_data(png_ptr,
-                   info_ptr,
-                   const_cast<unsigned char*>(input),
-                   input_size);
+  PngDecoderState decoder_state;
+  png_struct* png_ptr;
+  png_info* info_ptr;
 
-  if (!state.done) {
+  // Set when libpng has reported an error.
+  bool failed;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(State);
+};
+
+PNGCodec::IncrementalDecoder::IncrementalDecoder(
+    SkBitmap* bitmap,
+    const RowCallback& row_callback)
+    : state_(new State(bitmap, row_callback)) {
+  DCHECK(bitmap);
+  state_->png_ptr =
+      png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+  if (state_->png_ptr)
+    state_->info_ptr = png_create_info_struct(state_->png_ptr);
+  if (!state_->info_ptr) {
+    state_->failed = true;
+    return;
+  }
+
+  // libpng checks the signature itself when it is fed the first bytes.
+  png_set_error_fn(state_->png_ptr, NULL, LogLibPNGDecodeError,
+                   LogLibPNGDecodeWarning);
+  png_set_progressive_read_fn(state_->png_ptr, &state_->decoder_state,
+                              &DecodeInfoCallback, &DecodeRowCallback,
+                              &DecodeEndCallback);
+}
+
+PNGCodec::IncrementalDecoder::~IncrementalDecoder() {
+}
+
+bool PNGCodec::IncrementalDecoder::AppendData(const unsigned char* data,
+                                              size_t size) {
+  if (state_->failed)
+    return false;
+  if (done())
+    return true;  // Ignore anything after the end of the image.
+
+  if (setjmp(png_jmpbuf(state_->png_ptr))) {
+    // We get here as a jump from random parts of the PNG library called
+    // below. The structures are cleaned up along with |state_|.
+    state_->failed = true;
     return false;
   }
 
-  // Set the bitmap's opaqueness based on what we saw.
-  bitmap->setAlphaType(state.is_opaque ?
-                       kOpaque_SkAlphaType : kPremul_SkAlphaType);
+  png_process_data(state_->png_ptr,
+                   state_->info_ptr,
+                   const_cast<unsigned char*>(data),
+                   size);
 
+  if (done()) {
+    // Set the bitmap's opaqueness based on what we saw.
+    state_->decoder_state.bitmap->setAlphaType(
+        state_->decoder_state.is_opaque ? kOpaque_SkAlphaType
+                                        : kPremul_SkAlphaType);
+  }
   return true;
 }
 
+bool PNGCodec::IncrementalDecoder::done() const {
+  return state_->decoder_state.done;
+}
+
 // Encoder --------------------------------------------------------------------
 //
 // This section of the code is based on nsPNGEncoder.cpp in Mozilla
@@ -482,13 +546,21 @@ namespace {
 // to write data.
 struct PngEncoderState {
   explicit PngEncoderState(std::vector<unsigned char>* o) : out(o) {}
+  explicit PngEncoderState(const PNGCodec::WriteCallback& c)
+      : out(NULL), callback(c) {}
+
+  // Exactly one of these is set.
   std::vector<unsigned char>* out;
+  PNGCodec::WriteCallback callback;
 };
 
 // Called by libpng to flush its internal buffer to ours.
 void EncoderWriteCallback(png_structp png, png_bytep data, png_size_t size) {
   PngEncoderState* state = static_cast<PngEncoderState*>(png_get_io_ptr(png));
-  DCHECK(state->out);
+  if (!state->out) {
+    state->callback.Run(data, size);
+    return;
+  }
 
   size_t old_size = state->out->size();
   state->out->resize(old_size + size);
@@ -637,7 +709,7 @@ bool EncodeWithCompressionLevel(const unsigned char* input,
                                 bool discard_transparency,
                                 const std::vector<PNGCodec::Comment>& comments,
                                 int compression_level,
-                                std::vector<unsigned char>* output) {
+                                PngEncoderState* state) {
   // Run to convert an input row into the output row format, NULL means no
   // conversion is necessary.
   FormatConverter converter = NULL;
@@ -722,10 +794,7 @@ bool EncodeWithCompressionLevel(const unsigned char* input,
     return false;
   destroyer.SetInfoStruct(&info_ptr);
 
-  output->clear();
-
-  PngEncoderState state(output);
-  bool success = DoLibpngWrite(png_ptr, info_ptr, &state,
+  bool success = DoLibpngWrite(png_ptr, info_ptr, state,
                                size.width(), size.height(), row_byte_width,
                                input, compression_level, png_output_color_type,
                                output_color_components, converter, comments);
@@ -736,7 +805,7 @@ bool EncodeWithCompressionLevel(const unsigned char* input,
 bool InternalEncodeSkBitmap(const SkBitmap& input,
                             bool discard_transparency,
                             int compression_level,
-                            std::vector<unsigned char>* output) {
+                            PngEncoderState* state) {
   if (input.empty() || input.isNull())
     return false;
   int bpp = input.bytesPerPixel();
@@ -754,7 +823,7 @@ bool InternalEncodeSkBitmap(const SkBitmap& input,
       discard_transparency,
       std::vector<PNGCodec::Comment>(),
       compression_level,
-      output);
+      state);
 }
 
 
@@ -768,6 +837,8 @@ bool PNGCodec::Encode(const unsigned char* input,
                       bool discard_transparency,
                       const std::vector<Comment>& comments,
                       std::vector<unsigned char>* output) {
+  output->clear();
+  PngEncoderState state(output);
   return EncodeWithCompressionLevel(input,
                                     format,
                                     size,
@@ -775,36 +846,54 @@ bool PNGCodec::Encode(const unsigned char* input,
                                     discard_transparency,
                                     comments,
                                     Z_DEFAULT_COMPRESSION,
-                                    output);
+                                    &state);
 }
 
 // static
 bool PNGCodec::EncodeBGRASkBitmap(const SkBitmap& input,
                                   bool discard_transparency,
                                   std::vector<unsigned char>* output) {
+  output->clear();
+  PngEncoderState state(output);
   return InternalEncodeSkBitmap(input,
                                 discard_transparency,
                                 Z_DEFAULT_COMPRESSION,
-                                output);
+                                &state);
+}
+
+// static
+bool PNGCodec::EncodeBGRASkBitmap(const SkBitmap& input,
+                                  bool discard_transparency,
+                                  const WriteCallback& callback) {
+  DCHECK(!callback.is_null());
+  PngEncoderState state(callback);
+  return InternalEncodeSkBitmap(input,
+                                discard_transparency,
+                                Z_DEFAULT_COMPRESSION,
+                                &state);
 }
 
 // static
 bool PNGCodec::EncodeA8SkBitmap(const SkBitmap& input,
                                 std::vector<unsigned char>* output) {
+  output->clear();
+  PngEncoderState state(output);
   return InternalEncodeSkBitmap(input,
                                 false,
                                 Z_DEFAULT_COMPRESSION,
-                                output);
+                                &state);
 }
 
 // static
 bool PNGCodec::FastEncodeBGRASkBitmap(const SkBitmap& input,
                                       bool discard_transparency,
                                       std::vector<unsigned char>* output) {
+  output->clear();
+  PngEncoderState state(output);
   return InternalEncodeSkBitmap(input,
                                 discard_transparency,
                                 Z_BEST_SPEED,
-                                output);
+                                &state);
 }
 
 PNGCodec::Comment::Comment(const std::string& k, const std::string& t)
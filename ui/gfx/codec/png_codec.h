@@ -9,6 +9,8 @@
 #include <vector>
 
 #include "base/basictypes.h"
+#include "base/callback.h"
+#include "base/memory/scoped_ptr.h"
 #include "ui/gfx/gfx_export.h"
 
 class SkBitmap;
@@ -53,6 +55,40 @@ class GFX_EXPORT PNGCodec {
     std::string text;
   };
 
+  // Receives encoded PNG data as it is produced, see EncodeBGRASkBitmap().
+  typedef base::Callback<void(const unsigned char* data, size_t size)>
+      WriteCallback;
+
+  // Decodes PNG data into an SkBitmap as it arrives, for instance while it is
+  // being read or downloaded. Rows are written straight into the bitmap's
+  // pixels, which are allocated once the header has been read.
+  class GFX_EXPORT IncrementalDecoder {
+   public:
+    // Called each time |row| of the bitmap has been written. Interlaced
+    // images are decoded in seven passes, numbered by |pass|, each of which
+    // fills in more of the pixels of some of the rows; the pixels that are
+    // still missing are transparent. Other images have a single pass 0.
+    typedef base::Callback<void(int row, int pass)> RowCallback;
+
+    // |row_callback| may be null.
+    IncrementalDecoder(SkBitmap* bitmap, const RowCallback& row_callback);
+    ~IncrementalDecoder();
+
+    // Decodes the next |size| bytes of the PNG. Returns false if the data is
+    // not a PNG or is corrupted, after which the decoder is unusable.
+    bool AppendData(const unsigned char* data, size_t size);
+
+    // Returns true once the whole image has been decoded. The bitmap's alpha
+    // type is only set at that point.
+    bool done() const;
+
+   private:
+    class State;
+    scoped_ptr<State> state_;
+
+    DISALLOW_COPY_AND_ASSIGN(IncrementalDecoder);
+  };
+
   // Encodes the given raw 'input' data, with each pixel being represented as
   // given in 'format'. The encoded PNG data will be written into the supplied
   // vector and true will be returned on success. On failure (false), the
@@ -87,6 +123,13 @@ class GFX_EXPORT PNGCodec {
                                  bool discard_transparency,
                                  std::vector<unsigned char>* output);
 
+  // Same as the above, but the encoded data is passed to |callback| in pieces
+  // as it is produced rather than collected into a vector, so that it can be
+  // written out without keeping a second copy of the image in memory.
+  static bool EncodeBGRASkBitmap(const SkBitmap& input,
+                                 bool discard_transparency,
+                                 const WriteCallback& callback);
+
   // Call PNGCodec::Encode on the supplied SkBitmap |input|. The difference
   // between this and the previous method is that this restricts compression to
   // zlib q1, which is just rle encoding.
@@ -121,7 +164,7 @@ class GFX_EXPORT PNGCodec {
   // megabyte, and those require a 7-10 megabyte side buffer.)
   //
   // Returns true if data is non-null and can be decoded as a png, false
-  // otherwise.
+  // otherwise. Use IncrementalDecoder to decode data that arrives in pieces.
   static bool Decode(const unsigned char* input, size_t input_size,
                      SkBitmap* bitmap);
 
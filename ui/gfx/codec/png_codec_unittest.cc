@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <cmath>
 
+#include "base/bind.h"
 #include "base/logging.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "third_party/libpng/png.h"
@@ -265,6 +266,17 @@ void MakeTestBGRASkBitmap(int w, int h, SkBitmap* bmp) {
     src_data[i] = SkPreMultiplyARGB(i % 255, i % 250, i % 245, i % 240);
 }
 
+void AppendEncodedData(std::vector<unsigned char>* encoded,
+                       const unsigned char* data,
+                       size_t size) {
+  encoded->insert(encoded->end(), data, data + size);
+}
+
+void CountDecodedRow(std::vector<int>* rows_per_pass, int row, int pass) {
+  ASSERT_LT(pass, static_cast<int>(rows_per_pass->size()));
+  ++(*rows_per_pass)[pass];
+}
+
 void MakeTestA8SkBitmap(int w, int h, SkBitmap* bmp) {
   bmp->setConfig(SkBitmap::kA8_Config, w, h);
   bmp->allocPixels();
@@ -1187,4 +1199,106 @@ TEST(PNGCodec, EncodeDecodeWithVaryingCompressionLevels) {
 }
 
 
+TEST(PNGCodec, EncodeBGRASkBitmapToCallback) {
+  const int w = 20, h = 20;
+
+  SkBitmap original_bitmap;
+  MakeTestBGRASkBitmap(w, h, &original_bitmap);
+
+  std::vector<unsigned char> encoded;
+  ASSERT_TRUE(PNGCodec::EncodeBGRASkBitmap(original_bitmap, false, &encoded));
+
+  // The pieces given to the callback make up the same PNG.
+  std::vector<unsigned char> streamed;
+  ASSERT_TRUE(PNGCodec::EncodeBGRASkBitmap(
+      original_bitmap, false, base::Bind(&AppendEncodedData, &streamed)));
+  EXPECT_EQ(encoded, streamed);
+}
+
+TEST(PNGCodec, IncrementalDecode) {
+  const int w = 20, h = 20;
+
+  std::vector<unsigned char> original;
+  MakeRGBAImage(w, h, true, &original);
+  std::vector<unsigned char> encoded;
+  ASSERT_TRUE(EncodeImage(original,
+                          w, h,
+                          COLOR_TYPE_RGBA,
+                          &encoded,
+                          PNG_INTERLACE_NONE));
+
+  SkBitmap expected_bitmap;
+  ASSERT_TRUE(PNGCodec::Decode(&encoded.front(), encoded.size(),
+                               &expected_bitmap));
+
+  // Feed the data a few bytes at a time.
+  SkBitmap decoded_bitmap;
+  std::vector<int> rows_per_pass(7);
+  PNGCodec::IncrementalDecoder decoder(
+      &decoded_bitmap, base::Bind(&CountDecodedRow, &rows_per_pass));
+  const size_t kChunkSize = 7;
+  for (size_t i = 0; i < encoded.size(); i += kChunkSize) {
+    EXPECT_FALSE(decoder.done());
+    ASSERT_TRUE(decoder.AppendData(
+        &encoded[i], std::min(kChunkSize, encoded.size() - i)));
+  }
+  EXPECT_TRUE(decoder.done());
+
+  EXPECT_EQ(h, rows_per_pass[0]);
+  EXPECT_TRUE(BitmapsAreEqual(decoded_bitmap, expected_bitmap));
+  EXPECT_EQ(expected_bitmap.alphaType(), decoded_bitmap.alphaType());
+}
+
+TEST(PNGCodec, IncrementalDecodeInterlaced) {
+  const int w = 20, h = 20;
+
+  std::vector<unsigned char> original;
+  MakeRGBImage(w, h, &original);
+  std::vector<unsigned char> encoded;
+  ASSERT_TRUE(EncodeImage(original,
+                          w, h,
+                          COLOR_TYPE_RGB,
+                          &encoded,
+                          PNG_INTERLACE_ADAM7));
+
+  SkBitmap expected_bitmap;
+  ASSERT_TRUE(PNGCodec::Decode(&encoded.front(), encoded.size(),
+                               &expected_bitmap));
+
+  SkBitmap decoded_bitmap;
+  std::vector<int> rows_per_pass(7);
+  PNGCodec::IncrementalDecoder decoder(
+      &decoded_bitmap, base::Bind(&CountDecodedRow, &rows_per_pass));
+  ASSERT_TRUE(decoder.AppendData(&encoded.front(), encoded.size()));
+  EXPECT_TRUE(decoder.done());
+
+  // Adam7 sends rows 0, 8, 16, ... in the first pass and every other row in
+  // the last one.
+  EXPECT_EQ((h + 7) / 8, rows_per_pass[0]);
+  EXPECT_EQ(h / 2, rows_per_pass[6]);
+  EXPECT_TRUE(BitmapsAreEqual(decoded_bitmap, expected_bitmap));
+}
+
+TEST(PNGCodec, IncrementalDecodeCorrupted) {
+  const int w = 20, h = 20;
+
+  std::vector<unsigned char> original;
+  MakeRGBImage(w, h, &original);
+
+  SkBitmap decoded_bitmap;
+  PNGCodec::IncrementalDecoder decoder(
+      &decoded_bitmap, PNGCodec::IncrementalDecoder::RowCallback());
+  EXPECT_FALSE(decoder.AppendData(&original.front(), original.size()));
+  EXPECT_FALSE(decoder.done());
+
+  // Once it has failed, the decoder rejects any more data.
+  std::vector<unsigned char> encoded;
+  ASSERT_TRUE(EncodeImage(original,
+                          w, h,
+                          COLOR_TYPE_RGB,
+                          &encoded,
+                          PNG_INTERLACE_NONE));
+  EXPECT_FALSE(decoder.AppendData(&encoded.front(), encoded.size()));
+}
+
 }  // namespace gfx
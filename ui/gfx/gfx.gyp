@@ -517,6 +517,25 @@
     }
   ],
   'conditions': [
+    ['OS=="win" or use_pango==1', {
+      'targets': [
+        {
+          'target_name': 'gfx_perftests',
+          'type': 'executable',
+          'sources': [
+            'render_text_perftest.cc',
+          ],
+          'dependencies': [
+            '<(DEPTH)/base/base.gyp:base',
+            '<(DEPTH)/base/base.gyp:run_all_unittests',
+            '<(DEPTH)/base/base.gyp:test_support_base',
+            '<(DEPTH)/testing/gtest.gyp:gtest',
+            '<(DEPTH)/testing/perf/perf_test.gyp:perf_test',
+            'gfx',
+          ],
+        },
+      ],
+    }],
     ['OS=="android"' , {
      'targets': [
        {
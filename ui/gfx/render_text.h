@@ -163,6 +163,14 @@ class GFX_EXPORT RenderText {
   // Creates a platform-specific RenderText instance.
   static RenderText* CreateInstance();
 
+  // Returns the number of layouts that found their shaped text in, and that
+  // added it to, the process-wide cache of shaped text. The cache is shared
+  // by all instances on the UI thread. Platforms without one report zeros.
+  static void GetShapingCacheStats(size_t* hits, size_t* misses);
+
+  // Empties the process-wide cache of shaped text and resets its counts.
+  static void ClearShapingCacheForTesting();
+
   const base::string16& text() const { return text_; }
   void SetText(const base::string16& text);
 
@@ -341,4 +341,13 @@ RenderText* RenderText::CreateInstance() {
   return new RenderTextMac;
 }
 
+void RenderText::GetShapingCacheStats(size_t* hits, size_t* misses) {
+  // CoreText lines are not cached.
+  *hits = 0;
+  *misses = 0;
+}
+
+void RenderText::ClearShapingCacheForTesting() {
+}
+
 }  // namespace gfx
@@ -10,4 +10,12 @@ RenderText* RenderText::CreateInstance() {
   return NULL;
 }
 
+void RenderText::GetShapingCacheStats(size_t* hits, size_t* misses) {
+  *hits = 0;
+  *misses = 0;
+}
+
+void RenderText::ClearShapingCacheForTesting() {
+}
+
 }  // namespace gfx
@@ -9,8 +9,12 @@
 #include <string>
 #include <vector>
 
+#include "base/containers/mru_cache.h"
+#include "base/format_macros.h"
 #include "base/i18n/break_iterator.h"
 #include "base/logging.h"
+#include "base/strings/stringprintf.h"
+#include "base/strings/utf_string_conversions.h"
 #include "third_party/skia/include/core/SkTypeface.h"
 #include "ui/gfx/canvas.h"
 #include "ui/gfx/font.h"
@@ -61,6 +65,37 @@ void SetPangoUnderlineMetrics(PangoFontDescription *desc,
                                 PANGO_PIXELS(position));
 }
 
+// The number of shaped layouts kept by LayoutCache.
+const size_t kLayoutCacheSize = 256;
+
+// Drops the cache's reference to an evicted layout.
+class LayoutUnrefDeletor {
+ public:
+  void operator()(PangoLayout*& layout) {
+    g_object_unref(layout);
+  }
+};
+
+// A process-wide cache of shaped layouts, keyed by everything that goes into
+// them; see RenderTextPango::GetLayoutCacheKey(). Tab strips and omnibox
+// popups lay out the same strings over and over. Layouts are never modified
+// once set up, so instances with equal keys share one.
+struct LayoutCache {
+  typedef base::MRUCacheBase<std::string, PangoLayout*, LayoutUnrefDeletor>
+      Layouts;
+
+  LayoutCache() : layouts(kLayoutCacheSize), hits(0), misses(0) {}
+
+  Layouts layouts;
+  size_t hits;
+  size_t misses;
+};
+
+LayoutCache* GetLayoutCache() {
+  CR_DEFINE_STATIC_LOCAL(LayoutCache, layout_cache, ());
+  return &layout_cache;
+}
+
 }  // namespace
 
 // TODO(xji): index saved in upper layer is utf16 index. Pango uses utf8 index.
@@ -301,7 +336,18 @@ void RenderTextPango::ResetLayout() {
 }
 
 void RenderTextPango::EnsureLayout() {
-  if (layout_ == NULL) {
+  if (layout_ != NULL)
+    return;
+
+  LayoutCache* cache = GetLayoutCache();
+  const std::string cache_key = GetLayoutCacheKey();
+  LayoutCache::Layouts::iterator cached = cache->layouts.Get(cache_key);
+  if (cached != cache->layouts.end()) {
+    ++cache->hits;
+    layout_ = cached->second;
+    g_object_ref(layout_);
+  } else {
+    ++cache->misses;
     cairo_surface_t* surface =
         cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 0, 0);
     CHECK_EQ(CAIRO_STATUS_SUCCESS, cairo_surface_status(surface));
@@ -327,16 +373,49 @@ void RenderTextPango::EnsureLayout() {
     // TODO(xji): If RenderText will be used for displaying purpose, such as
     // label, we will need to remove the single-line-mode setting.
     pango_layout_set_single_paragraph_mode(layout_, true);
-
-    layout_text_ = pango_layout_get_text(layout_);
     SetupPangoAttributes(layout_);
 
-    current_line_ = pango_layout_get_line_readonly(layout_, 0);
-    CHECK_NE(static_cast<PangoLayoutLine*>(NULL), current_line_);
-    pango_layout_line_ref(current_line_);
+    g_object_ref(layout_);
+    cache->layouts.Put(cache_key, layout_);
+  }
+
+  layout_text_ = pango_layout_get_text(layout_);
+
+  current_line_ = pango_layout_get_line_readonly(layout_, 0);
+  CHECK_NE(static_cast<PangoLayoutLine*>(NULL), current_line_);
+  pango_layout_line_ref(current_line_);
 
-    pango_layout_get_log_attrs(layout_, &log_attrs_, &num_log_attrs_);
+  pango_layout_get_log_attrs(layout_, &log_attrs_, &num_log_attrs_);
+}
+
+std::string RenderTextPango::GetLayoutCacheKey() {
+  // The text comes first and is the only part that may contain NULs.
+  std::string key = base::UTF16ToUTF8(GetLayoutText());
+  key.push_back('\0');
+  key.append(font_list().GetFontDescriptionString());
+  base::StringAppendF(&key, "|%d|%d", GetTextDirection(),
+                      Canvas::DefaultCanvasTextAlignment());
+
+  // The bold and italic breaks become font attributes in
+  // SetupPangoAttributes().
+  const BreakList<bool>& bold = styles()[BOLD];
+  for (BreakList<bool>::const_iterator it = bold.breaks().begin();
+       it != bold.breaks().end(); ++it) {
+    base::StringAppendF(&key, "|b%" PRIuS ":%d", it->first, it->second);
   }
+  const BreakList<bool>& italic = styles()[ITALIC];
+  for (BreakList<bool>::const_iterator it = italic.breaks().begin();
+       it != italic.breaks().end(); ++it) {
+    base::StringAppendF(&key, "|i%" PRIuS ":%d", it->first, it->second);
+  }
+
+  // SetupPangoLayout() derives the layout's font options from these.
+  const FontRenderParams& params = GetDefaultFontRenderParams();
+  base::StringAppendF(&key, "|%d%d%d%d%d%d", params.antialiasing,
+                      params.subpixel_positioning, params.autohinter,
+                      params.use_bitmaps, params.hinting,
+                      params.subpixel_rendering);
+  return key;
 }
 
 void RenderTextPango::SetupPangoAttributes(PangoLayout* layout) {
@@ -530,4 +609,17 @@ RenderText* RenderText::CreateInstance() {
   return new RenderTextPango;
 }
 
+void RenderText::GetShapingCacheStats(size_t* hits, size_t* misses) {
+  const LayoutCache* cache = GetLayoutCache();
+  *hits = cache->hits;
+  *misses = cache->misses;
+}
+
+void RenderText::ClearShapingCacheForTesting() {
+  LayoutCache* cache = GetLayoutCache();
+  cache->layouts.Clear();
+  cache->hits = 0;
+  cache->misses = 0;
+}
+
 }  // namespace gfx
@@ -6,6 +6,7 @@
 #define UI_GFX_RENDER_TEXT_PANGO_H_
 
 #include <pango/pango.h>
+#include <string>
 #include <vector>
 
 #include "ui/gfx/render_text.h"
@@ -58,6 +59,10 @@ class RenderTextPango : public RenderText {
   // Setup pango attribute: foreground, background, font, strike.
   void SetupPangoAttributes(PangoLayout* layout);
 
+  // Returns the key of |layout_| in the process-wide layout cache: the layout
+  // text, fonts, bold and italic ranges, direction and font render params.
+  std::string GetLayoutCacheKey();
+
   // Append one pango attribute |pango_attr| into pango attribute list |attrs|.
   void AppendPangoAttribute(size_t start,
                             size_t end,
@@ -0,0 +1,88 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/scoped_ptr.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "ui/gfx/font_list.h"
+#include "ui/gfx/rect.h"
+#include "ui/gfx/render_text.h"
+
+namespace gfx {
+
+namespace {
+
+const int kTabCount = 20;
+const int kRelayoutCount = 50;
+
+// Tab titles, some of them shared by several tabs, as when many tabs of one
+// site are open.
+const char* const kTabTitles[] = {
+  "New Tab",
+  "Inbox (3) - someone@example.com",
+  "Chromium Code Search",
+  "Issue 123456 - chromium - Crash when dragging a tab out of the window",
+  "\xD7\xA2\xD7\x91\xD7\xA8\xD7\x99\xD7\xAA - Hebrew title",
+  "Loading...",
+  "example.com/a/long/path/that/ends/up/elided/in/a/narrow/tab",
+};
+
+// Lays out the titles of a tab strip of |width| pixels, the way
+// Canvas::DrawStringRect() does: with a new RenderText per title.
+void LayoutTabStrip(const FontList& font_list, int width) {
+  const int tab_width = width / kTabCount;
+  for (int i = 0; i < kTabCount; ++i) {
+    scoped_ptr<RenderText> render_text(RenderText::CreateInstance());
+    render_text->SetFontList(font_list);
+    render_text->SetText(
+        base::UTF8ToUTF16(kTabTitles[i % arraysize(kTabTitles)]));
+    render_text->SetDisplayRect(Rect(0, 0, tab_width, 20));
+    EXPECT_GT(render_text->GetStringSize().width(), 0);
+  }
+}
+
+// Relayouts the tab strip as it shrinks, optionally starting every relayout
+// from an empty shaping cache, and reports the time per relayout and the
+// cache hit rate.
+void RunTabStripRelayout(bool cold_cache) {
+  const FontList font_list("Arial, 13px");
+  RenderText::ClearShapingCacheForTesting();
+  base::TimeDelta elapsed;
+  for (int i = 0; i < kRelayoutCount; ++i) {
+    if (cold_cache)
+      RenderText::ClearShapingCacheForTesting();
+    const base::TimeTicks start = base::TimeTicks::Now();
+    LayoutTabStrip(font_list, 2000 - 10 * i);
+    elapsed += base::TimeTicks::Now() - start;
+  }
+
+  size_t hits = 0;
+  size_t misses = 0;
+  RenderText::GetShapingCacheStats(&hits, &misses);
+  const std::string trace = cold_cache ? "cold" : "warm";
+  perf_test::PrintResult(
+      "tab_strip_relayout", "", trace,
+      elapsed.InMicrosecondsF() / kRelayoutCount, "us", true);
+  if (hits + misses > 0) {
+    perf_test::PrintResult(
+        "tab_strip_shaping_cache_hit_rate", "", trace,
+        100.0 * hits / (hits + misses), "%", true);
+  }
+}
+
+}  // namespace
+
+TEST(RenderTextPerfTest, TabStripRelayout) {
+  scoped_ptr<RenderText> render_text(RenderText::CreateInstance());
+  if (!render_text)
+    return;
+
+  RunTabStripRelayout(true);
+  RunTabStripRelayout(false);
+  RenderText::ClearShapingCacheForTesting();
+}
+
+}  // namespace gfx
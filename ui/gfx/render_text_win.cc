@@ -6,11 +6,13 @@
 
 #include <algorithm>
 
+#include "base/containers/mru_cache.h"
 #include "base/i18n/break_iterator.h"
 #include "base/i18n/char_iterator.h"
 #include "base/i18n/rtl.h"
 #include "base/logging.h"
 #include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/win/windows_version.h"
 #include "third_party/icu/source/common/unicode/uchar.h"
@@ -264,6 +266,111 @@ bool IsUnusualBlockCode(const UBlockCode block_code) {
          block_code == UBLOCK_MISCELLANEOUS_SYMBOLS;
 }
 
+// The number of runs kept by ShapedRunCache.
+const size_t kShapedRunCacheSize = 1024;
+
+// What LayoutVisualText() computes for a run, short of its position, which
+// depends on the neighbouring runs.
+struct ShapedRun {
+  ShapedRun() : glyph_count(0) {
+    memset(&script_analysis, 0, sizeof(script_analysis));
+    memset(&abc_widths, 0, sizeof(abc_widths));
+  }
+
+  Font font;
+  SCRIPT_ANALYSIS script_analysis;
+  int glyph_count;
+  scoped_ptr<WORD[]> glyphs;
+  scoped_ptr<WORD[]> logical_clusters;
+  scoped_ptr<SCRIPT_VISATTR[]> visible_attributes;
+  scoped_ptr<int[]> advance_widths;
+  scoped_ptr<GOFFSET[]> offsets;
+  ABC abc_widths;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(ShapedRun);
+};
+
+// A process-wide cache of shaped runs, keyed by GetShapedRunKey(). Tab strips
+// and omnibox popups lay out the same strings over and over; a hit skips
+// Uniscribe and font fallback for the run.
+struct ShapedRunCache {
+  typedef base::OwningMRUCache<std::string, ShapedRun*> Runs;
+
+  ShapedRunCache() : runs(kShapedRunCacheSize), hits(0), misses(0) {}
+
+  Runs runs;
+  size_t hits;
+  size_t misses;
+};
+
+ShapedRunCache* GetShapedRunCache() {
+  CR_DEFINE_STATIC_LOCAL(ShapedRunCache, shaped_run_cache, ());
+  return &shaped_run_cache;
+}
+
+// Returns the ShapedRunCache key of the itemized, not yet shaped |run|: its
+// |text|, font, style and script analysis, and the font smoothing settings.
+std::string GetShapedRunKey(const internal::TextRun& run,
+                            const wchar_t* text) {
+  bool smoothing_enabled;
+  bool cleartype_enabled;
+  GetCachedFontSmoothingSettings(&smoothing_enabled, &cleartype_enabled);
+  std::string key = base::StringPrintf(
+      "%s|%d|%d|%d|%d%d|", run.font.GetFontName().c_str(),
+      run.font.GetFontSize(), run.font.GetHeight(), run.font_style,
+      smoothing_enabled, cleartype_enabled);
+  key.append(reinterpret_cast<const char*>(&run.script_analysis),
+             sizeof(run.script_analysis));
+  key.append(reinterpret_cast<const char*>(text),
+             run.range.length() * sizeof(wchar_t));
+  return key;
+}
+
+// Copies the first |count| elements of |source| to |dest|.
+template <typename T>
+void CopyArray(const scoped_ptr<T[]>& source,
+               size_t count,
+               scoped_ptr<T[]>* dest) {
+  if (!source) {
+    dest->reset();
+    return;
+  }
+  dest->reset(new T[count]);
+  std::copy(source.get(), source.get() + count, dest->get());
+}
+
+ShapedRun* CreateShapedRun(const internal::TextRun& run) {
+  ShapedRun* shaped_run = new ShapedRun;
+  shaped_run->font = run.font;
+  shaped_run->script_analysis = run.script_analysis;
+  shaped_run->glyph_count = run.glyph_count;
+  CopyArray(run.glyphs, run.glyph_count, &shaped_run->glyphs);
+  CopyArray(run.logical_clusters, run.range.length(),
+            &shaped_run->logical_clusters);
+  CopyArray(run.visible_attributes, run.glyph_count,
+            &shaped_run->visible_attributes);
+  CopyArray(run.advance_widths, run.glyph_count, &shaped_run->advance_widths);
+  CopyArray(run.offsets, run.glyph_count, &shaped_run->offsets);
+  shaped_run->abc_widths = run.abc_widths;
+  return shaped_run;
+}
+
+void ApplyShapedRun(const ShapedRun& shaped_run, internal::TextRun* run) {
+  run->font = shaped_run.font;
+  run->script_analysis = shaped_run.script_analysis;
+  run->glyph_count = shaped_run.glyph_count;
+  CopyArray(shaped_run.glyphs, run->glyph_count, &run->glyphs);
+  CopyArray(shaped_run.logical_clusters, run->range.length(),
+            &run->logical_clusters);
+  CopyArray(shaped_run.visible_attributes, run->glyph_count,
+            &run->visible_attributes);
+  CopyArray(shaped_run.advance_widths, run->glyph_count,
+            &run->advance_widths);
+  CopyArray(shaped_run.offsets, run->glyph_count, &run->offsets);
+  run->abc_widths = shaped_run.abc_widths;
+}
+
 }  // namespace
 
 namespace internal {
@@ -997,35 +1104,26 @@ void RenderTextWin::LayoutVisualText() {
   // ensures that the text baseline does not shift.
   int ascent = font_list().GetBaseline();
   int descent = font_list().GetHeight() - font_list().GetBaseline();
+  ShapedRunCache* cache = GetShapedRunCache();
+  const base::string16& layout_text = GetLayoutText();
   for (size_t i = 0; i < runs_.size(); ++i) {
     internal::TextRun* run = runs_[i];
-    LayoutTextRun(run);
+    const std::string cache_key =
+        GetShapedRunKey(*run, &layout_text[run->range.start()]);
+    ShapedRunCache::Runs::iterator cached = cache->runs.Get(cache_key);
+    if (cached != cache->runs.end()) {
+      ++cache->hits;
+      ApplyShapedRun(*cached->second, run);
+    } else {
+      ++cache->misses;
+      hr = PlaceTextRun(run);
+      if (SUCCEEDED(hr))
+        cache->runs.Put(cache_key, CreateShapedRun(*run));
+    }
 
     ascent = std::max(ascent, run->font.GetBaseline());
     descent = std::max(descent,
                        run->font.GetHeight() - run->font.GetBaseline());
-
-    if (run->glyph_count > 0) {
-      run->advance_widths.reset(new int[run->glyph_count]);
-      // TODO(asvitkine): Temporary instrumentation to debug a double-free
-      // crash where we're seeing these two being equal inexplicably. Hitting
-      // this implies that the malloc book-keeping is corrupt and it returned
-      // the same pointer for two different allocs, which we can debug further.
-      // http://crbug.com/348103
-      CHECK_NE(static_cast<void*>(run->logical_clusters.get()),
-               static_cast<void*>(run->advance_widths.get()));
-      run->offsets.reset(new GOFFSET[run->glyph_count]);
-      hr = ScriptPlace(cached_hdc_,
-                       &run->script_cache,
-                       run->glyphs.get(),
-                       run->glyph_count,
-                       run->visible_attributes.get(),
-                       &(run->script_analysis),
-                       run->advance_widths.get(),
-                       run->offsets.get(),
-                       &(run->abc_widths));
-      DCHECK(SUCCEEDED(hr));
-    }
   }
 
   // Build the array of bidirectional embedding levels.
@@ -1054,6 +1152,33 @@ void RenderTextWin::LayoutVisualText() {
   string_width_ = preceding_run_widths;
 }
 
+HRESULT RenderTextWin::PlaceTextRun(internal::TextRun* run) {
+  LayoutTextRun(run);
+  if (run->glyph_count == 0)
+    return S_OK;
+
+  run->advance_widths.reset(new int[run->glyph_count]);
+  // TODO(asvitkine): Temporary instrumentation to debug a double-free
+  // crash where we're seeing these two being equal inexplicably. Hitting
+  // this implies that the malloc book-keeping is corrupt and it returned
+  // the same pointer for two different allocs, which we can debug further.
+  // http://crbug.com/348103
+  CHECK_NE(static_cast<void*>(run->logical_clusters.get()),
+           static_cast<void*>(run->advance_widths.get()));
+  run->offsets.reset(new GOFFSET[run->glyph_count]);
+  HRESULT hr = ScriptPlace(cached_hdc_,
+                           &run->script_cache,
+                           run->glyphs.get(),
+                           run->glyph_count,
+                           run->visible_attributes.get(),
+                           &(run->script_analysis),
+                           run->advance_widths.get(),
+                           run->offsets.get(),
+                           &(run->abc_widths));
+  DCHECK(SUCCEEDED(hr));
+  return hr;
+}
+
 void RenderTextWin::LayoutTextRun(internal::TextRun* run) {
   const size_t run_length = run->range.length();
   const wchar_t* run_text = &(GetLayoutText()[run->range.start()]);
@@ -1284,4 +1409,17 @@ RenderText* RenderText::CreateInstance() {
   return new RenderTextWin;
 }
 
+void RenderText::GetShapingCacheStats(size_t* hits, size_t* misses) {
+  const ShapedRunCache* cache = GetShapedRunCache();
+  *hits = cache->hits;
+  *misses = cache->misses;
+}
+
+void RenderText::ClearShapingCacheForTesting() {
+  ShapedRunCache* cache = GetShapedRunCache();
+  cache->runs.Clear();
+  cache->hits = 0;
+  cache->misses = 0;
+}
+
 }  // namespace gfx
@@ -95,6 +95,9 @@ class RenderTextWin : public RenderText {
   void LayoutVisualText();
   void LayoutTextRun(internal::TextRun* run);
 
+  // Shapes |run| with LayoutTextRun() and places its glyphs.
+  HRESULT PlaceTextRun(internal::TextRun* run);
+
   // Helper function that calls |ScriptShape()| on the run, which has logic to
   // handle E_OUTOFMEMORY return codes.
   HRESULT ShapeTextRunWithFont(internal::TextRun* run, const Font& font);
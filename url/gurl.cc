@@ -61,17 +61,18 @@ const std::string& EmptyStringForGURL() {
 
 } // namespace
 
-GURL::GURL() : is_valid_(false) {
+GURL::Storage::Storage() : is_valid(false) {
 }
 
-GURL::GURL(const GURL& other)
-    : spec_(other.spec_),
-      is_valid_(other.is_valid_),
-      parsed_(other.parsed_) {
-  if (other.inner_url_)
-    inner_url_.reset(new GURL(*other.inner_url_));
-  // Valid filesystem urls should always have an inner_url_.
-  DCHECK(!is_valid_ || !SchemeIsFileSystem() || inner_url_);
+GURL::Storage::~Storage() {
+}
+
+GURL::GURL() {
+}
+
+GURL::GURL(const GURL& other) : storage_(other.storage_) {
+  // Valid filesystem urls should always have an inner_url.
+  DCHECK(!is_valid() || !SchemeIsFileSystem() || inner_url());
 }
 
 GURL::GURL(const std::string& url_string) {
@@ -87,74 +88,83 @@ GURL::GURL(const std::string& url_string, RetainWhiteSpaceSelector) {
 }
 
 GURL::GURL(const char* canonical_spec, size_t canonical_spec_len,
-           const url_parse::Parsed& parsed, bool is_valid)
-    : spec_(canonical_spec, canonical_spec_len),
-      is_valid_(is_valid),
-      parsed_(parsed) {
+           const url_parse::Parsed& parsed, bool is_valid) {
+  scoped_refptr<Storage> storage(new Storage);
+  storage->spec.assign(canonical_spec, canonical_spec_len);
+  storage->is_valid = is_valid;
+  storage->parsed = parsed;
+  SetStorage(storage.get());
   InitializeFromCanonicalSpec();
 }
 
 GURL::GURL(std::string canonical_spec,
-           const url_parse::Parsed& parsed, bool is_valid)
-    : is_valid_(is_valid),
-      parsed_(parsed) {
-  spec_.swap(canonical_spec);
+           const url_parse::Parsed& parsed, bool is_valid) {
+  scoped_refptr<Storage> storage(new Storage);
+  storage->spec.swap(canonical_spec);
+  storage->is_valid = is_valid;
+  storage->parsed = parsed;
+  SetStorage(storage.get());
   InitializeFromCanonicalSpec();
 }
 
 template<typename STR>
 void GURL::InitCanonical(const STR& input_spec, bool trim_path_end) {
+  scoped_refptr<Storage> storage(new Storage);
+
   // Reserve enough room in the output for the input, plus some extra so that
   // we have room if we have to escape a few things without reallocating.
-  spec_.reserve(input_spec.size() + 32);
-  url_canon::StdStringCanonOutput output(&spec_);
-  is_valid_ = url_util::Canonicalize(
+  storage->spec.reserve(input_spec.size() + 32);
+  url_canon::StdStringCanonOutput output(&storage->spec);
+  storage->is_valid = url_util::Canonicalize(
       input_spec.data(), static_cast<int>(input_spec.length()), trim_path_end,
-      NULL, &output, &parsed_);
+      NULL, &output, &storage->parsed);
 
   output.Complete();  // Must be done before using string.
-  if (is_valid_ && SchemeIsFileSystem()) {
-    inner_url_.reset(new GURL(spec_.data(), parsed_.Length(),
-                              *parsed_.inner_parsed(), true));
-  }
+  SetStorage(storage.get());
 }
 
-void GURL::InitializeFromCanonicalSpec() {
-  if (is_valid_ && SchemeIsFileSystem()) {
-    inner_url_.reset(
-        new GURL(spec_.data(), parsed_.Length(),
-                 *parsed_.inner_parsed(), true));
+void GURL::SetStorage(Storage* storage) {
+  storage_ = storage;
+  if (storage->is_valid && SchemeIsFileSystem()) {
+    storage->inner_url.reset(
+        new GURL(storage->spec.data(), storage->parsed.Length(),
+                 *storage->parsed.inner_parsed(), true));
   }
+}
 
+void GURL::InitializeFromCanonicalSpec() {
 #ifndef NDEBUG
   // For testing purposes, check that the parsed canonical URL is identical to
   // what we would have produced. Skip checking for invalid URLs have no meaning
   // and we can't always canonicalize then reproducabely.
-  if (is_valid_) {
+  const std::string& spec = storage().spec;
+  const url_parse::Parsed& parsed = storage().parsed;
+  if (is_valid()) {
     url_parse::Component scheme;
     // We can't do this check on the inner_url of a filesystem URL, as
     // canonical_spec actually points to the start of the outer URL, so we'd
     // end up with infinite recursion in this constructor.
-    if (!url_util::FindAndCompareScheme(spec_.data(), spec_.length(),
+    if (!url_util::FindAndCompareScheme(spec.data(), spec.length(),
                                         "filesystem", &scheme) ||
-        scheme.begin == parsed_.scheme.begin) {
-      // We need to retain trailing whitespace on path URLs, as the |parsed_|
+        scheme.begin == parsed.scheme.begin) {
+      // We need to retain trailing whitespace on path URLs, as the |parsed|
       // spec we originally received may legitimately contain trailing white-
       // space on the path or  components e.g. if the #ref has been
       // removed from a "foo:hello #ref" URL (see http://crbug.com/291747).
-      GURL test_url(spec_, RETAIN_TRAILING_PATH_WHITEPACE);
-
-      DCHECK(test_url.is_valid_ == is_valid_);
-      DCHECK(test_url.spec_ == spec_);
-
-      DCHECK(test_url.parsed_.scheme == parsed_.scheme);
-      DCHECK(test_url.parsed_.username == parsed_.username);
-      DCHECK(test_url.parsed_.password == parsed_.password);
-      DCHECK(test_url.parsed_.host == parsed_.host);
-      DCHECK(test_url.parsed_.port == parsed_.port);
-      DCHECK(test_url.parsed_.path == parsed_.path);
-      DCHECK(test_url.parsed_.query == parsed_.query);
-      DCHECK(test_url.parsed_.ref == parsed_.ref);
+      GURL test_url(spec, RETAIN_TRAILING_PATH_WHITEPACE);
+      const url_parse::Parsed& test_parsed = test_url.storage().parsed;
+
+      DCHECK(test_url.is_valid() == is_valid());
+      DCHECK(test_url.storage().spec == spec);
+
+      DCHECK(test_parsed.scheme == parsed.scheme);
+      DCHECK(test_parsed.username == parsed.username);
+      DCHECK(test_parsed.password == parsed.password);
+      DCHECK(test_parsed.host == parsed.host);
+      DCHECK(test_parsed.port == parsed.port);
+      DCHECK(test_parsed.path == parsed.path);
+      DCHECK(test_parsed.query == parsed.query);
+      DCHECK(test_parsed.ref == parsed.ref);
     }
   }
 #endif
@@ -169,8 +179,9 @@ GURL& GURL::operator=(GURL other) {
 }
 
 const std::string& GURL::spec() const {
-  if (is_valid_ || spec_.empty())
-    return spec_;
+  const std::string& spec = storage().spec;
+  if (is_valid() || spec.empty())
+    return spec;
 
   DCHECK(false) << "Trying to get the spec of an invalid URL!";
   return EmptyStringForGURL();
@@ -188,32 +199,31 @@ GURL GURL::ResolveWithCharsetConverter(
     const std::string& relative,
     url_canon::CharsetConverter* charset_converter) const {
   // Not allowed for invalid URLs.
-  if (!is_valid_)
+  if (!is_valid())
     return GURL();
 
-  GURL result;
+  const std::string& spec = storage().spec;
+  scoped_refptr<Storage> result(new Storage);
 
   // Reserve enough room in the output for the input, plus some extra so that
   // we have room if we have to escape a few things without reallocating.
-  result.spec_.reserve(spec_.size() + 32);
-  url_canon::StdStringCanonOutput output(&result.spec_);
+  result->spec.reserve(spec.size() + 32);
+  url_canon::StdStringCanonOutput output(&result->spec);
 
   if (!url_util::ResolveRelative(
-          spec_.data(), static_cast<int>(spec_.length()), parsed_,
+          spec.data(), static_cast<int>(spec.length()), storage().parsed,
           relative.data(), static_cast<int>(relative.length()),
-          charset_converter, &output, &result.parsed_)) {
+          charset_converter, &output, &result->parsed)) {
     // Error resolving, return an empty URL.
     return GURL();
   }
 
   output.Complete();
-  result.is_valid_ = true;
-  if (result.SchemeIsFileSystem()) {
-    result.inner_url_.reset(
-        new GURL(result.spec_.data(), result.parsed_.Length(),
-                 *result.parsed_.inner_parsed(), true));
-  }
-  return result;
+  result->is_valid = true;
+
+  GURL url;
+  url.SetStorage(result.get());
+  return url;
 }
 
 // Note: code duplicated above (it's inconvenient to use a template here).
@@ -221,94 +231,93 @@ GURL GURL::ResolveWithCharsetConverter(
     const base::string16& relative,
     url_canon::CharsetConverter* charset_converter) const {
   // Not allowed for invalid URLs.
-  if (!is_valid_)
+  if (!is_valid())
     return GURL();
 
-  GURL result;
+  const std::string& spec = storage().spec;
+  scoped_refptr<Storage> result(new Storage);
 
   // Reserve enough room in the output for the input, plus some extra so that
   // we have room if we have to escape a few things without reallocating.
-  result.spec_.reserve(spec_.size() + 32);
-  url_canon::StdStringCanonOutput output(&result.spec_);
+  result->spec.reserve(spec.size() + 32);
+  url_canon::StdStringCanonOutput output(&result->spec);
 
   if (!url_util::ResolveRelative(
-          spec_.data(), static_cast<int>(spec_.length()), parsed_,
+          spec.data(), static_cast<int>(spec.length()), storage().parsed,
           relative.data(), static_cast<int>(relative.length()),
-          charset_converter, &output, &result.parsed_)) {
+          charset_converter, &output, &result->parsed)) {
     // Error resolving, return an empty URL.
     return GURL();
   }
 
   output.Complete();
-  result.is_valid_ = true;
-  if (result.SchemeIsFileSystem()) {
-    result.inner_url_.reset(
-        new GURL(result.spec_.data(), result.parsed_.Length(),
-                 *result.parsed_.inner_parsed(), true));
-  }
-  return result;
+  result->is_valid = true;
+
+  GURL url;
+  url.SetStorage(result.get());
+  return url;
 }
 
 // Note: code duplicated below (it's inconvenient to use a template here).
 GURL GURL::ReplaceComponents(
     const url_canon::Replacements<char>& replacements) const {
-  GURL result;
-
   // Not allowed for invalid URLs.
-  if (!is_valid_)
+  if (!is_valid())
     return GURL();
 
+  const std::string& spec = storage().spec;
+  scoped_refptr<Storage> result(new Storage);
+
   // Reserve enough room in the output for the input, plus some extra so that
   // we have room if we have to escape a few things without reallocating.
-  result.spec_.reserve(spec_.size() + 32);
-  url_canon::StdStringCanonOutput output(&result.spec_);
+  result->spec.reserve(spec.size() + 32);
+  url_canon::StdStringCanonOutput output(&result->spec);
 
-  result.is_valid_ = url_util::ReplaceComponents(
-      spec_.data(), static_cast<int>(spec_.length()), parsed_, replacements,
-      NULL, &output, &result.parsed_);
+  result->is_valid = url_util::ReplaceComponents(
+      spec.data(), static_cast<int>(spec.length()), storage().parsed,
+      replacements, NULL, &output, &result->parsed);
 
   output.Complete();
-  if (result.is_valid_ && result.SchemeIsFileSystem()) {
-    result.inner_url_.reset(new GURL(spec_.data(), result.parsed_.Length(),
-                                     *result.parsed_.inner_parsed(), true));
-  }
-  return result;
+
+  GURL url;
+  url.SetStorage(result.get());
+  return url;
 }
 
 // Note: code duplicated above (it's inconvenient to use a template here).
 GURL GURL::ReplaceComponents(
     const url_canon::Replacements<base::char16>& replacements) const {
-  GURL result;
-
   // Not allowed for invalid URLs.
-  if (!is_valid_)
+  if (!is_valid())
     return GURL();
 
+  const std::string& spec = storage().spec;
+  scoped_refptr<Storage> result(new Storage);
+
   // Reserve enough room in the output for the input, plus some extra so that
   // we have room if we have to escape a few things without reallocating.
-  result.spec_.reserve(spec_.size() + 32);
-  url_canon::StdStringCanonOutput output(&result.spec_);
+  result->spec.reserve(spec.size() + 32);
+  url_canon::StdStringCanonOutput output(&result->spec);
 
-  result.is_valid_ = url_util::ReplaceComponents(
-      spec_.data(), static_cast<int>(spec_.length()), parsed_, replacements,
-      NULL, &output, &result.parsed_);
+  result->is_valid = url_util::ReplaceComponents(
+      spec.data(), static_cast<int>(spec.length()), storage().parsed,
+      replacements, NULL, &output, &result->parsed);
 
   output.Complete();
-  if (result.is_valid_ && result.SchemeIsFileSystem()) {
-    result.inner_url_.reset(new GURL(spec_.data(), result.parsed_.Length(),
-                                     *result.parsed_.inner_parsed(), true));
-  }
-  return result;
+
+  GURL url;
+  url.SetStorage(result.get());
+  return url;
 }
 
 GURL GURL::GetOrigin() const {
   // This doesn't make sense for invalid or nonstandard URLs, so return
   // the empty URL
-  if (!is_valid_ || !IsStandard())
+  if (!is_valid() || !IsStandard())
     return GURL();
 
   if (SchemeIsFileSystem())
-    return inner_url_->GetOrigin();
+    return inner_url()->GetOrigin();
 
   url_canon::Replacements<char> replacements;
   replacements.ClearUsername();
@@ -321,7 +330,7 @@ GURL GURL::GetOrigin() const {
 }
 
 GURL GURL::GetAsReferrer() const {
-  if (!is_valid_ ||
+  if (!is_valid() ||
       (!has_ref() && !has_username() && !has_password()))
     return GURL(*this);
 
@@ -335,36 +344,45 @@ GURL GURL::GetAsReferrer() const {
 GURL GURL::GetWithEmptyPath() const {
   // This doesn't make sense for invalid or nonstandard URLs, so return
   // the empty URL.
-  if (!is_valid_ || !IsStandard())
+  if (!is_valid() || !IsStandard())
     return GURL();
 
   // We could optimize this since we know that the URL is canonical, and we are
   // appending a canonical path, so avoiding re-parsing.
-  GURL other(*this);
-  if (parsed_.path.len == 0)
-    return other;
+  const url_parse::Parsed& parsed = storage().parsed;
+  if (parsed.path.len == 0)
+    return *this;
+
+  scoped_refptr<Storage> result(new Storage);
+  result->is_valid = true;
+  result->parsed = parsed;
 
   // Clear everything after the path.
-  other.parsed_.query.reset();
-  other.parsed_.ref.reset();
+  result->parsed.query.reset();
+  result->parsed.ref.reset();
 
-  // Set the path, since the path is longer than one, we can just set the
-  // first character and resize.
-  other.spec_[other.parsed_.path.begin] = '/';
-  other.parsed_.path.len = 1;
-  other.spec_.resize(other.parsed_.path.begin + 1);
-  return other;
+  // Set the path, since the path is longer than one, we can just copy
+  // everything before it and append a slash.
+  result->spec.assign(storage().spec, 0, parsed.path.begin);
+  result->spec.push_back('/');
+  result->parsed.path.len = 1;
+
+  GURL url;
+  url.SetStorage(result.get());
+  return url;
 }
 
 bool GURL::IsStandard() const {
-  return url_util::IsStandard(spec_.data(), parsed_.scheme);
+  return url_util::IsStandard(storage().spec.data(), storage().parsed.scheme);
 }
 
 bool GURL::SchemeIs(const char* lower_ascii_scheme) const {
-  if (parsed_.scheme.len <= 0)
+  const std::string& spec = storage().spec;
+  const url_parse::Parsed& parsed = storage().parsed;
+  if (parsed.scheme.len <= 0)
     return lower_ascii_scheme == NULL;
-  return url_util::LowerCaseEqualsASCII(spec_.data() + parsed_.scheme.begin,
-                                        spec_.data() + parsed_.scheme.end(),
+  return url_util::LowerCaseEqualsASCII(spec.data() + parsed.scheme.begin,
+                                        spec.data() + parsed.scheme.end(),
                                         lower_ascii_scheme);
 }
 
@@ -377,47 +395,58 @@ bool GURL::SchemeIsWSOrWSS() const {
 }
 
 int GURL::IntPort() const {
-  if (parsed_.port.is_nonempty())
-    return url_parse::ParsePort(spec_.data(), parsed_.port);
+  const std::string& spec = storage().spec;
+  const url_parse::Parsed& parsed = storage().parsed;
+  if (parsed.port.is_nonempty())
+    return url_parse::ParsePort(spec.data(), parsed.port);
   return url_parse::PORT_UNSPECIFIED;
 }
 
 int GURL::EffectiveIntPort() const {
+  const std::string& spec = storage().spec;
+  const url_parse::Parsed& parsed = storage().parsed;
   int int_port = IntPort();
   if (int_port == url_parse::PORT_UNSPECIFIED && IsStandard())
-    return url_canon::DefaultPortForScheme(spec_.data() + parsed_.scheme.begin,
-                                           parsed_.scheme.len);
+    return url_canon::DefaultPortForScheme(spec.data() + parsed.scheme.begin,
+                                           parsed.scheme.len);
   return int_port;
 }
 
 std::string GURL::ExtractFileName() const {
+  const std::string& spec = storage().spec;
+  const url_parse::Parsed& parsed = storage().parsed;
   url_parse::Component file_component;
-  url_parse::ExtractFileName(spec_.data(), parsed_.path, &file_component);
+  url_parse::ExtractFileName(spec.data(), parsed.path, &file_component);
   return ComponentString(file_component);
 }
 
 std::string GURL::PathForRequest() const {
-  DCHECK(parsed_.path.len > 0) << "Canonical path for requests should be non-empty";
-  if (parsed_.ref.len >= 0) {
+  const std::string& spec = storage().spec;
+  const url_parse::Parsed& parsed = storage().parsed;
+  DCHECK(parsed.path.len > 0)
+      << "Canonical path for requests should be non-empty";
+  if (parsed.ref.len >= 0) {
     // Clip off the reference when it exists. The reference starts after the #
     // sign, so we have to subtract one to also remove it.
-    return std::string(spec_, parsed_.path.begin,
-                       parsed_.ref.begin - parsed_.path.begin - 1);
+    return std::string(spec, parsed.path.begin,
+                       parsed.ref.begin - parsed.path.begin - 1);
   }
   // Compute the actual path length, rather than depending on the spec's
   // terminator.  If we're an inner_url, our spec continues on into our outer
   // url's path/query/ref.
-  int path_len = parsed_.path.len;
-  if (parsed_.query.is_valid())
-    path_len = parsed_.query.end() - parsed_.path.begin;
+  int path_len = parsed.path.len;
+  if (parsed.query.is_valid())
+    path_len = parsed.query.end() - parsed.path.begin;
 
-  return std::string(spec_, parsed_.path.begin, path_len);
+  return std::string(spec, parsed.path.begin, path_len);
 }
 
 std::string GURL::HostNoBrackets() const {
+  const std::string& spec = storage().spec;
+  const url_parse::Parsed& parsed = storage().parsed;
   // If host looks like an IPv6 literal, strip the square brackets.
-  url_parse::Component h(parsed_.host);
-  if (h.len >= 2 && spec_[h.begin] == '[' && spec_[h.end() - 1] == ']') {
+  url_parse::Component h(parsed.host);
+  if (h.len >= 2 && spec[h.begin] == '[' && spec[h.end() - 1] == ']') {
     h.begin++;
     h.len -= 2;
   }
@@ -425,16 +454,19 @@ std::string GURL::HostNoBrackets() const {
 }
 
 std::string GURL::GetContent() const {
-  return is_valid_ ? ComponentString(parsed_.GetContent()) : std::string();
+  return is_valid() ? ComponentString(storage().parsed.GetContent())
+                    : std::string();
 }
 
 bool GURL::HostIsIPAddress() const {
-  if (!is_valid_ || spec_.empty())
+  const std::string& spec = storage().spec;
+  const url_parse::Parsed& parsed = storage().parsed;
+  if (!is_valid() || spec.empty())
      return false;
 
   url_canon::RawCanonOutputT<char, 128> ignored_output;
   url_canon::CanonHostInfo host_info;
-  url_canon::CanonicalizeIPAddress(spec_.c_str(), parsed_.host,
+  url_canon::CanonicalizeIPAddress(spec.c_str(), parsed.host,
                                    &ignored_output, &host_info);
   return host_info.IsIPAddress();
 }
@@ -446,7 +478,8 @@ const GURL& GURL::EmptyGURL() {
   if (!empty_gurl) {
     // Create the string. Be careful that we don't break in the case that this
     // is being called from multiple threads.
-    GURL* new_empty_gurl = new GURL;
+    GURL* new_empty_gurl =
+        new GURL(std::string(), url_parse::Parsed(), false);
     if (InterlockedCompareExchangePointer(
         reinterpret_cast<PVOID*>(&empty_gurl), new_empty_gurl, NULL)) {
       // The old value was non-NULL, so no replacement was done. Another
@@ -460,7 +493,7 @@ const GURL& GURL::EmptyGURL() {
 #else
 
 void EmptyGURLOnce(void) {
-  empty_gurl = new GURL;
+  empty_gurl = new GURL(std::string(), url_parse::Parsed(), false);
 }
 
 const GURL& GURL::EmptyGURL() {
@@ -471,24 +504,33 @@ const GURL& GURL::EmptyGURL() {
 
 #endif  // WIN32
 
+// static
+const GURL::Storage& GURL::EmptyStorage() {
+  // Unlike default-constructed URLs, EmptyGURL() has a storage, which is
+  // never freed.
+  return *EmptyGURL().storage_.get();
+}
+
 bool GURL::DomainIs(const char* lower_ascii_domain,
                     int domain_len) const {
+  const std::string& spec = storage().spec;
+  const url_parse::Parsed& parsed = storage().parsed;
   // Return false if this URL is not valid or domain is empty.
-  if (!is_valid_ || !domain_len)
+  if (!is_valid() || !domain_len)
     return false;
 
-  // FileSystem URLs have empty parsed_.host, so check this first.
-  if (SchemeIsFileSystem() && inner_url_)
-    return inner_url_->DomainIs(lower_ascii_domain, domain_len);
+  // FileSystem URLs have empty parsed.host, so check this first.
+  if (SchemeIsFileSystem() && inner_url())
+    return inner_url()->DomainIs(lower_ascii_domain, domain_len);
 
-  if (!parsed_.host.is_nonempty())
+  if (!parsed.host.is_nonempty())
     return false;
 
   // Check whether the host name is end with a dot. If yes, treat it
   // the same as no-dot unless the input comparison domain is end
   // with dot.
-  const char* last_pos = spec_.data() + parsed_.host.end() - 1;
-  int host_len = parsed_.host.len;
+  const char* last_pos = spec.data() + parsed.host.end() - 1;
+  int host_len = parsed.host.len;
   if ('.' == *last_pos && '.' != lower_ascii_domain[domain_len - 1]) {
     last_pos--;
     host_len--;
@@ -499,7 +541,7 @@ bool GURL::DomainIs(const char* lower_ascii_domain,
     return false;
 
   // Compare this url whether belong specific domain.
-  const char* start_pos = spec_.data() + parsed_.host.begin +
+  const char* start_pos = spec.data() + parsed.host.begin +
                           host_len - domain_len;
 
   if (!url_util::LowerCaseEqualsASCII(start_pos,
@@ -519,10 +561,7 @@ bool GURL::DomainIs(const char* lower_ascii_domain,
 }
 
 void GURL::Swap(GURL* other) {
-  spec_.swap(other->spec_);
-  std::swap(is_valid_, other->is_valid_);
-  std::swap(parsed_, other->parsed_);
-  inner_url_.swap(other->inner_url_);
+  storage_.swap(other->storage_);
 }
 
 std::ostream& operator<<(std::ostream& out, const GURL& url) {
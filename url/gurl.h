@@ -8,6 +8,7 @@
 #include <iosfwd>
 #include <string>
 
+#include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/strings/string16.h"
 #include "url/url_canon.h"
@@ -15,6 +16,8 @@
 #include "url/url_export.h"
 #include "url/url_parse.h"
 
+class GURLInterner;
+
 class URL_EXPORT GURL {
  public:
   typedef url_canon::StdStringReplacements<std::string> Replacements;
@@ -23,8 +26,8 @@ class URL_EXPORT GURL {
   // Creates an empty, invalid URL.
   GURL();
 
-  // Copy construction is relatively inexpensive, with most of the time going
-  // to reallocating the string. It does not re-parse.
+  // Copies share the spec and components of |other|, which are immutable, so
+  // copy construction only takes a reference. It does not re-parse.
   GURL(const GURL& other);
 
   // The narrow version requires the input be UTF-8. Invalid UTF-8 input will
@@ -61,14 +64,14 @@ class URL_EXPORT GURL {
   // "reasonable looking" so that the user can see how it's busted if
   // displayed to them.
   bool is_valid() const {
-    return is_valid_;
+    return storage().is_valid;
   }
 
   // Returns true if the URL is zero-length. Note that empty URLs are also
   // invalid, and is_valid() will return false for them. This is provided
   // because some users may want to treat the empty case differently.
   bool is_empty() const {
-    return spec_.empty();
+    return storage().spec.empty();
   }
 
   // Returns the raw spec, i.e., the full text of the URL, in canonical UTF-8,
@@ -94,7 +97,7 @@ class URL_EXPORT GURL {
   //
   // The returned string is guaranteed to be valid UTF-8.
   const std::string& possibly_invalid_spec() const {
-    return spec_;
+    return storage().spec;
   }
 
   // Getter for the raw parsed structure. This allows callers to locate parts
@@ -106,23 +109,24 @@ class URL_EXPORT GURL {
   // SURE YOU ARE USING possibly_invalid_spec() to get the spec, and that you
   // don't do anything "important" with invalid specs.
   const url_parse::Parsed& parsed_for_possibly_invalid_spec() const {
-    return parsed_;
+    return storage().parsed;
   }
 
   // Defiant equality operator!
   bool operator==(const GURL& other) const {
-    return spec_ == other.spec_;
+    return storage_.get() == other.storage_.get() ||
+           storage().spec == other.storage().spec;
   }
   bool operator!=(const GURL& other) const {
-    return spec_ != other.spec_;
+    return storage().spec != other.storage().spec;
   }
 
   // Allows GURL to used as a key in STL (for example, a std::set or std::map).
   bool operator<(const GURL& other) const {
-    return spec_ < other.spec_;
+    return storage().spec < other.storage().spec;
   }
   bool operator>(const GURL& other) const {
-    return spec_ > other.spec_;
+    return storage().spec > other.storage().spec;
   }
 
   // Resolves a URL that's possibly relative to this object's URL, and returns
@@ -248,31 +252,31 @@ class URL_EXPORT GURL {
   // Getters for various components of the URL. The returned string will be
   // empty if the component is empty or is not present.
   std::string scheme() const {  // Not including the colon. See also SchemeIs.
-    return ComponentString(parsed_.scheme);
+    return ComponentString(storage().parsed.scheme);
   }
   std::string username() const {
-    return ComponentString(parsed_.username);
+    return ComponentString(storage().parsed.username);
   }
   std::string password() const {
-    return ComponentString(parsed_.password);
+    return ComponentString(storage().parsed.password);
   }
   // Note that this may be a hostname, an IPv4 address, or an IPv6 literal
   // surrounded by square brackets, like "[2001:db8::1]".  To exclude these
   // brackets, use HostNoBrackets() below.
   std::string host() const {
-    return ComponentString(parsed_.host);
+    return ComponentString(storage().parsed.host);
   }
   std::string port() const {  // Returns -1 if "default"
-    return ComponentString(parsed_.port);
+    return ComponentString(storage().parsed.port);
   }
   std::string path() const {  // Including first slash following host
-    return ComponentString(parsed_.path);
+    return ComponentString(storage().parsed.path);
   }
   std::string query() const {  // Stuff following '?'
-    return ComponentString(parsed_.query);
+    return ComponentString(storage().parsed.query);
   }
   std::string ref() const {  // Stuff following '#'
-    return ComponentString(parsed_.ref);
+    return ComponentString(storage().parsed.ref);
   }
 
   // Existance querying. These functions will return true if the corresponding
@@ -280,31 +284,31 @@ class URL_EXPORT GURL {
   // being nonempty. http://www.google.com/? has a query that just happens to
   // be empty, and has_query() will return true.
   bool has_scheme() const {
-    return parsed_.scheme.len >= 0;
+    return storage().parsed.scheme.len >= 0;
   }
   bool has_username() const {
-    return parsed_.username.len >= 0;
+    return storage().parsed.username.len >= 0;
   }
   bool has_password() const {
-    return parsed_.password.len >= 0;
+    return storage().parsed.password.len >= 0;
   }
   bool has_host() const {
     // Note that hosts are special, absense of host means length 0.
-    return parsed_.host.len > 0;
+    return storage().parsed.host.len > 0;
   }
   bool has_port() const {
-    return parsed_.port.len >= 0;
+    return storage().parsed.port.len >= 0;
   }
   bool has_path() const {
     // Note that http://www.google.com/" has a path, the path is "/". This can
     // return false only for invalid or nonstandard URLs.
-    return parsed_.path.len >= 0;
+    return storage().parsed.path.len >= 0;
   }
   bool has_query() const {
-    return parsed_.query.len >= 0;
+    return storage().parsed.query.len >= 0;
   }
   bool has_ref() const {
-    return parsed_.ref.len >= 0;
+    return storage().parsed.ref.len >= 0;
   }
 
   // Returns a parsed version of the port. Can also be any of the special
@@ -359,7 +363,7 @@ class URL_EXPORT GURL {
   // Returns the inner URL of a nested URL [currently only non-null for
   // filesystem: URLs].
   const GURL* inner_url() const {
-    return inner_url_.get();
+    return storage().inner_url.get();
   }
 
  private:
@@ -376,26 +380,51 @@ class URL_EXPORT GURL {
 
   void InitializeFromCanonicalSpec();
 
+  friend class GURLInterner;
+
+  // The parsed URL. It is never modified once a GURL refers to it, so copies
+  // of a GURL share it, and it can be shared across threads.
+  struct URL_EXPORT Storage : public base::RefCountedThreadSafe<Storage> {
+    Storage();
+
+    // The actual text of the URL, in canonical ASCII form.
+    std::string spec;
+
+    // Set when the given URL is valid. Otherwise, we may still have a spec and
+    // components, but they may not identify valid resources (for example, an
+    // invalid port number, invalid characters in the scheme, etc.).
+    bool is_valid;
+
+    // Identified components of the canonical spec.
+    url_parse::Parsed parsed;
+
+    // Used for nested schemes [currently only filesystem:].
+    scoped_ptr<GURL> inner_url;
+
+   private:
+    friend class base::RefCountedThreadSafe<Storage>;
+    ~Storage();
+  };
+
+  // Returns the storage of this URL, or of the empty URL if there is none.
+  const Storage& storage() const {
+    return storage_.get() ? *storage_.get() : EmptyStorage();
+  }
+  static const Storage& EmptyStorage();
+
+  // Sets |storage|, which must not be modified afterwards, as the storage of
+  // this URL, and creates the inner URL of filesystem: URLs.
+  void SetStorage(Storage* storage);
+
   // Returns the substring of the input identified by the given component.
   std::string ComponentString(const url_parse::Component& comp) const {
     if (comp.len <= 0)
       return std::string();
-    return std::string(spec_, comp.begin, comp.len);
+    return std::string(storage().spec, comp.begin, comp.len);
   }
 
-  // The actual text of the URL, in canonical ASCII form.
-  std::string spec_;
-
-  // Set when the given URL is valid. Otherwise, we may still have a spec and
-  // components, but they may not identify valid resources (for example, an
-  // invalid port number, invalid characters in the scheme, etc.).
-  bool is_valid_;
-
-  // Identified components of the canonical spec.
-  url_parse::Parsed parsed_;
-
-  // Used for nested schemes [currently only filesystem:].
-  scoped_ptr<GURL> inner_url_;
+  // NULL for the empty URL, so that default construction doesn't allocate.
+  scoped_refptr<const Storage> storage_;
 
   // TODO bug 684583: Add encoding for query params.
 };
@@ -0,0 +1,29 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "url/gurl_interner.h"
+
+GURLInterner::GURLInterner() {
+}
+
+GURLInterner::~GURLInterner() {
+}
+
+GURL GURLInterner::Intern(const GURL& url) {
+  // The components of valid URLs follow from their spec, so equal specs can
+  // share everything. Invalid URLs may have arbitrary components.
+  if (!url.is_valid())
+    return url;
+  return *urls_.insert(url).first;
+}
+
+void GURLInterner::Purge() {
+  std::set<GURL>::iterator i = urls_.begin();
+  while (i != urls_.end()) {
+    if (i->storage_->HasOneRef())
+      urls_.erase(i++);
+    else
+      ++i;
+  }
+}
@@ -0,0 +1,42 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef URL_GURL_INTERNER_H_
+#define URL_GURL_INTERNER_H_
+
+#include <set>
+
+#include "base/basictypes.h"
+#include "url/gurl.h"
+#include "url/url_export.h"
+
+// Copies of a GURL share its spec and components. GURLInterner extends this to
+// GURLs that were parsed separately, for containers that keep many URLs alive
+// which are often equal, such as URLs loaded from a database: interning them
+// keeps a single copy of each spec, and makes comparing them cheap.
+//
+// The interner keeps a reference to every URL it returned, until Purge() finds
+// that nothing else uses it. It is not thread-safe.
+class URL_EXPORT GURLInterner {
+ public:
+  GURLInterner();
+  ~GURLInterner();
+
+  // Returns a GURL equal to |url|, which shares its storage with the GURLs
+  // previously returned for the same spec. Invalid URLs are returned as is.
+  GURL Intern(const GURL& url);
+
+  // Forgets the URLs that are only referenced by this interner.
+  void Purge();
+
+  // Returns the number of distinct URLs held by this interner.
+  size_t size() const { return urls_.size(); }
+
+ private:
+  std::set<GURL> urls_;
+
+  DISALLOW_COPY_AND_ASSIGN(GURLInterner);
+};
+
+#endif  // URL_GURL_INTERNER_H_
@@ -0,0 +1,58 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+#include "url/gurl_interner.h"
+
+namespace {
+
+TEST(GURLInternerTest, SharesEqualURLs) {
+  GURLInterner interner;
+
+  GURL url1("http://www.google.com/foo");
+  GURL url2("http://www.google.com/foo");
+  ASSERT_NE(&url1.possibly_invalid_spec(), &url2.possibly_invalid_spec());
+
+  GURL interned1 = interner.Intern(url1);
+  GURL interned2 = interner.Intern(url2);
+  EXPECT_EQ(url1, interned1);
+  EXPECT_EQ(url2, interned2);
+  EXPECT_EQ(&interned1.possibly_invalid_spec(),
+            &interned2.possibly_invalid_spec());
+  EXPECT_EQ(1u, interner.size());
+
+  GURL other = interner.Intern(GURL("http://www.google.com/bar"));
+  EXPECT_EQ("http://www.google.com/bar", other.spec());
+  EXPECT_EQ(2u, interner.size());
+}
+
+TEST(GURLInternerTest, InvalidURLs) {
+  GURLInterner interner;
+
+  GURL invalid("foo bar");
+  ASSERT_FALSE(invalid.is_valid());
+  EXPECT_EQ(invalid, interner.Intern(invalid));
+  EXPECT_EQ(GURL(), interner.Intern(GURL()));
+  EXPECT_EQ(0u, interner.size());
+}
+
+TEST(GURLInternerTest, Purge) {
+  GURLInterner interner;
+
+  GURL kept = interner.Intern(GURL("http://www.google.com/kept"));
+  interner.Intern(GURL("http://www.google.com/dropped"));
+  interner.Intern(GURL("filesystem:http://www.google.com/temporary/dropped"));
+  EXPECT_EQ(3u, interner.size());
+
+  interner.Purge();
+  EXPECT_EQ(1u, interner.size());
+
+  // The URL that is still in use is still shared.
+  EXPECT_EQ(&kept.possibly_invalid_spec(),
+            &interner.Intern(GURL("http://www.google.com/kept"))
+                 .possibly_invalid_spec());
+}
+
+}  // namespace
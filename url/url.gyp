@@ -47,6 +47,7 @@
         'url_lib',
       ],
       'sources': [
+        'gurl_interner_unittest.cc',
         'gurl_unittest.cc',
         'origin_unittest.cc',
         'url_canon_unittest.cc',
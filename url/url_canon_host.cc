@@ -118,6 +118,14 @@ bool DoSimpleHost(const INCHAR* host,
 
   bool success = true;
   for (int i = 0; i < host_len; ++i) {
+    // Lowercase letters, digits, '-', '_' and '.' map to themselves in
+    // kHostCharLookup, so copy runs of them in one go.
+    int canonical_len = AppendCanonicalChars(host, i, host_len, '.', output);
+    if (canonical_len > 0) {
+      i += canonical_len - 1;
+      continue;
+    }
+
     unsigned int source = host[i];
     if (source == '%') {
       // Unescape first, if possible.
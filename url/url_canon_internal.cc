@@ -4,6 +4,9 @@
 
 #include <errno.h>
 #include <stdlib.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #include <cstdio>
 #include <string>
@@ -105,6 +108,40 @@ bool PrepareUTF16OverrideComponent(
 
 }  // namespace
 
+int CountCanonicalChars(const char* spec, int len, char extra) {
+  int i = 0;
+#if defined(__SSE2__)
+  // The comparisons are signed, so non-ASCII bytes (negative values) fail
+  // both range checks, as they should.
+  const __m128i before_a = _mm_set1_epi8('a' - 1);
+  const __m128i after_z = _mm_set1_epi8('z' + 1);
+  const __m128i before_0 = _mm_set1_epi8('0' - 1);
+  const __m128i after_9 = _mm_set1_epi8('9' + 1);
+  const __m128i dash = _mm_set1_epi8('-');
+  const __m128i underscore = _mm_set1_epi8('_');
+  const __m128i extra_char = _mm_set1_epi8(extra);
+  for (; i + 16 <= len; i += 16) {
+    __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&spec[i]));
+    __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(chunk, before_a),
+                                  _mm_cmplt_epi8(chunk, after_z));
+    __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(chunk, before_0),
+                                  _mm_cmplt_epi8(chunk, after_9));
+    __m128i other = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, dash),
+                     _mm_cmpeq_epi8(chunk, underscore)),
+        _mm_cmpeq_epi8(chunk, extra_char));
+    __m128i canonical = _mm_or_si128(_mm_or_si128(lower, digit), other);
+    // Let the loop below find the first character that isn't canonical.
+    if (_mm_movemask_epi8(canonical) != 0xffff)
+      break;
+  }
+#endif
+  while (i < len && IsCanonicalChar(spec[i], extra))
+    i++;
+  return i;
+}
+
 // See the header file for this array's declaration.
 const unsigned char kSharedCharTypeTable[0x100] = {
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 0x00 - 0x0f
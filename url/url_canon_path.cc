@@ -184,6 +184,14 @@ bool DoPartialPath(const CHAR* spec,
 
   bool success = true;
   for (int i = path.begin; i < end; i++) {
+    // Copy runs of characters that need no handling at all in one go. The dot
+    // handling below only looks at the output, so it is unaffected.
+    int canonical_len = AppendCanonicalChars(spec, i, end, '/', output);
+    if (canonical_len > 0) {
+      i += canonical_len - 1;
+      continue;
+    }
+
     UCHAR uch = static_cast<UCHAR>(spec[i]);
     if (sizeof(CHAR) > sizeof(char) && uch >= 0x80) {
       // We only need to test wide input for having non-ASCII characters. For
@@ -1145,6 +1145,13 @@ TEST(URLCanonTest, Path) {
       // UTF-16 input, so this doesn't happen on 8-bit.
     {"/\xef\xb7\x90zyx", NULL, "/%EF%B7%90zyx", url_parse::Component(0, 13), true},
     {NULL, L"/\xfdd0zyx", "/%EF%BF%BDzyx", url_parse::Component(0, 13), false},
+
+    // ----- long runs of canonical characters -----
+      // These are copied in bulk, 16 characters at a time when possible.
+    {"/abcdefghijklmnopqrstuvwxyz0123456789-_/foo", L"/abcdefghijklmnopqrstuvwxyz0123456789-_/foo", "/abcdefghijklmnopqrstuvwxyz0123456789-_/foo", url_parse::Component(0, 43), true},
+    {"/abcdefghijklmnopqrstuvwxyz/../foo", L"/abcdefghijklmnopqrstuvwxyz/../foo", "/foo", url_parse::Component(0, 4), true},
+    {"/abcdefghijklmnopqrstuVwxyz\foo", L"/abcdefghijklmnopqrstuVwxyz\foo", "/abcdefghijklmnopqrstuVwxyz/foo", url_parse::Component(0, 31), true},
+    {"/abcdefghijklmnopqrst\xc2\xa9uvwxyz", NULL, "/abcdefghijklmnopqrst%C2%A9uvwxyz", url_parse::Component(0, 33), true},
   };
 
   for (size_t i = 0; i < arraysize(path_cases); i++) {
@@ -1198,6 +1205,35 @@ TEST(URLCanonTest, Path) {
   EXPECT_EQ("/ab%00c", out_str);
 }
 
+TEST(URLCanonTest, CountCanonicalChars) {
+  struct CountCase {
+    const char* input;
+    char extra;
+    int expected;
+  } count_cases[] = {
+    {"", '/', 0},
+    {"abc", '/', 3},
+    {"ABC", '/', 0},
+    {"a-b_c/d.e", '/', 7},
+    {"a-b_c/d.e", '.', 5},
+    {"abcdefghijklmnopqrstuvwxyz", '/', 26},
+    {"abcdefghijklmnopqrstuvwxyZ", '/', 25},
+    {"abcdefghijklmnoP", '/', 15},
+    {"abcdefghijklmnop%41", '/', 16},
+    {"0123456789abcdef0123456789\x80", '/', 26},
+    {"0123456789/abcdef/0123456789/ghijk lmn", '/', 34},
+  };
+
+  for (size_t i = 0; i < arraysize(count_cases); i++) {
+    const char* input = count_cases[i].input;
+    EXPECT_EQ(count_cases[i].expected,
+              url_canon::CountCanonicalChars(input,
+                                             static_cast<int>(strlen(input)),
+                                             count_cases[i].extra))
+        << input;
+  }
+}
+
 TEST(URLCanonTest, Query) {
   struct QueryCase {
     const char* input8;
@@ -17,6 +17,9 @@ namespace appcache {
 // static
 const int64 AppCacheStorage::kUnitializedId = -1;
 
+// static
+const size_t AppCacheStorage::kMaxRecentlyUsedResponseInfos = 64;
+
 AppCacheStorage::AppCacheStorage(AppCacheService* service)
     : last_cache_id_(kUnitializedId), last_group_id_(kUnitializedId),
       last_response_id_(kUnitializedId), service_(service)  {
@@ -74,6 +77,7 @@ void AppCacheStorage::ResponseInfoLoadTask::OnReadComplete(int result) {
                                     response_id_,
                                     info_buffer_->http_info.release(),
                                     info_buffer_->response_data_size);
+    storage_->RetainRecentlyUsedResponseInfo(info.get());
   }
   FOR_EACH_DELEGATE(delegates_, OnResponseInfoLoaded(info.get(), response_id_));
   delete this;
@@ -83,6 +87,7 @@ void AppCacheStorage::LoadResponseInfo(
     const GURL& manifest_url, int64 group_id, int64 id, Delegate* delegate) {
   AppCacheResponseInfo* info = working_set_.GetResponseInfo(id);
   if (info) {
+    RetainRecentlyUsedResponseInfo(info);
     delegate->OnResponseInfoLoaded(info, id);
     return;
   }
@@ -95,6 +100,22 @@ void AppCacheStorage::LoadResponseInfo(
   info_load->StartIfNeeded();
 }
 
+void AppCacheStorage::RetainRecentlyUsedResponseInfo(
+    AppCacheResponseInfo* info) {
+  DCHECK(info);
+  for (ResponseInfoList::iterator iter = recently_used_infos_.begin();
+       iter != recently_used_infos_.end(); ++iter) {
+    if (iter->get() == info) {
+      recently_used_infos_.splice(recently_used_infos_.begin(),
+                                  recently_used_infos_, iter);
+      return;
+    }
+  }
+  recently_used_infos_.push_front(info);
+  if (recently_used_infos_.size() > kMaxRecentlyUsedResponseInfos)
+    recently_used_infos_.pop_back();
+}
+
 void AppCacheStorage::UpdateUsageMapAndNotify(
     const GURL& origin, int64 new_usage) {
   DCHECK_GE(new_usage, 0);
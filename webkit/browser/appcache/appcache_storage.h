@@ -5,6 +5,7 @@
 #ifndef WEBKIT_BROWSER_APPCACHE_APPCACHE_STORAGE_H_
 #define WEBKIT_BROWSER_APPCACHE_APPCACHE_STORAGE_H_
 
+#include <list>
 #include <map>
 #include <vector>
 
@@ -259,6 +260,7 @@ class WEBKIT_STORAGE_BROWSER_EXPORT AppCacheStorage {
   };
 
   typedef std::map<int64, ResponseInfoLoadTask*> PendingResponseInfoLoads;
+  typedef std::list<scoped_refptr<AppCacheResponseInfo> > ResponseInfoList;
 
   DelegateReference* GetDelegateReference(Delegate* delegate) {
     DelegateReferenceMap::iterator iter =
@@ -284,6 +286,11 @@ class WEBKIT_STORAGE_BROWSER_EXPORT AppCacheStorage {
     return new ResponseInfoLoadTask(manifest_url, group_id, response_id, this);
   }
 
+  // Keeps |info| alive as the most recently used entry of a bounded list,
+  // so that repeated loads of the same responses are served from the
+  // working set instead of reading the headers from disk again.
+  void RetainRecentlyUsedResponseInfo(AppCacheResponseInfo* info);
+
   // Should only be called when creating a new response writer.
   int64 NewResponseId() {
     return ++last_response_id_;
@@ -304,11 +311,16 @@ class WEBKIT_STORAGE_BROWSER_EXPORT AppCacheStorage {
   AppCacheService* service_;
   DelegateReferenceMap delegate_references_;
   PendingResponseInfoLoads pending_info_loads_;
+  ResponseInfoList recently_used_infos_;  // most recently used first
 
   // The set of last ids must be retrieved from storage prior to being used.
   static const int64 kUnitializedId;
 
+  // The most response infos kept alive by |recently_used_infos_|.
+  static const size_t kMaxRecentlyUsedResponseInfos;
+
   FRIEND_TEST_ALL_PREFIXES(AppCacheStorageTest, DelegateReferences);
+  FRIEND_TEST_ALL_PREFIXES(AppCacheStorageTest, RecentlyUsedResponseInfos);
   FRIEND_TEST_ALL_PREFIXES(AppCacheStorageTest, UsageMap);
 
   DISALLOW_COPY_AND_ASSIGN(AppCacheStorage);
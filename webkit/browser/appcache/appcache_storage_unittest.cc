@@ -75,6 +75,41 @@ TEST_F(AppCacheStorageTest, AddRemoveResponseInfo) {
   dummy.storage()->working_set()->RemoveResponseInfo(info.get());
 }
 
+TEST_F(AppCacheStorageTest, RecentlyUsedResponseInfos) {
+  MockAppCacheService service;
+  AppCacheStorage* storage = service.storage();
+  const int64 kCount =
+      static_cast<int64>(AppCacheStorage::kMaxRecentlyUsedResponseInfos);
+
+  // Infos retained by the storage outlive the caller's references.
+  for (int64 id = 1; id <= kCount; ++id) {
+    scoped_refptr<AppCacheResponseInfo> info(
+        new AppCacheResponseInfo(storage, GURL(), id,
+                                 new net::HttpResponseInfo,
+                                 kUnkownResponseDataSize));
+    storage->RetainRecentlyUsedResponseInfo(info.get());
+  }
+  EXPECT_TRUE(storage->working_set()->GetResponseInfo(1));
+  EXPECT_TRUE(storage->working_set()->GetResponseInfo(kCount));
+
+  // Using the oldest info again makes it the most recently used, so the
+  // next one over the limit evicts the second oldest instead.
+  storage->RetainRecentlyUsedResponseInfo(
+      storage->working_set()->GetResponseInfo(1));
+  scoped_refptr<AppCacheResponseInfo> info(
+      new AppCacheResponseInfo(storage, GURL(), kCount + 1,
+                               new net::HttpResponseInfo,
+                               kUnkownResponseDataSize));
+  storage->RetainRecentlyUsedResponseInfo(info.get());
+  info = NULL;
+
+  EXPECT_TRUE(storage->working_set()->GetResponseInfo(1));
+  EXPECT_FALSE(storage->working_set()->GetResponseInfo(2));
+  EXPECT_TRUE(storage->working_set()->GetResponseInfo(kCount + 1));
+  EXPECT_EQ(AppCacheStorage::kMaxRecentlyUsedResponseInfos,
+            storage->recently_used_infos_.size());
+}
+
 TEST_F(AppCacheStorageTest, DelegateReferences) {
   typedef scoped_refptr<AppCacheStorage::DelegateReference>
       ScopedDelegateReference;
@@ -5,9 +5,11 @@
 #include "webkit/browser/blob/blob_storage_context.h"
 
 #include "base/bind.h"
+#include "base/debug/trace_event.h"
 #include "base/location.h"
 #include "base/logging.h"
 #include "base/message_loop/message_loop_proxy.h"
+#include "base/metrics/histogram.h"
 #include "url/gurl.h"
 #include "webkit/browser/blob/blob_data_handle.h"
 #include "webkit/common/blob/blob_data.h"
@@ -36,6 +38,11 @@ GURL ClearBlobUrlRef(const GURL& url) {
 // way to come up with a better limit.
 static const int64 kMaxMemoryUsage = 500 * 1024 * 1024;  // Half a gig.
 
+// Exposes the bytes held in the browser heap by all blobs to tracing.
+void TraceMemoryUsage(int64 memory_usage) {
+  TRACE_COUNTER1("Blob", "BlobStorageContext::MemoryUsage", memory_usage);
+}
+
 }  // namespace
 
 BlobStorageContext::BlobMapEntry::BlobMapEntry()
@@ -184,6 +191,7 @@ void BlobStorageContext::AppendBlobDataItem(
   // as a stop gap, we'll prevent memory usage over a max amount.
   if (exceeded_memory) {
     memory_usage_ -= target_blob_data->GetMemoryUsage();
+    TraceMemoryUsage(memory_usage_);
     found->second.flags |= EXCEEDED_MEMORY;
     found->second.data = new BlobData(uuid);
     return;
@@ -198,6 +206,14 @@ void BlobStorageContext::FinishBuildingBlob(
     return;
   found->second.data->set_content_type(content_type);
   found->second.flags &= ~BEING_BUILT;
+
+  UMA_HISTOGRAM_BOOLEAN("Storage.Blob.ExceededMemory",
+                        (found->second.flags & EXCEEDED_MEMORY) != 0);
+  UMA_HISTOGRAM_COUNTS(
+      "Storage.Blob.MemoryUsageKB",
+      static_cast<int>(found->second.data->GetMemoryUsage() / 1024));
+  UMA_HISTOGRAM_COUNTS("Storage.Blob.TotalMemoryUsageKB",
+                       static_cast<int>(memory_usage_ / 1024));
 }
 
 void BlobStorageContext::CancelBuildingBlob(const std::string& uuid) {
@@ -221,6 +237,7 @@ void BlobStorageContext::DecrementBlobRefCount(const std::string& uuid) {
   DCHECK_EQ(found->second.data->uuid(), uuid);
   if (--(found->second.refcount) == 0) {
     memory_usage_ -= found->second.data->GetMemoryUsage();
+    TraceMemoryUsage(memory_usage_);
     blob_map_.erase(found);
   }
 }
@@ -282,6 +299,7 @@ bool BlobStorageContext::AppendBytesItem(
     return false;
   target_blob_data->AppendData(bytes, static_cast<size_t>(length));
   memory_usage_ += length;
+  TraceMemoryUsage(memory_usage_);
   return true;
 }
 
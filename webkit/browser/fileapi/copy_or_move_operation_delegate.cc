@@ -351,8 +351,10 @@ class SnapshotCopyOrMoveImpl
   DISALLOW_COPY_AND_ASSIGN(SnapshotCopyOrMoveImpl);
 };
 
-// The size of buffer for StreamCopyHelper.
-const int kReadBufferSize = 32768;
+// The size of buffer for StreamCopyHelper. Each read or write round trips
+// through the file thread, or the network for some file systems, so large
+// buffers keep the number of round trips per file low.
+const int kReadBufferSize = 1 << 20;
 
 // To avoid too many progress callbacks, it should be called less
 // frequently than 50ms.
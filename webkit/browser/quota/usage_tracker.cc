@@ -328,6 +328,13 @@ void ClientUsageTracker::GetGlobalUsage(const GlobalUsageCallback& callback) {
     return;
   }
 
+  if (global_usage_retrieved_) {
+    // The usage of cached origins is kept up to date by UpdateUsageCache(),
+    // so only the origins whose usage isn't cached need to be asked for.
+    GetNonCachedGlobalUsage(callback);
+    return;
+  }
+
   client_->GetOriginsForType(type_, base::Bind(
       &ClientUsageTracker::DidGetOriginsForGlobalUsage, AsWeakPtr(),
       callback));
@@ -471,6 +478,71 @@ void ClientUsageTracker::DidGetOriginsForGlobalUsage(
   accumulator.Run(0, 0);
 }
 
+void ClientUsageTracker::GetNonCachedGlobalUsage(
+    const GlobalUsageCallback& callback) {
+  AccumulateInfo* info = new AccumulateInfo;
+  info->limited_usage = global_limited_usage_;
+  info->unlimited_usage = global_unlimited_usage_;
+  // Getting origin usage may synchronously return the result, so add one more
+  // pending origin as a sentinel and fire it at the end, as
+  // GetUsageForOrigins() does.
+  info->pending_jobs = 1;
+  for (OriginSetByHost::const_iterator itr =
+           non_cached_limited_origins_by_host_.begin();
+       itr != non_cached_limited_origins_by_host_.end(); ++itr) {
+    info->pending_jobs += itr->second.size();
+  }
+  for (OriginSetByHost::const_iterator itr =
+           non_cached_unlimited_origins_by_host_.begin();
+       itr != non_cached_unlimited_origins_by_host_.end(); ++itr) {
+    info->pending_jobs += itr->second.size();
+  }
+
+  OriginUsageAccumulator accumulator =
+      base::Bind(&ClientUsageTracker::AccumulateNonCachedOriginUsage,
+                 AsWeakPtr(), base::Owned(info), callback);
+  const OriginSetByHost* non_cached_origins[] = {
+    &non_cached_limited_origins_by_host_,
+    &non_cached_unlimited_origins_by_host_,
+  };
+  for (size_t i = 0; i < arraysize(non_cached_origins); ++i) {
+    for (OriginSetByHost::const_iterator host_itr =
+             non_cached_origins[i]->begin();
+         host_itr != non_cached_origins[i]->end(); ++host_itr) {
+      for (std::set<GURL>::const_iterator origin_itr =
+               host_itr->second.begin();
+           origin_itr != host_itr->second.end(); ++origin_itr) {
+        client_->GetOriginUsage(*origin_itr, type_, base::Bind(
+            &DidGetOriginUsage, accumulator, *origin_itr));
+      }
+    }
+  }
+
+  // Fire the sentinel as we've now called GetOriginUsage for all origins.
+  accumulator.Run(GURL(), 0);
+}
+
+void ClientUsageTracker::AccumulateNonCachedOriginUsage(
+    AccumulateInfo* info,
+    const GlobalUsageCallback& callback,
+    const GURL& origin,
+    int64 usage) {
+  if (!origin.is_empty()) {
+    if (usage < 0)
+      usage = 0;
+
+    if (IsStorageUnlimited(origin))
+      info->unlimited_usage += usage;
+    else
+      info->limited_usage += usage;
+  }
+  if (--info->pending_jobs)
+    return;
+
+  callback.Run(info->limited_usage + info->unlimited_usage,
+               info->unlimited_usage);
+}
+
 void ClientUsageTracker::AccumulateHostUsage(
     AccumulateInfo* info,
     const GlobalUsageCallback& callback,
@@ -137,6 +137,11 @@ class ClientUsageTracker : public SpecialStoragePolicy::Observer,
                                     int64 usage);
   void DidGetOriginsForGlobalUsage(const GlobalUsageCallback& callback,
                                    const std::set<GURL>& origins);
+  void GetNonCachedGlobalUsage(const GlobalUsageCallback& callback);
+  void AccumulateNonCachedOriginUsage(AccumulateInfo* info,
+                                      const GlobalUsageCallback& callback,
+                                      const GURL& origin,
+                                      int64 usage);
   void AccumulateHostUsage(AccumulateInfo* info,
                            const GlobalUsageCallback& callback,
                            int64 limited_usage,
@@ -324,5 +324,31 @@ TEST_F(UsageTrackerTest, LimitedGlobalUsageTest) {
   EXPECT_EQ(2 + 32, unlimited_usage);
 }
 
+TEST_F(UsageTrackerTest, GlobalUsageOnlyQueriesNonCachedOrigins) {
+  const GURL kNormal("http://normal");
+  const GURL kNonCached("http://non_cached");
+
+  SetUsageCacheEnabled(kNonCached, false);
+  UpdateUsageWithoutNotification(kNormal, 1);
+  UpdateUsageWithoutNotification(kNonCached, 2);
+
+  int64 total_usage = 0;
+  int64 unlimited_usage = 0;
+  GetGlobalUsage(&total_usage, &unlimited_usage);
+  EXPECT_EQ(1 + 2, total_usage);
+
+  // Once the global usage is known, the cached usage of |kNormal| is trusted
+  // and only |kNonCached| is asked for its usage again.
+  UpdateUsageWithoutNotification(kNormal, 4);
+  UpdateUsageWithoutNotification(kNonCached, 8);
+  GetGlobalUsage(&total_usage, &unlimited_usage);
+  EXPECT_EQ(1 + 2 + 8, total_usage);
+  EXPECT_EQ(0, unlimited_usage);
+
+  UpdateUsage(kNormal, 16);
+  GetGlobalUsage(&total_usage, &unlimited_usage);
+  EXPECT_EQ(1 + 16 + 2 + 8, total_usage);
+}
+
 
 }  // namespace quota